@@ -23,6 +23,7 @@
 #include "ALICE3/Core/TrackUtilities.h"
 
 #include <CommonConstants/PhysicsConstants.h>
+#include <Framework/Logger.h>
 #include <MathUtils/Primitive2D.h>
 #include <ReconstructionDataFormats/Track.h>
 
@@ -31,8 +32,10 @@
 #include <TLorentzVector.h>
 #include <TRandom3.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <unordered_map>
 #include <vector>
 
 namespace o2
@@ -46,19 +49,73 @@ class Decayer
   // Default constructor
   Decayer() = default;
 
+  // Decay properties of a particle species, cached at the first decay of the species
+  struct DecayTable {
+    bool isKnown = false;               // the species is in the PDG database
+    int charge = 0;                     // charge in units of e
+    double mass = 0.;                   // GeV/c2
+    double ctau = 0.;                   // cm
+    std::vector<double> cumulativeBR;   // cumulative branching ratio of the channels
+    std::vector<size_t> firstDaughter;  // index of the first daughter of each channel, and the end of the last one
+    std::vector<int> daughterPdgCodes;  // PDG codes of the daughters of all the channels
+    std::vector<double> daughterMasses; // masses of the daughters of all the channels, negative if unknown
+  };
+
   template <typename TDatabase>
-  std::vector<o2::upgrade::OTFParticle> decayParticle(const TDatabase& pdgDB, const OTFParticle& particle)
+  const DecayTable& getDecayTable(const TDatabase& pdgDB, const int pdgCode)
   {
-    const auto& particleInfo = pdgDB->GetParticle(particle.pdgCode());
+    auto [it, isNew] = mDecayTables.try_emplace(pdgCode);
+    DecayTable& table = it->second;
+    if (!isNew) {
+      return table;
+    }
+    const auto& particleInfo = pdgDB->GetParticle(pdgCode);
     if (!particleInfo) {
-      return {};
+      return table;
+    }
+    table.isKnown = true;
+    table.charge = particleInfo->Charge() / 3;
+    table.mass = particleInfo->Mass();
+    table.ctau = o2::constants::physics::LightSpeedCm2S * particleInfo->Lifetime();
+    double brSum = 0.;
+    for (int ch = 0; ch < particleInfo->NDecayChannels(); ++ch) {
+      const auto* channel = particleInfo->DecayChannel(ch);
+      brSum += channel->BranchingRatio();
+      table.cumulativeBR.push_back(brSum);
+      table.firstDaughter.push_back(table.daughterPdgCodes.size());
+      for (int dau = 0; dau < channel->NDaughters(); ++dau) {
+        const int pdgDau = channel->DaughterPdgCode(dau);
+        const auto& dauInfo = pdgDB->GetParticle(pdgDau);
+        table.daughterPdgCodes.push_back(pdgDau);
+        table.daughterMasses.push_back(dauInfo ? dauInfo->Mass() : -1.);
+      }
+    }
+    table.firstDaughter.push_back(table.daughterPdgCodes.size());
+    return table;
+  }
+
+  template <typename TDatabase>
+  std::vector<o2::upgrade::OTFParticle> decayParticle(const TDatabase& pdgDB, const OTFParticle& particle)
+  {
+    std::vector<o2::upgrade::OTFParticle> decayProducts;
+    decayParticle(pdgDB, particle, decayProducts);
+    return decayProducts;
+  }
+
+  // Decays a particle, the decay products are appended to decayProducts
+  template <typename TDatabase>
+  void decayParticle(const TDatabase& pdgDB, const OTFParticle& particle, std::vector<o2::upgrade::OTFParticle>& decayProducts)
+  {
+    const DecayTable& table = getDecayTable(pdgDB, particle.pdgCode());
+    if (!table.isKnown) {
+      return;
     }
 
-    const int charge = particleInfo->Charge() / 3;
-    const double mass = particleInfo->Mass();
+    const int charge = table.charge;
+    const double mass = table.mass;
 
     const double u = mRand3.Uniform(0.001, 0.999);
-    const double ctau = o2::constants::physics::LightSpeedCm2S * particleInfo->Lifetime(); // cm
+    const double ctau = table.ctau; // cm
     const double betaGamma = particle.p() / mass;
     const double rxyz = -betaGamma * ctau * std::log(1 - u);
     double px, py, e;
@@ -87,50 +144,39 @@ class Decayer
       py = particle.py() * std::cos(theta) + particle.px() * std::sin(theta);
     }
 
-    double brTotal = 0.;
     e = std::sqrt(mass * mass + px * px + py * py + particle.pz() * particle.pz());
-    for (int ch = 0; ch < particleInfo->NDecayChannels(); ++ch) {
-      brTotal += particleInfo->DecayChannel(ch)->BranchingRatio();
-    }
-
-    double brSum = 0.;
-    std::vector<double> dauMasses;
-    std::vector<int> pdgCodesDaughters;
+    const double brTotal = table.cumulativeBR.empty() ? 0. : table.cumulativeBR.back();
     const double randomChannel = mRand3.Uniform(0., brTotal);
-    for (int ch = 0; ch < particleInfo->NDecayChannels(); ++ch) {
-      brSum += particleInfo->DecayChannel(ch)->BranchingRatio();
-      if (randomChannel < brSum) {
-        for (int dau = 0; dau < particleInfo->DecayChannel(ch)->NDaughters(); ++dau) {
-          const int pdgDau = particleInfo->DecayChannel(ch)->DaughterPdgCode(dau);
-          pdgCodesDaughters.push_back(pdgDau);
-          const auto& dauInfo = pdgDB->GetParticle(pdgDau);
-          dauMasses.push_back(dauInfo->Mass());
-        }
-        break;
-      }
+    // first channel whose cumulative branching ratio is above the random number
+    const size_t ch = std::upper_bound(table.cumulativeBR.begin(), table.cumulativeBR.end(), randomChannel) - table.cumulativeBR.begin();
+    if (ch >= table.cumulativeBR.size()) {
+      return;
     }
-
-    if (dauMasses.empty()) {
-      return {};
+    const size_t firstDaughter = table.firstDaughter[ch];
+    const size_t nDaughters = table.firstDaughter[ch + 1] - firstDaughter;
+    if (!nDaughters) {
+      return;
+    }
+    const double* dauMasses = table.daughterMasses.data() + firstDaughter;
+    for (size_t i = 0; i < nDaughters; ++i) {
+      if (dauMasses[i] < 0.) {
+        LOG(error) << "Decayer: unknown daughter " << table.daughterPdgCodes[firstDaughter + i] << " of " << particle.pdgCode() << ", not decaying";
+        return;
+      }
     }
 
     TLorentzVector tlv(px, py, particle.pz(), e);
-    TGenPhaseSpace decay;
-    decay.SetDecay(tlv, dauMasses.size(), dauMasses.data());
-    decay.Generate();
-
-    std::vector<o2::upgrade::OTFParticle> decayProducts;
-    for (size_t i = 0; i < dauMasses.size(); ++i) {
-      o2::upgrade::OTFParticle particle;
-      TLorentzVector dau = *decay.GetDecay(i);
-      particle.setPDG(pdgCodesDaughters[i]);
-      particle.setVxVyVz(mVx, mVy, mVz);
-      particle.setPxPyPzE(dau.Px(), dau.Py(), dau.Pz(), dau.E());
-      particle.setBitOn(o2::upgrade::DecayerBits::ProducedByDecayer);
-      decayProducts.push_back(particle);
+    mPhaseSpace.SetDecay(tlv, nDaughters, dauMasses);
+    mPhaseSpace.Generate();
+
+    for (size_t i = 0; i < nDaughters; ++i) {
+      o2::upgrade::OTFParticle& daughter = decayProducts.emplace_back();
+      const TLorentzVector& dau = *mPhaseSpace.GetDecay(i);
+      daughter.setPDG(table.daughterPdgCodes[firstDaughter + i]);
+      daughter.setVxVyVz(mVx, mVy, mVz);
+      daughter.setPxPyPzE(dau.Px(), dau.Py(), dau.Pz(), dau.E());
+      daughter.setBitOn(o2::upgrade::DecayerBits::ProducedByDecayer);
     }
-
-    return decayProducts;
   }
 
   // Setters
@@ -151,6 +197,8 @@ class Decayer
   double mBz{20.}; // kG
   double mVx{-1.}, mVy{-1.}, mVz{-1.};
   TRandom3 mRand3{};
+  TGenPhaseSpace mPhaseSpace;                       // reused for all the decays
+  std::unordered_map<int, DecayTable> mDecayTables; // decay tables by PDG code
 };
 
 } // namespace upgrade
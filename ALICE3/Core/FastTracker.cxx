@@ -36,12 +36,14 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace o2
@@ -71,6 +73,7 @@ DetLayer* FastTracker::AddLayer(TString name, float r, float z, float x0, float
   }
   // Add the new layer to the layers vector
   layers.push_back(newLayer);
+  mIsCompiled = false;
   // Return the last added layer
   return &layers.back();
 }
@@ -83,6 +86,7 @@ void FastTracker::addDeadPhiRegionInLayer(const std::string& layerName, float ph
     return;
   }
   layers[layerIdx].addDeadPhiRegion(phiStart, phiEnd);
+  mIsCompiled = false;
 }
 
 int FastTracker::GetLayerIndex(const std::string& name) const
@@ -109,6 +113,101 @@ void FastTracker::Print()
   LOG(info) << "+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+";
 }
 
+void FastTracker::CompileLayers()
+{
+  const size_t nLayers = layers.size();
+  mCompiled = CompiledLayers();
+  mCompiled.radius.resize(nLayers);
+  mCompiled.z.resize(nLayers);
+  mCompiled.x0.resize(nLayers);
+  mCompiled.xrho.resize(nLayers);
+  mCompiled.resRPhi2.resize(nLayers);
+  mCompiled.resZ2.resize(nLayers);
+  mCompiled.type.resize(nLayers);
+  mCompiled.deadSectors.assign(nLayers, -1);
+  const double sectorWidth = o2::constants::math::TwoPI / kNPhiSectors;
+  const double sectorMargin = 1.e-3 * sectorWidth; // covers the rounding of the sector index
+  for (size_t il = 0; il < nLayers; il++) {
+    const DetLayer& layer = layers[il];
+    mCompiled.radius[il] = layer.getRadius();
+    mCompiled.z[il] = layer.getZ();
+    mCompiled.x0[il] = layer.getRadiationLength();
+    mCompiled.xrho[il] = layer.getDensity();
+    mCompiled.resRPhi2[il] = layer.getResolutionRPhi() * layer.getResolutionRPhi();
+    mCompiled.resZ2[il] = layer.getResolutionZ() * layer.getResolutionZ();
+    mCompiled.type[il] = layer.getType();
+    if (mCompiled.firstActiveLayer < 0 && !layer.isInert()) {
+      mCompiled.firstActiveLayer = il;
+    }
+
+    const TGraph* graph = layer.getDeadPhiRegions();
+    if (graph == nullptr) {
+      continue;
+    }
+    // the layer is dead where the linear interpolation of the graph is above 1:
+    // on (a, b) with a and b the ends of each segment, or its crossing of 1
+    std::vector<std::pair<double, double>> points(graph->GetN());
+    for (int ip = 0; ip < graph->GetN(); ip++) {
+      points[ip] = {graph->GetX()[ip], graph->GetY()[ip]};
+    }
+    std::stable_sort(points.begin(), points.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    std::vector<std::pair<double, double>> deadIntervals;
+    for (size_t ip = 0; ip + 1 < points.size(); ip++) {
+      const auto [x1, y1] = points[ip];
+      const auto [x2, y2] = points[ip + 1];
+      if (y1 <= 1. && y2 <= 1.) {
+        continue;
+      }
+      double start = x1;
+      double end = x2;
+      if (y1 <= 1.) {
+        start = x1 + (1. - y1) / (y2 - y1) * (x2 - x1);
+      } else if (y2 <= 1.) {
+        end = x1 + (1. - y1) / (y2 - y1) * (x2 - x1);
+      }
+      deadIntervals.emplace_back(start, end);
+    }
+    // a sector is alive if it does not touch any dead interval, dead if it is inside one, and mixed otherwise
+    mCompiled.deadSectors[il] = mCompiled.phiSectors.size();
+    for (int is = 0; is < kNPhiSectors; is++) {
+      const double sectorStart = is * sectorWidth - sectorMargin;
+      const double sectorEnd = (is + 1) * sectorWidth + sectorMargin;
+      uint8_t status = kSectorAlive;
+      for (const auto& [start, end] : deadIntervals) {
+        if (start < sectorStart && sectorEnd < end) {
+          status = kSectorDead;
+          break;
+        }
+        if (start <= sectorEnd && sectorStart <= end) {
+          status = kSectorMixed;
+        }
+      }
+      mCompiled.phiSectors.push_back(status);
+    }
+  }
+  mIsCompiled = true;
+}
+
+bool FastTracker::IsInDeadPhiRegion(int layer, float phi) const
+{
+  const int offset = mCompiled.deadSectors[layer];
+  if (offset < 0) {
+    return false;
+  }
+  const int sector = static_cast<int>(phi * (kNPhiSectors / o2::constants::math::TwoPI));
+  if (sector < 0 || sector >= kNPhiSectors) {
+    return layers[layer].isInDeadPhiRegion(phi); // outside of [0, 2pi), evaluate the graph
+  }
+  switch (mCompiled.phiSectors[offset + sector]) {
+    case kSectorAlive:
+      return false;
+    case kSectorDead:
+      return true;
+    default:
+      return layers[layer].isInDeadPhiRegion(phi);
+  }
+}
+
 void FastTracker::AddTPC(float phiResMean, float zResMean)
 {
   LOG(info) << " Adding standard time projection chamber";
@@ -206,7 +305,7 @@ void FastTracker::AddGenericDetector(o2::fastsim::GeometryEntry configMap, o2::c
   }
 }
 
-float FastTracker::Dist(float z, float r)
+float FastTracker::Dist(float z, float r) const
 {
   // porting of DetektorK::Dist
   // see here:
@@ -229,7 +328,7 @@ float FastTracker::Dist(float z, float r)
   return dist;
 }
 
-float FastTracker::OneEventHitDensity(float multiplicity, float radius)
+float FastTracker::OneEventHitDensity(float multiplicity, float radius) const
 {
   // porting of DetektorK::OneEventHitDensity
   // see here:
@@ -240,7 +339,7 @@ float FastTracker::OneEventHitDensity(float multiplicity, float radius)
   return den;
 }
 
-float FastTracker::IntegratedHitDensity(float multiplicity, float radius)
+float FastTracker::IntegratedHitDensity(float multiplicity, float radius) const
 {
   // porting of DetektorK::IntegratedHitDensity
   // see here:
@@ -252,7 +351,7 @@ float FastTracker::IntegratedHitDensity(float multiplicity, float radius)
   return den;
 }
 
-float FastTracker::UpcHitDensity(float radius)
+float FastTracker::UpcHitDensity(float radius) const
 {
   // porting of DetektorK::UpcHitDensity
   // see here:
@@ -266,14 +365,14 @@ float FastTracker::UpcHitDensity(float radius)
   return mUPCelectrons;
 }
 
-float FastTracker::HitDensity(float radius)
+float FastTracker::HitDensity(float radius, float nch) const
 {
   // porting of DetektorK::HitDensity
   // see here:
   // https://github.com/AliceO2Group/DelphesO2/blob/master/src/DetectorK/DetectorK.cxx#L663
   float arealDensity = 0.;
   if (radius > maxRadiusSlowDet) {
-    arealDensity = OneEventHitDensity(dNdEtaCent, radius);
+    arealDensity = OneEventHitDensity(nch, radius);
     arealDensity += otherBackground * OneEventHitDensity(dNdEtaMinB, radius);
   }
 
@@ -281,20 +380,20 @@ float FastTracker::HitDensity(float radius)
   // Look-up tables, UpcHitDensity(radius) always returns 0,
   // hence it is left commented out for now
   if (radius < maxRadiusSlowDet) {
-    arealDensity = OneEventHitDensity(dNdEtaCent, radius);
+    arealDensity = OneEventHitDensity(nch, radius);
     arealDensity += otherBackground * OneEventHitDensity(dNdEtaMinB, radius) + IntegratedHitDensity(dNdEtaMinB, radius);
     // +UpcHitDensity(radius);
   }
   return arealDensity;
 }
 
-float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ)
+float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ, float nch) const
 {
   // porting of DetektorK::ProbGoodChiSqHit
   // see here:
   // https://github.com/AliceO2Group/DelphesO2/blob/master/src/DetectorK/DetectorK.cxx#L629
   float sx, goodHit;
-  sx = o2::constants::math::TwoPI * searchRadiusRPhi * searchRadiusZ * HitDensity(radius);
+  sx = o2::constants::math::TwoPI * searchRadiusRPhi * searchRadiusZ * HitDensity(radius, nch);
   goodHit = 1. / (1 + sx);
   return goodHit;
 }
@@ -304,23 +403,33 @@ float FastTracker::ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float
 int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, const float maxRadius)
 {
   dNdEtaCent = nch; // set the number of charged particles per unit rapidity
-  hits.clear();
-  nIntercepts = 0;
-  nSiliconPoints = 0;
-  nGasPoints = 0;
+  if (!mIsCompiled) {
+    CompileLayers();
+  }
+  return FastTrack(inputTrack, outputTrack, nch, mState, maxRadius);
+}
+
+int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, FastTrackState& state, const float maxRadius) const
+{
+  const int dNdEta = nch; // number of charged particles per unit rapidity, an integer as dNdEtaCent
+  TRandom* random = state.random ? state.random : gRandom;
+  state.hits.clear();
+  state.hits.reserve(3 * layers.size()); // at most one hit per layer, only allocates for the first track
+  state.nIntercepts = 0;
+  state.nSiliconPoints = 0;
+  state.nGasPoints = 0;
+  int& nIntercepts = state.nIntercepts;
   std::array<float, 3> posIni; // provision for != PV
   inputTrack.getXYZGlo(posIni);
   const float initialRadius = std::hypot(posIni[0], posIni[1]);
   const float kTrackingMargin = 0.1;
 
-  int firstActiveLayer = -1; // first layer that is not inert
-  for (size_t i = 0; i < layers.size(); ++i) {
-    if (!layers[i].isInert()) {
-      firstActiveLayer = i;
-      break;
-    }
+  if (!mIsCompiled) {
+    LOG(fatal) << "The layers of the FastTracker are not compiled, call CompileLayers() after their configuration";
+    return -2;
   }
-  if (firstActiveLayer < 0) {
+  const CompiledLayers& table = mCompiled; // the propagation only reads the compiled tables
+  if (table.firstActiveLayer < 0) {
     LOG(fatal) << "No active layers found in FastTracker, check layer setup";
     return -2; // no active layers
   }
@@ -331,10 +440,8 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
   // but does not count all points in the tpc as layers which we do here
   // Loop over all the added layers to prevent crash when adding the tpc
   // Should not affect efficiency calculation
-  goodHitProbability.clear();
-  for (size_t i = 0; i < layers.size(); ++i) {
-    goodHitProbability.push_back(-1.);
-  }
+  std::vector<float>& goodHitProbability = state.goodHitProbability;
+  goodHitProbability.assign(layers.size(), -1.);
   goodHitProbability[0] = 1.; // we use layer zero to accumulate
 
   // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
@@ -344,11 +451,11 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
   new (&outputTrack)(o2::track::TrackParCov)(inputTrack);
   for (size_t il = 0; il < layers.size(); il++) {
     // check if layer is doable
-    if (layers[il].getRadius() < initialRadius) {
+    if (table.radius[il] < initialRadius) {
       continue; // this layer should not be attempted, but go ahead
     }
 
-    if (layers[il].getRadius() > maxRadius) {
+    if (table.radius[il] > maxRadius) {
       if (lastLayerReached == -1) {
         // This means that we didn't reach the first layer
         return -9;
@@ -358,19 +465,19 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
 
     // check if layer is reached
     float targetX = 1e+3;
-    inputTrack.getXatLabR(layers[il].getRadius(), targetX, magneticField);
+    inputTrack.getXatLabR(table.radius[il], targetX, magneticField);
     if (targetX > 999.f) {
-      LOGF(debug, "Failed to find intercept for layer %d at radius %.2f cm", il, layers[il].getRadius());
+      LOGF(debug, "Failed to find intercept for layer %d at radius %.2f cm", il, table.radius[il]);
       break; // failed to find intercept
     }
 
     bool ok = inputTrack.propagateTo(targetX, magneticField);
-    if (ok && mApplyMSCorrection && layers[il].getRadiationLength() > 0) {
-      ok = inputTrack.correctForMaterial(layers[il].getRadiationLength(), 0, applyAngularCorrection);
+    if (ok && mApplyMSCorrection && table.x0[il] > 0) {
+      ok = inputTrack.correctForMaterial(table.x0[il], 0, applyAngularCorrection);
     }
-    if (ok && mApplyElossCorrection && layers[il].getDensity() > 0) { // correct in small steps
+    if (ok && mApplyElossCorrection && table.xrho[il] > 0) { // correct in small steps
       for (int ise = xrhosteps; ise--;) {
-        ok = inputTrack.correctForMaterial(0, -layers[il].getDensity() / xrhosteps, applyAngularCorrection);
+        ok = inputTrack.correctForMaterial(0, -table.xrho[il] / xrhosteps, applyAngularCorrection);
         if (!ok)
           break;
       }
@@ -380,7 +487,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     // was there a problem on this layer?
     if (!ok && il > 0) { // may fail to reach target layer due to the eloss
       float rad2 = inputTrack.getX() * inputTrack.getX() + inputTrack.getY() * inputTrack.getY();
-      float maxR = layers[il - 1].getRadius() + kTrackingMargin * 2;
+      float maxR = table.radius[il - 1] + kTrackingMargin * 2;
       float minRad = (fMinRadTrack > 0 && fMinRadTrack < maxR) ? fMinRadTrack : maxR;
       if (rad2 - minRad * minRad < kTrackingMargin * kTrackingMargin) { // check previously reached layer
         return -5;                                                      // did not reach min requested layer
@@ -389,18 +496,18 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       }
     }
 
-    if (std::abs(inputTrack.getZ()) > layers[il].getZ() && mApplyZacceptance) {
+    if (std::abs(inputTrack.getZ()) > table.z[il] && mApplyZacceptance) {
       break; // out of acceptance bounds
     }
 
-    if (layers[il].isInert()) {
+    if (table.type[il] == DetLayer::kLayerInert) {
       if (mVerboseLevel > 0) {
-        LOG(info) << "Skipping inert layer: " << layers[il].getName() << " at radius " << layers[il].getRadius() << " cm";
+        LOG(info) << "Skipping inert layer: " << layers[il].getName() << " at radius " << table.radius[il] << " cm";
       }
       continue; // inert layer, skip
     }
 
-    if (layers[il].isInDeadPhiRegion(inputTrack.getPhi())) {
+    if (IsInDeadPhiRegion(il, inputTrack.getPhi())) {
       LOGF(debug, "Track is in dead region of layer %d", il);
       continue; // dead region, skip
     }
@@ -442,7 +549,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
   for (int il = lastLayerReached; il >= firstLayerReached; il--) {
 
     float targetX = 1e+3;
-    inputTrack.getXatLabR(layers[il].getRadius(), targetX, magneticField);
+    inputTrack.getXatLabR(table.radius[il], targetX, magneticField);
     if (targetX > 999)
       continue; // failed to find intercept
 
@@ -450,14 +557,13 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       continue; // failed to propagate
     }
 
-    if (std::abs(inputTrack.getZ()) > layers[il].getZ() && mApplyZacceptance) {
+    if (std::abs(inputTrack.getZ()) > table.z[il] && mApplyZacceptance) {
       continue; // out of acceptance bounds but continue inwards
     }
 
     // get perfect data point position
     std::array<float, 3> spacePoint;
     inputTrack.getXYZGlo(spacePoint);
-    std::vector<float> thisHit = {spacePoint[0], spacePoint[1], spacePoint[2]};
 
     // towards adding cluster: move to track alpha
     float alpha = inwardTrack.getAlpha();
@@ -470,47 +576,47 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       continue;
     }
 
-    if (!layers[il].isInert()) { // only update covm for tracker hits
+    if (table.type[il] != DetLayer::kLayerInert) { // only update covm for tracker hits
       const o2::track::TrackParametrization<float>::dim2_t hitpoint = {
         static_cast<float>(xyz1[1]),
         static_cast<float>(xyz1[2])};
-      const o2::track::TrackParametrization<float>::dim3_t hitpointcov = {layers[il].getResolutionRPhi() * layers[il].getResolutionRPhi(), 0.f, layers[il].getResolutionZ() * layers[il].getResolutionZ()};
+      const o2::track::TrackParametrization<float>::dim3_t hitpointcov = {table.resRPhi2[il], 0.f, table.resZ2[il]};
 
       inwardTrack.update(hitpoint, hitpointcov);
       inwardTrack.checkCovariance();
     }
 
-    if (mApplyMSCorrection && layers[il].getRadiationLength() > 0) {
-      if (!inputTrack.correctForMaterial(layers[il].getRadiationLength(), 0, applyAngularCorrection)) {
+    if (mApplyMSCorrection && table.x0[il] > 0) {
+      if (!inputTrack.correctForMaterial(table.x0[il], 0, applyAngularCorrection)) {
         return -6;
       }
-      if (!inwardTrack.correctForMaterial(layers[il].getRadiationLength(), 0, applyAngularCorrection)) {
+      if (!inwardTrack.correctForMaterial(table.x0[il], 0, applyAngularCorrection)) {
         return -6;
       }
     }
-    if (mApplyElossCorrection && layers[il].getDensity() > 0) {
+    if (mApplyElossCorrection && table.xrho[il] > 0) {
       for (int ise = xrhosteps; ise--;) { // correct in small steps
-        if (!inputTrack.correctForMaterial(0, layers[il].getDensity() / xrhosteps, applyAngularCorrection)) {
+        if (!inputTrack.correctForMaterial(0, table.xrho[il] / xrhosteps, applyAngularCorrection)) {
           return -7;
         }
-        if (!inwardTrack.correctForMaterial(0, layers[il].getDensity() / xrhosteps, applyAngularCorrection)) {
+        if (!inwardTrack.correctForMaterial(0, table.xrho[il] / xrhosteps, applyAngularCorrection)) {
           return -7;
         }
       }
     }
 
-    if (layers[il].isSilicon()) {
-      nSiliconPoints++; // count silicon hits
+    if (table.type[il] == DetLayer::kLayerSilicon) {
+      state.nSiliconPoints++; // count silicon hits
     }
-    if (layers[il].isGas()) {
-      nGasPoints++; // count TPC/gas hits
+    if (table.type[il] == DetLayer::kLayerGas) {
+      state.nGasPoints++; // count TPC/gas hits
     }
 
-    hits.push_back(thisHit);
-    if (!layers[il].isInert()) { // good hit probability calculation
-      float sigYCmb = o2::math_utils::sqrt(inwardTrack.getSigmaY2() + layers[il].getResolutionRPhi() * layers[il].getResolutionRPhi());
-      float sigZCmb = o2::math_utils::sqrt(inwardTrack.getSigmaZ2() + layers[il].getResolutionZ() * layers[il].getResolutionZ());
-      goodHitProbability[il] = ProbGoodChiSqHit(layers[il].getRadius() * 100, sigYCmb * 100, sigZCmb * 100);
+    state.hits.insert(state.hits.end(), spacePoint.begin(), spacePoint.end());
+    if (table.type[il] != DetLayer::kLayerInert) { // good hit probability calculation
+      float sigYCmb = o2::math_utils::sqrt(inwardTrack.getSigmaY2() + table.resRPhi2[il]);
+      float sigZCmb = o2::math_utils::sqrt(inwardTrack.getSigmaZ2() + table.resZ2[il]);
+      goodHitProbability[il] = ProbGoodChiSqHit(table.radius[il] * 100, sigYCmb * 100, sigZCmb * 100, dNdEta);
       goodHitProbability[0] *= goodHitProbability[il];
     }
   }
@@ -543,7 +649,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     eff *= iGoodHit;
   }
   if (mApplyEffCorrection) {
-    if (gRandom->Uniform() > eff) {
+    if (random->Uniform() > eff) {
       return -8;
     }
   }
@@ -601,11 +707,11 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
       LOG(info) << "Cov matrix: ";
       m.Print();
     }
-    covMatNotOK++;
+    state.covMatNotOK++;
     nIntercepts = -1; // mark as problematic so that it isn't used
     return -1;
   }
-  covMatOK++;
+  state.covMatOK++;
 
   // transform parameter vector and smear
   float params_[5];
@@ -614,7 +720,7 @@ int FastTracker::FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackPa
     for (int j = 0; j < 5; ++j)
       val += eigVec[j][ii] * outputTrack.getParam(j);
     // smear parameters according to eigenvalues
-    params_[ii] = gRandom->Gaus(val, sqrt(eigVal[ii]));
+    params_[ii] = random->Gaus(val, sqrt(eigVal[ii]));
   }
 
   // invert eigenvector matrix
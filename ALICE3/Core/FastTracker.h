@@ -18,6 +18,7 @@
 #include <CCDB/BasicCCDBManager.h>
 #include <ReconstructionDataFormats/Track.h>
 
+#include <TRandom.h>
 #include <TString.h>
 
 #include <Rtypes.h>
@@ -34,6 +35,28 @@ namespace fastsim
 
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
 
+// scratch and output state of the fast tracking of one track
+// each thread tracking with the same FastTracker needs its own state
+struct FastTrackState {
+  int nIntercepts = 0;                   /// found in first outward propagation
+  int nSiliconPoints = 0;                /// silicon-based space points added to track
+  int nGasPoints = 0;                    /// tpc-based space points added to track
+  std::vector<float> goodHitProbability; /// good hit probability per layer, layer 0 holds the product
+  std::vector<float> hits;               /// x, y, z of each added hit, preallocated for all the layers
+  uint64_t covMatOK = 0;                 /// tracks whose cov mat has positive eigenvals
+  uint64_t covMatNotOK = 0;              /// tracks whose cov mat has negative eigenvals
+  TRandom* random = nullptr;             /// random generator of the smearing and efficiency, gRandom if null
+
+  std::size_t GetNHits() const { return hits.size() / 3; }
+  float GetHitX(const int i) const { return hits[3 * i]; }
+  float GetHitY(const int i) const { return hits[3 * i + 1]; }
+  float GetHitZ(const int i) const { return hits[3 * i + 2]; }
+  float GetGoodHitProb(int layer) const
+  {
+    return (layer >= 0 && static_cast<size_t>(layer) < goodHitProbability.size()) ? goodHitProbability[layer] : 0.0f;
+  }
+};
+
 // this class implements a synthetic smearer that allows
 // for on-demand smearing of TrackParCovs in a certain flexible t
 // detector layout.
@@ -58,11 +81,31 @@ class FastTracker
   int GetLayerIndex(const std::string& name) const;
   size_t GetNLayers() const { return layers.size(); }
   bool IsLayerInert(const int layer) const { return layers[layer].isInert(); }
-  void ClearLayers() { layers.clear(); }
-  void SetRadiationLength(const std::string layerName, float x0) { layers[GetLayerIndex(layerName)].setRadiationLength(x0); }
-  void SetRadius(const std::string layerName, float r) { layers[GetLayerIndex(layerName)].setRadius(r); }
-  void SetResolutionRPhi(const std::string layerName, float resRPhi) { layers[GetLayerIndex(layerName)].setResolutionRPhi(resRPhi); }
-  void SetResolutionZ(const std::string layerName, float resZ) { layers[GetLayerIndex(layerName)].setResolutionZ(resZ); }
+  void ClearLayers()
+  {
+    layers.clear();
+    mIsCompiled = false;
+  }
+  void SetRadiationLength(const std::string layerName, float x0)
+  {
+    layers[GetLayerIndex(layerName)].setRadiationLength(x0);
+    mIsCompiled = false;
+  }
+  void SetRadius(const std::string layerName, float r)
+  {
+    layers[GetLayerIndex(layerName)].setRadius(r);
+    mIsCompiled = false;
+  }
+  void SetResolutionRPhi(const std::string layerName, float resRPhi)
+  {
+    layers[GetLayerIndex(layerName)].setResolutionRPhi(resRPhi);
+    mIsCompiled = false;
+  }
+  void SetResolutionZ(const std::string layerName, float resZ)
+  {
+    layers[GetLayerIndex(layerName)].setResolutionZ(resZ);
+    mIsCompiled = false;
+  }
   void SetResolution(const std::string layerName, float resRPhi, float resZ)
   {
     SetResolutionRPhi(layerName, resRPhi);
@@ -84,6 +127,16 @@ class FastTracker
 
   void Print();
 
+  /**
+   * @brief Builds the tables of the layers read by FastTrack.
+   *
+   * The geometry, material and resolution of the layers are copied into contiguous arrays, and the dead regions
+   * in phi into a map of phi sectors. The non-reentrant FastTrack builds the tables at its first call after a change
+   * of the layers through the FastTracker; the reentrant FastTrack requires them to be built beforehand. Changes
+   * made through the pointer returned by AddLayer after the tables are built require to call CompileLayers again.
+   */
+  void CompileLayers();
+
   /**
    * @brief Performs fast tracking on the input track parameters.
    *
@@ -97,13 +150,23 @@ class FastTracker
    */
   int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, const float maxRadius = 100.f);
 
+  /**
+   * @brief Reentrant fast tracking, same as FastTrack above with the results in the given state.
+   *
+   * The tracker is not modified, so that several threads can track with the same FastTracker,
+   * each one with its own state (and its own random generator in the state).
+   */
+  int FastTrack(o2::track::TrackParCov inputTrack, o2::track::TrackParCov& outputTrack, const float nch, FastTrackState& state, const float maxRadius = 100.f) const;
+
   // For efficiency calculation
-  float Dist(float z, float radius);
-  float OneEventHitDensity(float multiplicity, float radius);
-  float IntegratedHitDensity(float multiplicity, float radius);
-  float UpcHitDensity(float radius);
-  float HitDensity(float radius);
-  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ);
+  float Dist(float z, float radius) const;
+  float OneEventHitDensity(float multiplicity, float radius) const;
+  float IntegratedHitDensity(float multiplicity, float radius) const;
+  float UpcHitDensity(float radius) const;
+  float HitDensity(float radius) const { return HitDensity(radius, dNdEtaCent); }
+  float HitDensity(float radius, float nch) const;
+  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ) const { return ProbGoodChiSqHit(radius, searchRadiusRPhi, searchRadiusZ, dNdEtaCent); }
+  float ProbGoodChiSqHit(float radius, float searchRadiusRPhi, float searchRadiusZ, float nch) const;
 
   // Setters and getters for configuration
   void SetIntegrationTime(float t) { integrationTime = t; }
@@ -119,25 +182,21 @@ class FastTracker
   void SetApplyElossCorrection(bool b) { mApplyElossCorrection = b; }
   void SetApplyEffCorrection(bool b) { mApplyEffCorrection = b; }
 
-  // Getters for the last track
-  int GetNIntercepts() const { return nIntercepts; }
-  int GetNSiliconPoints() const { return nSiliconPoints; }
-  int GetNGasPoints() const { return nGasPoints; }
-  float GetGoodHitProb(int layer) const
-  {
-    return (layer >= 0 && static_cast<size_t>(layer) < goodHitProbability.size()) ? goodHitProbability[layer] : 0.0f;
-  }
-  std::size_t GetNHits() const { return hits.size(); }
-  float GetHitX(const int i) const { return hits[i][0]; }
-  float GetHitY(const int i) const { return hits[i][1]; }
-  float GetHitZ(const int i) const { return hits[i][2]; }
-  uint64_t GetCovMatOK() const { return covMatOK; }
-  uint64_t GetCovMatNotOK() const { return covMatNotOK; }
+  // Getters for the last track tracked with the non-reentrant FastTrack
+  int GetNIntercepts() const { return mState.nIntercepts; }
+  int GetNSiliconPoints() const { return mState.nSiliconPoints; }
+  int GetNGasPoints() const { return mState.nGasPoints; }
+  float GetGoodHitProb(int layer) const { return mState.GetGoodHitProb(layer); }
+  std::size_t GetNHits() const { return mState.GetNHits(); }
+  float GetHitX(const int i) const { return mState.GetHitX(i); }
+  float GetHitY(const int i) const { return mState.GetHitY(i); }
+  float GetHitZ(const int i) const { return mState.GetHitZ(i); }
+  uint64_t GetCovMatOK() const { return mState.covMatOK; }
+  uint64_t GetCovMatNotOK() const { return mState.covMatNotOK; }
 
  private:
   // Definition of detector layers
   std::vector<DetLayer> layers;
-  std::vector<std::vector<float>> hits; // bookkeep last added hits
 
   /// configuration parameters
   bool mApplyZacceptance = false;       /// check z acceptance or not
@@ -160,17 +219,34 @@ class FastTracker
   float upcBackgroundMultiplier = 1.0f; /// multiplier for UPC background
   float fMinRadTrack = 132.f;           /// minimum radius for track propagation in cm
 
-  /// counters for covariance matrix statuses
-  uint64_t covMatOK = 0;    /// cov mat has positive eigenvals
-  uint64_t covMatNotOK = 0; /// cov mat has negative eigenvals
+  /// last track information and counters for covariance matrix statuses of the non-reentrant FastTrack
+  FastTrackState mState; //!
+
+  /// tables of the layers read by FastTrack, as a structure of arrays indexed by layer
+  struct CompiledLayers {
+    std::vector<float> radius;       /// radius in cm
+    std::vector<float> z;            /// z dimension in cm
+    std::vector<float> x0;           /// radiation length
+    std::vector<float> xrho;         /// density
+    std::vector<float> resRPhi2;     /// squared RPhi resolution in cm^2
+    std::vector<float> resZ2;        /// squared Z resolution in cm^2
+    std::vector<int> type;           /// layer type, as DetLayer
+    std::vector<int> deadSectors;    /// offset of the phi sectors of the layer in phiSectors, -1 without dead regions
+    std::vector<uint8_t> phiSectors; /// status of each phi sector of the layers with dead regions
+    int firstActiveLayer = -1;       /// first layer that is not inert
+  };
+  static constexpr int kNPhiSectors = 512; /// number of phi sectors of the dead region map
+  enum PhiSectorStatus : uint8_t {
+    kSectorAlive = 0, /// no dead region in the sector
+    kSectorDead,      /// the sector is in a dead region
+    kSectorMixed      /// the sector contains a border of a dead region, the dead regions of the layer are evaluated
+  };
+  CompiledLayers mCompiled; //!
+  bool mIsCompiled = false; //!
 
-  /// last track information
-  int nIntercepts = 0;    /// found in first outward propagation
-  int nSiliconPoints = 0; /// silicon-based space points added to track
-  int nGasPoints = 0;     /// tpc-based space points added to track
-  std::vector<float> goodHitProbability;
+  bool IsInDeadPhiRegion(int layer, float phi) const;
 
-  ClassDef(FastTracker, 1);
+  ClassDef(FastTracker, 2);
 };
 
 // +-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+-~-<*>-~-+
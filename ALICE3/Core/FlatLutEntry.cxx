@@ -14,13 +14,21 @@
 #include <Framework/Logger.h>
 #include <Framework/RuntimeError.h>
 
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
 #include <ios>
+#include <memory>
 #include <span>
+#include <utility>
 
 namespace o2::delphes
 {
@@ -266,10 +274,45 @@ FlatLutData FlatLutData::loadFromFile(std::ifstream& file, const char* filename)
   return data;
 }
 
+FlatLutData FlatLutData::mapFromFile(const char* filename)
+{
+  const int fd = ::open(filename, O_RDONLY);
+  if (fd < 0) {
+    throw framework::runtime_error_f("Cannot open LUT file %s: %s", filename, std::strerror(errno));
+  }
+  struct stat fileStat;
+  if (::fstat(fd, &fileStat) != 0) {
+    ::close(fd);
+    throw framework::runtime_error_f("Cannot stat LUT file %s: %s", filename, std::strerror(errno));
+  }
+  const size_t size = fileStat.st_size;
+  if (size < sizeof(lutHeader_t)) {
+    ::close(fd);
+    throw framework::runtime_error_f("File %s too small for LUT header: expected at least %zu, got %zu", filename, sizeof(lutHeader_t), size);
+  }
+  void* address = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  ::close(fd); // the mapping keeps its own reference to the file
+  if (address == MAP_FAILED) {
+    throw framework::runtime_error_f("Cannot map LUT file %s: %s", filename, std::strerror(errno));
+  }
+  std::shared_ptr<const void> mapping(address, [size](const void* ptr) { ::munmap(const_cast<void*>(ptr), size); });
+
+  // Only the page of the header is read here, the entries are read on first access
+  const auto* buffer = static_cast<const uint8_t*>(address);
+  validateBuffer(buffer, size);
+  FlatLutData data;
+  data.view(buffer, size);
+  data.mMapping = std::move(mapping);
+
+  LOGF(info, "Successfully mapped LUT from %s: %zu bytes", filename, size);
+  return data;
+}
+
 void FlatLutData::reset()
 {
   mData.clear();
   updateRef();
+  mMapping.reset();
   resetDimensions();
 }
 
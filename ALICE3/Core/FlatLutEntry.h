@@ -16,6 +16,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <fstream>
+#include <memory>
 #include <span>
 #include <vector>
 
@@ -90,6 +91,7 @@ struct lutHeader_t {
  *
  * All entries stored sequentially in a single allocation.
  * Can be directly mapped from file or shared memory without copying.
+ * The data is either owned (copy), a view of an external buffer, or a read-only memory map of a file.
  */
 class FlatLutData
 {
@@ -155,6 +157,13 @@ class FlatLutData
    */
   static FlatLutData loadFromFile(std::ifstream& file, const char* filename);
 
+  /**
+   * @brief Construct a new FlatLutData as a read-only memory map of a file
+   * The pages are shared by all the processes mapping the same file and are only read when accessed.
+   * The mapping is released with the last FlatLutData referring to it.
+   */
+  static FlatLutData mapFromFile(const char* filename);
+
   /**
    * @brief Preview buffer header for version and other compatibility checks
    */
@@ -209,6 +218,7 @@ class FlatLutData
 
   std::vector<uint8_t> mData;
   std::span<uint8_t const> mDataRef;
+  std::shared_ptr<const void> mMapping; // memory map viewed by mDataRef, if any
 
   // Cache dimensions for quick access
   int mNchBins = 0;
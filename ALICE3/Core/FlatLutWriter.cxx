@@ -26,13 +26,17 @@
 #include <TMatrixDSymfwd.h>
 #include <TMatrixDfwd.h>
 #include <TParticlePDG.h>
+#include <TRandom3.h>
 #include <TString.h>
 #include <TVectorDfwd.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 #include <fstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 using namespace o2::delphes;
 
@@ -48,6 +52,7 @@ void FlatLutWriter::print() const
   LOG(info) << "    -> mAtLeastHits  = " << mAtLeastHits;
   LOG(info) << "    -> mAtLeastCorr  = " << mAtLeastCorr;
   LOG(info) << "    -> mAtLeastFake  = " << mAtLeastFake;
+  LOG(info) << "    -> mNThreads     = " << mNThreads;
   LOG(info) << "    -> Nch Binning: = " << mNchBinning.toString();
   LOG(info) << "    -> Radius Binning: = " << mRadiusBinning.toString();
   LOG(info) << "    -> Eta Binning: = " << mEtaBinning.toString();
@@ -76,26 +81,40 @@ bool FlatLutWriter::fatSolve(lutEntry_t& lutEntry,
                              size_t otof,
                              int q,
                              const float nch)
+{
+  return fatSolve(lutEntry, nullptr, pt, eta, mass, itof, otof, q, nch);
+}
+
+bool FlatLutWriter::fatSolve(lutEntry_t& lutEntry,
+                             FastTrackState* state,
+                             float pt,
+                             float eta,
+                             const float mass,
+                             size_t itof,
+                             size_t otof,
+                             int q,
+                             const float nch)
 {
   lutEntry.valid = false;
 
-  static TLorentzVector tlv;
+  TLorentzVector tlv;
   tlv.SetPtEtaPhiM(pt, eta, 0.f, mass);
   o2::track::TrackParCov trkIn;
   o2::upgrade::convertTLorentzVectorToO2Track(q, tlv, {0.f, 0.f, 0.f}, trkIn);
 
   o2::track::TrackParCov trkOut;
-  const int status = fat.FastTrack(trkIn, trkOut, nch);
+  const int status = state ? fat.FastTrack(trkIn, trkOut, nch, *state) : fat.FastTrack(trkIn, trkOut, nch);
   if (status <= mAtLeastHits) {
     LOGF(debug, "fatSolve: FastTrack failed with status %d (threshold %d)", status, mAtLeastHits);
     return false;
   }
 
   LOGF(debug, "fatSolve: FastTrack succeeded with status %d", status);
+  auto getGoodHitProb = [&](size_t layer) { return state ? state->GetGoodHitProb(layer) : fat.GetGoodHitProb(layer); };
 
   lutEntry.valid = true;
-  lutEntry.itof = fat.GetGoodHitProb(itof);
-  lutEntry.otof = fat.GetGoodHitProb(otof);
+  lutEntry.itof = getGoodHitProb(itof);
+  lutEntry.otof = getGoodHitProb(otof);
 
   static constexpr int nCov = 15;
   for (int i = 0; i < nCov; ++i)
@@ -107,13 +126,13 @@ bool FlatLutWriter::fatSolve(lutEntry_t& lutEntry,
   for (size_t i = 1; i < fat.GetNLayers(); ++i) {
     if (fat.IsLayerInert(i))
       continue; // skip inert layers
-    auto igoodhit = fat.GetGoodHitProb(i);
+    auto igoodhit = getGoodHitProb(i);
     if (igoodhit <= 0.f || i == itof || i == otof)
       continue;
     lutEntry.eff *= igoodhit;
     auto pairfake = 0.f;
     for (size_t j = i + 1; j < fat.GetNLayers(); ++j) {
-      auto jgoodhit = fat.GetGoodHitProb(j);
+      auto jgoodhit = getGoodHitProb(j);
       if (jgoodhit <= 0.f || j == itof || j == otof)
         continue;
       pairfake = (1.f - igoodhit) * (1.f - jgoodhit);
@@ -141,6 +160,11 @@ bool FlatLutWriter::fwdSolve(float*, float, float, float)
 #endif
 
 bool FlatLutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, float mass, float Bfield)
+{
+  return fwdPara(lutEntry, nullptr, pt, eta, mass, Bfield);
+}
+
+bool FlatLutWriter::fwdPara(lutEntry_t& lutEntry, FastTrackState* state, float pt, float eta, float mass, float Bfield)
 {
   lutEntry.valid = false;
 
@@ -151,7 +175,7 @@ bool FlatLutWriter::fwdPara(lutEntry_t& lutEntry, float pt, float eta, float mas
     return false;
   }
 
-  if (!fatSolve(lutEntry, pt, etaMaxBarrel, mass)) {
+  if (!fatSolve(lutEntry, state, pt, etaMaxBarrel, mass)) {
     return false;
   }
 
@@ -280,93 +304,76 @@ void FlatLutWriter::lutWrite(const char* filename, int pdg, float field, size_t
 
   LOGF(info, "Writing LUT with dimensions: nch=%d rad=%d eta=%d pt=%d (total=%zu entries)", nnch, nrad, neta, npt, static_cast<size_t>(nnch) * nrad * neta * npt);
 
-  lutEntry_t lutEntry;
   int nCalls = 0;
   int successfulCalls = 0;
   int failedCalls = 0;
 
-  // Write all entries sequentially
+  // Write all entries sequentially, the entries of an nch bin are computed first
+  const int nCells = nrad * neta * npt; // cells per nch bin
+  const int nThreads = std::max(1, std::min(mNThreads, nCells));
+  std::vector<lutEntry_t> lutEntries(nCells);
+  std::vector<char> isSolved(nCells);
+  if (nThreads > 1) {
+    fat.CompileLayers(); // read by the threads, the layers must not change while writing
+  }
+  lutEntry_t lastEntry; // carries over the values of the previous cell, as a sequential solution
   for (int inch = 0; inch < nnch; ++inch) {
     LOGF(info, "Writing nch bin %d/%d", inch, nnch);
     auto nch = lutHeader.nchmap.eval(inch);
-    lutEntry.nch = nch;
     fat.SetdNdEtaCent(nch);
 
-    for (int irad = 0; irad < nrad; ++irad) {
-      for (int ieta = 0; ieta < neta; ++ieta) {
-        auto eta = lutHeader.etamap.eval(ieta);
-        lutEntry.eta = eta;
-
-        for (int ipt = 0; ipt < npt; ++ipt) {
-          nCalls++;
-          lutEntry.pt = lutHeader.ptmap.eval(ipt);
-          lutEntry.valid = true;
-
-          // Solve for this bin
-          if (std::fabs(eta) <= etaMaxBarrel) {
-            // Full lever arm region (barrel)
-            LOGF(debug, "Solving barrel: pt=%f eta=%f", lutEntry.pt, lutEntry.eta);
-            successfulCalls++;
-
-            if (!fatSolve(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, itof, otof, q, nch)) {
-              lutEntry.valid = false;
-              lutEntry.eff = 0.f;
-              lutEntry.eff2 = 0.f;
-              for (int i = 0; i < 15; ++i) {
-                lutEntry.covm[i] = 0.f;
-              }
-              successfulCalls--;
-              failedCalls++;
-            }
-          } else {
-            // Forward region
-            LOGF(debug, "Solving forward: pt=%f eta=%f", lutEntry.pt, lutEntry.eta);
-            lutEntry.eff = 1.f;
-            lutEntry.eff2 = 1.f;
-            bool retval = true;
-            successfulCalls++;
-
-            if (useFlatDipole) {
-              // Using the parametrization at the border of the barrel
-              retval = fatSolve(lutEntry, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q, nch);
-            } else if (usePara) {
-              retval = fwdPara(lutEntry, lutEntry.pt, lutEntry.eta, lutHeader.mass, field);
-            } else {
-              retval = fwdSolve(lutEntry.covm, lutEntry.pt, lutEntry.eta, lutHeader.mass);
-            }
-
-            if (useDipole) {
-              // Using the parametrization at the border of the barrel only for efficiency and momentum resolution
-              lutEntry_t lutEntryBarrel;
-              retval = fatSolve(lutEntryBarrel, lutEntry.pt, etaMaxBarrel, lutHeader.mass, itof, otof, q, nch);
-              lutEntry.valid = lutEntryBarrel.valid;
-              lutEntry.covm[14] = lutEntryBarrel.covm[14];
-              lutEntry.eff = lutEntryBarrel.eff;
-              lutEntry.eff2 = lutEntryBarrel.eff2;
-            }
-
-            if (!retval) {
-              LOGF(debug, "Forward solve failed");
-              lutEntry.valid = false;
-              for (int i = 0; i < 15; ++i) {
-                lutEntry.covm[i] = 0.f;
-              }
-              successfulCalls--;
-              failedCalls++;
-            }
-          }
-
-          // Diagonalize covariance matrix
-          diagonalise(lutEntry);
-
-          // Write entry to file
-          lutFile.write(reinterpret_cast<char*>(&lutEntry), sizeof(lutEntry_t));
-          if (!lutFile.good()) {
-            LOGF(error, "Failed to write LUT entry at index [%d,%d,%d,%d]", inch, irad, ieta, ipt);
-            lutFile.close();
-            return;
-          }
+    // Solves the cells [first, last) in order, starting from the values of the entry
+    auto solveCells = [&](int first, int last, lutEntry_t lutEntry, FastTrackState* state) {
+      TRandom3 random;
+      if (state) {
+        state->random = &random;
+      }
+      for (int iCell = first; iCell < last; ++iCell) {
+        if (state) {
+          random.SetSeed(mRandomSeed + static_cast<uint32_t>(inch * nCells + iCell) + 1u); // 0 would be a time-based seed
         }
+        lutEntry.nch = nch;
+        lutEntry.eta = lutHeader.etamap.eval((iCell / npt) % neta);
+        lutEntry.pt = lutHeader.ptmap.eval(iCell % npt);
+        isSolved[iCell] = solveCell(lutEntry, state, lutHeader.mass, itof, otof, q, field);
+        lutEntries[iCell] = lutEntry;
+      }
+      if (state) {
+        state->random = nullptr;
+      }
+    };
+
+    if (nThreads == 1) {
+      solveCells(0, nCells, lastEntry, nullptr);
+    } else {
+      // contiguous ranges of cells per thread, each with its own tracking state
+      std::vector<std::thread> threads;
+      std::vector<FastTrackState> states(nThreads);
+      for (int iThread = 0; iThread < nThreads; ++iThread) {
+        const int first = static_cast<long>(nCells) * iThread / nThreads;
+        const int last = static_cast<long>(nCells) * (iThread + 1) / nThreads;
+        threads.emplace_back(solveCells, first, last, iThread == 0 ? lastEntry : lutEntry_t(), &states[iThread]);
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+    }
+    lastEntry = lutEntries[nCells - 1];
+
+    for (int iCell = 0; iCell < nCells; ++iCell) {
+      nCalls++;
+      if (isSolved[iCell]) {
+        successfulCalls++;
+      } else {
+        failedCalls++;
+      }
+
+      // Write entry to file
+      lutFile.write(reinterpret_cast<char*>(&lutEntries[iCell]), sizeof(lutEntry_t));
+      if (!lutFile.good()) {
+        LOGF(error, "Failed to write LUT entry at index [%d,%d,%d,%d]", inch, iCell / (neta * npt), (iCell / npt) % neta, iCell % npt);
+        lutFile.close();
+        return;
       }
     }
   }
@@ -377,6 +384,67 @@ void FlatLutWriter::lutWrite(const char* filename, int pdg, float field, size_t
   LOGF(info, "Total calls: %d, successful: %d, failed: %d", nCalls, successfulCalls, failedCalls);
 }
 
+bool FlatLutWriter::solveCell(lutEntry_t& lutEntry, FastTrackState* state, const float mass, size_t itof, size_t otof, int q, float field)
+{
+  const float nch = lutEntry.nch;
+  bool isSolved = true;
+  lutEntry.valid = true;
+
+  // Solve for this bin
+  if (std::fabs(lutEntry.eta) <= etaMaxBarrel) {
+    // Full lever arm region (barrel)
+    LOGF(debug, "Solving barrel: pt=%f eta=%f", lutEntry.pt, lutEntry.eta);
+
+    if (!fatSolve(lutEntry, state, lutEntry.pt, lutEntry.eta, mass, itof, otof, q, nch)) {
+      lutEntry.valid = false;
+      lutEntry.eff = 0.f;
+      lutEntry.eff2 = 0.f;
+      for (int i = 0; i < 15; ++i) {
+        lutEntry.covm[i] = 0.f;
+      }
+      isSolved = false;
+    }
+  } else {
+    // Forward region
+    LOGF(debug, "Solving forward: pt=%f eta=%f", lutEntry.pt, lutEntry.eta);
+    lutEntry.eff = 1.f;
+    lutEntry.eff2 = 1.f;
+    bool retval = true;
+
+    if (useFlatDipole) {
+      // Using the parametrization at the border of the barrel
+      retval = fatSolve(lutEntry, state, lutEntry.pt, etaMaxBarrel, mass, itof, otof, q, nch);
+    } else if (usePara) {
+      retval = fwdPara(lutEntry, state, lutEntry.pt, lutEntry.eta, mass, field);
+    } else {
+      retval = fwdSolve(lutEntry.covm, lutEntry.pt, lutEntry.eta, mass);
+    }
+
+    if (useDipole) {
+      // Using the parametrization at the border of the barrel only for efficiency and momentum resolution
+      lutEntry_t lutEntryBarrel;
+      retval = fatSolve(lutEntryBarrel, state, lutEntry.pt, etaMaxBarrel, mass, itof, otof, q, nch);
+      lutEntry.valid = lutEntryBarrel.valid;
+      lutEntry.covm[14] = lutEntryBarrel.covm[14];
+      lutEntry.eff = lutEntryBarrel.eff;
+      lutEntry.eff2 = lutEntryBarrel.eff2;
+    }
+
+    if (!retval) {
+      LOGF(debug, "Forward solve failed");
+      lutEntry.valid = false;
+      for (int i = 0; i < 15; ++i) {
+        lutEntry.covm[i] = 0.f;
+      }
+      isSolved = false;
+    }
+  }
+
+  // Diagonalize covariance matrix
+  diagonalise(lutEntry);
+  return isSolved;
+}
+
 void FlatLutWriter::diagonalise(lutEntry_t& lutEntry)
 {
   static constexpr int kEig = 5;
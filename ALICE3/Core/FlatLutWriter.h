@@ -20,6 +20,7 @@
 #include <TGraph.h>
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 namespace o2::fastsim
 {
@@ -32,6 +33,9 @@ using lutEntry_t = o2::delphes::lutEntry_t;
  *   [lutHeader_t][lutEntry_t_0][lutEntry_t_1]...[lutEntry_t_N]
  *
  * This enables zero-copy loading into the TrackSmearer and direct shared memory mapping.
+ *
+ * The entries of each nch bin can be computed on several threads, which share the FastTracker and each
+ * have their own tracking state and random generator (see setNThreads).
  */
 class FlatLutWriter
 {
@@ -49,6 +53,12 @@ class FlatLutWriter
   void setAtLeastCorr(int n) { mAtLeastCorr = n; }
   void setAtLeastFake(int n) { mAtLeastFake = n; }
 
+  /// Number of threads computing the entries, 1 to compute them sequentially with gRandom.
+  /// With more threads the random generator of each entry is seeded from the seed and the index of the entry,
+  /// so that the output does not depend on the number of threads
+  void setNThreads(int n) { mNThreads = n; }
+  void setRandomSeed(uint32_t seed) { mRandomSeed = seed; }
+
   bool fatSolve(lutEntry_t& lutEntry,
                 float pt = 0.1f,
                 float eta = 0.0f,
@@ -69,6 +79,13 @@ class FlatLutWriter
  private:
   void diagonalise(lutEntry_t& lutEntry);
 
+  // Same as the public ones with the tracking state of the calling thread, the state of fat if null
+  bool fatSolve(lutEntry_t& lutEntry, FastTrackState* state, float pt, float eta, const float mass, size_t itof = 0, size_t otof = 0, int q = 1, const float nch = 1.0f);
+  bool fwdPara(lutEntry_t& lutEntry, FastTrackState* state, float pt, float eta, float mass, float Bfield);
+
+  // Computes the entry of one cell, whose nch, eta and pt are set. Returns false if the solution failed
+  bool solveCell(lutEntry_t& lutEntry, FastTrackState* state, const float mass, size_t itof, size_t otof, int q, float field);
+
   float etaMaxBarrel = 1.75f;
   bool usePara = true;        // use fwd parametrisation
   bool useDipole = false;     // use dipole i.e. flat parametrization for efficiency and momentum resolution
@@ -78,6 +95,9 @@ class FlatLutWriter
   int mAtLeastCorr = 4;
   int mAtLeastFake = 0;
 
+  int mNThreads = 1;        // number of threads computing the entries
+  uint32_t mRandomSeed = 0; // seed of the random generators of the entries, with more than one thread
+
   // Binning of the LUT to make
   struct LutBinning {
     bool log;
@@ -14,6 +14,7 @@
 #include "ALICE3/Core/FlatLutEntry.h"
 #include "ALICE3/Core/GeometryContainer.h"
 
+#include <CommonConstants/MathConstants.h>
 #include <CommonConstants/PhysicsConstants.h>
 #include <Framework/Logger.h>
 #include <Framework/RuntimeError.h>
@@ -28,6 +29,26 @@
 #include <span>
 #include <string>
 
+namespace
+{
+// Counter-based random numbers: the draw k of the track i of a batch only depends on (seed, i, k)
+constexpr uint64_t kDrawsPerTrack = 8; // 1 for the efficiency, 6 for the 3 pairs of Gaussian numbers, 1 spare
+
+uint64_t splitMix64(uint64_t x)
+{
+  x += 0x9e3779b97f4a7c15ULL;
+  x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+}
+
+/// \return uniform number in (0, 1)
+double counterUniform(uint64_t seed, uint64_t counter)
+{
+  return ((splitMix64(seed ^ splitMix64(counter)) >> 11) + 0.5) * 0x1.0p-53;
+}
+} // namespace
+
 namespace o2::delphes
 {
 int TrackSmearer::getIndexPDG(int pdg)
@@ -107,16 +128,20 @@ bool TrackSmearer::loadTable(int pdg, const char* filename, bool forceReload)
   LOGF(info, "Loading %s LUT file: '%s'", getParticleName(pdg), filename);
   const std::string localFilename = o2::fastsim::GeometryEntry::accessFile(filename, "./.ALICE3/LUTs/", mCcdbManager, 10);
 
-  std::ifstream lutFile(localFilename, std::ifstream::binary);
-  if (!lutFile.is_open()) {
-    throw framework::runtime_error_f("Cannot open LUT file: %s", localFilename.c_str());
+  std::ifstream lutFile;
+  if (!mMapTables) {
+    lutFile.open(localFilename, std::ifstream::binary);
+    if (!lutFile.is_open()) {
+      throw framework::runtime_error_f("Cannot open LUT file: %s", localFilename.c_str());
+    }
   }
 
   try {
-    mLUTData[ipdg] = FlatLutData::loadFromFile(lutFile, localFilename.c_str());
+    // The memory mapped tables are shared by all the processes using the same file
+    mLUTData[ipdg] = mMapTables ? FlatLutData::mapFromFile(localFilename.c_str()) : FlatLutData::loadFromFile(lutFile, localFilename.c_str());
 
     // Validate header
-    auto header = mLUTData[ipdg].getHeader();
+    const auto& header = mLUTData[ipdg].getHeaderRef();
     if (header.pdg != pdg && !checkSpecialCase(pdg, header)) {
       LOGF(error, "LUT header PDG mismatch: expected %d, got %d; not loading", pdg, header.pdg);
       return false;
@@ -299,6 +324,15 @@ const lutEntry_t* TrackSmearer::getLUTEntry(const int pdg, const float nch, cons
 }
 
 bool TrackSmearer::smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff)
+{
+  // FIXME: use a fixed RNG instead of whatever ROOT has as a default
+  auto uniform = []() { return gRandom->Uniform(); };
+  auto gaus = [](double mean, double sigma) { return gRandom->Gaus(mean, sigma); };
+  return smearTrackWith(o2track, lutEntry, interpolatedEff, uniform, gaus);
+}
+
+template <typename UniformGenerator, typename GausGenerator>
+bool TrackSmearer::smearTrackWith(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff, UniformGenerator&& uniform, GausGenerator&& gaus)
 {
   bool isReconstructed = true;
 
@@ -316,7 +350,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, floa
     if (mInterpolateEfficiency) {
       eff = interpolatedEff;
     }
-    if (gRandom->Uniform() > eff) { // FIXME: use a fixed RNG instead of whatever ROOT has as a default
+    if (uniform() > eff) {
       isReconstructed = false;
     }
   }
@@ -334,7 +368,7 @@ bool TrackSmearer::smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, floa
     for (int j = 0; j < kParSize; ++j) {
       val += lutEntry->eigvec[j][i] * o2track.getParam(j);
     }
-    params[i] = gRandom->Gaus(val, std::sqrt(lutEntry->eigval[i]));
+    params[i] = gaus(val, std::sqrt(lutEntry->eigval[i]));
   }
 
   // Transform back params vector
@@ -381,6 +415,81 @@ bool TrackSmearer::smearTrack(O2Track& o2track, int pdg, float nch)
   return smearTrack(o2track, lutEntry, interpolatedEff);
 }
 
+void TrackSmearer::smearTracks(std::span<O2Track> tracks, std::span<const int> pdgs, float nch, std::span<uint8_t> isReconstructed, uint64_t seed)
+{
+  const size_t nTracks = tracks.size();
+  if (pdgs.size() != nTracks || isReconstructed.size() != nTracks) {
+    throw framework::runtime_error_f("smearTracks: %zu tracks, %zu PDG codes and %zu flags", nTracks, pdgs.size(), isReconstructed.size());
+  }
+
+  // multiplicity and radius bins, the same for all the tracks using a LUT
+  int nchBins[nLUTs];
+  int radBins[nLUTs];
+  for (unsigned int iLUT = 0; iLUT < nLUTs; ++iLUT) {
+    if (mLUTData[iLUT].isLoaded()) {
+      const auto& header = mLUTData[iLUT].getHeaderRef();
+      nchBins[iLUT] = header.nchmap.find(nch);
+      radBins[iLUT] = header.radmap.find(0.f);
+    }
+  }
+
+  // LUT entries and efficiencies
+  mBatchEntries.resize(nTracks);
+  mBatchEfficiencies.resize(nTracks);
+  for (size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+    const int pdg = pdgs[iTrack];
+    float pt = tracks[iTrack].getPt();
+    if (pdg == o2::constants::physics::kHelium3 || pdg == -o2::constants::physics::kHelium3) {
+      pt *= 2.f;
+    }
+    const float eta = tracks[iTrack].getEta();
+    mBatchEfficiencies[iTrack] = 0.f;
+    if (mInterpolateEfficiency) { // the interpolation needs the neighbouring multiplicity bins
+      mBatchEntries[iTrack] = getLUTEntry(pdg, nch, 0.f, eta, pt, mBatchEfficiencies[iTrack]);
+      continue;
+    }
+    const int ipdg = getIndexPDG(pdg);
+    if (!mLUTData[ipdg].isLoaded()) {
+      mBatchEntries[iTrack] = nullptr;
+      continue;
+    }
+    const auto& header = mLUTData[ipdg].getHeaderRef();
+    const auto* entry = mLUTData[ipdg].getEntryRef(nchBins[ipdg], radBins[ipdg], header.etamap.find(eta), header.ptmap.find(pt));
+    mBatchEntries[iTrack] = entry;
+    if (mWhatEfficiency == 1) {
+      mBatchEfficiencies[iTrack] = entry->eff;
+    } else if (mWhatEfficiency == 2) {
+      mBatchEfficiencies[iTrack] = entry->eff2;
+    }
+  }
+
+  // smearing
+  for (size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+    const lutEntry_t* lutEntry = mBatchEntries[iTrack];
+    if (!lutEntry || !lutEntry->valid) {
+      isReconstructed[iTrack] = 0;
+      continue;
+    }
+    const uint64_t firstCounter = iTrack * kDrawsPerTrack;
+    int iGaus = 0;
+    double pendingGaus = 0.;
+    auto uniform = [&]() { return counterUniform(seed, firstCounter); };
+    auto gaus = [&](double mean, double sigma) {
+      // Box-Muller, the numbers are generated in pairs
+      if (iGaus % 2) {
+        ++iGaus;
+        return mean + sigma * pendingGaus;
+      }
+      const double radius = std::sqrt(-2. * std::log(counterUniform(seed, firstCounter + 1 + iGaus)));
+      const double angle = o2::constants::math::TwoPI * counterUniform(seed, firstCounter + 2 + iGaus);
+      pendingGaus = radius * std::sin(angle);
+      ++iGaus;
+      return mean + sigma * radius * std::cos(angle);
+    };
+    isReconstructed[iTrack] = smearTrackWith(tracks[iTrack], lutEntry, mBatchEfficiencies[iTrack], uniform, gaus);
+  }
+}
+
 double TrackSmearer::getPtRes(const int pdg, const float nch, const float eta, const float pt) const
 {
   float dummy = 0.0f;
@@ -20,6 +20,7 @@
 #include <cstddef>
 #include <cstdint>
 #include <span>
+#include <vector>
 
 namespace o2::delphes
 {
@@ -42,6 +43,7 @@ class TrackSmearer
   void useEfficiency(bool val) { mUseEfficiency = val; }
   void interpolateEfficiency(bool val) { mInterpolateEfficiency = val; }
   void skipUnreconstructed(bool val) { mSkipUnreconstructed = val; }
+  void mapTables(bool val) { mMapTables = val; }
   void setWhatEfficiency(int val);
 
   const lutHeader_t* getLUTHeader(int pdg) const;
@@ -50,6 +52,19 @@ class TrackSmearer
   bool smearTrack(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff);
   bool smearTrack(O2Track& o2track, int pdg, float nch);
 
+  /**
+   * @brief Smears a batch of tracks, as smearTrack(o2track, pdg, nch) for each track
+   * The bins of the LUTs are looked up for the whole batch, the multiplicity and radius bins once per LUT.
+   * The random numbers of the track i of the batch only depend on (seed, i), and not on the state of gRandom,
+   * so that the result is reproducible for a given seed.
+   * @param tracks tracks to smear, in place
+   * @param pdgs PDG code of each track
+   * @param nch multiplicity of the event
+   * @param isReconstructed output, the track is reconstructed (1) or not (0)
+   * @param seed seed of the random numbers of the batch
+   */
+  void smearTracks(std::span<O2Track> tracks, std::span<const int> pdgs, float nch, std::span<uint8_t> isReconstructed, uint64_t seed);
+
   double getPtRes(const int pdg, const float nch, const float eta, const float pt) const;
   double getEtaRes(const int pdg, const float nch, const float eta, const float pt) const;
   double getAbsPtRes(const int pdg, const float nch, const float eta, const float pt) const;
@@ -69,13 +84,20 @@ class TrackSmearer
   bool mUseEfficiency = true;
   bool mInterpolateEfficiency = false;
   bool mSkipUnreconstructed = true; // don't smear tracks that are not reco'ed
+  bool mMapTables = true;           // memory map the LUT files instead of reading them
   int mWhatEfficiency = 1;
   float mdNdEta = 1600.f;
 
  private:
   o2::ccdb::BasicCCDBManager* mCcdbManager = nullptr;
 
+  std::vector<const lutEntry_t*> mBatchEntries; // LUT entry of each track of the batch
+  std::vector<float> mBatchEfficiencies;        // efficiency of each track of the batch
+
   static bool checkSpecialCase(int pdg, lutHeader_t const& header);
+
+  template <typename UniformGenerator, typename GausGenerator>
+  bool smearTrackWith(O2Track& o2track, const lutEntry_t* lutEntry, float interpolatedEff, UniformGenerator&& uniform, GausGenerator&& gaus);
 };
 
 } // namespace o2::delphes
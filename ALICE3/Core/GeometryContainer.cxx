@@ -25,6 +25,7 @@
 
 #include <TEnv.h>
 #include <THashList.h>
+#include <TMD5.h>
 #include <TString.h>
 #include <TSystem.h>
 
@@ -36,6 +37,7 @@
 #include <chrono>
 #include <cstdio>
 #include <fstream>
+#include <iterator>
 #include <map>
 #include <string>
 #include <thread>
@@ -47,6 +49,20 @@
 namespace o2::fastsim
 {
 
+GeometryEntry::GeometryEntry(std::string filename, o2::ccdb::BasicCCDBManager* ccdb)
+{
+  mFileName = accessFile(filename, "./.ALICE3/Configuration/", ccdb);
+  if (GeometryContainer::cacheConfigurations()) {
+    mConfigurations = GeometryEntry::parseCachedConfiguration(mFileName, mLayerNames, GeometryContainer::configurationCachePath());
+  } else {
+    mConfigurations = GeometryEntry::parseTEnvConfiguration(mFileName, mLayerNames);
+  }
+  LOG(info) << "Loaded geometry configuration from file: " << mFileName << " with " << mLayerNames.size() << " layers.";
+  if (mLayerNames.empty()) {
+    LOG(warning) << "No layers found in geometry configuration file: " << filename;
+  }
+}
+
 std::map<std::string, std::map<std::string, std::string>> GeometryEntry::parseTEnvConfiguration(std::string& filename, std::vector<std::string>& layers)
 {
   std::map<std::string, std::map<std::string, std::string>> configMap;
@@ -83,7 +99,78 @@ std::map<std::string, std::map<std::string, std::string>> GeometryEntry::parseTE
   return configMap;
 }
 
+std::map<std::string, std::map<std::string, std::string>> GeometryEntry::parseCachedConfiguration(std::string& filename, std::vector<std::string>& layers, const std::string& cachePath)
+{
+  static constexpr const char* CacheHeader = "ALICE3GeometryCache 2";
+  filename = gSystem->ExpandPathName(filename.c_str());
+  std::ifstream file(filename, std::ios::binary);
+  if (!file.is_open()) {
+    return parseTEnvConfiguration(filename, layers);
+  }
+  const std::string content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+  TMD5 digest;
+  digest.Update(reinterpret_cast<const UChar_t*>(content.data()), content.size());
+  digest.Final();
+  const std::string cacheFile = cachePath + "/" + digest.AsString() + "_" + std::to_string(content.size()) + ".txt";
+
+  // Read the cached configuration, if any. The entry keeps a copy of the parsed file, which must match the file
+  // byte by byte, so that a digest collision or a stale entry can never be used
+  std::ifstream cache(cacheFile, std::ios::binary);
+  std::string line;
+  if (cache.is_open() && std::getline(cache, line) && line == CacheHeader) {
+    std::string cachedContent(content.size(), '\0');
+    cache.read(cachedContent.data(), cachedContent.size());
+    bool isValid = cache.gcount() == static_cast<std::streamsize>(content.size()) && cachedContent == content && std::getline(cache, line) && line.empty();
+    std::map<std::string, std::map<std::string, std::string>> configMap;
+    layers.clear();
+    while (isValid && std::getline(cache, line)) {
+      const auto firstTab = line.find('\t');
+      const auto secondTab = line.find('\t', firstTab + 1);
+      if (firstTab == std::string::npos || secondTab == std::string::npos) {
+        isValid = false;
+        break;
+      }
+      const std::string layer = line.substr(0, firstTab);
+      if (std::find(layers.begin(), layers.end(), layer) == layers.end()) {
+        layers.push_back(layer);
+      }
+      configMap[layer][line.substr(firstTab + 1, secondTab - firstTab - 1)] = line.substr(secondTab + 1);
+    }
+    if (isValid) {
+      LOG(info) << "Read parsed configuration of " << filename << " from cache " << cacheFile;
+      return configMap;
+    }
+    LOG(warning) << "Invalid cache " << cacheFile << ", parsing the configuration again";
+  }
+
+  // Parse the configuration and store it in the cache, unless it can not be represented in the cache format
+  std::map<std::string, std::map<std::string, std::string>> configMap = parseTEnvConfiguration(filename, layers);
+  std::string cacheContent = std::string(CacheHeader) + "\n" + content + "\n";
+  for (const auto& layer : layers) {
+    for (const auto& [paramName, value] : configMap[layer]) {
+      if ((layer + paramName + value).find_first_of("\t\n") != std::string::npos) {
+        LOG(info) << "Configuration of " << filename << " can not be cached";
+        return configMap;
+      }
+      cacheContent += layer + "\t" + paramName + "\t" + value + "\n";
+    }
+  }
+  gSystem->mkdir(cachePath.c_str(), true);
+  // Write to a file of this process and move it in place, so that concurrent jobs never read a partial cache
+  const std::string temporaryFile = cacheFile + "." + std::to_string(getpid());
+  std::ofstream output(temporaryFile, std::ios::binary);
+  output << cacheContent;
+  output.close();
+  if (!output || std::rename(temporaryFile.c_str(), cacheFile.c_str()) != 0) {
+    LOG(warning) << "Could not write the configuration cache " << cacheFile;
+    std::remove(temporaryFile.c_str());
+  }
+  return configMap;
+}
+
 bool GeometryContainer::mCleanLutWhenLoaded = true;
+bool GeometryContainer::mCacheConfigurations = false;
+std::string GeometryContainer::mConfigurationCachePath = "./.ALICE3/Configuration/cache/";
 void GeometryContainer::init(o2::framework::InitContext& initContext)
 {
   std::vector<std::string> detectorConfiguration;
@@ -102,6 +189,15 @@ void GeometryContainer::init(o2::framework::InitContext& initContext)
   }
   setLutCleanupSetting(cleanLutWhenLoaded);
 
+  bool cacheParsedConfigurations;
+  if (common::core::getTaskOptionValue(initContext, "on-the-fly-detector-geometry-provider", "cacheParsedConfigurations", cacheParsedConfigurations, false)) {
+    setConfigurationCacheSetting(cacheParsedConfigurations);
+  }
+  std::string configurationCachePath;
+  if (common::core::getTaskOptionValue(initContext, "on-the-fly-detector-geometry-provider", "configurationCachePath", configurationCachePath, false)) {
+    setConfigurationCachePath(configurationCachePath);
+  }
+
   for (std::string& configFile : detectorConfiguration) {
     LOG(info) << "Detector geometry configuration file used: " << configFile;
     addEntry(configFile);
@@ -33,15 +33,7 @@ namespace o2::fastsim
 struct GeometryEntry {
   // Default constructor
   GeometryEntry() = default;
-  explicit GeometryEntry(std::string filename, o2::ccdb::BasicCCDBManager* ccdb = nullptr)
-  {
-    mFileName = accessFile(filename, "./.ALICE3/Configuration/", ccdb);
-    mConfigurations = GeometryEntry::parseTEnvConfiguration(mFileName, mLayerNames);
-    LOG(info) << "Loaded geometry configuration from file: " << mFileName << " with " << mLayerNames.size() << " layers.";
-    if (mLayerNames.empty()) {
-      LOG(warning) << "No layers found in geometry configuration file: " << filename;
-    }
-  }
+  explicit GeometryEntry(std::string filename, o2::ccdb::BasicCCDBManager* ccdb = nullptr);
 
   /**
    * @brief Parses a TEnv configuration file and returns the key-value pairs split per entry
@@ -51,6 +43,15 @@ struct GeometryEntry {
    */
   static std::map<std::string, std::map<std::string, std::string>> parseTEnvConfiguration(std::string& filename, std::vector<std::string>& layers);
 
+  /**
+   * @brief Same as parseTEnvConfiguration, but the parsed configuration is cached on local disk. The cache entries are keyed by the MD5 digest and the size of the content of the file, and keep a copy of the file which is compared to it before use, so that a configuration is parsed once for all the tasks and jobs using it, and again only if the file changes.
+   * @param filename Path to the TEnv configuration file
+   * @param layers Vector to store the order of the layers as they appear in the file
+   * @param cachePath The local directory of the cache. Default is "./.ALICE3/Configuration/cache/"
+   * @return A map where each key is a layer name and the value is another map of key-value pairs for that layer
+   */
+  static std::map<std::string, std::map<std::string, std::string>> parseCachedConfiguration(std::string& filename, std::vector<std::string>& layers, const std::string& cachePath = "./.ALICE3/Configuration/cache/");
+
   /**
    * @brief Accesses a file given its path, which can be either a local path or a ccdb path (starting with "ccdb:"). In the first case it returns the local path, in the second it retrieves the file from ccdb and returns the local path to the retrieved file.
    * @param path The path to the file, either local or ccdb (starting with "ccdb:")
@@ -91,6 +92,8 @@ class GeometryContainer
   // Add a geometry entry from a configuration file
   void addEntry(const std::string& filename);
   static void setLutCleanupSetting(const bool cleanLutWhenLoaded) { mCleanLutWhenLoaded = cleanLutWhenLoaded; }
+  static void setConfigurationCacheSetting(const bool cacheConfigurations) { mCacheConfigurations = cacheConfigurations; }
+  static void setConfigurationCachePath(const std::string& cachePath) { mConfigurationCachePath = cachePath; }
   void setCcdbManager(o2::ccdb::BasicCCDBManager* mgr) { mCcdb = mgr; }
 
   // Getters
@@ -99,6 +102,8 @@ class GeometryContainer
   const GeometryEntry& getEntry(const int id) const { return mEntries.at(id); }
   GeometryEntry getGeometryEntry(const int id) const { return mEntries.at(id); }
   static bool cleanLutWhenLoaded() { return mCleanLutWhenLoaded; }
+  static bool cacheConfigurations() { return mCacheConfigurations; }
+  static const std::string& configurationCachePath() { return mConfigurationCachePath; }
 
   // Get configuration maps
   std::map<std::string, std::map<std::string, std::string>> getConfigurations(const int id) const { return mEntries.at(id).getConfigurations(); }
@@ -109,7 +114,9 @@ class GeometryContainer
   float getFloatValue(const int id, const std::string& layerName, const std::string& key) const { return mEntries.at(id).getFloatValue(layerName, key); }
 
  private:
-  static bool mCleanLutWhenLoaded; // Whether to clean the LUT when loading a new geometry configuration
+  static bool mCleanLutWhenLoaded;            // Whether to clean the LUT when loading a new geometry configuration
+  static bool mCacheConfigurations;           // Whether to cache the parsed geometry configurations on local disk
+  static std::string mConfigurationCachePath; // Local directory of the cache of the parsed geometry configurations
   std::vector<GeometryEntry> mEntries;
   o2::ccdb::BasicCCDBManager* mCcdb = nullptr;
 };
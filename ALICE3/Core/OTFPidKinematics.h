@@ -0,0 +1,61 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file OTFPidKinematics.h
+/// \brief Kinematic invariants of a reconstructed track, shared by the mass hypotheses of the on-the-fly PID
+///
+
+#ifndef ALICE3_CORE_OTFPIDKINEMATICS_H_
+#define ALICE3_CORE_OTFPIDKINEMATICS_H_
+
+#include <cmath>
+
+namespace o2::upgrade
+{
+
+/// The quantities of the reconstructed track which do not depend on the mass hypothesis are computed once per
+/// track, the expected signals and the tracking resolutions of the hypotheses are computed from them.
+/// The values are the same as the ones computed from the momentum and the pseudorapidity in each hypothesis.
+struct OTFPidKinematics {
+  /// \param momentum the momentum of the track
+  /// \param eta the pseudorapidity of the track
+  /// \param sigma1Pt2 the variance of q/pt of the track
+  /// \param sigmaTgl2 the variance of tan(lambda) of the track
+  OTFPidKinematics(const float momentum, const float eta, const float sigma1Pt2, const float sigmaTgl2)
+    : p(momentum),
+      eta(eta),
+      coshEta(std::cosh(eta)),
+      sinhEta(std::sinh(eta)),
+      tanhEta(std::tanh(eta)),
+      sigma1Pt(std::sqrt(sigma1Pt2)),
+      etaResolution(std::fabs(std::sin(2.0 * std::atan(std::exp(-eta)))) * std::sqrt(sigmaTgl2))
+  {
+  }
+
+  /// \return the transverse momentum for a momentum hypothesis
+  float pt(const float momentum) const { return momentum / coshEta; }
+
+  /// \return the absolute resolution on the transverse momentum from the covariance of the track
+  double ptResolution(const float pt) const { return pt * pt * sigma1Pt; }
+
+  float p;              // momentum
+  float eta;            // pseudorapidity
+  float coshEta;        // cosh of the pseudorapidity
+  float sinhEta;        // sinh of the pseudorapidity
+  float tanhEta;        // tanh of the pseudorapidity
+  float sigma1Pt;       // resolution on q/pt
+  double etaResolution; // absolute resolution on the pseudorapidity, from the covariance of the track
+};
+
+} // namespace o2::upgrade
+
+#endif // ALICE3_CORE_OTFPIDKINEMATICS_H_
@@ -119,6 +119,7 @@ struct OnTheFlyDecayer {
   }
 
   std::vector<o2::upgrade::OTFParticle> allParticles;
+  std::vector<o2::upgrade::OTFParticle> decayStack; // decay products of a particle, reused for all the particles
   void decayParticles(const int start, const int stop)
   {
     int ndau = 0;
@@ -134,10 +135,12 @@ struct OnTheFlyDecayer {
       }
 
       particle.setBitOff(o2::upgrade::DecayerBits::IsAlive);
-      std::vector<o2::upgrade::OTFParticle> decayStack = decayer.decayParticle(pdgDB, particle);
+      decayStack.clear();
+      decayer.decayParticle(pdgDB, particle, decayStack);
       const float decayRadius = decayer.getDecayRadius();
-      const float trackVelocity = o2::upgrade::computeParticleVelocity(particle.p(), pdgDB->GetParticle(particle.pdgCode())->Mass());
-      const int charge = pdgDB->GetParticle(particle.pdgCode())->Charge() / 3;
+      const auto& decayTable = decayer.getDecayTable(pdgDB, particle.pdgCode());
+      const float trackVelocity = o2::upgrade::computeParticleVelocity(particle.p(), decayTable.mass);
+      const int charge = decayTable.charge;
       float trackLength{-1.f};
       if (!charge) {
         const float dx = particle.vx() - decayer.getSecondaryVertexX();
@@ -152,7 +155,7 @@ struct OnTheFlyDecayer {
 
       const float trackTimeNS = trackLength / trackVelocity * PicoToNano;
       particle.setIndicesDaughter(allParticles.size(), allParticles.size() + (decayStack.size() - 1));
-      for (o2::upgrade::OTFParticle daughter : decayStack) {
+      for (o2::upgrade::OTFParticle& daughter : decayStack) {
         daughter.setIndicesMother(i, i);
         daughter.setCollisionId(mCollisionId);
         daughter.setBitOn(o2::upgrade::DecayerBits::IsAlive);
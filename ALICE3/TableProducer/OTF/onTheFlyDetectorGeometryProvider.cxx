@@ -39,6 +39,8 @@
 struct OnTheFlyDetectorGeometryProvider {
   o2::framework::HistogramRegistry histos{"Histos", {}, o2::framework::OutputObjHandlingPolicy::AnalysisObject};
   o2::framework::Configurable<bool> cleanLutWhenLoaded{"cleanLutWhenLoaded", true, "clean LUTs after being loaded to save disk space"};
+  o2::framework::Configurable<bool> cacheParsedConfigurations{"cacheParsedConfigurations", false, "cache the parsed detector configurations on local disk, keyed by a digest of their content"};
+  o2::framework::Configurable<std::string> configurationCachePath{"configurationCachePath", "./.ALICE3/Configuration/cache/", "local directory of the cache of the parsed detector configurations"};
   o2::framework::Configurable<std::vector<std::string>> detectorConfiguration{"detectorConfiguration",
                                                                               std::vector<std::string>{"$O2PHYSICS_ROOT/share/alice3/a3geometry_v3.ini"},
                                                                               "Paths of the detector geometry configuration files"};
@@ -47,6 +49,8 @@ struct OnTheFlyDetectorGeometryProvider {
   {
     ccdb->setURL("http://alice-ccdb.cern.ch");
     ccdb->setTimestamp(-1);
+    o2::fastsim::GeometryContainer::setConfigurationCacheSetting(cacheParsedConfigurations);
+    o2::fastsim::GeometryContainer::setConfigurationCachePath(configurationCachePath);
     o2::fastsim::GeometryContainer geometryContainer; // Checking that the geometry files can be accessed and loaded
     geometryContainer.setCcdbManager(ccdb.operator->());
     LOG(info) << "On-the-fly detector geometry provider running.";
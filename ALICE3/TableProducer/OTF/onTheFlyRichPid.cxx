@@ -33,6 +33,7 @@
 #include "GeometryContainer.h"
 
 #include "ALICE3/Core/FlatTrackSmearer.h"
+#include "ALICE3/Core/OTFPidKinematics.h"
 #include "ALICE3/Core/TrackUtilities.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFRICH.h"
@@ -695,22 +696,23 @@ struct OnTheFlyRichPid {
 
   /// returns track angular resolution
   /// \param pt the transverse momentum of the tarck
-  /// \param eta the pseudorapidity of the tarck
+  /// \param coshEta the cosh of the pseudorapidity of the tarck
+  /// \param tanhEta the tanh of the pseudorapidity of the tarck
   /// \param trackPtResolution the absolute resolution on pt
   /// \param trackPtResolution the absolute resolution on eta
   /// \param mass the mass of the particle
   /// \param refractiveIndex the refractive index of the radiator
-  double calculateTrackAngularResolutionAdvanced(const float pt, const float eta, const float trackPtResolution, const float trackEtaResolution, const float mass, const float refractiveIndex)
+  double calculateTrackAngularResolutionAdvanced(const float pt, const float coshEta, const float tanhEta, const float trackPtResolution, const float trackEtaResolution, const float mass, const float refractiveIndex)
   {
     // Compute tracking contribution to timing using the error propagation formula
     // Uses light speed in m/ps, magnetic field in T (*0.1 for conversion kGauss -> T)
     const double a0 = mass * mass;
     const double a1 = refractiveIndex;
     const double a1Squared = a1 * a1;
-    const float ptCoshEta = pt * std::cosh(eta);
+    const float ptCoshEta = pt * coshEta;
     const float ptCoshEtaSquared = ptCoshEta * ptCoshEta;
     const double dThetaOndPt = a0 / (pt * std::sqrt(a0 + ptCoshEtaSquared) * std::sqrt(ptCoshEtaSquared * (a1Squared - 1.0) - a0));
-    const double dThetaOndEta = (a0 * std::tanh(eta)) / (std::sqrt(a0 + ptCoshEtaSquared) * std::sqrt(ptCoshEtaSquared * (a1Squared - 1.0) - a0));
+    const double dThetaOndEta = (a0 * tanhEta) / (std::sqrt(a0 + ptCoshEtaSquared) * std::sqrt(ptCoshEtaSquared * (a1Squared - 1.0) - a0));
     const double trackAngularResolution = std::hypot(std::fabs(dThetaOndPt) * trackPtResolution, std::fabs(dThetaOndEta) * trackEtaResolution);
     return trackAngularResolution;
   }
@@ -854,6 +856,7 @@ struct OnTheFlyRichPid {
                                                            o2::track::pid_constants::sMasses[o2::track::PID::Helium3],
                                                            o2::track::pid_constants::sMasses[o2::track::PID::Alpha]};
 
+      const o2::upgrade::OTFPidKinematics kinematics(recoTrack.getP(), recoTrack.getEta(), recoTrack.getSigma1Pt2(), recoTrack.getSigmaTgl2());
       for (int ii = 0; ii < kNspecies; ii++) { // Loop on the particle hypotheses
 
         float hypothesisAngleBarrelRich = kErrorValue;
@@ -863,9 +866,9 @@ struct OnTheFlyRichPid {
         // Evaluate total sigma (layer + tracking resolution)
         float barrelTotalAngularReso = barrelRICHAngularResolution;
         if (flagIncludeTrackAngularRes) {
-          const float transverseMomentum = recoTrack.getP() / std::cosh(recoTrack.getEta());
-          double ptResolution = transverseMomentum * transverseMomentum * std::sqrt(recoTrack.getSigma1Pt2());
-          double etaResolution = std::fabs(std::sin(2.0 * std::atan(std::exp(-recoTrack.getEta())))) * std::sqrt(recoTrack.getSigmaTgl2());
+          const float transverseMomentum = kinematics.pt(kinematics.p);
+          double ptResolution = kinematics.ptResolution(transverseMomentum);
+          double etaResolution = kinematics.etaResolution;
           if (flagRICHLoadDelphesLUTs) {
             if (mSmearer[collision.lutConfigId()]->hasTable(kParticlePdgs[ii])) {
               ptResolution = mSmearer[collision.lutConfigId()]->getAbsPtRes(kParticlePdgs[ii], dNdEta, recoTrack.getEta(), transverseMomentum);
@@ -873,7 +876,7 @@ struct OnTheFlyRichPid {
             }
           }
           // cout << endl <<  "Pt resolution: " << ptResolution << ", Eta resolution: " << etaResolution << endl << endl;
-          const float barrelTrackAngularReso = calculateTrackAngularResolutionAdvanced(recoTrack.getP() / std::cosh(recoTrack.getEta()), recoTrack.getEta(), ptResolution, etaResolution, kParticleMasses[ii], aerogelRindex[iSecor]);
+          const float barrelTrackAngularReso = calculateTrackAngularResolutionAdvanced(transverseMomentum, kinematics.coshEta, kinematics.tanhEta, ptResolution, etaResolution, kParticleMasses[ii], aerogelRindex[iSecor]);
           barrelTotalAngularReso = std::hypot(barrelRICHAngularResolution, barrelTrackAngularReso);
           if (doQAplots &&
               hypothesisAngleBarrelRich > kErrorValue + 1. &&
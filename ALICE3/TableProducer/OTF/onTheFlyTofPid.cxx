@@ -27,6 +27,7 @@
 #include "GeometryContainer.h"
 
 #include "ALICE3/Core/FlatTrackSmearer.h"
+#include "ALICE3/Core/OTFPidKinematics.h"
 #include "ALICE3/Core/TrackUtilities.h"
 #include "ALICE3/DataModel/OTFCollision.h"
 #include "ALICE3/DataModel/OTFTOF.h"
@@ -528,14 +529,16 @@ struct OnTheFlyTofPid {
 
   /// returns track time resolution
   /// \param pt the transverse momentum of the tarck
-  /// \param eta the pseudorapidity of the tarck
+  /// \param coshEta the cosh of the pseudorapidity of the tarck
+  /// \param sinhEta the sinh of the pseudorapidity of the tarck
   /// \param trackPtResolution the absolute resolution on pt
   /// \param trackEtaResolution the absolute resolution on eta
   /// \param mass the mass of the particle
   /// \param detRadius the radius of the cylindrical layer
   /// \param magneticField the magnetic field (along Z)
   double calculateTrackTimeResolutionAdvanced(const float pt,
-                                              const float eta,
+                                              const float coshEta,
+                                              const float sinhEta,
                                               const float trackPtResolution,
                                               const float trackEtaResolution,
                                               const float mass,
@@ -547,8 +550,8 @@ struct OnTheFlyTofPid {
     double a0 = mass * mass;
     double a1 = 0.299792458 * (0.1 * magneticField) * (0.01 * o2::constants::physics::LightSpeedCm2NS / 1e+3);
     double a2 = (detRadius * 0.01) * (detRadius * 0.01) * (0.299792458) * (0.299792458) * (0.1 * magneticField) * (0.1 * magneticField) / 2.0;
-    double dtofOndPt = (std::pow(pt, 4) * std::pow(std::cosh(eta), 2) * std::acos(1.0 - a2 / std::pow(pt, 2)) - 2.0 * a2 * std::pow(pt, 2) * (a0 + std::pow(pt * std::cosh(eta), 2)) / std::sqrt(a2 * (2.0 * std::pow(pt, 2) - a2))) / (a1 * std::pow(pt, 3) * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
-    double dtofOndEta = std::pow(pt, 2) * std::sinh(eta) * std::cosh(eta) * std::acos(1.0 - a2 / std::pow(pt, 2)) / (a1 * std::sqrt(a0 + std::pow(pt * std::cosh(eta), 2)));
+    double dtofOndPt = (std::pow(pt, 4) * std::pow(coshEta, 2) * std::acos(1.0 - a2 / std::pow(pt, 2)) - 2.0 * a2 * std::pow(pt, 2) * (a0 + std::pow(pt * coshEta, 2)) / std::sqrt(a2 * (2.0 * std::pow(pt, 2) - a2))) / (a1 * std::pow(pt, 3) * std::sqrt(a0 + std::pow(pt * coshEta, 2)));
+    double dtofOndEta = std::pow(pt, 2) * sinhEta * coshEta * std::acos(1.0 - a2 / std::pow(pt, 2)) / (a1 * std::sqrt(a0 + std::pow(pt * coshEta, 2)));
     double trackTimeResolution = std::hypot(std::fabs(dtofOndPt) * trackPtResolution, std::fabs(dtofOndEta) * trackEtaResolution);
     return trackTimeResolution;
   }
@@ -785,6 +788,7 @@ struct OnTheFlyTofPid {
       }
 
       // For every mass hypothesis compute the expected time, the delta with respect to it and the nsigma
+      const o2::upgrade::OTFPidKinematics kinematics(momentum, pseudorapidity, trkWithTime.mMomentum.second, trkWithTime.mPseudorapidity.second);
       for (int ii = 0; ii < kParticles; ii++) {
         expectedTimeInnerTOF[ii] = -100;
         expectedTimeOuterTOF[ii] = -100;
@@ -806,17 +810,17 @@ struct OnTheFlyTofPid {
         float innerTotalTimeReso = simConfig.innerTOFTimeReso;
         float outerTotalTimeReso = simConfig.outerTOFTimeReso;
         if (simConfig.flagIncludeTrackTimeRes) {
-          const float transverseMomentum = momentumHypotheses[ii] / std::cosh(pseudorapidity);
-          double ptResolution = transverseMomentum * transverseMomentum * std::sqrt(trkWithTime.mMomentum.second);
-          double etaResolution = std::fabs(std::sin(2.0 * std::atan(std::exp(-pseudorapidity)))) * std::sqrt(trkWithTime.mPseudorapidity.second);
+          const float transverseMomentum = kinematics.pt(momentumHypotheses[ii]);
+          double ptResolution = kinematics.ptResolution(transverseMomentum);
+          double etaResolution = kinematics.etaResolution;
           if (simConfig.flagTOFLoadDelphesLUTs) {
             if (mSmearer[collision.lutConfigId()]->hasTable(kParticlePdgs[ii])) { // Only if the LUT for this particle was loaded
               ptResolution = mSmearer[collision.lutConfigId()]->getAbsPtRes(kParticlePdgs[ii], dNdEta, pseudorapidity, transverseMomentum);
               etaResolution = mSmearer[collision.lutConfigId()]->getAbsEtaRes(kParticlePdgs[ii], dNdEta, pseudorapidity, transverseMomentum);
             }
           }
-          const float innerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii], simConfig.innerTOFRadius, mMagneticField);
-          const float outerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, pseudorapidity, ptResolution, etaResolution, kParticleMasses[ii], simConfig.outerTOFRadius, mMagneticField);
+          const float innerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, kinematics.coshEta, kinematics.sinhEta, ptResolution, etaResolution, kParticleMasses[ii], simConfig.innerTOFRadius, mMagneticField);
+          const float outerTrackTimeReso = calculateTrackTimeResolutionAdvanced(transverseMomentum, kinematics.coshEta, kinematics.sinhEta, ptResolution, etaResolution, kParticleMasses[ii], simConfig.outerTOFRadius, mMagneticField);
           innerTotalTimeReso = std::hypot(simConfig.innerTOFTimeReso, innerTrackTimeReso);
           outerTotalTimeReso = std::hypot(simConfig.outerTOFTimeReso, outerTrackTimeReso);
 
@@ -304,34 +304,24 @@ struct OnTheFlyTrackerPid {
     return (measuredToT - expectedToT) / resolution;
   }
 
-  float getToTMeanFromMomentumSlice(std::shared_ptr<TH2> hist, float momentum)
+  /// gets the expected ToT (mean) and its resolution (standard deviation) from a single projection of the momentum slice
+  /// \param hist the ToT vs momentum histogram of the hypothesis
+  /// \param momentum the momentum of the track
+  /// \param mean the output mean, -1 if the slice is not populated enough
+  /// \param stddev the output standard deviation, -1 if the slice is not populated enough
+  void getToTMeanAndResolutionFromMomentumSlice(std::shared_ptr<TH2> hist, float momentum, float& mean, float& stddev)
   {
+    mean = -1.f;
+    stddev = -1.f;
     if (!hist)
-      return -1.f;
+      return;
     int binX = hist->GetXaxis()->FindBin(momentum);
     TH1D* proj = hist->ProjectionY("temp", binX, binX);
-    if (proj->GetEntries() < kMinEntriesForProjection) {
-      delete proj;
-      return -1.f;
+    if (proj->GetEntries() >= kMinEntriesForProjection) {
+      mean = proj->GetMean();
+      stddev = proj->GetStdDev();
     }
-    float mean = proj->GetMean();
     delete proj;
-    return mean;
-  }
-
-  float getToTResolutionFromMomentumSlice(std::shared_ptr<TH2> hist, float momentum)
-  {
-    if (!hist)
-      return -1.f;
-    int binX = hist->GetXaxis()->FindBin(momentum);
-    TH1D* proj = hist->ProjectionY("temp", binX, binX);
-    if (proj->GetEntries() < kMinEntriesForProjection) {
-      delete proj;
-      return -1.f;
-    }
-    float stddev = proj->GetStdDev();
-    delete proj;
-    return stddev;
   }
 
   float computeTrackLength(o2::track::TrackParCov track, float radius, float magneticField)
@@ -745,8 +735,8 @@ struct OnTheFlyTrackerPid {
             continue;
           }
 
-          float expectedToT = getToTMeanFromMomentumSlice(h2dToTvsPperParticle[hypPdgIdx], rigidity);
-          float resolution = getToTResolutionFromMomentumSlice(h2dToTvsPperParticle[hypPdgIdx], rigidity);
+          float expectedToT, resolution;
+          getToTMeanAndResolutionFromMomentumSlice(h2dToTvsPperParticle[hypPdgIdx], rigidity, expectedToT, resolution);
 
           if (expectedToT > 0 && resolution > 0) {
             nSigmaValues[iHyp] = calculateNsigma(truncatedMeanToT, expectedToT, resolution);
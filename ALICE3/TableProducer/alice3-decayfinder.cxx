@@ -154,6 +154,11 @@ struct alice3decayFinder {
 
   HistogramRegistry histos{"histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
+  // track parameterisations of the daughters of the inner loops, in the order of the grouped partitions,
+  // converted once per collision instead of once per combination
+  std::vector<o2::track::TrackParCov> innerTrackParCovs;
+  std::vector<o2::track::TrackParCov> middleTrackParCovs;
+
   Partition<aod::McParticles> trueD = aod::mcparticle::pdgCode == 421;
   Partition<aod::McParticles> trueDbar = aod::mcparticle::pdgCode == -421;
   Partition<aod::McParticles> trueLc = aod::mcparticle::pdgCode == 4122;
@@ -252,12 +257,20 @@ struct alice3decayFinder {
     int particleMcRec;                     // MC particle reconstructed
   } mCandidate3Prong;
 
-  template <typename TTrackType>
-  bool buildDecayCandidateTwoBody(TTrackType const& posTrackRow, TTrackType const& negTrackRow, float posMass, float negMass, aod::McParticles const& mcParticles)
+  template <typename TTracks>
+  void fillTrackParCovs(TTracks const& tracks, std::vector<o2::track::TrackParCov>& trackParCovs)
   {
-    o2::track::TrackParCov posTrack = getTrackParCov(posTrackRow);
-    o2::track::TrackParCov negTrack = getTrackParCov(negTrackRow);
+    trackParCovs.clear();
+    trackParCovs.reserve(tracks.size());
+    for (auto const& track : tracks) {
+      trackParCovs.push_back(getTrackParCov(track));
+    }
+  }
 
+  // n.b. the track parameterisations are taken by value, they are overwritten with the tracks at the vertex
+  template <typename TTrackType>
+  bool buildDecayCandidateTwoBody(TTrackType const& posTrackRow, TTrackType const& negTrackRow, o2::track::TrackParCov posTrack, o2::track::TrackParCov negTrack, float posMass, float negMass, aod::McParticles const& mcParticles)
+  {
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
     // Move close to minima
     int nCand = 0;
@@ -324,16 +337,15 @@ struct alice3decayFinder {
                                     TTrackType const& prong0,
                                     TTrackType const& prong1,
                                     TTrackType const& prong2,
+                                    o2::track::TrackParCov trackParVar0,
+                                    o2::track::TrackParCov trackParVar1,
+                                    o2::track::TrackParCov trackParVar2,
                                     aod::McParticles const& mcParticles)
   {
     // get the collision primary vertex
     auto primaryVertex = getPrimaryVertex(collision);
     auto covMatrixPV = primaryVertex.getCov();
 
-    o2::track::TrackParCov trackParVar0 = getTrackParCov(prong0);
-    o2::track::TrackParCov trackParVar1 = getTrackParCov(prong1);
-    o2::track::TrackParCov trackParVar2 = getTrackParCov(prong2);
-
     // Move close to minima
     int nCand = 0;
     try {
@@ -704,12 +716,15 @@ struct alice3decayFinder {
     }
 
     // D0 mesons
+    fillTrackParCovs(tracksKaMinusFromDgrouped, innerTrackParCovs);
     for (auto const& posTrackRow : tracksPiPlusFromDgrouped) {
+      const o2::track::TrackParCov posTrack = getTrackParCov(posTrackRow);
+      int iNeg = -1;
       for (auto const& negTrackRow : tracksKaMinusFromDgrouped) {
-
+        iNeg++; // index in the cached track parameterisations
         if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
           continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged, mcParticles))
+        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, posTrack, innerTrackParCovs[iNeg], o2::constants::physics::MassPionCharged, o2::constants::physics::MassKaonCharged, mcParticles))
           continue;
 
         dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
@@ -851,12 +866,15 @@ struct alice3decayFinder {
     }
 
     // D0bar mesons
+    fillTrackParCovs(tracksPiMinusFromDgrouped, innerTrackParCovs);
     for (auto const& posTrackRow : tracksKaPlusFromDgrouped) {
+      const o2::track::TrackParCov posTrack = getTrackParCov(posTrackRow);
+      int iNeg = -1;
       for (auto const& negTrackRow : tracksPiMinusFromDgrouped) {
-
+        iNeg++; // index in the cached track parameterisations
         if (mcSameMotherCheck && !checkSameMother(posTrackRow, negTrackRow))
           continue;
-        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged, mcParticles))
+        if (!buildDecayCandidateTwoBody(posTrackRow, negTrackRow, posTrack, innerTrackParCovs[iNeg], o2::constants::physics::MassKaonCharged, o2::constants::physics::MassPionCharged, mcParticles))
           continue;
 
         dmeson.cosPA = RecoDecay::cpa(std::array{collision.posX(), collision.posY(), collision.posZ()}, std::array{dmeson.posSV[0], dmeson.posSV[1], dmeson.posSV[2]}, std::array{dmeson.P[0], dmeson.P[1], dmeson.P[2]});
@@ -1015,15 +1033,22 @@ struct alice3decayFinder {
   template <typename TProng>
   void fill3ProngTable(aod::Collision const& collision, TProng const& prongs0, TProng const& prongs1, TProng const& prongs2, aod::McParticles const& mcParticles)
   {
+    fillTrackParCovs(prongs2, middleTrackParCovs);
+    fillTrackParCovs(prongs1, innerTrackParCovs);
     for (auto const& prong0 : prongs0) {
+      const o2::track::TrackParCov trackParVar0 = getTrackParCov(prong0);
+      int iProng2 = -1;
       for (auto const& prong2 : prongs2) {
+        iProng2++; // index in the cached track parameterisations
         if (prong2.globalIndex() == prong0.globalIndex())
           continue; // avoid self
+        int iProng1 = -1;
         for (auto const& prong1 : prongs1) {
+          iProng1++;
           if (mcSameMotherCheck && (!checkSameMother(prong0, prong1) || !checkSameMother(prong0, prong1))) {
             continue;
           }
-          if (!buildDecayCandidateThreeBody(collision, prong0, prong1, prong2, mcParticles)) {
+          if (!buildDecayCandidateThreeBody(collision, prong0, prong1, prong2, trackParVar0, innerTrackParCovs[iProng1], middleTrackParCovs[iProng2], mcParticles)) {
             continue;
           }
           histos.fill(HIST("hDCA3ProngDaughters"), mCandidate3Prong.dcaDau * 1e+4);
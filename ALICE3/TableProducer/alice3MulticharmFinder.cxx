@@ -174,6 +174,11 @@ struct Alice3MulticharmFinder {
   std::map<std::string, HistPtr> histPointers;
   std::vector<int> savedConfigs;
 
+  // track parameterisations of the pions of the collision, in the order of the grouped partitions,
+  // converted once per collision instead of once per combination
+  std::vector<o2::track::TrackParCov> picTrackParCovs;
+  std::vector<o2::track::TrackParCov> piccTrackParCovs;
+
   // Constants
   static constexpr std::array<int, 6> MomentumIndices = {9, 13, 14, 18, 19, 20}; // cov matrix elements for momentum component
   static constexpr float ToMicrons = 1e+4;
@@ -304,13 +309,18 @@ struct Alice3MulticharmFinder {
     return true;
   }
 
-  template <typename TTrackType1, typename TTrackType2, typename TTrackType3>
-  bool buildDecayCandidateThreeBody(TTrackType1 const& prong0, TTrackType2 const& prong1, TTrackType3 const& prong2, float p0mass, float p1mass, float p2mass)
+  template <typename TTracks>
+  void fillTrackParCovs(TTracks const& tracks, std::vector<o2::track::TrackParCov>& trackParCovs)
   {
-    o2::track::TrackParCov t0 = getTrackParCov(prong0);
-    o2::track::TrackParCov t1 = getTrackParCov(prong1);
-    o2::track::TrackParCov t2 = getTrackParCov(prong2);
+    trackParCovs.clear();
+    trackParCovs.reserve(tracks.size());
+    for (auto const& track : tracks) {
+      trackParCovs.push_back(getTrackParCov(track));
+    }
+  }
 
+  bool buildDecayCandidateThreeBody(o2::track::TrackParCov const& t0, o2::track::TrackParCov const& t1, o2::track::TrackParCov const& t2, float p0mass, float p1mass, float p2mass)
+  {
     //}-{}-{}-{}-{}-{}-{}-{}-{}-{}
     // Move close to minima
     int nCand = 0;
@@ -621,6 +631,8 @@ struct Alice3MulticharmFinder {
     // n.b. cascades do not need to be grouped, being used directly in iterator-grouping
     auto picTracksGrouped = picTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
     auto piccTracksGrouped = piccTracks->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+    fillTrackParCovs(picTracksGrouped, picTrackParCovs);
+    fillTrackParCovs(piccTracksGrouped, piccTrackParCovs);
 
     for (auto const& track : tracks) {
       if (BIT_CHECK(track.decayMap(), kTruePiFromXiC)) {
@@ -659,7 +671,10 @@ struct Alice3MulticharmFinder {
       }
 
       GET_HIST(TH1, histPath + "hMinXiDecayRadius")->Fill(xiCand.cascRadius());
+      const o2::track::TrackParCov xiTrack = getTrackParCov(xi);
+      int iPi1c = -1;
       for (auto const& pi1c : picTracksGrouped) {
+        iPi1c++; // index in the cached track parameterisations
         if (mcSameMotherCheck && !checkSameMother(xi, pi1c)) {
           continue;
         }
@@ -674,15 +689,17 @@ struct Alice3MulticharmFinder {
 
         GET_HIST(TH1, histPath + "hPi1cPt")->Fill(pi1c.pt());
         // second pion from XiC decay for starts here
+        int iPi2c = -1;
         for (auto const& pi2c : picTracksGrouped) {
-          if (mcSameMotherCheck && !checkSameMother(xi, pi2c)) {
-            continue; // keep only if same mother
-          }
-
+          iPi2c++;
           if (pi1c.globalIndex() >= pi2c.globalIndex()) {
             continue; // avoid same-mother, avoid double-counting
           }
 
+          if (mcSameMotherCheck && !checkSameMother(xi, pi2c)) {
+            continue; // keep only if same mother
+          }
+
           if (xiCand.posTrackId() == pi2c.globalIndex() || xiCand.negTrackId() == pi2c.globalIndex() || xiCand.bachTrackId() == pi2c.globalIndex()) {
             continue; // avoid using any track that was already used
           }
@@ -697,7 +714,7 @@ struct Alice3MulticharmFinder {
           nCombinationsC++;
           GET_HIST(TH1, histPath + "hCharmBuilding")->Fill(0.0f);
 
-          if (!buildDecayCandidateThreeBody(xi, pi1c, pi2c, o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged)) {
+          if (!buildDecayCandidateThreeBody(xiTrack, picTrackParCovs[iPi1c], picTrackParCovs[iPi2c], o2::constants::physics::MassXiMinus, o2::constants::physics::MassPionCharged, o2::constants::physics::MassPionCharged)) {
             continue; // failed at building candidate
           }
 
@@ -748,7 +765,9 @@ struct Alice3MulticharmFinder {
 
           // attempt XiCC finding
           uint32_t nCombinationsCC = 0;
+          int iPicc = -1;
           for (auto const& picc : piccTracksGrouped) {
+            iPicc++;
             if (mcSameMotherCheck && !checkSameMotherExtra(xi, picc)) {
               continue;
             }
@@ -763,9 +782,8 @@ struct Alice3MulticharmFinder {
 
             GET_HIST(TH1, histPath + "hMultiCharmBuilding")->Fill(0.0f);
             GET_HIST(TH1, histPath + "hPiccPt")->Fill(picc.pt());
-            o2::track::TrackParCov piccTrack = getTrackParCov(picc);
             nCombinationsCC++;
-            if (!buildDecayCandidateTwoBody(xicTrack, piccTrack, o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged)) {
+            if (!buildDecayCandidateTwoBody(xicTrack, piccTrackParCovs[iPicc], o2::constants::physics::MassXiCPlus, o2::constants::physics::MassPionCharged)) {
               continue; // failed at building candidate
             }
 
@@ -18,17 +18,39 @@
 #include <DataFormatsParameters/GRPLHCIFData.h>
 #include <Framework/Logger.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <ostream>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace o2
 {
 double ctpRateFetcher::fetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName, bool fCrashOnNull)
+{
+  if (!mRateTables.empty() && mRateTables.front()->runNumber != runNumber) {
+    mRateTables.clear();
+  }
+  auto table = std::find_if(mRateTables.begin(), mRateTables.end(), [&sourceName](const auto& rateTable) { return rateTable->sourceName == sourceName; });
+  if (table == mRateTables.end()) {
+    mRateTables.push_back(getRateTable(ccdb, timeStamp, runNumber, sourceName));
+    table = mRateTables.end() - 1;
+  }
+  const double time = timeStamp * 1.e-3;
+  const int interval = (*table)->findInterval(time);
+  if (interval < 0) { // outside of the scaler records, or source not tabulated: keep the behaviour of the direct evaluation
+    return fetchFromScalers(ccdb, timeStamp, runNumber, sourceName, fCrashOnNull);
+  }
+  return (*table)->getRate(interval, time, mInterpolation);
+}
+
+double ctpRateFetcher::fetchFromScalers(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName, bool fCrashOnNull)
 {
   setupRun(runNumber, ccdb, timeStamp);
   if (sourceName.find("ZNC") != std::string::npos) {
@@ -60,17 +82,83 @@ double ctpRateFetcher::fetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStam
   return -1.;
 }
 
-double ctpRateFetcher::fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* /*ccdb*/, uint64_t timeStamp, int /*runNumber*/, const std::string& className, int inputType)
+std::shared_ptr<const ctpRateFetcher::RateTable> ctpRateFetcher::getRateTable(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName)
+{
+  static std::mutex tablesMutex;
+  static std::map<std::pair<int, std::string>, std::shared_ptr<const RateTable>> tables;
+  std::lock_guard<std::mutex> lock(tablesMutex);
+  auto& table = tables[{runNumber, sourceName}];
+  if (table) {
+    return table;
+  }
+
+  auto newTable = std::make_shared<RateTable>();
+  newTable->runNumber = runNumber;
+  newTable->sourceName = sourceName;
+  setupRun(runNumber, ccdb, timeStamp);
+  RateSource source;
+  if (findRateSource(runNumber, sourceName, source)) {
+    const auto& records = mScalers->getScalerRecordO2();
+    newTable->times.reserve(records.size());
+    for (const auto& record : records) {
+      newTable->times.push_back(record.epochTime);
+    }
+    // the rate given by the scalers only depends on the records surrounding the time, evaluate it once per interval
+    for (size_t i = 1; i < newTable->times.size(); i++) {
+      const double time = 0.5 * (newTable->times[i - 1] + newTable->times[i]);
+      newTable->rates.push_back(pileUpCorrection(mScalers->getRateGivenT(time, source.index, source.inputType, 1).second) / source.scale);
+    }
+    LOG(info) << "Tabulated the " << sourceName << " rate of run " << runNumber << " in " << newTable->rates.size() << " scaler intervals";
+  }
+  table = newTable;
+  return table;
+}
+
+bool ctpRateFetcher::findRateSource(int runNumber, const std::string& sourceName, RateSource& source)
+{
+  if (sourceName.find("ZNC") != std::string::npos) {
+    source.scale = sourceName.find("hadronic") != std::string::npos ? 28. : 1.;
+    if (runNumber < 544448) {
+      const auto& recs = mScalers->getScalerRecordO2();
+      source.index = recs.empty() || recs[0].scalersInps.size() != 48 ? -1 : 25;
+      source.inputType = 7;
+    } else {
+      source.index = findClassIndex("C1ZNC-B-NOPF-CRU");
+      source.inputType = 6;
+    }
+  } else if (sourceName == "T0CE") {
+    source.index = findClassIndex("CMTVXTCE-B-NOPF");
+  } else if (sourceName == "T0SC") {
+    source.index = findClassIndex("CMTVXTSC-B-NOPF");
+  } else if (sourceName == "T0VTX") {
+    if (runNumber < 534202) {
+      source.index = findClassIndex("minbias_TVX_L0");
+      source.inputType = 3;
+    } else {
+      source.index = findClassIndex("CMTVX-B-NOPF");
+      if (source.index < 0) {
+        source.index = findClassIndex("CMTVX-NONE");
+      }
+    }
+  }
+  return source.index >= 0;
+}
+
+int ctpRateFetcher::findClassIndex(const std::string& className) const
 {
   std::vector<ctp::CTPClass> ctpcls = mConfig->getCTPClasses();
   std::vector<int> clslist = mConfig->getTriggerClassList();
-  int classIndex = -1;
   for (size_t i = 0; i < clslist.size(); i++) {
     if (ctpcls[i].name.find(className) != std::string::npos) {
-      classIndex = i;
-      break;
+      return i;
     }
   }
+  return -1;
+}
+
+double ctpRateFetcher::fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* /*ccdb*/, uint64_t timeStamp, int /*runNumber*/, const std::string& className, int inputType)
+{
+  int classIndex = findClassIndex(className);
   if (classIndex == -1) {
     LOG(warn) << "Trigger class " << className << " not found in CTPConfiguration";
     return -1.;
@@ -81,7 +169,7 @@ double ctpRateFetcher::fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* /*ccdb*/
 
 double ctpRateFetcher::fetchCTPratesInputs(o2::ccdb::BasicCCDBManager* /*ccdb*/, uint64_t timeStamp, int /*runNumber*/, int input)
 {
-  std::vector<ctp::CTPScalerRecordO2> recs = mScalers->getScalerRecordO2();
+  const auto& recs = mScalers->getScalerRecordO2();
   if (recs[0].scalersInps.size() == 48) {
     return pileUpCorrection(mScalers->getRateGivenT(timeStamp * 1.e-3, input, 7, 1).second);
   } else {
@@ -101,6 +189,41 @@ double ctpRateFetcher::pileUpCorrection(double triggerRate)
   return mu * nbc * constants::lhc::LHCRevFreq;
 }
 
+int ctpRateFetcher::RateTable::findInterval(double time) const
+{
+  const int nRecords = times.size();
+  if (nRecords < 2 || rates.empty() || !(time > times.front() && time <= times.back())) {
+    return -1;
+  }
+  // the scaler records are almost equally spaced: start from the expected interval and correct the guess
+  int interval = 1 + static_cast<int>((time - times.front()) / (times.back() - times.front()) * (nRecords - 1));
+  interval = std::clamp(interval, 1, nRecords - 1);
+  while (interval > 1 && times[interval - 1] >= time) {
+    interval--;
+  }
+  while (interval < nRecords - 1 && times[interval] < time) {
+    interval++;
+  }
+  return interval;
+}
+
+double ctpRateFetcher::RateTable::getRate(int interval, double time, bool interpolation) const
+{
+  const double rate = rates[interval - 1];
+  if (!interpolation) {
+    return rate;
+  }
+  // linear interpolation between the centres of the neighbouring intervals
+  const int nIntervals = rates.size();
+  const double centre = 0.5 * (times[interval - 1] + times[interval]);
+  const int other = time < centre ? interval - 1 : interval + 1;
+  if (other < 1 || other > nIntervals) {
+    return rate;
+  }
+  const double otherCentre = 0.5 * (times[other - 1] + times[other]);
+  return rate + (rates[other - 1] - rate) * (time - centre) / (otherCentre - centre);
+}
+
 void ctpRateFetcher::setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp)
 {
   if (runNumber == mRunNumber) {
@@ -15,7 +15,9 @@
 #include <CCDB/BasicCCDBManager.h>
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace o2
 {
@@ -38,14 +40,41 @@ class ctpRateFetcher
   double fetch(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName, bool fCrashOnNull = true);
 
   void setManualCleanup(bool manualCleanup = true) { mManualCleanup = manualCleanup; }
+  /// Interpolate linearly the tabulated rates between the centres of the scaler intervals instead of returning the rate of the interval
+  void setInterpolation(bool interpolation = true) { mInterpolation = interpolation; }
 
  private:
+  /// Pile-up corrected rate of a source in each interval between consecutive scaler records of a run, built once per run and
+  /// shared by all the fetchers of the process
+  struct RateTable {
+    int runNumber = -1;
+    std::string sourceName;
+    std::vector<double> times; /// epoch time of the scaler records (s)
+    std::vector<double> rates; /// rate in the interval ending at each record, starting from the second one
+
+    int findInterval(double time) const;
+    double getRate(int interval, double time, bool interpolation) const;
+  };
+
+  /// Scaler counter used to compute the rate of a source
+  struct RateSource {
+    int index = -1;     /// class or input index
+    int inputType = 1;  /// counter type, as in CTPRunScalers::getRateGivenT
+    double scale = 1.;  /// divisor of the rate
+  };
+
+  double fetchFromScalers(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName, bool fCrashOnNull);
+  std::shared_ptr<const RateTable> getRateTable(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& sourceName);
+  bool findRateSource(int runNumber, const std::string& sourceName, RateSource& source);
+  int findClassIndex(const std::string& className) const;
   double fetchCTPratesInputs(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, int input);
   double fetchCTPratesClasses(o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp, int runNumber, const std::string& className, int inputType = 1);
   double pileUpCorrection(double rate);
   void setupRun(int runNumber, o2::ccdb::BasicCCDBManager* ccdb, uint64_t timeStamp);
 
   bool mManualCleanup = false;
+  bool mInterpolation = false;
+  std::vector<std::shared_ptr<const RateTable>> mRateTables; /// Rate tables of the current run used by this fetcher
   int mRunNumber = -1;
   ctp::CTPConfiguration* mConfig = nullptr;
   ctp::CTPRunScalers* mScalers = nullptr;
@@ -27,10 +27,14 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <future>
 #include <memory>
+#include <numeric>
 #include <utility>
 #include <vector>
 
@@ -70,6 +74,7 @@ class CollisionAssociation
   void setFillTableOfCollIdsPerTrack(bool fill = true) { mFillTableOfCollIdsPerTrack = fill; }
   void setBcWindow(int bcWindow = 115) { mBcWindowForOneSigma = bcWindow; }
   void setMaxPvContributorsForLowMultReassoc(int pvContributorsMax) { mMaxPvContributorsForLowMultReassoc = pvContributorsMax; }
+  void setNumThreads(int nThreads) { mNumThreads = std::max(1, nThreads); }
 
   template <typename TTracks, typename Slice, typename Assoc, typename RevIndices>
   void runStandardAssoc(o2::aod::Collisions const& collisions,
@@ -139,19 +144,10 @@ class CollisionAssociation
                         Assoc& association,
                         RevIndices& reverseIndices)
   {
-    // cache globalBC and track time in BC for optimization
-    std::vector<int64_t> globalBC;
-    std::vector<int64_t> trackBCCache;
-    std::vector<std::pair<typename TTracks::iterator, typename TTracks::iterator>> trackIterationWindows; // continous regions in which we can count on increasing globalBC numbers
-    globalBC.reserve(tracks.size());
-    trackBCCache.reserve(tracks.size());
-    auto trackBegin = tracks.begin();
-    int lastCollisionId = 0;
-    if (tracks.size() > 0) {
-      lastCollisionId = trackBegin.collisionId();
-    }
-    auto track = trackBegin;
-    for (; track != tracks.end(); ++track) {
+    // cache globalBC, track time in BC and time resolution of the tracks, read by the association workers
+    std::vector<TrackTimeInfo> trackInfo;
+    trackInfo.reserve(tracks.size());
+    for (const auto& track : tracks) {
       int64_t trackBC = -1;
       if (track.has_collision()) {
         trackBC = track.collision().bc().globalBC();
@@ -178,119 +174,119 @@ class CollisionAssociation
           }
         }
       }
-      globalBC.push_back(trackBC);
-      trackBCCache.push_back(trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS);
-      // find uniform blocks
-      if ((track.collisionId() < lastCollisionId) || (lastCollisionId < 0 && track.collisionId() >= 0)) {
-        if (lastCollisionId >= 0 || mIncludeUnassigned) {
-          LOGP(debug, "Found track block from {} to {}, current id {}, last id {}", trackBegin.filteredIndex(), track.filteredIndex() - 1, track.collisionId(), lastCollisionId);
-          trackIterationWindows.push_back(std::make_pair(trackBegin, track));
+      TrackTimeInfo info;
+      info.bc = trackBC;
+      info.bcWithTime = trackBC + track.trackTime() / o2::constants::lhc::LHCBunchSpacingNS;
+      info.globalIndex = track.globalIndex();
+      info.time = track.trackTime();
+      info.timeRes = track.trackTimeRes();
+      if constexpr (isCentralBarrel) {
+        if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && track.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && track.isPVContributor() && track.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
+          info.time = track.collision().collisionTime();       // if PV contributor, we assume the time to be the one of the collision
+          info.timeRes = o2::constants::lhc::LHCBunchSpacingNS; // 1 BC
+          info.threshold = TimeThreshold::PvContributor;
+        } else if (TESTBIT(track.flags(), o2::aod::track::TrackTimeResIsRange)) {
+          // the track time resolution is a range, not a gaussian resolution
+          info.threshold = TimeThreshold::Range;
+        } else {
+          info.threshold = TimeThreshold::Gaussian;
+        }
+      } else {
+        // the track is not a central track
+        if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
+          // then the track is an MFT track, or an MFT track with additionnal joined info
+          // in this case TrackTimeResIsRange
+          info.threshold = TimeThreshold::Range;
+        } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
+          // the track is a fwd track, with a gaussian time resolution
+          info.threshold = TimeThreshold::Gaussian;
         }
-        trackBegin = track;
       }
-      lastCollisionId = track.collisionId();
-    }
-    // trackIterationWindows.push_back(std::make_pair(trackBegin, tracks.end()));
-    if (lastCollisionId >= 0 || mIncludeUnassigned) {
-      LOGP(debug, "Found track block from {} to {}", trackBegin.filteredIndex(), tracks.size() - 1);
-      trackIterationWindows.push_back(std::make_pair(trackBegin, track));
+      trackInfo.push_back(info);
     }
 
-    // define vector of vectors to store indices of compatible collisions per track
-    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
-
-    // loop over collisions to find time-compatible tracks
+    // index of the collision time windows, built once per dataframe
+    // all the windows have the same half width bcOffsetMax around the collision BC, so the collisions sorted by BC are an interval index:
+    // the collisions compatible with a track BC are a contiguous range found with two binary searches
     int64_t bcOffsetMax = mBcWindowForOneSigma * mNumSigmaForTimeCompat + mTimeMargin / o2::constants::lhc::LHCBunchSpacingNS;
+    const std::size_t nCollisions = collisions.size();
+    std::vector<CollisionTimeInfo> collisionInfo;
+    collisionInfo.reserve(nCollisions);
     for (const auto& collision : collisions) {
-      const float collTime = collision.collisionTime();
-      const float collTimeRes2 = collision.collisionTimeRes() * collision.collisionTimeRes();
-      uint64_t collBC = collision.bc().globalBC();
-
-      // This is done per block to allow optimization below. Within each block the globalBC increase continously
-      for (auto& iterationWindow : trackIterationWindows) { // o2-linter: disable=const-ref-in-for-loop (iterationWindow is modified)
-        bool iteratorMoved = false;
-        const bool isAssignedTrackWindow = (iterationWindow.first != iterationWindow.second) ? iterationWindow.first.has_collision() : false;
-        for (auto trackInWindow = iterationWindow.first; trackInWindow != iterationWindow.second; ++trackInWindow) {
-          int64_t trackBC = globalBC[trackInWindow.filteredIndex()];
-          if (trackBC < 0) {
-            continue;
-          }
-
-          // Optimization to avoid looping over the full track list each time. This builds on that tracks are sorted by BCs (which they should be because collisions are sorted by BCs)
-          const int64_t bcOffset = trackBC - static_cast<int64_t>(collBC);
-          if constexpr (isCentralBarrel) {
-            // only for blocks with collision association
-            if (isAssignedTrackWindow) {
-              constexpr int margin = 200;
-              if (!iteratorMoved && bcOffset > -bcOffsetMax - margin) {
-                iterationWindow.first.setCursor(trackInWindow.filteredIndex());
-                iteratorMoved = true;
-                LOGP(debug, "Moving iterator begin {}", trackInWindow.filteredIndex());
-              } else if (bcOffset > bcOffsetMax + margin) {
-                LOGP(debug, "Stopping iterator {}", trackInWindow.filteredIndex());
-                break;
-              }
-            }
-          }
-
-          int64_t bcOffsetWindow = trackBCCache[trackInWindow.filteredIndex()] - static_cast<int64_t>(collBC);
-          if (std::abs(bcOffsetWindow) > bcOffsetMax) {
-            continue;
-          }
-
-          float trackTime = 0;
-          float trackTimeRes = 0;
-          if constexpr (isCentralBarrel) {
-            if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && trackInWindow.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && trackInWindow.isPVContributor() && trackInWindow.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
-              trackTime = trackInWindow.collision().collisionTime(); // if PV contributor, we assume the time to be the one of the collision
-              trackTimeRes = o2::constants::lhc::LHCBunchSpacingNS;  // 1 BC
-            } else {
-              trackTime = trackInWindow.trackTime();
-              trackTimeRes = trackInWindow.trackTimeRes();
-            }
-          } else {
-            trackTime = trackInWindow.trackTime();
-            trackTimeRes = trackInWindow.trackTimeRes();
-          }
+      collisionInfo.push_back({static_cast<int64_t>(collision.bc().globalBC()), collision.collisionTime(), collision.collisionTimeRes(), static_cast<int>(collision.globalIndex())});
+    }
+    std::vector<uint32_t> collisionsByBC(nCollisions);
+    std::iota(collisionsByBC.begin(), collisionsByBC.end(), 0);
+    std::stable_sort(collisionsByBC.begin(), collisionsByBC.end(), [&](uint32_t a, uint32_t b) { return collisionInfo[a].bc < collisionInfo[b].bc; });
+    std::vector<int64_t> sortedCollisionBC(nCollisions);
+    for (std::size_t i = 0; i < nCollisions; ++i) {
+      sortedCollisionBC[i] = collisionInfo[collisionsByBC[i]].bc;
+    }
 
-          const float deltaTime = trackTime - collTime + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
-          float sigmaTimeRes2 = collTimeRes2 + trackTimeRes * trackTimeRes;
-          LOGP(debug, "collision time={}, collision time res={}, track time={}, track time res={}, bc collision={}, bc track={}, delta time={}", collTime, collision.collisionTimeRes(), trackInWindow.trackTime(), trackInWindow.trackTimeRes(), collBC, trackBC, deltaTime);
+    // compatible (collision position, track index) pairs, regrouped by collision below to keep the output ordered as the collisions
+    // the tracks are split in contiguous chunks associated in parallel, the chunk outputs are concatenated in track order
+    const std::size_t nTracks = trackInfo.size();
+    const std::size_t nChunks = std::max<std::size_t>(1, std::min<std::size_t>(mNumThreads, nTracks / MinTracksPerChunk));
+    std::vector<std::vector<std::pair<uint32_t, int>>> chunkPairs(nChunks);
+    auto associateChunk = [&](const std::size_t iChunk) {
+      const std::size_t firstTrack = nTracks * iChunk / nChunks;
+      const std::size_t lastTrack = nTracks * (iChunk + 1) / nChunks;
+      findCompatibleCollisions(trackInfo, firstTrack, lastTrack, collisionInfo, collisionsByBC, sortedCollisionBC, bcOffsetMax, chunkPairs[iChunk]);
+    };
+    if (nChunks == 1) {
+      associateChunk(0);
+    } else {
+      std::vector<std::future<void>> workers;
+      workers.reserve(nChunks - 1);
+      for (std::size_t iChunk = 1; iChunk < nChunks; ++iChunk) {
+        workers.push_back(std::async(std::launch::async, associateChunk, iChunk));
+      }
+      associateChunk(0);
+      for (auto& worker : workers) {
+        worker.get();
+      }
+    }
+    std::vector<std::pair<uint32_t, int>> compatiblePairs;
+    if (nChunks == 1) {
+      compatiblePairs = std::move(chunkPairs[0]);
+    } else {
+      std::size_t nPairs = 0;
+      for (const auto& pairs : chunkPairs) {
+        nPairs += pairs.size();
+      }
+      compatiblePairs.reserve(nPairs);
+      for (const auto& pairs : chunkPairs) {
+        compatiblePairs.insert(compatiblePairs.end(), pairs.begin(), pairs.end());
+      }
+    }
 
-          float thresholdTime = 0.;
-          if constexpr (isCentralBarrel) {
-            if ((mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::OnlySameBc && trackInWindow.isPVContributor()) || (mUsePvAssociation == o2::aod::track_association::PVContrReassocOpt::SameBcAndLowMult && trackInWindow.isPVContributor() && trackInWindow.collision().numContrib() > mMaxPvContributorsForLowMultReassoc)) {
-              thresholdTime = trackTimeRes;
-            } else if (TESTBIT(trackInWindow.flags(), o2::aod::track::TrackTimeResIsRange)) {
-              // the track time resolution is a range, not a gaussian resolution
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else {
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          } else {
-            // the track is not a central track
-            if constexpr (TTracks::template contains<o2::aod::MFTTracks>()) {
-              // then the track is an MFT track, or an MFT track with additionnal joined info
-              // in this case TrackTimeResIsRange
-              thresholdTime = trackTimeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
-            } else if constexpr (TTracks::template contains<o2::aod::FwdTracks>()) {
-              // the track is a fwd track, with a gaussian time resolution
-              thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
-            }
-          }
+    // group the pairs by collision (counting sort, stable in the track order) and fill the association
+    std::vector<uint32_t> pairOffsets(nCollisions + 1, 0);
+    for (const auto& compatiblePair : compatiblePairs) {
+      pairOffsets[compatiblePair.first + 1]++;
+    }
+    std::partial_sum(pairOffsets.begin(), pairOffsets.end(), pairOffsets.begin());
+    std::vector<int> tracksPerCollision(compatiblePairs.size());
+    {
+      std::vector<uint32_t> fillPosition(pairOffsets.begin(), pairOffsets.end() - 1);
+      for (const auto& compatiblePair : compatiblePairs) {
+        tracksPerCollision[fillPosition[compatiblePair.first]++] = compatiblePair.second;
+      }
+    }
 
-          if (std::abs(deltaTime) < thresholdTime) {
-            const auto collIdx = collision.globalIndex();
-            const auto trackIdx = trackInWindow.globalIndex();
-            LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
-            association(collIdx, trackIdx);
-            if (mFillTableOfCollIdsPerTrack) {
-              if (collsPerTrack[trackIdx] == nullptr) {
-                collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
-              }
-              collsPerTrack[trackIdx].get()->push_back(collIdx);
-            }
+    // define vector of vectors to store indices of compatible collisions per track
+    std::vector<std::unique_ptr<std::vector<int>>> collsPerTrack(tracksUnfiltered.size());
+    for (std::size_t collisionPosition = 0; collisionPosition < nCollisions; ++collisionPosition) {
+      const auto collIdx = collisionInfo[collisionPosition].globalIndex;
+      for (uint32_t iPair = pairOffsets[collisionPosition]; iPair < pairOffsets[collisionPosition + 1]; ++iPair) {
+        const auto trackIdx = tracksPerCollision[iPair];
+        LOGP(debug, "Filling track id {} for coll id {}", trackIdx, collIdx);
+        association(collIdx, trackIdx);
+        if (mFillTableOfCollIdsPerTrack) {
+          if (collsPerTrack[trackIdx] == nullptr) {
+            collsPerTrack[trackIdx] = std::make_unique<std::vector<int>>();
           }
+          collsPerTrack[trackIdx].get()->push_back(collIdx);
         }
       }
     }
@@ -310,6 +306,75 @@ class CollisionAssociation
   }
 
  private:
+  static constexpr std::size_t MinTracksPerChunk = 10000; // below this number of tracks per worker the threads are not worth it
+
+  enum class TimeThreshold : uint8_t {
+    None,          // no compatibility
+    PvContributor, // PV contributor reassociated only within its BC
+    Range,         // track time resolution is a range
+    Gaussian       // track time resolution is a gaussian sigma
+  };
+
+  /// Time information of a track cached for the time-compatibility test
+  struct TrackTimeInfo {
+    int64_t bc = -1;                               // global BC of the track, -1 if not associated
+    int64_t bcWithTime = -1;                       // global BC including the track time
+    float time = 0.f;                              // track time with respect to the BC (ns)
+    float timeRes = 0.f;                           // track time resolution (ns)
+    int globalIndex = -1;                          // index of the track in the unfiltered table
+    TimeThreshold threshold = TimeThreshold::None; // definition of the compatibility threshold
+  };
+
+  /// Time information of a collision cached for the time-compatibility index
+  struct CollisionTimeInfo {
+    int64_t bc;      // global BC of the collision
+    float time;      // collision time with respect to the BC (ns)
+    float timeRes;   // collision time resolution (ns)
+    int globalIndex; // index of the collision in the collision table
+  };
+
+  /// Finds the collisions time compatible with the tracks [firstTrack, lastTrack), only reads the caches
+  void findCompatibleCollisions(const std::vector<TrackTimeInfo>& trackInfo, const std::size_t firstTrack, const std::size_t lastTrack,
+                                const std::vector<CollisionTimeInfo>& collisionInfo, const std::vector<uint32_t>& collisionsByBC,
+                                const std::vector<int64_t>& sortedCollisionBC, const int64_t bcOffsetMax, std::vector<std::pair<uint32_t, int>>& compatiblePairs) const
+  {
+    for (std::size_t iTrack = firstTrack; iTrack < lastTrack; ++iTrack) {
+      const TrackTimeInfo& track = trackInfo[iTrack];
+      if (track.bc < 0 || track.threshold == TimeThreshold::None) {
+        continue;
+      }
+      auto first = std::lower_bound(sortedCollisionBC.begin(), sortedCollisionBC.end(), track.bcWithTime - bcOffsetMax);
+      auto last = std::upper_bound(first, sortedCollisionBC.end(), track.bcWithTime + bcOffsetMax);
+      for (auto sortedCollision = first; sortedCollision != last; ++sortedCollision) {
+        const uint32_t collisionPosition = collisionsByBC[sortedCollision - sortedCollisionBC.begin()];
+        const CollisionTimeInfo& collision = collisionInfo[collisionPosition];
+        const float collTimeRes2 = collision.timeRes * collision.timeRes;
+        const int64_t bcOffset = track.bc - collision.bc;
+        const float deltaTime = track.time - collision.time + bcOffset * o2::constants::lhc::LHCBunchSpacingNS;
+        float sigmaTimeRes2 = collTimeRes2 + track.timeRes * track.timeRes;
+
+        float thresholdTime = 0.;
+        switch (track.threshold) {
+          case TimeThreshold::PvContributor:
+            thresholdTime = track.timeRes;
+            break;
+          case TimeThreshold::Range:
+            thresholdTime = track.timeRes + mNumSigmaForTimeCompat * std::sqrt(collTimeRes2) + mTimeMargin;
+            break;
+          case TimeThreshold::Gaussian:
+            thresholdTime = mNumSigmaForTimeCompat * std::sqrt(sigmaTimeRes2) + mTimeMargin;
+            break;
+          default:
+            break;
+        }
+
+        if (std::abs(deltaTime) < thresholdTime) {
+          compatiblePairs.emplace_back(collisionPosition, track.globalIndex);
+        }
+      }
+    }
+  }
+
   float mNumSigmaForTimeCompat{4.};                                                  // number of sigma for time compatibility
   float mTimeMargin{500.};                                                           // additional time margin in ns
   int mTrackSelection{o2::aod::track_association::TrackSelection::GlobalTrackWoDCA}; // track selection for central barrel tracks (standard association only)
@@ -318,6 +383,7 @@ class CollisionAssociation
   bool mIncludeUnassigned{true};                                                     // include tracks that were originally not assigned to any collision
   bool mFillTableOfCollIdsPerTrack{false};                                           // fill additional table with vectors of compatible collisions per track
   int mBcWindowForOneSigma{115};                                                     // BC window to be multiplied by the number of sigmas to define maximum window to be considered
+  int mNumThreads{1};                                                                // number of threads of the time-based association
 };
 
 #endif // COMMON_CORE_COLLISIONASSOCIATION_H_
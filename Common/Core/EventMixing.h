@@ -12,6 +12,13 @@
 #ifndef COMMON_CORE_EVENTMIXING_H_
 #define COMMON_CORE_EVENTMIXING_H_
 
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
 namespace eventmixing
 {
 /// Calculate hash for an element based on 2 properties and their bins.
@@ -45,6 +52,103 @@ static int getMixingBin(const T1& vtxBins, const T1& multBins, const T2& vtx, co
   // overflow
   return -1;
 }
+
+/// Bounded pool of events for mixing, persistent across dataframes
+/// Each mixing bin (e.g. the output of getMixingBin or MixingHandler::FindEventCategory) keeps a ring of the last events,
+/// stored as compact copies of their selected tracks or candidates. When the memory cap is reached, the globally oldest
+/// events are dropped first, whatever their bin.
+/// \tparam TRecord trivially copyable structure with the quantities of a track or candidate needed for the mixing
+template <typename TRecord>
+class MixingPool
+{
+  static_assert(std::is_trivially_copyable_v<TRecord>, "The records of the mixing pool must be trivially copyable");
+
+ public:
+  struct Event {
+    uint64_t id = 0;              /// Unique identifier of the event, e.g. its global BC, to avoid mixing an event with itself
+    uint64_t sequence = 0;        /// Insertion counter, used for the memory eviction
+    std::vector<TRecord> records; /// Selected tracks or candidates of the event
+  };
+
+  MixingPool() = default;
+
+  /// \param nBins number of mixing bins
+  /// \param depth maximum number of events stored per bin
+  /// \param maxMemory maximum memory of the stored records in bytes, 0 for no limit
+  void init(const int nBins, const std::size_t depth, const std::size_t maxMemory = 0)
+  {
+    mBins.assign(nBins, {});
+    mInsertionOrder.clear();
+    mDepth = depth;
+    mMaxMemory = maxMemory;
+    mMemory = 0;
+  }
+
+  /// Adds an event to its bin, dropping the oldest events of the bin beyond the depth and the oldest events of the pool beyond the memory cap
+  void push(const int bin, const uint64_t id, std::vector<TRecord>&& records)
+  {
+    if (bin < 0 || bin >= static_cast<int>(mBins.size()) || records.empty() || mDepth == 0) {
+      return;
+    }
+    auto& events = mBins[bin];
+    if (events.size() >= mDepth) {
+      popOldest(bin);
+    }
+    mMemory += records.size() * sizeof(TRecord);
+    events.push_back(Event{id, mSequence, std::move(records)});
+    mInsertionOrder.emplace_back(bin, mSequence++);
+    while (mMaxMemory > 0 && mMemory > mMaxMemory && !mInsertionOrder.empty()) {
+      const auto [oldestBin, oldestSequence] = mInsertionOrder.front();
+      mInsertionOrder.pop_front();
+      auto& oldestEvents = mBins[oldestBin];
+      // the event may have already left its ring because of the depth
+      if (!oldestEvents.empty() && oldestEvents.front().sequence == oldestSequence) {
+        mMemory -= oldestEvents.front().records.size() * sizeof(TRecord);
+        oldestEvents.pop_front();
+      }
+    }
+  }
+
+  /// Calls f(const Event&) for the stored events of a bin, from the most recent one, skipping the event with identifier id
+  /// \param maxEvents maximum number of events to mix with, 0 for all the stored events
+  template <typename F>
+  void forEachEvent(const int bin, const uint64_t id, F&& f, const std::size_t maxEvents = 0) const
+  {
+    if (bin < 0 || bin >= static_cast<int>(mBins.size())) {
+      return;
+    }
+    std::size_t nMixed = 0;
+    const auto& events = mBins[bin];
+    for (auto event = events.rbegin(); event != events.rend(); ++event) {
+      if (event->id == id) {
+        continue;
+      }
+      f(*event);
+      if (++nMixed == maxEvents) {
+        break;
+      }
+    }
+  }
+
+  std::size_t getNEvents(const int bin) const { return (bin < 0 || bin >= static_cast<int>(mBins.size())) ? 0 : mBins[bin].size(); }
+  std::size_t getMemory() const { return mMemory; }
+  int getNBins() const { return mBins.size(); }
+
+ private:
+  void popOldest(const int bin)
+  {
+    auto& events = mBins[bin];
+    mMemory -= events.front().records.size() * sizeof(TRecord);
+    events.pop_front();
+  }
+
+  std::vector<std::deque<Event>> mBins;                    /// Ring of events per mixing bin, oldest first
+  std::deque<std::pair<int, uint64_t>> mInsertionOrder;    /// Bin and sequence of the events in insertion order
+  std::size_t mDepth = 0;                                  /// Maximum number of events per bin
+  std::size_t mMaxMemory = 0;                              /// Maximum memory of the records in bytes
+  std::size_t mMemory = 0;                                 /// Current memory of the records in bytes
+  uint64_t mSequence = 0;                                  /// Counter of the inserted events
+};
 }; // namespace eventmixing
 
 #endif // COMMON_CORE_EVENTMIXING_H_
@@ -81,31 +81,53 @@ double EventPlaneHelper::GetPhiFT0(int chno, o2::ft0::Geometry ft0geom)
   return TMath::ATan2(chPos.Y() + offsetY, chPos.X() + offsetX);
 }
 
-void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom)
+void EventPlaneHelper::GetChannelCosSin(int det, int chno, int nmod, double& cosPhi, double& sinPhi, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
 {
-  /* Calculate the complex Q-vector for the provided detector and channel number,
-    before adding it to the total Q-vector given as argument. */
-  double phi = -999.;
-
-  switch (det) {
-    case 0:                           // FT0. Note: the channel number for FT0-C should
-      phi = GetPhiFT0(chno, ft0geom); // already be given in the right range.
-      break;
-    case 1: // FV0.
-      phi = GetPhiFV0(chno, fv0geom);
-      break;
-    default:
-      printf("'int det' value does not correspond to any accepted case.\n");
-      break;
+  /* The channel positions and offsets do not change between the events, so the
+    angles are computed once per channel and harmonic instead of recalculating
+    the FT0 channel centers at each call. */
+  auto& harmonics = mChannelHarmonics[det];
+  if (static_cast<int>(harmonics.size()) <= nmod) {
+    harmonics.resize(nmod + 1);
+  }
+  auto& table = harmonics[nmod];
+  if (static_cast<int>(table.isSet.size()) <= chno) {
+    table.cosPhi.resize(chno + 1);
+    table.sinPhi.resize(chno + 1);
+    table.isSet.resize(chno + 1, false);
   }
 
-  /// printf("Phi: %.3f\n", phi);
+  if (!table.isSet[chno]) {
+    double phi = (det == 0) ? GetPhiFT0(chno, ft0geom) : GetPhiFV0(chno, fv0geom);
+    table.cosPhi[chno] = TMath::Cos(phi * nmod);
+    table.sinPhi[chno] = TMath::Sin(phi * nmod);
+    table.isSet[chno] = true;
+  }
+  cosPhi = table.cosPhi[chno];
+  sinPhi = table.sinPhi[chno];
+}
 
-  if (phi < -900) {
+void EventPlaneHelper::SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom)
+{
+  /* Calculate the complex Q-vector for the provided detector and channel number,
+    before adding it to the total Q-vector given as argument. */
+  if (det != 0 && det != 1) { // 0: FT0, the channel number for FT0-C should already be given in the right range. 1: FV0.
+    printf("'int det' value does not correspond to any accepted case.\n");
     printf("Error on phi. Skip\n");
     return;
   } // TODO: ensure proper safety check.
-  Qvec += TComplex(ampl * TMath::Cos(phi * nmod), ampl * TMath::Sin(phi * nmod));
+
+  if (nmod < 0 || chno < 0) {
+    double phi = (det == 0) ? GetPhiFT0(chno, ft0geom) : GetPhiFV0(chno, fv0geom);
+    Qvec += TComplex(ampl * TMath::Cos(phi * nmod), ampl * TMath::Sin(phi * nmod));
+    sum += ampl;
+    return;
+  }
+
+  double cosPhi = 0.;
+  double sinPhi = 0.;
+  GetChannelCosSin(det, chno, nmod, cosPhi, sinPhi, ft0geom, fv0geom);
+  Qvec += TComplex(ampl * cosPhi, ampl * sinPhi);
   sum += ampl;
 }
 
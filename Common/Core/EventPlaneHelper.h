@@ -42,21 +42,25 @@ class EventPlaneHelper
   {
     mOffsetFT0AX = offsetX;
     mOffsetFT0AY = offsetY;
+    ResetChannelCache();
   }
   void SetOffsetFT0C(double offsetX, double offsetY)
   {
     mOffsetFT0CX = offsetX;
     mOffsetFT0CY = offsetY;
+    ResetChannelCache();
   }
   void SetOffsetFV0left(double offsetX, double offsetY)
   {
     mOffsetFV0leftX = offsetX;
     mOffsetFV0leftY = offsetY;
+    ResetChannelCache();
   }
   void SetOffsetFV0right(double offsetX, double offsetY)
   {
     mOffsetFV0rightX = offsetX;
     mOffsetFV0rightY = offsetY;
+    ResetChannelCache();
   }
 
   // Methods to calculate the azimuthal angles for each part of FIT, given the channel number.
@@ -65,7 +69,11 @@ class EventPlaneHelper
 
   // Method to get the Q-vector and sum of amplitudes for any channel in FIT, given
   // the detector and amplitude.
-  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, o2::ft0::Geometry ft0geom, o2::fv0::Geometry* fv0geom);
+  void SumQvectors(int det, int chno, float ampl, int nmod, TComplex& Qvec, float& sum, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
+
+  // Method to get cos(nmod * phi) and sin(nmod * phi) of a FIT channel, computed from the
+  // geometry at the first call and cached for the following ones.
+  void GetChannelCosSin(int det, int chno, int nmod, double& cosPhi, double& sinPhi, const o2::ft0::Geometry& ft0geom, o2::fv0::Geometry* fv0geom);
 
   // Method to get the bin corresponding to a centrality percentile, according to the
   // centClasses[] array defined in Tasks/qVectorsQA.cxx.
@@ -107,7 +115,20 @@ class EventPlaneHelper
   double mOffsetFV0rightX = 0.; // X-coordinate of the offset of FV0-A right.
   double mOffsetFV0rightY = 0.; // Y-coordinate of the offset of FV0-A right.
 
-  ClassDefNV(EventPlaneHelper, 2)
+  struct ChannelHarmonics {
+    std::vector<double> cosPhi; // cos(nmod * phi) of each channel.
+    std::vector<double> sinPhi; // sin(nmod * phi) of each channel.
+    std::vector<bool> isSet;    // Whether the angles of the channel have been computed.
+  };
+  std::vector<ChannelHarmonics> mChannelHarmonics[2]; //! Cached channel angles of FT0 and FV0, per harmonic.
+
+  void ResetChannelCache()
+  {
+    mChannelHarmonics[0].clear();
+    mChannelHarmonics[1].clear();
+  }
+
+  ClassDefNV(EventPlaneHelper, 3)
 };
 
 #endif // COMMON_CORE_EVENTPLANEHELPER_H_
@@ -19,6 +19,7 @@
 #include <Framework/Logger.h>
 
 #include <TCollection.h>
+#include <TGraph.h>
 #include <TH1.h>
 #include <TH2.h>
 #include <TNamed.h>
@@ -32,6 +33,7 @@
 
 #include <cstdio>
 #include <string>
+#include <utility>
 #include <vector>
 
 ClassImp(FFitWeights)
@@ -74,6 +76,7 @@ void FFitWeights::init()
   fW_data = new TObjArray();
   fW_data->SetName("FFitWeights_Data");
   fW_data->SetOwner(kTRUE);
+  fSplineCache.clear();
 
   if (!qAxis)
     this->setBinAxis(500, 0, 25);
@@ -130,6 +133,7 @@ Long64_t FFitWeights::Merge(TCollection* collist)
     fW_data->SetName("FFitWeights_Data");
     fW_data->SetOwner(kTRUE);
   }
+  fSplineCache.clear();
   FFitWeights* lW = 0;
   TIter allW(collist);
   while ((lW = (reinterpret_cast<FFitWeights*>(allW())))) {
@@ -172,6 +176,7 @@ void FFitWeights::mptSel()
   if (!th2) {
     return;
   }
+  fSplineCache.clear();
 
   TH1D* tmp{nullptr};
   TGraph* tmpgr{nullptr};
@@ -196,6 +201,7 @@ void FFitWeights::qSelection(const std::vector<int>& nhv, const std::vector<std:
   if (!tar)
     return;
 
+  fSplineCache.clear();
   for (const auto& pf : stv) {
     for (const auto& nh : nhv) {
       TH2D* th2{reinterpret_cast<TH2D*>(tar->FindObject(this->getQName(nh, pf.c_str())))};
@@ -221,6 +227,20 @@ void FFitWeights::qSelection(const std::vector<int>& nhv, const std::vector<std:
     }
   }
 };
+const std::vector<TGraph*>& FFitWeights::getSplines(const char* name)
+{
+  // the splines are looked up by name once per pattern, instead of a search in fW_data for each evaluation
+  std::string pattern{name}; // name may be a Form() buffer, reused by the lookups below
+  auto cached = fSplineCache.find(pattern);
+  if (cached != fSplineCache.end()) {
+    return cached->second;
+  }
+  std::vector<TGraph*> splines(NumberSp + 1, nullptr);
+  for (int isp{0}; isp <= NumberSp; isp++) {
+    splines[isp] = dynamic_cast<TGraph*>(fW_data->FindObject(Form(pattern.c_str(), isp)));
+  }
+  return fSplineCache.emplace(pattern, std::move(splines)).first->second;
+};
 float FFitWeights::internalEval(float centr, const float& val, const char* name)
 {
   if (!fW_data) {
@@ -231,7 +251,7 @@ float FFitWeights::internalEval(float centr, const float& val, const char* name)
     return -1;
   }
 
-  auto* spline = dynamic_cast<TGraph*>(fW_data->FindObject(Form(name, isp)));
+  auto* spline = getSplines(name)[isp];
   if (!spline) {
     return -1;
   }
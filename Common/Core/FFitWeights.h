@@ -19,6 +19,7 @@
 
 #include <TAxis.h>
 #include <TCollection.h>
+#include <TGraph.h>
 #include <TH2.h>
 #include <TNamed.h>
 #include <TObjArray.h>
@@ -28,6 +29,7 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -81,6 +83,7 @@ class FFitWeights : public TNamed
   TAxis* ptAxis; //!
 
   std::vector<std::pair<int, std::string>> qnTYPE;
+  std::map<std::string, std::vector<TGraph*>> fSplineCache; //! splines of each centrality bin, per name pattern
 
   const char* getQName(const int nh, const char* pf = "")
   {
@@ -96,6 +99,7 @@ class FFitWeights : public TNamed
   static constexpr float MaxTol = 100.05;
 
   float internalEval(float centr, const float& val, const char* name);
+  const std::vector<TGraph*>& getSplines(const char* name);
 
   ClassDef(FFitWeights, 1); // calibration class
 };
@@ -0,0 +1,66 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   PIDCalibrationService.h
+/// \since  14/10/2026
+/// \brief  Device-wide registry of the PID calibration objects retrieved from the CCDB.
+///         All the tasks and modules of a device requesting the same object (type, path and metadata) share one read-only
+///         copy, which is fetched again only when the requested timestamp leaves the validity interval of the cached one.
+///         The objects are kept in the process-wide SharedCCDBCache.
+///
+
+#ifndef COMMON_CORE_PID_PIDCALIBRATIONSERVICE_H_
+#define COMMON_CORE_PID_PIDCALIBRATIONSERVICE_H_
+
+#include "Common/Tools/SharedCCDBCache.h"
+
+#include <cstdint>
+#include <map>
+#include <string>
+
+namespace o2::pid
+{
+
+class PIDCalibrationService
+{
+ public:
+  /// Read-only handle to a shared calibration object
+  template <typename T>
+  using Handle = o2::common::SharedCCDBCache::Handle<T>;
+
+  /// Get the calibration object valid for a timestamp, fetched from the CCDB only if no task of the device did it before
+  /// \param ccdb CCDB manager used in case the object has to be fetched
+  /// \param path CCDB path of the object
+  /// \param timestamp timestamp for which the object is requested
+  /// \param metadata metadata of the CCDB query, e.g. the reconstruction pass
+  /// \param fallbackToLatest if no object matches the metadata, take the object valid at the timestamp without metadata
+  /// \return handle to the shared object, with a null object if not found
+  template <typename T, typename TCCDB>
+  static Handle<T> get(TCCDB& ccdb, const std::string& path, const int64_t timestamp, const std::map<std::string, std::string>& metadata, const bool fallbackToLatest = true)
+  {
+    return o2::common::SharedCCDBCache::get<T>(ccdb, path, timestamp, metadata, fallbackToLatest);
+  }
+
+  /// Register a calibration object not coming from the CCDB (e.g. from a local file), valid for all timestamps
+  template <typename T>
+  static Handle<T> set(const std::string& name, const T& object)
+  {
+    return o2::common::SharedCCDBCache::set<T>(name, object);
+  }
+
+  static uint64_t getNFetches() { return o2::common::SharedCCDBCache::getNFetches(); }
+  static uint64_t getNHits() { return o2::common::SharedCCDBCache::getNHits(); }
+};
+
+} // namespace o2::pid
+
+#endif // COMMON_CORE_PID_PIDCALIBRATIONSERVICE_H_
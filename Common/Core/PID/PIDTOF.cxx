@@ -25,6 +25,7 @@
 #include <TGraph.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <string>
@@ -33,6 +34,37 @@
 namespace o2::pid::tof
 {
 
+void TOFEtaLookupTable::fill(const TGraph* g, const int nBins)
+{
+  mContent.clear();
+  const int nPoints = g->GetN();
+  if (nPoints <= 0) {
+    return;
+  }
+  const double* x = g->GetX();
+  mEtaStart = *std::min_element(x, x + nPoints);
+  mEtaStop = *std::max_element(x, x + nPoints);
+  if (nPoints == 1 || mEtaStop <= mEtaStart) { // Constant function
+    mEtaStop = mEtaStart;
+    mContent.assign(2, g->Eval(mEtaStart));
+    mSlopeLow = mSlopeHigh = 0.f;
+    return;
+  }
+  // Use a multiple of the number of graph intervals so that equidistant graph points fall on the nodes and the table is exact
+  const int nIntervals = nPoints - 1;
+  const int nNodesBins = nIntervals * std::max(1, (nBins + nIntervals - 1) / nIntervals);
+  const float width = (mEtaStop - mEtaStart) / nNodesBins;
+  mInvEtaWidth = 1.f / width;
+  mContent.resize(nNodesBins + 1);
+  for (int i = 0; i <= nNodesBins; ++i) {
+    mContent[i] = g->Eval(mEtaStart + i * width);
+  }
+  mContent.back() = g->Eval(mEtaStop);
+  // TGraph::Eval extrapolates linearly with the first and last segments
+  mSlopeLow = mContent.front() - g->Eval(mEtaStart - 1.f);
+  mSlopeHigh = g->Eval(mEtaStop + 1.f) - mContent.back();
+}
+
 void TOFResoParamsV3::setResolutionParametrizationRun2(std::unordered_map<std::string, float> const& pars)
 {
   std::array<std::string, 13> paramNames{"TrkRes.Pi.P0", "TrkRes.Pi.P1", "TrkRes.Pi.P2", "TrkRes.Pi.P3", "time_resolution",
@@ -66,11 +98,12 @@ void TOFResoParamsV3::setTimeShiftParameters(std::unordered_map<std::string, flo
   if (nPoints <= 0) {
     LOG(fatal) << "TOFResoParamsV3 shift: time must be positive";
   }
-  TGraph graph;
+  TGraph* graph = new TGraph(); // Kept alive as the graph pointer is stored
+  graph->SetName(Form("TimeShift.%s", positive ? "Pos" : "Neg"));
   for (int i = 0; i < nPoints; ++i) {
-    graph.AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
+    graph->AddPoint(pars.at(Form("TimeShift.eta%i", i)), pars.at(Form("TimeShift.cor%i", i)));
   }
-  setTimeShiftParameters(&graph, positive);
+  setTimeShiftParameters(graph, positive);
 }
 void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive)
 {
@@ -83,6 +116,7 @@ void TOFResoParamsV3::setTimeShiftParameters(std::string const& filename, std::s
     }
     f.Close();
   }
+  compileTimeShiftTable(positive);
   LOG(info) << "Set the Time Shift parameters from file " << filename << " and object " << objname << " for " << (positive ? "positive" : "negative");
 }
 void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
@@ -96,20 +130,19 @@ void TOFResoParamsV3::setTimeShiftParameters(TGraph* g, const bool positive)
   } else {
     gNegEtaTimeCorr = g;
   }
+  compileTimeShiftTable(positive);
   LOG(info) << "Set the Time Shift parameters from object " << g->GetName() << " " << g->GetTitle() << " for " << (positive ? "positive" : "negative");
 }
-float TOFResoParamsV3::getTimeShift(float eta, int16_t sign) const
+void TOFResoParamsV3::compileTimeShiftTable(const bool positive, const int nBins)
 {
-  if (sign > 0) {
-    if (!gPosEtaTimeCorr) {
-      return 0.f;
-    }
-    return gPosEtaTimeCorr->Eval(eta);
-  }
-  if (!gNegEtaTimeCorr) {
-    return 0.f;
+  const TGraph* g = positive ? gPosEtaTimeCorr : gNegEtaTimeCorr;
+  TOFEtaLookupTable& table = positive ? mTimeShiftTablePos : mTimeShiftTableNeg;
+  if (!g) {
+    table.clear();
+    return;
   }
-  return gNegEtaTimeCorr->Eval(eta);
+  table.fill(g, nBins);
+  LOG(info) << "Tabulated the Time Shift for " << (positive ? "positive" : "negative") << " in " << (table.empty() ? 0 : table.mContent.size() - 1) << " bins in [" << table.mEtaStart << ", " << table.mEtaStop << "]";
 }
 
 } // namespace o2::pid::tof
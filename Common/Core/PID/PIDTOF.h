@@ -30,6 +30,7 @@
 #include <TGraph.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
@@ -176,6 +177,36 @@ class TOFResoParamsV2 : public o2::tof::Parameters<13>
   TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
 };
 
+/// \brief Uniformly binned lookup table of a function of eta, linearly interpolated between the nodes
+/// Outside of the tabulated range the function is extrapolated linearly, as done by TGraph::Eval
+struct TOFEtaLookupTable {
+  std::vector<float> mContent; /// Function values at the nBins + 1 equidistant nodes
+  float mEtaStart = 0.f;       /// Eta of the first node
+  float mEtaStop = 0.f;        /// Eta of the last node
+  float mInvEtaWidth = 0.f;    /// Inverse of the node spacing
+  float mSlopeLow = 0.f;       /// Slope used below mEtaStart
+  float mSlopeHigh = 0.f;      /// Slope used above mEtaStop
+
+  bool empty() const { return mContent.empty(); }
+  void clear() { mContent.clear(); }
+
+  /// Tabulates the graph on nBins uniform bins spanning its x range
+  void fill(const TGraph* g, const int nBins);
+
+  float eval(const float eta) const
+  {
+    if (!(eta > mEtaStart)) {
+      return mContent.front() + mSlopeLow * (eta - mEtaStart);
+    }
+    if (eta >= mEtaStop) {
+      return mContent.back() + mSlopeHigh * (eta - mEtaStop);
+    }
+    const float x = (eta - mEtaStart) * mInvEtaWidth;
+    const int i = std::min(static_cast<int>(x), static_cast<int>(mContent.size()) - 2);
+    return mContent[i] + (mContent[i + 1] - mContent[i]) * (x - i);
+  }
+};
+
 /// \brief Next implementation class to store TOF response parameters for exp. times
 class TOFResoParamsV3 : public o2::tof::Parameters<13>
 {
@@ -220,9 +251,9 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
       // LOG(info) << "TOFResoParamsV3 shift: no correction mEtaN is " << mEtaN;
       return 0.f;
     }
-    const int& etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : (eta - mEtaStart) * mInvEtaWidth);
+    const int etaIndex = (eta <= mEtaStart) ? 0 : (eta >= mEtaStop ? (mEtaN - 1) : std::min(static_cast<int>((eta - mEtaStart) * mInvEtaWidth), mEtaN - 1));
     // LOG(info) << "TOFResoParamsV3 shift: correction for eta " << eta << " is for index " << etaIndex << " = " << shift;
-    return mContent.at(etaIndex);
+    return mContent[etaIndex];
   }
 
   void printMomentumChargeShiftParameters() const
@@ -241,7 +272,19 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   void setTimeShiftParameters(std::unordered_map<std::string, float> const& pars, const bool positive);
   void setTimeShiftParameters(std::string const& filename, std::string const& objname, const bool positive);
   void setTimeShiftParameters(TGraph* g, const bool positive);
-  float getTimeShift(float eta, int16_t sign) const;
+  /// Tabulates the time shift graph so that getTimeShift does not call TGraph::Eval per track
+  /// Called when the time shift parameters are set, can be called again to change the granularity
+  /// \param positive charge of the time shift to tabulate
+  /// \param nBins minimum number of uniform bins of the table
+  void compileTimeShiftTable(const bool positive, const int nBins = 400);
+  float getTimeShift(float eta, int16_t sign) const
+  {
+    const TOFEtaLookupTable& table = sign > 0 ? mTimeShiftTablePos : mTimeShiftTableNeg;
+    if (table.empty()) {
+      return 0.f;
+    }
+    return table.eval(eta);
+  }
 
   void printTimeShiftParameters() const
   {
@@ -332,8 +375,10 @@ class TOFResoParamsV3 : public o2::tof::Parameters<13>
   static constexpr std::array<const char*, 9> particleNames = {"El", "Mu", "Pi", "Ka", "Pr", "De", "Tr", "He", "Al"};
 
   // Time shift for post calibration
-  TGraph* gPosEtaTimeCorr = nullptr; /// Time shift correction for positive tracks
-  TGraph* gNegEtaTimeCorr = nullptr; /// Time shift correction for negative tracks
+  TGraph* gPosEtaTimeCorr = nullptr;    /// Time shift correction for positive tracks
+  TGraph* gNegEtaTimeCorr = nullptr;    /// Time shift correction for negative tracks
+  TOFEtaLookupTable mTimeShiftTablePos; /// Tabulated time shift correction for positive tracks
+  TOFEtaLookupTable mTimeShiftTableNeg; /// Tabulated time shift correction for negative tracks
 };
 
 /// \brief Class to handle the the TOF detector response for the TOF beta measurement
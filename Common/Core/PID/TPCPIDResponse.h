@@ -25,6 +25,8 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 namespace o2::pid::tpc
@@ -93,6 +95,17 @@ class Response
   /// Gets relative dEdx resolution contribution due to relative pt resolution
   float GetRelativeResolutiondEdx(const float p, const float mass, const float charge, const float resol) const;
 
+  /// Gets the expected signal from the track inner momentum
+  float GetExpectedSignalFromValues(const float tpcInnerParam, const o2::track::PID::ID id) const;
+  /// Gets the expected resolution from the track properties
+  float GetExpectedSigmaFromValues(const long multTPC, const float tpcInnerParam, const float tgl, const float signed1Pt, const int16_t tpcNClsFound, const o2::track::PID::ID id) const;
+
+  /// Gets the number of sigmas with respect to the expected signal for a batch of tracks and several mass hypotheses at once
+  /// Inputs are structures of arrays indexed by track, the output is species-major: nSigma[iSpecies * nTracks + iTrack]
+  /// Gives the same values as GetNumberOfSigmaMCTunedAtMultiplicity evaluated track by track with the given signal
+  void GetNumberOfSigmaBatch(const std::size_t nTracks, const uint8_t* hasTPC, const float* tpcInnerParam, const float* tgl, const float* signed1Pt,
+                             const int16_t* tpcNClsFound, const float* tpcSignal, const long* multTPC, const std::vector<o2::track::PID::ID>& ids, float* nSigma) const;
+
   void PrintAll() const;
 
  private:
@@ -116,7 +129,12 @@ inline float Response::GetExpectedSignal(const TrackType& track, const o2::track
   if (!track.hasTPC()) {
     return -999.f;
   }
-  const float bethe = mMIP * o2::common::BetheBlochAleph(track.tpcInnerParam() / o2::track::pid_constants::sMasses[id], mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
+  return GetExpectedSignalFromValues(track.tpcInnerParam(), id);
+}
+
+inline float Response::GetExpectedSignalFromValues(const float tpcInnerParam, const o2::track::PID::ID id) const
+{
+  const float bethe = mMIP * o2::common::BetheBlochAleph(tpcInnerParam / o2::track::pid_constants::sMasses[id], mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
   return bethe >= 0.f ? bethe : -999.f;
 }
 
@@ -135,27 +153,53 @@ inline float Response::GetExpectedSigmaAtMultiplicity(const long multTPC, const
   if (!track.hasTPC()) {
     return -999.f;
   }
+  return GetExpectedSigmaFromValues(multTPC, track.tpcInnerParam(), track.tgl(), track.signed1Pt(), track.tpcNClsFound(), id);
+}
+
+inline float Response::GetExpectedSigmaFromValues(const long multTPC, const float tpcInnerParam, const float tgl, const float signed1Pt, const int16_t tpcNClsFound, const o2::track::PID::ID id) const
+{
   float resolution = 0.;
   if (mUseDefaultResolutionParam) {
-    const float reso = GetExpectedSignal(track, id) * mResolutionParamsDefault[0] * (static_cast<float>(track.tpcNClsFound()) > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / static_cast<float>(track.tpcNClsFound())) : 1.f);
+    const float reso = GetExpectedSignalFromValues(tpcInnerParam, id) * mResolutionParamsDefault[0] * (static_cast<float>(tpcNClsFound) > 0 ? std::sqrt(1. + mResolutionParamsDefault[1] / static_cast<float>(tpcNClsFound)) : 1.f);
     reso >= 0.f ? resolution = reso : resolution = -999.f;
   } else {
 
-    const double ncl = nClNorm / track.tpcNClsFound(); //
-    const double p = track.tpcInnerParam();
+    const double ncl = nClNorm / tpcNClsFound; //
+    const double p = tpcInnerParam;
     const double mass = o2::track::pid_constants::sMasses[id];
     const double bg = p / mass;
     const double dEdx = o2::common::BetheBlochAleph(static_cast<float>(bg), mBetheBlochParams[0], mBetheBlochParams[1], mBetheBlochParams[2], mBetheBlochParams[3], mBetheBlochParams[4]) * std::pow(static_cast<float>(o2::track::pid_constants::sCharges[id]), mChargeFactor);
     const double relReso = GetRelativeResolutiondEdx(p, mass, o2::track::pid_constants::sCharges[id], mResolutionParams[3]);
 
-    const std::vector<double> values{1.f / dEdx, track.tgl(), std::sqrt(ncl), relReso, track.signed1Pt(), multTPC / mMultNormalization};
+    // named values instead of a vector to avoid a heap allocation per track and species
+    const double invdEdx = 1.f / dEdx;
+    const double tglValue = tgl;
+    const double sqrtNcl = std::sqrt(ncl);
+    const double signed1PtValue = signed1Pt;
+    const double multValue = multTPC / mMultNormalization;
 
-    const float reso = sqrt(pow(mResolutionParams[0], 2) * values[0] + pow(mResolutionParams[1], 2) * (values[2] * mResolutionParams[5]) * pow(values[0] / sqrt(1 + pow(values[1], 2)), mResolutionParams[2]) + values[2] * pow(values[3], 2) + pow(mResolutionParams[4] * values[4], 2) + pow(values[5] * mResolutionParams[6], 2) + pow(values[5] * (values[0] / sqrt(1 + pow(values[1], 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
+    const float reso = sqrt(pow(mResolutionParams[0], 2) * invdEdx + pow(mResolutionParams[1], 2) * (sqrtNcl * mResolutionParams[5]) * pow(invdEdx / sqrt(1 + pow(tglValue, 2)), mResolutionParams[2]) + sqrtNcl * pow(relReso, 2) + pow(mResolutionParams[4] * signed1PtValue, 2) + pow(multValue * mResolutionParams[6], 2) + pow(multValue * (invdEdx / sqrt(1 + pow(tglValue, 2))) * mResolutionParams[7], 2)) * dEdx * mMIP;
     reso >= 0.f ? resolution = reso : resolution = -999.f;
   }
   return resolution;
 }
 
+inline void Response::GetNumberOfSigmaBatch(const std::size_t nTracks, const uint8_t* hasTPC, const float* tpcInnerParam, const float* tgl, const float* signed1Pt,
+                                            const int16_t* tpcNClsFound, const float* tpcSignal, const long* multTPC, const std::vector<o2::track::PID::ID>& ids, float* nSigma) const
+{
+  // species in the outer loop: the inner loop runs over contiguous track arrays with species constants hoisted
+  for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+    const auto id = ids[iSpecies];
+    float* nSigmaSpecies = nSigma + iSpecies * nTracks;
+    for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+      const float expSignal = GetExpectedSignalFromValues(tpcInnerParam[iTrack], id);
+      const float expSigma = GetExpectedSigmaFromValues(multTPC[iTrack], tpcInnerParam[iTrack], tgl[iTrack], signed1Pt[iTrack], tpcNClsFound[iTrack], id);
+      const bool isValid = hasTPC[iTrack] && expSigma >= 0.f && expSignal >= 0.f;
+      nSigmaSpecies[iTrack] = isValid ? (tpcSignal[iTrack] - expSignal) / expSigma : -999.f;
+    }
+  }
+}
+
 /// Gets the number of sigma between the actual signal and the expected signal
 template <typename CollisionType, typename TrackType>
 inline float Response::GetNumberOfSigma(const CollisionType& collision, const TrackType& trk, const o2::track::PID::ID id) const
@@ -0,0 +1,153 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   ProfilingScopes.h
+/// \brief  In-situ timers and counters of the code regions of a task
+///
+/// A task declares the names of its regions (e.g. its process functions and the sub-steps of its modules) and opens a
+/// scope at the beginning of each region: when the scope goes out of scope, the elapsed time, one call and the number
+/// of processed items are added to the region. The totals are stored in three histograms of the registry of the task,
+/// with one labelled bin per region, so that they are merged across the jobs, and printed at the end of the stream.
+/// The scopes are compiled out unless O2PHYSICS_PROFILING_SCOPES is defined to 1, e.g. with
+/// -DCMAKE_CXX_FLAGS="-DO2PHYSICS_PROFILING_SCOPES=1".
+///
+
+#ifndef COMMON_CORE_PROFILINGSCOPES_H_
+#define COMMON_CORE_PROFILINGSCOPES_H_
+
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
+#include <Framework/Logger.h>
+
+#include <TAxis.h>
+#include <TH1.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#ifndef O2PHYSICS_PROFILING_SCOPES
+#define O2PHYSICS_PROFILING_SCOPES 0
+#endif
+
+namespace o2::common::core
+{
+
+/// Whether the profiling scopes are compiled in
+inline constexpr bool ProfilingScopesEnabled = O2PHYSICS_PROFILING_SCOPES;
+
+class ProfilingScopes
+{
+ public:
+  /// Time, calls and processed items of a region, added when the scope is destroyed
+  class Scope
+  {
+   public:
+    Scope(ProfilingScopes* profiler, int region) : mProfiler(profiler), mRegion(region)
+    {
+      if constexpr (ProfilingScopesEnabled) {
+        mStart = std::chrono::steady_clock::now();
+      }
+    }
+    Scope(Scope const&) = delete;
+    Scope& operator=(Scope const&) = delete;
+    ~Scope()
+    {
+      if constexpr (ProfilingScopesEnabled) {
+        mProfiler->add(mRegion, std::chrono::duration<double>(std::chrono::steady_clock::now() - mStart).count(), mItems);
+      }
+    }
+
+    /// Adds processed items to the region, e.g. the rows of a table
+    void count(int64_t items)
+    {
+      if constexpr (ProfilingScopesEnabled) {
+        mItems += items;
+      }
+    }
+
+   private:
+    ProfilingScopes* mProfiler;                     // profiler of the region
+    int mRegion;                                    // index of the region
+    int64_t mItems{0};                              // items processed in the scope
+    std::chrono::steady_clock::time_point mStart{}; // opening time of the scope
+  };
+
+  /// Books the histograms of the regions, does nothing if the scopes are compiled out
+  /// @param registry histogram registry of the task
+  /// @param regions names of the regions, in the order of their indices
+  /// @param folder folder of the histograms in the registry
+  void init(o2::framework::HistogramRegistry& registry, std::vector<std::string> const& regions, std::string const& folder = "Profiling")
+  {
+    if constexpr (!ProfilingScopesEnabled) {
+      return;
+    }
+    mRegions = regions;
+    const o2::framework::AxisSpec axis{static_cast<int>(regions.size()), -0.5, regions.size() - 0.5, "region"};
+    mHistTime = registry.add<TH1>((folder + "/hTime").c_str(), "Time spent in the region;;time (s)", o2::framework::HistType::kTH1D, {axis});
+    mHistCalls = registry.add<TH1>((folder + "/hCalls").c_str(), "Calls of the region;;calls", o2::framework::HistType::kTH1D, {axis});
+    mHistItems = registry.add<TH1>((folder + "/hItems").c_str(), "Items processed in the region;;items", o2::framework::HistType::kTH1D, {axis});
+    for (std::size_t i = 0; i < regions.size(); i++) {
+      for (const auto& hist : {mHistTime, mHistCalls, mHistItems}) {
+        hist->GetXaxis()->SetBinLabel(i + 1, regions[i].c_str());
+      }
+    }
+  }
+
+  /// @return scope of a region, to be kept alive until the end of the region
+  /// @param region index of the region, in the list given to init
+  Scope scope(int region) { return Scope{this, region}; }
+
+  /// Adds the time, one call and the processed items to a region
+  void add(int region, double time, int64_t items)
+  {
+    if constexpr (ProfilingScopesEnabled) {
+      if (!mHistTime) {
+        return;
+      }
+      mHistTime->AddBinContent(region + 1, time);
+      mHistCalls->AddBinContent(region + 1, 1.);
+      mHistItems->AddBinContent(region + 1, items);
+    }
+  }
+
+  /// Prints the totals of the regions which were called
+  void print() const
+  {
+    if constexpr (ProfilingScopesEnabled) {
+      if (!mHistTime) {
+        return;
+      }
+      for (std::size_t i = 0; i < mRegions.size(); i++) {
+        const double time = mHistTime->GetBinContent(i + 1);
+        const double calls = mHistCalls->GetBinContent(i + 1);
+        const double items = mHistItems->GetBinContent(i + 1);
+        if (calls > 0.) {
+          LOGF(info, "Profiling %-40s %10.0f calls, %12.3f s, %10.3f ms/call, %14.0f items (%10.0f items/s)", mRegions[i].c_str(), calls, time, 1.e3 * time / calls, items, time > 0. ? items / time : 0.);
+        }
+      }
+    }
+  }
+
+ private:
+  std::vector<std::string> mRegions; // names of the regions
+  std::shared_ptr<TH1> mHistTime;    // time per region, in s
+  std::shared_ptr<TH1> mHistCalls;   // calls per region
+  std::shared_ptr<TH1> mHistItems;   // processed items per region
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_PROFILINGSCOPES_H_
@@ -22,12 +22,13 @@
 #include <TMCProcess.h> // for VMC Particle Production Process
 #include <TPDGCode.h>   // for PDG codes
 
-#include <algorithm>   // std::find
+#include <algorithm>   // std::clamp, std::find
 #include <array>       // std::array
 #include <cmath>       // std::abs, std::sqrt
 #include <cstddef>     // std::size_t
 #include <cstdint>     // intX_t
-#include <tuple>       // std::apply
+#include <map>         // std::map
+#include <tuple>       // std::apply, std::tuple
 #include <type_traits> // std::decay_t
 #include <utility>     // std::move
 #include <vector>      // std::vector
@@ -561,6 +562,231 @@ struct RecoDecay {
     return maxNormDeltaIP;
   }
 
+  // Batch calculations
+
+  /// Structure of arrays of the momenta of one prong for a batch of candidates
+  template <typename T>
+  struct ProngMomenta {
+    const T* px; // x momentum components of the prong of each candidate
+    const T* py; // y momentum components of the prong of each candidate
+    const T* pz; // z momentum components of the prong of each candidate
+  };
+
+  /// Calculates the momentum of a batch of candidates from the momenta of their prongs.
+  /// \param n  number of candidates
+  /// \param prongs  array of N prong momentum arrays, each with n entries
+  /// \param px, py, pz  filled with the candidate momentum components, n entries each
+  template <std::size_t N, typename T, typename U>
+  static void pVecBatch(std::size_t n, const std::array<ProngMomenta<T>, N>& prongs, U* px, U* py, U* pz)
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      double sumPx{0.}, sumPy{0.}, sumPz{0.};
+      for (std::size_t iProng = 0; iProng < N; ++iProng) {
+        sumPx += prongs[iProng].px[i];
+        sumPy += prongs[iProng].py[i];
+        sumPz += prongs[iProng].pz[i];
+      }
+      px[i] = sumPx;
+      py[i] = sumPy;
+      pz[i] = sumPz;
+    }
+  }
+
+  /// Calculates the transverse momentum of a batch of candidates from the momenta of their prongs.
+  /// \param n  number of candidates
+  /// \param prongs  array of N prong momentum arrays, each with n entries
+  /// \param pt  filled with the candidate transverse momenta, n entries
+  template <std::size_t N, typename T, typename U>
+  static void ptBatch(std::size_t n, const std::array<ProngMomenta<T>, N>& prongs, U* pt)
+  {
+    for (std::size_t i = 0; i < n; ++i) {
+      double sumPx{0.}, sumPy{0.};
+      for (std::size_t iProng = 0; iProng < N; ++iProng) {
+        sumPx += prongs[iProng].px[i];
+        sumPy += prongs[iProng].py[i];
+      }
+      pt[i] = std::sqrt(sumPx * sumPx + sumPy * sumPy);
+    }
+  }
+
+  /// Calculates the invariant mass squared of a batch of candidates, with the same mass hypothesis for all of them.
+  /// Gives the same values as m2(arrMom, arrMass) candidate by candidate.
+  /// \param n  number of candidates
+  /// \param prongs  array of N prong momentum arrays, each with n entries
+  /// \param arrMass  array of N masses (in the same order as prongs)
+  /// \param m2  filled with the invariant masses squared, n entries
+  template <std::size_t N, typename T, typename U, typename V>
+  static void m2Batch(std::size_t n, const std::array<ProngMomenta<T>, N>& prongs, const std::array<U, N>& arrMass, V* m2)
+  {
+    std::array<double, N> arrMass2{};
+    for (std::size_t iProng = 0; iProng < N; ++iProng) {
+      arrMass2[iProng] = static_cast<double>(arrMass[iProng]) * static_cast<double>(arrMass[iProng]);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      double sumPx{0.}, sumPy{0.}, sumPz{0.}, energyTot{0.};
+      for (std::size_t iProng = 0; iProng < N; ++iProng) {
+        const double px = prongs[iProng].px[i];
+        const double py = prongs[iProng].py[i];
+        const double pz = prongs[iProng].pz[i];
+        sumPx += px;
+        sumPy += py;
+        sumPz += pz;
+        energyTot += std::sqrt(px * px + py * py + pz * pz + arrMass2[iProng]);
+      }
+      m2[i] = energyTot * energyTot - (sumPx * sumPx + sumPy * sumPy + sumPz * sumPz);
+    }
+  }
+
+  /// Calculates the invariant mass of a batch of candidates, see m2Batch.
+  template <std::size_t N, typename T, typename U, typename V>
+  static void mBatch(std::size_t n, const std::array<ProngMomenta<T>, N>& prongs, const std::array<U, N>& arrMass, V* m)
+  {
+    m2Batch(n, prongs, arrMass, m);
+    for (std::size_t i = 0; i < n; ++i) {
+      m[i] = std::sqrt(m[i]);
+    }
+  }
+
+  /// Calculates the cosine of pointing angle of a batch of candidates with a common primary vertex.
+  /// \param n  number of candidates
+  /// \param posPV  {x, y, z} position of the primary vertex
+  /// \param xSV, ySV, zSV  positions of the secondary vertices, n entries each
+  /// \param px, py, pz  candidate momenta, n entries each
+  /// \param cpa  filled with the cosines of pointing angle, n entries
+  template <typename T, typename U, typename V, typename W>
+  static void cpaBatch(std::size_t n, const T& posPV, const U* xSV, const U* ySV, const U* zSV, const V* px, const V* py, const V* pz, W* cpa)
+  {
+    const double xPV = posPV[0], yPV = posPV[1], zPV = posPV[2];
+    for (std::size_t i = 0; i < n; ++i) {
+      const double lx = xSV[i] - xPV, ly = ySV[i] - yPV, lz = zSV[i] - zPV;
+      const double momX = px[i], momY = py[i], momZ = pz[i];
+      const double cos = (lx * momX + ly * momY + lz * momZ) / std::sqrt((lx * lx + ly * ly + lz * lz) * (momX * momX + momY * momY + momZ * momZ));
+      cpa[i] = std::clamp(cos, -1., 1.);
+    }
+  }
+
+  /// Calculates the decay length of a batch of candidates with a common primary vertex.
+  /// \param n  number of candidates
+  /// \param posPV  {x, y, z} position of the primary vertex
+  /// \param xSV, ySV, zSV  positions of the secondary vertices, n entries each
+  /// \param decayLength  filled with the 3D decay lengths, n entries
+  /// \param decayLengthXY  filled with the decay lengths in {x, y}, n entries, not computed if nullptr
+  template <typename T, typename U, typename V>
+  static void decayLengthBatch(std::size_t n, const T& posPV, const U* xSV, const U* ySV, const U* zSV, V* decayLength, V* decayLengthXY = nullptr)
+  {
+    const double xPV = posPV[0], yPV = posPV[1], zPV = posPV[2];
+    for (std::size_t i = 0; i < n; ++i) {
+      const double lx = xSV[i] - xPV, ly = ySV[i] - yPV, lz = zSV[i] - zPV;
+      decayLength[i] = std::sqrt(lx * lx + ly * ly + lz * lz);
+    }
+    if (decayLengthXY == nullptr) {
+      return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      const double lx = xSV[i] - xPV, ly = ySV[i] - yPV;
+      decayLengthXY[i] = std::sqrt(lx * lx + ly * ly);
+    }
+  }
+
+  // Monte Carlo matching
+
+  /// Optional memo of the MC ancestry searches of getMother and of the final daughters searched by getMatchedMCRec.
+  /// The same particles are matched again for every candidate sharing a daughter and for every decay channel tested,
+  /// with the cache each search is done once per dataframe and repeated queries are a hash lookup.
+  /// The cache is used by the matching functions only while a McMatchingCache::Scope is alive, e.g.
+  ///   RecoDecay::McMatchingCache::Scope cacheScope(mcMatchingCache); // at the beginning of the process function
+  class McMatchingCache
+  {
+   public:
+    /// Activates the cache in the current thread and clears it, the MC particle indices being valid within one dataframe only
+    class Scope
+    {
+     public:
+      explicit Scope(McMatchingCache& cache) : mPrevious(active())
+      {
+        cache.clear();
+        active() = &cache;
+      }
+      ~Scope() { active() = mPrevious; }
+      Scope(const Scope&) = delete;
+      Scope& operator=(const Scope&) = delete;
+
+     private:
+      McMatchingCache* mPrevious;
+    };
+
+    void clear()
+    {
+      mMothers.clear();
+      mDaughters.clear();
+    }
+    std::size_t getNHits() const { return mNHits; }
+    std::size_t getNMisses() const { return mNMisses; }
+
+    /// Cache active in the current thread, nullptr if none
+    static McMatchingCache*& active()
+    {
+      static thread_local McMatchingCache* cache = nullptr;
+      return cache;
+    }
+
+    bool findMother(const int64_t index, const int pdgMother, const bool acceptAntiParticles, const int8_t depthMax, int& indexMother, int8_t& sign)
+    {
+      const auto entry = mMothers.find(motherKey(index, pdgMother, acceptAntiParticles, depthMax));
+      if (entry == mMothers.end()) {
+        mNMisses++;
+        return false;
+      }
+      mNHits++;
+      indexMother = entry->second.first;
+      sign = entry->second.second;
+      return true;
+    }
+    void storeMother(const int64_t index, const int pdgMother, const bool acceptAntiParticles, const int8_t depthMax, const int indexMother, const int8_t sign)
+    {
+      mMothers.emplace(motherKey(index, pdgMother, acceptAntiParticles, depthMax), std::make_pair(indexMother, sign));
+    }
+
+    template <std::size_t N>
+    const std::vector<int>* findDaughters(const int64_t indexMother, const std::array<int, N>& arrPdgFinal, const int8_t depthMax, const bool checkProcess)
+    {
+      const auto entry = mDaughters.find(daughtersKey(indexMother, arrPdgFinal, depthMax, checkProcess));
+      if (entry == mDaughters.end()) {
+        mNMisses++;
+        return nullptr;
+      }
+      mNHits++;
+      return &entry->second;
+    }
+    template <std::size_t N>
+    void storeDaughters(const int64_t indexMother, const std::array<int, N>& arrPdgFinal, const int8_t depthMax, const bool checkProcess, const std::vector<int>& daughters)
+    {
+      mDaughters.emplace(daughtersKey(indexMother, arrPdgFinal, depthMax, checkProcess), daughters);
+    }
+
+   private:
+    using MotherKey = std::tuple<int64_t, int, bool, int8_t>;
+    using DaughtersKey = std::tuple<int64_t, std::vector<int>, int8_t, bool>;
+
+    static MotherKey motherKey(const int64_t index, const int pdgMother, const bool acceptAntiParticles, const int8_t depthMax) { return {index, pdgMother, acceptAntiParticles, depthMax}; }
+    template <std::size_t N>
+    static DaughtersKey daughtersKey(const int64_t indexMother, const std::array<int, N>& arrPdgFinal, const int8_t depthMax, const bool checkProcess)
+    {
+      // getDaughters accepts the antiparticles of arrPdgFinal in any order: only the sorted absolute PDG codes matter
+      std::vector<int> pdgs(N);
+      for (std::size_t i = 0; i < N; ++i) {
+        pdgs[i] = std::abs(arrPdgFinal[i]);
+      }
+      std::sort(pdgs.begin(), pdgs.end());
+      return {indexMother, std::move(pdgs), depthMax, checkProcess};
+    }
+
+    std::map<MotherKey, std::pair<int, int8_t>> mMothers; // index and sign of the found mother per query
+    std::map<DaughtersKey, std::vector<int>> mDaughters;  // final daughters per mother and query
+    std::size_t mNHits{0};                                // number of queries answered by the cache
+    std::size_t mNMisses{0};                              // number of queries not found in the cache
+  };
+
   /// Finds the mother of an MC particle by looking for the expected PDG code in the mother chain.
   /// \tparam acceptFlavourOscillation  switch to accept decays where the mother oscillated (e.g. B0 -> B0bar)
   /// \param particlesMC  table with MC particles
@@ -586,6 +812,11 @@ struct RecoDecay {
       *sign = sgn;
     }
 
+    McMatchingCache* cache = McMatchingCache::active();
+    if (cache && cache->findMother(particle.globalIndex(), pdgMother, acceptAntiParticles, depthMax, indexMother, sgn)) {
+      motherFound = true;
+    }
+
     // vector of vectors with mother indices; each line corresponds to a "stage"
     std::vector<std::vector<int64_t>> arrayIds{};
     std::vector<int64_t> initVec{particle.globalIndex()};
@@ -628,6 +859,9 @@ struct RecoDecay {
       arrayIds.push_back(arrayIdsStage);
       stage--;
     }
+    if (cache && stage < 0) { // store the result of a new search
+      cache->storeMother(particle.globalIndex(), pdgMother, acceptAntiParticles, depthMax, indexMother, sgn);
+    }
     if (sign) {
       if constexpr (acceptFlavourOscillation) {
         if (std::abs(particle.getGenStatusCode()) == StatusCodeAfterFlavourOscillation) { // take possible flavour oscillation of B0(s) mother into account
@@ -836,7 +1070,16 @@ struct RecoDecay {
           }
         }
         // Get the list of actual final daughters.
-        getDaughters<checkProcess>(particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        McMatchingCache* cache = McMatchingCache::active();
+        const std::vector<int>* cachedDaughters = cache ? cache->findDaughters(indexMother, arrPdgDaughters, depthMax, checkProcess) : nullptr;
+        if (cachedDaughters) {
+          arrAllDaughtersIndex = *cachedDaughters;
+        } else {
+          getDaughters<checkProcess>(particleMother, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+          if (cache) {
+            cache->storeDaughters(indexMother, arrPdgDaughters, depthMax, checkProcess, arrAllDaughtersIndex);
+          }
+        }
         // printf("MC Rec: Mother %d has %d final daughters:", indexMother, arrAllDaughtersIndex.size());
         // for (auto i : arrAllDaughtersIndex) {
         //   printf(" %d", i);
@@ -974,7 +1217,16 @@ struct RecoDecay {
         }
       }
       // Get the list of actual final daughters.
-      getDaughters<checkProcess>(candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+      McMatchingCache* cache = McMatchingCache::active();
+      const std::vector<int>* cachedDaughters = cache ? cache->findDaughters(candidate.globalIndex(), arrPdgDaughters, depthMax, checkProcess) : nullptr;
+      if (cachedDaughters) {
+        arrAllDaughtersIndex = *cachedDaughters;
+      } else {
+        getDaughters<checkProcess>(candidate, &arrAllDaughtersIndex, arrPdgDaughters, depthMax);
+        if (cache) {
+          cache->storeDaughters(candidate.globalIndex(), arrPdgDaughters, depthMax, checkProcess, arrAllDaughtersIndex);
+        }
+      }
       // printf("MC Gen: Mother %ld has %ld final daughters:", candidate.globalIndex(), arrAllDaughtersIndex.size());
       // for (auto i : arrAllDaughtersIndex) {
       //   printf(" %d", i);
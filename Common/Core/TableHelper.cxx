@@ -21,7 +21,10 @@
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <mutex>
 #include <string>
+#include <unordered_set>
+#include <vector>
 
 /// Function to print the table required in the full workflow
 /// @param initContext initContext of the init function
@@ -35,23 +38,66 @@ void o2::common::core::printTablesInWorkflow(o2::framework::InitContext& initCon
   }
 }
 
+/// Function to get the set of tables consumed by the devices of the full workflow
+/// @param initContext initContext of the init function
+const std::unordered_set<std::string>& o2::common::core::getTablesRequiredInWorkflow(o2::framework::InitContext& initContext)
+{
+  // The running workflow is the same for all the tasks of the device, the devices and their inputs are scanned only once
+  static std::unordered_set<std::string> requiredTables;
+  static std::once_flag filled;
+  std::call_once(filled, [&initContext]() {
+    const auto& workflows = initContext.services().get<o2::framework::RunningWorkflowInfo const>();
+    for (auto const& device : workflows.devices) {
+      for (auto const& input : device.inputs) {
+        if (requiredTables.insert(input.matcher.binding).second) {
+          LOG(debug) << "Table: " << input.matcher.binding << " is needed in device: " << device.name;
+        }
+      }
+    }
+    LOG(info) << "Found " << requiredTables.size() << " tables required in the workflow";
+  });
+  return requiredTables;
+}
+
 /// Function to check if a table is required in a workflow
 /// @param initContext initContext of the init function
 /// @param table name of the table to check for
 bool o2::common::core::isTableRequiredInWorkflow(o2::framework::InitContext& initContext, const std::string& table)
 {
   LOG(debug) << "Checking if table " << table << " is needed";
-  bool tableNeeded = false;
+  return getTablesRequiredInWorkflow(initContext).count(table) > 0;
+}
+
+/// Function to get the names of the devices of the full workflow consuming a table
+/// @param initContext initContext of the init function
+/// @param table name of the table to check for
+std::vector<std::string> o2::common::core::getDevicesRequiringTable(o2::framework::InitContext& initContext, const std::string& table)
+{
+  std::vector<std::string> devices;
   const auto& workflows = initContext.services().get<o2::framework::RunningWorkflowInfo const>();
   for (auto const& device : workflows.devices) {
     for (auto const& input : device.inputs) {
       if (input.matcher.binding == table) {
-        LOG(debug) << "Table: " << input.matcher.binding << " is needed in device: " << device.name;
-        tableNeeded = true;
+        devices.push_back(device.name);
+        break;
       }
     }
   }
-  return tableNeeded;
+  return devices;
+}
+
+/// Function to check if at least one of the given tables is required in a workflow
+/// @param initContext initContext of the init function
+/// @param tables names of the tables to check for
+bool o2::common::core::isAnyTableRequiredInWorkflow(o2::framework::InitContext& initContext, const std::vector<std::string>& tables)
+{
+  const auto& requiredTables = getTablesRequiredInWorkflow(initContext);
+  for (const auto& table : tables) {
+    if (requiredTables.count(table) > 0) {
+      return true;
+    }
+  }
+  return false;
 }
 
 /// Function to enable or disable a configurable flag, depending on the fact that a table is needed or not
@@ -25,6 +25,7 @@
 #include <Framework/RunningWorkflowInfo.h>
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 namespace o2::common::core
@@ -39,6 +40,21 @@ void printTablesInWorkflow(o2::framework::InitContext& initContext);
 /// @param table name of the table to check for
 bool isTableRequiredInWorkflow(o2::framework::InitContext& initContext, const std::string& table);
 
+/// Function to get the set of tables consumed by the devices of the full workflow.
+/// The set is computed once from the running workflow and shared by all the tasks and modules of the device.
+/// @param initContext initContext of the init function
+const std::unordered_set<std::string>& getTablesRequiredInWorkflow(o2::framework::InitContext& initContext);
+
+/// Function to get the names of the devices of the full workflow consuming a table
+/// @param initContext initContext of the init function
+/// @param table name of the table to check for
+std::vector<std::string> getDevicesRequiringTable(o2::framework::InitContext& initContext, const std::string& table);
+
+/// Function to check if at least one of the given tables is required in a workflow
+/// @param initContext initContext of the init function
+/// @param tables names of the tables to check for
+bool isAnyTableRequiredInWorkflow(o2::framework::InitContext& initContext, const std::vector<std::string>& tables);
+
 /// Function to enable or disable a configurable flag, depending on the fact that a table is needed or not
 /// @param initContext initContext of the init function
 /// @param table name of the table to check for
@@ -61,6 +77,29 @@ void enableFlagIfTableRequired(o2::framework::InitContext& initContext, const st
   enableFlagIfTableRequired(initContext, table, flag.value);
 }
 
+/// Function to switch off a process function when none of the tables it fills is consumed in the workflow.
+/// A process function that is already disabled is left untouched. Useful for producers whose process switches are enabled by default.
+/// @param initContext initContext of the init function
+/// @param tables names of the tables filled by the process function
+/// @param processFlag process switch to set, e.g. doprocessRun3
+/// @return true if the process function is (still) enabled
+template <typename FlagType>
+bool disableProcessIfNoTableRequired(o2::framework::InitContext& initContext, const std::vector<std::string>& tables, FlagType& processFlag)
+{
+  if (!processFlag.value) {
+    return false;
+  }
+  if (isAnyTableRequiredInWorkflow(initContext, tables)) {
+    return true;
+  }
+  processFlag.value = false;
+  for (const auto& table : tables) {
+    LOG(info) << "Table not required in the workflow: " + table;
+  }
+  LOG(info) << "Auto-disabling process function " << processFlag.name;
+  return false;
+}
+
 /// Function to check for a specific configurable from another task in the current workflow and fetch its value. Useful for tasks that need to know the value of a configurable in another task.
 /// @param initContext initContext of the init function
 /// @param taskName name of the task to check for
@@ -0,0 +1,161 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file   TableResources.h
+/// \brief  Storage and read cost of the columns of a table
+///
+/// For each persistent column of a table, the report sums over the data frames the size of the Arrow buffers and the
+/// time needed to read all the rows of the column through the table iterator. It also lists the devices of the
+/// running workflow which consume the stored tables, i.e. whose columns are read by the workflow: the AOD reader reads
+/// the requested tables with all their columns. The report is printed at the end of the stream.
+///
+
+#ifndef COMMON_CORE_TABLERESOURCES_H_
+#define COMMON_CORE_TABLERESOURCES_H_
+
+#include "Common/Core/TableHelper.h"
+
+#include <Framework/ASoA.h>
+#include <Framework/DeviceSpec.h>
+#include <Framework/InitContext.h>
+#include <Framework/Logger.h>
+
+#include <arrow/table.h>
+#include <arrow/util/byte_size.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::common::core
+{
+
+/// Keeps a value from being optimised away, to time the reading of a column
+template <typename T>
+inline void doNotOptimize(T const& value)
+{
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename Table>
+class TableResources
+{
+ public:
+  TableResources() { addColumns(typename Table::table_t::persistent_columns_t{}); }
+
+  /// Finds the devices of the running workflow consuming the stored tables, except the device of the report
+  /// @param initContext initContext of the init function
+  void init(o2::framework::InitContext& initContext)
+  {
+    mDevice = initContext.services().get<o2::framework::DeviceSpec const>().name;
+    addConsumers(initContext, typename Table::originals{});
+  }
+
+  /// Adds the rows, the bytes and the read time of the columns of a data frame
+  void fill(Table const& table)
+  {
+    mDataFrames++;
+    mRows += table.size();
+    fillColumns(table, typename Table::table_t::persistent_columns_t{});
+  }
+
+  /// Prints the cost of each column and of the whole table
+  void print() const
+  {
+    int64_t totalBytes{0};
+    double totalTime{0.};
+    LOGF(info, "Table of %s: %lld rows in %d data frames", mDevice.c_str(), mRows, mDataFrames);
+    for (const auto& column : mColumns) {
+      LOGF(info, "  %-32s %14lld bytes, %8.3f bytes/row, read in %10.3f ms (%10.1f MB/s)", column.name.c_str(), column.bytes, bytesPerRow(column.bytes), 1.e3 * column.readTime, throughput(column.bytes, column.readTime));
+      totalBytes += column.bytes;
+      totalTime += column.readTime;
+    }
+    LOGF(info, "  %-32s %14lld bytes, %8.3f bytes/row, read in %10.3f ms (%10.1f MB/s)", "total", totalBytes, bytesPerRow(totalBytes), 1.e3 * totalTime, throughput(totalBytes, totalTime));
+    for (const auto& [table, devices] : mConsumers) {
+      std::string list;
+      for (const auto& device : devices) {
+        list += (list.empty() ? "" : ", ") + device;
+      }
+      LOGF(info, "  Stored table %s read by: %s", table.c_str(), list.empty() ? "no other device of the workflow" : list.c_str());
+    }
+  }
+
+ private:
+  struct ColumnResources {
+    std::string name;    // column label
+    int64_t bytes{0};    // size of the Arrow buffers
+    double readTime{0.}; // time to read all the rows, in s
+  };
+
+  template <typename... C>
+  void addColumns(o2::framework::pack<C...>)
+  {
+    ([&]() {
+      if constexpr (o2::soa::is_persistent_v<C>) {
+        mColumns.push_back({C::columnLabel()});
+      }
+    }(),
+     ...);
+  }
+
+  template <typename... O>
+  void addConsumers(o2::framework::InitContext& initContext, o2::framework::pack<O...>)
+  {
+    ([&]() {
+      const std::string label = o2::soa::getTableLabel<O>();
+      auto& consumers = mConsumers.emplace_back(label, std::vector<std::string>{}).second;
+      for (const auto& device : getDevicesRequiringTable(initContext, label)) {
+        if (device != mDevice) {
+          consumers.push_back(device);
+        }
+      }
+    }(),
+     ...);
+  }
+
+  template <typename... C>
+  void fillColumns(Table const& table, o2::framework::pack<C...>)
+  {
+    const auto arrowTable = table.asArrowTable();
+    std::size_t iColumn{0};
+    ([&]() {
+      if constexpr (o2::soa::is_persistent_v<C>) {
+        auto& column = mColumns[iColumn++];
+        if (const auto chunkedArray = arrowTable->GetColumnByName(C::columnLabel())) {
+          column.bytes += arrow::util::TotalBufferSize(*chunkedArray);
+        }
+        const auto start = std::chrono::steady_clock::now();
+        for (const auto& row : table) {
+          doNotOptimize(*static_cast<C const&>(row).mColumnIterator);
+        }
+        column.readTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      }
+    }(),
+     ...);
+  }
+
+  double bytesPerRow(int64_t bytes) const { return mRows > 0 ? static_cast<double>(bytes) / mRows : 0.; }
+  static double throughput(int64_t bytes, double time) { return time > 0. ? bytes / time / 1.e6 : 0.; }
+
+  std::string mDevice;                                                      // device of the report
+  std::vector<ColumnResources> mColumns;                                    // cost of each persistent column
+  std::vector<std::pair<std::string, std::vector<std::string>>> mConsumers; // devices consuming each stored table
+  int64_t mRows{0};                                                         // number of rows over the data frames
+  int mDataFrames{0};                                                       // number of data frames
+};
+
+} // namespace o2::common::core
+
+#endif // COMMON_CORE_TABLERESOURCES_H_
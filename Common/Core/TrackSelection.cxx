@@ -19,11 +19,15 @@
 #include <Framework/Logger.h>
 
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
 {
@@ -39,6 +43,72 @@ bool TrackSelection::FulfillsITSHitRequirements(uint8_t itsClusterMap) const
   return true;
 }
 
+void TrackSelection::TrackColumns::resize(std::size_t n)
+{
+  trackType.resize(n);
+  hasTPC.resize(n);
+  hasITS.resize(n);
+  flags.resize(n);
+  pt.resize(n);
+  eta.resize(n);
+  tpcNClsFound.resize(n);
+  tpcNClsCrossedRows.resize(n);
+  tpcCrossedRowsOverFindableCls.resize(n);
+  tpcChi2NCl.resize(n);
+  tpcFractionSharedCls.resize(n);
+  itsNCls.resize(n);
+  itsChi2NCl.resize(n);
+  itsClusterMap.resize(n);
+  dcaXY.resize(n);
+  dcaZ.resize(n);
+}
+
+void TrackSelection::IsSelectedMask(TrackColumns const& columns, std::vector<uint16_t>& masks) const
+{
+  const std::size_t n = columns.size();
+  masks.assign(n, 0);
+  uint16_t* mask = masks.data();
+
+  // one branch-free loop per cut over contiguous columns
+  auto setFlag = [&](const TrackCuts& cut, auto&& isSelected) {
+    const uint16_t bit = 1U << static_cast<int>(cut);
+    for (std::size_t i = 0; i < n; ++i) {
+      mask[i] |= isSelected(i) ? bit : 0;
+    }
+  };
+  auto isRun2 = [&](std::size_t i) { return columns.trackType[i] == o2::aod::track::Run2Track || columns.trackType[i] == o2::aod::track::Run2Tracklet; };
+
+  setFlag(TrackCuts::kTrackType, [&](std::size_t i) { return columns.trackType[i] == mTrackType; });
+  setFlag(TrackCuts::kPtRange, [&](std::size_t i) { return columns.pt[i] >= mMinPt && columns.pt[i] <= mMaxPt; });
+  setFlag(TrackCuts::kEtaRange, [&](std::size_t i) { return columns.eta[i] >= mMinEta && columns.eta[i] <= mMaxEta; });
+  setFlag(TrackCuts::kTPCNCls, [&](std::size_t i) { return columns.tpcNClsFound[i] >= mMinNClustersTPC; });
+  setFlag(TrackCuts::kTPCCrossedRows, [&](std::size_t i) { return columns.tpcNClsCrossedRows[i] >= mMinNCrossedRowsTPC; });
+  setFlag(TrackCuts::kTPCCrossedRowsOverNCls, [&](std::size_t i) { return columns.tpcCrossedRowsOverFindableCls[i] >= mMinNCrossedRowsOverFindableClustersTPC; });
+  setFlag(TrackCuts::kTPCChi2NDF, [&](std::size_t i) { return columns.tpcChi2NCl[i] <= mMaxChi2PerClusterTPC; });
+  setFlag(TrackCuts::kTPCRefit, [&](std::size_t i) { return !mRequireTPCRefit || (isRun2(i) ? (columns.flags[i] & o2::aod::track::TPCrefit) != 0 : columns.hasTPC[i] != 0); });
+  setFlag(TrackCuts::kITSNCls, [&](std::size_t i) { return columns.itsNCls[i] >= mMinNClustersITS; });
+  setFlag(TrackCuts::kITSChi2NDF, [&](std::size_t i) { return columns.itsChi2NCl[i] <= mMaxChi2PerClusterITS; });
+  setFlag(TrackCuts::kITSRefit, [&](std::size_t i) { return !mRequireITSRefit || (isRun2(i) ? (columns.flags[i] & o2::aod::track::ITSrefit) != 0 : columns.hasITS[i] != 0); });
+  if (mRequiredITSHits.empty()) {
+    setFlag(TrackCuts::kITSHits, [](std::size_t) { return true; });
+  } else {
+    // the ITS requirement only depends on the cluster map: tabulate it once instead of testing each track
+    std::array<bool, 256> fulfillsITSHits{};
+    for (std::size_t itsClusterMap = 0; itsClusterMap < fulfillsITSHits.size(); ++itsClusterMap) {
+      fulfillsITSHits[itsClusterMap] = FulfillsITSHitRequirements(static_cast<uint8_t>(itsClusterMap));
+    }
+    setFlag(TrackCuts::kITSHits, [&](std::size_t i) { return fulfillsITSHits[columns.itsClusterMap[i]]; });
+  }
+  setFlag(TrackCuts::kGoldenChi2, [&](std::size_t i) { return !(isRun2(i) && mRequireGoldenChi2) || (columns.flags[i] & o2::aod::track::GoldenChi2) != 0; });
+  if (mMaxDcaXYPtDep) {
+    setFlag(TrackCuts::kDCAxy, [&](std::size_t i) { return std::fabs(columns.dcaXY[i]) <= mMaxDcaXYPtDep(columns.pt[i]); });
+  } else {
+    setFlag(TrackCuts::kDCAxy, [&](std::size_t i) { return std::fabs(columns.dcaXY[i]) <= mMaxDcaXY; });
+  }
+  setFlag(TrackCuts::kDCAz, [&](std::size_t i) { return std::fabs(columns.dcaZ[i]) <= mMaxDcaZ; });
+  setFlag(TrackCuts::kTPCFracSharedCls, [&](std::size_t i) { return columns.tpcFractionSharedCls[i] <= mMaxTPCFractionSharedCls; });
+}
+
 const std::string TrackSelection::mCutNames[static_cast<int>(TrackSelection::TrackCuts::kNCuts)] = {"TrackType", "PtRange", "EtaRange", "TPCNCls", "TPCCrossedRows", "TPCCrossedRowsOverNCls", "TPCChi2NDF", "TPCRefit", "ITSNCls", "ITSChi2NDF", "ITSRefit", "ITSHits", "GoldenChi2", "DCAxy", "DCAz", "TPCFracSharedCls"};
 
 void TrackSelection::SetTrackType(o2::aod::track::TrackTypeEnum trackType)
@@ -20,7 +20,9 @@
 
 #include <Rtypes.h>
 
+#include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <set>
@@ -69,6 +71,62 @@ class TrackSelection
   };
 
   static const std::string mCutNames[static_cast<int>(TrackCuts::kNCuts)];
+  static constexpr uint16_t kAllCutsMask = (1U << static_cast<int>(TrackCuts::kNCuts)) - 1; // mask of a track passing all the cuts
+
+  /// Columns of the track quantities used by the selection, gathered once per table and shared by all the selections
+  struct TrackColumns {
+    std::vector<uint8_t> trackType;
+    std::vector<uint8_t> hasTPC;
+    std::vector<uint8_t> hasITS;
+    std::vector<uint32_t> flags;
+    std::vector<float> pt;
+    std::vector<float> eta;
+    std::vector<int16_t> tpcNClsFound;
+    std::vector<int16_t> tpcNClsCrossedRows;
+    std::vector<float> tpcCrossedRowsOverFindableCls;
+    std::vector<float> tpcChi2NCl;
+    std::vector<float> tpcFractionSharedCls;
+    std::vector<uint8_t> itsNCls;
+    std::vector<float> itsChi2NCl;
+    std::vector<uint8_t> itsClusterMap;
+    std::vector<float> dcaXY;
+    std::vector<float> dcaZ;
+
+    std::size_t size() const { return pt.size(); }
+    void resize(std::size_t n);
+
+    /// Gathers the columns of a whole track table, with the dynamic columns evaluated once per track
+    template <typename T>
+    void fill(T const& tracks)
+    {
+      resize(tracks.size());
+      std::size_t i = 0;
+      for (const auto& track : tracks) {
+        trackType[i] = track.trackType();
+        hasTPC[i] = track.hasTPC();
+        hasITS[i] = track.hasITS();
+        flags[i] = track.flags();
+        pt[i] = track.pt();
+        eta[i] = track.eta();
+        tpcNClsFound[i] = track.tpcNClsFound();
+        tpcNClsCrossedRows[i] = track.tpcNClsCrossedRows();
+        tpcCrossedRowsOverFindableCls[i] = track.tpcCrossedRowsOverFindableCls();
+        tpcChi2NCl[i] = track.tpcChi2NCl();
+        tpcFractionSharedCls[i] = track.tpcFractionSharedCls();
+        itsNCls[i] = track.itsNCls();
+        itsChi2NCl[i] = track.itsChi2NCl();
+        itsClusterMap[i] = track.itsClusterMap();
+        dcaXY[i] = track.dcaXY();
+        dcaZ[i] = track.dcaZ();
+        ++i;
+      }
+    }
+  };
+
+  /// Columnar version of IsSelectedMask: each cut is evaluated over all the tracks before the next one
+  /// \param columns track quantities of the table
+  /// \param masks filled with the cut mask of each track, same bits as IsSelectedMask. A track passes IsSelected if its mask is kAllCutsMask
+  void IsSelectedMask(TrackColumns const& columns, std::vector<uint16_t>& masks) const;
 
   // Temporary function to check if track passes selection criteria. To be replaced by framework filters.
   template <typename T>
@@ -274,4 +332,64 @@ class TrackSelection
   ClassDefNV(TrackSelection, 1);
 };
 
+/// Bit of a cut in the cut masks of TrackSelection
+constexpr uint32_t trackCutBit(const TrackSelection::TrackCuts cut) { return 1U << static_cast<int>(cut); }
+
+/// Track selection with the set of enabled cuts fixed at compile time
+/// The cut values are the runtime ones of the TrackSelection base, the cuts not in EnabledCuts are not evaluated and count as passed.
+/// The enabled cuts are tested in order of decreasing rejection power on global tracks, to leave IsSelected as early as possible.
+template <uint32_t EnabledCuts>
+class StaticTrackSelection : public TrackSelection
+{
+ public:
+  static constexpr uint32_t kEnabledCuts = EnabledCuts;
+
+  StaticTrackSelection() = default;
+  explicit StaticTrackSelection(const TrackSelection& selection) : TrackSelection(selection) {}
+
+  /// Order in which the enabled cuts are evaluated: acceptance and detector matching first, quality cuts last
+  static constexpr std::array<TrackCuts, static_cast<int>(TrackCuts::kNCuts)> kCutOrder = {
+    TrackCuts::kTrackType, TrackCuts::kEtaRange, TrackCuts::kPtRange, TrackCuts::kITSRefit, TrackCuts::kTPCRefit, TrackCuts::kITSHits,
+    TrackCuts::kDCAz, TrackCuts::kDCAxy, TrackCuts::kTPCCrossedRows, TrackCuts::kTPCCrossedRowsOverNCls, TrackCuts::kTPCNCls,
+    TrackCuts::kITSNCls, TrackCuts::kTPCChi2NDF, TrackCuts::kITSChi2NDF, TrackCuts::kGoldenChi2, TrackCuts::kTPCFracSharedCls};
+
+  using TrackSelection::IsSelected;
+
+  template <typename T>
+  bool IsSelected(T const& track) const
+  {
+    return isSelectedInOrder(track, std::make_index_sequence<kCutOrder.size()>{});
+  }
+
+  /// Same bits as TrackSelection::IsSelectedMask, with the bits of the disabled cuts always set
+  template <typename T>
+  uint16_t IsSelectedMask(T const& track) const
+  {
+    return maskInOrder(track, std::make_index_sequence<kCutOrder.size()>{});
+  }
+
+ private:
+  template <TrackCuts Cut, typename T>
+  bool passes(T const& track) const
+  {
+    if constexpr ((kEnabledCuts & trackCutBit(Cut)) != 0) {
+      return TrackSelection::IsSelected(track, Cut);
+    } else {
+      return true;
+    }
+  }
+
+  template <typename T, std::size_t... I>
+  bool isSelectedInOrder(T const& track, std::index_sequence<I...>) const
+  {
+    return (passes<kCutOrder[I]>(track) && ...);
+  }
+
+  template <typename T, std::size_t... I>
+  uint16_t maskInOrder(T const& track, std::index_sequence<I...>) const
+  {
+    return ((passes<kCutOrder[I]>(track) ? static_cast<uint16_t>(trackCutBit(kCutOrder[I])) : uint16_t{0}) | ...);
+  }
+};
+
 #endif // COMMON_CORE_TRACKSELECTION_H_
@@ -20,6 +20,8 @@
 
 #include "Common/Core/TrackSelection.h"
 
+#include <cstdint>
+
 // Default track selection requiring one hit in the SPD
 TrackSelection getGlobalTrackSelection();
 
@@ -40,4 +42,42 @@ TrackSelection getGlobalTrackSelectionRun3HF();
 // Global track selection for Run2 JE Hybrid tracks requiring one hit in the SPD and reduced set of cuts
 TrackSelection getJEGlobalTrackSelectionRun2();
 
+// Compile-time cut sets of the default selections: the cuts left at values that accept all the tracks are dropped
+namespace track_selection_cut_sets
+{
+constexpr uint32_t GlobalTrackRun3 = trackCutBit(TrackSelection::TrackCuts::kTrackType) | trackCutBit(TrackSelection::TrackCuts::kPtRange) |
+                                     trackCutBit(TrackSelection::TrackCuts::kEtaRange) | trackCutBit(TrackSelection::TrackCuts::kTPCCrossedRows) |
+                                     trackCutBit(TrackSelection::TrackCuts::kTPCCrossedRowsOverNCls) | trackCutBit(TrackSelection::TrackCuts::kTPCChi2NDF) |
+                                     trackCutBit(TrackSelection::TrackCuts::kTPCRefit) | trackCutBit(TrackSelection::TrackCuts::kITSChi2NDF) |
+                                     trackCutBit(TrackSelection::TrackCuts::kITSRefit) | trackCutBit(TrackSelection::TrackCuts::kITSHits) |
+                                     trackCutBit(TrackSelection::TrackCuts::kDCAxy) | trackCutBit(TrackSelection::TrackCuts::kDCAz);
+constexpr uint32_t GlobalTrackRun2 = GlobalTrackRun3 | trackCutBit(TrackSelection::TrackCuts::kGoldenChi2);
+constexpr uint32_t JEGlobalTrackRun2 = GlobalTrackRun2 | trackCutBit(TrackSelection::TrackCuts::kTPCFracSharedCls);
+} // namespace track_selection_cut_sets
+
+// Compile-time specialised version of getGlobalTrackSelection
+inline StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun2> getStaticGlobalTrackSelection()
+{
+  return StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun2>(getGlobalTrackSelection());
+}
+
+// Compile-time specialised version of getGlobalTrackSelectionRun3ITSMatch
+inline StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun3> getStaticGlobalTrackSelectionRun3ITSMatch(int matching,
+                                                                                                                int passFlag = TrackSelection::GlobalTrackRun3DCAxyCut::Default)
+{
+  return StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun3>(getGlobalTrackSelectionRun3ITSMatch(matching, passFlag));
+}
+
+// Compile-time specialised version of getGlobalTrackSelectionRun3HF
+inline StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun3> getStaticGlobalTrackSelectionRun3HF()
+{
+  return StaticTrackSelection<track_selection_cut_sets::GlobalTrackRun3>(getGlobalTrackSelectionRun3HF());
+}
+
+// Compile-time specialised version of getJEGlobalTrackSelectionRun2
+inline StaticTrackSelection<track_selection_cut_sets::JEGlobalTrackRun2> getStaticJEGlobalTrackSelectionRun2()
+{
+  return StaticTrackSelection<track_selection_cut_sets::JEGlobalTrackRun2>(getJEGlobalTrackSelectionRun2());
+}
+
 #endif // COMMON_CORE_TRACKSELECTIONDEFAULTS_H_
@@ -16,8 +16,6 @@
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
-#include <CommonDataFormat/IRFrame.h>
-#include <CommonDataFormat/InteractionRecord.h>
 #include <CommonUtils/StringUtils.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
@@ -37,8 +35,6 @@
 #include <string>
 #include <vector>
 
-using o2::InteractionRecord;
-
 namespace
 {
 int findBin(TH1* hist, const std::string& label)
@@ -219,42 +215,67 @@ std::vector<int> Zorro::initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber
 std::bitset<128> Zorro::fetch(uint64_t bcGlobalId, uint64_t tolerance)
 {
   mLastResult.reset();
-  if (bcGlobalId < mBCranges.front().getMin().toLong() - tolerance || bcGlobalId > mBCranges.back().getMax().toLong() + tolerance) {
+  if (mBCstart.empty() || bcGlobalId + tolerance < mBCstart.front() || bcGlobalId > mBCend.back() + tolerance) {
     setupHelpers((mOrbitResetTimestamp + static_cast<int64_t>(bcGlobalId * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000);
   }
 
-  o2::dataformats::IRFrame bcFrame{InteractionRecord::long2IR(bcGlobalId) - tolerance, InteractionRecord::long2IR(bcGlobalId) + tolerance};
+  const uint64_t frameMin = bcGlobalId > tolerance ? bcGlobalId - tolerance : 0;
+  const uint64_t frameMax = bcGlobalId + tolerance;
   if (bcGlobalId < mLastBCglobalId) { /// Handle the possible discontinuity in the BC processed by the analyses
     mLastSelectedIdx = 0;
   }
   uint64_t lastSelectedIdx = mLastSelectedIdx;
   mLastBCglobalId = bcGlobalId;
-  for (size_t i = mLastSelectedIdx; i < mBCranges.size(); i++) {
-    if (!mBCranges[i].isOutside(bcFrame)) {
-      for (int iMask{0}; iMask < 2; ++iMask) {
-        for (int iTOI{0}; iTOI < 64; ++iTOI) {
-          if (mZorroHelpers->at(i).selMask[iMask] & (1ull << iTOI)) {
-            mLastResult.set(iMask * 64 + iTOI, 1);
-            if (!mAccountedBCranges[i]) {
-              mATcounts[iMask * 64 + iTOI]++;
-              if (mAnalysedTriggers) {
-                mAnalysedTriggers->Fill(iMask * 64 + iTOI);
-              }
-            }
+
+  /// All the ranges before the first one with mBCendMax >= frameMin end before the BC frame: skip them with a galloping
+  /// search from the cursor, as the BCs are monotonically increasing within a dataframe
+  size_t first = mLastSelectedIdx;
+  if (first < mBCendMax.size() && mBCendMax[first] < frameMin) {
+    size_t step = 1;
+    size_t last = first + step;
+    while (last < mBCendMax.size() && mBCendMax[last] < frameMin) {
+      first = last;
+      step *= 2;
+      last = first + step;
+    }
+    last = std::min(last, mBCendMax.size());
+    first = std::lower_bound(mBCendMax.begin() + first, mBCendMax.begin() + last, frameMin) - mBCendMax.begin();
+    mLastSelectedIdx = first - 1;
+  }
+
+  for (size_t i = first; i < mBCstart.size(); i++) {
+    if (mBCstart[i] > frameMax) {
+      break;
+    } else if (mBCend[i] < frameMin) {
+      mLastSelectedIdx = i;
+      continue;
+    }
+    mLastResult |= mBCselection[i];
+    if (!mAccountedBCranges[i]) {
+      for (size_t iTrigger{0}; iTrigger < mBCselection[i].size(); ++iTrigger) {
+        if (mBCselection[i].test(iTrigger)) {
+          mATcounts[iTrigger]++;
+          if (mAnalysedTriggers) {
+            mAnalysedTriggers->Fill(iTrigger);
           }
         }
       }
-      mAccountedBCranges[i] = true;
-      mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
-    } else if (mBCranges[i].getMax() < bcFrame.getMin()) {
-      mLastSelectedIdx = i;
-    } else if (mBCranges[i].getMin() > bcFrame.getMax()) {
-      break;
     }
+    mAccountedBCranges[i] = true;
+    mLastSelectedIdx = mLastSelectedIdx == lastSelectedIdx-- ? i : mLastSelectedIdx; /// Decrease lastSelectedIdx to make sure this check is valid only in its first instance
   }
   return mLastResult;
 }
 
+std::vector<std::bitset<128>> Zorro::fetch(const std::vector<uint64_t>& bcGlobalIds, uint64_t tolerance)
+{
+  std::vector<std::bitset<128>> results(bcGlobalIds.size());
+  for (size_t i{0}; i < bcGlobalIds.size(); ++i) {
+    results[i] = fetch(bcGlobalIds[i], tolerance);
+  }
+  return results;
+}
+
 bool Zorro::isSelected(uint64_t bcGlobalId, uint64_t tolerance, TH2* ToiHisto)
 {
   uint64_t lastSelectedIdx = mLastSelectedIdx;
@@ -315,10 +336,17 @@ void Zorro::setupHelpers(int64_t timestamp)
   }
   mZorroHelpers = mCCDB->getSpecific<std::vector<ZorroHelper>>(mBaseCCDBPath + "ZorroHelpers", timestamp, {{"runNumber", std::to_string(mRunNumber)}});
   std::sort(mZorroHelpers->begin(), mZorroHelpers->end(), [](const auto& a, const auto& b) { return std::min(a.bcAOD, a.bcEvSel) < std::min(b.bcAOD, b.bcEvSel); });
-  mBCranges.clear();
+  mBCstart.clear();
+  mBCend.clear();
+  mBCendMax.clear();
+  mBCselection.clear();
   mAccountedBCranges.clear();
   for (const auto& helper : *mZorroHelpers) {
-    mBCranges.emplace_back(InteractionRecord::long2IR(std::min(helper.bcAOD, helper.bcEvSel)), InteractionRecord::long2IR(std::max(helper.bcAOD, helper.bcEvSel)));
+    mBCstart.push_back(std::min(helper.bcAOD, helper.bcEvSel));
+    mBCend.push_back(std::max(helper.bcAOD, helper.bcEvSel));
+    mBCendMax.push_back(mBCendMax.empty() ? mBCend.back() : std::max(mBCendMax.back(), mBCend.back()));
+    mBCselection.emplace_back((std::bitset<128>(helper.selMask[1]) << 64) | std::bitset<128>(helper.selMask[0]));
   }
-  mAccountedBCranges.resize(mBCranges.size(), false);
+  mAccountedBCranges.resize(mBCstart.size(), false);
+  mLastSelectedIdx = 0;
 }
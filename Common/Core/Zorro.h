@@ -22,7 +22,6 @@
 #include "ZorroHelper.h"
 #include "ZorroSummary.h"
 
-#include <CommonDataFormat/IRFrame.h>
 #include <Framework/HistogramRegistry.h>
 
 #include <TH1.h>
@@ -48,6 +47,7 @@ class Zorro
   Zorro() = default;
   std::vector<int> initCCDB(o2::ccdb::BasicCCDBManager* ccdb, int runNumber, uint64_t timestamp, std::string tois, int bcTolerance = 500);
   std::bitset<128> fetch(uint64_t bcGlobalId, uint64_t tolerance = 100);
+  std::vector<std::bitset<128>> fetch(const std::vector<uint64_t>& bcGlobalIds, uint64_t tolerance = 100); /// Trigger decisions of all the collisions of a dataframe, ordered by BC
   bool isSelected(uint64_t bcGlobalId, uint64_t tolerance = 100, TH2* toiHisto = nullptr);
   bool isNotSelectedByAny(uint64_t bcGlobalId, uint64_t tolerance = 100);
 
@@ -93,8 +93,11 @@ class Zorro
   TH1D* mSelections = nullptr;
   TH1D* mInspectedTVX = nullptr;
   std::bitset<128> mLastResult;
-  std::vector<bool> mAccountedBCranges; /// Avoid double accounting of inspected BC ranges
-  std::vector<o2::dataformats::IRFrame> mBCranges;
+  std::vector<bool> mAccountedBCranges;       /// Avoid double accounting of inspected BC ranges
+  std::vector<uint64_t> mBCstart;             /// First BC of the inspected BC ranges, sorted
+  std::vector<uint64_t> mBCend;               /// Last BC of the inspected BC ranges
+  std::vector<uint64_t> mBCendMax;            /// Running maximum of mBCend, used to skip the ranges before a BC
+  std::vector<std::bitset<128>> mBCselection; /// Software trigger decisions of the inspected BC ranges
   std::vector<ZorroHelper>* mZorroHelpers = nullptr;
   std::vector<std::string> mTOIs;
   std::vector<int> mTOIidx;
@@ -84,18 +84,24 @@ struct ITSResponse {
     return mResolutionParams[1] > -999.0 ? mResolutionParams[0] * std::erf((bg - mResolutionParams[1]) / mResolutionParams[2]) : mResolutionParams[0];
   }
 
+  /// Nsigma from the already decoded average cluster size, to share the decoding among the mass hypotheses
   template <o2::track::PID::ID id>
-  static float nSigmaITS(uint32_t itsClusterSizes, float momentum, float eta)
+  static float nSigmaITSFromAverage(const float average, float momentum, float eta)
   {
     unsigned int charge = (id == o2::track::PID::Helium3 || id == o2::track::PID::Alpha) ? 2 : 1;
     momentum *= charge;
     const float exp = expSignal<id>(momentum);
-    const float average = averageClusterSize(itsClusterSizes);
     const float coslInv = 1. / std::cosh(eta);
     const float resolution = expResolution<id>(momentum) * exp;
     return (average * coslInv - exp) / resolution;
   };
 
+  template <o2::track::PID::ID id>
+  static float nSigmaITS(uint32_t itsClusterSizes, float momentum, float eta)
+  {
+    return nSigmaITSFromAverage<id>(averageClusterSize(itsClusterSizes), momentum, eta);
+  };
+
   template <o2::track::PID::ID id, typename T>
   static float nSigmaITS(const T& track)
   {
@@ -240,7 +246,42 @@ using ITSNSigmaTr = ITSNSigmaTrImp<o2::aod::track::ITSClusterSizes, o2::aod::tra
 using ITSNSigmaHe = ITSNSigmaHeImp<o2::aod::track::ITSClusterSizes, o2::aod::track::P, o2::aod::track::Eta>;
 using ITSNSigmaAl = ITSNSigmaAlImp<o2::aod::track::ITSClusterSizes, o2::aod::track::P, o2::aod::track::Eta>;
 
+// Materialized columns, filled once per track by the pidITS task
+// The Nsigma columns have the same accessors as the dynamic ones: the two cannot be used together
+DECLARE_SOA_COLUMN(ITSAverageClusterSize, itsAverageClusterSize, float); //! Truncated mean of the ITS cluster sizes
+DECLARE_SOA_COLUMN(ITSNSigmaStoredEl, itsNSigmaEl, float);               //! Stored Nsigma separation with the ITS detector for electrons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredMu, itsNSigmaMu, float);               //! Stored Nsigma separation with the ITS detector for muons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredPi, itsNSigmaPi, float);               //! Stored Nsigma separation with the ITS detector for pions
+DECLARE_SOA_COLUMN(ITSNSigmaStoredKa, itsNSigmaKa, float);               //! Stored Nsigma separation with the ITS detector for kaons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredPr, itsNSigmaPr, float);               //! Stored Nsigma separation with the ITS detector for protons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredDe, itsNSigmaDe, float);               //! Stored Nsigma separation with the ITS detector for deuterons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredTr, itsNSigmaTr, float);               //! Stored Nsigma separation with the ITS detector for tritons
+DECLARE_SOA_COLUMN(ITSNSigmaStoredHe, itsNSigmaHe, float);               //! Stored Nsigma separation with the ITS detector for helium3
+DECLARE_SOA_COLUMN(ITSNSigmaStoredAl, itsNSigmaAl, float);               //! Stored Nsigma separation with the ITS detector for alphas
+
 } // namespace pidits
+
+DECLARE_SOA_TABLE(pidITSClsSize, "AOD", "pidITSClsSize", //! Table of the decoded ITS average cluster size
+                  pidits::ITSAverageClusterSize);
+DECLARE_SOA_TABLE(pidITSEl, "AOD", "pidITSEl", //! Table of the ITS response with Nsigma for electron
+                  pidits::ITSNSigmaStoredEl);
+DECLARE_SOA_TABLE(pidITSMu, "AOD", "pidITSMu", //! Table of the ITS response with Nsigma for muon
+                  pidits::ITSNSigmaStoredMu);
+DECLARE_SOA_TABLE(pidITSPi, "AOD", "pidITSPi", //! Table of the ITS response with Nsigma for pion
+                  pidits::ITSNSigmaStoredPi);
+DECLARE_SOA_TABLE(pidITSKa, "AOD", "pidITSKa", //! Table of the ITS response with Nsigma for kaon
+                  pidits::ITSNSigmaStoredKa);
+DECLARE_SOA_TABLE(pidITSPr, "AOD", "pidITSPr", //! Table of the ITS response with Nsigma for proton
+                  pidits::ITSNSigmaStoredPr);
+DECLARE_SOA_TABLE(pidITSDe, "AOD", "pidITSDe", //! Table of the ITS response with Nsigma for deuteron
+                  pidits::ITSNSigmaStoredDe);
+DECLARE_SOA_TABLE(pidITSTr, "AOD", "pidITSTr", //! Table of the ITS response with Nsigma for triton
+                  pidits::ITSNSigmaStoredTr);
+DECLARE_SOA_TABLE(pidITSHe, "AOD", "pidITSHe", //! Table of the ITS response with Nsigma for helium3
+                  pidits::ITSNSigmaStoredHe);
+DECLARE_SOA_TABLE(pidITSAl, "AOD", "pidITSAl", //! Table of the ITS response with Nsigma for alpha
+                  pidits::ITSNSigmaStoredAl);
+
 } // namespace o2::aod
 
 #endif // COMMON_DATAMODEL_PIDRESPONSEITS_H_
@@ -546,19 +546,24 @@ struct binning {
   static constexpr float binned_min = -6.35;
   static constexpr float bin_width = (binned_max - binned_min) / nbins;
 
-  // Function to pack a float into a binned value in table
-  template <typename T>
-  static void packInTable(const float& valueToBin, T& table)
+  // Function to pack a float into a binned value
+  static binned_t packValue(const float& valueToBin)
   {
     if (valueToBin <= binned_min) {
-      table(underflowBin);
+      return underflowBin;
     } else if (valueToBin >= binned_max) {
-      table(overflowBin);
+      return overflowBin;
     } else if (valueToBin >= 0) {
-      table(static_cast<binned_t>((valueToBin / bin_width) + 0.5f));
-    } else {
-      table(static_cast<binned_t>((valueToBin / bin_width) - 0.5f));
+      return static_cast<binned_t>((valueToBin / bin_width) + 0.5f);
     }
+    return static_cast<binned_t>((valueToBin / bin_width) - 0.5f);
+  }
+
+  // Function to pack a float into a binned value in table
+  template <typename T>
+  static void packInTable(const float& valueToBin, T& table)
+  {
+    table(packValue(valueToBin));
   }
 
   // Function to unpack a binned value into a float
@@ -599,6 +604,17 @@ DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaHe, tofNSigmaHe, //! Unwrapped (float) nsigm
 DECLARE_SOA_DYNAMIC_COLUMN(TOFNSigmaAl, tofNSigmaAl, //! Unwrapped (float) nsigma with the TOF detector for alpha
                            [](binning::binned_t nsigma_binned) -> float { return binning::unPackInTable(nsigma_binned); });
 
+// NSigma with reduced size 8 bit for all species in one table
+DECLARE_SOA_COLUMN(TOFNSigmaPackedEl, tofNSigmaPackedEl, binning::binned_t); //! Stored binned nsigma with the TOF detector for electron, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedMu, tofNSigmaPackedMu, binning::binned_t); //! Stored binned nsigma with the TOF detector for muon, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedPi, tofNSigmaPackedPi, binning::binned_t); //! Stored binned nsigma with the TOF detector for pion, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedKa, tofNSigmaPackedKa, binning::binned_t); //! Stored binned nsigma with the TOF detector for kaon, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedPr, tofNSigmaPackedPr, binning::binned_t); //! Stored binned nsigma with the TOF detector for proton, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedDe, tofNSigmaPackedDe, binning::binned_t); //! Stored binned nsigma with the TOF detector for deuteron, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedTr, tofNSigmaPackedTr, binning::binned_t); //! Stored binned nsigma with the TOF detector for triton, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedHe, tofNSigmaPackedHe, binning::binned_t); //! Stored binned nsigma with the TOF detector for helium3, interleaved table of all species
+DECLARE_SOA_COLUMN(TOFNSigmaPackedAl, tofNSigmaPackedAl, binning::binned_t); //! Stored binned nsigma with the TOF detector for alpha, interleaved table of all species
+
 } // namespace pidtof_tiny
 
 // Per particle tables
@@ -659,6 +675,19 @@ DECLARE_SOA_TABLE(pidTOFHe, "AOD", "pidTOFHe", //! Table of the TOF response wit
 DECLARE_SOA_TABLE(pidTOFAl, "AOD", "pidTOFAl", //! Table of the TOF response with binned Nsigma for alpha
                   pidtof_tiny::TOFNSigmaStoreAl, pidtof_tiny::TOFNSigmaAl<pidtof_tiny::TOFNSigmaStoreAl>);
 
+// Packed table with the binned Nsigma of all species, unpacked through the same accessors as the full tables
+DECLARE_SOA_TABLE(pidTOFPacked, "AOD", "pidTOFPacked", //! Table of the TOF response with binned Nsigma for all mass hypotheses
+                  pidtof_tiny::TOFNSigmaPackedEl, pidtof_tiny::TOFNSigmaPackedMu, pidtof_tiny::TOFNSigmaPackedPi, pidtof_tiny::TOFNSigmaPackedKa, pidtof_tiny::TOFNSigmaPackedPr, pidtof_tiny::TOFNSigmaPackedDe, pidtof_tiny::TOFNSigmaPackedTr, pidtof_tiny::TOFNSigmaPackedHe, pidtof_tiny::TOFNSigmaPackedAl,
+                  pidtof_tiny::TOFNSigmaEl<pidtof_tiny::TOFNSigmaPackedEl>,
+                  pidtof_tiny::TOFNSigmaMu<pidtof_tiny::TOFNSigmaPackedMu>,
+                  pidtof_tiny::TOFNSigmaPi<pidtof_tiny::TOFNSigmaPackedPi>,
+                  pidtof_tiny::TOFNSigmaKa<pidtof_tiny::TOFNSigmaPackedKa>,
+                  pidtof_tiny::TOFNSigmaPr<pidtof_tiny::TOFNSigmaPackedPr>,
+                  pidtof_tiny::TOFNSigmaDe<pidtof_tiny::TOFNSigmaPackedDe>,
+                  pidtof_tiny::TOFNSigmaTr<pidtof_tiny::TOFNSigmaPackedTr>,
+                  pidtof_tiny::TOFNSigmaHe<pidtof_tiny::TOFNSigmaPackedHe>,
+                  pidtof_tiny::TOFNSigmaAl<pidtof_tiny::TOFNSigmaPackedAl>);
+
 namespace pidtofbeta
 {
 DECLARE_SOA_COLUMN(Beta, beta, float);           //! TOF beta
@@ -20,6 +20,8 @@
 #ifndef COMMON_DATAMODEL_PIDRESPONSETPC_H_
 #define COMMON_DATAMODEL_PIDRESPONSETPC_H_
 
+#include "Common/Core/PID/TPCPIDResponse.h"
+
 #include <Framework/ASoA.h>
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/Logger.h>
@@ -284,19 +286,24 @@ struct binning {
   static constexpr float binned_min = -6.35;
   static constexpr float bin_width = (binned_max - binned_min) / nbins;
 
-  // Function to pack a float into a binned value in table
-  template <typename T>
-  static void packInTable(const float& valueToBin, T& table)
+  // Function to pack a float into a binned value
+  static binned_t packValue(const float& valueToBin)
   {
     if (valueToBin <= binned_min) {
-      table(underflowBin);
+      return underflowBin;
     } else if (valueToBin >= binned_max) {
-      table(overflowBin);
+      return overflowBin;
     } else if (valueToBin >= 0) {
-      table(static_cast<binned_t>((valueToBin / bin_width) + 0.5f));
-    } else {
-      table(static_cast<binned_t>((valueToBin / bin_width) - 0.5f));
+      return static_cast<binned_t>((valueToBin / bin_width) + 0.5f);
     }
+    return static_cast<binned_t>((valueToBin / bin_width) - 0.5f);
+  }
+
+  // Function to pack a float into a binned value in table
+  template <typename T>
+  static void packInTable(const float& valueToBin, T& table)
+  {
+    table(packValue(valueToBin));
   }
 
   // Function to unpack a binned value into a float
@@ -337,6 +344,17 @@ DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaHe, tpcNSigmaHe, //! Unwrapped (float) nsigm
 DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaAl, tpcNSigmaAl, //! Unwrapped (float) nsigma with the TPC detector for alpha
                            [](binning::binned_t nsigma_binned) -> float { return binning::unPackInTable(nsigma_binned); });
 
+// NSigma with reduced size 8 bit for all species in one table
+DECLARE_SOA_COLUMN(TPCNSigmaPackedEl, tpcNSigmaPackedEl, binning::binned_t); //! Stored binned nsigma with the TPC detector for electron, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedMu, tpcNSigmaPackedMu, binning::binned_t); //! Stored binned nsigma with the TPC detector for muon, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedPi, tpcNSigmaPackedPi, binning::binned_t); //! Stored binned nsigma with the TPC detector for pion, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedKa, tpcNSigmaPackedKa, binning::binned_t); //! Stored binned nsigma with the TPC detector for kaon, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedPr, tpcNSigmaPackedPr, binning::binned_t); //! Stored binned nsigma with the TPC detector for proton, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedDe, tpcNSigmaPackedDe, binning::binned_t); //! Stored binned nsigma with the TPC detector for deuteron, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedTr, tpcNSigmaPackedTr, binning::binned_t); //! Stored binned nsigma with the TPC detector for triton, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedHe, tpcNSigmaPackedHe, binning::binned_t); //! Stored binned nsigma with the TPC detector for helium3, interleaved table of all species
+DECLARE_SOA_COLUMN(TPCNSigmaPackedAl, tpcNSigmaPackedAl, binning::binned_t); //! Stored binned nsigma with the TPC detector for alpha, interleaved table of all species
+
 } // namespace pidtpc_tiny
 
 // Per particle tables
@@ -397,6 +415,105 @@ DECLARE_SOA_TABLE(pidTPCHe, "AOD", "pidTPCHe", //! Table of the TPC response wit
 DECLARE_SOA_TABLE(pidTPCAl, "AOD", "pidTPCAl", //! Table of the TPC response with binned Nsigma for alpha
                   pidtpc_tiny::TPCNSigmaStoreAl, pidtpc_tiny::TPCNSigmaAl<pidtpc_tiny::TPCNSigmaStoreAl>);
 
+// Packed table with the binned Nsigma of all species, unpacked through the same accessors as the full tables
+DECLARE_SOA_TABLE(pidTPCPacked, "AOD", "pidTPCPacked", //! Table of the TPC response with binned Nsigma for all mass hypotheses
+                  pidtpc_tiny::TPCNSigmaPackedEl, pidtpc_tiny::TPCNSigmaPackedMu, pidtpc_tiny::TPCNSigmaPackedPi, pidtpc_tiny::TPCNSigmaPackedKa, pidtpc_tiny::TPCNSigmaPackedPr, pidtpc_tiny::TPCNSigmaPackedDe, pidtpc_tiny::TPCNSigmaPackedTr, pidtpc_tiny::TPCNSigmaPackedHe, pidtpc_tiny::TPCNSigmaPackedAl,
+                  pidtpc_tiny::TPCNSigmaEl<pidtpc_tiny::TPCNSigmaPackedEl>,
+                  pidtpc_tiny::TPCNSigmaMu<pidtpc_tiny::TPCNSigmaPackedMu>,
+                  pidtpc_tiny::TPCNSigmaPi<pidtpc_tiny::TPCNSigmaPackedPi>,
+                  pidtpc_tiny::TPCNSigmaKa<pidtpc_tiny::TPCNSigmaPackedKa>,
+                  pidtpc_tiny::TPCNSigmaPr<pidtpc_tiny::TPCNSigmaPackedPr>,
+                  pidtpc_tiny::TPCNSigmaDe<pidtpc_tiny::TPCNSigmaPackedDe>,
+                  pidtpc_tiny::TPCNSigmaTr<pidtpc_tiny::TPCNSigmaPackedTr>,
+                  pidtpc_tiny::TPCNSigmaHe<pidtpc_tiny::TPCNSigmaPackedHe>,
+                  pidtpc_tiny::TPCNSigmaAl<pidtpc_tiny::TPCNSigmaPackedAl>);
+
+// Lazy tables: only the inputs not already in the track tables are stored, the Nsigma is evaluated on demand
+namespace pidtpc_lazy
+{
+DECLARE_SOA_COLUMN(TPCSignalForPid, tpcSignalForPid, float); //! dE/dx used for the PID (raw, corrected or MC tuned), negative if the PID is not evaluated for the track
+DECLARE_SOA_COLUMN(TPCMultForPid, tpcMultForPid, int);       //! TPC multiplicity used for the resolution, 0 if the track has no collision
+
+/// Holder of the TPC response used by the lazy Nsigma columns.
+/// The analysis task sets the response, retrieved from the same CCDB path and timestamp as the PID producer, before accessing the columns
+struct TPCLazyResponse {
+  static void setResponse(const o2::pid::tpc::Response* response) { mResponse = response; }
+  static const o2::pid::tpc::Response* getResponse() { return mResponse; }
+
+  template <o2::track::PID::ID id>
+  static float nSigma(const float tpcInnerParam, const float tgl, const float signed1Pt, const int16_t tpcNClsFound, const float tpcSignal, const int multTPC)
+  {
+    if (!mResponse) {
+      LOG(fatal) << "TPC response of the lazy Nsigma columns not set, call TPCLazyResponse::setResponse first";
+    }
+    if (tpcSignal < 0.f) {
+      return -999.f;
+    }
+    const float expSignal = mResponse->GetExpectedSignalFromValues(tpcInnerParam, id);
+    const float expSigma = mResponse->GetExpectedSigmaFromValues(multTPC, tpcInnerParam, tgl, signed1Pt, tpcNClsFound, id);
+    if (expSignal < 0.f || expSigma < 0.f) {
+      return -999.f;
+    }
+    return (tpcSignal - expSignal) / expSigma;
+  }
+
+ private:
+  static inline const o2::pid::tpc::Response* mResponse = nullptr;
+};
+
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaElImp, tpcNSigmaEl, //! Nsigma with the TPC detector for electron, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Electron>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaMuImp, tpcNSigmaMu, //! Nsigma with the TPC detector for muon, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Muon>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaPiImp, tpcNSigmaPi, //! Nsigma with the TPC detector for pion, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Pion>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaKaImp, tpcNSigmaKa, //! Nsigma with the TPC detector for kaon, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Kaon>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaPrImp, tpcNSigmaPr, //! Nsigma with the TPC detector for proton, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Proton>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaDeImp, tpcNSigmaDe, //! Nsigma with the TPC detector for deuteron, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Deuteron>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaTrImp, tpcNSigmaTr, //! Nsigma with the TPC detector for triton, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Triton>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaHeImp, tpcNSigmaHe, //! Nsigma with the TPC detector for helium3, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Helium3>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+DECLARE_SOA_DYNAMIC_COLUMN(TPCNSigmaAlImp, tpcNSigmaAl, //! Nsigma with the TPC detector for alpha, evaluated on demand
+                           [](float tpcInnerParam, float tgl, float signed1Pt, uint8_t tpcNClsFindable, int8_t tpcNClsFindableMinusFound, float tpcSignal, int multTPC) -> float {
+                             return TPCLazyResponse::nSigma<o2::track::PID::Alpha>(tpcInnerParam, tgl, signed1Pt, tpcNClsFindable - tpcNClsFindableMinusFound, tpcSignal, multTPC);
+                           });
+
+// Define user friendly names for the columns to attach to the tracks joined with the pidTPCLazy table
+using TPCNSigmaEl = TPCNSigmaElImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaMu = TPCNSigmaMuImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaPi = TPCNSigmaPiImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaKa = TPCNSigmaKaImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaPr = TPCNSigmaPrImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaDe = TPCNSigmaDeImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaTr = TPCNSigmaTrImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaHe = TPCNSigmaHeImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+using TPCNSigmaAl = TPCNSigmaAlImp<o2::aod::track::TPCInnerParam, o2::aod::track::Tgl, o2::aod::track::Signed1Pt, o2::aod::track::TPCNClsFindable, o2::aod::track::TPCNClsFindableMinusFound, TPCSignalForPid, TPCMultForPid>;
+
+} // namespace pidtpc_lazy
+
+DECLARE_SOA_TABLE(pidTPCLazy, "AOD", "pidTPCLazy", //! Compact inputs of the TPC response, to be joined with the tracks and the lazy Nsigma columns of pidtpc_lazy
+                  pidtpc_lazy::TPCSignalForPid, pidtpc_lazy::TPCMultForPid);
+
 // Extra tables
 namespace mcpidtpc
 {
@@ -33,12 +33,13 @@ struct TracksExtraConverter {
   Produces<aod::StoredTracksExtra_001> tracksExtra_001;
   void process(aod::TracksExtra_000 const& tracksExtra_000)
   {
-
+    tracksExtra_001.reserve(tracksExtra_000.size());
     for (const auto& track0 : tracksExtra_000) {
 
       uint32_t itsClusterSizes = 0;
+      const auto itsClusterMap = track0.itsClusterMap();
       for (int layer = 0; layer < 7; layer++) {
-        if (track0.itsClusterMap() & (1 << layer)) {
+        if (itsClusterMap & (1 << layer)) {
           itsClusterSizes |= (0xf << (layer * 4));
         }
       }
@@ -17,6 +17,7 @@
 ///
 
 #include "Common/Core/PID/DetectorResponse.h"
+#include "Common/Core/PID/PIDCalibrationService.h"
 #include "Common/Core/PID/PIDTOF.h"
 #include "Common/Core/PID/ParamBase.h"
 #include "Common/Core/PID/TPCPIDResponse.h"
@@ -134,27 +135,14 @@ struct bayesPid {
   std::array<std::array<float, PID::NIDs>, kNProb> Probability; /// Probabilities for all the cases defined in ProbType
   std::vector<PID::ID> enabledSpecies;                          /// Enabled species
 
-  /// Checker of the species that are enabled and initializer of the probabilities
-  template <ProbType detIndex, o2::track::PID::ID pid>
-  bool checkEnabled()
-  {
-    static_assert(detIndex < kNDet && detIndex >= 0);
-    if (!enabledDet[detIndex]) {
-      LOG(debug) << "Detector " << detectorName[detIndex] << " disabled";
-      return false; // Setting the probability to 1 if the detector is disabled
-    }
-    LOG(debug) << "Detector " << detectorName[detIndex] << " enabled with " << enabledSpecies.size() << " species";
-
-    for (const auto enabledPid : enabledSpecies) { // Checking that the species is enabled
-      LOG(debug) << "Testing " << PID::getName(enabledPid) << " " << static_cast<int>(enabledPid) << " vs " << static_cast<int>(pid);
-      if (enabledPid == pid) {
-        LOG(debug) << "Particle " << PID::getName(enabledPid) << " enabled";
-        Probability[detIndex][pid] = 1.f / enabledSpecies.size(); // set flat distribution (no decision yet)
-        return true;
-      }
-    }
-    return false;
-  }
+  // Buffers of the probabilities of a batch of tracks, stored species major: [enabled species][track in the batch]
+  static constexpr int NTracksPerBatch = 256;              /// Number of tracks processed together
+  std::vector<float> tpcDelta;                             /// Difference between the measured and expected dE/dx
+  std::vector<float> tpcSigma;                             /// Expected dE/dx resolution
+  std::vector<float> tofNSigma;                            /// TOF separation
+  std::vector<float> tofSigma;                             /// Expected TOF resolution
+  std::vector<uint8_t> hasTOF;                             /// Flag of the tracks with a TOF measurement
+  std::array<std::vector<float>, kNProb> probabilityBatch; /// Probabilities of the batch for all the cases defined in ProbType
 
   float fRange = 5.f;
 
@@ -242,6 +230,19 @@ struct bayesPid {
     } else { // All ok
       LOG(info) << enabledSpecies.size() << " species enabled for the Bayesian PID computation";
     }
+    const std::size_t batchBufferSize = enabledSpecies.size() * NTracksPerBatch;
+    tpcDelta.resize(batchBufferSize);
+    tpcSigma.resize(batchBufferSize);
+    tofNSigma.resize(batchBufferSize);
+    tofSigma.resize(batchBufferSize);
+    hasTOF.resize(NTracksPerBatch);
+    for (auto& probability : probabilityBatch) {
+      probability.resize(batchBufferSize);
+    }
+    // Flat lookup of the prior probabilities of the enabled species
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      std::fill_n(probabilityBatch[kPrior].begin() + iSpecies * NTracksPerBatch, NTracksPerBatch, Probability[kPrior][enabledSpecies[iSpecies]]);
+    }
     // Getting the parametrization parameters
     ccdb->setURL(url.value);
     ccdb->setTimestamp(timestamp.value);
@@ -274,46 +275,65 @@ struct bayesPid {
     } else {
       const std::string pathTPC = ccdbPathTPC.value;
       const auto time = timestamp.value;
-      responseTPC.SetParameters(ccdb->getForTimeStamp<o2::pid::tpc::Response>(pathTPC, time));
+      const auto responseHandle = o2::pid::PIDCalibrationService::get<o2::pid::tpc::Response>(ccdb, pathTPC, time, {});
+      if (!responseHandle.object) {
+        LOGP(fatal, "Could not find the TPC response object in {} for timestamp {}", pathTPC, time);
+      }
+      responseTPC.SetParameters(responseHandle.get());
       LOGP(info, "Loading TPC response from CCDB, using path: {} for timestamp {}", pathTPC, time);
       responseTPC.PrintAll();
     }
   }
 
-  /// Computes PID probabilities for the TPC
-  template <o2::track::PID::ID pid>
-  void ComputeTPCProbability(const Coll::iterator& collision, const Trks::iterator& track)
+  /// Gathers the TPC and TOF inputs of a batch of tracks in the species-major buffers
+  void gatherInputs(Coll const& collisions, Trks const& tracks, const int64_t firstTrack, const int nTracks)
   {
-
-    if (!checkEnabled<kTPC, pid>()) {
-      return;
+    const int nSpecies = enabledSpecies.size();
+    for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+      const auto& track = tracks.iteratorAt(firstTrack + iTrack);
+      hasTOF[iTrack] = track.hasTOF();
+      if (enabledDet[kTPC]) {
+        const auto& collision = collisions.iteratorAt(track.collisionId());
+        const float dedx = track.tpcSignal();
+        // if (fTuneMConData && ((fTuneMConDataMask & kDetTPC) == kDetTPC)){
+        //   dedx = GetTPCsignalTunedOnData(track);
+        // }
+        for (int iSpecies = 0; iSpecies < nSpecies; iSpecies++) {
+          const int index = iSpecies * NTracksPerBatch + iTrack;
+          tpcDelta[index] = dedx - responseTPC.GetExpectedSignal(track, enabledSpecies[iSpecies]);
+          tpcSigma[index] = responseTPC.GetExpectedSigma(collision, track, enabledSpecies[iSpecies]);
+        }
+      }
+      if (enabledDet[kTOF]) {
+        const float meanCorrFactor = 0.07 / fTOFtail; // Correction factor on the mean because of the tail (should be ~ 0.1 with tail = 1.1)
+        for (int iSpecies = 0; iSpecies < nSpecies; iSpecies++) {
+          const int index = iSpecies * NTracksPerBatch + iTrack;
+          tofNSigma[index] = /*responseTOFPID.GetSeparation(Response[kTOF], track) +*/ meanCorrFactor;
+          tofSigma[index] = /*responseTOFPID.GetExpectedSigma(Response[kTOF], track)*/ +0.f;
+        }
+      }
     }
+  }
 
-    const float dedx = track.tpcSignal();
-    bool mismatch = true;
-
-    // if (fTuneMConData && ((fTuneMConDataMask & kDetTPC) == kDetTPC)){
-    //   dedx = GetTPCsignalTunedOnData(track);
-    // }
-    const float bethe = responseTPC.GetExpectedSignal(track, pid);
-    const float sigma = responseTPC.GetExpectedSigma(collision, track, pid);
-    // LOG(info) << "For " << pid_constants::sNames[pid] << " computing bethe " << bethe << " and sigma " << sigma;
-    //  bethe = fTPCResponse.GetExpectedSignal(track, type, AliTPCPIDResponse::kdEdxDefault, fUseTPCEtaCorrection, fUseTPCMultiplicityCorrection, fUseTPCPileupCorrection);
-    //  sigma = fTPCResponse.GetExpectedSigma(track, type, AliTPCPIDResponse::kdEdxDefault, fUseTPCEtaCorrection, fUseTPCMultiplicityCorrection, fUseTPCPileupCorrection);
-
-    if (std::abs(dedx - bethe) > fRange * sigma) {
-      // Probability[kTPC][pid] = std::exp(-0.5 * fRange * fRange) / sigma; // BUG fix
-      Probability[kTPC][pid] = std::exp(-0.5 * fRange * fRange);
-    } else {
-      // Probability[kTPC][pid] = std::exp(-0.5 * (dedx - bethe) * (dedx - bethe) / (sigma * sigma)) / sigma; //BUG fix
-      Probability[kTPC][pid] = std::exp(-0.5 * (dedx - bethe) * (dedx - bethe) / (sigma * sigma));
-      mismatch = false;
-    }
-    if (Probability[kTPC][pid] <= 0.f) {
-      Probability[kTPC][pid] = 0.f;
-    }
-    if (mismatch) {
-      Probability[kTPC][pid] = 1.f / Probability[kTPC].size();
+  /// Computes PID probabilities for the TPC
+  void ComputeTPCProbability(const int nTracks)
+  {
+    std::vector<float>& probability = probabilityBatch[kTPC];
+    const float mismatchProbability = 1.f / PID::NIDs;
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      const int offset = iSpecies * NTracksPerBatch;
+      if (!enabledDet[kTPC]) { // Setting the probability to 1 if the detector is disabled
+        std::fill_n(probability.begin() + offset, nTracks, 1.f);
+        continue;
+      }
+      // Branch-free loop over contiguous inputs, vectorized by the compiler
+      for (int iTrack = offset; iTrack < offset + nTracks; iTrack++) {
+        const float delta = tpcDelta[iTrack];
+        const float sigma = tpcSigma[iTrack];
+        const float gaus = std::exp(-0.5f * delta * delta / (sigma * sigma));
+        // Outside of the range the track is considered a mismatch
+        probability[iTrack] = (std::abs(delta) > fRange * sigma) ? mismatchProbability : gaus;
+      }
     }
   }
 
@@ -328,19 +348,9 @@ struct bayesPid {
   using respTOF = o2::pid::tof::ExpTimes<Trks::iterator, pid>;
 
   /// Compute PID probabilities for TOF
-  template <o2::track::PID::ID pid>
-  void ComputeTOFProbability(const Trks::iterator& track)
+  void ComputeTOFProbability(const int nTracks)
   {
-
-    if (!checkEnabled<kTOF, pid>()) {
-      return;
-    }
-
-    if (!track.hasTOF()) {
-      return;
-    }
-    constexpr respTOF<pid> responseTOFPID;
-
+    std::vector<float>& probability = probabilityBatch[kTOF];
     // const float pt = track.pt();
     const float mismPropagationFactor[10] = {1., 1., 1., 1., 1., 1., 1., 1., 1., 1.};
     // In the O2 this cannot be done because the cluster information is missing in the AOD
@@ -385,76 +395,52 @@ struct bayesPid {
     //   fgTOFmismatchProb = fTOFResponse.GetMismatchProbability(track->GetTOFsignal(), track->Eta()) * nTOFcluster * 6E-6 * (1 + 2.90505e-01 / pt / pt); // mism weight * tof occupancy (including matching window factor) * pt dependence
     // }
 
-    const float meanCorrFactor = 0.07 / fTOFtail; // Correction factor on the mean because of the tail (should be ~ 0.1 with tail = 1.1)
-
-    const float nsigmas = /*responseTOFPID.GetSeparation(Response[kTOF], track) +*/ meanCorrFactor;
-
-    const float expTime = responseTOFPID.GetExpectedSignal(track);
-    const float sig = /*responseTOFPID.GetExpectedSigma(Response[kTOF], track)*/ +0.f;
-
-    if (nsigmas < fTOFtail) {
-      Probability[kTOF][pid] = std::exp(-0.5 * nsigmas * nsigmas) / sig;
-    } else {
-      Probability[kTOF][pid] = std::exp(-(nsigmas - fTOFtail * 0.5) * fTOFtail) / sig;
+    const float flatProbability = 1.f / enabledSpecies.size(); // flat distribution (no decision) for tracks without TOF
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      const int offset = iSpecies * NTracksPerBatch;
+      if (!enabledDet[kTOF]) { // Setting the probability to 1 if the detector is disabled
+        std::fill_n(probability.begin() + offset, nTracks, 1.f);
+        continue;
+      }
+      const float mismatch = fgTOFmismatchProb * mismPropagationFactor[enabledSpecies[iSpecies]];
+      for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+        const float nsigmas = tofNSigma[offset + iTrack];
+        const float sig = tofSigma[offset + iTrack];
+        const float core = std::exp(-0.5f * nsigmas * nsigmas) / sig;
+        const float tail = std::exp(-(nsigmas - fTOFtail * 0.5f) * fTOFtail) / sig;
+        probability[offset + iTrack] = hasTOF[iTrack] ? ((nsigmas < fTOFtail ? core : tail) + mismatch) : flatProbability;
+      }
     }
-
-    Probability[kTOF][pid] += fgTOFmismatchProb * mismPropagationFactor[pid];
-    LOG(debug) << "For " << pid_constants::sNames[pid] << " with signal " << track.tofSignal() << " computing exp time " << expTime << " and sigma " << sig << " and nsigma " << nsigmas << " probability " << Probability[kTOF][pid];
   }
 
   /// Calculate probabilities from all enabled detectors and species
-  void MergeProbabilities()
+  void MergeProbabilities(const int nTracks)
   {
-    LOG(debug) << "Merging probabilities";
-
-    float probSum[kNDet + 1] = {0.f}; /// Summed probabilities for all detectors + 1 for the sum of all detectors
-
-    for (const auto enabledPid : enabledSpecies) {
-      Probability[kMerged][enabledPid] = 1.f;
-      for (int det = 0; det < kNDet; det++) {
-        probSum[det] += Probability[det][enabledPid];
-        Probability[kMerged][enabledPid] *= Probability[det][enabledPid];
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      const int offset = iSpecies * NTracksPerBatch;
+      for (int iTrack = offset; iTrack < offset + nTracks; iTrack++) {
+        probabilityBatch[kMerged][iTrack] = probabilityBatch[kTOF][iTrack] * probabilityBatch[kTPC][iTrack];
       }
-      probSum[kNDet] += Probability[kMerged][enabledPid];
-      LOG(debug) << "For " << PID::getName(enabledPid);
-      for (int det = 0; det < kNDet; det++) {
-        if (enabledDet[det]) {
-          LOG(debug) << "\t" << detectorName[det] << " Probability " << Probability[det][enabledPid];
-        }
-      }
-      LOG(debug) << "\tCombined: " << Probability[kMerged][enabledPid];
     }
-    for (int det = 0; det < kNDet; det++) {
-      if (enabledDet[det]) {
-        LOG(debug) << "\tSum " << detectorName[det] << " Probability " << probSum[det];
-      }
-    }
-    LOG(debug) << "\tSum combined: " << probSum[kNDet];
   }
 
-  /// Calculate Bayesian probabilities
-  void ComputeBayesProbabilities()
+  /// Calculate Bayesian probabilities, normalized in one pass over the species
+  void ComputeBayesProbabilities(const int nTracks)
   {
-    LOG(debug) << "Computing bayes probabilities";
-
-    float sum = 0.;
-    for (const auto enabledPid : enabledSpecies) {
-      LOG(debug) << "Adding " << Probability[kMerged][enabledPid] << " with prior " << Probability[kPrior][enabledPid];
-      sum += Probability[kMerged][enabledPid] * Probability[kPrior][enabledPid];
-    }
-    if (sum <= 0) {
-      // LOG(warning) << "Invalid probability densities or prior probabilities";
-      for (uint64_t i = 0; i < Probability[kBayesian].size(); i++) {
-        Probability[kBayesian][i] = 1.f / Probability[kBayesian].size();
+    std::array<float, NTracksPerBatch> sum{};
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      const int offset = iSpecies * NTracksPerBatch;
+      for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+        probabilityBatch[kBayesian][offset + iTrack] = probabilityBatch[kMerged][offset + iTrack] * probabilityBatch[kPrior][offset + iTrack];
+        sum[iTrack] += probabilityBatch[kBayesian][offset + iTrack];
       }
-      return;
     }
-    for (const auto enabledPid : enabledSpecies) {
-      Probability[kBayesian][enabledPid] = Probability[kMerged][enabledPid] * Probability[kPrior][enabledPid] / sum;
-      // if (probDensityMism) {
-      //   probDensityMism[enabledPid] *= Probability[kPrior][enabledPid] / sum;
-      // }
-      LOG(debug) << "For " << PID::getName(enabledPid) << " merged prob. " << Probability[kMerged][enabledPid] << " prior " << Probability[kPrior][enabledPid] << " sum " << sum << " bayesian Probability: " << Probability[kBayesian][enabledPid];
+    for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+      const int offset = iSpecies * NTracksPerBatch;
+      for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+        // Invalid probability densities or prior probabilities are flagged with a negative value and handled when filling the tables
+        probabilityBatch[kBayesian][offset + iTrack] = sum[iTrack] <= 0.f ? -1.f : probabilityBatch[kBayesian][offset + iTrack] / sum[iTrack];
+      }
     }
   }
 
@@ -480,62 +466,57 @@ struct bayesPid {
     makeTable(pidHe, tablePIDHe);
     makeTable(pidAl, tablePIDAl);
 
-    for (auto const& trk : tracks) { // Loop on Tracks
-
-      auto collision = collisions.iteratorAt(trk.collisionId());
-      ComputeTPCProbability<PID::Electron>(collision, trk);
-      ComputeTPCProbability<PID::Muon>(collision, trk);
-      ComputeTPCProbability<PID::Pion>(collision, trk);
-      ComputeTPCProbability<PID::Kaon>(collision, trk);
-      ComputeTPCProbability<PID::Proton>(collision, trk);
-      ComputeTPCProbability<PID::Deuteron>(collision, trk);
-      ComputeTPCProbability<PID::Triton>(collision, trk);
-      ComputeTPCProbability<PID::Helium3>(collision, trk);
-      ComputeTPCProbability<PID::Alpha>(collision, trk);
-
-      ComputeTOFProbability<PID::Electron>(trk);
-      ComputeTOFProbability<PID::Muon>(trk);
-      ComputeTOFProbability<PID::Pion>(trk);
-      ComputeTOFProbability<PID::Kaon>(trk);
-      ComputeTOFProbability<PID::Proton>(trk);
-      ComputeTOFProbability<PID::Deuteron>(trk);
-      ComputeTOFProbability<PID::Triton>(trk);
-      ComputeTOFProbability<PID::Helium3>(trk);
-      ComputeTOFProbability<PID::Alpha>(trk);
-
-      MergeProbabilities();
-
-      ComputeBayesProbabilities();
-
-      if (pidEl == 1) {
-        tablePIDEl(Probability[kBayesian][PID::Electron] * 100.f);
-      }
-      if (pidMu == 1) {
-        tablePIDMu(Probability[kBayesian][PID::Muon] * 100.f);
-      }
-      if (pidPi == 1) {
-        tablePIDPi(Probability[kBayesian][PID::Pion] * 100.f);
-      }
-      if (pidKa == 1) {
-        tablePIDKa(Probability[kBayesian][PID::Kaon] * 100.f);
-      }
-      if (pidPr == 1) {
-        tablePIDPr(Probability[kBayesian][PID::Proton] * 100.f);
-      }
-      if (pidDe == 1) {
-        tablePIDDe(Probability[kBayesian][PID::Deuteron] * 100.f);
-      }
-      if (pidTr == 1) {
-        tablePIDTr(Probability[kBayesian][PID::Triton] * 100.f);
-      }
-      if (pidHe == 1) {
-        tablePIDHe(Probability[kBayesian][PID::Helium3] * 100.f);
-      }
-      if (pidAl == 1) {
-        tablePIDAl(Probability[kBayesian][PID::Alpha] * 100.f);
+    const int64_t nTracksTotal = tracks.size();
+    for (int64_t firstTrack = 0; firstTrack < nTracksTotal; firstTrack += NTracksPerBatch) { // Loop on batches of tracks
+      const int nTracks = std::min<int64_t>(NTracksPerBatch, nTracksTotal - firstTrack);
+
+      gatherInputs(collisions, tracks, firstTrack, nTracks);
+      ComputeTPCProbability(nTracks);
+      ComputeTOFProbability(nTracks);
+      MergeProbabilities(nTracks);
+      ComputeBayesProbabilities(nTracks);
+
+      for (int iTrack = 0; iTrack < nTracks; iTrack++) {
+        if (probabilityBatch[kBayesian][iTrack] < 0.f) { // Invalid probability densities or prior probabilities
+          for (uint64_t i = 0; i < Probability[kBayesian].size(); i++) {
+            Probability[kBayesian][i] = 1.f / Probability[kBayesian].size();
+          }
+        } else {
+          for (std::size_t iSpecies = 0; iSpecies < enabledSpecies.size(); iSpecies++) {
+            Probability[kBayesian][enabledSpecies[iSpecies]] = probabilityBatch[kBayesian][iSpecies * NTracksPerBatch + iTrack];
+          }
+        }
+
+        if (pidEl == 1) {
+          tablePIDEl(Probability[kBayesian][PID::Electron] * 100.f);
+        }
+        if (pidMu == 1) {
+          tablePIDMu(Probability[kBayesian][PID::Muon] * 100.f);
+        }
+        if (pidPi == 1) {
+          tablePIDPi(Probability[kBayesian][PID::Pion] * 100.f);
+        }
+        if (pidKa == 1) {
+          tablePIDKa(Probability[kBayesian][PID::Kaon] * 100.f);
+        }
+        if (pidPr == 1) {
+          tablePIDPr(Probability[kBayesian][PID::Proton] * 100.f);
+        }
+        if (pidDe == 1) {
+          tablePIDDe(Probability[kBayesian][PID::Deuteron] * 100.f);
+        }
+        if (pidTr == 1) {
+          tablePIDTr(Probability[kBayesian][PID::Triton] * 100.f);
+        }
+        if (pidHe == 1) {
+          tablePIDHe(Probability[kBayesian][PID::Helium3] * 100.f);
+        }
+        if (pidAl == 1) {
+          tablePIDAl(Probability[kBayesian][PID::Alpha] * 100.f);
+        }
+        const auto mostProbable = std::max_element(Probability[kBayesian].begin(), Probability[kBayesian].end());
+        tableBayes((*mostProbable) * 100.f, std::distance(Probability[kBayesian].begin(), mostProbable));
       }
-      const auto mostProbable = std::max_element(Probability[kBayesian].begin(), Probability[kBayesian].end());
-      tableBayes((*mostProbable) * 100.f, std::distance(Probability[kBayesian].begin(), mostProbable));
     }
   }
 };
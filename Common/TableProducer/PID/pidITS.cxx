@@ -20,6 +20,7 @@
 ///
 
 #include "Common/Core/MetadataHelper.h"
+#include "Common/Core/TableHelper.h"
 #include "Common/DataModel/PIDResponseITS.h"
 
 #include <CCDB/BasicCCDBManager.h>
@@ -32,6 +33,7 @@
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <string>
@@ -52,6 +54,11 @@ static const std::vector<std::string> parameterNames{"RespITSPar1", "RespITSPar2
                                                      "ResolutionPar1", "ResolutionPar2", "ResolutionPar3",
                                                      "ResolutionPar1_Z2", "ResolutionPar2_Z2", "ResolutionPar3_Z2"};
 
+static constexpr int nSpecies = 9;
+static const std::vector<std::string> particleNames{"El", "Mu", "Pi", "Ka", "Pr", "De", "Tr", "He", "Al"};
+static const std::vector<std::string> tableNames{"Enable"};
+static constexpr int defaultEnabled[nSpecies][1] = {{-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}, {-1}};
+
 static constexpr float defaultParameters[nCases][nParameters] = {
   {1.18941, 1.53792, 1.69961, 2.35117, 1.80347, 5.14355, 1.94669e-01, -2.08616e-01, 1.30753, 0.09, -999., -999.},
   {1.63806, 1.58847, 2.52275, 2.66505, 1.48405, 6.90453, 1.40487e-01, -4.31078e-01, 1.50052, 0.09, -999., -999.}};
@@ -66,6 +73,23 @@ struct itsPid {
                                               "Response parameters"};
   Configurable<bool> getFromCCDB{"getFromCCDB", false, "Get the parameters from CCDB"};
 
+  // Materialized tables, filled once per track so that the cluster sizes are decoded once
+  Produces<o2::aod::pidITSClsSize> tableClsSize;
+  Produces<o2::aod::pidITSEl> tablePIDEl;
+  Produces<o2::aod::pidITSMu> tablePIDMu;
+  Produces<o2::aod::pidITSPi> tablePIDPi;
+  Produces<o2::aod::pidITSKa> tablePIDKa;
+  Produces<o2::aod::pidITSPr> tablePIDPr;
+  Produces<o2::aod::pidITSDe> tablePIDDe;
+  Produces<o2::aod::pidITSTr> tablePIDTr;
+  Produces<o2::aod::pidITSHe> tablePIDHe;
+  Produces<o2::aod::pidITSAl> tablePIDAl;
+  Configurable<LabeledArray<int>> enableParticle{"enableParticle",
+                                                 {defaultEnabled[0], nSpecies, 1, particleNames, tableNames},
+                                                 "Produce the table with the ITS Nsigma for the various mass hypotheses. Values different than -1 override the automatic setup: the corresponding table can be set off (0) or on (1)"};
+  Configurable<int> enableClsSize{"enableClsSize", -1, "Produce the table with the ITS average cluster size. Values different than -1 override the automatic setup: the table can be set off (0) or on (1)"};
+  std::array<int, nSpecies> mEnabledTables{};
+
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   Configurable<std::string> paramfile{"param-file", "", "Path to the parametrization object, if empty the parametrization is not taken from file"};
   Configurable<std::string> url{"ccdb-url", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -73,7 +97,7 @@ struct itsPid {
   Configurable<std::string> recoPass{"recoPass", "", "Reconstruction pass name for CCDB query (automatically takes latest object for timestamp if blank)"};
   Configurable<int64_t> ccdbTimestamp{"ccdb-timestamp", 0, "timestamp of the object used to query in CCDB the detector response. Exceptions: -1 gets the latest object, 0 gets the run dependent timestamp"};
 
-  void init(o2::framework::InitContext&)
+  void init(o2::framework::InitContext& initContext)
   {
     if (getFromCCDB) {
       ccdb->setURL(url.value);
@@ -96,6 +120,28 @@ struct itsPid {
                                           itsParams->get(dataType, "ResolutionPar2_Z2"),
                                           itsParams->get(dataType, "ResolutionPar3_Z2"));
     }
+
+    // Checking the tables are requested in the workflow and enabling them
+    bool anyTable = false;
+    for (int i = 0; i < nSpecies; i++) {
+      mEnabledTables[i] = enableParticle->get(particleNames[i].c_str(), "Enable");
+      o2::common::core::enableFlagIfTableRequired(initContext, "pidITS" + particleNames[i], mEnabledTables[i]);
+      anyTable = anyTable || mEnabledTables[i] == 1;
+    }
+    o2::common::core::enableFlagIfTableRequired(initContext, "pidITSClsSize", enableClsSize);
+    anyTable = anyTable || enableClsSize == 1;
+    if (!anyTable && doprocessProducer) {
+      LOG(info) << "No ITS PID tables are required, disabling the producer";
+      doprocessProducer.value = false;
+    }
+  }
+
+  template <o2::track::PID::ID id, typename TableType>
+  void fillNSigma(TableType& table, const float average, const float momentum, const float eta)
+  {
+    if (mEnabledTables[id] == 1) {
+      table(o2::aod::ITSResponse::nSigmaITSFromAverage<id>(average, momentum, eta));
+    }
   }
 
   /// Dummy process function for BCs, needed in case both Run2 and Run3 process functions are disabled
@@ -115,6 +161,44 @@ struct itsPid {
     }
   }
   PROCESS_SWITCH(itsPid, processTest, "Produce a test", false);
+
+  void processProducer(o2::soa::Join<aod::Tracks, aod::TracksExtra> const& tracks)
+  {
+    auto reserveTable = [&tracks](const int flag, auto& table) {
+      if (flag == 1) {
+        table.reserve(tracks.size());
+      }
+    };
+    reserveTable(enableClsSize, tableClsSize);
+    reserveTable(mEnabledTables[o2::track::PID::Electron], tablePIDEl);
+    reserveTable(mEnabledTables[o2::track::PID::Muon], tablePIDMu);
+    reserveTable(mEnabledTables[o2::track::PID::Pion], tablePIDPi);
+    reserveTable(mEnabledTables[o2::track::PID::Kaon], tablePIDKa);
+    reserveTable(mEnabledTables[o2::track::PID::Proton], tablePIDPr);
+    reserveTable(mEnabledTables[o2::track::PID::Deuteron], tablePIDDe);
+    reserveTable(mEnabledTables[o2::track::PID::Triton], tablePIDTr);
+    reserveTable(mEnabledTables[o2::track::PID::Helium3], tablePIDHe);
+    reserveTable(mEnabledTables[o2::track::PID::Alpha], tablePIDAl);
+
+    for (const auto& track : tracks) {
+      const float average = o2::aod::ITSResponse::averageClusterSize(track.itsClusterSizes());
+      const float momentum = track.p();
+      const float eta = track.eta();
+      if (enableClsSize == 1) {
+        tableClsSize(average);
+      }
+      fillNSigma<o2::track::PID::Electron>(tablePIDEl, average, momentum, eta);
+      fillNSigma<o2::track::PID::Muon>(tablePIDMu, average, momentum, eta);
+      fillNSigma<o2::track::PID::Pion>(tablePIDPi, average, momentum, eta);
+      fillNSigma<o2::track::PID::Kaon>(tablePIDKa, average, momentum, eta);
+      fillNSigma<o2::track::PID::Proton>(tablePIDPr, average, momentum, eta);
+      fillNSigma<o2::track::PID::Deuteron>(tablePIDDe, average, momentum, eta);
+      fillNSigma<o2::track::PID::Triton>(tablePIDTr, average, momentum, eta);
+      fillNSigma<o2::track::PID::Helium3>(tablePIDHe, average, momentum, eta);
+      fillNSigma<o2::track::PID::Alpha>(tablePIDAl, average, momentum, eta);
+    }
+  }
+  PROCESS_SWITCH(itsPid, processProducer, "Produce the materialized ITS cluster size and Nsigma tables, if requested by the workflow", true);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -599,6 +599,10 @@ struct tofPidMerge {
   Produces<o2::aod::pidTOFFullHe> tablePIDFullHe;
   Produces<o2::aod::pidTOFFullAl> tablePIDFullAl;
 
+  // Table to produce (binned Nsigma of all mass hypotheses)
+  Produces<o2::aod::pidTOFPacked> tablePIDPacked;
+  int enablePacked = -1;
+
   // Beta tables
   Produces<aod::pidTOFbeta> tablePIDBeta;
   Produces<aod::pidTOFmass> tablePIDTOFMass;
@@ -612,6 +616,7 @@ struct tofPidMerge {
   Configurable<LabeledArray<int>> enableParticle{"enableParticle",
                                                  {kDefaultParEnabled[0], nSpecies, kParEnabledN, particleNames, kParEnabledNames},
                                                  "Produce PID information for the various mass hypotheses. Values different than -1 override the automatic setup: the corresponding table can be set off (0) or on (1)"};
+  Configurable<int> enableParticlesPacked{"enableParticlesPacked", -1, "Produce the binned PID information of all mass hypotheses in a single table. Values different than -1 override the automatic setup: the table can be set off (0) or on (1)"};
 
   // Histograms for QA
   std::array<std::shared_ptr<TH2>, nSpecies> hnsigma;
@@ -620,8 +625,9 @@ struct tofPidMerge {
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
 
   // Running variables
-  std::vector<int> mEnabledParticles;     // Vector of enabled PID hypotheses to loop on when making tables
-  std::vector<int> mEnabledParticlesFull; // Vector of enabled PID hypotheses to loop on when making full tables
+  std::vector<int> mEnabledParticles;           // Vector of enabled PID hypotheses to loop on when making tables
+  std::vector<int> mEnabledParticlesFull;       // Vector of enabled PID hypotheses to loop on when making full tables
+  std::array<bool, nSpecies> mComputeSpecies{}; // PID hypotheses for which the Nsigma is needed by any table, used in the fused processing
   void init(o2::framework::InitContext& initContext)
   {
     LOG(debug) << "Initializing the TOF PID Merge task";
@@ -642,7 +648,9 @@ struct tofPidMerge {
         mEnabledParticlesFull.push_back(i);
       }
     }
-    if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0) {
+    enablePacked = enableParticlesPacked.value;
+    o2::common::core::enableFlagIfTableRequired(initContext, "pidTOFPacked", enablePacked);
+    if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0 && enablePacked != 1) {
       LOG(info) << "No PID tables are required, disabling the task";
       doprocessRun3.value = false;
       doprocessRun2.value = false;
@@ -662,8 +670,8 @@ struct tofPidMerge {
       if (doprocessRun2 && doprocessRun3) {
         LOG(fatal) << "Both processRun2 and processRun3 are enabled. Pick one of the two";
       }
-      if (!doprocessRun2 && !doprocessRun3) {
-        LOG(fatal) << "Neither processRun2 nor processRun3 are enabled. Pick one of the two";
+      if (!doprocessRun2 && !doprocessRun3 && !doprocessRun3Fused) {
+        LOG(fatal) << "Neither processRun2 nor processRun3 (or processRun3Fused) are enabled. Pick one of the two";
       }
     }
 
@@ -715,8 +723,32 @@ struct tofPidMerge {
       if (doprocessRun2BetaM && doprocessRun3BetaM) {
         LOG(fatal) << "Both processRun2BetaM and processRun3BetaM are enabled. Pick one of the two";
       }
-      if (!doprocessRun2BetaM && !doprocessRun3BetaM) {
-        LOG(fatal) << "Neither processRun2BetaM nor processRun3BetaM are enabled. Pick one of the two";
+      if (!doprocessRun2BetaM && !doprocessRun3BetaM && !doprocessRun3Fused) {
+        LOG(fatal) << "Neither processRun2BetaM nor processRun3BetaM (or processRun3Fused) are enabled. Pick one of the two";
+      }
+    }
+
+    // The fused processing replaces the separate Run 3 Nsigma and beta/mass passes
+    if (doprocessRun3Fused) {
+      if (doprocessRun2 || doprocessRun2BetaM) {
+        LOG(fatal) << "processRun3Fused cannot be enabled together with the Run 2 process functions";
+      }
+      doprocessRun3.value = false;
+      doprocessRun3BetaM.value = false;
+      if (mEnabledParticlesFull.size() == 0 && mEnabledParticles.size() == 0 && enablePacked != 1 && !enableTableBeta && !enableTableMass) {
+        LOG(info) << "No TOF table is required, disabling the fused processing";
+        doprocessRun3Fused.value = false;
+      } else {
+        LOG(info) << "Fused processing enabled: Nsigma, beta and mass tables are produced in a single pass, disabling processRun3 and processRun3BetaM";
+      }
+      for (const int& i : mEnabledParticles) {
+        mComputeSpecies[i] = true;
+      }
+      for (const int& i : mEnabledParticlesFull) {
+        mComputeSpecies[i] = true;
+      }
+      if (enablePacked == 1) {
+        mComputeSpecies.fill(true);
       }
     }
   }
@@ -803,6 +835,50 @@ struct tofPidMerge {
     }
   }
 
+  // Fills the table of the given particle ID with the given resolution and Nsigma
+  void fillTable(const int id, const float resolution, const float nsigma, const bool fullTable = false)
+  {
+    auto fill = [&](auto& tableFull, auto& tableTiny) {
+      if (fullTable) {
+        tableFull(resolution, nsigma);
+      } else {
+        aod::pidtof_tiny::binning::packInTable(nsigma, tableTiny);
+      }
+    };
+    switch (id) {
+      case kIdxEl:
+        fill(tablePIDFullEl, tablePIDEl);
+        break;
+      case kIdxMu:
+        fill(tablePIDFullMu, tablePIDMu);
+        break;
+      case kIdxPi:
+        fill(tablePIDFullPi, tablePIDPi);
+        break;
+      case kIdxKa:
+        fill(tablePIDFullKa, tablePIDKa);
+        break;
+      case kIdxPr:
+        fill(tablePIDFullPr, tablePIDPr);
+        break;
+      case kIdxDe:
+        fill(tablePIDFullDe, tablePIDDe);
+        break;
+      case kIdxTr:
+        fill(tablePIDFullTr, tablePIDTr);
+        break;
+      case kIdxHe:
+        fill(tablePIDFullHe, tablePIDHe);
+        break;
+      case kIdxAl:
+        fill(tablePIDFullAl, tablePIDAl);
+        break;
+      default:
+        LOG(fatal) << "Wrong particle ID in fillTable() for " << (fullTable ? "full" : "tiny") << " tables";
+        break;
+    }
+  }
+
   // Makes the table empty for the given particle ID, filling it with dummy values
   void makeTableEmpty(const int id, bool fullTable = false)
   {
@@ -876,6 +952,20 @@ struct tofPidMerge {
     }
   }
 
+  // Fills the packed table with the binned Nsigma of all mass hypotheses, in the order of the table columns
+  template <typename TrackType, typename... ResponseTypes>
+  void makeTablePacked(const TrackType& trk, const ResponseTypes&... responses)
+  {
+    tablePIDPacked(aod::pidtof_tiny::binning::packValue(responses.GetSeparation(tofResponse->parameters, trk))...);
+  }
+
+  // Makes the packed table empty, filling it with dummy values
+  void makeTablePackedEmpty()
+  {
+    constexpr auto kEmpty = aod::pidtof_tiny::binning::underflowBin;
+    tablePIDPacked(kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty, kEmpty);
+  }
+
   void process(aod::BCs const&) {}
 
   template <o2::track::PID::ID pid>
@@ -903,6 +993,9 @@ struct tofPidMerge {
     for (auto const& pidId : mEnabledParticlesFull) {
       reserveTable(pidId, tracks.size(), true);
     }
+    if (enablePacked == 1) {
+      tablePIDPacked.reserve(tracks.size());
+    }
 
     float resolution = 1.f; // Last resolution assigned
     float nsigma = 0;
@@ -914,6 +1007,9 @@ struct tofPidMerge {
         for (auto const& pidId : mEnabledParticlesFull) {
           makeTableEmpty(pidId, true);
         }
+        if (enablePacked == 1) {
+          makeTablePackedEmpty();
+        }
         continue;
       }
 
@@ -1036,6 +1132,9 @@ struct tofPidMerge {
           hnsigmaFull[pidId]->Fill(trk.p(), nsigma);
         }
       }
+      if (enablePacked == 1) {
+        makeTablePacked(trk, responseEl, responseMu, responsePi, responseKa, responsePr, responseDe, responseTr, responseHe, responseAl);
+      }
     }
   }
   PROCESS_SWITCH(tofPidMerge, processRun3, "Produce Run 3 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
@@ -1065,6 +1164,9 @@ struct tofPidMerge {
     for (auto const& pidId : mEnabledParticlesFull) {
       reserveTable(pidId, tracks.size(), true);
     }
+    if (enablePacked == 1) {
+      tablePIDPacked.reserve(tracks.size());
+    }
 
     float resolution = 1.f; // Last resolution assigned
     float nsigma = 0;
@@ -1076,6 +1178,9 @@ struct tofPidMerge {
         for (auto const& pidId : mEnabledParticlesFull) {
           makeTableEmpty(pidId, true);
         }
+        if (enablePacked == 1) {
+          makeTablePackedEmpty();
+        }
         continue;
       }
 
@@ -1198,6 +1303,9 @@ struct tofPidMerge {
           hnsigmaFull[pidId]->Fill(trk.p(), nsigma);
         }
       }
+      if (enablePacked == 1) {
+        makeTablePacked(trk, responseEl, responseMu, responsePi, responseKa, responsePr, responseDe, responseTr, responseHe, responseAl);
+      }
     }
   }
   PROCESS_SWITCH(tofPidMerge, processRun2, "Produce Run 2 Nsigma table. Set to off if the tables are not required, or autoset is on", false);
@@ -1250,6 +1358,107 @@ struct tofPidMerge {
     }
   }
   PROCESS_SWITCH(tofPidMerge, processRun3BetaM, "Produce Run 3 Beta and Mass table. Set to off if the tables are not required, or autoset is on", false);
+
+  // Computes the expected resolution and the Nsigma once per track for all the needed mass hypotheses, in the order of the particle indices
+  template <typename TrackType, typename... ResponseTypes>
+  void computeSeparations(const TrackType& trk, std::array<float, nSpecies>& resolutions, std::array<float, nSpecies>& nsigmas, const ResponseTypes&... responses)
+  {
+    int id = 0;
+    auto computeSpecies = [&](const auto& response) {
+      if (mComputeSpecies[id]) {
+        resolutions[id] = response.GetExpectedSigma(tofResponse->parameters, trk);
+        nsigmas[id] = response.GetSeparation(tofResponse->parameters, trk, resolutions[id]);
+      }
+      id++;
+    };
+    (computeSpecies(responses), ...);
+  }
+
+  void processRun3Fused(Run3TrksWtofWevTime const& tracks,
+                        aod::Collisions const&,
+                        aod::BCsWithTimestamps const& bcs)
+  {
+    constexpr auto responseEl = ResponseImplementation<PID::Electron>();
+    constexpr auto responseMu = ResponseImplementation<PID::Muon>();
+    constexpr auto responsePi = ResponseImplementation<PID::Pion>();
+    constexpr auto responseKa = ResponseImplementation<PID::Kaon>();
+    constexpr auto responsePr = ResponseImplementation<PID::Proton>();
+    constexpr auto responseDe = ResponseImplementation<PID::Deuteron>();
+    constexpr auto responseTr = ResponseImplementation<PID::Triton>();
+    constexpr auto responseHe = ResponseImplementation<PID::Helium3>();
+    constexpr auto responseAl = ResponseImplementation<PID::Alpha>();
+
+    tofResponse->processSetup(bcs.iteratorAt(0)); // Update the calibration parameters
+
+    for (auto const& pidId : mEnabledParticles) {
+      reserveTable(pidId, tracks.size(), false);
+    }
+    for (auto const& pidId : mEnabledParticlesFull) {
+      reserveTable(pidId, tracks.size(), true);
+    }
+    if (enablePacked == 1) {
+      tablePIDPacked.reserve(tracks.size());
+    }
+    if (enableTableBeta) {
+      tablePIDBeta.reserve(tracks.size());
+    }
+    if (enableTableMass) {
+      tablePIDTOFMass.reserve(tracks.size());
+    }
+
+    std::array<float, nSpecies> resolutions{};
+    std::array<float, nSpecies> nsigmas{};
+    for (auto const& trk : tracks) { // Single loop on all tracks
+      // Beta and mass do not depend on the collision assignment
+      if (enableTableBeta || enableTableMass) {
+        const float beta = responseBeta.GetBeta(trk);
+        if (enableTableBeta) {
+          tablePIDBeta(beta, responseBeta.GetExpectedSigma(trk));
+        }
+        if (enableTableMass) {
+          if (enableTOFParamsForBetaMass) {
+            tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk.tofExpMom() / (1.f + trk.sign() * tofResponse->parameters.getMomentumChargeShift(trk.eta())), beta));
+          } else {
+            tablePIDTOFMass(o2::pid::tof::TOFMass::GetTOFMass(trk, beta));
+          }
+        }
+      }
+
+      if (!trk.has_collision()) { // Track was not assigned, cannot compute NSigma (no event time) -> filling with empty table
+        for (auto const& pidId : mEnabledParticles) {
+          makeTableEmpty(pidId, false);
+        }
+        for (auto const& pidId : mEnabledParticlesFull) {
+          makeTableEmpty(pidId, true);
+        }
+        if (enablePacked == 1) {
+          makeTablePackedEmpty();
+        }
+        continue;
+      }
+
+      computeSeparations(trk, resolutions, nsigmas, responseEl, responseMu, responsePi, responseKa, responsePr, responseDe, responseTr, responseHe, responseAl);
+      for (auto const& pidId : mEnabledParticles) {
+        fillTable(pidId, resolutions[pidId], nsigmas[pidId], false);
+        if (enableQaHistograms) {
+          hnsigma[pidId]->Fill(trk.p(), nsigmas[pidId]);
+        }
+      }
+      for (auto const& pidId : mEnabledParticlesFull) {
+        fillTable(pidId, resolutions[pidId], nsigmas[pidId], true);
+        if (enableQaHistograms) {
+          hnsigmaFull[pidId]->Fill(trk.p(), nsigmas[pidId]);
+        }
+      }
+      if (enablePacked == 1) {
+        using Binning = aod::pidtof_tiny::binning;
+        tablePIDPacked(Binning::packValue(nsigmas[kIdxEl]), Binning::packValue(nsigmas[kIdxMu]), Binning::packValue(nsigmas[kIdxPi]),
+                       Binning::packValue(nsigmas[kIdxKa]), Binning::packValue(nsigmas[kIdxPr]), Binning::packValue(nsigmas[kIdxDe]),
+                       Binning::packValue(nsigmas[kIdxTr]), Binning::packValue(nsigmas[kIdxHe]), Binning::packValue(nsigmas[kIdxAl]));
+      }
+    }
+  }
+  PROCESS_SWITCH(tofPidMerge, processRun3Fused, "Produce Run 3 Nsigma, beta and mass tables in a single pass over the tracks, replaces processRun3 and processRun3BetaM", false);
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -84,6 +84,7 @@ struct CaloClusterProducer {
   std::vector<o2::phos::TriggerRecord> outputPHOSClusterTrigRecs;
   std::vector<int> mclabels;
   std::vector<float> mcamplitudes;
+  std::vector<int> cpvRegions;
 
   int mRunNumber{0};
 
@@ -208,15 +209,16 @@ struct CaloClusterProducer {
       if ((c.cellType() == phos::TRU2x2 || c.cellType() == phos::TRU4x4) && c.cellNumber() == 0) {
         continue;
       }
+      const uint64_t cellBC = c.bc_as<aod::BCsWithTimestamps>().globalBC();
       if (phosCellTRs.size() == 0) { // first cell, first TrigRec
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, 0, 0); // BC,first cell, ncells
       }
-      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != c.bc_as<aod::BCsWithTimestamps>().globalBC()) { // switch to new BC
+      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != cellBC) { // switch to new BC
         // switch to another BC: set size and create next TriRec
         phosCellTRs.back().setNumberOfObjects(phosCells.size() - phosCellTRs.back().getFirstEntry());
         // Next event/trig rec.
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, phosCells.size(), 0);
       }
       phosCells.emplace_back(c.cellNumber(), c.amplitude(), c.time(),
@@ -336,36 +338,36 @@ struct CaloClusterProducer {
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = cpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
+          cpvRegions.clear();
+          cpvRegions.push_back(phosIndex);
           if (posX > -kCpvMaxX + cellSizeX) {
             if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
+              cpvRegions.push_back(phosIndex - kCpvZ - 1);
             }
-            regions.push_back(phosIndex - kCpvZ);
+            cpvRegions.push_back(phosIndex - kCpvZ);
             if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
+              cpvRegions.push_back(phosIndex - kCpvZ + 1);
             }
           }
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
+            cpvRegions.push_back(phosIndex - 1);
           }
           if (posZ < kCpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
+            cpvRegions.push_back(phosIndex + 1);
           }
           if (posX < kCpvMaxX - cellSizeX) {
             if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
+              cpvRegions.push_back(phosIndex + kCpvZ - 1);
             }
-            regions.push_back(phosIndex + kCpvZ);
+            cpvRegions.push_back(phosIndex + kCpvZ);
             if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
+              cpvRegions.push_back(phosIndex + kCpvZ + 1);
             }
           }
           float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
 
-          for (const int& indx : regions) {
+          for (const int& indx : cpvRegions) {
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
                 auto p = cpvMatchPoints[indx][ii];
@@ -503,15 +505,16 @@ struct CaloClusterProducer {
       if ((c.cellType() == phos::TRU2x2 || c.cellType() == phos::TRU4x4) && c.cellNumber() == 0) {
         continue;
       }
+      const uint64_t cellBC = c.bc_as<aod::BCsWithTimestamps>().globalBC();
       if (phosCellTRs.size() == 0) { // first cell, first TrigRec
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, 0, 0); // BC,first cell, ncells
       }
-      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != c.bc_as<aod::BCsWithTimestamps>().globalBC()) { // switch to new BC
+      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != cellBC) { // switch to new BC
         // switch to another BC: set size and create next TriRec
         phosCellTRs.back().setNumberOfObjects(phosCells.size() - phosCellTRs.back().getFirstEntry());
         // Next event/trig rec.
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, phosCells.size(), 0);
       }
       phosCells.emplace_back(c.cellNumber(), c.amplitude(), c.time(),
@@ -652,36 +655,36 @@ struct CaloClusterProducer {
 
         if (mod >= 2 && cpvExist) { // CPV exist in mods 2,3,4
           int phosIndex = cpvMatchIndex(mod, posX, posZ);
-          std::vector<int> regions;
-          regions.push_back(phosIndex);
+          cpvRegions.clear();
+          cpvRegions.push_back(phosIndex);
           if (posX > -kCpvMaxX + cellSizeX) {
             if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-              regions.push_back(phosIndex - kCpvZ - 1);
+              cpvRegions.push_back(phosIndex - kCpvZ - 1);
             }
-            regions.push_back(phosIndex - kCpvZ);
+            cpvRegions.push_back(phosIndex - kCpvZ);
             if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-              regions.push_back(phosIndex - kCpvZ + 1);
+              cpvRegions.push_back(phosIndex - kCpvZ + 1);
             }
           }
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-            regions.push_back(phosIndex - 1);
+            cpvRegions.push_back(phosIndex - 1);
           }
           if (posZ < kCpvMaxZ - cellSizeZ) { // top
-            regions.push_back(phosIndex + 1);
+            cpvRegions.push_back(phosIndex + 1);
           }
           if (posX < kCpvMaxX - cellSizeX) {
             if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-              regions.push_back(phosIndex + kCpvZ - 1);
+              cpvRegions.push_back(phosIndex + kCpvZ - 1);
             }
-            regions.push_back(phosIndex + kCpvZ);
+            cpvRegions.push_back(phosIndex + kCpvZ);
             if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-              regions.push_back(phosIndex + kCpvZ + 1);
+              cpvRegions.push_back(phosIndex + kCpvZ + 1);
             }
           }
           float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
           float sigmaZ = 1. / std::min(3.3, 1.12 + 0.35 * std::exp(-0.032 * e * e) + 0.75 / std::pow(e + 0.24, 3)); // inverse sigma Z
 
-          for (const int& indx : regions) {
+          for (const int& indx : cpvRegions) {
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
                 auto p = cpvMatchPoints[indx][ii];
@@ -844,15 +847,16 @@ struct CaloClusterProducer {
       if ((c.cellType() == phos::TRU2x2 || c.cellType() == phos::TRU4x4) && c.cellNumber() == 0) {
         continue;
       }
+      const uint64_t cellBC = c.bc_as<aod::BCsWithTimestamps>().globalBC();
       if (phosCellTRs.size() == 0) { // first cell, first TrigRec
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, 0, 0); // BC,first cell, ncells
       }
-      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != c.bc_as<aod::BCsWithTimestamps>().globalBC()) { // switch to new BC
+      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != cellBC) { // switch to new BC
         // switch to another BC: set size and create next TriRec
         phosCellTRs.back().setNumberOfObjects(phosCells.size() - phosCellTRs.back().getFirstEntry());
         // Next event/trig rec.
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, phosCells.size(), 0);
       }
       phosCells.emplace_back(c.cellNumber(), c.amplitude(), c.time(),
@@ -1053,30 +1057,30 @@ struct CaloClusterProducer {
         const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = cpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
+        cpvRegions.clear();
+        cpvRegions.push_back(phosIndex);
         if (posX > -kCpvMaxX + cellSizeX) {
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
+            cpvRegions.push_back(phosIndex - kCpvZ - 1);
           }
-          regions.push_back(phosIndex - kCpvZ);
+          cpvRegions.push_back(phosIndex - kCpvZ);
           if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
+            cpvRegions.push_back(phosIndex - kCpvZ + 1);
           }
         }
         if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
+          cpvRegions.push_back(phosIndex - 1);
         }
         if (posZ < kCpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
+          cpvRegions.push_back(phosIndex + 1);
         }
         if (posX < kCpvMaxX - cellSizeX) {
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
+            cpvRegions.push_back(phosIndex + kCpvZ - 1);
           }
-          regions.push_back(phosIndex + kCpvZ);
+          cpvRegions.push_back(phosIndex + kCpvZ);
           if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
+            cpvRegions.push_back(phosIndex + kCpvZ + 1);
           }
         }
         float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
@@ -1085,7 +1089,7 @@ struct CaloClusterProducer {
         // float cpvDx = 0., cpvDz = 0.;
         float trackDx = 9999., trackDz = 9999.;
         int trackindex = -1;
-        for (const int& indx : regions) {
+        for (const int& indx : cpvRegions) {
           if (cpvPoints != cpvNMatchPoints.end()) {
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
@@ -1254,15 +1258,16 @@ struct CaloClusterProducer {
       if ((c.cellType() == phos::TRU2x2 || c.cellType() == phos::TRU4x4) && c.cellNumber() == 0) {
         continue;
       }
+      const uint64_t cellBC = c.bc_as<aod::BCsWithTimestamps>().globalBC();
       if (phosCellTRs.size() == 0) { // first cell, first TrigRec
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, 0, 0); // BC,first cell, ncells
       }
-      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != c.bc_as<aod::BCsWithTimestamps>().globalBC()) { // switch to new BC
+      if (static_cast<uint64_t>(phosCellTRs.back().getBCData().toLong()) != cellBC) { // switch to new BC
         // switch to another BC: set size and create next TriRec
         phosCellTRs.back().setNumberOfObjects(phosCells.size() - phosCellTRs.back().getFirstEntry());
         // Next event/trig rec.
-        ir.setFromLong(c.bc_as<aod::BCsWithTimestamps>().globalBC());
+        ir.setFromLong(cellBC);
         phosCellTRs.emplace_back(ir, phosCells.size(), 0);
       }
       phosCells.emplace_back(c.cellNumber(), c.amplitude(), c.time(),
@@ -1482,30 +1487,30 @@ struct CaloClusterProducer {
         const float cellSizeZ = 2 * kCpvMaxZ / kCpvZ;
         // look 9 CPV regions around PHOS cluster
         int phosIndex = cpvMatchIndex(mod, posX, posZ);
-        std::vector<int> regions;
-        regions.push_back(phosIndex);
+        cpvRegions.clear();
+        cpvRegions.push_back(phosIndex);
         if (posX > -kCpvMaxX + cellSizeX) {
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom left
-            regions.push_back(phosIndex - kCpvZ - 1);
+            cpvRegions.push_back(phosIndex - kCpvZ - 1);
           }
-          regions.push_back(phosIndex - kCpvZ);
+          cpvRegions.push_back(phosIndex - kCpvZ);
           if (posZ < kCpvMaxZ - cellSizeZ) { // top left
-            regions.push_back(phosIndex - kCpvZ + 1);
+            cpvRegions.push_back(phosIndex - kCpvZ + 1);
           }
         }
         if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom
-          regions.push_back(phosIndex - 1);
+          cpvRegions.push_back(phosIndex - 1);
         }
         if (posZ < kCpvMaxZ - cellSizeZ) { // top
-          regions.push_back(phosIndex + 1);
+          cpvRegions.push_back(phosIndex + 1);
         }
         if (posX < kCpvMaxX - cellSizeX) {
           if (posZ > -kCpvMaxZ + cellSizeZ) { // bottom right
-            regions.push_back(phosIndex + kCpvZ - 1);
+            cpvRegions.push_back(phosIndex + kCpvZ - 1);
           }
-          regions.push_back(phosIndex + kCpvZ);
+          cpvRegions.push_back(phosIndex + kCpvZ);
           if (posZ < kCpvMaxZ - cellSizeZ) { // top right
-            regions.push_back(phosIndex + kCpvZ + 1);
+            cpvRegions.push_back(phosIndex + kCpvZ + 1);
           }
         }
         float sigmaX = 1. / std::min(5.2, 1.111 + 0.56 * std::exp(-0.031 * e * e) + 4.8 / std::pow(e + 0.61, 3)); // inverse sigma X
@@ -1514,7 +1519,7 @@ struct CaloClusterProducer {
         // float cpvDx = 0., cpvDz = 0.;
         float trackDx = 9999., trackDz = 9999.;
         int trackindex = -1;
-        for (const int& indx : regions) {
+        for (const int& indx : cpvRegions) {
           if (cpvPoints != cpvNMatchPoints.end()) {
             if (indx >= 0 && indx < kCpvCells) {
               for (int ii = cpvPoints->mStart[indx]; ii < cpvPoints->mEnd[indx]; ii++) {
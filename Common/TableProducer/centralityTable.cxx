@@ -33,6 +33,7 @@
 #include <Framework/OutputObjHeader.h>
 #include <Framework/runDataProcessing.h>
 
+#include <TAxis.h>
 #include <TFile.h>
 #include <TFormula.h>
 #include <TH1.h>
@@ -159,6 +160,11 @@ struct CentralityTable {
     TH1* mhMultSelCalib = nullptr;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
+    std::vector<float> mPercentiles; // bin contents of mhMultSelCalib, including under- and overflow
+    std::vector<double> mBinEdges;   // bin edges of mhMultSelCalib, empty for fixed-width bins
+    double mXmin = 0.;
+    double mXmax = 0.;
+    int mNbins = 0;
     explicit CalibrationInfo(std::string name)
       : name(name),
         mCalibrationStored(false),
@@ -183,6 +189,37 @@ struct CentralityTable {
       }
       return true;
     }
+    // flatten the calibration histogram, avoiding the TH1 lookups for each collision
+    void buildLookup()
+    {
+      const TAxis* axis = mhMultSelCalib->GetXaxis();
+      mNbins = axis->GetNbins();
+      mXmin = axis->GetXmin();
+      mXmax = axis->GetXmax();
+      mBinEdges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        mBinEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+      }
+      mPercentiles.resize(mNbins + 2);
+      for (int i = 0; i < mNbins + 2; i++) {
+        mPercentiles[i] = mhMultSelCalib->GetBinContent(i);
+      }
+    }
+    // percentile of the bin found as in TAxis::FindFixBin
+    float getPercentile(double value) const
+    {
+      int bin = 0;
+      if (value < mXmin) {
+        bin = 0;
+      } else if (!(value < mXmax)) {
+        bin = mNbins + 1;
+      } else if (mBinEdges.empty()) {
+        bin = 1 + static_cast<int>(mNbins * (value - mXmin) / (mXmax - mXmin));
+      } else {
+        bin = std::upper_bound(mBinEdges.begin(), mBinEdges.end(), value) - mBinEdges.begin();
+      }
+      return mPercentiles[bin];
+    }
   };
   CalibrationInfo fv0aInfo = CalibrationInfo("FV0");
   CalibrationInfo ft0mInfo = CalibrationInfo("FT0");
@@ -600,6 +637,7 @@ struct CentralityTable {
               }
               estimator.mCalibrationStored = true;
               estimator.isSane();
+              estimator.buildLookup();
             } else {
               LOGF(info, "Calibration information from %s for run %d not available, will fill this estimator with invalid values and continue (no crash).", estimator.name.c_str(), bc.runNumber());
             }
@@ -669,7 +707,7 @@ struct CentralityTable {
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.getPercentile(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -40,6 +40,7 @@ struct FwdTrackToCollisionAssociation {
   Configurable<bool> includeUnassigned{"includeUnassigned", false, "consider also tracks which are not assigned to any collision"};
   Configurable<bool> fillTableOfCollIdsPerTrack{"fillTableOfCollIdsPerTrack", false, "fill additional table with vector of collision ids per track"};
   Configurable<int> bcWindowForOneSigma{"bcWindowForOneSigma", 115, "BC window to be multiplied by the number of sigmas to define maximum window to be considered"};
+  Configurable<int> nThreads{"nThreads", 1, "number of threads of the time-based association, the output does not depend on it"};
 
   CollisionAssociation<false> collisionAssociator;
 
@@ -67,6 +68,7 @@ struct FwdTrackToCollisionAssociation {
     collisionAssociator.setIncludeUnassigned(includeUnassigned);
     collisionAssociator.setFillTableOfCollIdsPerTrack(fillTableOfCollIdsPerTrack);
     collisionAssociator.setBcWindow(bcWindowForOneSigma);
+    collisionAssociator.setNumThreads(nThreads);
   }
 
   void processFwdAssocWithTime(Collisions const& collisions,
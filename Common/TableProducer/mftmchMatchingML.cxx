@@ -33,14 +33,18 @@
 #include <RtypesCore.h>
 
 #include <algorithm>
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <map>
 #include <memory>
 #include <regex>
 #include <string>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include <math.h> // FIXME: Replace M_PI
@@ -79,65 +83,65 @@ struct mftmchMatchingML {
   Configurable<float> cfgThrScore{"threshold-score", 0.5, "Threshold value for matching score"};
   Configurable<int> cfgColWindow{"collision-window", 1, "Search window (collision ID) for MFT track"};
   Configurable<float> cfgXYWindow{"XY-window", 3, "Search window (delta XY) for MFT track"};
+  Configurable<int> cfgBatchSize{"batch-size", 1024, "Maximum number of candidate pairs scored in one inference"};
 
   Ort::Env env{ORT_LOGGING_LEVEL_WARNING, "model-explorer"};
   Ort::SessionOptions session_options;
   std::shared_ptr<Ort::Session> onnx_session = nullptr;
   OnnxModel model;
 
-  template <typename F, typename M>
-  std::vector<float> getVariables(F const& fwdtrack, M const& mfttrack)
+  static constexpr Double_t MatchingPlaneZ = -77.5;
+  static constexpr std::size_t NFeatures = 17;
+
+  std::vector<std::string> input_names;
+  std::vector<int64_t> input_shape;
+  std::vector<std::string> output_names;
+  std::size_t maxBatchSize = 1; // maximum number of candidate pairs per inference, 1 if the model has a fixed batch size
+
+  /// Track parameters propagated to the matching plane
+  struct TrackAtMatchingPlane {
+    Float_t x;
+    Float_t y;
+    Float_t phi;
+    Float_t tanl;
+  };
+
+  template <typename T>
+  TrackAtMatchingPlane propagateToMatchingPlane(T const& track)
   {
+    double chi2 = track.chi2();
+    SMatrix5 pars(track.x(), track.y(), track.phi(), track.tgl(), track.signed1Pt());
+    std::vector<double> v1;
+    SMatrix55 covs(v1.begin(), v1.end());
+    o2::track::TrackParCovFwd pars1{track.z(), pars, covs, chi2};
+    pars1.propagateToZlinear(MatchingPlaneZ);
+    return {static_cast<Float_t>(pars1.getX()), static_cast<Float_t>(pars1.getY()), static_cast<Float_t>(pars1.getPhi()), static_cast<Float_t>(pars1.getTanl())};
+  }
 
-    static constexpr Double_t MatchingPlaneZ = -77.5;
-
-    // propagate muontrack to matching position
-    double muonchi2 = fwdtrack.chi2();
-    SMatrix5 muonpars(fwdtrack.x(), fwdtrack.y(), fwdtrack.phi(), fwdtrack.tgl(), fwdtrack.signed1Pt());
-    std::vector<double> muonv1;
-    SMatrix55 muoncovs(muonv1.begin(), muonv1.end());
-    o2::track::TrackParCovFwd muonpars1{fwdtrack.z(), muonpars, muoncovs, muonchi2};
-    muonpars1.propagateToZlinear(MatchingPlaneZ);
-
-    // propagate mfttrack to matching position
-    double mftchi2 = mfttrack.chi2();
-    SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-    std::vector<double> mftv1;
-    SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-    o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-    mftpars1.propagateToZlinear(MatchingPlaneZ);
-
-    Float_t MFT_X = mftpars1.getX();
-    Float_t MFT_Y = mftpars1.getY();
-    Float_t MFT_Phi = mftpars1.getPhi();
-    Float_t MFT_Tanl = mftpars1.getTanl();
-
-    Float_t MCH_X = muonpars1.getX();
-    Float_t MCH_Y = muonpars1.getY();
-    Float_t MCH_Phi = muonpars1.getPhi();
-    Float_t MCH_Tanl = muonpars1.getTanl();
-
-    Float_t Ratio_X = MFT_X / MCH_X;
-    Float_t Ratio_Y = MFT_Y / MCH_Y;
-    Float_t Ratio_Phi = MFT_Phi / MCH_Phi;
-    Float_t Ratio_Tanl = MFT_Tanl / MCH_Tanl;
-
-    Float_t Delta_X = MFT_X - MCH_X;
-    Float_t Delta_Y = MFT_Y - MCH_Y;
-    Float_t Delta_Phi = MFT_Phi - MCH_Phi;
-    Float_t Delta_Tanl = MFT_Tanl - MCH_Tanl;
+  /// Appends the matching features of a pair
+  void appendVariables(TrackAtMatchingPlane const& mft, TrackAtMatchingPlane const& mch, std::vector<float>& input_tensor_values)
+  {
+    Float_t Ratio_X = mft.x / mch.x;
+    Float_t Ratio_Y = mft.y / mch.y;
+    Float_t Ratio_Phi = mft.phi / mch.phi;
+    Float_t Ratio_Tanl = mft.tanl / mch.tanl;
+
+    Float_t Delta_X = mft.x - mch.x;
+    Float_t Delta_Y = mft.y - mch.y;
+    Float_t Delta_Phi = mft.phi - mch.phi;
+    Float_t Delta_Tanl = mft.tanl - mch.tanl;
 
     Float_t Delta_XY = sqrt(Delta_X * Delta_X + Delta_Y * Delta_Y);
 
-    std::vector<float> input_tensor_values{
-      MFT_X,
-      MFT_Y,
-      MFT_Phi,
-      MFT_Tanl,
-      MCH_X,
-      MCH_Y,
-      MCH_Phi,
-      MCH_Tanl,
+    const std::array<float, NFeatures> features{
+      mft.x,
+      mft.y,
+      mft.phi,
+      mft.tanl,
+      mch.x,
+      mch.y,
+      mch.phi,
+      mch.tanl,
       Delta_XY,
       Delta_X,
       Delta_Y,
@@ -148,63 +152,45 @@ struct mftmchMatchingML {
       Ratio_Phi,
       Ratio_Tanl,
     };
-    return input_tensor_values;
+    input_tensor_values.insert(input_tensor_values.end(), features.begin(), features.end());
   }
 
-  template <typename F, typename M>
-  double matchONNX(F const& fwdtrack, M const& mfttrack)
+  /// Scores the candidate pairs, in batches of at most maxBatchSize pairs
+  /// \param input_tensor_values features of the candidate pairs, NFeatures per pair
+  /// \return score of each pair
+  std::vector<float> matchONNX(std::vector<float>& input_tensor_values)
   {
-    std::vector<std::string> input_names;
-    std::vector<std::vector<int64_t>> input_shapes;
-    std::vector<std::string> output_names;
-    std::vector<std::vector<int64_t>> output_shapes;
-
-    Ort::AllocatorWithDefaultOptions tmpAllocator;
-    for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
-      input_names.push_back(onnx_session->GetInputNameAllocated(i, tmpAllocator).get());
-    }
-    for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
-      input_shapes.emplace_back(onnx_session->GetInputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-    }
-    for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
-      output_names.push_back(onnx_session->GetOutputNameAllocated(i, tmpAllocator).get());
-    }
-    for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
-      output_shapes.emplace_back(onnx_session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
-    }
-
-    auto input_shape = input_shapes[0];
-    input_shape[0] = 1;
-
-    std::vector<float> input_tensor_values;
-    input_tensor_values = getVariables(fwdtrack, mfttrack);
-
-    if (input_tensor_values[8] < cfgXYWindow) {
+    const std::size_t nCandidates = input_tensor_values.size() / NFeatures;
+    std::vector<float> scores(nCandidates);
+
+    std::vector<const char*> inputNamesChar(input_names.size(), nullptr);
+    std::transform(std::begin(input_names), std::end(input_names), std::begin(inputNamesChar),
+                   [&](const std::string& str) { return str.c_str(); });
+
+    std::vector<const char*> outputNamesChar(output_names.size(), nullptr);
+    std::transform(std::begin(output_names), std::end(output_names), std::begin(outputNamesChar),
+                   [&](const std::string& str) { return str.c_str(); });
+
+    Ort::MemoryInfo mem_info =
+      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    Ort::RunOptions runOptions;
+    auto batch_shape = input_shape;
+    for (std::size_t first = 0; first < nCandidates; first += maxBatchSize) {
+      const std::size_t nBatch = std::min(maxBatchSize, nCandidates - first);
+      batch_shape[0] = nBatch;
       std::vector<Ort::Value> input_tensors;
-      Ort::MemoryInfo mem_info =
-        Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
-      input_tensors.push_back(Ort::Value::CreateTensor<float>(mem_info, input_tensor_values.data(), input_tensor_values.size(), input_shape.data(), input_shape.size()));
-
-      Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(input_names.size(), nullptr);
-      std::transform(std::begin(input_names), std::end(input_names), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(output_names.size(), nullptr);
-      std::transform(std::begin(output_names), std::end(output_names), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
+      input_tensors.push_back(Ort::Value::CreateTensor<float>(mem_info, input_tensor_values.data() + first * NFeatures, nBatch * NFeatures, batch_shape.data(), batch_shape.size()));
 
       std::vector<Ort::Value> output_tensors = onnx_session->Run(runOptions, inputNamesChar.data(), input_tensors.data(), input_tensors.size(), outputNamesChar.data(), outputNamesChar.size());
 
+      // first output value of each pair
       const float* output_value = output_tensors[0].GetTensorData<float>();
-
-      auto score = output_value[0];
-
-      return score;
-    } else {
-      auto score = 0;
-      return score;
+      const std::size_t stride = output_tensors[0].GetTensorTypeAndShapeInfo().GetElementCount() / nBatch;
+      for (std::size_t i = 0; i < nBatch; ++i) {
+        scores[first + i] = output_value[i * stride];
+      }
     }
+    return scores;
   };
 
   void init(o2::framework::InitContext&)
@@ -225,6 +211,17 @@ struct mftmchMatchingML {
                 << "/" << cfgModelName.value;
       model.initModel(cfgModelName, false, 1, strtoul(headers["Valid-From"].c_str(), NULL, 0), strtoul(headers["Valid-Until"].c_str(), NULL, 0));
       onnx_session = model.getSession();
+
+      Ort::AllocatorWithDefaultOptions tmpAllocator;
+      for (size_t i = 0; i < onnx_session->GetInputCount(); ++i) {
+        input_names.push_back(onnx_session->GetInputNameAllocated(i, tmpAllocator).get());
+      }
+      for (size_t i = 0; i < onnx_session->GetOutputCount(); ++i) {
+        output_names.push_back(onnx_session->GetOutputNameAllocated(i, tmpAllocator).get());
+      }
+      input_shape = onnx_session->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+      // the candidate pairs are scored together only if the batch size of the model is dynamic
+      maxBatchSize = input_shape[0] < 0 ? std::max(cfgBatchSize.value, 1) : 1;
     } else {
       LOG(info) << "Failed to retrieve Network file";
     }
@@ -232,41 +229,95 @@ struct mftmchMatchingML {
 
   void process(aod::Collisions const&, soa::Filtered<aod::FwdTracks> const& fwdtracks, aod::MFTTracks const& mfttracks)
   {
-    for (auto& fwdtrack : fwdtracks) {
-      if (fwdtrack.trackType() == aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack) {
-        double bestscore = 0;
-        int bestmfttrackid = -1;
-        for (auto& mfttrack : mfttracks) {
-          if (fwdtrack.has_collision() && mfttrack.has_collision()) {
-            if (0 <= fwdtrack.collisionId() - mfttrack.collisionId() && fwdtrack.collisionId() - mfttrack.collisionId() < cfgColWindow) {
-              double result = matchONNX(fwdtrack, mfttrack);
-              if (result > cfgThrScore) {
-                bestscore = result;
-                bestmfttrackid = mfttrack.globalIndex();
-              }
+    // MFT tracks at the matching plane, bucketed by collision and by (x, y) cell of the size of the XY window:
+    // the MFT tracks within the XY window of a muon track are in the 3x3 cells around the cell of the muon track
+    if (!(cfgXYWindow > 0.f)) {
+      return; // no MFT track within the XY window
+    }
+    const float cellSize = cfgXYWindow * 1.001f; // slightly larger than the window, against rounding
+    auto getCell = [cellSize](TrackAtMatchingPlane const& track) {
+      return std::make_pair(static_cast<int>(std::floor(track.x / cellSize)), static_cast<int>(std::floor(track.y / cellSize)));
+    };
+    std::vector<TrackAtMatchingPlane> mftsAtMatchingPlane(mfttracks.size());
+    std::map<std::tuple<int, int, int>, std::vector<int64_t>> mftCells; // key: (collision, cell x, cell y), value: MFT track indices
+    for (auto const& mfttrack : mfttracks) {
+      if (!mfttrack.has_collision()) {
+        continue;
+      }
+      const auto& mft = mftsAtMatchingPlane[mfttrack.globalIndex()] = propagateToMatchingPlane(mfttrack);
+      if (!(std::abs(mft.x) < cellSize * std::numeric_limits<int>::max() && std::abs(mft.y) < cellSize * std::numeric_limits<int>::max())) {
+        continue; // never within the XY window
+      }
+      const auto [cellX, cellY] = getCell(mft);
+      mftCells[{mfttrack.collisionId(), cellX, cellY}].push_back(mfttrack.globalIndex());
+    }
+
+    // candidate pairs: MFT tracks within the collision and XY windows of each standalone muon track
+    std::vector<float> input_tensor_values;
+    std::vector<std::pair<int64_t, int64_t>> candidates; // (muon track rank, MFT track index)
+    int64_t iMuon = 0;
+    for (auto const& fwdtrack : fwdtracks) {
+      if (fwdtrack.trackType() != aod::fwdtrack::ForwardTrackTypeEnum::MuonStandaloneTrack || !fwdtrack.has_collision()) {
+        iMuon++;
+        continue;
+      }
+      const auto mch = propagateToMatchingPlane(fwdtrack);
+      if (!(std::abs(mch.x) < cellSize * std::numeric_limits<int>::max() && std::abs(mch.y) < cellSize * std::numeric_limits<int>::max())) {
+        iMuon++;
+        continue;
+      }
+      const auto [cellX, cellY] = getCell(mch);
+      for (int iCol = 0; iCol < cfgColWindow; iCol++) {
+        for (int iCellX = cellX - 1; iCellX <= cellX + 1; iCellX++) {
+          for (int iCellY = cellY - 1; iCellY <= cellY + 1; iCellY++) {
+            auto cell = mftCells.find({fwdtrack.collisionId() - iCol, iCellX, iCellY});
+            if (cell == mftCells.end()) {
+              continue;
             }
-          }
-        }
-        if (bestmfttrackid != -1) {
-          for (auto& mfttrack : mfttracks) {
-            if (mfttrack.globalIndex() == bestmfttrackid) {
-              double mftchi2 = mfttrack.chi2();
-              SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
-              std::vector<double> mftv1;
-              SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
-              o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
-              mftpars1.propagateToZlinear(mfttrack.collision().posZ());
-
-              float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
-              float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
-              double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
-              double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
-              double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
-              fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
+            for (const auto iMft : cell->second) {
+              appendVariables(mftsAtMatchingPlane[iMft], mch, input_tensor_values);
+              if (input_tensor_values[input_tensor_values.size() - NFeatures + 8] < cfgXYWindow) {
+                candidates.emplace_back(iMuon, iMft);
+              } else {
+                input_tensor_values.resize(input_tensor_values.size() - NFeatures);
+              }
             }
           }
         }
       }
+      iMuon++;
+    }
+
+    // score all the candidate pairs together, the last MFT track above the threshold is matched
+    const auto scores = matchONNX(input_tensor_values);
+    std::vector<std::pair<int64_t, double>> bestMatches(iMuon, {-1, 0.}); // (MFT track index, score) per muon track
+    for (std::size_t iCandidate = 0; iCandidate < candidates.size(); iCandidate++) {
+      const auto [iMuonCandidate, iMft] = candidates[iCandidate];
+      double result = scores[iCandidate];
+      if (result > cfgThrScore && iMft > bestMatches[iMuonCandidate].first) {
+        bestMatches[iMuonCandidate] = {iMft, result};
+      }
+    }
+
+    iMuon = 0;
+    for (auto const& fwdtrack : fwdtracks) {
+      const auto [bestmfttrackid, bestscore] = bestMatches[iMuon++];
+      if (bestmfttrackid != -1) {
+        auto mfttrack = mfttracks.iteratorAt(bestmfttrackid);
+        double mftchi2 = mfttrack.chi2();
+        SMatrix5 mftpars(mfttrack.x(), mfttrack.y(), mfttrack.phi(), mfttrack.tgl(), mfttrack.signed1Pt());
+        std::vector<double> mftv1;
+        SMatrix55 mftcovs(mftv1.begin(), mftv1.end());
+        o2::track::TrackParCovFwd mftpars1{mfttrack.z(), mftpars, mftcovs, mftchi2};
+        mftpars1.propagateToZlinear(mfttrack.collision().posZ());
+
+        float dcaX = (mftpars1.getX() - mfttrack.collision().posX());
+        float dcaY = (mftpars1.getY() - mfttrack.collision().posY());
+        double px = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * cos(mfttrack.phi());
+        double py = fwdtrack.p() * sin(M_PI / 2 - atan(mfttrack.tgl())) * sin(mfttrack.phi());
+        double pz = fwdtrack.p() * cos(M_PI / 2 - atan(mfttrack.tgl()));
+        fwdtrackml(fwdtrack.collisionId(), 0, mfttrack.x(), mfttrack.y(), mfttrack.z(), mfttrack.phi(), mfttrack.tgl(), fwdtrack.sign() / std::sqrt(std::pow(px, 2) + std::pow(py, 2)), fwdtrack.nClusters(), fwdtrack.pDca(), fwdtrack.rAtAbsorberEnd(), 0, 0, 0, bestscore, mfttrack.globalIndex(), fwdtrack.globalIndex(), fwdtrack.mchBitMap(), fwdtrack.midBitMap(), fwdtrack.midBoards(), mfttrack.trackTime(), mfttrack.trackTimeRes(), mfttrack.eta(), std::sqrt(std::pow(px, 2) + std::pow(py, 2)), std::sqrt(std::pow(px, 2) + std::pow(py, 2) + std::pow(pz, 2)), dcaX, dcaY);
+      }
     }
   }
 };
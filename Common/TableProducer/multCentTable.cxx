@@ -23,6 +23,7 @@
 #include "PWGMM/Mult/DataModel/bestCollisionTable.h"
 
 #include "Common/Core/MetadataHelper.h"
+#include "Common/Core/ProfilingScopes.h"
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 #include "Common/Tools/Multiplicity/MultModule.h"
@@ -32,6 +33,8 @@
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
+#include <Framework/EndOfStreamContext.h>
+#include <Framework/HistogramRegistry.h>
 #include <Framework/InitContext.h>
 #include <Framework/O2DatabasePDGPlugin.h>
 #include <Framework/runDataProcessing.h>
@@ -58,6 +61,11 @@ struct MultCentTable {
   // hold multiplicity values for layover to centrality calculation
   std::vector<o2::common::multiplicity::multEntry> mults;
 
+  // in-situ profiling of the process functions, compiled out by default
+  enum ProfilingRegion { kRun2 = 0, kRun3, kRun3WithGlobalCounters, kMFT, kMonteCarlo, kCentralityRun2, kCentralityRun3 };
+  HistogramRegistry profilingHistos{"profilingHistos", {}, OutputObjHandlingPolicy::AnalysisObject};
+  o2::common::core::ProfilingScopes profiling;
+
   // slicers
   Preslice<soa::Join<aod::TracksIU, aod::TracksExtra>> slicerTracksIU = o2::aod::track::collisionId;
   Preslice<soa::Join<aod::TracksIU, aod::TracksExtra, aod::TrackSelection, aod::TrackSelectionExtension>> slicerTracksIUwithSelections = o2::aod::track::collisionId;
@@ -73,6 +81,12 @@ struct MultCentTable {
 
     // task-specific
     module.init(metadataInfo, opts, initContext);
+    profiling.init(profilingHistos, {"processRun2", "processRun3", "processRun3WithGlobalCounters", "processMFT", "processMonteCarlo", "processCentralityRun2", "processCentralityRun3"});
+  }
+
+  void endOfStream(EndOfStreamContext&)
+  {
+    profiling.print();
   }
 
   void processRun2(soa::Join<aod::Collisions, aod::Run2MatchedSparse> const& collisions,
@@ -83,6 +97,8 @@ struct MultCentTable {
                    aod::FV0Cs const&,
                    aod::FT0s const&)
   {
+    auto scope = profiling.scope(kRun2);
+    scope.count(collisions.size());
     mults.clear();
     for (auto const& collision : collisions) {
       o2::common::multiplicity::multEntry mult;
@@ -102,6 +118,8 @@ struct MultCentTable {
                    aod::FT0s const&,
                    aod::FDDs const&)
   {
+    auto scope = profiling.scope(kRun3);
+    scope.count(collisions.size());
     mults.clear();
     for (auto const& collision : collisions) {
       o2::common::multiplicity::multEntry mult;
@@ -121,6 +139,8 @@ struct MultCentTable {
                                      aod::FT0s const&,
                                      aod::FDDs const&)
   {
+    auto scope = profiling.scope(kRun3WithGlobalCounters);
+    scope.count(collisions.size());
     mults.clear();
     for (auto const& collision : collisions) {
       o2::common::multiplicity::multEntry mult;
@@ -136,6 +156,8 @@ struct MultCentTable {
                   soa::SmallGroups<aod::BestCollisionsFwd> const& retracks)
   {
     if (opts.mEnabledTables[o2::common::multiplicity::kMFTMults]) {
+      auto scope = profiling.scope(kMFT);
+      scope.count(mfttracks.size());
       // populates MFT information in the mults buffer (in addition to filling table)
       module.collisionProcessMFT(collision, mfttracks, retracks, mults, products);
     }
@@ -143,6 +165,8 @@ struct MultCentTable {
   void processMonteCarlo(aod::McCollision const& mcCollision, aod::McParticles const& mcParticles)
   {
     if (opts.mEnabledTables[o2::common::multiplicity::kMultMCExtras]) {
+      auto scope = profiling.scope(kMonteCarlo);
+      scope.count(mcParticles.size());
       module.collisionProcessMonteCarlo(mcCollision, mcParticles, pdg, products);
     }
   }
@@ -166,6 +190,8 @@ struct MultCentTable {
     if (collisions.size() != static_cast<int64_t>(mults.size())) {
       LOGF(fatal, "Size of collisions doesn't match size of multiplicity buffer!");
     }
+    auto scope = profiling.scope(kCentralityRun2);
+    scope.count(collisions.size());
     module.generateCentralitiesRun2(ccdb, metadataInfo, bcs, mults, products);
   }
   void processCentralityRun3(aod::Collisions const& collisions, soa::Join<aod::BCs, aod::BcSels, aod::Timestamps> const& bcs, aod::FT0s const&)
@@ -181,6 +207,8 @@ struct MultCentTable {
     if (collisions.size() != static_cast<int64_t>(mults.size())) {
       LOGF(fatal, "Size of collisions doesn't match size of multiplicity buffer!");
     }
+    auto scope = profiling.scope(kCentralityRun3);
+    scope.count(collisions.size());
     module.generateCentralitiesRun3(ccdb, metadataInfo, bcs, mults, products);
   }
 
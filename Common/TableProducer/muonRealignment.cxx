@@ -47,6 +47,7 @@
 #include <iterator>
 #include <map>
 #include <string>
+#include <vector>
 
 using namespace std;
 using namespace o2;
@@ -97,6 +98,7 @@ struct MuonRealignment {
   geo::TransformationCreator transformation;
   map<int, math_utils::Transform3D> transformRef; // reference geometry w.r.t track data
   map<int, math_utils::Transform3D> transformNew; // new geometry
+  vector<mch::Cluster> realignedClusters;         // re-aligned clusters of the current track, reused across the tracks
   globaltracking::MatchGlobalFwd mMatching;
   int fCurrentRun;        // needed to detect if the run changed and trigger update of calibrations etc.
   double mImproveCutChi2; // Chi2 cut for track improvement.
@@ -241,11 +243,14 @@ struct MuonRealignment {
         auto clustersSliced = clusters.sliceBy(perMuon, muon.globalIndex()); // Slice clusters by muon id
         mch::Track convertedTrack = mch::Track();                            // Temporary variable to store re-aligned clusters
         int clIndex = -1;
+        // The track parameters point to the clusters: reserve them all so that they are not reallocated
+        realignedClusters.clear();
+        realignedClusters.reserve(clustersSliced.size());
         // Get re-aligned clusters associated to current track
         for (auto const& cluster : clustersSliced) {
           clIndex += 1;
 
-          mch::Cluster* clusterMCH = new mch::Cluster();
+          mch::Cluster* clusterMCH = &realignedClusters.emplace_back();
 
           math_utils::Point3D<double> local;
           math_utils::Point3D<double> master;
@@ -175,6 +175,39 @@ struct OccupancyTableProducer {
   std::vector<std::array<int, 2>> vecRobustOccNtrackDetUnfm80medianPosVec;
   std::vector<std::array<int, 2>> vecRobustOccmultTableUnfm80medianPosVec;
 
+  // Occupancy estimators accumulated together in the drift window of each collision
+  enum OccEstimator {
+    kOccPrim = 0,
+    kOccFV0A,
+    kOccFV0C,
+    kOccFT0A,
+    kOccFT0C,
+    kOccFDDA,
+    kOccFDDC,
+    kOccNTrackITS,
+    kOccNTrackTPC,
+    kOccNTrackTRD,
+    kOccNTrackTOF,
+    kOccNTrackSize,
+    kOccNTrackTPCA,
+    kOccNTrackTPCC,
+    kOccNTrackITSTPCA,
+    kOccNTrackITSTPCC,
+    kOccNTrackITSTPC,
+    kOccMultNTracksHasITS,
+    kOccMultNTracksHasTPC,
+    kOccMultNTracksHasTOF,
+    kOccMultNTracksHasTRD,
+    kOccMultNTracksITSOnly,
+    kOccMultNTracksTPCOnly,
+    kOccMultNTracksITSTPC,
+    kOccMultAllTracksTPCOnly,
+    kNOccEstimators
+  };
+
+  std::array<std::vector<std::vector<float>>*, kNOccEstimators> occEstimatorVectors{}; // output vectors of each estimator
+  std::vector<double> occWindowDiff; // per TF, bin and estimator: difference of the occupancy with the previous bin
+
   std::vector<bool> processStatus;
   Configurable<uint> processStatusSize{"processStatusSize", 10, "processStatusSize"};
   void init(InitContext const&)
@@ -267,6 +300,13 @@ struct OccupancyTableProducer {
       }
     }
 
+    occEstimatorVectors = {&occPrimUnfm80, &occFV0AUnfm80, &occFV0CUnfm80, &occFT0AUnfm80, &occFT0CUnfm80, &occFDDAUnfm80, &occFDDCUnfm80,
+                           &occNTrackITSUnfm80, &occNTrackTPCUnfm80, &occNTrackTRDUnfm80, &occNTrackTOFUnfm80, &occNTrackSizeUnfm80,
+                           &occNTrackTPCAUnfm80, &occNTrackTPCCUnfm80, &occNTrackITSTPCAUnfm80, &occNTrackITSTPCCUnfm80, &occNTrackITSTPCUnfm80,
+                           &occMultNTracksHasITSUnfm80, &occMultNTracksHasTPCUnfm80, &occMultNTracksHasTOFUnfm80, &occMultNTracksHasTRDUnfm80,
+                           &occMultNTracksITSOnlyUnfm80, &occMultNTracksTPCOnlyUnfm80, &occMultNTracksITSTPCUnfm80, &occMultAllTracksTPCOnlyUnfm80};
+    occWindowDiff.resize(static_cast<std::size_t>(occVecArraySize) * (nBCinTF / bcGrouping + 1) * kNOccEstimators);
+
     if (buildFullOccTableProducer || buildOnlyOccsT0V0Prim || buildFlag02OccRobustTable || buildFlag03OccMeanRobustTable) {
       vecRobustOccT0V0PrimUnfm80.resize(nBCinTF / bcGrouping);
       vecRobustOccT0V0PrimUnfm80medianPosVec.resize(nBCinTF / bcGrouping); // Median => one for odd and two for even entries
@@ -429,6 +469,60 @@ struct OccupancyTableProducer {
     }
   }
 
+  static constexpr bool isOccEstimatorUsed(const int processMode, const int estimator)
+  {
+    if (estimator == kOccPrim) {
+      return processMode != kProcessOnlyBCTFinfoTable;
+    } else if (estimator <= kOccFT0C) {
+      return processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim;
+    } else if (estimator <= kOccFDDC) {
+      return processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim;
+    } else if (estimator <= kOccNTrackITSTPCC) {
+      return processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet;
+    } else if (estimator == kOccNTrackITSTPC) {
+      return processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra;
+    }
+    return processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra;
+  }
+
+  // Add the contributions of a collision to the difference arrays of all the bins of its drift window
+  void addToOccWindow(const int iTF, const int firstBin, const std::array<float, kNOccEstimators>& occContrib)
+  {
+    const int nBins = nBCinTF / bcGrouping;
+    double* diff = occWindowDiff.data() + static_cast<std::size_t>(iTF) * (nBins + 1) * kNOccEstimators;
+    int start = firstBin % nBins;
+    int remaining = nBCinDrift / bcGrouping;
+    while (remaining > 0) { // the window wraps around at the end of the TF
+      const int end = std::min(start + remaining, nBins);
+      for (int iEstimator = 0; iEstimator < kNOccEstimators; iEstimator++) {
+        diff[start * kNOccEstimators + iEstimator] += occContrib[iEstimator];
+        diff[end * kNOccEstimators + iEstimator] -= occContrib[iEstimator];
+      }
+      remaining -= end - start;
+      start = 0;
+    }
+  }
+
+  // Prefix sums of the difference arrays, giving the occupancy of every estimator in each bin
+  template <int processMode>
+  void integrateOccWindows(const int nTFs)
+  {
+    const int nBins = nBCinTF / bcGrouping;
+    std::array<double, kNOccEstimators> occSum;
+    for (int iTF = 0; iTF < nTFs; iTF++) {
+      occSum.fill(0.);
+      const double* diff = occWindowDiff.data() + static_cast<std::size_t>(iTF) * (nBins + 1) * kNOccEstimators;
+      for (int iBin = 0; iBin < nBins; iBin++) {
+        for (int iEstimator = 0; iEstimator < kNOccEstimators; iEstimator++) {
+          occSum[iEstimator] += diff[iBin * kNOccEstimators + iEstimator];
+          if (isOccEstimatorUsed(processMode, iEstimator)) {
+            (*occEstimatorVectors[iEstimator])[iTF][iBin] = occSum[iEstimator];
+          }
+        }
+      }
+    }
+  }
+
   int processTimeCounter = 0;
   template <int processMode, int tableMode, int meanTableMode, int robustTableMode, int meanRobustTableMode, typename B, typename C, typename T>
   void executeOccProducerProcessing(B const& BCs, C const& collisions, T const& tracks)
@@ -484,6 +578,7 @@ struct OccupancyTableProducer {
       occupancyQA.fill(HIST("h_DFcount_Lvl2"), 0.5);
 
       // Initialisze the vectors components to zero
+      std::fill(occWindowDiff.begin(), occWindowDiff.end(), 0.);
       tfIDX = 0;
       tfCounted = 0;
       for (int i = 0; i < occVecArraySize; i++) {
@@ -555,36 +650,6 @@ struct OccupancyTableProducer {
       int fNTrackITSTPCA = -9999;
       int fNTrackITSTPCC = -9999;
 
-      decltype(&occPrimUnfm80[0]) tfOccPrimUnfm80 = nullptr;
-      decltype(&occFV0AUnfm80[0]) tfOccFV0AUnfm80 = nullptr;
-      decltype(&occFV0CUnfm80[0]) tfOccFV0CUnfm80 = nullptr;
-      decltype(&occFT0AUnfm80[0]) tfOccFT0AUnfm80 = nullptr;
-      decltype(&occFT0CUnfm80[0]) tfOccFT0CUnfm80 = nullptr;
-
-      decltype(&occFDDAUnfm80[0]) tfOccFDDAUnfm80 = nullptr;
-      decltype(&occFDDCUnfm80[0]) tfOccFDDCUnfm80 = nullptr;
-
-      decltype(&occNTrackITSTPCUnfm80[0]) tfOccNTrackITSTPCUnfm80 = nullptr;
-
-      decltype(&occNTrackITSUnfm80[0]) tfOccNTrackITSUnfm80 = nullptr;
-      decltype(&occNTrackTPCUnfm80[0]) tfOccNTrackTPCUnfm80 = nullptr;
-      decltype(&occNTrackTRDUnfm80[0]) tfOccNTrackTRDUnfm80 = nullptr;
-      decltype(&occNTrackTOFUnfm80[0]) tfOccNTrackTOFUnfm80 = nullptr;
-      decltype(&occNTrackSizeUnfm80[0]) tfOccNTrackSizeUnfm80 = nullptr;
-      decltype(&occNTrackTPCAUnfm80[0]) tfOccNTrackTPCAUnfm80 = nullptr;
-      decltype(&occNTrackTPCCUnfm80[0]) tfOccNTrackTPCCUnfm80 = nullptr;
-      decltype(&occNTrackITSTPCAUnfm80[0]) tfOccNTrackITSTPCAUnfm80 = nullptr;
-      decltype(&occNTrackITSTPCCUnfm80[0]) tfOccNTrackITSTPCCUnfm80 = nullptr;
-
-      decltype(&occMultNTracksHasITSUnfm80[0]) tfOccMultNTracksHasITSUnfm80 = nullptr;
-      decltype(&occMultNTracksHasTPCUnfm80[0]) tfOccMultNTracksHasTPCUnfm80 = nullptr;
-      decltype(&occMultNTracksHasTOFUnfm80[0]) tfOccMultNTracksHasTOFUnfm80 = nullptr;
-      decltype(&occMultNTracksHasTRDUnfm80[0]) tfOccMultNTracksHasTRDUnfm80 = nullptr;
-      decltype(&occMultNTracksITSOnlyUnfm80[0]) tfOccMultNTracksITSOnlyUnfm80 = nullptr;
-      decltype(&occMultNTracksTPCOnlyUnfm80[0]) tfOccMultNTracksTPCOnlyUnfm80 = nullptr;
-      decltype(&occMultNTracksITSTPCUnfm80[0]) tfOccMultNTracksITSTPCUnfm80 = nullptr;
-      decltype(&occMultAllTracksTPCOnlyUnfm80[0]) tfOccMultAllTracksTPCOnlyUnfm80 = nullptr;
-
       for (const auto& collision : collisions) {
         const auto& bc = collision.template bc_as<B>();
         getTimingInfo(bc, lastRun, nBCsPerTF, bcSOR, time, tfIdThis, bcInTF);
@@ -657,44 +722,6 @@ struct OccupancyTableProducer {
         }
 
         bcTFMap[tfIDX].push_back(bc.globalIndex());
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-          tfOccPrimUnfm80 = &occPrimUnfm80[tfIDX];
-        }
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim) {
-          tfOccFV0AUnfm80 = &occFV0AUnfm80[tfIDX];
-          tfOccFV0CUnfm80 = &occFV0CUnfm80[tfIDX];
-          tfOccFT0AUnfm80 = &occFT0AUnfm80[tfIDX];
-          tfOccFT0CUnfm80 = &occFT0CUnfm80[tfIDX];
-        }
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim) {
-          tfOccFDDAUnfm80 = &occFDDAUnfm80[tfIDX];
-          tfOccFDDCUnfm80 = &occFDDCUnfm80[tfIDX];
-        }
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
-          tfOccNTrackITSUnfm80 = &occNTrackITSUnfm80[tfIDX];
-          tfOccNTrackTPCUnfm80 = &occNTrackTPCUnfm80[tfIDX];
-          tfOccNTrackTRDUnfm80 = &occNTrackTRDUnfm80[tfIDX];
-          tfOccNTrackTOFUnfm80 = &occNTrackTOFUnfm80[tfIDX];
-          tfOccNTrackSizeUnfm80 = &occNTrackSizeUnfm80[tfIDX];
-          tfOccNTrackTPCAUnfm80 = &occNTrackTPCAUnfm80[tfIDX];
-          tfOccNTrackTPCCUnfm80 = &occNTrackTPCCUnfm80[tfIDX];
-          tfOccNTrackITSTPCAUnfm80 = &occNTrackITSTPCAUnfm80[tfIDX];
-          tfOccNTrackITSTPCCUnfm80 = &occNTrackITSTPCCUnfm80[tfIDX];
-        }
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-          tfOccNTrackITSTPCUnfm80 = &occNTrackITSTPCUnfm80[tfIDX];
-        }
-        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
-          tfOccMultNTracksHasITSUnfm80 = &occMultNTracksHasITSUnfm80[tfIDX];
-          tfOccMultNTracksHasTPCUnfm80 = &occMultNTracksHasTPCUnfm80[tfIDX];
-          tfOccMultNTracksHasTOFUnfm80 = &occMultNTracksHasTOFUnfm80[tfIDX];
-          tfOccMultNTracksHasTRDUnfm80 = &occMultNTracksHasTRDUnfm80[tfIDX];
-          tfOccMultNTracksITSOnlyUnfm80 = &occMultNTracksITSOnlyUnfm80[tfIDX];
-          tfOccMultNTracksTPCOnlyUnfm80 = &occMultNTracksTPCOnlyUnfm80[tfIDX];
-          tfOccMultNTracksITSTPCUnfm80 = &occMultNTracksITSTPCUnfm80[tfIDX];
-          tfOccMultAllTracksTPCOnlyUnfm80 = &occMultAllTracksTPCOnlyUnfm80[tfIDX];
-        }
-
         // current collision bin in 80/160 bcGrouping.
         int bin80Zero = bcInTF / bcGrouping;
         // int bin160_0=bcInTF/160;
@@ -726,49 +753,49 @@ struct OccupancyTableProducer {
           fNTrackITSTPCA = nTrackITSTPCA;
           fNTrackITSTPCC = nTrackITSTPCC;
         }
-        // Processing for bcGrouping of 80 BCs
-        for (int deltaBin = 0; deltaBin < nBCinDrift / bcGrouping; deltaBin++) {
-
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccPrimUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNumContrib * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim) {
-            (*tfOccFV0AUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFV0A * 1;
-            (*tfOccFV0CUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFV0C * 1;
-            (*tfOccFT0AUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFT0A * 1;
-            (*tfOccFT0CUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFT0C * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim) {
-            (*tfOccFDDAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFDDA * 1;
-            (*tfOccFDDCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fMultFDDC * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
-            (*tfOccNTrackITSUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITS * 1;
-            (*tfOccNTrackTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPC * 1;
-            (*tfOccNTrackTRDUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTRD * 1;
-            (*tfOccNTrackTOFUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTOF * 1;
-            (*tfOccNTrackSizeUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackSize * 1;
-            (*tfOccNTrackTPCAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPCA * 1;
-            (*tfOccNTrackTPCCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackTPCC * 1;
-            (*tfOccNTrackITSTPCAUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPCA * 1;
-            (*tfOccNTrackITSTPCCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPCC * 1;
-          }
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccNTrackITSTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += fNTrackITSTPC * 1;
-          }
-
-          if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
-            (*tfOccMultNTracksHasITSUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasITS() * 1;
-            (*tfOccMultNTracksHasTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTPC() * 1;
-            (*tfOccMultNTracksHasTOFUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTOF() * 1;
-            (*tfOccMultNTracksHasTRDUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksHasTRD() * 1;
-            (*tfOccMultNTracksITSOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksITSOnly() * 1;
-            (*tfOccMultNTracksTPCOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksTPCOnly() * 1;
-            (*tfOccMultNTracksITSTPCUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multNTracksITSTPC() * 1;
-            (*tfOccMultAllTracksTPCOnlyUnfm80)[(bin80Zero + deltaBin) % (nBCinTF / bcGrouping)] += collision.multAllTracksTPCOnly() * 1;
-          }
+        // Contributions of the collision to the occupancy estimators, added to all the bins of its drift window at once
+        std::array<float, kNOccEstimators> occContrib{};
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccPrim || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
+          occContrib[kOccPrim] = fNumContrib;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccT0V0Prim || processMode == kProcessOnlyOccFDDT0V0Prim) {
+          occContrib[kOccFV0A] = fMultFV0A;
+          occContrib[kOccFV0C] = fMultFV0C;
+          occContrib[kOccFT0A] = fMultFT0A;
+          occContrib[kOccFT0C] = fMultFT0C;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccFDDT0V0Prim) {
+          occContrib[kOccFDDA] = fMultFDDA;
+          occContrib[kOccFDDC] = fMultFDDC;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet) {
+          occContrib[kOccNTrackITS] = fNTrackITS;
+          occContrib[kOccNTrackTPC] = fNTrackTPC;
+          occContrib[kOccNTrackTRD] = fNTrackTRD;
+          occContrib[kOccNTrackTOF] = fNTrackTOF;
+          occContrib[kOccNTrackSize] = fNTrackSize;
+          occContrib[kOccNTrackTPCA] = fNTrackTPCA;
+          occContrib[kOccNTrackTPCC] = fNTrackTPCC;
+          occContrib[kOccNTrackITSTPCA] = fNTrackITSTPCA;
+          occContrib[kOccNTrackITSTPCC] = fNTrackITSTPCC;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccNtrackDet || processMode == kProcessOnlyOccMultExtra) {
+          occContrib[kOccNTrackITSTPC] = fNTrackITSTPC;
+        }
+        if constexpr (processMode == kProcessFullOccTableProducer || processMode == kProcessOnlyOccMultExtra) {
+          occContrib[kOccMultNTracksHasITS] = collision.multNTracksHasITS();
+          occContrib[kOccMultNTracksHasTPC] = collision.multNTracksHasTPC();
+          occContrib[kOccMultNTracksHasTOF] = collision.multNTracksHasTOF();
+          occContrib[kOccMultNTracksHasTRD] = collision.multNTracksHasTRD();
+          occContrib[kOccMultNTracksITSOnly] = collision.multNTracksITSOnly();
+          occContrib[kOccMultNTracksTPCOnly] = collision.multNTracksTPCOnly();
+          occContrib[kOccMultNTracksITSTPC] = collision.multNTracksITSTPC();
+          occContrib[kOccMultAllTracksTPCOnly] = collision.multAllTracksTPCOnly();
         }
+        addToOccWindow(tfIDX, bin80Zero, occContrib);
       }
+      // Integrate the window contributions of all the estimators in a single pass
+      integrateOccWindows<processMode>(tfCounted);
       // collision Loop is over
 
       occupancyQA.fill(HIST("h_TF_in_DataFrame"), tfCounted);
@@ -464,20 +464,23 @@ struct qVectorsTable {
     if (cent < cfgMaxCentrality) {
       for (auto i{0u}; i < kTPCAll + 1; i++) {
         int idxDet = i * kNCorrections;
-        helperEP.DoRecenter(qVecRe[idxDet + kRecenter], qVecIm[idxDet + kRecenter],
-                            histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-
-        helperEP.DoRecenter(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                            histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-        helperEP.DoTwist(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist],
-                         histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-
-        helperEP.DoRecenter(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                            histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 1, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 2, i + 1));
-        helperEP.DoTwist(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                         histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 3, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 4, i + 1));
-        helperEP.DoRescale(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale],
-                           histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 5, i + 1), histsCorrs->GetBinContent(static_cast<int>(cent) + 1, 6, i + 1));
+        // Read the correction constants of the detector once for the three correction steps
+        int centBin = static_cast<int>(cent) + 1;
+        float x0 = histsCorrs->GetBinContent(centBin, 1, i + 1);
+        float y0 = histsCorrs->GetBinContent(centBin, 2, i + 1);
+        float lp = histsCorrs->GetBinContent(centBin, 3, i + 1);
+        float lm = histsCorrs->GetBinContent(centBin, 4, i + 1);
+        float ap = histsCorrs->GetBinContent(centBin, 5, i + 1);
+        float am = histsCorrs->GetBinContent(centBin, 6, i + 1);
+
+        helperEP.DoRecenter(qVecRe[idxDet + kRecenter], qVecIm[idxDet + kRecenter], x0, y0);
+
+        helperEP.DoRecenter(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist], x0, y0);
+        helperEP.DoTwist(qVecRe[idxDet + kTwist], qVecIm[idxDet + kTwist], lp, lm);
+
+        helperEP.DoRecenter(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], x0, y0);
+        helperEP.DoTwist(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], lp, lm);
+        helperEP.DoRescale(qVecRe[idxDet + kRescale], qVecIm[idxDet + kRescale], ap, am);
       }
       if (cfgShiftCorr) {
         auto deltaPsiFT0C = 0.0;
@@ -122,6 +122,7 @@ struct TimestampTask {
       mapRunToRunDuration[runNumber] = runDuration;
       LOGF(info, "Add new run number %i with orbit-reset timestamp %llu, SOR: %llu, EOR: %llu to cache", runNumber, orbitResetTimestamp, runDuration.first, runDuration.second);
     }
+    lastRunNumber = runNumber;
 
     if (verbose.value) {
       LOGF(info, "Orbit-reset timestamp for run number %i found: %llu us", runNumber, orbitResetTimestamp);
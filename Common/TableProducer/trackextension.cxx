@@ -13,6 +13,7 @@
 // Task performing basic track selection.
 //
 
+#include "Common/Core/TableHelper.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/TrackSelectionTables.h"
 
@@ -64,10 +65,14 @@ struct TrackExtension {
   int mRunNumber;
   float mMagField;
 
-  void init(InitContext&)
+  void init(InitContext& initContext)
   {
     using namespace analysis::trackextension;
 
+    // nothing to compute if no task of the workflow consumes the DCA table
+    o2::common::core::disableProcessIfNoTableRequired(initContext, {"TracksDCA"}, doprocessRun2);
+    o2::common::core::disableProcessIfNoTableRequired(initContext, {"TracksDCA"}, doprocessRun3);
+
     ccdb->setURL(ccdburl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
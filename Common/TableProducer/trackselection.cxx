@@ -31,7 +31,9 @@
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
+#include <cstddef>
 #include <cstdint>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -54,6 +56,7 @@ struct TrackSelectionTask {
   Configurable<float> ptMax{"ptMax", 1e10f, "Upper cut on pt for the track selected"};
   Configurable<float> etaMin{"etaMin", -0.8, "Lower cut on eta for the track selected"};
   Configurable<float> etaMax{"etaMax", 0.8, "Upper cut on eta for the track selected"};
+  Configurable<bool> columnarSelection{"columnarSelection", true, "evaluate each cut over the whole track table at once instead of track by track"};
 
   Produces<aod::TrackSelection> filterTable;
   Produces<aod::TrackSelectionExtension> filterTableDetail;
@@ -65,6 +68,10 @@ struct TrackSelectionTask {
   TrackSelection filtBit4;
   TrackSelection filtBit5;
 
+  // buffers of the columnar selection, reused across time frames
+  TrackSelection::TrackColumns trackColumns;
+  std::vector<uint16_t> maskGlob, maskSDD, maskFB1, maskFB2, maskFB3, maskFB4, maskFB5;
+
   void init(InitContext& initContext)
   {
     // Check which tables are used
@@ -144,6 +151,60 @@ struct TrackSelectionTask {
     filtBit5 = getJEGlobalTrackSelectionRun2(); // Jet validation requires reduced set of cuts
   }
 
+  /// Fills the tables with the same content as the track-by-track loop, with all the selections evaluated cut by cut over the whole table
+  template <typename TracksType>
+  void fillTablesColumnar(TracksType const& tracks)
+  {
+    using TrackSelectionFlags = o2::aod::track::TrackSelectionFlags;
+    constexpr uint16_t AllCuts = TrackSelection::kAllCutsMask;
+    trackColumns.fill(tracks);
+    globalTracks.IsSelectedMask(trackColumns, maskGlob);
+    if (produceTable == 1) {
+      if (!isRun3) {
+        globalTracksSDD.IsSelectedMask(trackColumns, maskSDD);
+      }
+      filtBit3.IsSelectedMask(trackColumns, maskFB3);
+      filtBit4.IsSelectedMask(trackColumns, maskFB4);
+      filtBit5.IsSelectedMask(trackColumns, maskFB5);
+    }
+    if (produceTable == 1 || (isRun3 && produceFBextendedTable == 1)) {
+      filtBit1.IsSelectedMask(trackColumns, maskFB1);
+      filtBit2.IsSelectedMask(trackColumns, maskFB2);
+    }
+
+    for (std::size_t i = 0; i < trackColumns.size(); ++i) {
+      const TrackSelectionFlags::flagtype trackflagGlob = maskGlob[i];
+      if (produceTable == 1) {
+        filterTable(static_cast<uint8_t>(!isRun3 && maskSDD[i] == AllCuts),
+                    trackflagGlob,
+                    maskFB1[i] == AllCuts,
+                    maskFB2[i] == AllCuts,
+                    maskFB3[i] == AllCuts,
+                    maskFB4[i] == AllCuts,
+                    maskFB5[i] == AllCuts);
+      }
+      if (produceFBextendedTable == 1) {
+        filterTableDetail(TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTrackType),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kPtRange),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kEtaRange),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTPCNCls),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTPCCrossedRows),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTPCCrossedRowsOverNCls),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTPCChi2NDF),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kTPCRefit),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kITSNCls),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kITSChi2NDF),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kITSRefit),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kITSHits),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kGoldenChi2),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kDCAxy),
+                          TrackSelectionFlags::checkFlag(trackflagGlob, TrackSelectionFlags::kDCAz),
+                          isRun3 ? TrackSelectionFlags::checkFlag(maskFB1[i], TrackSelectionFlags::kITSHits) : false,
+                          isRun3 ? TrackSelectionFlags::checkFlag(maskFB2[i], TrackSelectionFlags::kITSHits) : false);
+      }
+    }
+  }
+
   void process(soa::Join<aod::FullTracks, aod::TracksDCA> const& tracks)
   {
     if (produceTable == 1) {
@@ -155,6 +216,10 @@ struct TrackSelectionTask {
     if (produceTable == 0 && produceFBextendedTable == 0) {
       return;
     }
+    if (columnarSelection) {
+      fillTablesColumnar(tracks);
+      return;
+    }
     if (isRun3) {
       for (const auto& track : tracks) {
 
@@ -13,10 +13,13 @@
 /// \author
 /// \since
 
+#include "Common/Core/TableResources.h"
+
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
+#include <Framework/EndOfStreamContext.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
 #include <Framework/InitContext.h>
@@ -116,12 +119,32 @@ bool checkCycles(T const& particlesMC)
 
 template <soa::is_table Table>
 struct LoadTable {
+  Configurable<bool> reportResources{"reportResources", false, "Report the rows, the bytes and the read throughput of each column, and the devices reading the table"};
   OutputObj<TH1F> counter{TH1F("counter", "counter", 2, 0., 2)};
+  o2::common::core::TableResources<Table> resources;
+
+  void init(InitContext& initContext)
+  {
+    if (reportResources) {
+      resources.init(initContext);
+    }
+  }
+
   void process(Table const& table)
   {
     LOGF(info, "Table has %d entries", table.size());
     counter->Fill(0.5);
     counter->Fill(1.5, table.size());
+    if (reportResources) {
+      resources.fill(table);
+    }
+  }
+
+  void endOfStream(EndOfStreamContext&)
+  {
+    if (reportResources) {
+      resources.print();
+    }
   }
 };
 
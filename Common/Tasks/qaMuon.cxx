@@ -283,6 +283,9 @@ struct muonQa {
   Preslice<MyMuonsWithCov> fwdtracksPerCollision = aod::fwdtrack::collisionId;
   Preslice<MyMFTs> mftPerCollision = aod::fwdtrack::collisionId;
 
+  // MFT tracks propagated to the DCA of the collisions, per (MFT track, collision), shared by the global muons of the data frame
+  std::map<std::pair<int64_t, uint64_t>, VarTrack> mftsAtDCA;
+
   HistogramRegistry registry{"registry", {}};
   HistogramRegistry registryDCA{"registryDCA", {}};
   HistogramRegistry registryDCAdiMuons{"registryDCAdiMuons", {}};
@@ -2489,8 +2492,14 @@ struct muonQa {
             continue;
           }
 
-          // Propagate MFT track to DCA
-          FillPropagation<0, 1>(mft, fgValuesColltmp, VarTrack{}, fgValuesMFTtmp, kToDCA);
+          // Propagate MFT track to DCA, once per collision in the data frame
+          auto [mftAtDCA, isNew] = mftsAtDCA.try_emplace({mft.globalIndex(), collisionId});
+          if (isNew) {
+            FillPropagation<0, 1>(mft, fgValuesColltmp, VarTrack{}, fgValuesMFTtmp, kToDCA);
+            mftAtDCA->second = fgValuesMFTtmp;
+          } else {
+            fgValuesMFTtmp = mftAtDCA->second;
+          }
 
           // Fill DCA QA histograms
           FillDCAHistograms<0, 1, 0>(VarTrack{}, VarTrack{}, fgValuesMFTtmp, fgValuesColltmp, sign, quadrant, sameEvent, mixedEvent);
@@ -3844,6 +3853,7 @@ struct muonQa {
   {
     std::map<uint64_t, VarColl> collisionSel;
     std::map<uint64_t, std::vector<uint64_t>> matchingCandidates;
+    mftsAtDCA.clear();
 
     initCCDB(bcs);
 
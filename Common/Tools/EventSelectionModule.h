@@ -51,6 +51,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <future>
 #include <iterator>
 #include <limits>
 #include <map>
@@ -121,6 +122,7 @@ struct evselConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<float> confEpsilonVzDiffVetoInROF{"EpsilonVzDiffVetoInROF", 0.3, "Minumum distance to nearby collisions along z inside this ITS ROF, cm"};                                         // o2-linter: disable=name/configurable (temporary fix)
   o2::framework::Configurable<bool> confUseWeightsForOccupancyVariable{"UseWeightsForOccupancyEstimator", 1, "Use or not the delta-time weights for the occupancy estimator"};                                   // o2-linter: disable=name/configurable (temporary fix)
   o2::framework::Configurable<int> confNumberOfOrbitsPerTF{"NumberOfOrbitsPerTF", -1, "Number of orbits per Time Frame. Take from CCDB if -1"};                                                                  // o2-linter: disable=name/configurable (temporary fix)
+  o2::framework::Configurable<int> confNumberOfThreadsForOccupancy{"NumberOfThreadsForOccupancy", 1, "Number of threads for the occupancy and nearby-collision flags, the output does not depend on it"};         // o2-linter: disable=name/configurable (temporary fix)
 
   // o2::framework::Configurable<std::vector<float>> confTimeIntervalsForGranularOccupancy{"timeIntervalsForGranularOccupancy", {-100, -60, -30, -10, 0, 10, 30, 60, 100}, "Delta-time intervals (wrt given collision) for which we store occupancy"};
 
@@ -1187,270 +1189,234 @@ class EventSelectionModule
       }
     }
 
-    // save indices of collisions for occupancy calculation (both in ROF and in time range)
-    std::vector<std::vector<int>> vCollsInSameITSROF;
-    std::vector<std::vector<int>> vCollsInPrevITSROF;
-    std::vector<std::vector<int>> vCollsInTimeWin;
-    std::vector<std::vector<float>> vTimeDeltaForColls; // delta time wrt a given collision
+    // FT0C amplitudes of the collisions, needed by the neighbouring collisions in the occupancy calculation
     for (const auto& col : cols) {
       int32_t colIndex = col.globalIndex();
-      int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
       auto bcselEntr = bcselbuffer[vFoundBCindex[colIndex]];
       if (bcselEntr.foundFT0Id > -1) {
         // required: explicit ft0s table
         auto foundFT0 = ft0s.rawIteratorAt(bcselEntr.foundFT0Id);
         vAmpFT0CperColl[colIndex] = foundFT0.sumAmpC();
       }
+    }
 
-      int64_t tfId = (foundGlobalBC - bcSOR) / nBCsPerTF;
-      int64_t rofId = (foundGlobalBC + nBCsPerOrbit - rofOffset) / rofLength;
-
-      // ### for in-ROF occupancy
-      std::vector<int> vAssocCollInSameROF;
-      // find all collisions in the same ROF before a given collision
-      int32_t minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        // int thisRofIdInTF = (thisBC - rofOffset) / rofLength;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-
-        // check if we are within the same ROF
-        if (thisRofId != rofId)
-          break;
-        vAssocCollInSameROF.push_back(minColIndex);
-        minColIndex--;
-      }
-      // find all collisions in the same ROF after the current one
-      int32_t maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-        if (thisRofId != rofId)
-          break;
-        vAssocCollInSameROF.push_back(maxColIndex);
-        maxColIndex++;
-      }
-      vCollsInSameITSROF.push_back(vAssocCollInSameROF);
-
-      // ### bookkeep collisions in previous ROF
-      std::vector<int> vAssocCollInPrevROF;
-      minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        int64_t thisRofId = (thisBC + nBCsPerOrbit - rofOffset) / rofLength;
-        if (thisRofId == rofId - 1)
-          vAssocCollInPrevROF.push_back(minColIndex);
-        else if (thisRofId < rofId - 1)
-          break;
-        minColIndex--;
-      }
-      vCollsInPrevITSROF.push_back(vAssocCollInPrevROF);
-
-      // ### for occupancy in time windows
-      std::vector<int> vAssocToThisCol;
-      std::vector<float> vCollsTimeDeltaWrtGivenColl;
-      std::vector<float> vProxyNtracksAssocColls; // mult of associated collisions, for the median time calc
-      // find all collisions in time window before the current one
-      minColIndex = colIndex - 1;
-      while (minColIndex >= 0) {
-        int64_t thisBC = vFoundGlobalBC[minColIndex];
-        // check if this is still the same TF
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        // check if we are within the chosen time range
-        if (dt < timeWinOccupancyCalcMinNS)
-          break;
-        vAssocToThisCol.push_back(minColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        vProxyNtracksAssocColls.push_back(vProxyForCollNtracks[minColIndex]);
-        minColIndex--;
-      }
-      // find all collisions in time window after the current one
-      maxColIndex = colIndex + 1;
-      while (maxColIndex < cols.size()) {
-        int64_t thisBC = vFoundGlobalBC[maxColIndex];
-        int64_t thisTFid = (thisBC - bcSOR) / nBCsPerTF;
-        if (thisTFid != tfId)
-          break;
-        float dt = (thisBC - foundGlobalBC) * bcNS; // ns
-        if (dt > timeWinOccupancyCalcMaxNS)
-          break;
-        vAssocToThisCol.push_back(maxColIndex);
-        vCollsTimeDeltaWrtGivenColl.push_back(dt);
-        vProxyNtracksAssocColls.push_back(vProxyForCollNtracks[maxColIndex]);
-        maxColIndex++;
-      }
-      vCollsInTimeWin.push_back(vAssocToThisCol);
-      vTimeDeltaForColls.push_back(vCollsTimeDeltaWrtGivenColl);
-
-      // calculation of the median time for the occupancy in a given time window
-      std::vector<std::pair<float, float>> pairsDeltaTimeMult;
-      for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++)
-        pairsDeltaTimeMult.emplace_back(vCollsTimeDeltaWrtGivenColl[iCol], vProxyNtracksAssocColls[iCol]);
-      std::sort(pairsDeltaTimeMult.begin(), pairsDeltaTimeMult.end()); // sorts by first element by default
-      int proxyTotalMultInTimeWin = std::accumulate(vProxyNtracksAssocColls.begin(), vProxyNtracksAssocColls.end(), 0);
-
-      float sumMult = 0.0;
-      for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++) {
-        sumMult += pairsDeltaTimeMult[iCol].second;
-        if (sumMult > proxyTotalMultInTimeWin / 2.0) {
-          vMedianTimeForOccupancy[colIndex] = pairsDeltaTimeMult[iCol].first / 1e3; // ns -> us
-          break;
-        }
-      }
-      for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++) {
-        LOGP(debug, "dt={} mult={}", pairsDeltaTimeMult[iCol].first, pairsDeltaTimeMult[iCol].second);
-      }
-      LOGP(debug, "   --> median time = {}", vMedianTimeForOccupancy[colIndex]);
+    // TF and ITS ROF indices of the found BCs, computed once instead of at each step of the neighbour searches
+    const int32_t nCols = cols.size();
+    std::vector<int64_t> vTFid(nCols, 0);
+    std::vector<int64_t> vRofId(nCols, 0);
+    for (int32_t colIndex = 0; colIndex < nCols; colIndex++) {
+      vTFid[colIndex] = (vFoundGlobalBC[colIndex] - bcSOR) / nBCsPerTF;
+      vRofId[colIndex] = (vFoundGlobalBC[colIndex] + nBCsPerOrbit - rofOffset) / rofLength;
     }
+    // sorted copy of the TVX map, read concurrently in the occupancy calculation
+    std::vector<std::pair<int64_t, int32_t>> vGlobalBcWithTVX(mapGlobalBcWithTVX.begin(), mapGlobalBcWithTVX.end());
 
     // perform the occupancy calculation per ITS ROF and also in the pre-defined time window
     std::vector<int> vNumTracksITS567inFullTimeWin(cols.size(), 0); // counter of tracks in full time window for occupancy studies (excluding given event)
     std::vector<float> vSumAmpFT0CinFullTimeWin(cols.size(), 0);    // sum of FT0C of tracks in full time window for occupancy studies (excluding given event)
 
-    std::vector<bool> vNoCollInTimeRangeStrict(cols.size(), 0);   // no collisions in a specified time range
-    std::vector<bool> vNoCollInTimeRangeNarrow(cols.size(), 0);   // no collisions in a specified time range (narrow)
-    std::vector<bool> vNoHighMultCollInTimeRange(cols.size(), 0); // no high-mult collisions in a specified time range
+    // N.B.: uint8_t instead of bool, the flags of neighbouring collisions are filled by different threads
+    std::vector<uint8_t> vNoCollInTimeRangeStrict(cols.size(), 0);   // no collisions in a specified time range
+    std::vector<uint8_t> vNoCollInTimeRangeNarrow(cols.size(), 0);   // no collisions in a specified time range (narrow)
+    std::vector<uint8_t> vNoHighMultCollInTimeRange(cols.size(), 0); // no high-mult collisions in a specified time range
 
-    std::vector<bool> vNoCollInSameRofStrict(cols.size(), 0);      // to veto events with other collisions in the same ITS ROF
-    std::vector<bool> vNoCollInSameRofStandard(cols.size(), 0);    // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
-    std::vector<bool> vNoCollInSameRofWithCloseVz(cols.size(), 0); // to veto events with nearby collisions with close vZ
-    std::vector<bool> vNoHighMultCollInPrevRof(cols.size(), 0);    // veto events if FT0C amplitude in previous ITS ROF is above threshold
+    std::vector<uint8_t> vNoCollInSameRofStrict(cols.size(), 0);      // to veto events with other collisions in the same ITS ROF
+    std::vector<uint8_t> vNoCollInSameRofStandard(cols.size(), 0);    // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
+    std::vector<uint8_t> vNoCollInSameRofWithCloseVz(cols.size(), 0); // to veto events with nearby collisions with close vZ
+    std::vector<uint8_t> vNoHighMultCollInPrevRof(cols.size(), 0);    // veto events if FT0C amplitude in previous ITS ROF is above threshold
 
-    for (const auto& col : cols) {
-      int32_t colIndex = col.globalIndex();
-      float vZ = col.posZ();
-
-      // ### in-ROF occupancy
-      std::vector<int> vAssocCollInSameROF = vCollsInSameITSROF[colIndex];
-      int nITS567tracksForSameRofVetoStrict = 0;    // to veto events with other collisions in the same ITS ROF
-      int nCollsInRofWithFT0CAboveVetoStandard = 0; // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
-      int nITS567tracksForRofVetoOnCloseVz = 0;     // to veto events with nearby collisions with close vZ
-      for (uint32_t iCol = 0; iCol < vAssocCollInSameROF.size(); iCol++) {
-        int thisColIndex = vAssocCollInSameROF[iCol];
-        nITS567tracksForSameRofVetoStrict += vTracksITS567perColl[thisColIndex];
-        if (vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInROF)
-          nCollsInRofWithFT0CAboveVetoStandard++;
-        if (std::fabs(vCollVz[thisColIndex] - vZ) < evselOpts.confEpsilonVzDiffVetoInROF)
-          nITS567tracksForRofVetoOnCloseVz += vTracksITS567perColl[thisColIndex];
-      }
-      // in-ROF occupancy flags
-      vNoCollInSameRofStrict[colIndex] = (nITS567tracksForSameRofVetoStrict == 0);
-      vNoCollInSameRofStandard[colIndex] = (nCollsInRofWithFT0CAboveVetoStandard == 0);
-      vNoCollInSameRofWithCloseVz[colIndex] = (nITS567tracksForRofVetoOnCloseVz == 0);
-
-      // ### occupancy in previous ROF
-      std::vector<int> vAssocCollInPrevROF = vCollsInPrevITSROF[colIndex];
-      float totalFT0amplInPrevROF = 0;
-      for (uint32_t iCol = 0; iCol < vAssocCollInPrevROF.size(); iCol++) {
-        int thisColIndex = vAssocCollInPrevROF[iCol];
-        totalFT0amplInPrevROF += vAmpFT0CperColl[thisColIndex];
-      }
-      // veto events if FT0C amplitude in previous ITS ROF is above threshold
-      vNoHighMultCollInPrevRof[colIndex] = (totalFT0amplInPrevROF < evselOpts.confFT0CamplCutVetoOnCollInROF);
-
-      // ### occupancy in time windows
-      std::vector<int> vAssocToThisCol = vCollsInTimeWin[colIndex];
-      std::vector<float> vCollsTimeDeltaWrtGivenColl = vTimeDeltaForColls[colIndex];
-      int nITS567tracksInFullTimeWindow = 0;
-      float sumAmpFT0CInFullTimeWindow = 0;
-      int nITS567tracksForVetoNarrow = 0;      // to veto events with nearby collisions (narrow range) with per-collision multiplicity above threshold
-      int nITS567tracksForVetoStrict = 0;      // to veto events with nearby collisions
-      int nCollsWithFT0CAboveVetoStandard = 0; // to veto events with nearby collisions that have per-collision multiplicity above threshold
-      int colIndexFirstRejectedByTFborderCut = -1;
-      for (uint32_t iCol = 0; iCol < vAssocToThisCol.size(); iCol++) {
-        int thisColIndex = vAssocToThisCol[iCol];
-        float dt = vCollsTimeDeltaWrtGivenColl[iCol] / 1e3; // ns -> us
-        // counting tracks from other collisions in fixed time windows
-        if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollNarrow)
-          nITS567tracksForVetoNarrow += vProxyForCollNtracks[thisColIndex];
-        if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollStrict)
-          nITS567tracksForVetoStrict += vProxyForCollNtracks[thisColIndex];
-
-        // veto on high-mult collisions nearby, where artificial structures in the dt-occupancy plots are observed
-        if (dt > -4.0 && dt < 2.0 && vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInTimeRange) { // dt in us // o2-linter: disable=magic-number
-          nCollsWithFT0CAboveVetoStandard++;
+    // the collisions are processed in contiguous slices (i.e. in BC order), each collision only reads the shared per-collision vectors
+    auto calcOccupancyInSlice = [&](int32_t colFirst, int32_t colLast) {
+      std::vector<int> vAssocToThisCol;
+      std::vector<float> vCollsTimeDeltaWrtGivenColl;
+      std::vector<float> vProxyNtracksAssocColls; // mult of associated collisions, for the median time calc
+      std::vector<std::pair<float, float>> pairsDeltaTimeMult;
+      for (int32_t colIndex = colFirst; colIndex < colLast; colIndex++) {
+        int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
+        int64_t tfId = vTFid[colIndex];
+        int64_t rofId = vRofId[colIndex];
+        float vZ = vCollVz[colIndex];
+
+        // ### in-ROF occupancy
+        int nITS567tracksForSameRofVetoStrict = 0;    // to veto events with other collisions in the same ITS ROF
+        int nCollsInRofWithFT0CAboveVetoStandard = 0; // to veto events with other collisions in the same ITS ROF, with per-collision multiplicity above threshold
+        int nITS567tracksForRofVetoOnCloseVz = 0;     // to veto events with nearby collisions with close vZ
+        auto addCollInSameRof = [&](int thisColIndex) {
+          nITS567tracksForSameRofVetoStrict += vTracksITS567perColl[thisColIndex];
+          if (vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInROF)
+            nCollsInRofWithFT0CAboveVetoStandard++;
+          if (std::fabs(vCollVz[thisColIndex] - vZ) < evselOpts.confEpsilonVzDiffVetoInROF)
+            nITS567tracksForRofVetoOnCloseVz += vTracksITS567perColl[thisColIndex];
+        };
+        // find all collisions in the same TF and ROF before and after a given collision
+        for (int32_t minColIndex = colIndex - 1; minColIndex >= 0 && vTFid[minColIndex] == tfId && vRofId[minColIndex] == rofId; minColIndex--) {
+          addCollInSameRof(minColIndex);
         }
-
-        // check if we are close to TF borders => N ITS tracks is not reliable, and FT0C ampl will be used for occupancy estimation (a loop below)
-        if (vIsCollRejectedByTFborderCut[thisColIndex]) {
-          if (colIndexFirstRejectedByTFborderCut == -1)
-            colIndexFirstRejectedByTFborderCut = thisColIndex;
-          continue;
+        for (int32_t maxColIndex = colIndex + 1; maxColIndex < nCols && vTFid[maxColIndex] == tfId && vRofId[maxColIndex] == rofId; maxColIndex++) {
+          addCollInSameRof(maxColIndex);
         }
-
-        // weighted occupancy calc:
-        if (vIsFullInfoForOccupancy[colIndex]) {
-          float wOccup = 1.;
-          if (evselOpts.confUseWeightsForOccupancyVariable) {
-            // weighted occupancy
-            wOccup = calcWeightForOccupancy(dt);
-          }
-          nITS567tracksInFullTimeWindow += wOccup * vProxyForCollNtracks[thisColIndex];
-          sumAmpFT0CInFullTimeWindow += wOccup * vAmpFT0CperColl[thisColIndex];
+        // in-ROF occupancy flags
+        vNoCollInSameRofStrict[colIndex] = (nITS567tracksForSameRofVetoStrict == 0);
+        vNoCollInSameRofStandard[colIndex] = (nCollsInRofWithFT0CAboveVetoStandard == 0);
+        vNoCollInSameRofWithCloseVz[colIndex] = (nITS567tracksForRofVetoOnCloseVz == 0);
+
+        // ### occupancy in previous ROF
+        float totalFT0amplInPrevROF = 0;
+        for (int32_t minColIndex = colIndex - 1; minColIndex >= 0 && vTFid[minColIndex] == tfId; minColIndex--) {
+          int64_t thisRofId = vRofId[minColIndex];
+          if (thisRofId == rofId - 1)
+            totalFT0amplInPrevROF += vAmpFT0CperColl[minColIndex];
+          else if (thisRofId < rofId - 1)
+            break;
         }
-      }
-
-      // if some associated collisions are close to TF border - take FT0C amplitude instead of nTracks, using BC table
-      if (vIsFullInfoForOccupancy[colIndex] && vCanHaveAssocCollsWithinLastDriftTime[colIndex] && colIndexFirstRejectedByTFborderCut >= 0) {
-        int64_t foundGlobalBC = vFoundGlobalBC[colIndex];
-        int64_t tfId = (foundGlobalBC - bcSOR) / nBCsPerTF;
-        std::map<int64_t, int32_t>::iterator it = mapGlobalBcWithTVX.find(vFoundGlobalBC[colIndexFirstRejectedByTFborderCut]);
-        while (it != mapGlobalBcWithTVX.end()) {
-          int64_t thisFoundGlobalBC = it->first;
-          int32_t thisFoundBCindex = it->second;
-          auto bc = bcs.iteratorAt(thisFoundBCindex);
-          int64_t thisTFid = (bc.globalBC() - bcSOR) / nBCsPerTF;
-          if (thisTFid != tfId)
+        // veto events if FT0C amplitude in previous ITS ROF is above threshold
+        vNoHighMultCollInPrevRof[colIndex] = (totalFT0amplInPrevROF < evselOpts.confFT0CamplCutVetoOnCollInROF);
+
+        // ### for occupancy in time windows
+        vAssocToThisCol.clear();
+        vCollsTimeDeltaWrtGivenColl.clear();
+        vProxyNtracksAssocColls.clear();
+        // find all collisions in time window before the current one
+        for (int32_t minColIndex = colIndex - 1; minColIndex >= 0 && vTFid[minColIndex] == tfId; minColIndex--) {
+          float dt = (vFoundGlobalBC[minColIndex] - foundGlobalBC) * bcNS; // ns
+          // check if we are within the chosen time range
+          if (dt < timeWinOccupancyCalcMinNS)
             break;
-
-          float dt = (thisFoundGlobalBC - foundGlobalBC) * bcNS; // ns
+          vAssocToThisCol.push_back(minColIndex);
+          vCollsTimeDeltaWrtGivenColl.push_back(dt);
+          vProxyNtracksAssocColls.push_back(vProxyForCollNtracks[minColIndex]);
+        }
+        // find all collisions in time window after the current one
+        for (int32_t maxColIndex = colIndex + 1; maxColIndex < nCols && vTFid[maxColIndex] == tfId; maxColIndex++) {
+          float dt = (vFoundGlobalBC[maxColIndex] - foundGlobalBC) * bcNS; // ns
           if (dt > timeWinOccupancyCalcMaxNS)
             break;
+          vAssocToThisCol.push_back(maxColIndex);
+          vCollsTimeDeltaWrtGivenColl.push_back(dt);
+          vProxyNtracksAssocColls.push_back(vProxyForCollNtracks[maxColIndex]);
+        }
 
-          float multT0C = -1;
-          if (bc.has_ft0()) {
-            multT0C = bc.ft0().sumAmpC();
+        // calculation of the median time for the occupancy in a given time window
+        pairsDeltaTimeMult.clear();
+        for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++)
+          pairsDeltaTimeMult.emplace_back(vCollsTimeDeltaWrtGivenColl[iCol], vProxyNtracksAssocColls[iCol]);
+        std::sort(pairsDeltaTimeMult.begin(), pairsDeltaTimeMult.end()); // sorts by first element by default
+        int proxyTotalMultInTimeWin = std::accumulate(vProxyNtracksAssocColls.begin(), vProxyNtracksAssocColls.end(), 0);
+
+        float sumMult = 0.0;
+        for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++) {
+          sumMult += pairsDeltaTimeMult[iCol].second;
+          if (sumMult > proxyTotalMultInTimeWin / 2.0) {
+            vMedianTimeForOccupancy[colIndex] = pairsDeltaTimeMult[iCol].first / 1e3; // ns -> us
+            break;
+          }
+        }
+        for (size_t iCol = 0; iCol < vCollsTimeDeltaWrtGivenColl.size(); iCol++) {
+          LOGP(debug, "dt={} mult={}", pairsDeltaTimeMult[iCol].first, pairsDeltaTimeMult[iCol].second);
+        }
+        LOGP(debug, "   --> median time = {}", vMedianTimeForOccupancy[colIndex]);
+
+        // ### occupancy in time windows
+        int nITS567tracksInFullTimeWindow = 0;
+        float sumAmpFT0CInFullTimeWindow = 0;
+        int nITS567tracksForVetoNarrow = 0;      // to veto events with nearby collisions (narrow range) with per-collision multiplicity above threshold
+        int nITS567tracksForVetoStrict = 0;      // to veto events with nearby collisions
+        int nCollsWithFT0CAboveVetoStandard = 0; // to veto events with nearby collisions that have per-collision multiplicity above threshold
+        int colIndexFirstRejectedByTFborderCut = -1;
+        for (uint32_t iCol = 0; iCol < vAssocToThisCol.size(); iCol++) {
+          int thisColIndex = vAssocToThisCol[iCol];
+          float dt = vCollsTimeDeltaWrtGivenColl[iCol] / 1e3; // ns -> us
+          // counting tracks from other collisions in fixed time windows
+          if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollNarrow)
+            nITS567tracksForVetoNarrow += vProxyForCollNtracks[thisColIndex];
+          if (std::fabs(dt) < evselOpts.confTimeRangeVetoOnCollStrict)
+            nITS567tracksForVetoStrict += vProxyForCollNtracks[thisColIndex];
+
+          // veto on high-mult collisions nearby, where artificial structures in the dt-occupancy plots are observed
+          if (dt > -4.0 && dt < 2.0 && vAmpFT0CperColl[thisColIndex] > evselOpts.confFT0CamplCutVetoOnCollInTimeRange) { // dt in us // o2-linter: disable=magic-number
+            nCollsWithFT0CAboveVetoStandard++;
+          }
+
+          // check if we are close to TF borders => N ITS tracks is not reliable, and FT0C ampl will be used for occupancy estimation (a loop below)
+          if (vIsCollRejectedByTFborderCut[thisColIndex]) {
+            if (colIndexFirstRejectedByTFborderCut == -1)
+              colIndexFirstRejectedByTFborderCut = thisColIndex;
+            continue;
+          }
+
+          // weighted occupancy calc:
+          if (vIsFullInfoForOccupancy[colIndex]) {
             float wOccup = 1.;
             if (evselOpts.confUseWeightsForOccupancyVariable) {
-              wOccup = calcWeightForOccupancy(dt / 1e3); // ns -> us
+              // weighted occupancy
+              wOccup = calcWeightForOccupancy(dt);
             }
-            if (multT0C > 50.) // multiplicity in TVX is non-negligible, take it into occupancy calc
-            {
-              nITS567tracksInFullTimeWindow += wOccup * multT0C / 10.;
-              sumAmpFT0CInFullTimeWindow += wOccup * multT0C;
+            nITS567tracksInFullTimeWindow += wOccup * vProxyForCollNtracks[thisColIndex];
+            sumAmpFT0CInFullTimeWindow += wOccup * vAmpFT0CperColl[thisColIndex];
+          }
+        }
+
+        // if some associated collisions are close to TF border - take FT0C amplitude instead of nTracks, using BC table
+        if (vIsFullInfoForOccupancy[colIndex] && vCanHaveAssocCollsWithinLastDriftTime[colIndex] && colIndexFirstRejectedByTFborderCut >= 0) {
+          int64_t firstRejectedGlobalBC = vFoundGlobalBC[colIndexFirstRejectedByTFborderCut];
+          auto it = std::lower_bound(vGlobalBcWithTVX.begin(), vGlobalBcWithTVX.end(), firstRejectedGlobalBC, [](const auto& entry, int64_t globalBC) { return entry.first < globalBC; });
+          if (it != vGlobalBcWithTVX.end() && it->first != firstRejectedGlobalBC) {
+            it = vGlobalBcWithTVX.end(); // no TVX at the found BC of the collision
+          }
+          while (it != vGlobalBcWithTVX.end()) {
+            int64_t thisFoundGlobalBC = it->first;
+            int32_t thisFoundBCindex = it->second;
+            auto bc = bcs.iteratorAt(thisFoundBCindex);
+            int64_t thisTFid = (bc.globalBC() - bcSOR) / nBCsPerTF;
+            if (thisTFid != tfId)
+              break;
+
+            float dt = (thisFoundGlobalBC - foundGlobalBC) * bcNS; // ns
+            if (dt > timeWinOccupancyCalcMaxNS)
+              break;
+
+            float multT0C = -1;
+            if (bc.has_ft0()) {
+              multT0C = bc.ft0().sumAmpC();
+              float wOccup = 1.;
+              if (evselOpts.confUseWeightsForOccupancyVariable) {
+                wOccup = calcWeightForOccupancy(dt / 1e3); // ns -> us
+              }
+              if (multT0C > 50.) // multiplicity in TVX is non-negligible, take it into occupancy calc
+              {
+                nITS567tracksInFullTimeWindow += wOccup * multT0C / 10.;
+                sumAmpFT0CInFullTimeWindow += wOccup * multT0C;
+              }
             }
+            it++;
           }
-          it++;
         }
-      }
 
-      // protection against TF borders
-      if (!vIsFullInfoForOccupancy[colIndex]) { // occupancy in undefined (too close to TF borders)
-        nITS567tracksInFullTimeWindow = -1;
-        sumAmpFT0CInFullTimeWindow = -1;
+        // protection against TF borders
+        if (!vIsFullInfoForOccupancy[colIndex]) { // occupancy in undefined (too close to TF borders)
+          nITS567tracksInFullTimeWindow = -1;
+          sumAmpFT0CInFullTimeWindow = -1;
+        }
+
+        vNumTracksITS567inFullTimeWin[colIndex] = nITS567tracksInFullTimeWindow; // occupancy by a sum of number of ITS tracks (without a current collision)
+        vSumAmpFT0CinFullTimeWin[colIndex] = sumAmpFT0CInFullTimeWindow;         // occupancy by a sum of FT0C amplitudes (without a current collision)
+        // occupancy flags based on nearby collisions
+        vNoCollInTimeRangeNarrow[colIndex] = (nITS567tracksForVetoNarrow == 0);
+        vNoCollInTimeRangeStrict[colIndex] = (nITS567tracksForVetoStrict == 0);
+        vNoHighMultCollInTimeRange[colIndex] = (nCollsWithFT0CAboveVetoStandard == 0 && nITS567tracksForVetoNarrow == 0);
       }
+    };
 
-      vNumTracksITS567inFullTimeWin[colIndex] = nITS567tracksInFullTimeWindow; // occupancy by a sum of number of ITS tracks (without a current collision)
-      vSumAmpFT0CinFullTimeWin[colIndex] = sumAmpFT0CInFullTimeWindow;         // occupancy by a sum of FT0C amplitudes (without a current collision)
-      // occupancy flags based on nearby collisions
-      vNoCollInTimeRangeNarrow[colIndex] = (nITS567tracksForVetoNarrow == 0);
-      vNoCollInTimeRangeStrict[colIndex] = (nITS567tracksForVetoStrict == 0);
-      vNoHighMultCollInTimeRange[colIndex] = (nCollsWithFT0CAboveVetoStandard == 0 && nITS567tracksForVetoNarrow == 0);
-    } // end of the occupancy calculation
+    const int32_t nSlices = std::clamp<int32_t>(evselOpts.confNumberOfThreadsForOccupancy.value, 1, std::max<int32_t>(nCols, 1));
+    std::vector<std::future<void>> slices;
+    for (int32_t iSlice = 1; iSlice < nSlices; iSlice++) {
+      slices.push_back(std::async(std::launch::async, calcOccupancyInSlice, static_cast<int32_t>(static_cast<int64_t>(nCols) * iSlice / nSlices), static_cast<int32_t>(static_cast<int64_t>(nCols) * (iSlice + 1) / nSlices)));
+    }
+    calcOccupancyInSlice(0, nCols / nSlices);
+    for (auto& slice : slices) {
+      slice.get();
+    }
+    // end of the occupancy calculation
 
     for (const auto& col : cols) {
       int32_t colIndex = col.globalIndex();
@@ -29,6 +29,7 @@
 #include <Framework/Logger.h>
 #include <Framework/RunningWorkflowInfo.h>
 
+#include <TAxis.h>
 #include <TFile.h>
 #include <TFormula.h>
 #include <TH1.h>
@@ -36,6 +37,7 @@
 #include <TProfile.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
@@ -415,6 +417,11 @@ class MultModule
     TH1* mhMultSelCalib = nullptr;
     float mMCScalePars[6] = {0.0};
     TFormula* mMCScale = nullptr;
+    std::vector<float> mPercentiles; // content of mhMultSelCalib, including underflow and overflow
+    std::vector<double> mBinEdges;   // bin edges of mhMultSelCalib, empty for fixed bins
+    double mXmin = 0.;
+    double mXmax = 0.;
+    int mNbins = 0;
     explicit CalibrationInfo(std::string name)
       : name(name),
         mCalibrationStored(false),
@@ -439,6 +446,37 @@ class MultModule
       }
       return true;
     }
+    // flatten the calibration histogram, avoiding the TH1 lookups for each collision
+    void buildLookup()
+    {
+      const TAxis* axis = mhMultSelCalib->GetXaxis();
+      mNbins = axis->GetNbins();
+      mXmin = axis->GetXmin();
+      mXmax = axis->GetXmax();
+      mBinEdges.clear();
+      if (axis->GetXbins()->GetSize() > 0) {
+        mBinEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->GetSize());
+      }
+      mPercentiles.resize(mNbins + 2);
+      for (int i = 0; i < mNbins + 2; i++) {
+        mPercentiles[i] = mhMultSelCalib->GetBinContent(i);
+      }
+    }
+    // percentile of the bin found as in TAxis::FindFixBin
+    float getPercentile(double value) const
+    {
+      int bin = 0;
+      if (value < mXmin) {
+        bin = 0;
+      } else if (!(value < mXmax)) {
+        bin = mNbins + 1;
+      } else if (mBinEdges.empty()) {
+        bin = 1 + static_cast<int>(mNbins * (value - mXmin) / (mXmax - mXmin));
+      } else {
+        bin = std::upper_bound(mBinEdges.begin(), mBinEdges.end(), value) - mBinEdges.begin();
+      }
+      return mPercentiles[bin];
+    }
   };
 
   CalibrationInfo fv0aInfo = CalibrationInfo("FV0");
@@ -1239,6 +1277,7 @@ class MultModule
             }
             estimator.mCalibrationStored = true;
             estimator.isSane();
+            estimator.buildLookup();
           } else {
             LOGF(info, "Calibration information from %s for run %d not available, will fill this estimator with invalid values and continue (no crash).", estimator.name.c_str(), bc.runNumber());
           }
@@ -1316,7 +1355,7 @@ class MultModule
             scaledMultiplicity = scaleMC(multiplicity, estimator.mMCScalePars);
             LOGF(debug, "Unscaled %s multiplicity: %f, scaled %s multiplicity: %f", estimator.name.c_str(), multiplicity, estimator.name.c_str(), scaledMultiplicity);
           }
-          percentile = estimator.mhMultSelCalib->GetBinContent(estimator.mhMultSelCalib->FindFixBin(scaledMultiplicity));
+          percentile = estimator.getPercentile(scaledMultiplicity);
           if (assignOutOfRange)
             percentile = 100.5f;
         }
@@ -1351,7 +1390,8 @@ class MultModule
       }
 
       // populate centralities per BC
-      for (size_t ibc = 0; ibc < static_cast<size_t>(bcs.size()); ibc++) {
+      const bool bcCentralitiesEnabled = internalOpts.mEnabledTables[kBCCentFT0Ms] || internalOpts.mEnabledTables[kBCCentFT0As] || internalOpts.mEnabledTables[kBCCentFT0Cs];
+      for (size_t ibc = 0; bcCentralitiesEnabled && ibc < static_cast<size_t>(bcs.size()); ibc++) {
         float bcMultFT0A = 0;
         float bcMultFT0C = 0;
 
@@ -0,0 +1,469 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     benchmarkPid.cxx
+///
+/// \brief    Standalone throughput benchmark of the PID response code on a fixed sample of tracks
+///
+/// The track sample is read from a flat tree (e.g. produced from an AO2D with the branches listed in
+/// TrackSample) or generated with a fixed seed, so that the same tracks are replayed for every
+/// component. Each component is timed with its per-track path and with its batched or tabulated path:
+///   - TPC: expected signal, resolution and Nsigma, per track vs Response::GetNumberOfSigmaBatch
+///   - TOF: eta time shift, TGraph::Eval vs the table of TOFResoParamsV3, plus the expected times
+///   - TPC NN correction (if a network is given): whole-sample evalModel vs IO-bound batches
+///   - Bayesian PID: TPC/TOF likelihood and prior combination, track-major vs species-major batches
+/// One JSON object per measurement is written to the report file, e.g.
+///
+///   o2-bench-pid-throughput --input tracks.root --network pidTPC.onnx --output report.json
+///
+
+#include "Common/Core/PID/PIDTOF.h"
+#include "Common/Core/PID/TPCPIDResponse.h"
+#include "Tools/ML/model.h"
+
+#include <Framework/Logger.h>
+#include <Framework/PID.h>
+#include <ReconstructionDataFormats/PID.h>
+
+#include <TFile.h>
+#include <TGraph.h>
+#include <TTree.h>
+
+#include <boost/program_options.hpp> // IWYU pragma: keep
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bpo = boost::program_options;
+
+namespace
+{
+
+constexpr std::size_t NSpecies = o2::track::PID::NIDs;
+
+/// Structure of arrays of the track quantities used by the PID responses
+struct TrackSample {
+  std::vector<float> tpcInnerParam;
+  std::vector<float> tgl;
+  std::vector<float> signed1Pt;
+  std::vector<int16_t> tpcNClsFound;
+  std::vector<float> tpcSignal;
+  std::vector<long> multTPC;
+  std::vector<uint8_t> hasTPC;
+  std::vector<float> tofExpMom;
+  std::vector<float> length;
+  std::vector<float> tofSignal;
+  std::vector<float> eta;
+  std::vector<float> p;
+  std::vector<int16_t> sign;
+
+  std::size_t size() const { return tpcInnerParam.size(); }
+  void resize(const std::size_t n)
+  {
+    tpcInnerParam.resize(n);
+    tgl.resize(n);
+    signed1Pt.resize(n);
+    tpcNClsFound.resize(n);
+    tpcSignal.resize(n);
+    multTPC.resize(n);
+    hasTPC.resize(n);
+    tofExpMom.resize(n);
+    length.resize(n);
+    tofSignal.resize(n);
+    eta.resize(n);
+    p.resize(n);
+    sign.resize(n);
+  }
+};
+
+struct BenchmarkResult {
+  std::string component;
+  std::string path;
+  std::size_t nTracks = 0;
+  std::size_t iterations = 0;
+  double meanLatency = 0.; // microseconds per pass over the sample
+  double throughput = 0.;  // tracks per second
+  double checksum = 0.;    // sum of the outputs, to compare the paths and keep the computation alive
+};
+
+/// Generates a sample of tracks with realistic ranges, with the TPC signal of a random species
+void generateSample(TrackSample& sample, const std::size_t nTracks, const unsigned int seed, const o2::pid::tpc::Response& response)
+{
+  std::mt19937 generator(seed);
+  std::uniform_real_distribution<float> uniform(0.f, 1.f);
+  std::normal_distribution<float> gaus(0.f, 1.f);
+  std::uniform_int_distribution<int> species(o2::track::PID::Electron, o2::track::PID::Proton);
+  sample.resize(nTracks);
+  for (std::size_t i = 0; i < nTracks; ++i) {
+    const float pt = 0.1f + 5.f * uniform(generator) * uniform(generator);
+    sample.eta[i] = 1.6f * (uniform(generator) - 0.5f);
+    sample.tgl[i] = std::sinh(sample.eta[i]);
+    sample.sign[i] = uniform(generator) > 0.5f ? 1 : -1;
+    sample.signed1Pt[i] = sample.sign[i] / pt;
+    sample.p[i] = pt * std::sqrt(1.f + sample.tgl[i] * sample.tgl[i]);
+    sample.tpcInnerParam[i] = 0.98f * sample.p[i];
+    sample.tofExpMom[i] = 0.99f * sample.p[i];
+    sample.tpcNClsFound[i] = static_cast<int16_t>(60 + 99 * uniform(generator));
+    sample.multTPC[i] = static_cast<long>(5000 * uniform(generator));
+    sample.hasTPC[i] = uniform(generator) > 0.02f;
+    sample.length[i] = 370.f + 100.f * std::abs(sample.eta[i]);
+    const auto id = static_cast<o2::track::PID::ID>(species(generator));
+    const float expSignal = response.GetExpectedSignalFromValues(sample.tpcInnerParam[i], id);
+    sample.tpcSignal[i] = expSignal * (1.f + 0.07f * gaus(generator));
+    sample.tofSignal[i] = uniform(generator) > 0.4f ? o2::framework::pid::tof::MassToExpTime(sample.tofExpMom[i], sample.length[i], o2::track::pid_constants::sMasses2[id]) + 80.f * gaus(generator) : -999.f;
+  }
+}
+
+/// Reads the track sample from a flat tree with one branch per member of TrackSample
+bool readSample(TrackSample& sample, const std::string& fileName, const std::string& treeName, const std::size_t maxTracks)
+{
+  std::unique_ptr<TFile> file{TFile::Open(fileName.c_str(), "READ")};
+  if (!file || file->IsZombie()) {
+    LOG(error) << "Cannot open the track sample " << fileName;
+    return false;
+  }
+  auto* tree = file->Get<TTree>(treeName.c_str());
+  if (!tree) {
+    LOG(error) << "Cannot find the tree " << treeName << " in " << fileName;
+    return false;
+  }
+  float tpcInnerParam, tgl, signed1Pt, tpcSignal, tofExpMom, length, tofSignal, eta, p;
+  int16_t tpcNClsFound, sign;
+  long multTPC;
+  uint8_t hasTPC;
+  tree->SetBranchAddress("tpcInnerParam", &tpcInnerParam);
+  tree->SetBranchAddress("tgl", &tgl);
+  tree->SetBranchAddress("signed1Pt", &signed1Pt);
+  tree->SetBranchAddress("tpcNClsFound", &tpcNClsFound);
+  tree->SetBranchAddress("tpcSignal", &tpcSignal);
+  tree->SetBranchAddress("multTPC", &multTPC);
+  tree->SetBranchAddress("hasTPC", &hasTPC);
+  tree->SetBranchAddress("tofExpMom", &tofExpMom);
+  tree->SetBranchAddress("length", &length);
+  tree->SetBranchAddress("tofSignal", &tofSignal);
+  tree->SetBranchAddress("eta", &eta);
+  tree->SetBranchAddress("p", &p);
+  tree->SetBranchAddress("sign", &sign);
+  const std::size_t nTracks = std::min<std::size_t>(maxTracks, tree->GetEntries());
+  sample.resize(nTracks);
+  for (std::size_t i = 0; i < nTracks; ++i) {
+    tree->GetEntry(i);
+    sample.tpcInnerParam[i] = tpcInnerParam;
+    sample.tgl[i] = tgl;
+    sample.signed1Pt[i] = signed1Pt;
+    sample.tpcNClsFound[i] = tpcNClsFound;
+    sample.tpcSignal[i] = tpcSignal;
+    sample.multTPC[i] = multTPC;
+    sample.hasTPC[i] = hasTPC;
+    sample.tofExpMom[i] = tofExpMom;
+    sample.length[i] = length;
+    sample.tofSignal[i] = tofSignal;
+    sample.eta[i] = eta;
+    sample.p[i] = p;
+    sample.sign[i] = sign;
+  }
+  LOG(info) << "Read " << nTracks << " tracks from " << fileName;
+  return nTracks > 0;
+}
+
+/// Times the evaluation function over the full sample and fills the throughput
+template <typename F>
+void measure(F&& evaluate, const std::size_t iterations, BenchmarkResult& result)
+{
+  result.checksum = evaluate(); // warm up
+  double total = 0.;
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    evaluate();
+    total += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+  result.iterations = iterations;
+  result.meanLatency = total / iterations;
+  result.throughput = total > 0. ? 1.e6 * iterations * result.nTracks / total : 0.;
+}
+
+std::string toJson(const BenchmarkResult& result)
+{
+  std::stringstream ss;
+  ss << "{\"component\": \"" << result.component << "\", \"path\": \"" << result.path << "\", \"nTracks\": " << result.nTracks
+     << ", \"iterations\": " << result.iterations << ", \"meanLatencyUs\": " << result.meanLatency
+     << ", \"tracksPerSecond\": " << result.throughput << ", \"checksum\": " << result.checksum << "}";
+  return ss.str();
+}
+
+/// Default eta time shift graph, with the same number of points as the calibration objects
+std::unique_ptr<TGraph> makeTimeShiftGraph()
+{
+  auto graph = std::make_unique<TGraph>();
+  for (int i = 0; i < 40; ++i) {
+    const double eta = -1. + 2. * i / 39.;
+    graph->AddPoint(eta, 20. * eta * eta - 5. * eta);
+  }
+  return graph;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  bpo::options_description options("Allowed options");
+  options.add_options()(
+    "help,h", "Print this help")(
+    "input,i", bpo::value<std::string>()->default_value(""), "ROOT file with the flat tree of tracks, tracks are generated if empty")(
+    "tree", bpo::value<std::string>()->default_value("O2pidtracks"), "Name of the tree of tracks")(
+    "tracks,n", bpo::value<std::size_t>()->default_value(1000000), "Maximum number of tracks of the sample")(
+    "iterations", bpo::value<std::size_t>()->default_value(10), "Number of passes over the sample per measurement")(
+    "tpc-response", bpo::value<std::string>()->default_value(""), "ROOT file with the TPC Response object (default parametrisation if empty)")(
+    "network", bpo::value<std::string>()->default_value(""), "ONNX file of the TPC PID network, not benchmarked if empty")(
+    "network-batch-size", bpo::value<std::size_t>()->default_value(16384), "Batch size of the bound network evaluation")(
+    "seed", bpo::value<unsigned int>()->default_value(42), "Seed of the generated tracks")(
+    "output,o", bpo::value<std::string>()->default_value("pidBenchmark.json"), "Output report (one JSON object per line)");
+
+  bpo::variables_map arguments;
+  try {
+    bpo::store(parse_command_line(argc, argv, options), arguments);
+    bpo::notify(arguments);
+  } catch (const bpo::error& e) {
+    LOG(error) << e.what();
+    std::cout << options << std::endl;
+    return 1;
+  }
+  if (arguments.count("help")) {
+    std::cout << options << std::endl;
+    return 0;
+  }
+
+  o2::pid::tpc::Response response;
+  const auto responseFile = arguments["tpc-response"].as<std::string>();
+  if (!responseFile.empty()) {
+    std::unique_ptr<TFile> file{TFile::Open(responseFile.c_str(), "READ")};
+    auto* fileResponse = file ? file->Get<o2::pid::tpc::Response>("Response") : nullptr;
+    if (!fileResponse) {
+      LOG(fatal) << "Cannot read the TPC Response object from " << responseFile;
+    }
+    response = *fileResponse;
+  }
+
+  TrackSample sample;
+  const auto inputFile = arguments["input"].as<std::string>();
+  if (inputFile.empty()) {
+    generateSample(sample, arguments["tracks"].as<std::size_t>(), arguments["seed"].as<unsigned int>(), response);
+  } else if (!readSample(sample, inputFile, arguments["tree"].as<std::string>(), arguments["tracks"].as<std::size_t>())) {
+    return 1;
+  }
+  const std::size_t nTracks = sample.size();
+  const std::size_t iterations = std::max<std::size_t>(1, arguments["iterations"].as<std::size_t>());
+  const std::vector<o2::track::PID::ID> ids = {o2::track::PID::Electron, o2::track::PID::Muon, o2::track::PID::Pion,
+                                               o2::track::PID::Kaon, o2::track::PID::Proton, o2::track::PID::Deuteron,
+                                               o2::track::PID::Triton, o2::track::PID::Helium3, o2::track::PID::Alpha};
+
+  std::ofstream report(arguments["output"].as<std::string>());
+  std::vector<BenchmarkResult> results;
+  auto record = [&](BenchmarkResult& result) {
+    LOGP(info, "{} [{}]: {:.1f} us per pass over {} tracks, {:.3g} tracks/s (checksum {:.6g})",
+         result.component, result.path, result.meanLatency, result.nTracks, result.throughput, result.checksum);
+    report << toJson(result) << std::endl;
+    results.push_back(result);
+  };
+
+  // TPC Nsigma for all species
+  std::vector<float> nSigma(NSpecies * nTracks);
+  {
+    BenchmarkResult result{"tpcNSigma", "perTrack", nTracks};
+    measure([&]() {
+      double sum = 0.;
+      for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+        for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+          const float expSignal = response.GetExpectedSignalFromValues(sample.tpcInnerParam[iTrack], ids[iSpecies]);
+          const float expSigma = response.GetExpectedSigmaFromValues(sample.multTPC[iTrack], sample.tpcInnerParam[iTrack], sample.tgl[iTrack], sample.signed1Pt[iTrack], sample.tpcNClsFound[iTrack], ids[iSpecies]);
+          const bool isValid = sample.hasTPC[iTrack] && expSigma >= 0.f && expSignal >= 0.f;
+          nSigma[iSpecies * nTracks + iTrack] = isValid ? (sample.tpcSignal[iTrack] - expSignal) / expSigma : -999.f;
+          sum += nSigma[iSpecies * nTracks + iTrack];
+        }
+      }
+      return sum;
+    },
+            iterations, result);
+    record(result);
+  }
+  {
+    BenchmarkResult result{"tpcNSigma", "batched", nTracks};
+    measure([&]() {
+      response.GetNumberOfSigmaBatch(nTracks, sample.hasTPC.data(), sample.tpcInnerParam.data(), sample.tgl.data(), sample.signed1Pt.data(),
+                                     sample.tpcNClsFound.data(), sample.tpcSignal.data(), sample.multTPC.data(), ids, nSigma.data());
+      double sum = 0.;
+      for (std::size_t i = 0; i < ids.size() * nTracks; ++i) {
+        sum += nSigma[i];
+      }
+      return sum;
+    },
+            iterations, result);
+    record(result);
+  }
+
+  // TOF expected times with the eta time shift
+  auto timeShiftGraph = makeTimeShiftGraph();
+  o2::pid::tof::TOFResoParamsV3 tofParameters;
+  tofParameters.setTimeShiftParameters(timeShiftGraph.get(), true);
+  tofParameters.setTimeShiftParameters(timeShiftGraph.get(), false);
+  std::vector<float> expTimes(NSpecies * nTracks);
+  auto evaluateExpTimes = [&](auto&& timeShift) {
+    double sum = 0.;
+    for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+      const float massSquared = o2::track::pid_constants::sMasses2[ids[iSpecies]];
+      float* expTimesSpecies = expTimes.data() + iSpecies * nTracks;
+      for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+        expTimesSpecies[iTrack] = o2::framework::pid::tof::MassToExpTime(sample.tofExpMom[iTrack], sample.length[iTrack], massSquared) + timeShift(iTrack);
+        sum += expTimesSpecies[iTrack];
+      }
+    }
+    return sum;
+  };
+  {
+    BenchmarkResult result{"tofExpTime", "graphEval", nTracks};
+    measure([&]() { return evaluateExpTimes([&](const std::size_t iTrack) { return static_cast<float>(timeShiftGraph->Eval(sample.eta[iTrack])); }); }, iterations, result);
+    record(result);
+  }
+  {
+    BenchmarkResult result{"tofExpTime", "tabulated", nTracks};
+    measure([&]() { return evaluateExpTimes([&](const std::size_t iTrack) { return tofParameters.getTimeShift(sample.eta[iTrack], sample.sign[iTrack]); }); }, iterations, result);
+    record(result);
+  }
+
+  // TPC NN correction, with the input layout of the pidTPC module for the pion hypothesis
+  const auto networkFile = arguments["network"].as<std::string>();
+  if (!networkFile.empty()) {
+    o2::ml::OnnxModel network;
+    network.initModel(networkFile, false, 1);
+    const std::size_t nInputs = network.getNumInputNodes();
+    const std::size_t batchSize = std::min(nTracks, arguments["network-batch-size"].as<std::size_t>());
+    std::vector<float> networkInput(nTracks * nInputs, 0.f);
+    const float mass = o2::track::pid_constants::sMasses[o2::track::PID::Pion];
+    for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+      const std::array<float, 8> features = {sample.tpcInnerParam[iTrack], sample.tgl[iTrack], sample.signed1Pt[iTrack], mass,
+                                             sample.multTPC[iTrack] / 11000.f, std::sqrt(159.f / std::max<float>(sample.tpcNClsFound[iTrack], 1.f)), 0.f, 0.f};
+      std::copy_n(features.begin(), std::min(nInputs, features.size()), networkInput.begin() + iTrack * nInputs);
+    }
+    std::vector<float> networkOutput;
+    {
+      BenchmarkResult result{"tpcNetwork", "fullSample", nTracks};
+      measure([&]() {
+        network.evalModel(networkInput, networkOutput);
+        double sum = 0.;
+        for (const auto& value : networkOutput) {
+          sum += value;
+        }
+        return sum;
+      },
+              iterations, result);
+      record(result);
+    }
+    network.enableIoBinding(batchSize);
+    {
+      BenchmarkResult result{"tpcNetwork", "ioBound", nTracks};
+      measure([&]() {
+        double sum = 0.;
+        for (std::size_t first = 0; first < nTracks; first += batchSize) {
+          const std::size_t nRows = std::min(batchSize, nTracks - first);
+          std::copy_n(networkInput.begin() + first * nInputs, nRows * nInputs, network.getBoundInput());
+          const float* output = network.evalModelBound(nRows);
+          for (std::size_t iRow = 0; iRow < nRows * network.getNumOutputNodes(); ++iRow) {
+            sum += output[iRow];
+          }
+        }
+        return sum;
+      },
+              iterations, result);
+      record(result);
+    }
+  }
+
+  // Bayesian combination of the TPC and TOF likelihoods with flat priors, as done in the pidBayes task
+  constexpr float TOFResolution = 80.f;
+  const float prior = 1.f / ids.size();
+  std::vector<float> probabilities(NSpecies * nTracks);
+  {
+    BenchmarkResult result{"bayes", "perTrack", nTracks};
+    measure([&]() {
+      double sum = 0.;
+      std::array<double, NSpecies> probability{};
+      for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+        double norm = 0.;
+        for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+          const double tpcDelta = nSigma[iSpecies * nTracks + iTrack];
+          double likelihood = std::abs(tpcDelta) < 5. ? std::exp(-0.5 * tpcDelta * tpcDelta) : 0.;
+          if (sample.tofSignal[iTrack] > 0.f) {
+            const double tofDelta = (sample.tofSignal[iTrack] - expTimes[iSpecies * nTracks + iTrack]) / TOFResolution;
+            likelihood *= std::abs(tofDelta) < 5. ? std::exp(-0.5 * tofDelta * tofDelta) : 0.;
+          }
+          probability[iSpecies] = likelihood * prior;
+          norm += probability[iSpecies];
+        }
+        for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+          probabilities[iSpecies * nTracks + iTrack] = norm > 0. ? probability[iSpecies] / norm : prior;
+          sum += probabilities[iSpecies * nTracks + iTrack];
+        }
+      }
+      return sum;
+    },
+            iterations, result);
+    record(result);
+  }
+  {
+    BenchmarkResult result{"bayes", "speciesMajor", nTracks};
+    std::vector<float> norm(nTracks);
+    measure([&]() {
+      std::fill(norm.begin(), norm.end(), 0.f);
+      for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+        const float* tpcDelta = nSigma.data() + iSpecies * nTracks;
+        const float* expTimesSpecies = expTimes.data() + iSpecies * nTracks;
+        float* probabilitySpecies = probabilities.data() + iSpecies * nTracks;
+        for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+          float likelihood = std::abs(tpcDelta[iTrack]) < 5.f ? std::exp(-0.5f * tpcDelta[iTrack] * tpcDelta[iTrack]) : 0.f;
+          const float tofDelta = (sample.tofSignal[iTrack] - expTimesSpecies[iTrack]) / TOFResolution;
+          const float tofLikelihood = std::abs(tofDelta) < 5.f ? std::exp(-0.5f * tofDelta * tofDelta) : 0.f;
+          likelihood *= sample.tofSignal[iTrack] > 0.f ? tofLikelihood : 1.f;
+          probabilitySpecies[iTrack] = likelihood * prior;
+          norm[iTrack] += probabilitySpecies[iTrack];
+        }
+      }
+      double sum = 0.;
+      for (std::size_t iSpecies = 0; iSpecies < ids.size(); ++iSpecies) {
+        float* probabilitySpecies = probabilities.data() + iSpecies * nTracks;
+        for (std::size_t iTrack = 0; iTrack < nTracks; ++iTrack) {
+          probabilitySpecies[iTrack] = norm[iTrack] > 0.f ? probabilitySpecies[iTrack] / norm[iTrack] : prior;
+          sum += probabilitySpecies[iTrack];
+        }
+      }
+      return sum;
+    },
+            iterations, result);
+    record(result);
+  }
+
+  LOG(info) << "Wrote " << results.size() << " benchmark results to " << arguments["output"].as<std::string>();
+  return 0;
+} // main
@@ -23,6 +23,7 @@
 
 #include "Common/CCDB/ctpRateFetcher.h"
 #include "Common/Core/CollisionTypeHelper.h"
+#include "Common/Core/PID/PIDCalibrationService.h"
 #include "Common/Core/PID/TPCPIDResponse.h"
 #include "Common/Core/TableHelper.h"
 #include "Common/DataModel/PIDResponseTPC.h"
@@ -43,10 +44,13 @@
 #include <TMatrixDfwd.h>
 #include <TRandom.h>
 
+#include <algorithm>
+#include <array>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <future>
 #include <map>
 #include <memory>
 #include <ratio>
@@ -85,6 +89,10 @@ struct pidTPCProducts : o2::framework::ProducesGroup {
   o2::framework::Produces<o2::aod::pidTPCHe> tablePIDTinyHe;
   o2::framework::Produces<o2::aod::pidTPCAl> tablePIDTinyAl;
   o2::framework::Produces<o2::aod::mcTPCTuneOnData> tableTuneOnData;
+  // Compact inputs of the lazy Nsigma columns
+  o2::framework::Produces<o2::aod::pidTPCLazy> tablePIDLazy;
+  // Binned Nsigma of all mass hypotheses in one table
+  o2::framework::Produces<o2::aod::pidTPCPacked> tablePIDPacked;
 };
 
 struct pidTPCConfigurables : o2::framework::ConfigurableGroup {
@@ -102,6 +110,8 @@ struct pidTPCConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<std::string> networkPathCCDB{"networkPathCCDB", "Analysis/PID/TPC/ML", "Path on CCDB"};
   o2::framework::Configurable<bool> enableNetworkOptimizations{"enableNetworkOptimizations", 1, "(bool) If the neural network correction is used, this enables GraphOptimizationLevel::ORT_ENABLE_EXTENDED in the ONNX session"};
   o2::framework::Configurable<int> networkSetNumThreads{"networkSetNumThreads", 0, "Especially important for running on a SLURM cluster. Sets the number of threads used for execution."};
+  o2::framework::Configurable<int> networkBatchSize{"networkBatchSize", 16384, "Number of (track, mass hypothesis) pairs evaluated by the network in one call"};
+  o2::framework::Configurable<bool> networkAsyncEvaluation{"networkAsyncEvaluation", true, "(bool) Evaluate the network on a worker thread while the input of the next batch is prepared"};
   // Configuration flags to include and exclude particle hypotheses
   o2::framework::Configurable<int> savedEdxsCorrected{"savedEdxsCorrected", -1, {"Save table with corrected dE/dx calculated on the spot. 0: off, 1: on, -1: auto"}};
   o2::framework::Configurable<bool> useCorrecteddEdx{"useCorrecteddEdx", false, "(bool) If true, use corrected dEdx value in Nsigma calculation instead of the one in the AO2D"};
@@ -124,6 +134,8 @@ struct pidTPCConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<int> pidTinyTr{"pid-tiny-tr", -1, {"Produce PID information for the Triton mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   o2::framework::Configurable<int> pidTinyHe{"pid-tiny-he", -1, {"Produce PID information for the Helium3 mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
   o2::framework::Configurable<int> pidTinyAl{"pid-tiny-al", -1, {"Produce PID information for the Alpha mass hypothesis, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
+  o2::framework::Configurable<int> pidPacked{"pid-packed", -1, {"Produce the binned PID information of all mass hypotheses in a single table, overrides the automatic setup: the corresponding table can be set off (0) or on (1)"}};
+  o2::framework::Configurable<int> pidLazy{"pid-lazy", -1, {"Produce the compact inputs of the Nsigma columns evaluated on demand by the analysis tasks: the corresponding table can be set off (0) or on (1)"}};
   o2::framework::Configurable<int> enableTuneOnDataTable{"enableTuneOnDataTable", -1, {"Produce tuned dE/dx signal table for MC to be used as raw signal in other tasks (default -1, 'only if needed'"}};
   o2::framework::Configurable<int> useNetworkEl{"useNetworkEl", 1, {"Switch for applying neural network on the electron mass hypothesis (if network enabled) (set to 0 to disable)"}};
   o2::framework::Configurable<int> useNetworkMu{"useNetworkMu", 1, {"Switch for applying neural network on the muon mass hypothesis (if network enabled) (set to 0 to disable)"}};
@@ -208,7 +220,8 @@ class pidTPCModule
   o2::aod::pid::pidTPCConfigurables pidTPCopts;
 
   // TPC PID Response
-  o2::pid::tpc::Response* response{nullptr};
+  const o2::pid::tpc::Response* response{nullptr};
+  o2::pid::PIDCalibrationService::Handle<o2::pid::tpc::Response> responseHandle; // Response shared with the other tasks of the device, when taken from the CCDB
 
   // Network correction for TPC PID response
   ml::OnnxModel network;
@@ -329,6 +342,12 @@ class pidTPCModule
     enableFlag("He", pidTPCopts.pidTinyHe);
     enableFlag("Al", pidTPCopts.pidTinyAl);
 
+    enableFlag("Packed", pidTPCopts.pidPacked);
+    enableFlag("Lazy", pidTPCopts.pidLazy);
+    if (pidTPCopts.pidLazy.value == 1 && pidTPCopts.useNetworkCorrection) {
+      LOG(fatal) << "The lazy TPC Nsigma columns are evaluated with the parametrised response only and cannot be produced together with the network correction";
+    }
+
     if (metadataInfo.isMC()) {
       o2::common::core::enableFlagIfTableRequired(context, "mcTPCTuneOnData", pidTPCopts.enableTuneOnDataTable);
     }
@@ -360,7 +379,9 @@ class pidTPCModule
       LOGP(info, "Loading TPC response from file {}", fname.Data());
       try {
         std::unique_ptr<TFile> f(TFile::Open(fname, "READ"));
-        f->GetObject("Response", response);
+        o2::pid::tpc::Response* responseFromFile = nullptr;
+        f->GetObject("Response", responseFromFile);
+        response = responseFromFile;
       } catch (...) {
         LOGF(fatal, "Loading the TPC PID Response from file {} failed!", fname.Data());
       }
@@ -372,14 +393,12 @@ class pidTPCModule
       if (time != 0) {
         LOGP(info, "Initialising TPC PID response for fixed timestamp {} and reco pass {}:", time, pidTPCopts.recoPass.value);
         ccdb->setTimestamp(time);
-        response = ccdb->template getSpecific<o2::pid::tpc::Response>(path, time, metadata, &headers);
-        if (!response) {
-          LOGF(warning, "Unable to find TPC parametrisation for specified pass name - falling back to latest object");
-          response = ccdb->template getForTimeStamp<o2::pid::tpc::Response>(path, time, &headers);
-          if (!response) {
-            LOGF(fatal, "Unable to find any TPC object corresponding to timestamp {}!", time);
-          }
+        responseHandle = o2::pid::PIDCalibrationService::get<o2::pid::tpc::Response>(ccdb, path, time, metadata);
+        if (!responseHandle.object) {
+          LOGF(fatal, "Unable to find any TPC object corresponding to timestamp {}!", time);
         }
+        response = responseHandle.get();
+        headers = responseHandle.headers;
         networkVersion = headers["NN-Version"];
         LOG(info) << "Successfully retrieved TPC PID object from CCDB for timestamp " << time << ", period " << headers["LPMProductionTag"] << ", recoPass " << headers["RecoPassName"];
         metadata["RecoPassName"] = headers["RecoPassName"]; // Force pass number for NN request to match retrieved BB
@@ -449,21 +468,19 @@ class pidTPCModule
     if (pidTPCopts.autofetchNetworks) {
       const auto& bc = bcs.begin();
       // Initialise correct TPC response object before NN setup (for NCl normalisation)
-      if (useCCDBParam && pidTPCopts.ccdbTimestamp.value == 0 && !ccdb->isCachedObjectValid(pidTPCopts.ccdbPath.value, bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
+      if (useCCDBParam && pidTPCopts.ccdbTimestamp.value == 0 && !responseHandle.isValid(bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
         if (pidTPCopts.recoPass.value == "") {
           LOGP(info, "Retrieving latest TPC response object for timestamp {}:", bc.timestamp());
         } else {
           LOGP(info, "Retrieving TPC Response for timestamp {} and recoPass {}:", bc.timestamp(), pidTPCopts.recoPass.value);
         }
-        response = ccdb->template getSpecific<o2::pid::tpc::Response>(pidTPCopts.ccdbPath.value, bc.timestamp(), metadata, &headers);
-        networkVersion = headers["NN-Version"];
-        if (!response) {
-          LOGP(warning, "!! Could not find a valid TPC response object for specific pass name {}! Falling back to latest uploaded object.", metadata["RecoPassName"]);
-          response = ccdb->template getForTimeStamp<o2::pid::tpc::Response>(pidTPCopts.ccdbPath.value, bc.timestamp(), &headers);
-          if (!response) {
-            LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", bc.timestamp());
-          }
+        responseHandle = o2::pid::PIDCalibrationService::get<o2::pid::tpc::Response>(ccdb, pidTPCopts.ccdbPath.value, bc.timestamp(), metadata);
+        if (!responseHandle.object) {
+          LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", bc.timestamp());
         }
+        response = responseHandle.get();
+        headers = responseHandle.headers;
+        networkVersion = headers["NN-Version"];
         LOG(info) << "Successfully retrieved TPC PID object from CCDB for timestamp " << bc.timestamp() << ", period " << headers["LPMProductionTag"] << ", recoPass " << headers["RecoPassName"];
         metadata["RecoPassName"] = headers["RecoPassName"]; // Force pass number for NN request to match retrieved BB
         o2::parameters::GRPLHCIFData* grpo = ccdb->template getForTimeStamp<o2::parameters::GRPLHCIFData>(pidTPCopts.cfgPathGrpLhcIf.value, bc.timestamp());
@@ -497,21 +514,15 @@ class pidTPCModule
     }
 
     // Defining some network parameters
-    int input_dimensions = network.getNumInputNodes();
-    int output_dimensions = network.getNumOutputNodes();
-    const uint64_t track_prop_size = input_dimensions * size;
+    const int input_dimensions = network.getNumInputNodes();
+    const int output_dimensions = network.getNumOutputNodes();
     const uint64_t prediction_size = output_dimensions * size;
 
     network_prediction = std::vector<float>(prediction_size * 9); // For each mass hypotheses
     const float nNclNormalization = response->GetNClNormalization();
     float duration_network = 0;
 
-    std::vector<float> track_properties(track_prop_size);
-    uint64_t counter_track_props = 0;
-    int loop_counter = 0;
-
     // To load the Hadronic rate once for each collision
-    float hadronicRateBegin = 0.;
     std::vector<float> hadronicRateForCollision(collisions.size(), 0.0f);
     size_t i = 0;
     for (const auto& collision : collisions) {
@@ -523,15 +534,10 @@ class pidTPCModule
       }
       i++;
     }
-    auto bc = bcs.begin();
-    if (irSource.compare("") != 0) {
-      hadronicRateBegin = mRateFetcher.fetch(ccdb.service, bc.timestamp(), bc.runNumber(), irSource) * 1.e-3; // kHz
-    } else {
-      hadronicRateBegin = 0.0f;
-    }
 
-    // Filling a std::vector<float> to be evaluated by the network
-    // Evaluation on single tracks brings huge overhead: Thus evaluation is done on one large vector
+    // The tracks are evaluated in batches of fixed size: evaluation on single tracks brings huge overhead, evaluation of the whole table a large memory peak.
+    // Only the (track, mass hypothesis) pairs to which the correction is applied in makePidTables are sent to the network, i.e. tracks with a collision, above the beta-gamma cutoff and for the enabled species.
+    // The input is double buffered: the features of the next batch are prepared while the previous batch is evaluated by a worker thread.
     static constexpr int NParticleTypes = 9;
     constexpr int ExpectedInputDimensionsNNV2 = 7;
     constexpr int ExpectedInputDimensionsNNV3 = 8;
@@ -539,99 +545,126 @@ class pidTPCModule
     constexpr auto NetworkVersionV2 = "2";
     constexpr auto NetworkVersionV3 = "3";
     constexpr auto NetworkVersionV4 = "4";
-    for (int j = 0; j < NParticleTypes; j++) { // Loop over particle number for which network correction is used
-      for (auto const& trk : tracks) {
-        if (!trk.hasTPC()) {
+    const std::size_t batchSize = std::max(1, pidTPCopts.networkBatchSize.value);
+    if (!network.isIoBindingEnabled() || network.getMaxBatchSize() != batchSize) {
+      network.enableIoBinding(batchSize);
+    }
+    std::array<std::vector<float>, 2> batchInput;         // flattened features of the tracks of the batch
+    std::array<std::vector<uint64_t>, 2> batchPrediction; // position of the network output of each row of the batch in network_prediction
+    for (int iBuffer = 0; iBuffer < 2; iBuffer++) {
+      batchInput[iBuffer].resize(batchSize * input_dimensions);
+      batchPrediction[iBuffer].resize(batchSize);
+    }
+
+    auto evaluateBatch = [&](const int iBuffer, const std::size_t nRows) {
+      const auto start_network_eval = std::chrono::high_resolution_clock::now();
+      std::copy(batchInput[iBuffer].begin(), batchInput[iBuffer].begin() + nRows * input_dimensions, network.getBoundInput());
+      const float* output_network = network.evalModelBound(nRows);
+      if (!output_network) {
+        LOGF(fatal, "Evaluation of the TPC PID network failed!");
+      }
+      for (std::size_t iRow = 0; iRow < nRows; iRow++) {
+        for (int l = 0; l < output_dimensions; l++) {
+          network_prediction[batchPrediction[iBuffer][iRow] + l] = output_network[iRow * output_dimensions + l];
+        }
+      }
+      const auto stop_network_eval = std::chrono::high_resolution_clock::now();
+      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
+    };
+
+    std::future<void> pendingBatch; // batch being evaluated by the worker thread
+    auto waitForPendingBatch = [&pendingBatch]() {
+      if (pendingBatch.valid()) {
+        pendingBatch.get();
+      }
+    };
+    int currentBuffer = 0;
+    std::size_t nRowsInBatch = 0;
+    uint64_t count_tracks = 0;
+    uint64_t nEvaluatedRows = 0;
+    for (auto const& trk : tracks) {
+      if (!trk.hasTPC()) {
+        continue;
+      }
+      if (pidTPCopts.skipTPCOnly) {
+        if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
           continue;
         }
-        if (pidTPCopts.skipTPCOnly) {
-          if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
-            continue;
-          }
+      }
+      const uint64_t trackIndex = count_tracks++;
+      if (!trk.has_collision()) {
+        continue;
+      }
+      for (int j = 0; j < NParticleTypes; j++) { // Loop over particle number for which network correction is used
+        if (!speciesNetworkFlags[j] || trk.tpcInnerParam() / o2::track::pid_constants::sMasses[j] <= pidTPCopts.networkBetaGammaCutoff) {
+          continue;
         }
-        track_properties[counter_track_props] = trk.tpcInnerParam();
-        track_properties[counter_track_props + 1] = trk.tgl();
-        track_properties[counter_track_props + 2] = trk.signed1Pt();
-        track_properties[counter_track_props + 3] = o2::track::pid_constants::sMasses[j];
-        track_properties[counter_track_props + 4] = trk.has_collision() ? mults[trk.collisionId()] / 11000. : 1.;
-        track_properties[counter_track_props + 5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
+        float* track_properties = batchInput[currentBuffer].data() + nRowsInBatch * input_dimensions;
+        track_properties[0] = trk.tpcInnerParam();
+        track_properties[1] = trk.tgl();
+        track_properties[2] = trk.signed1Pt();
+        track_properties[3] = o2::track::pid_constants::sMasses[j];
+        track_properties[4] = mults[trk.collisionId()] / 11000.;
+        track_properties[5] = std::sqrt(nNclNormalization / trk.tpcNClsFound());
         if (input_dimensions == ExpectedInputDimensionsNNV2 && networkVersion == NetworkVersionV2) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
+          track_properties[6] = collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000.;
         }
-        if (input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision()) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
+        if ((input_dimensions == ExpectedInputDimensionsNNV3 && networkVersion == NetworkVersionV3) || (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4)) {
+          track_properties[6] = collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000.;
+          if (collsys == CollisionSystemType::kCollSyspp) {
+            track_properties[7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
           } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
+            track_properties[7] = hadronicRateForCollision[trk.collisionId()] / 50.;
           }
         }
-
         if (input_dimensions == ExpectedInputDimensionsNNV4 && networkVersion == NetworkVersionV4) {
-          track_properties[counter_track_props + 6] = trk.has_collision() ? collisions.iteratorAt(trk.collisionId()).ft0cOccupancyInTimeRange() / 60000. : 1.;
-          if (trk.has_collision()) {
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateForCollision[trk.collisionId()] / 50.;
-            }
-          } else {
-            // asign Hadronic Rate at beginning of run  if track does not belong to a collision
-            if (collsys == CollisionSystemType::kCollSyspp) {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 1500.;
-            } else {
-              track_properties[counter_track_props + 7] = hadronicRateBegin / 50.;
-            }
-          }
-          track_properties[counter_track_props + 8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
+          track_properties[8] = std::fmod(std::fmod(trk.phi(), 2 * M_PI) + 2 * M_PI, M_PI / 9.0);
         }
-        counter_track_props += input_dimensions;
-      }
+        batchPrediction[currentBuffer][nRowsInBatch] = output_dimensions * (trackIndex + size * j);
+        nRowsInBatch++;
 
-      auto start_network_eval = std::chrono::high_resolution_clock::now();
-      float* output_network = network.evalModel(track_properties);
-      auto stop_network_eval = std::chrono::high_resolution_clock::now();
-      duration_network += std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_eval - start_network_eval).count();
-      for (uint64_t k = 0; k < prediction_size; k += output_dimensions) {
-        for (int l = 0; l < output_dimensions; l++) {
-          network_prediction[k + l + prediction_size * loop_counter] = output_network[k + l];
+        if (nRowsInBatch == batchSize) { // Batch full: hand it to the worker thread and continue filling the other buffer
+          waitForPendingBatch();
+          if (pidTPCopts.networkAsyncEvaluation) {
+            pendingBatch = std::async(std::launch::async, evaluateBatch, currentBuffer, nRowsInBatch);
+          } else {
+            evaluateBatch(currentBuffer, nRowsInBatch);
+          }
+          nEvaluatedRows += nRowsInBatch;
+          currentBuffer = 1 - currentBuffer;
+          nRowsInBatch = 0;
         }
       }
-
-      counter_track_props = 0;
-      loop_counter += 1;
     }
-    track_properties.clear();
+    waitForPendingBatch();
+    if (nRowsInBatch > 0) {
+      evaluateBatch(currentBuffer, nRowsInBatch);
+      nEvaluatedRows += nRowsInBatch;
+    }
+    const uint64_t nEvaluations = std::max<uint64_t>(nEvaluatedRows, 1);
 
     auto stop_network_total = std::chrono::high_resolution_clock::now();
-    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / (size * 9) << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
-    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / (size * 9) << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
+    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval ONNX): " << duration_network / nEvaluations << "ns ; Total time (eval ONNX): " << duration_network / 1000000000 << " s";
+    LOG(debug) << "Neural Network for the TPC PID response correction: Time per track (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / nEvaluations << "ns ; Total time (eval + overhead): " << std::chrono::duration<float, std::ratio<1, 1000000000>>(stop_network_total - start_network_total).count() / 1000000000 << " s";
 
     return network_prediction;
   }
 
   //__________________________________________________
+  /// Fills the full and tiny tables of the given mass hypothesis
+  /// \return the Nsigma, to be stored in the packed table
   template <typename T, typename NSF, typename NST>
-  void makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const int64_t multTPC, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
+  float makePidTables(const int flagFull, NSF& tableFull, const int flagTiny, NST& tableTiny, const o2::track::PID::ID pid, const float tpcSignal, const T& trk, const int64_t multTPC, const std::vector<float>& network_prediction, const int& count_tracks, const int& tracksForNet_size)
   {
-    if (flagFull != 1 && flagTiny != 1) {
-      return;
+    if (flagFull != 1 && flagTiny != 1 && pidTPCopts.pidPacked.value != 1) {
+      return -999.f;
     }
     if (!trk.hasTPC() || tpcSignal < 0.f) {
       if (flagFull)
         tableFull(-999.f, -999.f);
       if (flagTiny)
         tableTiny(aod::pidtpc_tiny::binning::underflowBin);
-      return;
+      return -999.f;
     }
     if (pidTPCopts.skipTPCOnly) {
       if (!trk.hasITS() && !trk.hasTRD() && !trk.hasTOF()) {
@@ -639,7 +672,7 @@ class pidTPCModule
           tableFull(-999.f, -999.f);
         if (flagTiny)
           tableTiny(aod::pidtpc_tiny::binning::underflowBin);
-        return;
+        return -999.f;
       }
     }
     auto expSignal = response->GetExpectedSignal(trk, pid);
@@ -649,7 +682,7 @@ class pidTPCModule
         tableFull(-999.f, -999.f);
       if (flagTiny)
         tableTiny(aod::pidtpc_tiny::binning::underflowBin);
-      return;
+      return -999.f;
     }
 
     float nSigma = -999.f;
@@ -683,6 +716,7 @@ class pidTPCModule
       tableFull(expSigma, nSigma);
     if (flagTiny)
       aod::pidtpc_tiny::binning::packInTable(nSigma, tableTiny);
+    return nSigma;
   };
 
   //__________________________________________________
@@ -746,6 +780,9 @@ class pidTPCModule
     reserveTable(pidTPCopts.pidTinyHe, products.tablePIDTinyHe);
     reserveTable(pidTPCopts.pidTinyAl, products.tablePIDTinyAl);
 
+    reserveTable(pidTPCopts.pidPacked, products.tablePIDPacked);
+    reserveTable(pidTPCopts.pidLazy, products.tablePIDLazy);
+
     const uint64_t tracksForNet_size = (pidTPCopts.skipTPCOnly) ? totalTPCnotStandalone : totalTPCtracks;
     std::vector<float> network_prediction;
 
@@ -874,20 +911,18 @@ class pidTPCModule
       }
 
       const auto& bc = trk.has_collision() ? cols.rawIteratorAt(trk.collisionId()).template bc_as<aod::BCsWithTimestamps>() : bcs.begin();
-      if (useCCDBParam && pidTPCopts.ccdbTimestamp.value == 0 && !ccdb->isCachedObjectValid(pidTPCopts.ccdbPath.value, bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
+      if (useCCDBParam && pidTPCopts.ccdbTimestamp.value == 0 && !responseHandle.isValid(bc.timestamp())) { // Updating parametrisation only if the initial timestamp is 0
         if (pidTPCopts.recoPass.value == "") {
           LOGP(info, "Retrieving latest TPC response object for timestamp {}:", bc.timestamp());
         } else {
           LOGP(info, "Retrieving TPC Response for timestamp {} and recoPass {}:", bc.timestamp(), pidTPCopts.recoPass.value);
         }
-        response = ccdb->template getSpecific<o2::pid::tpc::Response>(pidTPCopts.ccdbPath.value, bc.timestamp(), metadata, &headers);
-        if (!response) {
-          LOGP(warning, "!! Could not find a valid TPC response object for specific pass name {}! Falling back to latest uploaded object.", metadata["RecoPassName"]);
-          response = ccdb->template getForTimeStamp<o2::pid::tpc::Response>(pidTPCopts.ccdbPath.value, bc.timestamp(), &headers);
-          if (!response) {
-            LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", bc.timestamp());
-          }
+        responseHandle = o2::pid::PIDCalibrationService::get<o2::pid::tpc::Response>(ccdb, pidTPCopts.ccdbPath.value, bc.timestamp(), metadata);
+        if (!responseHandle.object) {
+          LOGP(fatal, "Could not find ANY TPC response object for the timestamp {}!", bc.timestamp());
         }
+        response = responseHandle.get();
+        headers = responseHandle.headers;
         LOG(info) << "Successfully retrieved TPC PID object from CCDB for timestamp " << bc.timestamp() << ", period " << headers["LPMProductionTag"] << ", recoPass " << headers["RecoPassName"];
         o2::parameters::GRPLHCIFData* grpo = ccdb->template getForTimeStamp<o2::parameters::GRPLHCIFData>(pidTPCopts.cfgPathGrpLhcIf.value, bc.timestamp());
         if (grpo) {
@@ -947,19 +982,32 @@ class pidTPCModule
         }
       }
 
+      if (pidTPCopts.pidLazy.value == 1) {
+        const bool isSkipped = !trk.hasTPC() || (pidTPCopts.skipTPCOnly && !trk.hasITS() && !trk.hasTRD() && !trk.hasTOF());
+        products.tablePIDLazy(isSkipped ? -999.f : tpcSignalToEvaluatePID, static_cast<int>(multTPC));
+      }
+
       auto makePidTablesDefault = [&trk, &tpcSignalToEvaluatePID, &multTPC, &network_prediction, &count_tracks, &tracksForNet_size, this](const int flagFull, auto& tableFull, const int flagTiny, auto& tableTiny, const o2::track::PID::ID pid) {
-        this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, tpcSignalToEvaluatePID, trk, multTPC, network_prediction, count_tracks, tracksForNet_size);
+        return this->makePidTables(flagFull, tableFull, flagTiny, tableTiny, pid, tpcSignalToEvaluatePID, trk, multTPC, network_prediction, count_tracks, tracksForNet_size);
       };
 
-      makePidTablesDefault(pidTPCopts.pidFullEl, products.tablePIDFullEl, pidTPCopts.pidTinyEl, products.tablePIDTinyEl, o2::track::PID::Electron);
-      makePidTablesDefault(pidTPCopts.pidFullMu, products.tablePIDFullMu, pidTPCopts.pidTinyMu, products.tablePIDTinyMu, o2::track::PID::Muon);
-      makePidTablesDefault(pidTPCopts.pidFullPi, products.tablePIDFullPi, pidTPCopts.pidTinyPi, products.tablePIDTinyPi, o2::track::PID::Pion);
-      makePidTablesDefault(pidTPCopts.pidFullKa, products.tablePIDFullKa, pidTPCopts.pidTinyKa, products.tablePIDTinyKa, o2::track::PID::Kaon);
-      makePidTablesDefault(pidTPCopts.pidFullPr, products.tablePIDFullPr, pidTPCopts.pidTinyPr, products.tablePIDTinyPr, o2::track::PID::Proton);
-      makePidTablesDefault(pidTPCopts.pidFullDe, products.tablePIDFullDe, pidTPCopts.pidTinyDe, products.tablePIDTinyDe, o2::track::PID::Deuteron);
-      makePidTablesDefault(pidTPCopts.pidFullTr, products.tablePIDFullTr, pidTPCopts.pidTinyTr, products.tablePIDTinyTr, o2::track::PID::Triton);
-      makePidTablesDefault(pidTPCopts.pidFullHe, products.tablePIDFullHe, pidTPCopts.pidTinyHe, products.tablePIDTinyHe, o2::track::PID::Helium3);
-      makePidTablesDefault(pidTPCopts.pidFullAl, products.tablePIDFullAl, pidTPCopts.pidTinyAl, products.tablePIDTinyAl, o2::track::PID::Alpha);
+      std::array<float, 9> nSigmas;
+      nSigmas[0] = makePidTablesDefault(pidTPCopts.pidFullEl, products.tablePIDFullEl, pidTPCopts.pidTinyEl, products.tablePIDTinyEl, o2::track::PID::Electron);
+      nSigmas[1] = makePidTablesDefault(pidTPCopts.pidFullMu, products.tablePIDFullMu, pidTPCopts.pidTinyMu, products.tablePIDTinyMu, o2::track::PID::Muon);
+      nSigmas[2] = makePidTablesDefault(pidTPCopts.pidFullPi, products.tablePIDFullPi, pidTPCopts.pidTinyPi, products.tablePIDTinyPi, o2::track::PID::Pion);
+      nSigmas[3] = makePidTablesDefault(pidTPCopts.pidFullKa, products.tablePIDFullKa, pidTPCopts.pidTinyKa, products.tablePIDTinyKa, o2::track::PID::Kaon);
+      nSigmas[4] = makePidTablesDefault(pidTPCopts.pidFullPr, products.tablePIDFullPr, pidTPCopts.pidTinyPr, products.tablePIDTinyPr, o2::track::PID::Proton);
+      nSigmas[5] = makePidTablesDefault(pidTPCopts.pidFullDe, products.tablePIDFullDe, pidTPCopts.pidTinyDe, products.tablePIDTinyDe, o2::track::PID::Deuteron);
+      nSigmas[6] = makePidTablesDefault(pidTPCopts.pidFullTr, products.tablePIDFullTr, pidTPCopts.pidTinyTr, products.tablePIDTinyTr, o2::track::PID::Triton);
+      nSigmas[7] = makePidTablesDefault(pidTPCopts.pidFullHe, products.tablePIDFullHe, pidTPCopts.pidTinyHe, products.tablePIDTinyHe, o2::track::PID::Helium3);
+      nSigmas[8] = makePidTablesDefault(pidTPCopts.pidFullAl, products.tablePIDFullAl, pidTPCopts.pidTinyAl, products.tablePIDTinyAl, o2::track::PID::Alpha);
+
+      if (pidTPCopts.pidPacked.value == 1) {
+        using Binning = aod::pidtpc_tiny::binning;
+        products.tablePIDPacked(Binning::packValue(nSigmas[0]), Binning::packValue(nSigmas[1]), Binning::packValue(nSigmas[2]),
+                                Binning::packValue(nSigmas[3]), Binning::packValue(nSigmas[4]), Binning::packValue(nSigmas[5]),
+                                Binning::packValue(nSigmas[6]), Binning::packValue(nSigmas[7]), Binning::packValue(nSigmas[8]));
+      }
 
       if (trk.hasTPC() && (!pidTPCopts.skipTPCOnly || trk.hasITS() || trk.hasTRD() || trk.hasTOF())) {
         count_tracks++; // Increment network track counter only if track has TPC, and (not skipping TPConly) or (is not TPConly)
@@ -0,0 +1,284 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file SharedCCDBCache.h
+/// \brief Process-wide cache of the CCDB objects, shared by all the tasks of a device
+/// \author ALICE
+///
+/// The objects are deduplicated by type, path and metadata and handed out as shared read-only copies, which are
+/// fetched again only when the requested timestamp leaves the validity interval of the cached one. The objects
+/// declared with declare() are retrieved in parallel by prefetchRun() at the start of a new run, each worker thread
+/// using its own CCDB API instance, so that the run transitions do not serialise the CCDB round trips.
+
+#ifndef COMMON_TOOLS_SHAREDCCDBCACHE_H_
+#define COMMON_TOOLS_SHAREDCCDBCACHE_H_
+
+#include <CCDB/BasicCCDBManager.h>
+#include <CCDB/CcdbApi.h>
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <future>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+namespace common
+{
+
+class SharedCCDBCache
+{
+ public:
+  /// Read-only handle to a shared CCDB object
+  template <typename T>
+  struct Handle {
+    std::shared_ptr<const T> object = nullptr;  /// Shared copy of the object
+    int64_t validFrom = 0;                      /// Start of the validity interval of the object (ms)
+    int64_t validUntil = -1;                    /// End of the validity interval of the object (ms)
+    std::map<std::string, std::string> headers; /// CCDB headers of the object
+
+    bool isValid(const int64_t timestamp) const { return object && timestamp >= validFrom && timestamp <= validUntil; }
+    const T* get() const { return object.get(); }
+  };
+
+  /// Get the object valid for a timestamp, fetched from the CCDB only if no task of the device did it before
+  /// \param ccdb CCDB manager used in case the object has to be fetched
+  /// \param path CCDB path of the object
+  /// \param timestamp timestamp for which the object is requested
+  /// \param metadata metadata of the CCDB query
+  /// \param fallbackToLatest if no object matches the metadata, take the object valid at the timestamp without metadata
+  /// \return handle to the shared object, with a null object if not found
+  template <typename T, typename TCCDB>
+  static Handle<T> get(TCCDB& ccdb, const std::string& path, const int64_t timestamp, const std::map<std::string, std::string>& metadata = {}, const bool fallbackToLatest = false)
+  {
+    const std::string key = getKey<T>(path, metadata);
+    std::lock_guard<std::mutex> lock(mutex());
+    auto& entries = registry<T>();
+    auto entry = entries.find(key);
+    if (entry != entries.end() && entry->second.isValid(timestamp)) {
+      nHits()++;
+      return entry->second;
+    }
+
+    nFetches()++;
+    Handle<T> handle;
+    const T* object = ccdb->template getSpecific<T>(path, timestamp, metadata, &handle.headers);
+    if (!object && fallbackToLatest && !metadata.empty()) {
+      LOGP(warning, "Could not find the CCDB object {} for the requested metadata, falling back to the latest object for timestamp {}", path, timestamp);
+      handle.headers.clear();
+      object = ccdb->template getForTimeStamp<T>(path, timestamp, &handle.headers);
+    }
+    if (!object) {
+      return handle;
+    }
+    handle.object = std::make_shared<const T>(*object);
+    setValidity(handle, timestamp);
+    LOGP(info, "Shared CCDB object {} for timestamp {} valid in [{}, {}] ({} fetches, {} reused)", path, timestamp, handle.validFrom, handle.validUntil, nFetches(), nHits());
+    entries[key] = handle;
+    return handle;
+  }
+
+  /// Get the object valid at the start of a run, as BasicCCDBManager::getForRun
+  /// \param ccdb CCDB manager used in case the object has to be fetched
+  /// \param path CCDB path of the object
+  /// \param runNumber run number
+  /// \param setRunMetadata add the run number to the metadata of the query
+  template <typename T, typename TCCDB>
+  static Handle<T> getForRun(TCCDB& ccdb, const std::string& path, const int runNumber, const bool setRunMetadata = false)
+  {
+    const auto runDuration = ccdb->getRunDuration(runNumber);
+    return get<T>(ccdb, path, runDuration.first, getRunMetadata(runNumber, setRunMetadata));
+  }
+
+  /// Register an object not coming from the CCDB (e.g. from a local file), valid for all timestamps
+  /// \param name name of the object, used as its path
+  template <typename T>
+  static Handle<T> set(const std::string& name, const T& object)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    Handle<T> handle;
+    handle.object = std::make_shared<const T>(object);
+    handle.validFrom = 0;
+    handle.validUntil = std::numeric_limits<int64_t>::max();
+    registry<T>()[getKey<T>(name, {})] = handle;
+    return handle;
+  }
+
+  /// Declare an object retrieved by prefetchRun() at the start of each new run
+  /// \param path CCDB path of the object
+  /// \param setRunMetadata add the run number to the metadata of the query
+  template <typename T>
+  static void declare(const std::string& path, const bool setRunMetadata = false)
+  {
+    std::lock_guard<std::mutex> lock(mutex());
+    auto& requests = prefetchRequests();
+    const std::string name = std::string(typeid(T).name()) + ":" + path + (setRunMetadata ? ";run" : "");
+    if (std::find_if(requests.begin(), requests.end(), [&name](const auto& request) { return request.name == name; }) != requests.end()) {
+      return;
+    }
+    requests.push_back({name, [path, setRunMetadata](o2::ccdb::CcdbApi& api, const int64_t timestamp, const int runNumber) {
+                          const auto metadata = getRunMetadata(runNumber, setRunMetadata);
+                          Handle<T> handle;
+                          T* object = api.retrieveFromTFileAny<T>(path, metadata, timestamp, &handle.headers);
+                          if (!object) {
+                            LOGP(warning, "Could not prefetch the CCDB object {} for run {}", path, runNumber);
+                            return;
+                          }
+                          handle.object = std::shared_ptr<const T>(object);
+                          setValidity(handle, timestamp);
+                          std::lock_guard<std::mutex> lock(mutex());
+                          registry<T>()[getKey<T>(path, metadata)] = handle;
+                        }});
+  }
+
+  /// Retrieve in parallel all the declared objects valid at the start of a run, once per run
+  /// \param url URL of the CCDB
+  /// \param runNumber run number
+  /// \param nThreads number of worker threads, each with its own CCDB API instance
+  static void prefetchRun(const std::string& url, const int runNumber, const int nThreads)
+  {
+    std::vector<PrefetchRequest> requests;
+    {
+      std::lock_guard<std::mutex> lock(mutex());
+      if (lastPrefetchedRun() == runNumber) {
+        return;
+      }
+      lastPrefetchedRun() = runNumber;
+      requests = prefetchRequests();
+    }
+    if (requests.empty()) {
+      return;
+    }
+
+    o2::ccdb::CcdbApi api;
+    api.init(url);
+    const int64_t timestamp = o2::ccdb::BasicCCDBManager::getRunDuration(api, runNumber, false).first;
+    if (timestamp < 0) {
+      LOGP(warning, "Could not get the duration of run {}, skipping the prefetch of the CCDB objects", runNumber);
+      return;
+    }
+
+    std::atomic<std::size_t> nextRequest{0};
+    auto worker = [&]() {
+      o2::ccdb::CcdbApi workerApi;
+      workerApi.init(url);
+      for (std::size_t iRequest = nextRequest++; iRequest < requests.size(); iRequest = nextRequest++) {
+        requests[iRequest].fetch(workerApi, timestamp, runNumber);
+      }
+    };
+    std::vector<std::future<void>> workers;
+    const int nWorkers = std::clamp(nThreads, 1, static_cast<int>(requests.size()));
+    for (int iWorker = 1; iWorker < nWorkers; ++iWorker) {
+      workers.push_back(std::async(std::launch::async, worker));
+    }
+    worker();
+    for (auto& result : workers) {
+      result.get();
+    }
+    LOGP(info, "Prefetched {} CCDB objects for run {} with {} threads", requests.size(), runNumber, nWorkers);
+  }
+
+  static uint64_t getNFetches() { return nFetches(); }
+  static uint64_t getNHits() { return nHits(); }
+
+ private:
+  struct PrefetchRequest {
+    std::string name;                                                        /// type and path of the object
+    std::function<void(o2::ccdb::CcdbApi&, const int64_t, const int)> fetch; /// retrieve the object and store it in the registry
+  };
+
+  template <typename T>
+  static std::string getKey(const std::string& path, const std::map<std::string, std::string>& metadata)
+  {
+    std::string key = std::string(typeid(T).name()) + ":" + path;
+    for (const auto& [name, value] : metadata) {
+      key += ";" + name + "=" + value;
+    }
+    return key;
+  }
+
+  static std::map<std::string, std::string> getRunMetadata(const int runNumber, const bool setRunMetadata)
+  {
+    std::map<std::string, std::string> metadata;
+    if (setRunMetadata) {
+      metadata["runNumber"] = std::to_string(runNumber);
+    }
+    return metadata;
+  }
+
+  template <typename T>
+  static void setValidity(Handle<T>& handle, const int64_t timestamp)
+  {
+    handle.validFrom = getHeader(handle.headers, "Valid-From", timestamp);
+    handle.validUntil = getHeader(handle.headers, "Valid-Until", timestamp);
+  }
+
+  template <typename T>
+  static std::unordered_map<std::string, Handle<T>>& registry()
+  {
+    static std::unordered_map<std::string, Handle<T>> entries;
+    return entries;
+  }
+
+  static std::vector<PrefetchRequest>& prefetchRequests()
+  {
+    static std::vector<PrefetchRequest> requests;
+    return requests;
+  }
+
+  static std::mutex& mutex()
+  {
+    static std::mutex m;
+    return m;
+  }
+  static int& lastPrefetchedRun()
+  {
+    static int run = -1;
+    return run;
+  }
+  static uint64_t& nFetches()
+  {
+    static uint64_t n = 0;
+    return n;
+  }
+  static uint64_t& nHits()
+  {
+    static uint64_t n = 0;
+    return n;
+  }
+
+  static int64_t getHeader(const std::map<std::string, std::string>& headers, const std::string& name, const int64_t defaultValue)
+  {
+    const auto header = headers.find(name);
+    if (header == headers.end() || header->second.empty()) {
+      return defaultValue;
+    }
+    return std::strtoll(header->second.c_str(), nullptr, 10);
+  }
+};
+
+} // namespace common
+} // namespace o2
+
+#endif // COMMON_TOOLS_SHAREDCCDBCACHE_H_
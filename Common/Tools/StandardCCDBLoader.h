@@ -16,6 +16,8 @@
 #ifndef COMMON_TOOLS_STANDARDCCDBLOADER_H_
 #define COMMON_TOOLS_STANDARDCCDBLOADER_H_
 
+#include "Common/Tools/SharedCCDBCache.h"
+
 #include <DataFormatsCalibration/MeanVertexObject.h>
 #include <DataFormatsParameters/GRPMagField.h>
 #include <DataFormatsParameters/GRPObject.h>
@@ -46,6 +48,8 @@ struct StandardCCDBLoaderConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<std::string> grpmagPath{"grpmagPath", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object"};
   o2::framework::Configurable<std::string> grpPath{"grpPath", "GLO/GRP/GRP", "Path of the grp file"};
   o2::framework::Configurable<std::string> mVtxPath{"mVtxPath", "GLO/Calib/MeanVertex", "Path of the mean vertex file"};
+  o2::framework::Configurable<bool> useSharedCache{"useSharedCache", true, "Share the GRPMagField and mean vertex objects with the other tasks of the device"};
+  o2::framework::Configurable<int> prefetchThreads{"prefetchThreads", 0, "Number of threads prefetching the shared CCDB objects at the start of each run (0: no prefetch)"};
 };
 
 class StandardCCDBLoader
@@ -61,7 +65,7 @@ class StandardCCDBLoader
 
   // commonly needed objects
   const o2::dataformats::MeanVertexObject* mMeanVtx = nullptr;
-  o2::parameters::GRPMagField* grpmag = nullptr;
+  const o2::parameters::GRPMagField* grpmag = nullptr;
   o2::base::MatLayerCylSet* lut = nullptr;
   int runNumber = -1;
 
@@ -83,7 +87,20 @@ class StandardCCDBLoader
       return;
     }
 
-    grpmag = ccdb->template getForRun<o2::parameters::GRPMagField>(cGroup.grpmagPath.value, currentRunNumber);
+    if (cGroup.useSharedCache.value) {
+      if (cGroup.prefetchThreads.value > 0) {
+        SharedCCDBCache::declare<o2::parameters::GRPMagField>(cGroup.grpmagPath.value);
+        if (getMeanVertex) {
+          SharedCCDBCache::declare<o2::dataformats::MeanVertexObject>(cGroup.mVtxPath.value);
+        }
+        SharedCCDBCache::prefetchRun(cGroup.ccdburl.value, currentRunNumber, cGroup.prefetchThreads.value);
+      }
+      // keep the shared copies alive as long as this loader uses them
+      grpmagHandle = SharedCCDBCache::getForRun<o2::parameters::GRPMagField>(ccdb, cGroup.grpmagPath.value, currentRunNumber);
+      grpmag = grpmagHandle.get();
+    } else {
+      grpmag = ccdb->template getForRun<o2::parameters::GRPMagField>(cGroup.grpmagPath.value, currentRunNumber);
+    }
     if (grpmag) {
       LOG(info) << "Setting global propagator magnetic field to current " << grpmag->getL3Current() << " A for run " << currentRunNumber << " from its GRPMagField CCDB object";
       o2::base::Propagator::initFieldFromGRP(grpmag);
@@ -97,7 +114,10 @@ class StandardCCDBLoader
       }
       o2::base::Propagator::initFieldFromGRP(grpo);
     }
-    if (getMeanVertex) {
+    if (getMeanVertex && cGroup.useSharedCache.value) {
+      meanVertexHandle = SharedCCDBCache::getForRun<o2::dataformats::MeanVertexObject>(ccdb, cGroup.mVtxPath.value, currentRunNumber);
+      mMeanVtx = meanVertexHandle.get();
+    } else if (getMeanVertex) {
       // only try this if explicitly requested
       mMeanVtx = ccdb->template getForRun<o2::dataformats::MeanVertexObject>(cGroup.mVtxPath.value, currentRunNumber);
     } else {
@@ -116,6 +136,10 @@ class StandardCCDBLoader
 
     runNumber = currentRunNumber;
   }
+
+ private:
+  SharedCCDBCache::Handle<o2::parameters::GRPMagField> grpmagHandle;
+  SharedCCDBCache::Handle<o2::dataformats::MeanVertexObject> meanVertexHandle;
 };
 
 } // namespace common
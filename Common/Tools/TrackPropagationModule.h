@@ -22,6 +22,7 @@
 #include "Common/Tools/TrackTuner.h"
 
 #include <CommonConstants/GeomConstants.h>
+#include <CommonConstants/MathConstants.h>
 #include <DetectorsBase/Propagator.h>
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
@@ -39,11 +40,15 @@
 #include <TH1.h>
 #include <TH2.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstdint>
 #include <cstdlib>
 #include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 //__________________________________________
 // track propagation module
@@ -73,6 +78,12 @@ struct TrackPropagationProducts : o2::framework::ProducesGroup {
 struct TrackPropagationConfigurables : o2::framework::ConfigurableGroup {
   std::string prefix = "trackPropagation";
   o2::framework::Configurable<float> minPropagationRadius{"minPropagationDistance", o2::constants::geom::XTPCInnerRef + 0.1, "Only tracks which are at a smaller radius will be propagated, defaults to TPC inner wall"};
+  // lazy propagation: only the tracks passing the prefilter are propagated, the others are stored at the innermost update with dummy DCAs
+  o2::framework::Configurable<bool> propagateOnlyPrefiltered{"propagateOnlyPrefiltered", false, "Propagate to the PV only the tracks passing the prefilter"};
+  o2::framework::Configurable<float> prefilterMinPt{"prefilterMinPt", 0.f, "Prefilter: minimum pT at the innermost update (GeV/c)"};
+  o2::framework::Configurable<float> prefilterMaxAbsEta{"prefilterMaxAbsEta", 10.f, "Prefilter: maximum |eta| at the innermost update"};
+  o2::framework::Configurable<int> prefilterMinITSNCls{"prefilterMinITSNCls", 0, "Prefilter: minimum number of ITS clusters"};
+  o2::framework::Configurable<int> prefilterMinTPCNClsFound{"prefilterMinTPCNClsFound", 0, "Prefilter: minimum number of found TPC clusters"};
   // for TrackTuner only (MC smearing)
   o2::framework::Configurable<bool> useTrackTuner{"useTrackTuner", false, "Apply track tuner corrections to MC"};
   o2::framework::Configurable<bool> useTrkPid{"useTrkPid", false, "use pid in tracking"};
@@ -101,11 +112,14 @@ class TrackPropagationModule
   std::shared_ptr<TH1> trackTunedTracks;
 
   // Running variables
-  std::array<float, 2> mDcaInfo{};
-  o2::dataformats::DCA mDcaInfoCov;
   o2::dataformats::VertexBase mVtx;
-  o2::track::TrackParametrization<float> mTrackPar;
-  o2::track::TrackParametrizationWithError<float> mTrackParCov;
+  std::vector<o2::track::TrackParametrization<float>> mTrackParBuffer;             // parameters of the tracks of the dataframe
+  std::vector<o2::track::TrackParametrizationWithError<float>> mTrackParCovBuffer; // parameters with covariance of the tracks of the dataframe
+  std::vector<std::array<float, 2>> mDcaInfoBuffer;                                // DCAs of the tracks of the dataframe
+  std::vector<o2::dataformats::DCA> mDcaInfoCovBuffer;                             // DCAs with covariance of the tracks of the dataframe
+  std::vector<uint8_t> mTrackTypeBuffer;                                           // track types after the propagation
+  std::vector<double> mQ2OverPtBuffer;                                             // Q/Pt modified by the track tuner
+  std::vector<std::pair<uint32_t, int64_t>> mPropagationOrder;                     // (phi, eta) cell and index of the tracks to be propagated
   bool autoDetectDcaCalib = false; // track tuner setting
 
   template <typename TConfigurableGroup, typename TInitContext, typename THistoRegistry>
@@ -210,6 +224,32 @@ class TrackPropagationModule
     registry.template add<TH2>("hDCAzVsPtMC", "hDCAzVsPtMC", o2::framework::HistType::kTH2F, {axisBinsDCA, cGroup.axisPtQA});
   }
 
+  /// (phi, eta) cell of a track at the innermost update, used to group the propagations going through the same material LUT cells
+  static uint32_t getPropagationCell(const o2::track::TrackParametrization<float>& trackPar)
+  {
+    constexpr int NPhiCells = 36;
+    constexpr int NEtaCells = 20;
+    constexpr float MaxAbsEta = 2.f;
+    const int phiCell = std::clamp(static_cast<int>(trackPar.getPhi() / o2::constants::math::TwoPI * NPhiCells), 0, NPhiCells - 1);
+    const int etaCell = std::clamp(static_cast<int>((trackPar.getEta() + MaxAbsEta) / (2.f * MaxAbsEta) * NEtaCells), 0, NEtaCells - 1);
+    return phiCell * NEtaCells + etaCell;
+  }
+
+  /// Prefilter of the lazy propagation mode, using the TrackSelection criteria that do not depend on the DCA
+  template <typename TConfigurableGroup, typename TTrack, typename TTrackPar>
+  bool isSelectedForPropagation(TConfigurableGroup const& cGroup, TTrack const& track, TTrackPar const& trackPar)
+  {
+    if (trackPar.getPt() < cGroup.prefilterMinPt.value || std::abs(trackPar.getEta()) > cGroup.prefilterMaxAbsEta.value) {
+      return false;
+    }
+    if constexpr (requires { track.itsNCls(); track.tpcNClsFound(); }) {
+      if (track.itsNCls() < cGroup.prefilterMinITSNCls.value || track.tpcNClsFound() < cGroup.prefilterMinTPCNClsFound.value) {
+        return false;
+      }
+    }
+    return true;
+  }
+
   template <bool isMc, typename TConfigurableGroup, typename TCCDBLoader, typename TCollisions, typename TTracks, typename TOutputGroup, typename THistoRegistry>
   void fillTrackTables(TConfigurableGroup const& cGroup, TrackTuner& trackTunerObj, TCCDBLoader const& ccdbLoader, TCollisions const& collisions, TTracks const& tracks, TOutputGroup& cursors, THistoRegistry& registry)
   {
@@ -248,113 +288,149 @@ class TrackPropagationModule
       }
     }
 
+    uint64_t nSkippedTracks = 0;
+    const std::size_t nTracks = tracks.size();
+    if (fillTracksCov) {
+      mTrackParCovBuffer.resize(nTracks);
+      mDcaInfoCovBuffer.resize(nTracks);
+    } else {
+      mTrackParBuffer.resize(nTracks);
+      mDcaInfoBuffer.resize(nTracks);
+    }
+    mTrackTypeBuffer.resize(nTracks);
+    mQ2OverPtBuffer.assign(nTracks, -9999.);
+    mPropagationOrder.clear();
+
+    // first pass: tracks at the innermost update, and list of the tracks to be propagated
+    int64_t iTrack = 0;
     for (const auto& track : tracks) {
       if (fillTracksCov) {
-        if (fillTracksDCA || fillTracksDCACov) {
-          mDcaInfoCov.set(999, 999, 999, 999, 999);
-        }
-        setTrackParCov(track, mTrackParCov);
+        mDcaInfoCovBuffer[iTrack].set(999, 999, 999, 999, 999);
+        setTrackParCov(track, mTrackParCovBuffer[iTrack]);
         if (cGroup.useTrkPid.value) {
-          mTrackParCov.setPID(track.pidForTracking());
+          mTrackParCovBuffer[iTrack].setPID(track.pidForTracking());
         }
       } else {
-        if (fillTracksDCA) {
-          mDcaInfo[0] = 999;
-          mDcaInfo[1] = 999;
-        }
-        setTrackPar(track, mTrackPar);
+        mDcaInfoBuffer[iTrack] = {999, 999};
+        setTrackPar(track, mTrackParBuffer[iTrack]);
         if (cGroup.useTrkPid.value) {
-          mTrackPar.setPID(track.pidForTracking());
+          mTrackParBuffer[iTrack].setPID(track.pidForTracking());
         }
       }
-      // auto trackParCov = getTrackParCov(track);
-      o2::aod::track::TrackTypeEnum trackType = (o2::aod::track::TrackTypeEnum)track.trackType();
-      // std::array<float, 3> trackPxPyPz;
-      // std::array<float, 3> trackPxPyPzTuned = {0.0, 0.0, 0.0};
-      double q2OverPtNew = -9999.;
+      mTrackTypeBuffer[iTrack] = track.trackType();
       // Only propagate tracks which have passed the innermost wall of the TPC (e.g. skipping loopers etc). Others fill unpropagated.
-      if (track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value) {
-        if (fillTracksCov) {
-          if constexpr (isMc) { // checking MC and fillCovMat block begins
-            // bool hasMcParticle = track.has_mcParticle();
-            if (cGroup.useTrackTuner.value) {
-              trackTunedTracks->Fill(1); // all tracks
-              bool hasMcParticle = track.has_mcParticle();
-              if (hasMcParticle) {
-                auto mcParticle = track.mcParticle();
-                trackTunerObj.tuneTrackParams(mcParticle, mTrackParCov, matCorr, &mDcaInfoCov, trackTunedTracks);
-                q2OverPtNew = mTrackParCov.getQ2Pt();
-              }
-            }
-          } // MC and fillCovMat block ends
+      // In the lazy mode, tracks failing the prefilter are also filled unpropagated.
+      bool isToBePropagated = track.trackType() == o2::aod::track::TrackIU && track.x() < cGroup.minPropagationRadius.value;
+      if (isToBePropagated && cGroup.propagateOnlyPrefiltered.value) {
+        isToBePropagated = fillTracksCov ? isSelectedForPropagation(cGroup, track, mTrackParCovBuffer[iTrack]) : isSelectedForPropagation(cGroup, track, mTrackParBuffer[iTrack]);
+        if (!isToBePropagated) {
+          nSkippedTracks++;
         }
-        bool isPropagationOK = true;
-
-        if (track.has_collision()) {
-          auto const& collision = collisions.rawIteratorAt(track.collisionId());
-          if (fillTracksCov) {
-            mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-            mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
+      }
+      if (isToBePropagated) {
+        mPropagationOrder.emplace_back(getPropagationCell(fillTracksCov ? static_cast<const o2::track::TrackParametrization<float>&>(mTrackParCovBuffer[iTrack]) : mTrackParBuffer[iTrack]), iTrack);
+      }
+      iTrack++;
+    }
+
+    // second pass: propagation of the tracks grouped by (phi, eta) cell, so that consecutive
+    // propagations go through the same material LUT cells. The tracks are independent, hence
+    // the propagated parameters do not depend on the order.
+    std::stable_sort(mPropagationOrder.begin(), mPropagationOrder.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+    for (const auto& [cell, iPropagated] : mPropagationOrder) {
+      auto const& track = tracks.rawIteratorAt(iPropagated);
+      if (fillTracksCov) {
+        if constexpr (isMc) { // checking MC and fillCovMat block begins
+          // bool hasMcParticle = track.has_mcParticle();
+          if (cGroup.useTrackTuner.value) {
+            trackTunedTracks->Fill(1); // all tracks
+            bool hasMcParticle = track.has_mcParticle();
+            if (hasMcParticle) {
+              auto mcParticle = track.mcParticle();
+              trackTunerObj.tuneTrackParams(mcParticle, mTrackParCovBuffer[iPropagated], matCorr, &mDcaInfoCovBuffer[iPropagated], trackTunedTracks);
+              mQ2OverPtBuffer[iPropagated] = mTrackParCovBuffer[iPropagated].getQ2Pt();
+            }
           }
+        } // MC and fillCovMat block ends
+      }
+      bool isPropagationOK = true;
+
+      if (track.has_collision()) {
+        auto const& collision = collisions.rawIteratorAt(track.collisionId());
+        if (fillTracksCov) {
+          mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
+          mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
+          isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCovBuffer[iPropagated], 2.f, matCorr, &mDcaInfoCovBuffer[iPropagated]);
         } else {
-          if (fillTracksCov) {
-            mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
-            mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCov, 2.f, matCorr, &mDcaInfoCov);
-          } else {
-            isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackPar, 2.f, matCorr, &mDcaInfo);
-          }
-        }
-        if (isPropagationOK) {
-          trackType = o2::aod::track::Track;
+          isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, mTrackParBuffer[iPropagated], 2.f, matCorr, &mDcaInfoBuffer[iPropagated]);
         }
-        // filling some QA histograms for track tuner test purpose
+      } else {
         if (fillTracksCov) {
-          if constexpr (isMc) { // checking MC and fillCovMat block begins
-            if (track.has_mcParticle() && isPropagationOK) {
-              auto mcParticle1 = track.mcParticle();
-              // && abs(mcParticle1.pdgCode())==211
-              if (mcParticle1.isPhysicalPrimary()) {
-                registry.fill(HIST("hDCAxyVsPtRec"), mDcaInfoCov.getY(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAxyVsPtMC"), mDcaInfoCov.getY(), mcParticle1.pt());
-                registry.fill(HIST("hDCAzVsPtRec"), mDcaInfoCov.getZ(), mTrackParCov.getPt());
-                registry.fill(HIST("hDCAzVsPtMC"), mDcaInfoCov.getZ(), mcParticle1.pt());
-              }
-            }
-          } // MC and fillCovMat block ends
+          mVtx.setPos({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()});
+          mVtx.setCov(ccdbLoader.mMeanVtx->getSigmaX() * ccdbLoader.mMeanVtx->getSigmaX(), 0.0f, ccdbLoader.mMeanVtx->getSigmaY() * ccdbLoader.mMeanVtx->getSigmaY(), 0.0f, 0.0f, ccdbLoader.mMeanVtx->getSigmaZ() * ccdbLoader.mMeanVtx->getSigmaZ());
+          isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, mTrackParCovBuffer[iPropagated], 2.f, matCorr, &mDcaInfoCovBuffer[iPropagated]);
+        } else {
+          isPropagationOK = o2::base::Propagator::Instance()->propagateToDCABxByBz({ccdbLoader.mMeanVtx->getX(), ccdbLoader.mMeanVtx->getY(), ccdbLoader.mMeanVtx->getZ()}, mTrackParBuffer[iPropagated], 2.f, matCorr, &mDcaInfoBuffer[iPropagated]);
         }
       }
+      if (isPropagationOK) {
+        mTrackTypeBuffer[iPropagated] = o2::aod::track::Track;
+      }
+      // filling some QA histograms for track tuner test purpose
+      if (fillTracksCov) {
+        if constexpr (isMc) { // checking MC and fillCovMat block begins
+          if (track.has_mcParticle() && isPropagationOK) {
+            auto mcParticle1 = track.mcParticle();
+            // && abs(mcParticle1.pdgCode())==211
+            if (mcParticle1.isPhysicalPrimary()) {
+              registry.fill(HIST("hDCAxyVsPtRec"), mDcaInfoCovBuffer[iPropagated].getY(), mTrackParCovBuffer[iPropagated].getPt());
+              registry.fill(HIST("hDCAxyVsPtMC"), mDcaInfoCovBuffer[iPropagated].getY(), mcParticle1.pt());
+              registry.fill(HIST("hDCAzVsPtRec"), mDcaInfoCovBuffer[iPropagated].getZ(), mTrackParCovBuffer[iPropagated].getPt());
+              registry.fill(HIST("hDCAzVsPtMC"), mDcaInfoCovBuffer[iPropagated].getZ(), mcParticle1.pt());
+            }
+          }
+        } // MC and fillCovMat block ends
+      }
+    }
+
+    // third pass: tables filled in the original track order
+    iTrack = 0;
+    for (const auto& track : tracks) {
       // Filling modified Q/Pt values at IU/production point by track tuner in track tuner table
       if (cGroup.useTrackTuner.value && cGroup.fillTrackTunerTable.value) {
-        cursors.tunertable(q2OverPtNew);
+        cursors.tunertable(mQ2OverPtBuffer[iTrack]);
       }
       // LOG(info) <<  " trackPropagation (this value filled in tuner table)--> "  << q2OverPtNew;
       if (fillTracksCov) {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackParCov.getX(), mTrackParCov.getAlpha(), mTrackParCov.getY(), mTrackParCov.getZ(), mTrackParCov.getSnp(), mTrackParCov.getTgl(), mTrackParCov.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackParCov.getPt(), mTrackParCov.getP(), mTrackParCov.getEta(), mTrackParCov.getPhi());
+        const auto& trackParCov = mTrackParCovBuffer[iTrack];
+        const auto& dcaInfoCov = mDcaInfoCovBuffer[iTrack];
+        cursors.tracksParPropagated(track.collisionId(), mTrackTypeBuffer[iTrack], trackParCov.getX(), trackParCov.getAlpha(), trackParCov.getY(), trackParCov.getZ(), trackParCov.getSnp(), trackParCov.getTgl(), trackParCov.getQ2Pt());
+        cursors.tracksParExtensionPropagated(trackParCov.getPt(), trackParCov.getP(), trackParCov.getEta(), trackParCov.getPhi());
         // TODO do we keep the rho as 0? Also the sigma's are duplicated information
-        cursors.tracksParCovPropagated(std::sqrt(mTrackParCov.getSigmaY2()), std::sqrt(mTrackParCov.getSigmaZ2()), std::sqrt(mTrackParCov.getSigmaSnp2()),
-                                       std::sqrt(mTrackParCov.getSigmaTgl2()), std::sqrt(mTrackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
-        cursors.tracksParCovExtensionPropagated(mTrackParCov.getSigmaY2(), mTrackParCov.getSigmaZY(), mTrackParCov.getSigmaZ2(), mTrackParCov.getSigmaSnpY(),
-                                                mTrackParCov.getSigmaSnpZ(), mTrackParCov.getSigmaSnp2(), mTrackParCov.getSigmaTglY(), mTrackParCov.getSigmaTglZ(), mTrackParCov.getSigmaTglSnp(),
-                                                mTrackParCov.getSigmaTgl2(), mTrackParCov.getSigma1PtY(), mTrackParCov.getSigma1PtZ(), mTrackParCov.getSigma1PtSnp(), mTrackParCov.getSigma1PtTgl(),
-                                                mTrackParCov.getSigma1Pt2());
+        cursors.tracksParCovPropagated(std::sqrt(trackParCov.getSigmaY2()), std::sqrt(trackParCov.getSigmaZ2()), std::sqrt(trackParCov.getSigmaSnp2()),
+                                       std::sqrt(trackParCov.getSigmaTgl2()), std::sqrt(trackParCov.getSigma1Pt2()), 0, 0, 0, 0, 0, 0, 0, 0, 0, 0);
+        cursors.tracksParCovExtensionPropagated(trackParCov.getSigmaY2(), trackParCov.getSigmaZY(), trackParCov.getSigmaZ2(), trackParCov.getSigmaSnpY(),
+                                                trackParCov.getSigmaSnpZ(), trackParCov.getSigmaSnp2(), trackParCov.getSigmaTglY(), trackParCov.getSigmaTglZ(), trackParCov.getSigmaTglSnp(),
+                                                trackParCov.getSigmaTgl2(), trackParCov.getSigma1PtY(), trackParCov.getSigma1PtZ(), trackParCov.getSigma1PtSnp(), trackParCov.getSigma1PtTgl(),
+                                                trackParCov.getSigma1Pt2());
         if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfoCov.getY(), mDcaInfoCov.getZ());
+          cursors.tracksDCA(dcaInfoCov.getY(), dcaInfoCov.getZ());
         }
         if (fillTracksDCACov) {
-          cursors.tracksDCACov(mDcaInfoCov.getSigmaY2(), mDcaInfoCov.getSigmaZ2());
+          cursors.tracksDCACov(dcaInfoCov.getSigmaY2(), dcaInfoCov.getSigmaZ2());
         }
       } else {
-        cursors.tracksParPropagated(track.collisionId(), trackType, mTrackPar.getX(), mTrackPar.getAlpha(), mTrackPar.getY(), mTrackPar.getZ(), mTrackPar.getSnp(), mTrackPar.getTgl(), mTrackPar.getQ2Pt());
-        cursors.tracksParExtensionPropagated(mTrackPar.getPt(), mTrackPar.getP(), mTrackPar.getEta(), mTrackPar.getPhi());
+        const auto& trackPar = mTrackParBuffer[iTrack];
+        cursors.tracksParPropagated(track.collisionId(), mTrackTypeBuffer[iTrack], trackPar.getX(), trackPar.getAlpha(), trackPar.getY(), trackPar.getZ(), trackPar.getSnp(), trackPar.getTgl(), trackPar.getQ2Pt());
+        cursors.tracksParExtensionPropagated(trackPar.getPt(), trackPar.getP(), trackPar.getEta(), trackPar.getPhi());
         if (fillTracksDCA) {
-          cursors.tracksDCA(mDcaInfo[0], mDcaInfo[1]);
+          cursors.tracksDCA(mDcaInfoBuffer[iTrack][0], mDcaInfoBuffer[iTrack][1]);
         }
       }
+      iTrack++;
+    }
+    if (cGroup.propagateOnlyPrefiltered.value) {
+      LOGF(debug, "Lazy propagation: %llu out of %d tracks not propagated by the prefilter", static_cast<unsigned long long>(nSkippedTracks), static_cast<int>(tracks.size()));
     }
   }
 };
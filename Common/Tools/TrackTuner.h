@@ -36,9 +36,11 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <memory>
+#include <span>
 #include <string>
 #include <utility>
 #include <vector>
@@ -58,6 +60,85 @@ DECLARE_SOA_TABLE(TrackTunerTable, "AOD", "TRACKTUNERTABLE", //!
                   track_tuner::TunedQOverPt);
 } // namespace o2::aod
 
+/// Linear interpolation of a TGraphErrors, compiled at load time for a constant-time evaluation.
+/// A uniform grid over the abscissa range gives the first candidate segment of each grid bin, and each segment stores
+/// the coefficients of its linear interpolation. Outside the range, the value at the closest point is returned.
+class TrackTunerGraphTable
+{
+ public:
+  /// Compiles the table of a graph
+  void compile(const TGraphErrors* graph)
+  {
+    if (!graph || graph->GetN() == 0) {
+      LOG(fatal) << "[TrackTuner] Cannot compile the lookup table of an empty graph";
+      return;
+    }
+    const int nPoints = graph->GetN();
+    std::vector<int> order(nPoints);
+    for (int i = 0; i < nPoints; ++i) {
+      order[i] = i;
+    }
+    if (!std::is_sorted(graph->GetX(), graph->GetX() + nPoints)) {
+      LOG(warning) << "[TrackTuner] Points of the graph " << graph->GetName() << " not sorted in pT, sorting them";
+      std::stable_sort(order.begin(), order.end(), [graph](int a, int b) { return graph->GetX()[a] < graph->GetX()[b]; });
+    }
+    mX.resize(nPoints);
+    std::vector<double> y(nPoints);
+    for (int i = 0; i < nPoints; ++i) {
+      mX[i] = graph->GetX()[order[i]];
+      y[i] = graph->GetY()[order[i]];
+    }
+    const int nSegments = std::max(nPoints - 1, 1);
+    mSlopes.assign(nSegments, 0.);
+    mIntercepts.assign(nSegments, y[0]);
+    for (int i = 0; i < nPoints - 1; ++i) {
+      if (mX[i + 1] > mX[i]) {
+        mSlopes[i] = (y[i + 1] - y[i]) / (mX[i + 1] - mX[i]);
+        mIntercepts[i] = y[i] - mSlopes[i] * mX[i];
+      } else {
+        mIntercepts[i] = y[i];
+      }
+    }
+    mXMin = mX.front();
+    mXMax = mX.back();
+    const int nGridBins = NGridBinsPerSegment * nSegments;
+    mInvGridWidth = mXMax > mXMin ? nGridBins / (mXMax - mXMin) : 0.;
+    mGridSegments.resize(nGridBins);
+    for (int i = 0; i < nGridBins; ++i) {
+      const double lowEdge = mXMin + (mInvGridWidth > 0. ? i / mInvGridWidth : 0.);
+      const int segment = std::upper_bound(mX.begin(), mX.end(), lowEdge) - mX.begin() - 1;
+      mGridSegments[i] = std::clamp(segment, 0, nSegments - 1);
+    }
+  }
+
+  /// \return value of the graph at x, linearly interpolated between the two closest points
+  double eval(double x) const
+  {
+    if (!(x > mXMin)) {
+      x = mXMin;
+    } else if (x > mXMax) {
+      x = mXMax;
+    }
+    const int nGridBins = mGridSegments.size();
+    int segment = mGridSegments[std::min(static_cast<int>((x - mXMin) * mInvGridWidth), nGridBins - 1)];
+    while (segment + 1 < static_cast<int>(mSlopes.size()) && x > mX[segment + 1]) {
+      ++segment;
+    }
+    return mIntercepts[segment] + mSlopes[segment] * x;
+  }
+
+ private:
+  static constexpr int NGridBinsPerSegment = 4; // bins of the uniform grid per segment of the graph
+
+  std::vector<double> mX;          // abscissae of the points, sorted
+  std::vector<double> mSlopes;     // slope of each segment
+  std::vector<double> mIntercepts; // intercept of each segment
+  std::vector<int> mGridSegments;  // first segment of each bin of the uniform grid
+  double mXMin = 0.;               // lowest abscissa
+  double mXMax = 0.;               // highest abscissa
+  double mInvGridWidth = 0.;       // inverse of the width of the grid bins
+};
+
 struct TrackTuner : o2::framework::ConfigurableGroup {
 
   std::string prefix = "trackTuner"; // JSON group name
@@ -125,6 +206,20 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionMC;
   std::vector<std::unique_ptr<TGraphErrors>> grDcaZPullVsPtPionData;
 
+  // lookup tables compiled from the graphs, evaluated for each track
+  std::vector<TrackTunerGraphTable> tabDcaXYResVsPtPionMC;
+  std::vector<TrackTunerGraphTable> tabDcaXYResVsPtPionData;
+  std::vector<TrackTunerGraphTable> tabDcaZResVsPtPionMC;
+  std::vector<TrackTunerGraphTable> tabDcaZResVsPtPionData;
+  std::vector<TrackTunerGraphTable> tabDcaXYMeanVsPtPionMC;
+  std::vector<TrackTunerGraphTable> tabDcaXYMeanVsPtPionData;
+  std::vector<TrackTunerGraphTable> tabDcaXYPullVsPtPionMC;
+  std::vector<TrackTunerGraphTable> tabDcaXYPullVsPtPionData;
+  std::vector<TrackTunerGraphTable> tabDcaZPullVsPtPionMC;
+  std::vector<TrackTunerGraphTable> tabDcaZPullVsPtPionData;
+  TrackTunerGraphTable tabOneOverPtPionMC;
+  TrackTunerGraphTable tabOneOverPtPionData;
+
   /// @brief Function to initialize the run number to that of the 1st considered bunch crossing (useful only if autoDetectDcaCalib = true)
   void setRunNumber(int n)
   {
@@ -713,6 +808,34 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
       grOneOverPtPionData.reset(dynamic_cast<TGraphErrors*>(ccdb_object_qoverpt->FindObject(grOneOverPtPionNameData.c_str())));
     }
 
+    /// compile the graphs in lookup tables
+    tabDcaXYResVsPtPionMC.resize(nPhiBins);
+    tabDcaXYResVsPtPionData.resize(nPhiBins);
+    tabDcaZResVsPtPionMC.resize(nPhiBins);
+    tabDcaZResVsPtPionData.resize(nPhiBins);
+    tabDcaXYMeanVsPtPionMC.resize(nPhiBins);
+    tabDcaXYMeanVsPtPionData.resize(nPhiBins);
+    tabDcaXYPullVsPtPionMC.resize(nPhiBins);
+    tabDcaXYPullVsPtPionData.resize(nPhiBins);
+    tabDcaZPullVsPtPionMC.resize(nPhiBins);
+    tabDcaZPullVsPtPionData.resize(nPhiBins);
+    for (int iPhiBin = 0; iPhiBin < nPhiBins; ++iPhiBin) {
+      tabDcaXYResVsPtPionMC[iPhiBin].compile(grDcaXYResVsPtPionMC[iPhiBin].get());
+      tabDcaXYResVsPtPionData[iPhiBin].compile(grDcaXYResVsPtPionData[iPhiBin].get());
+      tabDcaZResVsPtPionMC[iPhiBin].compile(grDcaZResVsPtPionMC[iPhiBin].get());
+      tabDcaZResVsPtPionData[iPhiBin].compile(grDcaZResVsPtPionData[iPhiBin].get());
+      tabDcaXYMeanVsPtPionMC[iPhiBin].compile(grDcaXYMeanVsPtPionMC[iPhiBin].get());
+      tabDcaXYMeanVsPtPionData[iPhiBin].compile(grDcaXYMeanVsPtPionData[iPhiBin].get());
+      tabDcaXYPullVsPtPionMC[iPhiBin].compile(grDcaXYPullVsPtPionMC[iPhiBin].get());
+      tabDcaXYPullVsPtPionData[iPhiBin].compile(grDcaXYPullVsPtPionData[iPhiBin].get());
+      tabDcaZPullVsPtPionMC[iPhiBin].compile(grDcaZPullVsPtPionMC[iPhiBin].get());
+      tabDcaZPullVsPtPionData[iPhiBin].compile(grDcaZPullVsPtPionData[iPhiBin].get());
+    }
+    if (grOneOverPtPionMC.get() && grOneOverPtPionData.get()) {
+      tabOneOverPtPionMC.compile(grOneOverPtPionMC.get());
+      tabOneOverPtPionData.compile(grOneOverPtPionData.get());
+    }
+
     /// if we arrive here, it means that the graphs are all set
     areGraphsConfigured = true;
 
@@ -748,11 +871,11 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
       phiMC += o2::constants::math::TwoPI;                                    // 2 * std::numbers::pi;//
     int phiBin = phiMC / (o2::constants::math::TwoPI + 0.0000001) * nPhiBins; // 0.0000001 just a numerical protection
 
-    dcaXYResMC = evalGraph(ptMC, grDcaXYResVsPtPionMC[phiBin].get());
-    dcaXYResData = evalGraph(ptMC, grDcaXYResVsPtPionData[phiBin].get());
+    dcaXYResMC = tabDcaXYResVsPtPionMC[phiBin].eval(ptMC);
+    dcaXYResData = tabDcaXYResVsPtPionData[phiBin].eval(ptMC);
 
-    dcaZResMC = evalGraph(ptMC, grDcaZResVsPtPionMC[phiBin].get());
-    dcaZResData = evalGraph(ptMC, grDcaZResVsPtPionData[phiBin].get());
+    dcaZResMC = tabDcaZResVsPtPionMC[phiBin].eval(ptMC);
+    dcaZResData = tabDcaZResVsPtPionData[phiBin].eval(ptMC);
 
     // Local Q/Pt resolution: either the constant configurable value, or evaluated per-track from graphs
     double smearQOverPtMC = qOverPtMC;
@@ -763,8 +886,8 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
         if (!grOneOverPtPionData.get() || !grOneOverPtPionMC.get()) {
           LOG(fatal) << "### q/pt smearing: input graphs not correctly retrieved. Aborting.";
         }
-        smearQOverPtMC = std::max(0.0, evalGraph(ptMC, grOneOverPtPionMC.get()));
-        smearQOverPtData = std::max(0.0, evalGraph(ptMC, grOneOverPtPionData.get()));
+        smearQOverPtMC = std::max(0.0, tabOneOverPtPionMC.eval(ptMC));
+        smearQOverPtData = std::max(0.0, tabOneOverPtPionData.eval(ptMC));
         if (debugInfo) {
           LOG(info) << "### q/pt graph-based smearing: pT=" << ptMC
                     << " sigma(1/pT)_MC=" << smearQOverPtMC
@@ -776,14 +899,14 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
 
     if (updateTrackDCAs) {
 
-      dcaXYMeanMC = evalGraph(ptMC, grDcaXYMeanVsPtPionMC[phiBin].get());
-      dcaXYMeanData = evalGraph(ptMC, grDcaXYMeanVsPtPionData[phiBin].get());
+      dcaXYMeanMC = tabDcaXYMeanVsPtPionMC[phiBin].eval(ptMC);
+      dcaXYMeanData = tabDcaXYMeanVsPtPionData[phiBin].eval(ptMC);
 
-      dcaXYPullMC = evalGraph(ptMC, grDcaXYPullVsPtPionMC[phiBin].get());
-      dcaXYPullData = evalGraph(ptMC, grDcaXYPullVsPtPionData[phiBin].get());
+      dcaXYPullMC = tabDcaXYPullVsPtPionMC[phiBin].eval(ptMC);
+      dcaXYPullData = tabDcaXYPullVsPtPionData[phiBin].eval(ptMC);
 
-      dcaZPullMC = evalGraph(ptMC, grDcaZPullVsPtPionMC[phiBin].get());
-      dcaZPullData = evalGraph(ptMC, grDcaZPullVsPtPionData[phiBin].get());
+      dcaZPullMC = tabDcaZPullVsPtPionMC[phiBin].eval(ptMC);
+      dcaZPullData = tabDcaZPullVsPtPionData[phiBin].eval(ptMC);
     }
     //  Unit conversion, is it required ??
     dcaXYResMC *= 1.e-4;
@@ -1152,6 +1275,23 @@ struct TrackTuner : o2::framework::ConfigurableGroup {
     }
   } // tuneTrackParams() ends here
 
+  /// Tunes the parameters of a batch of tracks, as tuneTrackParams for each track
+  /// \param mcparticles MC particles of the tracks
+  /// \param trackParCovs track parameters to be tuned, one per MC particle
+  /// \param matCorr material correction type
+  /// \param dcaInfoCovs DCA of each track, updated with the propagation to the production point
+  /// \param hQA QA histogram
+  template <typename T1, typename T2, typename T3, typename T4, typename H>
+  void tuneTracksParams(std::span<const T1> mcparticles, std::span<T2> trackParCovs, T3 const& matCorr, std::span<T4> dcaInfoCovs, H hQA)
+  {
+    if (mcparticles.size() != trackParCovs.size() || mcparticles.size() != dcaInfoCovs.size()) {
+      LOG(fatal) << "[TrackTuner::tuneTracksParams()] Inconsistent sizes of the batch: " << mcparticles.size() << " MC particles, " << trackParCovs.size() << " tracks, " << dcaInfoCovs.size() << " DCAs";
+    }
+    for (std::size_t i = 0; i < mcparticles.size(); ++i) {
+      tuneTrackParams(mcparticles[i], trackParCovs[i], matCorr, &dcaInfoCovs[i], hQA);
+    }
+  }
+
   // to be declared
   // ---------------
   // int getPhiBin(double phi) const
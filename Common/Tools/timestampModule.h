@@ -19,7 +19,9 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <fstream>
 #include <map>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,6 +41,7 @@ struct timestampConfigurables : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<std::string> rct_path{"rct-path", "RCT/Info/RunInformation", "path to the ccdb RCT objects for the SOR timestamps"};
   o2::framework::Configurable<std::string> orbit_reset_path{"orbit-reset-path", "CTP/Calib/OrbitReset", "path to the ccdb orbit-reset objects"};
   o2::framework::Configurable<int> isRun2MC{"isRun2MC", -1, "Running mode: enable only for Run 2 MC. Timestamps are set to SOR timestamp. Default: -1 (autoset from metadata) 0 (Standard) 1 (Run 2 MC)"}; // o2-linter: disable=name/configurable (temporary fix)
+  o2::framework::Configurable<std::string> cache_file{"cache-file", "", "local file caching the orbit-reset and run-duration timestamps of the runs for the following jobs, disabled if empty"};
 };
 
 //__________________________________________
@@ -79,62 +82,124 @@ class TimestampModule
         timestampOpts.isRun2MC.value = 0;
       }
     }
+    readCacheFile();
+  }
+
+  /// Read the timestamps of the runs already queried by previous jobs, for the same running mode and orbit-reset path
+  void readCacheFile()
+  {
+    const std::string& path = timestampOpts.cache_file.value;
+    if (path.empty()) {
+      return;
+    }
+    std::ifstream file(path);
+    if (!file.is_open()) {
+      LOGF(info, "Timestamp cache file %s not found, it will be created", path.data());
+      return;
+    }
+    std::string line;
+    int nRuns = 0;
+    while (std::getline(file, line)) {
+      std::istringstream fields(line);
+      int runNumber = 0, isRun2MC = 0;
+      std::string orbitResetPath;
+      int64_t orbitReset = 0, sor = 0, eor = 0;
+      if (!(fields >> runNumber >> isRun2MC >> orbitResetPath >> orbitReset >> sor >> eor)) {
+        continue; // malformed line, e.g. partially written by a concurrent job
+      }
+      if (isRun2MC != timestampOpts.isRun2MC.value || orbitResetPath != timestampOpts.orbit_reset_path.value) {
+        continue;
+      }
+      mapRunToOrbitReset[runNumber] = orbitReset;
+      mapRunToRunDuration[runNumber] = {sor, eor};
+      nRuns++;
+    }
+    LOGF(info, "Read the timestamps of %d runs from the cache file %s", nRuns, path.data());
+  }
+
+  /// Append the timestamps of a run to the cache file, in a single write to stay readable with concurrent jobs
+  void writeCacheFile(int runNumber)
+  {
+    const std::string& path = timestampOpts.cache_file.value;
+    if (path.empty()) {
+      return;
+    }
+    std::ostringstream line;
+    line << runNumber << " " << timestampOpts.isRun2MC.value << " " << timestampOpts.orbit_reset_path.value << " " << orbitResetTimestamp << " " << runDuration.first << " " << runDuration.second << "\n";
+    std::ofstream file(path, std::ios::app);
+    if (!file.is_open()) {
+      LOGF(warning, "Cannot open the timestamp cache file %s", path.data());
+      return;
+    }
+    file << line.str() << std::flush;
+  }
+
+  /// Set the orbit-reset timestamp and the run duration for a run, from the cache or from the CCDB
+  template <typename Tccdb>
+  void setRun(int runNumber, Tccdb const& ccdb)
+  {
+    // We need to set the orbit-reset timestamp for the run number.
+    // This is done with caching if the run number was already processed before.
+    // If not the orbit-reset timestamp for the run number is queried from CCDB and added to the cache
+    if (mapRunToOrbitReset.count(runNumber)) { // The run number was already requested before: getting it from cache!
+      LOGF(debug, "Getting orbit-reset timestamp from cache");
+      orbitResetTimestamp = mapRunToOrbitReset[runNumber];
+      runDuration = mapRunToRunDuration[runNumber];
+    } else { // The run was not requested before: need to acccess CCDB!
+      LOGF(debug, "Getting start-of-run and end-of-run timestamps from CCDB");
+      runDuration = ccdb->getRunDuration(runNumber, true); /// fatalise if timestamps are not found
+      int64_t sorTimestamp = runDuration.first;            // timestamp of the SOR/SOX/STF in ms
+      int64_t eorTimestamp = runDuration.second;           // timestamp of the EOR/EOX/ETF in ms
+
+      // clear cache to prevent interference with orbit reset queries from other code
+      // FIXME this should not have been a problem, to be investigated
+      ccdb->clearCache(timestampOpts.orbit_reset_path.value.data());
+
+      const bool isUnanchoredRun3MC = runNumber >= 300000 && runNumber < 500000;
+      if (timestampOpts.isRun2MC.value == 1 || isUnanchoredRun3MC) {
+        // isRun2MC: bc/orbit distributions are not simulated in Run2 MC. All bcs are set to 0.
+        // isUnanchoredRun3MC: assuming orbit-reset is done in the beginning of each run
+        // Setting orbit-reset timestamp to start-of-run timestamp
+        orbitResetTimestamp = sorTimestamp * 1000; // from ms to us
+      } else if (runNumber < 300000) {             // Run 2
+        LOGF(debug, "Getting orbit-reset timestamp using start-of-run timestamp from CCDB");
+        auto ctp = ccdb->template getSpecific<std::vector<int64_t>>(timestampOpts.orbit_reset_path.value.data(), sorTimestamp);
+        orbitResetTimestamp = (*ctp)[0];
+      } else {
+        // sometimes orbit is reset after SOR. Using EOR timestamps for orbitReset query is more reliable
+        LOGF(debug, "Getting orbit-reset timestamp using end-of-run timestamp from CCDB");
+        auto ctp = ccdb->template getSpecific<std::vector<int64_t>>(timestampOpts.orbit_reset_path.value.data(), eorTimestamp / 2 + sorTimestamp / 2);
+        orbitResetTimestamp = (*ctp)[0];
+      }
+
+      // Adding the timestamp to the cache map
+      std::pair<std::map<int, int64_t>::iterator, bool> check;
+      check = mapRunToOrbitReset.insert(std::pair<int, int64_t>(runNumber, orbitResetTimestamp));
+      if (!check.second) {
+        LOGF(fatal, "Run number %i already existed with a orbit-reset timestamp of %llu", runNumber, check.first->second);
+      }
+      mapRunToRunDuration[runNumber] = runDuration;
+      LOGF(info, "Add new run number %i with orbit-reset timestamp %llu, SOR: %llu, EOR: %llu to cache", runNumber, orbitResetTimestamp, runDuration.first, runDuration.second);
+      writeCacheFile(runNumber);
+    }
+    lastRunNumber = runNumber;
+
+    if (timestampOpts.verbose) {
+      LOGF(info, "Orbit-reset timestamp for run number %i found: %llu us", runNumber, orbitResetTimestamp);
+    }
   }
 
   template <typename TBCs, typename Tccdb, typename TTimestampBuffer, typename TCursor>
   void process(TBCs const& bcs, Tccdb const& ccdb, TTimestampBuffer& timestampbuffer, TCursor& timestampTable)
   {
     timestampbuffer.clear();
+    timestampbuffer.reserve(bcs.size());
+    timestampTable.reserve(bcs.size());
+    // the run is looked up only when it changes, the loop is then a plain conversion of the global BCs
     for (auto const& bc : bcs) {
       int runNumber = bc.runNumber();
-      // We need to set the orbit-reset timestamp for the run number.
-      // This is done with caching if the run number was already processed before.
-      // If not the orbit-reset timestamp for the run number is queried from CCDB and added to the cache
-      if (runNumber == lastRunNumber) { // The run number coincides to the last run processed
-        LOGF(debug, "Using orbit-reset timestamp from last call");
-      } else if (mapRunToOrbitReset.count(runNumber)) { // The run number was already requested before: getting it from cache!
-        LOGF(debug, "Getting orbit-reset timestamp from cache");
-        orbitResetTimestamp = mapRunToOrbitReset[runNumber];
-        runDuration = mapRunToRunDuration[runNumber];
-      } else { // The run was not requested before: need to acccess CCDB!
-        LOGF(debug, "Getting start-of-run and end-of-run timestamps from CCDB");
-        runDuration = ccdb->getRunDuration(runNumber, true); /// fatalise if timestamps are not found
-        int64_t sorTimestamp = runDuration.first;            // timestamp of the SOR/SOX/STF in ms
-        int64_t eorTimestamp = runDuration.second;           // timestamp of the EOR/EOX/ETF in ms
-
-        // clear cache to prevent interference with orbit reset queries from other code
-        // FIXME this should not have been a problem, to be investigated
-        ccdb->clearCache(timestampOpts.orbit_reset_path.value.data());
-
-        const bool isUnanchoredRun3MC = runNumber >= 300000 && runNumber < 500000;
-        if (timestampOpts.isRun2MC.value == 1 || isUnanchoredRun3MC) {
-          // isRun2MC: bc/orbit distributions are not simulated in Run2 MC. All bcs are set to 0.
-          // isUnanchoredRun3MC: assuming orbit-reset is done in the beginning of each run
-          // Setting orbit-reset timestamp to start-of-run timestamp
-          orbitResetTimestamp = sorTimestamp * 1000; // from ms to us
-        } else if (runNumber < 300000) {             // Run 2
-          LOGF(debug, "Getting orbit-reset timestamp using start-of-run timestamp from CCDB");
-          auto ctp = ccdb->template getSpecific<std::vector<int64_t>>(timestampOpts.orbit_reset_path.value.data(), sorTimestamp);
-          orbitResetTimestamp = (*ctp)[0];
-        } else {
-          // sometimes orbit is reset after SOR. Using EOR timestamps for orbitReset query is more reliable
-          LOGF(debug, "Getting orbit-reset timestamp using end-of-run timestamp from CCDB");
-          auto ctp = ccdb->template getSpecific<std::vector<int64_t>>(timestampOpts.orbit_reset_path.value.data(), eorTimestamp / 2 + sorTimestamp / 2);
-          orbitResetTimestamp = (*ctp)[0];
-        }
-
-        // Adding the timestamp to the cache map
-        std::pair<std::map<int, int64_t>::iterator, bool> check;
-        check = mapRunToOrbitReset.insert(std::pair<int, int64_t>(runNumber, orbitResetTimestamp));
-        if (!check.second) {
-          LOGF(fatal, "Run number %i already existed with a orbit-reset timestamp of %llu", runNumber, check.first->second);
-        }
-        mapRunToRunDuration[runNumber] = runDuration;
-        LOGF(info, "Add new run number %i with orbit-reset timestamp %llu, SOR: %llu, EOR: %llu to cache", runNumber, orbitResetTimestamp, runDuration.first, runDuration.second);
-      }
-
-      if (timestampOpts.verbose) {
-        LOGF(info, "Orbit-reset timestamp for run number %i found: %llu us", runNumber, orbitResetTimestamp);
+      if (runNumber != lastRunNumber) {
+        setRun(runNumber, ccdb);
       }
       int64_t timestamp{(orbitResetTimestamp + int64_t(bc.globalBC() * o2::constants::lhc::LHCBunchSpacingNS * 1e-3)) / 1000}; // us -> ms
       if (timestamp < runDuration.first || timestamp > runDuration.second) {
@@ -20,6 +20,7 @@
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "DPG/Tasks/AOTEvent/quantileSketch.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
@@ -71,6 +72,8 @@ struct DetectorOccupancyQaTask {
   Configurable<bool> confFlagCentralityIsAvailable{"FlagCentralityIsAvailable", true, "Fill centrality-related historams"};                                             // o2-linter: disable=name/configurable (temporary fix)
   Configurable<bool> confFlagManyHeavyHistos{"FlagManyHeavyHistos", true, "Fill more TH2, TH3, THn historams"};                                                         // o2-linter: disable=name/configurable (temporary fix)
   Configurable<bool> confFlagIsTOFIsTRDdtStudy{"FlagIsTOFIsTRDdtStudy", false, "Fill THn dt historams with isTOF and isTRD condition"};                                 // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<bool> confFlagFillQuantileSketches{"FlagFillQuantileSketches", false, "Fill quantile sketch of the occupancy distribution"};                             // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<float> confQuantileSketchAccuracy{"QuantileSketchAccuracy", 0.01, "Relative accuracy of the quantiles of the sketches"};                                 // o2-linter: disable=name/configurable (temporary fix)
 
   // configuration for small time binning
   Configurable<float> confTimeIntervalForSmallBins{"TimeIntervalForSmallBins", 100, "Time interval for TPC occupancy calculation in small bins, +/-, us"}; // o2-linter: disable=name/configurable (temporary fix)
@@ -133,6 +136,7 @@ struct DetectorOccupancyQaTask {
   int64_t bcSOR = 0;                     // global bc of the start of the first orbit, setting 0 by default for unanchored MC
   int64_t nBCsPerTF = 32 * nBCsPerOrbit; // duration of TF in bcs, should be 128*3564 or 32*3564, setting 128 orbits by default sfor unanchored MC
   ctpRateFetcher mRateFetcher;
+  o2::dpg_quantiles::QuantileSketch sketchOccupancy;
 
   // save time "slices" for several collisions for QA
   bool flagFillQAtimeOccupHist = false;
@@ -153,6 +157,9 @@ struct DetectorOccupancyQaTask {
 
     // QA of occupancy-based event selection
     histos.add("hOccupancy", "", kTH1D, {{15002, -1.5, 15000.5}});
+    if (confFlagFillQuantileSketches) {
+      sketchOccupancy.init(histos, "sketchOccupancy", "occupancy (n ITS tracks weighted)", confQuantileSketchAccuracy, 1., 15000.);
+    }
 
     AxisSpec axisOccupancyTracks{nBinsOccupancy, 0., nMaxOccupancy, "occupancy (n ITS tracks weighted)"};
     if (confFlagCentralityIsAvailable) {
@@ -1264,6 +1271,7 @@ struct DetectorOccupancyQaTask {
       // continue;
 
       histos.fill(HIST("hOccupancy"), occupancy);
+      sketchOccupancy.fill(occupancy);
       if (occupancy >= 0 && confAddBasicQAhistos) {
         int orbitId = bcInTF / o2::constants::lhc::LHCMaxBunches;
         histos.fill(HIST("hOccupancyVsOrbit"), orbitId, occupancy);
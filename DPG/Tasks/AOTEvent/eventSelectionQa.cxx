@@ -17,6 +17,7 @@
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/CCDB/TriggerAliases.h"
 #include "Common/DataModel/EventSelection.h"
+#include "DPG/Tasks/AOTEvent/quantileSketch.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
@@ -71,6 +72,8 @@ struct EventSelectionQaTask {
   Configurable<bool> isLowFlux{"isLowFlux", 1, "1 - low flux (pp, pPb), 0 - high flux (PbPb)"};
   Configurable<bool> fillITSdeadStaveHists{"fillITSdeadStaveHists", 0, "0 - no, 1 - yes"};
   Configurable<bool> fillTPCnClsVsOccupancyHists{"fillTPCnClsVsOccupancyHists", 0, "0 - no, 1 - yes"};
+  Configurable<bool> fillQuantileSketches{"fillQuantileSketches", 0, "0 - no, 1 - yes"};
+  Configurable<float> quantileSketchAccuracy{"quantileSketchAccuracy", 0.01, "relative accuracy of the quantiles of the sketches"};
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
@@ -88,6 +91,9 @@ struct EventSelectionQaTask {
   std::bitset<nBCsPerOrbit> bcPatternA;
   std::bitset<nBCsPerOrbit> bcPatternC;
   std::bitset<nBCsPerOrbit> bcPatternB;
+  o2::dpg_quantiles::QuantileSketch sketchOccupancyByTracks;
+  o2::dpg_quantiles::QuantileSketch sketchOccupancyByFT0C;
+  o2::dpg_quantiles::QuantileSketch sketchNumTracksPV;
   SliceCache cache;
   Partition<aod::Tracks> tracklets = (aod::track::trackType == static_cast<uint8_t>(o2::aod::track::TrackTypeEnum::Run2Tracklet));
 
@@ -362,6 +368,11 @@ struct EventSelectionQaTask {
       histos.add("occupancyQA/hOccupancyByTracks", "", kTH1D, {{15002, -1.5, 15000.5}});
       histos.add("occupancyQA/hOccupancyByFT0C", "", kTH1D, {{15002, -20, 150000}});
       histos.add("occupancyQA/hOccupancyByFT0CvsByTracks", "", kTH2D, {{150, 0, 15000}, {150, 0, 150000}});
+      if (fillQuantileSketches) {
+        sketchOccupancyByTracks.init(histos, "occupancyQA/sketchOccupancyByTracks", "occupancy by tracks", quantileSketchAccuracy, 1., 15000.);
+        sketchOccupancyByFT0C.init(histos, "occupancyQA/sketchOccupancyByFT0C", "occupancy by FT0C", quantileSketchAccuracy, 1., 150000.);
+        sketchNumTracksPV.init(histos, "occupancyQA/sketchNumTracksPV", "n PV tracks", quantileSketchAccuracy, 1., 10000.);
+      }
 
       // 3D histograms: nGlobalTracks with cls567 as y-axis, V0A as x-axis:
       const AxisSpec axisNtracksPV{200, -0.5, 5000 - 0.5, "n ITS PV tracks"};
@@ -1244,6 +1255,9 @@ struct EventSelectionQaTask {
       if (!isLowFlux && col.sel8() && col.selection_bit(kNoSameBunchPileup) && fabs(col.posZ()) < 10) {
         histos.fill(HIST("occupancyQA/hOccupancyByTracks"), occupancyByTracks);
         histos.fill(HIST("occupancyQA/hOccupancyByFT0C"), occupancyByFT0C);
+        sketchOccupancyByTracks.fill(occupancyByTracks);
+        sketchOccupancyByFT0C.fill(occupancyByFT0C);
+        sketchNumTracksPV.fill(nPV);
         if (occupancyByTracks >= 0) {
           histos.fill(HIST("occupancyQA/hOccupancyByFT0CvsByTracks"), occupancyByTracks, occupancyByFT0C);
           histos.fill(HIST("occupancyQA/hNumTracksPV_vs_V0A_vs_occupancy"), multV0A, nPV, occupancyByTracks);
@@ -9,6 +9,8 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 
+#include "DPG/Tasks/AOTEvent/timeSeriesAccumulator.h"
+
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
 #include <DataFormatsFIT/Triggers.h>
@@ -19,6 +21,7 @@
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
+#include <Framework/EndOfStreamContext.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
 #include <Framework/InitContext.h>
@@ -26,11 +29,13 @@
 #include <Framework/runDataProcessing.h>
 
 #include <TH1.h>
+#include <THnSparse.h>
 #include <TList.h>
 #include <TString.h>
 
 #include <Rtypes.h>
 
+#include <array>
 #include <bitset>
 #include <cmath>
 #include <cstdint>
@@ -39,8 +44,32 @@ using namespace o2;
 using namespace o2::framework;
 using BCsRun3 = soa::Join<aod::BCs, aod::Timestamps, aod::Run3MatchedToBCSparse>;
 
+namespace
+{
+enum SecondsBcsMap { TCEselB = 0,
+                     ZNAselB,
+                     ZNCselB,
+                     ZEMselB,
+                     VCHselB,
+                     TCEselA,
+                     ZNAselA,
+                     ZNCselA,
+                     ZEMselA,
+                     VCHselA,
+                     TCEselC,
+                     ZNAselC,
+                     ZNCselC,
+                     ZEMselC,
+                     VCHselC,
+                     NSecondsBcsMaps };
+constexpr std::array<const char*, NSecondsBcsMaps> SecondsBcsNames{"hSecondsBcsTCEselB", "hSecondsBcsZNAselB", "hSecondsBcsZNCselB", "hSecondsBcsZEMselB", "hSecondsBcsVCHselB",
+                                                                   "hSecondsBcsTCEselA", "hSecondsBcsZNAselA", "hSecondsBcsZNCselA", "hSecondsBcsZEMselA", "hSecondsBcsVCHselA",
+                                                                   "hSecondsBcsTCEselC", "hSecondsBcsZNAselC", "hSecondsBcsZNCselC", "hSecondsBcsZEMselC", "hSecondsBcsVCHselC"};
+} // namespace
+
 struct LumiQaTask {
-  Configurable<float> confTimeBinWidthInSec{"TimeBinWidthInSec", 60., "Width of time bins in seconds"}; // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<float> confTimeBinWidthInSec{"TimeBinWidthInSec", 60., "Width of time bins in seconds"};                                                                                            // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<bool> confUseTimeSeriesAccumulators{"UseTimeSeriesAccumulators", false, "Fill the time-BC maps as THnSparse through streaming accumulators, memory independent of the run length"}; // o2-linter: disable=name/configurable (temporary fix)
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   int lastRunNumber = -1;
@@ -54,6 +83,17 @@ struct LumiQaTask {
   std::bitset<nBCsPerOrbit> bcPatternC;
   std::bitset<nBCsPerOrbit> beamPatternA;
   std::bitset<nBCsPerOrbit> beamPatternC;
+  std::array<o2::dpg_timeseries::TimeSeriesAccumulator, NSecondsBcsMaps> accumulators;
+
+  template <char... chars>
+  void fillSecondsBcs(const ConstStr<chars...>& name, SecondsBcsMap map, double secFromSOR, int bcInOrbit)
+  {
+    if (confUseTimeSeriesAccumulators) {
+      accumulators[map].fill(secFromSOR, bcInOrbit);
+    } else {
+      histos.fill(name, secFromSOR, bcInOrbit);
+    }
+  }
 
   void init(InitContext&)
   {
@@ -187,21 +227,13 @@ struct LumiQaTask {
 
       const AxisSpec axisBCs{nBCsPerOrbit, 0., static_cast<double>(nBCsPerOrbit), ""};
       const AxisSpec axisSeconds{nTimeBins, 0, timeInterval, "seconds"};
-      histos.add("hSecondsBcsTCEselB", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNAselB", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNCselB", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZEMselB", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsVCHselB", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsTCEselA", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNAselA", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNCselA", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZEMselA", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsVCHselA", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsTCEselC", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNAselC", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZNCselC", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsZEMselC", "", kTH2D, {axisSeconds, axisBCs});
-      histos.add("hSecondsBcsVCHselC", "", kTH2D, {axisSeconds, axisBCs});
+      for (int iMap = 0; iMap < NSecondsBcsMaps; iMap++) {
+        if (confUseTimeSeriesAccumulators) {
+          accumulators[iMap].bind(histos.add<THnSparse>(SecondsBcsNames[iMap], "", kTHnSparseD, {axisSeconds, axisBCs}).get());
+        } else {
+          histos.add(SecondsBcsNames[iMap], "", kTH2D, {axisSeconds, axisBCs});
+        }
+      }
     }
 
     for (const auto& bc : bcs) {
@@ -267,43 +299,43 @@ struct LumiQaTask {
         // B-mask
         if (zna && maskB) {
           histos.get<TH1>(HIST("hCounterZNAselB"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNAselB"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNAselB"), ZNAselB, secFromSOR, bcInOrbit);
         }
         if (znc && maskB) {
           histos.get<TH1>(HIST("hCounterZNCselB"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNCselB"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNCselB"), ZNCselB, secFromSOR, bcInOrbit);
         }
         if (zem && maskB) {
           histos.get<TH1>(HIST("hCounterZEMselB"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZEMselB"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZEMselB"), ZEMselB, secFromSOR, bcInOrbit);
         }
 
         // A-mask
         if (zna && maskA) {
           histos.get<TH1>(HIST("hCounterZNAselA"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNAselA"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNAselA"), ZNAselA, secFromSOR, bcInOrbit);
         }
         if (znc && maskA) {
           histos.get<TH1>(HIST("hCounterZNCselA"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNCselA"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNCselA"), ZNCselA, secFromSOR, bcInOrbit);
         }
         if (zem && maskA) {
           histos.get<TH1>(HIST("hCounterZEMselA"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZEMselA"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZEMselA"), ZEMselA, secFromSOR, bcInOrbit);
         }
 
         // C-mask
         if (zna && maskC) {
           histos.get<TH1>(HIST("hCounterZNAselC"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNAselC"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNAselC"), ZNAselC, secFromSOR, bcInOrbit);
         }
         if (znc && maskC) {
           histos.get<TH1>(HIST("hCounterZNCselC"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZNCselC"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZNCselC"), ZNCselC, secFromSOR, bcInOrbit);
         }
         if (zem && maskC) {
           histos.get<TH1>(HIST("hCounterZEMselC"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsZEMselC"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsZEMselC"), ZEMselC, secFromSOR, bcInOrbit);
         }
       }
 
@@ -325,17 +357,17 @@ struct LumiQaTask {
           histos.fill(HIST("hMultVCHselTVXB"), multV0A);
           histos.fill(HIST("hCentVCHselTVXB"), centV0A);
           histos.get<TH1>(HIST("hCounterVCHselB"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsVCHselB"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsVCHselB"), VCHselB, secFromSOR, bcInOrbit);
         }
 
         if (tvx && maskA && vch) {
           histos.get<TH1>(HIST("hCounterVCHselA"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsVCHselA"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsVCHselA"), VCHselA, secFromSOR, bcInOrbit);
         }
 
         if (tvx && maskC && vch) {
           histos.get<TH1>(HIST("hCounterVCHselC"))->Fill(srun, 1);
-          histos.fill(HIST("hSecondsBcsVCHselC"), secFromSOR, bcInOrbit);
+          fillSecondsBcs(HIST("hSecondsBcsVCHselC"), VCHselC, secFromSOR, bcInOrbit);
         }
 
         if (tvx && maskB && zac) {
@@ -393,10 +425,17 @@ struct LumiQaTask {
         histos.fill(HIST("hMultT0CselTVXTCEB"), multT0C);
         histos.fill(HIST("hCentT0CselTVXTCEB"), centT0C);
         histos.get<TH1>(HIST("hCounterTCEselB"))->Fill(srun, 1);
-        histos.fill(HIST("hSecondsBcsTCEselB"), secFromSOR, bcInOrbit);
+        fillSecondsBcs(HIST("hSecondsBcsTCEselB"), TCEselB, secFromSOR, bcInOrbit);
       }
     } // bc loop
   } // process
+
+  void endOfStream(EndOfStreamContext&)
+  {
+    for (auto& accumulator : accumulators) {
+      accumulator.flush();
+    }
+  }
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
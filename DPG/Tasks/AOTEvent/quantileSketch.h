@@ -0,0 +1,136 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file quantileSketch.h
+/// \brief Quantile sketches of the DPG QA distributions
+///
+/// A sketch stores a distribution in logarithmic bins (as the DDSketch): the upper edge of each bin is
+/// gamma = (1 + alpha) / (1 - alpha) times its lower edge, so that any quantile of the values above minValue in
+/// absolute value is estimated with a relative error below alpha, whatever the shape of the distribution. The values
+/// below minValue in absolute value are counted in a single zero bin. The sketch is a TH1D of the histogram registry
+/// of the task: it is merged exactly across jobs by adding the histograms, and needs about
+/// ln(maxValue / minValue) / (2 alpha) bins, e.g. 480 bins for a 1% accuracy on the occupancy in [1, 15000],
+/// instead of the fine histograms booked to extract the medians and the tails.
+
+#ifndef DPG_TASKS_AOTEVENT_QUANTILESKETCH_H_
+#define DPG_TASKS_AOTEVENT_QUANTILESKETCH_H_
+
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
+#include <Framework/Logger.h>
+
+#include <TAxis.h>
+#include <TH1.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::dpg_quantiles
+{
+/// \return bin edges of a sketch
+/// \param relativeAccuracy relative accuracy alpha of the quantiles
+/// \param minValue lowest absolute value resolved, the values below are counted in the zero bin
+/// \param maxValue highest absolute value resolved, the values above are counted in the overflow
+/// \param isSigned the sketch also resolves the negative values
+inline std::vector<double> sketchBinEdges(double relativeAccuracy, double minValue, double maxValue, bool isSigned)
+{
+  if (!(relativeAccuracy > 0. && relativeAccuracy < 1. && minValue > 0. && maxValue > minValue)) {
+    LOGF(fatal, "Invalid quantile sketch: accuracy %g, range [%g, %g]", relativeAccuracy, minValue, maxValue);
+  }
+  const double gamma = (1. + relativeAccuracy) / (1. - relativeAccuracy);
+  const int nBins = std::ceil(std::log(maxValue / minValue) / std::log(gamma));
+  std::vector<double> positiveEdges(nBins + 1);
+  for (int i = 0; i <= nBins; i++) {
+    positiveEdges[i] = minValue * std::pow(gamma, i);
+  }
+  std::vector<double> edges;
+  if (isSigned) {
+    for (auto it = positiveEdges.rbegin(); it != positiveEdges.rend(); ++it) {
+      edges.push_back(-*it);
+    }
+  } else {
+    edges.push_back(0.);
+  }
+  edges.insert(edges.end(), positiveEdges.begin(), positiveEdges.end());
+  return edges;
+}
+
+/// \return estimate of the q-quantile of a sketch, NaN if the sketch is empty
+/// \param sketch histogram booked with the bin edges of sketchBinEdges
+/// \param q quantile probability, in [0, 1]
+inline double sketchQuantile(const TH1& sketch, double q)
+{
+  const TAxis* axis = sketch.GetXaxis();
+  const int nBins = axis->GetNbins();
+  const double total = sketch.Integral(0, nBins + 1);
+  if (total <= 0.) {
+    return std::numeric_limits<double>::quiet_NaN();
+  }
+  const double rank = std::clamp(q, 0., 1.) * total;
+  double cumulated = 0.;
+  int bin = 0;
+  for (; bin <= nBins; bin++) {
+    cumulated += sketch.GetBinContent(bin);
+    if (cumulated >= rank && cumulated > 0.) {
+      break;
+    }
+  }
+  if (bin == 0) {
+    return axis->GetXmin();
+  } else if (bin > nBins) {
+    return axis->GetXmax();
+  }
+  const double low = axis->GetBinLowEdge(bin);
+  const double up = axis->GetBinUpEdge(bin);
+  if (low * up <= 0.) {
+    return 0.; // zero bin
+  }
+  return 2. * low * up / (low + up); // within the relative accuracy of both edges
+}
+
+class QuantileSketch
+{
+ public:
+  /// Books the sketch in a histogram registry
+  /// \param registry histogram registry of the task
+  /// \param name name of the histogram
+  /// \param title title of the monitored quantity
+  /// \param relativeAccuracy relative accuracy alpha of the quantiles
+  /// \param minValue lowest absolute value resolved, the values below are counted in the zero bin
+  /// \param maxValue highest absolute value resolved
+  /// \param isSigned the sketch also resolves the negative values
+  void init(o2::framework::HistogramRegistry& registry, const std::string& name, const std::string& title, double relativeAccuracy, double minValue, double maxValue, bool isSigned = false)
+  {
+    const o2::framework::AxisSpec axis{sketchBinEdges(relativeAccuracy, minValue, maxValue, isSigned), title};
+    mSketch = registry.add<TH1>(name.c_str(), (title + " quantile sketch").c_str(), o2::framework::HistType::kTH1D, {axis});
+  }
+
+  /// Adds a value to the sketch, if booked
+  void fill(double value)
+  {
+    if (mSketch) {
+      mSketch->Fill(value);
+    }
+  }
+
+  /// \return estimate of the q-quantile of the values added so far
+  double quantile(double q) const { return mSketch ? sketchQuantile(*mSketch, q) : std::numeric_limits<double>::quiet_NaN(); }
+
+ private:
+  std::shared_ptr<TH1> mSketch; // sketch histogram, owned by the registry
+};
+} // namespace o2::dpg_quantiles
+
+#endif // DPG_TASKS_AOTEVENT_QUANTILESKETCH_H_
@@ -16,6 +16,7 @@
 
 #include "Common/CCDB/EventSelectionParams.h"
 #include "Common/DataModel/EventSelection.h"
+#include "DPG/Tasks/AOTEvent/quantileSketch.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
@@ -56,6 +57,8 @@ struct RofOccupancyQaTask {
   Configurable<float> confEpsilonVzDiffVetoInROF{"EpsilonVzDiffVetoInROF", 0.3, "Minumum distance to nearby collisions along z inside this ITS ROF, cm"};                                       // o2-linter: disable=name/configurable
   Configurable<bool> confUseWeightsForOccupancyVariable{"UseWeightsForOccupancyEstimator", 1, "Use or not the delta-time weights for the occupancy estimator"};                                 // o2-linter: disable=name/configurable
   Configurable<float> confFactorForHistRange{"kFactorForHistRange", 1.0, "To change axes b/n pp and Pb-Pb"};                                                                                    // o2-linter: disable=name/configurable
+  Configurable<bool> confFlagFillQuantileSketches{"FlagFillQuantileSketches", false, "Fill quantile sketches of the occupancy and multiplicity distributions of sel8 collisions"};              // o2-linter: disable=name/configurable
+  Configurable<float> confQuantileSketchAccuracy{"QuantileSketchAccuracy", 0.01, "Relative accuracy of the quantiles of the sketches"};                                                         // o2-linter: disable=name/configurable
 
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
@@ -68,6 +71,10 @@ struct RofOccupancyQaTask {
   int rofOffset = -1;     // ITS ROF offset, in bc
   int rofLength = -1;     // ITS ROF length, in bc
 
+  o2::dpg_quantiles::QuantileSketch sketchOccupancyByTracks;
+  o2::dpg_quantiles::QuantileSketch sketchOccupancyByFT0C;
+  o2::dpg_quantiles::QuantileSketch sketchNumTracksPV;
+
   void init(InitContext&)
   {
     ccdb->setURL("http://alice-ccdb.cern.ch");
@@ -290,6 +297,12 @@ struct RofOccupancyQaTask {
     //
     histos.add("hNcollPerROF", "", kTH1D, {{16, -0.5, 15.5}});
 
+    if (confFlagFillQuantileSketches) {
+      sketchOccupancyByTracks.init(histos, "sketchOccupancyByTracks", "occupancy by tracks", confQuantileSketchAccuracy, 1., 15000. * k);
+      sketchOccupancyByFT0C.init(histos, "sketchOccupancyByFT0C", "occupancy by FT0C", confQuantileSketchAccuracy, 1., 150000. * k);
+      sketchNumTracksPV.init(histos, "sketchNumTracksPV", "n ITS567 PV tracks", confQuantileSketchAccuracy, 1., 10000. * k);
+    }
+
     // ROF-by-ROF study:
     histos.add("ROFbyROF/nPV_vs_ROFid", "", kTH2D, {{800, 0., 8000 * k}, {10, -0.5, 9.5}});
     histos.add("ROFbyROF/nPV_vs_subROFid", "", kTH2D, {{800, 0., 8000 * k}, {20, -0.5, 19.5}});
@@ -960,6 +973,9 @@ struct RofOccupancyQaTask {
 
         int nPV = vTracksITS567perColl[colIndex];
         float ft0C = vAmpFT0CperColl[colIndex];
+        sketchOccupancyByTracks.fill(occTracks);
+        sketchOccupancyByFT0C.fill(occFT0C);
+        sketchNumTracksPV.fill(nPV);
 
         // ROF-by-ROF
         if (std::fabs(vZ) < 8) {
@@ -20,6 +20,7 @@
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/Multiplicity.h"
 #include "Common/DataModel/TrackSelectionTables.h"
+#include "DPG/Tasks/AOTEvent/timeSeriesAccumulator.h"
 
 #include <CCDB/BasicCCDBManager.h>
 #include <CommonConstants/LHCConstants.h>
@@ -29,6 +30,7 @@
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
+#include <Framework/EndOfStreamContext.h>
 #include <Framework/HistogramRegistry.h>
 #include <Framework/HistogramSpec.h>
 #include <Framework/InitContext.h>
@@ -39,11 +41,13 @@
 
 #include <TAxis.h>
 #include <TH2.h>
+#include <THnSparse.h>
 #include <TMath.h>
 #include <TTree.h>
 
 #include <sys/types.h>
 
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <string>
@@ -76,6 +80,7 @@ struct TimeDependentQaTask {
   Configurable<float> confCutOnNtpcClsForSharedFractAndDeDxCalc{"CutOnNtpcClsForSharedFractAndDeDxCalc", 70, ""};                                                                // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagCheckMshape{"FlagCheckMshape", 0, "0 - don't check , 1 - check"};                                                                                    // o2-linter: disable=name/configurable (temporary fix)
   Configurable<int> confFlagCheckQoverPtHist{"FlagCheckQoverPtHist", 1, "0 - don't check , 1 - check"};                                                                          // o2-linter: disable=name/configurable (temporary fix)
+  Configurable<bool> confUseTimeSeriesAccumulators{"UseTimeSeriesAccumulators", false, "Fill the phi and BC maps vs time as THnSparse through streaming accumulators"};          // o2-linter: disable=name/configurable (temporary fix)
 
   // for O-O and Ne-Ne run
   Configurable<int> confIncludeMultDistrVsTimeHistos{"IncludeMultDistrVsTimeHistos", 0, ""};                                                                    // o2-linter: disable=name/configurable (temporary fix)
@@ -125,6 +130,22 @@ struct TimeDependentQaTask {
     enNumRctFlagsTotal, // counter
   };
 
+  enum TimeSeriesMaps {
+    enITSlayer0vsPhi = 0,
+    enITSlayer1vsPhi,
+    enITSlayer2vsPhi,
+    enITSlayer3vsPhi,
+    enITSlayer4vsPhi,
+    enITSlayer5vsPhi,
+    enITSlayer6vsPhi,
+    enITS7clsVsPhi,
+    enITSglobalVsPhi,
+    enITSTRDVsPhi,
+    enITSTOFVsPhi,
+    enBCsMap,
+    enNumTimeSeriesMaps, // counter
+  };
+
   Service<o2::ccdb::BasicCCDBManager> ccdb;
   HistogramRegistry histos{"Histos", {}, OutputObjHandlingPolicy::AnalysisObject};
   o2::tpc::TPCMShapeCorrection mshape; // object for simple access
@@ -146,6 +167,28 @@ struct TimeDependentQaTask {
 
   TAxis* axRctFlags;
 
+  // accumulators of the maps vs time, used instead of direct fills if confUseTimeSeriesAccumulators
+  std::array<o2::dpg_timeseries::TimeSeriesAccumulator, enNumTimeSeriesMaps> accumulators;
+
+  void addTimeMap(const char* name, TimeSeriesMaps map, const std::vector<AxisSpec>& axes)
+  {
+    if (confUseTimeSeriesAccumulators) {
+      accumulators[map].bind(histos.add<THnSparse>(name, "", kTHnSparseF, axes).get());
+    } else {
+      histos.add(name, "", kTH2F, axes);
+    }
+  }
+
+  template <char... chars>
+  void fillTimeMap(const ConstStr<chars...>& name, TimeSeriesMaps map, double secFromSOR, double value)
+  {
+    if (confUseTimeSeriesAccumulators) {
+      accumulators[map].fill(secFromSOR, value);
+    } else {
+      histos.fill(name, secFromSOR, value);
+    }
+  }
+
   void init(InitContext&)
   {
     ccdb->setURL("http://alice-ccdb.cern.ch");
@@ -242,7 +285,7 @@ struct TimeDependentQaTask {
 
       const int32_t nBCsPerOrbit = o2::constants::lhc::LHCMaxBunches;
       const AxisSpec axisBCs{nBCsPerOrbit, 0., static_cast<double>(nBCsPerOrbit), ""};
-      histos.add("hSecondsBCsMap", "", kTH2F, {axisSecondsSuperWideBins, axisBCs});
+      addTimeMap("hSecondsBCsMap", enBCsMap, {axisSecondsSuperWideBins, axisBCs});
 
       // shapes of distributions (added for the O-O run monitoring)
       if (confIncludeMultDistrVsTimeHistos) {
@@ -463,19 +506,19 @@ struct TimeDependentQaTask {
       const AxisSpec axisPhi{64, 0, TMath::TwoPi(), "#varphi"}; // o2-linter: disable=external-pi (temporary fix)
       const AxisSpec axisEta{10, -0.8, 0.8, "#eta"};
       if (confFlagFillPhiVsTimeHist == 2) {
-        histos.add("hSecondsITSlayer0vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer1vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer2vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer3vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer4vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer5vsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSlayer6vsPhi", "", kTH2F, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer0vsPhi", enITSlayer0vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer1vsPhi", enITSlayer1vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer2vsPhi", enITSlayer2vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer3vsPhi", enITSlayer3vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer4vsPhi", enITSlayer4vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer5vsPhi", enITSlayer5vsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSlayer6vsPhi", enITSlayer6vsPhi, {axisSeconds, axisPhi});
       }
       if (confFlagFillPhiVsTimeHist > 0) {
-        histos.add("hSecondsITS7clsVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSglobalVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSTRDVsPhi", "", kTH2F, {axisSeconds, axisPhi});
-        histos.add("hSecondsITSTOFVsPhi", "", kTH2F, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITS7clsVsPhi", enITS7clsVsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSglobalVsPhi", enITSglobalVsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSTRDVsPhi", enITSTRDVsPhi, {axisSeconds, axisPhi});
+        addTimeMap("hSecondsITSTOFVsPhi", enITSTOFVsPhi, {axisSeconds, axisPhi});
       }
       if (confFlagFillEtaPhiVsTimeHist)
         histos.add("hSecondsITSglobalVsEtaPhi", "", kTH3F, {axisSeconds, axisEta, axisPhi});
@@ -491,7 +534,7 @@ struct TimeDependentQaTask {
 
         uint64_t globalBC = bc.globalBC();
         int localBC = globalBC % nBCsPerOrbit;
-        histos.fill(HIST("hSecondsBCsMap"), secFromSOR, localBC);
+        fillTimeMap(HIST("hSecondsBCsMap"), enBCsMap, secFromSOR, localBC);
 
         if (bc.selection_bit(kNoTimeFrameBorder)) {
           histos.fill(HIST("hSecondsBCsTVXandTFborderCuts"), secFromSOR);
@@ -791,30 +834,30 @@ struct TimeDependentQaTask {
           // layer-by-layer check
           if (confFlagFillPhiVsTimeHist == 2) {
             if (track.itsClusterMap() & (1 << 0))
-              histos.fill(HIST("hSecondsITSlayer0vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer0vsPhi"), enITSlayer0vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 1))
-              histos.fill(HIST("hSecondsITSlayer1vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer1vsPhi"), enITSlayer1vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 2))
-              histos.fill(HIST("hSecondsITSlayer2vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer2vsPhi"), enITSlayer2vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 3))
-              histos.fill(HIST("hSecondsITSlayer3vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer3vsPhi"), enITSlayer3vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 4))
-              histos.fill(HIST("hSecondsITSlayer4vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer4vsPhi"), enITSlayer4vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 5))
-              histos.fill(HIST("hSecondsITSlayer5vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer5vsPhi"), enITSlayer5vsPhi, secFromSOR, track.phi());
             if (track.itsClusterMap() & (1 << 6))
-              histos.fill(HIST("hSecondsITSlayer6vsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSlayer6vsPhi"), enITSlayer6vsPhi, secFromSOR, track.phi());
           }
           // tracks with conditions
           if (confFlagFillPhiVsTimeHist > 0) {
             if (track.itsNCls() == 7)
-              histos.fill(HIST("hSecondsITS7clsVsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITS7clsVsPhi"), enITS7clsVsPhi, secFromSOR, track.phi());
             if (track.isGlobalTrack())
-              histos.fill(HIST("hSecondsITSglobalVsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSglobalVsPhi"), enITSglobalVsPhi, secFromSOR, track.phi());
             if (track.hasTRD())
-              histos.fill(HIST("hSecondsITSTRDVsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSTRDVsPhi"), enITSTRDVsPhi, secFromSOR, track.phi());
             if (track.hasTOF())
-              histos.fill(HIST("hSecondsITSTOFVsPhi"), secFromSOR, track.phi());
+              fillTimeMap(HIST("hSecondsITSTOFVsPhi"), enITSTOFVsPhi, secFromSOR, track.phi());
           }
           // eta-phi histogram for global tracks
           if (confFlagFillEtaPhiVsTimeHist && track.isGlobalTrack()) {
@@ -890,6 +933,13 @@ struct TimeDependentQaTask {
     }
   } // end of collision loop
   PROCESS_SWITCH(TimeDependentQaTask, processRun3, "Process Run3 QA vs time", true);
+
+  void endOfStream(EndOfStreamContext&)
+  {
+    for (auto& accumulator : accumulators) {
+      accumulator.flush();
+    }
+  }
 };
 
 WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
@@ -0,0 +1,180 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file timeSeriesAccumulator.h
+/// \brief Streaming accumulator of the time-dependent QA maps
+///
+/// The entries of a time-dependent map (time on the first axis, a monitored quantity on the second axis) are summed
+/// in dense blocks of consecutive time bins. Only a few blocks are active at a time: when the time advances beyond
+/// them, the oldest block is added to the output THnSparse and reused. The memory is therefore constant whatever the
+/// length of the run and the width of the time bins, and the output stores only the time intervals which were seen.
+/// The distribution of the monitored quantity in each time interval (its counts, mean, RMS and quantiles) is kept in
+/// the bins of the second axis. The bin contents, the squared weights and the number of entries are the same as if
+/// the entries were filled one by one, the sums of the weights times the coordinates are not updated, as in
+/// THnBase::Add. The accumulator must be flushed before the output is written, e.g. at the end of the stream.
+
+#ifndef DPG_TASKS_AOTEVENT_TIMESERIESACCUMULATOR_H_
+#define DPG_TASKS_AOTEVENT_TIMESERIESACCUMULATOR_H_
+
+#include <Framework/Logger.h>
+
+#include <TAxis.h>
+#include <THnSparse.h>
+
+#include <RtypesCore.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace o2::dpg_timeseries
+{
+class TimeSeriesAccumulator
+{
+ public:
+  /// Binds the accumulator to an output map, the pending entries are flushed to the previous one
+  /// \param hist output map, with fixed bins, the time on the first axis and the monitored quantity on the second axis
+  void bind(THnSparse* hist)
+  {
+    if (hist == mHist) {
+      return;
+    }
+    flush();
+    mHist = hist;
+    if (hist->GetNdimensions() != NAxes) {
+      LOGF(fatal, "The time-dependent map %s must have %d axes", hist->GetName(), NAxes);
+    }
+    for (int i = 0; i < NAxes; i++) {
+      const TAxis* axis = hist->GetAxis(i);
+      if (axis->GetXbins()->fN) {
+        LOGF(fatal, "The axes of the time-dependent map %s must have fixed bins", hist->GetName());
+      }
+      mAxes[i] = {axis->GetNbins(), axis->GetXmin(), axis->GetXmax()};
+    }
+    mNcells = mAxes[1].nbins + 2; // including under/overflow
+    mHasErrors = hist->GetCalculateErrors();
+    for (auto& block : mBlocks) {
+      block.firstTimeBin = -1;
+      block.sumw.assign(BlockSize * mNcells, 0.);
+      block.sumw2.assign(mHasErrors ? BlockSize * mNcells : 0, 0.);
+    }
+    mLastBlock = 0;
+  }
+
+  /// Fills an entry, as THnSparse::Fill(time, value, weight)
+  void fill(double time, double value, double weight = 1.)
+  {
+    const Long64_t timeBin = mAxes[0].findBin(time);
+    Block& block = getBlock(timeBin - timeBin % BlockSize);
+    const std::size_t cell = (timeBin - block.firstTimeBin) * mNcells + mAxes[1].findBin(value);
+    block.sumw[cell] += weight;
+    if (mHasErrors) {
+      block.sumw2[cell] += weight * weight;
+    }
+    block.nEntries++;
+  }
+
+  /// Adds the pending entries to the output map
+  void flush()
+  {
+    for (auto& block : mBlocks) {
+      flushBlock(block);
+    }
+  }
+
+ private:
+  static constexpr int NAxes = 2;           // time and monitored quantity
+  static constexpr Long64_t BlockSize = 64; // number of time bins per block
+  static constexpr std::size_t NBlocks = 4; // number of active blocks
+
+  struct Axis {
+    int nbins = 0;   // number of bins
+    double min = 0.; // lower edge
+    double max = 0.; // upper edge
+
+    /// \return the bin of a value, as TAxis::FindBin
+    int findBin(double x) const
+    {
+      if (x < min) {
+        return 0;
+      } else if (!(x < max)) {
+        return nbins + 1;
+      }
+      return 1 + static_cast<int>(nbins * (x - min) / (max - min));
+    }
+  };
+
+  struct Block {
+    Long64_t firstTimeBin = -1; // first time bin of the block, -1 if the block is free
+    std::vector<double> sumw;   // sum of the weights per (time bin, value bin)
+    std::vector<double> sumw2;  // sum of the squared weights per (time bin, value bin)
+    Long64_t nEntries = 0;      // number of pending entries
+  };
+
+  /// \return the active block starting at a time bin, the oldest block is flushed and reused if none is active
+  Block& getBlock(Long64_t firstTimeBin)
+  {
+    if (mBlocks[mLastBlock].firstTimeBin == firstTimeBin) {
+      return mBlocks[mLastBlock];
+    }
+    std::size_t iReused = 0;
+    for (std::size_t i = 0; i < NBlocks; i++) {
+      if (mBlocks[i].firstTimeBin == firstTimeBin) {
+        mLastBlock = i;
+        return mBlocks[i];
+      }
+      if (mBlocks[i].firstTimeBin < mBlocks[iReused].firstTimeBin) {
+        iReused = i; // free blocks first, then the oldest one
+      }
+    }
+    Block& block = mBlocks[iReused];
+    flushBlock(block);
+    block.firstTimeBin = firstTimeBin;
+    mLastBlock = iReused;
+    return block;
+  }
+
+  /// Adds the entries of a block to the output map and frees the block
+  void flushBlock(Block& block)
+  {
+    if (block.nEntries) {
+      for (std::size_t cell = 0; cell < block.sumw.size(); cell++) {
+        if (block.sumw[cell] == 0. && (!mHasErrors || block.sumw2[cell] == 0.)) {
+          continue;
+        }
+        mCoordinates[0] = block.firstTimeBin + cell / mNcells;
+        mCoordinates[1] = cell % mNcells;
+        const Long64_t globalBin = mHist->GetBin(mCoordinates.data(), kTRUE);
+        if (mHasErrors) {
+          mHist->AddBinError2(globalBin, block.sumw2[cell]);
+          block.sumw2[cell] = 0.;
+        }
+        // only after the errors, as in THnBase::Add
+        mHist->AddBinContent(globalBin, block.sumw[cell]);
+        block.sumw[cell] = 0.;
+      }
+      mHist->SetEntries(mHist->GetEntries() + block.nEntries);
+      block.nEntries = 0;
+    }
+    block.firstTimeBin = -1;
+  }
+
+  THnSparse* mHist = nullptr;              // output map the accumulator is bound to
+  std::array<Axis, NAxes> mAxes;           // binning of the axes
+  std::size_t mNcells = 0;                 // number of value bins per time bin, including under/overflow
+  bool mHasErrors = false;                 // the squared weights are summed
+  std::array<Block, NBlocks> mBlocks;      // active blocks
+  std::size_t mLastBlock = 0;              // last block filled
+  std::array<Int_t, NAxes> mCoordinates{}; // bin of each axis, for the flush
+};
+} // namespace o2::dpg_timeseries
+
+#endif // DPG_TASKS_AOTEVENT_TIMESERIESACCUMULATOR_H_
@@ -143,6 +143,16 @@ struct DerivedDataCreatorD0Calibration {
 
   OutputObj<TH1D> histDownSampl{"histDownSampl"};
 
+  /// Track passing the single-track selections, with the quantities used by the pairing
+  template <typename TTrack>
+  struct PreselectedTrack {
+    TTrack track;                       // track row
+    o2::track::TrackParCov trackParCov; // track parameters propagated to the DCA to the primary vertex
+    o2::dataformats::DCA dca;           // DCA to the primary vertex
+    int pidKaon{-1};                    // kaon PID status
+    int pidPion{-1};                    // pion PID status
+  };
+
   void init(InitContext const&)
   {
     // First we set the CCDB manager
@@ -194,6 +204,9 @@ struct DerivedDataCreatorD0Calibration {
     std::map<int, int> selectedCollisions; // map with indices of selected collisions (key: original AOD Collision table index, value: D0 collision index)
     std::map<int, int> selectedTracks;     // map with indices of selected tracks (key: original AOD Track table index, value: D0 daughter track index)
 
+    std::vector<PreselectedTrack<typename TTracks::iterator>> positiveTracks; // positive tracks of the collision passing the single-track selections
+    std::vector<PreselectedTrack<typename TTracks::iterator>> negativeTracks; // negative tracks of the collision passing the single-track selections
+
     for (auto const& collision : collisions) {
 
       // minimal event selection
@@ -215,78 +228,58 @@ struct DerivedDataCreatorD0Calibration {
       o2::InteractionRecord eventIR;
       eventIR.setFromLong(bc.globalBC());
 
+      // single-track selections, once per track of the collision instead of once per pair
+      positiveTracks.clear();
+      negativeTracks.clear();
       auto groupedTrackIndices = trackIndices.sliceBy(trackIndicesPerCollision, collision.globalIndex());
-      for (auto const& trackIndexPos : groupedTrackIndices) {
-        auto trackPos = trackIndexPos.template track_as<TTracks>();
+      for (auto const& trackIndex : groupedTrackIndices) {
+        auto track = trackIndex.template track_as<TTracks>();
         // track selections
-        if (trackPos.sign() < 0) { // first positive track
+        if (!track.isGlobalTrackWoDCA()) {
           continue;
         }
-        if (!trackPos.isGlobalTrackWoDCA()) {
+        if (track.pt() < cfgTrackCuts.ptMin) {
           continue;
         }
-        if (trackPos.pt() < cfgTrackCuts.ptMin) {
+        if (std::abs(track.eta()) > cfgTrackCuts.absEtaMax) {
           continue;
         }
-        if (std::abs(trackPos.eta()) > cfgTrackCuts.absEtaMax) {
-          continue;
-        }
-        auto trackParCovPos = getTrackParCov(trackPos);
-        o2::dataformats::DCA dcaPos;
-        trackParCovPos.propagateToDCA(primaryVertex, bz, &dcaPos);
-        if (!isSelectedTrackDca(cfgTrackCuts.binsPt, cfgTrackCuts.limitsDca, trackParCovPos.getPt(), dcaPos.getY(), dcaPos.getZ())) {
+        auto trackParCov = getTrackParCov(track);
+        o2::dataformats::DCA dca;
+        trackParCov.propagateToDCA(primaryVertex, bz, &dca);
+        if (!isSelectedTrackDca(cfgTrackCuts.binsPt, cfgTrackCuts.limitsDca, trackParCov.getPt(), dca.getY(), dca.getZ())) {
           continue;
         }
 
-        int pidTrackPosKaon{-1};
-        int pidTrackPosPion{-1};
+        int pidTrackKaon{-1};
+        int pidTrackPion{-1};
         if (cfgTrackCuts.usePidTpcOnly) {
-          /// kaon TPC PID positive daughter
-          pidTrackPosKaon = selectorKaon.statusTpc(trackPos);
-          /// pion TPC PID positive daughter
-          pidTrackPosPion = selectorPion.statusTpc(trackPos);
+          /// kaon TPC PID
+          pidTrackKaon = selectorKaon.statusTpc(track);
+          /// pion TPC PID
+          pidTrackPion = selectorPion.statusTpc(track);
         } else {
-          /// kaon TPC, TOF PID positive daughter
-          pidTrackPosKaon = selectorKaon.statusTpcAndTof(trackPos);
-          /// pion TPC, TOF PID positive daughter
-          pidTrackPosPion = selectorPion.statusTpcAndTof(trackPos);
+          /// kaon TPC, TOF PID
+          pidTrackKaon = selectorKaon.statusTpcAndTof(track);
+          /// pion TPC, TOF PID
+          pidTrackPion = selectorPion.statusTpcAndTof(track);
         }
+        (track.sign() > 0 ? positiveTracks : negativeTracks).push_back({track, trackParCov, dca, pidTrackKaon, pidTrackPion});
+      }
 
-        for (auto const& trackIndexNeg : groupedTrackIndices) {
-          auto trackNeg = trackIndexNeg.template track_as<TTracks>();
-          // track selections
-          if (trackNeg.sign() > 0) { // second negative track
-            continue;
-          }
-          if (!trackNeg.isGlobalTrackWoDCA()) {
-            continue;
-          }
-          if (trackNeg.pt() < cfgTrackCuts.ptMin) {
-            continue;
-          }
-          if (std::abs(trackNeg.eta()) > cfgTrackCuts.absEtaMax) {
-            continue;
-          }
-          auto trackParCovNeg = getTrackParCov(trackNeg);
-          o2::dataformats::DCA dcaNeg;
-          trackParCovNeg.propagateToDCA(primaryVertex, bz, &dcaNeg);
-          if (!isSelectedTrackDca(cfgTrackCuts.binsPt, cfgTrackCuts.limitsDca, trackParCovNeg.getPt(), dcaNeg.getY(), dcaNeg.getZ())) {
-            continue;
-          }
-
-          int pidTrackNegKaon{-1};
-          int pidTrackNegPion{-1};
-          if (cfgTrackCuts.usePidTpcOnly) {
-            /// kaon TPC PID negative daughter
-            pidTrackNegKaon = selectorKaon.statusTpc(trackNeg);
-            /// pion TPC PID negative daughter
-            pidTrackNegPion = selectorPion.statusTpc(trackNeg);
-          } else {
-            /// kaon TPC, TOF PID negative daughter
-            pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg);
-            /// pion TPC, TOF PID negative daughter
-            pidTrackNegPion = selectorPion.statusTpcAndTof(trackNeg);
-          }
+      for (auto const& preselectedPos : positiveTracks) { // first positive track
+        auto const& trackPos = preselectedPos.track;
+        auto const& trackParCovPos = preselectedPos.trackParCov;
+        auto const& dcaPos = preselectedPos.dca;
+        const int pidTrackPosKaon = preselectedPos.pidKaon;
+        const int pidTrackPosPion = preselectedPos.pidPion;
+
+        for (auto const& preselectedNeg : negativeTracks) { // second negative track
+          auto const& trackNeg = preselectedNeg.track;
+          auto const& trackParCovNeg = preselectedNeg.trackParCov;
+          auto const& dcaNeg = preselectedNeg.dca;
+          const int pidTrackNegKaon = preselectedNeg.pidKaon;
+          const int pidTrackNegPion = preselectedNeg.pidPion;
 
           // preselections
           // PID
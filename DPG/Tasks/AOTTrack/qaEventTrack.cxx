@@ -43,7 +43,9 @@
 
 #include <algorithm>
 #include <array>
+#include <bit>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
 #include <string>
@@ -159,6 +161,21 @@ struct qaEventTrack {
 
   HistogramRegistry histos;
 
+  // per-track quantities of the tracks of a collision, computed once and read by all the fills of the collision
+  struct TrackColumns {
+    std::vector<uint8_t> isSelected; // passes the PV contributor check and isSelectedTrack
+    std::vector<float> pt;           // transverse momentum
+    std::vector<float> eta;          // pseudorapidity
+    std::vector<float> phi;          // azimuthal angle
+    void clear()
+    {
+      isSelected.clear();
+      pt.clear();
+      eta.clear();
+      phi.clear();
+    }
+  } trackColumns;
+
   Preslice<aod::McParticles> perMcCollision = aod::mcparticle::mcCollisionId;
   Preslice<aod::Tracks> perRecoCollision = aod::track::collisionId;
 
@@ -678,6 +695,12 @@ struct qaEventTrack {
     }
   }
 
+  /// \return number of ITS layers with a cluster
+  static int countItsHits(const uint8_t itsClusterMap)
+  {
+    return std::popcount(static_cast<uint8_t>(itsClusterMap & 0x7F));
+  }
+
   // Function to select tracks
   template <bool IS_MC, typename T>
   bool isSelectedTrack(const T& track)
@@ -1316,7 +1339,12 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
 
   int nFilteredTracks = 0;
   int atLeastITSTracks = 0;
+  trackColumns.clear();
   for (const auto& track : tracks) {
+    trackColumns.isSelected.push_back(false);
+    trackColumns.pt.push_back(track.pt());
+    trackColumns.eta.push_back(track.eta());
+    trackColumns.phi.push_back(track.phi());
     if (checkOnlyPVContributor && !track.isPVContributor()) {
       continue;
     }
@@ -1327,6 +1355,7 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
     if (!isSelectedTrack<IS_MC>(track)) {
       continue;
     }
+    trackColumns.isSelected.back() = true;
     histos.fill(HIST("Tracks/selection"), 2.f);
     ++nFilteredTracks;
     if (track.passedTrackType()) {
@@ -1509,12 +1538,7 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
       histos.fill(HIST("Tracks/Kine/ptUnfilteredNegative"), trackUnfiltered.pt());
     }
     // fill ITS variables
-    int itsNhits = 0;
-    for (unsigned int i = 0; i < 7; i++) {
-      if (trackUnfiltered.itsClusterMap() & (1 << i)) {
-        itsNhits += 1;
-      }
-    }
+    const int itsNhits = countItsHits(trackUnfiltered.itsClusterMap());
     bool trkHasITS = false;
     for (unsigned int i = 0; i < 7; i++) {
       if (trackUnfiltered.itsClusterMap() & (1 << i)) {
@@ -1541,13 +1565,16 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
   histos.fill(HIST("Events/nContribAllvsWithTRD"), collision.numContrib(), nPvContrWithTRD);
 
   // track related histograms
+  std::size_t iTrack = 0;
   for (const auto& track : tracks) {
-    if (checkOnlyPVContributor && !track.isPVContributor()) {
-      continue;
-    }
-    if (!isSelectedTrack<IS_MC>(track)) {
+    const std::size_t iColumn = iTrack++;
+    if (!trackColumns.isSelected[iColumn]) {
       continue;
     }
+    const float pt = trackColumns.pt[iColumn];
+    const float eta = trackColumns.eta[iColumn];
+    const float phi = trackColumns.phi[iColumn];
+    const float relativeResoPt = pt * std::sqrt(track.c1Pt21Pt2());
     // TRD checks (debug)
     if (checksTRD.activateChecksTRD) {
       if (checksTRD.forceTRD && !track.hasTRD()) {
@@ -1560,33 +1587,32 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
       }
     }
     // fill kinematic variables
-    histos.fill(HIST("Tracks/Kine/pt"), track.pt());
+    histos.fill(HIST("Tracks/Kine/pt"), pt);
     if (track.sign() > 0) {
-      histos.fill(HIST("Tracks/Kine/ptFilteredPositive"), track.pt());
+      histos.fill(HIST("Tracks/Kine/ptFilteredPositive"), pt);
     } else {
-      histos.fill(HIST("Tracks/Kine/ptFilteredNegative"), track.pt());
-    }
-    histos.fill(HIST("Tracks/Kine/eta"), track.eta());
-    histos.fill(HIST("Tracks/Kine/phi"), track.phi());
-    histos.fill(HIST("Tracks/Kine/etavsphi"), track.eta(), track.phi());
-    histos.fill(HIST("Tracks/Kine/etavspt"), track.pt(), track.eta());
-    histos.fill(HIST("Tracks/Kine/phivspt"), track.pt(), track.phi());
-    histos.fill(HIST("Tracks/Kine/relativeResoPt"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
-    histos.fill(HIST("Tracks/Kine/relativeResoPtMean"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
-    auto eta = track.eta();
+      histos.fill(HIST("Tracks/Kine/ptFilteredNegative"), pt);
+    }
+    histos.fill(HIST("Tracks/Kine/eta"), eta);
+    histos.fill(HIST("Tracks/Kine/phi"), phi);
+    histos.fill(HIST("Tracks/Kine/etavsphi"), eta, phi);
+    histos.fill(HIST("Tracks/Kine/etavspt"), pt, eta);
+    histos.fill(HIST("Tracks/Kine/phivspt"), pt, phi);
+    histos.fill(HIST("Tracks/Kine/relativeResoPt"), pt, relativeResoPt);
+    histos.fill(HIST("Tracks/Kine/relativeResoPtMean"), pt, relativeResoPt);
     if (eta > 0) { /// positive eta
-      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaPlus"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaPlus"), pt, relativeResoPt);
       if (eta < 0.4) { /// |eta| < 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), pt, relativeResoPt);
       } else { /// |eta| > 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), pt, relativeResoPt);
       }
     } else { /// negative eta
-      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaMinus"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+      histos.fill(HIST("Tracks/Kine/relativeResoPtEtaMinus"), pt, relativeResoPt);
       if (eta > -0.4) { /// |eta| < 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaWithin04"), pt, relativeResoPt);
       } else { /// |eta| > 0.4
-        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), track.pt(), track.pt() * std::sqrt(track.c1Pt21Pt2()));
+        histos.fill(HIST("Tracks/Kine/relativeResoPtEtaAbove04"), pt, relativeResoPt);
       }
     }
 
@@ -1605,20 +1631,15 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
     }
     histos.fill(HIST("Tracks/dcaXY"), track.dcaXY());
     histos.fill(HIST("Tracks/dcaZ"), track.dcaZ());
-    histos.fill(HIST("Tracks/dcaXYvsPt"), track.dcaXY(), track.pt());
-    histos.fill(HIST("Tracks/dcaZvsPt"), track.dcaZ(), track.pt());
-    histos.fill(HIST("Tracks/dcaZvsEta"), track.dcaZ(), track.eta());
+    histos.fill(HIST("Tracks/dcaXYvsPt"), track.dcaXY(), pt);
+    histos.fill(HIST("Tracks/dcaZvsPt"), track.dcaZ(), pt);
+    histos.fill(HIST("Tracks/dcaZvsEta"), track.dcaZ(), eta);
     histos.fill(HIST("Tracks/length"), track.length());
 
     // fill ITS variables
     histos.fill(HIST("Tracks/ITS/itsNCls"), track.itsNCls());
     histos.fill(HIST("Tracks/ITS/itsChi2NCl"), track.itsChi2NCl());
-    int itsNhits = 0;
-    for (unsigned int i = 0; i < 7; i++) {
-      if (track.itsClusterMap() & (1 << i)) {
-        itsNhits += 1;
-      }
-    }
+    const int itsNhits = countItsHits(track.itsClusterMap());
     bool trkHasITS = false;
     for (unsigned int i = 0; i < 7; i++) {
       if (track.itsClusterMap() & (1 << i)) {
@@ -1633,10 +1654,10 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
     // fill TPC variables
     histos.fill(HIST("Tracks/TPC/tpcNClsFindable"), track.tpcNClsFindable());
     histos.fill(HIST("Tracks/TPC/tpcNClsFound"), track.tpcNClsFound());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEta"), track.eta(), track.tpcNClsFound());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVtxZ"), track.eta(), track.tpcNClsFound(), collision.posZ());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaPhi"), track.eta(), track.tpcNClsFound(), track.phi());
-    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVsPt"), track.eta(), track.tpcNClsFound(), track.pt());
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEta"), eta, track.tpcNClsFound());
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVtxZ"), eta, track.tpcNClsFound(), collision.posZ());
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaPhi"), eta, track.tpcNClsFound(), phi);
+    histos.fill(HIST("Tracks/TPC/tpcNClsFoundVsEtaVsPt"), eta, track.tpcNClsFound(), pt);
     histos.fill(HIST("Tracks/TPC/tpcNClsShared"), track.tpcNClsShared());
     histos.fill(HIST("Tracks/TPC/tpcCrossedRows"), track.tpcNClsCrossedRows());
     histos.fill(HIST("Tracks/TPC/tpcCrossedRowsOverFindableCls"), track.tpcCrossedRowsOverFindableCls());
@@ -1656,8 +1677,8 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
         // resolution plots
         if (doExtraPIDqa && track.pidForTracking() != static_cast<unsigned int>(std::abs(PartIdentifier))) {
           // full eta range
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcWrongPIDinTrk"), pt - particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledWrongPIDinTrk"), (pt - particle.pt()) / particle.pt(), particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
           if (particle.pt() > 0.f) {
@@ -1666,8 +1687,8 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
           histos.fill(HIST("Tracks/Kine/resoInvPtVsPtWrongPIDinTrk"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
           // split eta range
           if (eta > 0) { // positive eta
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlusWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlusWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlusWrongPIDinTrk"), pt - particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlusWrongPIDinTrk"), (pt - particle.pt()) / particle.pt(), particle.pt());
             histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
             histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
             if (particle.pt() > 0.f) {
@@ -1675,8 +1696,8 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
             }
             histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlusWrongPIDinTrk"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
           } else { // negative eta
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinusWrongPIDinTrk"), track.pt() - particle.pt(), particle.pt());
-            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinusWrongPIDinTrk"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinusWrongPIDinTrk"), pt - particle.pt(), particle.pt());
+            histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinusWrongPIDinTrk"), (pt - particle.pt()) / particle.pt(), particle.pt());
             histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
             histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinusWrongPIDinTrk"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
             if (particle.pt() > 0.f) {
@@ -1710,9 +1731,9 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
 
         // Kine plots
         // full eta range
-        histos.fill(HIST("Tracks/Kine/resoPt"), track.pt() - particle.pt(), track.pt(), track.sign());
-        histos.fill(HIST("Tracks/Kine/resoPtVsptmc"), track.pt() - particle.pt(), particle.pt(), track.sign());
-        histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaled"), (track.pt() - particle.pt()) / particle.pt(), particle.pt(), track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPt"), pt - particle.pt(), pt, track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPtVsptmc"), pt - particle.pt(), particle.pt(), track.sign());
+        histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaled"), (pt - particle.pt()) / particle.pt(), particle.pt(), track.sign());
         if (particle.pt() > 0.f) {
           histos.fill(HIST("Tracks/Kine/resoInvPt"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), 1.f / particle.pt(), track.sign());
           histos.fill(HIST("Tracks/Kine/resoInvPtVsPt"), std::abs(track.signed1Pt()) - 1.f / particle.pt(), particle.pt(), track.sign());
@@ -1725,16 +1746,16 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
         histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmc"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt(), track.sign());
         histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmc"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt(), track.sign());
 
-        histos.fill(HIST("Tracks/Kine/ptVsptmc"), particle.pt(), track.pt());
+        histos.fill(HIST("Tracks/Kine/ptVsptmc"), particle.pt(), pt);
         histos.fill(HIST("Tracks/Kine/Signed1PtVsSigned1Ptmc"), sign / particle.pt(), track.signed1Pt());
-        histos.fill(HIST("Tracks/Kine/resoEta"), track.eta() - particle.eta(), track.eta());
-        histos.fill(HIST("Tracks/Kine/resoPhi"), track.phi() - particle.phi(), track.phi());
+        histos.fill(HIST("Tracks/Kine/resoEta"), eta - particle.eta(), eta);
+        histos.fill(HIST("Tracks/Kine/resoPhi"), phi - particle.phi(), phi);
 
         // split eta range
         if (eta > 0) { // positive eta
-          histos.fill(HIST("Tracks/Kine/resoPtEtaPlus"), track.pt() - particle.pt(), track.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlus"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlus"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtEtaPlus"), pt - particle.pt(), pt);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaPlus"), pt - particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaPlus"), (pt - particle.pt()) / particle.pt(), particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaPlus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaPlus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
           if (particle.pt() > 0.f) {
@@ -1742,9 +1763,9 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
           }
           histos.fill(HIST("Tracks/Kine/resoInvPtVsPtEtaPlus"), track.signed1Pt() - 1.f / particle.pt(), particle.pt());
         } else { // negative eta
-          histos.fill(HIST("Tracks/Kine/resoPtEtaMinus"), track.pt() - particle.pt(), track.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinus"), track.pt() - particle.pt(), particle.pt());
-          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinus"), (track.pt() - particle.pt()) / particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtEtaMinus"), pt - particle.pt(), pt);
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcEtaMinus"), pt - particle.pt(), particle.pt());
+          histos.fill(HIST("Tracks/Kine/resoPtVsptmcScaledEtaMinus"), (pt - particle.pt()) / particle.pt(), particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsInvPtmcEtaMinus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), 1.f / particle.pt());
           histos.fill(HIST("Tracks/Kine/pullInvPtVsPtmcEtaMinus"), (std::abs(track.signed1Pt()) - 1.f / particle.pt()) / std::sqrt(track.c1Pt21Pt2()), particle.pt());
           if (particle.pt() > 0.f) {
@@ -1757,13 +1778,13 @@ void qaEventTrack::fillRecoHistogramsGroupedTracks(const C& collision, const T&
 
     // ITS-TPC matching pt-distributions
     if (track.hasITS()) {
-      histos.fill(HIST("Tracks/ITS/hasITS"), track.pt());
+      histos.fill(HIST("Tracks/ITS/hasITS"), pt);
     }
     if (track.hasTPC()) {
-      histos.fill(HIST("Tracks/TPC/hasTPC"), track.pt());
+      histos.fill(HIST("Tracks/TPC/hasTPC"), pt);
     }
     if (track.hasITS() && track.hasTPC()) {
-      histos.fill(HIST("Tracks/ITS/hasITSANDhasTPC"), track.pt());
+      histos.fill(HIST("Tracks/ITS/hasITSANDhasTPC"), pt);
     }
   }
 }
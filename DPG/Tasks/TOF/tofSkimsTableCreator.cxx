@@ -18,6 +18,8 @@
 
 #include "tofSkimsTableCreator.h"
 
+#include "DPG/Tasks/TPC/utilsSkimsSampling.h"
+
 #include "Common/DataModel/EventSelection.h"
 #include "Common/DataModel/FT0Corrected.h"
 #include "Common/DataModel/PIDResponseTOF.h"
@@ -32,6 +34,7 @@
 #include <Framework/Expressions.h>
 #include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
+#include <ReconstructionDataFormats/PID.h>
 
 #include <chrono>
 #include <cstdint>
@@ -43,6 +46,7 @@ using namespace o2;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::track;
+using namespace o2::dpg_skimssampling;
 
 struct tofSkimsTableCreator {
   using Trks = soa::Join<aod::Tracks, aod::TracksExtra,
@@ -59,6 +63,8 @@ struct tofSkimsTableCreator {
   Configurable<int> trackSelection{"trackSelection", 1, "Track selection: 0 -> No Cut, 1 -> kGlobalTrack, 2 -> kGlobalTrackWoPtEta, 3 -> kGlobalTrackWoDCA, 4 -> kQualityTracks, 5 -> kInAcceptanceTracks"};
   Configurable<bool> keepTpcOnly{"keepTpcOnly", false, "Flag to keep the TPC only tracks as well"};
   Configurable<float> fractionOfEvents{"fractionOfEvents", 0.1, "Fractions of events to keep"};
+  // Stratified sampling of the tracks, in (species for tracking, momentum, eta, occupancy) bins
+  SkimSampler sampler;
 
   unsigned int randomSeed = 0;
   void init(o2::framework::InitContext&)
@@ -85,6 +91,7 @@ struct tofSkimsTableCreator {
         LOG(fatal) << "Invalid track selection flag: " << trackSelection.value;
         break;
     }
+    sampler.init(PID::NIDs);
   }
 
   Filter eventFilter = (applyEvSel.node() == 0) ||
@@ -98,7 +105,8 @@ struct tofSkimsTableCreator {
                        ((trackSelection.node() == 5) && requireInAcceptanceTracksInFilter());
 
   void process(soa::Filtered<Coll>::iterator const& collision,
-               soa::Filtered<Trks> const& tracks)
+               soa::Filtered<Trks> const& tracks,
+               aod::BCs const&)
   {
     if (fractionOfEvents < 1.f && (static_cast<float>(rand_r(&randomSeed)) / static_cast<float>(RAND_MAX)) > fractionOfEvents) { // Skip events that are not sampled
       return;
@@ -144,8 +152,25 @@ struct tofSkimsTableCreator {
                 collision.collisionTimeRes(),
                 tofFlags);
 
+    if (sampler.isEnabled()) {
+      const uint64_t globalBC = collision.bc_as<aod::BCs>().globalBC();
+      sampler.startBatch();
+      for (auto const& trk : tracks) {
+        if (!keepTpcOnly.value && !trk.hasTOF()) {
+          sampler.skip();
+          continue;
+        }
+        sampler.offer(trk.pidForTracking(), trk.p(), trk.eta(), collision.trackOccupancyInTimeRange(), trackCounter(globalBC, trk.globalIndex(), trk.pidForTracking()));
+      }
+      sampler.finaliseBatch();
+    }
+
     int8_t lastTRDLayer = -1;
+    int64_t iSlot = 0;
     for (auto const& trk : tracks) {
+      if (!sampler.isSelected(iSlot++)) {
+        continue;
+      }
       if (!keepTpcOnly.value && !trk.hasTOF()) {
         continue;
       }
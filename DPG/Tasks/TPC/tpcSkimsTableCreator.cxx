@@ -19,6 +19,7 @@
 
 #include "tpcSkimsTableCreator.h"
 
+#include "utilsSkimsSampling.h"
 #include "utilsTpcSkimsTableCreator.h"
 
 #include "PWGDQ/DataModel/ReducedInfoTables.h"
@@ -66,6 +67,7 @@ using namespace o2::framework::expressions;
 using namespace o2::track;
 using namespace o2::dataformats;
 using namespace o2::dpg_tpcskimstablecreator;
+using namespace o2::dpg_skimssampling;
 
 using V0sWithID = soa::Join<aod::V0Datas, aod::V0MapID, aod::V0TOFNSigmas>;
 using CascsWithID = soa::Join<aod::CascDatas, aod::CascMapID, aod::CascTOFNSigmas>;
@@ -108,6 +110,8 @@ struct TreeWriterTpcV0 {
   Configurable<bool> checkZdc{"checkZdc", false, "set ZDC flag for PbPb"};
   Configurable<bool> treatLimitedAcceptanceAsBad{"treatLimitedAcceptanceAsBad", false, "reject all events where the detectors relevant for the specified Runlist are flagged as LimitedAcceptance"};
   Configurable<bool> requireGoodRct{"requireGoodRct", false, "require good detector flag in run condtion table"};
+  // Stratified sampling of the daughter tracks, in (species, betagamma, eta, occupancy) bins
+  SkimSampler sampler;
 
   // an arbitrary value of N sigma TOF assigned by TOF task to tracks which are not matched to TOF hits
   constexpr static float NSigmaTofUnmatched{o2::aod::v0data::kNoTOFValue};
@@ -182,6 +186,7 @@ struct TreeWriterTpcV0 {
     ccdb->setFatalWhenNull(false);
 
     rctChecker.init(rctLabel, checkZdc, treatLimitedAcceptanceAsBad);
+    sampler.init(o2::track::PID::NIDs);
   }
 
   template <bool IsCorrectedDeDx, typename V0Casc, typename T>
@@ -279,8 +284,7 @@ struct TreeWriterTpcV0 {
     const float v0radius = getRadius(v0casc);
     const float gammapsipair = v0casc.psipair();
 
-    const double pseudoRndm = track.pt() * 1000. - static_cast<int64_t>(track.pt() * 1000);
-    if (pseudoRndm < dwnSmplFactor) {
+    if (passPseudoRandomDownsampling(track.pt(), dwnSmplFactor)) {
       const float usedDedx = tpcSignalGeneric<DoUseCorrectedDeDx>(track);
       float tpcdEdxNorm{UndefValueFloat};
       if constexpr (ModeId != ModeStandard) {
@@ -422,93 +426,120 @@ struct TreeWriterTpcV0 {
                                               aod::pidits::ITSNSigmaEl, aod::pidits::ITSNSigmaPi,
                                               aod::pidits::ITSNSigmaKa, aod::pidits::ITSNSigmaPr>(myTracks);
 
-    for (const auto& collision : collisions) {
-      if (!isEventSelected(collision, applyEvSel)) {
-        continue;
-      }
-      const bool isGoodRctEvent = rctChecker.checkTable(collision);
-      if (requireGoodRct && !isGoodRctEvent) {
-        continue;
-      }
-
-      const auto v0s = myV0s.sliceBy(perCollisionV0s, static_cast<int>(collision.globalIndex()));
-      const auto cascs = myCascs.sliceBy(perCollisionCascs, static_cast<int>(collision.globalIndex()));
-      const auto bc = collision.bc_as<BCType>();
-      const int runnumber = bc.runNumber();
-      const auto hadronicRate = mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, irSource) * OneToKilo;
-      const int bcGlobalIndex = bc.globalIndex();
-      int bcTimeFrameId{}, bcBcInTimeFrame{};
-      if constexpr (ModeId == ModeWithdEdxTrkQA || ModeId == ModeStandard) {
-        bcTimeFrameId = UndefValueInt;
-        bcBcInTimeFrame = UndefValueInt;
-        rowTPCTree.reserve(2 * v0s.size() + cascs.size());
-      } else if constexpr (ModeId == ModeWithTrkQA) {
-        bcTimeFrameId = bc.tfId();
-        bcBcInTimeFrame = bc.bcInTF();
-        rowTPCTreeWithTrkQA.reserve(2 * v0s.size() + cascs.size());
-      }
-
-      auto getTrackQA = [&](const TrksType::iterator& track) {
-        if constexpr (!IsWithTrackQa) {
-          return std::make_pair(aod::TracksQA{}, false);
-        } else {
-          const auto trackGlobalIndex = track.globalIndex();
-          const auto label = labelTrack2TrackQA.at(trackGlobalIndex);
-          const bool existTrkQA = (label != -1);
-          const int64_t trkIndex = existTrkQA ? label : 0;
-          const aod::TracksQA& trkQA = tracksQA.iteratorAt(trkIndex);
+    int64_t iSlot{0}; // position of the daughter track in the order of the sampling
+    auto loopCollisions = [&](const bool isSamplingPass) {
+      iSlot = 0;
+      for (const auto& collision : collisions) {
+        if (!isEventSelected(collision, applyEvSel)) {
+          continue;
+        }
+        const bool isGoodRctEvent = rctChecker.checkTable(collision);
+        if (requireGoodRct && !isGoodRctEvent) {
+          continue;
+        }
 
-          return std::make_pair(trkQA, existTrkQA);
+        const auto v0s = myV0s.sliceBy(perCollisionV0s, static_cast<int>(collision.globalIndex()));
+        const auto cascs = myCascs.sliceBy(perCollisionCascs, static_cast<int>(collision.globalIndex()));
+        const auto bc = collision.bc_as<BCType>();
+        const int runnumber = bc.runNumber();
+        const auto hadronicRate = isSamplingPass ? 0. : mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, irSource) * OneToKilo;
+        const int bcGlobalIndex = bc.globalIndex();
+        int bcTimeFrameId{}, bcBcInTimeFrame{};
+        if constexpr (ModeId == ModeWithdEdxTrkQA || ModeId == ModeStandard) {
+          bcTimeFrameId = UndefValueInt;
+          bcBcInTimeFrame = UndefValueInt;
+          rowTPCTree.reserve(2 * v0s.size() + cascs.size());
+        } else if constexpr (ModeId == ModeWithTrkQA) {
+          bcTimeFrameId = bc.tfId();
+          bcBcInTimeFrame = bc.bcInTF();
+          rowTPCTreeWithTrkQA.reserve(2 * v0s.size() + cascs.size());
         }
-      };
-
-      auto fillDaughterTrack = [&](const auto& mother, const TrksType::iterator& dauTrack, const auto& v0, const bool isPositive) {
-        const auto [trackQAInstance, existTrkQA] = getTrackQA(dauTrack);
-        const auto trackId = dauTrack.globalIndex();
-        const auto dauTrackWithITSPid = tracksWithITSPid.rawIteratorAt(trackId);
-        const auto v0Id = getAddId(v0);
-        const V0Mother v0Mother = createV0Mother(v0Id);
-        const auto daughterId = isPositive ? v0Mother.posDaughterId : v0Mother.negDaughterId;
-        const V0Daughter daughter = createV0Daughter<IsCorrectedDeDx>(v0, dauTrackWithITSPid, v0Id, daughterId, isPositive);
-
-        const bool passTrackSelection = isTrackSelected(dauTrack, trackSelection);
-        const bool passDownsamplig = downsampleTsalisCharged(fRndm, dauTrack.pt(), daughter.downsamplingTsalis, daughter.mass, sqrtSNN, daughter.maxPt4dwnsmplTsalis);
-        const bool passNSigmaTofCut = std::fabs(daughter.tofNSigma) < daughter.nSigmaTofDauTrack || std::fabs(daughter.tofNSigma - NSigmaTofUnmatched) < nSigmaTofUnmatchedEqualityTolerance;
-        const bool passMatchTofRequirement = !daughter.rejectNoTofDauTrack || std::fabs(daughter.tofNSigma - NSigmaTofUnmatched) > nSigmaTofUnmatchedEqualityTolerance;
-        if (passTrackSelection && passDownsamplig && passNSigmaTofCut && passMatchTofRequirement) {
+
+        auto getTrackQA = [&](const TrksType::iterator& track) {
+          if constexpr (!IsWithTrackQa) {
+            return std::make_pair(aod::TracksQA{}, false);
+          } else {
+            const auto trackGlobalIndex = track.globalIndex();
+            const auto label = labelTrack2TrackQA.at(trackGlobalIndex);
+            const bool existTrkQA = (label != -1);
+            const int64_t trkIndex = existTrkQA ? label : 0;
+            const aod::TracksQA& trkQA = tracksQA.iteratorAt(trkIndex);
+
+            return std::make_pair(trkQA, existTrkQA);
+          }
+        };
+
+        auto fillDaughterTrack = [&](const auto& mother, const TrksType::iterator& dauTrack, const auto& v0, const bool isPositive) {
+          const auto trackId = dauTrack.globalIndex();
+          const auto dauTrackWithITSPid = tracksWithITSPid.rawIteratorAt(trackId);
+          const auto v0Id = getAddId(v0);
+          const V0Mother v0Mother = createV0Mother(v0Id);
+          const auto daughterId = isPositive ? v0Mother.posDaughterId : v0Mother.negDaughterId;
+          const V0Daughter daughter = createV0Daughter<IsCorrectedDeDx>(v0, dauTrackWithITSPid, v0Id, daughterId, isPositive);
+
+          if (sampler.isEnabled() && !isSamplingPass) {
+            // the selections were evaluated in the sampling pass, with the same draws of the random downsampling
+            if (!sampler.isSelected(iSlot++)) {
+              return;
+            }
+          } else {
+            const bool passTrackSelection = isTrackSelected(dauTrack, trackSelection);
+            const bool passDownsamplig = downsampleTsalisCharged(fRndm, dauTrack.pt(), daughter.downsamplingTsalis, daughter.mass, sqrtSNN, daughter.maxPt4dwnsmplTsalis);
+            const bool passNSigmaTofCut = std::fabs(daughter.tofNSigma) < daughter.nSigmaTofDauTrack || std::fabs(daughter.tofNSigma - NSigmaTofUnmatched) < nSigmaTofUnmatchedEqualityTolerance;
+            const bool passMatchTofRequirement = !daughter.rejectNoTofDauTrack || std::fabs(daughter.tofNSigma - NSigmaTofUnmatched) > nSigmaTofUnmatchedEqualityTolerance;
+            const bool isSelected = passTrackSelection && passDownsamplig && passNSigmaTofCut && passMatchTofRequirement;
+            if (isSamplingPass) {
+              if (isSelected && passPseudoRandomDownsampling(dauTrack.pt(), daughter.dwnSmplFactor)) {
+                sampler.offer(daughter.id, dauTrack.tpcInnerParam() / o2::track::pid_constants::sMasses[daughter.id], dauTrack.eta(), collision.trackOccupancyInTimeRange(), trackCounter(bc.globalBC(), trackId, daughter.id));
+              } else {
+                sampler.skip();
+              }
+              return;
+            }
+            if (!isSelected) {
+              return;
+            }
+          }
+          const auto [trackQAInstance, existTrkQA] = getTrackQA(dauTrack);
           OccupancyValues occValues{};
           if constexpr (ModeId == ModeWithTrkQA) {
             evaluateOccupancyVariables(dauTrack, occValues);
           }
           fillSkimmedV0Table<IsCorrectedDeDx, ModeId>(mother, dauTrack, trackQAInstance, existTrkQA, collision, daughter.tpcNSigma, daughter.tofNSigma, daughter.itsNSigma, daughter.tpcExpSignal, daughter.id, runnumber, daughter.dwnSmplFactor, hadronicRate, bcGlobalIndex, bcTimeFrameId, bcBcInTimeFrame, occValues, isGoodRctEvent);
-        }
-      };
+        };
 
-      /// Loop over v0 candidates
-      for (const auto& v0 : v0s) {
-        const auto v0Id = v0.v0addid();
-        if (v0Id == MotherUndef) {
-          continue;
-        }
-        const auto posTrack = v0.posTrack_as<TrksType>();
-        const auto negTrack = v0.negTrack_as<TrksType>();
+        /// Loop over v0 candidates
+        for (const auto& v0 : v0s) {
+          const auto v0Id = v0.v0addid();
+          if (v0Id == MotherUndef) {
+            continue;
+          }
+          const auto posTrack = v0.posTrack_as<TrksType>();
+          const auto negTrack = v0.negTrack_as<TrksType>();
 
-        fillDaughterTrack(v0, posTrack, v0, true);
-        fillDaughterTrack(v0, negTrack, v0, false);
-      }
+          fillDaughterTrack(v0, posTrack, v0, true);
+          fillDaughterTrack(v0, negTrack, v0, false);
+        }
 
-      /// Loop over cascade candidates
-      for (const auto& casc : cascs) {
-        const auto cascId = casc.cascaddid();
-        if (cascId == MotherUndef) {
-          continue;
+        /// Loop over cascade candidates
+        for (const auto& casc : cascs) {
+          const auto cascId = casc.cascaddid();
+          if (cascId == MotherUndef) {
+            continue;
+          }
+          const auto bachTrack = casc.bachelor_as<TrksType>();
+          // Omega and antiomega
+          const auto isDaughterPositive = cascId == MotherAntiOmega ? true : false;
+          fillDaughterTrack(casc, bachTrack, casc, isDaughterPositive);
         }
-        const auto bachTrack = casc.bachelor_as<TrksType>();
-        // Omega and antiomega
-        const auto isDaughterPositive = cascId == MotherAntiOmega ? true : false;
-        fillDaughterTrack(casc, bachTrack, casc, isDaughterPositive);
       }
+    };
+    if (sampler.isEnabled()) {
+      sampler.startBatch();
+      loopCollisions(true);
+      sampler.finaliseBatch();
     }
+    loopCollisions(false);
   } /// runV0
 
   void processStandard(Colls const& collisions,
@@ -637,6 +668,8 @@ struct TreeWriterTpcTof {
   Configurable<bool> checkZdc{"checkZdc", false, "set ZDC flag for PbPb"};
   Configurable<bool> treatLimitedAcceptanceAsBad{"treatLimitedAcceptanceAsBad", false, "reject all events where the detectors relevant for the specified Runlist are flagged as LimitedAcceptance"};
   Configurable<bool> requireGoodRct{"requireGoodRct", false, "require good detector flag in run condtion table"};
+  // Stratified sampling of the tracks, in (species, betagamma, eta, occupancy) bins
+  SkimSampler sampler;
 
   struct TofTrack {
     bool isApplyHardCutOnly;
@@ -692,6 +725,7 @@ struct TreeWriterTpcTof {
     ccdb->setFatalWhenNull(false);
 
     rctChecker.init(rctLabel, checkZdc, treatLimitedAcceptanceAsBad);
+    sampler.init(o2::track::PID::NIDs);
   }
 
   template <bool DoCorrectDeDx, int ModeId, typename T, typename C>
@@ -707,8 +741,7 @@ struct TreeWriterTpcTof {
     const auto ft0Occ = collision.ft0cOccupancyInTimeRange();
     const auto occMedianTime = collision.occupancyMedianTime();
 
-    const double pseudoRndm = track.pt() * 1000. - static_cast<int64_t>(track.pt() * 1000);
-    if (pseudoRndm < dwnSmplFactor) {
+    if (passPseudoRandomDownsampling(track.pt(), dwnSmplFactor)) {
       const float usedEdx = tpcSignalGeneric<DoCorrectDeDx>(track);
       float tpcdEdxNorm{UndefValueFloat};
       if constexpr (ModeId != ModeStandard) {
@@ -803,78 +836,107 @@ struct TreeWriterTpcTof {
         labelTrack2TrackQA.at(trackId) = trackQA.globalIndex();
       }
     }
-    for (const auto& collision : collisions) {
-      const auto tracks = myTracks.sliceBy(perCollisionTracksType, collision.globalIndex());
-      if (!isEventSelected(collision, applyEvSel)) {
-        continue;
-      }
-      const bool isGoodRctEvent = rctChecker.checkTable(collision);
-      if (requireGoodRct && !isGoodRctEvent) {
-        continue;
-      }
-
-      auto tracksWithITSPid = soa::Attach<TrksType,
-                                          aod::pidits::ITSNSigmaPi, aod::pidits::ITSNSigmaKa, aod::pidits::ITSNSigmaPr,
-                                          aod::pidits::ITSNSigmaDe, aod::pidits::ITSNSigmaTr>(tracks);
+    int64_t iSlot{0}; // position of the (track, species) candidate in the order of the sampling
+    auto loopCollisions = [&](const bool isSamplingPass) {
+      iSlot = 0;
+      for (const auto& collision : collisions) {
+        const auto tracks = myTracks.sliceBy(perCollisionTracksType, collision.globalIndex());
+        if (!isEventSelected(collision, applyEvSel)) {
+          continue;
+        }
+        const bool isGoodRctEvent = rctChecker.checkTable(collision);
+        if (requireGoodRct && !isGoodRctEvent) {
+          continue;
+        }
 
-      if constexpr (ModeId == ModeWithTrkQA) {
-        tracksWithITSPid.bindExternalIndices(&trackMeanOccs);
-      }
+        auto tracksWithITSPid = soa::Attach<TrksType,
+                                            aod::pidits::ITSNSigmaPi, aod::pidits::ITSNSigmaKa, aod::pidits::ITSNSigmaPr,
+                                            aod::pidits::ITSNSigmaDe, aod::pidits::ITSNSigmaTr>(tracks);
 
-      const auto bc = collision.bc_as<BCType>();
-      const int runnumber = bc.runNumber();
-      const auto hadronicRate = mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, irSource) * OneToKilo;
-      const int bcGlobalIndex = bc.globalIndex();
-      int bcTimeFrameId{}, bcBcInTimeFrame{};
-      if constexpr (ModeId == ModeStandard || ModeId == ModeWithdEdxTrkQA) {
-        bcTimeFrameId = UndefValueInt;
-        bcBcInTimeFrame = UndefValueInt;
-        rowTPCTOFTree.reserve(tracks.size());
-      } else {
-        bcTimeFrameId = bc.tfId();
-        bcBcInTimeFrame = bc.bcInTF();
-        rowTPCTOFTreeWithTrkQA.reserve(tracks.size());
-      }
-      for (auto const& trk : tracksWithITSPid) {
-        if (!isTrackSelected(trk, trackSelection)) {
-          continue;
+        if constexpr (ModeId == ModeWithTrkQA) {
+          tracksWithITSPid.bindExternalIndices(&trackMeanOccs);
         }
-        // get the corresponding trackQA using labelTracks2TracKQA and get variables of interest
-        aod::TracksQA trackQA{};
-        bool existTrkQA{false};
-        if constexpr (IsWithTrackQa) {
-          const auto label = labelTrack2TrackQA.at(trk.globalIndex());
-          existTrkQA = (label != -1);
-          const int64_t trkIndex = existTrkQA ? label : 0;
-          trackQA = tracksQA.iteratorAt(trkIndex);
+
+        const auto bc = collision.bc_as<BCType>();
+        const int runnumber = bc.runNumber();
+        const auto hadronicRate = isSamplingPass ? 0. : mRateFetcher.fetch(ccdb.service, bc.timestamp(), runnumber, irSource) * OneToKilo;
+        const int bcGlobalIndex = bc.globalIndex();
+        int bcTimeFrameId{}, bcBcInTimeFrame{};
+        if constexpr (ModeId == ModeStandard || ModeId == ModeWithdEdxTrkQA) {
+          bcTimeFrameId = UndefValueInt;
+          bcBcInTimeFrame = UndefValueInt;
+          rowTPCTOFTree.reserve(tracks.size());
+        } else {
+          bcTimeFrameId = bc.tfId();
+          bcBcInTimeFrame = bc.bcInTF();
+          rowTPCTOFTreeWithTrkQA.reserve(tracks.size());
         }
+        for (auto const& trk : tracksWithITSPid) {
+          if (!isTrackSelected(trk, trackSelection)) {
+            continue;
+          }
+          // get the corresponding trackQA using labelTracks2TracKQA and get variables of interest
+          aod::TracksQA trackQA{};
+          bool existTrkQA{false};
+          if constexpr (IsWithTrackQa) {
+            const auto label = labelTrack2TrackQA.at(trk.globalIndex());
+            existTrkQA = (label != -1);
+            const int64_t trkIndex = existTrkQA ? label : 0;
+            trackQA = tracksQA.iteratorAt(trkIndex);
+          }
 
-        TofTrack tofTriton(true, maxMomHardCutOnlyTr, maxMomTPCOnlyTr, trk.tpcNSigmaTr(), nSigmaTPCOnlyTr, downsamplingTsalisTritons, MassTriton, trk.tofNSigmaTr(), trk.itsNSigmaTr(), trk.tpcExpSignalTr(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidTriton, dwnSmplFactorTr, nSigmaTofTpctofTr, nSigmaTpcTpctofTr);
+          TofTrack tofTriton(true, maxMomHardCutOnlyTr, maxMomTPCOnlyTr, trk.tpcNSigmaTr(), nSigmaTPCOnlyTr, downsamplingTsalisTritons, MassTriton, trk.tofNSigmaTr(), trk.itsNSigmaTr(), trk.tpcExpSignalTr(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidTriton, dwnSmplFactorTr, nSigmaTofTpctofTr, nSigmaTpcTpctofTr);
 
-        TofTrack tofDeuteron(true, maxMomHardCutOnlyDe, maxMomTPCOnlyDe, trk.tpcNSigmaDe(), nSigmaTPCOnlyDe, downsamplingTsalisDeuterons, MassDeuteron, trk.tofNSigmaDe(), trk.itsNSigmaDe(), trk.tpcExpSignalDe(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidDeuteron, dwnSmplFactorDe, nSigmaTofTpctofDe, nSigmaTpcTpctofDe);
+          TofTrack tofDeuteron(true, maxMomHardCutOnlyDe, maxMomTPCOnlyDe, trk.tpcNSigmaDe(), nSigmaTPCOnlyDe, downsamplingTsalisDeuterons, MassDeuteron, trk.tofNSigmaDe(), trk.itsNSigmaDe(), trk.tpcExpSignalDe(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidDeuteron, dwnSmplFactorDe, nSigmaTofTpctofDe, nSigmaTpcTpctofDe);
 
-        TofTrack tofProton(false, UndefValueDouble, maxMomTPCOnlyPr, trk.tpcNSigmaPr(), nSigmaTPCOnlyPr, downsamplingTsalisProtons, MassProton, trk.tofNSigmaPr(), trk.itsNSigmaPr(), trk.tpcExpSignalPr(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidProton, dwnSmplFactorPr, nSigmaTofTpctofPr, nSigmaTpcTpctofPr);
+          TofTrack tofProton(false, UndefValueDouble, maxMomTPCOnlyPr, trk.tpcNSigmaPr(), nSigmaTPCOnlyPr, downsamplingTsalisProtons, MassProton, trk.tofNSigmaPr(), trk.itsNSigmaPr(), trk.tpcExpSignalPr(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidProton, dwnSmplFactorPr, nSigmaTofTpctofPr, nSigmaTpcTpctofPr);
 
-        TofTrack tofKaon(true, maxMomHardCutOnlyKa, maxMomTPCOnlyKa, trk.tpcNSigmaKa(), nSigmaTPCOnlyKa, downsamplingTsalisKaons, MassKPlus, trk.tofNSigmaKa(), trk.itsNSigmaKa(), trk.tpcExpSignalKa(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidKaon, dwnSmplFactorKa, nSigmaTofTpctofKa, nSigmaTpcTpctofKa);
+          TofTrack tofKaon(true, maxMomHardCutOnlyKa, maxMomTPCOnlyKa, trk.tpcNSigmaKa(), nSigmaTPCOnlyKa, downsamplingTsalisKaons, MassKPlus, trk.tofNSigmaKa(), trk.itsNSigmaKa(), trk.tpcExpSignalKa(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidKaon, dwnSmplFactorKa, nSigmaTofTpctofKa, nSigmaTpcTpctofKa);
 
-        TofTrack tofPion(false, UndefValueDouble, maxMomTPCOnlyPi, trk.tpcNSigmaPi(), nSigmaTPCOnlyPi, downsamplingTsalisPions, MassPiPlus, trk.tofNSigmaPi(), trk.itsNSigmaPi(), trk.tpcExpSignalPi(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidPion, dwnSmplFactorPi, nSigmaTofTpctofPi, nSigmaTpcTpctofPi);
+          TofTrack tofPion(false, UndefValueDouble, maxMomTPCOnlyPi, trk.tpcNSigmaPi(), nSigmaTPCOnlyPi, downsamplingTsalisPions, MassPiPlus, trk.tofNSigmaPi(), trk.itsNSigmaPi(), trk.tpcExpSignalPi(tpcSignalGeneric<IsCorrectedDeDx>(trk)), PidPion, dwnSmplFactorPi, nSigmaTofTpctofPi, nSigmaTpcTpctofPi);
 
-        OccupancyValues occValues{};
-        if constexpr (ModeId == ModeWithTrkQA) {
-          evaluateOccupancyVariables(trk, occValues);
-        }
+          OccupancyValues occValues{};
+          if constexpr (ModeId == ModeWithTrkQA) {
+            if (!isSamplingPass) {
+              evaluateOccupancyVariables(trk, occValues);
+            }
+          }
 
-        for (const auto& tofTrack : {&tofTriton, &tofDeuteron, &tofProton, &tofKaon, &tofPion}) {
-          const bool passMomHardCut = !tofTrack->isApplyHardCutOnly || trk.tpcInnerParam() < tofTrack->maxMomHardCutOnly;
-          const bool passMomTpcOnly = trk.tpcInnerParam() <= tofTrack->maxMomTPCOnly && std::fabs(tofTrack->tpcNSigma) < tofTrack->nSigmaTPCOnly;
-          const bool passMomTpcTof = trk.tpcInnerParam() > tofTrack->maxMomTPCOnly && std::fabs(tofTrack->tofNSigma) < tofTrack->nSigmaTofTpctof && std::fabs(tofTrack->tpcNSigma) < tofTrack->nSigmaTpcTpctof;
-          const bool passDownsamplig = downsampleTsalisCharged(fRndm, trk.pt(), tofTrack->downsamplingTsalis, tofTrack->mass, sqrtSNN);
-          if (passMomHardCut && (passMomTpcOnly || passMomTpcTof) && passDownsamplig) {
+          for (const auto& tofTrack : {&tofTriton, &tofDeuteron, &tofProton, &tofKaon, &tofPion}) {
+            if (sampler.isEnabled() && !isSamplingPass) {
+              // the selections were evaluated in the sampling pass, with the same draws of the random downsampling
+              if (!sampler.isSelected(iSlot++)) {
+                continue;
+              }
+            } else {
+              const bool passMomHardCut = !tofTrack->isApplyHardCutOnly || trk.tpcInnerParam() < tofTrack->maxMomHardCutOnly;
+              const bool passMomTpcOnly = trk.tpcInnerParam() <= tofTrack->maxMomTPCOnly && std::fabs(tofTrack->tpcNSigma) < tofTrack->nSigmaTPCOnly;
+              const bool passMomTpcTof = trk.tpcInnerParam() > tofTrack->maxMomTPCOnly && std::fabs(tofTrack->tofNSigma) < tofTrack->nSigmaTofTpctof && std::fabs(tofTrack->tpcNSigma) < tofTrack->nSigmaTpcTpctof;
+              const bool passDownsamplig = downsampleTsalisCharged(fRndm, trk.pt(), tofTrack->downsamplingTsalis, tofTrack->mass, sqrtSNN);
+              const bool isSelected = passMomHardCut && (passMomTpcOnly || passMomTpcTof) && passDownsamplig;
+              if (isSamplingPass) {
+                if (isSelected && passPseudoRandomDownsampling(trk.pt(), tofTrack->dwnSmplFactor)) {
+                  sampler.offer(tofTrack->pid, trk.tpcInnerParam() / o2::track::pid_constants::sMasses[tofTrack->pid], trk.eta(), collision.trackOccupancyInTimeRange(), trackCounter(bc.globalBC(), trk.globalIndex(), tofTrack->pid));
+                } else {
+                  sampler.skip();
+                }
+                continue;
+              }
+              if (!isSelected) {
+                continue;
+              }
+            }
             fillSkimmedTpcTofTable<IsCorrectedDeDx, ModeId>(trk, trackQA, existTrkQA, collision, tofTrack->tpcNSigma, tofTrack->tofNSigma, tofTrack->itsNSigma, tofTrack->tpcExpSignal, tofTrack->pid, runnumber, tofTrack->dwnSmplFactor, hadronicRate, bcGlobalIndex, bcTimeFrameId, bcBcInTimeFrame, occValues, isGoodRctEvent);
           }
-        }
-      } /// Loop tracks
+        } /// Loop tracks
+      }
+    };
+    if (sampler.isEnabled()) {
+      sampler.startBatch();
+      loopCollisions(true);
+      sampler.finaliseBatch();
     }
+    loopCollisions(false);
   } /// runTof
 
   void processStandard(Colls const& collisions,
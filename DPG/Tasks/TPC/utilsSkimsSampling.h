@@ -0,0 +1,186 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsSkimsSampling.h
+/// \brief Stratified sampling of the tracks written by the TPC and TOF skims
+///
+/// The tracks are split in strata of (species, momentum or betagamma bin, eta bin, occupancy bin). In each batch of
+/// tracks (a data frame or a collision), a uniform sample of at most maxTracksPerBatch tracks per stratum is drawn
+/// with reservoir sampling, and the number of tracks written per stratum in the whole job is limited by a fixed budget,
+/// so that the skims are balanced across the momentum range. The random number of each track is computed from the
+/// seed and the identifiers of the track (splitmix64), so that the sample does not depend on the order of the data.
+
+#ifndef DPG_TASKS_TPC_UTILSSKIMSSAMPLING_H_
+#define DPG_TASKS_TPC_UTILSSKIMSSAMPLING_H_
+
+#include <Framework/Configurable.h>
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace o2::dpg_skimssampling
+{
+
+/// Seeded counter-based random number (splitmix64)
+/// \param seed is the seed of the sampling
+/// \param counter is a unique identifier of the sampled object
+inline uint64_t counterRandom(const uint64_t seed, const uint64_t counter)
+{
+  uint64_t z{counter + (seed + 1) * 0x9e3779b97f4a7c15ull};
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+/// Identifier of a track for the sampling, unique in the job and independent of the order of the data
+/// \param globalBC is the global BC of the collision of the track
+/// \param trackIndex is the index of the track in its data frame
+/// \param species is the index of the species of the track
+inline uint64_t trackCounter(const uint64_t globalBC, const int64_t trackIndex, const int species)
+{
+  return counterRandom(globalBC, static_cast<uint64_t>(trackIndex) * 16 + species);
+}
+
+struct SkimSampler : o2::framework::ConfigurableGroup {
+  std::string prefix = "stratifiedSampling"; // JSON group name
+  o2::framework::Configurable<bool> enable{"enable", false, "Enable the stratified sampling of the tracks"};
+  o2::framework::Configurable<std::vector<double>> binsMomentum{"binsMomentum", std::vector<double>{0.1, 0.2, 0.5, 1., 2., 5., 10., 20., 50., 100., 1000.}, "Momentum (TOF) or betagamma (TPC) bin limits of the strata"};
+  o2::framework::Configurable<std::vector<double>> binsEta{"binsEta", std::vector<double>{-0.9, -0.45, 0., 0.45, 0.9}, "Eta bin limits of the strata (no eta strata if empty)"};
+  o2::framework::Configurable<std::vector<double>> binsOccupancy{"binsOccupancy", std::vector<double>{}, "Occupancy bin limits of the strata (no occupancy strata if empty)"};
+  o2::framework::Configurable<int> maxTracksPerBin{"maxTracksPerBin", 10000, "Maximum number of tracks written per stratum in the job (negative: no limit)"};
+  o2::framework::Configurable<int> maxTracksPerBatch{"maxTracksPerBatch", 100, "Maximum number of tracks per stratum sampled in a data frame (TPC) or a collision (TOF)"};
+  o2::framework::Configurable<int> seed{"seed", 0, "Seed of the sampling, the sample is reproducible for a given seed"};
+
+  int nSpecies{0};                                                // number of species
+  std::vector<int64_t> budgets;                                   // remaining number of tracks to be written per stratum in the job, negative if unlimited
+  std::vector<std::vector<std::pair<uint64_t, int64_t>>> samples; // (random number, slot) of the sampled tracks per stratum, as max-heaps
+  std::vector<bool> isAccepted;                                   // decision for each slot of the batch
+
+  /// \return whether the sampling is enabled
+  bool isEnabled() const { return enable.value; }
+
+  /// Initialise the budgets
+  /// \param nSpeciesToSample is the number of species, indices in [0, nSpeciesToSample)
+  void init(const int nSpeciesToSample)
+  {
+    if (!isEnabled()) {
+      return;
+    }
+    for (const auto* bins : {&binsMomentum.value, &binsEta.value, &binsOccupancy.value}) {
+      if (bins->size() == 1 || !std::is_sorted(bins->begin(), bins->end())) {
+        LOGP(fatal, "The bin limits of the sampling strata must be sorted, with at least two limits per binned variable.");
+      }
+    }
+    if (binsMomentum.value.empty()) {
+      LOGP(fatal, "The momentum bin limits of the sampling strata must be provided.");
+    }
+    if (maxTracksPerBatch.value <= 0) {
+      LOGP(fatal, "The number of tracks sampled per batch must be positive.");
+    }
+    nSpecies = nSpeciesToSample;
+    budgets.assign(static_cast<std::size_t>(nSpecies) * nBins(binsMomentum.value) * nBins(binsEta.value) * nBins(binsOccupancy.value), maxTracksPerBin.value);
+    samples.assign(budgets.size(), {});
+  }
+
+  /// Start the sampling of a new batch of tracks
+  void startBatch()
+  {
+    for (auto& sample : samples) {
+      sample.clear();
+    }
+    isAccepted.clear();
+  }
+
+  /// Reserve the slot of a track which is not written, to keep the slots aligned with the order of the tracks
+  void skip()
+  {
+    isAccepted.push_back(false);
+  }
+
+  /// Offer the next track of the batch to the sampler
+  /// \param species is the index of the species of the track
+  /// \param momentum is the momentum or the betagamma of the track
+  /// \param eta is the pseudorapidity of the track
+  /// \param occupancy is the occupancy of the collision of the track
+  /// \param counter is a unique and reproducible identifier of the track in the job
+  void offer(const int species, const double momentum, const double eta, const double occupancy, const uint64_t counter)
+  {
+    const auto slot = static_cast<int64_t>(isAccepted.size());
+    isAccepted.push_back(false);
+    const int iMomentum = findBin(binsMomentum.value, momentum);
+    const int iEta = findBin(binsEta.value, eta);
+    const int iOccupancy = findBin(binsOccupancy.value, occupancy);
+    if (species < 0 || species >= nSpecies || iMomentum < 0 || iEta < 0 || iOccupancy < 0) {
+      return;
+    }
+    const auto iStratum = ((static_cast<std::size_t>(species) * nBins(binsMomentum.value) + iMomentum) * nBins(binsEta.value) + iEta) * nBins(binsOccupancy.value) + iOccupancy;
+    const int64_t capacity = budgets[iStratum] < 0 ? maxTracksPerBatch.value : std::min<int64_t>(maxTracksPerBatch.value, budgets[iStratum]);
+    if (capacity == 0) {
+      return;
+    }
+    // keep the tracks with the smallest random numbers, i.e. a uniform sample independent of the order of the tracks
+    auto& sample = samples[iStratum];
+    const std::pair<uint64_t, int64_t> entry{counterRandom(seed.value, counter), slot};
+    if (static_cast<int64_t>(sample.size()) < capacity) {
+      sample.push_back(entry);
+      std::push_heap(sample.begin(), sample.end());
+    } else if (entry < sample.front()) {
+      std::pop_heap(sample.begin(), sample.end());
+      sample.back() = entry;
+      std::push_heap(sample.begin(), sample.end());
+    }
+  }
+
+  /// Accept the sampled tracks of the batch and update the budgets
+  void finaliseBatch()
+  {
+    for (std::size_t iStratum = 0; iStratum < samples.size(); ++iStratum) {
+      for (const auto& entry : samples[iStratum]) {
+        isAccepted[entry.second] = true;
+      }
+      if (budgets[iStratum] > 0) {
+        budgets[iStratum] -= static_cast<int64_t>(samples[iStratum].size());
+      }
+    }
+  }
+
+  /// \param slot is the position of the track in the order in which the tracks were offered or skipped
+  /// \return whether the track is written, always true if the sampling is disabled
+  bool isSelected(const int64_t slot) const
+  {
+    return !isEnabled() || isAccepted[slot];
+  }
+
+ private:
+  /// \return the number of bins of a binned variable, one if not binned
+  static std::size_t nBins(const std::vector<double>& bins) { return bins.empty() ? 1 : bins.size() - 1; }
+
+  /// \return the bin of a value, 0 if the variable is not binned and -1 if the value is out of the bins
+  static int findBin(const std::vector<double>& bins, const double value)
+  {
+    if (bins.empty()) {
+      return 0;
+    }
+    if (!(value >= bins.front() && value < bins.back())) {
+      return -1;
+    }
+    return std::upper_bound(bins.begin(), bins.end(), value) - bins.begin() - 1;
+  }
+};
+
+} // namespace o2::dpg_skimssampling
+
+#endif // DPG_TASKS_TPC_UTILSSKIMSSAMPLING_H_
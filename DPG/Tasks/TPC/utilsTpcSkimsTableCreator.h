@@ -29,6 +29,7 @@
 #include <TRandom3.h>
 
 #include <cmath>
+#include <cstdint>
 
 namespace o2::dpg_tpcskimstablecreator
 {
@@ -86,6 +87,13 @@ inline bool downsampleTsalisCharged(TRandom3* fRndm, const double pt, const doub
   }
 };
 
+/// Deterministic downsampling with the fraction of the track pt in MeV/c as pseudo-random number
+inline bool passPseudoRandomDownsampling(const double pt, const double dwnSmplFactor)
+{
+  const double pseudoRndm = pt * 1000. - static_cast<int64_t>(pt * 1000);
+  return pseudoRndm < dwnSmplFactor;
+}
+
 // Track selection
 template <typename TrackType>
 bool isTrackSelected(const TrackType& track, const int trackSelection)
@@ -44,7 +44,6 @@
 #include <Framework/Logger.h>
 #include <MathUtils/BetheBlochAleph.h>
 
-#include <Math/GenVector/Boost.h>
 #include <Math/Vector4D.h> // IWYU pragma: keep (do not replace with Math/Vector4Dfwd.h)
 #include <Math/Vector4Dfwd.h>
 #include <TAxis.h>
@@ -1906,16 +1905,26 @@ inline int8_t HfFilterHelper::isBDTSelected(const T& scores, const U& thresholdB
 template <typename T>
 inline T HfFilterHelper::computeRelativeMomentum(const std::array<T, 3>& pTrack, const std::array<T, 3>& CharmCandMomentum, const T& CharmMass)
 {
-  ROOT::Math::PxPyPzMVector part1(pTrack[0], pTrack[1], pTrack[2], massProton);
-  ROOT::Math::PxPyPzMVector part2(CharmCandMomentum[0], CharmCandMomentum[1], CharmCandMomentum[2], CharmMass);
-
-  ROOT::Math::PxPyPzMVector trackSum = part1 + part2;
-  ROOT::Math::Boost boostv12{trackSum.BoostToCM()};
-  ROOT::Math::PxPyPzMVector part1CM = boostv12(part1);
-  ROOT::Math::PxPyPzMVector part2CM = boostv12(part2);
-  ROOT::Math::PxPyPzMVector trackRelK = part1CM - part2CM;
-
-  T kStar = 0.5 * trackRelK.P();
+  // k* is the momentum of each particle in the rest frame of the pair, given by the invariant mass of the pair
+  // k* = sqrt((s - (m1 + m2)^2) * (s - (m1 - m2)^2)) / (2 sqrt(s)), without boosting the four-momenta
+  const double mass1{massProton};
+  const double mass2{CharmMass};
+  const double p1Sq{static_cast<double>(pTrack[0]) * pTrack[0] + static_cast<double>(pTrack[1]) * pTrack[1] + static_cast<double>(pTrack[2]) * pTrack[2]};
+  const double p2Sq{static_cast<double>(CharmCandMomentum[0]) * CharmCandMomentum[0] + static_cast<double>(CharmCandMomentum[1]) * CharmCandMomentum[1] + static_cast<double>(CharmCandMomentum[2]) * CharmCandMomentum[2]};
+  const double p1p2{static_cast<double>(pTrack[0]) * CharmCandMomentum[0] + static_cast<double>(pTrack[1]) * CharmCandMomentum[1] + static_cast<double>(pTrack[2]) * CharmCandMomentum[2]};
+  const double energy1{std::sqrt(p1Sq + mass1 * mass1)};
+  const double energy2{std::sqrt(p2Sq + mass2 * mass2)};
+
+  // s = m1^2 + m2^2 + 2 (E1 E2 - p1.p2)
+  const double s{mass1 * mass1 + mass2 * mass2 + 2. * (energy1 * energy2 - p1p2)};
+  const double massSum{mass1 + mass2};
+  const double massDiff{mass1 - mass2};
+  const double lambda{(s - massSum * massSum) * (s - massDiff * massDiff)};
+  if (s <= 0. || lambda <= 0.) {
+    return static_cast<T>(0.);
+  }
+
+  T kStar = std::sqrt(lambda) / (2. * std::sqrt(s));
   return kStar;
 } // float computeRelativeMomentum(const T& track, const std::array<float, 3>& CharmCandMomentum, const float& CharmMass)
 
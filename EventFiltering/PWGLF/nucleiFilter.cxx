@@ -9,6 +9,7 @@
 // granted to it by virtue of its status as an Intergovernmental Organization
 // or submit itself to any jurisdiction.
 
+#include "../filterInstrumentation.h"
 #include "../filterTables.h"
 
 #include "PWGLF/DataModel/LFPIDTOFGenericTables.h"
@@ -78,6 +79,7 @@ static constexpr std::array<int, nNuclei> charges{1, 1, 2};
 static const std::vector<std::string> matterOrNot{"Matter", "Antimatter"};
 static const std::vector<std::string> nucleiNames{"H2", "H3", "Helium"};
 static const std::vector<std::string> hypernucleiNames{"H3L"}; // 3-body decay case
+static const std::vector<std::string> sectionsNames{"Tracks", "TritonFemto", "V0s", "Decay3Bodys"};
 static const std::vector<std::string> columnsNames{o2::aod::filtering::H2::columnLabel(), o2::aod::filtering::He::columnLabel(), o2::aod::filtering::HeV0::columnLabel(), o2::aod::filtering::TritonFemto::columnLabel(), o2::aod::filtering::H3L3Body::columnLabel(), o2::aod::filtering::Tracked3Body::columnLabel(), o2::aod::filtering::ITSmildIonisation::columnLabel(), o2::aod::filtering::ITSextremeIonisation::columnLabel()};
 static const std::vector<std::string> cutsNames{
   "TPCnSigmaMin", "TPCnSigmaMax", "TOFnSigmaMin", "TOFnSigmaMax", "TOFpidStartPt"};
@@ -130,6 +132,7 @@ struct nucleiFilter {
 
   Configurable<LabeledArray<float>> cfgCutsPID{"nucleiCutsPID", {cutsPID[0], nNuclei, nCutsPID, nucleiNames, cutsNames}, "Nuclei PID selections"};
   Configurable<bool> cfgFixTPCinnerParam{"cfgFixTPCinnerParam", false, "Fix TPC inner param"};
+  Configurable<bool> cfgInstrumentation{"cfgInstrumentation", false, "Monitor the CPU time, candidates and memory of the filter"};
 
   // variable/tool for hypertriton 3body decay
   int mRunNumber;
@@ -179,6 +182,7 @@ struct nucleiFilter {
 
   HistogramRegistry qaHists{"qaHists", {}, OutputObjHandlingPolicy::AnalysisObject, true, true};
   OutputObj<TH1D> hProcessedEvents{TH1D("hProcessedEvents", ";;Number of filtered events", kNtriggers + 1, -0.5, static_cast<double>(kNtriggers) + 0.5)};
+  o2::aod::filtering::FilterInstrumentation instrumentation;
 
   void init(InitContext& initContext)
   {
@@ -205,6 +209,7 @@ struct nucleiFilter {
     for (uint32_t iS{0}; iS < columnsNames.size(); ++iS) {
       hProcessedEvents->GetXaxis()->SetBinLabel(iS + 2, columnsNames[iS].data());
     }
+    instrumentation.init(qaHists, sectionsNames, columnsNames, cfgInstrumentation);
 
     // for fH3L3Body
     bachelorTOFPID.SetPidType(o2::track::PID::Deuteron);
@@ -297,6 +302,13 @@ struct nucleiFilter {
     kITSextremeIonisation,
     kNtriggers
   } TriggerType;
+  enum {
+    kSectionTracks = 0,
+    kSectionTritonFemto,
+    kSectionV0s,
+    kSectionDecay3Bodys,
+    kNsections
+  } SectionType;
   // void process(soa::Join<aod::Collisions, aod::EvSels>::iterator const& collision, aod::Vtx3BodyDatas const& vtx3bodydatas, TrackCandidates const& tracks)
   using ColWithEvTime = soa::Join<aod::Collisions, aod::EvSels, aod::EvTimeTOFFT0>;
   void process(ColWithEvTime::iterator const& collision, aod::Decay3Bodys const& decay3bodys, TrackCandidates const& tracks, aod::AssignedTracked3Bodys const& tracked3Bodys, aod::V0s const& v0s, aod::BCsWithTimestamps const&)
@@ -308,9 +320,11 @@ struct nucleiFilter {
     hProcessedEvents->Fill(0);
     //
     if (!collision.selection_bit(aod::evsel::kNoTimeFrameBorder)) {
+      instrumentation.countDecisions(keepEvent);
       tags(keepEvent[kH2], keepEvent[kHe], keepEvent[kHeV0], keepEvent[kTritonFemto], keepEvent[kH3L3Body], keepEvent[kTracked3Body], keepEvent[kITSmildIonisation], keepEvent[kITSextremeIonisation]);
       return;
     }
+    instrumentation.start();
 
     //
     const double bgScalings[nNuclei][2]{
@@ -398,6 +412,7 @@ struct nucleiFilter {
       qaHists.fill(HIST("fTPCsignal"), track.sign() * track.tpcInnerParam() * fixTPCrigidity, track.tpcSignal());
 
     } // end loop over tracks
+    instrumentation.lap(kSectionTracks, tracks.size());
 
     for (const auto& track : tracks) {
       if (track.itsNCls() < cfgCutNclusITS ||
@@ -423,6 +438,7 @@ struct nucleiFilter {
         }
       }
     }
+    instrumentation.lap(kSectionTritonFemto, tracks.size());
 
     for (const auto& v0 : v0s) {
       const auto& posTrack = v0.posTrack_as<TrackCandidates>();
@@ -472,6 +488,7 @@ struct nucleiFilter {
       keepEvent[kHeV0] = true;
       break;
     }
+    instrumentation.lap(kSectionV0s, v0s.size());
 
     // fH3L3Body trigger
     auto bc = collision.bc_as<aod::BCsWithTimestamps>();
@@ -618,6 +635,8 @@ struct nucleiFilter {
       }
     }
 
+    instrumentation.lap(kSectionDecay3Bodys, decay3bodys.size());
+
     keepEvent[kTracked3Body] = tracked3Bodys.size() > 0;
 
     for (int iDecision{0}; iDecision < kNtriggers; ++iDecision) {
@@ -625,6 +644,7 @@ struct nucleiFilter {
         hProcessedEvents->Fill(iDecision + 1);
       }
     }
+    instrumentation.countDecisions(keepEvent);
 
     tags(keepEvent[kH2], keepEvent[kHe], keepEvent[kHeV0], keepEvent[kTritonFemto], keepEvent[kH3L3Body], keepEvent[kTracked3Body], keepEvent[kITSmildIonisation], keepEvent[kITSextremeIonisation]);
   }
@@ -40,6 +40,7 @@
 #include <Rtypes.h>
 
 #include <array>
+#include <bit>
 #include <cstdint>
 #include <cstdio>
 #include <memory>
@@ -85,6 +86,17 @@ bool readJsonFile(std::string& config, Document& d)
   return true;
 }
 
+// uniform number in [0, 1) computed from the global BC of the collision and the trigger channel (splitmix64)
+// the downscaling decisions are reproducible and do not depend on the order of the data
+double bcUniform(uint64_t globalBC, uint64_t channel)
+{
+  uint64_t z{globalBC + (channel + 1) * 0x9e3779b97f4a7c15ull};
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  z ^= z >> 31;
+  return (z >> 11) * 0x1.0p-53;
+}
+
 std::unordered_map<std::string, std::unordered_map<std::string, float>> mDownscaling;
 static const std::vector<std::string> downscalingName{"Downscaling"};
 static const float defaultDownscaling[128][1]{
@@ -231,6 +243,7 @@ struct centralEventFilterTask {
 
   Configurable<bool> cfgDisableDownscalings{"cfgDisableDownscalings", false, "Disable downscalings"};
   Configurable<bool> cfgSkipUntriggeredEvents{"cfgSkipUntriggeredEvents", false, "Skip untriggered events"};
+  Configurable<bool> cfgDeterministicDownscalings{"cfgDeterministicDownscalings", false, "Downscale with a random number computed from the global BC of the collision and the channel"};
 
   FILTER_CONFIGURABLE(F1ProtonFilters);
   FILTER_CONFIGURABLE(DoublePhiFilters);
@@ -353,21 +366,40 @@ struct centralEventFilterTask {
         auto column{tablePtr->GetColumnByName(colName.first)};
         double downscaling{cfgDisableDownscalings.value ? 1. : colName.second};
         if (column) {
-          int entry = 0;
+          int64_t firstEntry{0};
           for (int64_t iC{0}; iC < column->num_chunks(); ++iC) {
             auto chunk{column->chunk(iC)};
             auto boolArray = std::static_pointer_cast<arrow::BooleanArray>(chunk);
-            for (int64_t iS{startCollision}; iS < chunk->length(); ++iS) {
-              if (boolArray->Value(iS)) {
-                mScalers->Fill(binCenter);
-                outTrigger[entry][decisionBin] |= triggerBit;
-                if (mUniformGenerator(mGeneratorEngine) < downscaling) {
-                  mFiltered->Fill(binCenter);
-                  outDecision[entry][decisionBin] |= triggerBit;
-                }
+            const int64_t length{chunk->length()};
+            if (length <= startCollision) {
+              continue;
+            }
+            // the triggers are read from the bitmap of the chunk, the bytes without triggers are skipped
+            const uint8_t* bits{boolArray->values()->data()};
+            const int64_t bitOffset{boolArray->offset()};
+            for (int64_t iS{startCollision}; iS < length; ++iS) {
+              const int64_t iBit{bitOffset + iS};
+              if (!(iBit & 7) && iS + 8 <= length && !bits[iBit >> 3]) {
+                iS += 7;
+                continue;
+              }
+              if (!((bits[iBit >> 3] >> (iBit & 7)) & 1)) {
+                continue;
+              }
+              const int64_t entry{firstEntry + iS - startCollision};
+              mScalers->Fill(binCenter);
+              outTrigger[entry][decisionBin] |= triggerBit;
+              bool isSelected{downscaling >= 1.};
+              if (!isSelected) {
+                const double random{cfgDeterministicDownscalings.value ? bcUniform(GloBCArray->Value(CollBCIdArray->Value(entry)), bin - 2) : mUniformGenerator(mGeneratorEngine)};
+                isSelected = random < downscaling;
+              }
+              if (isSelected) {
+                mFiltered->Fill(binCenter);
+                outDecision[entry][decisionBin] |= triggerBit;
               }
-              entry++;
             }
+            firstEntry += length - startCollision;
           }
         }
       }
@@ -379,15 +411,15 @@ struct centralEventFilterTask {
       const auto& triggerWord{outTrigger[iE]};
       bool triggered{false}, selected{false};
       for (uint64_t iD{0}; iD < triggerWord.size(); ++iD) {
-        for (int iB{0}; iB < 64; ++iB) {
-          if (!(triggerWord[iD] & BIT(iB))) {
-            continue;
-          }
+        // loop over the set bits only
+        for (uint64_t iWord{triggerWord[iD]}; iWord; iWord &= iWord - 1) {
+          const int iB{std::countr_zero(iWord)};
           uint64_t xIndex{iD * 64 + iB};
           for (uint64_t jD{0}; jD < triggerWord.size(); ++jD) {
-            for (int jB{0}; jB < 64; ++jB) {
+            for (uint64_t jWord{triggerWord[jD]}; jWord; jWord &= jWord - 1) {
+              const int jB{std::countr_zero(jWord)};
               uint64_t yIndex{jD * 64 + jB};
-              if (xIndex <= yIndex && triggerWord[jD] & BIT(jB)) {
+              if (xIndex <= yIndex) {
                 mCovariance->Fill(iD * 64 + iB, jD * 64 + jB);
               }
             }
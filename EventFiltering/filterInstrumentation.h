@@ -0,0 +1,139 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file filterInstrumentation.h
+/// \brief Cost and selectivity instrumentation of the software trigger filters
+///
+/// The filters split their processing into sections (e.g. the loops over the tracks, V0s or candidates of each
+/// trigger). The instrumentation measures the CPU time of the thread spent in each section, the number of candidates
+/// evaluated in each section, the number of events evaluated and accepted by each trigger, and the high-water mark of
+/// the resident memory of the process. They are published as histograms of the registry of the filter, in the folder
+/// "instrumentation". If the instrumentation is not active, all the calls return immediately.
+
+#ifndef EVENTFILTERING_FILTERINSTRUMENTATION_H_
+#define EVENTFILTERING_FILTERINSTRUMENTATION_H_
+
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
+
+#include <TH1.h>
+
+#include <sys/resource.h>
+
+#include <array>
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace o2::aod::filtering
+{
+class FilterInstrumentation
+{
+ public:
+  /// \param registry histogram registry of the filter
+  /// \param sectionNames names of the timed sections
+  /// \param triggerNames names of the triggers of the filter
+  /// \param isActive the instrumentation is active
+  void init(o2::framework::HistogramRegistry& registry, std::vector<std::string> const& sectionNames, std::vector<std::string> const& triggerNames, bool isActive)
+  {
+    mIsActive = isActive;
+    if (!mIsActive) {
+      return;
+    }
+    const int nSections = sectionNames.size();
+    const int nTriggers = triggerNames.size();
+    mCpuTime = registry.add<TH1>("instrumentation/fCpuTime", "CPU time per section;;CPU time (#mus)", o2::framework::HistType::kTH1D, {{nSections, -0.5, nSections - 0.5}});
+    mCandidates = registry.add<TH1>("instrumentation/fCandidates", "Candidates evaluated per section;;Number of candidates", o2::framework::HistType::kTH1D, {{nSections, -0.5, nSections - 0.5}});
+    mEvaluated = registry.add<TH1>("instrumentation/fEvaluated", "Events evaluated per trigger;;Number of events", o2::framework::HistType::kTH1D, {{nTriggers, -0.5, nTriggers - 0.5}});
+    mAccepted = registry.add<TH1>("instrumentation/fAccepted", "Events accepted per trigger;;Number of events", o2::framework::HistType::kTH1D, {{nTriggers, -0.5, nTriggers - 0.5}});
+    mMaxRss = registry.add<TH1>("instrumentation/fMaxRss", "High-water mark of the resident memory;;Memory (kB)", o2::framework::HistType::kTH1D, {{1, -0.5, 0.5}});
+    for (int iS{0}; iS < nSections; ++iS) {
+      mCpuTime->GetXaxis()->SetBinLabel(iS + 1, sectionNames[iS].data());
+      mCandidates->GetXaxis()->SetBinLabel(iS + 1, sectionNames[iS].data());
+    }
+    for (int iT{0}; iT < nTriggers; ++iT) {
+      mEvaluated->GetXaxis()->SetBinLabel(iT + 1, triggerNames[iT].data());
+      mAccepted->GetXaxis()->SetBinLabel(iT + 1, triggerNames[iT].data());
+    }
+    mMaxRss->GetXaxis()->SetBinLabel(1, "Max RSS");
+  }
+
+  /// Starts the timing of the sections
+  void start()
+  {
+    if (mIsActive) {
+      mLastTime = cpuTime();
+    }
+  }
+
+  /// Adds the CPU time since the last call of start() or lap() to a section and restarts the timing
+  /// \param section index of the section
+  /// \param nCandidates number of candidates evaluated in the section
+  void lap(int section, int nCandidates = 0)
+  {
+    if (!mIsActive) {
+      return;
+    }
+    const double time = cpuTime();
+    mCpuTime->AddBinContent(section + 1, (time - mLastTime) * 1.e6);
+    mCandidates->AddBinContent(section + 1, nCandidates);
+    mLastTime = time;
+  }
+
+  /// Counts the decisions of the triggers for an event, and updates the high-water mark of the memory
+  /// \param keepEvent decision of each trigger
+  template <std::size_t N>
+  void countDecisions(std::array<bool, N> const& keepEvent)
+  {
+    if (!mIsActive) {
+      return;
+    }
+    for (std::size_t iT{0}; iT < N; ++iT) {
+      mEvaluated->AddBinContent(iT + 1);
+      if (keepEvent[iT]) {
+        mAccepted->AddBinContent(iT + 1);
+      }
+    }
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+      const double maxRss = usage.ru_maxrss / 1024.; // bytes on macOS
+#else
+      const double maxRss = usage.ru_maxrss; // kB on Linux
+#endif
+      if (maxRss > mMaxRss->GetBinContent(1)) {
+        mMaxRss->SetBinContent(1, maxRss);
+      }
+    }
+  }
+
+ private:
+  /// \return CPU time of the thread, in seconds
+  static double cpuTime()
+  {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1.e-9;
+  }
+
+  bool mIsActive = false;           // the instrumentation is active
+  double mLastTime = 0.;            // CPU time at the last start() or lap()
+  std::shared_ptr<TH1> mCpuTime;    // CPU time per section
+  std::shared_ptr<TH1> mCandidates; // candidates evaluated per section
+  std::shared_ptr<TH1> mEvaluated;  // events evaluated per trigger
+  std::shared_ptr<TH1> mAccepted;   // events accepted per trigger
+  std::shared_ptr<TH1> mMaxRss;     // high-water mark of the resident memory
+};
+} // namespace o2::aod::filtering
+
+#endif // EVENTFILTERING_FILTERINSTRUMENTATION_H_
@@ -87,6 +87,7 @@ struct BCRangeSelector {
     auto filt = decisions.begin();
     int firstSelectedCollision{-1};
     std::vector<IRFrame> bcRanges;
+    bcRanges.reserve(cols.size());
     int nColl{0}, nSelected{0};
     for (auto collision : cols) {
       if (filt.cefpSelected0() || filt.cefpSelected1()) {
@@ -124,15 +125,17 @@ struct BCRangeSelector {
       return a.getMin() < b.getMin();
     });
 
-    std::vector<IRFrame> bcRangesMerged(1, bcRanges[0]);
+    /// Union of the ranges, merged in place: the ranges which overlap or are contiguous (the limits are included) are joined
+    uint64_t nMerged{1};
     for (uint64_t iR{1}; iR < bcRanges.size(); ++iR) {
-      if (bcRangesMerged.back().getMax() >= bcRanges[iR].getMin()) {
-        bcRangesMerged.back().getMax() = std::max(bcRangesMerged.back().getMax(), bcRanges[iR].getMax());
+      auto& last = bcRanges[nMerged - 1];
+      if (last.getMax().toLong() + 1 >= bcRanges[iR].getMin().toLong()) {
+        last.getMax() = std::max(last.getMax(), bcRanges[iR].getMax());
       } else {
-        bcRangesMerged.push_back(bcRanges[iR]);
+        bcRanges[nMerged++] = bcRanges[iR];
       }
     }
-    bcRanges.swap(bcRangesMerged);
+    bcRanges.resize(nMerged);
 
     for (auto& range : bcRanges) {
       tags(range.getMin().toLong(), range.getMax().toLong());
@@ -0,0 +1,76 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_CORE_PHISTARCACHE_H_
+#define PWGCF_CORE_PHISTARCACHE_H_
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+
+// Cache of the azimuthal angles phi* of single particles at a fixed set of radii, used by the close pair rejections
+//
+// phi* only depends on the particle (charge times pT, phi) and on the magnetic field, so it is computed once per
+// particle and reused by all the pairs and triplets the particle enters, in the same and in the mixed events. The
+// particles are identified by their index (e.g. the global index of the table row); the charge times pT, phi and
+// the magnetic field are stored with the values and checked at each lookup, so that a reused index (new data
+// frame, other table) can never return stale values. The cache is cleared when it exceeds a fixed number of
+// particles, which bounds its memory.
+
+template <std::size_t NRadii>
+class PhiStarCache
+{
+  static_assert(NRadii <= 32, "The validity of phi* is stored in a 32-bit mask");
+
+ public:
+  struct Entry {
+    float magField = 0.f;                // magnetic field of the values
+    float chargedPt = 0.f;               // charge times pT of the particle
+    float phi = 0.f;                     // azimuth of the particle
+    std::array<float, NRadii> phiStar{}; // phi* at each radius
+    uint32_t validMask = 0;              // bit i set if phi* could be computed at radius i
+  };
+
+  /// Gets phi* of a particle, computed at the first request
+  /// \param index unique index of the particle
+  /// \param magField magnetic field
+  /// \param chargedPt charge times pT of the particle
+  /// \param phi azimuth of the particle
+  /// \param compute callable filling the array of phi* and returning the mask of the radii where it could be computed
+  /// \return phi* of the particle at all the radii
+  template <typename TCompute>
+  Entry get(int64_t index, float magField, float chargedPt, float phi, TCompute&& compute)
+  {
+    auto [it, isNew] = mEntries.try_emplace(index);
+    Entry& entry = it->second;
+    if (isNew || entry.magField != magField || entry.chargedPt != chargedPt || entry.phi != phi) {
+      entry.magField = magField;
+      entry.chargedPt = chargedPt;
+      entry.phi = phi;
+      entry.validMask = compute(entry.phiStar);
+    }
+    const Entry result = entry;
+    if (mEntries.size() > MaxEntries) {
+      mEntries.clear();
+    }
+    return result;
+  }
+
+  void clear() { mEntries.clear(); }
+
+ private:
+  static constexpr std::size_t MaxEntries = 1 << 16; // maximum number of cached particles
+
+  std::unordered_map<int64_t, Entry> mEntries; // cached particles
+};
+
+#endif // PWGCF_CORE_PHISTARCACHE_H_
@@ -0,0 +1,187 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGCF_CORE_STEPTHNFILLER_H_
+#define PWGCF_CORE_STEPTHNFILLER_H_
+
+#include <Framework/Logger.h>
+#include <Framework/StepTHn.h>
+
+#include <TArray.h>
+#include <TArrayD.h>
+#include <TArrayF.h>
+#include <TAxis.h>
+
+#include <RtypesCore.h>
+
+#include <algorithm>
+#include <vector>
+
+// Fast fill path of a StepTHn for the high-rate pair loops of the correlation tasks
+//
+// The binning of the axes and the strides of the global bin index are cached when the filler is bound to the
+// histogram. The bin lookup is done inline (arithmetic for fixed bins, binary search for variable bins), and the bin
+// of each axis is kept as long as its value does not change, so that the coordinates of the trigger particle are
+// looked up once per trigger while its associated particles are looped. The entries are added directly to the dense
+// containers of the StepTHn; the containers are created by StepTHn::Fill at the first entry of a step, or at the
+// first weighted entry for the squared weights, exactly as in StepTHn.
+
+class StepTHnFiller
+{
+ public:
+  /// Binds the filler to a histogram, nothing is done if it is already bound to it
+  /// The binning of the histogram must not change while it is bound
+  void bind(StepTHn* hist)
+  {
+    if (hist == mHist) {
+      return;
+    }
+    mHist = hist;
+    const int nVars = hist->getNVar();
+    mAxes.assign(nVars, Axis());
+    mStrides.assign(nVars, 1);
+    for (int i = nVars - 1; i >= 0; i--) {
+      const TAxis* axis = hist->GetAxis(i);
+      Axis& cache = mAxes[i];
+      cache.nBins = axis->GetNbins();
+      cache.min = axis->GetXmin();
+      cache.max = axis->GetXmax();
+      if (axis->GetXbins()->fN) {
+        cache.edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->fN);
+      }
+      cache.lastValue = cache.min - 1;
+      cache.lastBin = 0;
+      if (i < nVars - 1) {
+        mStrides[i] = mStrides[i + 1] * mAxes[i + 1].nBins;
+      }
+    }
+    mContainers.assign(hist->getNSteps(), Containers());
+  }
+
+  /// Fills an entry, with the same arguments and the same result as StepTHn::Fill
+  /// \param step analysis step
+  /// \param valuesAndWeight values of all the axes, optionally followed by the weight
+  template <typename... Ts>
+  void fill(int step, const Ts&... valuesAndWeight)
+  {
+    constexpr int NArgs = sizeof...(Ts);
+    const int nVars = mAxes.size();
+    if (NArgs != nVars && NArgs != nVars + 1) {
+      LOGF(fatal, "Number of arguments (%d) does not match the number of axes (%d) of %s", NArgs, nVars, mHist->GetName());
+    }
+    const double values[] = {static_cast<double>(valuesAndWeight)...};
+    const double weight = (NArgs == nVars + 1) ? values[nVars] : 1.;
+
+    Long64_t bin = 0;
+    for (int i = 0; i < nVars; i++) {
+      const int tmpBin = mAxes[i].findBin(values[i]);
+      // under/overflow not supported, as in StepTHn
+      if (tmpBin < 1 || tmpBin > mAxes[i].nBins) {
+        return;
+      }
+      bin += (tmpBin - 1) * mStrides[i];
+    }
+
+    Containers& containers = mContainers[step];
+    if (containers.values != mHist->getValues(step) || containers.sumw2 != mHist->getSumw2(step)) {
+      containers.update(mHist->getValues(step), mHist->getSumw2(step));
+    }
+    if (!containers.values || (weight != 1. && !containers.sumw2)) {
+      // let StepTHn create the missing container
+      mHist->Fill(step, valuesAndWeight...);
+      return;
+    }
+    containers.add(bin, weight);
+  }
+
+ private:
+  struct Axis {
+    int nBins = 0;             // number of bins
+    double min = 0.;           // lower edge
+    double max = 0.;           // upper edge
+    std::vector<double> edges; // bin edges, empty for fixed bins
+    double lastValue = 0.;     // last value looked up
+    int lastBin = 0;           // bin of the last value
+
+    /// \return the bin of a value, as TAxis::FindBin
+    int findBin(double x)
+    {
+      if (x == lastValue) {
+        return lastBin;
+      }
+      int bin;
+      if (x < min) {
+        bin = 0;
+      } else if (!(x < max)) {
+        bin = nBins + 1;
+      } else if (edges.empty()) {
+        bin = 1 + static_cast<int>(nBins * (x - min) / (max - min));
+      } else {
+        bin = std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+      }
+      lastValue = x;
+      lastBin = bin;
+      return bin;
+    }
+  };
+
+  struct Containers {
+    TArray* values = nullptr;    // container of the values of the step
+    TArray* sumw2 = nullptr;     // container of the squared weights of the step
+    Float_t* valuesF = nullptr;  // values of a StepTHnF
+    Double_t* valuesD = nullptr; // values of a StepTHnD
+    Float_t* sumw2F = nullptr;   // squared weights of a StepTHnF
+    Double_t* sumw2D = nullptr;  // squared weights of a StepTHnD
+
+    void update(TArray* newValues, TArray* newSumw2)
+    {
+      values = newValues;
+      sumw2 = newSumw2;
+      valuesF = nullptr;
+      valuesD = nullptr;
+      sumw2F = nullptr;
+      sumw2D = nullptr;
+      if (auto* array = dynamic_cast<TArrayF*>(values)) {
+        valuesF = array->GetArray();
+      } else if (auto* array = dynamic_cast<TArrayD*>(values)) {
+        valuesD = array->GetArray();
+      } else if (values) {
+        LOGF(fatal, "Unsupported container type of StepTHn");
+      }
+      if (auto* array = dynamic_cast<TArrayF*>(sumw2)) {
+        sumw2F = array->GetArray();
+      } else if (auto* array = dynamic_cast<TArrayD*>(sumw2)) {
+        sumw2D = array->GetArray();
+      }
+    }
+
+    void add(Long64_t bin, double weight)
+    {
+      if (valuesF) {
+        valuesF[bin] += weight;
+      } else {
+        valuesD[bin] += weight;
+      }
+      if (sumw2F) {
+        sumw2F[bin] += weight * weight;
+      } else if (sumw2D) {
+        sumw2D[bin] += weight * weight;
+      }
+    }
+  };
+
+  StepTHn* mHist = nullptr;            // histogram the filler is bound to
+  std::vector<Axis> mAxes;             // binning of the axes
+  std::vector<Long64_t> mStrides;      // stride of each axis in the global bin index
+  std::vector<Containers> mContainers; // containers per step
+};
+
+#endif // PWGCF_CORE_STEPTHNFILLER_H_
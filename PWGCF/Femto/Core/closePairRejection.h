@@ -16,6 +16,7 @@
 #ifndef PWGCF_FEMTO_CORE_CLOSEPAIRREJECTION_H_
 #define PWGCF_FEMTO_CORE_CLOSEPAIRREJECTION_H_
 
+#include "PWGCF/Core/PhiStarCache.h"
 #include "PWGCF/Femto/Core/histManager.h"
 
 #include "Common/Core/RecoDecay.h"
@@ -103,6 +104,13 @@ using ConfCprTrackCascadeBachelor = ConfCpr<PrefixCprTrackCascadeBachelor>;
 constexpr int Nradii = 9;
 constexpr std::array<float, Nradii> TpcRadii = {85., 105., 125., 145., 165., 185., 205., 225., 245.}; // in cm
 
+// phi* of the particles at the tpc radii, shared by all the close pair and triplet rejections of the thread
+inline PhiStarCache<Nradii>& getPhiStarCache()
+{
+  thread_local PhiStarCache<Nradii> cache;
+  return cache;
+}
+
 // directory names
 constexpr char PrefixTrackTrackSe[] = "CPR_TrackTrack/SE/";
 constexpr char PrefixTrackTrackMe[] = "CPR_TrackTrack/ME/";
@@ -255,11 +263,12 @@ class CloseTrackRejection
 
     mDeta = t1.eta() - t2.eta();
 
+    const auto phistar1 = getPhistar(t1, mChargeAbsTrack1);
+    const auto phistar2 = getPhistar(t2, mChargeAbsTrack2);
+    const uint32_t validMask = phistar1.validMask & phistar2.validMask;
     for (size_t i = 0; i < TpcRadii.size(); i++) {
-      auto phistar1 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack1 * t1.signedPt(), t1.phi());
-      auto phistar2 = phistar(mMagField, TpcRadii[i], mChargeAbsTrack2 * t2.signedPt(), t2.phi());
-      if (phistar1 && phistar2) {
-        mDphistar.at(i) = RecoDecay::constrainAngle(phistar1.value() - phistar2.value(), -o2::constants::math::PI); // constrain angular difference between -pi and pi
+      if (validMask & (1u << i)) {
+        mDphistar.at(i) = RecoDecay::constrainAngle(phistar1.phiStar[i] - phistar2.phiStar[i], -o2::constants::math::PI); // constrain angular difference between -pi and pi
         mDphistarMask.at(i) = true;
         count++;
       }
@@ -363,6 +372,25 @@ class CloseTrackRejection
   bool isActivated() const { return mIsActivated; }
 
  private:
+  // phi* at all the tpc radii, computed once per track
+  template <typename T>
+  PhiStarCache<Nradii>::Entry getPhistar(T const& track, int chargeAbs)
+  {
+    const float chargedPt = chargeAbs * track.signedPt();
+    const float phi = track.phi();
+    return getPhiStarCache().get(track.globalIndex(), mMagField, chargedPt, phi, [&](std::array<float, Nradii>& values) {
+      uint32_t validMask = 0;
+      for (size_t i = 0; i < TpcRadii.size(); i++) {
+        auto value = phistar(mMagField, TpcRadii[i], chargedPt, phi);
+        values[i] = value.value_or(0.f);
+        if (value) {
+          validMask |= 1u << i;
+        }
+      }
+      return validMask;
+    });
+  }
+
   std::optional<float> phistar(float magfield, float radius, float signedPt, float phi)
   {
     double arg = 0.3 * (0.1 * magfield) * (0.01 * radius) / (2. * signedPt);
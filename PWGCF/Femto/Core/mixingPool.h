@@ -0,0 +1,150 @@
+// Copyright 2019-2025 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file mixingPool.h
+/// \brief pool of events for the event mixing, kept across data frames
+///
+/// The events of each mixing bin are stored as slim records of their particles (kinematics and charge), so that each
+/// collision can be mixed with the most recent events of its mixing bin, also if they were in a previous data frame.
+/// The records provide the getters of the femto tables used in the mixed event (pair histograms, pair cleaner and close
+/// pair rejection). Each record gets a unique negative index, which can never collide with the global index of a table
+/// row, so the pair cleaner never rejects a mixed pair and the phi* of the record is cached once in the close pair
+/// rejection.
+
+#ifndef PWGCF_FEMTO_CORE_MIXINGPOOL_H_
+#define PWGCF_FEMTO_CORE_MIXINGPOOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace o2::analysis::femto
+{
+namespace mixingpool
+{
+
+/// Track kept in the mixing pool
+template <bool WithMass>
+class PooledTrack
+{
+ public:
+  template <typename T>
+  PooledTrack(T const& track, int64_t index)
+    : mIndex(index),
+      mPt(track.pt()),
+      mEta(track.eta()),
+      mPhi(track.phi()),
+      mSignedPt(track.signedPt())
+  {
+    if constexpr (WithMass) {
+      mMass = track.mass();
+    }
+  }
+
+  int64_t globalIndex() const { return mIndex; }
+  float pt() const { return mPt; }
+  float eta() const { return mEta; }
+  float phi() const { return mPhi; }
+  float signedPt() const { return mSignedPt; }
+  float mass() const
+    requires WithMass
+  {
+    return mMass;
+  }
+
+ private:
+  int64_t mIndex = 0;    // unique (negative) index of the record
+  float mPt = 0.f;       // transverse momentum
+  float mEta = 0.f;      // pseudorapidity
+  float mPhi = 0.f;      // azimuth
+  float mSignedPt = 0.f; // charge times transverse momentum
+  float mMass = 0.f;     // reconstructed mass, only set if WithMass
+};
+
+/// Event kept in the mixing pool, with its particles
+template <typename TRecord>
+class PooledEvent
+{
+ public:
+  template <typename T>
+  explicit PooledEvent(T const& col)
+    : mPosZ(col.posZ()),
+      mMult(col.mult()),
+      mCent(col.cent()),
+      mMagField(col.magField())
+  {
+  }
+
+  float posZ() const { return mPosZ; }
+  float mult() const { return mMult; }
+  float cent() const { return mCent; }
+  int8_t magField() const { return mMagField; }
+
+  std::vector<TRecord> const& getParticles() const { return mParticles; }
+  std::vector<TRecord>& getParticles() { return mParticles; }
+
+ private:
+  float mPosZ = 0.f;               // z coordinate of the vertex
+  float mMult = 0.f;               // multiplicity
+  float mCent = 0.f;               // centrality
+  int8_t mMagField = 0;            // magnetic field
+  std::vector<TRecord> mParticles; // records of the particles
+};
+
+/// Pool of the most recent events of each mixing bin
+template <typename TRecord>
+class MixingPool
+{
+ public:
+  using Event = PooledEvent<TRecord>;
+
+  /// \param depth maximum number of events kept per mixing bin
+  void init(int depth) { mDepth = depth; }
+
+  /// \return the events of a mixing bin, most recent first
+  std::deque<Event> const& getEvents(int bin) { return mBins[bin]; }
+
+  /// Adds an event to a mixing bin, the oldest event of the bin is dropped if the bin is full
+  /// \param bin mixing bin of the event
+  /// \param col collision
+  /// \param particles particles of the collision to be kept
+  template <typename T1, typename T2>
+  void push(int bin, T1 const& col, T2 const& particles)
+  {
+    if (mDepth <= 0) {
+      return;
+    }
+    Event event(col);
+    event.getParticles().reserve(particles.size());
+    for (auto const& particle : particles) {
+      event.getParticles().emplace_back(particle, mNextIndex--);
+    }
+    auto& events = mBins[bin];
+    events.push_front(std::move(event));
+    if (static_cast<int>(events.size()) > mDepth) {
+      events.pop_back();
+    }
+  }
+
+  void clear() { mBins.clear(); }
+
+ private:
+  int mDepth = 0;                                   // maximum number of events per mixing bin
+  int64_t mNextIndex = -1;                          // index of the next record
+  std::unordered_map<int, std::deque<Event>> mBins; // events per mixing bin
+};
+
+} // namespace mixingpool
+} // namespace o2::analysis::femto
+
+#endif // PWGCF_FEMTO_CORE_MIXINGPOOL_H_
@@ -19,7 +19,9 @@
 #include "PWGCF/Femto/Core/cascadeHistManager.h"
 #include "PWGCF/Femto/Core/closePairRejection.h"
 #include "PWGCF/Femto/Core/collisionHistManager.h"
+#include "PWGCF/Femto/Core/femtoUtils.h"
 #include "PWGCF/Femto/Core/kinkHistManager.h"
+#include "PWGCF/Femto/Core/mixingPool.h"
 #include "PWGCF/Femto/Core/modes.h"
 #include "PWGCF/Femto/Core/pairCleaner.h"
 #include "PWGCF/Femto/Core/pairHistManager.h"
@@ -40,6 +42,7 @@
 #include <cstdint>
 #include <map>
 #include <random>
+#include <type_traits>
 #include <vector>
 
 namespace o2::analysis::femto
@@ -128,6 +131,9 @@ class PairTrackTrackBuilder
     // setup mixing
     mMixingPolicy = static_cast<pairhistmanager::MixingPolicy>(confMixing.policy.value);
     mMixingDepth = confMixing.depth.value;
+    mUseMixingPool = confMixing.usePool.value;
+    mMixingPool.init(mMixingDepth);
+    mMixingPoolWithMass.init(mMixingDepth);
 
     // setup rng if necessary
     if (confMixing.seed.value >= 0) {
@@ -202,6 +208,28 @@ class PairTrackTrackBuilder
   template <modes::Mode mode, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8>
   void processMixedEvent(T1 const& cols, T2& trackTable, T3& partition1, T4& partition2, T5& cache, T6& binsVtxMult, T7& binsVtxCent, T8& binsVtxMultCent)
   {
+    if (mUseMixingPool) {
+      auto getMixingBin = [&](auto const& col) {
+        switch (mMixingPolicy) {
+          case static_cast<int>(pairhistmanager::kVtxMult):
+            return binsVtxMult.getBin({col.posZ(), col.mult()});
+          case static_cast<int>(pairhistmanager::kVtxCent):
+            return binsVtxCent.getBin({col.posZ(), col.cent()});
+          case static_cast<int>(pairhistmanager::kVtxMultCent):
+            return binsVtxMultCent.getBin({col.posZ(), col.mult(), col.cent()});
+          default:
+            LOG(fatal) << "Invalid binning policiy specifed. Breaking...";
+        }
+        return -1;
+      };
+      if (mSameSpecies) {
+        processMixedEventWithPool<mode>(cols, trackTable, partition1, partition1, cache, getMixingBin);
+      } else {
+        processMixedEventWithPool<mode>(cols, trackTable, partition1, partition2, cache, getMixingBin);
+      }
+      return;
+    }
+
 
     if (mSameSpecies) {
       switch (mMixingPolicy) {
@@ -269,6 +297,16 @@ class PairTrackTrackBuilder
   }
 
  private:
+  template <modes::Mode mode, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
+  void processMixedEventWithPool(T1 const& cols, T2& trackTable, T3& partition1, T4& partition2, T5& cache, T6 const& getMixingBin)
+  {
+    if constexpr (utils::HasMass<typename std::decay_t<T2>::iterator>) {
+      pairprocesshelpers::processMixedEventWithPool<mode>(cols, partition1, partition2, trackTable, cache, getMixingBin, mMixingPoolWithMass, mPairHistManagerMe, mCprMe, mPc);
+    } else {
+      pairprocesshelpers::processMixedEventWithPool<mode>(cols, partition1, partition2, trackTable, cache, getMixingBin, mMixingPool, mPairHistManagerMe, mCprMe, mPc);
+    }
+  }
+
   colhistmanager::CollisionHistManager mColHistManager;
   trackhistmanager::TrackHistManager<prefixTrack1> mTrackHistManager1;
   trackhistmanager::TrackHistManager<prefixTrack2> mTrackHistManager2;
@@ -281,6 +319,9 @@ class PairTrackTrackBuilder
   particlecleaner::ParticleCleaner mTrackCleaner2;
   pairhistmanager::MixingPolicy mMixingPolicy = pairhistmanager::MixingPolicy::kVtxMult;
   int mMixingDepth = 5;
+  bool mUseMixingPool = false;
+  mixingpool::MixingPool<mixingpool::PooledTrack<false>> mMixingPool;
+  mixingpool::MixingPool<mixingpool::PooledTrack<true>> mMixingPoolWithMass;
   bool mSameSpecies = false;
   bool mMixIdenticalParticles = false;
   std::mt19937 mRng;
@@ -135,6 +135,7 @@ struct ConfMixing : o2::framework::ConfigurableGroup {
   o2::framework::Configurable<int> depth{"depth", 5, "Number of events for mixing"};
   o2::framework::Configurable<int> policy{"policy", 0, "Binning policy for mixing (alywas in combination with z-vertex) -> 0: multiplicity, -> 1: centrality, -> 2: both"};
   o2::framework::Configurable<bool> sameSpecies{"sameSpecies", false, "Enable if particle 1 and particle 2 are the same"};
+  o2::framework::Configurable<bool> usePool{"usePool", false, "Mix each collision with particle 2 of the last (depth) collisions of its mixing bin, kept across data frames (track-track pairs in data only)"};
   o2::framework::Configurable<int> seed{"seed", -1, "Seed to randomize particle 1 and particle 2 (if they are identical). Set to negative value to deactivate. Set to 0 to generate unique seed in time."};
   o2::framework::Configurable<bool> enablePairCorrelationQa{"enablePairCorrelationQa", true, "Enable pair-level correlation QA (same-event + mixed-event)"};
   o2::framework::Configurable<bool> enableEventMixingQa{"enableEventMixingQa", false, "Enable QA of event properties used in event mixing (vtx, multiplicity, centrality)"};
@@ -494,14 +495,17 @@ class PairHistManager
     mParticle1 = ROOT::Math::PtEtaPhiMVector(mAbsCharge1 * particle1.pt(), particle1.eta(), particle1.phi(), mass1);
     mParticle2 = ROOT::Math::PtEtaPhiMVector(mAbsCharge2 * particle2.pt(), particle2.eta(), particle2.phi(), mass2);
 
+    // the pair momentum is shared by kT, mT and Minv
+    auto const sum = mParticle1 + mParticle2;
+
     // set kT
-    mKt = getKt(mParticle1, mParticle2);
+    mKt = getKt(sum);
 
     // set mT
-    mMt = getMt(mParticle1, mParticle2);
+    mMt = getMt(mParticle1, mParticle2, sum);
 
     // set Minv
-    mMassInv = getMinv(mParticle1, mParticle2);
+    mMassInv = getMinv(sum);
 
     // set kstar
     mKstar = getKstar(mParticle1, mParticle2);
@@ -560,9 +564,10 @@ class PairHistManager
     mTrueParticle2 = ROOT::Math::PtEtaPhiMVector(mAbsCharge2 * mcParticle2.pt(), mcParticle2.eta(), mcParticle2.phi(), mPdgMass2);
 
     // compute true kinematics
-    mTrueKt = getKt(mTrueParticle1, mTrueParticle2);
-    mTrueMt = getMt(mTrueParticle1, mTrueParticle2);
-    mTrueMinv = getMinv(mTrueParticle1, mTrueParticle2);
+    auto const trueSum = mTrueParticle1 + mTrueParticle2;
+    mTrueKt = getKt(trueSum);
+    mTrueMt = getMt(mTrueParticle1, mTrueParticle2, trueSum);
+    mTrueMinv = getMinv(trueSum);
     mTrueKstar = getKstar(mTrueParticle1, mTrueParticle2);
   }
 
@@ -900,16 +905,14 @@ class PairHistManager
     }
   }
 
-  float getKt(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2)
+  float getKt(ROOT::Math::PtEtaPhiMVector const& sum)
   {
-    auto sum = (part1 + part2);
     double kt = 0.5 * sum.Pt();
     return static_cast<float>(kt);
   }
 
-  float getMt(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2)
+  float getMt(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2, ROOT::Math::PtEtaPhiMVector const& sum)
   {
-    auto sum = part1 + part2;
     double mt = 0;
     double averageMass = 0;
     double reducedMass = 0;
@@ -931,9 +934,9 @@ class PairHistManager
     return static_cast<float>(mt);
   }
 
-  float getMinv(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2)
+  float getMinv(ROOT::Math::PtEtaPhiMVector const& sum)
   {
-    return static_cast<float>((part1 + part2).M());
+    return static_cast<float>(sum.M());
   }
 
   float getKstar(ROOT::Math::PtEtaPhiMVector const& part1, ROOT::Math::PtEtaPhiMVector const& part2)
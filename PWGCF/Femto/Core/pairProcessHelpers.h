@@ -376,6 +376,103 @@ void processMixedEvent(T1 const& Collisions,
   }
 }
 
+// mixed event in data, with the particles 2 of the previous collisions kept in a mixing pool across data frames
+// each collision is mixed with the most recent collisions of its mixing bin and then added to the pool
+template <modes::Mode mode,
+          typename T1,
+          typename T2,
+          typename T3,
+          typename T4,
+          typename T5,
+          typename T6,
+          typename T7,
+          typename T8,
+          typename T9,
+          typename T10>
+void processMixedEventWithPool(T1 const& Collisions,
+                               T2& Partition1,
+                               T3& Partition2,
+                               T4 const& TrackTable,
+                               T5& cache,
+                               T6 const& getMixingBin,
+                               T7& Pool,
+                               T8& PairHistManager,
+                               T9& CprManager,
+                               T10& PcManager)
+{
+  for (auto const& collision : Collisions) {
+    const int bin = getMixingBin(collision);
+    if (bin < 0) {
+      continue;
+    }
+
+    auto sliceParticle1 = Partition1->sliceByCached(o2::aod::femtobase::stored::fColId, collision.globalIndex(), cache);
+    auto sliceParticle2 = Partition2->sliceByCached(o2::aod::femtobase::stored::fColId, collision.globalIndex(), cache);
+
+    int windowSizeRaw = 0;
+    int windowSizeEffective = 0;
+
+    for (auto const& pooledCollision : Pool.getEvents(bin)) {
+      ++windowSizeRaw;
+
+      if (collision.magField() != pooledCollision.magField()) {
+        LOG(warn) << "Tried mixing events with different magnetic field.";
+        continue;
+      }
+
+      CprManager.setMagField(collision.magField());
+
+      PairHistManager.resetTrackedParticlesPerEvent();
+
+      auto const& pooledParticles2 = pooledCollision.getParticles();
+      if (sliceParticle1.size() == 0 || pooledParticles2.empty()) {
+        PairHistManager.fillMixingQaMePerEvent();
+        continue;
+      }
+
+      bool hasValidPair = false;
+      PairHistManager.fillMixingQaMe(collision, pooledCollision);
+      for (auto const& p1 : sliceParticle1) {
+        for (auto const& p2 : pooledParticles2) {
+
+          if (!PcManager.isCleanPair(p1, p2, TrackTable)) {
+            continue;
+          }
+
+          CprManager.setPair(p1, p2, TrackTable);
+          if (CprManager.isClosePair()) {
+            continue;
+          }
+
+          PairHistManager.setPair(p1, p2, TrackTable, collision, pooledCollision);
+          CprManager.fill(PairHistManager.getKstar());
+
+          if (PairHistManager.checkPairCuts()) {
+            hasValidPair = true;
+            PairHistManager.trackParticlesPerEvent(p1, p2);
+            PairHistManager.template fill<mode>();
+          }
+        }
+      }
+
+      if (hasValidPair) {
+        ++windowSizeEffective;
+      }
+
+      PairHistManager.fillMixingQaMePerEvent();
+    }
+
+    if (windowSizeRaw > 0) {
+      PairHistManager.fillMixingQaMePerMixingBin(windowSizeRaw, windowSizeEffective);
+    }
+
+    // only collisions with particles 2 are useful as mixing partners
+    if (sliceParticle2.size() != 0) {
+      Pool.push(bin, collision, sliceParticle2);
+    }
+  }
+}
+
 // process mixed event in mc
 template <modes::Mode mode,
           typename T1,
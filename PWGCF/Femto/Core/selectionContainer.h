@@ -259,9 +259,22 @@ class SelectionContainer
 
     // switch on limit type once outside the loop;
     // thresholds are sorted from most permissive to most restrictive,
-    // so we can break early as soon as one comparison fails
+    // so we can break early as soon as one comparison fails.
+    // static thresholds are sorted in init, so the passed ones are found with a binary search and set at once;
+    // function thresholds are only ordered at the midpoint of their domain and are scanned in order
     switch (mLimitType) {
       case (limits::kUpperLimit):
+        setLadder(value, [](T v, T threshold) { return v <= threshold; });
+        break;
+      case (limits::kAbsUpperLimit):
+        setLadder(std::abs(value), [](T v, T threshold) { return v <= threshold; });
+        break;
+      case (limits::kLowerLimit):
+        setLadder(value, [](T v, T threshold) { return v >= threshold; });
+        break;
+      case (limits::kAbsLowerLimit):
+        setLadder(std::abs(value), [](T v, T threshold) { return v >= threshold; });
+        break;
       case (limits::kUpperFunctionLimit):
         for (std::size_t i = 0; i < mSelectionValues.size(); i++) {
           if (value <= mSelectionValues.at(i)) {
@@ -271,7 +284,6 @@ class SelectionContainer
           }
         }
         break;
-      case (limits::kAbsUpperLimit):
       case (limits::kAbsUpperFunctionLimit):
         for (std::size_t i = 0; i < mSelectionValues.size(); i++) {
           if (std::abs(value) <= mSelectionValues.at(i)) {
@@ -281,7 +293,6 @@ class SelectionContainer
           }
         }
         break;
-      case (limits::kLowerLimit):
       case (limits::kLowerFunctionLimit):
         for (std::size_t i = 0; i < mSelectionValues.size(); i++) {
           if (value >= mSelectionValues.at(i)) {
@@ -291,7 +302,6 @@ class SelectionContainer
           }
         }
         break;
-      case (limits::kAbsLowerLimit):
       case (limits::kAbsLowerFunctionLimit):
         for (std::size_t i = 0; i < mSelectionValues.size(); i++) {
           if (std::abs(value) >= mSelectionValues.at(i)) {
@@ -535,6 +545,17 @@ class SelectionContainer
   bool skipMostPermissiveBit() const { return mSkipMostPermissiveBit; }
 
  private:
+  /// \brief Set the bits of the static thresholds passed by a value, i.e. of the leading thresholds for which the comparison holds.
+  /// \param value Value of the observable to evaluate.
+  /// \param passes Comparison of the value with a threshold, monotonic along the sorted thresholds.
+  template <typename Comparison>
+  void setLadder(T value, Comparison passes)
+  {
+    auto const nPassed = static_cast<std::size_t>(std::partition_point(mSelectionValues.begin(), mSelectionValues.end(), [&](T threshold) { return passes(value, threshold); }) - mSelectionValues.begin());
+    constexpr std::size_t NBits = sizeof(BitmaskType) * CHAR_BIT;
+    mBitmask = std::bitset<NBits>(nPassed >= NBits ? ~0ULL : (1ULL << nPassed) - 1);
+  }
+
   /// \brief Sort static threshold values from most permissive to most restrictive based on the limit type.
   void sortSelections()
   {
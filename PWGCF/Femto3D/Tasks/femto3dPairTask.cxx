@@ -143,6 +143,8 @@ struct FemtoCorrelations {
 
   std::unique_ptr<o2::aod::singletrackselector::FemtoPair<trkType>> Pair = std::make_unique<o2::aod::singletrackselector::FemtoPair<trkType>>();
 
+  std::mt19937 mt{static_cast<std::mt19937::result_type>(std::chrono::steady_clock::now().time_since_epoch().count())}; // seeded once, for the random pair order and the ME reduction
+
   Filter pFilter = o2::aod::singletrackselector::p > _min_P&& o2::aod::singletrackselector::p < _max_P;
   Filter etaFilter = nabs(o2::aod::singletrackselector::eta) < _eta;
 
@@ -339,7 +341,6 @@ struct FemtoCorrelations {
         SEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar()); // close pair rejection and fillig the SE histo
 
         if (_fill3dCF) {
-          std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
           TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
           SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
         }
@@ -396,19 +397,18 @@ struct FemtoCorrelations {
           mThistos[multBin][kTbin]->Fill(Pair->GetMt()); // test
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
             TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
             SEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
           }
         } else {
-          MEhistos_1D[multBin][kTbin]->Fill(Pair->GetKstar());
+          const float kstar = Pair->GetKstar();
+          MEhistos_1D[multBin][kTbin]->Fill(kstar);
 
           if (_fill3dCF) {
-            std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
             TVector3 qLCMS = std::pow(-1, (mt() % 2)) * Pair->GetQLCMS(); // introducing randomness to the pair order ([first, second]); important only for 3D because if there are any sudden order/correlation in the tables, it could couse unwanted asymmetries in the final 3d rel. momentum distributions; irrelevant in 1D case because the absolute value of the rel.momentum is taken
             MEhistos_3D[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z());
             if (_fill3dAddHistos == 1)
-              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetKstar());
+              Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), kstar);
             else if (_fill3dAddHistos == 2)
               Add3dHistos[multBin][kTbin]->Fill(qLCMS.X(), qLCMS.Y(), qLCMS.Z(), Pair->GetGammaOut());
           }
@@ -527,7 +527,6 @@ struct FemtoCorrelations {
 
           for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
               if ((mt() % (_MEreductionFactor.value + 1)) < _MEreductionFactor.value)
                 continue;
             }
@@ -559,7 +558,6 @@ struct FemtoCorrelations {
 
           for (unsigned int indx2 = indx1 + 1; indx2 < EvPerBin; indx2++) { // nested loop for all the combinations of collisions in a chosen mult/vertex bin
             if (_MEreductionFactor.value > 1) {
-              std::mt19937 mt(std::chrono::steady_clock::now().time_since_epoch().count());
               if (mt() % (_MEreductionFactor.value + 1) < _MEreductionFactor.value)
                 continue;
             }
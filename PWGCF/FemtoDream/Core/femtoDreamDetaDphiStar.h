@@ -16,6 +16,7 @@
 #ifndef PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 #define PWGCF_FEMTODREAM_CORE_FEMTODREAMDETADPHISTAR_H_
 
+#include "PWGCF/Core/PhiStarCache.h"
 #include "PWGCF/DataModel/FemtoDerived.h"
 
 #include <Framework/HistogramRegistry.h>
@@ -26,6 +27,7 @@
 #include <THnSparse.h>
 #include <TVector2.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -796,14 +798,12 @@ class FemtoDreamDetaDphiStar
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_eta{};
   std::array<std::shared_ptr<THnSparse>, 3> histdetadpi_phi{};
 
-  ///  Calculate phi at all required radii stored in tmpRadiiTPC
-  /// Magnetic field to be provided in Tesla
+  PhiStarCache<9> phiStarCache; ///< phi* of the particles at the radii stored in tmpRadiiTPC
+
+  ///  Get the charge from cutcontainer using masks
   template <typename T>
-  int PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  int ChargeFromCut(const T& part)
   {
-
-    float phi0 = part.phi();
-    // Start: Get the charge from cutcontainer using masks
     int charge = 0.;
     if ((part.cut() & kSignMinusMask) == kValue0 && (part.cut() & kSignPlusMask) == kValue0) {
       charge = 0;
@@ -814,7 +814,32 @@ class FemtoDreamDetaDphiStar
     } else {
       LOG(fatal) << "FemtoDreamDetaDphiStar: Charge bits are set wrong!";
     }
-    // End: Get the charge from cutcontainer using masks
+    return charge;
+  }
+
+  ///  Get phi at all required radii stored in tmpRadiiTPC, computed once per particle
+  template <typename T>
+  int CachedPhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  {
+    const int charge = ChargeFromCut(part);
+    const auto entry = phiStarCache.get(part.globalIndex(), magfield, charge * part.pt(), part.phi(), [&](std::array<float, 9>& values) {
+      std::vector<float> computed;
+      PhiAtRadiiTPC(part, computed);
+      std::copy(computed.begin(), computed.end(), values.begin());
+      return (1u << 9) - 1;
+    });
+    tmpVec.assign(entry.phiStar.begin(), entry.phiStar.end());
+    return charge;
+  }
+
+  ///  Calculate phi at all required radii stored in tmpRadiiTPC
+  /// Magnetic field to be provided in Tesla
+  template <typename T>
+  int PhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  {
+
+    float phi0 = part.phi();
+    int charge = ChargeFromCut(part);
     float pt = part.pt();
     for (size_t i = 0; i < 9; i++) {
       if (runOldVersion) {
@@ -940,9 +965,9 @@ class FemtoDreamDetaDphiStar
   {
     std::vector<float> tmpVec1;
     std::vector<float> tmpVec2;
-    auto charge1 = PhiAtRadiiTPC(part1, tmpVec1);
+    auto charge1 = CachedPhiAtRadiiTPC(part1, tmpVec1);
     if constexpr (!isHF) {
-      auto charge2 = PhiAtRadiiTPC(part2, tmpVec2);
+      auto charge2 = CachedPhiAtRadiiTPC(part2, tmpVec2);
       if (charge1 == charge2) {
         *sameCharge = true;
       }
@@ -19,6 +19,7 @@
 #ifndef PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSEDETADPHISTAR_H_
 #define PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSEDETADPHISTAR_H_
 
+#include "PWGCF/Core/PhiStarCache.h"
 #include "PWGCF/FemtoUniverse/Core/FemtoUniverseContainer.h"
 #include "PWGCF/FemtoUniverse/Core/FemtoUniverseTrackSelection.h"
 #include "PWGCF/FemtoUniverse/DataModel/FemtoDerived.h"
@@ -35,6 +36,7 @@
 #include <TMathBase.h>
 #include <TVector2.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstddef>
@@ -925,14 +927,12 @@ class FemtoUniverseDetaDphiStar
   std::shared_ptr<TH3> histdetadpiqlcmssame{};
   std::shared_ptr<TH3> histdetadpiqlcmsmixed{};
 
-  ///  Calculate phi at all required radii stored in TmpRadiiTPC
-  /// Magnetic field to be provided in Tesla
+  PhiStarCache<9> phiStarCache; ///< phi* of the particles at the radii stored in TmpRadiiTPC
+
+  ///  Get the charge from cutcontainer using masks
   template <typename T>
-  void phiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  float chargeFromCut(const T& part)
   {
-
-    float phi0 = part.phi();
-    // Start: Get the charge from cutcontainer using masks
     float charge = 0.;
     if ((part.cut() & kSignMinusMask) == kValue0 && (part.cut() & kSignPlusMask) == kValue0) {
       charge = 0;
@@ -943,7 +943,30 @@ class FemtoUniverseDetaDphiStar
     } else {
       LOG(fatal) << "FemtoUniverseDetaDphiStar: Charge bits are set wrong!";
     }
-    // End: Get the charge from cutcontainer using masks
+    return charge;
+  }
+
+  ///  Get phi at all required radii stored in TmpRadiiTPC, computed once per particle
+  template <typename T>
+  void cachedPhiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  {
+    const auto entry = phiStarCache.get(part.globalIndex(), magfield, chargeFromCut(part) * part.pt(), part.phi(), [&](std::array<float, 9>& values) {
+      std::vector<float> computed;
+      phiAtRadiiTPC(part, computed);
+      std::copy(computed.begin(), computed.end(), values.begin());
+      return (1u << 9) - 1;
+    });
+    tmpVec.assign(entry.phiStar.begin(), entry.phiStar.end());
+  }
+
+  ///  Calculate phi at all required radii stored in TmpRadiiTPC
+  /// Magnetic field to be provided in Tesla
+  template <typename T>
+  void phiAtRadiiTPC(const T& part, std::vector<float>& tmpVec)
+  {
+
+    float phi0 = part.phi();
+    float charge = chargeFromCut(part);
     float pt = part.pt();
     for (size_t i = 0; i < 9; i++) {
       double arg = 0.3 * charge * magfield * TmpRadiiTPC[i] * 0.01 / (2. * pt);
@@ -961,8 +984,8 @@ class FemtoUniverseDetaDphiStar
   {
     std::vector<float> tmpVec1;
     std::vector<float> tmpVec2;
-    phiAtRadiiTPC(part1, tmpVec1);
-    phiAtRadiiTPC(part2, tmpVec2);
+    cachedPhiAtRadiiTPC(part1, tmpVec1);
+    cachedPhiAtRadiiTPC(part2, tmpVec2);
     int num = tmpVec1.size();
     float dPhiAvg = 0;
     float dphi = 0;
@@ -989,8 +1012,8 @@ class FemtoUniverseDetaDphiStar
   {
     std::vector<float> tmpVec1;
     std::vector<float> tmpVec2;
-    phiAtRadiiTPC(part1, tmpVec1);
-    phiAtRadiiTPC(part2, tmpVec2);
+    cachedPhiAtRadiiTPC(part1, tmpVec1);
+    cachedPhiAtRadiiTPC(part2, tmpVec2);
     int num = tmpVec1.size();
     float dphi = 0;
     int entries = 0;
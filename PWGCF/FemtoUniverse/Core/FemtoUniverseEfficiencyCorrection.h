@@ -50,6 +50,14 @@ enum ParticleNo : size_t {
   TWO,
 };
 
+enum class EffCorVariables {
+  Pt,
+  PtEta,
+  PtMult,
+  PtEtaMult,
+  Unknown,
+};
+
 template <size_t T>
 concept IsOneOrTwo = T == ParticleNo::ONE || T == ParticleNo::TWO;
 
@@ -97,6 +105,10 @@ class EfficiencyCorrection
 
     shouldApplyCorrection = config->confEffCorApply;
 
+    // the variables of the histograms are parsed once, not at each weight lookup
+    variables = getVariables(config->confEffCorVariables.value);
+    nDimensions = getDimensionFromVariables();
+
     if (shouldApplyCorrection && !config->confEffCorCCDBTimestamps.value.empty()) {
       for (auto idx = 0UL; idx < config->confEffCorCCDBTimestamps.value.size(); idx++) {
         auto timestamp = 0L;
@@ -108,7 +120,7 @@ class EfficiencyCorrection
         }
 
         if (timestamp > 0) {
-          switch (getDimensionFromVariables()) {
+          switch (nDimensions) {
             case 1:
               hLoaded[idx] = loadHistFromCCDB<TH1>(timestamp);
               break;
@@ -205,23 +217,28 @@ class EfficiencyCorrection
 
     if (shouldApplyCorrection && hWeights) {
       auto dim = static_cast<size_t>(hWeights->GetDimension());
-      if (dim != getDimensionFromVariables()) {
+      if (dim != nDimensions) {
         LOGF(fatal, notify("Histogram \"%s\" has wrong dimension %d != %d"), config->confEffCorCCDBPath.value, dim, config->confEffCorVariables.value.size());
         return weight;
       }
 
       auto bin = -1;
-      if (config->confEffCorVariables.value == "pt") {
-        bin = hWeights->FindBin(particle.pt());
-      } else if (config->confEffCorVariables.value == "pt,eta") {
-        bin = hWeights->FindBin(particle.pt(), particle.eta());
-      } else if (config->confEffCorVariables.value == "pt,mult") {
-        bin = hWeights->FindBin(particle.pt(), particle.template fdCollision_as<CollisionType>().multV0M());
-      } else if (config->confEffCorVariables.value == "pt,eta,mult") {
-        bin = hWeights->FindBin(particle.pt(), particle.eta(), particle.template fdCollision_as<CollisionType>().multV0M());
-      } else {
-        LOGF(fatal, notify("Unknown configuration for efficiency variables"));
-        return weight;
+      switch (variables) {
+        case EffCorVariables::Pt:
+          bin = hWeights->FindBin(particle.pt());
+          break;
+        case EffCorVariables::PtEta:
+          bin = hWeights->FindBin(particle.pt(), particle.eta());
+          break;
+        case EffCorVariables::PtMult:
+          bin = hWeights->FindBin(particle.pt(), particle.template fdCollision_as<CollisionType>().multV0M());
+          break;
+        case EffCorVariables::PtEtaMult:
+          bin = hWeights->FindBin(particle.pt(), particle.eta(), particle.template fdCollision_as<CollisionType>().multV0M());
+          break;
+        default:
+          LOGF(fatal, notify("Unknown configuration for efficiency variables"));
+          return weight;
       }
 
       weight = hWeights->GetBinContent(bin);
@@ -279,6 +296,20 @@ class EfficiencyCorrection
     return clonedHist;
   }
 
+  static auto getVariables(const std::string& name) -> EffCorVariables
+  {
+    if (name == "pt") {
+      return EffCorVariables::Pt;
+    } else if (name == "pt,eta") {
+      return EffCorVariables::PtEta;
+    } else if (name == "pt,mult") {
+      return EffCorVariables::PtMult;
+    } else if (name == "pt,eta,mult") {
+      return EffCorVariables::PtEtaMult;
+    }
+    return EffCorVariables::Unknown;
+  }
+
   auto getDimensionFromVariables() -> size_t
   {
     auto parts = std::views::split(config->confEffCorVariables.value, ',');
@@ -291,6 +322,9 @@ class EfficiencyCorrection
   bool shouldFillHistograms{false};
   bool shouldSetMultToConst{false};
 
+  EffCorVariables variables{EffCorVariables::Unknown};
+  size_t nDimensions{0};
+
   o2::ccdb::BasicCCDBManager& ccdb{o2::ccdb::BasicCCDBManager::instance()};
   std::array<TH1*, 2> hLoaded{nullptr, nullptr};
 
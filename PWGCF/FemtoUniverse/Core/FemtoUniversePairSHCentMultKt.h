@@ -17,6 +17,7 @@
 #define PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSEPAIRSHCENTMULTKT_H_
 
 #include "PWGCF/FemtoUniverse/Core/FemtoUniverseMath.h"
+#include "PWGCF/FemtoUniverse/Core/FemtoUniverseSHAccumulator.h"
 #include "PWGCF/FemtoUniverse/Core/FemtoUniverseSHContainer.h"
 #include "PWGCF/FemtoUniverse/Core/FemtoUniverseSpherHarMath.h"
 
@@ -164,6 +165,23 @@ class PairSHCentMultKt
                                                               {(kMaxJM * 2), -0.5,
                                                                ((static_cast<float>(kMaxJM) * 2.0 - 0.5))}});
         }
+
+        std::vector<TH1*> components;
+        for (int ihist = 0; ihist < kMaxJM; ihist++) {
+          if (FolderSuffix[EventType] == FolderSuffix[0]) {
+            components.push_back(fnumsreal[i][j][ihist].get());
+            components.push_back(fnumsimag[i][j][ihist].get());
+          } else {
+            components.push_back(fdensreal[i][j][ihist].get());
+            components.push_back(fdensimag[i][j][ihist].get());
+          }
+        }
+        if (FolderSuffix[EventType] == FolderSuffix[0]) {
+          fAccumulators[i][j].init(components, fcovnum[i][j].get());
+        } else {
+          fAccumulators[i][j].init(components, fcovden[i][j].get());
+        }
+
         if (isqinvfill) {
           if (FolderSuffix[EventType] == FolderSuffix[0]) {
             std::string bufnameNum = "h1DNum";
@@ -276,7 +294,7 @@ class PairSHCentMultKt
   {
     int fMultBin = multval;
     int fKtBin = ktval;
-    std::vector<std::complex<double>> fYlmBuffer(kMaxJM);
+    std::array<std::complex<double>, kMaxJM> fYlmBuffer;
     std::vector<double> f3d;
     setPionPairMass();
 
@@ -304,52 +322,36 @@ class PairSHCentMultKt
     // int nqbin = fbinctn[0][0]->GetXaxis()->FindFixBin(kv);
     // int nqbinnotfix = fbinctn[0][0]->GetXaxis()->FindBin(kv);
 
-    FemtoUniverseSpherHarMath kYlm;
-    kYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
+    fYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
+
+    // real part and minus the imaginary part of each Ylm, in the order of the covariance matrix
+    std::array<double, kMaxJM * 2> fComponents;
+    for (int ilm = 0; ilm < kMaxJM; ilm++) {
+      fComponents[ilm * 2] = real(fYlmBuffer[ilm]);
+      fComponents[ilm * 2 + 1] = -imag(fYlmBuffer[ilm]);
+    }
+    fAccumulators[fMultBin][fKtBin].addPair(kv, fComponents.data());
 
     if (ChosenEventType == femto_universe_sh_container::EventType::same) {
-      for (int ihist = 0; ihist < kMaxJM; ihist++) {
-        fnumsreal[fMultBin][fKtBin][ihist]->Fill(kv, real(fYlmBuffer[ihist]));
-        fnumsimag[fMultBin][fKtBin][ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
-        fbinctn[fMultBin][fKtBin]->Fill(kv, 1.0);
-      }
+      fbinctn[fMultBin][fKtBin]->Fill(kv, static_cast<double>(kMaxJM));
       if (isqinvfill) {
         fnums1D[fMultBin][fKtBin]->Fill(f3d[0]);
       }
-      for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
-        for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
-          if ((ilmzero % 2) == 0 && (ilmprim % 2) == 0) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 0 && (ilmprim % 2) == 1) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 0) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 1) {
-            fcovnum[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          }
-        }
-      }
     } else if (ChosenEventType == femto_universe_sh_container::EventType::mixed) {
-      for (int ihist = 0; ihist < kMaxJM; ihist++) {
-        fdensreal[fMultBin][fKtBin][ihist]->Fill(kv, real(fYlmBuffer[ihist]));
-        fdensimag[fMultBin][fKtBin][ihist]->Fill(kv, -imag(fYlmBuffer[ihist]));
-        fbinctd[fMultBin][fKtBin]->Fill(kv, 1.0);
-      }
+      fbinctd[fMultBin][fKtBin]->Fill(kv, static_cast<double>(kMaxJM));
       if (isqinvfill) {
         fdens1D[fMultBin][fKtBin]->Fill(f3d[0]);
       }
-      for (int ilmzero = 0; ilmzero < kMaxJM * 2; ilmzero++) {
-        for (int ilmprim = 0; ilmprim < kMaxJM * 2; ilmprim++) {
-          if ((ilmzero % 2) == 0 && (ilmprim % 2) == 0) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 0 && (ilmprim % 2) == 1) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (real(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 0) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * real(fYlmBuffer[ilmprim / 2])));
-          } else if ((ilmzero % 2) == 1 && (ilmprim % 2) == 1) {
-            fcovden[fMultBin][fKtBin]->Fill(kv, ilmzero, ilmprim, (-imag(fYlmBuffer[ilmzero / 2]) * -imag(fYlmBuffer[ilmprim / 2])));
-          }
-        }
+    }
+  }
+
+  /// Function to set the entries and the statistics of the spherical harmonic histograms, including all the pairs
+  /// added so far. To be called once the pairs of a data frame are processed
+  void flush()
+  {
+    for (auto& accumulatorsMult : fAccumulators) {
+      for (auto& accumulator : accumulatorsMult) {
+        accumulator.flush();
       }
     }
   }
@@ -421,6 +423,9 @@ class PairSHCentMultKt
   std::array<std::array<std::shared_ptr<TH3>, 7>, 4> fcovnum{};
   std::array<std::array<std::shared_ptr<TH3>, 7>, 4> fcovden{};
 
+  std::array<std::array<FemtoUniverseSHAccumulator, 7>, 4> fAccumulators{}; ///< Accumulators of the spherical harmonic histograms
+  FemtoUniverseSpherHarMath fYlm;                                           ///< Calculator of the spherical harmonics
+
  protected:
   framework::HistogramRegistry* pairSHCentMultKtRegistry = nullptr;
   static constexpr std::string_view FolderSuffix[2] = {"SameEvent", "MixedEvent"}; ///< Folder naming for the output according to EventType
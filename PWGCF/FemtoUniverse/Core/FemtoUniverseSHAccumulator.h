@@ -0,0 +1,206 @@
+// Copyright 2019-2025 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file FemtoUniverseSHAccumulator.h
+/// \brief FemtoUniverseSHAccumulator - Accumulates the spherical harmonic components of the pairs and their covariance
+
+#ifndef PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSESHACCUMULATOR_H_
+#define PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSESHACCUMULATOR_H_
+
+#include <Framework/Logger.h>
+
+#include <TArrayD.h>
+#include <TAxis.h>
+#include <TH1.h>
+#include <TH3.h>
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace o2::analysis::femto_universe
+{
+
+/// \class FemtoUniverseSHAccumulator
+/// \brief Accumulator of the spherical harmonic components of the pairs, and of their covariance, for one
+/// multiplicity and kT bin. The k* bin of a pair is looked up once and the components are added directly to the bin
+/// contents (and squared weights) of the histograms; the covariance is updated as the outer product of the component
+/// vector with itself. The entries and the statistics (mean, RMS) of the histograms only depend on a few sums of the
+/// components, which are accumulated over the pairs and set in the histograms by flush(). The histograms have the
+/// same contents, errors and statistics as if they were filled pair by pair, as long as they are only filled here.
+class FemtoUniverseSHAccumulator
+{
+ public:
+  /// Binds the accumulator to the histograms of one multiplicity and kT bin
+  /// \param components histograms of the components, in the order of the covariance matrix (real part and minus the imaginary part of each Ylm)
+  /// \param cov covariance histogram, with k* on x and the index of the components on y and z
+  void init(std::vector<TH1*> const& components, TH3* cov)
+  {
+    mComponents.clear();
+    for (auto* hist : components) {
+      auto* histD = dynamic_cast<TH1D*>(hist);
+      if (!histD) {
+        LOG(fatal) << "FemtoUniverseSHAccumulator: the component histograms must be TH1D";
+      }
+      mComponents.push_back(histD);
+    }
+    mCov = dynamic_cast<TH3D*>(cov);
+    if (!mCov) {
+      LOG(fatal) << "FemtoUniverseSHAccumulator: the covariance histogram must be a TH3D";
+    }
+
+    const std::size_t nComponents = mComponents.size();
+    mCovBinY.resize(nComponents);
+    mCovBinZ.resize(nComponents);
+    for (std::size_t i = 0; i < nComponents; i++) {
+      mCovBinY[i] = mCov->GetYaxis()->FindBin(static_cast<double>(i));
+      mCovBinZ[i] = mCov->GetZaxis()->FindBin(static_cast<double>(i));
+      if (mCovBinY[i] < 1 || mCovBinY[i] > mCov->GetNbinsY() || mCovBinZ[i] < 1 || mCovBinZ[i] > mCov->GetNbinsZ()) {
+        LOG(fatal) << "FemtoUniverseSHAccumulator: the covariance histogram does not cover all the components";
+      }
+    }
+    mStrideY = mCov->GetNbinsX() + 2;
+    mStrideZ = mStrideY * (mCov->GetNbinsY() + 2);
+
+    mComponentStats.assign(nComponents, {});
+    mComponentEntries = 0.;
+    mCovStats = {};
+    mCovEntries = 0.;
+    mIsPending = false;
+  }
+
+  /// Adds a pair, same as filling each component histogram i with (kv, values[i]) and the covariance histogram with
+  /// (kv, i, j, values[i] * values[j]) for all i and j
+  /// \param kv k* of the pair
+  /// \param values components of the pair
+  void addPair(double kv, const double* values)
+  {
+    if (!mCov) {
+      return;
+    }
+    const std::size_t nComponents = mComponents.size();
+
+    // components
+    const int bin = mComponents[0]->GetXaxis()->FindBin(kv);
+    const bool isInRange = (bin >= 1 && bin <= mComponents[0]->GetNbinsX()) || TH1::StatOverflows();
+    for (std::size_t i = 0; i < nComponents; i++) {
+      TH1D* hist = mComponents[i];
+      const double w = values[i];
+      addToBin(hist, bin, w);
+      if (isInRange) {
+        auto& stats = mComponentStats[i];
+        stats[0] += w;
+        stats[1] += w * w;
+        stats[2] += w * kv;
+        stats[3] += w * kv * kv;
+      }
+    }
+    mComponentEntries += 1.;
+
+    // covariance, rank one update
+    const int binX = mCov->GetXaxis()->FindBin(kv);
+    if (!mCov->GetSumw2N() && !mCov->TestBit(TH1::kIsNotW)) {
+      for (std::size_t i = 0; i < nComponents && !mCov->GetSumw2N(); i++) {
+        for (std::size_t j = 0; j < nComponents; j++) {
+          if (values[i] * values[j] != 1.) {
+            mCov->Sumw2();
+            break;
+          }
+        }
+      }
+    }
+    Double_t* content = mCov->GetArray();
+    Double_t* sumw2 = mCov->GetSumw2N() ? mCov->GetSumw2()->GetArray() : nullptr;
+    for (std::size_t i = 0; i < nComponents; i++) {
+      const int binXY = binX + mStrideY * mCovBinY[i];
+      for (std::size_t j = 0; j < nComponents; j++) {
+        const int globalBin = binXY + mStrideZ * mCovBinZ[j];
+        const double w = values[i] * values[j];
+        content[globalBin] += w;
+        if (sumw2) {
+          sumw2[globalBin] += w * w;
+        }
+      }
+    }
+    mCovEntries += static_cast<double>(nComponents * nComponents);
+    if ((binX >= 1 && binX <= mCov->GetNbinsX()) || TH1::StatOverflows()) {
+      // the sums over the matrix factorise into sums over the components
+      double sum = 0.;
+      double sum2 = 0.;
+      double sumIndex = 0.;
+      double sumIndex2 = 0.;
+      for (std::size_t i = 0; i < nComponents; i++) {
+        sum += values[i];
+        sum2 += values[i] * values[i];
+        sumIndex += i * values[i];
+        sumIndex2 += i * i * values[i];
+      }
+      mCovStats[0] += sum * sum;            // sum w
+      mCovStats[1] += sum2 * sum2;          // sum w^2
+      mCovStats[2] += kv * sum * sum;       // sum w x
+      mCovStats[3] += kv * kv * sum * sum;  // sum w x^2
+      mCovStats[4] += sumIndex * sum;       // sum w y
+      mCovStats[5] += sumIndex2 * sum;      // sum w y^2
+      mCovStats[6] += kv * sumIndex * sum;  // sum w x y
+      mCovStats[7] += sum * sumIndex;       // sum w z
+      mCovStats[8] += sum * sumIndex2;      // sum w z^2
+      mCovStats[9] += kv * sum * sumIndex;  // sum w x z
+      mCovStats[10] += sumIndex * sumIndex; // sum w y z
+    }
+    mIsPending = true;
+  }
+
+  /// Sets the entries and the statistics of the histograms, including all the pairs added so far
+  void flush()
+  {
+    if (!mIsPending) {
+      return;
+    }
+    for (std::size_t i = 0; i < mComponents.size(); i++) {
+      std::array<Double_t, 4> stats = mComponentStats[i];
+      mComponents[i]->PutStats(stats.data());
+      mComponents[i]->SetEntries(mComponentEntries);
+    }
+    std::array<Double_t, 11> covStats = mCovStats;
+    mCov->PutStats(covStats.data());
+    mCov->SetEntries(mCovEntries);
+    mIsPending = false;
+  }
+
+ private:
+  /// Adds a weight to a bin, creating the squared weights at the first weight different from 1 as TH1::Fill
+  static void addToBin(TH1D* hist, int bin, double w)
+  {
+    if (!hist->GetSumw2N() && w != 1. && !hist->TestBit(TH1::kIsNotW)) {
+      hist->Sumw2();
+    }
+    hist->GetArray()[bin] += w;
+    if (hist->GetSumw2N()) {
+      hist->GetSumw2()->GetArray()[bin] += w * w;
+    }
+  }
+
+  std::vector<TH1D*> mComponents;                     ///< Histograms of the components
+  TH3D* mCov = nullptr;                               ///< Histogram of the covariance
+  std::vector<int> mCovBinY;                          ///< Bin on y of each component in the covariance histogram
+  std::vector<int> mCovBinZ;                          ///< Bin on z of each component in the covariance histogram
+  int mStrideY = 0;                                   ///< Stride of the y bins in the covariance histogram
+  int mStrideZ = 0;                                   ///< Stride of the z bins in the covariance histogram
+  std::vector<std::array<double, 4>> mComponentStats; ///< Statistics of each component histogram (sum w, w^2, w x, w x^2)
+  double mComponentEntries = 0.;                      ///< Entries of the component histograms
+  std::array<double, 11> mCovStats{};                 ///< Statistics of the covariance histogram, as in TH3::GetStats
+  double mCovEntries = 0.;                            ///< Entries of the covariance histogram
+  bool mIsPending = false;                            ///< Pairs added since the last flush
+};
+
+} // namespace o2::analysis::femto_universe
+
+#endif // PWGCF_FEMTOUNIVERSE_CORE_FEMTOUNIVERSESHACCUMULATOR_H_
@@ -166,7 +166,7 @@ class FemtoUniverseSHContainer
   template <bool isMC, typename T>
   void addEventPair(T const& part1, T const& part2, uint8_t ChosenEventType, int /*maxl*/, bool isiden)
   {
-    std::vector<std::complex<double>> fYlmBuffer(kMaxJM);
+    std::array<std::complex<double>, kMaxJM> fYlmBuffer;
     std::vector<double> f3d;
     f3d = FemtoUniverseMath::newpairfunc(part1, kMassOne, part2, kMassTwo, isiden);
 
@@ -177,8 +177,7 @@ class FemtoUniverseSHContainer
 
     int nqbin = fbinctn->GetXaxis()->FindFixBin(kv) - 1;
 
-    FemtoUniverseSpherHarMath kYlm;
-    kYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
+    fYlm.doYlmUpToL(kMaxL, qout, qside, qlong, fYlmBuffer.data());
 
     if (ChosenEventType == femto_universe_sh_container::EventType::same) {
       for (int ihist = 0; ihist < kMaxJM; ihist++) {
@@ -261,6 +260,8 @@ class FemtoUniverseSHContainer
   std::array<float, (kMaxJM * kMaxJM * 4 * 100)> fcovmnum{}; ///< Covariance matrix for the numerator
   std::array<float, (kMaxJM * kMaxJM * 4 * 100)> fcovmden{}; ///< Covariance matrix for the numerator
 
+  FemtoUniverseSpherHarMath fYlm; ///< Calculator of the spherical harmonics
+
  protected:
   framework::HistogramRegistry* kHistogramRegistry = nullptr;                       ///< For QA output
   static constexpr std::string_view kFolderSuffix[2] = {"SameEvent", "MixedEvent"}; ///< Folder naming for the output according to kEventType
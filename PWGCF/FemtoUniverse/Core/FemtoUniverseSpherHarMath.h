@@ -30,6 +30,8 @@ namespace o2::analysis::femto_universe
 class FemtoUniverseSpherHarMath
 {
  public:
+  FemtoUniverseSpherHarMath() { initializeYlms(); }
+
   /// Values of various coefficients
   void initializeYlms()
   {
@@ -164,19 +166,35 @@ class FemtoUniverseSpherHarMath
   /// Function to calculate a set of Ylms up to a given l with cartesian input
   void doYlmUpToL(int lmax, double x, double y, double z, std::complex<double>* ylms)
   {
-    double ctheta, phi;
+    double ctheta;
 
     double r = std::sqrt(x * x + y * y + z * z);
     if (r < 1e-10 || std::fabs(z) < 1e-10)
       ctheta = 0.0;
     else
       ctheta = z / r;
-    phi = std::atan2(y, x);
-    doYlmUpToL(lmax, ctheta, phi, ylms);
+
+    // cos(phi) and sin(phi) of phi = atan2(y, x), without evaluating the angle
+    double rxy = std::sqrt(x * x + y * y);
+    double cphi = 1.0;
+    double sphi = 0.0;
+    if (rxy > 0) {
+      cphi = x / rxy;
+      sphi = y / rxy;
+    }
+    ylmUpToL(lmax, ctheta, cphi, sphi, ylms);
   }
 
   /// Function to calculate a set of Ylms up to a given l with spherical input
   void doYlmUpToL(int lmax, double ctheta, double phi, std::complex<double>* ylms)
+  {
+    ylmUpToL(lmax, ctheta, std::cos(phi), std::sin(phi), ylms);
+  }
+
+ private:
+  /// Function to calculate a set of Ylms up to a given l from cos(theta), cos(phi) and sin(phi)
+  /// cos(m phi) and sin(m phi) are obtained by recurrence from cos(phi) and sin(phi)
+  void ylmUpToL(int lmax, double ctheta, double cphi, double sphi, std::complex<double>* ylms)
   {
     int lcur = 0;
     double lpol;
@@ -186,11 +204,14 @@ class FemtoUniverseSpherHarMath
 
     double lbuf[36];
     legendreUpToYlm(lmax, ctheta, lbuf);
-    initializeYlms();
 
-    for (int iter = 1; iter <= lmax; iter++) {
-      coss[iter - 1] = std::cos(iter * phi);
-      sins[iter - 1] = std::sin(iter * phi);
+    if (lmax > 0) {
+      coss[0] = cphi;
+      sins[0] = sphi;
+    }
+    for (int iter = 2; iter <= lmax; iter++) {
+      coss[iter - 1] = coss[iter - 2] * cphi - sins[iter - 2] * sphi;
+      sins[iter - 1] = sins[iter - 2] * cphi + coss[iter - 2] * sphi;
     }
 
     ylms[lcur++] = fgPrefactors[0] * lbuf[0] * std::complex<double>(1, 0);
@@ -208,7 +229,6 @@ class FemtoUniverseSpherHarMath
     }
   }
 
- private:
   static std::complex<double> fCeiphi(double phi);
 
   std::array<float, 36> fgPrefactors;
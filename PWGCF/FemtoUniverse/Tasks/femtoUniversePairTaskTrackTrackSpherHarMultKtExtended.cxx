@@ -567,6 +567,17 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
     eventHisto.fillQA(col);
   }
 
+  /// Sets the entries and the statistics of the spherical harmonic histograms, once the pairs of a data frame are processed
+  void flushSHContainers()
+  {
+    sameEventMultCont.flush();
+    sameEventMultContPP.flush();
+    sameEventMultContMM.flush();
+    mixedEventMultCont.flush();
+    mixedEventMultContPP.flush();
+    mixedEventMultContMM.flush();
+  }
+
   /// This function processes the same event and takes care of all the histogramming
   /// \todo the trivial loops over the tracks should be factored out since they will be common to all combinations of T-T, T-V0, V0-V0, ...
   /// @tparam PartitionType
@@ -832,6 +843,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processSameEvent, "Enable processing same event", true);
 
@@ -872,6 +884,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processSameEventMC, "Enable processing same event for Monte Carlo", false);
 
@@ -1025,6 +1038,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
         doSameEventMCTruth<false>(thegroupPartsTwo, thegroupPartsTwo, col.multNtr(), pairType, fillQA);
       }
     }
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processSameEventMCTruth, "Enable processing same event for MC truth", false);
 
@@ -1217,6 +1231,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventCent, "Enable processing mixed events for centrality", true);
 
@@ -1265,6 +1280,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventNtr, "Enable processing mixed events for centrality", false);
 
@@ -1317,6 +1333,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventMCCent, "Enable processing mixed events MC", false);
 
@@ -1369,6 +1386,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventMCNtr, "Enable processing mixed events MC", false);
 
@@ -1476,6 +1494,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
         doMixedEventMCTruth<false>(groupPartsOne, groupPartsTwo, multiplicityCol, pairType);
       }
     }
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventNtrMCTruth, "Enable processing MC Truth mixed events for multiplicity", false);
 
@@ -1515,6 +1534,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended {
         doMixedEventMCTruth<false>(groupPartsOne, groupPartsTwo, multiplicityCol, pairType);
       }
     }
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtended, processMixedEventCentMCTruth, "Enable processing MC Truth mixed events for multiplicity", false);
 };
@@ -557,6 +557,17 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid {
     eventHisto.fillQA(col);
   }
 
+  /// Sets the entries and the statistics of the spherical harmonic histograms, once the pairs of a data frame are processed
+  void flushSHContainers()
+  {
+    sameEventMultCont.flush();
+    sameEventMultContPP.flush();
+    sameEventMultContMM.flush();
+    mixedEventMultCont.flush();
+    mixedEventMultContPP.flush();
+    mixedEventMultContMM.flush();
+  }
+
   /// This function processes the same event and takes care of all the histogramming
   /// \todo the trivial loops over the tracks should be factored out since they will be common to all combinations of T-T, T-V0, V0-V0, ...
   /// @tparam PartitionType
@@ -809,6 +820,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid, processSameEvent, "Enable processing same event", true);
 
@@ -999,6 +1011,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid, processMixedEventCent, "Enable processing mixed events for centrality", true);
 
@@ -1047,6 +1060,7 @@ struct FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid {
       }
     }
     delete randgen;
+    flushSHContainers();
   }
   PROCESS_SWITCH(FemtoUniversePairTaskTrackTrackSpherHarMultKtExtendedItsPid, processMixedEventNtr, "Enable processing mixed events for centrality", false);
 };
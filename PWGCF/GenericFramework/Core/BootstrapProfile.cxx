@@ -11,6 +11,8 @@
 
 #include "BootstrapProfile.h"
 
+#include <TArrayD.h>
+#include <TBuffer.h>
 #include <TCollection.h>
 #include <TH1.h>
 #include <TList.h>
@@ -20,6 +22,7 @@
 
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <cstdio>
 BootstrapProfile::BootstrapProfile() : TProfile(),
                                        fListOfEntries(0),
@@ -27,7 +30,9 @@ BootstrapProfile::BootstrapProfile() : TProfile(),
                                        fNSubs(0),
                                        fMultiRebin(0),
                                        fMultiRebinEdges(0),
-                                       fPresetWeights(0) {}
+                                       fPresetWeights(0),
+                                       fSubNBins(0),
+                                       fSubsPending(kFALSE) {}
 BootstrapProfile::~BootstrapProfile()
 {
   delete fListOfEntries;
@@ -38,14 +43,18 @@ BootstrapProfile::BootstrapProfile(const char* name, const char* title, Int_t nb
                                                                                                                fNSubs(0),
                                                                                                                fMultiRebin(0),
                                                                                                                fMultiRebinEdges(0),
-                                                                                                               fPresetWeights(0) {}
+                                                                                                               fPresetWeights(0),
+                                       fSubNBins(0),
+                                       fSubsPending(kFALSE) {}
 BootstrapProfile::BootstrapProfile(const char* name, const char* title, Int_t nbinsx, Double_t xlow, Double_t xup) : TProfile(name, title, nbinsx, xlow, xup),
                                                                                                                      fListOfEntries(0),
                                                                                                                      fProfInitialized(kFALSE),
                                                                                                                      fNSubs(0),
                                                                                                                      fMultiRebin(0),
                                                                                                                      fMultiRebinEdges(0),
-                                                                                                                     fPresetWeights(0) {}
+                                                                                                                     fPresetWeights(0),
+                                       fSubNBins(0),
+                                       fSubsPending(kFALSE) {}
 void BootstrapProfile::InitializeSubsamples(Int_t nSub)
 {
   if (nSub < 1) {
@@ -62,6 +71,10 @@ void BootstrapProfile::InitializeSubsamples(Int_t nSub)
     reinterpret_cast<TProfile*>(fListOfEntries->At(i))->Reset();
   }
   fNSubs = nSub;
+  fSubSums.clear();
+  fSubStats.clear();
+  fSubNBins = 0;
+  fSubsPending = kFALSE;
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w, const Double_t& rn)
 {
@@ -71,14 +84,93 @@ void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const
   Int_t targetInd = rn * fNSubs;
   if (targetInd >= fNSubs)
     targetInd = 0;
-  reinterpret_cast<TProfile*>(fListOfEntries->At(targetInd))->Fill(xv, yv, w);
+  // Same selection as TProfile::Fill, the sums are converted into the subprofile only at output or merge time
+  if (fYmin != fYmax && (yv < fYmin || yv > fYmax || TMath::IsNaN(yv)))
+    return;
+  const Int_t nBins = fXaxis.GetNbins() + 2;
+  if (nBins != fSubNBins || static_cast<Int_t>(fSubStats.size()) != fNSubs * kNSubStats) {
+    flushSubsamples();
+    fSubNBins = nBins;
+    fSubSums.assign(static_cast<size_t>(fNSubs) * nBins * kNSubSums, 0.);
+    fSubStats.assign(static_cast<size_t>(fNSubs) * kNSubStats, 0.);
+  }
+  const Int_t bin = fXaxis.FindFixBin(xv);
+  const Double_t wy = w * yv;
+  Double_t* sums = &fSubSums[(static_cast<size_t>(targetInd) * nBins + bin) * kNSubSums];
+  sums[0] += w;
+  sums[1] += wy;
+  sums[2] += wy * yv;
+  sums[3] += w * w;
+  Double_t* stats = &fSubStats[static_cast<size_t>(targetInd) * kNSubStats];
+  stats[0] += 1;
+  fSubsPending = kTRUE;
+  if ((bin == 0 || bin == nBins - 1) && !GetStatOverflowsBehaviour())
+    return;
+  stats[1] += w;
+  stats[2] += w * w;
+  stats[3] += w * xv;
+  stats[4] += w * xv * xv;
+  stats[5] += wy;
+  stats[6] += wy * yv;
 }
 void BootstrapProfile::FillProfile(const Double_t& xv, const Double_t& yv, const Double_t& w)
 {
   TProfile::Fill(xv, yv, w);
 }
+void BootstrapProfile::flushSubsamples()
+{
+  if (!fSubsPending)
+    return;
+  fSubsPending = kFALSE;
+  const Int_t nSubs = fListOfEntries ? std::min(fNSubs, fListOfEntries->GetEntries()) : 0;
+  for (Int_t i = 0; i < nSubs; i++) {
+    const Double_t* subStats = &fSubStats[static_cast<size_t>(i) * kNSubStats];
+    if (subStats[0] == 0)
+      continue;
+    TProfile* tpf = reinterpret_cast<TProfile*>(fListOfEntries->At(i));
+    if (tpf->GetNbinsX() + 2 != fSubNBins) {
+      printf("Binning of subprofile %i changed, dropping its pending entries\n", i);
+      continue;
+    }
+    Double_t stats[6];
+    tpf->GetStats(stats);
+    for (Int_t j = 0; j < 6; j++)
+      stats[j] += subStats[j + 1];
+    const Double_t entries = tpf->GetEntries() + subStats[0];
+    TArrayD* sumw2 = tpf->GetSumw2();
+    TArrayD* binSumw2 = tpf->GetBinSumw2();
+    for (Int_t bin = 0; bin < fSubNBins; bin++) {
+      const Double_t* sums = &fSubSums[(static_cast<size_t>(i) * fSubNBins + bin) * kNSubSums];
+      if (sums[0] == 0 && sums[3] == 0)
+        continue;
+      tpf->GetArray()[bin] += sums[1];
+      sumw2->fArray[bin] += sums[2];
+      tpf->SetBinEntries(bin, tpf->GetBinEntries(bin) + sums[0]);
+      if (binSumw2->fN)
+        binSumw2->fArray[bin] += sums[3];
+    }
+    tpf->PutStats(stats);
+    tpf->SetEntries(entries);
+  }
+  std::fill(fSubSums.begin(), fSubSums.end(), 0.);
+  std::fill(fSubStats.begin(), fSubStats.end(), 0.);
+}
+void BootstrapProfile::Streamer(TBuffer& R__b)
+{
+  if (R__b.IsReading()) {
+    R__b.ReadClassBuffer(BootstrapProfile::Class(), this);
+    fSubSums.clear();
+    fSubStats.clear();
+    fSubNBins = 0;
+    fSubsPending = kFALSE;
+  } else {
+    flushSubsamples();
+    R__b.WriteClassBuffer(BootstrapProfile::Class(), this);
+  }
+}
 void BootstrapProfile::RebinMulti(Int_t nbins)
 {
+  flushSubsamples();
   this->RebinX(nbins);
   if (!fListOfEntries)
     return;
@@ -87,6 +179,7 @@ void BootstrapProfile::RebinMulti(Int_t nbins)
 }
 TH1* BootstrapProfile::getHist(Int_t ind)
 {
+  flushSubsamples();
   if (fPresetWeights && fMultiRebin > 0)
     return getWeightBasedRebin(ind);
   if (ind < 0) {
@@ -107,6 +200,7 @@ TH1* BootstrapProfile::getHist(Int_t ind)
 }
 TProfile* BootstrapProfile::getProfile(Int_t ind)
 {
+  flushSubsamples();
   if (ind < 0) {
     return reinterpret_cast<TProfile*>(this);
   } else {
@@ -124,10 +218,12 @@ TProfile* BootstrapProfile::getProfile(Int_t ind)
 }
 Long64_t BootstrapProfile::Merge(TCollection* collist)
 {
+  flushSubsamples();
   Long64_t nmergedpf = TProfile::Merge(collist);
   BootstrapProfile* l_PBS = 0;
   TIter all_PBS(collist);
   while ((l_PBS = reinterpret_cast<BootstrapProfile*>(all_PBS()))) {
+    l_PBS->flushSubsamples();
     reinterpret_cast<TProfile*>(this)->Add(reinterpret_cast<TProfile*>(l_PBS));
     TList* tarL = l_PBS->fListOfEntries;
     if (!tarL)
@@ -205,6 +301,8 @@ TH1* BootstrapProfile::getWeightBasedRebin(Int_t ind)
 }
 void BootstrapProfile::MergeBS(BootstrapProfile* target)
 {
+  flushSubsamples();
+  target->flushSubsamples();
   this->Add(target);
   TList* tarL = target->fListOfEntries;
   if (!fListOfEntries) {
@@ -219,6 +317,7 @@ void BootstrapProfile::MergeBS(BootstrapProfile* target)
 }
 TProfile* BootstrapProfile::getSummedProfiles()
 {
+  flushSubsamples();
   if (!fListOfEntries || !fListOfEntries->GetEntries()) {
     printf("No subprofiles initialized for the BootstrapProfile.\n");
     return 0;
@@ -24,6 +24,8 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <vector>
+
 class BootstrapProfile : public TProfile
 {
  public:
@@ -43,10 +45,12 @@ class BootstrapProfile : public TProfile
   TProfile* getProfile(Int_t ind = -1);
   TProfile* getSummedProfiles();
   void OverrideMainWithSub();
+  void flushSubsamples(); // Converts the pending subsample sums into the subprofiles
   Int_t getNSubs() { return fListOfEntries->GetEntries(); }
   void PresetWeights(BootstrapProfile* targetBS) { fPresetWeights = targetBS; }
   void ResetBin(Int_t nbin)
   {
+    flushSubsamples();
     ResetBin(reinterpret_cast<TProfile*>(this), nbin);
     for (Int_t i = 0; i < fListOfEntries->GetEntries(); i++)
       ResetBin(reinterpret_cast<TProfile*>(fListOfEntries->At(i)), nbin);
@@ -61,6 +65,12 @@ class BootstrapProfile : public TProfile
   Int_t fMultiRebin;                //! externaly set runtime, no need to store
   Double_t* fMultiRebinEdges;       //! externaly set runtime, no need to store
   BootstrapProfile* fPresetWeights; //! BootstrapProfile whose weights we should copy
+  std::vector<Double_t> fSubSums;   //! sums of w, w*y, w*y^2 and w^2 per subsample and bin, not yet in the subprofiles
+  std::vector<Double_t> fSubStats;  //! entries and sums of w, w^2, w*x, w*x^2, w*y and w*y^2 per subsample, not yet in the subprofiles
+  Int_t fSubNBins;                  //! number of bins (with under- and overflow) of the layout of fSubSums
+  Bool_t fSubsPending;              //! whether fSubSums holds entries not yet in the subprofiles
+  static constexpr Int_t kNSubSums = 4;
+  static constexpr Int_t kNSubStats = 7;
   void ResetBin(TProfile* tpf, Int_t nbin)
   {
     tpf->SetBinEntries(nbin, 0);
@@ -15,6 +15,7 @@
 
 #include <complex>
 #include <cstdio>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -82,16 +83,20 @@ int GFW::CreateRegions()
   for (auto pItr = fCumulants.begin(); pItr != fCumulants.end(); ++pItr)
     pItr->DestroyComplexVectorArray();
   fCumulants.clear();
+  fCorrNodes.clear();
+  fCorrNodeIndex.clear();
+  fCorrNodeValue.clear();
+  fCorrNodeEvent.clear();
   InitializePowerArrays();
   if (fRegions.size() < 1) {
     printf("No regions set. Skipping...\n");
     return 0;
   }
   int nRegions = 0;
+  fCumulants.reserve(fRegions.size());
   for (auto pItr = fRegions.begin(); pItr != fRegions.end(); pItr++) {
-    GFWCumulant* lCumulant = new GFWCumulant();
-    lCumulant->CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
-    fCumulants.push_back(*lCumulant);
+    fCumulants.emplace_back();
+    fCumulants.back().CreateComplexVectorArrayVarPower(pItr->Nhar, pItr->NparVec, pItr->NpT);
     ++nRegions;
   }
   if (nRegions)
@@ -101,11 +106,36 @@ int GFW::CreateRegions()
 void GFW::Fill(double eta, int ptin, double phi, double weight, int mask, double SecondWeight)
 {
   // if(!fInitialized) return;
+  fQsChanged = true;
   for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
     if (fRegions.at(i).EtaMin < eta && fRegions.at(i).EtaMax > eta && (fRegions.at(i).BitMask & mask))
       fCumulants.at(i).FillArray(ptin, phi, weight, SecondWeight);
   }
 };
+void GFW::Fill(const vector<double>& eta, const vector<int>& ptin, const vector<double>& phi, const vector<double>& weight, const vector<int>& mask, const vector<double>& secondWeight)
+{
+  fQsChanged = true;
+  const int nParticles = static_cast<int>(eta.size());
+  const bool hasSecondWeight = !secondWeight.empty();
+  for (int i = 0; i < static_cast<int>(fRegions.size()); ++i) {
+    const Region& lRegion = fRegions.at(i);
+    // Particles of the region, filled at once in the cumulant
+    fBatchPtin.clear();
+    fBatchPhi.clear();
+    fBatchWeight.clear();
+    fBatchSecondWeight.clear();
+    for (int j = 0; j < nParticles; ++j) {
+      if (lRegion.EtaMin < eta[j] && lRegion.EtaMax > eta[j] && (lRegion.BitMask & mask[j])) {
+        fBatchPtin.push_back(ptin[j]);
+        fBatchPhi.push_back(phi[j]);
+        fBatchWeight.push_back(weight[j]);
+        if (hasSecondWeight)
+          fBatchSecondWeight.push_back(secondWeight[j]);
+      }
+    }
+    fCumulants.at(i).FillArray(static_cast<int>(fBatchPtin.size()), fBatchPtin.data(), fBatchPhi.data(), fBatchWeight.data(), hasSecondWeight ? fBatchSecondWeight.data() : nullptr);
+  }
+};
 complex<double> GFW::TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant* r1, GFWCumulant* r2, GFWCumulant* r3)
 {
   complex<double> part1 = r1->Vec(n1, p1, ptbin);
@@ -168,6 +198,7 @@ void GFW::Clear()
     CreateRegions();
   for (auto ptr = fCumulants.begin(); ptr != fCumulants.end(); ++ptr)
     ptr->ResetQs();
+  fQsChanged = true;
 };
 GFW::CorrConfig GFW::GetCorrelatorConfig(string config, string head, bool ptdif)
 {
@@ -267,6 +298,10 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
     return complex<double>(0, 0); // Check if we have any regions at all
   complex<double> retval(1, 0);
   int ptInd;
+  if (fQsChanged) { // new event, the terms have to be recalculated
+    fEventCounter++;
+    fQsChanged = false;
+  }
   for (int i = 0; i < static_cast<int>(corconf.Regs.size()); i++) { // looping over all regions
     if (corconf.Regs.at(i).size() == 0)
       return complex<double>(0, 0); // again, if no regions in the current subevent, then quit immediatelly
@@ -284,7 +319,7 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
       return complex<double>(0, 0); // if REF is not filled, don't even continue. Could be redundant, but should save little CPU time
     if (!qpoi->IsPtBinFilled(ptInd))
       return complex<double>(0, 0); // if POI is not filled, don't even continue. Could be redundant, but should save little CPU time
-    GFWCumulant* qovl = 0;
+    int qovl = -1;
     // Check if in the ref. region we have enough particles (no. of particles in the region >= no of harmonics for subevent)
     int sz1 = corconf.Hars.at(i).size();
     if (poi != ref)
@@ -293,18 +328,104 @@ complex<double> GFW::Calculate(CorrConfig corconf, int ptbin, bool SetHarmsToZer
       return complex<double>(0, 0);
     // Then, figure the overlap
     if (ovl > -1) // if overlap is defined, then (unless it's explicitly disabled)
-      qovl = &fCumulants.at(ovl);
+      qovl = ovl;
     else if (ref == poi)
-      qovl = qref; // If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
+      qovl = ref; // If ref and poi are the same, then the same is for overlap. Only, when OL not explicitly defined
     if (SetHarmsToZero) {
       for (int j = 0; j < static_cast<int>(corconf.Hars.at(i).size()); j++) {
         corconf.Hars.at(i).at(j) = 0;
       }
     }
-    retval *= RecursiveCorr(qpoi, qref, qovl, ptInd, corconf.Hars.at(i));
+    vector<int> pows(corconf.Hars.at(i).size(), 1);
+    retval *= EvaluateCorr(CompileCorr(poi, ref, qovl, ptInd, corconf.Hars.at(i), pows));
   }
   return retval;
 };
+int GFW::AddCorrLeaf(int region, int har, int pow, int ptbin)
+{
+  CorrNode lNode;
+  lNode.region = region;
+  lNode.har = har;
+  lNode.pow = pow;
+  lNode.ptbin = ptbin;
+  return AddCorrNode(vector<int>{-1, region, har, pow, ptbin}, lNode);
+};
+int GFW::AddCorrNode(const vector<int>& key, CorrNode node)
+{
+  auto lItr = fCorrNodeIndex.find(key);
+  if (lItr != fCorrNodeIndex.end())
+    return lItr->second;
+  fCorrNodes.push_back(std::move(node));
+  fCorrNodeValue.push_back(complex<double>(0., 0.));
+  fCorrNodeEvent.push_back(0);
+  return fCorrNodeIndex[key] = static_cast<int>(fCorrNodes.size()) - 1;
+};
+int GFW::CompileCorr(int poi, int ref, int ovl, int ptbin, vector<int>& hars, vector<int>& pows)
+{
+  if ((pows.at(0) != 1) && ovl > -1)
+    poi = ovl; // if the power of POI is not unity, then always use overlap (if defined).
+  if (hars.size() < 2)
+    return AddCorrLeaf(poi, hars.at(0), pows.at(0), ptbin);
+  vector<int> lKey = {poi, ref, ovl, ptbin};
+  lKey.insert(lKey.end(), hars.begin(), hars.end());
+  lKey.insert(lKey.end(), pows.begin(), pows.end());
+  auto lItr = fCorrNodeIndex.find(lKey);
+  if (lItr != fCorrNodeIndex.end())
+    return lItr->second;
+  CorrNode lNode;
+  if (hars.size() < 3) { // TwoRec
+    lNode.factors = {AddCorrLeaf(poi, hars.at(0), pows.at(0), ptbin), AddCorrLeaf(ref, hars.at(1), pows.at(1), ptbin)};
+    if (ovl > -1)
+      lNode.terms.push_back(std::make_pair(1, AddCorrLeaf(ovl, hars.at(0) + hars.at(1), pows.at(0) + pows.at(1), ptbin)));
+    return AddCorrNode(lKey, lNode);
+  }
+  int harlast = hars.at(hars.size() - 1);
+  int powlast = pows.at(pows.size() - 1);
+  hars.erase(hars.end() - 1);
+  pows.erase(pows.end() - 1);
+  lNode.factors.push_back(CompileCorr(poi, ref, ovl, ptbin, hars, pows));
+  lNode.factors.push_back(AddCorrLeaf(ref, harlast, powlast, 0));
+  int lDegeneracy = 1;
+  int harSize = static_cast<int>(hars.size());
+  for (int i = harSize - 1; i >= 0; i--) {
+    if (i > 2) { // same permutation check as in RecursiveCorr
+      if (hars.at(i) == hars.at(i - 1) && pows.at(i) == pows.at(i - 1)) {
+        lDegeneracy++;
+        continue;
+      }
+    }
+    hars.at(i) += harlast;
+    pows.at(i) += powlast;
+    lNode.terms.push_back(std::make_pair(lDegeneracy, CompileCorr(poi, ref, ovl, ptbin, hars, pows)));
+    lDegeneracy = 1;
+    hars.at(i) -= harlast;
+    pows.at(i) -= powlast;
+  }
+  hars.push_back(harlast);
+  pows.push_back(powlast);
+  return AddCorrNode(lKey, lNode);
+};
+complex<double> GFW::EvaluateCorr(int node)
+{
+  if (fCorrNodeEvent[node] == fEventCounter)
+    return fCorrNodeValue[node];
+  const CorrNode& lNode = fCorrNodes[node];
+  complex<double> formula;
+  if (lNode.region > -1) {
+    formula = fCumulants.at(lNode.region).Vec(lNode.har, lNode.pow, lNode.ptbin);
+  } else {
+    formula = EvaluateCorr(lNode.factors[0]) * EvaluateCorr(lNode.factors[1]);
+    for (const auto& [degeneracy, term] : lNode.terms) {
+      complex<double> subtractVal = EvaluateCorr(term);
+      if (degeneracy > 1)
+        subtractVal *= degeneracy;
+      formula -= subtractVal;
+    }
+  }
+  fCorrNodeValue[node] = formula;
+  fCorrNodeEvent[node] = fEventCounter;
+  return formula;
+};
 vector<pair<int, vector<int>>> GFW::GetHarmonicsSingleConfig(const CorrConfig& incfg)
 {
   vector<pair<int, vector<int>>> retPair;
@@ -20,6 +20,7 @@
 
 #include <complex>
 #include <cstdio>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
@@ -59,6 +60,7 @@ class GFW
   void AddRegion(std::string refName, int lNhar, int* lNparVec, double lEtaMin, double lEtaMax, int lNpT, int BitMask);  // Legacy support, array instead of a vector
   int CreateRegions();
   void Fill(double eta, int ptin, double phi, double weight, int mask, double secondWeight = -1);
+  void Fill(const std::vector<double>& eta, const std::vector<int>& ptin, const std::vector<double>& phi, const std::vector<double>& weight, const std::vector<int>& mask, const std::vector<double>& secondWeight = {}); // Batch fill of the particles of an event
   void Clear();
   GFWCumulant GetCumulant(int index) { return fCumulants.at(index); }
   CorrConfig GetCorrelatorConfig(std::string config, std::string head = "", bool ptdif = false);
@@ -68,6 +70,29 @@ class GFW
  protected:
   bool fInitialized;
   std::vector<CorrConfig> fListOfCFGs;
+  std::vector<int> fBatchPtin;            //! Particles of a region in the batch fill
+  std::vector<double> fBatchPhi;          //!
+  std::vector<double> fBatchWeight;       //!
+  std::vector<double> fBatchSecondWeight; //!
+  // Terms of the recursive correlators, shared between all the configurations and pT bins and calculated once per event
+  struct CorrNode {
+    int region = -1; // Q-vector term: region, harmonic, power and pT bin of the Q-vector; -1 for composite terms
+    int har = 0;
+    int pow = 0;
+    int ptbin = 0;
+    std::vector<int> factors{};               // Composite term: product of the two factors,
+    std::vector<std::pair<int, int>> terms{}; // minus the (degeneracy, term) subtractions
+  };
+  std::vector<CorrNode> fCorrNodes;                 //! Terms of the correlators, children before parents
+  std::map<std::vector<int>, int> fCorrNodeIndex;   //! Index of the terms in fCorrNodes
+  std::vector<std::complex<double>> fCorrNodeValue; //! Value of the terms in the event fCorrNodeEvent
+  std::vector<unsigned int> fCorrNodeEvent;         //! Event counter at which the terms were calculated
+  unsigned int fEventCounter = 1;                   //! Incremented when the Q-vectors change
+  bool fQsChanged = true;                           //! Whether the Q-vectors changed since the last calculation
+  int AddCorrLeaf(int region, int har, int pow, int ptbin);
+  int AddCorrNode(const std::vector<int>& key, CorrNode node);
+  int CompileCorr(int poi, int ref, int ovl, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // Same terms as RecursiveCorr, with regions as indices (-1 for no overlap)
+  std::complex<double> EvaluateCorr(int node);
   std::complex<double> TwoRec(int n1, int n2, int p1, int p2, int ptbin, GFWCumulant*, GFWCumulant*, GFWCumulant*);
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars, std::vector<int>& pows); // POI, Ref. flow, overlapping region
   std::complex<double> RecursiveCorr(GFWCumulant* qpoi, GFWCumulant* qref, GFWCumulant* qol, int ptbin, std::vector<int>& hars);                         // POI, Ref. flow, overlapping region
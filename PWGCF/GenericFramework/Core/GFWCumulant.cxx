@@ -11,20 +11,23 @@
 
 #include "GFWCumulant.h"
 
+#include <algorithm>
 #include <cmath>
 #include <complex>
+#include <cstddef>
 #include <vector>
 
 using std::complex;
 using std::vector;
 
-GFWCumulant::GFWCumulant() : fQvector(0),
+GFWCumulant::GFWCumulant() : fQvector(),
                              fUsed(kBlank),
                              fNEntries(-1),
                              fN(1),
                              fPow(1),
+                             fMaxPow(1),
                              fPt(1),
-                             fFilledPts(0),
+                             fFilledPts(),
                              fInitialized(false) {}
 
 GFWCumulant::~GFWCumulant() {}
@@ -37,53 +40,113 @@ void GFWCumulant::FillArray(int ptin, double phi, double weight, double SecondWe
   else if (ptin < 0 || ptin >= fPt)
     return;
   fFilledPts[ptin] = true;
+  // Powers of the weight are calculated once for all the harmonics; multiplication is cheaper that power
+  // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
+  // this is important when POIs are a subset of REFs and have different weights than REFs
+  double* lPrefactor = fWeightPowers.data();
+  lPrefactor[0] = 1.;
+  for (int lPow = 1; lPow < fMaxPow; lPow++)
+    lPrefactor[lPow] = lPrefactor[lPow - 1] * ((SecondWeight > 0 && lPow > 1) ? SecondWeight : weight);
+  // e^{i n phi} by recurrence from e^{i phi}, so that only one sin and cos are calculated
+  const double lCos1 = cos(phi);
+  const double lSin1 = sin(phi);
+  double lCos = 1.;
+  double lSin = 0.;
+  complex<double>* lQ = &fQvector[QIndex(ptin, 0, 0)];
   for (int lN = 0; lN < fN; lN++) {
-    double lSin = sin(lN * phi); // No need to recalculate for each power
-    double lCos = cos(lN * phi); // No need to recalculate for each power
-    for (int lPow = 0; lPow < PW(lN); lPow++) {
-      double lPrefactor = 0;
-      // Dont calculate it twice; multiplication is cheaper that power
-      // Also, if second weight is specified, then keep the first weight with power no more than 1, and us the other weight otherwise
-      // this is important when POIs are a subset of REFs and have different weights than REFs
-      if (SecondWeight > 0 && lPow > 1)
-        lPrefactor = pow(SecondWeight, lPow - 1) * weight;
-      else
-        lPrefactor = pow(weight, lPow);
-      double qsin = lPrefactor * lSin;
-      double qcos = lPrefactor * lCos;
-      fQvector[ptin][lN][lPow] += complex<double>(qcos, qsin);
-    }
+    for (int lPow = 0; lPow < fPowVec[lN]; lPow++)
+      lQ[lPow] += complex<double>(lPrefactor[lPow] * lCos, lPrefactor[lPow] * lSin);
+    lQ += fMaxPow;
+    const double lCosNext = lCos * lCos1 - lSin * lSin1;
+    lSin = lSin * lCos1 + lCos * lSin1;
+    lCos = lCosNext;
   }
   Inc();
 };
-void GFWCumulant::ResetQs()
+void GFWCumulant::FillArray(int nParticles, const int* ptin, const double* phi, const double* weight, const double* SecondWeight)
 {
-  if (!fNEntries)
-    return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
-  for (int i = 0; i < fPt; i++) {
-    fFilledPts[i] = false;
+  if (!fInitialized)
+    CreateComplexVectorArray(1, 1, 1);
+  // The particles are processed in batches: the loops over the particles of a batch have no dependencies and vectorise
+  int lPtBins[kBatchSize];
+  double lWeight[kBatchSize];
+  double lSecondWeight[kBatchSize];
+  double lCos1[kBatchSize];
+  double lSin1[kBatchSize];
+  double lCos[kBatchSize];
+  double lSin[kBatchSize];
+  for (int lFirst = 0; lFirst < nParticles; lFirst += kBatchSize) {
+    // Same pT bin selection as for the single particle fill
+    int lNBatch = 0;
+    const int lLast = std::min(lFirst + kBatchSize, nParticles);
+    for (int i = lFirst; i < lLast; i++) {
+      const int lPtBin = (fPt == 1) ? 0 : ptin[i];
+      if (lPtBin < 0 || lPtBin >= fPt)
+        continue;
+      fFilledPts[lPtBin] = true;
+      lPtBins[lNBatch] = lPtBin;
+      lCos1[lNBatch] = phi[i];
+      lWeight[lNBatch] = weight[i];
+      lSecondWeight[lNBatch] = SecondWeight ? SecondWeight[i] : -1.;
+      lNBatch++;
+    }
+    for (int j = 0; j < lNBatch; j++) {
+      lSin1[j] = sin(lCos1[j]);
+      lCos1[j] = cos(lCos1[j]);
+      lCos[j] = 1.;
+      lSin[j] = 0.;
+    }
+    // Powers of the weights, (power x particle)
+    double* lPrefactor = fWeightPowers.data();
+    for (int j = 0; j < lNBatch; j++)
+      lPrefactor[j] = 1.;
+    for (int lPow = 1; lPow < fMaxPow; lPow++) {
+      const double* lPrevious = lPrefactor + (lPow - 1) * kBatchSize;
+      double* lCurrent = lPrefactor + lPow * kBatchSize;
+      for (int j = 0; j < lNBatch; j++)
+        lCurrent[j] = lPrevious[j] * ((lSecondWeight[j] > 0 && lPow > 1) ? lSecondWeight[j] : lWeight[j]);
+    }
     for (int lN = 0; lN < fN; lN++) {
-      for (int lPow = 0; lPow < PW(lN); lPow++) {
-        fQvector[i][lN][lPow] = fNullQ;
+      for (int lPow = 0; lPow < fPowVec[lN]; lPow++) {
+        const double* lCurrent = lPrefactor + lPow * kBatchSize;
+        if (fPt == 1) {
+          double lRe = 0.;
+          double lIm = 0.;
+          for (int j = 0; j < lNBatch; j++) {
+            lRe += lCurrent[j] * lCos[j];
+            lIm += lCurrent[j] * lSin[j];
+          }
+          fQvector[QIndex(0, lN, lPow)] += complex<double>(lRe, lIm);
+        } else {
+          for (int j = 0; j < lNBatch; j++)
+            fQvector[QIndex(lPtBins[j], lN, lPow)] += complex<double>(lCurrent[j] * lCos[j], lCurrent[j] * lSin[j]);
+        }
+      }
+      // Next harmonic, e^{i (n+1) phi} = e^{i n phi} e^{i phi}
+      for (int j = 0; j < lNBatch; j++) {
+        const double lCosNext = lCos[j] * lCos1[j] - lSin[j] * lSin1[j];
+        lSin[j] = lSin[j] * lCos1[j] + lCos[j] * lSin1[j];
+        lCos[j] = lCosNext;
       }
     }
+    fNEntries += lNBatch;
   }
+};
+void GFWCumulant::ResetQs()
+{
+  if (!fNEntries)
+    return; // If 0 entries, then no need to reset. Otherwise, if -1, then just initialized and need to set to 0.
+  std::fill(fFilledPts.begin(), fFilledPts.end(), false);
+  std::fill(fQvector.begin(), fQvector.end(), fNullQ);
   fNEntries = 0;
 };
 void GFWCumulant::DestroyComplexVectorArray()
 {
   if (!fInitialized)
     return;
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      delete[] fQvector[i][l_n];
-    }
-  }
-  for (int i = 0; i < fPt; i++) {
-    delete[] fQvector[i];
-  }
-  delete[] fQvector;
-  delete[] fFilledPts;
+  vector<complex<double>>().swap(fQvector);
+  vector<bool>().swap(fFilledPts);
+  vector<double>().swap(fWeightPowers);
   fInitialized = false;
   fNEntries = -1;
 };
@@ -102,17 +165,14 @@ void GFWCumulant::CreateComplexVectorArrayVarPower(int N, vector<int> PowVec, in
   fN = N;
   fPow = 0;
   fPt = Pt;
-  fFilledPts = new bool[Pt];
   fPowVec = PowVec;
-  fQvector = new complex<double>**[fPt];
-  for (int i = 0; i < fPt; i++) {
-    fQvector[i] = new complex<double>*[fN];
-  }
-  for (int l_n = 0; l_n < fN; l_n++) {
-    for (int i = 0; i < fPt; i++) {
-      fQvector[i][l_n] = new complex<double>[PW(l_n)];
-    }
-  }
+  fMaxPow = 1;
+  for (int l_n = 0; l_n < fN; l_n++)
+    fMaxPow = std::max(fMaxPow, PW(l_n));
+  // One contiguous buffer, the powers of each harmonic are padded to the largest power
+  fQvector.assign(static_cast<std::size_t>(fPt) * fN * fMaxPow, fNullQ);
+  fFilledPts.assign(fPt, false);
+  fWeightPowers.assign(static_cast<std::size_t>(fMaxPow) * kBatchSize, 0.);
   ResetQs();
   fInitialized = true;
 };
@@ -123,12 +183,12 @@ complex<double> GFWCumulant::Vec(int n, int p, int ptbin)
   if (ptbin >= fPt || ptbin < 0)
     ptbin = 0;
   if (n >= 0)
-    return fQvector[ptbin][n][p];
-  return conj(fQvector[ptbin][-n][p]);
+    return fQvector[QIndex(ptbin, n, p)];
+  return conj(fQvector[QIndex(ptbin, -n, p)]);
 };
 bool GFWCumulant::IsPtBinFilled(int ptb)
 {
-  if (!fFilledPts)
+  if (fFilledPts.empty())
     return false;
   if (ptb > 0) {
     if (fPt == 1)
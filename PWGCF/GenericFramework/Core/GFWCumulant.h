@@ -29,6 +29,7 @@ class GFWCumulant
   ~GFWCumulant();
   void ResetQs();
   void FillArray(int ptin, double phi, double weight = 1, double SecondWeight = -1);
+  void FillArray(int nParticles, const int* ptin, const double* phi, const double* weight, const double* SecondWeight = nullptr); // Batch fill, vectorised across the particles
   enum UsedFlags_t { kBlank = 0,
                      kFull = 1,
                      kPt = 2 };
@@ -46,17 +47,21 @@ class GFWCumulant
   void DestroyComplexVectorArray();
   std::complex<double> Vec(int, int, int ptbin = 0); // envelope class to summarize pt-dif. Q-vec getter
  protected:
-  std::complex<double>*** fQvector;
+  static constexpr int kBatchSize = 64;       // Number of particles processed at once by the batch fill
+  std::vector<std::complex<double>> fQvector; //! Q-vectors, contiguous in (pT bin x harmonic x power)
   uint fUsed;
   int fNEntries;
   // Q-vectors. Could be done recursively, but maybe defining each one of them explicitly is easier to read
-  int fN;                   //! Harmonics
-  int fPow;                 //! Power
-  std::vector<int> fPowVec; //! Powers array
-  int fPt;                  //! fPt bins
-  bool* fFilledPts;
-  bool fInitialized; // Arrays are initialized
+  int fN;                       //! Harmonics
+  int fPow;                     //! Power
+  std::vector<int> fPowVec;     //! Powers array
+  int fMaxPow;                  //! Largest power, stride of the harmonics in fQvector
+  int fPt;                      //! fPt bins
+  std::vector<bool> fFilledPts; //! Filled pT bins
+  bool fInitialized;            // Arrays are initialized
   std::complex<double> fNullQ = 0;
+  std::vector<double> fWeightPowers; //! Powers of the weights of the particles of a batch (power x particle)
+  int QIndex(int ptbin, int n, int p) const { return (ptbin * fN + n) * fMaxPow + p; }
 };
 
 #endif // PWGCF_GENERICFRAMEWORK_CORE_GFWCUMULANT_H_
@@ -13,6 +13,8 @@
 
 #include <Framework/Logger.h>
 
+#include <TArrayD.h>
+#include <TAxis.h>
 #include <TCollection.h>
 #include <TFile.h>
 #include <TH1.h>
@@ -25,7 +27,9 @@
 
 #include <RtypesCore.h>
 
+#include <cstddef>
 #include <cstdio>
+#include <vector>
 
 GFWWeights::GFWWeights() : TNamed("", ""),
                            fDataFilled(kFALSE),
@@ -157,29 +161,80 @@ double GFWWeights::getWeight(double phi, double eta, double vz, double pt, doubl
     return 1. / weight;
   return 1;
 };
-double GFWWeights::getNUA(double phi, double eta, double vz)
+void GFWWeights::WeightTable::build(const TH3D* hist)
+{
+  clear();
+  if (!hist)
+    return;
+  auto setAxis = [](Axis& axis, const TAxis* histAxis) {
+    axis.nBins = histAxis->GetNbins();
+    axis.min = histAxis->GetXmin();
+    axis.max = histAxis->GetXmax();
+    const TArrayD* bins = histAxis->GetXbins();
+    axis.edges.assign(bins->GetArray(), bins->GetArray() + bins->GetSize());
+  };
+  setAxis(xAxis, hist->GetXaxis());
+  setAxis(yAxis, hist->GetYaxis());
+  setAxis(zAxis, hist->GetZaxis());
+  const int nCells = hist->GetNcells();
+  weights.resize(nCells);
+  for (int bin = 0; bin < nCells; bin++) {
+    const double content = hist->GetBinContent(bin);
+    weights[bin] = (content != 0) ? 1. / content : 1.;
+  }
+}
+void GFWWeights::WeightTable::getWeights(const std::vector<double>& x, const std::vector<double>& y, double z, std::vector<double>& out) const
+{
+  out.resize(x.size());
+  const int zBin = zAxis.findBin(z);
+  for (std::size_t i = 0; i < x.size(); i++)
+    out[i] = weights[getBin(xAxis.findBin(x[i]), yAxis.findBin(y[i]), zBin)];
+}
+bool GFWWeights::prepareNUA()
 {
+  if (fAccTable.isBuilt())
+    return true;
   if (!fAccInt)
     createNUA();
-  int xind = fAccInt->GetXaxis()->FindBin(phi);
-  int etaind = fAccInt->GetYaxis()->FindBin(eta);
-  int vzind = fAccInt->GetZaxis()->FindBin(vz);
-  double weight = fAccInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  fAccTable.build(fAccInt);
+  return fAccTable.isBuilt();
 }
-double GFWWeights::getNUE(double pt, double eta, double vz)
+bool GFWWeights::prepareNUE()
 {
+  if (fEffTable.isBuilt())
+    return true;
   if (!fEffInt)
     createNUE();
-  int xind = fEffInt->GetXaxis()->FindBin(pt);
-  int etaind = fEffInt->GetYaxis()->FindBin(eta);
-  int vzind = fEffInt->GetZaxis()->FindBin(vz);
-  double weight = fEffInt->GetBinContent(xind, etaind, vzind);
-  if (weight != 0)
-    return 1. / weight;
-  return 1;
+  fEffTable.build(fEffInt);
+  return fEffTable.isBuilt();
+}
+double GFWWeights::getNUA(double phi, double eta, double vz)
+{
+  if (!prepareNUA())
+    return 1;
+  return fAccTable.getWeight(phi, eta, vz);
+}
+double GFWWeights::getNUE(double pt, double eta, double vz)
+{
+  if (!prepareNUE())
+    return 1;
+  return fEffTable.getWeight(pt, eta, vz);
+}
+void GFWWeights::getNUA(const std::vector<double>& phi, const std::vector<double>& eta, double vz, std::vector<double>& weights)
+{
+  if (!prepareNUA()) {
+    weights.assign(phi.size(), 1.);
+    return;
+  }
+  fAccTable.getWeights(phi, eta, vz, weights);
+}
+void GFWWeights::getNUE(const std::vector<double>& pt, const std::vector<double>& eta, double vz, std::vector<double>& weights)
+{
+  if (!prepareNUE()) {
+    weights.assign(pt.size(), 1.);
+    return;
+  }
+  fEffTable.getWeights(pt, eta, vz, weights);
 }
 double GFWWeights::findMax(TH3D* inh, int& ix, int& iy, int& iz)
 {
@@ -253,6 +308,7 @@ void GFWWeights::createNUA(bool IntegrateOverCentAndPt)
       fAccInt->GetZaxis()->SetRange(1, fAccInt->GetNbinsZ());
     }
     fAccInt->GetYaxis()->SetRange(1, fAccInt->GetNbinsY());
+    fAccTable.build(fAccInt);
     return;
   }
 };
@@ -292,8 +348,11 @@ void GFWWeights::createNUE(bool IntegrateOverCentrality)
     den->RebinY(2);
     num->RebinZ(5);
     den->RebinZ(5);
+    if (fEffInt)
+      delete fEffInt;
     fEffInt = reinterpret_cast<TH3D*>(num->Clone("Efficiency_Integrated"));
     fEffInt->Divide(den);
+    fEffTable.build(fEffInt);
     return;
   }
 };
@@ -378,6 +437,8 @@ void GFWWeights::overwriteNUA()
   delete trash;
   fW_data->Add(reinterpret_cast<TH3D*>(fAccInt->Clone(ts.Data())));
   delete fAccInt;
+  fAccInt = 0;
+  fAccTable.clear();
 }
 Long64_t GFWWeights::Merge(TCollection* collist)
 {
@@ -26,6 +26,10 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
 class GFWWeights : public TNamed
 {
  public:
@@ -37,6 +41,8 @@ class GFWWeights : public TNamed
   double getWeight(double phi, double eta, double vz, double pt, double cent, int htype);             // htype: 0 for data, 1 for mc rec, 2 for mc gen
   double getNUA(double phi, double eta, double vz);                                                   // This just fetches correction from integrated NUA, should speed up
   double getNUE(double pt, double eta, double vz);                                                    // fetches weight from fEffInt
+  void getNUA(const std::vector<double>& phi, const std::vector<double>& eta, double vz, std::vector<double>& weights);
+  void getNUE(const std::vector<double>& pt, const std::vector<double>& eta, double vz, std::vector<double>& weights);
   bool isDataFilled() { return fDataFilled; }
   bool isMCFilled() { return fMCFilled; }
   double findMax(TH3D* inh, int& ix, int& iy, int& iz);
@@ -72,6 +78,40 @@ class GFWWeights : public TNamed
   TH3D* fAccInt;   //!
   int fNbinsPt;    //! do not store
   double* fbinsPt; //! do not store
+  // Flattened copy of an integrated correction with the inverse of the bin contents, for the per-track lookups.
+  // The bins are found with the same arithmetic as TAxis::FindBin, the TH3D is kept for I/O and merging only
+  struct WeightTable {
+    struct Axis {
+      int nBins = 0;
+      double min = 0.;
+      double max = 0.;
+      std::vector<double> edges{}; // bin edges, only for variable bins
+      int findBin(double x) const
+      {
+        if (x < min)
+          return 0;
+        if (!(x < max))
+          return nBins + 1;
+        if (edges.empty())
+          return 1 + static_cast<int>(nBins * (x - min) / (max - min));
+        return static_cast<int>(std::upper_bound(edges.begin(), edges.end(), x) - edges.begin());
+      }
+    };
+    Axis xAxis;
+    Axis yAxis;
+    Axis zAxis;
+    std::vector<double> weights{}; // 1/content, 1 for empty bins, with the TH3 global bin numbering
+    bool isBuilt() const { return !weights.empty(); }
+    void build(const TH3D* hist);
+    void clear() { weights.clear(); }
+    std::size_t getBin(int ix, int iy, int iz) const { return ix + static_cast<std::size_t>(xAxis.nBins + 2) * (iy + static_cast<std::size_t>(yAxis.nBins + 2) * iz); }
+    double getWeight(double x, double y, double z) const { return weights[getBin(xAxis.findBin(x), yAxis.findBin(y), zAxis.findBin(z))]; }
+    void getWeights(const std::vector<double>& x, const std::vector<double>& y, double z, std::vector<double>& out) const;
+  };
+  WeightTable fAccTable; //! lookup table of fAccInt
+  WeightTable fEffTable; //! lookup table of fEffInt
+  bool prepareNUA();
+  bool prepareNUE();
   void addArray(TObjArray* targ, TObjArray* sour);
   const char* getBinName(double /*ptv*/, double /*v0mv*/, const char* pf = "")
   {
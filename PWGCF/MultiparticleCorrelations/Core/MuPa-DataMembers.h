@@ -120,10 +120,13 @@ struct EventByEventQuantities {
 // *) Particle-by-particle quantities:
 //    Remark: Here I define all particle quantities, that I need across several member functions.
 struct ParticleByParticleQuantities {
-  double fPhi = 0.;      // azimuthal angle
-  double fPt = 0.;       // transverse momentum
-  double fEta = 0.;      // pseudorapidity
-  double fCharge = -44.; // particle charge. Yes, never initialize charge to 0.
+  double fPhi = 0.;                                               // azimuthal angle
+  double fPt = 0.;                                                // transverse momentum
+  double fEta = 0.;                                               // pseudorapidity
+  double fCharge = -44.;                                          // particle charge. Yes, never initialize charge to 0.
+  double fPhiOfHarmonics = -44.;                                  // azimuthal angle for which fCosHarmonics and fSinHarmonics were calculated
+  double fCosHarmonics[gMaxHarmonic * gMaxCorrelator + 1] = {0.}; // cos(h*phi) of this particle, see CalculateHarmonicsOfThisParticle()
+  double fSinHarmonics[gMaxHarmonic * gMaxCorrelator + 1] = {0.}; // sin(h*phi) of this particle, see CalculateHarmonicsOfThisParticle()
 } pbyp;
 
 // *) QA:
@@ -294,6 +297,11 @@ struct Qvector {
   TComplex fQvector[gMaxHarmonic * gMaxCorrelator + 1][gMaxCorrelator + 1] = {{TComplex(0., 0.)}}; //! integrated Q-vector, legacy code (TBI 20250718 remove, and switch to line below eventually)
   // std::vector<std::vector<std::complex<double>>> fQvector; // dynamically allocated integrated Q-vector => it has to be done this way, to optimize memory usage
 
+  // subsets of particles in generic correlators, see GenericCorrelator(...):
+  int fSubsetHarmonic[1 << gMaxCorrelator] = {0};                           //! sum of harmonics of particles in each subset (subset is a bitmask of particle indices)
+  std::complex<double> fSubsetBlock[1 << gMaxCorrelator] = {{0., 0.}};      //! (-1)^(k-1) (k-1)! Q(sum of harmonics, k) of each subset with k particles
+  std::complex<double> fSubsetCorrelator[1 << gMaxCorrelator] = {{0., 0.}}; //! sum over all partitions of each subset into blocks, of products of their terms above
+
   bool fCalculateqvectorsKineAny = false;                              // by default, it's off. It's set to true automatically if any of kine correlators is requested,
                                                                        // either for Correlations, Test0, EtaSeparations, etc.
   bool fCalculateqvectorsKine[eqvectorKine_N] = {false};               // same as above, just specifically for each enum eqvectorKine + applies only to Correlations and Test0
@@ -14065,7 +14065,7 @@ TComplex Seven(int n1, int n2, int n3, int n4, int n5, int n6, int n7)
 
   int harmonic[7] = {n1, n2, n3, n4, n5, n6, n7};
 
-  TComplex seven = Recursion(7, harmonic);
+  TComplex seven = GenericCorrelator(7, harmonic);
 
   return seven;
 
@@ -14079,7 +14079,7 @@ TComplex Eight(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8)
 
   int harmonic[8] = {n1, n2, n3, n4, n5, n6, n7, n8};
 
-  TComplex eight = Recursion(8, harmonic);
+  TComplex eight = GenericCorrelator(8, harmonic);
 
   return eight;
 
@@ -14093,7 +14093,7 @@ TComplex Nine(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, in
 
   int harmonic[9] = {n1, n2, n3, n4, n5, n6, n7, n8, n9};
 
-  TComplex nine = Recursion(9, harmonic);
+  TComplex nine = GenericCorrelator(9, harmonic);
 
   return nine;
 
@@ -14107,7 +14107,7 @@ TComplex Ten(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8, int
 
   int harmonic[10] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10};
 
-  TComplex ten = Recursion(10, harmonic);
+  TComplex ten = GenericCorrelator(10, harmonic);
 
   return ten;
 
@@ -14121,7 +14121,7 @@ TComplex Eleven(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8,
 
   int harmonic[11] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11};
 
-  TComplex eleven = Recursion(11, harmonic);
+  TComplex eleven = GenericCorrelator(11, harmonic);
 
   return eleven;
 
@@ -14135,7 +14135,7 @@ TComplex Twelve(int n1, int n2, int n3, int n4, int n5, int n6, int n7, int n8,
 
   int harmonic[12] = {n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11, n12};
 
-  TComplex twelve = Recursion(12, harmonic);
+  TComplex twelve = GenericCorrelator(12, harmonic);
 
   return twelve;
 
@@ -14185,6 +14185,55 @@ TComplex Recursion(int n, int* harmonic, int mult = 1, int skip = 0)
 
 //============================================================
 
+TComplex GenericCorrelator(int n, const int* harmonic)
+{
+  // Calculate generic n-particle correlator from Q-vectors, without recursion. Same result as Recursion(n, harmonic).
+
+  // The correlator is the sum over all partitions of n particles into blocks, of the product over blocks of
+  // (-1)^(k-1) (k-1)! Q(sum of harmonics in the block, k), where k is the number of particles in the block.
+  // Particle subsets are bitmasks, and subsets are processed in increasing order, so that the sum over partitions of
+  // each subset is obtained from the ones of smaller subsets, by fixing the block which contains its lowest particle.
+  // This needs ~3^n/2 complex multiplications, instead of the exponentially growing number of Q-vector calls
+  // in Recursion(...) (e.g. for n = 8, 255 Q-vector calls instead of 8279).
+
+  if (n < 1 || n > gMaxCorrelator) {
+    LOGF(fatal, "\033[1;31m%s at line %d : n = %d is not supported\033[0m", __FUNCTION__, __LINE__, n);
+  }
+
+  const unsigned int nSubsets = 1u << n;
+  qv.fSubsetHarmonic[0] = 0;
+  qv.fSubsetCorrelator[0] = std::complex<double>(1., 0.);
+  double blockFactor[gMaxCorrelator + 1] = {0.}; // (-1)^(k-1) (k-1)!
+  blockFactor[1] = 1.;
+  for (int k = 2; k <= n; k++) {
+    blockFactor[k] = -1. * (k - 1) * blockFactor[k - 1];
+  }
+
+  for (unsigned int subset = 1; subset < nSubsets; subset++) {
+    const unsigned int lowest = subset & (~subset + 1); // lowest particle in this subset
+    const unsigned int rest = subset ^ lowest;          // all other particles
+    const int k = std::popcount(subset);                // number of particles in this subset
+    qv.fSubsetHarmonic[subset] = qv.fSubsetHarmonic[rest] + harmonic[std::countr_zero(subset)];
+    TComplex q = Q(qv.fSubsetHarmonic[subset], k);
+    qv.fSubsetBlock[subset] = blockFactor[k] * std::complex<double>(q.Re(), q.Im());
+
+    // sum over the blocks which contain the lowest particle (sub runs over all subsets of rest, including empty one):
+    std::complex<double> correlator(0., 0.);
+    for (unsigned int sub = rest;; sub = (sub - 1) & rest) {
+      correlator += qv.fSubsetBlock[sub | lowest] * qv.fSubsetCorrelator[rest ^ sub];
+      if (sub == 0) {
+        break;
+      }
+    }
+    qv.fSubsetCorrelator[subset] = correlator;
+  } // for (unsigned int subset = 1; subset < nSubsets; subset++)
+
+  return TComplex(qv.fSubsetCorrelator[nSubsets - 1].real(), qv.fSubsetCorrelator[nSubsets - 1].imag());
+
+} // TComplex GenericCorrelator(int n, const int* harmonic)
+
+//============================================================
+
 void ResetQ()
 {
   // Reset the components of generic Q-vectors. Use it whenever you call the
@@ -18476,6 +18525,25 @@ void FillQvector(const double& dPhi, const double& dPt, const double& dEta)
 
 //============================================================
 
+void CalculateHarmonicsOfThisParticle()
+{
+  // Calculate cos(h*phi) and sin(h*phi) of this particle, for all harmonics needed in Q-vectors.
+  // They are calculated only when azimuthal angle changes, and are then reused in integrated and all differential Q-vectors.
+
+  if (pbyp.fPhi == pbyp.fPhiOfHarmonics) {
+    return;
+  }
+
+  for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
+    pbyp.fCosHarmonics[h] = std::cos(h * pbyp.fPhi);
+    pbyp.fSinHarmonics[h] = std::sin(h * pbyp.fPhi);
+  }
+  pbyp.fPhiOfHarmonics = pbyp.fPhi;
+
+} // void CalculateHarmonicsOfThisParticle()
+
+//============================================================
+
 void FillQvectorFromSparse()
 {
   // Fill integrated Q-vector using sparse histograms.
@@ -18490,11 +18558,10 @@ void FillQvectorFromSparse()
 
   // Particle weights from sparse histograms:
   // Remark: Keep in sync with corresponding implementation in Fillqvectors()
-  double wPhi = 1.;      // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
-  double wPt = 1.;       // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
-  double wEta = 1.;      // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
-  double wCharge = 1.;   // differential multidimensional charge weight, its dimensions are defined via enum eDiffChargeWeights
-  double wToPowerP = 1.; // weight raised to power p
+  double wPhi = 1.;    // differential multidimensional phi weight, its dimensions are defined via enum eDiffPhiWeights
+  double wPt = 1.;     // differential multidimensional pt weight, its dimensions are defined via enum eDiffPtWeights
+  double wEta = 1.;    // differential multidimensional eta weight, its dimensions are defined via enum eDiffEtaWeights
+  double wCharge = 1.; // differential multidimensional charge weight, its dimensions are defined via enum eDiffChargeWeights
 
   // *) Multidimensional phi weights:
   if (pw.fUseDiffPhiWeights[wPhiPhiAxis]) { // yes, 0th axis serves as a common boolean for this category
@@ -18579,18 +18646,20 @@ void FillQvectorFromSparse()
   } // if(pw.fUseDiffChargeWeights[wChargeChargeAxis])
 
   if (qv.fCalculateQvectors) {
+    // cos(h*phi), sin(h*phi) and weight powers are calculated only once, and not for each (h, wp) combination:
+    CalculateHarmonicsOfThisParticle();
+    double wToPowerP[gMaxCorrelator + 1] = {0.}; // weight raised to power p
+    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {
+      if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis] || pw.fUseDiffChargeWeights[wChargeChargeAxis]) {
+        wToPowerP[wp] = std::pow(wPhi * wPt * wEta * wCharge, wp); // Q-vector with weights
+      } else {
+        wToPowerP[wp] = 1.; // bare Q-vector without weights
+      }
+    }
     for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
       for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
-        if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis] || pw.fUseDiffChargeWeights[wChargeChargeAxis]) {
-          wToPowerP = std::pow(wPhi * wPt * wEta * wCharge, wp);
-          qv.fQvector[h][wp] += TComplex(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi)); // Q-vector with weights, legacy code (TBI 20251027 remove this line)
-          // qv.fQvector[h][wp] += std::complex<double>(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi)); // Q-vector with weights, new code
-          // TBI 20251028 I have to keep it this way for the time being, otherwise I have to change all over the place, e.g. in TComplex Q(int n, int wp), etc.
-        } else {
-          qv.fQvector[h][wp] += TComplex(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare Q-vector without weights, legacy code (TBI 20251027 remove this line)
-          // qv.fQvector[h][wp] += std::complex<double>(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare Q-vector without weights, new code
-          // TBI 20251028 I have to keep it this way for the time being, otherwise I have to change all over the place, e.g. in TComplex Q(int n, int wp), etc.
-        }
+        qv.fQvector[h][wp] += TComplex(wToPowerP[wp] * pbyp.fCosHarmonics[h], wToPowerP[wp] * pbyp.fSinHarmonics[h]);
+        // TBI 20251028 I have to keep TComplex for the time being, otherwise I have to change all over the place, e.g. in TComplex Q(int n, int wp), etc.
       } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
     } // for(int h=0;h<gMaxHarmonic*gMaxCorrelator+1;h++)
   } // if (qv.fCalculateQvectors) {
@@ -19529,16 +19598,22 @@ void FillqvectorFromSparse(const eqvectorKine& kineVarChoice, const int& bin, co
   }
 
   // *) Finally, fill differential q-vector in that linearized "global bin":
-  double wToPowerP = 1.; // weight raised to power p
+  //    cos(h*phi) and sin(h*phi) are calculated only once per particle, and reused for all differential q-vectors, see CalculateHarmonicsOfThisParticle()
+  CalculateHarmonicsOfThisParticle();
+  double wToPowerP[gMaxCorrelator + 1] = {0.}; // weight raised to power p
+  for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {
+    // yes, because the first enum serves as a boolean for that category:
+    if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis] || pw.fUseDiffChargeWeights[wChargeChargeAxis]) {
+      wToPowerP[wp] = std::pow(dWeight, wp); // q-vector with weights, dWeight = wPhi * wPt * wEta * wcharge
+    } else {
+      wToPowerP[wp] = 1.; // bare q-vector without weights
+    }
+  }
 
   for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++) {
-    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) {                                                                                                                   // weight power
-      if (pw.fUseDiffPhiWeights[wPhiPhiAxis] || pw.fUseDiffPtWeights[wPtPtAxis] || pw.fUseDiffEtaWeights[wEtaEtaAxis] || pw.fUseDiffChargeWeights[wChargeChargeAxis]) { // yes, because the first enum serves as a boolean for that category
-        wToPowerP = std::pow(dWeight, wp);                                                                                                                              // dWeight = wPhi * wPt * wEta * wcharge
-        qv.fqvector[kineVarChoice][bin][h][wp] += std::complex<double>(wToPowerP * std::cos(h * pbyp.fPhi), wToPowerP * std::sin(h * pbyp.fPhi));                       // q-vector with weights
-      } else {
-        qv.fqvector[kineVarChoice][bin][h][wp] += std::complex<double>(std::cos(h * pbyp.fPhi), std::sin(h * pbyp.fPhi)); // bare q-vector without weights
-      }
+    std::vector<std::complex<double>>& qvectorThisHarmonic = qv.fqvector[kineVarChoice][bin][h];
+    for (int wp = 0; wp < gMaxCorrelator + 1; wp++) { // weight power
+      qvectorThisHarmonic[wp] += std::complex<double>(wToPowerP[wp] * pbyp.fCosHarmonics[h], wToPowerP[wp] * pbyp.fSinHarmonics[h]);
     } // for(int wp=0;wp<gMaxCorrelator+1;wp++)
   } // for (int h = 0; h < gMaxHarmonic * gMaxCorrelator + 1; h++)
 
@@ -98,6 +98,7 @@ using TracksRec_QA = TracksRec;    // if I would need additional tables for QA,
 
 #include <Riostream.h>
 
+#include <bit>
 #include <complex>
 using namespace std;
 
@@ -1185,6 +1185,7 @@ struct DptDptFilterTracks {
   bool checkAmbiguousTracks = false;
 
   std::vector<bool> particleReconstructed;
+  std::vector<bool> collisionAccepted; /* acceptance of each collision, indexed by the collision global index */
 
   void init(InitContext& initContext)
   {
@@ -1547,14 +1548,17 @@ struct DptDptFilterTracks {
     if (!fullDerivedData) {
       tracksinfo.reserve(tracks.size());
     }
+    /* the acceptance of the collisions is bucketed once, to not look up the collision of each track */
+    collisionAccepted.assign(collisions.size(), false);
     for (auto const& collision : collisions) {
       if (collision.collisionaccepted()) {
+        collisionAccepted[collision.globalIndex()] = true;
         ncollaccepted++;
       }
     }
     for (auto const& track : tracks) {
       int8_t pid = -1;
-      if (track.has_collision() && (track.template collision_as<soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>()).collisionaccepted()) {
+      if (track.has_collision() && collisionAccepted[track.collisionId()]) {
         pid = selectTrackAmbiguousCheck<outdebug>(collisions, track);
         if (!(pid < 0)) {
           naccepted++;
@@ -1590,14 +1594,18 @@ struct DptDptFilterTracks {
   /* the aim is to fill the structure of the generated particles  */
   /* that were reconstructed                                      */
   template <typename passedtracks>
-  void filterTracksSpecial(soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo> const&, passedtracks const& tracks)
+  void filterTracksSpecial(soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo> const& collisions, passedtracks const& tracks)
   {
     /* do check for special adjustments */
     getCCDBInformation();
 
+    collisionAccepted.assign(collisions.size(), false);
+    for (auto const& collision : collisions) {
+      collisionAccepted[collision.globalIndex()] = collision.collisionaccepted();
+    }
     for (auto const& track : tracks) {
       int8_t pid = -1;
-      if (track.has_collision() && (track.template collision_as<soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>()).collisionaccepted()) {
+      if (track.has_collision() && collisionAccepted[track.collisionId()]) {
         pid = selectTrack<kNODEBUG, soa::Join<aod::Collisions, aod::DptDptCFCollisionsInfo>>(track);
         if (!(pid < 0)) {
           particleReconstructed[track.mcParticleId()] = true;
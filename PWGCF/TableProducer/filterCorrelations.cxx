@@ -41,6 +41,7 @@
 #include <Rtypes.h>
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <experimental/type_traits> // required for is_detected
 #include <type_traits>
@@ -137,6 +138,7 @@ struct FilterCF {
   // persistent caches
   std::vector<bool> mcReconstructedCache;
   std::vector<int> mcParticleLabelsCache;
+  std::vector<bool> keepCollisionCache; // event selection of each collision, evaluated in the first pass of processMCT
 
   void init(InitContext&)
   {
@@ -401,16 +403,19 @@ struct FilterCF {
     }
 
     // PASS 1 on collisions: check which particles are kept
+    keepCollisionCache.clear();
+    keepCollisionCache.reserve(allCollisions.size());
     for (auto& collision : allCollisions) {
+      keepCollisionCache.push_back(keepCollision(collision));
+      if (!keepCollisionCache.back()) {
+        continue;
+      }
+
       auto groupedTracks = tracks.sliceBy(perCollision, collision.globalIndex());
       if (cfgVerbosity > 0) {
         LOGF(info, "processMC:   Tracks for collision %d: %d | Vertex: %.1f (%d) | INT7: %d", collision.globalIndex(), groupedTracks.size(), collision.posZ(), collision.flags(), collision.sel7());
       }
 
-      if (!keepCollision(collision)) {
-        continue;
-      }
-
       for (auto& track : groupedTracks) {
         if (track.has_mcParticle()) {
           mcReconstructedCache[track.mcParticleId()] = true;
@@ -462,16 +467,15 @@ struct FilterCF {
     }
 
     // PASS 2 on collisions: store collisions and tracks
+    // the event selection is reused from pass 1, collisions are iterated in the same order
+    std::size_t collisionCounter = 0;
     for (auto& collision : allCollisions) {
-      auto groupedTracks = tracks.sliceBy(perCollision, collision.globalIndex());
-      if (cfgVerbosity > 0) {
-        LOGF(info, "processMC:   Tracks for collision %d: %d | Vertex: %.1f (%d) | INT7: %d", collision.globalIndex(), groupedTracks.size(), collision.posZ(), collision.flags(), collision.sel7());
-      }
-
-      if (!keepCollision(collision)) {
+      if (!keepCollisionCache[collisionCounter++]) {
         continue;
       }
 
+      auto groupedTracks = tracks.sliceBy(perCollision, collision.globalIndex());
+
       auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
       // NOTE works only when we store all MC collisions (as we do here)
       outputCollisions(bc.runNumber(), collision.posZ(), collision.multiplicity(), bc.timestamp());
@@ -15,6 +15,8 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 
 ClassImp(AnalysisCompositeCut)
@@ -65,6 +67,7 @@ AnalysisCompositeCut& AnalysisCompositeCut::operator=(const AnalysisCompositeCut
     fOptionUseAND = c.fOptionUseAND;
     fCutList = c.fCutList;
     fCompositeCutList = c.fCompositeCutList;
+    fProgram.clear();
   }
   return (*this);
 }
@@ -78,27 +81,109 @@ bool AnalysisCompositeCut::IsSelected(float* values)
   //
   // apply cuts
   //
-  for (std::vector<AnalysisCut>::iterator it = fCutList.begin(); it < fCutList.end(); ++it) {
-    if (fOptionUseAND && !(*it).IsSelected(values)) {
-      return false;
+  if (fProgram.empty()) {
+    Compile();
+  }
+  int next = 0;
+  while (next >= 0) {
+    const Instruction& instruction = fProgram[next];
+    next = (instruction.fIsJump || AnalysisCut::PassesCut(instruction.fCut, values)) ? instruction.fOnTrue : instruction.fOnFalse;
+  }
+  return (next == kAccept);
+}
+
+//____________________________________________________________________________
+void AnalysisCompositeCut::Compile()
+{
+  //
+  // Compile the tree of cuts into a flat list of instructions with short-circuit jumps, as the recursive evaluation:
+  //   in an AND, a failed cut jumps to the failure of the node and a passed cut continues with the next one;
+  //   in an OR, a passed cut jumps to the success of the node and a failed cut continues with the next one.
+  // The jump targets are first labels, which are replaced by the instruction indices at the end.
+  // Since the cuts have no side effects, the cuts with constant limits are placed before the cuts with function limits.
+  //
+  fProgram.clear();
+  std::vector<int> labels;
+  CompileNode(*this, kAccept, kReject, labels);
+  for (auto& instruction : fProgram) {
+    if (instruction.fOnTrue >= 0) {
+      instruction.fOnTrue = labels[instruction.fOnTrue];
     }
-    if (!fOptionUseAND && (*it).IsSelected(values)) {
-      return true;
+    if (instruction.fOnFalse >= 0) {
+      instruction.fOnFalse = labels[instruction.fOnFalse];
     }
   }
+}
 
-  for (std::vector<AnalysisCompositeCut>::iterator it = fCompositeCutList.begin(); it < fCompositeCutList.end(); ++it) {
-    if (fOptionUseAND && !(*it).IsSelected(values)) {
-      return false;
+//____________________________________________________________________________
+void AnalysisCompositeCut::CompileNode(const AnalysisCompositeCut& node, int onTrue, int onFalse, std::vector<int>& labels)
+{
+  //
+  // emit the instructions of a composite cut; every node emits at least one instruction
+  //
+  std::vector<const AnalysisCut*> cuts;
+  for (const auto& cut : node.fCutList) {
+    cuts.push_back(&cut);
+  }
+  std::stable_partition(cuts.begin(), cuts.end(), [](const AnalysisCut* cut) {
+    return std::none_of(cut->GetCuts().begin(), cut->GetCuts().end(), [](const CutContainer& c) { return c.fFuncLow || c.fFuncHigh; });
+  });
+  const std::size_t nItems = cuts.size() + node.fCompositeCutList.size();
+  if (nItems == 0) {
+    AddInstruction(nullptr, node.fOptionUseAND ? onTrue : onFalse, onFalse);
+    return;
+  }
+
+  for (std::size_t i = 0; i < nItems; i++) {
+    const bool isLast = (i == nItems - 1);
+    int next = -1;
+    if (!isLast) {
+      next = labels.size();
+      labels.push_back(-1);
+    }
+    const int itemOnTrue = (node.fOptionUseAND && !isLast) ? next : onTrue;
+    const int itemOnFalse = (!node.fOptionUseAND && !isLast) ? next : onFalse;
+    if (i < cuts.size()) {
+      CompileCut(*cuts[i], itemOnTrue, itemOnFalse, labels);
+    } else {
+      CompileNode(node.fCompositeCutList[i - cuts.size()], itemOnTrue, itemOnFalse, labels);
     }
-    if (!fOptionUseAND && (*it).IsSelected(values)) {
-      return true;
+    if (!isLast) {
+      labels[next] = fProgram.size();
+    }
+  }
+}
+
+//____________________________________________________________________________
+void AnalysisCompositeCut::CompileCut(const AnalysisCut& cut, int onTrue, int onFalse, std::vector<int>& labels)
+{
+  //
+  // emit the instructions of a simple cut, i.e. the AND of its single cuts
+  //
+  const auto& containers = cut.GetCuts();
+  if (containers.empty()) {
+    AddInstruction(nullptr, onTrue, onFalse);
+    return;
+  }
+  for (std::size_t i = 0; i < containers.size(); i++) {
+    int next = onTrue;
+    if (i < containers.size() - 1) {
+      next = labels.size();
+      labels.push_back(fProgram.size() + 1);
     }
+    AddInstruction(&containers[i], next, onFalse);
   }
+}
 
-  if (fOptionUseAND) {
-    return true;
-  } else {
-    return false;
+//____________________________________________________________________________
+void AnalysisCompositeCut::AddInstruction(const CutContainer* cut, int onTrue, int onFalse)
+{
+  Instruction instruction = {};
+  if (cut) {
+    instruction.fCut = *cut;
   }
+  instruction.fIsJump = (cut == nullptr);
+  instruction.fOnTrue = onTrue;
+  instruction.fOnFalse = onFalse;
+  fProgram.push_back(instruction);
 }
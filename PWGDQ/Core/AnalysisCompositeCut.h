@@ -41,6 +41,7 @@ class AnalysisCompositeCut : public AnalysisCut
     } else {
       fCutList.push_back(*cut);
     }
+    fProgram.clear();
   };
 
   bool GetUseAND() const { return fOptionUseAND; }
@@ -48,11 +49,32 @@ class AnalysisCompositeCut : public AnalysisCut
 
   bool IsSelected(float* values) override;
 
+  // Compile the tree of cuts into a flat list of instructions, done at the first call of IsSelected
+  void Compile();
+
  protected:
   bool fOptionUseAND;                                  // true (default): apply AND on all cuts; false: use OR
   std::vector<AnalysisCut> fCutList;                   // list of cuts
   std::vector<AnalysisCompositeCut> fCompositeCutList; // list of composite cuts
 
+ private:
+  // Instruction of the compiled cut: one single cut (or an unconditional jump) and the next instruction
+  // depending on its decision. Negative targets are the final decisions (kAccept, kReject)
+  struct Instruction {
+    CutContainer fCut; // cut to be applied
+    bool fIsJump;      // if true, no cut is applied and the evaluation continues at fOnTrue
+    int fOnTrue;       // next instruction if the cut is passed
+    int fOnFalse;      // next instruction if the cut is failed
+  };
+  static constexpr int kAccept = -1;
+  static constexpr int kReject = -2;
+
+  std::vector<Instruction> fProgram; //! compiled cut, built from the lists above
+
+  void CompileNode(const AnalysisCompositeCut& node, int onTrue, int onFalse, std::vector<int>& labels);
+  void CompileCut(const AnalysisCut& cut, int onTrue, int onFalse, std::vector<int>& labels);
+  void AddInstruction(const CutContainer* cut, int onTrue, int onFalse);
+
   ClassDef(AnalysisCompositeCut, 2);
 };
 
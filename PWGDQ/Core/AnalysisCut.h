@@ -70,6 +70,10 @@ class AnalysisCut : public TNamed
     std::shared_ptr<TF1> fFuncHigh; // function for the upper limit cut
   };
 
+  // apply a single cut, true if the cut is passed or not applied because of the dependent variables
+  static bool PassesCut(const CutContainer& cut, const float* values);
+  const std::vector<CutContainer>& GetCuts() const { return fCuts; }
+
  protected:
   std::vector<CutContainer> fCuts;
 
@@ -131,50 +135,62 @@ void AnalysisCut::AddCut(int var, T1 cutLow, T2 cutHigh, bool exclude,
 }
 
 //____________________________________________________________________________
-inline bool AnalysisCut::IsSelected(float* values)
+inline bool AnalysisCut::PassesCut(const CutContainer& cut, const float* values)
 {
   //
-  // apply the configured cuts
+  // apply one cut
   //
-  // iterate over cuts
-  for (std::vector<CutContainer>::iterator it = fCuts.begin(); it != fCuts.end(); ++it) {
-    // check whether a dependent variables were enabled and if they are in the requested range
-    if ((*it).fDepVar != -1) {
-      bool inRange = (values[(*it).fDepVar] > (*it).fDepLow && values[(*it).fDepVar] <= (*it).fDepHigh);
-      if (!inRange && !((*it).fDepExclude)) {
-        continue;
-      }
-      if (inRange && (*it).fDepExclude) {
-        continue;
-      }
-    }
-    if ((*it).fDepVar2 != -1) {
-      bool inRange = (values[(*it).fDepVar2] > (*it).fDep2Low && values[(*it).fDepVar2] <= (*it).fDep2High);
-      if (!inRange && !((*it).fDep2Exclude)) {
-        continue;
-      }
-      if (inRange && (*it).fDep2Exclude) {
-        continue;
-      }
+  // check whether a dependent variables were enabled and if they are in the requested range
+  if (cut.fDepVar != -1) {
+    bool inRange = (values[cut.fDepVar] > cut.fDepLow && values[cut.fDepVar] <= cut.fDepHigh);
+    if (!inRange && !(cut.fDepExclude)) {
+      return true;
     }
-    // obtain the low and high cut values (either directly as a value or from a function)
-    float cutLow, cutHigh;
-    if ((*it).fFuncLow) {
-      cutLow = ((*it).fFuncLow)->Eval(values[(*it).fDepVar]);
-    } else {
-      cutLow = ((*it).fLow);
+    if (inRange && cut.fDepExclude) {
+      return true;
     }
-    if ((*it).fFuncHigh) {
-      cutHigh = ((*it).fFuncHigh)->Eval(values[(*it).fDepVar]);
-    } else {
-      cutHigh = ((*it).fHigh);
+  }
+  if (cut.fDepVar2 != -1) {
+    bool inRange = (values[cut.fDepVar2] > cut.fDep2Low && values[cut.fDepVar2] <= cut.fDep2High);
+    if (!inRange && !(cut.fDep2Exclude)) {
+      return true;
     }
-    // apply the cut and return the decision
-    bool inRange = (values[(*it).fVar] >= cutLow && values[(*it).fVar] <= cutHigh);
-    if (!inRange && !((*it).fExclude)) {
-      return false;
+    if (inRange && cut.fDep2Exclude) {
+      return true;
     }
-    if (inRange && ((*it).fExclude)) {
+  }
+  // obtain the low and high cut values (either directly as a value or from a function)
+  float cutLow, cutHigh;
+  if (cut.fFuncLow) {
+    cutLow = (cut.fFuncLow)->Eval(values[cut.fDepVar]);
+  } else {
+    cutLow = (cut.fLow);
+  }
+  if (cut.fFuncHigh) {
+    cutHigh = (cut.fFuncHigh)->Eval(values[cut.fDepVar]);
+  } else {
+    cutHigh = (cut.fHigh);
+  }
+  // apply the cut and return the decision
+  bool inRange = (values[cut.fVar] >= cutLow && values[cut.fVar] <= cutHigh);
+  if (!inRange && !(cut.fExclude)) {
+    return false;
+  }
+  if (inRange && (cut.fExclude)) {
+    return false;
+  }
+  return true;
+}
+
+//____________________________________________________________________________
+inline bool AnalysisCut::IsSelected(float* values)
+{
+  //
+  // apply the configured cuts
+  //
+  // iterate over cuts
+  for (const auto& cut : fCuts) {
+    if (!PassesCut(cut, values)) {
       return false;
     }
   }
@@ -34,10 +34,67 @@
 #include <memory>
 #include <numeric>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
+namespace o2::aod::dqcuts
+{
+AnalysisCompositeCut* BuildCompositeCut(const char* cutName);
+AnalysisCut* BuildAnalysisCut(const char* cutName);
+} // namespace o2::aod::dqcuts
+
+namespace
+{
+// Cuts already built, by name. Each cut of the library is built once and then copied, so that the cuts used as
+// ingredients of many other cuts (kinematics, track quality, PID) and the cuts requested by several tasks are not
+// looked up again through the long chains of name comparisons below
+std::unordered_map<std::string, std::unique_ptr<AnalysisCompositeCut>> gCompositeCutCache;
+std::unordered_map<std::string, std::unique_ptr<AnalysisCut>> gAnalysisCutCache;
+
+AnalysisCut* CloneCut(const AnalysisCut& cut)
+{
+  // some of the analysis cuts of the library are composite cuts
+  if (cut.IsA() == AnalysisCompositeCut::Class()) {
+    return new AnalysisCompositeCut(static_cast<const AnalysisCompositeCut&>(cut));
+  }
+  return new AnalysisCut(cut);
+}
+} // namespace
+
 AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
+{
+  //
+  // get a composite cut, built at the first request
+  //
+  auto it = gCompositeCutCache.find(cutName);
+  if (it == gCompositeCutCache.end()) {
+    AnalysisCompositeCut* cut = BuildCompositeCut(cutName);
+    if (!cut) {
+      return nullptr;
+    }
+    it = gCompositeCutCache.emplace(cutName, cut).first;
+  }
+  return new AnalysisCompositeCut(*(it->second));
+}
+
+AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+{
+  //
+  // get an analysis cut, built at the first request
+  //
+  auto it = gAnalysisCutCache.find(cutName);
+  if (it == gAnalysisCutCache.end()) {
+    AnalysisCut* cut = BuildAnalysisCut(cutName);
+    if (!cut) {
+      return nullptr;
+    }
+    it = gAnalysisCutCache.emplace(cutName, cut).first;
+  }
+  return CloneCut(*(it->second));
+}
+
+AnalysisCompositeCut* o2::aod::dqcuts::BuildCompositeCut(const char* cutName)
 {
   //
   // define composie cuts, typically combinations of all the ingredients needed for a full cut
@@ -3998,7 +4055,7 @@ AnalysisCompositeCut* o2::aod::dqcuts::GetCompositeCut(const char* cutName)
   return nullptr;
 }
 
-AnalysisCut* o2::aod::dqcuts::GetAnalysisCut(const char* cutName)
+AnalysisCut* o2::aod::dqcuts::BuildAnalysisCut(const char* cutName)
 {
   //
   // define here cuts which are likely to be used often
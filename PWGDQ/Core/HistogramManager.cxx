@@ -25,10 +25,11 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <iostream>
-#include <list>
 #include <memory>
+#include <string_view>
 #include <vector>
 using namespace std;
 
@@ -37,6 +38,7 @@ using namespace std;
 #include <THn.h>
 #include <THnSparse.h>
 #include <TIterator.h>
+#include <TList.h>
 #include <TObjArray.h>
 #include <TObject.h>
 #include <TProfile.h>
@@ -50,7 +52,8 @@ HistogramManager::HistogramManager() : TNamed("", ""),
                                        fMainList(nullptr),
                                        fNVars(0),
                                        fUsedVars(nullptr),
-                                       fVariablesMap(),
+                                       fClassHandles(),
+                                       fFillPlans(),
                                        fUseDefaultVariableNames(false),
                                        fBinsAllocated(0),
                                        fVariableNames(nullptr),
@@ -66,7 +69,8 @@ HistogramManager::HistogramManager(const char* name, const char* title, const in
                                                                                               fMainList(),
                                                                                               fNVars(maxNVars),
                                                                                               fUsedVars(),
-                                                                                              fVariablesMap(),
+                                                                                              fClassHandles(),
+                                                                                              fFillPlans(),
                                                                                               fUseDefaultVariableNames(kFALSE),
                                                                                               fBinsAllocated(0),
                                                                                               fVariableNames(),
@@ -109,22 +113,107 @@ void HistogramManager::SetDefaultVarNames(TString* vars, TString* units)
 };
 
 //__________________________________________________________________
-void HistogramManager::AddHistClass(const char* histClass)
+int HistogramManager::AddHistClass(const char* histClass)
 {
   //
-  // Add a new histogram list
+  // Add a new histogram list and return its handle
   //
   if (fMainList->FindObject(histClass)) {
     LOG(warn) << "HistogramManager::AddHistClass(): Cannot add histogram class " << histClass
               << " because it already exists.";
-    return;
+    return GetHistClassHandle(histClass);
   }
   auto* hList = new TList;
   hList->SetOwner(kTRUE);
   hList->SetName(histClass);
   fMainList->Add(hList);
-  std::list<std::vector<int>> varList;
-  fVariablesMap[histClass] = varList;
+  int handle = fFillPlans.size();
+  fFillPlans.emplace_back();
+  fClassHandles[histClass] = handle;
+  return handle;
+}
+
+//__________________________________________________________________
+int HistogramManager::GetHistClassHandle(const char* histClass) const
+{
+  //
+  // Get the handle of a histogram class
+  //
+  auto it = fClassHandles.find(std::string_view(histClass));
+  if (it == fClassHandles.end()) {
+    return kNothing;
+  }
+  return it->second;
+}
+
+//__________________________________________________________________
+void HistogramManager::AddToFillPlan(const char* histClass, const FillPlanEntry& entry)
+{
+  //
+  // Add the fill instruction of a new histogram to the fill plan of its class
+  // NOTE: the histograms are filled in the same order in which they were added
+  //
+  int handle = GetHistClassHandle(histClass);
+  if (handle == kNothing) {
+    LOG(fatal) << "HistogramManager::AddToFillPlan(): Histogram class " << histClass << " has no fill plan";
+    return;
+  }
+  fFillPlans[handle].push_back(entry);
+}
+
+//__________________________________________________________________
+void HistogramManager::AddToFillPlan(const char* histClass, TH1* h, bool isProfile, bool isFillLabelx,
+                                     int varX, int varY, int varZ, int varT, int varW)
+{
+  //
+  // Add the fill instruction of a new TH1, TH2, TH3 or profile to the fill plan of its class
+  // NOTE: the dimension of the histogram does not count the profiled variable
+  //
+  FillPlanEntry entry;
+  entry.fHist = h;
+  entry.fVarW = varW;
+  entry.fNVars = 4;
+  entry.fVars[0] = varX;
+  entry.fVars[1] = varY;
+  entry.fVars[2] = varZ;
+  entry.fVars[3] = varT;
+  switch (h->GetDimension()) {
+    case 1:
+      if (isProfile) {
+        entry.fKind = (isFillLabelx ? kFillTProfileLabelx : kFillTProfile);
+      } else {
+        entry.fKind = (isFillLabelx ? kFillTH1Labelx : kFillTH1);
+      }
+      break;
+    case 2:
+      if (isProfile) {
+        entry.fKind = kFillTProfile2D;
+      } else {
+        entry.fKind = (isFillLabelx ? kFillTH2Labelx : kFillTH2);
+      }
+      break;
+    default:
+      entry.fKind = (isProfile ? kFillTProfile3D : kFillTH3);
+      break;
+  }
+  AddToFillPlan(histClass, entry);
+}
+
+//__________________________________________________________________
+void HistogramManager::AddToFillPlan(const char* histClass, THnBase* h, int nDimensions, const int* vars, int varW)
+{
+  //
+  // Add the fill instruction of a new THn or THnSparse to the fill plan of its class
+  //
+  FillPlanEntry entry;
+  entry.fHistN = h;
+  entry.fKind = kFillTHn;
+  entry.fVarW = varW;
+  entry.fNVars = nDimensions;
+  for (int idim = 0; idim < nDimensions; ++idim) {
+    entry.fVars[idim] = vars[idim];
+  }
+  AddToFillPlan(histClass, entry);
 }
 
 //_________________________________________________________________
@@ -183,20 +272,6 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
     fUsedVars[varW] = kTRUE;
   }
 
-  // encode needed variable identifiers in a vector and push it to the std::list corresponding to the current histogram list
-  std::vector<int> varVector;
-  varVector.push_back(isProfile ? 1 : 0); // whether the histogram is a profile
-  varVector.push_back(0);                 // whether it is a THn
-  varVector.push_back(varW);              // variable used for weighting
-  varVector.push_back(varX);              // variables on each axis
-  varVector.push_back(varY);
-  varVector.push_back(varZ);
-  varVector.push_back(varT);                 // variable used for profiling in case of TProfile3D
-  varVector.push_back(isFillLabelx ? 1 : 0); // whether to fill with the x-axis labels
-  std::list varList = fVariablesMap[histClass];
-  varList.push_back(varVector);
-  fVariablesMap[histClass] = varList;
-
   // create and configure histograms according to required options
   TH1* h = nullptr;
   switch (dimension) {
@@ -335,6 +410,9 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
       hList->Add(h);
       break;
   } // end switch
+
+  // precompile the fill instruction of the histogram
+  AddToFillPlan(histClass, h, isProfile, isFillLabelx, varX, varY, varZ, varT, varW);
 }
 
 //_________________________________________________________________
@@ -393,20 +471,6 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   TString titleStr(title);
   std::unique_ptr<TObjArray> arr(titleStr.Tokenize(";"));
 
-  // encode needed variable identifiers in a vector and push it to the std::list corresponding to the current histogram list
-  std::vector<int> varVector;
-  varVector.push_back(isProfile ? 1 : 0); // whether the histogram is a profile
-  varVector.push_back(0);                 // whether it is a THn
-  varVector.push_back(varW);              // variable used for weighting
-  varVector.push_back(varX);              // variables on each axis
-  varVector.push_back(varY);
-  varVector.push_back(varZ);
-  varVector.push_back(varT);                 // variable used for profiling in case of TProfile3D
-  varVector.push_back(isFillLabelx ? 1 : 0); // whether to fill with the x-axis labels
-  std::list varList = fVariablesMap[histClass];
-  varList.push_back(varVector);
-  fVariablesMap[histClass] = varList;
-
   TH1* h = nullptr;
   switch (dimension) {
     case 1:
@@ -541,6 +605,9 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
       hList->Add(h);
       break;
   } // end switch(dimension)
+
+  // precompile the fill instruction of the histogram
+  AddToFillPlan(histClass, h, isProfile, isFillLabelx, varX, varY, varZ, varT, varW);
 }
 
 //_________________________________________________________________
@@ -580,17 +647,11 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
     }
   }
 
-  // encode needed variable identifiers in a vector and push it to the std::list corresponding to the current histogram list
-  std::vector<int> varVector;
-  varVector.push_back(0);           // whether the histogram is a profile
-  varVector.push_back(nDimensions); // number of dimensions
-  varVector.push_back(varW);        // variable used for weighting
-  for (int idim = 0; idim < nDimensions; ++idim) {
-    varVector.push_back(vars[idim]); // axes variables
+  if (nDimensions > kMaxTHnDimensions) {
+    LOG(fatal) << "HistogramManager::AddHistogram(): Histogram " << hname << " has " << nDimensions
+               << " dimensions, at most " << kMaxTHnDimensions << " are supported";
+    return;
   }
-  std::list varList = fVariablesMap[histClass];
-  varList.push_back(varVector);
-  fVariablesMap[histClass] = varList;
 
   uint32_t nbins = 1;
   THnBase* h = nullptr;
@@ -641,6 +702,9 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
   }
 
   fBinsAllocated += nbins;
+
+  // precompile the fill instruction of the histogram
+  AddToFillPlan(histClass, h, nDimensions, vars, varW);
 }
 
 //_________________________________________________________________
@@ -673,17 +737,11 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
     fUsedVars[varW] = kTRUE;
   }
 
-  // encode needed variable identifiers in a vector and push it to the std::list corresponding to the current histogram list
-  std::vector<int> varVector;
-  varVector.push_back(0);           // whether the histogram is a profile
-  varVector.push_back(nDimensions); // number of dimensions
-  varVector.push_back(varW);        // variable used for weighting
-  for (int idim = 0; idim < nDimensions; ++idim) {
-    varVector.push_back(vars[idim]); // axes variables
+  if (nDimensions > kMaxTHnDimensions) {
+    LOG(fatal) << "HistogramManager::AddHistogram(): Histogram " << hname << " has " << nDimensions
+               << " dimensions, at most " << kMaxTHnDimensions << " are supported";
+    return;
   }
-  std::list varList = fVariablesMap[histClass];
-  varList.push_back(varVector);
-  fVariablesMap[histClass] = varList;
 
   // get the min and max for each axis
   auto* xmin = new double[nDimensions];
@@ -747,6 +805,9 @@ void HistogramManager::AddHistogram(const char* histClass, const char* hname, co
     }
   }
   fBinsAllocated += bins;
+
+  // precompile the fill instruction of the histogram
+  AddToFillPlan(histClass, h, nDimensions, vars, varW);
 }
 
 //__________________________________________________________________
@@ -755,153 +816,143 @@ void HistogramManager::FillHistClass(const char* className, Float_t* values)
   //
   //  fill a class of histograms
   //
-
-  // get the needed histogram list
-  auto* hList = reinterpret_cast<TList*>(fMainList->FindObject(className));
-  if (!hList) {
+  int handle = GetHistClassHandle(className);
+  if (handle == kNothing) {
     // TODO: add some meaningfull error message
     /*LOG(warn) << "HistogramManager::FillHistClass(): Histogram list " << className << " not found!";
     LOG(warn) << "         Histogram list not filled" << endl; */
     return;
   }
+  FillHistClass(handle, values);
+}
 
-  // get the corresponding std::list containng identifiers to the needed variables to be filled
-  auto const& varList = fVariablesMap[className];
-
-  TIter next(hList);
-
-  TObject* h = nullptr;
-  bool isProfile;
-  bool isTHn;
-  int dimension = 0;
-  bool isSparse = kFALSE;
-  bool isFillLabelx = kFALSE;
-  // TODO: At the moment, maximum 20 dimensions are foreseen for the THn histograms. We should make this more dynamic
-  //       But maybe its better to have it like to avoid dynamically allocating this array in the histogram loop
-  double fillValues[20] = {0.0};
-  int varX = -1, varY = -1, varZ = -1, varT = -1, varW = -1;
-
-  // loop over the histogram and std::list
-  // NOTE: these two should contain the same number of elements and be synchronized, otherwise its a mess
-  for (auto varIter = varList.begin(); varIter != varList.end(); varIter++) {
-    h = next(); // get the histogram
-    // decode information from the vector of indices
-    isProfile = ((*varIter)[0] == 1 ? true : false);
-    isTHn = ((*varIter)[1] > 0 ? true : false);
-    if (isTHn) {
-      dimension = (*varIter)[1];
-    } else {
-      dimension = (reinterpret_cast<TH1*>(h))->GetDimension();
-    }
-
-    // get the various variable indices
-    varW = (*varIter)[2];
-    if (isTHn) {
-      for (int i = 0; i < dimension; i++) {
-        fillValues[i] = values[(*varIter)[3 + i]];
-      }
-    } else {
-      varX = (*varIter)[3];
-      varY = (*varIter)[4];
-      varZ = (*varIter)[5];
-      varT = (*varIter)[6];
-      isFillLabelx = ((*varIter)[7] == 1 ? true : false);
-    }
-
-    if (!isTHn) {
-      switch (dimension) {
-        case 1:
-          if (isProfile) {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TProfile*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY]);
-              } else {
-                (reinterpret_cast<TProfile*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varW]);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH1*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), 1.);
-              } else {
-                (reinterpret_cast<TH1*>(h))->Fill(values[varX]);
-              }
-            }
-          }
-          break;
-        case 2:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile2D*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          } else {
-            if (varW > kNothing) {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], values[varW]);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY], values[varW]);
-              }
-            } else {
-              if (isFillLabelx) {
-                (reinterpret_cast<TH2*>(h))->Fill(Form("%d", static_cast<int>(values[varX])), values[varY], 1.);
-              } else {
-                (reinterpret_cast<TH2*>(h))->Fill(values[varX], values[varY]);
-              }
-            }
-          }
-          break;
-        case 3:
-          if (isProfile) {
-            if (varW > kNothing) {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT], values[varW]);
-            } else {
-              (reinterpret_cast<TProfile3D*>(h))->Fill(values[varX], values[varY], values[varZ], values[varT]);
-            }
-          } else {
-            if (varW > kNothing) {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ], values[varW]);
-            } else {
-              (reinterpret_cast<TH3*>(h))->Fill(values[varX], values[varY], values[varZ]);
-            }
-          }
-          break;
+//__________________________________________________________________
+void HistogramManager::FillHistClass(int classHandle, Float_t* values)
+{
+  //
+  //  fill a class of histograms, following its precompiled fill plan
+  //
+  if (classHandle < 0 || classHandle >= static_cast<int>(fFillPlans.size())) {
+    return;
+  }
 
-        default:
-          break;
-      } // end switch
-      // end if(!isTHn)
-    } else {
-      if (varW > kNothing) {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues, values[varW]);
+  double fillValues[kMaxTHnDimensions] = {0.0};
+  for (auto const& entry : fFillPlans[classHandle]) {
+    const int* vars = entry.fVars;
+    const int varW = entry.fVarW;
+    switch (entry.fKind) {
+      case kFillTH1:
+        if (varW > kNothing) {
+          entry.fHist->Fill(values[vars[0]], values[varW]);
         } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues, values[varW]);
+          entry.fHist->Fill(values[vars[0]]);
         }
-      } else {
-        if (isSparse) {
-          (reinterpret_cast<THnSparse*>(h))->Fill(fillValues);
+        break;
+      case kFillTH1Labelx:
+        entry.fHist->Fill(Form("%d", static_cast<int>(values[vars[0]])), (varW > kNothing ? values[varW] : 1.));
+        break;
+      case kFillTProfile:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[varW]);
         } else {
-          (reinterpret_cast<THn*>(h))->Fill(fillValues);
+          (reinterpret_cast<TProfile*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]]);
         }
-      }
-    } // end else
+        break;
+      case kFillTProfileLabelx:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile*>(entry.fHist))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile*>(entry.fHist))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]]);
+        }
+        break;
+      case kFillTH2:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH2*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[varW]);
+        } else {
+          (reinterpret_cast<TH2*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]]);
+        }
+        break;
+      case kFillTH2Labelx:
+        (reinterpret_cast<TH2*>(entry.fHist))->Fill(Form("%d", static_cast<int>(values[vars[0]])), values[vars[1]], (varW > kNothing ? values[varW] : 1.));
+        break;
+      case kFillTProfile2D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile2D*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile2D*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillTH3:
+        if (varW > kNothing) {
+          (reinterpret_cast<TH3*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[varW]);
+        } else {
+          (reinterpret_cast<TH3*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]]);
+        }
+        break;
+      case kFillTProfile3D:
+        if (varW > kNothing) {
+          (reinterpret_cast<TProfile3D*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]], values[varW]);
+        } else {
+          (reinterpret_cast<TProfile3D*>(entry.fHist))->Fill(values[vars[0]], values[vars[1]], values[vars[2]], values[vars[3]]);
+        }
+        break;
+      case kFillTHn:
+        for (int i = 0; i < entry.fNVars; i++) {
+          fillValues[i] = values[vars[i]];
+        }
+        if (varW > kNothing) {
+          entry.fHistN->Fill(fillValues, values[varW]);
+        } else {
+          entry.fHistN->Fill(fillValues);
+        }
+        break;
+      default:
+        break;
+    } // end switch
   } // end loop over histograms
 }
 
+//__________________________________________________________________
+void HistogramManager::MergeAndReset(HistogramManager& other)
+{
+  //
+  // add the histograms of another manager, defined in the same order as the ones of this manager, and reset them
+  // NOTE: the histograms are merged, so that the alphanumeric bins filled via labels are matched by label
+  //
+  if (other.fFillPlans.size() != fFillPlans.size()) {
+    LOG(fatal) << "HistogramManager::MergeAndReset(): " << other.GetName() << " has " << other.fFillPlans.size()
+               << " histogram classes instead of " << fFillPlans.size();
+    return;
+  }
+  for (std::size_t handle = 0; handle < fFillPlans.size(); ++handle) {
+    if (other.fFillPlans[handle].size() != fFillPlans[handle].size()) {
+      LOG(fatal) << "HistogramManager::MergeAndReset(): the histograms of class " << handle << " of " << other.GetName()
+                 << " are not defined as the ones of " << GetName();
+      return;
+    }
+    for (std::size_t i = 0; i < fFillPlans[handle].size(); ++i) {
+      auto const& entry = fFillPlans[handle][i];
+      auto const& otherEntry = other.fFillPlans[handle][i];
+      TList list;
+      if (entry.fKind == kFillTHn) {
+        if (otherEntry.fHistN->GetEntries() == 0) {
+          continue;
+        }
+        list.Add(otherEntry.fHistN);
+        entry.fHistN->Merge(&list);
+        otherEntry.fHistN->Reset();
+      } else {
+        if (otherEntry.fHist->GetEntries() == 0) {
+          continue;
+        }
+        list.Add(otherEntry.fHist);
+        entry.fHist->Merge(&list);
+        otherEntry.fHist->Reset();
+      }
+    }
+  }
+}
+
 //____________________________________________________________________________________
 void HistogramManager::MakeAxisLabels(TAxis* ax, const char* labels)
 {
@@ -27,11 +27,14 @@
 #include <RtypesCore.h>
 
 #include <cstdint>
-#include <list>
+#include <functional>
 #include <map>
 #include <string>
 #include <vector>
 
+class TH1;
+class THnBase;
+
 class HistogramManager : public TNamed
 {
 
@@ -41,7 +44,8 @@ class HistogramManager : public TNamed
   ~HistogramManager() override;
 
   enum Constants {
-    kNothing = -1
+    kNothing = -1,
+    kMaxTHnDimensions = 20 // maximum number of dimensions of the THn histograms
   };
 
   void SetMainHistogramList(THashList* list)
@@ -50,10 +54,16 @@ class HistogramManager : public TNamed
       delete fMainList;
     }
     fMainList = list;
+    // the fill plans refer to the histograms of the old list
+    fClassHandles.clear();
+    fFillPlans.clear();
   }
 
-  // Create a new histogram class
-  void AddHistClass(const char* histClass);
+  // Create a new histogram class and return its handle, which can be used to fill the class without looking it up by name
+  // If the class already exists, its handle is returned
+  int AddHistClass(const char* histClass);
+  // Get the handle of an existing histogram class, kNothing if the class does not exist
+  int GetHistClassHandle(const char* histClass) const;
   // Create a new histogram in the class <histClass> with name <name> and title <title>
   // The type of histogram is deduced from the parameters specified by the user
   // The binning for at least one dimension needs to be specified, namely: nXbins, xmin, xmax, varX which will result in a TH1F histogram
@@ -88,6 +98,11 @@ class HistogramManager : public TNamed
                     TString* axLabels = nullptr, int varW = -1, bool useSparse = kFALSE, bool isdouble = false);
 
   void FillHistClass(const char* className, float* values);
+  // Fill a class of histograms using its handle, as returned by AddHistClass() or GetHistClassHandle()
+  void FillHistClass(int classHandle, float* values);
+  // Add the histograms of another manager, with the same histogram definitions (e.g. a shard filled by another thread),
+  // and reset them
+  void MergeAndReset(HistogramManager& other);
 
   void SetUseDefaultVariableNames(bool flag) { fUseDefaultVariableNames = flag; }
   void SetDefaultVarNames(TString* vars, TString* units);
@@ -102,8 +117,33 @@ class HistogramManager : public TNamed
   THashList* fMainList; // master histogram list
   int fNVars;           // number of variables handled (tipically from the Variable Manager)
 
-  bool* fUsedVars;                                                  //! flags of used variables
-  std::map<std::string, std::list<std::vector<int>>> fVariablesMap; //!  map holding identifiers for all variables needed by histograms
+  // how a histogram is filled, decoded once when the histogram is added
+  enum FillKinds {
+    kFillTH1 = 0,
+    kFillTH1Labelx,
+    kFillTProfile,
+    kFillTProfileLabelx,
+    kFillTH2,
+    kFillTH2Labelx,
+    kFillTProfile2D,
+    kFillTH3,
+    kFillTProfile3D,
+    kFillTHn
+  };
+
+  // precompiled fill instruction of one histogram
+  struct FillPlanEntry {
+    TH1* fHist = nullptr;         // histogram, for all kinds except THn
+    THnBase* fHistN = nullptr;    // histogram, for THn and THnSparse
+    int fKind = kFillTH1;         // fill kind, see FillKinds
+    int fVarW = kNothing;         // variable used for weighting
+    int fNVars = 0;               // number of variables in fVars
+    int fVars[kMaxTHnDimensions]; // variables on each axis (x, y, z, t for the TH1, TH2, TH3 and profiles)
+  };
+
+  bool* fUsedVars;                                       //! flags of used variables
+  std::map<std::string, int, std::less<>> fClassHandles; //! handle of each histogram class
+  std::vector<std::vector<FillPlanEntry>> fFillPlans;    //! fill instructions for the histograms of each class, indexed by the class handle
 
   // various
   bool fUseDefaultVariableNames; //! toggle the usage of default variable names and units
@@ -112,6 +152,9 @@ class HistogramManager : public TNamed
   TString* fVariableUnits;       //! variable units
 
   void MakeAxisLabels(TAxis* ax, const char* labels);
+  void AddToFillPlan(const char* histClass, const FillPlanEntry& entry);
+  void AddToFillPlan(const char* histClass, TH1* h, bool isProfile, bool isFillLabelx, int varX, int varY, int varZ, int varT, int varW);
+  void AddToFillPlan(const char* histClass, THnBase* h, int nDimensions, const int* vars, int varW);
 
   HistogramManager& operator=(const HistogramManager& c);
   HistogramManager(const HistogramManager& c);
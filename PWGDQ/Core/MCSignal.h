@@ -61,6 +61,7 @@ process(aod::McParticles const& mcTracks) {
 #include <TNamed.h>
 
 #include <cstdint>
+#include <unordered_map>
 #include <vector>
 
 class MCSignal : public TNamed
@@ -119,7 +120,27 @@ class MCSignal : public TNamed
 
   void PrintConfig();
 
+  // Cache of the prong decisions per MC particle, so that a particle entering many tuples is checked only once per prong.
+  // The particles are identified by their global index, so the cache must be reset whenever the MC particle table
+  // changes (e.g. at each data frame) and all the checks done with the same table in between
+  void SetUseCache(bool useCache = true)
+  {
+    fUseCache = useCache;
+    ResetCache();
+  }
+  void ResetCache()
+  {
+    fProngCache.assign(fNProngs, {});
+  }
+
  private:
+  // decision of a prong for one MC particle, without the comparison to the common ancestor of the first prong
+  struct ProngDecision {
+    bool fPassed = false;          // all the requirements of the prong are fulfilled
+    bool fAncestorReached = false; // the generation of the common ancestor was reached
+    int fAncestorLabel = -1;       // global index of the common ancestor
+  };
+
   std::vector<MCProng> fProngs;            // vector of MCProng
   unsigned int fNProngs;                   // number of prongs
   std::vector<int8_t> fCommonAncestorIdxs; // index of the most recent ancestor, relative to each prong's history
@@ -128,9 +149,13 @@ class MCSignal : public TNamed
   bool fDecayChannelIsNotExclusive;        // if true, then the indicated mother particle has a number of daughters which is larger than the number of direct prongs defined in this MC signal
   int fNAncestorDirectProngs;              // number of direct prongs belonging to the common ancestor specified by this signal
   int fTempAncestorLabel;
+  bool fUseCache = false;                                              // use the cache of the prong decisions
+  std::vector<std::unordered_map<int64_t, ProngDecision>> fProngCache; //! prong decisions per prong, key: 2 * global index + checkSources
 
   template <typename T>
   bool CheckProng(int i, bool checkSources, const T& track);
+  template <typename T>
+  ProngDecision EvaluateProng(int i, bool checkSources, const T& track);
 
   bool CheckMC(int, bool)
   {
@@ -151,37 +176,65 @@ class MCSignal : public TNamed
 
 template <typename T>
 bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
+{
+  ProngDecision decision;
+  if (fUseCache) {
+    if (fProngCache.size() != fNProngs) {
+      ResetCache();
+    }
+    auto [it, isNew] = fProngCache[i].try_emplace(2 * static_cast<int64_t>(track.globalIndex()) + checkSources);
+    if (isNew) {
+      it->second = EvaluateProng(i, checkSources, track);
+    }
+    decision = it->second;
+  } else {
+    decision = EvaluateProng(i, checkSources, track);
+  }
+
+  // check the common ancestor (if specified)
+  if (decision.fAncestorReached) {
+    if (i == 0) {
+      fTempAncestorLabel = decision.fAncestorLabel;
+    } else {
+      if (decision.fAncestorLabel != fTempAncestorLabel && !fExcludeCommonAncestor)
+        return false;
+      else if (decision.fAncestorLabel == fTempAncestorLabel && fExcludeCommonAncestor)
+        return false;
+    }
+  }
+  return decision.fPassed;
+}
+
+template <typename T>
+MCSignal::ProngDecision MCSignal::EvaluateProng(int i, bool checkSources, const T& track)
 {
   using P = typename T::parent_t;
   auto currentMCParticle = track;
+  ProngDecision decision;
 
   // loop over the generations specified for this prong
   for (int j = 0; j < fProngs[i].fNGenerations; j++) {
     // check the PDG code
     if (!fProngs[i].TestPDG(j, currentMCParticle.pdgCode())) {
-      return false;
+      return decision;
     }
-    // check the common ancestor (if specified)
+    // record the common ancestor (if specified), compared to the one of the first prong in CheckProng
     if (fNProngs > 1 && fCommonAncestorIdxs[i] == j) {
+      decision.fAncestorReached = true;
+      decision.fAncestorLabel = currentMCParticle.globalIndex();
       if (i == 0) {
-        fTempAncestorLabel = currentMCParticle.globalIndex();
         // In the case of decay channels marked as being "exclusive", check how many decay daughters this mother has registered
         //   in the stack and compare to the number of prongs defined for this MCSignal.
         //  If these numbers are equal, it means this decay MCSignal match is exclusive (there are no additional prongs for this mother besides the
         //     prongs defined here).
         if (currentMCParticle.has_daughters()) {
           if (fDecayChannelIsExclusive && currentMCParticle.daughtersIds()[1] - currentMCParticle.daughtersIds()[0] + 1 != fNAncestorDirectProngs) {
-            return false;
+            return decision;
           }
           if (fDecayChannelIsNotExclusive && currentMCParticle.daughtersIds()[1] - currentMCParticle.daughtersIds()[0] + 1 == fNAncestorDirectProngs) {
-            return false;
+            return decision;
           }
         }
-      } else {
-        if (currentMCParticle.globalIndex() != fTempAncestorLabel && !fExcludeCommonAncestor)
-          return false;
-        else if (currentMCParticle.globalIndex() == fTempAncestorLabel && fExcludeCommonAncestor)
-          return false;
       }
     }
 
@@ -190,7 +243,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
     if (!fProngs[i].fCheckGenerationsInTime) {
       // make sure that a mother exists in the stack before moving one generation further in history
       if (!currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
-        return false;
+        return decision;
       }
       if (currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
         currentMCParticle = currentMCParticle.template mothers_first_as<P>();
@@ -198,7 +251,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
     } else {
       // make sure that a daughter exists in the stack before moving one generation younger
       if (!currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
-        return false;
+        return decision;
       }
       if (currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
         const auto& daughtersSlice = currentMCParticle.template daughters_as<P>();
@@ -263,11 +316,11 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
       } // end if(hasSources)
       // no source bit is fulfilled
       if (hasSources && !sourcesDecision) {
-        return false;
+        return decision;
       }
       // if fUseANDonSourceBitMap is on, request all bits
       if (hasSources && (fProngs[i].fUseANDonSourceBitMap[j] && (sourcesDecision != fProngs[i].fSourceBits[j]))) {
-        return false;
+        return decision;
       }
 
       // Update the currentMCParticle by moving either back in time (towards mothers, grandmothers, etc)
@@ -275,7 +328,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
       if (!fProngs[i].fCheckGenerationsInTime) {
         // make sure that a mother exists in the stack before moving one generation further in history
         if (!currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
-          return false;
+          return decision;
         }
         if (currentMCParticle.has_mothers() && j < fProngs[i].fNGenerations - 1) {
           currentMCParticle = currentMCParticle.template mothers_first_as<P>();
@@ -284,7 +337,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
         // prong history will be moved to the branch of the first daughter that matches the PDG requirement
         // make sure that a daughter exists in the stack before moving one generation younger
         if (!currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
-          return false;
+          return decision;
         }
         if (currentMCParticle.has_daughters() && j < fProngs[i].fNGenerations - 1) {
           const auto& daughtersSlice = currentMCParticle.template daughters_as<P>();
@@ -300,7 +353,8 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
   } // end if(checkSources)
 
   if (fProngs[i].fPDGInHistory.size() == 0) {
-    return true;
+    decision.fPassed = true;
+    return decision;
   } else { // check if mother pdg is in history
     std::vector<int> pdgInHistory;
 
@@ -323,7 +377,7 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
             break;
           }
           if (fProngs[i].fExcludePDGInHistory[k] && !fProngs[i].ComparePDG(mother.pdgCode(), fProngs[i].fPDGInHistory[k], true, fProngs[i].fExcludePDGInHistory[k])) {
-            return false;
+            return decision;
           }
           ith++;
           currentMCParticle = mother;
@@ -352,10 +406,11 @@ bool MCSignal::CheckProng(int i, bool checkSources, const T& track)
       }*/
     }
     if (pdgInHistory.size() != nIncludedPDG) { // vector has as many entries as mothers (daughters) defined for prong
-      return false;
+      return decision;
     }
   }
-  return true;
+  decision.fPassed = true;
+  return decision;
 }
 
 #endif // PWGDQ_CORE_MCSIGNAL_H_
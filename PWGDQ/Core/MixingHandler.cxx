@@ -28,6 +28,7 @@ ClassImp(MixingHandler);
 //_________________________________________________________________________
 MixingHandler::MixingHandler() : TNamed(),
                                  fIsInitialized(kFALSE),
+                                 fNCategories(0),
                                  fVariableLimits(),
                                  fVariables()
 {
@@ -39,6 +40,7 @@ MixingHandler::MixingHandler() : TNamed(),
 //_________________________________________________________________________
 MixingHandler::MixingHandler(const char* name, const char* title) : TNamed(name, title),
                                                                     fIsInitialized(kFALSE),
+                                                                    fNCategories(0),
                                                                     fVariableLimits(),
                                                                     fVariables()
 {
@@ -118,10 +120,22 @@ void MixingHandler::Init()
   for (auto v : fVariableLimits) {
     size *= (v.GetSize() - 1);
   }
-  (void)size;
+  fNCategories = fVariableLimits.empty() ? 0 : size;
   fIsInitialized = kTRUE;
 }
 
+//_________________________________________________________________________
+int MixingHandler::GetNCategories()
+{
+  //
+  // Number of event categories, i.e. of pools needed to store the events of all the categories
+  //
+  if (!fIsInitialized) {
+    Init();
+  }
+  return fNCategories;
+}
+
 //_________________________________________________________________________
 int MixingHandler::FindEventCategory(float* values)
 {
@@ -45,6 +45,7 @@ class MixingHandler : public TNamed
 
   void Init();
   int FindEventCategory(float* values);
+  int GetNCategories(); // categories returned by FindEventCategory are in [0, GetNCategories())
   int GetBinFromCategory(VarManager::Variables var, int category) const;
 
  private:
@@ -53,11 +54,12 @@ class MixingHandler : public TNamed
 
   // User options
   bool fIsInitialized; // check if the mixing handler is initialized
+  int fNCategories;    // number of event categories
 
   std::vector<TArrayF> fVariableLimits;
   std::vector<int> fVariables;
 
-  ClassDef(MixingHandler, 1);
+  ClassDef(MixingHandler, 2);
 };
 
 #endif // PWGDQ_CORE_MIXINGHANDLER_H_
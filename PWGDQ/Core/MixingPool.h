@@ -0,0 +1,139 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+/// \file MixingPool.h
+/// \brief Pool of events for the event mixing, kept across data frames
+//
+// The selected leptons of the most recent events of each mixing category (e.g. the hash from the MixingHandler)
+// are kept as slim records, so that each event can be mixed with a fixed number of events of its category,
+// independently of the size of the data frames, and without going again through the track tables.
+// The records provide the getters used by the VarManager mixed-event fill functions and by the pairing tasks.
+
+#ifndef PWGDQ_CORE_MIXINGPOOL_H_
+#define PWGDQ_CORE_MIXINGPOOL_H_
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Lepton kept in the mixing pool
+class MixingPoolLepton
+{
+ public:
+  template <typename T>
+  MixingPoolLepton(T const& track, uint32_t filter) : fPt(track.pt()),
+                                                      fEta(track.eta()),
+                                                      fPhi(track.phi()),
+                                                      fSign(track.sign()),
+                                                      fFilter(filter)
+  {
+    if constexpr (requires { track.fwdDcaX(); }) {
+      fFwdDcaX = track.fwdDcaX();
+      fFwdDcaY = track.fwdDcaY();
+      fChi2 = track.chi2();
+      fChi2MatchMCHMID = track.chi2MatchMCHMID();
+      fChi2MatchMCHMFT = track.chi2MatchMCHMFT();
+      fMatchMCHTrackId = track.matchMCHTrackId();
+      fMatchMFTTrackId = track.matchMFTTrackId();
+      fAmbiguityInBunch = track.muonAmbiguityInBunch();
+      fAmbiguityOutOfBunch = track.muonAmbiguityOutOfBunch();
+    }
+  }
+
+  float pt() const { return fPt; }
+  float eta() const { return fEta; }
+  float phi() const { return fPhi; }
+  int sign() const { return fSign; }
+  uint32_t filter() const { return fFilter; }
+
+  // muons only
+  float fwdDcaX() const { return fFwdDcaX; }
+  float fwdDcaY() const { return fFwdDcaY; }
+  float chi2() const { return fChi2; }
+  float chi2MatchMCHMID() const { return fChi2MatchMCHMID; }
+  float chi2MatchMCHMFT() const { return fChi2MatchMCHMFT; }
+  int matchMCHTrackId() const { return fMatchMCHTrackId; }
+  int matchMFTTrackId() const { return fMatchMFTTrackId; }
+  int muonAmbiguityInBunch() const { return fAmbiguityInBunch; }
+  int muonAmbiguityOutOfBunch() const { return fAmbiguityOutOfBunch; }
+
+ private:
+  float fPt = 0.f;              // transverse momentum
+  float fEta = 0.f;             // pseudorapidity
+  float fPhi = 0.f;             // azimuth
+  int fSign = 0;                // charge
+  uint32_t fFilter = 0;         // cuts passed by the lepton, restricted to the cuts of the pairing
+  float fFwdDcaX = 0.f;         // DCA x of the muon
+  float fFwdDcaY = 0.f;         // DCA y of the muon
+  float fChi2 = 0.f;            // chi2 of the muon track
+  float fChi2MatchMCHMID = 0.f; // chi2 of the MCH-MID matching
+  float fChi2MatchMCHMFT = 0.f; // chi2 of the MCH-MFT matching
+  int fMatchMCHTrackId = -1;    // index of the matched MCH track, only meaningful in the data frame of the muon
+  int fMatchMFTTrackId = -1;    // index of the matched MFT track, only meaningful in the data frame of the muon
+  int fAmbiguityInBunch = 0;    // number of in-bunch collisions the muon is associated to
+  int fAmbiguityOutOfBunch = 0; // number of out-of-bunch collisions the muon is associated to
+};
+
+// Event kept in the mixing pool, with its selected leptons
+class MixingPoolEvent
+{
+ public:
+  MixingPoolEvent(int64_t dataFrame, std::vector<MixingPoolLepton>&& leptons) : fDataFrame(dataFrame),
+                                                                                fLeptons(std::move(leptons))
+  {
+  }
+
+  int64_t getDataFrame() const { return fDataFrame; }
+  std::vector<MixingPoolLepton> const& getLeptons() const { return fLeptons; }
+
+ private:
+  int64_t fDataFrame = 0;                 // data frame of the event
+  std::vector<MixingPoolLepton> fLeptons; // selected leptons of the event
+};
+
+// Pool of the most recent events of each mixing category
+class MixingPool
+{
+ public:
+  // depth: maximum number of events kept per category
+  void init(int depth) { fDepth = depth; }
+
+  // to be called at the beginning of each data frame
+  void newDataFrame() { fDataFrame++; }
+  int64_t getDataFrame() const { return fDataFrame; }
+
+  // events of a category, most recent first
+  std::deque<MixingPoolEvent> const& getEvents(int category) { return fEvents[category]; }
+
+  // add an event to a category, the oldest event of the category is dropped if it is full
+  void push(int category, std::vector<MixingPoolLepton>&& leptons)
+  {
+    if (fDepth <= 0) {
+      return;
+    }
+    auto& events = fEvents[category];
+    events.emplace_front(fDataFrame, std::move(leptons));
+    if (static_cast<int>(events.size()) > fDepth) {
+      events.pop_back();
+    }
+  }
+
+  void clear() { fEvents.clear(); }
+
+ private:
+  int fDepth = 0;                                               // maximum number of events per category
+  int64_t fDataFrame = 0;                                       // current data frame
+  std::unordered_map<int, std::deque<MixingPoolEvent>> fEvents; // events per category
+};
+
+#endif // PWGDQ_CORE_MIXINGPOOL_H_
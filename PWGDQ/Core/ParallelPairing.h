@@ -0,0 +1,102 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+//
+/// \file ParallelPairing.h
+/// \brief Tools to share the collisions of a data frame among threads in the pairing tasks
+//
+// The collisions are paired by several threads, each one with its own VarManager::Context and histogram manager.
+// What depends on the collision order (the rows of the output tables, the bookkeeping done over the data frame)
+// is kept as OrderedActions, one per collision, which are run by the calling thread once all the collisions are paired,
+// so that the output is the same as the one of the serial pairing.
+
+#ifndef PWGDQ_CORE_PARALLELPAIRING_H_
+#define PWGDQ_CORE_PARALLELPAIRING_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <utility>
+#include <vector>
+
+namespace dqpairing
+{
+
+// Actions of the pairing of one collision which must run in collision order
+// The actions are run immediately, unless they are deferred, in which case they are run by Run()
+class OrderedActions
+{
+ public:
+  explicit OrderedActions(bool deferred = false) : fDeferred(deferred) {}
+
+  bool IsDeferred() const { return fDeferred; }
+
+  // write a row with a table cursor, the arguments being evaluated at the call
+  template <typename TCursor, typename... TArgs>
+  void WriteRow(TCursor& cursor, TArgs... args)
+  {
+    if (!fDeferred) {
+      cursor(args...);
+      return;
+    }
+    fActions.emplace_back([&cursor, args...]() { cursor(args...); });
+  }
+
+  // run an action on the values array, or on a copy of its first nValues values if deferred
+  template <typename TAction>
+  void RunWithValues(float* values, int nValues, TAction action)
+  {
+    if (!fDeferred) {
+      action(values);
+      return;
+    }
+    fActions.emplace_back([action, valuesCopy = std::vector<float>(values, values + nValues)]() mutable { action(valuesCopy.data()); });
+  }
+
+  // run the deferred actions, in the order in which they were added
+  void Run()
+  {
+    for (auto& action : fActions) {
+      action();
+    }
+    fActions.clear();
+  }
+
+ private:
+  bool fDeferred;                              // keep the actions until Run() is called
+  std::vector<std::function<void()>> fActions; // deferred actions
+};
+
+// Run task(item, worker) for all the items in [0, nItems) on nWorkers threads, the calling thread being worker 0
+// The items are taken in increasing order by the first free worker
+inline void RunOnWorkers(std::size_t nItems, int nWorkers, const std::function<void(std::size_t, int)>& task)
+{
+  std::atomic<std::size_t> nextItem{0};
+  auto worker = [&](int iWorker) {
+    for (std::size_t iItem = nextItem++; iItem < nItems; iItem = nextItem++) {
+      task(iItem, iWorker);
+    }
+  };
+  std::vector<std::future<void>> workers;
+  nWorkers = std::clamp(nWorkers, 1, static_cast<int>(std::max<std::size_t>(nItems, 1)));
+  for (int iWorker = 1; iWorker < nWorkers; ++iWorker) {
+    workers.push_back(std::async(std::launch::async, worker, iWorker));
+  }
+  worker(0);
+  for (auto& result : workers) {
+    result.get();
+  }
+}
+
+} // namespace dqpairing
+
+#endif // PWGDQ_CORE_PARALLELPAIRING_H_
@@ -33,9 +33,11 @@
 #include <Rtypes.h>
 #include <RtypesCore.h>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <iterator>
 #include <map>
 #include <numeric>
 #include <tuple>
@@ -51,9 +53,13 @@ std::map<TString, int> VarManager::fgVarNamesMap;
 bool VarManager::fgUsedVars[VarManager::kNVars] = {false};
 bool VarManager::fgUsedKF = false;
 bool VarManager::fgPVrecalKF = true;
+bool VarManager::fgSparseFillMode = false;
+bool VarManager::fgFillGroupUsed[VarManager::kNFillGroups] = {false};
 float VarManager::fgMagField = 0.5;
 float VarManager::fgzMatching = -77.5;
 float VarManager::fgzShiftFwd = 0.0;
+uint32_t VarManager::fgFwdPropagationSetup = 0;
+bool VarManager::fgUseMuonPropagationCache = false;
 float VarManager::fgValues[VarManager::kNVars] = {0.0f};
 float VarManager::fgTPCInterSectorBoundary = 1.0; // cm
 int VarManager::fgITSROFbias = 0;
@@ -64,11 +70,7 @@ uint64_t VarManager::fgSOR = 0;
 uint64_t VarManager::fgEOR = 0;
 ROOT::Math::PxPyPzEVector VarManager::fgBeamA(0, 0, 6799.99, 6800);  // GeV, beam from A-side 4-momentum vector
 ROOT::Math::PxPyPzEVector VarManager::fgBeamC(0, 0, -6799.99, 6800); // GeV, beam from C-side 4-momentum vector
-o2::vertexing::DCAFitterN<2> VarManager::fgFitterTwoProngBarrel;
-o2::vertexing::DCAFitterN<3> VarManager::fgFitterThreeProngBarrel;
-o2::vertexing::DCAFitterN<4> VarManager::fgFitterFourProngBarrel;
-o2::vertexing::FwdDCAFitterN<2> VarManager::fgFitterTwoProngFwd;
-o2::vertexing::FwdDCAFitterN<3> VarManager::fgFitterThreeProngFwd;
+VarManager::Context VarManager::fgDefaultContext(VarManager::fgValues);
 o2::globaltracking::MatchGlobalFwd VarManager::mMatching;
 std::map<VarManager::CalibObjects, TObject*> VarManager::fgCalibs;
 bool VarManager::fgRunTPCPostCalibration[4] = {false, false, false, false};
@@ -123,6 +125,64 @@ void VarManager::SetVariableDependencies()
   if (fgUsedVars[kTrackIsInsideTPCModule]) {
     fgUsedVars[kPhiTPCOuter] = true;
   }
+
+  // polarization: phi tilde needs cos(theta) and phi, the frames are computed only if cos(theta) is used
+  if (fgUsedVars[kPhiTildeHE]) {
+    fgUsedVars[kCosThetaHE] = true;
+    fgUsedVars[kPhiHE] = true;
+  }
+  if (fgUsedVars[kPhiTildeCS]) {
+    fgUsedVars[kCosThetaCS] = true;
+    fgUsedVars[kPhiCS] = true;
+  }
+  if (fgUsedVars[kPhiTildePP]) {
+    fgUsedVars[kCosThetaPP] = true;
+    fgUsedVars[kPhiPP] = true;
+  }
+  if (fgUsedVars[kPhiPP]) {
+    fgUsedVars[kCosThetaPP] = true;
+  }
+  if (fgUsedVars[kMCPhiTildeHE]) {
+    fgUsedVars[kMCCosThetaHE] = true;
+    fgUsedVars[kMCPhiHE] = true;
+  }
+  if (fgUsedVars[kMCPhiTildeCS]) {
+    fgUsedVars[kMCCosThetaCS] = true;
+    fgUsedVars[kMCPhiCS] = true;
+  }
+  if (fgUsedVars[kMCPhiTildePP]) {
+    fgUsedVars[kMCCosThetaPP] = true;
+    fgUsedVars[kMCPhiPP] = true;
+  }
+  if (fgUsedVars[kMCPhiPP]) {
+    fgUsedVars[kMCCosThetaPP] = true;
+  }
+  if (fgUsedVars[kCos2ThetaStarRandom]) {
+    fgUsedVars[kCosThetaStarRandom] = true;
+  }
+  if (fgUsedVars[kDeltaPhiPair]) {
+    fgUsedVars[kPsiPair] = true;
+  }
+
+  // groups of variables which are computed together, see FillGroups
+  static constexpr int PairVertexingVars[] = {
+    kUsedKF, kKFMass, kKFMassGeoTop, kCosPointingAngle,
+    kVertexingProcCode, kVertexingChi2PCA, kVertexingPz, kVertexingSV,
+    kVertexingLxy, kVertexingLxyErr, kVertexingLxyOverErr, kVertexingLz, kVertexingLzErr, kVertexingLzOverErr,
+    kVertexingLxyz, kVertexingLxyzErr, kVertexingLxyzOverErr,
+    kVertexingTauxy, kVertexingTauxyErr, kVertexingTauz, kVertexingTauzErr,
+    kVertexingLxyProjected, kVertexingLxyProjectedRecalculatePV, kVertexingLzProjected, kVertexingLxyzProjected,
+    kVertexingTauxyProjected, kVertexingTauxyProjectedNs, kVertexingTauxyProjectedPoleJPsiMass,
+    kVertexingTauxyProjectedPoleJPsiMassRecalculatePV, kVertexingTauzProjected, kVertexingTauxyzProjected,
+    kKFTrack0DCAxyz, kKFTrack1DCAxyz, kKFTracksDCAxyzMax, kKFDCAxyzBetweenProngs,
+    kKFTrack0DCAxy, kKFTrack1DCAxy, kKFTracksDCAxyMax, kKFDCAxyBetweenProngs,
+    kKFTrack0DeviationFromPV, kKFTrack1DeviationFromPV, kKFTrack0DeviationxyFromPV, kKFTrack1DeviationxyFromPV,
+    kKFChi2OverNDFGeo, kKFNContributorsPV, kKFCosPA, kKFChi2OverNDFGeoTop, kKFJpsiDCAxyz, kKFJpsiDCAxy,
+    kKFPairDeviationFromPV, kKFPairDeviationxyFromPV};
+  static constexpr int PairLegsVars[] = {kPt1, kEta1, kPhi1, kPt2, kEta2, kPhi2};
+
+  fgFillGroupUsed[kFillGroupPairVertexing] = std::any_of(std::begin(PairVertexingVars), std::end(PairVertexingVars), [](int var) { return fgUsedVars[var]; });
+  fgFillGroupUsed[kFillGroupPairLegs] = std::any_of(std::begin(PairLegsVars), std::end(PairLegsVars), [](int var) { return fgUsedVars[var]; });
 }
 
 //__________________________________________________________________
@@ -132,13 +192,29 @@ void VarManager::ResetValues(int startValue, int endValue, float* values)
   // reset all variables to an "innocent" value
   // NOTE: here we use -9999.0 as a neutral value, but depending on situation, this may not be the case
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   for (Int_t i = startValue; i < endValue; ++i) {
     values[i] = -9999.;
   }
 }
 
+//__________________________________________________________________
+namespace
+{
+thread_local VarManager::Context* gThreadContext = nullptr; // context set by the thread, if any
+} // namespace
+
+void VarManager::SetContext(Context* context)
+{
+  gThreadContext = context;
+}
+
+VarManager::Context* VarManager::GetContext()
+{
+  return gThreadContext ? gThreadContext : &fgDefaultContext;
+}
+
 //__________________________________________________________________
 void VarManager::SetCollisionSystem(TString system, float energy)
 {
@@ -242,7 +318,7 @@ float VarManager::calculateCosPA(KFParticle kfp, KFParticle PV)
 }
 
 //__________________________________________________________________
-double VarManager::ComputePIDcalibration(int species, double nSigmaValue)
+double VarManager::ComputePIDcalibration(int species, double nSigmaValue, const float* values)
 {
   // species: 0 - electron, 1 - pion, 2 - kaon, 3 - proton
   // Depending on the PID calibration type, we use different types of calibration histograms
@@ -280,13 +356,13 @@ double VarManager::ComputePIDcalibration(int species, double nSigmaValue)
     }
 
     // Get the bin indices for the calibration histograms
-    int binTPCncls = calibMeanHist->GetXaxis()->FindBin(fgValues[kTPCncls]);
+    int binTPCncls = calibMeanHist->GetXaxis()->FindBin(values[kTPCncls]);
     binTPCncls = (binTPCncls == 0 ? 1 : binTPCncls);
     binTPCncls = (binTPCncls > calibMeanHist->GetXaxis()->GetNbins() ? calibMeanHist->GetXaxis()->GetNbins() : binTPCncls);
-    int binPin = calibMeanHist->GetYaxis()->FindBin(fgValues[kPin]);
+    int binPin = calibMeanHist->GetYaxis()->FindBin(values[kPin]);
     binPin = (binPin == 0 ? 1 : binPin);
     binPin = (binPin > calibMeanHist->GetYaxis()->GetNbins() ? calibMeanHist->GetYaxis()->GetNbins() : binPin);
-    int binEta = calibMeanHist->GetZaxis()->FindBin(fgValues[kEta]);
+    int binEta = calibMeanHist->GetZaxis()->FindBin(values[kEta]);
     binEta = (binEta == 0 ? 1 : binEta);
     binEta = (binEta > calibMeanHist->GetZaxis()->GetNbins() ? calibMeanHist->GetZaxis()->GetNbins() : binEta);
 
@@ -331,16 +407,16 @@ double VarManager::ComputePIDcalibration(int species, double nSigmaValue)
     }
 
     // Get the bin indices for the calibration histograms
-    int binEta = calibMeanHist->GetAxis(0)->FindBin(fgValues[kEta]);
+    int binEta = calibMeanHist->GetAxis(0)->FindBin(values[kEta]);
     binEta = (binEta == 0 ? 1 : binEta);
     binEta = (binEta > calibMeanHist->GetAxis(0)->GetNbins() ? calibMeanHist->GetAxis(0)->GetNbins() : binEta);
-    int binNpv = calibMeanHist->GetAxis(1)->FindBin(fgValues[kVtxNcontribReal]);
+    int binNpv = calibMeanHist->GetAxis(1)->FindBin(values[kVtxNcontribReal]);
     binNpv = (binNpv == 0 ? 1 : binNpv);
     binNpv = (binNpv > calibMeanHist->GetAxis(1)->GetNbins() ? calibMeanHist->GetAxis(1)->GetNbins() : binNpv);
-    int binNlong = calibMeanHist->GetAxis(2)->FindBin(fgValues[kNTPCcontribLongA]);
+    int binNlong = calibMeanHist->GetAxis(2)->FindBin(values[kNTPCcontribLongA]);
     binNlong = (binNlong == 0 ? 1 : binNlong);
     binNlong = (binNlong > calibMeanHist->GetAxis(2)->GetNbins() ? calibMeanHist->GetAxis(2)->GetNbins() : binNlong);
-    int binTlong = calibMeanHist->GetAxis(3)->FindBin(fgValues[kNTPCmedianTimeLongA]);
+    int binTlong = calibMeanHist->GetAxis(3)->FindBin(values[kNTPCmedianTimeLongA]);
     binTlong = (binTlong == 0 ? 1 : binTlong);
     binTlong = (binTlong > calibMeanHist->GetAxis(3)->GetNbins() ? calibMeanHist->GetAxis(3)->GetNbins() : binTlong);
 
@@ -401,7 +477,7 @@ void VarManager::FillEfficiency(float* values)
 {
   // depending on the efficiency type, we use different types of efficiency histograms and different variables to get the efficiency value
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if (fgEfficiencyType == kNone) {
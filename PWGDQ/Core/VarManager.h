@@ -80,6 +80,7 @@
 #include <map>
 #include <numbers>
 #include <tuple>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -1155,6 +1156,13 @@ class VarManager : public TObject
     kToMatching
   };
 
+  // Groups of variables computed together by one expensive step of the fill functions
+  enum FillGroups {
+    kFillGroupPairVertexing = 0, // secondary vertex of the pair, from the DCA fitter or KF (FillPairVertexing)
+    kFillGroupPairLegs,          // leg kinematics at the secondary vertex, overwritten by FillPairVertexing for the muon pairs
+    kNFillGroups
+  };
+
   static TString fgVariableNames[kNVars];      // variable names
   static TString fgVariableUnits[kNVars];      // variable units
   static std::map<TString, int> fgVarNamesMap; // key: variables short name, value: order in the Variables enum
@@ -1181,6 +1189,18 @@ class VarManager : public TObject
     for (auto& var : usedVars) {
       fgUsedVars[var] = true;
     }
+    SetVariableDependencies();
+  }
+  // In the sparse fill mode, the fill functions skip the groups of variables (FillGroups) of which no variable is used
+  // NOTE: only the used variables are then filled, so the mode must not be enabled by tasks writing other variables into tables
+  static void SetSparseFillMode(bool sparse = true)
+  {
+    fgSparseFillMode = sparse;
+    SetVariableDependencies();
+  }
+  static bool GetSparseFillMode()
+  {
+    return fgSparseFillMode;
   }
   static bool GetUsedVar(int var)
   {
@@ -1203,12 +1223,14 @@ class VarManager : public TObject
   static void SetMagneticField(float magField)
   {
     fgMagField = magField;
+    fgFwdPropagationSetup++;
   }
 
   // Setup plane position for MFT-MCH matching
   static void SetMatchingPlane(float z)
   {
     fgzMatching = z;
+    fgFwdPropagationSetup++;
   }
 
   static float GetMatchingPlane()
@@ -1220,6 +1242,7 @@ class VarManager : public TObject
   static void SetZShift(float z)
   {
     fgzShiftFwd = z;
+    fgFwdPropagationSetup++;
   }
 
   // Setup the 2 prong KFParticle
@@ -1232,47 +1255,58 @@ class VarManager : public TObject
   static void SetupMuonMagField()
   {
     o2::mch::TrackExtrap::setField();
+    fgFwdPropagationSetup++;
+  }
+
+  // Cache the results of PropagateMuon in the context, so that a muon is propagated once to each end point
+  // (and collision), also when it is used in several Fill functions or pairs
+  static void SetUseMuonPropagationCache(bool useCache)
+  {
+    fgUseMuonPropagationCache = useCache;
   }
 
   // Setup the 2 prong DCAFitterN
   static void SetupTwoProngDCAFitter(float magField, bool propagateToPCA, float maxR, float maxDZIni, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngBarrel.setBz(magField);
-    fgFitterTwoProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngBarrel.setMaxR(maxR);
-    fgFitterTwoProngBarrel.setMaxDZIni(maxDZIni);
-    fgFitterTwoProngBarrel.setMinParamChange(minParamChange);
-    fgFitterTwoProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngBarrel.setUseAbsDCA(useAbsDCA);
+    auto& fitter = GetContext()->fFitterTwoProngBarrel;
+    fitter.setBz(magField);
+    fitter.setPropagateToPCA(propagateToPCA);
+    fitter.setMaxR(maxR);
+    fitter.setMaxDZIni(maxDZIni);
+    fitter.setMinParamChange(minParamChange);
+    fitter.setMinRelChi2Change(minRelChi2Change);
+    fitter.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
   // Setup the 2 prong FwdDCAFitterN
   static void SetupTwoProngFwdDCAFitter(float magField, bool propagateToPCA, float maxR, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterTwoProngFwd.setBz(magField);
-    fgFitterTwoProngFwd.setPropagateToPCA(propagateToPCA);
-    fgFitterTwoProngFwd.setMaxR(maxR);
-    fgFitterTwoProngFwd.setMinParamChange(minParamChange);
-    fgFitterTwoProngFwd.setMinRelChi2Change(minRelChi2Change);
-    fgFitterTwoProngFwd.setUseAbsDCA(useAbsDCA);
+    auto& fitter = GetContext()->fFitterTwoProngFwd;
+    fitter.setBz(magField);
+    fitter.setPropagateToPCA(propagateToPCA);
+    fitter.setMaxR(maxR);
+    fitter.setMinParamChange(minParamChange);
+    fitter.setMinRelChi2Change(minRelChi2Change);
+    fitter.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
   // Use MatLayerCylSet to correct MCS in fwdtrack propagation
   static void SetupMatLUTFwdDCAFitter(o2::base::MatLayerCylSet* m)
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
-    fgFitterTwoProngFwd.setMatLUT(m);
+    auto& fitter = GetContext()->fFitterTwoProngFwd;
+    fitter.setTGeoMat(false);
+    fitter.setMatLUT(m);
   }
   // Use GeometryManager to correct MCS in fwdtrack propagation
   static void SetupTGeoFwdDCAFitter()
   {
-    fgFitterTwoProngFwd.setTGeoMat(true);
+    GetContext()->fFitterTwoProngFwd.setTGeoMat(true);
   }
   // No material budget in fwdtrack propagation
   static void SetupFwdDCAFitterNoCorr()
   {
-    fgFitterTwoProngFwd.setTGeoMat(false);
+    GetContext()->fFitterTwoProngFwd.setTGeoMat(false);
   }
   // Setup the 3 prong KFParticle
   static void SetupThreeProngKFParticle(float magField)
@@ -1284,12 +1318,13 @@ class VarManager : public TObject
   // Setup the 3 prong DCAFitterN
   static void SetupThreeProngDCAFitter(float magField, bool propagateToPCA, float maxR, float /*maxDZIni*/, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterThreeProngBarrel.setBz(magField);
-    fgFitterThreeProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterThreeProngBarrel.setMaxR(maxR);
-    fgFitterThreeProngBarrel.setMinParamChange(minParamChange);
-    fgFitterThreeProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterThreeProngBarrel.setUseAbsDCA(useAbsDCA);
+    auto& fitter = GetContext()->fFitterThreeProngBarrel;
+    fitter.setBz(magField);
+    fitter.setPropagateToPCA(propagateToPCA);
+    fitter.setMaxR(maxR);
+    fitter.setMinParamChange(minParamChange);
+    fitter.setMinRelChi2Change(minRelChi2Change);
+    fitter.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
@@ -1303,12 +1338,13 @@ class VarManager : public TObject
   // Setup the 4 prong DCAFitterN
   static void SetupFourProngDCAFitter(float magField, bool propagateToPCA, float maxR, float /*maxDZIni*/, float minParamChange, float minRelChi2Change, bool useAbsDCA)
   {
-    fgFitterFourProngBarrel.setBz(magField);
-    fgFitterFourProngBarrel.setPropagateToPCA(propagateToPCA);
-    fgFitterFourProngBarrel.setMaxR(maxR);
-    fgFitterFourProngBarrel.setMinParamChange(minParamChange);
-    fgFitterFourProngBarrel.setMinRelChi2Change(minRelChi2Change);
-    fgFitterFourProngBarrel.setUseAbsDCA(useAbsDCA);
+    auto& fitter = GetContext()->fFitterFourProngBarrel;
+    fitter.setBz(magField);
+    fitter.setPropagateToPCA(propagateToPCA);
+    fitter.setMaxR(maxR);
+    fitter.setMinParamChange(minParamChange);
+    fitter.setMinRelChi2Change(minRelChi2Change);
+    fitter.setUseAbsDCA(useAbsDCA);
     fgUsedKF = false;
   }
 
@@ -1341,6 +1377,8 @@ class VarManager : public TObject
   template <typename T, typename C>
   static o2::dataformats::GlobalFwdTrack PropagateMuon(const T& muon, const C& collision, int endPoint = kToVertex);
   template <typename T, typename C>
+  static o2::dataformats::GlobalFwdTrack PropagateMuonNoCache(const T& muon, const C& collision, int endPoint = kToVertex);
+  template <typename T, typename C>
   static o2::track::TrackParCovFwd PropagateFwd(const T& track, const C& cov, float z);
   template <uint32_t fillMap, typename T, typename C>
   static void FillMuonPDca(const T& muon, const C& collision, float* values = nullptr);
@@ -1483,7 +1521,7 @@ class VarManager : public TObject
     fgCalibrationType = type;
     fgUseInterpolatedCalibration = useInterpolation;
   }
-  static double ComputePIDcalibration(int species, double nSigmaValue);
+  static double ComputePIDcalibration(int species, double nSigmaValue, const float* values);
 
   static void SetEfficiencyObject(int type, TObject* obj);
   static void FillEfficiency(float* values = nullptr);
@@ -1521,15 +1559,66 @@ class VarManager : public TObject
   static float fgValues[kNVars]; // array holding all variables computed during analysis
   static void ResetValues(int startValue = 0, int endValue = kNVars, float* values = nullptr);
 
+  // Muon propagated by PropagateMuon, with the inputs of the propagation
+  struct MuonPropagation {
+    std::array<float, 6> fMuon{};                    // z, x, y, phi, tgl and signed 1/pt of the muon
+    std::array<float, 5> fCollision{};               // x, y, z and xx, yy covariances of the collision
+    uint32_t fSetup = 0;                             // setup of the forward propagation
+    o2::dataformats::GlobalFwdTrack fPropagatedMuon; // propagated muon
+  };
+
+  // Context of the Fill functions: the values array used when none is given to them, and the vertexing fitters
+  // The static API runs on the context of the calling thread, which is the default context (fgValues and the fitters
+  // configured by the Setup functions) unless another one is set with SetContext(). With one context per thread, the
+  // Fill functions can run in parallel, as long as the configuration (used variables, calibrations, magnetic field,
+  // KFParticle field) is not changed meanwhile.
+  struct Context {
+    Context() : fValues(fBuffer.data()) {}
+    explicit Context(float* values) : fValues(values) {}
+    // copy of the fitters of another context (e.g. the configured default one), with its own values array
+    Context(const Context& other) : fValues(fBuffer.data()),
+                                    fFitterTwoProngBarrel(other.fFitterTwoProngBarrel),
+                                    fFitterThreeProngBarrel(other.fFitterThreeProngBarrel),
+                                    fFitterFourProngBarrel(other.fFitterFourProngBarrel),
+                                    fFitterTwoProngFwd(other.fFitterTwoProngFwd),
+                                    fFitterThreeProngFwd(other.fFitterThreeProngFwd)
+    {
+    }
+    Context& operator=(const Context&) = delete;
+
+    std::array<float, kNVars> fBuffer{};                  // values, if not given at construction
+    float* fValues;                                       // values of the context
+    o2::vertexing::DCAFitterN<2> fFitterTwoProngBarrel;   // 2-prong fitter for barrel tracks
+    o2::vertexing::DCAFitterN<3> fFitterThreeProngBarrel; // 3-prong fitter for barrel tracks
+    o2::vertexing::DCAFitterN<4> fFitterFourProngBarrel;  // 4-prong fitter for barrel tracks
+    o2::vertexing::FwdDCAFitterN<2> fFitterTwoProngFwd;   // 2-prong fitter for muon tracks
+    o2::vertexing::FwdDCAFitterN<3> fFitterThreeProngFwd; // 3-prong fitter for muon tracks
+    // propagated muons, key: muon index and end point
+    std::unordered_map<uint64_t, MuonPropagation> fMuonPropagations;
+  };
+  // context of the calling thread, nullptr to go back to the default context
+  static void SetContext(Context* context);
+  static Context* GetContext();
+
  private:
   static bool fgUsedVars[kNVars]; // holds flags for when the corresponding variable is needed (e.g., in the histogram manager, in cuts, mixing handler, etc.)
   static bool fgUsedKF;
   static bool fgPVrecalKF;
-  static void SetVariableDependencies(); // toggle those variables on which other used variables might depend
+  static bool fgSparseFillMode;              // skip the groups of variables of which no variable is used
+  static bool fgFillGroupUsed[kNFillGroups]; // true if at least one variable of the group is used
+  static void SetVariableDependencies();     // toggle those variables on which other used variables might depend
+  // a group is always computed, unless the sparse fill mode is enabled
+  static bool IsFillGroupNeeded(int group)
+  {
+    return !fgSparseFillMode || fgFillGroupUsed[group];
+  }
 
   static float fgMagField;
   static float fgzMatching;
   static float fgzShiftFwd;
+  static uint32_t fgFwdPropagationSetup;                      // incremented at each change of the forward propagation setup
+  static bool fgUseMuonPropagationCache;                      // cache the propagated muons
+  static constexpr std::size_t MaxMuonPropagations = 1 << 16; // maximum number of cached muons per context
   static float fgCenterOfMassEnergy;        // collision energy
   static float fgMassofCollidingParticle;   // mass of the colliding particle
   static float fgTPCInterSectorBoundary;    // TPC inter-sector border size at the TPC outer radius, in cm
@@ -1558,11 +1647,7 @@ class VarManager : public TObject
   template <typename T1, typename T2>
   static float LorentzTransformJpsihadroncosChi(TString Option, const T1& v1, const T2& v2);
 
-  static o2::vertexing::DCAFitterN<2> fgFitterTwoProngBarrel;
-  static o2::vertexing::DCAFitterN<3> fgFitterThreeProngBarrel;
-  static o2::vertexing::DCAFitterN<4> fgFitterFourProngBarrel;
-  static o2::vertexing::FwdDCAFitterN<2> fgFitterTwoProngFwd;
-  static o2::vertexing::FwdDCAFitterN<3> fgFitterThreeProngFwd;
+  static Context fgDefaultContext; // context used by the threads which did not set one
   static o2::globaltracking::MatchGlobalFwd mMatching;
 
   static std::map<CalibObjects, TObject*> fgCalibs; // map of calibration histograms
@@ -1711,6 +1796,36 @@ o2::dataformats::VertexBase VarManager::RecalculatePrimaryVertex(T const& track0
 
 template <typename T, typename C>
 o2::dataformats::GlobalFwdTrack VarManager::PropagateMuon(const T& muon, const C& collision, const int endPoint)
+{
+  if constexpr (requires { muon.globalIndex(); }) {
+    if (fgUseMuonPropagationCache) {
+      // the cached muon is used only if the muon, the collision and the setup did not change since it was propagated
+      auto& cache = GetContext()->fMuonPropagations;
+      if (cache.size() > MaxMuonPropagations) {
+        cache.clear();
+      }
+      const std::array<float, 6> muonPars = {static_cast<float>(muon.z()), static_cast<float>(muon.x()), static_cast<float>(muon.y()), static_cast<float>(muon.phi()), static_cast<float>(muon.tgl()), static_cast<float>(muon.signed1Pt())};
+      std::array<float, 5> collisionPars = {0.f, 0.f, 0.f, 0.f, 0.f};
+      // the propagation to the absorber end and to the matching plane does not depend on the collision for MCH tracks
+      if (static_cast<int>(muon.trackType()) <= 2 || endPoint == kToVertex || endPoint == kToDCA) {
+        collisionPars = {static_cast<float>(collision.posX()), static_cast<float>(collision.posY()), static_cast<float>(collision.posZ()), static_cast<float>(collision.covXX()), static_cast<float>(collision.covYY())};
+      }
+      auto [it, isNew] = cache.try_emplace((static_cast<uint64_t>(muon.globalIndex()) << 2) | static_cast<uint64_t>(endPoint));
+      MuonPropagation& entry = it->second;
+      if (isNew || entry.fMuon != muonPars || entry.fCollision != collisionPars || entry.fSetup != fgFwdPropagationSetup) {
+        entry.fMuon = muonPars;
+        entry.fCollision = collisionPars;
+        entry.fSetup = fgFwdPropagationSetup;
+        entry.fPropagatedMuon = PropagateMuonNoCache(muon, collision, endPoint);
+      }
+      return entry.fPropagatedMuon;
+    }
+  }
+  return PropagateMuonNoCache(muon, collision, endPoint);
+}
+
+template <typename T, typename C>
+o2::dataformats::GlobalFwdTrack VarManager::PropagateMuonNoCache(const T& muon, const C& collision, const int endPoint)
 {
   o2::track::TrackParCovFwd fwdtrack = o2::aod::fwdtrackutils::getTrackParCovFwdShift(muon, fgzShiftFwd, muon);
   o2::dataformats::GlobalFwdTrack propmuon;
@@ -1761,7 +1876,7 @@ template <uint32_t fillMap, typename T, typename C>
 void VarManager::FillMuonPDca(const T& muon, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0) {
@@ -1780,7 +1895,7 @@ template <uint32_t fillMap, typename T, typename C>
 void VarManager::FillPropagateMuon(const T& muon, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((fillMap & ReducedMuonCov) > 0) {
@@ -1836,7 +1951,7 @@ template <uint32_t fillMap, typename T1, typename T2, typename C>
 void VarManager::FillGlobalMuonRefit(T1 const& muontrack, T2 const& mfttrack, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0) {
     o2::dataformats::GlobalFwdTrack propmuon = PropagateMuon(muontrack, collision);
@@ -1860,7 +1975,7 @@ template <uint32_t MuonfillMap, uint32_t MFTfillMap, typename T1, typename T2, t
 void VarManager::FillGlobalMuonRefitCov(T1 const& muontrack, T2 const& mfttrack, const C& collision, C2 const& mftcov, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr ((MuonfillMap & MuonCov) > 0) {
     if constexpr ((MFTfillMap & MFTCov) > 0) {
@@ -1884,7 +1999,7 @@ template <typename T>
 void VarManager::FillTimeFrame(T const& tf, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr (T::template contains<o2::aod::BCs>()) {
     values[kTFNBCs] = tf.size();
@@ -1910,7 +2025,7 @@ template <typename T>
 void VarManager::FillBC(T const& bc, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   values[kRunNo] = bc.runNumber();
   values[kBC] = bc.globalBC();
@@ -1923,7 +2038,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillEvent(T const& event, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((fillMap & CollisionTimestamp) > 0) {
@@ -2469,7 +2584,7 @@ template <typename T>
 void VarManager::FillEventTracks(T const& tracks, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   // compute event properties based on DCAz of the tracks
@@ -2605,7 +2720,7 @@ template <typename T>
 void VarManager::FillEventFlowResoFactor(T const& hs_sp, T const& hs_ep, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if (values[kCentFT0C] >= 0.) {
@@ -2621,7 +2736,7 @@ template <typename T>
 void VarManager::FillTwoMixEventsFlowResoFactor(T const& hs_sp, T const& hs_ep, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if (values[kTwoEvCentFT0C1] >= 0.) {
@@ -2645,7 +2760,7 @@ template <typename T, typename T1, typename T2>
 void VarManager::FillTwoMixEventsCumulants(T const& h_v22ev1, T const& h_v24ev1, T const& h_v22ev2, T const& h_v24ev2, T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   int idx_v22ev1;
@@ -2691,7 +2806,7 @@ template <typename T>
 void VarManager::FillTwoEvents(T const& ev1, T const& ev2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   // if constexpr (T::template contains<o2::aod::Collision>()) {
   values[kTwoEvPosZ1] = ev1.posZ();
@@ -2711,7 +2826,7 @@ template <uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillTwoMixEvents(T1 const& ev1, T1 const& ev2, T2 const& /*tracks1*/, T2 const& /*tracks2*/, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   values[kTwoEvPosZ1] = ev1.posZ();
   values[kTwoEvPosZ2] = ev2.posZ();
@@ -2749,7 +2864,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillTrack(T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((fillMap & TrackMFT) > 0) {
@@ -3035,7 +3150,7 @@ void VarManager::FillTrack(T const& track, float* values)
     // compute TPC postcalibrated electron nsigma based on calibration histograms from CCDB
     if (fgUsedVars[kTPCnSigmaEl_Corr] && fgRunTPCPostCalibration[0]) {
       if (!isTPCCalibrated) {
-        values[kTPCnSigmaEl_Corr] = ComputePIDcalibration(0, values[kTPCnSigmaEl]);
+        values[kTPCnSigmaEl_Corr] = ComputePIDcalibration(0, values[kTPCnSigmaEl], values);
       } else {
         LOG(fatal) << "TPC PID postcalibration is configured but the tracks are already postcalibrated. This is not allowed. Please check your configuration.";
         values[kTPCnSigmaEl_Corr] = track.tpcNSigmaEl();
@@ -3045,7 +3160,7 @@ void VarManager::FillTrack(T const& track, float* values)
     // compute TPC postcalibrated pion nsigma if required
     if (fgUsedVars[kTPCnSigmaPi_Corr] && fgRunTPCPostCalibration[1]) {
       if (!isTPCCalibrated) {
-        values[kTPCnSigmaPi_Corr] = ComputePIDcalibration(1, values[kTPCnSigmaPi]);
+        values[kTPCnSigmaPi_Corr] = ComputePIDcalibration(1, values[kTPCnSigmaPi], values);
       } else {
         LOG(fatal) << "TPC PID postcalibration is configured but the tracks are already postcalibrated. This is not allowed. Please check your configuration.";
         values[kTPCnSigmaPi_Corr] = track.tpcNSigmaPi();
@@ -3054,7 +3169,7 @@ void VarManager::FillTrack(T const& track, float* values)
     if (fgUsedVars[kTPCnSigmaKa_Corr] && fgRunTPCPostCalibration[2]) {
       // compute TPC postcalibrated kaon nsigma if required
       if (!isTPCCalibrated) {
-        values[kTPCnSigmaKa_Corr] = ComputePIDcalibration(2, values[kTPCnSigmaKa]);
+        values[kTPCnSigmaKa_Corr] = ComputePIDcalibration(2, values[kTPCnSigmaKa], values);
       } else {
         LOG(fatal) << "TPC PID postcalibration is configured but the tracks are already postcalibrated. This is not allowed. Please check your configuration.";
         values[kTPCnSigmaKa_Corr] = track.tpcNSigmaKa();
@@ -3063,7 +3178,7 @@ void VarManager::FillTrack(T const& track, float* values)
     // compute TPC postcalibrated proton nsigma if required
     if (fgUsedVars[kTPCnSigmaPr_Corr] && fgRunTPCPostCalibration[3]) {
       if (!isTPCCalibrated) {
-        values[kTPCnSigmaPr_Corr] = ComputePIDcalibration(3, values[kTPCnSigmaPr]);
+        values[kTPCnSigmaPr_Corr] = ComputePIDcalibration(3, values[kTPCnSigmaPr], values);
       } else {
         LOG(fatal) << "TPC PID postcalibration is configured but the tracks are already postcalibrated. This is not allowed. Please check your configuration.";
         values[kTPCnSigmaPr_Corr] = track.tpcNSigmaPr();
@@ -3185,7 +3300,7 @@ void VarManager::FillTrackCollision(T const& track, C const& collision, float* v
 {
 
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr ((fillMap & ReducedTrackBarrel) > 0 || (fillMap & TrackDCA) > 0) {
     auto trackPar = getTrackPar(track);
@@ -3219,7 +3334,7 @@ template <uint32_t fillMap, typename T, typename C, typename M, typename P>
 void VarManager::FillTrackCollisionMatCorr(T const& track, C const& collision, M const& materialCorr, P const& propagator, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr ((fillMap & ReducedTrackBarrel) > 0 || (fillMap & TrackDCA) > 0) {
     auto trackPar = getTrackPar(track);
@@ -3247,7 +3362,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillPhoton(T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   // Quantities based on the basic table (contains just kine information and filter bits)
@@ -3279,7 +3394,7 @@ template <typename U, typename T>
 void VarManager::FillTrackMC(const U& mcStack, T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   // Quantities based on the mc particle table
@@ -3313,7 +3428,7 @@ void VarManager::FillTrackCollisionMC(T1 const& track, T2 const& MotherTrack, C
 {
 
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m = o2::constants::physics::MassBPlus;
@@ -3367,7 +3482,7 @@ void VarManager::FillTrackCollisionMC(T1 const& track, const std::array<double,
 {
 
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m = o2::constants::physics::MassJPsi;
@@ -3465,7 +3580,7 @@ template <uint32_t fillMap, typename T1, typename T2, typename C>
 void VarManager::FillPairPropagateMuon(T1 const& muon1, T2 const& muon2, const C& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   o2::dataformats::GlobalFwdTrack propmuon1 = PropagateMuon(muon1, collision);
   o2::dataformats::GlobalFwdTrack propmuon2 = PropagateMuon(muon2, collision);
@@ -3490,7 +3605,7 @@ template <int pairType, uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillPair(T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -3788,7 +3903,7 @@ template <int pairType, uint32_t fillMap, typename C, typename T1, typename T2>
 void VarManager::FillPairCollision(const C& collision, T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0)) {
@@ -3840,7 +3955,7 @@ template <int pairType, uint32_t fillMap, typename C, typename T1, typename T2,
 void VarManager::FillPairCollisionMatCorr(C const& collision, T1 const& t1, T2 const& t2, M const& materialCorr, P const& propagator, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((pairType == kDecayToEE) && ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0)) {
@@ -3899,7 +4014,7 @@ void VarManager::FillTriple(T1 const& t1, T2 const& t2, T3 const& t3, float* val
 {
 
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if (pairType == kTripleCandidateToEEPhoton) {
     float m1 = o2::constants::physics::MassElectron;
@@ -3973,7 +4088,7 @@ void VarManager::FillPairME(T1 const& t1, T2 const& t2, float* values)
   // Lightweight fill function called from the innermost event mixing loop
   //
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -4218,7 +4333,7 @@ template <int pairType, typename T1, typename T2>
 void VarManager::FillPairMC(T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -4400,7 +4515,7 @@ template <int candidateType, typename T1, typename T2, typename T3>
 void VarManager::FillTripleMC(T1 const& t1, T2 const& t2, T3 const& t3, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr (candidateType == kTripleCandidateToEEPhoton) {
@@ -4489,8 +4604,9 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
 
+  auto* ctx = GetContext();
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
   float m1 = o2::constants::physics::MassElectron;
   float m2 = o2::constants::physics::MassElectron;
@@ -4506,6 +4622,15 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
   ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), m2);
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
+  // sparse fill mode: skip the vertex fit if none of the variables filled here is used
+  if (!propToSV && !IsFillGroupNeeded(kFillGroupPairVertexing)) {
+    if constexpr (!(pairType == kDecayToMuMu && muonHasCov)) {
+      return;
+    } else if (!IsFillGroupNeeded(kFillGroupPairLegs)) {
+      return;
+    }
+  }
+
   values[kUsedKF] = fgUsedKF;
   if (!fgUsedKF) {
     int procCode = 0;
@@ -4525,12 +4650,12 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
                                       t2.cSnpSnp(), t2.cTglY(), t2.cTglZ(), t2.cTglSnp(), t2.cTglTgl(),
                                       t2.c1PtY(), t2.c1PtZ(), t2.c1PtSnp(), t2.c1PtTgl(), t2.c1Pt21Pt2()};
       o2::track::TrackParCov pars2{t2.x(), t2.alpha(), t2pars, t2covs};
-      procCode = fgFitterTwoProngBarrel.process(pars1, pars2);
+      procCode = ctx->fFitterTwoProngBarrel.process(pars1, pars2);
     } else if constexpr ((pairType == kDecayToMuMu) && muonHasCov) {
       // Initialize track parameters for forward
       o2::track::TrackParCovFwd pars1 = FwdToTrackPar(t1, t1);
       o2::track::TrackParCovFwd pars2 = FwdToTrackPar(t2, t2);
-      procCode = fgFitterTwoProngFwd.process(pars1, pars2);
+      procCode = ctx->fFitterTwoProngFwd.process(pars1, pars2);
     } else {
       return;
     }
@@ -4570,12 +4695,12 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
+        secondaryVertex = ctx->fFitterTwoProngBarrel.getPCACandidate();
         // printf("secVtx (first) %f %f  %f \n",secondaryVertex[0],secondaryVertex[1],secondaryVertex[2]);
-        covMatrixPCA = fgFitterTwoProngBarrel.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngBarrel.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
+        covMatrixPCA = ctx->fFitterTwoProngBarrel.calcPCACovMatrixFlat();
+        auto chi2PCA = ctx->fFitterTwoProngBarrel.getChi2AtPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngBarrel.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngBarrel.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -4585,11 +4710,11 @@ void VarManager::FillPairVertexing(C const& collision, T const& t1, T const& t2,
 
       } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
         // Get pca candidate from forward DCA fitter
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterTwoProngFwd.calcPCACovMatrixFlat();
-        auto chi2PCA = fgFitterTwoProngFwd.getChi2AtPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
+        secondaryVertex = ctx->fFitterTwoProngFwd.getPCACandidate();
+        covMatrixPCA = ctx->fFitterTwoProngFwd.calcPCACovMatrixFlat();
+        auto chi2PCA = ctx->fFitterTwoProngFwd.getChi2AtPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngFwd.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngFwd.getTrack(1);
         values[kVertexingChi2PCA] = chi2PCA;
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
@@ -4875,8 +5000,9 @@ void VarManager::FillPairVertexingRecomputePV(C const& /*collision*/, T const& t
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
 
+  auto* ctx = GetContext();
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -4893,7 +5019,7 @@ void VarManager::FillPairVertexingRecomputePV(C const& /*collision*/, T const& t
   ROOT::Math::PtEtaPhiMVector v2(t2.pt(), t2.eta(), t2.phi(), m2);
   ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
 
-  if (fgFitterTwoProngBarrel.getNCandidates() == 0)
+  if (ctx->fFitterTwoProngBarrel.getNCandidates() == 0)
     return;
   Vec3D secondaryVertex;
 
@@ -4903,9 +5029,9 @@ void VarManager::FillPairVertexingRecomputePV(C const& /*collision*/, T const& t
       if constexpr ((pairType == kDecayToEE || pairType == kDecayToKPi) && trackHasCov) {
         // Get pca candidate from forward DCA fitter
         // no need to re-compute secondary vertex (done already in FillPairVertexing)
-        secondaryVertex = fgFitterTwoProngBarrel.getPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngBarrel.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngBarrel.getTrack(1);
+        secondaryVertex = ctx->fFitterTwoProngBarrel.getPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngBarrel.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngBarrel.getTrack(1);
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
         v12 = v1 + v2;
@@ -4913,9 +5039,9 @@ void VarManager::FillPairVertexingRecomputePV(C const& /*collision*/, T const& t
       } else if constexpr (pairType == kDecayToMuMu && muonHasCov) {
         // Get pca candidate from forward DCA fitter
         // no need to re-compute secondary vertex (done already in FillPairVertexing)
-        secondaryVertex = fgFitterTwoProngFwd.getPCACandidate();
-        auto trackParVar0 = fgFitterTwoProngFwd.getTrack(0);
-        auto trackParVar1 = fgFitterTwoProngFwd.getTrack(1);
+        secondaryVertex = ctx->fFitterTwoProngFwd.getPCACandidate();
+        auto trackParVar0 = ctx->fFitterTwoProngFwd.getTrack(0);
+        auto trackParVar1 = ctx->fFitterTwoProngFwd.getTrack(1);
         v1 = {trackParVar0.getPt(), trackParVar0.getEta(), trackParVar0.getPhi(), m1};
         v2 = {trackParVar1.getPt(), trackParVar1.getEta(), trackParVar1.getPhi(), m2};
         v12 = v1 + v2;
@@ -4935,8 +5061,9 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
   constexpr bool eventHasVtxCov = ((collFillMap & Collision) > 0 || (collFillMap & ReducedEventVtxCov) > 0);
   bool trackHasCov = ((fillMap & ReducedTrackBarrelCov) > 0);
 
+  auto* ctx = GetContext();
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float m1, m2, m3;
@@ -4976,7 +5103,7 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
                                       t3.cSnpSnp(), t3.cTglY(), t3.cTglZ(), t3.cTglSnp(), t3.cTglTgl(),
                                       t3.c1PtY(), t3.c1PtZ(), t3.c1PtSnp(), t3.c1PtTgl(), t3.c1Pt21Pt2()};
       o2::track::TrackParCov pars3{t3.x(), t3.alpha(), t3pars, t3covs};
-      procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
+      procCode = ctx->fFitterThreeProngBarrel.process(pars1, pars2, pars3);
     } else {
       return;
     }
@@ -5010,9 +5137,9 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
     Vec3D secondaryVertex;
 
     if constexpr (eventHasVtxCov) {
-      secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
+      secondaryVertex = ctx->fFitterThreeProngBarrel.getPCACandidate();
 
-      std::array<float, 6> covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+      std::array<float, 6> covMatrixPCA = ctx->fFitterThreeProngBarrel.calcPCACovMatrixFlat();
 
       o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
       std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
@@ -5020,7 +5147,7 @@ void VarManager::FillTripletVertexing(C const& collision, T const& t1, T const&
       auto covMatrixPV = primaryVertex.getCov();
 
       if (fgUsedVars[kVertexingChi2PCA]) {
-        auto chi2PCA = fgFitterThreeProngBarrel.getChi2AtPCACandidate();
+        auto chi2PCA = ctx->fFitterThreeProngBarrel.getChi2AtPCACandidate();
         values[VarManager::kVertexingChi2PCA] = chi2PCA;
       }
 
@@ -5157,8 +5284,9 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
   constexpr bool eventHasVtxCov = ((collFillMap & Collision) > 0 || (collFillMap & ReducedEventVtxCov) > 0);
   constexpr bool trackHasCov = ((fillMap & TrackCov) > 0 || (fillMap & ReducedTrackBarrelCov) > 0);
   constexpr bool muonHasCov = ((fillMap & MuonCov) > 0 || (fillMap & ReducedMuonCov) > 0);
+  auto* ctx = GetContext();
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float mtrack;
@@ -5178,8 +5306,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
       o2::track::TrackParCovFwd pars2 = FwdToTrackPar(lepton2, lepton2);
       o2::track::TrackParCovFwd pars3 = FwdToTrackPar(track, track);
 
-      procCode = VarManager::fgFitterThreeProngFwd.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngFwd.process(pars1, pars2);
+      procCode = ctx->fFitterThreeProngFwd.process(pars1, pars2, pars3);
+      procCodeJpsi = ctx->fFitterTwoProngFwd.process(pars1, pars2);
     } else if constexpr ((candidateType == kBtoJpsiEEK || candidateType == kDstarToD0KPiPi) && trackHasCov) {
       if constexpr ((candidateType == kBtoJpsiEEK) && trackHasCov) {
         mlepton1 = o2::constants::physics::MassElectron;
@@ -5205,8 +5333,8 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
                                            track.cSnpSnp(), track.cTglY(), track.cTglZ(), track.cTglSnp(), track.cTglTgl(),
                                            track.c1PtY(), track.c1PtZ(), track.c1PtSnp(), track.c1PtTgl(), track.c1Pt21Pt2()};
       o2::track::TrackParCov pars3{track.x(), track.alpha(), lepton3pars, lepton3covs};
-      procCode = VarManager::fgFitterThreeProngBarrel.process(pars1, pars2, pars3);
-      procCodeJpsi = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+      procCode = ctx->fFitterThreeProngBarrel.process(pars1, pars2, pars3);
+      procCodeJpsi = ctx->fFitterTwoProngBarrel.process(pars1, pars2);
     } else {
       return;
     }
@@ -5265,15 +5393,15 @@ void VarManager::FillDileptonTrackVertexing(C const& collision, T1 const& lepton
       auto covMatrixPV = primaryVertex.getCov();
 
       if constexpr ((candidateType == kBtoJpsiEEK || candidateType == kDstarToD0KPiPi) && trackHasCov) {
-        secondaryVertex = fgFitterThreeProngBarrel.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngBarrel.calcPCACovMatrixFlat();
+        secondaryVertex = ctx->fFitterThreeProngBarrel.getPCACandidate();
+        covMatrixPCA = ctx->fFitterThreeProngBarrel.calcPCACovMatrixFlat();
       } else if constexpr (candidateType == kBcToThreeMuons && muonHasCov) {
-        secondaryVertex = fgFitterThreeProngFwd.getPCACandidate();
-        covMatrixPCA = fgFitterThreeProngFwd.calcPCACovMatrixFlat();
+        secondaryVertex = ctx->fFitterThreeProngFwd.getPCACandidate();
+        covMatrixPCA = ctx->fFitterThreeProngFwd.calcPCACovMatrixFlat();
       }
 
       if (fgUsedVars[kVertexingChi2PCA]) {
-        auto chi2PCA = fgFitterThreeProngBarrel.getChi2AtPCACandidate();
+        auto chi2PCA = ctx->fFitterThreeProngBarrel.getChi2AtPCACandidate();
         values[VarManager::kVertexingChi2PCA] = chi2PCA;
       }
 
@@ -5416,7 +5544,7 @@ template <typename C, typename A>
 void VarManager::FillQVectorFromGFW(C const& /*collision*/, A const& compA11, A const& compB11, A const& compC11, A const& compA21, A const& compB21, A const& compC21, A const& compA31, A const& compB31, A const& compC31, A const& compA41, A const& compB41, A const& compC41, A const& compA23, A const& compA42, float S10A, float S10B, float S10C, float S11A, float S11B, float S11C, float S12A, float S13A, float S14A, float S21A, float S22A, float S31A, float S41A, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   // Fill Qn vectors from generic flow framework for different eta gap A, B, C (n=1,2,3,4) with proper normalisation
@@ -5521,7 +5649,7 @@ template <typename C>
 void VarManager::FillQVectorFromCentralFW(C const& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float xQVecFT0a = collision.qvecFT0ARe();   // already normalised
@@ -5617,7 +5745,7 @@ template <typename C>
 void VarManager::FillSpectatorPlane(C const& collision, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   auto zncEnergy = collision.energySectorZNC();
@@ -5725,7 +5853,7 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
 {
 
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -5787,23 +5915,23 @@ void VarManager::FillPairVn(T1 const& t1, T2 const& t2, float* values)
   values[kV2EP] = std::isnan(V2EP) || std::isinf(V2EP) ? 0. : V2EP;
   values[kWV2EP] = std::isnan(V2EP) || std::isinf(V2EP) ? 0. : 1.0;
 
-  if (std::isnan(VarManager::fgValues[VarManager::kU2Q2]) == true) {
+  if (std::isnan(values[kU2Q2]) == true) {
     values[kU2Q2] = -999.;
     values[kR2SP_AB] = -999.;
     values[kR2SP_AC] = -999.;
     values[kR2SP_BC] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kU3Q3]) == true) {
+  if (std::isnan(values[kU3Q3]) == true) {
     values[kU3Q3] = -999.;
     values[kR3SP] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kCos2DeltaPhi]) == true) {
+  if (std::isnan(values[kCos2DeltaPhi]) == true) {
     values[kCos2DeltaPhi] = -999.;
     values[kR2EP_AB] = -999.;
     values[kR2EP_AC] = -999.;
     values[kR2EP_BC] = -999.;
   }
-  if (std::isnan(VarManager::fgValues[VarManager::kCos3DeltaPhi]) == true) {
+  if (std::isnan(values[kCos3DeltaPhi]) == true) {
     values[kCos3DeltaPhi] = -999.;
     values[kR3EP] = -999.;
   }
@@ -5903,7 +6031,7 @@ template <typename T>
 void VarManager::FillZDC(T const& zdc, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   values[kEnergyCommonZNA] = (zdc.energyCommonZNA() > 0) ? zdc.energyCommonZNA() : -1.;
@@ -5920,7 +6048,7 @@ template <typename T1, typename T2>
 void VarManager::FillDileptonHadron(T1 const& dilepton, T2 const& hadron, float* values, float hadronMass)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if (fgUsedVars[kPairMass] || fgUsedVars[kPairPt] || fgUsedVars[kPairEta] || fgUsedVars[kPairPhi] || fgUsedVars[kPairMassDau] || fgUsedVars[kPairPtDau] || fgUsedVars[kDileptonHadronKstar]) {
@@ -6095,7 +6223,7 @@ template <typename T1, typename T2>
 void VarManager::FillDileptonPhoton(T1 const& dilepton, T2 const& photon, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if (fgUsedVars[kPairMass] || fgUsedVars[kPairPt] || fgUsedVars[kPairEta] || fgUsedVars[kPairPhi]) {
     ROOT::Math::PtEtaPhiMVector v1(dilepton.pt(), dilepton.eta(), dilepton.phi(), dilepton.mass());
@@ -6122,7 +6250,7 @@ template <typename T>
 void VarManager::FillHadron(T const& hadron, float* values, float hadronMass)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   ROOT::Math::PtEtaPhiMVector vhadron(hadron.pt(), hadron.eta(), hadron.phi(), hadronMass);
@@ -6137,7 +6265,7 @@ template <int partType, typename Cand, typename H, typename T>
 void VarManager::FillSingleDileptonCharmHadron(Cand const& candidate, H hfHelper, T& bdtScoreCharmHad, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr (partType == kJPsi) {
@@ -6173,7 +6301,7 @@ template <int candidateType, typename T1, typename T2, typename T3>
 void VarManager::FillDileptonTrackTrack(T1 const& dilepton, T2 const& hadron1, T3 const& hadron2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   double defaultDileptonMass = 3.096;
@@ -6234,8 +6362,9 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
     return;
   }
 
+  auto* ctx = GetContext();
   if (!values) {
-    values = fgValues;
+    values = ctx->fValues;
   }
 
   float mtrack1, mtrack2;
@@ -6281,11 +6410,11 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
                                         track2.c1PtY(), track2.c1PtZ(), track2.c1PtSnp(), track2.c1PtTgl(), track2.c1Pt21Pt2()};
     o2::track::TrackParCov pars4{track2.x(), track2.alpha(), track2pars, track2covs};
 
-    procCodeDilepton = VarManager::fgFitterTwoProngBarrel.process(pars1, pars2);
+    procCodeDilepton = ctx->fFitterTwoProngBarrel.process(pars1, pars2);
     // create dilepton track
-    // o2::track::TrackParCov parsDilepton = VarManager::fgFitterTwoProngBarrel.createParentTrackParCov(0);
-    // procCodeDileptonTrackTrack = VarManager::fgFitterThreeProngBarrel.process(parsDilepton, pars3, pars4);
-    procCodeDileptonTrackTrack = VarManager::fgFitterFourProngBarrel.process(pars1, pars2, pars3, pars4);
+    // o2::track::TrackParCov parsDilepton = ctx->fFitterTwoProngBarrel.createParentTrackParCov(0);
+    // procCodeDileptonTrackTrack = ctx->fFitterThreeProngBarrel.process(parsDilepton, pars3, pars4);
+    procCodeDileptonTrackTrack = ctx->fFitterFourProngBarrel.process(pars1, pars2, pars3, pars4);
 
     // fill values
     if (procCodeDilepton == 0 && procCodeDileptonTrackTrack == 0) {
@@ -6310,8 +6439,8 @@ void VarManager::FillDileptonTrackTrackVertexing(C const& collision, T1 const& l
     } else {
       Vec3D secondaryVertex;
       std::array<float, 6> covMatrixPCA;
-      secondaryVertex = fgFitterFourProngBarrel.getPCACandidate();
-      covMatrixPCA = fgFitterFourProngBarrel.calcPCACovMatrixFlat();
+      secondaryVertex = ctx->fFitterFourProngBarrel.getPCACandidate();
+      covMatrixPCA = ctx->fFitterFourProngBarrel.calcPCACovMatrixFlat();
 
       o2::math_utils::Point3D<float> vtxXYZ(collision.posX(), collision.posY(), collision.posZ());
       std::array<float, 6> vtxCov{collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
@@ -6488,7 +6617,7 @@ template <int candidateType, typename T1, typename T2>
 void VarManager::FillQuadMC(T1 const& dilepton, T2 const& track1, T2 const& track2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   double defaultDileptonMass = 3.096;
@@ -6639,7 +6768,7 @@ template <typename T1>
 void VarManager::FillBdtScore(T1 const& bdtScore, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if (bdtScore.size() == 1) {
@@ -6679,7 +6808,7 @@ template <typename T1, typename T2, typename T3, typename T4, typename T5>
 void VarManager::FillFIT(T1 const& bc, T2 const& bcs, T3 const& ft0s, T4 const& fv0as, T5 const& fdds, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   // Initialize FIT info structure
@@ -6736,7 +6865,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillEventAlice3(T const& event, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
   if constexpr ((fillMap & CollisionTimestamp) > 0) {
     values[kTimestamp] = event.timestamp();
@@ -6804,7 +6933,7 @@ template <uint32_t fillMap, typename T>
 void VarManager::FillTrackAlice3(T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   if constexpr ((fillMap & Track) > 0 || (fillMap & ReducedTrack) > 0) {
@@ -6957,7 +7086,7 @@ template <int pairType, uint32_t fillMap, typename T1, typename T2>
 void VarManager::FillPairAlice3(T1 const& t1, T2 const& t2, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   float m1 = o2::constants::physics::MassElectron;
@@ -7213,7 +7342,7 @@ template <typename M, typename T>
 void VarManager::FillResolutions(M const& mcTrack, T const& track, float* values)
 {
   if (!values) {
-    values = fgValues;
+    values = GetContext()->fValues;
   }
 
   values[kDeltaPt] = track.pt() - mcTrack.pt();
@@ -248,6 +248,7 @@ struct TableMaker {
     Configurable<bool> fConfigQA{"cfgQA", false, "If true, fill QA histograms"};
     Configurable<bool> fConfigFillBcStat{"cfgFillBcStat", false, "If true, fill QA histograms for normalization studies (for OO and Pb-Pb)"};
     Configurable<bool> fConfigDetailedQA{"cfgDetailedQA", false, "If true, include more QA histograms (BeforeCuts classes)"};
+    Configurable<int> fConfigQASampling{"cfgQASampling", 1, "Fill the track and muon QA histograms for one out of N skimmed tracks (1: all the tracks)"};
     Configurable<std::string> fConfigAddEventHistogram{"cfgAddEventHistogram", "", "Comma separated list of histograms"};
     Configurable<std::string> fConfigAddTrackHistogram{"cfgAddTrackHistogram", "", "Comma separated list of histograms"};
     Configurable<std::string> fConfigAddMuonHistogram{"cfgAddMuonHistogram", "", "Comma separated list of histograms"};
@@ -332,6 +333,10 @@ struct TableMaker {
   std::vector<AnalysisCompositeCut*> fMuonCuts;  //! Muon track cuts
 
   bool fDoDetailedQA = false; // Bool to set detailed QA true, if QA is set true
+  std::vector<TString> fTrackQAClasses; // QA histogram class of each barrel track cut
+  std::vector<TString> fMuonQAClasses;  // QA histogram class of each muon cut
+  uint64_t fNQATracks = 0;              // number of skimmed barrel tracks, used for the QA sampling
+  uint64_t fNQAMuons = 0;               // number of skimmed muons, used for the QA sampling
   int fCurrentRun;            // needed to detect if the run changed and trigger update of calibrations etc.
 
   // maps used to store index info; NOTE: std::map are sorted in ascending order by default (needed for track to collision indices)
@@ -461,6 +466,9 @@ struct TableMaker {
     if (fConfigHistOutput.fConfigQA && fConfigHistOutput.fConfigDetailedQA) {
       fDoDetailedQA = true;
     }
+    if (fConfigHistOutput.fConfigQASampling.value < 1) {
+      LOG(fatal) << "cfgQASampling must be at least 1";
+    }
 
     // Create the histogram class names to be added to the histogram manager
     // The histogram class names are added into a string and then passed to the DefineHistograms() function which
@@ -595,6 +603,14 @@ struct TableMaker {
       }
     }
 
+    // keep the QA histogram class names, so they are not composed in the track loops
+    for (auto& cut : fTrackCuts) {
+      fTrackQAClasses.push_back(Form("TrackBarrel_%s", cut->GetName()));
+    }
+    for (auto& cut : fMuonCuts) {
+      fMuonQAClasses.push_back(Form("Muons_%s", cut->GetName()));
+    }
+
     VarManager::SetUseVars(AnalysisCut::fgUsedVars); // provide the list of required variables so that VarManager knows what to fill
   }
 
@@ -1312,17 +1328,21 @@ struct TableMaker {
       for (auto cut = fTrackCuts.begin(); cut != fTrackCuts.end(); cut++, i++) {
         if ((*cut)->IsSelected(VarManager::fgValues)) {
           trackTempFilterMap |= (static_cast<uint32_t>(1) << i);
-          // NOTE: the QA is filled here just for the first occurence of this track.
-          //    So if there are histograms of quantities which depend on the collision association, these will not be accurate
-          if (fConfigHistOutput.fConfigQA && (fTrackIndexMap.find(track.globalIndex()) == fTrackIndexMap.end())) {
-            fHistMan->FillHistClass(Form("TrackBarrel_%s", (*cut)->GetName()), VarManager::fgValues);
-          }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsTracks)))->Fill(static_cast<float>(i));
         }
       }
       if (!trackTempFilterMap) {
         continue;
       }
+      // NOTE: the QA is filled here just for the first occurence of this track, and for one out of cfgQASampling tracks.
+      //    So if there are histograms of quantities which depend on the collision association, these will not be accurate
+      if (fConfigHistOutput.fConfigQA && (fTrackIndexMap.find(track.globalIndex()) == fTrackIndexMap.end()) && (fNQATracks++ % fConfigHistOutput.fConfigQASampling.value == 0)) {
+        for (std::size_t icut = 0; icut < fTrackQAClasses.size(); icut++) {
+          if (trackTempFilterMap & (static_cast<uint32_t>(1) << icut)) {
+            fHistMan->FillHistClass(fTrackQAClasses[icut].Data(), VarManager::fgValues);
+          }
+        }
+      }
 
       // If this track is already present in the index map, it means it was already skimmed,
       // so we just store the association and we skip the track
@@ -1581,12 +1601,6 @@ struct TableMaker {
       for (auto cut = fMuonCuts.begin(); cut != fMuonCuts.end(); cut++, i++) {
         if ((*cut)->IsSelected(VarManager::fgValues)) {
           trackTempFilterMap |= (static_cast<uint8_t>(1) << i);
-          // NOTE: the QA is filled here just for the first occurence of this muon, which means the current association
-          //     will be skipped from histograms if this muon was already filled in the skimming map.
-          //    So if there are histograms of quantities which depend on the collision association, these histograms will not be completely accurate
-          if (fConfigHistOutput.fConfigQA && (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end())) {
-            fHistMan->FillHistClass(Form("Muons_%s", (*cut)->GetName()), VarManager::fgValues);
-          }
           (reinterpret_cast<TH1D*>(fStatsList->At(kStatsMuons)))->Fill(static_cast<float>(i));
         }
       }
@@ -1595,6 +1609,16 @@ struct TableMaker {
       if (!trackTempFilterMap) {
         continue;
       }
+      // NOTE: the QA is filled here just for the first occurence of this muon, and for one out of cfgQASampling muons,
+      //     which means the current association will be skipped from histograms if this muon was already filled in the skimming map.
+      //    So if there are histograms of quantities which depend on the collision association, these histograms will not be completely accurate
+      if (fConfigHistOutput.fConfigQA && (fFwdTrackIndexMap.find(muon.globalIndex()) == fFwdTrackIndexMap.end()) && (fNQAMuons++ % fConfigHistOutput.fConfigQASampling.value == 0)) {
+        for (std::size_t icut = 0; icut < fMuonQAClasses.size(); icut++) {
+          if (trackTempFilterMap & (static_cast<uint32_t>(1) << icut)) {
+            fHistMan->FillHistClass(fMuonQAClasses[icut].Data(), VarManager::fgValues);
+          }
+        }
+      }
       trackFilteringTag = trackTempFilterMap; // BIT0-7:  user selection cuts
 
       // update the index map if this is a new muon (it can already exist in the map from a different collision association)
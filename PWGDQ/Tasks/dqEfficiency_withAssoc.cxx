@@ -21,6 +21,7 @@
 #include "PWGDQ/Core/MCSignalLibrary.h"
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/MixingLibrary.h"
+#include "PWGDQ/Core/ParallelPairing.h"
 #include "PWGDQ/Core/VarManager.h"
 #include "PWGDQ/DataModel/ReducedInfoTables.h"
 
@@ -47,6 +48,7 @@
 #include <TMath.h>
 #include <TMathBase.h>
 #include <TObjString.h>
+#include <TROOT.h>
 #include <TString.h>
 
 #include <RtypesCore.h>
@@ -64,6 +66,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -1403,6 +1406,7 @@ struct AnalysisSameEventPairing {
     Configurable<bool> noCorr{"cfgNoCorrFwdProp", false, "Do not correct for MCS effects in track propagation"};
     Configurable<std::string> collisionSystem{"syst", "pp", "Collision system, pp or PbPb"};
     Configurable<float> centerMassEnergy{"energy", 13600, "Center of mass energy in GeV"};
+    Configurable<int> nPairingThreads{"cfgNPairingThreads", 1, "Number of threads sharing the collisions in the same event pairing (1: serial pairing)"};
   } fConfigOptions;
 
   struct : ConfigurableGroup {
@@ -1434,6 +1438,7 @@ struct AnalysisSameEventPairing {
   Filter eventFilter = aod::dqanalysisflags::isEventSelected > static_cast<uint32_t>(0);
 
   HistogramManager* fHistMan;
+  std::vector<HistogramManager*> fPairingHistMans; // histograms filled by each thread of the same event pairing, the first one being fHistMan
 
   // keep histogram class names in maps, so we don't have to buld their names in the pair loops
   std::map<int, std::vector<TString>> fTrackHistNames;
@@ -1446,6 +1451,7 @@ struct AnalysisSameEventPairing {
   std::vector<MCSignal*> fEmuRecMCSignals;
   std::vector<MCSignal*> fGenMCSignals;
   std::vector<MCSignal*> fFinalStateMCSignals;
+  std::vector<std::vector<MCSignal*>> fPairingRecMCSignals; // rec signals checked by each thread of the same event pairing, the first ones being fRecMCSignals
 
   std::vector<AnalysisCompositeCut> fPairCuts;
   std::vector<AnalysisCut*> fMCGenAccCuts;
@@ -1456,6 +1462,7 @@ struct AnalysisSameEventPairing {
   int fNCutsBarrel;
   int fNCutsMuon;
   int fNPairCuts;
+  int fNPairingThreads = 1; // number of threads of the same event pairing
   bool fHasTwoProngGenMCsignals = false;
 
   bool fEnableBarrelHistos;
@@ -1529,6 +1536,10 @@ struct AnalysisSameEventPairing {
         fRecMCSignals.push_back(mcIt);
       }
     }
+    // the rec signals are checked for all the pairs, the decisions of each MC particle are cached per data frame
+    for (auto& sig : fRecMCSignals) {
+      sig->SetUseCache(true);
+    }
 
     // Setting the MC rec signal names for e-mu pairs (independent list; the pair has leg1=electron, leg2=muon)
     TString emuSigNamesStr = fConfigMC.emuRecSignals.value;
@@ -1939,6 +1950,25 @@ struct AnalysisSameEventPairing {
     dqhistograms::AddHistogramsFromJSON(fHistMan, fConfigAddJSONHistograms.value.c_str()); // ad-hoc histograms via JSON
     VarManager::SetUseVars(fHistMan->GetUsedVars());                                       // provide the list of required variables so that VarManager knows what to fill
     fOutputList.setObject(fHistMan->GetMainHistogramList());
+
+    fNPairingThreads = std::max(fConfigOptions.nPairingThreads.value, 1);
+    fPairingHistMans.assign(fNPairingThreads, fHistMan);
+    fPairingRecMCSignals.assign(fNPairingThreads, fRecMCSignals);
+    if (fNPairingThreads > 1) {
+      ROOT::EnableThreadSafety();
+      // the other threads fill copies of the histograms, added to the output ones at the end of each data frame,
+      // and check copies of the MC signals, which keep their decisions in a cache
+      for (int iThread = 1; iThread < fNPairingThreads; ++iThread) {
+        fPairingHistMans[iThread] = new HistogramManager(Form("analysisHistos%d", iThread), "aa", VarManager::kNVars);
+        fPairingHistMans[iThread]->SetUseDefaultVariableNames(kTRUE);
+        fPairingHistMans[iThread]->SetDefaultVarNames(VarManager::fgVariableNames, VarManager::fgVariableUnits);
+        DefineHistograms(fPairingHistMans[iThread], histNames.Data(), fConfigAddSEPHistogram.value.data());
+        dqhistograms::AddHistogramsFromJSON(fPairingHistMans[iThread], fConfigAddJSONHistograms.value.c_str());
+        for (auto& sig : fPairingRecMCSignals[iThread]) {
+          sig = new MCSignal(*sig);
+        }
+      }
+    }
   }
 
   void initParamsFromCCDB(uint64_t timestamp, bool withTwoProngFitter = true)
@@ -1976,6 +2006,8 @@ struct AnalysisSameEventPairing {
   }
 
   // Template function to run same event pairing (barrel-barrel, muon-muon, barrel-muon)
+  // With cfgNPairingThreads > 1, the collisions are shared among threads, each one with its own VarManager context,
+  // histogram manager and MC signals; the table rows are then written in collision order
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
   void runSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& assocs, TTracks const& /*tracks*/, ReducedMCEvents const& /*mcEvents*/, ReducedMCTracks const& /*mcTracks*/)
   {
@@ -1983,6 +2015,11 @@ struct AnalysisSameEventPairing {
       LOG(warning) << "No events in this TF, going to the next one ...";
       return;
     }
+    for (auto& signals : fPairingRecMCSignals) {
+      for (auto& sig : signals) {
+        sig->ResetCache();
+      }
+    }
     if (fCurrentRun != events.begin().runNumber()) {
       initParamsFromCCDB(events.begin().timestamp(), TTwoProngFitter);
       fCurrentRun = events.begin().runNumber();
@@ -1999,12 +2036,6 @@ struct AnalysisSameEventPairing {
       ncuts = fNCutsMuon;
     }
 
-    uint32_t twoTrackFilter = static_cast<uint32_t>(0);
-    int sign1 = 0;
-    int sign2 = 0;
-    uint32_t mcDecision = static_cast<uint32_t>(0);
-    bool isCorrectAssoc_leg1 = false;
-    bool isCorrectAssoc_leg2 = false;
     dielectronList.reserve(1);
     dimuonList.reserve(1);
     dielectronsExtraList.reserve(1);
@@ -2022,341 +2053,386 @@ struct AnalysisSameEventPairing {
     if (fConfigOptions.polarTables.value) {
       dileptonPolarList.reserve(1);
     }
-    constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
-    constexpr bool trackHasCov = ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelCov) > 0);
 
+    dqpairing::OrderedActions serialRows;
+    std::vector<std::pair<std::decay_t<decltype(events.begin())>, decltype(assocs.sliceBy(preslice, 0))>> collisions;
     for (auto& event : events) {
       if (!event.has_reducedMCevent() || !event.isEventSelected_bit(0)) { // condition on reducedMCevent to avoid rec. events with no generated event
         continue;
       }
-      uint8_t evSel = event.isEventSelected_raw();
-      // Reset the fValues array
-      VarManager::ResetValues(0, VarManager::kNVars);
-      VarManager::FillEvent<gkEventFillMap>(event, VarManager::fgValues);
-      VarManager::FillEvent<VarManager::ObjTypes::ReducedEventMC>(event.reducedMCevent(), VarManager::fgValues);
-
       auto groupedAssocs = assocs.sliceBy(preslice, event.globalIndex());
-      if (groupedAssocs.size() == 0) {
+      if (fNPairingThreads > 1) {
+        collisions.emplace_back(event, groupedAssocs);
         continue;
       }
+      runSameEventPairingInEvent<TTwoProngFitter, TPairType, TEventFillMap, TTrackFillMap, TTracks>(event, groupedAssocs, histNames, histNamesMC, ncuts, fHistMan, fRecMCSignals, serialRows);
+    } // end loop over events
+    if (collisions.empty()) {
+      return;
+    }
 
-      for (auto& [a1, a2] : o2::soa::combinations(groupedAssocs, groupedAssocs)) {
+    // each thread starts from a copy of the configured context, with the fitters set up for the current run
+    std::vector<std::unique_ptr<VarManager::Context>> contexts;
+    for (int iThread = 0; iThread < fNPairingThreads; ++iThread) {
+      contexts.push_back(std::make_unique<VarManager::Context>(*VarManager::GetContext()));
+    }
+    std::vector<dqpairing::OrderedActions> rows(collisions.size(), dqpairing::OrderedActions(true));
+    dqpairing::RunOnWorkers(collisions.size(), fNPairingThreads, [&](std::size_t iCollision, int iThread) {
+      VarManager::SetContext(contexts[iThread].get());
+      auto const& [event, groupedAssocs] = collisions[iCollision];
+      runSameEventPairingInEvent<TTwoProngFitter, TPairType, TEventFillMap, TTrackFillMap, TTracks>(event, groupedAssocs, histNames, histNamesMC, ncuts, fPairingHistMans[iThread], fPairingRecMCSignals[iThread], rows[iCollision]);
+      VarManager::SetContext(nullptr);
+    });
+    for (auto& collisionRows : rows) {
+      collisionRows.Run();
+    }
+    for (int iThread = 1; iThread < fNPairingThreads; ++iThread) {
+      fHistMan->MergeAndReset(*fPairingHistMans[iThread]);
+    }
+  }
+
+  // Same event pairing of the track associations of one collision, using the values of the VarManager context of the
+  // calling thread, filling the histograms of histMan and checking the MC signals recMCSignals
+  // The table rows go through rows, to be written in collision order
+  template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TTracks, typename TEvent, typename TGroupedAssocs>
+  void runSameEventPairingInEvent(TEvent const& event, TGroupedAssocs const& groupedAssocs, std::map<int, std::vector<TString>> const& histNames, std::map<int, std::vector<TString>> const& histNamesMC, int ncuts,
+                                  HistogramManager* histMan, std::vector<MCSignal*> const& recMCSignals, dqpairing::OrderedActions& rows)
+  {
+    constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
+    constexpr bool trackHasCov = ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelCov) > 0);
+    uint32_t twoTrackFilter = static_cast<uint32_t>(0);
+    int sign1 = 0;
+    int sign2 = 0;
+    uint32_t mcDecision = static_cast<uint32_t>(0);
+    bool isCorrectAssoc_leg1 = false;
+    bool isCorrectAssoc_leg2 = false;
+    float* values = VarManager::GetContext()->fValues;
+
+    uint8_t evSel = event.isEventSelected_raw();
+    // Reset the fValues array
+    VarManager::ResetValues(0, VarManager::kNVars);
+    VarManager::FillEvent<gkEventFillMap>(event, values);
+    VarManager::FillEvent<VarManager::ObjTypes::ReducedEventMC>(event.reducedMCevent(), values);
+    if (groupedAssocs.size() == 0) {
+      return;
+    }
 
-        if constexpr (TPairType == VarManager::kDecayToEE) {
-          twoTrackFilter = a1.isBarrelSelected_raw() & a2.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
+    for (auto& [a1, a2] : o2::soa::combinations(groupedAssocs, groupedAssocs)) {
 
-          if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-            continue;
-          }
+      if constexpr (TPairType == VarManager::kDecayToEE) {
+        twoTrackFilter = a1.isBarrelSelected_raw() & a2.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
 
-          auto t1 = a1.template reducedtrack_as<TTracks>();
-          auto t2 = a2.template reducedtrack_as<TTracks>();
-          sign1 = t1.sign();
-          sign2 = t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          if (t1.barrelAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.barrelAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.barrelAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.barrelAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
 
-          // run MC matching for this pair
-          int isig = 0;
-          mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+        auto t1 = a1.template reducedtrack_as<TTracks>();
+        auto t2 = a2.template reducedtrack_as<TTracks>();
+        sign1 = t1.sign();
+        sign2 = t2.sign();
+        // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+        if (t1.barrelAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+        }
+        if (t2.barrelAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+        }
+        if (t1.barrelAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+        }
+        if (t2.barrelAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+        }
+
+        // run MC matching for this pair
+        int isig = 0;
+        mcDecision = 0;
+        for (auto sig = recMCSignals.begin(); sig != recMCSignals.end(); sig++, isig++) {
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-            isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
-            isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+            if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
+              mcDecision |= (static_cast<uint32_t>(1) << isig);
+            }
           }
+        } // end loop over MC signals
+        if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+          isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+          isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+        }
 
-          VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
-          if (fPropTrack) {
-            VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
-          }
-          if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
-          }
-          if constexpr (eventHasQvector) {
-            VarManager::FillPairVn<TPairType>(t1, t2);
-          }
-          if (!fConfigMC.skimSignalOnly || (fConfigMC.skimSignalOnly && mcDecision > 0)) {
-            dielectronList(event.globalIndex(), VarManager::fgValues[VarManager::kMass],
-                           VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi],
-                           t1.sign() + t2.sign(), twoTrackFilter, mcDecision);
+        VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
+        if (fPropTrack) {
+          VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
+        }
+        if constexpr (TTwoProngFitter) {
+          VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+        }
+        if constexpr (eventHasQvector) {
+          VarManager::FillPairVn<TPairType>(t1, t2);
+        }
+        if (!fConfigMC.skimSignalOnly || (fConfigMC.skimSignalOnly && mcDecision > 0)) {
+          rows.WriteRow(dielectronList, event.globalIndex(), values[VarManager::kMass],
+                        values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi],
+                        t1.sign() + t2.sign(), twoTrackFilter, mcDecision);
 
+          if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackCollInfo) > 0) {
+            rows.WriteRow(dielectronInfoList, t1.collisionId(), t1.trackId(), t2.trackId());
+            rows.WriteRow(dileptonInfoList, t1.collisionId(), event.posX(), event.posY(), event.posZ());
+          }
+          if constexpr (trackHasCov && TTwoProngFitter) {
+            rows.WriteRow(dielectronsExtraList, t1.globalIndex(), t2.globalIndex(), values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingLzProjected], values[VarManager::kVertexingLxyProjected]);
             if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackCollInfo) > 0) {
-              dielectronInfoList(t1.collisionId(), t1.trackId(), t2.trackId());
-              dileptonInfoList(t1.collisionId(), event.posX(), event.posY(), event.posZ());
-            }
-            if constexpr (trackHasCov && TTwoProngFitter) {
-              dielectronsExtraList(t1.globalIndex(), t2.globalIndex(), VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingLzProjected], VarManager::fgValues[VarManager::kVertexingLxyProjected]);
-              if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackCollInfo) > 0) {
-                if (fConfigOptions.flatTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-                  dielectronAllList(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), twoTrackFilter, mcDecision,
-                                    t1.pt(), t1.eta(), t1.phi(), t1.itsClusterMap(), t1.itsChi2NCl(), t1.tpcNClsCrossedRows(), t1.tpcNClsFound(), t1.tpcChi2NCl(), t1.dcaXY(), t1.dcaZ(), t1.tpcSignal(), t1.tpcNSigmaEl(), t1.tpcNSigmaPi(), t1.tpcNSigmaPr(), t1.beta(), t1.tofNSigmaEl(), t1.tofNSigmaPi(), t1.tofNSigmaPr(),
-                                    t2.pt(), t2.eta(), t2.phi(), t2.itsClusterMap(), t2.itsChi2NCl(), t2.tpcNClsCrossedRows(), t2.tpcNClsFound(), t2.tpcChi2NCl(), t2.dcaXY(), t2.dcaZ(), t2.tpcSignal(), t2.tpcNSigmaEl(), t2.tpcNSigmaPi(), t2.tpcNSigmaPr(), t2.beta(), t2.tofNSigmaEl(), t2.tofNSigmaPi(), t2.tofNSigmaPr(),
-                                    VarManager::fgValues[VarManager::kKFTrack0DCAxyz], VarManager::fgValues[VarManager::kKFTrack1DCAxyz], VarManager::fgValues[VarManager::kKFDCAxyzBetweenProngs], VarManager::fgValues[VarManager::kKFTrack0DCAxy], VarManager::fgValues[VarManager::kKFTrack1DCAxy], VarManager::fgValues[VarManager::kKFDCAxyBetweenProngs],
-                                    VarManager::fgValues[VarManager::kKFTrack0DeviationFromPV], VarManager::fgValues[VarManager::kKFTrack1DeviationFromPV], VarManager::fgValues[VarManager::kKFTrack0DeviationxyFromPV], VarManager::fgValues[VarManager::kKFTrack1DeviationxyFromPV],
-                                    VarManager::fgValues[VarManager::kKFMass], VarManager::fgValues[VarManager::kKFChi2OverNDFGeo], VarManager::fgValues[VarManager::kVertexingLxyz], VarManager::fgValues[VarManager::kVertexingLxyzOverErr], VarManager::fgValues[VarManager::kVertexingLxy], VarManager::fgValues[VarManager::kVertexingLxyOverErr], VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr], VarManager::fgValues[VarManager::kKFCosPA], VarManager::fgValues[VarManager::kKFJpsiDCAxyz], VarManager::fgValues[VarManager::kKFJpsiDCAxy],
-                                    VarManager::fgValues[VarManager::kKFPairDeviationFromPV], VarManager::fgValues[VarManager::kKFPairDeviationxyFromPV],
-                                    VarManager::fgValues[VarManager::kKFMassGeoTop], VarManager::fgValues[VarManager::kKFChi2OverNDFGeoTop],
-                                    VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjected],
-                                    VarManager::fgValues[VarManager::kVertexingLzProjected], VarManager::fgValues[VarManager::kVertexingLxyProjected]);
-                }
-                if (fConfigOptions.polarTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-                  dileptonPolarList(VarManager::fgValues[VarManager::kCosThetaHE], VarManager::fgValues[VarManager::kPhiHE], VarManager::fgValues[VarManager::kPhiTildeHE],
-                                    VarManager::fgValues[VarManager::kCosThetaCS], VarManager::fgValues[VarManager::kPhiCS], VarManager::fgValues[VarManager::kPhiTildeCS],
-                                    VarManager::fgValues[VarManager::kCosThetaPP], VarManager::fgValues[VarManager::kPhiPP], VarManager::fgValues[VarManager::kPhiTildePP],
-                                    VarManager::fgValues[VarManager::kCosThetaRM],
-                                    VarManager::fgValues[VarManager::kCosThetaStarTPC], VarManager::fgValues[VarManager::kCosThetaStarFT0A], VarManager::fgValues[VarManager::kCosThetaStarFT0C]);
-                }
+              if (fConfigOptions.flatTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+                rows.WriteRow(dielectronAllList, values[VarManager::kMass], values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], t1.sign() + t2.sign(), twoTrackFilter, mcDecision,
+                              t1.pt(), t1.eta(), t1.phi(), t1.itsClusterMap(), t1.itsChi2NCl(), t1.tpcNClsCrossedRows(), t1.tpcNClsFound(), t1.tpcChi2NCl(), t1.dcaXY(), t1.dcaZ(), t1.tpcSignal(), t1.tpcNSigmaEl(), t1.tpcNSigmaPi(), t1.tpcNSigmaPr(), t1.beta(), t1.tofNSigmaEl(), t1.tofNSigmaPi(), t1.tofNSigmaPr(),
+                              t2.pt(), t2.eta(), t2.phi(), t2.itsClusterMap(), t2.itsChi2NCl(), t2.tpcNClsCrossedRows(), t2.tpcNClsFound(), t2.tpcChi2NCl(), t2.dcaXY(), t2.dcaZ(), t2.tpcSignal(), t2.tpcNSigmaEl(), t2.tpcNSigmaPi(), t2.tpcNSigmaPr(), t2.beta(), t2.tofNSigmaEl(), t2.tofNSigmaPi(), t2.tofNSigmaPr(),
+                              values[VarManager::kKFTrack0DCAxyz], values[VarManager::kKFTrack1DCAxyz], values[VarManager::kKFDCAxyzBetweenProngs], values[VarManager::kKFTrack0DCAxy], values[VarManager::kKFTrack1DCAxy], values[VarManager::kKFDCAxyBetweenProngs],
+                              values[VarManager::kKFTrack0DeviationFromPV], values[VarManager::kKFTrack1DeviationFromPV], values[VarManager::kKFTrack0DeviationxyFromPV], values[VarManager::kKFTrack1DeviationxyFromPV],
+                              values[VarManager::kKFMass], values[VarManager::kKFChi2OverNDFGeo], values[VarManager::kVertexingLxyz], values[VarManager::kVertexingLxyzOverErr], values[VarManager::kVertexingLxy], values[VarManager::kVertexingLxyOverErr], values[VarManager::kVertexingTauxy], values[VarManager::kVertexingTauxyErr], values[VarManager::kKFCosPA], values[VarManager::kKFJpsiDCAxyz], values[VarManager::kKFJpsiDCAxy],
+                              values[VarManager::kKFPairDeviationFromPV], values[VarManager::kKFPairDeviationxyFromPV],
+                              values[VarManager::kKFMassGeoTop], values[VarManager::kKFChi2OverNDFGeoTop],
+                              values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingTauxyProjected],
+                              values[VarManager::kVertexingLzProjected], values[VarManager::kVertexingLxyProjected]);
+              }
+              if (fConfigOptions.polarTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+                rows.WriteRow(dileptonPolarList, values[VarManager::kCosThetaHE], values[VarManager::kPhiHE], values[VarManager::kPhiTildeHE],
+                              values[VarManager::kCosThetaCS], values[VarManager::kPhiCS], values[VarManager::kPhiTildeCS],
+                              values[VarManager::kCosThetaPP], values[VarManager::kPhiPP], values[VarManager::kPhiTildePP],
+                              values[VarManager::kCosThetaRM],
+                              values[VarManager::kCosThetaStarTPC], values[VarManager::kCosThetaStarFT0A], values[VarManager::kCosThetaStarFT0C]);
               }
             }
           }
         }
+      }
 
-        if constexpr (TPairType == VarManager::kDecayToMuMu) {
-          twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
-          if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-            continue;
-          }
-          auto t1 = a1.template reducedmuon_as<TTracks>();
-          auto t2 = a2.template reducedmuon_as<TTracks>();
-          if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMFTTrackId() >= 0)
-            continue;
-          sign1 = t1.sign();
-          sign2 = t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          if (t1.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
-
-          // run MC matching for this pair
-          int isig = 0;
-          mcDecision = 0;
-          for (auto sig = fRecMCSignals.begin(); sig != fRecMCSignals.end(); sig++, isig++) {
-            if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
-                mcDecision |= (static_cast<uint32_t>(1) << isig);
-              }
-            }
-          } // end loop over MC signals
+      if constexpr (TPairType == VarManager::kDecayToMuMu) {
+        twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
+        auto t1 = a1.template reducedmuon_as<TTracks>();
+        auto t2 = a2.template reducedmuon_as<TTracks>();
+        if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
+          continue;
+        if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMFTTrackId() >= 0)
+          continue;
+        sign1 = t1.sign();
+        sign2 = t2.sign();
+        // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+        if (t1.muonAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+        }
+        if (t2.muonAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+        }
+        if (t1.muonAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+        }
+        if (t2.muonAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+        }
 
+        // run MC matching for this pair
+        int isig = 0;
+        mcDecision = 0;
+        for (auto sig = recMCSignals.begin(); sig != recMCSignals.end(); sig++, isig++) {
           if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-            isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
-            isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+            if ((*sig)->CheckSignal(true, t1.reducedMCTrack(), t2.reducedMCTrack())) {
+              mcDecision |= (static_cast<uint32_t>(1) << isig);
+            }
           }
+        } // end loop over MC signals
 
-          VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
-          if (fPropTrack) {
-            VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
-          }
-          if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
-          }
-          if constexpr (eventHasQvector) {
-            VarManager::FillPairVn<TPairType>(t1, t2);
-          }
+        if (t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+          isCorrectAssoc_leg1 = (t1.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+          isCorrectAssoc_leg2 = (t2.reducedMCTrack().reducedMCevent() == event.reducedMCevent());
+        }
 
-          dimuonList(event.globalIndex(), VarManager::fgValues[VarManager::kMass],
-                     VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi],
-                     t1.sign() + t2.sign(), twoTrackFilter, mcDecision);
-          if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedMuonCollInfo) > 0) {
-            dileptonInfoList(t1.collisionId(), event.posX(), event.posY(), event.posZ());
-          }
+        VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
+        if (fPropTrack) {
+          VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
+        }
+        if constexpr (TTwoProngFitter) {
+          VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+        }
+        if constexpr (eventHasQvector) {
+          VarManager::FillPairVn<TPairType>(t1, t2);
+        }
 
-          if constexpr (TTwoProngFitter) {
-            dimuonsExtraList(t1.globalIndex(), t2.globalIndex(), VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingLz], VarManager::fgValues[VarManager::kVertexingLxy]);
-            if (fConfigOptions.flatTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
-              dimuonAllList(event.posX(), event.posY(), event.posZ(), event.numContrib(),
-                            event.selection_raw(), evSel,
-                            event.reducedMCevent().mcPosX(), event.reducedMCevent().mcPosY(), event.reducedMCevent().mcPosZ(),
-                            VarManager::fgValues[VarManager::kMass],
-                            mcDecision,
-                            VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
-                            VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
-                            VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
-                            VarManager::fgValues[VarManager::kCosPointingAngle],
-                            VarManager::fgValues[VarManager::kPt1], VarManager::fgValues[VarManager::kEta1], VarManager::fgValues[VarManager::kPhi1], t1.sign(),
-                            VarManager::fgValues[VarManager::kPt2], VarManager::fgValues[VarManager::kEta2], VarManager::fgValues[VarManager::kPhi2], t2.sign(),
-                            t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
-                            t1.mcMask(), t2.mcMask(),
-                            t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
-                            t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
-                            t1.chi2(), t2.chi2(),
-                            t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(), t1.reducedMCTrack().e(),
-                            t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(), t2.reducedMCTrack().e(),
-                            t1.reducedMCTrack().vx(), t1.reducedMCTrack().vy(), t1.reducedMCTrack().vz(), t1.reducedMCTrack().vt(),
-                            t2.reducedMCTrack().vx(), t2.reducedMCTrack().vy(), t2.reducedMCTrack().vz(), t2.reducedMCTrack().vt(),
-                            (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
-                            isCorrectAssoc_leg1, isCorrectAssoc_leg2,
-                            -999.0, -999.0, -999.0, -999.0, -999.0,
-                            -999.0, -999.0, -999.0, -999.0, -999.0,
-                            -999.0, VarManager::fgValues[VarManager::kMultDimuons],
-                            VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
-            }
-          }
+        rows.WriteRow(dimuonList, event.globalIndex(), values[VarManager::kMass],
+                      values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi],
+                      t1.sign() + t2.sign(), twoTrackFilter, mcDecision);
+        if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedMuonCollInfo) > 0) {
+          rows.WriteRow(dileptonInfoList, t1.collisionId(), event.posX(), event.posY(), event.posZ());
         }
-        // Fill histograms
-        bool isAmbiInBunch = false;
-        bool isAmbiOutOfBunch = false;
-        bool isCorrect_pair = false;
-        if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2)
-          isCorrect_pair = true;
 
-        for (int icut = 0; icut < ncuts; icut++) {
-          if (twoTrackFilter & (static_cast<uint32_t>(1) << icut)) {
-            isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
-            isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
-            if (sign1 * sign2 < 0) {                                                    // +- pairs
-              fHistMan->FillHistClass(histNames[icut][0].Data(), VarManager::fgValues); // reconstructed, unmatched
-              for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) {        // loop over MC signals
-                if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                  PromptNonPromptSepTable(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kRap], VarManager::fgValues[VarManager::kPhi],
-                                          VarManager::fgValues[VarManager::kVertexingTauxyProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMass], VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV],
-                                          VarManager::fgValues[VarManager::kVtxX], VarManager::fgValues[VarManager::kVtxY], VarManager::fgValues[VarManager::kVtxZ], VarManager::fgValues[VarManager::kDCAxy1], VarManager::fgValues[VarManager::kDCAz1], VarManager::fgValues[VarManager::kITSclusterMap1], VarManager::fgValues[VarManager::kTPCnSigmaEl1], VarManager::fgValues[VarManager::kDCAxy2], VarManager::fgValues[VarManager::kDCAz2], VarManager::fgValues[VarManager::kITSclusterMap2], VarManager::fgValues[VarManager::kTPCnSigmaEl2],
-                                          isAmbiInBunch, isAmbiOutOfBunch, isCorrect_pair, VarManager::fgValues[VarManager::kMultFT0A], VarManager::fgValues[VarManager::kMultFT0C], VarManager::fgValues[VarManager::kCentFT0M], VarManager::fgValues[VarManager::kVtxNcontribReal]);
-                  fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][0].Data(), VarManager::fgValues); // matched signal
-                  if (useMiniTree.fConfigMiniTree) {
-                    if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                      twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
-                      if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-                        continue;
-                      }
-                      auto t1 = a1.template reducedmuon_as<TTracks>();
-                      auto t2 = a2.template reducedmuon_as<TTracks>();
-
-                      float dileptonMass = VarManager::fgValues[VarManager::kMass];
-                      if (dileptonMass > useMiniTree.fConfigMiniTreeMinMass && dileptonMass < useMiniTree.fConfigMiniTreeMaxMass) {
-                        // In the miniTree the positive daughter is positioned as first
-                        if (t1.sign() > 0) {
-                          dileptonMiniTreeRec(mcDecision,
-                                              VarManager::fgValues[VarManager::kMass],
-                                              VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kCentFT0C],
-                                              t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
-                                              t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
-                                              t1.pt(), t1.eta(), t1.phi(),
-                                              t2.pt(), t2.eta(), t2.phi());
-                        } else {
-                          dileptonMiniTreeRec(mcDecision,
-                                              VarManager::fgValues[VarManager::kMass],
-                                              VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], VarManager::fgValues[VarManager::kCentFT0C],
-                                              t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
-                                              t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
-                                              t2.pt(), t2.eta(), t2.phi(),
-                                              t1.pt(), t1.eta(), t1.phi());
-                        }
-                      }
-                    }
-                  }
-                  if (fConfigQA) {
-                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) { // correct track-collision association
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][3].Data(), VarManager::fgValues);
-                    } else { // incorrect track-collision association
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][4].Data(), VarManager::fgValues);
-                    }
-                    if (isAmbiInBunch) { // ambiguous in bunch
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][5].Data(), VarManager::fgValues);
-                      if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][6].Data(), VarManager::fgValues);
-                      } else {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][7].Data(), VarManager::fgValues);
-                      }
+        if constexpr (TTwoProngFitter) {
+          rows.WriteRow(dimuonsExtraList, t1.globalIndex(), t2.globalIndex(), values[VarManager::kVertexingTauz], values[VarManager::kVertexingLz], values[VarManager::kVertexingLxy]);
+          if (fConfigOptions.flatTables.value && t1.has_reducedMCTrack() && t2.has_reducedMCTrack()) {
+            rows.WriteRow(dimuonAllList, event.posX(), event.posY(), event.posZ(), event.numContrib(),
+                          event.selection_raw(), evSel,
+                          event.reducedMCevent().mcPosX(), event.reducedMCevent().mcPosY(), event.reducedMCevent().mcPosZ(),
+                          values[VarManager::kMass],
+                          mcDecision,
+                          values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], t1.sign() + t2.sign(), values[VarManager::kVertexingChi2PCA],
+                          values[VarManager::kVertexingTauz], values[VarManager::kVertexingTauzErr],
+                          values[VarManager::kVertexingTauxy], values[VarManager::kVertexingTauxyErr],
+                          values[VarManager::kCosPointingAngle],
+                          values[VarManager::kPt1], values[VarManager::kEta1], values[VarManager::kPhi1], t1.sign(),
+                          values[VarManager::kPt2], values[VarManager::kEta2], values[VarManager::kPhi2], t2.sign(),
+                          t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
+                          t1.mcMask(), t2.mcMask(),
+                          t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
+                          t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
+                          t1.chi2(), t2.chi2(),
+                          t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(), t1.reducedMCTrack().e(),
+                          t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(), t2.reducedMCTrack().e(),
+                          t1.reducedMCTrack().vx(), t1.reducedMCTrack().vy(), t1.reducedMCTrack().vz(), t1.reducedMCTrack().vt(),
+                          t2.reducedMCTrack().vx(), t2.reducedMCTrack().vy(), t2.reducedMCTrack().vz(), t2.reducedMCTrack().vt(),
+                          (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
+                          isCorrectAssoc_leg1, isCorrectAssoc_leg2,
+                          -999.0, -999.0, -999.0, -999.0, -999.0,
+                          -999.0, -999.0, -999.0, -999.0, -999.0,
+                          -999.0, values[VarManager::kMultDimuons],
+                          values[VarManager::kVertexingPz], values[VarManager::kVertexingSV]);
+          }
+        }
+      }
+      // Fill histograms
+      bool isAmbiInBunch = false;
+      bool isAmbiOutOfBunch = false;
+      bool isCorrect_pair = false;
+      if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2)
+        isCorrect_pair = true;
+
+      for (int icut = 0; icut < ncuts; icut++) {
+        if (twoTrackFilter & (static_cast<uint32_t>(1) << icut)) {
+          isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
+          isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
+          if (sign1 * sign2 < 0) {                                            // +- pairs
+            histMan->FillHistClass(histNames.at(icut)[0].Data(), values);     // reconstructed, unmatched
+            for (unsigned int isig = 0; isig < recMCSignals.size(); isig++) { // loop over MC signals
+              if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
+                rows.WriteRow(PromptNonPromptSepTable, values[VarManager::kMass], values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kRap], values[VarManager::kPhi],
+                              values[VarManager::kVertexingTauxyProjected], values[VarManager::kVertexingTauxyProjectedPoleJPsiMass], values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV],
+                              values[VarManager::kVtxX], values[VarManager::kVtxY], values[VarManager::kVtxZ], values[VarManager::kDCAxy1], values[VarManager::kDCAz1], values[VarManager::kITSclusterMap1], values[VarManager::kTPCnSigmaEl1], values[VarManager::kDCAxy2], values[VarManager::kDCAz2], values[VarManager::kITSclusterMap2], values[VarManager::kTPCnSigmaEl2],
+                              isAmbiInBunch, isAmbiOutOfBunch, isCorrect_pair, values[VarManager::kMultFT0A], values[VarManager::kMultFT0C], values[VarManager::kCentFT0M], values[VarManager::kVtxNcontribReal]);
+                histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[0].Data(), values); // matched signal
+                if (useMiniTree.fConfigMiniTree) {
+                  if constexpr (TPairType == VarManager::kDecayToMuMu) {
+                    twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
+                    if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+                      continue;
                     }
-                    if (isAmbiOutOfBunch) { // ambiguous out of bunch
-                      fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][8].Data(), VarManager::fgValues);
-                      if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][9].Data(), VarManager::fgValues);
+                    auto t1 = a1.template reducedmuon_as<TTracks>();
+                    auto t2 = a2.template reducedmuon_as<TTracks>();
+
+                    float dileptonMass = values[VarManager::kMass];
+                    if (dileptonMass > useMiniTree.fConfigMiniTreeMinMass && dileptonMass < useMiniTree.fConfigMiniTreeMaxMass) {
+                      // In the miniTree the positive daughter is positioned as first
+                      if (t1.sign() > 0) {
+                        rows.WriteRow(dileptonMiniTreeRec, mcDecision,
+                                      values[VarManager::kMass],
+                                      values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], values[VarManager::kCentFT0C],
+                                      t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
+                                      t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
+                                      t1.pt(), t1.eta(), t1.phi(),
+                                      t2.pt(), t2.eta(), t2.phi());
                       } else {
-                        fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][10].Data(), VarManager::fgValues);
+                        rows.WriteRow(dileptonMiniTreeRec, mcDecision,
+                                      values[VarManager::kMass],
+                                      values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], values[VarManager::kCentFT0C],
+                                      t2.reducedMCTrack().pt(), t2.reducedMCTrack().eta(), t2.reducedMCTrack().phi(),
+                                      t1.reducedMCTrack().pt(), t1.reducedMCTrack().eta(), t1.reducedMCTrack().phi(),
+                                      t2.pt(), t2.eta(), t2.phi(),
+                                      t1.pt(), t1.eta(), t1.phi());
                       }
                     }
                   }
                 }
                 if (fConfigQA) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
+                  if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) { // correct track-collision association
+                    histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[3].Data(), values);
+                  } else { // incorrect track-collision association
+                    histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[4].Data(), values);
+                  }
+                  if (isAmbiInBunch) { // ambiguous in bunch
+                    histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[5].Data(), values);
+                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
+                      histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[6].Data(), values);
+                    } else {
+                      histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[7].Data(), values);
+                    }
                   }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3 + 3].Data(), VarManager::fgValues);
+                  if (isAmbiOutOfBunch) { // ambiguous out of bunch
+                    histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[8].Data(), values);
+                    if (isCorrectAssoc_leg1 && isCorrectAssoc_leg2) {
+                      histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[9].Data(), values);
+                    } else {
+                      histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[10].Data(), values);
+                    }
                   }
                 }
               }
-            } else {
-              if (sign1 > 0) { // ++ pairs
-                fHistMan->FillHistClass(histNames[icut][1].Data(), VarManager::fgValues);
-                for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) { // loop over MC signals
-                  if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                    fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][1].Data(), VarManager::fgValues);
-                  }
+              if (fConfigQA) {
+                if (isAmbiInBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[3].Data(), values);
                 }
-                if (fConfigQA) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][4 + 3].Data(), VarManager::fgValues);
-                  }
+                if (isAmbiOutOfBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[3 + 3].Data(), values);
                 }
-              } else { // -- pairs
-                fHistMan->FillHistClass(histNames[icut][2].Data(), VarManager::fgValues);
-                for (unsigned int isig = 0; isig < fRecMCSignals.size(); isig++) { // loop over MC signals
-                  if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
-                    fHistMan->FillHistClass(histNamesMC[icut * fRecMCSignals.size() + isig][2].Data(), VarManager::fgValues);
-                  }
+              }
+            }
+          } else {
+            if (sign1 > 0) { // ++ pairs
+              histMan->FillHistClass(histNames.at(icut)[1].Data(), values);
+              for (unsigned int isig = 0; isig < recMCSignals.size(); isig++) { // loop over MC signals
+                if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
+                  histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[1].Data(), values);
                 }
-                if (fConfigQA) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][5 + 3].Data(), VarManager::fgValues);
-                  }
+              }
+              if (fConfigQA) {
+                if (isAmbiInBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[4].Data(), values);
+                }
+                if (isAmbiOutOfBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[4 + 3].Data(), values);
                 }
               }
-            }
-            for (unsigned int iPairCut = 0; iPairCut < fPairCuts.size(); iPairCut++) {
-              AnalysisCompositeCut cut = fPairCuts.at(iPairCut);
-              if (!(cut.IsSelected(VarManager::fgValues))) // apply pair cuts
-                continue;
-              if (sign1 * sign2 < 0) {
-                fHistMan->FillHistClass(histNames[ncuts + icut * fPairCuts.size() + iPairCut][0].Data(), VarManager::fgValues);
-              } else {
-                if (sign1 > 0) {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * fPairCuts.size() + iPairCut][1].Data(), VarManager::fgValues);
-                } else {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * fPairCuts.size() + iPairCut][2].Data(), VarManager::fgValues);
+            } else { // -- pairs
+              histMan->FillHistClass(histNames.at(icut)[2].Data(), values);
+              for (unsigned int isig = 0; isig < recMCSignals.size(); isig++) { // loop over MC signals
+                if (mcDecision & (static_cast<uint32_t>(1) << isig)) {
+                  histMan->FillHistClass(histNamesMC.at(icut * recMCSignals.size() + isig)[2].Data(), values);
                 }
               }
-            } // end loop (pair cuts)
+              if (fConfigQA) {
+                if (isAmbiInBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[5].Data(), values);
+                }
+                if (isAmbiOutOfBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[5 + 3].Data(), values);
+                }
+              }
+            }
           }
-        } // end loop (cuts)
-      } // end loop over pairs of track associations
-    } // end loop over events
+          for (unsigned int iPairCut = 0; iPairCut < fPairCuts.size(); iPairCut++) {
+            AnalysisCompositeCut cut = fPairCuts.at(iPairCut);
+            if (!(cut.IsSelected(values))) // apply pair cuts
+              continue;
+            if (sign1 * sign2 < 0) {
+              histMan->FillHistClass(histNames.at(ncuts + icut * fPairCuts.size() + iPairCut)[0].Data(), values);
+            } else {
+              if (sign1 > 0) {
+                histMan->FillHistClass(histNames.at(ncuts + icut * fPairCuts.size() + iPairCut)[1].Data(), values);
+              } else {
+                histMan->FillHistClass(histNames.at(ncuts + icut * fPairCuts.size() + iPairCut)[2].Data(), values);
+              }
+            }
+          } // end loop (pair cuts)
+        }
+      } // end loop (cuts)
+    } // end loop over pairs of track associations
   }
 
   PresliceUnsorted<ReducedMCTracks> perReducedMcEvent = aod::reducedtrackMC::reducedMCeventId;
@@ -20,6 +20,8 @@
 #include "PWGDQ/Core/HistogramsLibrary.h"
 #include "PWGDQ/Core/MixingHandler.h"
 #include "PWGDQ/Core/MixingLibrary.h"
+#include "PWGDQ/Core/MixingPool.h"
+#include "PWGDQ/Core/ParallelPairing.h"
 #include "PWGDQ/Core/VarManager.h"
 #include "PWGDQ/DataModel/ReducedInfoTables.h"
 
@@ -54,6 +56,7 @@
 #include <TMath.h>
 #include <TMathBase.h>
 #include <TObjString.h>
+#include <TROOT.h>
 #include <TString.h>
 
 #include <RtypesCore.h>
@@ -61,6 +64,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
@@ -70,6 +74,7 @@
 #include <map>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -1306,6 +1311,7 @@ struct AnalysisSameEventPairing {
   } fConfigCuts;
 
   Configurable<int> fConfigMixingDepth{"cfgMixingDepth", 100, "Number of Events stored for event mixing"};
+  Configurable<bool> fConfigUseMixingPool{"cfgUseMixingPool", false, "If true, mix the barrel and muon pairs with the events of a pool kept across data frames"};
   // Configurable<std::string> fConfigAddEventMixingHistogram{"cfgAddEventMixingHistogram", "", "Comma separated list of histograms"};
   Configurable<std::string> fConfigAddSEPHistogram{"cfgAddSEPHistogram", "", "Comma separated list of histograms"};
   Configurable<std::string> fConfigAddJSONHistograms{"cfgAddJSONHistograms", "", "Histograms in JSON format"};
@@ -1337,6 +1343,7 @@ struct AnalysisSameEventPairing {
     Configurable<bool> useRemoteCollisionInfo{"cfgUseRemoteCollisionInfo", false, "Use remote collision information from CCDB"};
     Configurable<bool> useEfficiencyWeighting{"cfgUseEfficiencyWeighting", false, "Apply efficiency weighting to the pairs from CCDB"};
     Configurable<int> efficiencyType{"cfgEfficiencyType", 0, "Type of efficiency to apply from CCDB: 0 no efficiency, 1 pt-cent-costhetastar"};
+    Configurable<int> nPairingThreads{"cfgNPairingThreads", 1, "Number of threads sharing the collisions in the same event pairing (1: serial pairing)"};
   } fConfigOptions;
   struct : ConfigurableGroup {
     Configurable<bool> applyBDT{"applyBDT", false, "Flag to apply ML selections"};
@@ -1352,7 +1359,8 @@ struct AnalysisSameEventPairing {
 
   Filter filterEventSelected = aod::dqanalysisflags::isEventSelected > static_cast<uint8_t>(0);
 
-  HistogramManager* fHistMan;
+  HistogramManager* fHistMan = nullptr;
+  std::vector<HistogramManager*> fPairingHistMans; // histograms filled by each thread of the same event pairing, the first one being fHistMan
 
   o2::analysis::DQMlResponse<float> fDQMlResponse;
   std::vector<float> fOutputMlPsi2ee = {}; // TODO: check this is needed or not
@@ -1365,6 +1373,8 @@ struct AnalysisSameEventPairing {
   std::vector<TString> fTrackCuts;
   std::vector<TString> fMuonCuts;
   std::map<std::pair<uint32_t, uint32_t>, uint32_t> fAmbiguousPairs;
+  MixingPool fBarrelMixingPool; // events kept for the barrel mixing across data frames
+  MixingPool fMuonMixingPool;   // events kept for the muon mixing across data frames
 
   uint32_t fTrackFilterMask; // mask for the track cuts required in this task to be applied on the barrel cuts produced upstream
   uint32_t fMuonFilterMask;  // mask for the muon cuts required in this task to be applied on the muon cuts produced upstream
@@ -1372,6 +1382,7 @@ struct AnalysisSameEventPairing {
   int fNCutsMuon;
   int fNPairCuts;
   int fNPairPerEvent;
+  int fNPairingThreads = 1; // number of threads of the same event pairing
 
   bool fEnableBarrelMixingHistos;
   bool fEnableBarrelHistos;
@@ -1621,6 +1632,8 @@ struct AnalysisSameEventPairing {
     }
 
     fCurrentRun = 0;
+    fBarrelMixingPool.init(fConfigMixingDepth.value);
+    fMuonMixingPool.init(fConfigMixingDepth.value);
 
     fCCDB->setURL(fConfigCCDB.url.value);
     fCCDB->setCaching(true);
@@ -1693,17 +1706,39 @@ struct AnalysisSameEventPairing {
       fHistMan->SetUseDefaultVariableNames(true);
       fHistMan->SetDefaultVarNames(VarManager::fgVariableNames, VarManager::fgVariableUnits);
       VarManager::SetCollisionSystem((TString)fConfigOptions.collisionSystem, fConfigOptions.centerMassEnergy); // set collision system and center of mass energy
-      DefineHistograms(fHistMan, histNames.Data(), fConfigAddSEPHistogram.value.data());                        // define all histograms
-      if (fEnableBarrelHistos) {
-        DefineHistograms(fHistMan, "PairingSEQA", "sameevent-pairing"); // histograms for QA of the pairing
-      }
-      if (fEnableBarrelMixingHistos) {
-        DefineHistograms(fHistMan, "PairingMEQA", "mixedevent-pairing"); // histograms for QA of the pairing
-      }
-      dqhistograms::AddHistogramsFromJSON(fHistMan, fConfigAddJSONHistograms.value.c_str()); // ad-hoc histograms via JSON
-      VarManager::SetUseVars(fHistMan->GetUsedVars());                                       // provide the list of required variables so that VarManager knows what to fill
+      defineHistograms(fHistMan, histNames);
+      VarManager::SetUseVars(fHistMan->GetUsedVars()); // provide the list of required variables so that VarManager knows what to fill
       fOutputList.setObject(fHistMan->GetMainHistogramList());
     }
+
+    fNPairingThreads = std::max(fConfigOptions.nPairingThreads.value, 1);
+    if (fNPairingThreads > 1 && fConfigML.applyBDT) {
+      LOG(warning) << "The BDT selection cannot run in parallel, the same event pairing runs on one thread";
+      fNPairingThreads = 1;
+    }
+    fPairingHistMans.assign(fNPairingThreads, fHistMan);
+    if (fNPairingThreads > 1) {
+      ROOT::EnableThreadSafety();
+      // the other threads fill copies of the histograms, added to the output ones at the end of each data frame
+      for (int iThread = 1; iThread < fNPairingThreads && fConfigQA; ++iThread) {
+        fPairingHistMans[iThread] = new HistogramManager(Form("analysisHistos%d", iThread), "aa", VarManager::kNVars);
+        fPairingHistMans[iThread]->SetUseDefaultVariableNames(true);
+        fPairingHistMans[iThread]->SetDefaultVarNames(VarManager::fgVariableNames, VarManager::fgVariableUnits);
+        defineHistograms(fPairingHistMans[iThread], histNames);
+      }
+    }
+  }
+
+  void defineHistograms(HistogramManager* histMan, TString const& histNames)
+  {
+    DefineHistograms(histMan, histNames.Data(), fConfigAddSEPHistogram.value.data()); // define all histograms
+    if (fEnableBarrelHistos) {
+      DefineHistograms(histMan, "PairingSEQA", "sameevent-pairing"); // histograms for QA of the pairing
+    }
+    if (fEnableBarrelMixingHistos) {
+      DefineHistograms(histMan, "PairingMEQA", "mixedevent-pairing"); // histograms for QA of the pairing
+    }
+    dqhistograms::AddHistogramsFromJSON(histMan, fConfigAddJSONHistograms.value.c_str()); // ad-hoc histograms via JSON
   }
 
   void initParamsFromCCDB(uint64_t timestamp, int runNumber, bool withTwoProngFitter = true)
@@ -1758,6 +1793,8 @@ struct AnalysisSameEventPairing {
   }
 
   // Template function to run same event pairing (barrel-barrel, muon-muon, barrel-muon)
+  // With cfgNPairingThreads > 1, the collisions are shared among threads, each one with its own VarManager context and
+  // histogram manager; the table rows and the bookkeeping done over the data frame are then written in collision order
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TEvents, typename TTrackAssocs, typename TTracks>
   void runSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice, TTrackAssocs const& assocs, TTracks const& /*tracks*/)
   {
@@ -1790,10 +1827,6 @@ struct AnalysisSameEventPairing {
       histNames = fTrackMuonHistNames;
     }*/
 
-    uint32_t twoTrackFilter = static_cast<uint32_t>(0);
-    uint32_t dileptonMcDecision = static_cast<uint32_t>(0); // placeholder, copy of the dqEfficiency.cxx one
-    int sign1 = 0;
-    int sign2 = 0;
     // Reserve capacity for the output tables to avoid repeated reallocations
     // inside the Arrow builders.  Unused capacity is virtual address space
     // only — pages are not faulted in until written.
@@ -1813,12 +1846,10 @@ struct AnalysisSameEventPairing {
       dileptonPolarList.reserve(nAssocs);
     }
     fAmbiguousPairs.clear();
-    constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
-    constexpr bool eventHasQvectorCentr = ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0);
-    constexpr bool trackHasCov = ((TTrackFillMap & VarManager::ObjTypes::TrackCov) > 0 || (TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelCov) > 0);
-    bool isSelectedBDT = false;
     fNPairPerEvent = 0;
 
+    dqpairing::OrderedActions serialRows;
+    std::vector<std::pair<std::decay_t<decltype(events.begin())>, decltype(assocs.sliceBy(preslice, 0))>> collisions;
     for (auto& event : events) {
       if (!event.isEventSelected_bit(0)) {
         continue;
@@ -1826,371 +1857,443 @@ struct AnalysisSameEventPairing {
       if (fConfigCuts.event && event.isEventSelected_bit(2)) {
         continue;
       }
-      uint8_t evSel = event.isEventSelected_raw();
-      // Reset the fValues array
-      VarManager::ResetValues(0, VarManager::kNVars);
-      // VarManager::FillEvent<gkEventFillMap>(event, VarManager::fgValues);
-      VarManager::FillEvent<TEventFillMap>(event, VarManager::fgValues);
-
       auto groupedAssocs = assocs.sliceBy(preslice, event.globalIndex());
-      if (groupedAssocs.size() == 0) {
+      if (fNPairingThreads > 1) {
+        collisions.emplace_back(event, groupedAssocs);
         continue;
       }
+      runSameEventPairingInEvent<TTwoProngFitter, TPairType, TEventFillMap, TTrackFillMap, TTracks>(event, groupedAssocs, histNames, ncuts, histIdxOffset, fHistMan, serialRows);
+    } // end loop over events
+    if (collisions.empty()) {
+      return;
+    }
 
-      bool isFirst = true;
-      for (auto& [a1, a2] : o2::soa::combinations(groupedAssocs, groupedAssocs)) {
-        if constexpr (TPairType == VarManager::kDecayToEE) {
-          twoTrackFilter = a1.isBarrelSelected_raw() & a2.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
+    // each thread starts from a copy of the configured context, with the fitters set up for the current run
+    std::vector<std::unique_ptr<VarManager::Context>> contexts;
+    for (int iThread = 0; iThread < fNPairingThreads; ++iThread) {
+      contexts.push_back(std::make_unique<VarManager::Context>(*VarManager::GetContext()));
+    }
+    std::vector<dqpairing::OrderedActions> rows(collisions.size(), dqpairing::OrderedActions(true));
+    dqpairing::RunOnWorkers(collisions.size(), fNPairingThreads, [&](std::size_t iCollision, int iThread) {
+      VarManager::SetContext(contexts[iThread].get());
+      auto const& [event, groupedAssocs] = collisions[iCollision];
+      runSameEventPairingInEvent<TTwoProngFitter, TPairType, TEventFillMap, TTrackFillMap, TTracks>(event, groupedAssocs, histNames, ncuts, histIdxOffset, fPairingHistMans[iThread], rows[iCollision]);
+      VarManager::SetContext(nullptr);
+    });
+    for (auto& collisionRows : rows) {
+      collisionRows.Run();
+    }
+    if (fConfigQA) {
+      for (int iThread = 1; iThread < fNPairingThreads; ++iThread) {
+        fHistMan->MergeAndReset(*fPairingHistMans[iThread]);
+      }
+    }
+  }
 
-          if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-            continue;
-          }
+  // Same event pairing of the track associations of one collision, using the values of the VarManager context of the
+  // calling thread and filling the histograms of histMan
+  // The table rows and what depends on the previous collisions go through rows, to be written in collision order
+  template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, typename TTracks, typename TEvent, typename TGroupedAssocs>
+  void runSameEventPairingInEvent(TEvent const& event, TGroupedAssocs const& groupedAssocs, std::map<int, std::vector<TString>> const& histNames, int ncuts, int histIdxOffset,
+                                  HistogramManager* histMan, dqpairing::OrderedActions& rows)
+  {
+    constexpr bool eventHasQvector = ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0);
+    constexpr bool eventHasQvectorCentr = ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0);
+    constexpr bool trackHasCov = ((TTrackFillMap & VarManager::ObjTypes::TrackCov) > 0 || (TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelCov) > 0);
+    uint32_t twoTrackFilter = static_cast<uint32_t>(0);
+    uint32_t dileptonMcDecision = static_cast<uint32_t>(0); // placeholder, copy of the dqEfficiency.cxx one
+    int sign1 = 0;
+    int sign2 = 0;
+    bool isSelectedBDT = false;
+    float* values = VarManager::GetContext()->fValues;
 
-          auto t1 = a1.template reducedtrack_as<TTracks>();
-          auto t2 = a2.template reducedtrack_as<TTracks>();
-          sign1 = t1.sign();
-          sign2 = t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          // TODO: Make sure that we do not work with more than 28 track bits
-          if (t1.barrelAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.barrelAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.barrelAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.barrelAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
+    uint8_t evSel = event.isEventSelected_raw();
+    // Reset the fValues array
+    VarManager::ResetValues(0, VarManager::kNVars);
+    VarManager::FillEvent<TEventFillMap>(event, values);
+    if (groupedAssocs.size() == 0) {
+      return;
+    }
 
-          fNPairPerEvent++;
-          VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
-          // compute quantities which depend on the associated collision, such as DCA
-          if (fConfigOptions.propTrack) {
-            VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
-          }
-          if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
-          }
-          if constexpr (eventHasQvector) {
-            VarManager::FillPairVn<TPairType>(t1, t2);
-          }
-          if constexpr (eventHasQvectorCentr) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
+    int nPairs = 0;
+    bool isFirst = true;
+    for (auto& [a1, a2] : o2::soa::combinations(groupedAssocs, groupedAssocs)) {
+      if constexpr (TPairType == VarManager::kDecayToEE) {
+        twoTrackFilter = a1.isBarrelSelected_raw() & a2.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
 
-          if (fConfigOptions.useEfficiencyWeighting) {
-            VarManager::FillEfficiency();
-          }
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
 
-          dielectronList(event.globalIndex(), VarManager::fgValues[VarManager::kMass],
-                         VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi],
-                         t1.sign() + t2.sign(), twoTrackFilter, 0);
+        auto t1 = a1.template reducedtrack_as<TTracks>();
+        auto t2 = a2.template reducedtrack_as<TTracks>();
+        sign1 = t1.sign();
+        sign2 = t2.sign();
+        // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+        // TODO: Make sure that we do not work with more than 28 track bits
+        if (t1.barrelAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+        }
+        if (t2.barrelAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+        }
+        if (t1.barrelAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+        }
+        if (t2.barrelAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+        }
 
-          if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackCollInfo) > 0) {
-            dielectronInfoList(t1.collisionId(), t1.trackId(), t2.trackId());
-            dileptonInfoList(t1.collisionId(), event.posX(), event.posY(), event.posZ());
-          }
-          if (fConfigOptions.polarTables.value) {
-            dileptonPolarList(VarManager::fgValues[VarManager::kCosThetaHE], VarManager::fgValues[VarManager::kPhiHE], VarManager::fgValues[VarManager::kPhiTildeHE],
-                              VarManager::fgValues[VarManager::kCosThetaCS], VarManager::fgValues[VarManager::kPhiCS], VarManager::fgValues[VarManager::kPhiTildeCS],
-                              VarManager::fgValues[VarManager::kCosThetaPP], VarManager::fgValues[VarManager::kPhiPP], VarManager::fgValues[VarManager::kPhiTildePP],
-                              VarManager::fgValues[VarManager::kCosThetaRM],
-                              VarManager::fgValues[VarManager::kCosThetaStarTPC], VarManager::fgValues[VarManager::kCosThetaStarFT0A], VarManager::fgValues[VarManager::kCosThetaStarFT0C]);
-          }
-          if constexpr (trackHasCov && TTwoProngFitter) {
-            dielectronsExtraList(t1.globalIndex(), t2.globalIndex(), VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingLzProjected], VarManager::fgValues[VarManager::kVertexingLxyProjected]);
-            if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelPID) > 0) {
-              if (fConfigML.applyBDT) {
-                std::vector<float> dqInputFeatures = fDQMlResponse.getInputFeatures(t1, t2, VarManager::fgValues);
-
-                if (dqInputFeatures.empty()) {
-                  LOG(fatal) << "Input features for ML selection are empty! Please check your configuration.";
-                  return;
-                }
+        nPairs++;
+        VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
+        // compute quantities which depend on the associated collision, such as DCA
+        if (fConfigOptions.propTrack) {
+          VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
+        }
+        if constexpr (TTwoProngFitter) {
+          VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+        }
+        if constexpr (eventHasQvector) {
+          VarManager::FillPairVn<TPairType>(t1, t2);
+        }
+        if constexpr (eventHasQvectorCentr) {
+          VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+        }
 
-                int modelIndex = -1;
-                const auto& binsCent = fDQMlResponse.getBinsCent();
-                const auto& binsPt = fDQMlResponse.getBinsPt();
-                const std::string& centType = fDQMlResponse.getCentType();
-
-                if ("kCentFT0C" == centType) {
-                  modelIndex = o2::aod::dqmlcuts::getMlBinIndex(VarManager::fgValues[VarManager::kCentFT0C], VarManager::fgValues[VarManager::kPt], binsCent, binsPt);
-                } else if ("kCentFT0A" == centType) {
-                  modelIndex = o2::aod::dqmlcuts::getMlBinIndex(VarManager::fgValues[VarManager::kCentFT0A], VarManager::fgValues[VarManager::kPt], binsCent, binsPt);
-                } else if ("kCentFT0M" == centType) {
-                  modelIndex = o2::aod::dqmlcuts::getMlBinIndex(VarManager::fgValues[VarManager::kCentFT0M], VarManager::fgValues[VarManager::kPt], binsCent, binsPt);
-                } else {
-                  LOG(fatal) << "Unknown centrality estimation type: " << centType;
-                  return;
-                }
+        if (fConfigOptions.useEfficiencyWeighting) {
+          VarManager::FillEfficiency();
+        }
 
-                if (modelIndex < 0) {
-                  LOG(info) << "Ml index is negative! This means that the centrality/pt is not in the range of the model bins.";
-                  continue;
-                }
+        rows.WriteRow(dielectronList, event.globalIndex(), values[VarManager::kMass],
+                      values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi],
+                      t1.sign() + t2.sign(), twoTrackFilter, 0);
 
-                LOG(debug) << "Model index: " << modelIndex << ", pT: " << VarManager::fgValues[VarManager::kPt] << ", centrality (kCentFT0C): " << VarManager::fgValues[VarManager::kCentFT0C];
-                isSelectedBDT = fDQMlResponse.isSelectedMl(dqInputFeatures, modelIndex, fOutputMlPsi2ee);
-                VarManager::FillBdtScore(fOutputMlPsi2ee); // TODO: check if this is needed or not
+        if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackCollInfo) > 0) {
+          rows.WriteRow(dielectronInfoList, t1.collisionId(), t1.trackId(), t2.trackId());
+          rows.WriteRow(dileptonInfoList, t1.collisionId(), event.posX(), event.posY(), event.posZ());
+        }
+        if (fConfigOptions.polarTables.value) {
+          rows.WriteRow(dileptonPolarList, values[VarManager::kCosThetaHE], values[VarManager::kPhiHE], values[VarManager::kPhiTildeHE],
+                        values[VarManager::kCosThetaCS], values[VarManager::kPhiCS], values[VarManager::kPhiTildeCS],
+                        values[VarManager::kCosThetaPP], values[VarManager::kPhiPP], values[VarManager::kPhiTildePP],
+                        values[VarManager::kCosThetaRM],
+                        values[VarManager::kCosThetaStarTPC], values[VarManager::kCosThetaStarFT0A], values[VarManager::kCosThetaStarFT0C]);
+        }
+        if constexpr (trackHasCov && TTwoProngFitter) {
+          rows.WriteRow(dielectronsExtraList, t1.globalIndex(), t2.globalIndex(), values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingLzProjected], values[VarManager::kVertexingLxyProjected]);
+          if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedTrackBarrelPID) > 0) {
+            if (fConfigML.applyBDT) {
+              std::vector<float> dqInputFeatures = fDQMlResponse.getInputFeatures(t1, t2, values);
+
+              if (dqInputFeatures.empty()) {
+                LOG(fatal) << "Input features for ML selection are empty! Please check your configuration.";
+                return;
               }
 
-              if (fConfigML.applyBDT && !isSelectedBDT)
-                continue;
+              int modelIndex = -1;
+              const auto& binsCent = fDQMlResponse.getBinsCent();
+              const auto& binsPt = fDQMlResponse.getBinsPt();
+              const std::string& centType = fDQMlResponse.getCentType();
+
+              if ("kCentFT0C" == centType) {
+                modelIndex = o2::aod::dqmlcuts::getMlBinIndex(values[VarManager::kCentFT0C], values[VarManager::kPt], binsCent, binsPt);
+              } else if ("kCentFT0A" == centType) {
+                modelIndex = o2::aod::dqmlcuts::getMlBinIndex(values[VarManager::kCentFT0A], values[VarManager::kPt], binsCent, binsPt);
+              } else if ("kCentFT0M" == centType) {
+                modelIndex = o2::aod::dqmlcuts::getMlBinIndex(values[VarManager::kCentFT0M], values[VarManager::kPt], binsCent, binsPt);
+              } else {
+                LOG(fatal) << "Unknown centrality estimation type: " << centType;
+                return;
+              }
 
-              if (fConfigOptions.flatTables.value) {
-                dielectronAllList(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), twoTrackFilter, dileptonMcDecision,
-                                  t1.pt(), t1.eta(), t1.phi(), t1.itsClusterMap(), t1.itsChi2NCl(), t1.tpcNClsCrossedRows(), t1.tpcNClsFound(), t1.tpcChi2NCl(), t1.dcaXY(), t1.dcaZ(), t1.tpcSignal(), t1.tpcNSigmaEl(), t1.tpcNSigmaPi(), t1.tpcNSigmaPr(), t1.beta(), t1.tofNSigmaEl(), t1.tofNSigmaPi(), t1.tofNSigmaPr(),
-                                  t2.pt(), t2.eta(), t2.phi(), t2.itsClusterMap(), t2.itsChi2NCl(), t2.tpcNClsCrossedRows(), t2.tpcNClsFound(), t2.tpcChi2NCl(), t2.dcaXY(), t2.dcaZ(), t2.tpcSignal(), t2.tpcNSigmaEl(), t2.tpcNSigmaPi(), t2.tpcNSigmaPr(), t2.beta(), t2.tofNSigmaEl(), t2.tofNSigmaPi(), t2.tofNSigmaPr(),
-                                  VarManager::fgValues[VarManager::kKFTrack0DCAxyz], VarManager::fgValues[VarManager::kKFTrack1DCAxyz], VarManager::fgValues[VarManager::kKFDCAxyzBetweenProngs], VarManager::fgValues[VarManager::kKFTrack0DCAxy], VarManager::fgValues[VarManager::kKFTrack1DCAxy], VarManager::fgValues[VarManager::kKFDCAxyBetweenProngs],
-                                  VarManager::fgValues[VarManager::kKFTrack0DeviationFromPV], VarManager::fgValues[VarManager::kKFTrack1DeviationFromPV], VarManager::fgValues[VarManager::kKFTrack0DeviationxyFromPV], VarManager::fgValues[VarManager::kKFTrack1DeviationxyFromPV],
-                                  VarManager::fgValues[VarManager::kKFMass], VarManager::fgValues[VarManager::kKFChi2OverNDFGeo], VarManager::fgValues[VarManager::kVertexingLxyz], VarManager::fgValues[VarManager::kVertexingLxyzOverErr], VarManager::fgValues[VarManager::kVertexingLxy], VarManager::fgValues[VarManager::kVertexingLxyOverErr], VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr], VarManager::fgValues[VarManager::kKFCosPA], VarManager::fgValues[VarManager::kKFJpsiDCAxyz], VarManager::fgValues[VarManager::kKFJpsiDCAxy],
-                                  VarManager::fgValues[VarManager::kKFPairDeviationFromPV], VarManager::fgValues[VarManager::kKFPairDeviationxyFromPV],
-                                  VarManager::fgValues[VarManager::kKFMassGeoTop],
-                                  VarManager::fgValues[VarManager::kKFChi2OverNDFGeoTop], VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjected], VarManager::fgValues[VarManager::kVertexingLzProjected], VarManager::fgValues[VarManager::kVertexingLxyProjected]);
+              if (modelIndex < 0) {
+                LOG(info) << "Ml index is negative! This means that the centrality/pt is not in the range of the model bins.";
+                continue;
               }
+
+              LOG(debug) << "Model index: " << modelIndex << ", pT: " << values[VarManager::kPt] << ", centrality (kCentFT0C): " << values[VarManager::kCentFT0C];
+              isSelectedBDT = fDQMlResponse.isSelectedMl(dqInputFeatures, modelIndex, fOutputMlPsi2ee);
+              VarManager::FillBdtScore(fOutputMlPsi2ee); // TODO: check if this is needed or not
+            }
+
+            if (fConfigML.applyBDT && !isSelectedBDT)
+              continue;
+
+            if (fConfigOptions.flatTables.value) {
+              rows.WriteRow(dielectronAllList, values[VarManager::kMass], values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], t1.sign() + t2.sign(), twoTrackFilter, dileptonMcDecision,
+                            t1.pt(), t1.eta(), t1.phi(), t1.itsClusterMap(), t1.itsChi2NCl(), t1.tpcNClsCrossedRows(), t1.tpcNClsFound(), t1.tpcChi2NCl(), t1.dcaXY(), t1.dcaZ(), t1.tpcSignal(), t1.tpcNSigmaEl(), t1.tpcNSigmaPi(), t1.tpcNSigmaPr(), t1.beta(), t1.tofNSigmaEl(), t1.tofNSigmaPi(), t1.tofNSigmaPr(),
+                            t2.pt(), t2.eta(), t2.phi(), t2.itsClusterMap(), t2.itsChi2NCl(), t2.tpcNClsCrossedRows(), t2.tpcNClsFound(), t2.tpcChi2NCl(), t2.dcaXY(), t2.dcaZ(), t2.tpcSignal(), t2.tpcNSigmaEl(), t2.tpcNSigmaPi(), t2.tpcNSigmaPr(), t2.beta(), t2.tofNSigmaEl(), t2.tofNSigmaPi(), t2.tofNSigmaPr(),
+                            values[VarManager::kKFTrack0DCAxyz], values[VarManager::kKFTrack1DCAxyz], values[VarManager::kKFDCAxyzBetweenProngs], values[VarManager::kKFTrack0DCAxy], values[VarManager::kKFTrack1DCAxy], values[VarManager::kKFDCAxyBetweenProngs],
+                            values[VarManager::kKFTrack0DeviationFromPV], values[VarManager::kKFTrack1DeviationFromPV], values[VarManager::kKFTrack0DeviationxyFromPV], values[VarManager::kKFTrack1DeviationxyFromPV],
+                            values[VarManager::kKFMass], values[VarManager::kKFChi2OverNDFGeo], values[VarManager::kVertexingLxyz], values[VarManager::kVertexingLxyzOverErr], values[VarManager::kVertexingLxy], values[VarManager::kVertexingLxyOverErr], values[VarManager::kVertexingTauxy], values[VarManager::kVertexingTauxyErr], values[VarManager::kKFCosPA], values[VarManager::kKFJpsiDCAxyz], values[VarManager::kKFJpsiDCAxy],
+                            values[VarManager::kKFPairDeviationFromPV], values[VarManager::kKFPairDeviationxyFromPV],
+                            values[VarManager::kKFMassGeoTop],
+                            values[VarManager::kKFChi2OverNDFGeoTop], values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingTauxyProjected], values[VarManager::kVertexingLzProjected], values[VarManager::kVertexingLxyProjected]);
             }
           }
         }
+      }
 
-        if constexpr (TPairType == VarManager::kDecayToMuMu) {
-          twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
-          if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
-            continue;
-          }
+      if constexpr (TPairType == VarManager::kDecayToMuMu) {
+        twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
+        }
 
-          auto t1 = a1.template reducedmuon_as<TTracks>();
-          auto t2 = a2.template reducedmuon_as<TTracks>();
-          if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMFTTrackId() >= 0)
-            continue;
-          sign1 = t1.sign();
-          sign2 = t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          if (t1.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
+        auto t1 = a1.template reducedmuon_as<TTracks>();
+        auto t2 = a2.template reducedmuon_as<TTracks>();
+        if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
+          continue;
+        if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMFTTrackId() >= 0)
+          continue;
+        sign1 = t1.sign();
+        sign2 = t2.sign();
+        // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+        if (t1.muonAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+        }
+        if (t2.muonAmbiguityInBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+        }
+        if (t1.muonAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+        }
+        if (t2.muonAmbiguityOutOfBunch() > 1) {
+          twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+        }
 
-          VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
-          // compute quantities which depend on the associated collision, such as DCA
-          if (fConfigOptions.propTrack) {
-            VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
-          }
-          if constexpr (TTwoProngFitter) {
-            VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
-          }
-          if constexpr (eventHasQvector) {
-            VarManager::FillPairVn<TPairType>(t1, t2);
-          }
-          if constexpr (eventHasQvectorCentr) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
+        VarManager::FillPair<TPairType, TTrackFillMap>(t1, t2);
+        // compute quantities which depend on the associated collision, such as DCA
+        if (fConfigOptions.propTrack) {
+          VarManager::FillPairCollision<TPairType, TTrackFillMap>(event, t1, t2);
+        }
+        if constexpr (TTwoProngFitter) {
+          VarManager::FillPairVertexing<TPairType, TEventFillMap, TTrackFillMap>(event, t1, t2, fConfigOptions.propToPCA);
+        }
+        if constexpr (eventHasQvector) {
+          VarManager::FillPairVn<TPairType>(t1, t2);
+        }
+        if constexpr (eventHasQvectorCentr) {
+          VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+        }
+
+        rows.WriteRow(dimuonList, event.globalIndex(), values[VarManager::kMass],
+                      values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi],
+                      t1.sign() + t2.sign(), twoTrackFilter, 0);
+        if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedMuonCollInfo) > 0) {
+          rows.WriteRow(dileptonInfoList, t1.collisionId(), event.posX(), event.posY(), event.posZ());
+        }
 
-          dimuonList(event.globalIndex(), VarManager::fgValues[VarManager::kMass],
-                     VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi],
-                     t1.sign() + t2.sign(), twoTrackFilter, 0);
+        if constexpr (TTwoProngFitter) {
+          rows.WriteRow(dimuonsExtraList, t1.globalIndex(), t2.globalIndex(), values[VarManager::kVertexingTauz], values[VarManager::kVertexingLz], values[VarManager::kVertexingLxy]);
+          if (fConfigOptions.flatTables.value) {
+            rows.WriteRow(dimuonAllList, event.posX(), event.posY(), event.posZ(), event.numContrib(),
+                          event.selection_raw(), evSel,
+                          -999., -999., -999.,
+                          values[VarManager::kMass],
+                          false,
+                          values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], t1.sign() + t2.sign(), values[VarManager::kVertexingChi2PCA],
+                          values[VarManager::kVertexingTauz], values[VarManager::kVertexingTauzErr],
+                          values[VarManager::kVertexingTauxy], values[VarManager::kVertexingTauxyErr],
+                          values[VarManager::kCosPointingAngle],
+                          values[VarManager::kPt1], values[VarManager::kEta1], values[VarManager::kPhi1], t1.sign(),
+                          values[VarManager::kPt2], values[VarManager::kEta2], values[VarManager::kPhi2], t2.sign(),
+                          t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
+                          0., 0.,
+                          t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
+                          t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
+                          t1.chi2(), t2.chi2(),
+                          -999., -999., -999., -999.,
+                          -999., -999., -999., -999.,
+                          -999., -999., -999., -999.,
+                          -999., -999., -999., -999.,
+                          (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
+                          true, true,
+                          values[VarManager::kU2Q2], values[VarManager::kU3Q3],
+                          values[VarManager::kR2EP_AB], values[VarManager::kR2SP_AB], values[VarManager::kCentFT0C],
+                          values[VarManager::kCos2DeltaPhi], values[VarManager::kCos3DeltaPhi],
+                          values[VarManager::kCORR2POI], values[VarManager::kCORR4POI], values[VarManager::kM01POI], values[VarManager::kM0111POI], values[VarManager::kMultDimuons],
+                          values[VarManager::kVertexingPz], values[VarManager::kVertexingSV]);
+          }
           if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedMuonCollInfo) > 0) {
-            dileptonInfoList(t1.collisionId(), event.posX(), event.posY(), event.posZ());
+            if constexpr (eventHasQvector == true || eventHasQvectorCentr == true) {
+              rows.WriteRow(dileptonFlowList, t1.collisionId(), values[VarManager::kMass], values[VarManager::kCentFT0C],
+                            values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kPhi], t1.sign() + t2.sign(), isFirst,
+                            values[VarManager::kU2Q2], values[VarManager::kR2SP_AB], values[VarManager::kR2SP_AC], values[VarManager::kR2SP_BC],
+                            values[VarManager::kU3Q3], values[VarManager::kR3SP],
+                            values[VarManager::kCos2DeltaPhi], values[VarManager::kR2EP_AB], values[VarManager::kR2EP_AC], values[VarManager::kR2EP_BC],
+                            values[VarManager::kCos3DeltaPhi], values[VarManager::kR3EP],
+                            values[VarManager::kCORR2POI], values[VarManager::kCORR4POI], values[VarManager::kM01POI], values[VarManager::kM0111POI],
+                            values[VarManager::kCORR2REF], values[VarManager::kCORR4REF], values[VarManager::kM11REF], values[VarManager::kM1111REF],
+                            values[VarManager::kMultDimuons], values[VarManager::kMultA]);
+            }
           }
+        }
+        if (t1.sign() != t2.sign()) {
+          isFirst = false;
+        }
+      }
+      // TODO: the model for the electron-muon combination has to be thought through
+      /*if constexpr (TPairType == VarManager::kElectronMuon) {
+        twoTrackFilter = a1.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isMuonSelected_raw() & fTwoTrackFilterMask;
+      }*/
 
-          if constexpr (TTwoProngFitter) {
-            dimuonsExtraList(t1.globalIndex(), t2.globalIndex(), VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingLz], VarManager::fgValues[VarManager::kVertexingLxy]);
-            if (fConfigOptions.flatTables.value) {
-              dimuonAllList(event.posX(), event.posY(), event.posZ(), event.numContrib(),
-                            event.selection_raw(), evSel,
-                            -999., -999., -999.,
-                            VarManager::fgValues[VarManager::kMass],
-                            false,
-                            VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
-                            VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
-                            VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
-                            VarManager::fgValues[VarManager::kCosPointingAngle],
-                            VarManager::fgValues[VarManager::kPt1], VarManager::fgValues[VarManager::kEta1], VarManager::fgValues[VarManager::kPhi1], t1.sign(),
-                            VarManager::fgValues[VarManager::kPt2], VarManager::fgValues[VarManager::kEta2], VarManager::fgValues[VarManager::kPhi2], t2.sign(),
-                            t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
-                            0., 0.,
-                            t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
-                            t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
-                            t1.chi2(), t2.chi2(),
-                            -999., -999., -999., -999.,
-                            -999., -999., -999., -999.,
-                            -999., -999., -999., -999.,
-                            -999., -999., -999., -999.,
-                            (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
-                            true, true,
-                            VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kU3Q3],
-                            VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kCentFT0C],
-                            VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kCos3DeltaPhi],
-                            VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI], VarManager::fgValues[VarManager::kMultDimuons],
-                            VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
-            }
-            if constexpr ((TTrackFillMap & VarManager::ObjTypes::ReducedMuonCollInfo) > 0) {
-              if constexpr (eventHasQvector == true || eventHasQvectorCentr == true) {
-                dileptonFlowList(t1.collisionId(), VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kCentFT0C],
-                                 VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), isFirst,
-                                 VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kR2SP_AC], VarManager::fgValues[VarManager::kR2SP_BC],
-                                 VarManager::fgValues[VarManager::kU3Q3], VarManager::fgValues[VarManager::kR3SP],
-                                 VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2EP_AC], VarManager::fgValues[VarManager::kR2EP_BC],
-                                 VarManager::fgValues[VarManager::kCos3DeltaPhi], VarManager::fgValues[VarManager::kR3EP],
-                                 VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI],
-                                 VarManager::fgValues[VarManager::kCORR2REF], VarManager::fgValues[VarManager::kCORR4REF], VarManager::fgValues[VarManager::kM11REF], VarManager::fgValues[VarManager::kM1111REF],
-                                 VarManager::fgValues[VarManager::kMultDimuons], VarManager::fgValues[VarManager::kMultA]);
+      if (fConfigML.applyBDT && !isSelectedBDT)
+        continue;
+
+      // Fill histograms
+      std::pair<uint32_t, uint32_t> legIds(0, 0);
+      bool isBothLegsAmbi = false;
+      if constexpr (TPairType == VarManager::kDecayToEE) {
+        legIds = {a1.reducedtrackId(), a2.reducedtrackId()};
+        isBothLegsAmbi = (twoTrackFilter & (static_cast<uint32_t>(1) << 28) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30))) &&
+                         (twoTrackFilter & (static_cast<uint32_t>(1) << 29) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
+      }
+      if (isBothLegsAmbi && rows.IsDeferred()) {
+        // the ambiguous pairs are counted over the data frame, so their histograms are filled in collision order
+        rows.RunWithValues(values, VarManager::kNVars, [this, &histNames, ncuts, histIdxOffset, legIds, twoTrackFilter, sign1, sign2](float* pairValues) {
+          dqpairing::OrderedActions pairRows;
+          fillSameEventPairHistograms<TPairType>(legIds, twoTrackFilter, sign1, sign2, histNames, ncuts, histIdxOffset, fHistMan, pairValues, pairRows);
+        });
+      } else {
+        fillSameEventPairHistograms<TPairType>(legIds, twoTrackFilter, sign1, sign2, histNames, ncuts, histIdxOffset, histMan, values, rows);
+      }
+    } // end loop over pairs of track associations
+
+    // the number of pairs is counted over the data frame
+    rows.RunWithValues(values, VarManager::kNVars, [this, nPairs](float* eventValues) {
+      fNPairPerEvent += nPairs;
+      eventValues[VarManager::kNPairsPerEvent] = fNPairPerEvent;
+      if (fEnableBarrelHistos && fConfigQA) {
+        fHistMan->FillHistClass("PairingSEQA", eventValues);
+      }
+    });
+  }
+
+  // Fill the histograms of a same event pair, for all the cuts passed by both legs
+  // NOTE: the ambiguous barrel pairs are counted in fAmbiguousPairs, so these must be filled in collision order
+  template <int TPairType>
+  void fillSameEventPairHistograms(std::pair<uint32_t, uint32_t> const& legIds, uint32_t twoTrackFilter, int sign1, int sign2, std::map<int, std::vector<TString>> const& histNames, int ncuts, int histIdxOffset,
+                                   HistogramManager* histMan, float* values, dqpairing::OrderedActions& rows)
+  {
+    bool isAmbiInBunch = false;
+    bool isAmbiOutOfBunch = false;
+    bool isUnambiguous = false;
+    bool isLeg1Ambi = false;
+    bool isLeg2Ambi = false;
+    bool isAmbiExtra = false;
+
+    for (int icut = 0; icut < ncuts; icut++) {
+      if (twoTrackFilter & (static_cast<uint32_t>(1) << icut)) {
+        isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
+        isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
+        isUnambiguous = !(isAmbiInBunch || isAmbiOutOfBunch);
+        isLeg1Ambi = (twoTrackFilter & (static_cast<uint32_t>(1) << 28) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)));
+        isLeg2Ambi = (twoTrackFilter & (static_cast<uint32_t>(1) << 29) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
+        if constexpr (TPairType == VarManager::kDecayToEE) {
+          if (isLeg1Ambi && isLeg2Ambi) {
+            if (fAmbiguousPairs.find(legIds) != fAmbiguousPairs.end()) {
+              if (fAmbiguousPairs[legIds] & (static_cast<uint32_t>(1) << icut)) { // if this pair is already stored with this cut
+                isAmbiExtra = true;
+              } else {
+                fAmbiguousPairs[legIds] |= static_cast<uint32_t>(1) << icut;
               }
+            } else {
+              fAmbiguousPairs[legIds] = static_cast<uint32_t>(1) << icut;
             }
           }
-          if (t1.sign() != t2.sign()) {
-            isFirst = false;
-          }
         }
-        // TODO: the model for the electron-muon combination has to be thought through
-        /*if constexpr (TPairType == VarManager::kElectronMuon) {
-          twoTrackFilter = a1.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isMuonSelected_raw() & fTwoTrackFilterMask;
-        }*/
-
-        // Fill histograms
-        bool isAmbiInBunch = false;
-        bool isAmbiOutOfBunch = false;
-        bool isUnambiguous = false;
-        bool isLeg1Ambi = false;
-        bool isLeg2Ambi = false;
-        bool isAmbiExtra = false;
-
-        if (fConfigML.applyBDT && !isSelectedBDT)
-          continue;
-
-        for (int icut = 0; icut < ncuts; icut++) {
-          if (twoTrackFilter & (static_cast<uint32_t>(1) << icut)) {
-            isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
-            isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
-            isUnambiguous = !(isAmbiInBunch || isAmbiOutOfBunch);
-            isLeg1Ambi = (twoTrackFilter & (static_cast<uint32_t>(1) << 28) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)));
-            isLeg2Ambi = (twoTrackFilter & (static_cast<uint32_t>(1) << 29) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
-            if constexpr (TPairType == VarManager::kDecayToEE) {
-              if (isLeg1Ambi && isLeg2Ambi) {
-                std::pair<uint32_t, uint32_t> iPair(a1.reducedtrackId(), a2.reducedtrackId());
-                if (fAmbiguousPairs.find(iPair) != fAmbiguousPairs.end()) {
-                  if (fAmbiguousPairs[iPair] & (static_cast<uint32_t>(1) << icut)) { // if this pair is already stored with this cut
-                    isAmbiExtra = true;
-                  } else {
-                    fAmbiguousPairs[iPair] |= static_cast<uint32_t>(1) << icut;
-                  }
-                } else {
-                  fAmbiguousPairs[iPair] = static_cast<uint32_t>(1) << icut;
-                }
+        if (sign1 * sign2 < 0) {
+          rows.WriteRow(PromptNonPromptSepTable, values[VarManager::kMass], values[VarManager::kPt], values[VarManager::kEta], values[VarManager::kRap], values[VarManager::kPhi],
+                        values[VarManager::kVertexingTauxyProjected], values[VarManager::kVertexingTauxyProjectedPoleJPsiMass], values[VarManager::kVertexingTauzProjected], values[VarManager::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV],
+                        values[VarManager::kVtxX], values[VarManager::kVtxY], values[VarManager::kVtxZ], values[VarManager::kDCAxy1], values[VarManager::kDCAz1], values[VarManager::kITSclusterMap1], values[VarManager::kTPCnSigmaEl1], values[VarManager::kDCAxy2], values[VarManager::kDCAz2], values[VarManager::kITSclusterMap2], values[VarManager::kTPCnSigmaEl2],
+                        isAmbiInBunch, isAmbiOutOfBunch, values[VarManager::kMultFT0A], values[VarManager::kMultFT0C], values[VarManager::kCentFT0M], values[VarManager::kVtxNcontribReal]);
+          if constexpr (TPairType == VarManager::kDecayToMuMu) {
+            histMan->FillHistClass(histNames.at(icut)[0].Data(), values);
+            if (fConfigAmbiguousMuonHistograms) {
+              if (isAmbiInBunch) {
+                histMan->FillHistClass(histNames.at(icut)[3 + histIdxOffset].Data(), values);
+              }
+              if (isAmbiOutOfBunch) {
+                histMan->FillHistClass(histNames.at(icut)[3 + histIdxOffset + 3].Data(), values);
+              }
+              if (isUnambiguous) {
+                histMan->FillHistClass(histNames.at(icut)[3 + histIdxOffset + 6].Data(), values);
               }
             }
-            if (sign1 * sign2 < 0) {
-              PromptNonPromptSepTable(VarManager::fgValues[VarManager::kMass], VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kRap], VarManager::fgValues[VarManager::kPhi],
-                                      VarManager::fgValues[VarManager::kVertexingTauxyProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMass], VarManager::fgValues[VarManager::kVertexingTauzProjected], VarManager::fgValues[VarManager::kVertexingTauxyProjectedPoleJPsiMassRecalculatePV],
-                                      VarManager::fgValues[VarManager::kVtxX], VarManager::fgValues[VarManager::kVtxY], VarManager::fgValues[VarManager::kVtxZ], VarManager::fgValues[VarManager::kDCAxy1], VarManager::fgValues[VarManager::kDCAz1], VarManager::fgValues[VarManager::kITSclusterMap1], VarManager::fgValues[VarManager::kTPCnSigmaEl1], VarManager::fgValues[VarManager::kDCAxy2], VarManager::fgValues[VarManager::kDCAz2], VarManager::fgValues[VarManager::kITSclusterMap2], VarManager::fgValues[VarManager::kTPCnSigmaEl2],
-                                      isAmbiInBunch, isAmbiOutOfBunch, VarManager::fgValues[VarManager::kMultFT0A], VarManager::fgValues[VarManager::kMultFT0C], VarManager::fgValues[VarManager::kCentFT0M], VarManager::fgValues[VarManager::kVtxNcontribReal]);
-              if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                fHistMan->FillHistClass(histNames[icut][0].Data(), VarManager::fgValues);
-                if (fConfigAmbiguousMuonHistograms) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3 + histIdxOffset].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][3 + histIdxOffset + 3].Data(), VarManager::fgValues);
-                  }
-                  if (isUnambiguous) {
-                    fHistMan->FillHistClass(histNames[icut][3 + histIdxOffset + 6].Data(), VarManager::fgValues);
-                  }
+          }
+          if constexpr (TPairType == VarManager::kDecayToEE) {
+            histMan->FillHistClass(histNames.at(icut)[0].Data(), values);
+            if (isAmbiExtra) {
+              histMan->FillHistClass(histNames.at(icut)[3].Data(), values);
+            }
+          }
+        } else {
+          if (sign1 > 0) {
+            if constexpr (TPairType == VarManager::kDecayToMuMu) {
+              histMan->FillHistClass(histNames.at(icut)[1].Data(), values);
+              if (fConfigAmbiguousMuonHistograms) {
+                if (isAmbiInBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[4 + histIdxOffset].Data(), values);
                 }
-              }
-              if constexpr (TPairType == VarManager::kDecayToEE) {
-                fHistMan->FillHistClass(histNames[icut][0].Data(), VarManager::fgValues);
-                if (isAmbiExtra) {
-                  fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
+                if (isAmbiOutOfBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[4 + histIdxOffset + 3].Data(), values);
                 }
-              }
-            } else {
-              if (sign1 > 0) {
-                if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                  fHistMan->FillHistClass(histNames[icut][1].Data(), VarManager::fgValues);
-                  if (fConfigAmbiguousMuonHistograms) {
-                    if (isAmbiInBunch) {
-                      fHistMan->FillHistClass(histNames[icut][4 + histIdxOffset].Data(), VarManager::fgValues);
-                    }
-                    if (isAmbiOutOfBunch) {
-                      fHistMan->FillHistClass(histNames[icut][4 + histIdxOffset + 3].Data(), VarManager::fgValues);
-                    }
-                    if (isUnambiguous) {
-                      fHistMan->FillHistClass(histNames[icut][4 + histIdxOffset + 6].Data(), VarManager::fgValues);
-                    }
-                  }
+                if (isUnambiguous) {
+                  histMan->FillHistClass(histNames.at(icut)[4 + histIdxOffset + 6].Data(), values);
                 }
-                if constexpr (TPairType == VarManager::kDecayToEE) {
-                  fHistMan->FillHistClass(histNames[icut][1].Data(), VarManager::fgValues);
-                  if (isAmbiExtra) {
-                    fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
-                  }
+              }
+            }
+            if constexpr (TPairType == VarManager::kDecayToEE) {
+              histMan->FillHistClass(histNames.at(icut)[1].Data(), values);
+              if (isAmbiExtra) {
+                histMan->FillHistClass(histNames.at(icut)[4].Data(), values);
+              }
+            }
+          } else {
+            if constexpr (TPairType == VarManager::kDecayToMuMu) {
+              histMan->FillHistClass(histNames.at(icut)[2].Data(), values);
+              if (fConfigAmbiguousMuonHistograms) {
+                if (isAmbiInBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[5 + histIdxOffset].Data(), values);
                 }
-              } else {
-                if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                  fHistMan->FillHistClass(histNames[icut][2].Data(), VarManager::fgValues);
-                  if (fConfigAmbiguousMuonHistograms) {
-                    if (isAmbiInBunch) {
-                      fHistMan->FillHistClass(histNames[icut][5 + histIdxOffset].Data(), VarManager::fgValues);
-                    }
-                    if (isAmbiOutOfBunch) {
-                      fHistMan->FillHistClass(histNames[icut][5 + histIdxOffset + 3].Data(), VarManager::fgValues);
-                    }
-                    if (isUnambiguous) {
-                      fHistMan->FillHistClass(histNames[icut][5 + histIdxOffset + 6].Data(), VarManager::fgValues);
-                    }
-                  }
+                if (isAmbiOutOfBunch) {
+                  histMan->FillHistClass(histNames.at(icut)[5 + histIdxOffset + 3].Data(), values);
                 }
-                if constexpr (TPairType == VarManager::kDecayToEE) {
-                  fHistMan->FillHistClass(histNames[icut][2].Data(), VarManager::fgValues);
-                  if (isAmbiExtra) {
-                    fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
-                  }
+                if (isUnambiguous) {
+                  histMan->FillHistClass(histNames.at(icut)[5 + histIdxOffset + 6].Data(), values);
                 }
               }
             }
-            for (unsigned int iPairCut = 0; iPairCut < fPairCuts.size(); iPairCut++) {
-              AnalysisCompositeCut cut = fPairCuts.at(iPairCut);
-              if (!(cut.IsSelected(VarManager::fgValues))) // apply pair cuts
-                continue;
-              if (sign1 * sign2 < 0) {
-                fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][0].Data(), VarManager::fgValues);
-              } else {
-                if (sign1 > 0) {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][1].Data(), VarManager::fgValues);
-                } else {
-                  fHistMan->FillHistClass(histNames[ncuts + icut * ncuts + iPairCut][2].Data(), VarManager::fgValues);
-                }
+            if constexpr (TPairType == VarManager::kDecayToEE) {
+              histMan->FillHistClass(histNames.at(icut)[2].Data(), values);
+              if (isAmbiExtra) {
+                histMan->FillHistClass(histNames.at(icut)[5].Data(), values);
               }
-            } // end loop (pair cuts)
+            }
           }
-        } // end loop (cuts)
-      } // end loop over pairs of track associations
-      VarManager::fgValues[VarManager::kNPairsPerEvent] = fNPairPerEvent;
-      if (fEnableBarrelHistos && fConfigQA) {
-        fHistMan->FillHistClass("PairingSEQA", VarManager::fgValues);
+        }
+        for (unsigned int iPairCut = 0; iPairCut < fPairCuts.size(); iPairCut++) {
+          AnalysisCompositeCut cut = fPairCuts.at(iPairCut);
+          if (!(cut.IsSelected(values))) // apply pair cuts
+            continue;
+          if (sign1 * sign2 < 0) {
+            histMan->FillHistClass(histNames.at(ncuts + icut * ncuts + iPairCut)[0].Data(), values);
+          } else {
+            if (sign1 > 0) {
+              histMan->FillHistClass(histNames.at(ncuts + icut * ncuts + iPairCut)[1].Data(), values);
+            } else {
+              histMan->FillHistClass(histNames.at(ncuts + icut * ncuts + iPairCut)[2].Data(), values);
+            }
+          }
+        } // end loop (pair cuts)
       }
-    } // end loop over events
+    } // end loop (cuts)
   }
 
   template <int TPairType, uint32_t TEventFillMap, typename TAssoc1, typename TAssoc2, typename TTracks1, typename TTracks2>
   void runMixedPairing(TAssoc1 const& assocs1, TAssoc2 const& assocs2, TTracks1 const& /*tracks1*/, TTracks2 const& /*tracks2*/)
   {
-    std::map<int, std::vector<TString>> histNames = fTrackHistNames;
-    int pairSign = 0;
-    int ncuts = 0;
     uint32_t twoTrackFilter = static_cast<uint32_t>(0);
     for (auto& a1 : assocs1) {
       for (auto& a2 : assocs2) {
@@ -2199,164 +2302,194 @@ struct AnalysisSameEventPairing {
           if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
             continue;
           }
-          auto t1 = a1.template reducedtrack_as<TTracks1>();
-          auto t2 = a2.template reducedtrack_as<TTracks2>();
-          fNPairPerEvent++;
-          VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          pairSign = t1.sign() + t2.sign();
-          ncuts = fNCutsBarrel;
+          runMixedPair<TPairType, TEventFillMap>(a1.template reducedtrack_as<TTracks1>(), a2.template reducedtrack_as<TTracks2>(), twoTrackFilter, true);
         }
         if constexpr (TPairType == VarManager::kDecayToMuMu) {
           twoTrackFilter = a1.isMuonSelected_raw() & a2.isMuonSelected_raw() & fMuonFilterMask;
           if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
             continue;
           }
-          auto t1 = a1.template reducedmuon_as<TTracks1>();
-          auto t2 = a2.template reducedmuon_as<TTracks2>();
-          if (t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          if (t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMCHTrackId() >= 0)
-            continue;
-          VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
-            VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
-          }
-          pairSign = t1.sign() + t2.sign();
-          // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
-          if (t1.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
-          }
-          if (t2.muonAmbiguityInBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
-          }
-          if (t1.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
-          }
-          if (t2.muonAmbiguityOutOfBunch() > 1) {
-            twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
-          }
-          ncuts = fNCutsMuon;
-          histNames = fMuonHistNames;
+          runMixedPair<TPairType, TEventFillMap>(a1.template reducedmuon_as<TTracks1>(), a2.template reducedmuon_as<TTracks2>(), twoTrackFilter, true);
+        }
+      } // end for (track2)
+    } // end for (track1)
+  }
 
-          if (fConfigOptions.flatTables.value) {
-            dimuonAllList(-999., -999., -999., -999.,
-                          0, 0,
-                          -999., -999., -999.,
-                          VarManager::fgValues[VarManager::kMass],
-                          false,
-                          VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
-                          VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
-                          VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
-                          VarManager::fgValues[VarManager::kCosPointingAngle],
-                          t1.pt(), t1.eta(), t1.phi(), t1.sign(),
-                          t2.pt(), t2.eta(), t2.phi(), t2.sign(),
-                          t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
-                          0., 0.,
-                          t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
-                          t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
-                          t1.chi2(), t2.chi2(),
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          -999., -999., -999., -999.,
-                          (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
-                          true, true,
-                          VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kU3Q3],
-                          VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kCentFT0C],
-                          VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kCos3DeltaPhi],
-                          VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI], VarManager::fgValues[VarManager::kMultDimuons],
-                          VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
-          }
+  // mixing of the leptons of an event with the ones of an event of the mixing pool
+  template <int TPairType, uint32_t TEventFillMap>
+  void runMixedPairing(std::vector<MixingPoolLepton> const& leptons1, std::vector<MixingPoolLepton> const& leptons2, bool sameDataFrame)
+  {
+    for (auto const& t1 : leptons1) {
+      for (auto const& t2 : leptons2) {
+        uint32_t twoTrackFilter = t1.filter() & t2.filter();
+        if (!twoTrackFilter) { // the tracks must have at least one filter bit in common to continue
+          continue;
         }
-        /*if constexpr (TPairType == VarManager::kElectronMuon) {
-          twoTrackFilter = a1.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isMuonSelected_raw() & fTrackFilterMask;
-        }*/
-
-        bool isAmbiInBunch = false;
-        bool isAmbiOutOfBunch = false;
-        bool isUnambiguous = false;
-        for (int icut = 0; icut < ncuts; icut++) {
-          if (!(twoTrackFilter & (static_cast<uint32_t>(1) << icut))) {
-            continue; // cut not passed
-          }
-          isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
-          isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
-          isUnambiguous = !((twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
-          if (pairSign == 0) {
-            if constexpr (TPairType == VarManager::kDecayToMuMu) {
-              fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
-              if (fConfigAmbiguousMuonHistograms) {
-                if (isAmbiInBunch) {
-                  fHistMan->FillHistClass(histNames[icut][15].Data(), VarManager::fgValues);
-                }
-                if (isAmbiOutOfBunch) {
-                  fHistMan->FillHistClass(histNames[icut][18].Data(), VarManager::fgValues);
-                }
-                if (isUnambiguous) {
-                  fHistMan->FillHistClass(histNames[icut][21].Data(), VarManager::fgValues);
-                }
-              }
+        runMixedPair<TPairType, TEventFillMap>(t1, t2, twoTrackFilter, sameDataFrame);
+      }
+    }
+  }
+
+  // fill a pair of leptons from two different events
+  template <int TPairType, uint32_t TEventFillMap, typename T1, typename T2>
+  void runMixedPair(T1 const& t1, T2 const& t2, uint32_t twoTrackFilter, bool checkMatchedTracks)
+  {
+    std::map<int, std::vector<TString>>& histNames = (TPairType == VarManager::kDecayToMuMu) ? fMuonHistNames : fTrackHistNames;
+    int pairSign = 0;
+    int ncuts = 0;
+    if constexpr (TPairType == VarManager::kDecayToEE) {
+      fNPairPerEvent++;
+      VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      pairSign = t1.sign() + t2.sign();
+      ncuts = fNCutsBarrel;
+    }
+    if constexpr (TPairType == VarManager::kDecayToMuMu) {
+      // the matched track indices can only be compared within the same data frame
+      if (checkMatchedTracks && t1.matchMCHTrackId() == t2.matchMCHTrackId() && t1.matchMCHTrackId() >= 0)
+        return;
+      if (checkMatchedTracks && t1.matchMFTTrackId() == t2.matchMFTTrackId() && t1.matchMCHTrackId() >= 0)
+        return;
+      VarManager::FillPairME<TEventFillMap, TPairType>(t1, t2);
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::ReducedEventQvector) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      if constexpr ((TEventFillMap & VarManager::ObjTypes::CollisionQvect) > 0) {
+        VarManager::FillPairVn<TEventFillMap, TPairType>(t1, t2);
+      }
+      pairSign = t1.sign() + t2.sign();
+      // store the ambiguity number of the two dilepton legs in the last 4 digits of the two-track filter
+      if (t1.muonAmbiguityInBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 28);
+      }
+      if (t2.muonAmbiguityInBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 29);
+      }
+      if (t1.muonAmbiguityOutOfBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 30);
+      }
+      if (t2.muonAmbiguityOutOfBunch() > 1) {
+        twoTrackFilter |= (static_cast<uint32_t>(1) << 31);
+      }
+      ncuts = fNCutsMuon;
+
+      if (fConfigOptions.flatTables.value) {
+        dimuonAllList(-999., -999., -999., -999.,
+                      0, 0,
+                      -999., -999., -999.,
+                      VarManager::fgValues[VarManager::kMass],
+                      false,
+                      VarManager::fgValues[VarManager::kPt], VarManager::fgValues[VarManager::kEta], VarManager::fgValues[VarManager::kPhi], t1.sign() + t2.sign(), VarManager::fgValues[VarManager::kVertexingChi2PCA],
+                      VarManager::fgValues[VarManager::kVertexingTauz], VarManager::fgValues[VarManager::kVertexingTauzErr],
+                      VarManager::fgValues[VarManager::kVertexingTauxy], VarManager::fgValues[VarManager::kVertexingTauxyErr],
+                      VarManager::fgValues[VarManager::kCosPointingAngle],
+                      t1.pt(), t1.eta(), t1.phi(), t1.sign(),
+                      t2.pt(), t2.eta(), t2.phi(), t2.sign(),
+                      t1.fwdDcaX(), t1.fwdDcaY(), t2.fwdDcaX(), t2.fwdDcaY(),
+                      0., 0.,
+                      t1.chi2MatchMCHMID(), t2.chi2MatchMCHMID(),
+                      t1.chi2MatchMCHMFT(), t2.chi2MatchMCHMFT(),
+                      t1.chi2(), t2.chi2(),
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      -999., -999., -999., -999.,
+                      (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)), (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)),
+                      true, true,
+                      VarManager::fgValues[VarManager::kU2Q2], VarManager::fgValues[VarManager::kU3Q3],
+                      VarManager::fgValues[VarManager::kR2EP_AB], VarManager::fgValues[VarManager::kR2SP_AB], VarManager::fgValues[VarManager::kCentFT0C],
+                      VarManager::fgValues[VarManager::kCos2DeltaPhi], VarManager::fgValues[VarManager::kCos3DeltaPhi],
+                      VarManager::fgValues[VarManager::kCORR2POI], VarManager::fgValues[VarManager::kCORR4POI], VarManager::fgValues[VarManager::kM01POI], VarManager::fgValues[VarManager::kM0111POI], VarManager::fgValues[VarManager::kMultDimuons],
+                      VarManager::fgValues[VarManager::kVertexingPz], VarManager::fgValues[VarManager::kVertexingSV]);
+      }
+    }
+    /*if constexpr (TPairType == VarManager::kElectronMuon) {
+      twoTrackFilter = a1.isBarrelSelected_raw() & a1.isBarrelSelectedPrefilter_raw() & a2.isMuonSelected_raw() & fTrackFilterMask;
+    }*/
+
+    bool isAmbiInBunch = false;
+    bool isAmbiOutOfBunch = false;
+    bool isUnambiguous = false;
+    for (int icut = 0; icut < ncuts; icut++) {
+      if (!(twoTrackFilter & (static_cast<uint32_t>(1) << icut))) {
+        continue; // cut not passed
+      }
+      isAmbiInBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29));
+      isAmbiOutOfBunch = (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31));
+      isUnambiguous = !((twoTrackFilter & (static_cast<uint32_t>(1) << 28)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 29)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 30)) || (twoTrackFilter & (static_cast<uint32_t>(1) << 31)));
+      if (pairSign == 0) {
+        if constexpr (TPairType == VarManager::kDecayToMuMu) {
+          fHistMan->FillHistClass(histNames[icut][3].Data(), VarManager::fgValues);
+          if (fConfigAmbiguousMuonHistograms) {
+            if (isAmbiInBunch) {
+              fHistMan->FillHistClass(histNames[icut][15].Data(), VarManager::fgValues);
             }
-            if constexpr (TPairType == VarManager::kDecayToEE) {
-              fHistMan->FillHistClass(Form("PairsBarrelMEPM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+            if (isAmbiOutOfBunch) {
+              fHistMan->FillHistClass(histNames[icut][18].Data(), VarManager::fgValues);
             }
-          } else {
-            if (pairSign > 0) {
-              if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
-                if (fConfigAmbiguousMuonHistograms) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][16].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][19].Data(), VarManager::fgValues);
-                  }
-                  if (isUnambiguous) {
-                    fHistMan->FillHistClass(histNames[icut][22].Data(), VarManager::fgValues);
-                  }
-                }
+            if (isUnambiguous) {
+              fHistMan->FillHistClass(histNames[icut][21].Data(), VarManager::fgValues);
+            }
+          }
+        }
+        if constexpr (TPairType == VarManager::kDecayToEE) {
+          fHistMan->FillHistClass(Form("PairsBarrelMEPM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+        }
+      } else {
+        if (pairSign > 0) {
+          if constexpr (TPairType == VarManager::kDecayToMuMu) {
+            fHistMan->FillHistClass(histNames[icut][4].Data(), VarManager::fgValues);
+            if (fConfigAmbiguousMuonHistograms) {
+              if (isAmbiInBunch) {
+                fHistMan->FillHistClass(histNames[icut][16].Data(), VarManager::fgValues);
               }
-              if constexpr (TPairType == VarManager::kDecayToEE) {
-                fHistMan->FillHistClass(Form("PairsBarrelMEPP_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+              if (isAmbiOutOfBunch) {
+                fHistMan->FillHistClass(histNames[icut][19].Data(), VarManager::fgValues);
               }
-            } else {
-              if constexpr (TPairType == VarManager::kDecayToMuMu) {
-                fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
-                if (fConfigAmbiguousMuonHistograms) {
-                  if (isAmbiInBunch) {
-                    fHistMan->FillHistClass(histNames[icut][17].Data(), VarManager::fgValues);
-                  }
-                  if (isAmbiOutOfBunch) {
-                    fHistMan->FillHistClass(histNames[icut][20].Data(), VarManager::fgValues);
-                  }
-                  if (isUnambiguous) {
-                    fHistMan->FillHistClass(histNames[icut][23].Data(), VarManager::fgValues);
-                  }
-                }
+              if (isUnambiguous) {
+                fHistMan->FillHistClass(histNames[icut][22].Data(), VarManager::fgValues);
               }
-              if constexpr (TPairType == VarManager::kDecayToEE) {
-                fHistMan->FillHistClass(Form("PairsBarrelMEMM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+            }
+          }
+          if constexpr (TPairType == VarManager::kDecayToEE) {
+            fHistMan->FillHistClass(Form("PairsBarrelMEPP_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+          }
+        } else {
+          if constexpr (TPairType == VarManager::kDecayToMuMu) {
+            fHistMan->FillHistClass(histNames[icut][5].Data(), VarManager::fgValues);
+            if (fConfigAmbiguousMuonHistograms) {
+              if (isAmbiInBunch) {
+                fHistMan->FillHistClass(histNames[icut][17].Data(), VarManager::fgValues);
+              }
+              if (isAmbiOutOfBunch) {
+                fHistMan->FillHistClass(histNames[icut][20].Data(), VarManager::fgValues);
+              }
+              if (isUnambiguous) {
+                fHistMan->FillHistClass(histNames[icut][23].Data(), VarManager::fgValues);
               }
             }
           }
-        } // end for (cuts)
-      } // end for (track2)
-    } // end for (track1)
+          if constexpr (TPairType == VarManager::kDecayToEE) {
+            fHistMan->FillHistClass(Form("PairsBarrelMEMM_%s", fTrackCuts[icut].Data()), VarManager::fgValues);
+          }
+        }
+      }
+    } // end for (cuts)
   }
 
   // barrel-barrel and muon-muon event mixing
   template <int TPairType, uint32_t TEventFillMap, typename TEvents, typename TAssocs, typename TTracks>
   void runSameSideMixing(TEvents& events, TAssocs const& assocs, TTracks const& tracks, Preslice<TAssocs>& preSlice)
   {
+    if (fConfigUseMixingPool) {
+      runPooledMixing<TPairType, TEventFillMap>(events, assocs, tracks, preSlice);
+      return;
+    }
     events.bindExternalIndices(&assocs);
     int mixingDepth = fConfigMixingDepth.value;
     fAmbiguousPairs.clear();
@@ -2379,6 +2512,47 @@ struct AnalysisSameEventPairing {
     } // end event loop
   }
 
+  // barrel-barrel and muon-muon event mixing with the events of the mixing pool
+  // Each event is mixed with the most recent events of its mixing category, also from the previous data frames,
+  // and is then added to the pool with its selected leptons
+  template <int TPairType, uint32_t TEventFillMap, typename TEvents, typename TAssocs, typename TTracks>
+  void runPooledMixing(TEvents& events, TAssocs const& assocs, TTracks const& /*tracks*/, Preslice<TAssocs>& preSlice)
+  {
+    MixingPool& pool = (TPairType == VarManager::kDecayToMuMu) ? fMuonMixingPool : fBarrelMixingPool;
+    pool.newDataFrame();
+    for (auto& event : events) {
+      auto groupedAssocs = assocs.sliceBy(preSlice, event.globalIndex());
+      std::vector<MixingPoolLepton> leptons;
+      leptons.reserve(groupedAssocs.size());
+      for (auto& assoc : groupedAssocs) {
+        if constexpr (TPairType == VarManager::kDecayToEE) {
+          uint32_t filter = assoc.isBarrelSelected_raw() & assoc.isBarrelSelectedPrefilter_raw() & fTrackFilterMask;
+          if (filter) {
+            leptons.emplace_back(assoc.template reducedtrack_as<TTracks>(), filter);
+          }
+        }
+        if constexpr (TPairType == VarManager::kDecayToMuMu) {
+          uint32_t filter = assoc.isMuonSelected_raw() & fMuonFilterMask;
+          if (filter) {
+            leptons.emplace_back(assoc.template reducedmuon_as<TTracks>(), filter);
+          }
+        }
+      }
+
+      VarManager::ResetValues(0, VarManager::kNVars);
+      VarManager::FillEvent<TEventFillMap>(event, VarManager::fgValues);
+      for (auto const& pooledEvent : pool.getEvents(event.mixingHash())) {
+        fNPairPerEvent = 0;
+        runMixedPairing<TPairType, TEventFillMap>(leptons, pooledEvent.getLeptons(), pooledEvent.getDataFrame() == pool.getDataFrame());
+        VarManager::fgValues[VarManager::kNPairsPerEvent] = fNPairPerEvent;
+        if (fEnableBarrelMixingHistos && fConfigQA) {
+          fHistMan->FillHistClass("PairingMEQA", VarManager::fgValues);
+        }
+      }
+      pool.push(event.mixingHash(), std::move(leptons));
+    } // end event loop
+  }
+
   template <bool TTwoProngFitter, int TPairType, uint32_t TEventFillMap, uint32_t TTrackFillMap, uint32_t TMuonFillMap, typename TEvents, typename TTrackAssocs, typename TTracks, typename TMuonAssocs, typename TMuons>
   void runEmuSameEventPairing(TEvents const& events, Preslice<TTrackAssocs>& preslice1, TTrackAssocs const& assocs1, TTracks const& /*tracks1*/, Preslice<TMuonAssocs>& preslice2, TMuonAssocs const& assocs2, TMuons const& /*tracks2*/)
   {
@@ -31,6 +31,7 @@
 #include <TH1.h>
 
 #include <cstdint>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -72,15 +73,39 @@ struct filterEoI {
     hEventCounter->GetXaxis()->SetBinLabel(8, "event with v0 or electrons from dalitz");
   }
 
-  SliceCache cache;
-  Preslice<aod::EMPrimaryElectrons> perCollision_el = aod::emprimaryelectron::collisionId;
-  Preslice<aod::EMPrimaryMuons> perCollision_mu = aod::emprimarymuon::collisionId;
-  Preslice<aod::V0PhotonsKF> perCollision_v0 = aod::v0photonkf::collisionId;
-  Preslice<aod::EMPrimaryElectronsFromDalitz> perCollision_elda = aod::emprimaryelectron::collisionId;
+  // numbers of candidates per collision, counted in a single pass over each table instead of slicing the tables per collision
+  std::vector<int> nElectronsPerCollision;
+  std::vector<int> nMuonsPerCollision;
+  std::vector<int> nV0sPerCollision;
+  std::vector<int> nElectronsDAPerCollision;
+
+  template <typename TCandidates>
+  void countPerCollision(TCandidates const& candidates, int nCollisions, std::vector<int>& counts)
+  {
+    counts.assign(nCollisions, 0);
+    for (const auto& candidate : candidates) {
+      if (0 <= candidate.collisionId() && candidate.collisionId() < nCollisions) {
+        counts[candidate.collisionId()]++;
+      }
+    }
+  }
 
   template <uint8_t system, typename TCollisions, typename TElectrons, typename TMuons, typename TV0s, typename TElectronsDA>
   void selectEoI(TCollisions const& collisions, TElectrons const& electrons, TMuons const& muons, TV0s const& v0s, TElectronsDA const& electronsda)
   {
+    if constexpr (static_cast<bool>(system & kElectron)) {
+      countPerCollision(electrons, collisions.size(), nElectronsPerCollision);
+    }
+    if constexpr (static_cast<bool>(system & kFwdMuon)) {
+      countPerCollision(muons, collisions.size(), nMuonsPerCollision);
+    }
+    if constexpr (static_cast<bool>(system & kPCM)) {
+      countPerCollision(v0s, collisions.size(), nV0sPerCollision);
+    }
+    if constexpr (static_cast<bool>(system & kElectronFromDalitz)) {
+      countPerCollision(electronsda, collisions.size(), nElectronsDAPerCollision);
+    }
+
     for (const auto& collision : collisions) {
       bool does_electron_exist = false;
       bool does_fwdmuon_exist = false;
@@ -89,29 +114,25 @@ struct filterEoI {
       fRegistry.fill(HIST("hEventCounter"), 1);
 
       if constexpr (static_cast<bool>(system & kElectron)) {
-        auto electrons_coll = electrons.sliceBy(perCollision_el, collision.globalIndex());
-        if (electrons_coll.size() >= minNelectron) {
+        if (nElectronsPerCollision[collision.globalIndex()] >= minNelectron) {
           does_electron_exist = true;
           fRegistry.fill(HIST("hEventCounter"), 2);
         }
       }
       if constexpr (static_cast<bool>(system & kFwdMuon)) {
-        auto muons_coll = muons.sliceBy(perCollision_mu, collision.globalIndex());
-        if (muons_coll.size() >= minNmuon) {
+        if (nMuonsPerCollision[collision.globalIndex()] >= minNmuon) {
           does_fwdmuon_exist = true;
           fRegistry.fill(HIST("hEventCounter"), 3);
         }
       }
       if constexpr (static_cast<bool>(system & kPCM)) {
-        auto v0s_coll = v0s.sliceBy(perCollision_v0, collision.globalIndex());
-        if (v0s_coll.size() >= 1) {
+        if (nV0sPerCollision[collision.globalIndex()] >= 1) {
           does_pcm_exist = true;
           fRegistry.fill(HIST("hEventCounter"), 4);
         }
       }
       if constexpr (static_cast<bool>(system & kElectronFromDalitz)) {
-        auto electronsda_coll = electronsda.sliceBy(perCollision_elda, collision.globalIndex());
-        if (electronsda_coll.size() >= 2) {
+        if (nElectronsDAPerCollision[collision.globalIndex()] >= 2) {
           does_electronda_exist = true;
         }
       }
@@ -253,6 +253,7 @@ struct prefilterDimuon {
 
   std::unordered_map<int, bool> map_best_match_globalmuon;
   std::unordered_map<int, uint16_t> map_pfb; // map track.globalIndex -> prefilter bit
+  std::vector<bool> isSelectedMuon;          // track.globalIndex -> track cut and best global muon match
 
   SliceCache cache;
   Preslice<MyTracks> perCollision_track = aod::emprimarymuon::emeventId;
@@ -268,8 +269,10 @@ struct prefilterDimuon {
   {
     map_best_match_globalmuon = findBestMatchMap(tracks, fDimuonCut);
 
+    isSelectedMuon.assign(tracks.size(), false);
     for (const auto& track : tracks) {
       map_pfb[track.globalIndex()] = 0;
+      isSelectedMuon[track.globalIndex()] = fDimuonCut.IsSelectedTrack(track) && map_best_match_globalmuon[track.globalIndex()];
     } // end of track loop
 
     for (const auto& collision : collisions) {
@@ -296,10 +299,7 @@ struct prefilterDimuon {
       // LOGF(info, "centrality = %f , posTracks_per_coll.size() = %d, negTracks_per_coll.size() = %d", centralities[cfgCentEstimator], posTracks_per_coll.size(), negTracks_per_coll.size());
 
       for (const auto& [pos, neg] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
-        if (!fDimuonCut.IsSelectedTrack(pos) || !fDimuonCut.IsSelectedTrack(neg)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[pos.globalIndex()] || !map_best_match_globalmuon[neg.globalIndex()]) {
+        if (!isSelectedMuon[pos.globalIndex()] || !isSelectedMuon[neg.globalIndex()]) {
           continue;
         }
 
@@ -322,10 +322,7 @@ struct prefilterDimuon {
       } // end of ULS pairing
 
       for (const auto& [pos1, pos2] : combinations(CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
-        if (!fDimuonCut.IsSelectedTrack(pos1) || !fDimuonCut.IsSelectedTrack(pos2)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[pos1.globalIndex()] || !map_best_match_globalmuon[pos2.globalIndex()]) {
+        if (!isSelectedMuon[pos1.globalIndex()] || !isSelectedMuon[pos2.globalIndex()]) {
           continue;
         }
         // don't apply pair cut when you produce prefilter bit.
@@ -347,10 +344,7 @@ struct prefilterDimuon {
       } // end of LS++ pairing
 
       for (const auto& [neg1, neg2] : combinations(CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
-        if (!fDimuonCut.IsSelectedTrack(neg1) || !fDimuonCut.IsSelectedTrack(neg2)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[neg1.globalIndex()] || !map_best_match_globalmuon[neg2.globalIndex()]) {
+        if (!isSelectedMuon[neg1.globalIndex()] || !isSelectedMuon[neg2.globalIndex()]) {
           continue;
         }
         // don't apply pair cut when you produce prefilter bit.
@@ -393,10 +387,7 @@ struct prefilterDimuon {
       }
 
       for (const auto& [pos, neg] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, negTracks_per_coll))) { // ULS
-        if (!fDimuonCut.IsSelectedTrack(pos) || !fDimuonCut.IsSelectedTrack(neg)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[pos.globalIndex()] || !map_best_match_globalmuon[neg.globalIndex()]) {
+        if (!isSelectedMuon[pos.globalIndex()] || !isSelectedMuon[neg.globalIndex()]) {
           continue;
         }
         if (map_pfb[pos.globalIndex()] != 0 || map_pfb[neg.globalIndex()] != 0) {
@@ -415,10 +406,7 @@ struct prefilterDimuon {
       }
 
       for (const auto& [pos1, pos2] : combinations(CombinationsStrictlyUpperIndexPolicy(posTracks_per_coll, posTracks_per_coll))) { // LS++
-        if (!fDimuonCut.IsSelectedTrack(pos1) || !fDimuonCut.IsSelectedTrack(pos2)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[pos1.globalIndex()] || !map_best_match_globalmuon[pos2.globalIndex()]) {
+        if (!isSelectedMuon[pos1.globalIndex()] || !isSelectedMuon[pos2.globalIndex()]) {
           continue;
         }
         if (map_pfb[pos1.globalIndex()] != 0 || map_pfb[pos2.globalIndex()] != 0) {
@@ -437,10 +425,7 @@ struct prefilterDimuon {
       }
 
       for (const auto& [neg1, neg2] : combinations(CombinationsStrictlyUpperIndexPolicy(negTracks_per_coll, negTracks_per_coll))) { // LS--
-        if (!fDimuonCut.IsSelectedTrack(neg1) || !fDimuonCut.IsSelectedTrack(neg2)) {
-          continue;
-        }
-        if (!map_best_match_globalmuon[neg1.globalIndex()] || !map_best_match_globalmuon[neg2.globalIndex()]) {
+        if (!isSelectedMuon[neg1.globalIndex()] || !isSelectedMuon[neg2.globalIndex()]) {
           continue;
         }
         if (map_pfb[neg1.globalIndex()] != 0 || map_pfb[neg2.globalIndex()] != 0) {
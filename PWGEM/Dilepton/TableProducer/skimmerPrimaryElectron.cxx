@@ -56,6 +56,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -433,8 +434,9 @@ struct skimmerPrimaryElectron {
   }
 
   template <typename TCollision, typename TTrack>
-  void fillMLPIDTable(TCollision const& collision, TTrack const& track)
+  void addToMLPIDBatch(TCollision const& collision, TTrack const& track)
   {
+    mlpidIds.emplace_back(collision.globalIndex(), track.globalIndex());
     if (usePIDML) {
       o2::dataformats::DCA mDcaInfoCov;
       mDcaInfoCov.set(999, 999, 999, 999, 999);
@@ -459,13 +461,25 @@ struct skimmerPrimaryElectron {
       }
       // LOGF(info, "track.tpcInnerParam() = %f (GeV/c), pbin = %d", track.tpcInnerParam(), pbin);
 
-      float probaEl = mlResponseSingleTrack.getModelOutput(inputFeatures, pbin)[1]; // 0: hadron, 1:electron
-      mapProbaEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = probaEl;
-      emmlpids(collision.globalIndex(), track.globalIndex(), probaEl);
-    } else {
-      mapProbaEl[std::make_pair(collision.globalIndex(), track.globalIndex())] = 1.0;
-      emmlpids(collision.globalIndex(), track.globalIndex(), 1.0);
+      mlResponseSingleTrack.addToBatchModel(inputFeatures, pbin);
+    }
+  }
+
+  // evaluates the tracks added by addToMLPIDBatch with one call per model, and fills the MLPID table in the same order
+  void fillMLPIDTable()
+  {
+    if (usePIDML) {
+      mlResponseSingleTrack.evalBatch();
+    }
+    for (std::size_t iTrack = 0; iTrack < mlpidIds.size(); iTrack++) {
+      float probaEl = usePIDML ? mlResponseSingleTrack.getBatchOutput(iTrack)[1] : 1.f; // 0: hadron, 1:electron
+      mapProbaEl[mlpidIds[iTrack]] = probaEl;
+      emmlpids(mlpidIds[iTrack].first, mlpidIds[iTrack].second, probaEl);
+    }
+    if (usePIDML) {
+      mlResponseSingleTrack.clearBatch();
     }
+    mlpidIds.clear();
   }
 
   template <typename TCollision, typename TTrack>
@@ -771,6 +785,7 @@ struct skimmerPrimaryElectron {
   std::unordered_map<int, double> mapCollisionTime;
   std::unordered_map<int, double> mapCollisionTimeError;
 
+  std::vector<std::pair<int, int>> mlpidIds;                     // pair(collisionId, trackId) of the tracks in the MLPID batch
   std::map<std::pair<int, int>, float> mapProbaEl;               // map pair(collisionId, trackId) -> probaEl
   std::map<std::pair<int, int>, float> mapTOFNsigmaReassociated; // map pair(collisionId, trackId) -> tof n sigma
   std::map<std::pair<int, int>, float> mapTOFBetaReassociated;   // map pair(collisionId, trackId) -> tof beta
@@ -796,7 +811,10 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        fillMLPIDTable(collision, track);
+        addToMLPIDBatch(collision, track);
+      }
+      fillMLPIDTable();
+      for (const auto& track : tracks_per_coll) {
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
@@ -859,9 +877,12 @@ struct skimmerPrimaryElectron {
 
       auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, collision.globalIndex());
 
+      for (const auto& trackId : trackIdsThisCollision) {
+        addToMLPIDBatch(collision, trackId.template track_as<MyTracks>());
+      }
+      fillMLPIDTable();
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracks>();
-        fillMLPIDTable(collision, track);
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
@@ -918,7 +939,10 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        fillMLPIDTable(collision, track);
+        addToMLPIDBatch(collision, track);
+      }
+      fillMLPIDTable();
+      for (const auto& track : tracks_per_coll) {
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
@@ -982,9 +1006,12 @@ struct skimmerPrimaryElectron {
 
       auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, collision.globalIndex());
 
+      for (const auto& trackId : trackIdsThisCollision) {
+        addToMLPIDBatch(collision, trackId.template track_as<MyTracks>());
+      }
+      fillMLPIDTable();
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracks>();
-        fillMLPIDTable(collision, track);
         if (!checkTrack<false>(collision, track)) {
           continue;
         }
@@ -1045,7 +1072,10 @@ struct skimmerPrimaryElectron {
 
       auto tracks_per_coll = tracks.sliceBy(perCol, collision.globalIndex());
       for (const auto& track : tracks_per_coll) {
-        fillMLPIDTable(collision, track);
+        addToMLPIDBatch(collision, track);
+      }
+      fillMLPIDTable();
+      for (const auto& track : tracks_per_coll) {
         if (!checkTrack<true>(collision, track)) {
           continue;
         }
@@ -1108,9 +1138,12 @@ struct skimmerPrimaryElectron {
 
       auto trackIdsThisCollision = trackIndices.sliceBy(trackIndicesPerCollision, collision.globalIndex());
 
+      for (const auto& trackId : trackIdsThisCollision) {
+        addToMLPIDBatch(collision, trackId.template track_as<MyTracksMC>());
+      }
+      fillMLPIDTable();
       for (const auto& trackId : trackIdsThisCollision) {
         auto track = trackId.template track_as<MyTracksMC>();
-        fillMLPIDTable(collision, track);
         if (!checkTrack<true>(collision, track)) {
           continue;
         }
@@ -1616,31 +1649,49 @@ struct prefilterPrimaryElectron {
           continue;
         }
         getPxPyPz(trackParCov, pVec_recalc);
+        const ROOT::Math::PtEtaPhiMVector v1(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
 
         for (const auto& empos : positrons_per_coll) {
           if (empos.trackId() == ele.globalIndex()) {
             continue;
           }
 
-          ROOT::Math::PtEtaPhiMVector v1(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
-          ROOT::Math::PtEtaPhiMVector v2(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron);                            // signal track
+          ROOT::Math::PtEtaPhiMVector v2(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron); // signal track
           ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          const double mee = v12.M();
           float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(empos.px(), empos.py(), empos.pz(), pVec_recalc[0], pVec_recalc[1], pVec_recalc[2], empos.sign(), ele.sign(), d_bz);
           if (fillQAHistogram) {
-            fRegistry.fill(HIST("Pair/before/uls/hMvsPhiV"), phiv, v12.M());
-            fRegistry.fill(HIST("Pair/before/uls/hMvsPt"), v12.M(), v12.Pt());
+            fRegistry.fill(HIST("Pair/before/uls/hMvsPhiV"), phiv, mee);
+            fRegistry.fill(HIST("Pair/before/uls/hMvsPt"), mee, v12.Pt());
           }
+          uint8_t& pfb = pfb_map[empos.globalIndex()];
           for (int i = 0; i < static_cast<int>(max_mee_vec.size()); i++) {
-            if (v12.M() < max_mee_vec.at(i)) {
-              pfb_map[empos.globalIndex()] |= (uint8_t(1) << (static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPi0_20MeV) + i));
+            if (mee < max_mee_vec.at(i)) {
+              pfb |= (uint8_t(1) << (static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPi0_20MeV) + i));
             }
           }
 
-          if (v12.M() < slope * phiv + intercept) {
-            pfb_map[empos.globalIndex()] |= (uint8_t(1) << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPC));
+          if (mee < slope * phiv + intercept) {
+            pfb |= (uint8_t(1) << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPC));
           }
 
         } // end of signal positon loop
+
+        if (!fillQAHistogram) {
+          continue;
+        }
+        // the same-sign pairs are only monitored, the loose track propagated above is reused
+        for (const auto& emele : electrons_per_coll) {
+          if (emele.trackId() == ele.globalIndex()) {
+            continue;
+          }
+
+          ROOT::Math::PtEtaPhiMVector v2(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron); // signal track
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(emele.px(), emele.py(), emele.pz(), pVec_recalc[0], pVec_recalc[1], pVec_recalc[2], emele.sign(), ele.sign(), d_bz);
+          fRegistry.fill(HIST("Pair/before/lsmm/hMvsPhiV"), phiv, v12.M());
+          fRegistry.fill(HIST("Pair/before/lsmm/hMvsPt"), v12.M(), v12.Pt());
+        } // end of signal electron loop
       } // end of loose electron loop
 
       for (const auto& pos : posTracks_per_coll) {
@@ -1659,97 +1710,49 @@ struct prefilterPrimaryElectron {
           continue;
         }
         getPxPyPz(trackParCov, pVec_recalc);
+        const ROOT::Math::PtEtaPhiMVector v2(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
         for (const auto& emele : electrons_per_coll) {
           if (emele.trackId() == pos.globalIndex()) {
             continue;
           }
 
-          ROOT::Math::PtEtaPhiMVector v1(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron);                            // signal track
-          ROOT::Math::PtEtaPhiMVector v2(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
+          ROOT::Math::PtEtaPhiMVector v1(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron); // signal track
           ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          const double mee = v12.M();
           float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(pVec_recalc[0], pVec_recalc[1], pVec_recalc[2], emele.px(), emele.py(), emele.pz(), pos.sign(), emele.sign(), d_bz);
           if (fillQAHistogram) {
-            fRegistry.fill(HIST("Pair/before/uls/hMvsPhiV"), phiv, v12.M());
-            fRegistry.fill(HIST("Pair/before/uls/hMvsPt"), v12.M(), v12.Pt());
+            fRegistry.fill(HIST("Pair/before/uls/hMvsPhiV"), phiv, mee);
+            fRegistry.fill(HIST("Pair/before/uls/hMvsPt"), mee, v12.Pt());
           }
+          uint8_t& pfb = pfb_map[emele.globalIndex()];
           for (int i = 0; i < static_cast<int>(max_mee_vec.size()); i++) {
-            if (v12.M() < max_mee_vec.at(i)) {
-              pfb_map[emele.globalIndex()] |= (uint8_t(1) << (static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPi0_20MeV) + i));
+            if (mee < max_mee_vec.at(i)) {
+              pfb |= (uint8_t(1) << (static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPi0_20MeV) + i));
             }
           }
 
-          if (v12.M() < slope * phiv + intercept) {
-            pfb_map[emele.globalIndex()] |= (uint8_t(1) << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPC));
+          if (mee < slope * phiv + intercept) {
+            pfb |= (uint8_t(1) << static_cast<int>(o2::aod::pwgem::dilepton::utils::pairutil::DileptonPrefilterBit::kElFromPC));
           }
         } // end of signal electron loop
-      } // end of loose positon loop
 
-      for (const auto& pos : posTracks_per_coll) {
-        // if (!checkTrack(collision, pos)) { // track cut is applied to loose sample
-        //   continue;
-        // }
-        o2::dataformats::DCA mDcaInfoCov;
-        mDcaInfoCov.set(999, 999, 999, 999, 999);
-        std::array<float, 3> pVec_recalc = {0, 0, 0}; // px, py, pz
-        auto trackParCov = getTrackParCov(pos);
-        trackParCov.setPID(o2::track::PID::Electron);
-        mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-        mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-        bool isPropOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, trackParCov, 2.f, matCorr, &mDcaInfoCov);
-        if (!isPropOK) {
+        if (!fillQAHistogram) {
           continue;
         }
-        getPxPyPz(trackParCov, pVec_recalc);
+        // the same-sign pairs are only monitored, the loose track propagated above is reused
         for (const auto& empos : positrons_per_coll) {
           if (empos.trackId() == pos.globalIndex()) {
             continue;
           }
 
-          ROOT::Math::PtEtaPhiMVector v1(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron);                            // signal track
-          ROOT::Math::PtEtaPhiMVector v2(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
+          ROOT::Math::PtEtaPhiMVector v1(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron); // signal track
           ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
           float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(pVec_recalc[0], pVec_recalc[1], pVec_recalc[2], empos.px(), empos.py(), empos.pz(), pos.sign(), empos.sign(), d_bz);
-          if (fillQAHistogram) {
-            fRegistry.fill(HIST("Pair/before/lspp/hMvsPhiV"), phiv, v12.M());
-            fRegistry.fill(HIST("Pair/before/lspp/hMvsPt"), v12.M(), v12.Pt());
-          }
+          fRegistry.fill(HIST("Pair/before/lspp/hMvsPhiV"), phiv, v12.M());
+          fRegistry.fill(HIST("Pair/before/lspp/hMvsPt"), v12.M(), v12.Pt());
         } // end of signal positron loop
       } // end of loose positon loop
 
-      for (const auto& ele : negTracks_per_coll) {
-        // if (!checkTrack(collision, ele)) {
-        //   continue;
-        // }
-        o2::dataformats::DCA mDcaInfoCov;
-        mDcaInfoCov.set(999, 999, 999, 999, 999);
-        std::array<float, 3> pVec_recalc = {0, 0, 0}; // px, py, pz
-        auto trackParCov = getTrackParCov(ele);
-        trackParCov.setPID(o2::track::PID::Electron);
-        mVtx.setPos({collision.posX(), collision.posY(), collision.posZ()});
-        mVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-        bool isPropOK = o2::base::Propagator::Instance()->propagateToDCABxByBz(mVtx, trackParCov, 2.f, matCorr, &mDcaInfoCov);
-        if (!isPropOK) {
-          continue;
-        }
-        getPxPyPz(trackParCov, pVec_recalc);
-
-        for (const auto& emele : electrons_per_coll) {
-          if (emele.trackId() == ele.globalIndex()) {
-            continue;
-          }
-
-          ROOT::Math::PtEtaPhiMVector v1(trackParCov.getPt(), trackParCov.getEta(), trackParCov.getPhi(), o2::constants::physics::MassElectron); // loose track
-          ROOT::Math::PtEtaPhiMVector v2(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron);                            // signal track
-          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-          float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(emele.px(), emele.py(), emele.pz(), pVec_recalc[0], pVec_recalc[1], pVec_recalc[2], emele.sign(), ele.sign(), d_bz);
-          if (fillQAHistogram) {
-            fRegistry.fill(HIST("Pair/before/lsmm/hMvsPhiV"), phiv, v12.M());
-            fRegistry.fill(HIST("Pair/before/lsmm/hMvsPt"), v12.M(), v12.Pt());
-          }
-
-        } // end of signal electron loop
-      } // end of loose electron loop
-
       posTracks_per_coll.clear();
       negTracks_per_coll.clear();
       posTracks_per_coll.shrink_to_fit();
@@ -1908,49 +1911,47 @@ struct prefilterPrimaryElectron {
 
       } // end of ULS pairing
 
-      for (const auto& [pos, empos] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, positrons_per_coll))) {
-        // auto pos = tracks.rawIteratorAt(empos.trackId()); // use rawIterator, if the table is filtered.
-        if (!checkTrack(collision, pos)) { // track cut is applied to loose sample
-          continue;
-        }
-        if (!isElectron(collision, pos)) {
-          continue;
-        }
-        if (empos.trackId() == pos.globalIndex()) {
-          continue;
-        }
+      if (fillQAHistogram) { // the same-sign pairs are only monitored
+        for (const auto& [pos, empos] : combinations(CombinationsFullIndexPolicy(posTracks_per_coll, positrons_per_coll))) {
+          // auto pos = tracks.rawIteratorAt(empos.trackId()); // use rawIterator, if the table is filtered.
+          if (!checkTrack(collision, pos)) { // track cut is applied to loose sample
+            continue;
+          }
+          if (!isElectron(collision, pos)) {
+            continue;
+          }
+          if (empos.trackId() == pos.globalIndex()) {
+            continue;
+          }
 
-        ROOT::Math::PtEtaPhiMVector v1(pos.pt(), pos.eta(), pos.phi(), o2::constants::physics::MassElectron);       // loose track
-        ROOT::Math::PtEtaPhiMVector v2(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron); // signal track
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(empos.px(), empos.py(), empos.pz(), pos.px(), pos.py(), pos.pz(), empos.sign(), pos.sign(), d_bz);
-        if (fillQAHistogram) {
+          ROOT::Math::PtEtaPhiMVector v1(pos.pt(), pos.eta(), pos.phi(), o2::constants::physics::MassElectron);       // loose track
+          ROOT::Math::PtEtaPhiMVector v2(empos.pt(), empos.eta(), empos.phi(), o2::constants::physics::MassElectron); // signal track
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(empos.px(), empos.py(), empos.pz(), pos.px(), pos.py(), pos.pz(), empos.sign(), pos.sign(), d_bz);
           fRegistry.fill(HIST("Pair/before/lspp/hMvsPhiV"), phiv, v12.M());
           fRegistry.fill(HIST("Pair/before/lspp/hMvsPt"), v12.M(), v12.Pt());
-        }
-      } // end of LS++ pairing
+        } // end of LS++ pairing
 
-      for (const auto& [ele, emele] : combinations(CombinationsFullIndexPolicy(negTracks_per_coll, electrons_per_coll))) {
-        // auto ele = tracks.rawIteratorAt(emele.trackId()); // use rawIterator, if the table is filtered.
-        if (!checkTrack(collision, ele)) { // track cut is applied to loose sample
-          continue;
-        }
-        if (!isElectron(collision, ele)) {
-          continue;
-        }
-        if (emele.trackId() == ele.globalIndex()) {
-          continue;
-        }
+        for (const auto& [ele, emele] : combinations(CombinationsFullIndexPolicy(negTracks_per_coll, electrons_per_coll))) {
+          // auto ele = tracks.rawIteratorAt(emele.trackId()); // use rawIterator, if the table is filtered.
+          if (!checkTrack(collision, ele)) { // track cut is applied to loose sample
+            continue;
+          }
+          if (!isElectron(collision, ele)) {
+            continue;
+          }
+          if (emele.trackId() == ele.globalIndex()) {
+            continue;
+          }
 
-        ROOT::Math::PtEtaPhiMVector v1(ele.pt(), ele.eta(), ele.phi(), o2::constants::physics::MassElectron);       // loose track
-        ROOT::Math::PtEtaPhiMVector v2(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron); // signal track
-        ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-        float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(emele.px(), emele.py(), emele.pz(), ele.px(), ele.py(), ele.pz(), emele.sign(), ele.sign(), d_bz);
-        if (fillQAHistogram) {
+          ROOT::Math::PtEtaPhiMVector v1(ele.pt(), ele.eta(), ele.phi(), o2::constants::physics::MassElectron);       // loose track
+          ROOT::Math::PtEtaPhiMVector v2(emele.pt(), emele.eta(), emele.phi(), o2::constants::physics::MassElectron); // signal track
+          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
+          float phiv = o2::aod::pwgem::dilepton::utils::pairutil::getPhivPair(emele.px(), emele.py(), emele.pz(), ele.px(), ele.py(), ele.pz(), emele.sign(), ele.sign(), d_bz);
           fRegistry.fill(HIST("Pair/before/lsmm/hMvsPhiV"), phiv, v12.M());
           fRegistry.fill(HIST("Pair/before/lsmm/hMvsPt"), v12.M(), v12.Pt());
-        }
-      } // end of LS-- pairing
+        } // end of LS-- pairing
+      }
 
     } // end of collision loop
 
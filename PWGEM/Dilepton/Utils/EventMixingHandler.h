@@ -15,67 +15,117 @@
 #ifndef PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 #define PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
 
+#include <cstddef>
 #include <map>
+#include <span>
+#include <utility>
 #include <vector>
 
 namespace o2::aod::pwgem::dilepton::utils
 {
+// The collisions of each mixing bin are kept in a sliding window of a buffer of twice the depth, so that adding a
+// collision and dropping the oldest one is O(1) (amortized) and the collisions of a bin are always contiguous.
+// The track arrays of the dropped collisions are recycled (map node and capacity) for the next collisions, so that the
+// pool does not allocate once it is full. The pool is accessed through spans, which are valid until the pool is modified.
 template <typename T, typename U, typename V>
 class EventMixingHandler
 {
  public:
-  EventMixingHandler()
-  {
-    fNdepth = 0;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
+  EventMixingHandler() = default;
 
-  explicit EventMixingHandler(int ndepth)
-  {
-    fNdepth = ndepth;
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
-
-  ~EventMixingHandler()
-  {
-    fMapMixBins.clear();
-    fMap_Tracks_per_collision.clear();
-  }
+  explicit EventMixingHandler(int ndepth) : fNdepth(ndepth) {}
 
   void SetNdepth(int ndepth) { fNdepth = ndepth; }
 
   void ReserveNTracksPerCollision(U key_df_collision, int ntrack)
   {
-    fMap_Tracks_per_collision[key_df_collision].reserve(ntrack);
+    GetTrackArray(key_df_collision).reserve(ntrack);
   }
 
   void AddTrackToEventPool(U key_df_collision, V obj)
   {
-    fMap_Tracks_per_collision[key_df_collision].emplace_back(obj);
+    GetTrackArray(key_df_collision).emplace_back(obj);
   }
 
-  std::vector<U> GetCollisionIdsFromEventPool(T key_bin) { return fMapMixBins[key_bin]; }
-  std::vector<V> GetTracksPerCollision(T key_bin, int index) { return fMap_Tracks_per_collision[fMapMixBins[key_bin][index]]; }
-  std::vector<V> GetTracksPerCollision(U key_df_collision) { return fMap_Tracks_per_collision[key_df_collision]; }
+  std::span<const U> GetCollisionIdsFromEventPool(T key_bin)
+  {
+    auto bin = fMapMixBins.find(key_bin);
+    if (bin == fMapMixBins.end()) {
+      return {};
+    }
+    return std::span<const U>(bin->second.fCollisionIds).subspan(bin->second.fFirst);
+  }
+  std::span<const V> GetTracksPerCollision(T key_bin, int index) { return GetTracksPerCollision(GetCollisionIdsFromEventPool(key_bin)[index]); }
+  std::span<const V> GetTracksPerCollision(U key_df_collision)
+  {
+    auto tracks = fMap_Tracks_per_collision.find(key_df_collision);
+    if (tracks == fMap_Tracks_per_collision.end()) {
+      return {};
+    }
+    return tracks->second;
+  }
 
   // call this function at the end of collision loop
   void AddCollisionIdAtLast(T key_bin, U key_df_collision)
   {
-    // LOGF(info, "fMapMixBins[key_bin].size() = %d", fMapMixBins[key_bin].size());
-    if (static_cast<int>(fMapMixBins[key_bin].size()) >= fNdepth) {
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].clear();
-      fMap_Tracks_per_collision[fMapMixBins[key_bin][0]].shrink_to_fit();
-      fMapMixBins[key_bin].erase(fMapMixBins[key_bin].begin());
+    if (fNdepth <= 0) {
+      ReleaseTracks(key_df_collision);
+      return;
+    }
+    auto& bin = fMapMixBins[key_bin];
+    const std::size_t ndepth = fNdepth;
+    if (bin.fCollisionIds.capacity() < 2 * ndepth) {
+      bin.fCollisionIds.reserve(2 * ndepth);
     }
-    fMapMixBins[key_bin].emplace_back(key_df_collision);
+    if (bin.fCollisionIds.size() - bin.fFirst >= ndepth) {
+      ReleaseTracks(bin.fCollisionIds[bin.fFirst]);
+      bin.fFirst++;
+    }
+    if (bin.fCollisionIds.size() >= 2 * ndepth) { // move the window to the beginning of the buffer
+      bin.fCollisionIds.erase(bin.fCollisionIds.begin(), bin.fCollisionIds.begin() + bin.fFirst);
+      bin.fFirst = 0;
+    }
+    bin.fCollisionIds.emplace_back(key_df_collision);
   }
 
  private:
-  int fNdepth;                                           // depth of event mixing
-  std::map<T, std::vector<U>> fMapMixBins;               // map : e.g. <zbin, centbin, epbin> -> pair<df index, global collision index>
-  std::map<U, std::vector<V>> fMap_Tracks_per_collision; // map : e.g. pair<df index, global collision index> -> track array
+  using TrackMap = std::map<U, std::vector<V>>;
+
+  struct MixBin {
+    std::vector<U> fCollisionIds; // buffer of the collisions, the ones in the pool start at fFirst
+    std::size_t fFirst = 0;       // oldest collision of the pool in the buffer
+  };
+
+  // track array of a collision, recycled from a dropped collision if it is new
+  std::vector<V>& GetTrackArray(U key_df_collision)
+  {
+    auto tracks = fMap_Tracks_per_collision.find(key_df_collision);
+    if (tracks != fMap_Tracks_per_collision.end()) {
+      return tracks->second;
+    }
+    if (fFreeNodes.empty()) {
+      return fMap_Tracks_per_collision[key_df_collision];
+    }
+    auto node = std::move(fFreeNodes.back());
+    fFreeNodes.pop_back();
+    node.key() = key_df_collision;
+    return fMap_Tracks_per_collision.insert(std::move(node)).position->second;
+  }
+
+  // drop the tracks of a collision, keeping their map node and memory for the next collisions
+  void ReleaseTracks(U key_df_collision)
+  {
+    auto node = fMap_Tracks_per_collision.extract(key_df_collision);
+    if (!node.empty()) {
+      node.mapped().clear();
+      fFreeNodes.emplace_back(std::move(node));
+    }
+  }
+
+  int fNdepth = 0;                                      // depth of event mixing
+  std::map<T, MixBin> fMapMixBins;                      // map : e.g. <zbin, centbin, epbin> -> pair<df index, global collision index>
+  TrackMap fMap_Tracks_per_collision;                   // map : e.g. pair<df index, global collision index> -> track array
+  std::vector<typename TrackMap::node_type> fFreeNodes; // track arrays of the dropped collisions, to be reused
 };
 } // namespace o2::aod::pwgem::dilepton::utils
 #endif // PWGEM_DILEPTON_UTILS_EVENTMIXINGHANDLER_H_
@@ -29,14 +29,129 @@
 #include <THnSparse.h>
 #include <TKey.h>
 #include <TObject.h>
+#include <TRandom.h>
 #include <TString.h>
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
 class MomentumSmearer
 {
  public:
+  /// Cumulative distribution of a resolution histogram, computed once when the histogram is loaded
+  /// The random values are drawn exactly as in TH1::GetRandom and TH3::GetRandom3 (same calls to gRandom, same bin
+  /// search and interpolation), without going through the histogram for each generated lepton
+  class SamplingTable
+  {
+   public:
+    void build(const TH1* hist)
+    {
+      fHasEntries = hist->GetEntries() > 0;
+      fNbinsX = hist->GetNbinsX();
+      fNbinsY = hist->GetNbinsY();
+      const int nbinsZ = hist->GetNbinsZ();
+      const std::size_t nbins = static_cast<std::size_t>(fNbinsX) * fNbinsY * nbinsZ;
+      fIntegral.assign(nbins + 1, 0.);
+      std::size_t ibin = 0;
+      for (int binz = 1; binz <= nbinsZ; binz++) {
+        for (int biny = 1; biny <= fNbinsY; biny++) {
+          for (int binx = 1; binx <= fNbinsX; binx++) {
+            ibin++;
+            const double content = hist->GetBinContent(binx, biny, binz);
+            fIntegral[ibin] = fIntegral[ibin - 1] + (content > 0. ? content : 0.); // negative contents are not sampled
+          }
+        }
+      }
+      fIsEmpty = fIntegral[nbins] == 0.;
+      if (!fIsEmpty) {
+        const double integral = fIntegral[nbins];
+        for (std::size_t bin = 1; bin <= nbins; bin++) {
+          fIntegral[bin] /= integral;
+        }
+      }
+      fillEdges(hist->GetXaxis(), fLowEdgesX, fWidthsX);
+      fillEdges(hist->GetYaxis(), fLowEdgesY, fWidthsY);
+      fillEdges(hist->GetZaxis(), fLowEdgesZ, fWidthsZ);
+    }
+
+    /// \return false if the histogram had no entries, in which case no smearing is applied
+    bool hasEntries() const { return fHasEntries; }
+
+    /// \return a random value distributed as the 1D histogram, as TH1::GetRandom
+    double getRandom() const
+    {
+      if (fIsEmpty) {
+        return 0.;
+      }
+      const double r1 = gRandom->Rndm();
+      const std::size_t ibin = findBin(r1);
+      double x = fLowEdgesX[ibin];
+      if (r1 > fIntegral[ibin]) {
+        x += fWidthsX[ibin] * (r1 - fIntegral[ibin]) / (fIntegral[ibin + 1] - fIntegral[ibin]);
+      }
+      return x;
+    }
+
+    /// random values distributed as the 3D histogram, as TH3::GetRandom3
+    void getRandom3(double& x, double& y, double& z) const
+    {
+      if (fIsEmpty) {
+        x = y = z = 0.;
+        return;
+      }
+      const double r1 = gRandom->Rndm();
+      const std::size_t ibin = findBin(r1);
+      const std::size_t nxy = static_cast<std::size_t>(fNbinsX) * fNbinsY;
+      const std::size_t binz = ibin / nxy;
+      const std::size_t biny = (ibin - nxy * binz) / fNbinsX;
+      const std::size_t binx = ibin - fNbinsX * (biny + fNbinsY * binz);
+      x = fLowEdgesX[binx];
+      if (r1 > fIntegral[ibin]) {
+        x += fWidthsX[binx] * (r1 - fIntegral[ibin]) / (fIntegral[ibin + 1] - fIntegral[ibin]);
+      }
+      y = fLowEdgesY[biny] + fWidthsY[biny] * gRandom->Rndm();
+      z = fLowEdgesZ[binz] + fWidthsZ[binz] * gRandom->Rndm();
+    }
+
+   private:
+    static void fillEdges(const TAxis* axis, std::vector<double>& lowEdges, std::vector<double>& widths)
+    {
+      const int nbins = axis->GetNbins();
+      lowEdges.resize(nbins);
+      widths.resize(nbins);
+      for (int bin = 1; bin <= nbins; bin++) {
+        lowEdges[bin - 1] = axis->GetBinLowEdge(bin);
+        widths[bin - 1] = axis->GetBinWidth(bin);
+      }
+    }
+
+    /// \return the bin of a cumulated probability, as TMath::BinarySearch on the integral
+    std::size_t findBin(double r1) const
+    {
+      const auto first = fIntegral.begin();
+      const auto last = fIntegral.end() - 1; // the search excludes the last element as in TH1::GetRandom
+      auto it = std::lower_bound(first, last, r1);
+      if (it == last || *it != r1) {
+        --it;
+      }
+      return it - first;
+    }
+
+    bool fHasEntries = false;       // the histogram had entries
+    bool fIsEmpty = true;           // the histogram had no positive content
+    int fNbinsX = 0;                // number of bins in x
+    int fNbinsY = 0;                // number of bins in y
+    std::vector<double> fIntegral;  // normalised cumulative distribution, fIntegral[0] = 0
+    std::vector<double> fLowEdgesX; // lower edges of the x bins
+    std::vector<double> fWidthsX;   // widths of the x bins
+    std::vector<double> fLowEdgesY; // lower edges of the y bins
+    std::vector<double> fWidthsY;   // widths of the y bins
+    std::vector<double> fLowEdgesZ; // lower edges of the z bins
+    std::vector<double> fWidthsZ;   // widths of the z bins
+  };
+
   /// Default constructor
   MomentumSmearer() = default;
 
@@ -130,7 +245,7 @@ class MomentumSmearer
     }
   }
 
-  void fillVecReso(TH2F* fReso, std::vector<TH1F*>& fVecReso, const char* suffix)
+  void fillVecReso(TH2F* fReso, std::vector<SamplingTable>& fVecReso, const char* suffix)
   {
     TAxis* axisPt = fReso->GetXaxis(); // be careful! This works only for variable bin width.
     int nBinsPt = axisPt->GetNbins();
@@ -138,7 +253,8 @@ class MomentumSmearer
     for (int i = 0; i < nBinsPt; i++) {
       auto h1 = reinterpret_cast<TH1F*>(fReso->ProjectionY(Form("h1reso%s_pt%d", suffix, i), i + 1, i + 1));
       h1->Scale(1.f, "width"); // convert ntrack to probability density
-      fVecReso[i] = h1;
+      fVecReso[i].build(h1);
+      delete h1;
     }
   }
 
@@ -153,7 +269,7 @@ class MomentumSmearer
     LOGF(info, "ncen = %d, npt = %d, neta = %d, nphi = %d, nch = %d without under- and overflow bins", fNCenBins, fNPtBins, fNEtaBins, fNPhiBins, fNChBins);
     // fVecResoND.reserve(npt * neta * nphi * nch);
 
-    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<TH3D*>>>>(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins)))));
+    fVecResoND.resize(fNCenBins, std::vector<std::vector<std::vector<std::vector<SamplingTable>>>>(fNPtBins, std::vector<std::vector<std::vector<SamplingTable>>>(fNEtaBins, std::vector<std::vector<SamplingTable>>(fNPhiBins, std::vector<SamplingTable>(fNChBins)))));
     // fVecResoND.resize(fNPtBins, std::vector<std::vector<std::vector<TH3D*>>>(fNEtaBins, std::vector<std::vector<TH3D*>>(fNPhiBins, std::vector<TH3D*>(fNChBins))));
     //  auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(4, 5, 6));
     //  h3->SetName(Form("h3reso_pt%d_eta%d_phi%d_ch%d", 0, 0, 0, 0));
@@ -175,7 +291,8 @@ class MomentumSmearer
               auto h3 = reinterpret_cast<TH3D*>(hs_reso->Projection(5, 6, 7));
               h3->SetName(Form("h3reso_cen%d_pt%d_eta%d_phi%d_ch%d", icen, ipt, ieta, iphi, ich));
               h3->Scale(1.f, "width"); // convert ntrack to probability density
-              fVecResoND[icen][ipt][ieta][iphi][ich] = h3;
+              fVecResoND[icen][ipt][ieta][iphi][ich].build(h3);
+              delete h3;
             } // end of charge loop
           } // end of phi loop
         } // end of eta loop
@@ -371,7 +488,7 @@ class MomentumSmearer
     fInitialized = true;
   }
 
-  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, std::vector<TH1F*>& fVecReso)
+  void applySmearing(const float ptgen, const float vargen, const float multiply, float& varsmeared, TH2F* fReso, std::vector<SamplingTable> const& fVecReso)
   {
     float ptgen_tmp = ptgen > fMinPtGen ? ptgen : fMinPtGen;
     TAxis* axisPt = fReso->GetXaxis();
@@ -384,8 +501,8 @@ class MomentumSmearer
       ptbin = nBinsPt;
     }
     float smearing = 0.;
-    if (fVecReso[ptbin - 1]->GetEntries() > 0) {
-      smearing = fVecReso[ptbin - 1]->GetRandom() * multiply;
+    if (fVecReso[ptbin - 1].hasEntries()) {
+      smearing = fVecReso[ptbin - 1].getRandom() * multiply;
     }
     varsmeared = vargen - smearing;
   }
@@ -463,8 +580,9 @@ class MomentumSmearer
     }
 
     double dpt_rel = 0, deta = 0, dphi = 0;
-    if (fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetEntries() > 0) {
-      fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1]->GetRandom3(dpt_rel, deta, dphi);
+    const SamplingTable& table = fVecResoND[cenbin - 1][ptbin - 1][etabin - 1][phibin - 1][chbin - 1];
+    if (table.hasEntries()) {
+      table.getRandom3(dpt_rel, deta, dphi);
     }
     ptsmeared = ptgen - dpt_rel * ptgen;
     etasmeared = etagen - deta;
@@ -552,8 +670,8 @@ class MomentumSmearer
       ptbin = nBinsPt;
     }
     float dca = 0.;
-    if (fVecDCA[ptbin - 1]->GetEntries() > 0) {
-      dca = fVecDCA[ptbin - 1]->GetRandom();
+    if (fVecDCA[ptbin - 1].hasEntries()) {
+      dca = fVecDCA[ptbin - 1].getRandom();
     }
     return dca;
   }
@@ -627,19 +745,19 @@ class MomentumSmearer
   TH2F* fResoEta;
   TH2F* fResoPhi_Pos;
   TH2F* fResoPhi_Neg;
-  std::vector<std::vector<std::vector<std::vector<std::vector<TH3D*>>>>> fVecResoND;
+  std::vector<std::vector<std::vector<std::vector<std::vector<SamplingTable>>>>> fVecResoND;
   int fNCenBins = 1;
   int fNPtBins = 1;
   int fNEtaBins = 1;
   int fNPhiBins = 1;
   int fNChBins = 1;
-  std::vector<TH1F*> fVecResoPt;
-  std::vector<TH1F*> fVecResoEta;
-  std::vector<TH1F*> fVecResoPhi_Pos;
-  std::vector<TH1F*> fVecResoPhi_Neg;
+  std::vector<SamplingTable> fVecResoPt;
+  std::vector<SamplingTable> fVecResoEta;
+  std::vector<SamplingTable> fVecResoPhi_Pos;
+  std::vector<SamplingTable> fVecResoPhi_Neg;
   TObject* fEff;
   TH2F* fDCA;
-  std::vector<TH1F*> fVecDCA;
+  std::vector<SamplingTable> fVecDCA;
   int64_t fTimestamp;
   bool fFromCcdb = false;
   o2::framework::Service<o2::ccdb::BasicCCDBManager> fCcdb;
@@ -0,0 +1,173 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \fill buffer of THnSparse for the pair loops
+
+#ifndef PWGEM_DILEPTON_UTILS_THNSPARSEFILLBUFFER_H_
+#define PWGEM_DILEPTON_UTILS_THNSPARSEFILLBUFFER_H_
+
+#include <Framework/Logger.h>
+
+#include <TArrayD.h>
+#include <TAxis.h>
+#include <THnSparse.h>
+
+#include <RtypesCore.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace o2::aod::pwgem::dilepton::utils
+{
+// The entries of a THnSparse are summed per bin in a buffer and added to the histogram by Flush(), so that the bin of
+// the THnSparse (hash lookup and allocation) is looked up once per bin and not once per entry. The binning of the axes
+// is cached at Bind(), and the bin of each axis is found inline as in TAxis::FindBin, including the under/overflow bins.
+// The bin contents, the squared weights and the number of entries are the same as if the entries were filled one by one.
+// The sums of the weights times the coordinates kept by THnBase::Fill are not updated, as in THnBase::Add, which is also
+// used to merge the outputs. The buffer must be flushed before the histogram is written, e.g. at the end of each data frame.
+class THnSparseFillBuffer
+{
+ public:
+  THnSparseFillBuffer() = default;
+
+  /// Binds the buffer to a histogram, the pending entries are flushed to the previous one
+  /// The binning of the histogram must not change while it is bound
+  void Bind(THnSparse* hist)
+  {
+    if (hist == fHist) {
+      return;
+    }
+    Flush();
+    fHist = hist;
+    const int ndim = hist->GetNdimensions();
+    fAxes.assign(ndim, Axis());
+    fStrides.assign(ndim, 1);
+    fIsPacked = true;
+    Long64_t stride = 1;
+    for (int i = 0; i < ndim; i++) {
+      const TAxis* axis = hist->GetAxis(i);
+      Axis& cache = fAxes[i];
+      cache.nbins = axis->GetNbins();
+      cache.min = axis->GetXmin();
+      cache.max = axis->GetXmax();
+      if (axis->GetXbins()->fN) {
+        cache.edges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->fN);
+      }
+      fStrides[i] = stride;
+      const Long64_t nbins = cache.nbins + 2; // including under/overflow
+      if (stride > std::numeric_limits<Long64_t>::max() / nbins) {
+        fIsPacked = false; // the bins can not be packed in 64 bits, the entries are filled directly
+      } else {
+        stride *= nbins;
+      }
+    }
+    fCoordinates.resize(ndim);
+  }
+
+  /// Fills an entry, with the same arguments and the same result as THnSparse::Fill
+  /// \param valuesAndWeight values of all the axes, optionally followed by the weight
+  template <typename... Ts>
+  void Fill(const Ts&... valuesAndWeight)
+  {
+    constexpr int NArgs = sizeof...(Ts);
+    const int ndim = fAxes.size();
+    if (NArgs != ndim && NArgs != ndim + 1) {
+      LOGF(fatal, "Number of arguments (%d) does not match the number of axes (%d) of %s", NArgs, ndim, fHist->GetName());
+    }
+    const double values[] = {static_cast<double>(valuesAndWeight)...};
+    const double weight = (NArgs == ndim + 1) ? values[ndim] : 1.;
+    if (!fIsPacked) {
+      fHist->Fill(values, weight);
+      return;
+    }
+
+    Long64_t key = 0;
+    for (int i = 0; i < ndim; i++) {
+      key += fAxes[i].FindBin(values[i]) * fStrides[i];
+    }
+    Bin& bin = fBins[key];
+    bin.sumw += weight;
+    bin.sumw2 += weight * weight;
+    fNentries++;
+    if (fBins.size() >= MaxBins) {
+      Flush();
+    }
+  }
+
+  /// Adds the pending entries to the histogram
+  void Flush()
+  {
+    if (!fNentries) {
+      return;
+    }
+    const int ndim = fAxes.size();
+    const bool hasErrors = fHist->GetCalculateErrors();
+    fHist->Reserve(fHist->GetNbins() + fBins.size());
+    for (const auto& [key, bin] : fBins) {
+      Long64_t rest = key;
+      for (int i = ndim - 1; i >= 0; i--) {
+        fCoordinates[i] = rest / fStrides[i];
+        rest -= fCoordinates[i] * fStrides[i];
+      }
+      const Long64_t globalBin = fHist->GetBin(fCoordinates.data(), kTRUE);
+      if (hasErrors) {
+        fHist->AddBinError2(globalBin, bin.sumw2);
+      }
+      // only after the errors, as in THnBase::Add
+      fHist->AddBinContent(globalBin, bin.sumw);
+    }
+    fHist->SetEntries(fHist->GetEntries() + fNentries);
+    fBins.clear();
+    fNentries = 0;
+  }
+
+ private:
+  struct Axis {
+    int nbins = 0;             // number of bins
+    double min = 0.;           // lower edge
+    double max = 0.;           // upper edge
+    std::vector<double> edges; // bin edges, empty for fixed bins
+
+    /// \return the bin of a value, as TAxis::FindBin
+    int FindBin(double x) const
+    {
+      if (x < min) {
+        return 0;
+      } else if (!(x < max)) {
+        return nbins + 1;
+      } else if (edges.empty()) {
+        return 1 + static_cast<int>(nbins * (x - min) / (max - min));
+      }
+      return std::upper_bound(edges.begin(), edges.end(), x) - edges.begin();
+    }
+  };
+
+  struct Bin {
+    double sumw = 0.;  // sum of the weights
+    double sumw2 = 0.; // sum of the squared weights
+  };
+
+  static constexpr std::size_t MaxBins = 1 << 16; // maximum number of pending bins
+
+  THnSparse* fHist = nullptr;              // histogram the buffer is bound to
+  std::vector<Axis> fAxes;                 // binning of the axes
+  std::vector<Long64_t> fStrides;          // stride of each axis in the packed bin
+  bool fIsPacked = true;                   // the bins of the histogram can be packed in 64 bits
+  std::vector<Int_t> fCoordinates;         // bin of each axis, for the flush
+  std::unordered_map<Long64_t, Bin> fBins; // pending bins, by packed bin
+  Long64_t fNentries = 0;                  // number of pending entries
+};
+} // namespace o2::aod::pwgem::dilepton::utils
+
+#endif // PWGEM_DILEPTON_UTILS_THNSPARSEFILLBUFFER_H_
@@ -34,12 +34,11 @@ float EMNonLin::getCorrectionFactor(float var, const Context& ctx)
     if (refVal == 0.f) {
       break;
     }
-    const auto& p = ctx.params[i];
-
-    // evaluate pol1 for each parameter at this centrality
-    float a = p.a0 + p.a1 * ctx.cent;
-    float b = p.b0 + p.b1 * ctx.cent;
-    float c = p.c0 + p.c1 * ctx.cent;
+    // pol1 of each parameter at this centrality, evaluated by the context
+    const auto& p = ctx.centParams[i];
+    float a = p.a;
+    float b = p.b;
+    float c = p.c;
 
     // guard against c <= 0 which would make pow(x, -c) diverge
     if (c <= 0.f) {
@@ -51,16 +51,24 @@ class EMNonLin
     float c0{0.f}, c1{0.f}; // pol1 params for c: exponent
   };
 
+  struct CentParams {
+    float a{1.f}; // asymptote at the current centrality
+    float b{0.f}; // magnitude at the current centrality
+    float c{0.f}; // exponent at the current centrality
+  };
+
   struct Context {
     const NonLinParams* params = nullptr;
     int nIter = 0;
     float cent = 0.f;
+    CentParams centParams[MaxIter] = {}; // a, b and c of each iteration, evaluated once per change of params or centrality
 
     /// \brief Sets parameters for the NonLin. Used with EMNonLin::resolveParams()
     /// \param newParams pointer to new NonLinParams
     void setParams(const NonLinParams* newParams)
     {
       params = newParams;
+      updateCentParams();
     }
 
     /// \brief Sets iteration used for the NonLin.
@@ -75,6 +83,21 @@ class EMNonLin
     void setCent(float centrality)
     {
       cent = (centrality >= MaxCent) ? MaxCent : centrality;
+      updateCentParams();
+    }
+
+    /// \brief Evaluates the pol1 of a, b and c at the current centrality, so that they are not recomputed for each photon.
+    void updateCentParams()
+    {
+      if (!params) {
+        return;
+      }
+      for (int i = 0; i < MaxIter; ++i) {
+        const auto& p = params[i];
+        centParams[i].a = p.a0 + p.a1 * cent;
+        centParams[i].b = p.b0 + p.b1 * cent;
+        centParams[i].c = p.c0 + p.c1 * cent;
+      }
     }
   };
 
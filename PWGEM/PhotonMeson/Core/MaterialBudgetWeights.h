@@ -25,10 +25,14 @@
 #include <Framework/InitContext.h>
 #include <Framework/Logger.h>
 
+#include <TArrayD.h>
+#include <TAxis.h>
 #include <TH1.h>
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <vector>
 
 using MyV0PhotonsMB = o2::soa::Join<o2::aod::V0PhotonsKF, o2::aod::V0KFEMEventIds>;
 using MyV0PhotonMB = MyV0PhotonsMB::iterator;
@@ -42,6 +46,12 @@ struct MaterialBudgetWeights {
   o2::ccdb::CcdbApi ccdbApi;
   TH1F* hOmegaMBFromCCDB = nullptr;
 
+  // weights of the CCDB histogram, copied once so that the weight of each V0 is a direct lookup
+  std::vector<float> mbWeights; // weight of each bin, without under/overflow
+  std::vector<double> mbEdges;  // bin edges, empty for fixed bins
+  double mbRxyMin = 0.;         // lower edge of the histogram
+  double mbRxyMax = 0.;         // upper edge of the histogram
+
   void init(o2::framework::InitContext&)
   {
     // Load CCDB object only when the real process is enabled
@@ -59,6 +69,17 @@ struct MaterialBudgetWeights {
     if (!hOmegaMBFromCCDB) {
       LOG(fatal) << "MaterialBudgetWeights: CCDB object is missing. Path=" << mbWeightsPath.value;
     }
+
+    const TAxis* axis = hOmegaMBFromCCDB->GetXaxis();
+    mbWeights.resize(axis->GetNbins());
+    for (int i = 0; i < axis->GetNbins(); i++) {
+      mbWeights[i] = hOmegaMBFromCCDB->GetBinContent(i + 1);
+    }
+    if (axis->GetXbins()->fN) {
+      mbEdges.assign(axis->GetXbins()->GetArray(), axis->GetXbins()->GetArray() + axis->GetXbins()->fN);
+    }
+    mbRxyMin = axis->GetXmin();
+    mbRxyMax = axis->GetXmax();
   }
 
   float computeMBWeight(float v0Rxy)
@@ -67,13 +88,21 @@ struct MaterialBudgetWeights {
       return 1.f;
     }
 
-    int binMBWeight = hOmegaMBFromCCDB->FindBin(v0Rxy);
-    if (binMBWeight < 1 || binMBWeight > hOmegaMBFromCCDB->GetNbinsX()) {
+    // same bin as TAxis::FindBin
+    if (!(v0Rxy >= mbRxyMin && v0Rxy < mbRxyMax)) {
       LOG(debug) << "MaterialBudgetWeights: v0Rxy out of histogram range, returning 1";
       return 1.f;
     }
-
-    return hOmegaMBFromCCDB->GetBinContent(binMBWeight);
+    int binMBWeight = 0; // starting from 0
+    if (mbEdges.empty()) {
+      binMBWeight = static_cast<int>(mbWeights.size() * (v0Rxy - mbRxyMin) / (mbRxyMax - mbRxyMin));
+      if (binMBWeight >= static_cast<int>(mbWeights.size())) { // rounding just below the upper edge, overflow as in TAxis::FindBin
+        return 1.f;
+      }
+    } else {
+      binMBWeight = std::upper_bound(mbEdges.begin(), mbEdges.end(), v0Rxy) - mbEdges.begin() - 1;
+    }
+    return mbWeights[binMBWeight];
   }
 
   // real process (weights from CCDB)
@@ -68,6 +68,7 @@
 #include <string>
 #include <tuple>
 #include <type_traits>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -92,6 +93,7 @@ struct Pi0EtaToGammaGamma {
   o2::framework::Configurable<float> cfgCentMin{"cfgCentMin", 0, "min. centrality"};
   o2::framework::Configurable<float> cfgCentMax{"cfgCentMax", 999, "max. centrality"};
   o2::framework::Configurable<float> maxY{"maxY", 0.8, "maximum rapidity for reconstructed particles"};
+  o2::framework::Configurable<float> cfgMaxMassPairing{"cfgMaxMassPairing", -1.f, "max. mass of the photon pairs, the pairs above are neither filled nor used for the event mixing (no cut if negative)"};
   o2::framework::Configurable<bool> cfgDoMix{"cfgDoMix", true, "flag for event mixing"};
   o2::framework::Configurable<int> ndepth{"ndepth", 10, "depth for event mixing"};
   o2::framework::ConfigurableAxis ConfVtxBins{"ConfVtxBins", {o2::framework::VARIABLE_WIDTH, -10.0f, -8.f, -6.f, -4.f, -2.f, 0.f, 2.f, 4.f, 6.f, 8.f, 10.f}, "Mixing bins - z-vertex"};
@@ -254,8 +256,24 @@ struct Pi0EtaToGammaGamma {
   o2::aod::pwgem::dilepton::utils::EventMixingHandler<std::tuple<int, int, int, int>, std::pair<int, int>, o2::aod::pwgem::photonmeson::utils::EMPhoton>* emh2 = nullptr;
   //---------------------------------------------------------------------------
 
-  std::vector<int> used_photonIds_per_col;                   // <ndf, trackId>
+  std::unordered_set<int> used_photonIds_per_col;            // <ndf, trackId>
   std::vector<std::pair<int, int>> used_dileptonIds_per_col; // <ndf, trackId>
+
+  // photon of a collision which passed the cuts, with its kinematics for the pairing
+  struct PairingPhoton {
+    int globalIndex = -1; // index of the photon
+    float pt = 0.f;       // transverse momentum
+    float eta = 0.f;      // pseudorapidity
+    float phi = 0.f;      // azimuth
+    float energy = 0.f;   // energy of the photon, for the energy asymmetry
+    float weight = 1.f;   // material budget weight of the photon
+    double px = 0.;       // momentum and energy of the massless 4-vector
+    double py = 0.;
+    double pz = 0.;
+    double e = 0.;
+  };
+  std::vector<PairingPhoton> selected_photons1; // selected photons of the first table in the current collision
+  std::vector<PairingPhoton> selected_photons2; // selected photons of the second table in the current collision
   std::map<std::pair<int, int>, uint64_t> map_mixed_eventId_to_globalBC;
 
   std::vector<float> zvtx_bin_edges;
@@ -462,7 +480,6 @@ struct Pi0EtaToGammaGamma {
     emh2 = 0x0;
 
     used_photonIds_per_col.clear();
-    used_photonIds_per_col.shrink_to_fit();
     used_dileptonIds_per_col.clear();
     used_dileptonIds_per_col.shrink_to_fit();
     map_mixed_eventId_to_globalBC.clear();
@@ -694,6 +711,52 @@ struct Pi0EtaToGammaGamma {
     return;
   }
 
+  /// \brief fills the photons of a collision which pass the cuts, with their kinematics
+  /// \tparam TDetectorTag tag for TPhotons type to select the proper cut function and arguments
+  /// \param photons_per_collision photons of the collision
+  /// \param applyCutWithoutTM if the EMCal clusters also have to pass the cut without matched tracks
+  /// \param matchedTracks table of matched global tracks to EMCal clusters (optional)
+  /// \param matchedSecondaries table of matched secondary tracks to EMCal clusters (optional)
+  /// \param selected selected photons
+  template <typename TDetectorTag, typename TPhotons, typename TMatchedTracks, typename TMatchedSecondaries>
+  void selectPhotonsForPairing(TPhotons const& photons_per_collision, bool applyCutWithoutTM, TMatchedTracks const& matchedTracks, TMatchedSecondaries const& matchedSecondaries, std::vector<PairingPhoton>& selected)
+  {
+    selected.clear();
+    selected.reserve(photons_per_collision.size());
+    for (const auto& g : photons_per_collision) {
+      if constexpr (std::is_same_v<TDetectorTag, EMCTag>) {
+        if (applyCutWithoutTM && !TDetectorTag::applyCut(*this, g)) {
+          continue;
+        }
+        // For the EMCal case we need to get the primary and secondary matched tracks
+        auto matchedTracksPerCluster = matchedTracks.sliceByCached(TDetectorTag::perClusterMT(), g.globalIndex(), cache);
+        auto matchedSecondariesPerCluster = matchedSecondaries.sliceByCached(TDetectorTag::perClusterMS(), g.globalIndex(), cache);
+        if (!TDetectorTag::applyCut(*this, g, matchedTracksPerCluster, matchedSecondariesPerCluster)) {
+          continue;
+        }
+      } else {
+        if (!TDetectorTag::applyCut(*this, g)) {
+          continue;
+        }
+      }
+
+      PairingPhoton& photon = selected.emplace_back();
+      photon.globalIndex = g.globalIndex();
+      photon.pt = g.pt();
+      photon.eta = g.eta();
+      photon.phi = g.phi();
+      photon.energy = g.e();
+      if constexpr (requires { g.omegaMBWeight(); }) {
+        photon.weight = g.omegaMBWeight();
+      }
+      ROOT::Math::PtEtaPhiMVector v(photon.pt, photon.eta, photon.phi, 0.);
+      photon.px = v.Px();
+      photon.py = v.Py();
+      photon.pz = v.Pz();
+      photon.e = v.E();
+    }
+  }
+
   /// \brief function to run the photon pairing
   /// \tparam TDetectorTag1 tag for TPhotons1 type to select the proper cut function and arguments
   /// \tparam TDetectorTag2 tag for TPhotons2 type to select the proper cut function and arguments
@@ -843,9 +906,8 @@ struct Pi0EtaToGammaGamma {
             fRegistry.fill(HIST("Pair/same/hs"), veeg.M(), veeg.Pt(), weight);
 
             std::pair<int, int> tuple_tmp_id2 = std::make_pair(pos2.trackId(), ele2.trackId());
-            if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g1.globalIndex()) == used_photonIds_per_col.end()) {
+            if (used_photonIds_per_col.insert(g1.globalIndex()).second) {
               emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g1.pt(), g1.eta(), g1.phi(), 0));
-              used_photonIds_per_col.emplace_back(g1.globalIndex());
             }
             if (std::find(used_dileptonIds_per_col.begin(), used_dileptonIds_per_col.end(), tuple_tmp_id2) == used_dileptonIds_per_col.end()) {
               emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(v_ee.Pt(), v_ee.Eta(), v_ee.Phi(), v_ee.M()));
@@ -858,86 +920,72 @@ struct Pi0EtaToGammaGamma {
         auto photons1_per_collision = photons1.sliceByCached(TDetectorTag1::perCollision(), collision.globalIndex(), cache);
         auto photons2_per_collision = photons2.sliceByCached(TDetectorTag2::perCollision(), collision.globalIndex(), cache);
 
-        for (const auto& [g1, g2] : o2::soa::combinations(TCombinationPolicy(photons1_per_collision, photons2_per_collision))) {
-          if constexpr (std::is_same_v<TDetectorTag1, EMCTag>) {
-            // For the EMCal case we need to get the primary and secondary matched tracks
-            auto matchedTracks1 = matchedTracks.sliceByCached(TDetectorTag1::perClusterMT(), g1.globalIndex(), cache);
-            auto matchedSecondaries1 = matchedSecondaries.sliceByCached(TDetectorTag1::perClusterMS(), g1.globalIndex(), cache);
-
-            if (!TDetectorTag1::applyCut(*this, g1, matchedTracks1, matchedSecondaries1)) {
+        // the cuts and the kinematics of the photons are evaluated once per photon and not once per pair
+        // the EMCal clusters paired with photons of another detector also have to pass the cut without matched tracks
+        constexpr bool IsSameTable = std::is_same_v<TDetectorTag1, TDetectorTag2> && std::is_same_v<TPhotons1, TPhotons2>;
+        selectPhotonsForPairing<TDetectorTag1>(photons1_per_collision, false, matchedTracks, matchedSecondaries, selected_photons1);
+        if constexpr (!IsSameTable) {
+          selectPhotonsForPairing<TDetectorTag2>(photons2_per_collision, !std::is_same_v<TDetectorTag1, EMCTag>, matchedTracks, matchedSecondaries, selected_photons2);
+        }
+        const std::vector<PairingPhoton>& selected2 = IsSameTable ? selected_photons1 : selected_photons2;
+        constexpr bool IsStrictlyUpper = std::is_same_v<TCombinationPolicy<TPhotons1, TPhotons2>, o2::soa::CombinationsStrictlyUpperIndexPolicy<TPhotons1, TPhotons2>>;
+        const float maxMass2 = cfgMaxMassPairing * cfgMaxMassPairing;
+
+        for (std::size_t i1 = 0; i1 < selected_photons1.size(); i1++) {
+          const auto& g1 = selected_photons1[i1];
+          for (std::size_t i2 = IsStrictlyUpper ? i1 + 1 : 0; i2 < selected2.size(); i2++) {
+            const auto& g2 = selected2[i2];
+
+            // for massless photons, m^2 = 2 (E1 E2 - p1.p2)
+            if (cfgMaxMassPairing > 0.f && 2. * (g1.e * g2.e - g1.px * g2.px - g1.py * g2.py - g1.pz * g2.pz) > maxMass2) {
               continue;
             }
-          } else {
-            if (!TDetectorTag1::applyCut(*this, g1) || !TDetectorTag2::applyCut(*this, g2)) {
+
+            ROOT::Math::PtEtaPhiMVector v12;
+            v12.SetPxPyPzE(g1.px + g2.px, g1.py + g2.py, g1.pz + g2.pz, g1.e + g2.e);
+            if (std::fabs(v12.Rapidity()) > maxY) {
               continue;
             }
-          }
 
-          if constexpr (std::is_same_v<TDetectorTag2, EMCTag>) {
-            auto matchedTracks2 = matchedTracks.sliceByCached(TDetectorTag2::perClusterMT(), g2.globalIndex(), cache);
-            auto matchedSecondaries2 = matchedSecondaries.sliceByCached(TDetectorTag2::perClusterMS(), g2.globalIndex(), cache);
-            if (!TDetectorTag2::applyCut(*this, g2, matchedTracks2, matchedSecondaries2)) {
-              continue;
+            float alphaMeson = std::fabs(g1.energy - g2.energy) / (g1.energy + g2.energy);
+            float alphaCut = 999.f;
+            switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
+              case AlphaMesonCutOption::Off:
+                break;
+              case AlphaMesonCutOption::SpecificValue:
+                alphaCut = cfgAlphaMeson;
+                break;
+              case AlphaMesonCutOption::PTDependent: {
+                alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
+                break;
+              }
+              default:
+                LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
             }
-          } else {
-            if (!TDetectorTag2::applyCut(*this, g2)) {
+            if (alphaMeson > alphaCut) {
               continue;
             }
-          }
-
-          ROOT::Math::PtEtaPhiMVector v1(g1.pt(), g1.eta(), g1.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v2(g2.pt(), g2.eta(), g2.phi(), 0.);
-          ROOT::Math::PtEtaPhiMVector v12 = v1 + v2;
-          if (std::fabs(v12.Rapidity()) > maxY) {
-            continue;
-          }
-
-          float alphaMeson = std::fabs(g1.e() - g2.e()) / (g1.e() + g2.e());
-          float alphaCut = 999.f;
-          switch (static_cast<AlphaMesonCutOption>(cfgAlphaMesonCut.value)) {
-            case AlphaMesonCutOption::Off:
-              break;
-            case AlphaMesonCutOption::SpecificValue:
-              alphaCut = cfgAlphaMeson;
-              break;
-            case AlphaMesonCutOption::PTDependent: {
-              alphaCut = cfgAlphaMesonA * std::tanh(cfgAlphaMesonB * v12.pt());
-              break;
-            }
-            default:
-              LOGF(error, "Invalid option for alpha meson cut. No alpha cut will be applied.");
-          }
-          if (alphaMeson > alphaCut) {
-            continue;
-          }
-
-          float wpair = weight;
 
-          if constexpr (requires { g1.omegaMBWeight(); }) {
-            wpair *= g1.omegaMBWeight();
-          }
-          if constexpr (requires { g2.omegaMBWeight(); }) {
-            wpair *= g2.omegaMBWeight();
-          }
+            float wpair = weight * g1.weight * g2.weight;
 
-          fRegistry.fill(HIST("Pair/same/hs"), v12.M(), v12.Pt(), wpair);
+            fRegistry.fill(HIST("Pair/same/hs"), v12.M(), v12.Pt(), wpair);
 
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g1.globalIndex()) == used_photonIds_per_col.end()) {
-            emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g1.pt(), g1.eta(), g1.phi(), 0));
-            used_photonIds_per_col.emplace_back(g1.globalIndex());
-          }
-          if (std::find(used_photonIds_per_col.begin(), used_photonIds_per_col.end(), g2.globalIndex()) == used_photonIds_per_col.end()) {
-            emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g2.pt(), g2.eta(), g2.phi(), 0));
-            used_photonIds_per_col.emplace_back(g2.globalIndex());
+            if (used_photonIds_per_col.insert(g1.globalIndex).second) {
+              emh1->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g1.pt, g1.eta, g1.phi, 0));
+            }
+            if (used_photonIds_per_col.insert(g2.globalIndex).second) {
+              emh2->AddTrackToEventPool(key_df_collision, o2::aod::pwgem::photonmeson::utils::EMPhoton(g2.pt, g2.eta, g2.phi, 0));
+            }
+            ndiphoton++;
           }
-          ndiphoton++;
         } // end of pairing loop
       } // end of pairing in same event
 
       used_photonIds_per_col.clear();
-      used_photonIds_per_col.shrink_to_fit();
       used_dileptonIds_per_col.clear();
       used_dileptonIds_per_col.shrink_to_fit();
+      selected_photons1.clear();
+      selected_photons2.clear();
 
       // event mixing
       if (!cfgDoMix || !(ndiphoton > 0)) {
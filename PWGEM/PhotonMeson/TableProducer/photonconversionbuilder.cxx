@@ -65,6 +65,7 @@
 #include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <set>
@@ -504,8 +505,29 @@ struct PhotonConversionBuilder {
     }
   }
 
+  struct CachedV0 {
+    V0PhotonCandidate candidate;
+    KFParticle gammaKF_DecayVtx;
+    KFParticle gammaKF_PV;
+    KFParticle kfp_pos_DecayVtx;
+    KFParticle kfp_ele_DecayVtx;
+    o2::track::TrackParCov pTrack;
+    o2::track::TrackParCov nTrack;
+    float posdcaXY;
+    float posdcaZ;
+    float eledcaXY;
+    float eledcaZ;
+    float cospa_kf;
+    float cospaXYKF;
+    float cospaRZKF;
+    float rxy;
+    float v0eta;
+    float v0phi;
+  };
+
+  // first pass: topological selection of the v0 and secondary-vertex fit. The fit of the candidates is kept in v0_cache, so that the selected ones are written without a second fit.
   template <bool isMC, class TBCs, class TCollisions, class TTracks, typename TV0>
-  void fillV0Table(TV0 const& v0, const bool filltable)
+  void buildV0Candidate(TV0 const& v0)
   {
     // Get tracks
     const auto& pos = v0.template posTrack_as<TTracks>();
@@ -655,20 +677,18 @@ struct PhotonConversionBuilder {
       return;
     }
 
-    if (!filltable) {
-      if (isITSTPCTrack(pos) && isITSTPCTrack(ele)) {
-        registry.fill(HIST("V0/hRxy_minX_ITSTPC_ITSTPC"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
-      } else if (isITSonlyTrack(pos) && isITSonlyTrack(ele)) {
-        registry.fill(HIST("V0/hRxy_minX_ITSonly_ITSonly"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
-      } else if ((isITSTPCTrack(pos) && isITSonlyTrack(ele)) || (isITSTPCTrack(ele) && isITSonlyTrack(pos))) {
-        registry.fill(HIST("V0/hRxy_minX_ITSTPC_ITSonly"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
-      } else if (isITSTPCTrack(pos) && !ele.hasITS()) {
-        registry.fill(HIST("V0/hRxy_minX_ITSTPC_TPC"), std::min(pTrack.getX(), 83.f), std::min(pTrack.getX(), 83.f) - rxy); // trackiu.x() - rxy should be positive
-      } else if (isITSTPCTrack(ele) && !pos.hasITS()) {
-        registry.fill(HIST("V0/hRxy_minX_ITSTPC_TPC"), std::min(nTrack.getX(), 83.f), std::min(nTrack.getX(), 83.f) - rxy); // trackiu.x() - rxy should be positive
-      } else {
-        registry.fill(HIST("V0/hRxy_minX_TPC_TPC"), std::min(83.f, 83.f), std::min(83.f, 83.f) - rxy); // trackiu.x() - rxy should be positive
-      }
+    if (isITSTPCTrack(pos) && isITSTPCTrack(ele)) {
+      registry.fill(HIST("V0/hRxy_minX_ITSTPC_ITSTPC"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
+    } else if (isITSonlyTrack(pos) && isITSonlyTrack(ele)) {
+      registry.fill(HIST("V0/hRxy_minX_ITSonly_ITSonly"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
+    } else if ((isITSTPCTrack(pos) && isITSonlyTrack(ele)) || (isITSTPCTrack(ele) && isITSonlyTrack(pos))) {
+      registry.fill(HIST("V0/hRxy_minX_ITSTPC_ITSonly"), std::min(pTrack.getX(), nTrack.getX()), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
+    } else if (isITSTPCTrack(pos) && !ele.hasITS()) {
+      registry.fill(HIST("V0/hRxy_minX_ITSTPC_TPC"), std::min(pTrack.getX(), 83.f), std::min(pTrack.getX(), 83.f) - rxy); // trackiu.x() - rxy should be positive
+    } else if (isITSTPCTrack(ele) && !pos.hasITS()) {
+      registry.fill(HIST("V0/hRxy_minX_ITSTPC_TPC"), std::min(nTrack.getX(), 83.f), std::min(nTrack.getX(), 83.f) - rxy); // trackiu.x() - rxy should be positive
+    } else {
+      registry.fill(HIST("V0/hRxy_minX_TPC_TPC"), std::min(83.f, 83.f), std::min(83.f, 83.f) - rxy); // trackiu.x() - rxy should be positive
     }
 
     if (pos.hasITS() && ele.hasITS()) { // ITSonly-ITSonly, ITSTPC-ITSTPC, ITSTPC-ITSonly
@@ -772,107 +792,126 @@ struct PhotonConversionBuilder {
     }
     pca_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = v0photoncandidate.getPCA();
     cospa_map[std::make_tuple(v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())] = v0photoncandidate.getCosPA();
+    v0_cache.emplace(v0.globalIndex(), CachedV0{v0photoncandidate, gammaKF_DecayVtx, gammaKF_PV, kfp_pos_DecayVtx, kfp_ele_DecayVtx, pTrack, nTrack, posdcaXY, posdcaZ, eledcaXY, eledcaZ, cospa_kf, cospaXYKF, cospaRZKF, rxy, v0eta, v0phi});
+  }
+
+  // second pass: ML selection and tables of a v0 selected by build(), from the fit cached in the first pass and the ML scores of the batch
+  template <bool isMC, class TCollisions, class TTracks, typename TV0>
+  void fillV0Table(TV0 const& v0, CachedV0 const& cache, const std::size_t iCandML)
+  {
+    const auto& pos = v0.template posTrack_as<TTracks>();
+    const auto& ele = v0.template negTrack_as<TTracks>();
+    const auto& collision = v0.template collision_as<TCollisions>();
+    const auto& gammaKF_DecayVtx = cache.gammaKF_DecayVtx;
+    const auto& gammaKF_PV = cache.gammaKF_PV;
+    const auto& kfp_pos_DecayVtx = cache.kfp_pos_DecayVtx;
+    const auto& kfp_ele_DecayVtx = cache.kfp_ele_DecayVtx;
+    const auto& pTrack = cache.pTrack;
+    const auto& nTrack = cache.nTrack;
+    const float posdcaXY = cache.posdcaXY;
+    const float posdcaZ = cache.posdcaZ;
+    const float eledcaXY = cache.eledcaXY;
+    const float eledcaZ = cache.eledcaZ;
+    const float cospa_kf = cache.cospa_kf;
+    const float cospaXYKF = cache.cospaXYKF;
+    const float cospaRZKF = cache.cospaRZKF;
+    const float rxy = cache.rxy;
+    const float v0eta = cache.v0eta;
+    const float v0phi = cache.v0phi;
+    v0photoncandidate = cache.candidate;
 
     if (applyPCMMl) {
-      bool isSelectedML = false;
-      std::vector<float> mlInputFeatures = emMlResponse.getInputFeatures(v0photoncandidate, pos, ele);
-      if (use2DBinning) {
-        isSelectedML = emMlResponse.isSelectedMl(mlInputFeatures, v0photoncandidate.getPt(), v0photoncandidate.getCent(), outputML);
+      bool isSelectedML = emMlResponse.isSelectedBatch(iCandML);
+      const auto scoresML = emMlResponse.getBatchOutput(iCandML);
+      outputML.assign(scoresML.begin(), scoresML.end());
+      if (nClassesPCMMl == 2) {
+        registry.fill(HIST("V0/hBDTBackgroundScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
+        registry.fill(HIST("V0/hBDTSignalScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
+      } else if (nClassesPCMMl == 3) {
+        registry.fill(HIST("V0/hBDTPrimaryPhotonScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
+        registry.fill(HIST("V0/hBDTSecondaryPhotonScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
+        registry.fill(HIST("V0/hBDTBackgroundScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[2]);
       } else {
-        isSelectedML = emMlResponse.isSelectedMl(mlInputFeatures, v0photoncandidate.getPt(), outputML);
-      }
-      if (filltable) {
-        if (nClassesPCMMl == 2) {
-          registry.fill(HIST("V0/hBDTBackgroundScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-          registry.fill(HIST("V0/hBDTSignalScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
-        } else if (nClassesPCMMl == 3) {
-          registry.fill(HIST("V0/hBDTPrimaryPhotonScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-          registry.fill(HIST("V0/hBDTSecondaryPhotonScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
-          registry.fill(HIST("V0/hBDTBackgroundScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[2]);
-        } else {
-          registry.fill(HIST("V0/hBDTScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-        }
+        registry.fill(HIST("V0/hBDTScoreBeforeCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
       }
       if (!isSelectedML) {
         return;
       }
-      if (filltable) {
-        if (nClassesPCMMl == 2) {
-          registry.fill(HIST("V0/hBDTBackgroundScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-          registry.fill(HIST("V0/hBDTSignalScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
-        } else if (nClassesPCMMl == 3) {
-          registry.fill(HIST("V0/hBDTPrimaryPhotonScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-          registry.fill(HIST("V0/hBDTSecondaryPhotonScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
-          registry.fill(HIST("V0/hBDTBackgroundScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[2]);
-        } else {
-          registry.fill(HIST("V0/hBDTScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
-        }
+      if (nClassesPCMMl == 2) {
+        registry.fill(HIST("V0/hBDTBackgroundScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
+        registry.fill(HIST("V0/hBDTSignalScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
+      } else if (nClassesPCMMl == 3) {
+        registry.fill(HIST("V0/hBDTPrimaryPhotonScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
+        registry.fill(HIST("V0/hBDTSecondaryPhotonScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[1]);
+        registry.fill(HIST("V0/hBDTBackgroundScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[2]);
+      } else {
+        registry.fill(HIST("V0/hBDTScoreAfterCutVsPt"), v0photoncandidate.getPt(), outputML[0]);
       }
     }
 
-    if (filltable) {
-      registry.fill(HIST("V0/hAP"), v0photoncandidate.getAlpha(), v0photoncandidate.getQt());
-      registry.fill(HIST("V0/hConversionPointXY"), gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY());
-      registry.fill(HIST("V0/hConversionPointRZ"), gammaKF_DecayVtx.GetZ(), rxy);
-      registry.fill(HIST("V0/hPt"), v0photoncandidate.getPt());
-      registry.fill(HIST("V0/hEtaPhi"), v0phi, v0eta);
-      registry.fill(HIST("V0/hCosPA"), v0photoncandidate.getCosPA());
-      registry.fill(HIST("V0/hCosPA_Rxy"), rxy, v0photoncandidate.getCosPA());
-      registry.fill(HIST("V0/hPCA"), v0photoncandidate.getPCA());
-      registry.fill(HIST("V0/hPCA_CosPA"), v0photoncandidate.getCosPA(), v0photoncandidate.getPCA());
-      registry.fill(HIST("V0/hPCA_Rxy"), rxy, v0photoncandidate.getPCA());
-      registry.fill(HIST("V0/hDCAxyz"), v0photoncandidate.getDcaXYToPV(), v0photoncandidate.getDcaZToPV());
-      registry.fill(HIST("V0/hPCA_diffX"), v0photoncandidate.getPCA(), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
-      registry.fill(HIST("V0/hPhiVPsiPair"), v0photoncandidate.getPsiPair(), v0photoncandidate.getPhiV());
-
-      // LOGF(info, "cospa_kf = %f, cospaXY_kf = %f, cospaRZ_kf = %f", cospa_kf, cospaXY_kf, cospaRZ_kf);
-      registry.fill(HIST("V0/hCosPAXY_Rxy"), rxy, cospaXYKF);
-      registry.fill(HIST("V0/hCosPARZ_Rxy"), rxy, cospaRZKF);
-
-      for (const auto& leg : {kfp_pos_DecayVtx, kfp_ele_DecayVtx}) {
-        float legpt = RecoDecay::sqrtSumOfSquares(leg.GetPx(), leg.GetPy());
-        float legeta = RecoDecay::eta(std::array{leg.GetPx(), leg.GetPy(), leg.GetPz()});
-        float legphi = RecoDecay::constrainAngle(RecoDecay::phi(leg.GetPx(), leg.GetPy()));
-        registry.fill(HIST("V0Leg/hPt"), legpt);
-        registry.fill(HIST("V0Leg/hEtaPhi"), legphi, legeta);
-      } // end of leg loop
-      for (const auto& leg : {pos, ele}) {
-        registry.fill(HIST("V0Leg/hdEdx_Pin"), leg.tpcInnerParam(), leg.tpcSignal());
-        registry.fill(HIST("V0Leg/hTPCNsigmaEl"), leg.tpcInnerParam(), leg.tpcNSigmaEl());
-      } // end of leg loop
-      for (const auto& leg : {pTrack, nTrack}) {
-        registry.fill(HIST("V0Leg/hXZ"), leg.getZ(), leg.getX());
-        registry.fill(HIST("V0Leg/hRelDeltaPt"), leg.getPt(), leg.getPt() * std::sqrt(leg.getSigma1Pt2()));
-      } // end of leg loop
-      registry.fill(HIST("V0Leg/hDCAxyz"), posdcaXY, posdcaZ);
-      registry.fill(HIST("V0Leg/hDCAxyz"), eledcaXY, eledcaZ);
-
-      ROOT::Math::PxPyPzMVector vpos_sv(kfp_pos_DecayVtx.GetPx(), kfp_pos_DecayVtx.GetPy(), kfp_pos_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
-      ROOT::Math::PxPyPzMVector vele_sv(kfp_ele_DecayVtx.GetPx(), kfp_ele_DecayVtx.GetPy(), kfp_ele_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
-      ROOT::Math::PxPyPzMVector v0_sv = vpos_sv + vele_sv;
-      registry.fill(HIST("V0/hMeeSV_Rxy"), rxy, v0_sv.M());
-
-      v0photonskf(collision.globalIndex(), v0.globalIndex(), v0legs.lastIndex() + 1, v0legs.lastIndex() + 2,
-                  gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY(), gammaKF_DecayVtx.GetZ(),
-                  gammaKF_PV.GetPx(), gammaKF_PV.GetPy(), gammaKF_PV.GetPz(),
-                  v0_sv.M(), v0photoncandidate.getDcaXYToPV(), v0photoncandidate.getDcaZToPV(),
-                  cospa_kf, cospaXYKF, cospaRZKF,
-                  v0photoncandidate.getPCA(), v0photoncandidate.getAlpha(), v0photoncandidate.getQt(), v0photoncandidate.getChi2NDF());
-      v0photonsphivpsi(v0photoncandidate.getPhiV(), v0photoncandidate.getPsiPair());
-
-      // v0photonskfcov(gammaKF_PV.GetCovariance(9), gammaKF_PV.GetCovariance(14), gammaKF_PV.GetCovariance(20), gammaKF_PV.GetCovariance(13), gammaKF_PV.GetCovariance(19), gammaKF_PV.GetCovariance(18));
-
-      fillTrackTable<isMC>(pos, kfp_pos_DecayVtx, posdcaXY, posdcaZ); // positive leg first
-      fillTrackTable<isMC>(ele, kfp_ele_DecayVtx, eledcaXY, eledcaZ); // negative leg second
-    } // end of fill table
+    registry.fill(HIST("V0/hAP"), v0photoncandidate.getAlpha(), v0photoncandidate.getQt());
+    registry.fill(HIST("V0/hConversionPointXY"), gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY());
+    registry.fill(HIST("V0/hConversionPointRZ"), gammaKF_DecayVtx.GetZ(), rxy);
+    registry.fill(HIST("V0/hPt"), v0photoncandidate.getPt());
+    registry.fill(HIST("V0/hEtaPhi"), v0phi, v0eta);
+    registry.fill(HIST("V0/hCosPA"), v0photoncandidate.getCosPA());
+    registry.fill(HIST("V0/hCosPA_Rxy"), rxy, v0photoncandidate.getCosPA());
+    registry.fill(HIST("V0/hPCA"), v0photoncandidate.getPCA());
+    registry.fill(HIST("V0/hPCA_CosPA"), v0photoncandidate.getCosPA(), v0photoncandidate.getPCA());
+    registry.fill(HIST("V0/hPCA_Rxy"), rxy, v0photoncandidate.getPCA());
+    registry.fill(HIST("V0/hDCAxyz"), v0photoncandidate.getDcaXYToPV(), v0photoncandidate.getDcaZToPV());
+    registry.fill(HIST("V0/hPCA_diffX"), v0photoncandidate.getPCA(), std::min(pTrack.getX(), nTrack.getX()) - rxy); // trackiu.x() - rxy should be positive
+    registry.fill(HIST("V0/hPhiVPsiPair"), v0photoncandidate.getPsiPair(), v0photoncandidate.getPhiV());
+
+    // LOGF(info, "cospa_kf = %f, cospaXY_kf = %f, cospaRZ_kf = %f", cospa_kf, cospaXY_kf, cospaRZ_kf);
+    registry.fill(HIST("V0/hCosPAXY_Rxy"), rxy, cospaXYKF);
+    registry.fill(HIST("V0/hCosPARZ_Rxy"), rxy, cospaRZKF);
+
+    for (const auto& leg : {kfp_pos_DecayVtx, kfp_ele_DecayVtx}) {
+      float legpt = RecoDecay::sqrtSumOfSquares(leg.GetPx(), leg.GetPy());
+      float legeta = RecoDecay::eta(std::array{leg.GetPx(), leg.GetPy(), leg.GetPz()});
+      float legphi = RecoDecay::constrainAngle(RecoDecay::phi(leg.GetPx(), leg.GetPy()));
+      registry.fill(HIST("V0Leg/hPt"), legpt);
+      registry.fill(HIST("V0Leg/hEtaPhi"), legphi, legeta);
+    } // end of leg loop
+    for (const auto& leg : {pos, ele}) {
+      registry.fill(HIST("V0Leg/hdEdx_Pin"), leg.tpcInnerParam(), leg.tpcSignal());
+      registry.fill(HIST("V0Leg/hTPCNsigmaEl"), leg.tpcInnerParam(), leg.tpcNSigmaEl());
+    } // end of leg loop
+    for (const auto& leg : {pTrack, nTrack}) {
+      registry.fill(HIST("V0Leg/hXZ"), leg.getZ(), leg.getX());
+      registry.fill(HIST("V0Leg/hRelDeltaPt"), leg.getPt(), leg.getPt() * std::sqrt(leg.getSigma1Pt2()));
+    } // end of leg loop
+    registry.fill(HIST("V0Leg/hDCAxyz"), posdcaXY, posdcaZ);
+    registry.fill(HIST("V0Leg/hDCAxyz"), eledcaXY, eledcaZ);
+
+    ROOT::Math::PxPyPzMVector vpos_sv(kfp_pos_DecayVtx.GetPx(), kfp_pos_DecayVtx.GetPy(), kfp_pos_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
+    ROOT::Math::PxPyPzMVector vele_sv(kfp_ele_DecayVtx.GetPx(), kfp_ele_DecayVtx.GetPy(), kfp_ele_DecayVtx.GetPz(), o2::constants::physics::MassElectron);
+    ROOT::Math::PxPyPzMVector v0_sv = vpos_sv + vele_sv;
+    registry.fill(HIST("V0/hMeeSV_Rxy"), rxy, v0_sv.M());
+
+    v0photonskf(collision.globalIndex(), v0.globalIndex(), v0legs.lastIndex() + 1, v0legs.lastIndex() + 2,
+                gammaKF_DecayVtx.GetX(), gammaKF_DecayVtx.GetY(), gammaKF_DecayVtx.GetZ(),
+                gammaKF_PV.GetPx(), gammaKF_PV.GetPy(), gammaKF_PV.GetPz(),
+                v0_sv.M(), v0photoncandidate.getDcaXYToPV(), v0photoncandidate.getDcaZToPV(),
+                cospa_kf, cospaXYKF, cospaRZKF,
+                v0photoncandidate.getPCA(), v0photoncandidate.getAlpha(), v0photoncandidate.getQt(), v0photoncandidate.getChi2NDF());
+    v0photonsphivpsi(v0photoncandidate.getPhiV(), v0photoncandidate.getPsiPair());
+
+    // v0photonskfcov(gammaKF_PV.GetCovariance(9), gammaKF_PV.GetCovariance(14), gammaKF_PV.GetCovariance(20), gammaKF_PV.GetCovariance(13), gammaKF_PV.GetCovariance(19), gammaKF_PV.GetCovariance(18));
+
+    fillTrackTable<isMC>(pos, kfp_pos_DecayVtx, posdcaXY, posdcaZ); // positive leg first
+    fillTrackTable<isMC>(ele, kfp_ele_DecayVtx, eledcaXY, eledcaZ); // negative leg second
   }
 
   Preslice<aod::V0s> perCollision = o2::aod::v0::collisionId;
   std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> pca_map;      // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> pca
   std::map<std::tuple<int64_t, int64_t, int64_t, int64_t>, float> cospa_map;    // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex()) -> cospa
-  std::vector<std::pair<int64_t, int64_t>> stored_v0Ids;                        // (pos.globalIndex(), ele.globalIndex())
+  std::set<std::pair<int64_t, int64_t>> stored_v0Ids;                           // (pos.globalIndex(), ele.globalIndex())
   std::vector<std::tuple<int64_t, int64_t, int64_t, int64_t>> stored_fullv0Ids; // (v0.globalIndex(), collision.globalIndex(), pos.globalIndex(), ele.globalIndex())
   std::unordered_map<int64_t, int> nv0_map;                                     // map collisionId -> nv0
+  std::unordered_map<int64_t, CachedV0> v0_cache;                               // map v0.globalIndex() -> fit of the candidate
+  std::vector<int64_t> filled_v0Ids;                                            // v0.globalIndex() of the candidates to be written, in the order of the ML batch
 
   template <bool isMC, bool isTriggerAnalysis, bool enableFilter, typename TCollisions, typename TV0s, typename TTracks, typename TBCs>
   void build(TCollisions const& collisions, TV0s const& v0s, TTracks const&, TBCs const&)
@@ -906,13 +945,33 @@ struct PhotonConversionBuilder {
       // LOGF(info, "n v0 = %d", v0s_per_coll.size());
       for (const auto& v0 : v0s_per_coll) {
         // LOGF(info, "collision.globalIndex() = %d, v0.globalIndex() = %d, v0.posTrackId() = %d, v0.negTrackId() = %d", collision.globalIndex(), v0.globalIndex(), v0.posTrackId() , v0.negTrackId());
-        fillV0Table<isMC, TBCs, TCollisions, TTracks>(v0, false);
+        buildV0Candidate<isMC, TBCs, TCollisions, TTracks>(v0);
       } // end of v0 loop
     } // end of collision loop
 
-    stored_v0Ids.reserve(pca_map.size());     // number of photon candidates per DF
     stored_fullv0Ids.reserve(pca_map.size()); // number of photon candidates per DF
 
+    // minimal pca of the candidates sharing a leg, and candidates sharing both legs
+    std::unordered_map<int64_t, float> min_pca_pos;                                              // pos.globalIndex() -> minimal pca
+    std::unordered_map<int64_t, float> min_pca_ele;                                              // ele.globalIndex() -> minimal pca
+    std::map<std::pair<int64_t, int64_t>, std::vector<std::pair<int64_t, float>>> same_legs_map; // (pos.globalIndex(), ele.globalIndex()) -> (collision.globalIndex(), cospa)
+    for (const auto& [key, value] : pca_map) {
+      auto collisionId = std::get<1>(key);
+      auto posId = std::get<2>(key);
+      auto eleId = std::get<3>(key);
+      if (!std::isnan(value)) {
+        auto [it_pos, is_new_pos] = min_pca_pos.try_emplace(posId, value);
+        if (!is_new_pos && value < it_pos->second) {
+          it_pos->second = value;
+        }
+        auto [it_ele, is_new_ele] = min_pca_ele.try_emplace(eleId, value);
+        if (!is_new_ele && value < it_ele->second) {
+          it_ele->second = value;
+        }
+      }
+      same_legs_map[std::make_pair(posId, eleId)].emplace_back(collisionId, cospa_map[key]);
+    }
+
     // find minimal pca
     for (const auto& [key, value] : pca_map) {
       auto v0Id = std::get<0>(key);
@@ -921,35 +980,22 @@ struct PhotonConversionBuilder {
       auto eleId = std::get<3>(key);
       float v0pca = value;
       float cospa = cospa_map[key];
-      bool is_closest_v0 = true;
-      bool is_most_aligned_v0 = true;
 
-      for (const auto& [key_tmp, value_tmp] : pca_map) {
-        auto v0Id_tmp = std::get<0>(key_tmp);
-        auto collisionId_tmp = std::get<1>(key_tmp);
-        auto posId_tmp = std::get<2>(key_tmp);
-        auto eleId_tmp = std::get<3>(key_tmp);
-        float v0pca_tmp = value_tmp;
-        float cospa_tmp = cospa_map[key_tmp];
-
-        if (v0Id == v0Id_tmp) { // skip exactly the same v0
-          continue;
-        }
-
-        if (collisionId != collisionId_tmp && eleId == eleId_tmp && posId == posId_tmp && cospa < cospa_tmp) { // same ele and pos, but attached to different collision
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , cospa1 = %f , cospa2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, cospa, cospa_tmp);
+      // same ele and pos, but attached to different collision
+      bool is_most_aligned_v0 = true;
+      for (const auto& [collisionId_tmp, cospa_tmp] : same_legs_map[std::make_pair(posId, eleId)]) {
+        if (collisionId != collisionId_tmp && cospa < cospa_tmp) {
           is_most_aligned_v0 = false;
           break;
         }
+      }
 
-        if ((eleId == eleId_tmp || posId == posId_tmp) && v0pca > v0pca_tmp) {
-          // LOGF(info, "!reject! | collision id = %d | posid1 = %d , eleid1 = %d , posid2 = %d , eleid2 = %d , pca1 = %f , pca2 = %f", collisionId, posId, eleId, posId_tmp, eleId_tmp, v0pca, v0pca_tmp);
-          is_closest_v0 = false;
-          break;
-        }
-      } // end of pca_map tmp loop
+      // same ele or pos with smaller pca
+      auto it_pos = min_pca_pos.find(posId);
+      auto it_ele = min_pca_ele.find(eleId);
+      bool is_closest_v0 = !((it_pos != min_pca_pos.end() && v0pca > it_pos->second) || (it_ele != min_pca_ele.end() && v0pca > it_ele->second));
 
-      bool is_stored = std::find(stored_v0Ids.begin(), stored_v0Ids.end(), std::make_pair(posId, eleId)) != stored_v0Ids.end();
+      bool is_stored = stored_v0Ids.find(std::make_pair(posId, eleId)) != stored_v0Ids.end();
       if (is_closest_v0 && is_most_aligned_v0 && !is_stored) {
         // auto v0 = v0s.rawIteratorAt(v0Id);
         // auto collision = collisions.rawIteratorAt(collisionId);
@@ -958,13 +1004,17 @@ struct PhotonConversionBuilder {
         // LOGF(info, "!accept! | collision id = %d | v0id1 = %d , posid1 = %d , eleid1 = %d , pca1 = %f , cospa = %f", collisionId, v0Id, posId, eleId, v0pca, cospa);
 
         // fillV0Table<isMC, TCollisions, TTracks>(v0, true);
-        stored_v0Ids.emplace_back(std::make_pair(posId, eleId));
+        stored_v0Ids.emplace(posId, eleId);
         stored_fullv0Ids.emplace_back(std::make_tuple(v0Id, collisionId, posId, eleId));
         nv0_map[collisionId]++;
       }
     } // end of pca_map loop
     // LOGF(info, "pca_map.size() = %d", pca_map.size());
 
+    // the ML scores of all the candidates to be written are evaluated together, with one call per model
+    if (applyPCMMl) {
+      emMlResponse.clearBatch();
+    }
     for (const auto& fullv0Id : stored_fullv0Ids) {
       auto v0Id = std::get<0>(fullv0Id);
       // auto collisionId = std::get<1>(fullv0Id);
@@ -980,9 +1030,26 @@ struct PhotonConversionBuilder {
         }
         // LOGF(info, "collision_tmp.globalIndex() = %d, collision_tmp.neeuls() = %d, nv0_map = %d", collision_tmp.globalIndex(), collision_tmp.neeuls(), nv0_map[collision_tmp.globalIndex()]);
       }
+      filled_v0Ids.emplace_back(v0Id);
 
-      fillV0Table<isMC, TBCs, TCollisions, TTracks>(v0, true);
+      if (applyPCMMl) {
+        const auto& candidate = v0_cache.at(v0Id).candidate;
+        std::vector<float> mlInputFeatures = emMlResponse.getInputFeatures(candidate, v0.template posTrack_as<TTracks>(), v0.template negTrack_as<TTracks>());
+        if (use2DBinning) {
+          emMlResponse.addToBatch(mlInputFeatures, candidate.getPt(), candidate.getCent());
+        } else {
+          emMlResponse.addToBatch(mlInputFeatures, candidate.getPt());
+        }
+      }
     } // end of fullv0Id loop
+    if (applyPCMMl) {
+      emMlResponse.evalBatch();
+    }
+
+    for (std::size_t iCandML = 0; iCandML < filled_v0Ids.size(); iCandML++) {
+      auto v0Id = filled_v0Ids[iCandML];
+      fillV0Table<isMC, TCollisions, TTracks>(v0s.rawIteratorAt(v0Id), v0_cache.at(v0Id), iCandML);
+    } // end of filled v0 loop
 
     for (const auto& collision : collisions) {
       if constexpr (isMC) {
@@ -996,8 +1063,9 @@ struct PhotonConversionBuilder {
     pca_map.clear();
     cospa_map.clear();
     nv0_map.clear();
+    v0_cache.clear();
+    filled_v0Ids.clear();
     stored_v0Ids.clear();
-    stored_v0Ids.shrink_to_fit();
     stored_fullv0Ids.clear();
     stored_fullv0Ids.shrink_to_fit();
   } // end of build
@@ -58,16 +58,16 @@ struct skimmerPHOS {
       registry.fill(HIST("hPHOSClusterFilter"), 1);
 
       if (cluster.e() < minE) {
-        continue;
         registry.fill(HIST("hPHOSClusterFilter"), 2);
+        continue;
       }
       if (cluster.m02() < minM02) {
-        continue;
         registry.fill(HIST("hPHOSClusterFilter"), 3);
+        continue;
       }
       if (cluster.ncell() < minNcell) {
-        continue;
         registry.fill(HIST("hPHOSClusterFilter"), 4);
+        continue;
       }
 
       registry.fill(HIST("hPHOSClusterFilter"), 5);
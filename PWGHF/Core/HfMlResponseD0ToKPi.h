@@ -24,6 +24,7 @@
 
 #include <CommonConstants/PhysicsConstants.h>
 
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -116,6 +117,25 @@
     break;                                                                 \
   }
 
+// Check if the index of mCachedIndices (index associated to a FEATURE)
+// matches the entry in EnumInputFeatures associated to this FEATURE
+// if so, the column of the FEATURE is filled for all the candidates
+// with the value of EXPRESSION, evaluated for each candidate and its pdgCode
+#define CHECK_AND_FILL_COL_D0(FEATURE, EXPRESSION)            \
+  case static_cast<uint8_t>(InputFeaturesD0ToKPi::FEATURE): { \
+    for (std::size_t iCand = 0; iCand < nCand; ++iCand) {     \
+      candidate.setCursor(rows[iCand]);                       \
+      [[maybe_unused]] const int pdgCode = pdgCodes[iCand];   \
+      column[iCand] = EXPRESSION;                             \
+    }                                                         \
+    break;                                                    \
+  }
+
+// Variation of CHECK_AND_FILL_COL_D0(FEATURE, EXPRESSION)
+// where the value is given by GETTER1 for a D0 and by GETTER2 for a D0bar
+#define CHECK_AND_FILL_COL_D0_SIGNED(FEATURE, GETTER1, GETTER2) \
+  CHECK_AND_FILL_COL_D0(FEATURE, pdgCode == o2::constants::physics::kD0 ? candidate.GETTER1() : candidate.GETTER2())
+
 namespace o2::analysis
 {
 enum class InputFeaturesD0ToKPi : uint8_t {
@@ -240,6 +260,81 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
     return inputFeatures;
   }
 
+  /// Method to get the input features of several candidates needed for batched ML inference, one feature at a time
+  /// \param candidates is the table of D0 candidates
+  /// \param rows are the positions of the candidates in the table
+  /// \param pdgCodes are the PDG codes of the mass hypotheses of the candidates (D0 or D0bar)
+  /// \param featureColumns is filled with the input features, one column of rows.size() values for each feature
+  template <bool usingMl = false, typename T1>
+  void getInputFeaturesColumnar(T1 const& candidates, std::vector<int64_t> const& rows, std::vector<int> const& pdgCodes, std::vector<float>& featureColumns)
+  {
+    const auto& cachedIndices = MlResponse<TypeOutputScore>::mCachedIndices;
+    const std::size_t nCand = rows.size();
+    featureColumns.assign(cachedIndices.size() * nCand, 0.f);
+    if (nCand == 0) {
+      return;
+    }
+
+    auto candidate = candidates.begin();
+    for (std::size_t iFeature = 0; iFeature < cachedIndices.size(); ++iFeature) {
+      float* column = featureColumns.data() + iFeature * nCand;
+      switch (cachedIndices[iFeature]) {
+        CHECK_AND_FILL_COL_D0(chi2PCA, candidate.chi2PCA());
+        CHECK_AND_FILL_COL_D0(decayLength, candidate.decayLength());
+        CHECK_AND_FILL_COL_D0(decayLengthXY, candidate.decayLengthXY());
+        CHECK_AND_FILL_COL_D0(decayLengthNormalised, candidate.decayLengthNormalised());
+        CHECK_AND_FILL_COL_D0(decayLengthXYNormalised, candidate.decayLengthXYNormalised());
+        CHECK_AND_FILL_COL_D0(ptProng0, candidate.ptProng0());
+        CHECK_AND_FILL_COL_D0(ptProng1, candidate.ptProng1());
+        CHECK_AND_FILL_COL_D0(impactParameterXY0, candidate.impactParameter0());
+        CHECK_AND_FILL_COL_D0(impactParameterXY1, candidate.impactParameter1());
+        CHECK_AND_FILL_COL_D0(impactParameterZ0, candidate.impactParameterZ0());
+        CHECK_AND_FILL_COL_D0(impactParameterZ1, candidate.impactParameterZ1());
+        // TPC PID variables
+        CHECK_AND_FILL_COL_D0(nSigTpcPi0, candidate.nSigTpcPi0());
+        CHECK_AND_FILL_COL_D0(nSigTpcKa0, candidate.nSigTpcKa0());
+        CHECK_AND_FILL_COL_D0(nSigTpcPi1, candidate.nSigTpcPi1());
+        CHECK_AND_FILL_COL_D0(nSigTpcKa1, candidate.nSigTpcKa1());
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcPiExpPi, nSigTpcPi0, nSigTpcPi1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcKaExpPi, nSigTpcKa0, nSigTpcKa1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcPiExpKa, nSigTpcPi1, nSigTpcPi0);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcKaExpKa, nSigTpcKa1, nSigTpcKa0);
+        // TOF PID variables
+        CHECK_AND_FILL_COL_D0(nSigTofPi0, candidate.nSigTofPi0());
+        CHECK_AND_FILL_COL_D0(nSigTofKa0, candidate.nSigTofKa0());
+        CHECK_AND_FILL_COL_D0(nSigTofPi1, candidate.nSigTofPi1());
+        CHECK_AND_FILL_COL_D0(nSigTofKa1, candidate.nSigTofKa1());
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTofPiExpPi, nSigTofPi0, nSigTofPi1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTofKaExpPi, nSigTofKa0, nSigTofKa1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTofPiExpKa, nSigTofPi1, nSigTofPi0);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTofKaExpKa, nSigTofKa1, nSigTofKa0);
+        // Combined PID variables
+        CHECK_AND_FILL_COL_D0(nSigTpcTofPi0, candidate.tpcTofNSigmaPi0());
+        CHECK_AND_FILL_COL_D0(nSigTpcTofKa0, candidate.tpcTofNSigmaKa0());
+        CHECK_AND_FILL_COL_D0(nSigTpcTofPi1, candidate.tpcTofNSigmaPi1());
+        CHECK_AND_FILL_COL_D0(nSigTpcTofKa1, candidate.tpcTofNSigmaKa1());
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcTofPiExpPi, tpcTofNSigmaPi0, tpcTofNSigmaPi1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcTofKaExpPi, tpcTofNSigmaKa0, tpcTofNSigmaKa1);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcTofPiExpKa, tpcTofNSigmaPi1, tpcTofNSigmaPi0);
+        CHECK_AND_FILL_COL_D0_SIGNED(nSigTpcTofKaExpKa, tpcTofNSigmaKa1, tpcTofNSigmaKa0);
+
+        CHECK_AND_FILL_COL_D0(maxNormalisedDeltaIP, candidate.maxNormalisedDeltaIP());
+        CHECK_AND_FILL_COL_D0(impactParameterProduct, candidate.impactParameterProduct());
+        CHECK_AND_FILL_COL_D0(cosThetaStar, pdgCode == o2::constants::physics::kD0 ? HfHelper::cosThetaStarD0(candidate) : HfHelper::cosThetaStarD0bar(candidate));
+        CHECK_AND_FILL_COL_D0(cpa, candidate.cpa());
+        CHECK_AND_FILL_COL_D0(cpaXY, candidate.cpaXY());
+        CHECK_AND_FILL_COL_D0(ct, HfHelper::ctD0(candidate));
+      }
+      if constexpr (usingMl) {
+        switch (cachedIndices[iFeature]) {
+          CHECK_AND_FILL_COL_D0(bdtOutputBkg, pdgCode == o2::constants::physics::kD0 ? candidate.mlProbD0()[0] : candidate.mlProbD0bar()[0]);
+          CHECK_AND_FILL_COL_D0(bdtOutputNonPrompt, pdgCode == o2::constants::physics::kD0 ? candidate.mlProbD0()[1] : candidate.mlProbD0bar()[1]);
+          CHECK_AND_FILL_COL_D0(bdtOutputPrompt, pdgCode == o2::constants::physics::kD0 ? candidate.mlProbD0()[2] : candidate.mlProbD0bar()[2]);
+        }
+      }
+    }
+  }
+
  protected:
   /// Method to fill the map of available input features
   void setAvailableInputFeatures()
@@ -306,5 +401,7 @@ class HfMlResponseD0ToKPi : public HfMlResponse<TypeOutputScore>
 #undef CHECK_AND_FILL_VEC_D0_HFHELPER_SIGNED
 #undef CHECK_AND_FILL_VEC_D0_OBJECT_HFHELPER_SIGNED
 #undef CHECK_AND_FILL_VEC_D0_ML
+#undef CHECK_AND_FILL_COL_D0
+#undef CHECK_AND_FILL_COL_D0_SIGNED
 
 #endif // PWGHF_CORE_HFMLRESPONSED0TOKPI_H_
@@ -21,6 +21,7 @@
 
 #include "Tools/ML/MlResponse.h"
 
+#include <cstddef>
 #include <cstdint>
 #include <map>
 #include <string>
@@ -85,6 +86,30 @@
     break;                                                                    \
   }
 
+// Check if the index of mCachedIndices (index associated to a FEATURE)
+// matches the entry in EnumInputFeatures associated to this FEATURE
+// if so, the column of the FEATURE is filled for all the candidates
+// with the value of EXPRESSION, evaluated for each candidate and its mass hypothesis
+#define CHECK_AND_FILL_COL_LCTOPKPI(FEATURE, EXPRESSION)               \
+  case static_cast<uint8_t>(InputFeaturesLcToPKPi::FEATURE): {         \
+    for (std::size_t iCand = 0; iCand < nCand; ++iCand) {              \
+      candidate.setCursor(rows[iCand]);                                \
+      [[maybe_unused]] const bool caseLcToPKPi = casesLcToPKPi[iCand]; \
+      column[iCand] = EXPRESSION;                                      \
+    }                                                                  \
+    break;                                                             \
+  }
+
+// Specific case of CHECK_AND_FILL_COL_LCTOPKPI(FEATURE, EXPRESSION)
+// where the value is given by the GETTER of the candidate
+#define CHECK_AND_FILL_COL_LCTOPKPI_GETTER(FEATURE, GETTER) \
+  CHECK_AND_FILL_COL_LCTOPKPI(FEATURE, candidate.GETTER())
+
+// Variation of CHECK_AND_FILL_COL_LCTOPKPI(FEATURE, EXPRESSION)
+// where the value is given by GETTER1 for a LcToPKPi and by GETTER2 for a LcToPiKP
+#define CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(FEATURE, GETTER1, GETTER2) \
+  CHECK_AND_FILL_COL_LCTOPKPI(FEATURE, caseLcToPKPi ? candidate.GETTER1() : candidate.GETTER2())
+
 namespace o2::analysis
 {
 enum class InputFeaturesLcToPKPi : uint8_t {
@@ -247,6 +272,96 @@ class HfMlResponseLcToPKPi : public HfMlResponse<TypeOutputScore>
     return inputFeatures;
   }
 
+  /// Method to get the input features of several candidates needed for batched ML inference, one feature at a time
+  /// \param candidates is the table of Lc candidates
+  /// \param rows are the positions of the candidates in the table
+  /// \param casesLcToPKPi are the mass hypotheses of the candidates (1 for LcToPKPi, 0 for LcToPiKP)
+  /// \param featureColumns is filled with the input features, one column of rows.size() values for each feature
+  template <typename T1>
+  void getInputFeaturesColumnar(T1 const& candidates, std::vector<int64_t> const& rows, std::vector<uint8_t> const& casesLcToPKPi, std::vector<float>& featureColumns)
+  {
+    const auto& cachedIndices = MlResponse<TypeOutputScore>::mCachedIndices;
+    const std::size_t nCand = rows.size();
+    featureColumns.assign(cachedIndices.size() * nCand, 0.f);
+    if (nCand == 0) {
+      return;
+    }
+
+    auto candidate = candidates.begin();
+    for (std::size_t iFeature = 0; iFeature < cachedIndices.size(); ++iFeature) {
+      float* column = featureColumns.data() + iFeature * nCand;
+      switch (cachedIndices[iFeature]) {
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(ptProng0, ptProng0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(ptProng1, ptProng1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(ptProng2, ptProng2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterXY0, impactParameter0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterXY1, impactParameter1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterXY2, impactParameter2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterZ0, impactParameterZ0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterZ1, impactParameterZ1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(impactParameterZ2, impactParameterZ2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(decayLength, decayLength);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(decayLengthXY, decayLengthXY);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(decayLengthXYNormalised, decayLengthXYNormalised);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(cpa, cpa);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(cpaXY, cpaXY);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(chi2PCA, chi2PCA);
+        // TPC PID variables
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPr0, nSigTpcPr0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaKa0, nSigTpcKa0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPi0, nSigTpcPi0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPr1, nSigTpcPr1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaKa1, nSigTpcKa1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPi1, nSigTpcPi1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPr2, nSigTpcPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaKa2, nSigTpcKa2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcNSigmaPi2, nSigTpcPi2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tpcNSigmaPrExpPr0, nSigTpcPr0, nSigTpcPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tpcNSigmaPiExpPi2, nSigTpcPi2, nSigTpcPi0);
+        // TOF PID variables
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPr0, nSigTofPr0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaKa0, nSigTofKa0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPi0, nSigTofPi0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPr1, nSigTofPr1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaKa1, nSigTofKa1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPi1, nSigTofPi1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPr2, nSigTofPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaKa2, nSigTofKa2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tofNSigmaPi2, nSigTofPi2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tofNSigmaPrExpPr0, nSigTofPr0, nSigTofPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tofNSigmaPiExpPi2, nSigTofPi2, nSigTofPi0);
+        // Combined PID variables
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPi0, tpcTofNSigmaPi0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPi1, tpcTofNSigmaPi1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPi2, tpcTofNSigmaPi2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaKa0, tpcTofNSigmaKa0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaKa1, tpcTofNSigmaKa1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaKa2, tpcTofNSigmaKa2);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPr0, tpcTofNSigmaPr0);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPr1, tpcTofNSigmaPr1);
+        CHECK_AND_FILL_COL_LCTOPKPI_GETTER(tpcTofNSigmaPr2, tpcTofNSigmaPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tpcTofNSigmaPrExpPr0, tpcTofNSigmaPr0, tpcTofNSigmaPr2);
+        CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(tpcTofNSigmaPiExpPi2, tpcTofNSigmaPi2, tpcTofNSigmaPi0);
+      }
+      if constexpr (reconstructionType == aod::hf_cand::VertexerType::KfParticle) {
+        switch (cachedIndices[iFeature]) {
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfChi2PrimProton, kfChi2PrimProng0, kfChi2PrimProng2);
+          CHECK_AND_FILL_COL_LCTOPKPI_GETTER(kfChi2PrimKaon, kfChi2PrimProng1);
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfChi2PrimPion, kfChi2PrimProng2, kfChi2PrimProng0);
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfChi2GeoKaonPion, kfChi2GeoProng1Prong2, kfChi2GeoProng0Prong1);
+          CHECK_AND_FILL_COL_LCTOPKPI_GETTER(kfChi2GeoProtonPion, kfChi2GeoProng0Prong2);
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfChi2GeoProtonKaon, kfChi2GeoProng0Prong1, kfChi2GeoProng1Prong2);
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfDcaKaonPion, kfDcaProng1Prong2, kfDcaProng0Prong1);
+          CHECK_AND_FILL_COL_LCTOPKPI_GETTER(kfDcaProtonPion, kfDcaProng0Prong2);
+          CHECK_AND_FILL_COL_LCTOPKPI_SIGNED(kfDcaProtonKaon, kfDcaProng0Prong1, kfDcaProng1Prong2);
+          CHECK_AND_FILL_COL_LCTOPKPI_GETTER(kfChi2Geo, kfChi2Geo);
+          CHECK_AND_FILL_COL_LCTOPKPI_GETTER(kfChi2Topo, kfChi2Topo);
+          CHECK_AND_FILL_COL_LCTOPKPI(kfDecayLengthNormalised, candidate.kfDecayLength() / candidate.kfDecayLengthError());
+        }
+      }
+    }
+  }
+
  protected:
   /// Method to fill the map of available input features
   void setAvailableInputFeatures()
@@ -330,5 +445,8 @@ class HfMlResponseLcToPKPi : public HfMlResponse<TypeOutputScore>
 #undef CHECK_AND_FILL_VEC_LCTOPKPI
 #undef CHECK_AND_FILL_VEC_LCTOPKPI_HFHELPER
 #undef CHECK_AND_FILL_VEC_LCTOPKPI_OBJECT_SIGNED
+#undef CHECK_AND_FILL_COL_LCTOPKPI
+#undef CHECK_AND_FILL_COL_LCTOPKPI_GETTER
+#undef CHECK_AND_FILL_COL_LCTOPKPI_SIGNED
 
 #endif // PWGHF_CORE_HFMLRESPONSELCTOPKPI_H_
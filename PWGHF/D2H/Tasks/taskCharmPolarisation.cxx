@@ -2327,6 +2327,13 @@ struct HfTaskCharmPolarisation {
       float phiBeam = -10.f;
       // random
       float cosThetaStarRandom = -10.f;
+      // projections of the daughter momentum on the axes of the frames, shared by the frames
+      double const normDauCM = std::sqrt(threeVecDauCM.Mag2());
+      double const normHelicity = std::sqrt(helicityVec.Mag2());
+      double const normNormal = std::sqrt(normalVec.Mag2());
+      double const projHelicity = helicityVec.Dot(threeVecDauCM);
+      double const projNormal = normalVec.Dot(threeVecDauCM);
+      double const projBeam = beamVec.Dot(threeVecDauCM);
 
       int8_t nMuons{0u};
       if constexpr (DoMc) {
@@ -2347,7 +2354,7 @@ struct HfTaskCharmPolarisation {
           float const phiStarBeam = std::atan2(threeVecDauCM.Y(), threeVecDauCM.X());
           float const psiAngle = epHelper.GetEventPlane(xQvec, yQvec, 2);
           float const deltaPhiStarEP = RecoDecay::constrainAngle(phiStarBeam - psiAngle, 0., 2);
-          float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(qVecNorm.Mag2());
+          float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / normDauCM / std::sqrt(qVecNorm.Mag2());
           fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::EP>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarEP, deltaPhiStarEP, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar, centrality);
         }
         if (DoMc) {
@@ -2355,33 +2362,33 @@ struct HfTaskCharmPolarisation {
           double const deltaPhi = sampleDeltaPhi(ptCharmHad);
           double psi = candidate.phi() - deltaPhi;
           ROOT::Math::XYZVector qVecNorm = ROOT::Math::XYZVector(-std::sin(psi), std::cos(psi), 0.f);
-          float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+          float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / normDauCM;
           fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::EP>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarEP, -99.f, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar, centrality);
         }
       }
 
       if (activateTHnSparseCosThStarHelicity) {
         // helicity
-        cosThetaStarHelicity = helicityVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(helicityVec.Mag2());
-        phiHelicity = std::atan2(beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()), normalVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(normalVec.Mag2())));
+        cosThetaStarHelicity = projHelicity / normDauCM / normHelicity;
+        phiHelicity = std::atan2(projBeam / normDauCM, projNormal / (normDauCM * normNormal));
         fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::Helicity>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarHelicity, phiHelicity, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarProduction) {
         // production
-        cosThetaStarProduction = normalVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(normalVec.Mag2());
-        phiProduction = std::atan2(normalVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(normalVec.Mag2())), helicityVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(helicityVec.Mag2())));
+        cosThetaStarProduction = projNormal / normDauCM / normNormal;
+        phiProduction = std::atan2(projNormal / (normDauCM * normNormal), projHelicity / (normDauCM * normHelicity));
         fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::Production>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarProduction, phiProduction, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarBeam) {
         // beam
-        cosThetaStarBeam = beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
-        phiBeam = std::atan2(helicityVec.Dot(threeVecDauCM) / (std::sqrt(threeVecDauCM.Mag2()) * std::sqrt(helicityVec.Mag2())), beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()));
+        cosThetaStarBeam = projBeam / normDauCM;
+        phiBeam = std::atan2(projHelicity / (normDauCM * normHelicity), projBeam / normDauCM);
         fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::Beam>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarBeam, phiBeam, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar);
       }
       if (activateTHnSparseCosThStarRandom) {
         // random
         ROOT::Math::XYZVector const randomVec = ROOT::Math::XYZVector(std::sin(thetaRandom) * std::cos(phiRandom), std::sin(thetaRandom) * std::sin(phiRandom), std::cos(thetaRandom));
-        cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+        cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / normDauCM;
         if (doprocessDstarMcInPbPb || doprocessDstarMcWithMlInPbPb) {
           fillRecoHistos<Channel, WithMl, DoMc, charm_polarisation::CosThetaStarType::Random>(invMassCharmHadForSparse, ptCharmHad, numPvContributors, rapidity, invMassD0, invMassKPiLc, cosThetaStarRandom, -99.f, outputMl, isRotatedCandidate, origin, ptBhadMother, resoChannelLc, absEtaTrackMin, numItsClsMin, numTpcClsMin, charge, nMuons, partRecoDstar, centrality);
         } else {
@@ -2691,25 +2698,26 @@ struct HfTaskCharmPolarisation {
     ROOT::Math::Boost const boost{fourVecMother.BoostToCM()};
     ROOT::Math::PxPyPzMVector const fourVecDauCM = boost(fourVecDau);
     ROOT::Math::XYZVector const threeVecDauCM = fourVecDauCM.Vect();
+    double const normDauCM = std::sqrt(threeVecDauCM.Mag2());
 
     if (activateTHnSparseCosThStarHelicity) {
       ROOT::Math::XYZVector const helicityVec = fourVecMother.Vect();
-      float const cosThetaStarHelicity = helicityVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(helicityVec.Mag2());
+      float const cosThetaStarHelicity = helicityVec.Dot(threeVecDauCM) / normDauCM / std::sqrt(helicityVec.Mag2());
       fillGenHistos<charm_polarisation::CosThetaStarType::Helicity, Channel>(ptCharmHad, numPvContributors, rapidity, cosThetaStarHelicity, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarProduction) {
       ROOT::Math::XYZVector const normalVec = ROOT::Math::XYZVector(pyCharmHad, -pxCharmHad, 0.f);
-      float const cosThetaStarProduction = normalVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2()) / std::sqrt(normalVec.Mag2());
+      float const cosThetaStarProduction = normalVec.Dot(threeVecDauCM) / normDauCM / std::sqrt(normalVec.Mag2());
       fillGenHistos<charm_polarisation::CosThetaStarType::Production, Channel>(ptCharmHad, numPvContributors, rapidity, cosThetaStarProduction, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarBeam) {
       ROOT::Math::XYZVector const beamVec = ROOT::Math::XYZVector(0.f, 0.f, 1.f);
-      float const cosThetaStarBeam = beamVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+      float const cosThetaStarBeam = beamVec.Dot(threeVecDauCM) / normDauCM;
       fillGenHistos<charm_polarisation::CosThetaStarType::Beam, Channel>(ptCharmHad, numPvContributors, rapidity, cosThetaStarBeam, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar);
     }
     if (activateTHnSparseCosThStarRandom) {
       ROOT::Math::XYZVector const randomVec = ROOT::Math::XYZVector(std::sin(thetaRandom) * std::cos(phiRandom), std::sin(thetaRandom) * std::sin(phiRandom), std::cos(thetaRandom));
-      float const cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+      float const cosThetaStarRandom = randomVec.Dot(threeVecDauCM) / normDauCM;
       if constexpr (WithCent) {
         fillGenHistos<charm_polarisation::CosThetaStarType::Random, Channel>(ptCharmHad, numPvContributors, rapidity, cosThetaStarRandom, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar, *centrality);
       } else {
@@ -2720,7 +2728,7 @@ struct HfTaskCharmPolarisation {
       double const deltaPhi = sampleDeltaPhi(ptCharmHad);
       double psi = mcParticle.phi() - deltaPhi;
       ROOT::Math::XYZVector qVecNorm = ROOT::Math::XYZVector(-std::sin(psi), std::cos(psi), 0.f);
-      float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / std::sqrt(threeVecDauCM.Mag2());
+      float const cosThetaStarEP = qVecNorm.Dot(threeVecDauCM) / normDauCM;
       if constexpr (WithCent) {
         fillGenHistos<charm_polarisation::CosThetaStarType::EP, Channel>(ptCharmHad, numPvContributors, rapidity, cosThetaStarEP, origin, ptBhadMother, areDauInAcc, resoChannelLc, charge, partRecoDstar, *centrality);
       } else {
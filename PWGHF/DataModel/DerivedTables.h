@@ -29,6 +29,9 @@
 
 #include <sys/types.h>
 
+#include <algorithm>
+#include <bit>
+#include <cmath>
 #include <cstdint>
 #include <vector>
 
@@ -138,6 +141,83 @@ DECLARE_SOA_DYNAMIC_COLUMN(P, p, //! momentum
                            [](float pt, float eta) -> float { return RecoDecayPtEtaPhi::p(pt, eta); });
 } // namespace hf_cand_base
 
+// Reduced-precision candidate kinematics
+// pT is stored as a half-precision (IEEE 754 binary16) float, η and y in steps of 1e-3, φ in steps of 2π/2^16.
+namespace hf_cand_base_packed
+{
+constexpr float StepEta{1.e-3f};                               // storage step of η and y
+constexpr float StepPhi{o2::constants::math::TwoPI / 65536.f}; // storage step of φ
+constexpr float StepMlScore{1.f / 65535.f};                    // storage step of the ML scores
+
+/// Encoding of a float as a half-precision float, rounded to the nearest value
+inline uint16_t packFloat16(const float value)
+{
+  const uint32_t bits = std::bit_cast<uint32_t>(value);
+  const uint32_t sign = (bits >> 16) & 0x8000u;
+  const uint32_t absBits = bits & 0x7fffffffu;
+  if (absBits >= 0x7f800000u) { // infinity or NaN
+    return static_cast<uint16_t>(sign | 0x7c00u | (absBits > 0x7f800000u ? 0x200u : 0u));
+  }
+  if (absBits >= 0x477ff000u) { // overflow to infinity
+    return static_cast<uint16_t>(sign | 0x7c00u);
+  }
+  if (absBits < 0x38800000u) { // zero or subnormal half-precision value
+    if (absBits < 0x33000000u) {
+      return static_cast<uint16_t>(sign);
+    }
+    const uint32_t shift = 126u - (absBits >> 23);
+    const uint32_t mantissa = (absBits & 0x7fffffu) | 0x800000u;
+    return static_cast<uint16_t>(sign | ((mantissa + (1u << (shift - 1u))) >> shift));
+  }
+  const uint32_t rounded = absBits + 0xfffu + ((absBits >> 13) & 1u); // round half to even
+  return static_cast<uint16_t>(sign | ((rounded - 0x38000000u) >> 13));
+}
+
+/// Decoding of a half-precision float
+inline float unpackFloat16(const uint16_t value)
+{
+  const uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+  const uint32_t exponent = (value >> 10) & 0x1fu;
+  const uint32_t mantissa = value & 0x3ffu;
+  if (exponent == 0u) { // zero or subnormal
+    const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+    return sign ? -magnitude : magnitude;
+  }
+  if (exponent == 0x1fu) { // infinity or NaN
+    return std::bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+  }
+  return std::bit_cast<float>(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+inline int16_t packEta(const float eta) { return static_cast<int16_t>(std::lround(std::clamp(eta / StepEta, -32767.f, 32767.f))); }
+inline float unpackEta(const int16_t eta) { return eta * StepEta; }
+inline uint16_t packPhi(const float phi) { return static_cast<uint16_t>(std::lround(RecoDecay::constrainAngle(phi) / StepPhi) & 0xffff); }
+inline float unpackPhi(const uint16_t phi) { return phi * StepPhi; }
+inline uint16_t packMlScore(const float score) { return static_cast<uint16_t>(std::lround(std::clamp(score, 0.f, 1.f) / StepMlScore)); }
+inline float unpackMlScore(const uint16_t score) { return score * StepMlScore; }
+
+DECLARE_SOA_COLUMN(PtPacked, ptPacked, uint16_t);   //! transverse momentum, half-precision float
+DECLARE_SOA_COLUMN(EtaPacked, etaPacked, int16_t);  //! pseudorapidity, in steps of StepEta
+DECLARE_SOA_COLUMN(PhiPacked, phiPacked, uint16_t); //! azimuth, in steps of StepPhi
+DECLARE_SOA_COLUMN(YPacked, yPacked, int16_t);      //! rapidity, in steps of StepEta
+DECLARE_SOA_DYNAMIC_COLUMN(Pt, pt,                  //! transverse momentum
+                           [](uint16_t pt) -> float { return unpackFloat16(pt); });
+DECLARE_SOA_DYNAMIC_COLUMN(Eta, eta, //! pseudorapidity
+                           [](int16_t eta) -> float { return unpackEta(eta); });
+DECLARE_SOA_DYNAMIC_COLUMN(Phi, phi, //! azimuth
+                           [](uint16_t phi) -> float { return unpackPhi(phi); });
+DECLARE_SOA_DYNAMIC_COLUMN(Y, y, //! rapidity
+                           [](int16_t y) -> float { return unpackEta(y); });
+DECLARE_SOA_DYNAMIC_COLUMN(Px, px, //! px
+                           [](uint16_t pt, uint16_t phi) -> float { return RecoDecayPtEtaPhi::px(unpackFloat16(pt), unpackPhi(phi)); });
+DECLARE_SOA_DYNAMIC_COLUMN(Py, py, //! py
+                           [](uint16_t pt, uint16_t phi) -> float { return RecoDecayPtEtaPhi::py(unpackFloat16(pt), unpackPhi(phi)); });
+DECLARE_SOA_DYNAMIC_COLUMN(Pz, pz, //! pz
+                           [](uint16_t pt, int16_t eta) -> float { return RecoDecayPtEtaPhi::pz(unpackFloat16(pt), unpackEta(eta)); });
+DECLARE_SOA_DYNAMIC_COLUMN(P, p, //! momentum
+                           [](uint16_t pt, int16_t eta) -> float { return RecoDecayPtEtaPhi::p(unpackFloat16(pt), unpackEta(eta)); });
+} // namespace hf_cand_base_packed
+
 // Candidate selection flags
 namespace hf_cand_sel
 {
@@ -156,6 +236,7 @@ DECLARE_SOA_COLUMN(MlScoreBkg, mlScoreBkg, float);                  //! ML score
 DECLARE_SOA_COLUMN(MlScorePrompt, mlScorePrompt, float);            //! ML score for prompt class
 DECLARE_SOA_COLUMN(MlScoreNonPrompt, mlScoreNonPrompt, float);      //! ML score for non-prompt class
 DECLARE_SOA_COLUMN(MlScores, mlScores, std::vector<float>);         //! vector of ML scores
+DECLARE_SOA_COLUMN(MlScoresPacked, mlScoresPacked, std::vector<uint16_t>); //! vector of ML scores, in steps of hf_cand_base_packed::StepMlScore
 } // namespace hf_cand_mc
 
 namespace hf_mc_particle
@@ -191,6 +272,32 @@ DECLARE_SOA_COLUMN(FlagMcDecayChanGen, flagMcDecayChanGen, int8_t); //! resonant
                            hf_cand_base::P<hf_cand_base::Pt, hf_cand_base::Eta>,                                                                                      \
                            o2::soa::Marker<Marker##_hf_type_>);
 
+// Declares the base table with candidates with reduced-precision kinematics (PackedBases), alternative to Bases.
+#define DECLARE_TABLE_CAND_BASE_PACKED(_hf_type_, _hf_description_, _hf_namespace_)                                \
+  DECLARE_SOA_TABLE_STAGED(Hf##_hf_type_##PackedBases, "HF" _hf_description_ "BASEP",                              \
+                           o2::soa::Index<>,                                                                       \
+                           hf_cand_base::der_##_hf_namespace_::Hf##_hf_type_##CollBaseId,                          \
+                           hf_cand_base_packed::PtPacked,                                                          \
+                           hf_cand_base_packed::EtaPacked,                                                         \
+                           hf_cand_base_packed::PhiPacked,                                                         \
+                           hf_cand_base::M,                                                                        \
+                           hf_cand_base_packed::YPacked,                                                           \
+                           hf_cand_base_packed::Pt<hf_cand_base_packed::PtPacked>,                                 \
+                           hf_cand_base_packed::Eta<hf_cand_base_packed::EtaPacked>,                               \
+                           hf_cand_base_packed::Phi<hf_cand_base_packed::PhiPacked>,                               \
+                           hf_cand_base_packed::Y<hf_cand_base_packed::YPacked>,                                   \
+                           hf_cand_base_packed::Px<hf_cand_base_packed::PtPacked, hf_cand_base_packed::PhiPacked>, \
+                           hf_cand_base_packed::Py<hf_cand_base_packed::PtPacked, hf_cand_base_packed::PhiPacked>, \
+                           hf_cand_base_packed::Pz<hf_cand_base_packed::PtPacked, hf_cand_base_packed::EtaPacked>, \
+                           hf_cand_base_packed::P<hf_cand_base_packed::PtPacked, hf_cand_base_packed::EtaPacked>,  \
+                           o2::soa::Marker<Marker##_hf_type_>);
+
+// Declares the table with reduced-precision candidate selection ML scores (PackedMls), alternative to Mls.
+#define DECLARE_TABLE_CAND_ML_PACKED(_hf_type_, _hf_description_)                 \
+  DECLARE_SOA_TABLE_STAGED(Hf##_hf_type_##PackedMls, "HF" _hf_description_ "MLP", \
+                           hf_cand_mc::MlScoresPacked,                            \
+                           o2::soa::Marker<Marker##_hf_type_>);
+
 // Declares the table with global indices for 2-prong candidates (Ids).
 #define DECLARE_TABLE_CAND_ID_2P(_hf_type_, _hf_description_)              \
   DECLARE_SOA_TABLE_STAGED(Hf##_hf_type_##Ids, "HF" _hf_description_ "ID", \
@@ -274,12 +381,14 @@ DECLARE_SOA_COLUMN(FlagMcDecayChanGen, flagMcDecayChanGen, int8_t); //! resonant
 // Helper macros for combinations
 // ================
 
-#define DECLARE_TABLES_COMMON(_hf_type_, _hf_description_, _hf_namespace_)   \
-  DECLARE_TABLES_COLL(_hf_type_, _hf_description_)                           \
-  DECLARE_TABLES_MCCOLL(_hf_type_, _hf_description_, _hf_namespace_)         \
-  DECLARE_TABLE_CAND_BASE(_hf_type_, _hf_description_, _hf_namespace_)       \
-  DECLARE_TABLE_CAND_SEL(_hf_type_, _hf_description_)                        \
-  DECLARE_TABLE_MCPARTICLE_BASE(_hf_type_, _hf_description_, _hf_namespace_) \
+#define DECLARE_TABLES_COMMON(_hf_type_, _hf_description_, _hf_namespace_)    \
+  DECLARE_TABLES_COLL(_hf_type_, _hf_description_)                            \
+  DECLARE_TABLES_MCCOLL(_hf_type_, _hf_description_, _hf_namespace_)          \
+  DECLARE_TABLE_CAND_BASE(_hf_type_, _hf_description_, _hf_namespace_)        \
+  DECLARE_TABLE_CAND_BASE_PACKED(_hf_type_, _hf_description_, _hf_namespace_) \
+  DECLARE_TABLE_CAND_SEL(_hf_type_, _hf_description_)                         \
+  DECLARE_TABLE_CAND_ML_PACKED(_hf_type_, _hf_description_)                   \
+  DECLARE_TABLE_MCPARTICLE_BASE(_hf_type_, _hf_description_, _hf_namespace_)  \
   DECLARE_TABLE_MCPARTICLE_ID(_hf_type_, _hf_description_)
 
 #define DECLARE_TABLES_2P(_hf_type_, _hf_description_, _hf_namespace_, _marker_number_) \
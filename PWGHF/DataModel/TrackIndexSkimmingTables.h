@@ -277,6 +277,44 @@ DECLARE_SOA_TABLE(HfPvRefitDstar, "AOD", "HFPVREFITDSTAR", //!
                   hf_pv_refit::PvRefitSigmaZ2,
                   o2::soa::Marker<2>);
 
+// ================
+// Secondary-vertex fit tables
+// ================
+
+namespace hf_sv_fit
+{
+DECLARE_SOA_COLUMN(IsSvFitReusable, isSvFitReusable, bool);           //! Whether the fit was done with the tracks at their default collision and can be reused by the candidate creators
+DECLARE_SOA_COLUMN(XSecondaryVertex, xSecondaryVertex, double);       //!
+DECLARE_SOA_COLUMN(YSecondaryVertex, ySecondaryVertex, double);       //!
+DECLARE_SOA_COLUMN(ZSecondaryVertex, zSecondaryVertex, double);       //!
+DECLARE_SOA_COLUMN(CovSecondaryVertex, covSecondaryVertex, float[6]); //! Flat covariance matrix of the secondary vertex (xx, xy, yy, xz, yz, zz)
+DECLARE_SOA_COLUMN(Chi2Pca, chi2Pca, float);                          //!
+DECLARE_SOA_COLUMN(Prong0AtPca, prong0AtPca, float[22]);              //! First prong at the PCA (x, alpha, 5 parameters, 15 covariance elements)
+DECLARE_SOA_COLUMN(Prong1AtPca, prong1AtPca, float[22]);              //! Second prong at the PCA (x, alpha, 5 parameters, 15 covariance elements)
+DECLARE_SOA_COLUMN(Prong2AtPca, prong2AtPca, float[22]);              //! Third prong at the PCA (x, alpha, 5 parameters, 15 covariance elements)
+} // namespace hf_sv_fit
+
+DECLARE_SOA_TABLE(HfSvFit2Prong, "AOD", "HFSVFIT2PRONG", //! Secondary-vertex fits of the skimmed 2-prong candidates, joinable with Hf2Prongs
+                  hf_sv_fit::IsSvFitReusable,
+                  hf_sv_fit::XSecondaryVertex,
+                  hf_sv_fit::YSecondaryVertex,
+                  hf_sv_fit::ZSecondaryVertex,
+                  hf_sv_fit::CovSecondaryVertex,
+                  hf_sv_fit::Chi2Pca,
+                  hf_sv_fit::Prong0AtPca,
+                  hf_sv_fit::Prong1AtPca);
+
+DECLARE_SOA_TABLE(HfSvFit3Prong, "AOD", "HFSVFIT3PRONG", //! Secondary-vertex fits of the skimmed 3-prong candidates, joinable with Hf3Prongs
+                  hf_sv_fit::IsSvFitReusable,
+                  hf_sv_fit::XSecondaryVertex,
+                  hf_sv_fit::YSecondaryVertex,
+                  hf_sv_fit::ZSecondaryVertex,
+                  hf_sv_fit::CovSecondaryVertex,
+                  hf_sv_fit::Chi2Pca,
+                  hf_sv_fit::Prong0AtPca,
+                  hf_sv_fit::Prong1AtPca,
+                  hf_sv_fit::Prong2AtPca);
+
 // ================
 // Decay types stored in HFflag
 // ================
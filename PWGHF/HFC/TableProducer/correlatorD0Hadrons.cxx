@@ -55,6 +55,7 @@
 #include <Rtypes.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <vector>
@@ -243,6 +244,8 @@ struct HfCorrelatorD0Hadrons {
   int leadingIndex = 0;
   double softPiMass = 0.14543; // pion mass + Q-value of the D*->D0pi decay
 
+  AssociatedTracks associatedTracks; // associated tracks of the collision, read once for all the candidates
+
   SliceCache cache;
 
   Filter collisionFilter = aod::hf_selection_dmeson_collision::dmesonSel == true;
@@ -432,6 +435,7 @@ struct HfCorrelatorD0Hadrons {
       return static_cast<int>(aod::hf_d0_assoc_tracks::NotSoftPi);
     };
 
+    associatedTracks.fill(tracks, MassPiPlus);
     for (const auto& candidate : candidates) {
       if (std::abs(HfHelper::yD0(candidate)) >= yCandMax || candidate.pt() <= ptCandMin || candidate.pt() >= ptTrackMax) {
         continue;
@@ -497,11 +501,12 @@ struct HfCorrelatorD0Hadrons {
       // ============ D-h correlation dedicated section ==================================
 
       // ========================== track loop starts here ================================
-      for (const auto& track : tracks) {
+      for (std::size_t iTrack = 0; iTrack < associatedTracks.size(); iTrack++) {
+        const auto trackIndex = associatedTracks.globalIndex[iTrack];
         registry.fill(HIST("hTrackCounter"), 0); // fill total no. of tracks
         // Remove D0 daughters by checking track indices
         bool correlationStatus = false;
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex())) {
+        if ((candidate.prong0Id() == trackIndex) || (candidate.prong1Id() == trackIndex)) {
           if (!storeAutoCorrelationFlag) {
             continue;
           }
@@ -511,21 +516,21 @@ struct HfCorrelatorD0Hadrons {
 
         // ========== soft pion removal ===================================================
         double invMassDstar1 = 0., invMassDstar2 = 0.;
-        auto pSum2 = RecoDecay::p2(candidate.pVector(), track.pVector());
-        auto ePion = track.energy(MassPiPlus);
+        auto pSum2 = RecoDecay::p2(candidate.pVector(), associatedTracks.pVector[iTrack]);
+        auto ePion = associatedTracks.energy[iTrack];
         invMassDstar1 = std::sqrt((ePiK + ePion) * (ePiK + ePion) - pSum2);
         invMassDstar2 = std::sqrt((eKPi + ePion) * (eKPi + ePion) - pSum2);
 
         if (candidate.isSelD0() >= selectionFlagD0) {
           if ((std::abs(invMassDstar1 - invMassD0) - softPiMass) < ptSoftPionMax) {
-            addSoftPionTrackForOfflineMixing(track.globalIndex(), aod::hf_d0_assoc_tracks::SoftPiD0);
+            addSoftPionTrackForOfflineMixing(trackIndex, aod::hf_d0_assoc_tracks::SoftPiD0);
             continue;
           }
         }
 
         if (candidate.isSelD0bar() >= selectionFlagD0bar) {
           if ((std::abs(invMassDstar2 - invMassD0bar) - softPiMass) < ptSoftPionMax) {
-            addSoftPionTrackForOfflineMixing(track.globalIndex(), aod::hf_d0_assoc_tracks::SoftPiD0bar);
+            addSoftPionTrackForOfflineMixing(trackIndex, aod::hf_d0_assoc_tracks::SoftPiD0bar);
             continue;
           }
         }
@@ -540,22 +545,22 @@ struct HfCorrelatorD0Hadrons {
         }
 
         if (correlateD0WithLeadingParticle) {
-          if (track.globalIndex() != leadingIndex) {
+          if (trackIndex != leadingIndex) {
             continue;
           }
           registry.fill(HIST("hTrackCounter"), 3); // fill no. of tracks  have leading particle
         }
-        entryD0HadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                          track.eta() - candidate.eta(),
+        entryD0HadronPair(getDeltaPhi(associatedTracks.phi[iTrack], candidate.phi()),
+                          associatedTracks.eta[iTrack] - candidate.eta(),
                           candidate.pt(),
-                          track.pt(),
+                          associatedTracks.pt[iTrack],
                           poolBin,
                           correlationStatus,
                           cent);
         entryD0HadronRecoInfo(invMassD0, invMassD0bar, signalStatus);
         entryD0HadronGenInfo(false, false, 0);
         entryD0HadronMlInfo(outputMlD0[0], outputMlD0[1], outputMlD0[2], outputMlD0bar[0], outputMlD0bar[1], outputMlD0bar[2]);
-        entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
+        entryTrackRecoInfo(associatedTracks.dcaXY[iTrack], associatedTracks.dcaZ[iTrack], associatedTracks.tpcNClsCrossedRows[iTrack]);
         registry.fill(HIST("hCentFT0M"), cent);
 
       } // end inner loop (tracks)
@@ -625,6 +630,7 @@ struct HfCorrelatorD0Hadrons {
     std::vector<float> outputMlD0 = {-1., -1., -1.};
     std::vector<float> outputMlD0bar = {-1., -1., -1.};
 
+    associatedTracks.fill(tracks, MassPiPlus);
     for (const auto& candidate : candidates) {
       bool isD0Prompt = candidate.originMcRec() == RecoDecay::OriginType::Prompt;
       bool isD0NonPrompt = candidate.originMcRec() == RecoDecay::OriginType::NonPrompt;
@@ -714,14 +720,16 @@ struct HfCorrelatorD0Hadrons {
       flagD0bar = candidate.flagMcMatchRec() == -o2::hf_decay::hf_cand_2prong::DecayChannelMain::D0ToPiK; // flagD0Reflection 'true' if candidate, selected as D0 (particle), is matched to D0bar (antiparticle)
       // ========== track loop starts here ========================
 
+      std::size_t iTrack = 0;
       for (const auto& track : tracks) {
+        const std::size_t iAssoc = iTrack++;
         registry.fill(HIST("hTrackCounter"), 0); // fill total no. of tracks
         if (!track.isGlobalTrackWoDCA()) {
           continue;
         }
         // Removing D0 daughters by checking track indices
         bool correlationStatus = false;
-        if ((candidate.prong0Id() == track.globalIndex()) || (candidate.prong1Id() == track.globalIndex())) {
+        if ((candidate.prong0Id() == associatedTracks.globalIndex[iAssoc]) || (candidate.prong1Id() == associatedTracks.globalIndex[iAssoc])) {
           if (!storeAutoCorrelationFlag) {
             continue;
           }
@@ -733,8 +741,8 @@ struct HfCorrelatorD0Hadrons {
         // ===== soft pion removal ===================================================
         double invMassDstar1 = 0, invMassDstar2 = 0;
         bool isSoftPiD0 = false, isSoftPiD0bar = false;
-        auto pSum2 = RecoDecay::p2(candidate.pVector(), track.pVector());
-        auto ePion = track.energy(MassPiPlus);
+        auto pSum2 = RecoDecay::p2(candidate.pVector(), associatedTracks.pVector[iAssoc]);
+        auto ePion = associatedTracks.energy[iAssoc];
         invMassDstar1 = std::sqrt((ePiK + ePion) * (ePiK + ePion) - pSum2);
         invMassDstar2 = std::sqrt((eKPi + ePion) * (eKPi + ePion) - pSum2);
 
@@ -753,7 +761,7 @@ struct HfCorrelatorD0Hadrons {
         registry.fill(HIST("hTrackCounter"), 2); // fill no. of tracks after soft pion removal
 
         if (correlateD0WithLeadingParticle) {
-          if (track.globalIndex() != leadingIndex) {
+          if (associatedTracks.globalIndex[iAssoc] != leadingIndex) {
             continue;
           }
           registry.fill(HIST("hTrackCounter"), 3); // fill no. of tracks  have leading particle
@@ -780,10 +788,10 @@ struct HfCorrelatorD0Hadrons {
           SETBIT(signalStatus, aod::hf_correlation_d0_hadron::ParticleTypeMcRec::D0barBg);
         } // background case D0bar
 
-        entryD0HadronPair(getDeltaPhi(track.phi(), candidate.phi()),
-                          track.eta() - candidate.eta(),
+        entryD0HadronPair(getDeltaPhi(associatedTracks.phi[iAssoc], candidate.phi()),
+                          associatedTracks.eta[iAssoc] - candidate.eta(),
                           candidate.pt(),
-                          track.pt(),
+                          associatedTracks.pt[iAssoc],
                           poolBin,
                           correlationStatus,
                           cent);
@@ -799,11 +807,11 @@ struct HfCorrelatorD0Hadrons {
           registry.fill(HIST("hTrackCounter"), 4); // fill no. of fake tracks
         }
         // for secondary particle fraction estimation
-        registry.fill(HIST("hPtParticleAssocVsCandRec"), track.pt(), candidate.pt());
+        registry.fill(HIST("hPtParticleAssocVsCandRec"), associatedTracks.pt[iAssoc], candidate.pt());
         if (isPhysicalPrimary) {
-          registry.fill(HIST("hPtPrimaryParticleAssocVsCandRec"), track.pt(), candidate.pt());
+          registry.fill(HIST("hPtPrimaryParticleAssocVsCandRec"), associatedTracks.pt[iAssoc], candidate.pt());
         }
-        entryTrackRecoInfo(track.dcaXY(), track.dcaZ(), track.tpcNClsCrossedRows());
+        entryTrackRecoInfo(associatedTracks.dcaXY[iAssoc], associatedTracks.dcaZ[iAssoc], associatedTracks.tpcNClsCrossedRows[iAssoc]);
       } // end inner loop (Tracks)
     } // end of outer loop (D0)
   }
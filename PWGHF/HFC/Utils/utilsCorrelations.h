@@ -27,8 +27,11 @@
 
 #include <TPDGCode.h>
 
+#include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
+#include <vector>
 
 namespace o2::analysis::hf_correlations
 {
@@ -227,5 +230,57 @@ int findLeadingParticleMcGen(TMcParticles const& mcParticles, T1 const etaTrackM
   }
   return leadingParticle.globalIndex();
 }
+
+// ======= Associated tracks of a collision ============
+/// Quantities of the associated tracks of a collision used in the pair loops, read once per collision and stored as
+/// arrays: the dynamic columns (pt, eta, phi, momentum, energy) are otherwise recomputed for each trigger candidate.
+/// The values are those of the track table, so that the pairs are unchanged.
+struct AssociatedTracks {
+  std::vector<int64_t> globalIndex;          // global index of the track
+  std::vector<float> pt;                     // transverse momentum
+  std::vector<float> eta;                    // pseudorapidity
+  std::vector<float> phi;                    // azimuthal angle
+  std::vector<std::array<float, 3>> pVector; // momentum
+  std::vector<float> energy;                 // energy with the mass hypothesis of fill
+  std::vector<float> dcaXY;                  // DCA in the transverse plane
+  std::vector<float> dcaZ;                   // DCA along z
+  std::vector<int16_t> tpcNClsCrossedRows;   // number of crossed TPC rows
+
+  /// \return number of tracks
+  std::size_t size() const { return globalIndex.size(); }
+
+  /// Stores the quantities of the tracks of a collision, in the order of the table
+  /// \param tracks tracks of the collision
+  /// \param mass mass hypothesis of the energy
+  template <typename TTracks>
+  void fill(TTracks const& tracks, const double mass)
+  {
+    clear();
+    for (const auto& track : tracks) {
+      globalIndex.push_back(track.globalIndex());
+      pt.push_back(track.pt());
+      eta.push_back(track.eta());
+      phi.push_back(track.phi());
+      pVector.push_back(track.pVector());
+      energy.push_back(track.energy(mass));
+      dcaXY.push_back(track.dcaXY());
+      dcaZ.push_back(track.dcaZ());
+      tpcNClsCrossedRows.push_back(track.tpcNClsCrossedRows());
+    }
+  }
+
+  void clear()
+  {
+    globalIndex.clear();
+    pt.clear();
+    eta.clear();
+    phi.clear();
+    pVector.clear();
+    energy.clear();
+    dcaXY.clear();
+    dcaZ.clear();
+    tpcNClsCrossedRows.clear();
+  }
+};
 } // namespace o2::analysis::hf_correlations
 #endif // PWGHF_HFC_UTILS_UTILSCORRELATIONS_H_
@@ -26,6 +26,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 #include "PWGHF/Utils/utilsMcGen.h"
 #include "PWGHF/Utils/utilsMcMatching.h"
@@ -34,6 +35,7 @@
 #include "PWGLF/DataModel/mcCentrality.h"
 
 #include "Common/Core/RecoDecay.h"
+#include "Common/Core/TableHelper.h"
 #include "Common/Core/ZorroSummary.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/Centrality.h"
@@ -67,11 +69,13 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <numeric>
+#include <optional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -88,6 +92,7 @@ using namespace o2::hf_occupancy;
 using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::aod::pid_tpc_tof_utils;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of heavy-flavour 2-prong decay candidates
 struct HfCandidateCreator2Prong {
@@ -100,6 +105,7 @@ struct HfCandidateCreator2Prong {
 
   // vertexing
   Configurable<bool> constrainKfToPv{"constrainKfToPv", true, "constraint KFParticle to PV"};
+  Configurable<bool> useKfSimd{"useKfSimd", false, "Reconstruct the KFParticle candidates in batches with KFParticleSIMD"};
   Configurable<bool> propagateToPCA{"propagateToPCA", true, "create tracks version propagated to PCA"};
   Configurable<bool> useAbsDCA{"useAbsDCA", false, "Minimise abs. distance rather than chi2"};
   Configurable<bool> useWeightedFinalPCA{"useWeightedFinalPCA", false, "Recalculate vertex position using track covariances, effective only if useAbsDCA is true"};
@@ -115,11 +121,15 @@ struct HfCandidateCreator2Prong {
   Configurable<std::string> ccdbPathGrpMag{"ccdbPathGrpMag", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object (Run 3)"};
 
   HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<2> df; // 2-prong vertex fitter
+  o2::vertexing::DCAFitterN<2>* df{}; // 2-prong vertex fitter
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
 
   int runNumber{0};
   double bz{0.};
+  bool useSkimSvFit{false}; // reuse the secondary-vertex fits of the track-index skimming
+  KFCandidateBatch2Prong kfBatchD0;    // D0 candidates reconstructed with KFParticleSIMD
+  KFCandidateBatch2Prong kfBatchD0bar; // D0bar candidates reconstructed with KFParticleSIMD
+  double bzKfBatch{0.};                // magnetic field of the KFParticleSIMD reconstruction
 
   constexpr static float CentiToMicro{10000.f}; // from cm to µm
 
@@ -132,11 +142,12 @@ struct HfCandidateCreator2Prong {
   HistogramRegistry registry{"registry"};
   OutputObj<ZorroSummary> zorroSummary{"zorroSummary"};
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
-    std::array<bool, 8> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
-                                    doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
-                                    doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M, doprocessPvRefitWithDCAFitterNUpc, doprocessNoPvRefitWithDCAFitterNUpc};
+    std::array<bool, 10> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
+                                     doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
+                                     doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M, doprocessPvRefitWithDCAFitterNUpc, doprocessNoPvRefitWithDCAFitterNUpc,
+                                     doprocessPvRefitWithDCAFitterNSkimSvFit, doprocessNoPvRefitWithDCAFitterNSkimSvFit};
     std::array<bool, 8> doprocessKF{doprocessPvRefitWithKFParticle, doprocessNoPvRefitWithKFParticle,
                                     doprocessPvRefitWithKFParticleCentFT0C, doprocessNoPvRefitWithKFParticleCentFT0C,
                                     doprocessPvRefitWithKFParticleCentFT0M, doprocessNoPvRefitWithKFParticleCentFT0M, doprocessPvRefitWithKFParticleUpc, doprocessNoPvRefitWithKFParticleUpc};
@@ -152,7 +163,7 @@ struct HfCandidateCreator2Prong {
       LOGP(fatal, "At most one process function for collision monitoring can be enabled at a time.");
     }
     if (nProcessesCollisions == 1) {
-      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
+      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithDCAFitterNSkimSvFit || doprocessNoPvRefitWithDCAFitterNSkimSvFit || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisions\"?");
       }
       if ((doprocessPvRefitWithDCAFitterNCentFT0C || doprocessNoPvRefitWithDCAFitterNCentFT0C || doprocessPvRefitWithKFParticleCentFT0C || doprocessNoPvRefitWithKFParticleCentFT0C) && !doprocessCollisionsCentFT0C) {
@@ -193,13 +204,10 @@ struct HfCandidateCreator2Prong {
       registry.fill(HIST("hVertexerType"), aod::hf_cand::VertexerType::DCAFitter);
       // Configure DCAFitterN
       // df.setBz(bz);
-      df.setPropagateToPCA(propagateToPCA);
-      df.setMaxR(maxR);
-      df.setMaxDZIni(maxDZIni);
-      df.setMinParamChange(minParamChange);
-      df.setMinRelChi2Change(minRelChi2Change);
-      df.setUseAbsDCA(useAbsDCA);
-      df.setWeightedFinalPCA(useWeightedFinalPCA);
+      df = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
+    }
+    if (doprocessPvRefitWithDCAFitterNSkimSvFit || doprocessNoPvRefitWithDCAFitterNSkimSvFit) {
+      useSkimSvFit = isSkimSvFitCompatible(initContext);
     }
     if (std::accumulate(doprocessKF.begin(), doprocessKF.end(), 0) == 1) {
       registry.fill(HIST("hVertexerType"), aod::hf_cand::VertexerType::KfParticle);
@@ -214,6 +222,32 @@ struct HfCandidateCreator2Prong {
     setLabelHistoCands(hCandidates);
   }
 
+  /// Check that the secondary-vertex fits of the track-index skimming were done with the same DCAFitterN settings as the ones of this task
+  /// \param initContext is the init context of the task
+  /// \return false if any setting differs, in which case the candidates are fitted again
+  bool isSkimSvFitCompatible(InitContext& initContext)
+  {
+    const std::string skimmerName{"hf-track-index-skim-creator"};
+    bool isCompatible{true};
+    auto checkOption = [&](const auto& configurable) {
+      auto skimmerValue = configurable.value;
+      if (!o2::common::core::getTaskOptionValue(initContext, skimmerName, configurable.name, skimmerValue, false)) {
+        LOGP(warning, "Option {} of {} not found in the workflow, assuming the same value as in this task", configurable.name, skimmerName);
+      } else if (skimmerValue != configurable.value) {
+        LOGP(warning, "Option {} differs between {} and this task, the 2-prong candidates will be fitted again", configurable.name, skimmerName);
+        isCompatible = false;
+      }
+    };
+    checkOption(propagateToPCA);
+    checkOption(useAbsDCA);
+    checkOption(useWeightedFinalPCA);
+    checkOption(maxR);
+    checkOption(maxDZIni);
+    checkOption(minParamChange);
+    checkOption(minRelChi2Change);
+    return isCompatible;
+  }
+
   template <bool DoPvRefit, bool ApplyUpcSel, o2::hf_centrality::CentralityEstimator CentEstimator, typename Coll, typename CandType, typename TTracks, typename BCsType>
   void runCreator2ProngWithDCAFitterN(Coll const&,
                                       CandType const& rowsTrackIndexProng2,
@@ -254,30 +288,48 @@ struct HfCandidateCreator2Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(bz);
-
-      // reconstruct the 2-prong secondary vertex
+      HfDcaFitterPool::updateBz(bz);
+
+      // reconstruct the 2-prong secondary vertex, unless it can be taken from the track-index skimming
+      o2::vertexing::DCAFitterN<2>::Vec3D secondaryVertex{};
+      float chi2PCA{0.f};
+      std::array<float, 6> covMatrixPCA{};
+      o2::track::TrackParCov trackParVar0{};
+      o2::track::TrackParCov trackParVar1{};
+      bool isSvFitReused{false};
       hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVarPos1, trackParVarNeg1) == 0) {
+      if constexpr (requires { rowTrackIndexProng2.isSvFitReusable(); }) {
+        if (useSkimSvFit && rowTrackIndexProng2.isSvFitReusable()) {
+          secondaryVertex = o2::vertexing::DCAFitterN<2>::Vec3D(rowTrackIndexProng2.xSecondaryVertex(), rowTrackIndexProng2.ySecondaryVertex(), rowTrackIndexProng2.zSecondaryVertex());
+          chi2PCA = rowTrackIndexProng2.chi2Pca();
+          std::copy_n(rowTrackIndexProng2.covSecondaryVertex(), covMatrixPCA.size(), covMatrixPCA.begin());
+          trackParVar0 = hf_trkcandsel::getTrackAtPca(rowTrackIndexProng2.prong0AtPca());
+          trackParVar1 = hf_trkcandsel::getTrackAtPca(rowTrackIndexProng2.prong1AtPca());
+          isSvFitReused = true;
+        }
+      }
+      if (!isSvFitReused) {
+        try {
+          if (df->process(trackParVarPos1, trackParVarNeg1) == 0) {
+            continue;
+          }
+        } catch (const std::runtime_error& error) {
+          LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
           continue;
         }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
+        secondaryVertex = df->getPCACandidate();
+        chi2PCA = df->getChi2AtPCACandidate();
+        covMatrixPCA = df->calcPCACovMatrixFlat();
+        trackParVar0 = df->getTrack(0);
+        trackParVar1 = df->getTrack(1);
       }
       hCandidates->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
       registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
       registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
       registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      auto trackParVar0 = df.getTrack(0);
-      auto trackParVar1 = df.getTrack(1);
 
       // get track momenta
       std::array<float, 3> pvec0{};
@@ -371,14 +423,70 @@ struct HfCandidateCreator2Prong {
     }
   }
 
+  /// @brief Create the KFPVertex of the production vertex of a candidate
+  /// @param collision collision of the candidate
+  /// @param rowTrackIndexProng2 track-index row of the candidate, holding the PV refit
+  template <bool DoPvRefit, typename Coll, typename TRow>
+  KFPVertex createKfpVertex(Coll const& collision, TRow const& rowTrackIndexProng2)
+  {
+    KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
+    if constexpr (DoPvRefit) {
+      /// use PV refit
+      /// Using it in the rowCandidateBase all dynamic columns shall take it into account
+      // coordinates
+      kfpVertex.SetXYZ(rowTrackIndexProng2.pvRefitX(), rowTrackIndexProng2.pvRefitY(), rowTrackIndexProng2.pvRefitZ());
+      // covariance matrix
+      kfpVertex.SetCovarianceMatrix(rowTrackIndexProng2.pvRefitSigmaX2(), rowTrackIndexProng2.pvRefitSigmaXY(), rowTrackIndexProng2.pvRefitSigmaY2(), rowTrackIndexProng2.pvRefitSigmaXZ(), rowTrackIndexProng2.pvRefitSigmaYZ(), rowTrackIndexProng2.pvRefitSigmaZ2());
+    }
+    return kfpVertex;
+  }
+
+  /// @brief Reconstruct the D0 and D0bar candidates of the dataframe in batches with KFParticleSIMD
+  /// The candidates rejected by the event selection are reconstructed too and never read.
+  /// @param rowsTrackIndexProng2 track-index rows of the candidates
+  template <bool DoPvRefit, typename Coll, typename TTracks, typename BCsType, typename CandType>
+  void fillKfBatches(CandType const& rowsTrackIndexProng2)
+  {
+    kfBatchD0.clear();
+    kfBatchD0bar.clear();
+    kfBatchD0.reserve(rowsTrackIndexProng2.size());
+    kfBatchD0bar.reserve(rowsTrackIndexProng2.size());
+    for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
+      auto collision = rowTrackIndexProng2.template collision_as<Coll>();
+      auto bc = collision.template bc_as<BCsType>();
+      if (runNumber != bc.runNumber()) {
+        LOG(info) << ">>>>>>>>>>>> Current run number: " << runNumber;
+        initCCDB(bc, runNumber, ccdb, isRun2 ? ccdbPathGrp : ccdbPathGrpMag, nullptr, isRun2);
+        bz = o2::base::Propagator::Instance()->getNominalBz();
+        LOG(info) << ">>>>>>>>>>>> Magnetic field: " << bz;
+      }
+      KFParticle::SetField(bz);
+      KFParticle const kfpV(createKfpVertex<DoPvRefit>(collision, rowTrackIndexProng2));
+      KFPTrack const kfpTrack0 = createKFPTrackFromTrack(rowTrackIndexProng2.template prong0_as<TTracks>());
+      KFPTrack const kfpTrack1 = createKFPTrackFromTrack(rowTrackIndexProng2.template prong1_as<TTracks>());
+      kfBatchD0.add(KFParticle(kfpTrack0, kPiPlus), KFParticle(kfpTrack1, kKPlus), kfpV);
+      kfBatchD0bar.add(KFParticle(kfpTrack1, kPiPlus), KFParticle(kfpTrack0, kKPlus), kfpV);
+    }
+    // candidates of a dataframe spanning several runs are reconstructed with the field of the last run,
+    // the candidates of the other runs fall back to the scalar reconstruction
+    bzKfBatch = bz;
+    kfBatchD0.construct(bz, 2, -1.f, constrainKfToPv);
+    kfBatchD0bar.construct(bz, 2, -1.f, false);
+  }
+
   template <bool DoPvRefit, bool ApplyUpcSel, o2::hf_centrality::CentralityEstimator CentEstimator, typename Coll, typename CandType, typename TTracks, typename BCsType>
   void runCreator2ProngWithKFParticle(Coll const&,
                                       CandType const& rowsTrackIndexProng2,
                                       TTracks const&,
                                       BCsType const& bcs)
   {
+    if (useKfSimd) {
+      fillKfBatches<DoPvRefit, Coll, TTracks, BCsType>(rowsTrackIndexProng2);
+    }
 
+    int64_t iBatch{-1};
     for (const auto& rowTrackIndexProng2 : rowsTrackIndexProng2) {
+      ++iBatch;
 
       /// reject candidates in collisions not satisfying the event selections
       auto collision = rowTrackIndexProng2.template collision_as<Coll>();
@@ -412,16 +520,7 @@ struct HfCandidateCreator2Prong {
       float covMatrixPV[6];
 
       KFParticle::SetField(bz);
-      KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
-
-      if constexpr (DoPvRefit) {
-        /// use PV refit
-        /// Using it in the rowCandidateBase all dynamic columns shall take it into account
-        // coordinates
-        kfpVertex.SetXYZ(rowTrackIndexProng2.pvRefitX(), rowTrackIndexProng2.pvRefitY(), rowTrackIndexProng2.pvRefitZ());
-        // covariance matrix
-        kfpVertex.SetCovarianceMatrix(rowTrackIndexProng2.pvRefitSigmaX2(), rowTrackIndexProng2.pvRefitSigmaXY(), rowTrackIndexProng2.pvRefitSigmaY2(), rowTrackIndexProng2.pvRefitSigmaXZ(), rowTrackIndexProng2.pvRefitSigmaYZ(), rowTrackIndexProng2.pvRefitSigmaZ2());
-      }
+      KFPVertex kfpVertex = createKfpVertex<DoPvRefit>(collision, rowTrackIndexProng2);
       kfpVertex.GetCovarianceMatrix(covMatrixPV);
       KFParticle const kfpV(kfpVertex);
       registry.fill(HIST("hCovPVXX"), covMatrixPV[0]);
@@ -453,14 +552,21 @@ struct HfCandidateCreator2Prong {
         registry.fill(HIST("hDcaZProngs"), track1.pt(), -999.f);
       }
 
+      // use the batched reconstruction only if it was done with the magnetic field of this candidate
+      const bool useKfBatch = useKfSimd && bz == bzKfBatch;
       KFParticle kfCandD0;
-      const KFParticle* kfDaughtersD0[2] = {&kfPosPion, &kfNegKaon};
-      kfCandD0.SetConstructMethod(2);
-      kfCandD0.Construct(kfDaughtersD0, 2);
       KFParticle kfCandD0bar;
-      const KFParticle* kfDaughtersD0bar[2] = {&kfNegPion, &kfPosKaon};
-      kfCandD0bar.SetConstructMethod(2);
-      kfCandD0bar.Construct(kfDaughtersD0bar, 2);
+      if (useKfBatch) {
+        kfCandD0 = kfBatchD0.getCandidate(iBatch);
+        kfCandD0bar = kfBatchD0bar.getCandidate(iBatch);
+      } else {
+        const KFParticle* kfDaughtersD0[2] = {&kfPosPion, &kfNegKaon};
+        kfCandD0.SetConstructMethod(2);
+        kfCandD0.Construct(kfDaughtersD0, 2);
+        const KFParticle* kfDaughtersD0bar[2] = {&kfNegPion, &kfPosKaon};
+        kfCandD0bar.SetConstructMethod(2);
+        kfCandD0bar.Construct(kfDaughtersD0bar, 2);
+      }
 
       auto massD0 = kfCandD0.GetMass();
       auto massD0bar = kfCandD0bar.GetMass();
@@ -480,8 +586,12 @@ struct HfCandidateCreator2Prong {
       float topolChi2PerNdfD0 = -999.;
       KFParticle kfCandD0Topol2PV;
       if (constrainKfToPv) {
-        kfCandD0Topol2PV = kfCandD0;
-        kfCandD0Topol2PV.SetProductionVertex(kfpV);
+        if (useKfBatch) {
+          kfCandD0Topol2PV = kfBatchD0.getCandidateTopo(iBatch);
+        } else {
+          kfCandD0Topol2PV = kfCandD0;
+          kfCandD0Topol2PV.SetProductionVertex(kfpV);
+        }
         topolChi2PerNdfD0 = kfCandD0Topol2PV.GetChi2() / kfCandD0Topol2PV.GetNDF();
       }
 
@@ -554,6 +664,26 @@ struct HfCandidateCreator2Prong {
   }
   PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterN, "Run candidate creator using DCA fitter w/o PV refit and w/o centrality selections", true);
 
+  /// @brief process function using DCA fitter w/ PV refit and w/o centrality selections, reusing the secondary-vertex fits of the track-index skimming
+  void processPvRefitWithDCAFitterNSkimSvFit(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                             soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong, aod::HfSvFit2Prong> const& rowsTrackIndexProng2,
+                                             TracksWCovExtraPidPiKa const& tracks,
+                                             aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ true, false, CentralityEstimator::None>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processPvRefitWithDCAFitterNSkimSvFit, "Run candidate creator using the DCA fitter results of the track-index skimming w/ PV refit and w/o centrality selections", false);
+
+  /// @brief process function using DCA fitter w/o PV refit and w/o centrality selections, reusing the secondary-vertex fits of the track-index skimming
+  void processNoPvRefitWithDCAFitterNSkimSvFit(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                               soa::Join<aod::Hf2Prongs, aod::HfSvFit2Prong> const& rowsTrackIndexProng2,
+                                               TracksWCovExtraPidPiKa const& tracks,
+                                               aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator2ProngWithDCAFitterN</*doPvRefit*/ false, false, CentralityEstimator::None>(collisions, rowsTrackIndexProng2, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator2Prong, processNoPvRefitWithDCAFitterNSkimSvFit, "Run candidate creator using the DCA fitter results of the track-index skimming w/o PV refit and w/o centrality selections", false);
+
   /// @brief process function using KFParticle package w/ PV refit and w/o centrality selections
   void processPvRefitWithKFParticle(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
                                     soa::Join<aod::Hf2Prongs, aod::HfPvRefit2Prong> const& rowsTrackIndexProng2,
@@ -827,8 +957,10 @@ struct HfCandidateCreator2ProngExpressions {
   Configurable<bool> matchKinkedDecayTopology{"matchKinkedDecayTopology", false, "Match also candidates with tracks that decay with kinked topology"};
   Configurable<bool> matchInteractionsWithMaterial{"matchInteractionsWithMaterial", false, "Match also candidates with tracks that interact with material"};
   Configurable<bool> matchCorrelatedBackground{"matchCorrelatedBackground", false, "Match correlated background candidates"};
+  Configurable<bool> useMcMatchingCache{"useMcMatchingCache", true, "Memoize the MC ancestry searches shared by the candidates of a dataframe"};
 
-  HfEventSelectionMc hfEvSelMc; // mc event selection and monitoring
+  HfEventSelectionMc hfEvSelMc;               // mc event selection and monitoring
+  RecoDecay::McMatchingCache mcMatchingCache; // memo of the MC ancestry searches
 
   using McCollisionsNoCents = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels>;
   using McCollisionsFT0Cs = soa::Join<aod::Collisions, aod::EvSels, aod::McCollisionLabels, aod::CentFT0Cs>;
@@ -870,6 +1002,10 @@ struct HfCandidateCreator2ProngExpressions {
                           BCsInfo const&)
   {
     rowCandidateProng2->bindExternalIndices(&tracks);
+    std::optional<RecoDecay::McMatchingCache::Scope> mcMatchingCacheScope;
+    if (useMcMatchingCache) {
+      mcMatchingCacheScope.emplace(mcMatchingCache);
+    }
 
     int indexRec = -1;
     int8_t sign = 0;
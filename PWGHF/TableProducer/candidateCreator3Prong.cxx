@@ -26,6 +26,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 #include "PWGHF/Utils/utilsMcGen.h"
 #include "PWGHF/Utils/utilsMcMatching.h"
@@ -34,6 +35,7 @@
 #include "PWGLF/DataModel/mcCentrality.h"
 
 #include "Common/Core/RecoDecay.h"
+#include "Common/Core/TableHelper.h"
 #include "Common/Core/ZorroSummary.h"
 #include "Common/Core/trackUtilities.h"
 #include "Common/DataModel/Centrality.h"
@@ -68,6 +70,7 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <cstdint>
@@ -92,6 +95,7 @@ using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::aod::pid_tpc_tof_utils;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of heavy-flavour 3-prong decay candidates
 struct HfCandidateCreator3Prong {
@@ -146,17 +150,20 @@ struct HfCandidateCreator3Prong {
   Configurable<LabeledArray<float>> tpcPidBBParamsLightNuclei{"tpcPidBBParamsLightNuclei", {hf_presel_lightnuclei::BetheBlochParams[0], hf_presel_lightnuclei::NParticleRows, hf_presel_lightnuclei::NBetheBlochParams, hf_presel_lightnuclei::labelsRowsNucleiType, hf_presel_lightnuclei::labelsBetheBlochParams}, "TPC PID Bethe–Bloch parameter configurations for light nuclei (deuteron, triton, helium-3, alpha)"};
 
   HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<3> df; // 3-prong vertex fitter
+  o2::vertexing::DCAFitterN<3>* df{}; // 3-prong vertex fitter
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
 
   int runNumber{0};
   double bz{0.};
+  bool useSkimSvFit{false}; // reuse the secondary-vertex fits of the track-index skimming
 
   constexpr static float CentiToMicro{10000.f}; // from cm to µm
   constexpr static float UndefValueFloat{-999.f};
 
   using FilteredHf3Prongs = soa::Filtered<aod::Hf3Prongs>;
   using FilteredPvRefitHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfPvRefit3Prong>>;
+  using FilteredSvFitHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfSvFit3Prong>>;
+  using FilteredPvRefitSvFitHf3Prongs = soa::Filtered<soa::Join<aod::Hf3Prongs, aod::HfPvRefit3Prong, aod::HfSvFit3Prong>>;
   using TracksWCovExtraPidPiKaPrLightNuclei = soa::Join<aod::TracksWCovExtra, aod::TracksPidPi, aod::PidTpcTofFullPi, aod::TracksPidKa, aod::PidTpcTofFullKa, aod::TracksPidPr, aod::PidTpcTofFullPr, aod::TracksPidDe, aod::PidTpcTofFullDe, aod::TracksPidHe, aod::PidTpcTofFullHe, aod::TracksPidTr, aod::PidTpcTofFullTr, aod::TracksPidAl, aod::PidTpcTofFullAl>;
 
   // filter candidates
@@ -166,11 +173,12 @@ struct HfCandidateCreator3Prong {
   HistogramRegistry registry{"registry"};
   OutputObj<ZorroSummary> zorroSummary{"zorroSummary"};
 
-  void init(InitContext const&)
+  void init(InitContext& initContext)
   {
-    std::array<bool, 8> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
-                                    doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
-                                    doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M, doprocessPvRefitWithDCAFitterNUpc, doprocessNoPvRefitWithDCAFitterNUpc};
+    std::array<bool, 10> doprocessDF{doprocessPvRefitWithDCAFitterN, doprocessNoPvRefitWithDCAFitterN,
+                                     doprocessPvRefitWithDCAFitterNCentFT0C, doprocessNoPvRefitWithDCAFitterNCentFT0C,
+                                     doprocessPvRefitWithDCAFitterNCentFT0M, doprocessNoPvRefitWithDCAFitterNCentFT0M, doprocessPvRefitWithDCAFitterNUpc, doprocessNoPvRefitWithDCAFitterNUpc,
+                                     doprocessPvRefitWithDCAFitterNSkimSvFit, doprocessNoPvRefitWithDCAFitterNSkimSvFit};
     std::array<bool, 8> doprocessKF{doprocessPvRefitWithKFParticle, doprocessNoPvRefitWithKFParticle,
                                     doprocessPvRefitWithKFParticleCentFT0C, doprocessNoPvRefitWithKFParticleCentFT0C,
                                     doprocessPvRefitWithKFParticleCentFT0M, doprocessNoPvRefitWithKFParticleCentFT0M, doprocessPvRefitWithKFParticleUpc, doprocessNoPvRefitWithKFParticleUpc};
@@ -187,7 +195,7 @@ struct HfCandidateCreator3Prong {
       LOGP(fatal, "At most one process function for collision monitoring can be enabled at a time.");
     }
     if (nProcessesCollisions == 1) {
-      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
+      if ((doprocessPvRefitWithDCAFitterN || doprocessNoPvRefitWithDCAFitterN || doprocessPvRefitWithDCAFitterNSkimSvFit || doprocessNoPvRefitWithDCAFitterNSkimSvFit || doprocessPvRefitWithKFParticle || doprocessNoPvRefitWithKFParticle) && !doprocessCollisions) {
         LOGP(fatal, "Process function for collision monitoring not correctly enabled. Did you enable \"processCollisions\"?");
       }
       if ((doprocessPvRefitWithDCAFitterNCentFT0C || doprocessNoPvRefitWithDCAFitterNCentFT0C || doprocessPvRefitWithKFParticleCentFT0C || doprocessNoPvRefitWithKFParticleCentFT0C) && !doprocessCollisionsCentFT0C) {
@@ -239,13 +247,10 @@ struct HfCandidateCreator3Prong {
 
     // Configure DCAFitterN
     // df.setBz(bz);
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(static_cast<float>(maxR));
-    df.setMaxDZIni(static_cast<float>(maxDZIni));
-    df.setMinParamChange(static_cast<float>(minParamChange));
-    df.setMinRelChi2Change(static_cast<float>(minRelChi2Change));
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
+    df = HfDcaFitterPool::get<3>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
+    if (doprocessPvRefitWithDCAFitterNSkimSvFit || doprocessNoPvRefitWithDCAFitterNSkimSvFit) {
+      useSkimSvFit = isSkimSvFitCompatible(initContext);
+    }
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
@@ -288,6 +293,32 @@ struct HfCandidateCreator3Prong {
     }
   }
 
+  /// Check that the secondary-vertex fits of the track-index skimming were done with the same DCAFitterN settings as the ones of this task
+  /// \param initContext is the init context of the task
+  /// \return false if any setting differs, in which case the candidates are fitted again
+  bool isSkimSvFitCompatible(InitContext& initContext)
+  {
+    const std::string skimmerName{"hf-track-index-skim-creator"};
+    bool isCompatible{true};
+    auto checkOption = [&](const auto& configurable) {
+      auto skimmerValue = configurable.value;
+      if (!o2::common::core::getTaskOptionValue(initContext, skimmerName, configurable.name, skimmerValue, false)) {
+        LOGP(warning, "Option {} of {} not found in the workflow, assuming the same value as in this task", configurable.name, skimmerName);
+      } else if (skimmerValue != configurable.value) {
+        LOGP(warning, "Option {} differs between {} and this task, the 3-prong candidates will be fitted again", configurable.name, skimmerName);
+        isCompatible = false;
+      }
+    };
+    checkOption(propagateToPCA);
+    checkOption(useAbsDCA);
+    checkOption(useWeightedFinalPCA);
+    checkOption(maxR);
+    checkOption(maxDZIni);
+    checkOption(minParamChange);
+    checkOption(minRelChi2Change);
+    return isCompatible;
+  }
+
   template <bool DoPvRefit, bool ApplyUpcSel, o2::hf_centrality::CentralityEstimator CentEstimator, typename Coll, typename Cand, typename BCsType>
   void runCreator3ProngWithDCAFitterN(Coll const&,
                                       Cand const& rowsTrackIndexProng3,
@@ -330,31 +361,48 @@ struct HfCandidateCreator3Prong {
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
         // df.print();
       }
-      df.setBz(static_cast<float>(bz));
+      HfDcaFitterPool::updateBz(bz);
 
-      // reconstruct the 3-prong secondary vertex
+      // reconstruct the 3-prong secondary vertex, unless it can be taken from the track-index skimming
+      o2::vertexing::DCAFitterN<3>::Vec3D secondaryVertex{};
+      float chi2PCA{0.f};
+      std::array<float, 6> covMatrixPCA{};
+      bool isSvFitReused{false};
       hCandidates->Fill(SVFitting::BeforeFit);
-      try {
-        if (df.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+      if constexpr (requires { rowTrackIndexProng3.isSvFitReusable(); }) {
+        if (useSkimSvFit && rowTrackIndexProng3.isSvFitReusable()) {
+          secondaryVertex = o2::vertexing::DCAFitterN<3>::Vec3D(rowTrackIndexProng3.xSecondaryVertex(), rowTrackIndexProng3.ySecondaryVertex(), rowTrackIndexProng3.zSecondaryVertex());
+          chi2PCA = rowTrackIndexProng3.chi2Pca();
+          std::copy_n(rowTrackIndexProng3.covSecondaryVertex(), covMatrixPCA.size(), covMatrixPCA.begin());
+          trackParVar0 = hf_trkcandsel::getTrackAtPca(rowTrackIndexProng3.prong0AtPca());
+          trackParVar1 = hf_trkcandsel::getTrackAtPca(rowTrackIndexProng3.prong1AtPca());
+          trackParVar2 = hf_trkcandsel::getTrackAtPca(rowTrackIndexProng3.prong2AtPca());
+          isSvFitReused = true;
+        }
+      }
+      if (!isSvFitReused) {
+        try {
+          if (df->process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+            continue;
+          }
+        } catch (const std::runtime_error& error) {
+          LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+          hCandidates->Fill(SVFitting::Fail);
           continue;
         }
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        hCandidates->Fill(SVFitting::Fail);
-        continue;
+        secondaryVertex = df->getPCACandidate();
+        chi2PCA = df->getChi2AtPCACandidate();
+        covMatrixPCA = df->calcPCACovMatrixFlat();
+        trackParVar0 = df->getTrack(0);
+        trackParVar1 = df->getTrack(1);
+        trackParVar2 = df->getTrack(2);
       }
       hCandidates->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
       registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
       registry.fill(HIST("hCovSVYY"), covMatrixPCA[2]);
       registry.fill(HIST("hCovSVXZ"), covMatrixPCA[3]);
       registry.fill(HIST("hCovSVZZ"), covMatrixPCA[5]);
-      trackParVar0 = df.getTrack(0);
-      trackParVar1 = df.getTrack(1);
-      trackParVar2 = df.getTrack(2);
 
       // get track momenta
       std::array<float, 3> pvec0{};
@@ -734,6 +782,26 @@ struct HfCandidateCreator3Prong {
   }
   PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitWithDCAFitterN, "Run candidate creator using DCA fitter without PV refit and w/o centrality selections", true);
 
+  /// @brief process function using DCA fitter  w/ PV refit and w/o centrality selections, reusing the secondary-vertex fits of the track-index skimming
+  void processPvRefitWithDCAFitterNSkimSvFit(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                             FilteredPvRefitSvFitHf3Prongs const& rowsTrackIndexProng3,
+                                             TracksWCovExtraPidPiKaPrLightNuclei const& tracks,
+                                             aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3ProngWithDCAFitterN</*doPvRefit*/ true, false, CentralityEstimator::None>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processPvRefitWithDCAFitterNSkimSvFit, "Run candidate creator using the DCA fitter results of the track-index skimming with PV refit and w/o centrality selections", false);
+
+  /// @brief process function using DCA fitter  w/o PV refit and w/o centrality selections, reusing the secondary-vertex fits of the track-index skimming
+  void processNoPvRefitWithDCAFitterNSkimSvFit(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
+                                               FilteredSvFitHf3Prongs const& rowsTrackIndexProng3,
+                                               TracksWCovExtraPidPiKaPrLightNuclei const& tracks,
+                                               aod::BCsWithTimestamps const& bcWithTimeStamps)
+  {
+    runCreator3ProngWithDCAFitterN</*doPvRefit*/ false, false, CentralityEstimator::None>(collisions, rowsTrackIndexProng3, tracks, bcWithTimeStamps);
+  }
+  PROCESS_SWITCH(HfCandidateCreator3Prong, processNoPvRefitWithDCAFitterNSkimSvFit, "Run candidate creator using the DCA fitter results of the track-index skimming without PV refit and w/o centrality selections", false);
+
   /// @brief process function using KFParticle package  w/ PV refit and w/o centrality selections
   void processPvRefitWithKFParticle(soa::Join<aod::Collisions, aod::EvSels> const& collisions,
                                     FilteredPvRefitHf3Prongs const& rowsTrackIndexProng3,
@@ -22,6 +22,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsMcGen.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
 
@@ -68,6 +69,7 @@ using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::hf_trkcandsel;
 using namespace o2::hf_decay::hf_cand_beauty;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of B0 candidates
 struct HfCandidateCreatorB0 {
@@ -107,9 +109,9 @@ struct HfCandidateCreatorB0 {
   double bz{0.};
 
   // Fitter for B vertex (2-prong vertex filter)
-  o2::vertexing::DCAFitterN<2> df2;
+  o2::vertexing::DCAFitterN<2>* df2{};
   // Fitter to redo D-vertex to get extrapolated daughter tracks (3-prong vertex filter)
-  o2::vertexing::DCAFitterN<3> df3;
+  o2::vertexing::DCAFitterN<3>* df3{};
 
   using TracksWithSel = soa::Join<aod::TracksWCovDca, aod::TrackSelection>;
   using CandsDFiltered = soa::Filtered<soa::Join<aod::HfCand3Prong, aod::HfSelDplusToPiKPi>>;
@@ -137,28 +139,16 @@ struct HfCandidateCreatorB0 {
     invMass2DPiMax = (MassB0 + invMassWindowB0) * (MassB0 + invMassWindowB0);
 
     // Initialise fitter for B vertex (2-prong vertex filter)
-    df2.setPropagateToPCA(propagateToPCA);
-    df2.setMaxR(maxR);
-    df2.setMaxDZIni(maxDZIni);
-    df2.setMinParamChange(minParamChange);
-    df2.setMinRelChi2Change(minRelChi2Change);
-    df2.setUseAbsDCA(useAbsDCA);
-    df2.setWeightedFinalPCA(useWeightedFinalPCA);
+    df2 = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     // Initial fitter to redo D-vertex to get extrapolated daughter tracks (3-prong vertex filter)
-    df3.setPropagateToPCA(propagateToPCA);
-    df3.setMaxR(maxR);
-    df3.setMaxDZIni(maxDZIni);
-    df3.setMinParamChange(minParamChange);
-    df3.setMinRelChi2Change(minRelChi2Change);
-    df3.setUseAbsDCA(useAbsDCA);
-    df3.setWeightedFinalPCA(useWeightedFinalPCA);
+    df3 = HfDcaFitterPool::get<3>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     // Configure CCDB access
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
+    lut = HfDcaFitterPool::getMatLut(ccdb, ccdbPathLut);
     runNumber = 0;
 
     /// candidate monitoring
@@ -216,8 +206,7 @@ struct HfCandidateCreatorB0 {
         bz = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << bz;
       }
-      df2.setBz(bz);
-      df3.setBz(bz);
+      HfDcaFitterPool::updateBz(bz);
 
       auto thisCollId = collision.globalIndex();
       auto candsDThisColl = candsD.sliceBy(candsDPerCollision, thisCollId);
@@ -260,7 +249,7 @@ struct HfCandidateCreatorB0 {
         // reconstruct 3-prong secondary vertex (D±)
         hCandidatesD->Fill(SVFitting::BeforeFit);
         try {
-          if (df3.process(trackParCov0, trackParCov1, trackParCov2) == 0) {
+          if (df3->process(trackParCov0, trackParCov1, trackParCov2) == 0) {
             continue;
           }
         } catch (const std::runtime_error& error) {
@@ -270,22 +259,22 @@ struct HfCandidateCreatorB0 {
         }
         hCandidatesD->Fill(SVFitting::FitOk);
 
-        const auto& secondaryVertexD = df3.getPCACandidate();
+        const auto& secondaryVertexD = df3->getPCACandidate();
         // propagate the 3 prongs to the secondary vertex
         trackParCov0.propagateTo(secondaryVertexD[0], bz);
         trackParCov1.propagateTo(secondaryVertexD[0], bz);
         trackParCov2.propagateTo(secondaryVertexD[0], bz);
 
         // update pVec of tracks
-        df3.getTrack(0).getPxPyPzGlo(pVec0);
-        df3.getTrack(1).getPxPyPzGlo(pVec1);
-        df3.getTrack(2).getPxPyPzGlo(pVec2);
+        df3->getTrack(0).getPxPyPzGlo(pVec0);
+        df3->getTrack(1).getPxPyPzGlo(pVec1);
+        df3->getTrack(2).getPxPyPzGlo(pVec2);
 
         // D∓ → π∓ K± π∓
         std::array<float, 3> const pVecPiK = RecoDecay::pVec(pVec0, pVec1);
         std::array<float, 3> pVecD = RecoDecay::pVec(pVec0, pVec1, pVec2);
-        auto trackParCovPiK = o2::dataformats::V0(df3.getPCACandidatePos(), pVecPiK, df3.calcPCACovMatrixFlat(), trackParCov0, trackParCov1);
-        auto trackParCovD = o2::dataformats::V0(df3.getPCACandidatePos(), pVecD, df3.calcPCACovMatrixFlat(), trackParCovPiK, trackParCov2);
+        auto trackParCovPiK = o2::dataformats::V0(df3->getPCACandidatePos(), pVecPiK, df3->calcPCACovMatrixFlat(), trackParCov0, trackParCov1);
+        auto trackParCovD = o2::dataformats::V0(df3->getPCACandidatePos(), pVecD, df3->calcPCACovMatrixFlat(), trackParCovPiK, trackParCov2);
 
         int const indexTrack0 = track0.globalIndex();
         int const indexTrack1 = track1.globalIndex();
@@ -322,7 +311,7 @@ struct HfCandidateCreatorB0 {
           // reconstruct the 2-prong B0 vertex
           hCandidatesB->Fill(SVFitting::BeforeFit);
           try {
-            if (df2.process(trackParCovD, trackParCovPi) == 0) {
+            if (df2->process(trackParCovD, trackParCovPi) == 0) {
               continue;
             }
           } catch (const std::runtime_error& error) {
@@ -333,16 +322,16 @@ struct HfCandidateCreatorB0 {
           hCandidatesB->Fill(SVFitting::FitOk);
 
           // calculate relevant properties
-          const auto& secondaryVertexB0 = df2.getPCACandidate();
-          auto chi2PCA = df2.getChi2AtPCACandidate();
-          auto covMatrixPCA = df2.calcPCACovMatrixFlat();
+          const auto& secondaryVertexB0 = df2->getPCACandidate();
+          auto chi2PCA = df2->getChi2AtPCACandidate();
+          auto covMatrixPCA = df2->calcPCACovMatrixFlat();
           hCovSVXX->Fill(covMatrixPCA[0]);
           hCovPVXX->Fill(covMatrixPV[0]);
 
           // get D and Pi tracks (propagated to the B0 vertex if propagateToPCA==true)
           // track.getPxPyPzGlo(pVec) modifies pVec of track
-          df2.getTrack(0).getPxPyPzGlo(pVecD);    // momentum of D at the B0 vertex
-          df2.getTrack(1).getPxPyPzGlo(pVecPion); // momentum of Pi at the B0 vertex
+          df2->getTrack(0).getPxPyPzGlo(pVecD);    // momentum of D at the B0 vertex
+          df2->getTrack(1).getPxPyPzGlo(pVecPion); // momentum of Pi at the B0 vertex
 
           // calculate invariant mass square and apply selection
           auto invMass2DPi = RecoDecay::m2(std::array{pVecD, pVecPion}, std::array{MassDMinus, MassPiPlus});
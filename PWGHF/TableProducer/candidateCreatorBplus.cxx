@@ -26,6 +26,7 @@
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsMcGen.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
 
@@ -74,6 +75,7 @@ using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::hf_decay::hf_cand_beauty;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of B± → D0bar(D0) π± → (K± π∓) π±
 struct HfCandidateCreatorBplus {
@@ -116,9 +118,9 @@ struct HfCandidateCreatorBplus {
   double bz{0.};
 
   // Fitter for B vertex
-  o2::vertexing::DCAFitterN<2> dfB;
+  o2::vertexing::DCAFitterN<2>* dfB{};
   // Fitter to redo D-vertex to get extrapolated daughter tracks
-  o2::vertexing::DCAFitterN<2> df;
+  o2::vertexing::DCAFitterN<2>* df{};
 
   using TracksWithSel = soa::Join<aod::TracksWCovDca, aod::TrackSelection>;
   using CandsDFiltered = soa::Filtered<soa::Join<aod::HfCand2Prong, aod::HfSelD0>>;
@@ -143,26 +145,16 @@ struct HfCandidateCreatorBplus {
     invMass2D0PiMax = (MassBPlus + invMassWindowBplus) * (MassBPlus + invMassWindowBplus);
 
     // Initialise fitter for B vertex
-    dfB.setPropagateToPCA(propagateToPCA);
-    dfB.setMaxR(maxR);
-    dfB.setMinParamChange(minParamChange);
-    dfB.setMinRelChi2Change(minRelChi2Change);
-    dfB.setUseAbsDCA(true);
-    dfB.setWeightedFinalPCA(useWeightedFinalPCA);
+    dfB = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = true, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     // Initial fitter to redo D-vertex to get extrapolated daughter tracks
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
+    df = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     // Configure CCDB access
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
+    lut = HfDcaFitterPool::getMatLut(ccdb, ccdbPathLut);
     runNumber = 0;
 
     /// candidate monitoring
@@ -211,8 +203,7 @@ struct HfCandidateCreatorBplus {
         bz = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << bz;
       }
-      df.setBz(bz);
-      dfB.setBz(bz);
+      HfDcaFitterPool::updateBz(bz);
 
       auto thisCollId = collision.globalIndex();
       auto candsDThisColl = candsD.sliceBy(candsDPerCollision, thisCollId);
@@ -250,7 +241,7 @@ struct HfCandidateCreatorBplus {
         // reconstruct D0 secondary vertex
         hCandidatesD->Fill(SVFitting::BeforeFit);
         try {
-          if (df.process(trackParCovProng0, trackParCovProng1) == 0) {
+          if (df->process(trackParCovProng0, trackParCovProng1) == 0) {
             continue;
           }
         } catch (const std::runtime_error& error) {
@@ -260,19 +251,19 @@ struct HfCandidateCreatorBplus {
         }
         hCandidatesD->Fill(SVFitting::FitOk);
 
-        const auto& vertexD0 = df.getPCACandidatePos();
+        const auto& vertexD0 = df->getPCACandidatePos();
         trackParCovProng0.propagateTo(vertexD0[0], bz);
         trackParCovProng1.propagateTo(vertexD0[0], bz);
         // Get pVec of tracks
         std::array<float, 3> pVec0 = {0};
         std::array<float, 3> pVec1 = {0};
-        df.getTrack(0).getPxPyPzGlo(pVec0);
-        df.getTrack(1).getPxPyPzGlo(pVec1);
+        df->getTrack(0).getPxPyPzGlo(pVec0);
+        df->getTrack(1).getPxPyPzGlo(pVec1);
         // Get D0 momentum
         std::array<float, 3> const pVecD = RecoDecay::pVec(pVec0, pVec1);
 
         // build a D0 neutral track
-        auto trackD0 = o2::dataformats::V0(vertexD0, pVecD, df.calcPCACovMatrixFlat(), trackParCovProng0, trackParCovProng1);
+        auto trackD0 = o2::dataformats::V0(vertexD0, pVecD, df->calcPCACovMatrixFlat(), trackParCovProng0, trackParCovProng1);
 
         int const indexTrack0 = prong0.globalIndex();
         int const indexTrack1 = prong1.globalIndex();
@@ -316,7 +307,7 @@ struct HfCandidateCreatorBplus {
           // find the DCA between the D0 and the bachelor track, for B+
           hCandidatesB->Fill(SVFitting::BeforeFit);
           try {
-            if (dfB.process(trackD0, trackParCovPi) == 0) {
+            if (dfB->process(trackD0, trackParCovPi) == 0) {
               continue;
             }
           } catch (const std::runtime_error& error) {
@@ -330,9 +321,9 @@ struct HfCandidateCreatorBplus {
           trackD0.getPxPyPzGlo(pVecD0);         // momentum of D0 at the B+ vertex
           trackParCovPi.getPxPyPzGlo(pVecBach); // momentum of pi+ at the B+ vertex
 
-          const auto& secVertexBplus = dfB.getPCACandidate();
-          auto chi2PCA = dfB.getChi2AtPCACandidate();
-          auto covMatrixPCA = dfB.calcPCACovMatrixFlat();
+          const auto& secVertexBplus = dfB->getPCACandidate();
+          auto chi2PCA = dfB->getChi2AtPCACandidate();
+          auto covMatrixPCA = dfB->calcPCACovMatrixFlat();
           hCovSVXX->Fill(covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
 
           // get track impact parameters
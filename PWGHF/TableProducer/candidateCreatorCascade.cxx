@@ -20,6 +20,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
@@ -67,6 +68,7 @@ using namespace o2::hf_trkcandsel;
 using namespace o2::hf_centrality;
 using namespace o2::constants::physics;
 using namespace o2::framework;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of heavy-flavour cascade decay candidates
 struct HfCandidateCreatorCascade {
@@ -91,7 +93,7 @@ struct HfCandidateCreatorCascade {
   Configurable<std::string> ccdbPathGrpMag{"ccdbPathGrpMag", "GLO/Config/GRPMagField", "CCDB path of the GRPMagField object (Run 3)"};
 
   HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<2> df; // 2-prong vertex fitter
+  o2::vertexing::DCAFitterN<2>* df{}; // 2-prong vertex fitter
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
@@ -140,18 +142,12 @@ struct HfCandidateCreatorCascade {
     hfEvSel.init(registry, &zorroSummary);
 
     // df.setBz(bz);
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMaxDZIni(maxDZIni);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
+    df = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
+    lut = HfDcaFitterPool::getMatLut(ccdb, ccdbPathLut);
     runNumber = 0;
 
     /// candidate monitoring
@@ -239,7 +235,7 @@ struct HfCandidateCreatorCascade {
         bz = o2::base::Propagator::Instance()->getNominalBz();
         // df.setBz(bz); /// put it outside the 'if'! Otherwise we have a difference wrt bz Configurable (< 1 permille) in Run2 conv. data
       }
-      df.setBz(bz);
+      HfDcaFitterPool::updateBz(bz);
 
       auto trackBach = getTrackParCov(bach);
       const std::array<float, 3> vertexV0 = {v0X, v0Y, v0Z};
@@ -252,7 +248,7 @@ struct HfCandidateCreatorCascade {
       // reconstruct the cascade secondary vertex
       hCandidates->Fill(SVFitting::BeforeFit);
       try {
-        if (df.process(trackV0, trackBach) == 0) {
+        if (df->process(trackV0, trackBach) == 0) {
           continue;
         }
         LOG(debug) << "Vertexing succeeded for Lc candidate";
@@ -264,12 +260,12 @@ struct HfCandidateCreatorCascade {
       }
       hCandidates->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
+      const auto& secondaryVertex = df->getPCACandidate();
+      auto chi2PCA = df->getChi2AtPCACandidate();
+      auto covMatrixPCA = df->calcPCACovMatrixFlat();
       registry.fill(HIST("hCovSVXX"), covMatrixPCA[0]); // FIXME: Calculation of errorDecayLength(XY) gives wrong values without this line.
-      auto trackParVarV0 = df.getTrack(0);
-      auto trackParVarBach = df.getTrack(1);
+      auto trackParVarV0 = df->getTrack(0);
+      auto trackParVarBach = df->getTrack(1);
 
       // get track momenta
       std::array<float, 3> pVecV0{};
@@ -21,6 +21,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsTrkCandHf.h"
 
 #include "Common/Core/RecoDecay.h"
@@ -58,6 +59,7 @@ using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::hf_trkcandsel;
 using namespace o2::hf_decay::hf_cand_beauty;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of Λb candidates
 struct HfCandidateCreatorLb {
@@ -77,8 +79,8 @@ struct HfCandidateCreatorLb {
   Configurable<int> selectionFlagLc{"selectionFlagLc", 1, "Selection Flag for Lc"};
   Configurable<float> yCandMax{"yCandMax", -1., "max. cand. rapidity"};
 
-  o2::vertexing::DCAFitterN<2> df2; // 2-prong vertex fitter
-  o2::vertexing::DCAFitterN<3> df3; // 3-prong vertex fitter (to rebuild Lc vertex)
+  o2::vertexing::DCAFitterN<2>* df2{}; // 2-prong vertex fitter
+  o2::vertexing::DCAFitterN<3>* df3{}; // 3-prong vertex fitter (to rebuild Lc vertex)
 
   double massLcPi{0.};
 
@@ -97,23 +99,9 @@ struct HfCandidateCreatorLb {
 
   void init(InitContext const&)
   {
-    df2.setBz(bz);
-    df2.setPropagateToPCA(propagateToPCA);
-    df2.setMaxR(maxR);
-    df2.setMaxDZIni(maxDZIni);
-    df2.setMinParamChange(minParamChange);
-    df2.setMinRelChi2Change(minRelChi2Change);
-    df2.setUseAbsDCA(useAbsDCA);
-    df2.setWeightedFinalPCA(useWeightedFinalPCA);
-
-    df3.setBz(bz);
-    df3.setPropagateToPCA(propagateToPCA);
-    df3.setMaxR(maxR);
-    df3.setMaxDZIni(maxDZIni);
-    df3.setMinParamChange(minParamChange);
-    df3.setMinRelChi2Change(minRelChi2Change);
-    df3.setUseAbsDCA(useAbsDCA);
-    df3.setWeightedFinalPCA(useWeightedFinalPCA);
+    HfDcaFitterPool::updateBz(bz);
+    df2 = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
+    df3 = HfDcaFitterPool::get<3>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     /// candidate monitoring
     hCandidatesLc = registry.add<TH1>("hCandidatesLc", "Lc candidate counter", {HistType::kTH1D, {axisCands}});
@@ -153,7 +141,7 @@ struct HfCandidateCreatorLb {
       // reconstruct the 3-prong secondary vertex
       hCandidatesLc->Fill(SVFitting::BeforeFit);
       try {
-        if (df3.process(trackParVar0, trackParVar1, trackParVar2) == 0) {
+        if (df3->process(trackParVar0, trackParVar1, trackParVar2) == 0) {
           continue;
         }
       } catch (const std::runtime_error& error) {
@@ -163,15 +151,15 @@ struct HfCandidateCreatorLb {
       }
       hCandidatesLc->Fill(SVFitting::FitOk);
 
-      const auto& secondaryVertex = df3.getPCACandidate();
+      const auto& secondaryVertex = df3->getPCACandidate();
       trackParVar0.propagateTo(secondaryVertex[0], bz);
       trackParVar1.propagateTo(secondaryVertex[0], bz);
       trackParVar2.propagateTo(secondaryVertex[0], bz);
 
       std::array<float, 3> const pvecpK = RecoDecay::pVec(track0.pVector(), track1.pVector());
       std::array<float, 3> pvecLc = RecoDecay::pVec(pvecpK, track2.pVector());
-      auto trackpK = o2::dataformats::V0(df3.getPCACandidatePos(), pvecpK, df3.calcPCACovMatrixFlat(), trackParVar0, trackParVar1);
-      auto trackLc = o2::dataformats::V0(df3.getPCACandidatePos(), pvecLc, df3.calcPCACovMatrixFlat(), trackpK, trackParVar2);
+      auto trackpK = o2::dataformats::V0(df3->getPCACandidatePos(), pvecpK, df3->calcPCACovMatrixFlat(), trackParVar0, trackParVar1);
+      auto trackLc = o2::dataformats::V0(df3->getPCACandidatePos(), pvecLc, df3->calcPCACovMatrixFlat(), trackpK, trackParVar2);
 
       int const index0Lc = track0.globalIndex();
       int const index1Lc = track1.globalIndex();
@@ -195,7 +183,7 @@ struct HfCandidateCreatorLb {
         // reconstruct the 3-prong Lc vertex
         hCandidatesLb->Fill(SVFitting::BeforeFit);
         try {
-          if (df2.process(trackLc, trackParVarPi) == 0) {
+          if (df2->process(trackLc, trackParVarPi) == 0) {
             continue;
           }
         } catch (const std::runtime_error& error) {
@@ -206,13 +194,13 @@ struct HfCandidateCreatorLb {
         hCandidatesLb->Fill(SVFitting::FitOk);
 
         // calculate relevant properties
-        const auto& secondaryVertexLb = df2.getPCACandidate();
-        auto chi2PCA = df2.getChi2AtPCACandidate();
-        auto covMatrixPCA = df2.calcPCACovMatrixFlat();
+        const auto& secondaryVertexLb = df2->getPCACandidate();
+        auto chi2PCA = df2->getChi2AtPCACandidate();
+        auto covMatrixPCA = df2->calcPCACovMatrixFlat();
 
         // get Lc and Pi tracks (propagated to the Lb vertex if propagateToPCA==true)
-        df2.getTrack(0).getPxPyPzGlo(pvecLc);
-        df2.getTrack(1).getPxPyPzGlo(pvecPion);
+        df2->getTrack(0).getPxPyPzGlo(pvecLc);
+        df2->getTrack(1).getPxPyPzGlo(pvecPion);
 
         auto primaryVertex = getPrimaryVertex(collision);
         auto covMatrixPV = primaryVertex.getCov();
@@ -23,8 +23,10 @@
 #include <Framework/AnalysisHelpers.h>
 #include <Framework/AnalysisTask.h>
 #include <Framework/Configurable.h>
+#include <Framework/InitContext.h>
 #include <Framework/runDataProcessing.h>
 
+#include <array>
 #include <string>
 #include <vector>
 
@@ -48,11 +50,33 @@ struct HfCandidateCreatorMcGen {
   Configurable<bool> rejectBackground2Prong{"rejectBackground2Prong", false, "Reject particles from PbPb background for 2 prong candidates"};
   Configurable<bool> rejectBackground3Prong{"rejectBackground3Prong", false, "Reject particles from PbPb background for 3 prong candidates"};
 
+  Configurable<bool> useMcGenIndexer{"useMcGenIndexer", true, "Match all the enabled channels in a single pass over the MC particles"};
+
+  hf_mc_gen::HfMcGenIndexer mcGenIndexer;
+
   Preslice<aod::McParticles> mcParticlesPerMcCollision = aod::mcparticle::mcCollisionId;
 
+  void init(InitContext&)
+  {
+    using Indexer = hf_mc_gen::HfMcGenIndexer;
+    std::array<bool, Indexer::NFamilies> isEnabled{};
+    isEnabled[Indexer::TwoProng] = fill2Prong;
+    isEnabled[Indexer::ThreeProng] = fill3Prong;
+    isEnabled[Indexer::Bplus] = fillBplus;
+    isEnabled[Indexer::B0] = fillB0;
+    std::array<bool, Indexer::NFamilies> rejectBackground{};
+    rejectBackground[Indexer::TwoProng] = rejectBackground2Prong;
+    rejectBackground[Indexer::ThreeProng] = rejectBackground3Prong;
+    mcGenIndexer.init(isEnabled, rejectBackground, matchCorrelatedBackground, pdgMothersCorrelBkg);
+  }
+
   void process(aod::McCollisions const& mcCollisions,
                aod::McParticles const& mcParticles)
   {
+    if (useMcGenIndexer) {
+      mcGenIndexer.fill(mcParticles, rowMcMatchGen2Prong, rowMcMatchGen3Prong, rowMcMatchGenBplus, rowMcMatchGenB0);
+      return;
+    }
 
     for (const auto& mcCollision : mcCollisions) {
       const auto mcParticlesPerMcColl = mcParticles.sliceBy(mcParticlesPerMcCollision, mcCollision.globalIndex());
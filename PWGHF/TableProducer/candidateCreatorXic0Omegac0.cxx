@@ -27,6 +27,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 //
 #include "PWGLF/DataModel/LFStrangenessTables.h"
@@ -90,6 +91,7 @@ using namespace o2::constants::physics;
 using namespace o2::framework;
 using namespace o2::framework::expressions;
 using namespace o2::hf_evsel;
+using namespace o2::hf_dca_fitter;
 
 enum McMatchFlag : uint8_t {
   None = 0,
@@ -166,7 +168,7 @@ struct HfCandidateCreatorXic0Omegac0 {
   Configurable<bool> kfResolutionQA{"kfResolutionQA", false, "KF: KFParticle Quality Assurance"};
 
   HfEventSelection hfEvSel;        // event selection and monitoring
-  o2::vertexing::DCAFitterN<2> df; // 2-prong vertex fitter to build the omegac/xic vertex
+  o2::vertexing::DCAFitterN<2>* df{}; // 2-prong vertex fitter to build the omegac/xic vertex
   Service<o2::ccdb::BasicCCDBManager> ccdb{};
   Service<o2::framework::O2DatabasePDG> pdgdb{};
   o2::base::MatLayerCylSet* lut{};
@@ -393,20 +395,12 @@ struct HfCandidateCreatorXic0Omegac0 {
     // init HF event selection helper
     hfEvSel.init(registry, &zorroSummary);
 
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMaxDZIni(maxDZIni);
-    df.setMaxDXYIni(maxDXYIni);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setMaxChi2(maxChi2);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
+    df = HfDcaFitterPool::get<2>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .maxDXYIni = maxDXYIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .maxChi2 = maxChi2, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
 
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
+    lut = HfDcaFitterPool::getMatLut(ccdb, ccdbPathLut);
     runNumber = 0;
   }
 
@@ -464,7 +458,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
       }
-      df.setBz(magneticField);
+      HfDcaFitterPool::updateBz(magneticField);
 
       auto trackCharmBachelorId = cand.prong0Id();
       auto trackCharmBachelor = tracks.rawIteratorAt(trackCharmBachelorId);
@@ -554,7 +548,7 @@ struct HfCandidateCreatorXic0Omegac0 {
       // reconstruct charm baryon with DCAFitter
       int nVtxFromFitterCharmBaryon = 0;
       try {
-        nVtxFromFitterCharmBaryon = df.process(trackCasc, trackParVarCharmBachelor);
+        nVtxFromFitterCharmBaryon = df->process(trackCasc, trackParVarCharmBachelor);
       } catch (...) {
         LOG(error) << "Exception caught in charm DCA fitter process call!";
         hFitterStatus->Fill(1);
@@ -566,15 +560,15 @@ struct HfCandidateCreatorXic0Omegac0 {
       }
       hFitterStatus->Fill(0);
       hCandidateCounter->Fill(2);
-      auto vertexCharmBaryonFromFitter = df.getPCACandidate();
+      auto vertexCharmBaryonFromFitter = df->getPCACandidate();
       std::array<float, 3> pVecCascAsD{};
       std::array<float, 3> pVecCharmBachelorAsD{};
-      df.getTrack(0).getPxPyPzGlo(pVecCascAsD);
-      df.getTrack(1).getPxPyPzGlo(pVecCharmBachelorAsD);
+      df->getTrack(0).getPxPyPzGlo(pVecCascAsD);
+      df->getTrack(1).getPxPyPzGlo(pVecCharmBachelorAsD);
       std::array<float, 3> pVecCharmBaryon = {pVecCascAsD[0] + pVecCharmBachelorAsD[0], pVecCascAsD[1] + pVecCharmBachelorAsD[1], pVecCascAsD[2] + pVecCharmBachelorAsD[2]};
 
-      std::array<float, 3> const coordVtxCharmBaryon = df.getPCACandidatePos();
-      std::array<float, 6> covVtxCharmBaryon = df.calcPCACovMatrixFlat();
+      std::array<float, 3> const coordVtxCharmBaryon = df->getPCACandidatePos();
+      std::array<float, 6> covVtxCharmBaryon = df->calcPCACovMatrixFlat();
 
       // pseudorapidity
       float const pseudorapCharmBachelor = trackCharmBachelor.eta();
@@ -662,7 +656,7 @@ struct HfCandidateCreatorXic0Omegac0 {
       // DCA between daughters
       float dcaCascDau = casc.dcacascdaughters();
       float dcaV0Dau = casc.dcaV0daughters();
-      float const dcaCharmBaryonDau = std::sqrt(df.getChi2AtPCACandidate());
+      float const dcaCharmBaryonDau = std::sqrt(df->getChi2AtPCACandidate());
 
       // fill test histograms
       hInvMassCharmBaryon->Fill(mCharmBaryon);
@@ -795,7 +789,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
       }
-      df.setBz(magneticField);
+      HfDcaFitterPool::updateBz(magneticField);
       KFParticle::SetField(magneticField);
       // bachelor from Omegac0
       auto trackCharmBachelorId = cand.prong0Id();
@@ -1290,7 +1284,7 @@ struct HfCandidateCreatorXic0Omegac0 {
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << magneticField;
         runNumber = bc.runNumber();
       }
-      df.setBz(magneticField);
+      HfDcaFitterPool::updateBz(magneticField);
       KFParticle::SetField(magneticField);
       // bachelor from Xic0
       auto trackCharmBachelorId = cand.prong0Id();
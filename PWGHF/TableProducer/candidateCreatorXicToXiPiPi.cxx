@@ -27,6 +27,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/TrackIndexSkimmingTables.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
+#include "PWGHF/Utils/utilsDcaFitter.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 #include "PWGLF/DataModel/mcCentrality.h"
@@ -81,6 +82,7 @@ using namespace o2::hf_evsel;
 using namespace o2::hf_centrality;
 using namespace o2::hf_occupancy;
 using namespace o2::aod::hf_cand_xic_to_xi_pi_pi;
+using namespace o2::hf_dca_fitter;
 
 /// Reconstruction of heavy-flavour 3-prong decay candidates
 struct HfCandidateCreatorXicToXiPiPi {
@@ -116,7 +118,7 @@ struct HfCandidateCreatorXicToXiPiPi {
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType matCorr = o2::base::Propagator::MatCorrType::USEMatCorrLUT;
 
-  o2::vertexing::DCAFitterN<3> df;
+  o2::vertexing::DCAFitterN<3>* df{};
 
   HfEventSelection hfEvSel;
 
@@ -182,20 +184,14 @@ struct HfCandidateCreatorXicToXiPiPi {
     ccdb->setURL(ccdbUrl);
     ccdb->setCaching(true);
     ccdb->setLocalObjectValidityChecking();
-    lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->get<o2::base::MatLayerCylSet>(ccdbPathLut));
+    lut = HfDcaFitterPool::getMatLut(ccdb, ccdbPathLut);
     runNumber = 0;
 
     // initialize HF event selection helper
     hfEvSel.init(registry, &zorroSummary);
 
     // initialize 3-prong vertex fitter
-    df.setPropagateToPCA(propagateToPCA);
-    df.setMaxR(maxR);
-    df.setMaxDZIni(maxDZIni);
-    df.setMinParamChange(minParamChange);
-    df.setMinRelChi2Change(minRelChi2Change);
-    df.setUseAbsDCA(useAbsDCA);
-    df.setWeightedFinalPCA(useWeightedFinalPCA);
+    df = HfDcaFitterPool::get<3>({.propagateToPCA = propagateToPCA, .maxR = maxR, .maxDZIni = maxDZIni, .minParamChange = minParamChange, .minRelChi2Change = minRelChi2Change, .useAbsDCA = useAbsDCA, .useWeightedFinalPCA = useWeightedFinalPCA});
   }
 
   template <o2::hf_centrality::CentralityEstimator CentEstimator, typename Collision>
@@ -250,7 +246,7 @@ struct HfCandidateCreatorXicToXiPiPi {
         bz = o2::base::Propagator::Instance()->getNominalBz();
         LOG(info) << ">>>>>>>>>>>> Magnetic field: " << bz;
       }
-      df.setBz(bz);
+      HfDcaFitterPool::updateBz(bz);
 
       //--------------------------info of V0 and cascades track from LF-tables---------------------------
       std::array<float, 3> const vertexV0 = {casc.xlambda(), casc.ylambda(), casc.zlambda()};
@@ -284,7 +280,7 @@ struct HfCandidateCreatorXicToXiPiPi {
 
       // reconstruct the 3-prong secondary vertex
       try {
-        if (df.process(trackCasc, trackParCovCharmBachelor0, trackParCovCharmBachelor1) == 0) {
+        if (df->process(trackCasc, trackParCovCharmBachelor0, trackParCovCharmBachelor1) == 0) {
           continue;
         }
       } catch (const std::runtime_error& error) {
@@ -298,14 +294,14 @@ struct HfCandidateCreatorXicToXiPiPi {
       int8_t const signXic = casc.sign() < 0 ? +1 : -1;
 
       // get SV properties
-      const auto& secondaryVertex = df.getPCACandidate();
-      auto chi2SV = df.getChi2AtPCACandidate();
-      auto covMatrixSV = df.calcPCACovMatrixFlat();
+      const auto& secondaryVertex = df->getPCACandidate();
+      auto chi2SV = df->getChi2AtPCACandidate();
+      auto covMatrixSV = df->calcPCACovMatrixFlat();
 
       // get track momenta
-      trackCasc = df.getTrack(0);
-      trackParCovCharmBachelor0 = df.getTrack(1);
-      trackParCovCharmBachelor1 = df.getTrack(2);
+      trackCasc = df->getTrack(0);
+      trackParCovCharmBachelor0 = df->getTrack(1);
+      trackParCovCharmBachelor1 = df->getTrack(2);
       std::array<float, 3> pVecXi{};
       std::array<float, 3> pVecPi0{};
       std::array<float, 3> pVecPi1{};
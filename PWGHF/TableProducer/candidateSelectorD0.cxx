@@ -40,8 +40,10 @@
 #include <Framework/runDataProcessing.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -91,6 +93,7 @@ struct HfCandidateSelectorD0 {
   Configurable<LabeledArray<double>> cutsMl{"cutsMl", {hf_cuts_ml::Cuts[0], hf_cuts_ml::NBinsPt, hf_cuts_ml::NCutScores, hf_cuts_ml::labelsPt, hf_cuts_ml::labelsCutScore}, "ML selections per pT bin"};
   Configurable<int> nClassesMl{"nClassesMl", static_cast<int>(hf_cuts_ml::NCutScores), "Number of classes in ML model"};
   Configurable<bool> enableDebugMl{"enableDebugMl", false, "Flag to enable histograms to monitor BDT application"};
+  Configurable<bool> useBatchedMl{"useBatchedMl", false, "Flag to evaluate the ML models once per dataframe, on the input features of all the candidates"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
   // CCDB configuration
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
@@ -104,6 +107,10 @@ struct HfCandidateSelectorD0 {
   o2::analysis::HfMlResponseD0ToKPi<float> hfMlResponse;
   std::vector<float> outputMlD0;
   std::vector<float> outputMlD0bar;
+  std::vector<int64_t> rowsMl;         // positions in the table of the candidates evaluated in batched ML mode
+  std::vector<int> pdgCodesMl;         // mass hypotheses of the candidates evaluated in batched ML mode
+  std::vector<float> ptCandsMl;        // pT of the candidates evaluated in batched ML mode
+  std::vector<float> featureColumnsMl; // input features of the candidates evaluated in batched ML mode, one column for each feature
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
@@ -304,196 +311,260 @@ struct HfCandidateSelectorD0 {
 
     return true;
   }
-  template <int ReconstructionType, typename CandType>
-  void processSel(CandType const& candidates,
-                  TracksSel const&)
+
+  /// Selection flags of a candidate: 0 - rejected, 1 - accepted
+  struct SelectionStatus {
+    int statusD0{0};
+    int statusD0bar{0};
+    int statusHFFlag{0};
+    int statusTopol{0};
+    int statusCand{0};
+    int statusPID{0};
+  };
+  std::vector<SelectionStatus> statusesBatch; // selection flags of the candidates of the dataframe in batched ML mode
+
+  /// Track-quality, topological and PID selections of a candidate, without ML
+  /// \param candidate is candidate
+  /// \param status is filled with the selection flags of the candidate
+  template <int ReconstructionType, typename T>
+  void selectCandidate(const T& candidate, SelectionStatus& status)
   {
-    // looping over 2-prong candidates
-    for (const auto& candidate : candidates) {
+    if (!(candidate.hfflag() & 1 << aod::hf_cand_2prong::DecayType::D0ToPiK)) {
+      return;
+    }
+    status.statusHFFlag = 1;
 
-      // final selection flag: 0 - rejected, 1 - accepted
-      int statusD0 = 0;
-      int statusD0bar = 0;
-      int statusHFFlag = 0;
-      int statusTopol = 0;
-      int statusCand = 0;
-      int statusPID = 0;
-
-      outputMlD0.clear();
-      outputMlD0bar.clear();
-
-      if (!(candidate.hfflag() & 1 << aod::hf_cand_2prong::DecayType::D0ToPiK)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
-        continue;
-      }
-      statusHFFlag = 1;
+    auto trackPos = candidate.template prong0_as<TracksSel>(); // positive daughter
+    auto trackNeg = candidate.template prong1_as<TracksSel>(); // negative daughter
 
-      auto ptCand = candidate.pt();
-      auto trackPos = candidate.template prong0_as<TracksSel>(); // positive daughter
-      auto trackNeg = candidate.template prong1_as<TracksSel>(); // negative daughter
+    // implement track quality selection for D0 daughters
+    if (!isSelectedCandidateProng(trackPos, trackNeg)) {
+      return;
+    }
 
-      // implement track quality selection for D0 daughters
-      if (!isSelectedCandidateProng(trackPos, trackNeg)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
-        continue;
-      }
+    // conjugate-independent topological selection
+    if (!selectionTopol<ReconstructionType>(candidate)) {
+      return;
+    }
+    status.statusTopol = 1;
 
-      // conjugate-independent topological selection
-      if (!selectionTopol<ReconstructionType>(candidate)) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
-        continue;
+    // implement filter bit 4 cut - should be done before this task at the track selection level
+    // need to add special cuts (additional cuts on decay length and d0 norm)
+
+    // conjugate-dependent topological selection for D0
+    bool const topolD0 = selectionTopolConjugate<ReconstructionType>(candidate, trackPos, trackNeg);
+    // conjugate-dependent topological selection for D0bar
+    bool const topolD0bar = selectionTopolConjugate<ReconstructionType>(candidate, trackNeg, trackPos);
+
+    if (!topolD0 && !topolD0bar) {
+      return;
+    }
+    status.statusCand = 1;
+
+    if (usePid) {
+      // track-level PID selection
+      int pidTrackPosKaon = -1;
+      int pidTrackPosPion = -1;
+      int pidTrackNegKaon = -1;
+      int pidTrackNegPion = -1;
+
+      if (usePidTpcOnly) {
+        /// kaon TPC PID positive daughter
+        pidTrackPosKaon = selectorKaon.statusTpc(trackPos, candidate.nSigTpcKa0());
+        /// pion TPC PID positive daughter
+        pidTrackPosPion = selectorPion.statusTpc(trackPos, candidate.nSigTpcPi0());
+        /// kaon TPC PID negative daughter
+        pidTrackNegKaon = selectorKaon.statusTpc(trackNeg, candidate.nSigTpcKa1());
+        /// pion TPC PID negative daughter
+        pidTrackNegPion = selectorPion.statusTpc(trackNeg, candidate.nSigTpcPi1());
+      } else if (usePidTpcAndTof) {
+        /// kaon TPC, TOF PID positive daughter
+        pidTrackPosKaon = selectorKaon.statusTpcAndTof(trackPos, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
+        /// pion TPC, TOF PID positive daughter
+        pidTrackPosPion = selectorPion.statusTpcAndTof(trackPos, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
+        /// kaon TPC, TOF PID negative daughter
+        pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
+        /// pion TPC, TOF PID negative daughter
+        pidTrackNegPion = selectorPion.statusTpcAndTof(trackNeg, candidate.nSigTpcPi1(), candidate.nSigTofPi1());
+      } else {
+        /// kaon TPC, TOF PID positive daughter
+        pidTrackPosKaon = selectorKaon.statusTpcOrTof(trackPos, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
+        /// pion TPC, TOF PID positive daughter
+        pidTrackPosPion = selectorPion.statusTpcOrTof(trackPos, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
+        /// kaon TPC, TOF PID negative daughter
+        pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
+        /// pion TPC, TOF PID negative daughter
+        pidTrackNegPion = selectorPion.statusTpcOrTof(trackNeg, candidate.nSigTpcPi1(), candidate.nSigTofPi1());
       }
-      statusTopol = 1;
 
-      // implement filter bit 4 cut - should be done before this task at the track selection level
-      // need to add special cuts (additional cuts on decay length and d0 norm)
+      // int pidBayesTrackPos1Pion = selectorPion.statusBayes(trackPos);
 
-      // conjugate-dependent topological selection for D0
-      bool const topolD0 = selectionTopolConjugate<ReconstructionType>(candidate, trackPos, trackNeg);
-      // conjugate-dependent topological selection for D0bar
-      bool const topolD0bar = selectionTopolConjugate<ReconstructionType>(candidate, trackNeg, trackPos);
+      int pidD0 = -1;
+      int pidD0bar = -1;
 
-      if (!topolD0 && !topolD0bar) {
-        hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-        if (applyMl) {
-          hfMlD0Candidate(outputMlD0, outputMlD0bar);
-        }
-        continue;
+      if (pidTrackPosPion == TrackSelectorPID::Accepted &&
+          pidTrackNegKaon == TrackSelectorPID::Accepted) {
+        pidD0 = 1; // accept D0
+      } else if (pidTrackPosPion == TrackSelectorPID::Rejected ||
+                 pidTrackNegKaon == TrackSelectorPID::Rejected) {
+        pidD0 = 0; // exclude D0
       }
-      statusCand = 1;
-
-      if (usePid) {
-        // track-level PID selection
-        int pidTrackPosKaon = -1;
-        int pidTrackPosPion = -1;
-        int pidTrackNegKaon = -1;
-        int pidTrackNegPion = -1;
-
-        if (usePidTpcOnly) {
-          /// kaon TPC PID positive daughter
-          pidTrackPosKaon = selectorKaon.statusTpc(trackPos, candidate.nSigTpcKa0());
-          /// pion TPC PID positive daughter
-          pidTrackPosPion = selectorPion.statusTpc(trackPos, candidate.nSigTpcPi0());
-          /// kaon TPC PID negative daughter
-          pidTrackNegKaon = selectorKaon.statusTpc(trackNeg, candidate.nSigTpcKa1());
-          /// pion TPC PID negative daughter
-          pidTrackNegPion = selectorPion.statusTpc(trackNeg, candidate.nSigTpcPi1());
-        } else if (usePidTpcAndTof) {
-          /// kaon TPC, TOF PID positive daughter
-          pidTrackPosKaon = selectorKaon.statusTpcAndTof(trackPos, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
-          /// pion TPC, TOF PID positive daughter
-          pidTrackPosPion = selectorPion.statusTpcAndTof(trackPos, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-          /// kaon TPC, TOF PID negative daughter
-          pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-          /// pion TPC, TOF PID negative daughter
-          pidTrackNegPion = selectorPion.statusTpcAndTof(trackNeg, candidate.nSigTpcPi1(), candidate.nSigTofPi1());
-        } else {
-          /// kaon TPC, TOF PID positive daughter
-          pidTrackPosKaon = selectorKaon.statusTpcOrTof(trackPos, candidate.nSigTpcKa0(), candidate.nSigTofKa0());
-          /// pion TPC, TOF PID positive daughter
-          pidTrackPosPion = selectorPion.statusTpcOrTof(trackPos, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-          /// kaon TPC, TOF PID negative daughter
-          pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-          /// pion TPC, TOF PID negative daughter
-          pidTrackNegPion = selectorPion.statusTpcOrTof(trackNeg, candidate.nSigTpcPi1(), candidate.nSigTofPi1());
-        }
 
-        // int pidBayesTrackPos1Pion = selectorPion.statusBayes(trackPos);
-
-        int pidD0 = -1;
-        int pidD0bar = -1;
+      if (pidTrackNegPion == TrackSelectorPID::Accepted &&
+          pidTrackPosKaon == TrackSelectorPID::Accepted) {
+        pidD0bar = 1; // accept D0bar
+      } else if (pidTrackNegPion == TrackSelectorPID::Rejected ||
+                 pidTrackPosKaon == TrackSelectorPID::Rejected) {
+        pidD0bar = 0; // exclude D0bar
+      }
 
-        if (pidTrackPosPion == TrackSelectorPID::Accepted &&
-            pidTrackNegKaon == TrackSelectorPID::Accepted) {
-          pidD0 = 1; // accept D0
-        } else if (pidTrackPosPion == TrackSelectorPID::Rejected ||
-                   pidTrackNegKaon == TrackSelectorPID::Rejected) {
-          pidD0 = 0; // exclude D0
-        }
+      if (pidD0 == 0 && pidD0bar == 0) {
+        return;
+      }
 
-        if (pidTrackNegPion == TrackSelectorPID::Accepted &&
-            pidTrackPosKaon == TrackSelectorPID::Accepted) {
-          pidD0bar = 1; // accept D0bar
-        } else if (pidTrackNegPion == TrackSelectorPID::Rejected ||
-                   pidTrackPosKaon == TrackSelectorPID::Rejected) {
-          pidD0bar = 0; // exclude D0bar
-        }
+      if ((pidD0 == -1 || pidD0 == 1) && topolD0) {
+        status.statusD0 = 1; // identified as D0
+      }
+      if ((pidD0bar == -1 || pidD0bar == 1) && topolD0bar) {
+        status.statusD0bar = 1; // identified as D0bar
+      }
+      status.statusPID = 1;
+    } else {
+      if (topolD0) {
+        status.statusD0 = 1; // identified as D0
+      }
+      if (topolD0bar) {
+        status.statusD0bar = 1; // identified as D0bar
+      }
+    }
+  }
 
-        if (pidD0 == 0 && pidD0bar == 0) {
-          hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
-          if (applyMl) {
-            hfMlD0Candidate(outputMlD0, outputMlD0bar);
-          }
-          continue;
-        }
+  /// Apply the ML selections to the selection flags of a candidate
+  /// \param candidate is candidate
+  /// \param status are the selection flags of the candidate
+  /// \param isSelectedMlD0 is the result of the ML selection for the D0 hypothesis
+  /// \param isSelectedMlD0bar is the result of the ML selection for the D0bar hypothesis
+  /// \param scoresD0 are the model scores for the D0 hypothesis
+  /// \param scoresD0bar are the model scores for the D0bar hypothesis
+  template <typename T>
+  void applyMlSelection(const T& candidate, SelectionStatus& status, bool isSelectedMlD0, bool isSelectedMlD0bar, std::span<const float> scoresD0, std::span<const float> scoresD0bar)
+  {
+    if (!isSelectedMlD0) {
+      status.statusD0 = 0;
+    }
+    if (!isSelectedMlD0bar) {
+      status.statusD0bar = 0;
+    }
 
-        if ((pidD0 == -1 || pidD0 == 1) && topolD0) {
-          statusD0 = 1; // identified as D0
-        }
-        if ((pidD0bar == -1 || pidD0bar == 1) && topolD0bar) {
-          statusD0bar = 1; // identified as D0bar
-        }
-        statusPID = 1;
-      } else {
-        if (topolD0) {
-          statusD0 = 1; // identified as D0
-        }
-        if (topolD0bar) {
-          statusD0bar = 1; // identified as D0bar
-        }
+    if (enableDebugMl) {
+      if (isSelectedMlD0) {
+        registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), scoresD0[0], status.statusD0);
+        registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), scoresD0[1], status.statusD0);
+        registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), scoresD0[2], status.statusD0);
+        registry.fill(HIST("DebugBdt/hMassDmesonSel"), HfHelper::invMassD0ToPiK(candidate));
+      }
+      if (isSelectedMlD0bar) {
+        registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), scoresD0bar[0], status.statusD0bar);
+        registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), scoresD0bar[1], status.statusD0bar);
+        registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), scoresD0bar[2], status.statusD0bar);
+        registry.fill(HIST("DebugBdt/hMassDmesonSel"), HfHelper::invMassD0barToKPi(candidate));
       }
+    }
+  }
+
+  template <int ReconstructionType, typename CandType>
+  void processSel(CandType const& candidates,
+                  TracksSel const&)
+  {
+    if (applyMl && useBatchedMl) {
+      processSelBatchedMl<ReconstructionType>(candidates);
+      return;
+    }
+
+    // looping over 2-prong candidates
+    for (const auto& candidate : candidates) {
+      SelectionStatus status;
+      selectCandidate<ReconstructionType>(candidate, status);
 
       if (applyMl) {
         // ML selections
         bool isSelectedMlD0 = false;
         bool isSelectedMlD0bar = false;
+        outputMlD0.clear();
+        outputMlD0bar.clear();
 
-        if (statusD0 > 0) {
+        if (status.statusD0 > 0) {
           std::vector<float> inputFeaturesD0 = hfMlResponse.getInputFeatures(candidate, o2::constants::physics::kD0);
-          isSelectedMlD0 = hfMlResponse.isSelectedMl(inputFeaturesD0, ptCand, outputMlD0);
+          isSelectedMlD0 = hfMlResponse.isSelectedMl(inputFeaturesD0, candidate.pt(), outputMlD0);
         }
-        if (statusD0bar > 0) {
+        if (status.statusD0bar > 0) {
           std::vector<float> inputFeaturesD0bar = hfMlResponse.getInputFeatures(candidate, o2::constants::physics::kD0Bar);
-          isSelectedMlD0bar = hfMlResponse.isSelectedMl(inputFeaturesD0bar, ptCand, outputMlD0bar);
-        }
-
-        if (!isSelectedMlD0) {
-          statusD0 = 0;
-        }
-        if (!isSelectedMlD0bar) {
-          statusD0bar = 0;
+          isSelectedMlD0bar = hfMlResponse.isSelectedMl(inputFeaturesD0bar, candidate.pt(), outputMlD0bar);
         }
 
+        applyMlSelection(candidate, status, isSelectedMlD0, isSelectedMlD0bar, outputMlD0, outputMlD0bar);
         hfMlD0Candidate(outputMlD0, outputMlD0bar);
-
-        if (enableDebugMl) {
-          if (isSelectedMlD0) {
-            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0[0], statusD0);
-            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0[1], statusD0);
-            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0[2], statusD0);
-            registry.fill(HIST("DebugBdt/hMassDmesonSel"), HfHelper::invMassD0ToPiK(candidate));
-          }
-          if (isSelectedMlD0bar) {
-            registry.fill(HIST("DebugBdt/hBdtScore1VsStatus"), outputMlD0bar[0], statusD0bar);
-            registry.fill(HIST("DebugBdt/hBdtScore2VsStatus"), outputMlD0bar[1], statusD0bar);
-            registry.fill(HIST("DebugBdt/hBdtScore3VsStatus"), outputMlD0bar[2], statusD0bar);
-            registry.fill(HIST("DebugBdt/hMassDmesonSel"), HfHelper::invMassD0barToKPi(candidate));
-          }
-        }
       }
-      hfSelD0Candidate(statusD0, statusD0bar, statusHFFlag, statusTopol, statusCand, statusPID);
+      hfSelD0Candidate(status.statusD0, status.statusD0bar, status.statusHFFlag, status.statusTopol, status.statusCand, status.statusPID);
     }
   }
 
+  /// Selections with the ML models evaluated once for all the candidates of the dataframe
+  /// \param candidates are the 2-prong candidates
+  template <int ReconstructionType, typename CandType>
+  void processSelBatchedMl(CandType const& candidates)
+  {
+    // first pass: selections without ML and collection of the mass hypotheses to be evaluated
+    statusesBatch.clear();
+    rowsMl.clear();
+    pdgCodesMl.clear();
+    ptCandsMl.clear();
+    for (const auto& candidate : candidates) {
+      auto& status = statusesBatch.emplace_back();
+      selectCandidate<ReconstructionType>(candidate, status);
+      if (status.statusD0 > 0) {
+        rowsMl.push_back(candidate.filteredIndex());
+        pdgCodesMl.push_back(o2::constants::physics::kD0);
+        ptCandsMl.push_back(candidate.pt());
+      }
+      if (status.statusD0bar > 0) {
+        rowsMl.push_back(candidate.filteredIndex());
+        pdgCodesMl.push_back(o2::constants::physics::kD0Bar);
+        ptCandsMl.push_back(candidate.pt());
+      }
+    }
+
+    // input features gathered feature by feature and evaluated in one model call per bin
+    hfMlResponse.clearBatch();
+    hfMlResponse.getInputFeaturesColumnar(candidates, rowsMl, pdgCodesMl, featureColumnsMl);
+    hfMlResponse.addColumnsToBatch(featureColumnsMl, ptCandsMl);
+    hfMlResponse.evalBatch();
+
+    // second pass: ML selections, in the same order as the candidates were added to the batch
+    std::size_t iCandBatch{0};
+    auto status = statusesBatch.begin();
+    for (const auto& candidate : candidates) {
+      bool isSelectedMlD0 = false;
+      bool isSelectedMlD0bar = false;
+      std::span<const float> scoresD0{};
+      std::span<const float> scoresD0bar{};
+      if (status->statusD0 > 0) {
+        isSelectedMlD0 = hfMlResponse.isSelectedBatch(iCandBatch);
+        scoresD0 = hfMlResponse.getBatchOutput(iCandBatch++);
+      }
+      if (status->statusD0bar > 0) {
+        isSelectedMlD0bar = hfMlResponse.isSelectedBatch(iCandBatch);
+        scoresD0bar = hfMlResponse.getBatchOutput(iCandBatch++);
+      }
+
+      applyMlSelection(candidate, *status, isSelectedMlD0, isSelectedMlD0bar, scoresD0, scoresD0bar);
+      outputMlD0.assign(scoresD0.begin(), scoresD0.end());
+      outputMlD0bar.assign(scoresD0bar.begin(), scoresD0bar.end());
+      hfMlD0Candidate(outputMlD0, outputMlD0bar);
+      hfSelD0Candidate(status->statusD0, status->statusD0bar, status->statusHFFlag, status->statusTopol, status->statusCand, status->statusPID);
+      ++status;
+    }
+  }
   void processWithDCAFitterN(aod::HfCand2ProngWPid const& candidates, TracksSel const& tracks)
   {
     processSel<aod::hf_cand::VertexerType::DCAFitter>(candidates, tracks);
@@ -44,6 +44,7 @@
 #include <TH2.h>
 
 #include <array>
+#include <cstddef>
 #include <cstdint>
 #include <numeric>
 #include <string>
@@ -102,6 +103,7 @@ struct HfCandidateSelectorLc {
   Configurable<LabeledArray<double>> cutsMl{"cutsMl", {hf_cuts_ml::Cuts[0], hf_cuts_ml::NBinsPt, hf_cuts_ml::NCutScores, hf_cuts_ml::labelsPt, hf_cuts_ml::labelsCutScore}, "ML selections per pT bin"};
   Configurable<int> nClassesMl{"nClassesMl", static_cast<int>(hf_cuts_ml::NCutScores), "Number of classes in ML model"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
+  Configurable<bool> useBatchedMl{"useBatchedMl", false, "Flag to evaluate the ML models once per dataframe, on the input features of all the candidates"};
   // CCDB configuration
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::vector<std::string>> modelPathsCCDB{"modelPathsCCDB", std::vector<std::string>{"EventFiltering/PWGHF/BDTLc"}, "Paths of models on CCDB"};
@@ -113,6 +115,10 @@ struct HfCandidateSelectorLc {
   o2::analysis::HfMlResponseLcToPKPi<float, aod::hf_cand::VertexerType::KfParticle> hfMlResponseKF;
   std::vector<float> outputMlLcToPKPi;
   std::vector<float> outputMlLcToPiKP;
+  std::vector<int64_t> rowsMl;          // positions in the table of the candidates evaluated in batched ML mode
+  std::vector<uint8_t> casesLcToPKPiMl; // mass hypotheses of the candidates evaluated in batched ML mode
+  std::vector<float> ptCandsMl;         // pT of the candidates evaluated in batched ML mode
+  std::vector<float> featureColumnsMl;  // input features of the candidates evaluated in batched ML mode, one column for each feature
   o2::ccdb::CcdbApi ccdbApi;
   TrackSelectorPi selectorPion;
   TrackSelectorKa selectorKaon;
@@ -435,143 +441,172 @@ struct HfCandidateSelectorLc {
            pidTrackPion != TrackSelectorPID::Rejected;
   }
 
-  /// \brief function to apply Lc selections
-  /// \param reconstructionType is the reconstruction type (DCAFitterN or KFParticle)
-  /// \param candidates Lc candidate table
-  /// \param tracks track table
-  template <bool UseBayesPid = false, aod::hf_cand::VertexerType ReconstructionType, typename CandType, typename TTracks>
-  void runSelectLc(CandType const& candidates, TTracks const&)
+  /// Selection flags of a candidate before the ML selections
+  struct SelectionStatus {
+    bool isPreselected{false};  // whether the candidate passes the selections applied before ML
+    bool isCandLcToPKPi{false}; // whether the LcToPKPi hypothesis passes the topological and PID selections
+    bool isCandLcToPiKP{false}; // whether the LcToPiKP hypothesis passes the topological and PID selections
+  };
+  std::vector<SelectionStatus> statusesBatch; // selection flags of the candidates of the dataframe in batched ML mode
+
+  /// \brief function to apply the track-quality, topological and PID selections to a Lc candidate
+  /// \param candidate is the Lc candidate
+  /// \param status is filled with the selection flags of the candidate
+  template <bool UseBayesPid, aod::hf_cand::VertexerType ReconstructionType, typename TTracks, typename TCand>
+  void selectCandidate(TCand const& candidate, SelectionStatus& status)
   {
-    // looping over 3-prong candidates
-    for (const auto& candidate : candidates) {
+    auto ptCand = candidate.pt();
 
-      // final selection flag
-      auto statusLcToPKPi = 0;
-      auto statusLcToPiKP = 0;
+    if (!(candidate.hfflag() & 1 << aod::hf_cand_3prong::DecayType::LcToPKPi)) {
+      if (activateQA) {
+        registry.fill(HIST("hSelections"), 1, ptCand);
+      }
+      return;
+    }
 
-      outputMlLcToPKPi.clear();
-      outputMlLcToPiKP.clear();
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoSkims, ptCand);
+    }
 
-      auto ptCand = candidate.pt();
+    auto trackPos1 = candidate.template prong0_as<TTracks>(); // positive daughter (negative for the antiparticles)
+    auto trackNeg = candidate.template prong1_as<TTracks>();  // negative daughter (positive for the antiparticles)
+    auto trackPos2 = candidate.template prong2_as<TTracks>(); // positive daughter (negative for the antiparticles)
 
-      if (!(candidate.hfflag() & 1 << aod::hf_cand_3prong::DecayType::LcToPKPi)) {
-        hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-        if (applyMl) {
-          hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
-        }
-        if (activateQA) {
-          registry.fill(HIST("hSelections"), 1, ptCand);
-        }
-        continue;
-      }
+    // implement filter bit 4 cut - should be done before this task at the track selection level
 
-      if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoSkims, ptCand);
-      }
+    // track quality selection
+    if (!isSelectedCandidateProngQuality(trackPos1, trackNeg, trackPos2)) {
+      return;
+    }
+
+    // conjugate-independent topological selection
+    if (!selectionTopol<ReconstructionType>(candidate)) {
+      return;
+    }
 
-      auto trackPos1 = candidate.template prong0_as<TTracks>(); // positive daughter (negative for the antiparticles)
-      auto trackNeg = candidate.template prong1_as<TTracks>();  // negative daughter (positive for the antiparticles)
-      auto trackPos2 = candidate.template prong2_as<TTracks>(); // positive daughter (negative for the antiparticles)
+    // conjugate-dependent topological selection for Lc
+    bool const topolLcToPKPi = selectionTopolConjugate<ReconstructionType>(candidate, trackPos1, trackNeg, trackPos2);
+    bool const topolLcToPiKP = selectionTopolConjugate<ReconstructionType>(candidate, trackPos2, trackNeg, trackPos1);
 
-      // implement filter bit 4 cut - should be done before this task at the track selection level
+    if (!topolLcToPKPi && !topolLcToPiKP) {
+      return;
+    }
 
-      // track quality selection
-      bool const trackQualitySel = isSelectedCandidateProngQuality(trackPos1, trackNeg, trackPos2);
-      if (!trackQualitySel) {
-        hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-        if (applyMl) {
-          hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
-        }
-        continue;
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, candidate.pt());
+    }
+
+    // PID not applied, accepted by default
+    auto pidLcToPKPi = 1;
+    auto pidLcToPiKP = 1;
+    auto pidBayesLcToPKPi = 1;
+    auto pidBayesLcToPiKP = 1;
+
+    if (usePid) {
+      // track-level PID selection
+      TrackSelectorPID::Status pidTrackPos1Proton{};
+      TrackSelectorPID::Status pidTrackPos2Proton{};
+      TrackSelectorPID::Status pidTrackPos1Pion{};
+      TrackSelectorPID::Status pidTrackPos2Pion{};
+      TrackSelectorPID::Status pidTrackNegKaon{};
+      if (usePidTpcAndTof) {
+        pidTrackPos1Proton = selectorProton.statusTpcAndTof(trackPos1, candidate.nSigTpcPr0(), candidate.nSigTofPr0());
+        pidTrackPos2Proton = selectorProton.statusTpcAndTof(trackPos2, candidate.nSigTpcPr2(), candidate.nSigTofPr2());
+        pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
+        pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
+        pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
+      } else {
+        pidTrackPos1Proton = selectorProton.statusTpcOrTof(trackPos1, candidate.nSigTpcPr0(), candidate.nSigTofPr0());
+        pidTrackPos2Proton = selectorProton.statusTpcOrTof(trackPos2, candidate.nSigTpcPr2(), candidate.nSigTofPr2());
+        pidTrackPos1Pion = selectorPion.statusTpcOrTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
+        pidTrackPos2Pion = selectorPion.statusTpcOrTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
+        pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
       }
 
-      // conjugate-independent topological selection
-      if (!selectionTopol<ReconstructionType>(candidate)) {
-        hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-        if (applyMl) {
-          hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
-        }
-        continue;
+      if (!isSelectedPID(pidTrackPos1Proton, pidTrackNegKaon, pidTrackPos2Pion)) {
+        pidLcToPKPi = 0; // reject LcToPKPi
+      }
+      if (!isSelectedPID(pidTrackPos2Proton, pidTrackNegKaon, pidTrackPos1Pion)) {
+        pidLcToPiKP = 0; // accept LcToPiKP
       }
+    }
 
-      // conjugate-dependent topological selection for Lc
-      bool const topolLcToPKPi = selectionTopolConjugate<ReconstructionType>(candidate, trackPos1, trackNeg, trackPos2);
-      bool const topolLcToPiKP = selectionTopolConjugate<ReconstructionType>(candidate, trackPos2, trackNeg, trackPos1);
+    if constexpr (UseBayesPid) {
+      TrackSelectorPID::Status const pidBayesTrackPos1Proton = selectorProton.statusBayes(trackPos1);
+      TrackSelectorPID::Status const pidBayesTrackPos2Proton = selectorProton.statusBayes(trackPos2);
+      TrackSelectorPID::Status const pidBayesTrackPos1Pion = selectorPion.statusBayes(trackPos1);
+      TrackSelectorPID::Status const pidBayesTrackPos2Pion = selectorPion.statusBayes(trackPos2);
+      TrackSelectorPID::Status const pidBayesTrackNegKaon = selectorKaon.statusBayes(trackNeg);
 
-      if (!topolLcToPKPi && !topolLcToPiKP) {
-        hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-        if (applyMl) {
-          hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
-        }
-        continue;
+      if (!isSelectedPID(pidBayesTrackPos1Proton, pidBayesTrackNegKaon, pidBayesTrackPos2Pion)) {
+        pidBayesLcToPKPi = 0; // reject LcToPKPi
       }
 
-      if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoTopol, candidate.pt());
+      if (!isSelectedPID(pidBayesTrackPos2Proton, pidBayesTrackNegKaon, pidBayesTrackPos1Pion)) {
+        pidBayesLcToPiKP = 0; // reject LcToPiKP
       }
+    }
 
-      // PID not applied, accepted by default
-      auto pidLcToPKPi = 1;
-      auto pidLcToPiKP = 1;
-      auto pidBayesLcToPKPi = 1;
-      auto pidBayesLcToPiKP = 1;
-
-      if (usePid) {
-        // track-level PID selection
-        TrackSelectorPID::Status pidTrackPos1Proton{};
-        TrackSelectorPID::Status pidTrackPos2Proton{};
-        TrackSelectorPID::Status pidTrackPos1Pion{};
-        TrackSelectorPID::Status pidTrackPos2Pion{};
-        TrackSelectorPID::Status pidTrackNegKaon{};
-        if (usePidTpcAndTof) {
-          pidTrackPos1Proton = selectorProton.statusTpcAndTof(trackPos1, candidate.nSigTpcPr0(), candidate.nSigTofPr0());
-          pidTrackPos2Proton = selectorProton.statusTpcAndTof(trackPos2, candidate.nSigTpcPr2(), candidate.nSigTofPr2());
-          pidTrackPos1Pion = selectorPion.statusTpcAndTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-          pidTrackPos2Pion = selectorPion.statusTpcAndTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-          pidTrackNegKaon = selectorKaon.statusTpcAndTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-        } else {
-          pidTrackPos1Proton = selectorProton.statusTpcOrTof(trackPos1, candidate.nSigTpcPr0(), candidate.nSigTofPr0());
-          pidTrackPos2Proton = selectorProton.statusTpcOrTof(trackPos2, candidate.nSigTpcPr2(), candidate.nSigTofPr2());
-          pidTrackPos1Pion = selectorPion.statusTpcOrTof(trackPos1, candidate.nSigTpcPi0(), candidate.nSigTofPi0());
-          pidTrackPos2Pion = selectorPion.statusTpcOrTof(trackPos2, candidate.nSigTpcPi2(), candidate.nSigTofPi2());
-          pidTrackNegKaon = selectorKaon.statusTpcOrTof(trackNeg, candidate.nSigTpcKa1(), candidate.nSigTofKa1());
-        }
+    if ((pidLcToPKPi == 0 && pidLcToPiKP == 0) || (pidBayesLcToPKPi == 0 && pidBayesLcToPiKP == 0)) {
+      return;
+    }
 
-        if (!isSelectedPID(pidTrackPos1Proton, pidTrackNegKaon, pidTrackPos2Pion)) {
-          pidLcToPKPi = 0; // reject LcToPKPi
-        }
-        if (!isSelectedPID(pidTrackPos2Proton, pidTrackNegKaon, pidTrackPos1Pion)) {
-          pidLcToPiKP = 0; // accept LcToPiKP
-        }
-      }
+    if (activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoPID, candidate.pt());
+    }
 
-      if constexpr (UseBayesPid) {
-        TrackSelectorPID::Status const pidBayesTrackPos1Proton = selectorProton.statusBayes(trackPos1);
-        TrackSelectorPID::Status const pidBayesTrackPos2Proton = selectorProton.statusBayes(trackPos2);
-        TrackSelectorPID::Status const pidBayesTrackPos1Pion = selectorPion.statusBayes(trackPos1);
-        TrackSelectorPID::Status const pidBayesTrackPos2Pion = selectorPion.statusBayes(trackPos2);
-        TrackSelectorPID::Status const pidBayesTrackNegKaon = selectorKaon.statusBayes(trackNeg);
+    status.isPreselected = true;
+    status.isCandLcToPKPi = pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && topolLcToPKPi;
+    status.isCandLcToPiKP = pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && topolLcToPiKP;
+  }
 
-        if (!isSelectedPID(pidBayesTrackPos1Proton, pidBayesTrackNegKaon, pidBayesTrackPos2Pion)) {
-          pidBayesLcToPKPi = 0; // reject LcToPKPi
-        }
+  /// \brief function to fill the selection table of a Lc candidate, after the ML selections
+  /// \param candidate is the Lc candidate
+  /// \param status are the selection flags of the candidate before the ML selections
+  /// \param isSelectedMlLcToPKPi is the result of the ML selection for the LcToPKPi hypothesis
+  /// \param isSelectedMlLcToPiKP is the result of the ML selection for the LcToPiKP hypothesis
+  template <typename TCand>
+  void fillSelection(TCand const& candidate, SelectionStatus const& status, bool isSelectedMlLcToPKPi, bool isSelectedMlLcToPiKP)
+  {
+    if (!status.isPreselected || (applyMl && !isSelectedMlLcToPKPi && !isSelectedMlLcToPiKP)) {
+      hfSelLcCandidate(0, 0);
+      return;
+    }
+    if (applyMl && activateQA) {
+      registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoMl, candidate.pt());
+    }
 
-        if (!isSelectedPID(pidBayesTrackPos2Proton, pidBayesTrackNegKaon, pidBayesTrackPos1Pion)) {
-          pidBayesLcToPiKP = 0; // reject LcToPiKP
-        }
-      }
+    auto statusLcToPKPi = 0;
+    auto statusLcToPiKP = 0;
+    if (status.isCandLcToPKPi && isSelectedMlLcToPKPi) {
+      statusLcToPKPi = 1; // identified as LcToPKPi
+    }
+    if (status.isCandLcToPiKP && isSelectedMlLcToPiKP) {
+      statusLcToPiKP = 1; // identified as LcToPiKP
+    }
+    hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
+  }
 
-      if ((pidLcToPKPi == 0 && pidLcToPiKP == 0) || (pidBayesLcToPKPi == 0 && pidBayesLcToPiKP == 0)) {
-        hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-        if (applyMl) {
-          hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
-        }
-        continue;
+  /// \brief function to apply Lc selections
+  /// \param reconstructionType is the reconstruction type (DCAFitterN or KFParticle)
+  /// \param candidates Lc candidate table
+  /// \param tracks track table
+  template <bool UseBayesPid = false, aod::hf_cand::VertexerType ReconstructionType, typename CandType, typename TTracks>
+  void runSelectLc(CandType const& candidates, TTracks const&)
+  {
+    if (applyMl && useBatchedMl) {
+      if constexpr (ReconstructionType == aod::hf_cand::VertexerType::DCAFitter) {
+        runSelectLcBatchedMl<UseBayesPid, ReconstructionType, TTracks>(candidates, hfMlResponseDCA);
+      } else {
+        runSelectLcBatchedMl<UseBayesPid, ReconstructionType, TTracks>(candidates, hfMlResponseKF);
       }
+      return;
+    }
 
-      if (activateQA) {
-        registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoPID, candidate.pt());
-      }
+    // looping over 3-prong candidates
+    for (const auto& candidate : candidates) {
+      SelectionStatus status;
+      selectCandidate<UseBayesPid, ReconstructionType, TTracks>(candidate, status);
 
       bool isSelectedMlLcToPKPi = true;
       bool isSelectedMlLcToPiKP = true;
@@ -579,47 +614,89 @@ struct HfCandidateSelectorLc {
         // ML selections
         isSelectedMlLcToPKPi = false;
         isSelectedMlLcToPiKP = false;
+        outputMlLcToPKPi.clear();
+        outputMlLcToPiKP.clear();
 
         if constexpr (ReconstructionType == aod::hf_cand::VertexerType::DCAFitter) {
-          if (pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && topolLcToPKPi) {
+          if (status.isCandLcToPKPi) {
             std::vector<float> inputFeaturesLcToPKPi = hfMlResponseDCA.getInputFeatures(candidate, true);
             isSelectedMlLcToPKPi = hfMlResponseDCA.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlLcToPKPi);
           }
-          if (pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && topolLcToPiKP) {
+          if (status.isCandLcToPiKP) {
             std::vector<float> inputFeaturesLcToPiKP = hfMlResponseDCA.getInputFeatures(candidate, false);
             isSelectedMlLcToPiKP = hfMlResponseDCA.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlLcToPiKP);
           }
         } else {
-          if (pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && topolLcToPKPi) {
+          if (status.isCandLcToPKPi) {
             std::vector<float> inputFeaturesLcToPKPi = hfMlResponseKF.getInputFeatures(candidate, true);
             isSelectedMlLcToPKPi = hfMlResponseKF.isSelectedMl(inputFeaturesLcToPKPi, candidate.pt(), outputMlLcToPKPi);
           }
-          if (pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && topolLcToPiKP) {
+          if (status.isCandLcToPiKP) {
             std::vector<float> inputFeaturesLcToPiKP = hfMlResponseKF.getInputFeatures(candidate, false);
             isSelectedMlLcToPiKP = hfMlResponseKF.isSelectedMl(inputFeaturesLcToPiKP, candidate.pt(), outputMlLcToPiKP);
           }
         }
 
         hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
+      }
 
-        if (!isSelectedMlLcToPKPi && !isSelectedMlLcToPiKP) {
-          hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
-          continue;
-        }
+      fillSelection(candidate, status, isSelectedMlLcToPKPi, isSelectedMlLcToPiKP);
+    }
+  }
 
-        if (activateQA) {
-          registry.fill(HIST("hSelections"), 2 + aod::SelectionStep::RecoMl, candidate.pt());
-        }
+  /// \brief function to apply Lc selections with the ML models evaluated once for all the candidates of the dataframe
+  /// \param candidates Lc candidate table
+  /// \param hfMlResponse is the ML response of the reconstruction type
+  template <bool UseBayesPid, aod::hf_cand::VertexerType ReconstructionType, typename TTracks, typename CandType, typename TMlResponse>
+  void runSelectLcBatchedMl(CandType const& candidates, TMlResponse& hfMlResponse)
+  {
+    // first pass: selections without ML and collection of the mass hypotheses to be evaluated
+    statusesBatch.clear();
+    rowsMl.clear();
+    casesLcToPKPiMl.clear();
+    ptCandsMl.clear();
+    for (const auto& candidate : candidates) {
+      auto& status = statusesBatch.emplace_back();
+      selectCandidate<UseBayesPid, ReconstructionType, TTracks>(candidate, status);
+      if (status.isCandLcToPKPi) {
+        rowsMl.push_back(candidate.filteredIndex());
+        casesLcToPKPiMl.push_back(1);
+        ptCandsMl.push_back(candidate.pt());
       }
+      if (status.isCandLcToPiKP) {
+        rowsMl.push_back(candidate.filteredIndex());
+        casesLcToPKPiMl.push_back(0);
+        ptCandsMl.push_back(candidate.pt());
+      }
+    }
 
-      if (pidLcToPKPi == 1 && pidBayesLcToPKPi == 1 && isSelectedMlLcToPKPi && topolLcToPKPi && trackQualitySel) {
-        statusLcToPKPi = 1; // identified as LcToPKPi
+    // input features gathered feature by feature and evaluated in one model call per bin
+    hfMlResponse.clearBatch();
+    hfMlResponse.getInputFeaturesColumnar(candidates, rowsMl, casesLcToPKPiMl, featureColumnsMl);
+    hfMlResponse.addColumnsToBatch(featureColumnsMl, ptCandsMl);
+    hfMlResponse.evalBatch();
+
+    // second pass: ML selections, in the same order as the candidates were added to the batch
+    std::size_t iCandBatch{0};
+    auto status = statusesBatch.begin();
+    for (const auto& candidate : candidates) {
+      bool isSelectedMlLcToPKPi = false;
+      bool isSelectedMlLcToPiKP = false;
+      outputMlLcToPKPi.clear();
+      outputMlLcToPiKP.clear();
+      if (status->isCandLcToPKPi) {
+        isSelectedMlLcToPKPi = hfMlResponse.isSelectedBatch(iCandBatch);
+        const auto scores = hfMlResponse.getBatchOutput(iCandBatch++);
+        outputMlLcToPKPi.assign(scores.begin(), scores.end());
       }
-      if (pidLcToPiKP == 1 && pidBayesLcToPiKP == 1 && isSelectedMlLcToPiKP && topolLcToPiKP && trackQualitySel) {
-        statusLcToPiKP = 1; // identified as LcToPiKP
+      if (status->isCandLcToPiKP) {
+        isSelectedMlLcToPiKP = hfMlResponse.isSelectedBatch(iCandBatch);
+        const auto scores = hfMlResponse.getBatchOutput(iCandBatch++);
+        outputMlLcToPiKP.assign(scores.begin(), scores.end());
       }
-
-      hfSelLcCandidate(statusLcToPKPi, statusLcToPiKP);
+      hfMlLcToPKPiCandidate(outputMlLcToPKPi, outputMlLcToPiKP);
+      fillSelection(candidate, *status, isSelectedMlLcToPKPi, isSelectedMlLcToPiKP);
+      ++status;
     }
   }
 
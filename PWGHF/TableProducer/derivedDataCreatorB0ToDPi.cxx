@@ -60,6 +60,8 @@ using namespace o2::hf_decay::hf_cand_beauty;
 struct HfDerivedDataCreatorB0ToDPi {
   HfProducesDerivedData<
     o2::aod::HfB0Bases,
+    o2::aod::HfB0PackedBases,
+    o2::aod::HfB0PackedMls,
     o2::aod::HfB0CollBases,
     o2::aod::HfB0CollIds,
     o2::aod::HfB0McCollBases,
@@ -217,6 +219,7 @@ struct HfDerivedDataCreatorB0ToDPi {
       rowCandidateMl(
         mlScore);
     }
+    rowsCommon.fillTablesCandidateMl(std::array<float, 1>{mlScore});
     if (fillCandidateMlDplus) {
       rowCandidateMlDplus(
         mlScoresCharm);
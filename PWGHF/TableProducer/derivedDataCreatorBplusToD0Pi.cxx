@@ -61,6 +61,8 @@ using namespace o2::hf_decay::hf_cand_beauty;
 struct HfDerivedDataCreatorBplusToD0Pi {
   HfProducesDerivedData<
     o2::aod::HfBplusBases,
+    o2::aod::HfBplusPackedBases,
+    o2::aod::HfBplusPackedMls,
     o2::aod::HfBplusCollBases,
     o2::aod::HfBplusCollIds,
     o2::aod::HfBplusMcCollBases,
@@ -253,6 +255,7 @@ struct HfDerivedDataCreatorBplusToD0Pi {
       rowCandidateMl(
         mlScore);
     }
+    rowsCommon.fillTablesCandidateMl(std::array<float, 1>{mlScore});
     if (fillCandidateMlD0) {
       rowCandidateMlD0(
         mlScoresCharm);
@@ -59,6 +59,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorD0ToKPi {
   HfProducesDerivedData<
     o2::aod::HfD0Bases,
+    o2::aod::HfD0PackedBases,
+    o2::aod::HfD0PackedMls,
     o2::aod::HfD0CollBases,
     o2::aod::HfD0CollIds,
     o2::aod::HfD0McCollBases,
@@ -144,6 +146,9 @@ struct HfDerivedDataCreatorD0ToKPi {
       LOGP(fatal, "Only one process function can be enabled at a time.");
     }
     rowsCommon.init(confDerData);
+    for (auto* enabled : {&fillCandidatePar, &fillCandidateParE, &fillCandidateSel, &fillCandidateMl, &fillCandidateId, &fillCandidateMc}) {
+      selectTable(*enabled, confDerData.tablesToFill.value);
+    }
   }
 
   template <typename T>
@@ -223,6 +228,7 @@ struct HfDerivedDataCreatorD0ToKPi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
@@ -58,6 +58,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorDplusToPiKPi {
   HfProducesDerivedData<
     o2::aod::HfDplusBases,
+    o2::aod::HfDplusPackedBases,
+    o2::aod::HfDplusPackedMls,
     o2::aod::HfDplusCollBases,
     o2::aod::HfDplusCollIds,
     o2::aod::HfDplusMcCollBases,
@@ -218,6 +220,7 @@ struct HfDerivedDataCreatorDplusToPiKPi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
@@ -58,6 +58,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorDsToKKPi {
   HfProducesDerivedData<
     o2::aod::HfDsBases,
+    o2::aod::HfDsPackedBases,
+    o2::aod::HfDsPackedMls,
     o2::aod::HfDsCollBases,
     o2::aod::HfDsCollIds,
     o2::aod::HfDsMcCollBases,
@@ -201,6 +203,7 @@ struct HfDerivedDataCreatorDsToKKPi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
@@ -56,6 +56,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorDstarToD0Pi {
   HfProducesDerivedData<
     o2::aod::HfDstarBases,
+    o2::aod::HfDstarPackedBases,
+    o2::aod::HfDstarPackedMls,
     o2::aod::HfDstarCollBases,
     o2::aod::HfDstarCollIds,
     o2::aod::HfDstarMcCollBases,
@@ -187,6 +189,7 @@ struct HfDerivedDataCreatorDstarToD0Pi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
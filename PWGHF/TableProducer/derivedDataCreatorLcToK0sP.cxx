@@ -58,6 +58,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorLcToK0sP {
   HfProducesDerivedData<
     o2::aod::HfLcToK0sPBases,
+    o2::aod::HfLcToK0sPPackedBases,
+    o2::aod::HfLcToK0sPPackedMls,
     o2::aod::HfLcToK0sPCollBases,
     o2::aod::HfLcToK0sPCollIds,
     o2::aod::HfLcToK0sPMcCollBases,
@@ -194,6 +196,7 @@ struct HfDerivedDataCreatorLcToK0sP {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
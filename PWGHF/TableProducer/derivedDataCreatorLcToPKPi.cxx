@@ -58,6 +58,8 @@ using namespace o2::analysis::hf_derived;
 struct HfDerivedDataCreatorLcToPKPi {
   HfProducesDerivedData<
     o2::aod::HfLcBases,
+    o2::aod::HfLcPackedBases,
+    o2::aod::HfLcPackedMls,
     o2::aod::HfLcCollBases,
     o2::aod::HfLcCollIds,
     o2::aod::HfLcMcCollBases,
@@ -126,6 +128,9 @@ struct HfDerivedDataCreatorLcToPKPi {
       LOGP(fatal, "Only one process function can be enabled at a time.");
     }
     rowsCommon.init(confDerData);
+    for (auto* enabled : {&fillCandidatePar, &fillCandidateParE, &fillCandidateSel, &fillCandidateMl, &fillCandidateId, &fillCandidateMc}) {
+      selectTable(*enabled, confDerData.tablesToFill.value);
+    }
   }
 
   template <typename T>
@@ -201,6 +206,7 @@ struct HfDerivedDataCreatorLcToPKPi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
@@ -59,6 +59,8 @@ using namespace o2::aod::hf_cand_xic_to_xi_pi_pi;
 struct HfDerivedDataCreatorXicToXiPiPi {
   HfProducesDerivedData<
     o2::aod::HfXicToXiPiPiBases,
+    o2::aod::HfXicToXiPiPiPackedBases,
+    o2::aod::HfXicToXiPiPiPackedMls,
     o2::aod::HfXicToXiPiPiCollBases,
     o2::aod::HfXicToXiPiPiCollIds,
     o2::aod::HfXicToXiPiPiMcCollBases,
@@ -200,6 +202,7 @@ struct HfDerivedDataCreatorXicToXiPiPi {
       rowCandidateMl(
         mlScores);
     }
+    rowsCommon.fillTablesCandidateMl(mlScores);
     if (fillCandidateId) {
       rowCandidateId(
         candidate.collisionId(),
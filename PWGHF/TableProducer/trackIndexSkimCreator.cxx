@@ -29,6 +29,8 @@
 #include "PWGHF/Utils/utilsAnalysis.h"
 #include "PWGHF/Utils/utilsBfieldCCDB.h"
 #include "PWGHF/Utils/utilsEvSelHf.h"
+#include "PWGHF/Utils/utilsPvRefit.h"
+#include "PWGHF/Utils/utilsTrkCandHf.h"
 #include "PWGLF/DataModel/LFStrangenessTables.h"
 
 #include "Common/CCDB/TriggerAliases.h"
@@ -48,11 +50,9 @@
 #include <CCDB/BasicCCDBManager.h> // for PV refit
 #include <CCDB/CcdbApi.h>
 #include <CommonConstants/PhysicsConstants.h>
-#include <CommonUtils/ConfigurableParam.h>
 #include <DCAFitter/DCAFitterN.h>
 #include <DetectorsBase/MatLayerCylSet.h>
-#include <DetectorsBase/Propagator.h>     // for PV refit
-#include <DetectorsVertexing/PVertexer.h> // for PV refit
+#include <DetectorsBase/Propagator.h> // for PV refit
 #include <Framework/ASoA.h>
 #include <Framework/AnalysisDataModel.h>
 #include <Framework/AnalysisHelpers.h>
@@ -78,9 +78,12 @@
 
 #include <algorithm> // std::find
 #include <array>
+#include <atomic>
 #include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <functional> // std::ref
+#include <future>
 #include <iterator> // std::distance
 #include <numeric>
 #include <string>  // std::string
@@ -295,6 +298,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     double etaMinDefault{-99999.};
     Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
     Configurable<bool> doPvRefit{"doPvRefit", false, "do PV refit excluding the considered track"};
+    Configurable<int> pvRefitMethod{"pvRefitMethod", 0, "PV refit method (0: PVertexer refit, 1: downdate of the PV fit in information-matrix form)"};
     Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
     Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
     // Configurable<double> bz{"bz", 5., "bz field"};
@@ -355,6 +359,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber{};
+  o2::hf_pv_refit::HfPvRefitter pvRefitter; // PV refit excluding the considered track
 
   using TracksWithSelAndDca = soa::Join<aod::TracksWCovDcaExtra, aod::TrackSelection>;
   using TracksWithSelAndDcaAndPidTpc = soa::Join<aod::TracksWCovDcaExtra, aod::TrackSelection, aod::pidTPCFullPr, aod::pidTPCFullKa, aod::pidTPCFullDe, aod::pidTPCFullTr, aod::pidTPCFullHe>;
@@ -937,65 +942,20 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
 
   /// Method for the PV refit and DCA recalculation for tracks with a collision assigned
   /// \param collision is a collision
-  /// \param bcWithTimeStamps is a table of bunch crossing joined with timestamps used to query the CCDB for B and material budget
-  /// \param vecPvContributorGlobId is a vector containing the global ID of PV contributors for the current collision
-  /// \param vecPvContributorTrackParCov is a vector containing the TrackParCov of PV contributors for the current collision
   /// \param trackToRemove is the track to be removed, if contributor, from the PV refit
   /// \param pvCoord is an array containing the coordinates of the refitted PV
   /// \param pvCovMatrix is an array containing the covariance matrix values of the refitted PV
   /// \param dcaXYdcaZ is an array containing the dcaXY and dcaZ of trackToRemove with respect to the refitted PV
   template <typename TTrack>
   void performPvRefitTrack(aod::Collision const& collision,
-                           aod::BCsWithTimestamps const&,
-                           std::vector<int64_t> const& vecPvContributorGlobId,
-                           std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
                            TTrack const& trackToRemove,
                            std::array<float, 3>& pvCoord,
                            std::array<float, 6>& pvCovMatrix,
                            std::array<float, 2>& dcaXYdcaZ)
   {
-    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
-
-    /// Prepare the vertex refitting
-    // set the magnetic field from CCDB
-    const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
-    initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
-    /*if (runNumber != bc.runNumber()) {
-
-      if (isRun2) { // Run 2 GRP object
-        o2::parameters::GRPObject* grpo = ccdb->getForTimeStamp<o2::parameters::GRPObject>(ccdbPathGrp, bc.timestamp());
-        if (grpo != nullptr) {
-          o2::base::Propagator::initFieldFromGRP(grpo);
-          o2::base::Propagator::Instance()->setMatLUT(lut);
-          LOGF(info, "Setting magnetic field to %d kG for run %d from its GRP CCDB object (type o2::parameters::GRPObject)", grpo->getNominalL3Field(), bc.runNumber());
-        } else {
-          LOGF(fatal, "Run 2 GRP object (type o2::parameters::GRPObject) is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
-        }
-      } else { // Run 3 GRP object
-        o2::parameters::GRPMagField* grpo = ccdb->getForTimeStamp<o2::parameters::GRPMagField>(ccdbPathGrpMag, bc.timestamp());
-        if (grpo != nullptr) {
-          o2::base::Propagator::initFieldFromGRP(grpo);
-          o2::base::Propagator::Instance()->setMatLUT(lut);
-          LOG(info) << "Setting magnetic field to current" << grpo->getL3Current() << " A for run" << bc.runNumber() << " from its GRP CCDB object (type o2::parameters::GRPMagField)";
-        } else {
-          LOGF(fatal, "Run 3 GRP object (type o2::parameters::GRPMagField) is not available in CCDB for run=%d at timestamp=%llu", bc.runNumber(), bc.timestamp());
-        }
-      }
-
-      runNumber = bc.runNumber();
-    }*/
-
-    // build the VertexBase to initialize the vertexer
-    o2::dataformats::VertexBase primVtx;
-    primVtx.setX(collision.posX());
-    primVtx.setY(collision.posY());
-    primVtx.setZ(collision.posZ());
-    primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-    // configure PVertexer
-    o2::vertexing::PVertexer vertexer;
-    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
-    vertexer.init();
-    const bool pvRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+    /// the PV contributors of the collision were prepared for the refit in pvRefitter
+    const o2::dataformats::VertexBase primVtx{getPrimaryVertex(collision)};
+    const bool pvRefitDoable = pvRefitter.isDoable();
     if (!pvRefitDoable) {
       LOG(info) << "Not enough tracks accepted for the refit";
       if (config.doPvRefit && config.fillHistograms) {
@@ -1003,7 +963,7 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
       }
     }
     if (config.debugPvRefit) {
-      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
+      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << pvRefitter.getNContributors() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
     }
 
     if (config.fillHistograms) {
@@ -1017,15 +977,11 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
     bool recalcImpPar = false;
     if (config.doPvRefit && pvRefitDoable) {
       recalcImpPar = true;
-      const auto trackIterator = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), trackToRemove.globalIndex()); /// track global index
-      if (trackIterator != vecPvContributorGlobId.end()) {
+      const int entry = pvRefitter.findContributor(trackToRemove.globalIndex()); /// track global index
+      if (entry >= 0) {
 
         /// this track contributed to the PV fit: let's do the refit without it
-        const int entry = std::distance(vecPvContributorGlobId.begin(), trackIterator);
-
-        vecPvRefitContributorUsed[entry] = false; /// remove the track from the PV refitting
-
-        const auto primVtxRefitted = vertexer.refitVertex(vecPvRefitContributorUsed, primVtx); // vertex refit
+        const auto primVtxRefitted = pvRefitter.refit({entry}); // vertex refit
         // LOG(info) << "refit " << cnt << "/" << ntr << " result = " << primVtxRefitted.asString();
         if (config.debugPvRefit) {
           LOG(info) << "refit for track with global index " << static_cast<int>(trackToRemove.globalIndex()) << " " << primVtxRefitted.asString();
@@ -1048,8 +1004,6 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
           registry.fill(HIST("PvRefit/hChi2vsNContrib"), primVtxRefitted.getNContributors(), primVtxRefitted.getChi2());
         }
 
-        vecPvRefitContributorUsed[entry] = true; /// restore the track for the next PV refitting (probably not necessary here)
-
         if (recalcImpPar) {
           // fill the histograms for refitted PV with good Chi2
           const double deltaX = primVtx.getX() - primVtxRefitted.getX();
@@ -1131,13 +1085,14 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
                        TTracks const& tracks,
                        GroupedTrackIndices const& trackIndicesCollision,
                        GroupedPvContributors const& pvContrCollision,
-                       aod::BCsWithTimestamps const& bcWithTimeStamps,
+                       aod::BCsWithTimestamps const& /*bcWithTimeStamps*/,
                        std::vector<std::array<float, 2>>& pvRefitDcaPerTrack,
                        std::vector<std::array<float, 3>>& pvRefitPvCoordPerTrack,
                        std::vector<std::array<float, 6>>& pvRefitPvCovMatrixPerTrack)
   {
     const auto thisCollId = collision.globalIndex();
     auto tracksWithItsPid = soa::Attach<TTracks, aod::pidits::ITSNSigmaDe, aod::pidits::ITSNSigmaTr, aod::pidits::ITSNSigmaHe, aod::pidits::ITSNSigmaAl>(tracks);
+    bool isPvRefitPrepared{false}; // the PV contributors are prepared for the refit once per collision, at the first PV refit
 
     for (const auto& trackId : trackIndicesCollision) {
       int statusProng = BIT(CandidateType::NCandidateTypes) - 1; // all bits on
@@ -1156,20 +1111,29 @@ struct HfTrackIndexSkimCreatorTagSelTracks {
         pvRefitPvCoord = {collision.posX(), collision.posY(), collision.posZ()};
         pvRefitPvCovMatrix = {collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()};
 
-        /// retrieve PV contributors for the current collision
-        std::vector<int64_t> vecPvContributorGlobId{};
-        std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
-
-        for (const auto& contributor : pvContrCollision) {
-          vecPvContributorGlobId.push_back(contributor.globalIndex());
-          vecPvContributorTrackParCov.push_back(getTrackParCov(contributor));
+        if (!isPvRefitPrepared) {
+          // set the magnetic field from CCDB
+          const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
+          initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
+
+          /// retrieve PV contributors for the current collision
+          std::vector<int64_t> vecPvContributorGlobId{};
+          std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
+          for (const auto& contributor : pvContrCollision) {
+            vecPvContributorGlobId.push_back(contributor.globalIndex());
+            vecPvContributorTrackParCov.push_back(getTrackParCov(contributor));
+          }
+          if (config.debugPvRefit) {
+            LOG(info) << "### vecPvContributorGlobId.size()=" << vecPvContributorGlobId.size() << ", vecPvContributorTrackParCov.size()=" << vecPvContributorTrackParCov.size() << ", N. original contributors=" << collision.numContrib();
+          }
+          pvRefitter.prepare(getPrimaryVertex(collision), vecPvContributorGlobId, vecPvContributorTrackParCov, config.pvRefitMethod);
+          isPvRefitPrepared = true;
         }
         if (config.debugPvRefit) {
-          LOG(info) << "### vecPvContributorGlobId.size()=" << vecPvContributorGlobId.size() << ", vecPvContributorTrackParCov.size()=" << vecPvContributorTrackParCov.size() << ", N. original contributors=" << collision.numContrib();
           /// Perform the PV refit only for tracks with an assigned collision
           LOG(info) << "[BEFORE performPvRefitTrack] track.collision().globalIndex(): " << collision.globalIndex();
         }
-        performPvRefitTrack(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
+        performPvRefitTrack(collision, track, pvRefitPvCoord, pvRefitPvCovMatrix, pvRefitDcaXYDcaZ);
         // we subtract the offset since trackIdx is the global index referred to the total track table
         const auto trackIdx = track.globalIndex();
         pvRefitDcaPerTrack[trackIdx] = pvRefitDcaXYDcaZ;
@@ -1390,6 +1354,9 @@ struct HfTrackIndexSkimCreator {
   // Tables with ML scores for HF Filters
   Produces<aod::Hf2ProngMlProbs> rowTrackIndexMlScoreProng2;
   Produces<aod::Hf3ProngMlProbs> rowTrackIndexMlScoreProng3;
+  // Tables with the secondary-vertex fits, reused by the candidate creators
+  Produces<aod::HfSvFit2Prong> rowProng2SvFit;
+  Produces<aod::HfSvFit3Prong> rowProng3SvFit;
 
   struct : ConfigurableGroup {
     Configurable<bool> isRun2{"isRun2", false, "enable Run 2 or Run 3 GRP objects for magnetic field"};
@@ -1397,6 +1364,7 @@ struct HfTrackIndexSkimCreator {
     Configurable<bool> doDstar{"doDstar", false, "do D* candidates"};
     Configurable<bool> debug{"debug", false, "debug mode"};
     Configurable<bool> debugPvRefit{"debugPvRefit", false, "debug lines for primary vertex refit"};
+    Configurable<int> pvRefitMethod{"pvRefitMethod", 0, "PV refit method (0: PVertexer refit, 1: downdate of the PV fit in information-matrix form)"};
     Configurable<bool> fillHistograms{"fillHistograms", true, "fill histograms"};
     // Configurable<int> nCollsMax{"nCollsMax", -1, "Max collisions per file"}; //can be added to run over limited collisions per file - for tesing purposes
     // preselection
@@ -1413,6 +1381,8 @@ struct HfTrackIndexSkimCreator {
     Configurable<double> maxDZIni{"maxDZIni", 4., "reject (if>0) PCA candidate if tracks DZ exceeds threshold"};
     Configurable<double> minParamChange{"minParamChange", 1.e-3, "stop iterations if largest change of any X is smaller than this"};
     Configurable<double> minRelChi2Change{"minRelChi2Change", 0.9, "stop iterations if chi2/chi2old > this"};
+    Configurable<bool> fillSvFitTables{"fillSvFitTables", false, "fill the tables with the secondary-vertex fits of the 2- and 3-prong candidates, reused by the candidate creators"};
+    Configurable<int> nThreadsVertexing{"nThreadsVertexing", 1, "Number of threads fitting the 3-prong vertices of each track pair (1: fits done in the combinatorial loop, ignored in debug mode)"};
     // CCDB
     Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
     Configurable<std::string> ccdbPathLut{"ccdbPathLut", "GLO/Param/MatLUT", "Path for LUT parametrization"};
@@ -1488,6 +1458,32 @@ struct HfTrackIndexSkimCreator {
   o2::base::MatLayerCylSet* lut{};
   o2::base::Propagator::MatCorrType noMatCorr = o2::base::Propagator::MatCorrType::USEMatCorrNONE;
   int runNumber{};
+  o2::hf_pv_refit::HfPvRefitter pvRefitter; // PV refit excluding the candidate daughters
+
+  /// Parameters of a skimmed track at the primary vertex of the collision being processed
+  struct TrackAtPv {
+    o2::track::TrackParCov trackParVar{}; // track parameters, propagated to the PV if the track is associated to another collision
+    std::array<float, 3> pVec{};          // momentum at the PV
+    std::array<float, 2> dcaInfo{};       // DCA in xy and z to the PV
+    bool isPropagated{false};             // whether the track was re-propagated to the PV
+  };
+  std::vector<TrackAtPv> tracksPosAtPv{}; // positive tracks of the collision for 2- and 3-prongs, in slice order
+  std::vector<TrackAtPv> tracksNegAtPv{}; // negative tracks of the collision for 2- and 3-prongs, in slice order
+
+  /// Outcome of a 3-prong vertex fit
+  struct Prong3Fit {
+    int pairId{-1};                                        // track pair of the combination, for the fits done ahead of the combinatorial loop
+    int nVtx{0};                                           // number of vertices found by the fitter, -1 if it threw
+    o2::vertexing::DCAFitterN<3>::Vec3D secondaryVertex{}; // PCA of the three tracks
+    std::array<o2::track::TrackParCov, 3> tracksAtPca{};   // tracks propagated to the PCA
+    float chi2Pca{0.f};                                    // chi2 at the PCA
+    std::array<float, 6> covPca{};                         // flat covariance matrix of the PCA, computed only to fill the secondary-vertex fit table
+  };
+  static constexpr std::size_t MinFitsPerThread{8};          // minimum number of queued fits per thread of the multi-threaded vertexing
+  std::vector<o2::vertexing::DCAFitterN<3>> df3Workers{};    // 3-prong vertex fitters of the worker threads
+  std::vector<std::pair<bool, int>> queued3ProngFits{};      // combinations of a track pair with a third track (negative?, index in slice) to be fitted
+  std::vector<Prong3Fit> fits3ProngPos{};                    // 3-prong fits with a positive third track, indexed as tracksPosAtPv
+  std::vector<Prong3Fit> fits3ProngNeg{};                    // 3-prong fits with a negative third track, indexed as tracksNegAtPv
 
   // int nColls{0}; //can be added to run over limited collisions per file - for tesing purposes
 
@@ -1598,6 +1594,8 @@ struct HfTrackIndexSkimCreator {
     df3.setMinRelChi2Change(config.minRelChi2Change);
     df3.setUseAbsDCA(config.useAbsDCA);
     df3.setWeightedFinalPCA(config.useWeightedFinalPCA);
+    // the fitters of the worker threads share the configuration of the main one
+    df3Workers.assign(std::max(config.nThreadsVertexing.value, 1) - 1, df3);
 
     ccdb->setURL(config.ccdbUrl);
     ccdb->setCaching(true);
@@ -1978,6 +1976,85 @@ struct HfTrackIndexSkimCreator {
     }
   }
 
+  /// Method to fill the secondary-vertex fit table of the 2-prong candidates with the current fit of the 2-prong fitter
+  /// \param isReusable whether the fit was done with the tracks at their default collision
+  void fillSvFit2Prong(const bool isReusable)
+  {
+    std::array<float, hf_trkcandsel::NValuesTrackAtPca> prong0AtPca{};
+    std::array<float, hf_trkcandsel::NValuesTrackAtPca> prong1AtPca{};
+    hf_trkcandsel::flattenTrackAtPca(df2.getTrack(0), prong0AtPca.data());
+    hf_trkcandsel::flattenTrackAtPca(df2.getTrack(1), prong1AtPca.data());
+    const auto& secondaryVertex = df2.getPCACandidate();
+    auto covPca = df2.calcPCACovMatrixFlat();
+    rowProng2SvFit(isReusable, secondaryVertex[0], secondaryVertex[1], secondaryVertex[2], covPca.data(), df2.getChi2AtPCACandidate(), prong0AtPca.data(), prong1AtPca.data());
+  }
+
+  /// Method to fill the secondary-vertex fit table of the 3-prong candidates
+  /// \param fit is the 3-prong fit
+  /// \param isReusable whether the fit was done with the tracks at their default collision
+  void fillSvFit3Prong(Prong3Fit& fit, const bool isReusable)
+  {
+    std::array<std::array<float, hf_trkcandsel::NValuesTrackAtPca>, 3> prongsAtPca{};
+    for (std::size_t iProng = 0; iProng < prongsAtPca.size(); iProng++) {
+      hf_trkcandsel::flattenTrackAtPca(fit.tracksAtPca[iProng], prongsAtPca[iProng].data());
+    }
+    rowProng3SvFit(isReusable, fit.secondaryVertex[0], fit.secondaryVertex[1], fit.secondaryVertex[2], fit.covPca.data(), fit.chi2Pca, prongsAtPca[0].data(), prongsAtPca[1].data(), prongsAtPca[2].data());
+  }
+
+  /// Method to fit the vertex of a 3-prong combination and keep the outcome
+  /// \param fitter is the 3-prong vertex fitter
+  /// \param trackParVar0 is the first daughter track
+  /// \param trackParVar1 is the second daughter track
+  /// \param trackParVar2 is the third daughter track
+  /// \param fit is filled with the number of vertices, the PCA and the tracks at the PCA
+  /// \param calcCovPca whether to compute the covariance matrix of the PCA
+  static void fit3Prong(o2::vertexing::DCAFitterN<3>& fitter, const o2::track::TrackParCov& trackParVar0, const o2::track::TrackParCov& trackParVar1, const o2::track::TrackParCov& trackParVar2, Prong3Fit& fit, const bool calcCovPca)
+  {
+    try {
+      fit.nVtx = fitter.process(trackParVar0, trackParVar1, trackParVar2);
+    } catch (...) {
+      fit.nVtx = -1;
+      return;
+    }
+    if (fit.nVtx > 0) {
+      fit.secondaryVertex = fitter.getPCACandidate();
+      fit.chi2Pca = fitter.getChi2AtPCACandidate();
+      if (calcCovPca) {
+        fit.covPca = fitter.calcPCACovMatrixFlat();
+      }
+      for (int iProng = 0; iProng < 3; iProng++) { // o2-linter: disable="magic-number" (3 prongs)
+        fit.tracksAtPca[iProng] = fitter.getTrack(iProng);
+      }
+    }
+  }
+
+  /// Method to fit the queued 3-prong combinations of a track pair with a pool of threads, one vertex fitter per thread
+  /// \param trackParVarPos is the positive track of the pair
+  /// \param trackParVarNeg is the negative track of the pair
+  void fitQueued3Prongs(const o2::track::TrackParCov& trackParVarPos, const o2::track::TrackParCov& trackParVarNeg)
+  {
+    std::atomic<std::size_t> nextFit{0};
+    auto worker = [&](o2::vertexing::DCAFitterN<3>& fitter) {
+      for (std::size_t iFit = nextFit++; iFit < queued3ProngFits.size(); iFit = nextFit++) {
+        const auto& [isNegThird, iThird] = queued3ProngFits[iFit];
+        if (isNegThird) {
+          fit3Prong(fitter, trackParVarNeg, trackParVarPos, tracksNegAtPv[iThird].trackParVar, fits3ProngNeg[iThird], config.fillSvFitTables);
+        } else {
+          fit3Prong(fitter, trackParVarPos, trackParVarNeg, tracksPosAtPv[iThird].trackParVar, fits3ProngPos[iThird], config.fillSvFitTables);
+        }
+      }
+    };
+    const std::size_t nWorkers = std::min(df3Workers.size(), queued3ProngFits.size() / MinFitsPerThread);
+    std::vector<std::future<void>> workers;
+    for (std::size_t iWorker = 0; iWorker < nWorkers; iWorker++) {
+      workers.push_back(std::async(std::launch::async, worker, std::ref(df3Workers[iWorker])));
+    }
+    worker(df3);
+    for (auto& result : workers) {
+      result.get();
+    }
+  }
+
   /// Method to perform selections for 2-prong candidates after vertex reconstruction
   /// \param secVtx is the secondary vertex
   /// \param primVtx is the primary vertex
@@ -2170,38 +2247,17 @@ struct HfTrackIndexSkimCreator {
 
   /// Method for the PV refit excluding the candidate daughters
   /// \param collision is a collision
-  /// \param bcWithTimeStamps is a table of bunch crossing joined with timestamps used to query the CCDB for B and material budget
-  /// \param vecPvContributorGlobId is a vector containing the global ID of PV contributors for the current collision
-  /// \param vecPvContributorTrackParCov is a vector containing the TrackParCov of PV contributors for the current collision
   /// \param vecCandPvContributorGlobId is a vector containing the global indices of daughter tracks that contributed to the original PV refit
   /// \param pvCoord is a vector where to store X, Y and Z values of refitted PV
   /// \param pvCovMatrix is a vector where to store the covariance matrix values of refitted PV
   void performPvRefitCandProngs(SelectedCollisions::iterator const& collision,
-                                aod::BCsWithTimestamps const&,
-                                std::vector<int64_t> const& vecPvContributorGlobId,
-                                std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
                                 std::vector<int64_t> const& vecCandPvContributorGlobId,
                                 std::array<float, 3>& pvCoord,
                                 std::array<float, 6>& pvCovMatrix)
   {
-    std::vector<bool> vecPvRefitContributorUsed(vecPvContributorGlobId.size(), true);
-
-    /// Prepare the vertex refitting
-    // set the magnetic field from CCDB
-    const auto bc = collision.bc_as<o2::aod::BCsWithTimestamps>();
-    initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
-
-    // build the VertexBase to initialize the vertexer
-    o2::dataformats::VertexBase primVtx;
-    primVtx.setX(collision.posX());
-    primVtx.setY(collision.posY());
-    primVtx.setZ(collision.posZ());
-    primVtx.setCov(collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ());
-    // configure PVertexer
-    o2::vertexing::PVertexer vertexer;
-    o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
-    vertexer.init();
-    const bool pvRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, primVtx);
+    /// the PV contributors of the collision were prepared for the refit in pvRefitter
+    const o2::dataformats::VertexBase primVtx{getPrimaryVertex(collision)};
+    const bool pvRefitDoable = pvRefitter.isDoable();
     if (!pvRefitDoable) {
       LOG(info) << "Not enough tracks accepted for the refit";
       if ((doprocess2And3ProngsWithPvRefit || doprocess2And3ProngsWithPvRefitWithPidForHfFiltersBdt) && config.fillHistograms) {
@@ -2209,7 +2265,7 @@ struct HfTrackIndexSkimCreator {
       }
     }
     if (config.debugPvRefit) {
-      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << vecPvContributorTrackParCov.size() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
+      LOG(info) << "prepareVertexRefit = " << pvRefitDoable << " Ncontrib= " << pvRefitter.getNContributors() << " Ntracks= " << collision.numContrib() << " Vtx= " << primVtx.asString();
     }
 
     /// PV refitting, if the tracks contributed to this at the beginning
@@ -2219,22 +2275,21 @@ struct HfTrackIndexSkimCreator {
         registry.fill(HIST("PvRefit/verticesPerCandidate"), 2);
       }
       bool recalcPvRefit = true;
-      int nCandContr = 0;
-      for (const uint64_t myGlobalID : vecCandPvContributorGlobId) {                                              // o2-linter: disable=const-ref-in-for-loop (small type)
-        auto trackIterator = std::find(vecPvContributorGlobId.begin(), vecPvContributorGlobId.end(), myGlobalID); /// track global index
-        if (trackIterator != vecPvContributorGlobId.end()) {
+      std::vector<int> vecCandPvContributorEntry{};
+      for (const int64_t myGlobalID : vecCandPvContributorGlobId) { // o2-linter: disable=const-ref-in-for-loop (small type)
+        const int entry = pvRefitter.findContributor(myGlobalID);  /// track global index
+        if (entry >= 0) {
           /// this is a contributor, let's remove it for the PV refit
-          const int entry = std::distance(vecPvContributorGlobId.begin(), trackIterator);
-          vecPvRefitContributorUsed[entry] = false; /// remove the track from the PV refitting
-          nCandContr++;
+          vecCandPvContributorEntry.push_back(entry);
         }
       }
+      const int nCandContr = vecCandPvContributorEntry.size();
 
       /// do the PV refit excluding the candidate daughters that originally contributed to fit it
       if (config.debugPvRefit) {
         LOG(info) << "### PV refit after removing " << nCandContr << " tracks";
       }
-      auto primVtxRefitted = vertexer.refitVertex(vecPvRefitContributorUsed, primVtx); // vertex refit
+      auto primVtxRefitted = pvRefitter.refit(vecCandPvContributorEntry); // vertex refit
       // LOG(info) << "refit " << cnt << "/" << ntr << " result = " << primVtxRefitted.asString();
       // LOG(info) << "refit for track with global index " << static_cast<int>(myTrack.globalIndex()) << " " << primVtxRefitted.asString();
       if (primVtxRefitted.getChi2() < 0) {
@@ -2300,7 +2355,7 @@ struct HfTrackIndexSkimCreator {
 
   template <bool DoPvRefit, bool UsePidForHfFiltersBdt, typename TTracks>
   void run2And3Prongs(SelectedCollisions const& collisions,
-                      aod::BCsWithTimestamps const& bcWithTimeStamps,
+                      aod::BCsWithTimestamps const&,
                       FilteredTrackAssocSel const&,
                       TTracks const& tracks)
   {
@@ -2321,7 +2376,6 @@ struct HfTrackIndexSkimCreator {
       /// retrieve PV contributors for the current collision
       std::vector<int64_t> vecPvContributorGlobId{};
       std::vector<o2::track::TrackParCov> vecPvContributorTrackParCov{};
-      std::vector<bool> vecPvRefitContributorUsed{};
       if constexpr (DoPvRefit) {
         auto groupedTracksUnfiltered = tracks.sliceBy(tracksPerCollision, collision.globalIndex());
         const int nTrk = groupedTracksUnfiltered.size();
@@ -2347,7 +2401,6 @@ struct HfTrackIndexSkimCreator {
             LOG(info) << "!!! Some problem here !!! vecPvContributorTrackParCov.size()= " << vecPvContributorTrackParCov.size() << ", nContrib=" << nContrib << ", collision.numContrib()" << collision.numContrib();
           }
         }
-        vecPvRefitContributorUsed = std::vector<bool>(vecPvContributorGlobId.size(), true);
       }
 
       // auto centrality = collision.centV0M(); //FIXME add centrality when option for variations to the process function appears
@@ -2377,6 +2430,12 @@ struct HfTrackIndexSkimCreator {
       initCCDB(bc, runNumber, ccdb, config.isRun2 ? config.ccdbPathGrp : config.ccdbPathGrpMag, lut, config.isRun2);
       df2.setBz(o2::base::Propagator::Instance()->getNominalBz());
       df3.setBz(o2::base::Propagator::Instance()->getNominalBz());
+      for (auto& fitter : df3Workers) {
+        fitter.setBz(o2::base::Propagator::Instance()->getNominalBz());
+      }
+      if constexpr (DoPvRefit) {
+        pvRefitter.prepare(getPrimaryVertex(collision), vecPvContributorGlobId, vecPvContributorTrackParCov, config.pvRefitMethod);
+      }
 
       // used to calculate number of candidiates per event
       auto nCand2 = rowTrackIndexProng2.lastIndex();
@@ -2389,10 +2448,37 @@ struct HfTrackIndexSkimCreator {
 
       const auto thisCollId = collision.globalIndex();
 
-      // first loop over positive tracks
       const auto groupedTrackIndicesPos1 = positiveFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+      const auto groupedTrackIndicesNeg1 = negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+
+      // get the parameters of the tracks at the PV once per collision instead of once per combination
+      auto fillTracksAtPv = [&](const auto& groupedTrackIndices, std::vector<TrackAtPv>& tracksAtPv) {
+        tracksAtPv.clear();
+        tracksAtPv.reserve(groupedTrackIndices.size());
+        for (const auto& trackIndex : groupedTrackIndices) {
+          const auto track = trackIndex.template track_as<TTracks>();
+          auto& trackAtPv = tracksAtPv.emplace_back();
+          trackAtPv.trackParVar = getTrackParCov(track);
+          trackAtPv.pVec = track.pVector();
+          trackAtPv.dcaInfo = {track.dcaXY(), track.dcaZ()};
+          if (thisCollId != track.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
+            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackAtPv.trackParVar, 2.f, noMatCorr, &trackAtPv.dcaInfo);
+            getPxPyPz(trackAtPv.trackParVar, trackAtPv.pVec);
+            trackAtPv.isPropagated = true;
+          }
+        }
+      };
+      fillTracksAtPv(groupedTrackIndicesPos1, tracksPosAtPv);
+      fillTracksAtPv(groupedTrackIndicesNeg1, tracksNegAtPv);
+      fits3ProngPos.assign(tracksPosAtPv.size(), Prong3Fit{});
+      fits3ProngNeg.assign(tracksNegAtPv.size(), Prong3Fit{});
+      const bool doMultiThreadedVertexing = config.do3Prong && !df3Workers.empty() && !config.debug;
+      int pairId = -1; // counter of the track pairs for which the 3-prong fits are done ahead of the combinatorial loop
+
+      // first loop over positive tracks
       int lastFilledD0 = -1; // index to be filled in table for D* mesons
-      for (auto trackIndexPos1 = groupedTrackIndicesPos1.begin(); trackIndexPos1 != groupedTrackIndicesPos1.end(); ++trackIndexPos1) {
+      int iPos1 = 0;
+      for (auto trackIndexPos1 = groupedTrackIndicesPos1.begin(); trackIndexPos1 != groupedTrackIndicesPos1.end(); ++trackIndexPos1, ++iPos1) {
         const auto trackPos1 = trackIndexPos1.template track_as<TTracks>();
 
         // retrieve the selection flag that corresponds to this collision
@@ -2400,17 +2486,13 @@ struct HfTrackIndexSkimCreator {
         const bool sel2ProngStatusPos = TESTBIT(isSelProngPos1, CandidateType::Cand2Prong);
         const bool sel3ProngStatusPos1 = TESTBIT(isSelProngPos1, CandidateType::Cand3Prong);
 
-        auto trackParVarPos1 = getTrackParCov(trackPos1);
-        std::array pVecTrackPos1{trackPos1.pVector()};
-        std::array dcaInfoPos1{trackPos1.dcaXY(), trackPos1.dcaZ()};
-        if (thisCollId != trackPos1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-          o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos1, 2.f, noMatCorr, &dcaInfoPos1);
-          getPxPyPz(trackParVarPos1, pVecTrackPos1);
-        }
+        const auto& trackParVarPos1 = tracksPosAtPv[iPos1].trackParVar;
+        const auto& pVecTrackPos1 = tracksPosAtPv[iPos1].pVec;
+        const auto& dcaInfoPos1 = tracksPosAtPv[iPos1].dcaInfo;
 
         // first loop over negative tracks
-        const auto groupedTrackIndicesNeg1 = negativeFor2And3Prongs->sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
-        for (auto trackIndexNeg1 = groupedTrackIndicesNeg1.begin(); trackIndexNeg1 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg1) {
+        int iNeg1 = 0;
+        for (auto trackIndexNeg1 = groupedTrackIndicesNeg1.begin(); trackIndexNeg1 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg1, ++iNeg1) {
           const auto trackNeg1 = trackIndexNeg1.template track_as<TTracks>();
 
           // retrieve the selection flag that corresponds to this collision
@@ -2418,13 +2500,9 @@ struct HfTrackIndexSkimCreator {
           const bool sel2ProngStatusNeg = TESTBIT(isSelProngNeg1, CandidateType::Cand2Prong);
           const bool sel3ProngStatusNeg1 = TESTBIT(isSelProngNeg1, CandidateType::Cand3Prong);
 
-          auto trackParVarNeg1 = getTrackParCov(trackNeg1);
-          std::array pVecTrackNeg1{trackNeg1.pVector()};
-          std::array dcaInfoNeg1{trackNeg1.dcaXY(), trackNeg1.dcaZ()};
-          if (thisCollId != trackNeg1.collisionId()) { // this is not the "default" collision for this track, we have to re-propagate it
-            o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg1, 2.f, noMatCorr, &dcaInfoNeg1);
-            getPxPyPz(trackParVarNeg1, pVecTrackNeg1);
-          }
+          const auto& trackParVarNeg1 = tracksNegAtPv[iNeg1].trackParVar;
+          const auto& pVecTrackNeg1 = tracksNegAtPv[iNeg1].pVec;
+          const auto& dcaInfoNeg1 = tracksNegAtPv[iNeg1].dcaInfo;
 
           uint isSelected2ProngCand = n2ProngBit; // bitmap for checking status of two-prong candidates (1 is true, 0 is rejected)
 
@@ -2497,7 +2575,7 @@ struct HfTrackIndexSkimCreator {
                     if (config.debugPvRefit) {
                       LOG(info) << "### [2 Prong] Calling performPvRefitCandProngs for HF 2 prong candidate";
                     }
-                    performPvRefitCandProngs(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, {trackPos1.globalIndex(), trackNeg1.globalIndex()}, pvRefitCoord2Prong, pvRefitCovMatrix2Prong);
+                    performPvRefitCandProngs(collision, {trackPos1.globalIndex(), trackNeg1.globalIndex()}, pvRefitCoord2Prong, pvRefitCovMatrix2Prong);
                   } else if (nCandContr == 1) {
                     /// Only one daughter was a contributor, let's use then the PV recalculated by excluding only it
                     if (config.debugPvRefit) {
@@ -2550,6 +2628,9 @@ struct HfTrackIndexSkimCreator {
                 if (isSelected2ProngCand > 0) {
                   // fill table row
                   rowTrackIndexProng2(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), isSelected2ProngCand);
+                  if (config.fillSvFitTables) {
+                    fillSvFit2Prong(!tracksPosAtPv[iPos1].isPropagated && !tracksNegAtPv[iNeg1].isPropagated);
+                  }
                   if (config.applyMlForHfFilters) {
                     rowTrackIndexMlScoreProng2(mlScoresD0);
                   }
@@ -2632,8 +2713,47 @@ struct HfTrackIndexSkimCreator {
           }
 
           if (config.do3Prong && is2ProngCandidateGoodFor3Prong) { // if 3 prongs are enabled and the first 2 tracks are selected for the 3-prong channels
+            if (doMultiThreadedVertexing) {
+              // queue the combinations passing the same preselections as in the loops below and fit them in parallel
+              pairId++;
+              queued3ProngFits.clear();
+              int whichHypoQueued[kN3ProngDecays];
+              if (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexNeg1.isIdentifiedPid(), ChannelKaonPid)) {
+                int iPos2 = iPos1 + 1;
+                for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2, ++iPos2) {
+                  uint isSelected3ProngCand = n3ProngBit;
+                  if (!TESTBIT(trackIndexPos2.isSelProng(), CandidateType::Cand3Prong)) {
+                    continue;
+                  }
+                  applyPreselection3Prong(pVecTrackPos1, pVecTrackNeg1, tracksPosAtPv[iPos2].pVec, trackIndexPos1.isIdentifiedPid(), trackIndexPos2.isIdentifiedPid(), cutStatus3Prong, whichHypoQueued, isSelected3ProngCand);
+                  if (isSelected3ProngCand != 0) {
+                    fits3ProngPos[iPos2].pairId = pairId;
+                    queued3ProngFits.emplace_back(false, iPos2);
+                  }
+                }
+              }
+              if (!config.applyKaonPidIn3Prongs || TESTBIT(trackIndexPos1.isIdentifiedPid(), ChannelKaonPid)) {
+                int iNeg2 = iNeg1 + 1;
+                for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2, ++iNeg2) {
+                  int isSelected3ProngCand = n3ProngBit;
+                  if (!TESTBIT(trackIndexNeg2.isSelProng(), CandidateType::Cand3Prong)) {
+                    continue;
+                  }
+                  int8_t const isIdentifiedPidTrackNeg1 = trackIndexNeg1.isIdentifiedPid();
+                  int8_t const isIdentifiedPidTrackNeg2 = trackIndexNeg2.isIdentifiedPid();
+                  applyPreselection3Prong(pVecTrackNeg1, pVecTrackPos1, tracksNegAtPv[iNeg2].pVec, isIdentifiedPidTrackNeg1, isIdentifiedPidTrackNeg2, cutStatus3Prong, whichHypoQueued, isSelected3ProngCand);
+                  if (isSelected3ProngCand != 0) {
+                    fits3ProngNeg[iNeg2].pairId = pairId;
+                    queued3ProngFits.emplace_back(true, iNeg2);
+                  }
+                }
+              }
+              fitQueued3Prongs(trackParVarPos1, trackParVarNeg1);
+            }
+
             // second loop over positive tracks
-            for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2) {
+            int iPos2 = iPos1 + 1;
+            for (auto trackIndexPos2 = trackIndexPos1 + 1; trackIndexPos2 != groupedTrackIndicesPos1.end(); ++trackIndexPos2, ++iPos2) {
 
               uint isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexPos2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2652,16 +2772,16 @@ struct HfTrackIndexSkimCreator {
 
               const auto trackPos2 = trackIndexPos2.template track_as<TTracks>();
 
-              auto trackParVarPos2 = getTrackParCov(trackPos2);
-              std::array dcaInfoPos2{trackPos2.dcaXY(), trackPos2.dcaZ()};
+              auto trackParVarPos2 = tracksPosAtPv[iPos2].trackParVar;
+              auto dcaInfoPos2 = tracksPosAtPv[iPos2].dcaInfo;
+              if (!isSelected3ProngCand && tracksPosAtPv[iPos2].isPropagated) { // debug mode: the rejected candidates are fitted with the parameters at the default collision
+                trackParVarPos2 = getTrackParCov(trackPos2);
+                dcaInfoPos2 = {trackPos2.dcaXY(), trackPos2.dcaZ()};
+              }
 
               // preselection of 3-prong candidates
               if (isSelected3ProngCand) {
-                std::array pVecTrackPos2{trackPos2.pVector()};
-                if (thisCollId != trackPos2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarPos2, 2.f, noMatCorr, &dcaInfoPos2);
-                  getPxPyPz(trackParVarPos2, pVecTrackPos2);
-                }
+                const auto& pVecTrackPos2 = tracksPosAtPv[iPos2].pVec;
 
                 if (config.debug) {
                   for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
@@ -2736,7 +2856,7 @@ struct HfTrackIndexSkimCreator {
                   if (config.debugPvRefit) {
                     LOG(info) << "### [3 prong] Calling performPvRefitCandProngs for HF 3 prong candidate, removing " << nCandContr << " daughters";
                   }
-                  performPvRefitCandProngs(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, vecCandPvContributorGlobId, pvRefitCoord3Prong2Pos1Neg, pvRefitCovMatrix3Prong2Pos1Neg);
+                  performPvRefitCandProngs(collision, vecCandPvContributorGlobId, pvRefitCoord3Prong2Pos1Neg, pvRefitCovMatrix3Prong2Pos1Neg);
                 } else if (nCandContr == 1) {
                   /// Only one daughter was a contributor, let's use then the PV recalculated by excluding only it
                   if (config.debugPvRefit) {
@@ -2769,26 +2889,23 @@ struct HfTrackIndexSkimCreator {
                 }
               }
 
-              // reconstruct the 3-prong secondary vertex
-              int nVtxFrom3ProngFitter = 0;
-              try {
-                nVtxFrom3ProngFitter = df3.process(trackParVarPos1, trackParVarNeg1, trackParVarPos2);
-              } catch (...) {
-                continue;
+              // reconstruct the 3-prong secondary vertex, unless already done by the multi-threaded vertexing
+              auto& fit3ProngPos = fits3ProngPos[iPos2];
+              if (!doMultiThreadedVertexing || fit3ProngPos.pairId != pairId) {
+                fit3Prong(df3, trackParVarPos1, trackParVarNeg1, trackParVarPos2, fit3ProngPos, config.fillSvFitTables);
               }
-
-              if (nVtxFrom3ProngFitter == 0) {
+              if (fit3ProngPos.nVtx <= 0) {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fit3ProngPos.secondaryVertex;
               // get track momenta
               std::array<float, 3> pvec0{};
               std::array<float, 3> pvec1{};
               std::array<float, 3> pvec2{};
-              const auto trackParVarPcaPos1 = df3.getTrack(0);
-              const auto trackParVarPcaNeg1 = df3.getTrack(1);
-              const auto trackParVarPcaPos2 = df3.getTrack(2);
+              const auto& trackParVarPcaPos1 = fit3ProngPos.tracksAtPca[0];
+              const auto& trackParVarPcaNeg1 = fit3ProngPos.tracksAtPca[1];
+              const auto& trackParVarPcaPos2 = fit3ProngPos.tracksAtPca[2];
               trackParVarPcaPos1.getPxPyPzGlo(pvec0);
               trackParVarPcaNeg1.getPxPyPzGlo(pvec1);
               trackParVarPcaPos2.getPxPyPzGlo(pvec2);
@@ -2818,6 +2935,9 @@ struct HfTrackIndexSkimCreator {
 
               // fill table row
               rowTrackIndexProng3(thisCollId, trackPos1.globalIndex(), trackNeg1.globalIndex(), trackPos2.globalIndex(), isSelected3ProngCand);
+              if (config.fillSvFitTables) {
+                fillSvFit3Prong(fit3ProngPos, !tracksPosAtPv[iPos1].isPropagated && !tracksNegAtPv[iNeg1].isPropagated && !tracksPosAtPv[iPos2].isPropagated);
+              }
               if (config.applyMlForHfFilters) {
                 rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
               }
@@ -2909,7 +3029,8 @@ struct HfTrackIndexSkimCreator {
             }
 
             // second loop over negative tracks
-            for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2) {
+            int iNeg2 = iNeg1 + 1;
+            for (auto trackIndexNeg2 = trackIndexNeg1 + 1; trackIndexNeg2 != groupedTrackIndicesNeg1.end(); ++trackIndexNeg2, ++iNeg2) {
 
               int isSelected3ProngCand = n3ProngBit;
               if (!TESTBIT(trackIndexNeg2.isSelProng(), CandidateType::Cand3Prong)) { // continue immediately
@@ -2927,16 +3048,16 @@ struct HfTrackIndexSkimCreator {
               }
 
               auto trackNeg2 = trackIndexNeg2.template track_as<TTracks>();
-              auto trackParVarNeg2 = getTrackParCov(trackNeg2);
-              std::array dcaInfoNeg2{trackNeg2.dcaXY(), trackNeg2.dcaZ()};
+              auto trackParVarNeg2 = tracksNegAtPv[iNeg2].trackParVar;
+              auto dcaInfoNeg2 = tracksNegAtPv[iNeg2].dcaInfo;
+              if (!isSelected3ProngCand && tracksNegAtPv[iNeg2].isPropagated) { // debug mode: the rejected candidates are fitted with the parameters at the default collision
+                trackParVarNeg2 = getTrackParCov(trackNeg2);
+                dcaInfoNeg2 = {trackNeg2.dcaXY(), trackNeg2.dcaZ()};
+              }
 
               // preselection of 3-prong candidates
               if (isSelected3ProngCand) {
-                std::array pVecTrackNeg2{trackNeg2.pVector()};
-                if (thisCollId != trackNeg2.collisionId()) { // this is not the "default" collision for this track and we still did not re-propagate it, we have to re-propagate it
-                  o2::base::Propagator::Instance()->propagateToDCABxByBz({collision.posX(), collision.posY(), collision.posZ()}, trackParVarNeg2, 2.f, noMatCorr, &dcaInfoNeg2);
-                  getPxPyPz(trackParVarNeg2, pVecTrackNeg2);
-                }
+                const auto& pVecTrackNeg2 = tracksNegAtPv[iNeg2].pVec;
 
                 if (config.debug) {
                   for (int iDecay3P = 0; iDecay3P < kN3ProngDecays; iDecay3P++) {
@@ -3011,7 +3132,7 @@ struct HfTrackIndexSkimCreator {
                   if (config.debugPvRefit) {
                     LOG(info) << "### [3 prong] Calling performPvRefitCandProngs for HF 3 prong candidate, removing " << nCandContr << " daughters";
                   }
-                  performPvRefitCandProngs(collision, bcWithTimeStamps, vecPvContributorGlobId, vecPvContributorTrackParCov, vecCandPvContributorGlobId, pvRefitCoord3Prong1Pos2Neg, pvRefitCovMatrix3Prong1Pos2Neg);
+                  performPvRefitCandProngs(collision, vecCandPvContributorGlobId, pvRefitCoord3Prong1Pos2Neg, pvRefitCovMatrix3Prong1Pos2Neg);
                 } else if (nCandContr == 1) {
                   /// Only one daughter was a contributor, let's use then the PV recalculated by excluding only it
                   if (config.debugPvRefit) {
@@ -3044,26 +3165,23 @@ struct HfTrackIndexSkimCreator {
                 }
               }
 
-              // reconstruct the 3-prong secondary vertex
-              int nVtxFrom3ProngFitterSecondLoop = 0;
-              try {
-                nVtxFrom3ProngFitterSecondLoop = df3.process(trackParVarNeg1, trackParVarPos1, trackParVarNeg2);
-              } catch (...) {
-                continue;
+              // reconstruct the 3-prong secondary vertex, unless already done by the multi-threaded vertexing
+              auto& fit3ProngNeg = fits3ProngNeg[iNeg2];
+              if (!doMultiThreadedVertexing || fit3ProngNeg.pairId != pairId) {
+                fit3Prong(df3, trackParVarNeg1, trackParVarPos1, trackParVarNeg2, fit3ProngNeg, config.fillSvFitTables);
               }
-
-              if (nVtxFrom3ProngFitterSecondLoop == 0) {
+              if (fit3ProngNeg.nVtx <= 0) {
                 continue;
               }
               // get secondary vertex
-              const auto& secondaryVertex3 = df3.getPCACandidate();
+              const auto& secondaryVertex3 = fit3ProngNeg.secondaryVertex;
               // get track momenta
               std::array<float, 3> pvec0{};
               std::array<float, 3> pvec1{};
               std::array<float, 3> pvec2{};
-              const auto trackParVarPcaNeg1 = df3.getTrack(0);
-              const auto trackParVarPcaPos1 = df3.getTrack(1);
-              const auto trackParVarPcaNeg2 = df3.getTrack(2);
+              const auto& trackParVarPcaNeg1 = fit3ProngNeg.tracksAtPca[0];
+              const auto& trackParVarPcaPos1 = fit3ProngNeg.tracksAtPca[1];
+              const auto& trackParVarPcaNeg2 = fit3ProngNeg.tracksAtPca[2];
               trackParVarPcaNeg1.getPxPyPzGlo(pvec0);
               trackParVarPcaPos1.getPxPyPzGlo(pvec1);
               trackParVarPcaNeg2.getPxPyPzGlo(pvec2);
@@ -3094,6 +3212,9 @@ struct HfTrackIndexSkimCreator {
 
               // fill table row
               rowTrackIndexProng3(thisCollId, trackNeg1.globalIndex(), trackPos1.globalIndex(), trackNeg2.globalIndex(), isSelected3ProngCand);
+              if (config.fillSvFitTables) {
+                fillSvFit3Prong(fit3ProngNeg, !tracksNegAtPv[iNeg1].isPropagated && !tracksPosAtPv[iPos1].isPropagated && !tracksNegAtPv[iNeg2].isPropagated);
+              }
               if (config.applyMlForHfFilters) {
                 rowTrackIndexMlScoreProng3(mlScores3Prongs[0], mlScores3Prongs[1], mlScores3Prongs[2], mlScores3Prongs[3]);
               }
@@ -22,6 +22,7 @@
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
 #include "PWGHF/Utils/utilsAnalysis.h"
+#include "PWGHF/Utils/utilsSampling.h"
 
 #include "Common/Core/RecoDecay.h"
 
@@ -243,6 +244,7 @@ struct HfTreeCreatorD0ToKPi {
   Configurable<float> downSampleBkgFactor{"downSampleBkgFactor", 1., "Fraction of background candidates to keep for ML trainings"};
   Configurable<float> ptMaxForDownSample{"ptMaxForDownSample", 10., "Maximum pt for the application of the downsampling factor"};
   Configurable<bool> fillCorrBkgs{"fillCorrBkgs", false, "Flag to fill derived tables with correlated background candidates"};
+  o2::analysis::hf_sampling::HfCandidateSampler sampler;
 
   // using TracksWPid = soa::Join<aod::Tracks, aod::TracksPidPi, aod::PidTpcTofFullPi, aod::TracksPidKa, aod::PidTpcTofFullKa>;
   using SelectedCandidatesMc = soa::Filtered<soa::Join<aod::HfCand2ProngWPid, aod::HfCand2ProngMcRec, aod::HfSelD0>>;
@@ -273,6 +275,7 @@ struct HfTreeCreatorD0ToKPi {
     if (std::accumulate(doprocess.begin(), doprocess.end(), 0) != 1) {
       LOGP(fatal, "Only one process function can be enabled at a time.");
     }
+    sampler.init();
   }
 
   template <typename T>
@@ -430,7 +433,12 @@ struct HfTreeCreatorD0ToKPi {
     if constexpr (ApplyMl) {
       rowCandidateMl.reserve(candidates.size());
     }
+    sampler.sample(candidates, [](const auto&) { return false; });
+    int64_t iCandidate{-1};
     for (const auto& candidate : candidates) {
+      if (!sampler.isSelected(++iCandidate)) {
+        continue;
+      }
       if (downSampleBkgFactor < 1.) {
         float const pseudoRndm = candidate.ptProng0() * 1000. - static_cast<int64_t>(candidate.ptProng0() * 1000);
         if (candidate.pt() < ptMaxForDownSample && pseudoRndm >= downSampleBkgFactor) {
@@ -518,7 +526,14 @@ struct HfTreeCreatorD0ToKPi {
     if constexpr (ApplyMl) {
       rowCandidateMl.reserve(candidates.size());
     }
+    sampler.sample(candidates, [this](const auto& cand) {
+      return std::abs(cand.flagMcMatchRec()) == o2::hf_decay::hf_cand_2prong::DecayChannelMain::D0ToPiK || (fillCorrBkgs && cand.flagMcMatchRec() != 0);
+    });
+    int64_t iCandidate{-1};
     for (const auto& candidate : candidates) {
+      if (!sampler.isSelected(++iCandidate)) {
+        continue;
+      }
       if constexpr (OnlyBkg) {
         if ((std::abs(candidate.flagMcMatchRec()) == o2::hf_decay::hf_cand_2prong::DecayChannelMain::D0ToPiK) || (fillCorrBkgs && (candidate.flagMcMatchRec() != 0))) {
           continue;
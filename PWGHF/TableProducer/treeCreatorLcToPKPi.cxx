@@ -22,6 +22,7 @@
 #include "PWGHF/DataModel/AliasTables.h"
 #include "PWGHF/DataModel/CandidateReconstructionTables.h"
 #include "PWGHF/DataModel/CandidateSelectionTables.h"
+#include "PWGHF/Utils/utilsSampling.h"
 
 #include "Common/Core/RecoDecay.h"
 #include "Common/DataModel/Centrality.h"
@@ -409,6 +410,7 @@ struct HfTreeCreatorLcToPKPi {
   Configurable<bool> keepCorrBkgMC{"keepCorrBkgMC", false, "Flag to keep correlated background sources (Λc+ -> p K− π+ π0, p π− π+, p K− K+ and other charm hadrons)"};
   Configurable<double> downSampleBkgFactor{"downSampleBkgFactor", 1., "Fraction of candidates to store in the tree"};
   Configurable<float> downSampleBkgPtMax{"downSampleBkgPtMax", 100.f, "Max. pt for background downsampling"};
+  o2::analysis::hf_sampling::HfCandidateSampler sampler;
 
   constexpr static float UndefValueFloat = -999.f;
   constexpr static int UndefValueInt = -999;
@@ -478,6 +480,7 @@ struct HfTreeCreatorLcToPKPi {
     if ((std::accumulate(processes.begin(), processes.begin() + 4, 0) != 0) && fillCandidateMcTable) {
       LOGP(fatal, "fillCandidateMcTable can be activated only in case of MC processing.");
     }
+    sampler.init();
   }
 
   /// \brief function to check when applyMl == true if the HfMlLcToPKPi size is equal to that of the table with candidates
@@ -956,10 +959,14 @@ struct HfTreeCreatorLcToPKPi {
     const int64_t candidatesSize = static_cast<int64_t>(candidates.size());
     reserveTables<ReconstructionType>(candidatesSize, IsMc);
 
+    sampler.sample(candidates, [](const auto& cand) { return std::abs(cand.flagMcMatchRec()) == o2::hf_decay::hf_cand_3prong::DecayChannelMain::LcToPKPi; });
     int iCand{0};
     for (const auto& candidate : candidates) {
       const auto candidateMlScore = candidateMlScores.rawIteratorAt(iCand);
       ++iCand;
+      if (!sampler.isSelected(iCand - 1)) {
+        continue;
+      }
       const float ptProng0 = candidate.ptProng0();
       const auto collision = candidate.template collision_as<Colls>();
       auto fillTable = [&](int candFlag) {
@@ -1146,10 +1153,14 @@ struct HfTreeCreatorLcToPKPi {
 
     // Filling candidate properties
 
+    sampler.sample(candidates, [](const auto&) { return false; });
     int iCand{0};
     for (const auto& candidate : candidates) {
       const auto candidateMlScore = candidateMlScores.rawIteratorAt(iCand);
       ++iCand;
+      if (!sampler.isSelected(iCand - 1)) {
+        continue;
+      }
       const float ptProng0 = candidate.ptProng0();
       const auto collision = candidate.template collision_as<Colls>();
       auto fillTable = [&](int candFlag) {
@@ -0,0 +1,134 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsDcaFitter.h
+/// \brief Pool of DCAFitterN instances and material LUT shared by the HF candidate creators
+///
+/// The fitters are configured once per (number of prongs, settings) and per thread, and shared by all the tasks of a
+/// device running in that thread. The magnetic field is propagated to all the fitters of the thread only when it changes.
+/// The material LUT is retrieved and rectified once per device.
+
+#ifndef PWGHF_UTILS_UTILSDCAFITTER_H_
+#define PWGHF_UTILS_UTILSDCAFITTER_H_
+
+#include <DCAFitter/DCAFitterN.h>
+#include <DetectorsBase/MatLayerCylSet.h>
+#include <Framework/Logger.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+namespace o2::hf_dca_fitter
+{
+
+/// Settings of a DCAFitterN, the default values are the ones of DCAFitterN
+struct HfDcaFitterSettings {
+  bool propagateToPCA{true};       // create tracks version propagated to PCA
+  double maxR{200.};               // reject PCA's above this radius
+  double maxDZIni{4.};             // reject (if>0) PCA candidate if tracks DZ exceeds threshold
+  double maxDXYIni{4.};            // reject (if>0) PCA candidate if tracks DXY exceeds threshold
+  double minParamChange{1.e-3};    // stop iterations if largest change of any X is smaller than this
+  double minRelChi2Change{0.9};    // stop iterations if chi2/chi2old > this
+  double maxChi2{100.};            // discard vertices with chi2/Nprongs > this (or sum{DCAi^2}/Nprongs for abs. distance minimization)
+  bool useAbsDCA{false};           // minimise abs. distance rather than chi2
+  bool useWeightedFinalPCA{false}; // recalculate vertex position using track covariances, effective only if useAbsDCA is true
+
+  auto key() const { return std::make_tuple(propagateToPCA, maxR, maxDZIni, maxDXYIni, minParamChange, minRelChi2Change, maxChi2, useAbsDCA, useWeightedFinalPCA); }
+  bool operator<(const HfDcaFitterSettings& other) const { return key() < other.key(); }
+};
+
+class HfDcaFitterPool
+{
+ public:
+  /// Get the fitter of the calling thread with the requested settings, created and configured at the first request
+  /// \param settings are the settings of the fitter
+  /// \return pointer to the shared fitter, valid for the lifetime of the thread
+  template <int NProngs>
+  static o2::vertexing::DCAFitterN<NProngs>* get(const HfDcaFitterSettings& settings)
+  {
+    auto& fitters = registry<NProngs>();
+    auto entry = fitters.find(settings);
+    if (entry != fitters.end()) {
+      return entry->second.get();
+    }
+    auto fitter = std::make_unique<o2::vertexing::DCAFitterN<NProngs>>();
+    fitter->setPropagateToPCA(settings.propagateToPCA);
+    fitter->setMaxR(settings.maxR);
+    fitter->setMaxDZIni(settings.maxDZIni);
+    fitter->setMaxDXYIni(settings.maxDXYIni);
+    fitter->setMinParamChange(settings.minParamChange);
+    fitter->setMinRelChi2Change(settings.minRelChi2Change);
+    fitter->setMaxChi2(settings.maxChi2);
+    fitter->setUseAbsDCA(settings.useAbsDCA);
+    fitter->setWeightedFinalPCA(settings.useWeightedFinalPCA);
+    fitter->setBz(bzThread());
+    LOGP(info, "Configured a shared {}-prong DCAFitterN ({} in this thread)", NProngs, fitters.size() + 1);
+    return (fitters[settings] = std::move(fitter)).get();
+  }
+
+  /// Set the magnetic field of all the fitters of the calling thread, if it changed
+  /// \param bz is the magnetic field along z (kG)
+  static void updateBz(const double bz)
+  {
+    if (bz == bzThread()) {
+      return;
+    }
+    bzThread() = bz;
+    setBzAll<2>(bz);
+    setBzAll<3>(bz);
+    setBzAll<4>(bz);
+  }
+
+  /// Get the material LUT, retrieved and rectified once per device
+  /// \param ccdb is the CCDB manager used to retrieve the LUT
+  /// \param path is the CCDB path of the LUT
+  template <typename TCCDB>
+  static o2::base::MatLayerCylSet* getMatLut(TCCDB& ccdb, const std::string& path)
+  {
+    static std::mutex mutex;
+    static std::map<std::string, o2::base::MatLayerCylSet*> luts;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& lut = luts[path];
+    if (!lut) {
+      lut = o2::base::MatLayerCylSet::rectifyPtrFromFile(ccdb->template get<o2::base::MatLayerCylSet>(path));
+    }
+    return lut;
+  }
+
+ private:
+  template <int NProngs>
+  static std::map<HfDcaFitterSettings, std::unique_ptr<o2::vertexing::DCAFitterN<NProngs>>>& registry()
+  {
+    thread_local std::map<HfDcaFitterSettings, std::unique_ptr<o2::vertexing::DCAFitterN<NProngs>>> fitters;
+    return fitters;
+  }
+
+  template <int NProngs>
+  static void setBzAll(const double bz)
+  {
+    for (auto& [settings, fitter] : registry<NProngs>()) {
+      fitter->setBz(bz);
+    }
+  }
+
+  static double& bzThread()
+  {
+    thread_local double bz{0.};
+    return bz;
+  }
+};
+
+} // namespace o2::hf_dca_fitter
+
+#endif // PWGHF_UTILS_UTILSDCAFITTER_H_
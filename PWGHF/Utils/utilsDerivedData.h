@@ -16,6 +16,8 @@
 #ifndef PWGHF_UTILS_UTILSDERIVEDDATA_H_
 #define PWGHF_UTILS_UTILSDERIVEDDATA_H_
 
+#include "PWGHF/DataModel/DerivedTables.h"
+
 #include "Common/Core/RecoDecay.h"
 
 #include <Framework/ASoA.h>
@@ -23,8 +25,10 @@
 #include <Framework/Configurable.h>
 #include <Framework/Logger.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <map>
+#include <string>
 #include <vector>
 
 // Macro to store nSigma for prong _id_ with PID hypothesis _hyp_ in an array
@@ -49,9 +53,26 @@ void reserveTable(TCursor& cursor,
   }
 }
 
+/// Apply the declarative selection of the filled tables to a fill switch.
+/// \param enabled  switch for filling the table, named "fill<Table>"
+/// \param tables  names of the tables to fill (e.g. "CandidateBase", "CollId"), the switch is left unchanged if empty
+inline void selectTable(o2::framework::Configurable<bool>& enabled,
+                        const std::vector<std::string>& tables)
+{
+  if (tables.empty()) {
+    return;
+  }
+  const auto name = enabled.name.substr(std::string("fill").size());
+  enabled.value = std::find(tables.begin(), tables.end(), name) != tables.end();
+  LOGF(info, "Table %s: %s", name.data(), enabled.value ? "filled" : "pruned");
+}
+
 struct HfConfigurableDerivedData : o2::framework::ConfigurableGroup {
+  o2::framework::Configurable<std::vector<std::string>> tablesToFill{"tablesToFill", {}, "Names of the tables to fill (e.g. CandidateBase, CandidatePar, CollBase), overriding the fill switches if not empty"};
   // Candidates
   o2::framework::Configurable<bool> fillCandidateBase{"fillCandidateBase", true, "Fill candidate base properties"};
+  o2::framework::Configurable<bool> fillCandidateBasePacked{"fillCandidateBasePacked", false, "Fill candidate base properties with reduced-precision kinematics"};
+  o2::framework::Configurable<bool> fillCandidateMlPacked{"fillCandidateMlPacked", false, "Fill candidate selection ML scores with reduced precision"};
   // Collisions
   o2::framework::Configurable<bool> fillCollBase{"fillCollBase", true, "Fill collision base properties"};
   o2::framework::Configurable<bool> fillCollId{"fillCollId", true, "Fill original collision indices"};
@@ -66,6 +87,8 @@ struct HfConfigurableDerivedData : o2::framework::ConfigurableGroup {
 
 template <
   typename HfBases,
+  typename HfPackedBases,
+  typename HfPackedMls,
   typename HfCollBases,
   typename HfCollIds,
   typename HfMcCollBases,
@@ -76,6 +99,8 @@ template <
 struct HfProducesDerivedData : o2::framework::ProducesGroup {
   // Candidates
   o2::framework::Produces<HfBases> rowCandidateBase;
+  o2::framework::Produces<HfPackedBases> rowCandidateBasePacked;
+  o2::framework::Produces<HfPackedMls> rowCandidateMlPacked;
   // Collisions
   o2::framework::Produces<HfCollBases> rowCollBase;
   o2::framework::Produces<HfCollIds> rowCollId;
@@ -90,15 +115,24 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
   HfConfigurableDerivedData const* conf{};
   std::map<int, std::vector<int>> matchedCollisions; // indices of derived reconstructed collisions matched to the global indices of MC collisions
   std::map<int, bool> hasMcParticles;                // flags for MC collisions with HF particles
+  std::vector<uint16_t> mlScoresPacked;              // buffer of the reduced-precision ML scores
 
-  void init(HfConfigurableDerivedData const& c)
+  void init(HfConfigurableDerivedData& c)
   {
+    for (auto* enabled : {&c.fillCandidateBase, &c.fillCandidateBasePacked, &c.fillCandidateMlPacked,
+                          &c.fillCollBase, &c.fillCollId,
+                          &c.fillMcCollBase, &c.fillMcCollId, &c.fillMcRCollId,
+                          &c.fillParticleBase, &c.fillParticleId}) {
+      selectTable(*enabled, c.tablesToFill.value);
+    }
     conf = &c;
   }
 
   void reserveTablesCandidates(const uint64_t size)
   {
     o2::analysis::hf_derived::reserveTable(rowCandidateBase, conf->fillCandidateBase, size);
+    o2::analysis::hf_derived::reserveTable(rowCandidateBasePacked, conf->fillCandidateBasePacked, size);
+    o2::analysis::hf_derived::reserveTable(rowCandidateMlPacked, conf->fillCandidateMlPacked, size);
   }
 
   void reserveTablesColl(const uint64_t size)
@@ -134,6 +168,30 @@ struct HfProducesDerivedData : o2::framework::ProducesGroup {
         invMass,
         y);
     }
+    if (conf->fillCandidateBasePacked.value) {
+      namespace packed = o2::aod::hf_cand_base_packed;
+      rowCandidateBasePacked(
+        rowCollBase.lastIndex(),
+        packed::packFloat16(candidate.pt()),
+        packed::packEta(candidate.eta()),
+        packed::packPhi(candidate.phi()),
+        invMass,
+        packed::packEta(y));
+    }
+  }
+
+  /// Fill the table of reduced-precision ML scores
+  /// \param mlScores  ML scores of the candidate
+  template <typename TScores>
+  void fillTablesCandidateMl(const TScores& mlScores)
+  {
+    if (conf->fillCandidateMlPacked.value) {
+      mlScoresPacked.clear();
+      for (const auto& score : mlScores) {
+        mlScoresPacked.push_back(o2::aod::hf_cand_base_packed::packMlScore(score));
+      }
+      rowCandidateMlPacked(mlScoresPacked);
+    }
   }
 
   template <bool IsMc, typename TCollision>
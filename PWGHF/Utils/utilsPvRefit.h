@@ -0,0 +1,245 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsPvRefit.h
+/// \brief Refit of the primary vertex excluding some of its contributors, prepared once per collision
+///
+/// The contributors of a collision are prepared once and the primary vertex is then refitted, for each track or
+/// candidate, excluding the requested contributors. Two methods are available:
+/// - the PVertexer refit, for which the vertexer and its track pool are prepared once per collision instead of once per refit;
+/// - the downdate of the primary-vertex fit in information-matrix form, where the linearised contribution of each track
+///   is computed once per collision and removing k contributors amounts to subtracting their contributions and inverting
+///   a 3x3 matrix.
+
+#ifndef PWGHF_UTILS_UTILSPVREFIT_H_
+#define PWGHF_UTILS_UTILSPVREFIT_H_
+
+#include <CommonUtils/ConfigurableParam.h>
+#include <DetectorsBase/Propagator.h>
+#include <DetectorsVertexing/PVertexer.h>
+#include <Framework/Logger.h>
+#include <ReconstructionDataFormats/PrimaryVertex.h>
+#include <ReconstructionDataFormats/Track.h>
+#include <ReconstructionDataFormats/Vertex.h>
+
+#include <Math/SMatrix.h>
+#include <Math/SVector.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <vector>
+
+namespace o2::hf_pv_refit
+{
+
+/// Method used to refit the primary vertex
+enum PvRefitMethod : int {
+  PVertexerRefit = 0, // refit with the PVertexer
+  Downdate            // downdate of the primary-vertex fit in information-matrix form
+};
+
+/// \brief Refit of the primary vertex of a collision excluding some of its contributors
+class HfPvRefitter
+{
+ public:
+  using SMatrix33Sym = ROOT::Math::SMatrix<double, 3, 3, ROOT::Math::MatRepSym<double, 3>>;
+  using SVector3 = ROOT::Math::SVector<double, 3>;
+
+  /// Prepare the refits of the primary vertex of a collision
+  /// \param primVtx is the original primary vertex
+  /// \param vecPvContributorGlobId is a vector containing the global ID of the PV contributors of the collision
+  /// \param vecPvContributorTrackParCov is a vector containing the TrackParCov of the PV contributors of the collision
+  /// \param method is the method used to refit the primary vertex, see PvRefitMethod
+  /// \return whether the primary vertex can be refitted
+  bool prepare(o2::dataformats::VertexBase const& primVtx,
+               std::vector<int64_t> const& vecPvContributorGlobId,
+               std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov,
+               const int method)
+  {
+    vertex = primVtx;
+    globIds = vecPvContributorGlobId;
+    pvRefitMethod = method;
+    if (pvRefitMethod == Downdate) {
+      isRefitDoable = computeContributions(vecPvContributorTrackParCov);
+      return isRefitDoable;
+    }
+
+    // (re)initialise the vertexer only if the magnetic field changed
+    const float bz = o2::base::Propagator::Instance()->getNominalBz();
+    if (!isVertexerInitialised || bz != bzVertexer) {
+      o2::conf::ConfigurableParam::updateFromString("pvertexer.useMeanVertexConstraint=false"); /// remove diamond constraint (let's keep it at the moment...)
+      vertexer.init();
+      isVertexerInitialised = true;
+      bzVertexer = bz;
+    }
+    isContributorUsed.assign(globIds.size(), true);
+    isRefitDoable = vertexer.prepareVertexRefit(vecPvContributorTrackParCov, vertex);
+    return isRefitDoable;
+  }
+
+  /// \return whether the primary vertex of the prepared collision can be refitted
+  bool isDoable() const { return isRefitDoable; }
+
+  /// \return the number of PV contributors of the prepared collision
+  std::size_t getNContributors() const { return globIds.size(); }
+
+  /// Find a PV contributor of the prepared collision
+  /// \param globalIndex is the global index of the track
+  /// \return the position of the track among the PV contributors, -1 if it is not a PV contributor
+  int findContributor(const int64_t globalIndex) const
+  {
+    const auto it = std::find(globIds.begin(), globIds.end(), globalIndex);
+    return it == globIds.end() ? -1 : static_cast<int>(std::distance(globIds.begin(), it));
+  }
+
+  /// Refit the primary vertex excluding some of its contributors
+  /// \param contributorsToRemove are the positions of the contributors to be removed, as returned by findContributor
+  /// \return the refitted primary vertex, with negative chi2 if the refit failed
+  o2::dataformats::PrimaryVertex refit(std::vector<int> const& contributorsToRemove)
+  {
+    if (pvRefitMethod == Downdate) {
+      return downdate(contributorsToRemove);
+    }
+    for (const auto& iContributor : contributorsToRemove) {
+      isContributorUsed[iContributor] = false;
+    }
+    auto primVtxRefitted = vertexer.refitVertex(isContributorUsed, vertex);
+    for (const auto& iContributor : contributorsToRemove) {
+      isContributorUsed[iContributor] = true; /// restore the track for the next PV refitting
+    }
+    return primVtxRefitted;
+  }
+
+ private:
+  /// Linearised contribution of a track to the primary-vertex fit, chi2(V) = c + 2 g.V + V^T J V
+  struct Contribution {
+    SMatrix33Sym information{}; // J: information matrix
+    SVector3 gradient{};        // g: gradient term
+    double chi2Offset{0.};      // c: constant term
+    bool isValid{false};        // whether the track could be propagated to the primary vertex
+  };
+
+  static constexpr int MinContributors{2}; // minimum number of contributors of the refitted vertex
+
+  o2::vertexing::PVertexer vertexer;       // vertexer used by the PVertexer refit
+  bool isVertexerInitialised{false};       // whether the vertexer was initialised
+  float bzVertexer{0.f};                   // magnetic field with which the vertexer was initialised
+  std::vector<bool> isContributorUsed;     // contributors used in the PVertexer refit
+  o2::dataformats::VertexBase vertex;      // original primary vertex
+  std::vector<int64_t> globIds;            // global indices of the PV contributors
+  std::vector<Contribution> contributions; // contributions of the PV contributors to the primary-vertex fit
+  Contribution sumContributions;           // sum of the contributions of all the valid PV contributors
+  int nValidContributors{0};               // number of PV contributors with a valid contribution
+  int pvRefitMethod{PVertexerRefit};       // method used to refit the primary vertex
+  bool isRefitDoable{false};               // whether the primary vertex of the prepared collision can be refitted
+
+  /// Compute the linearised contributions of the PV contributors at the original primary vertex
+  /// \param vecPvContributorTrackParCov is a vector containing the TrackParCov of the PV contributors of the collision
+  /// \return whether enough contributors are valid to refit the primary vertex
+  bool computeContributions(std::vector<o2::track::TrackParCov> const& vecPvContributorTrackParCov)
+  {
+    const float bz = o2::base::Propagator::Instance()->getNominalBz();
+    contributions.assign(vecPvContributorTrackParCov.size(), Contribution{});
+    sumContributions = Contribution{};
+    nValidContributors = 0;
+    for (std::size_t iContributor = 0; iContributor < vecPvContributorTrackParCov.size(); ++iContributor) {
+      auto track = vecPvContributorTrackParCov[iContributor];
+      if (!track.propagateToDCA(vertex, bz)) {
+        continue;
+      }
+      // residuals of the track at the vertex V in the track frame: r = r0 + A V
+      const double snp = track.getSnp();
+      const double cosPhi = std::sqrt((1. - snp) * (1. + snp));
+      const double tgP = snp / cosPhi;
+      const double tgL = track.getTgl() / cosPhi;
+      const double cosAlpha = std::cos(track.getAlpha());
+      const double sinAlpha = std::sin(track.getAlpha());
+      const double sigmaY2 = track.getSigmaY2();
+      const double sigmaZY = track.getSigmaZY();
+      const double sigmaZ2 = track.getSigmaZ2();
+      const double det = sigmaY2 * sigmaZ2 - sigmaZY * sigmaZY;
+      if (det <= 0.) {
+        continue;
+      }
+      const double wYY = sigmaZ2 / det;
+      const double wYZ = -sigmaZY / det;
+      const double wZZ = sigmaY2 / det;
+      const std::array<double, 3> aY{tgP * cosAlpha + sinAlpha, tgP * sinAlpha - cosAlpha, 0.};
+      const std::array<double, 3> aZ{tgL * cosAlpha, tgL * sinAlpha, -1.};
+      const double r0Y = track.getY() - tgP * track.getX();
+      const double r0Z = track.getZ() - tgL * track.getX();
+
+      auto& contribution = contributions[iContributor];
+      for (int i = 0; i < 3; ++i) {
+        // rows of W A
+        const double waY = wYY * aY[i] + wYZ * aZ[i];
+        const double waZ = wYZ * aY[i] + wZZ * aZ[i];
+        for (int j = 0; j <= i; ++j) {
+          contribution.information(i, j) = aY[j] * waY + aZ[j] * waZ;
+        }
+        contribution.gradient[i] = r0Y * waY + r0Z * waZ;
+      }
+      contribution.chi2Offset = r0Y * (wYY * r0Y + wYZ * r0Z) + r0Z * (wYZ * r0Y + wZZ * r0Z);
+      contribution.isValid = true;
+      sumContributions.information += contribution.information;
+      sumContributions.gradient += contribution.gradient;
+      sumContributions.chi2Offset += contribution.chi2Offset;
+      nValidContributors++;
+    }
+    return nValidContributors >= MinContributors;
+  }
+
+  /// Refit the primary vertex by subtracting the contributions of the removed contributors
+  /// \param contributorsToRemove are the positions of the contributors to be removed
+  /// \return the refitted primary vertex, with negative chi2 if the refit failed
+  o2::dataformats::PrimaryVertex downdate(std::vector<int> const& contributorsToRemove) const
+  {
+    o2::dataformats::PrimaryVertex primVtxRefitted;
+    primVtxRefitted.setXYZ(vertex.getX(), vertex.getY(), vertex.getZ());
+    primVtxRefitted.setCov(vertex.getSigmaX2(), vertex.getSigmaXY(), vertex.getSigmaY2(), vertex.getSigmaXZ(), vertex.getSigmaYZ(), vertex.getSigmaZ2());
+    primVtxRefitted.setChi2(-1.f);
+
+    auto information = sumContributions.information;
+    auto gradient = sumContributions.gradient;
+    double chi2 = sumContributions.chi2Offset;
+    int nContributors = nValidContributors;
+    for (const auto& iContributor : contributorsToRemove) {
+      const auto& contribution = contributions[iContributor];
+      if (!contribution.isValid) {
+        continue;
+      }
+      information -= contribution.information;
+      gradient -= contribution.gradient;
+      chi2 -= contribution.chi2Offset;
+      nContributors--;
+    }
+    primVtxRefitted.setNContributors(nContributors);
+    if (nContributors < MinContributors || !information.Invert()) {
+      return primVtxRefitted;
+    }
+    // minimum of the chi2: J V = -g, chi2 = c + g.V
+    SVector3 position = information * gradient;
+    position *= -1.;
+    chi2 += ROOT::Math::Dot(gradient, position);
+    primVtxRefitted.setXYZ(position[0], position[1], position[2]);
+    primVtxRefitted.setCov(information(0, 0), information(1, 0), information(1, 1), information(2, 0), information(2, 1), information(2, 2));
+    primVtxRefitted.setChi2(std::max(chi2, 0.));
+    return primVtxRefitted;
+  }
+};
+
+} // namespace o2::hf_pv_refit
+
+#endif // PWGHF_UTILS_UTILSPVREFIT_H_
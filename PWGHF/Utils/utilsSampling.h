@@ -0,0 +1,161 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file utilsSampling.h
+/// \brief Stratified sampling of the candidates written by the HF tree creators
+///
+/// The candidates are split in strata of (pT bin, signal/background). In each time frame, a uniform sample of at most
+/// maxCandidatesPerTf candidates per stratum is drawn with reservoir sampling, and the number of candidates written per
+/// stratum in the whole job is limited by a fixed budget, so that the output is balanced across the pT bins.
+
+#ifndef PWGHF_UTILS_UTILSSAMPLING_H_
+#define PWGHF_UTILS_UTILSSAMPLING_H_
+
+#include <Framework/Configurable.h>
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace o2::analysis::hf_sampling
+{
+
+/// Classes of candidates sampled separately
+enum CandidateClass : int {
+  Bkg = 0,
+  Sig,
+  NClasses
+};
+
+struct HfCandidateSampler : o2::framework::ConfigurableGroup {
+  std::string prefix = "hfSampling"; // JSON group name
+  o2::framework::Configurable<std::vector<double>> binsPt{"binsPt", std::vector<double>{}, "pT bin limits of the sampling strata (sampling disabled if empty)"};
+  o2::framework::Configurable<std::vector<int>> maxCandidatesSig{"maxCandidatesSig", std::vector<int>{}, "Maximum number of signal candidates written per pT bin in the job (negative: no limit)"};
+  o2::framework::Configurable<std::vector<int>> maxCandidatesBkg{"maxCandidatesBkg", std::vector<int>{}, "Maximum number of background candidates written per pT bin in the job (negative: no limit)"};
+  o2::framework::Configurable<int> maxCandidatesPerTf{"maxCandidatesPerTf", 1000, "Maximum number of candidates per pT bin and class sampled in a time frame"};
+  o2::framework::Configurable<int> seed{"seed", 0, "Seed of the random generator (0: non-deterministic seed)"};
+
+  std::mt19937_64 generator;                    // random generator of the reservoir sampling
+  std::vector<int64_t> budgets;                 // remaining number of candidates to be written per stratum in the job, negative if unlimited
+  std::vector<int64_t> nOffered;                // number of candidates offered per stratum in the time frame
+  std::vector<std::vector<int64_t>> reservoirs; // sampled candidates per stratum in the time frame
+  std::vector<bool> isAccepted;                 // decision for each candidate offered in the time frame
+
+  /// \return whether the sampling is enabled
+  bool isEnabled() const { return binsPt.value.size() > 1; }
+
+  /// Initialise the budgets and the random generator
+  void init()
+  {
+    if (!isEnabled()) {
+      return;
+    }
+    const auto nBinsPt = binsPt.value.size() - 1;
+    if (!std::is_sorted(binsPt.value.begin(), binsPt.value.end())) {
+      LOGP(fatal, "The pT bin limits of the sampling strata must be sorted.");
+    }
+    if (maxCandidatesSig.value.size() != nBinsPt || maxCandidatesBkg.value.size() != nBinsPt) {
+      LOGP(fatal, "The budgets of the sampling strata must have one entry per pT bin ({}).", nBinsPt);
+    }
+    if (maxCandidatesPerTf.value <= 0) {
+      LOGP(fatal, "The number of candidates sampled per time frame must be positive.");
+    }
+    budgets.assign(nBinsPt * NClasses, -1);
+    for (std::size_t iBin = 0; iBin < nBinsPt; ++iBin) {
+      budgets[iBin * NClasses + Bkg] = maxCandidatesBkg.value[iBin];
+      budgets[iBin * NClasses + Sig] = maxCandidatesSig.value[iBin];
+    }
+    nOffered.assign(budgets.size(), 0);
+    reservoirs.assign(budgets.size(), {});
+    generator.seed(seed.value == 0 ? std::random_device{}() : static_cast<uint64_t>(seed.value));
+  }
+
+  /// Start the sampling of the candidates of a new time frame
+  void startTimeFrame()
+  {
+    std::fill(nOffered.begin(), nOffered.end(), 0);
+    for (auto& reservoir : reservoirs) {
+      reservoir.clear();
+    }
+    isAccepted.clear();
+  }
+
+  /// Offer the next candidate of the time frame to the sampler
+  /// \param pt is the transverse momentum of the candidate
+  /// \param isSignal is whether the candidate is a signal candidate
+  void offer(const double pt, const bool isSignal)
+  {
+    const auto index = static_cast<int64_t>(isAccepted.size());
+    isAccepted.push_back(false);
+    const auto& bins = binsPt.value;
+    if (pt < bins.front() || pt >= bins.back()) {
+      return;
+    }
+    const auto iBin = static_cast<std::size_t>(std::upper_bound(bins.begin(), bins.end(), pt) - bins.begin() - 1);
+    const auto iStratum = iBin * NClasses + (isSignal ? Sig : Bkg);
+    const int64_t capacity = budgets[iStratum] < 0 ? maxCandidatesPerTf.value : std::min<int64_t>(maxCandidatesPerTf.value, budgets[iStratum]);
+    auto& reservoir = reservoirs[iStratum];
+    const auto nSeen = ++nOffered[iStratum];
+    if (static_cast<int64_t>(reservoir.size()) < capacity) {
+      reservoir.push_back(index);
+      return;
+    }
+    // replace a sampled candidate with probability capacity/nSeen
+    const auto iSlot = std::uniform_int_distribution<int64_t>{0, nSeen - 1}(generator);
+    if (iSlot < capacity) {
+      reservoir[iSlot] = index;
+    }
+  }
+
+  /// Accept the sampled candidates of the time frame and update the budgets
+  void finaliseTimeFrame()
+  {
+    for (std::size_t iStratum = 0; iStratum < reservoirs.size(); ++iStratum) {
+      for (const auto& index : reservoirs[iStratum]) {
+        isAccepted[index] = true;
+      }
+      if (budgets[iStratum] > 0) {
+        budgets[iStratum] -= static_cast<int64_t>(reservoirs[iStratum].size());
+      }
+    }
+  }
+
+  /// \param index is the position of the candidate in the order in which the candidates were offered
+  /// \return whether the candidate is written, always true if the sampling is disabled
+  bool isSelected(const int64_t index) const
+  {
+    return !isEnabled() || isAccepted[index];
+  }
+
+  /// Sample the candidates of a time frame
+  /// \param candidates are the candidates of the time frame
+  /// \param isSignal is a function returning whether a candidate is a signal candidate
+  template <typename TCandidates, typename TIsSignal>
+  void sample(TCandidates const& candidates, TIsSignal const& isSignal)
+  {
+    if (!isEnabled()) {
+      return;
+    }
+    startTimeFrame();
+    for (const auto& candidate : candidates) {
+      offer(candidate.pt(), isSignal(candidate));
+    }
+    finaliseTimeFrame();
+  }
+};
+
+} // namespace o2::analysis::hf_sampling
+
+#endif // PWGHF_UTILS_UTILSSAMPLING_H_
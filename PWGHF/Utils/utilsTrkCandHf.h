@@ -19,9 +19,11 @@
 #include "PWGHF/Utils/utilsAnalysis.h"
 
 #include <Framework/HistogramSpec.h>
+#include <ReconstructionDataFormats/Track.h>
 
 #include <Rtypes.h>
 
+#include <array>
 #include <cstddef>
 #include <cstdint>
 
@@ -48,6 +50,40 @@ void setLabelHistoCands(THisto& hCandidates)
   hCandidates->GetXaxis()->SetBinLabel(SVFitting::Fail + 1, "Run-time error in secondary vertexing");
 }
 
+/// number of values describing a track at the PCA in the secondary-vertex fit tables: x, alpha, 5 parameters and 15 covariance elements
+constexpr std::size_t NValuesTrackAtPca{2u + o2::track::kNParams + o2::track::kCovMatSize};
+
+/// \brief Function to flatten a track at the PCA of a secondary vertex, as stored in the secondary-vertex fit tables
+/// \param track is the track at the PCA
+/// \param values is filled with the NValuesTrackAtPca values describing the track
+inline void flattenTrackAtPca(const o2::track::TrackParCov& track, float* values)
+{
+  values[0] = track.getX();
+  values[1] = track.getAlpha();
+  for (int iPar{0}; iPar < o2::track::kNParams; iPar++) {
+    values[2 + iPar] = track.getParam(iPar);
+  }
+  const auto& cov = track.getCov();
+  for (int iCov{0}; iCov < o2::track::kCovMatSize; iCov++) {
+    values[2 + o2::track::kNParams + iCov] = cov[iCov];
+  }
+}
+
+/// \brief Function to restore a track at the PCA of a secondary vertex from the secondary-vertex fit tables
+/// \param values are the NValuesTrackAtPca values describing the track
+inline o2::track::TrackParCov getTrackAtPca(const float* values)
+{
+  std::array<float, o2::track::kNParams> params{};
+  std::array<float, o2::track::kCovMatSize> cov{};
+  for (int iPar{0}; iPar < o2::track::kNParams; iPar++) {
+    params[iPar] = values[2 + iPar];
+  }
+  for (int iCov{0}; iCov < o2::track::kCovMatSize; iCov++) {
+    cov[iCov] = values[2 + o2::track::kNParams + iCov];
+  }
+  return o2::track::TrackParCov(values[0], values[1], params, cov);
+}
+
 /// \brief Function to evaluate number of ones in a binary representation of the argument
 /// \param num is the input argument
 inline int countOnesInBinary(const uint8_t num)
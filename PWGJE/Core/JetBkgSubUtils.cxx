@@ -15,9 +15,12 @@
 
 #include "PWGJE/Core/JetBkgSubUtils.h"
 
+#include "PWGJE/Core/JetGhostUtilities.h"
+
 #include <TMath.h>
 
 #include <fastjet/AreaDefinition.hh>
+#include <fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh>
 #include <fastjet/ClusterSequenceArea.hh>
 #include <fastjet/GhostedAreaSpec.hh>
 #include <fastjet/JetDefinition.hh>
@@ -27,6 +30,8 @@
 #include <fastjet/tools/Subtractor.hh>
 
 #include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <tuple>
 #include <vector>
@@ -62,18 +67,37 @@ std::tuple<double, double> JetBkgSubUtils::estimateRhoAreaMedian(const std::vect
     return std::make_tuple(0.0, 0.0);
   }
 
+  if (useGhostGridCache) {
+    // the ghosts cover the same acceptance as the ones of ghostAreaSpec but come from the cached grid
+    jetghostutilities::GhostGridSpec ghostGridSpec;
+    ghostGridSpec.rapMin = -ghostAreaSpec.ghost_maxrap();
+    ghostGridSpec.rapMax = ghostAreaSpec.ghost_maxrap();
+    ghostGridSpec.ghostArea = ghostAreaSpec.ghost_area();
+    ghostGridSpec.repeat = ghostAreaSpec.repeat();
+    ghostGridSpec.gridScatter = ghostAreaSpec.grid_scatter();
+    ghostGridSpec.ptScatter = ghostAreaSpec.pt_scatter();
+    ghostGridSpec.meanGhostPt = ghostAreaSpec.mean_ghost_pt();
+    ghostGridSpec.isScatteredPerEvent = isGhostScatterPerEvent;
+    auto& ghostGrid = jetghostutilities::getGhostGrid(ghostGridSpec);
+    fastjet::ClusterSequenceActiveAreaExplicitGhosts clusterSeq(inputParticles, jetDefBkg, ghostGrid.getGhosts(), ghostGrid.getGhostArea());
+    return computeRhoAreaMedian(clusterSeq, selRho(clusterSeq.inclusive_jets()), doSparseSub);
+  }
+
   // cluster the kT jets
   fastjet::ClusterSequenceArea clusterSeq(inputParticles, jetDefBkg, areaDefBkg);
 
   // select jets in detector acceptance
-  std::vector<fastjet::PseudoJet> alljets = selRho(clusterSeq.inclusive_jets());
+  return computeRhoAreaMedian(clusterSeq, selRho(clusterSeq.inclusive_jets()), doSparseSub);
+}
 
+std::tuple<double, double> JetBkgSubUtils::computeRhoAreaMedian(const fastjet::ClusterSequenceAreaBase& clusterSeq, const std::vector<fastjet::PseudoJet>& alljets, bool doSparseSub) const
+{
   double totaljetAreaPhys(0), totalAreaCovered(0);
   std::vector<double> rhovector;
   std::vector<double> rhoMdvector;
 
   // Fill a vector for pT/area to be used for the median
-  for (auto& ijet : alljets) {
+  for (const auto& ijet : alljets) {
 
     if (ijet.area() <= 0.0) {
       continue;
@@ -118,6 +142,14 @@ fastjet::PseudoJet JetBkgSubUtils::doRhoAreaSub(const fastjet::PseudoJet& jet, d
 }
 
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
+{
+  if (useNativeConstSub) {
+    return doEventConstSubNative(inputParticles, rhoParam, rhoMParam);
+  }
+  return doEventConstSubFastJet(inputParticles, rhoParam, rhoMParam);
+}
+
+std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSubFastJet(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
   fastjet::contrib::ConstituentSubtractor constituentSub(rhoParam, rhoMParam);
@@ -135,6 +167,112 @@ std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSub(std::vector<fast
   return constituentSub.subtract_event(inputParticles, std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax)));
 }
 
+std::vector<fastjet::PseudoJet> JetBkgSubUtils::doEventConstSubNative(const std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam)
+{
+  std::vector<fastjet::PseudoJet> subtractedParticles;
+  const double maxEta = std::max(std::abs(bkgEtaMin), std::abs(bkgEtaMax));
+  const double ghostSpacing = std::sqrt(ghostAreaSpec.ghost_area());
+  if (inputParticles.empty() || maxEta <= 0. || ghostSpacing <= 0.) {
+    return subtractedParticles;
+  }
+
+  // ghost grid of the fastjet constituent subtractor: cell centres in |y| < maxEta and 0 < phi < 2pi
+  const int nGhostsRap = std::max(1, static_cast<int>(2. * maxEta / ghostSpacing + 0.5));
+  const int nGhostsPhi = std::max(1, static_cast<int>(2. * M_PI / ghostSpacing + 0.5));
+  const double gridSizeRap = 2. * maxEta / nGhostsRap;
+  const double gridSizePhi = 2. * M_PI / nGhostsPhi;
+  const double usedGhostArea = gridSizeRap * gridSizePhi;
+  constSubGhostPt.assign(static_cast<std::size_t>(nGhostsRap) * nGhostsPhi, rhoParam * usedGhostArea);
+  constSubGhostMd.assign(constSubGhostPt.size(), doRhoMassSub ? rhoMParam * usedGhostArea : 0.);
+
+  // particles in the ghost acceptance and their pairs with the ghosts closer than constSubRMax
+  constSubParticleIndex.clear();
+  constSubParticlePt.clear();
+  constSubParticleMd.clear();
+  constSubPairs.clear();
+  const double maxDistanceSquared = constSubRMax * constSubRMax;
+  for (std::size_t iInput = 0; iInput < inputParticles.size(); iInput++) {
+    const auto& particle = inputParticles[iInput];
+    if (std::abs(particle.eta()) > maxEta) {
+      continue;
+    }
+    const int iParticle = constSubParticleIndex.size();
+    const double pt = particle.pt();
+    const double rap = particle.rap();
+    const double phi = particle.phi();
+    constSubParticleIndex.push_back(iInput);
+    constSubParticlePt.push_back(pt);
+    constSubParticleMd.push_back(std::sqrt(pt * pt + particle.m2()) - pt);
+    const double ptFactor = std::abs(constSubAlpha) > 1.e-5 ? std::pow(pt, constSubAlpha) : 1.;
+
+    // grid cells whose centre can be within constSubRMax of the particle
+    const int iRapMin = std::max(0, static_cast<int>(std::ceil((rap - constSubRMax + maxEta) / gridSizeRap - 0.5)));
+    const int iRapMax = std::min(nGhostsRap - 1, static_cast<int>(std::floor((rap + constSubRMax + maxEta) / gridSizeRap - 0.5)));
+    int iPhiMin = static_cast<int>(std::ceil((phi - constSubRMax) / gridSizePhi - 0.5));
+    int iPhiMax = static_cast<int>(std::floor((phi + constSubRMax) / gridSizePhi - 0.5));
+    if (iPhiMax - iPhiMin + 1 >= nGhostsPhi) {
+      iPhiMin = 0;
+      iPhiMax = nGhostsPhi - 1;
+    }
+    for (int iRap = iRapMin; iRap <= iRapMax; iRap++) {
+      const double deltaRap = rap - ((iRap + 0.5) * gridSizeRap - maxEta);
+      for (int iPhiUnwrapped = iPhiMin; iPhiUnwrapped <= iPhiMax; iPhiUnwrapped++) {
+        const int iPhi = ((iPhiUnwrapped % nGhostsPhi) + nGhostsPhi) % nGhostsPhi;
+        double deltaPhi = std::abs(phi - (iPhi + 0.5) * gridSizePhi);
+        deltaPhi = std::min(deltaPhi, 2. * M_PI - deltaPhi);
+        const double deltaRSquared = deltaRap * deltaRap + deltaPhi * deltaPhi;
+        if (deltaRSquared <= maxDistanceSquared) {
+          constSubPairs.push_back({ptFactor * std::sqrt(deltaRSquared), iParticle, iRap * nGhostsPhi + iPhi});
+        }
+      }
+    }
+  }
+
+  // subtract the ghosts from the particles, closest pairs first
+  std::sort(constSubPairs.begin(), constSubPairs.end());
+  for (const auto& pair : constSubPairs) {
+    auto& particlePt = constSubParticlePt[pair.iParticle];
+    auto& ghostPt = constSubGhostPt[pair.iGhost];
+    if (particlePt > 0. && ghostPt > 0.) {
+      if (particlePt >= ghostPt) {
+        particlePt -= ghostPt;
+        ghostPt = 0.;
+      } else {
+        ghostPt -= particlePt;
+        particlePt = 0.;
+      }
+    }
+    if (doRhoMassSub) {
+      auto& particleMd = constSubParticleMd[pair.iParticle];
+      auto& ghostMd = constSubGhostMd[pair.iGhost];
+      if (particleMd > 0. && ghostMd > 0.) {
+        if (particleMd >= ghostMd) {
+          particleMd -= ghostMd;
+          ghostMd = 0.;
+        } else {
+          ghostMd -= particleMd;
+          particleMd = 0.;
+        }
+      }
+    }
+  }
+
+  // by default, the masses of all particles are set to zero. With the mass subtraction the mass is rebuilt from the subtracted mass term
+  subtractedParticles.reserve(constSubParticleIndex.size());
+  for (std::size_t iParticle = 0; iParticle < constSubParticleIndex.size(); iParticle++) {
+    const double pt = constSubParticlePt[iParticle];
+    if (pt <= 0.) {
+      continue;
+    }
+    const auto& particle = inputParticles[constSubParticleIndex[iParticle]];
+    const double md = constSubParticleMd[iParticle];
+    const double mass = doRhoMassSub ? std::sqrt(md * md + 2. * pt * md) : 0.;
+    auto& subtractedParticle = subtractedParticles.emplace_back(particle);
+    subtractedParticle.reset_PtYPhiM(pt, particle.rap(), particle.phi(), mass);
+  }
+  return subtractedParticles;
+}
+
 std::vector<fastjet::PseudoJet> JetBkgSubUtils::doJetConstSub(std::vector<fastjet::PseudoJet>& jets, double rhoParam, double rhoMParam)
 {
   JetBkgSubUtils::initialise();
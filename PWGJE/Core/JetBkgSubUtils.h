@@ -18,6 +18,7 @@
 #define PWGJE_CORE_JETBKGSUBUTILS_H_
 
 #include <fastjet/AreaDefinition.hh>
+#include <fastjet/ClusterSequenceAreaBase.hh>
 #include <fastjet/GhostedAreaSpec.hh>
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
@@ -82,6 +83,25 @@ class JetBkgSubUtils
   /// @return inputParticles, a vector of background subtracted input particles
   std::vector<fastjet::PseudoJet> doEventConstSub(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
 
+  /// @brief event-wise constituent subtraction with the fastjet constituent subtractor
+  /// @param inputParticles (all the tracks/clusters/particles in the event)
+  /// @param rhoParam the underlying evvent density vs pT (to be set)
+  /// @param rhoParam the underlying evvent density vs jet mass (to be set)
+  /// @return inputParticles, a vector of background subtracted input particles
+  std::vector<fastjet::PseudoJet> doEventConstSubFastJet(std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
+
+  /// @brief event-wise constituent subtraction with the native implementation
+  ///
+  /// Same algorithm as the fastjet constituent subtractor with the deltaR distance: the ghosts are placed on a regular grid
+  /// in |y| < max(|bkgEtaMin|, |bkgEtaMax|), the particle-ghost pairs closer than constSubRMax are found by scanning the
+  /// grid cells around each particle and are processed by increasing pT^alpha * deltaR. The particles and the ghosts are
+  /// stored as arrays and all the buffers are reused for the next events.
+  /// @param inputParticles (all the tracks/clusters/particles in the event)
+  /// @param rhoParam the underlying evvent density vs pT (to be set)
+  /// @param rhoParam the underlying evvent density vs jet mass (to be set)
+  /// @return inputParticles, a vector of background subtracted input particles, in the input order
+  std::vector<fastjet::PseudoJet> doEventConstSubNative(const std::vector<fastjet::PseudoJet>& inputParticles, double rhoParam, double rhoMParam);
+
   /// @brief method that subtracts the background from jets using the jet-wise constituent subtractor
   /// @param jets (all jets in the event)
   /// @param rhoParam the underlying evvent density vs pT (to be set)
@@ -108,6 +128,12 @@ class JetBkgSubUtils
   }
   void setDoRhoMassSub(bool doMSub_out = true) { doRhoMassSub = doMSub_out; }
   void setGhostAreaSpec(fastjet::GhostedAreaSpec ghostAreaSpec_out) { ghostAreaSpec = ghostAreaSpec_out; }
+  void setUseNativeConstSub(bool useNative_out = true) { useNativeConstSub = useNative_out; }
+  void setUseGhostGridCache(bool useCache_out = true, bool scatterPerEvent_out = true)
+  {
+    useGhostGridCache = useCache_out;
+    isGhostScatterPerEvent = scatterPerEvent_out;
+  }
 
   // Getters
   float getJetBkgR() const { return jetBkgR; }
@@ -118,6 +144,7 @@ class JetBkgSubUtils
   float getConstSubAlpha() const { return constSubAlpha; }
   float getConstSubRMax() const { return constSubRMax; }
   float getDoRhoMassSub() const { return doRhoMassSub; }
+  bool getUseNativeConstSub() const { return useNativeConstSub; }
   fastjet::GhostedAreaSpec getGhostAreaSpec() const { return ghostAreaSpec; }
   fastjet::JetDefinition getJetDefinition() const { return jetDefBkg; }
   fastjet::AreaDefinition getAreaDefinition() const { return areaDefBkg; }
@@ -126,6 +153,13 @@ class JetBkgSubUtils
   // Calculate the jet mass
   double getMd(fastjet::PseudoJet jet) const;
 
+  /// @brief Computes rho and rhoM as the medians of the jet pT / area and jet mass / area
+  /// @param clusterSeq cluster sequence of the jets
+  /// @param alljets jets in the acceptance
+  /// @param doSparseSub weather to do rho sparse subtraction
+  /// @return Rho, RhoM the underlying event density
+  std::tuple<double, double> computeRhoAreaMedian(const fastjet::ClusterSequenceAreaBase& clusterSeq, const std::vector<fastjet::PseudoJet>& alljets, bool doSparseSub) const;
+
  protected:
   float jetBkgR = 0.2;
   float bkgEtaMin = -0.9;
@@ -135,7 +169,10 @@ class JetBkgSubUtils
   float constSubAlpha = 1.0;
   float constSubRMax = 0.24;
   int nHardReject = 2;
-  bool doRhoMassSub = false; /// flag whether to do jet mass subtraction with the const sub
+  bool doRhoMassSub = false;          /// flag whether to do jet mass subtraction with the const sub
+  bool useGhostGridCache = false;     /// flag whether to take the ghosts of the rho estimation from the cached ghost grids
+  bool isGhostScatterPerEvent = true; /// flag whether the scatter of the cached ghosts is redrawn for each event
+  bool useNativeConstSub = false;     /// flag whether the event-wise constituent subtraction uses the native implementation
 
   fastjet::GhostedAreaSpec ghostAreaSpec = fastjet::GhostedAreaSpec();
   fastjet::JetAlgorithm algorithmBkg = fastjet::kt_algorithm;
@@ -144,6 +181,21 @@ class JetBkgSubUtils
   fastjet::AreaDefinition areaDefBkg = fastjet::AreaDefinition(fastjet::active_area_explicit_ghosts, ghostAreaSpec);
   fastjet::Selector selRho = fastjet::Selector();
 
+  /// particle-ghost pair of the native constituent subtractor
+  struct ConstSubPair {
+    double distance; /// pT^alpha * deltaR
+    int iParticle;
+    int iGhost;
+    bool operator<(const ConstSubPair& other) const { return std::tie(distance, iParticle, iGhost) < std::tie(other.distance, other.iParticle, other.iGhost); }
+  };
+  // buffers of the native constituent subtractor
+  std::vector<int> constSubParticleIndex;  /// index in the input of each particle in the ghost acceptance
+  std::vector<double> constSubParticlePt;  /// pT of the particles, subtracted in place
+  std::vector<double> constSubParticleMd;  /// sqrt(pT^2 + m^2) - pT of the particles, subtracted in place
+  std::vector<double> constSubGhostPt;     /// pT of the ghosts, subtracted in place
+  std::vector<double> constSubGhostMd;     /// mass term of the ghosts, subtracted in place
+  std::vector<ConstSubPair> constSubPairs; /// particle-ghost pairs closer than constSubRMax
+
 }; // class JetBkgSubUtils
 
 #endif // PWGJE_CORE_JETBKGSUBUTILS_H_
@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <cstdlib>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace jetderiveddatautilities
@@ -750,6 +751,66 @@ std::vector<int> initialiseClusterDefinitions(const std::string clusterDefinitio
   return clusterDefinitionsVec;
 }
 
+/// Index of the derived track of each (track, collision) pair
+///
+/// The derived track of a track in its first collision is stored in a flat table indexed by the track. Only the other
+/// collisions of the tracks associated to several collisions are kept in a hash map.
+class JTrackIndexMapping
+{
+ public:
+  /// Removes all the derived tracks
+  /// \param nTracks number of tracks of the dataframe
+  void clear(std::size_t nTracks = 0)
+  {
+    collisionIds.assign(nTracks, -1);
+    jTrackIds.assign(nTracks, -1);
+    otherJTrackIds.clear();
+  }
+
+  /// Sets the derived track of a (track, collision) pair
+  /// \param trackId index of the track
+  /// \param collisionId index of the collision
+  /// \param jTrackId index of the derived track
+  void insert(int32_t trackId, int32_t collisionId, int32_t jTrackId)
+  {
+    if (trackId < 0) {
+      return;
+    }
+    if (static_cast<std::size_t>(trackId) >= jTrackIds.size()) {
+      collisionIds.resize(trackId + 1, -1);
+      jTrackIds.resize(trackId + 1, -1);
+    }
+    if (jTrackIds[trackId] < 0 || collisionIds[trackId] == collisionId) {
+      collisionIds[trackId] = collisionId;
+      jTrackIds[trackId] = jTrackId;
+      return;
+    }
+    otherJTrackIds[key(trackId, collisionId)] = jTrackId;
+  }
+
+  /// \param trackId index of the track
+  /// \param collisionId index of the collision
+  /// \return the index of the derived track of the (track, collision) pair, -1 if there is none
+  int32_t find(int32_t trackId, int32_t collisionId) const
+  {
+    if (trackId < 0 || static_cast<std::size_t>(trackId) >= jTrackIds.size() || jTrackIds[trackId] < 0) {
+      return -1;
+    }
+    if (collisionIds[trackId] == collisionId) {
+      return jTrackIds[trackId];
+    }
+    const auto entry = otherJTrackIds.find(key(trackId, collisionId));
+    return entry == otherJTrackIds.end() ? -1 : entry->second;
+  }
+
+ private:
+  std::vector<int32_t> collisionIds;                  // first collision of each track
+  std::vector<int32_t> jTrackIds;                     // derived track of each track in its first collision
+  std::unordered_map<int64_t, int32_t> otherJTrackIds; // derived tracks of the other (track, collision) pairs
+
+  static int64_t key(int32_t trackId, int32_t collisionId) { return (static_cast<int64_t>(trackId) << 32) | static_cast<uint32_t>(collisionId); }
+};
+
 } // namespace jetderiveddatautilities
 
 #endif // PWGJE_CORE_JETDERIVEDDATAUTILITIES_H_
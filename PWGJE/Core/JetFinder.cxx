@@ -16,11 +16,17 @@
 
 #include "PWGJE/Core/JetFinder.h"
 
+#include "PWGJE/Core/JetGhostUtilities.h"
+
+#include <fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh>
 #include <fastjet/ClusterSequenceArea.hh>
 #include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 #include <fastjet/Selector.hh>
 
+#include <algorithm>
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 /// Sets the jet finding parameters
@@ -65,3 +71,59 @@ fastjet::ClusterSequenceArea JetFinder::findJets(std::vector<fastjet::PseudoJet>
   jets = fastjet::sorted_by_pt(jets);
   return clusterSeq;
 }
+
+/// Performs jet finding for several jet radii at once
+/// \param inputParticles vector of input particles/tracks
+/// \param jetRadii jet radii
+/// \param jets vector of jets to be filled, per radius
+/// \return cluster sequences needed to access constituents, per radius
+std::vector<std::shared_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> JetFinder::findJetsMultiR(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<double> const& jetRadii, std::vector<std::vector<fastjet::PseudoJet>>& jets)
+{
+  std::vector<std::shared_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> clusterSeqs(jetRadii.size());
+  jets.assign(jetRadii.size(), {});
+  if (jetRadii.empty()) {
+    return clusterSeqs;
+  }
+
+  // the ghosts only depend on the acceptance of the input particles, so they are taken once for all the radii from the cached grid
+  jetghostutilities::GhostGridSpec ghostGridSpec;
+  ghostGridSpec.rapMin = etaMin;
+  ghostGridSpec.rapMax = etaMax;
+  ghostGridSpec.phiMin = phiMin;
+  ghostGridSpec.phiMax = phiMax;
+  ghostGridSpec.ghostArea = ghostArea;
+  ghostGridSpec.repeat = ghostRepeatN;
+  ghostGridSpec.gridScatter = gridScatter;
+  ghostGridSpec.ptScatter = ktScatter;
+  ghostGridSpec.meanGhostPt = ghostktMean;
+  ghostGridSpec.isScatteredPerEvent = isGhostScatterPerEvent;
+  auto& ghostGrid = jetghostutilities::getGhostGrid(ghostGridSpec);
+  const std::vector<fastjet::PseudoJet>& ghosts = ghostGrid.getGhosts();
+  const double ghostAreaActual = ghostGrid.getGhostArea();
+  const fastjet::Selector selNoGhosts = !fastjet::SelectorIsPureGhost();
+
+  // C/A merges the pairs in increasing order of distance, so the inclusive jets of radius R are the exclusive jets at dcut = (R/Rmax)^2 of the clustering at Rmax
+  const bool isSharedClustering = algorithm == fastjet::cambridge_algorithm && !isReclustering;
+  const double jetRMax = *std::max_element(jetRadii.begin(), jetRadii.end());
+  std::shared_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts> clusterSeqShared;
+  if (isSharedClustering) {
+    jetR = jetRMax;
+    setParams();
+    clusterSeqShared = std::make_shared<fastjet::ClusterSequenceActiveAreaExplicitGhosts>(inputParticles, jetDef, ghosts, ghostAreaActual);
+  }
+
+  for (std::size_t iR = 0; iR < jetRadii.size(); iR++) {
+    jetR = jetRadii[iR];
+    setParams();
+    if (isSharedClustering) {
+      clusterSeqs[iR] = clusterSeqShared;
+      jets[iR] = clusterSeqShared->exclusive_jets((jetR * jetR) / (jetRMax * jetRMax));
+    } else {
+      clusterSeqs[iR] = std::make_shared<fastjet::ClusterSequenceActiveAreaExplicitGhosts>(inputParticles, jetDef, ghosts, ghostAreaActual);
+      jets[iR] = clusterSeqs[iR]->inclusive_jets();
+    }
+    jets[iR] = (selJets && selNoGhosts)(jets[iR]);
+    jets[iR] = fastjet::sorted_by_pt(jets[iR]);
+  }
+  return clusterSeqs;
+}
@@ -19,6 +19,7 @@
 #define PWGJE_CORE_JETFINDER_H_
 
 #include <fastjet/AreaDefinition.hh>
+#include <fastjet/ClusterSequenceActiveAreaExplicitGhosts.hh>
 #include <fastjet/ClusterSequenceArea.hh>
 #include <fastjet/GhostedAreaSpec.hh>
 #include <fastjet/JetDefinition.hh>
@@ -27,6 +28,7 @@
 
 #include <Rtypes.h>
 
+#include <memory>
 #include <vector>
 
 #include <math.h>
@@ -70,6 +72,8 @@ class JetFinder
 
   bool isReclustering = false;
   bool isTriggering = false;
+  bool isMultiR = false;              // find the jets of all the radii in one call, see findJetsMultiR
+  bool isGhostScatterPerEvent = true; // redraw the scatter of the cached ghosts of findJetsMultiR for each event
 
   fastjet::JetAlgorithm algorithm = fastjet::antikt_algorithm;
   fastjet::RecombinationScheme recombScheme = fastjet::E_scheme;
@@ -92,8 +96,18 @@ class JetFinder
   /// \return ClusterSequenceArea object needed to access constituents
   fastjet::ClusterSequenceArea findJets(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<fastjet::PseudoJet>& jets); // ideally find a way of passing the cluster sequence as a reeference
 
+  /// Performs jet finding for several jet radii at once
+  /// \note the ghosts are taken from the cached ghost grids and shared by all the radii. For C/A the jets of all the radii are extracted
+  /// from a single clustering at the largest radius, for the other algorithms the input is clustered once per radius
+  /// \note the constituents of the jets include the ghosts, which carry no user info
+  /// \param inputParticles vector of input particles/tracks
+  /// \param jetRadii jet radii
+  /// \param jets vector of jets to be filled, per radius
+  /// \return cluster sequences needed to access constituents, per radius
+  std::vector<std::shared_ptr<fastjet::ClusterSequenceActiveAreaExplicitGhosts>> findJetsMultiR(std::vector<fastjet::PseudoJet>& inputParticles, std::vector<double> const& jetRadii, std::vector<std::vector<fastjet::PseudoJet>>& jets);
+
  private:
-  ClassDefNV(JetFinder, 1);
+  ClassDefNV(JetFinder, 3);
 };
 
 #endif // PWGJE_CORE_JETFINDER_H_
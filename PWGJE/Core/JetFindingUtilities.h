@@ -35,6 +35,7 @@
 #include <fastjet/PseudoJet.hh>
 
 #include <cmath>
+#include <cstddef>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -283,10 +284,7 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
   auto jetRValues = static_cast<std::vector<double>>(jetRadius);
   jetFinder.jetPtMin = jetPtMin;
   jetFinder.jetPtMax = jetPtMax;
-  for (auto R : jetRValues) {
-    jetFinder.jetR = R;
-    std::vector<fastjet::PseudoJet> jets;
-    fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
+  auto fillJets = [&](double R, std::vector<fastjet::PseudoJet> const& jets) {
     for (const auto& jet : jets) {
       if (jet.has_area() && jet.area() < jetAreaFractionMin * M_PI * R * R) {
         continue;
@@ -297,6 +295,9 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
       if (doCandidateJetFinding) {
         bool isCandidateJet = false;
         for (const auto& constituent : jet.constituents()) {
+          if (!constituent.template has_user_info<fastjetutilities::fastjet_user_info>()) { // ghosts of the multi-R jet finding
+            continue;
+          }
           JetConstituentStatus constituentStatus = constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus();
           if (constituentStatus == JetConstituentStatus::candidate) { // note currently we cannot run V0 and HF in the same jet. If we ever need to we can seperate the loops
             isCandidateJet = true;
@@ -313,6 +314,9 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
       jetsTable(collision.globalIndex(), jet.pt(), jet.eta(), jet.phi(),
                 jet.E(), jet.rapidity(), jet.m(), jet.has_area() ? jet.area() : 0., std::round(R * 100));
       for (const auto& constituent : sorted_by_pt(jet.constituents())) {
+        if (!constituent.template has_user_info<fastjetutilities::fastjet_user_info>()) { // ghosts of the multi-R jet finding
+          continue;
+        }
         if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == JetConstituentStatus::track) {
           tracks.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
         }
@@ -325,6 +329,20 @@ void findJets(JetFinder& jetFinder, std::vector<fastjet::PseudoJet>& inputPartic
       }
       constituentsTable(jetsTable.lastIndex(), tracks, clusters, cands);
     }
+  };
+  if (jetFinder.isMultiR) {
+    std::vector<std::vector<fastjet::PseudoJet>> jetsPerR;
+    auto clusterSeqs = jetFinder.findJetsMultiR(inputParticles, jetRValues, jetsPerR);
+    for (std::size_t iR = 0; iR < jetRValues.size(); iR++) {
+      fillJets(jetRValues[iR], jetsPerR[iR]);
+    }
+    return;
+  }
+  for (auto R : jetRValues) {
+    jetFinder.jetR = R;
+    std::vector<fastjet::PseudoJet> jets;
+    fastjet::ClusterSequenceArea clusterSeq(jetFinder.findJets(inputParticles, jets));
+    fillJets(R, jets);
   }
 }
 
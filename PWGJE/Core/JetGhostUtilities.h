@@ -0,0 +1,147 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+/// \file JetGhostUtilities.h
+/// \brief Cache of the ghost grids used for the jet areas and the background estimation
+///
+/// The ghost grid of an acceptance and ghost area is built once per thread and reused by all the events. The ghosts
+/// are stored in a pooled buffer: if the grid or the ghost pT are scattered, the scatter is redrawn in place for each
+/// event, otherwise the same deterministic grid is handed out.
+
+#ifndef PWGJE_CORE_JETGHOSTUTILITIES_H_
+#define PWGJE_CORE_JETGHOSTUTILITIES_H_
+
+#include <fastjet/PseudoJet.hh>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <map>
+#include <random>
+#include <tuple>
+#include <vector>
+
+namespace jetghostutilities
+{
+
+/// Parameters of a ghost grid, with the same meaning as in fastjet::GhostedAreaSpec
+struct GhostGridSpec {
+  double rapMin = -0.9;            // minimum rapidity of the ghosts
+  double rapMax = 0.9;             // maximum rapidity of the ghosts
+  double phiMin = 0.;              // minimum azimuth of the ghosts
+  double phiMax = 2. * M_PI;       // maximum azimuth of the ghosts
+  double ghostArea = 0.005;        // requested area per ghost
+  int repeat = 1;                  // no ghosts if not positive
+  double gridScatter = 1.;         // scatter of the ghost positions, in units of the grid spacing
+  double ptScatter = 0.1;          // relative scatter of the ghost pT
+  double meanGhostPt = 1.e-100;    // mean ghost pT
+  bool isScatteredPerEvent = true; // redraw the scatter for each event, otherwise the scattered grid is drawn once
+
+  auto key() const { return std::make_tuple(rapMin, rapMax, phiMin, phiMax, ghostArea, repeat, gridScatter, ptScatter, meanGhostPt, isScatteredPerEvent); }
+  bool operator<(const GhostGridSpec& other) const { return key() < other.key(); }
+};
+
+/// Ghost grid of an acceptance, built once and reused by all the events
+class GhostGrid
+{
+ public:
+  /// Builds the grid
+  /// \param spec parameters of the grid
+  void build(GhostGridSpec const& spec)
+  {
+    gridSpec = spec;
+    double phiMin = spec.phiMin;
+    double phiMax = spec.phiMax;
+    if (phiMax - phiMin >= 2. * M_PI) { // the azimuth is periodic
+      phiMin = 0.;
+      phiMax = 2. * M_PI;
+    }
+    const double spacing = std::sqrt(spec.ghostArea);
+    nRap = std::max(1, static_cast<int>((spec.rapMax - spec.rapMin) / spacing + 0.5));
+    nPhi = std::max(1, static_cast<int>((phiMax - phiMin) / spacing + 0.5));
+    rapStart = spec.rapMin;
+    phiStart = phiMin;
+    rapStep = (spec.rapMax - spec.rapMin) / nRap;
+    phiStep = (phiMax - phiMin) / nPhi;
+    ghosts.assign(spec.repeat > 0 ? static_cast<std::size_t>(nRap) * nPhi : 0, fastjet::PseudoJet());
+    generator.seed(Seed);
+    fill();
+  }
+
+  /// \return the ghosts of the current event
+  const std::vector<fastjet::PseudoJet>& getGhosts()
+  {
+    if (gridSpec.isScatteredPerEvent && isScattered()) {
+      fill();
+    }
+    return ghosts;
+  }
+
+  /// \return the actual area of each ghost
+  double getGhostArea() const { return rapStep * phiStep; }
+
+ private:
+  static constexpr unsigned Seed = 12345; // seed of the scatter, for reproducible grids
+
+  GhostGridSpec gridSpec;                 // parameters of the grid
+  int nRap = 0;                           // number of ghosts along the rapidity
+  int nPhi = 0;                           // number of ghosts along the azimuth
+  double rapStart = 0.;                   // lower edge of the grid in rapidity
+  double phiStart = 0.;                   // lower edge of the grid in azimuth
+  double rapStep = 0.;                    // grid spacing in rapidity
+  double phiStep = 0.;                    // grid spacing in azimuth
+  std::vector<fastjet::PseudoJet> ghosts; // pooled ghosts
+  std::mt19937 generator;                 // generator of the scatter
+
+  bool isScattered() const { return gridSpec.gridScatter != 0. || gridSpec.ptScatter != 0.; }
+
+  /// Fills the pooled ghosts in place
+  void fill()
+  {
+    if (ghosts.empty()) {
+      return;
+    }
+    std::uniform_real_distribution<double> uniform(-0.5, 0.5);
+    const bool scatter = isScattered();
+    std::size_t iGhost = 0;
+    for (int iRap = 0; iRap < nRap; iRap++) {
+      for (int iPhi = 0; iPhi < nPhi; iPhi++) {
+        double rap = rapStart + (iRap + 0.5) * rapStep;
+        double phi = phiStart + (iPhi + 0.5) * phiStep;
+        double pt = gridSpec.meanGhostPt;
+        if (scatter) {
+          rap += gridSpec.gridScatter * uniform(generator) * rapStep;
+          phi += gridSpec.gridScatter * uniform(generator) * phiStep;
+          pt *= 1. + gridSpec.ptScatter * uniform(generator);
+        }
+        ghosts[iGhost++].reset_PtYPhiM(pt, rap, phi, 0.);
+      }
+    }
+  }
+};
+
+/// Gets the ghost grid of a spec, built at the first request and shared by all the users in the calling thread
+/// \param spec parameters of the grid
+/// \return the ghost grid
+inline GhostGrid& getGhostGrid(GhostGridSpec const& spec)
+{
+  thread_local std::map<GhostGridSpec, GhostGrid> grids;
+  auto entry = grids.find(spec);
+  if (entry == grids.end()) {
+    entry = grids.emplace(spec, GhostGrid()).first;
+    entry->second.build(spec);
+  }
+  return entry->second;
+}
+
+}; // namespace jetghostutilities
+
+#endif // PWGJE_CORE_JETGHOSTUTILITIES_H_
@@ -33,11 +33,14 @@
 #include <RtypesCore.h>
 
 #include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <numeric>
 #include <ostream>
 #include <stdexcept>
 #include <tuple>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <math.h>
@@ -294,6 +297,156 @@ std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometrically(
   return std::make_tuple(baseToTagMap, tagToBaseMap);
 }
 
+/**
+ * Bucket index of jets in (eta, phi) for the geometrical jet matching.
+ *
+ * The cells are at least as large as the matching distance, so that the jets closer than the matching distance
+ * to a point are all in the 3x3 cells around it. The azimuth is periodic, so no jets need to be duplicated.
+ *
+ * NOTE: Assumes, but does not validate, that 0 <= phi < 2pi.
+ */
+template <typename T>
+class JetGeoGrid
+{
+ public:
+  /**
+   * Builds the index.
+   *
+   * @param jetsPhi Jets phi
+   * @param jetsEta Jets eta
+   * @param maxMatchingDistance Maximum matching distance, defining the cell size.
+   */
+  JetGeoGrid(const std::vector<T>& jetsPhi, const std::vector<T>& jetsEta, double maxMatchingDistance) : phis(jetsPhi), etas(jetsEta), cellSize(maxMatchingDistance)
+  {
+    if (etas.empty() || cellSize <= 0.) {
+      return;
+    }
+    nCellsPhi = std::max(1, static_cast<int>(2 * M_PI / cellSize));
+    cellSizePhi = 2 * M_PI / nCellsPhi;
+    const auto [itEtaMin, itEtaMax] = std::minmax_element(etas.begin(), etas.end());
+    etaMin = *itEtaMin;
+    nCellsEta = static_cast<int>((*itEtaMax - etaMin) / cellSize) + 1;
+
+    // counting sort of the jets by cell
+    cellStart.assign(static_cast<std::size_t>(nCellsEta) * nCellsPhi + 1, 0);
+    std::vector<int> jetCell(etas.size());
+    for (std::size_t i = 0; i < etas.size(); i++) {
+      jetCell[i] = cellIndex(getCellEta(etas[i]), getCellPhi(phis[i]));
+      cellStart[jetCell[i] + 1]++;
+    }
+    std::partial_sum(cellStart.begin(), cellStart.end(), cellStart.begin());
+    jetsInCells.resize(etas.size());
+    std::vector<int> cellFill(cellStart.begin(), cellStart.end() - 1);
+    for (std::size_t i = 0; i < etas.size(); i++) {
+      jetsInCells[cellFill[jetCell[i]]++] = i;
+    }
+  }
+
+  /**
+   * Finds the closest jet within the matching distance.
+   *
+   * @param phi Phi of the point
+   * @param eta Eta of the point
+   *
+   * @returns Index of the closest jet, -1 if no jet is closer than the matching distance.
+   */
+  int findNearest(T phi, T eta) const
+  {
+    if (cellStart.empty()) {
+      return -1;
+    }
+    const int cellEta = static_cast<int>(std::floor((eta - etaMin) / cellSize));
+    const int cellPhi = getCellPhi(phi);
+    int indexNearest = -1;
+    double distanceNearest = cellSize;
+    for (int iEta = std::max(cellEta - 1, 0); iEta <= std::min(cellEta + 1, nCellsEta - 1); iEta++) {
+      // with less than 3 cells in phi, all of them are neighbours
+      const int nNeighboursPhi = std::min(nCellsPhi, 3);
+      for (int iNeighbourPhi = 0; iNeighbourPhi < nNeighboursPhi; iNeighbourPhi++) {
+        const int iPhi = nCellsPhi < 3 ? iNeighbourPhi : (cellPhi - 1 + iNeighbourPhi + nCellsPhi) % nCellsPhi;
+        const int cell = cellIndex(iEta, iPhi);
+        for (int iJet = cellStart[cell]; iJet < cellStart[cell + 1]; iJet++) {
+          const int index = jetsInCells[iJet];
+          const double deltaPhi = M_PI - std::abs(M_PI - std::abs(phi - phis[index]));
+          const double distance = std::sqrt((eta - etas[index]) * (eta - etas[index]) + deltaPhi * deltaPhi);
+          if (distance < distanceNearest || (distance == distanceNearest && index < indexNearest)) {
+            indexNearest = index;
+            distanceNearest = distance;
+          }
+        }
+      }
+    }
+    return distanceNearest < cellSize ? indexNearest : -1;
+  }
+
+ private:
+  const std::vector<T>& phis;    // phi of the indexed jets
+  const std::vector<T>& etas;    // eta of the indexed jets
+  double cellSize;               // cell size in eta, and minimum cell size in phi
+  double cellSizePhi = 2 * M_PI; // cell size in phi
+  double etaMin = 0.;            // lower edge of the first eta cell
+  int nCellsEta = 0;             // number of cells in eta
+  int nCellsPhi = 0;             // number of cells in phi
+  std::vector<int> cellStart;    // position of the first jet of each cell in jetsInCells
+  std::vector<int> jetsInCells;  // indices of the jets sorted by cell
+
+  int getCellEta(T eta) const { return std::clamp(static_cast<int>((eta - etaMin) / cellSize), 0, nCellsEta - 1); }
+  int getCellPhi(T phi) const { return std::clamp(static_cast<int>(phi / cellSizePhi), 0, nCellsPhi - 1); }
+  int cellIndex(int cellEta, int cellPhi) const { return cellEta * nCellsPhi + cellPhi; }
+};
+
+/**
+ * Geometrical jet matching with bucket indices of the jets in (eta, phi).
+ *
+ * Same matching as `MatchJetsGeometrically`: jets are required to match uniquely - namely: base <-> tag, within
+ * the provided matching distance. Each jet is compared only to the jets of the other collection in the neighbouring
+ * cells instead of building KD-trees of the jets duplicated around the phi boundary.
+ *
+ * NOTE: Assumes, but does not validate, that 0 <= phi < 2pi.
+ *
+ * @param jetsBasePhi Base jet collection phi.
+ * @param jetsBaseEta Base jet collection eta.
+ * @param jetsTagPhi Tag jet collection phi.
+ * @param jetsTagEta Tag jet collection eta.
+ * @param maxMatchingDistance Maximum matching distance.
+ *
+ * @returns (Base to tag index map, tag to base index map) for uniquely matched jets.
+ */
+template <typename T>
+std::tuple<std::vector<int>, std::vector<int>> MatchJetsGeometricallyGrid(
+  const std::vector<T>& jetsBasePhi,
+  const std::vector<T>& jetsBaseEta,
+  const std::vector<T>& jetsTagPhi,
+  const std::vector<T>& jetsTagEta,
+  double maxMatchingDistance)
+{
+  const std::size_t nJetsBase = jetsBaseEta.size();
+  const std::size_t nJetsTag = jetsTagEta.size();
+  std::vector<int> baseToTagMap(nJetsBase, -1);
+  std::vector<int> tagToBaseMap(nJetsTag, -1);
+  if (!(nJetsBase && nJetsTag)) {
+    return std::make_tuple(baseToTagMap, tagToBaseMap);
+  }
+  if (jetsBasePhi.size() != jetsBaseEta.size()) {
+    throw std::invalid_argument("Base collection eta and phi sizes don't match. Check the inputs.");
+  }
+  if (jetsTagPhi.size() != jetsTagEta.size()) {
+    throw std::invalid_argument("Tag collection eta and phi sizes don't match. Check the inputs.");
+  }
+
+  const JetGeoGrid<T> gridBase(jetsBasePhi, jetsBaseEta, maxMatchingDistance);
+  const JetGeoGrid<T> gridTag(jetsTagPhi, jetsTagEta, maxMatchingDistance);
+  for (std::size_t iBase = 0; iBase < nJetsBase; iBase++) {
+    const int iTag = gridTag.findNearest(jetsBasePhi[iBase], jetsBaseEta[iBase]);
+    // true matches are pairs where the base jet is the closest to the tag jet and vice versa
+    if (iTag > -1 && gridBase.findNearest(jetsTagPhi[iTag], jetsTagEta[iTag]) == static_cast<int>(iBase)) {
+      baseToTagMap[iBase] = iTag;
+      tagToBaseMap[iTag] = iBase;
+    }
+  }
+  return std::make_tuple(baseToTagMap, tagToBaseMap);
+}
+
 template <typename T, typename U>
 void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingGeo, std::vector<std::vector<int>>& tagToBaseMatchingGeo, std::vector<double> const& jetRadiiForMatchingDistance, std::vector<double> const& maxMatchingDistancePerJetR)
 {
@@ -344,7 +497,7 @@ void MatchGeo(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::
       jetsTagEta.emplace_back(jetTag.eta());
       jetsTagGlobalIndex.emplace_back(jetTag.globalIndex());
     }
-    std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometrically(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, effectiveMatchingDistance);
+    std::tie(baseToTagMatchingGeoIndex, tagToBaseMatchingGeoIndex) = MatchJetsGeometricallyGrid(jetsBasePhi, jetsBaseEta, jetsTagPhi, jetsTagEta, effectiveMatchingDistance);
     int jetBaseIndex = 0;
     int jetTagIndex = 0;
     for (const auto& jetBase : jetsBasePerCollision) {
@@ -433,21 +586,32 @@ auto constexpr getConstituentId(T const& track)
   }
 }
 
+// trackTagIds optionally holds the hashed constituent ids of tracksTag, used instead of looping over tracksTag
 template <bool isEMCAL, bool isCandidate, bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename O, typename P, typename Q, typename R, typename S>
-float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag)
+float getPtSum(T const& tracksBase, U const& candidatesBase, V const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, R const& fullTracksBase, S const& fullTracksTag, std::unordered_set<int> const* trackTagIds = nullptr)
 {
   std::vector<int> particleTracker;
   float ptSum = 0.;
   for (const auto& trackBase : tracksBase) {
     auto trackBaseId = getConstituentId<jetsTagIsMc>(trackBase);
-    for (const auto& trackTag : tracksTag) {
-      auto trackTagId = getConstituentId<jetsBaseIsMc>(trackTag);
-      if (trackBaseId != -1 && trackBaseId == trackTagId) {
-        ptSum += trackBase.pt();
-        if constexpr (jetsBaseIsMc) {
-          particleTracker.push_back(trackBaseId);
+    if (trackBaseId == -1) {
+      continue;
+    }
+    bool isTrackMatched = false;
+    if (trackTagIds) {
+      isTrackMatched = trackTagIds->count(trackBaseId) > 0;
+    } else {
+      for (const auto& trackTag : tracksTag) {
+        if (trackBaseId == getConstituentId<jetsBaseIsMc>(trackTag)) {
+          isTrackMatched = true;
+          break;
         }
-        break;
+      }
+    }
+    if (isTrackMatched) {
+      ptSum += trackBase.pt();
+      if constexpr (jetsBaseIsMc) {
+        particleTracker.push_back(trackBaseId);
       }
     }
   }
@@ -546,24 +710,65 @@ auto getConstituents(T const& jet, U const& /*constituents*/)
 template <bool jetsBaseIsMc, bool jetsTagIsMc, typename T, typename U, typename V, typename M, typename N, typename O, typename P, typename Q>
 void MatchPt(T const& jetsBasePerCollision, U const& jetsTagPerCollision, std::vector<std::vector<int>>& baseToTagMatchingPt, std::vector<std::vector<int>>& tagToBaseMatchingPt, V const& tracksBase, M const& candidatesBase, N const& clustersBase, O const& tracksTag, P const& candidatesTag, Q const& clustersTag, float minPtFraction)
 {
+  constexpr bool IsEMCAL{jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>()};
+  constexpr bool IsCandidate{(jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>())};
+
+  // hash the track constituents of the tag jets once per collision, and index the tag jets by track constituent
+  std::vector<std::unordered_set<int>> tagTrackIds;
+  std::unordered_map<int, std::vector<int>> tagJetsPerTrackId;
+  for (const auto& jetTag : jetsTagPerCollision) {
+    auto& trackIds = tagTrackIds.emplace_back();
+    for (const auto& trackTag : getConstituents(jetTag, tracksTag)) {
+      const auto trackTagId = getConstituentId<jetsBaseIsMc>(trackTag);
+      if (trackTagId != -1 && trackIds.insert(trackTagId).second) {
+        tagJetsPerTrackId[trackTagId].push_back(tagTrackIds.size() - 1);
+      }
+    }
+  }
+  // with only track constituents, a positive pT fraction can be reached only by jets sharing tracks
+  const bool isSharingTracksRequired = !IsEMCAL && !IsCandidate && minPtFraction >= 0.f;
+  std::vector<bool> isTagSharingTracks(tagTrackIds.size(), true);
+
   float ptSumBase;
   float ptSumTag;
   for (const auto& jetBase : jetsBasePerCollision) {
     auto jetBaseTracks = getConstituents(jetBase, tracksBase);
     auto jetBaseClusters = getConstituents(jetBase, clustersBase);
     auto jetBaseCandidates = getConstituents(jetBase, candidatesBase);
+    std::unordered_set<int> baseTrackIds;
+    for (const auto& trackBase : jetBaseTracks) {
+      const auto trackBaseId = getConstituentId<jetsTagIsMc>(trackBase);
+      if (trackBaseId != -1) {
+        baseTrackIds.insert(trackBaseId);
+      }
+    }
+    if (isSharingTracksRequired) {
+      std::fill(isTagSharingTracks.begin(), isTagSharingTracks.end(), false);
+      for (const auto& trackBaseId : baseTrackIds) {
+        const auto tagJets = tagJetsPerTrackId.find(trackBaseId);
+        if (tagJets == tagJetsPerTrackId.end()) {
+          continue;
+        }
+        for (const auto& iTag : tagJets->second) {
+          isTagSharingTracks[iTag] = true;
+        }
+      }
+    }
+    int iTag = -1;
     for (const auto& jetTag : jetsTagPerCollision) {
+      iTag++;
       if (std::round(jetBase.r()) != std::round(jetTag.r())) {
         continue;
       }
+      if (!isTagSharingTracks[iTag]) {
+        continue;
+      }
       auto jetTagTracks = getConstituents(jetTag, tracksTag);
       auto jetTagClusters = getConstituents(jetTag, clustersTag);
       auto jetTagCandidates = getConstituents(jetTag, candidatesTag);
 
-      constexpr bool IsEMCAL{jetfindingutilities::isEMCALClusterTable<N>() || jetfindingutilities::isEMCALClusterTable<Q>()};
-      constexpr bool IsCandidate{(jetcandidateutilities::isCandidateTable<M>() || jetcandidateutilities::isCandidateMcTable<M>()) && (jetcandidateutilities::isCandidateTable<P>() || jetcandidateutilities::isCandidateMcTable<P>())};
-      ptSumBase = getPtSum<IsEMCAL, IsCandidate, jetsBaseIsMc, jetsTagIsMc>(jetBaseTracks, jetBaseCandidates, jetBaseClusters, jetTagTracks, jetTagCandidates, jetTagClusters, tracksBase, tracksTag);
-      ptSumTag = getPtSum<IsEMCAL, IsCandidate, jetsTagIsMc, jetsBaseIsMc>(jetTagTracks, jetTagCandidates, jetTagClusters, jetBaseTracks, jetBaseCandidates, jetBaseClusters, tracksTag, tracksBase);
+      ptSumBase = getPtSum<IsEMCAL, IsCandidate, jetsBaseIsMc, jetsTagIsMc>(jetBaseTracks, jetBaseCandidates, jetBaseClusters, jetTagTracks, jetTagCandidates, jetTagClusters, tracksBase, tracksTag, &tagTrackIds[iTag]);
+      ptSumTag = getPtSum<IsEMCAL, IsCandidate, jetsTagIsMc, jetsBaseIsMc>(jetTagTracks, jetTagCandidates, jetTagClusters, jetBaseTracks, jetBaseCandidates, jetBaseClusters, tracksTag, tracksBase, &baseTrackIds);
       if (ptSumBase > jetBase.pt() * minPtFraction) {
         baseToTagMatchingPt[jetBase.globalIndex()].push_back(jetTag.globalIndex());
       }
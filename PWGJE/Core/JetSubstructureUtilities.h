@@ -31,7 +31,9 @@
 #include <fastjet/contrib/SoftDrop.hh>
 
 #include <cmath>
+#include <memory>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace jetsubstructureutilities
@@ -118,6 +120,168 @@ std::vector<float> getNSubjettiness(T const& jet, U const& tracks, V const& clus
   return result;
 }
 
+/**
+ * C/A reclustering history of a jet, built once and shared by the substructure observables
+ *
+ * The jet constituents are reclustered once with C/A and the tree is kept until the next jet. The primary splittings
+ * (following the harder branch), the Soft Drop grooming at any (zCut, beta) and the N-subjettiness, with the C/A
+ * exclusive subjets of the tree as axes, are all derived from it instead of reclustering the jet for each observable.
+ */
+class JetReclusteringCache
+{
+ public:
+  /// primary splitting of the reclustered jet
+  struct Splitting {
+    fastjet::PseudoJet mother;     // subjet which splits
+    fastjet::PseudoJet leading;    // harder branch
+    fastjet::PseudoJet subLeading; // softer branch
+    double z;                      // momentum fraction of the softer branch
+    double theta;                  // angle between the two branches
+  };
+
+  /// Soft Drop observables of the primary splittings
+  struct SoftDropResult {
+    double zg = -1.;     // momentum fraction of the first splitting passing the Soft Drop condition
+    double rg = -1.;     // angle of the first splitting passing the Soft Drop condition
+    int nsd = 0;         // number of splittings passing the Soft Drop condition
+    int iSplitting = -1; // index of the first splitting passing the Soft Drop condition, -1 if none
+  };
+
+  JetReclusteringCache()
+  {
+    jetReclusterer.isReclustering = true;
+    jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
+    jetReclusterer.ghostRepeatN = 0;
+  }
+
+  /**
+   * recluster the constituents of a jet with C/A and follow its primary splittings
+   *
+   * @param jetConstituents constituents of the jet
+   * @param jetR jet radius, used as the reference angle of the Soft Drop condition and of the N-subjettiness normalisation
+   * @return whether a reclustered jet was found
+   */
+  bool build(std::vector<fastjet::PseudoJet>& jetConstituents, float jetR)
+  {
+    splittings.clear();
+    jetsReclustered.clear();
+    clusterSeq.reset();
+    jetRadius = jetR;
+    if (jetConstituents.empty()) {
+      return false;
+    }
+    jetReclusterer.jetR = jetR;
+    // the cluster sequence is initialised in place, since the reclustered jets refer to it
+    clusterSeq.reset(new fastjet::ClusterSequenceArea(jetReclusterer.findJets(jetConstituents, jetsReclustered)));
+    if (jetsReclustered.empty()) {
+      clusterSeq.reset();
+      return false;
+    }
+    jetsReclustered = sorted_by_pt(jetsReclustered);
+    fastjet::PseudoJet mother = jetsReclustered[0];
+    fastjet::PseudoJet leading;
+    fastjet::PseudoJet subLeading;
+    while (mother.has_parents(leading, subLeading)) {
+      if (leading.perp() < subLeading.perp()) {
+        std::swap(leading, subLeading);
+      }
+      splittings.push_back({mother, leading, subLeading, subLeading.perp() / (leading.perp() + subLeading.perp()), leading.delta_R(subLeading)});
+      mother = leading;
+    }
+    return true;
+  }
+
+  /// @return whether the cache holds a reclustered jet
+  bool isValid() const { return static_cast<bool>(clusterSeq); }
+
+  /// @return the reclustered jet
+  const fastjet::PseudoJet& getJet() const { return jetsReclustered[0]; }
+
+  /// @return the primary splittings of the reclustered jet, from the first declustering on
+  const std::vector<Splitting>& getSplittings() const { return splittings; }
+
+  /**
+   * Soft Drop observables from the primary splittings, with the condition z >= zCut * (theta / jetR)^beta
+   *
+   * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
+   * @param beta angular exponent in the SoftDrop condition
+   */
+  SoftDropResult getSoftDrop(float zCut, float beta) const
+  {
+    SoftDropResult result;
+    for (std::size_t iSplitting = 0; iSplitting < splittings.size(); iSplitting++) {
+      const auto& splitting = splittings[iSplitting];
+      if (splitting.z >= zCut * std::pow(splitting.theta / jetRadius, beta)) {
+        if (result.iSplitting < 0) {
+          result.zg = splitting.z;
+          result.rg = splitting.theta;
+          result.iSplitting = iSplitting;
+        }
+        result.nsd++;
+      }
+    }
+    return result;
+  }
+
+  /**
+   * Soft Drop groomed jet, the subjet at the first primary splitting passing z >= zCut * (theta / r0)^beta
+   *
+   * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
+   * @param beta angular exponent in the SoftDrop condition
+   * @param r0 reference angle of the SoftDrop condition, 1 as in fastjet::contrib::SoftDrop by default
+   * @return the groomed jet, or the last leading branch if no splitting passes the condition
+   */
+  fastjet::PseudoJet getGroomedJet(float zCut, float beta, float r0 = 1.f) const
+  {
+    for (const auto& splitting : splittings) {
+      if (splitting.z >= zCut * std::pow(splitting.theta / r0, beta)) {
+        return splitting.mother;
+      }
+    }
+    return splittings.empty() ? getJet() : splittings.back().leading;
+  }
+
+  /**
+   * returns a vector with Nsubjettiness variables, with the C/A exclusive subjets of the cached tree as axes
+   *
+   * @param nMax returns a vector filled with TauN values upto N (the first entry is the distance between axes in tau2)
+   * @param doSoftDrop apply SoftDrop
+   * @param zCut minimim momentum sharing fraction needed to satisfy the SoftDrop condition
+   * @param beta angular exponent in the SoftDrop condition
+   */
+  std::vector<float> getNSubjettiness(std::vector<fastjet::PseudoJet>::size_type nMax, bool doSoftDrop = false, float zCut = 0.1, float beta = 0.0) const
+  {
+    std::vector<float> result;
+    for (std::vector<fastjet::PseudoJet>::size_type n = 0; n < nMax + 1; n++) {
+      result.push_back(-1.0 * (n + 1));
+    }
+    if (!isValid()) {
+      return result;
+    }
+    const fastjet::PseudoJet pseudoJet = doSoftDrop ? getGroomedJet(zCut, beta) : getJet();
+    for (std::vector<fastjet::PseudoJet>::size_type n = 1; n <= nMax; n++) {
+      if (pseudoJet.constituents().size() < n) { // Tau_N needs at least N tracks
+        return result;
+      }
+      const std::vector<fastjet::PseudoJet> nSubAxes = pseudoJet.exclusive_subjets(n);
+      fastjet::contrib::Nsubjettiness nSub(n, fastjet::contrib::ManualAxes(), fastjet::contrib::NormalizedMeasure(1.0, jetRadius));
+      nSub.setAxes(nSubAxes);
+      result[n] = nSub.result(pseudoJet);
+      if (n == 2) {
+        result[0] = nSubAxes[0].delta_R(nSubAxes[1]); // distance between axes for 2-subjettiness
+      }
+    }
+    return result;
+  }
+
+ private:
+  JetFinder jetReclusterer;                                 // C/A reclusterer of the jet constituents
+  std::unique_ptr<fastjet::ClusterSequenceArea> clusterSeq; // cluster sequence of the reclustered jet
+  std::vector<fastjet::PseudoJet> jetsReclustered;          // reclustered jets, the leading one first
+  std::vector<Splitting> splittings;                        // primary splittings of the leading reclustered jet
+  float jetRadius = 0.4;                                    // jet radius
+};
+
 }; // namespace jetsubstructureutilities
 
 #endif // PWGJE_CORE_JETSUBSTRUCTUREUTILITIES_H_
@@ -0,0 +1,406 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     benchmarkJetCore.cxx
+///
+/// \brief    Standalone benchmark of the PWGJE core utilities on fixed pp and Pb-Pb event samples
+///
+/// The particles of each event class are generated once with a fixed seed (a soft thermal component with the
+/// multiplicity of the class and a back-to-back hard scattering) and the same events are replayed through the stages
+/// of a jet analysis:
+///   - jetFinding: anti-kT jets with active areas from JetFinder::findJets
+///   - rhoEstimation: median background density from JetBkgSubUtils::estimateRhoAreaMedian
+///   - rhoAreaSubtraction: area subtraction of the jets with JetBkgSubUtils::doRhoAreaSub
+///   - eventConstSubFastJet / eventConstSubNative: event-wise constituent subtraction, fastjet contrib vs native
+///   - geometricalMatching: matching to the jets of a smeared detector-level copy of the event, MatchJetsGeometricallyGrid
+///   - substructure: C/A reclustering, Soft Drop and N-subjettiness of the jets with JetReclusteringCache
+/// For each event class and stage, the time, the number of heap allocations and the allocated bytes per event are
+/// measured, together with the peak resident memory of the process after the class. The pp class runs first, so that
+/// its peak memory is not inflated by the Pb-Pb class. One JSON object per measurement is written to the report file, e.g.
+///
+///   o2-bench-jet-core-throughput --events-pp 2000 --events-pbpb 50 --output report.json
+///
+
+#include "PWGJE/Core/JetBkgSubUtils.h"
+#include "PWGJE/Core/JetFinder.h"
+#include "PWGJE/Core/JetMatchingUtilities.h"
+#include "PWGJE/Core/JetSubstructureUtilities.h"
+
+#include <Framework/Logger.h>
+
+#include <fastjet/ClusterSequenceArea.hh>
+#include <fastjet/GhostedAreaSpec.hh>
+#include <fastjet/PseudoJet.hh>
+
+#include <boost/program_options.hpp> // IWYU pragma: keep
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace bpo = boost::program_options;
+
+namespace
+{
+
+std::atomic<std::size_t> nAllocations{0};    // number of heap allocations of the process
+std::atomic<std::size_t> nAllocatedBytes{0}; // number of bytes allocated on the heap by the process
+
+} // namespace
+
+// the global allocation functions are replaced to count the heap allocations of each stage
+void* operator new(std::size_t size)
+{
+  nAllocations.fetch_add(1, std::memory_order_relaxed);
+  nAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* pointer = std::malloc(size == 0 ? 1 : size)) {
+    return pointer;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+namespace
+{
+
+constexpr double MassPion = 0.13957;       // mass assigned to the particles (GeV/c^2)
+constexpr double EtaMax = 0.9;             // acceptance of the particles
+constexpr double SoftTemperature = 0.3;    // inverse slope of the soft component (GeV/c)
+constexpr double SoftPtMin = 0.15;         // minimum pT of the particles (GeV/c)
+constexpr int NFragments = 10;             // number of particles per hard parton
+constexpr double FragmentWidth = 0.1;      // spread of the fragments around the parton direction
+constexpr double TrackingEfficiency = 0.9; // probability to keep a particle at detector level
+constexpr double PtResolution = 0.02;      // relative pT resolution at detector level
+
+/// Stages of the jet analysis, in the order in which they run
+enum Stage : int {
+  JetFinding = 0,
+  RhoEstimation,
+  RhoAreaSubtraction,
+  EventConstSubFastJet,
+  EventConstSubNative,
+  GeometricalMatching,
+  Substructure,
+  NStages
+};
+
+const std::vector<std::string> stageNames = {"jetFinding", "rhoEstimation", "rhoAreaSubtraction", "eventConstSubFastJet", "eventConstSubNative", "geometricalMatching", "substructure"};
+
+/// Parameters of the generated events of a collision system
+struct EventClass {
+  std::string name;
+  std::size_t nEvents = 0;
+  double meanMultiplicity = 0.; // mean number of soft particles in the acceptance
+  double hardPtMin = 0.;        // minimum pT of the hard partons (GeV/c)
+  double hardPtMax = 0.;        // maximum pT of the hard partons (GeV/c)
+};
+
+/// Measurement of one stage over all the events of a class
+struct StageResult {
+  std::string eventClass;
+  std::string stage;
+  std::size_t nEvents = 0;
+  double totalTime = 0.;        // microseconds
+  std::size_t nAllocations = 0; // heap allocations
+  std::size_t nBytes = 0;       // allocated bytes
+  long peakRss = 0;             // peak resident memory of the process after the class, kB
+  double checksum = 0.;         // sum of the outputs, to keep the computation alive
+};
+
+/// Accumulates the time and the heap allocations of its scope into a stage
+class ScopedMeasurement
+{
+ public:
+  explicit ScopedMeasurement(StageResult& stageResult) : result(stageResult), allocationsStart(nAllocations.load(std::memory_order_relaxed)), bytesStart(nAllocatedBytes.load(std::memory_order_relaxed)), start(std::chrono::steady_clock::now()) {}
+
+  ~ScopedMeasurement()
+  {
+    result.totalTime += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    result.nAllocations += nAllocations.load(std::memory_order_relaxed) - allocationsStart;
+    result.nBytes += nAllocatedBytes.load(std::memory_order_relaxed) - bytesStart;
+  }
+
+ private:
+  StageResult& result;
+  std::size_t allocationsStart;
+  std::size_t bytesStart;
+  std::chrono::steady_clock::time_point start;
+};
+
+/// Adds a particle of the acceptance to the event
+void addParticle(std::vector<fastjet::PseudoJet>& particles, const double pt, const double eta, const double phi)
+{
+  if (std::abs(eta) > EtaMax || pt < SoftPtMin) {
+    return;
+  }
+  const double px = pt * std::cos(phi);
+  const double py = pt * std::sin(phi);
+  const double pz = pt * std::sinh(eta);
+  fastjet::PseudoJet particle(px, py, pz, std::sqrt(px * px + py * py + pz * pz + MassPion * MassPion));
+  particle.set_user_index(static_cast<int>(particles.size()));
+  particles.push_back(particle);
+}
+
+/// Generates the particles of an event: thermal soft particles and the fragments of two back-to-back partons
+void generateEvent(std::vector<fastjet::PseudoJet>& particles, const EventClass& eventClass, std::mt19937& generator)
+{
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gaus(0., 1.);
+  std::poisson_distribution<int> multiplicity(eventClass.meanMultiplicity);
+  particles.clear();
+  const int nSoft = multiplicity(generator);
+  for (int iParticle = 0; iParticle < nSoft; iParticle++) {
+    const double pt = SoftPtMin - SoftTemperature * std::log(uniform(generator) * uniform(generator));
+    addParticle(particles, pt, EtaMax * (2. * uniform(generator) - 1.), 2. * M_PI * uniform(generator));
+  }
+  const double hardPt = eventClass.hardPtMin + (eventClass.hardPtMax - eventClass.hardPtMin) * uniform(generator);
+  const double partonEta = 0.5 * (2. * uniform(generator) - 1.);
+  const double partonPhi = 2. * M_PI * uniform(generator);
+  std::vector<double> weights(NFragments);
+  for (int iParton = 0; iParton < 2; iParton++) {
+    double sumWeights = 0.;
+    for (auto& weight : weights) {
+      weight = -std::log(uniform(generator));
+      sumWeights += weight;
+    }
+    for (const auto& weight : weights) {
+      const double phi = std::fmod(partonPhi + iParton * M_PI + FragmentWidth * gaus(generator) + 4. * M_PI, 2. * M_PI);
+      addParticle(particles, hardPt * weight / sumWeights, (iParton == 0 ? partonEta : -partonEta) + FragmentWidth * gaus(generator), phi);
+    }
+  }
+}
+
+/// Detector-level copy of an event, with a tracking efficiency and a pT resolution
+void smearEvent(const std::vector<fastjet::PseudoJet>& particles, std::vector<fastjet::PseudoJet>& tracks, std::mt19937& generator)
+{
+  std::uniform_real_distribution<double> uniform(0., 1.);
+  std::normal_distribution<double> gaus(0., 1.);
+  tracks.clear();
+  for (const auto& particle : particles) {
+    if (uniform(generator) > TrackingEfficiency) {
+      continue;
+    }
+    addParticle(tracks, particle.pt() * (1. + PtResolution * gaus(generator)), particle.eta(), particle.phi());
+  }
+}
+
+/// \return the peak resident memory of the process, in kB
+long getPeakRss()
+{
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+std::string toJson(const StageResult& result)
+{
+  const double nEvents = std::max<std::size_t>(result.nEvents, 1);
+  std::stringstream ss;
+  ss << "{\"eventClass\": \"" << result.eventClass << "\", \"stage\": \"" << result.stage << "\", \"nEvents\": " << result.nEvents
+     << ", \"meanLatencyUs\": " << result.totalTime / nEvents << ", \"allocationsPerEvent\": " << result.nAllocations / nEvents
+     << ", \"bytesPerEvent\": " << result.nBytes / nEvents << ", \"peakRssKb\": " << result.peakRss
+     << ", \"checksum\": " << result.checksum << "}";
+  return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  bpo::options_description options("Allowed options");
+  options.add_options()(
+    "help,h", "Print this help")(
+    "events-pp", bpo::value<std::size_t>()->default_value(2000), "Number of pp events")(
+    "events-pbpb", bpo::value<std::size_t>()->default_value(50), "Number of Pb-Pb events")(
+    "multiplicity-pp", bpo::value<double>()->default_value(15.), "Mean number of soft particles of the pp events")(
+    "multiplicity-pbpb", bpo::value<double>()->default_value(2800.), "Mean number of soft particles of the Pb-Pb events")(
+    "jet-r", bpo::value<float>()->default_value(0.4f), "Jet radius")(
+    "bkg-jet-r", bpo::value<float>()->default_value(0.2f), "Jet radius of the background estimation")(
+    "substructure-pt-min", bpo::value<double>()->default_value(10.), "Minimum pT of the jets of the substructure stage (GeV/c)")(
+    "ghost-grid-cache", bpo::value<bool>()->default_value(true), "Take the ghosts of the background estimation from the cached grids")(
+    "seed", bpo::value<unsigned int>()->default_value(42), "Seed of the generated events")(
+    "output,o", bpo::value<std::string>()->default_value("jetCoreBenchmark.json"), "Output report (one JSON object per line)");
+
+  bpo::variables_map arguments;
+  try {
+    bpo::store(parse_command_line(argc, argv, options), arguments);
+    bpo::notify(arguments);
+  } catch (const bpo::error& e) {
+    LOG(error) << e.what();
+    std::cout << options << std::endl;
+    return 1;
+  }
+  if (arguments.count("help")) {
+    std::cout << options << std::endl;
+    return 0;
+  }
+
+  const float jetR = arguments["jet-r"].as<float>();
+  const double substructurePtMin = arguments["substructure-pt-min"].as<double>();
+  const std::vector<EventClass> eventClasses = {{"pp", arguments["events-pp"].as<std::size_t>(), arguments["multiplicity-pp"].as<double>(), 5., 60.},
+                                                {"PbPb", arguments["events-pbpb"].as<std::size_t>(), arguments["multiplicity-pbpb"].as<double>(), 20., 120.}};
+
+  JetFinder jetFinder;
+  jetFinder.etaMin = -EtaMax;
+  jetFinder.etaMax = EtaMax;
+  jetFinder.phiMin = -1.0 * M_PI;
+  jetFinder.phiMax = 2.0 * M_PI;
+  jetFinder.jetR = jetR;
+  jetFinder.jetEtaDefault = true;
+
+  JetBkgSubUtils bkgSub;
+  bkgSub.setJetBkgR(arguments["bkg-jet-r"].as<float>());
+  bkgSub.setEtaMinMax(-EtaMax, EtaMax);
+  bkgSub.setPhiMinMax(0., 2.0 * M_PI);
+  bkgSub.setGhostAreaSpec(fastjet::GhostedAreaSpec(EtaMax, 1, 0.005));
+  bkgSub.setUseGhostGridCache(arguments["ghost-grid-cache"].as<bool>());
+
+  jetsubstructureutilities::JetReclusteringCache reclusteringCache;
+
+  std::ofstream report(arguments["output"].as<std::string>());
+  std::vector<StageResult> results;
+  std::mt19937 generator(arguments["seed"].as<unsigned int>());
+  for (const auto& eventClass : eventClasses) {
+    // the events are generated before the measurements, so that only the replay is measured
+    std::vector<std::vector<fastjet::PseudoJet>> events(eventClass.nEvents);
+    std::vector<std::vector<fastjet::PseudoJet>> eventsDetector(eventClass.nEvents);
+    for (std::size_t iEvent = 0; iEvent < eventClass.nEvents; iEvent++) {
+      generateEvent(events[iEvent], eventClass, generator);
+      smearEvent(events[iEvent], eventsDetector[iEvent], generator);
+    }
+
+    std::vector<StageResult> stages(NStages);
+    for (int iStage = 0; iStage < NStages; iStage++) {
+      stages[iStage].eventClass = eventClass.name;
+      stages[iStage].stage = stageNames[iStage];
+      stages[iStage].nEvents = eventClass.nEvents;
+    }
+
+    std::vector<fastjet::PseudoJet> inputParticles;
+    std::vector<fastjet::PseudoJet> jets;
+    std::vector<fastjet::PseudoJet> jetsDetector;
+    std::vector<fastjet::PseudoJet> jetConstituents;
+    std::vector<float> jetsPhi;
+    std::vector<float> jetsEta;
+    std::vector<float> jetsDetectorPhi;
+    std::vector<float> jetsDetectorEta;
+    for (std::size_t iEvent = 0; iEvent < eventClass.nEvents; iEvent++) {
+      inputParticles = events[iEvent];
+      jets.clear();
+      std::unique_ptr<fastjet::ClusterSequenceArea> clusterSeq;
+      {
+        ScopedMeasurement measurement(stages[JetFinding]);
+        clusterSeq.reset(new fastjet::ClusterSequenceArea(jetFinder.findJets(inputParticles, jets)));
+      }
+      for (const auto& jet : jets) {
+        stages[JetFinding].checksum += jet.pt();
+      }
+
+      double rho = 0., rhoM = 0.;
+      {
+        ScopedMeasurement measurement(stages[RhoEstimation]);
+        std::tie(rho, rhoM) = bkgSub.estimateRhoAreaMedian(inputParticles, false);
+      }
+      stages[RhoEstimation].checksum += rho;
+
+      {
+        ScopedMeasurement measurement(stages[RhoAreaSubtraction]);
+        for (const auto& jet : jets) {
+          stages[RhoAreaSubtraction].checksum += bkgSub.doRhoAreaSub(jet, rho, rhoM).pt();
+        }
+      }
+
+      inputParticles = events[iEvent];
+      {
+        ScopedMeasurement measurement(stages[EventConstSubFastJet]);
+        for (const auto& particle : bkgSub.doEventConstSubFastJet(inputParticles, rho, rhoM)) {
+          stages[EventConstSubFastJet].checksum += particle.pt();
+        }
+      }
+      {
+        ScopedMeasurement measurement(stages[EventConstSubNative]);
+        for (const auto& particle : bkgSub.doEventConstSubNative(events[iEvent], rho, rhoM)) {
+          stages[EventConstSubNative].checksum += particle.pt();
+        }
+      }
+
+      inputParticles = eventsDetector[iEvent];
+      jetsDetector.clear();
+      auto clusterSeqDetector(jetFinder.findJets(inputParticles, jetsDetector));
+      {
+        ScopedMeasurement measurement(stages[GeometricalMatching]);
+        jetsPhi.clear();
+        jetsEta.clear();
+        for (const auto& jet : jets) {
+          jetsPhi.push_back(jet.phi());
+          jetsEta.push_back(jet.eta());
+        }
+        jetsDetectorPhi.clear();
+        jetsDetectorEta.clear();
+        for (const auto& jet : jetsDetector) {
+          jetsDetectorPhi.push_back(jet.phi());
+          jetsDetectorEta.push_back(jet.eta());
+        }
+        auto [baseToTag, tagToBase] = jetmatchingutilities::MatchJetsGeometricallyGrid(jetsDetectorPhi, jetsDetectorEta, jetsPhi, jetsEta, 0.6 * jetR);
+        stages[GeometricalMatching].checksum += std::count_if(baseToTag.begin(), baseToTag.end(), [](int iTag) { return iTag >= 0; });
+      }
+
+      {
+        ScopedMeasurement measurement(stages[Substructure]);
+        for (const auto& jet : jets) {
+          if (jet.pt() < substructurePtMin) {
+            continue;
+          }
+          jetConstituents = jet.constituents();
+          if (!reclusteringCache.build(jetConstituents, jetR)) {
+            continue;
+          }
+          stages[Substructure].checksum += reclusteringCache.getSoftDrop(0.1, 0.).zg;
+          stages[Substructure].checksum += reclusteringCache.getNSubjettiness(2, true, 0.1, 0.)[2];
+        }
+      }
+    }
+
+    const long peakRss = getPeakRss();
+    for (auto& result : stages) {
+      result.peakRss = peakRss;
+      const double nEvents = std::max<std::size_t>(result.nEvents, 1);
+      LOGP(info, "{} [{}]: {:.1f} us, {:.1f} allocations and {:.0f} bytes per event over {} events, peak RSS {} kB (checksum {:.6g})",
+           result.eventClass, result.stage, result.totalTime / nEvents, result.nAllocations / nEvents, result.nBytes / nEvents,
+           result.nEvents, result.peakRss, result.checksum);
+      report << toJson(result) << std::endl;
+      results.push_back(result);
+    }
+  }
+
+  LOG(info) << "Wrote " << results.size() << " benchmark results to " << arguments["output"].as<std::string>();
+  return 0;
+} // main
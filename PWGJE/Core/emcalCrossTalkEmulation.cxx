@@ -25,14 +25,12 @@
 
 #include <TRandom3.h>
 
-#include <algorithm> // std::find_if
 #include <array>
 #include <cstddef> // size_t
 #include <cstdint>
 #include <cstdlib> // std::abs
 #include <iomanip> // setw
 #include <ios>     // left and right
-#include <iterator>
 #include <ostream>
 #include <sstream>
 #include <string>
@@ -196,6 +194,15 @@ void EMCCrossTalk::setCells(std::vector<o2::emcal::Cell>& cells, std::vector<o2:
   mCells = &cells;
   mCellsTmp = cells; // a copy since we will need one vector with the changed energies and one with the original ones
   mCellLabels = &cellLabels;
+
+  // index the original cells by tower, keeping the first cell of each tower as std::find_if would
+  mCellIndex.fill(-1);
+  for (size_t iCell = 0; iCell < cells.size(); ++iCell) {
+    int& index = mCellIndex[cells[iCell].getTower()];
+    if (index < 0) {
+      index = iCell;
+    }
+  }
 }
 
 void EMCCrossTalk::calculateInducedEnergyInTCardCell(int absId, int absIdRef, int iSM, float ampRef, int cellCase)
@@ -262,13 +269,9 @@ void EMCCrossTalk::calculateInducedEnergyInTCardCell(int absId, int absIdRef, in
 
   // Try to find the cell that will get energy induced
   float amp = 0.f;
-  auto itCell = std::find_if((*mCells).begin(), (*mCells).end(), [absId](const o2::emcal::Cell& cell) {
-    return cell.getTower() == absId;
-  });
-
-  if (itCell != (*mCells).end()) {
+  if (mCellIndex[absId] >= 0) {
     // We found a cell, so let's get the amplitude of that cell
-    amp = itCell->getAmplitude();
+    amp = (*mCells)[mCellIndex[absId]].getAmplitude();
   } else {
     amp = 0.f; // this is a new cell, so the base amp is 0.f
   }
@@ -531,17 +534,13 @@ void EMCCrossTalk::addInducedEnergiesToNewCells()
         // Try to find the cell that will get energy induced
         float ampi = 0.f;
         size_t indexInCells = 0;
-        auto itCell = std::find_if((*mCells).begin(), (*mCells).begin() + nCells, [absIDi](const o2::emcal::Cell& cell) {
-          return cell.getTower() == absIDi;
-        });
-
-        if (itCell != (*mCells).begin() + nCells) {
+        if (mCellIndex[absIDi] >= 0) {
           // We found a cell, so let's get the amplitude of that cell
-          ampi = itCell->getAmplitude();
+          indexInCells = mCellIndex[absIDi];
+          ampi = (*mCells)[indexInCells].getAmplitude();
           if (ampi <= ampMax) {
             continue; // early continue if the new amplitude is not the biggest one
           }
-          indexInCells = std::distance((*mCells).begin(), itCell);
           LOGF(debug, "Found cell with index %d", indexInCells);
         } else {
           continue;
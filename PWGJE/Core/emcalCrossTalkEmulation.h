@@ -150,7 +150,7 @@ class EMCCrossTalk
   /// \details mTCardCorrCellsEner and mTCardCorrCellsNew
   void resetArrays();
 
-  /// \brief Sets the pointer the current vector of cells.
+  /// \brief Sets the pointer the current vector of cells and indexes the cells by tower.
   /// \param cells pointer to emcal cells of the current event
   /// \param cellLabels pointer to emcal cell labels of the current event
   void setCells(std::vector<o2::emcal::Cell>& cells, std::vector<o2::emcal::CellLabel>& cellLabels);
@@ -182,6 +182,7 @@ class EMCCrossTalk
   bool mTCardCorrClusEnerConserv;                // When making correlation, subtract from the reference cell the induced energy on the neighbour cells
   std::array<float, NCells> mTCardCorrCellsEner; //  Array with induced cell energy in T-Card neighbour cells
   std::array<bool, NCells> mTCardCorrCellsNew;   //  Array with induced cell energy in T-Card neighbour cells, that before had no signal
+  std::array<int, NCells> mCellIndex;            //  Index of each tower in the original cells of the current event, -1 if the tower has no cell
 
   o2::framework::Array2D<float> mTCardCorrInduceEner;           // Induced energy loss gauss constant on 0-same row, diff col, 1-up/down cells left/right col 2-left/righ col, and 2nd row cells, param 0
   o2::framework::Array2D<float> mTCardCorrInduceEnerFrac;       // Induced energy loss gauss fraction param0 on 0-same row, diff col, 1-up/down cells left/right col 2-left/righ col, and 2nd row cells, param 0
@@ -24,6 +24,7 @@
 #include <limits>
 #include <span>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
 namespace tmemcutilities
@@ -114,6 +115,143 @@ MatchResult matchTracksToCluster(
   }
   return result;
 }
+
+/**
+ * Flat grid of the tracks in (eta, phi), reused to match the clusters of all the events.
+ *
+ * Same matching as `matchTracksToCluster`, but the buffers of the grid and of the result are kept between the events
+ * and rebuilt in place, so that no memory is allocated once the capacity of the largest event is reached. The cells are
+ * at least as large as the matching distance, so all the tracks matched to a cluster are in the 3x3 cells around it.
+ * The matches of each cluster are sorted by increasing distance, equidistant tracks by index.
+ */
+class TrackClusterMatcher
+{
+ public:
+  /**
+   * Match the clusters of an event to the tracks.
+   *
+   * @param clusterPhi cluster collection phi.
+   * @param clusterEta cluster collection eta.
+   * @param trackPhi track collection phi.
+   * @param trackEta track collection eta.
+   * @param maxMatchingDistance Maximum matching distance.
+   * @param maxNumberMatches Maximum number of matches (e.g. 5 closest).
+   * @param result cluster to track index map, overwritten.
+   */
+  void match(
+    std::span<const float> clusterPhi,
+    std::span<const float> clusterEta,
+    std::span<const float> trackPhi,
+    std::span<const float> trackEta,
+    double maxMatchingDistance,
+    int maxNumberMatches,
+    MatchResult& result)
+  {
+    const std::size_t nClusters = clusterEta.size();
+    const std::size_t nTracks = trackEta.size();
+    if (nClusters == 0 || nTracks == 0) {
+      result.matchIndexTrack.clear();
+      result.matchDeltaPhi.clear();
+      result.matchDeltaEta.clear();
+      return;
+    }
+    if (clusterPhi.size() != clusterEta.size()) {
+      throw std::invalid_argument("cluster collection eta and phi sizes don't match. Check the inputs.");
+    }
+    if (trackPhi.size() != trackEta.size()) {
+      throw std::invalid_argument("track collection eta and phi sizes don't match. Check the inputs.");
+    }
+    result.matchIndexTrack.resize(nClusters);
+    result.matchDeltaPhi.resize(nClusters);
+    result.matchDeltaEta.resize(nClusters);
+
+    build(trackPhi, trackEta, maxMatchingDistance);
+    const auto nMatchesMax = static_cast<std::size_t>(std::max(maxNumberMatches, 0));
+    for (std::size_t iCluster = 0; iCluster < nClusters; iCluster++) {
+      // collect the tracks within the matching distance in the neighbouring cells
+      candidates.clear();
+      const int cellEta = static_cast<int>(std::floor((clusterEta[iCluster] - etaMin) / cellSizeEta));
+      const int cellPhi = static_cast<int>(std::floor((clusterPhi[iCluster] - phiMin) / cellSizePhi));
+      for (int iEta = std::max(cellEta - 1, 0); iEta <= std::min(cellEta + 1, nCellsEta - 1); iEta++) {
+        for (int iPhi = std::max(cellPhi - 1, 0); iPhi <= std::min(cellPhi + 1, nCellsPhi - 1); iPhi++) {
+          const int cell = iEta * nCellsPhi + iPhi;
+          for (int iTrack = cellStart[cell]; iTrack < cellStart[cell + 1]; iTrack++) {
+            const int index = tracksInCells[iTrack];
+            const float deltaEta = trackEta[index] - clusterEta[iCluster];
+            const float deltaPhi = trackPhi[index] - clusterPhi[iCluster];
+            const float distance = std::sqrt(deltaEta * deltaEta + deltaPhi * deltaPhi);
+            if (distance < maxMatchingDistance) {
+              candidates.emplace_back(distance, index);
+            }
+          }
+        }
+      }
+      const std::size_t nMatches = std::min(candidates.size(), nMatchesMax);
+      std::partial_sort(candidates.begin(), candidates.begin() + nMatches, candidates.end());
+
+      auto& indices = result.matchIndexTrack[iCluster];
+      auto& deltaPhis = result.matchDeltaPhi[iCluster];
+      auto& deltaEtas = result.matchDeltaEta[iCluster];
+      indices.clear();
+      deltaPhis.clear();
+      deltaEtas.clear();
+      for (std::size_t iMatch = 0; iMatch < nMatches; iMatch++) {
+        const int index = candidates[iMatch].second;
+        indices.push_back(index);
+        deltaPhis.push_back(trackPhi[index] - clusterPhi[iCluster]);
+        deltaEtas.push_back(trackEta[index] - clusterEta[iCluster]);
+      }
+    }
+  }
+
+ private:
+  static constexpr int MaxCellsPerAxis = 256;  // maximum number of cells along eta and phi
+  static constexpr float MinCellSize = 1.e-3f; // minimum cell size, for a vanishing matching distance
+
+  float etaMin = 0.f;                            // lower edge of the first eta cell
+  float phiMin = 0.f;                            // lower edge of the first phi cell
+  float cellSizeEta = 1.f;                       // cell size in eta
+  float cellSizePhi = 1.f;                       // cell size in phi
+  int nCellsEta = 0;                             // number of cells in eta
+  int nCellsPhi = 0;                             // number of cells in phi
+  std::vector<int> cellStart;                    // position of the first track of each cell in tracksInCells
+  std::vector<int> cellFill;                     // next free position of each cell in tracksInCells, while building
+  std::vector<int> trackCells;                   // cell of each track
+  std::vector<int> tracksInCells;                // indices of the tracks sorted by cell
+  std::vector<std::pair<float, int>> candidates; // (distance, index) of the tracks matched to the current cluster
+
+  /// Rebuild the grid in place for the tracks of the event
+  void build(std::span<const float> trackPhi, std::span<const float> trackEta, double maxMatchingDistance)
+  {
+    const auto [etaLow, etaHigh] = std::minmax_element(trackEta.begin(), trackEta.end());
+    const auto [phiLow, phiHigh] = std::minmax_element(trackPhi.begin(), trackPhi.end());
+    etaMin = *etaLow;
+    phiMin = *phiLow;
+    cellSizeEta = std::max({static_cast<float>(maxMatchingDistance), (*etaHigh - etaMin) / MaxCellsPerAxis, MinCellSize});
+    cellSizePhi = std::max({static_cast<float>(maxMatchingDistance), (*phiHigh - phiMin) / MaxCellsPerAxis, MinCellSize});
+    nCellsEta = static_cast<int>((*etaHigh - etaMin) / cellSizeEta) + 1;
+    nCellsPhi = static_cast<int>((*phiHigh - phiMin) / cellSizePhi) + 1;
+
+    const std::size_t nTracks = trackEta.size();
+    const std::size_t nCells = static_cast<std::size_t>(nCellsEta) * nCellsPhi;
+    cellStart.assign(nCells + 1, 0);
+    trackCells.resize(nTracks);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      const int iEta = std::min(static_cast<int>((trackEta[iTrack] - etaMin) / cellSizeEta), nCellsEta - 1);
+      const int iPhi = std::min(static_cast<int>((trackPhi[iTrack] - phiMin) / cellSizePhi), nCellsPhi - 1);
+      trackCells[iTrack] = iEta * nCellsPhi + iPhi;
+      cellStart[trackCells[iTrack] + 1]++;
+    }
+    for (std::size_t iCell = 0; iCell < nCells; iCell++) {
+      cellStart[iCell + 1] += cellStart[iCell];
+    }
+    cellFill.assign(cellStart.begin(), cellStart.end() - 1);
+    tracksInCells.resize(nTracks);
+    for (std::size_t iTrack = 0; iTrack < nTracks; iTrack++) {
+      tracksInCells[cellFill[trackCells[iTrack]]++] = static_cast<int>(iTrack);
+    }
+  }
+};
 }; // namespace tmemcutilities
 
 #endif // PWGJE_CORE_UTILSTRACKMATCHINGEMC_H_
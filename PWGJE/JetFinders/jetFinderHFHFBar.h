@@ -115,6 +115,7 @@ struct JetFinderHFHFBarTask {
   o2::framework::Configurable<int> jetPtBinWidth{"jetPtBinWidth", 5, "used to define the width of the jetPt bins for the THnSparse"};
   o2::framework::Configurable<bool> fillTHnSparse{"fillTHnSparse", false, "switch to fill the THnSparse"};
   o2::framework::Configurable<double> jetExtraParam{"jetExtraParam", -99.0, "sets the _extra_param in fastjet"};
+  o2::framework::Configurable<bool> doMultiRJetFinding{"doMultiRJetFinding", false, "find the jets of all the radii in one call, sharing the ghosts and for C/A the clustering"};
 
   o2::framework::Service<o2::framework::O2DatabasePDG> pdgDatabase;
   int trackSelection = -1;
@@ -162,6 +163,7 @@ struct JetFinderHFHFBarTask {
       jetFinder.isTriggering = true;
     }
     jetFinder.fastjetExtraParam = jetExtraParam;
+    jetFinder.isMultiR = doMultiRJetFinding;
 
     auto jetRadiiBins = (std::vector<double>)jetRadius;
     if (jetRadiiBins.size() > 1) {
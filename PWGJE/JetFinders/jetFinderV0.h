@@ -95,6 +95,7 @@ struct JetFinderV0Task {
   o2::framework::Configurable<int> jetPtBinWidth{"jetPtBinWidth", 5, "used to define the width of the jetPt bins for the THnSparse"};
   o2::framework::Configurable<bool> fillTHnSparse{"fillTHnSparse", true, "switch to fill the THnSparse"};
   o2::framework::Configurable<double> jetExtraParam{"jetExtraParam", -99.0, "sets the _extra_param in fastjet"};
+  o2::framework::Configurable<bool> doMultiRJetFinding{"doMultiRJetFinding", false, "find the jets of all the radii in one call, sharing the ghosts and for C/A the clustering"};
   o2::framework::Configurable<bool> useV0SignalFlags{"useV0SignalFlags", true, "use V0 signal flags table"};
   o2::framework::Configurable<bool> saveJetsWithCandidatesOnly{"saveJetsWithCandidatesOnly", true, "only save jets if they contain a V0"};
 
@@ -146,6 +147,7 @@ struct JetFinderV0Task {
       jetFinder.isTriggering = true;
     }
     jetFinder.fastjetExtraParam = jetExtraParam;
+    jetFinder.isMultiR = doMultiRJetFinding;
 
     if (candPDG == 310) {
       candIndex = 0;
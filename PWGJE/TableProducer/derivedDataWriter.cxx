@@ -249,8 +249,6 @@ struct JetDerivedDataWriter {
   } products;
 
   struct : PresliceGroup {
-    Preslice<soa::Join<aod::JTracks, aod::JTrackExtras, aod::JTrackPIs>> TracksPerCollision = aod::jtrack::collisionId;
-
     Preslice<soa::Join<aod::JMcParticles, aod::JMcParticlePIs>> ParticlesPerMcCollision = aod::jmcparticle::mcCollisionId;
     Preslice<aod::McCollisionsD0> D0McCollisionsPerMcCollision = aod::jcandidateindices::mcCollisionId;
     Preslice<aod::McCollisionsDplus> DplusMcCollisionsPerMcCollision = aod::jcandidateindices::mcCollisionId;
@@ -424,6 +422,8 @@ struct JetDerivedDataWriter {
   std::vector<int32_t> collisionMapping;
   std::vector<int32_t> bcMapping;
   std::vector<int32_t> trackMapping;
+  std::vector<uint8_t> isCollisionSelectedMask;
+  std::vector<uint8_t> isTrackSelectedMask;
   std::vector<int32_t> mcCollisionMapping;
   std::vector<int32_t> particleMapping;
   std::vector<int32_t> d0McCollisionMapping;
@@ -438,17 +438,15 @@ struct JetDerivedDataWriter {
 
   void processBCs(soa::Join<aod::JCollisions, aod::JCollisionSelections> const& collisions, soa::Join<aod::JBCs, aod::JBCPIs> const& bcs)
   {
-    std::vector<int32_t> bcIndicies;
     bcMapping.clear();
     bcMapping.resize(bcs.size(), -1);
 
     for (auto const& collision : collisions) {
       if (collision.isCollisionSelected()) {
         auto bc = collision.bc_as<soa::Join<aod::JBCs, aod::JBCPIs>>();
-        if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
+        if (bcMapping[bc.globalIndex()] < 0) { // each bunch crossing is stored once
           products.storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.triggerMask(), bc.timestamp(), bc.alias_raw(), bc.selection_raw(), bc.rct_raw());
           products.storedJBCParentIndexTable(bc.bcId());
-          bcIndicies.push_back(bc.globalIndex());
           bcMapping[bc.globalIndex()] = products.storedJBCsTable.lastIndex();
         }
       }
@@ -458,16 +456,14 @@ struct JetDerivedDataWriter {
 
   void processBCsForMcGenOnly(soa::Join<aod::JMcCollisions, aod::JMcCollisionSelections> const& mcCollisions, aod::JBCs const& bcs)
   {
-    std::vector<int32_t> bcIndicies;
     bcMapping.clear();
     bcMapping.resize(bcs.size(), -1);
 
     for (auto const& mcCollision : mcCollisions) {
       if (mcCollision.isMcCollisionSelected()) {
         auto bc = mcCollision.bc_as<aod::JBCs>();
-        if (std::find(bcIndicies.begin(), bcIndicies.end(), bc.globalIndex()) == bcIndicies.end()) {
+        if (bcMapping[bc.globalIndex()] < 0) { // each bunch crossing is stored once
           products.storedJBCsTable(bc.runNumber(), bc.globalBC(), bc.triggerMask(), bc.timestamp(), bc.alias_raw(), bc.selection_raw(), bc.rct_raw());
-          bcIndicies.push_back(bc.globalIndex());
           bcMapping[bc.globalIndex()] = products.storedJBCsTable.lastIndex();
         }
       }
@@ -526,19 +522,36 @@ struct JetDerivedDataWriter {
     trackMapping.clear();
     trackMapping.resize(tracks.size(), -1);
 
+    isCollisionSelectedMask.assign(collisions.size(), 0);
     for (auto const& collision : collisions) {
-      if (collision.isCollisionSelected()) {
-        const auto tracksPerCollision = tracks.sliceBy(preslices.TracksPerCollision, collision.globalIndex());
-        for (const auto& track : tracksPerCollision) {
-          if (!trackSelection(track)) { // skips tracks that pass no selections. This might cause a problem with tracks matched with clusters. We should generate a track selection purely for cluster matched tracks so that they are kept. This includes also the track pT selction.
-            continue;
-          }
-          products.storedJTracksTable(collisionMapping[collision.globalIndex()], o2::math_utils::detail::truncateFloatFraction(track.pt(), precisionMomentumMask), o2::math_utils::detail::truncateFloatFraction(track.eta(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.phi(), precisionPositionMask), track.trackSel());
-          products.storedJTracksExtraTable(o2::math_utils::detail::truncateFloatFraction(track.dcaX(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigma1Pt(), precisionMomentumMask));
-          products.storedJTracksParentIndexTable(track.trackId());
-          trackMapping[track.globalIndex()] = products.storedJTracksTable.lastIndex();
-        }
+      isCollisionSelectedMask[collision.globalIndex()] = collision.isCollisionSelected();
+    }
+
+    // the selection mask is built in a first pass, then the selected tracks are gathered in a single pass into the reserved tables
+    // the tracks are sorted by collision, so the stored tracks keep the order of the per-collision loop
+    isTrackSelectedMask.assign(tracks.size(), 0);
+    int64_t nSelectedTracks = 0;
+    for (const auto& track : tracks) {
+      const auto collisionId = track.collisionId();
+      // skips tracks that pass no selections. This might cause a problem with tracks matched with clusters. We should generate a track selection purely for cluster matched tracks so that they are kept. This includes also the track pT selction.
+      if (collisionId < 0 || !isCollisionSelectedMask[collisionId] || !trackSelection(track)) {
+        continue;
+      }
+      isTrackSelectedMask[track.globalIndex()] = 1;
+      nSelectedTracks++;
+    }
+
+    products.storedJTracksTable.reserve(nSelectedTracks);
+    products.storedJTracksExtraTable.reserve(nSelectedTracks);
+    products.storedJTracksParentIndexTable.reserve(nSelectedTracks);
+    for (const auto& track : tracks) {
+      if (!isTrackSelectedMask[track.globalIndex()]) {
+        continue;
       }
+      products.storedJTracksTable(collisionMapping[track.collisionId()], o2::math_utils::detail::truncateFloatFraction(track.pt(), precisionMomentumMask), o2::math_utils::detail::truncateFloatFraction(track.eta(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.phi(), precisionPositionMask), track.trackSel());
+      products.storedJTracksExtraTable(o2::math_utils::detail::truncateFloatFraction(track.dcaX(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.dcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXY(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigmadcaXYZ(), precisionPositionMask), o2::math_utils::detail::truncateFloatFraction(track.sigma1Pt(), precisionMomentumMask));
+      products.storedJTracksParentIndexTable(track.trackId());
+      trackMapping[track.globalIndex()] = products.storedJTracksTable.lastIndex();
     }
   }
   PROCESS_SWITCH(JetDerivedDataWriter, processTracks, "write out output tables for tracks", true);
@@ -58,9 +58,13 @@
 
 #include <GPUROOTCartesianFwd.h>
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
+#include <future>
 #include <gsl/span>
 #include <memory>
 #include <random>
@@ -138,6 +142,7 @@ struct EmcalCorrectionTask {
   Configurable<float> mcCellEnergyShift{"mcCellEnergyShift", 1., "Relative shift of the MC cell energy. 1.1 for 10% shift to higher mass, etc. Only applied to MC."};
   Configurable<float> mcCellEnergyResolutionBroadening{"mcCellEnergyResolutionBroadening", 0., "Relative widening of the MC cell energy resolution. 0 for no widening, 0.1 for 10% widening, etc. Only applied to MC."};
   Configurable<bool> applyGainCalibShift{"applyGainCalibShift", false, "Apply shift for cell gain calibration to use values before cell format change (Sept. 2023)"};
+  Configurable<int> nThreadsClusterization{"nThreadsClusterization", 1, "Number of threads clusterizing the BCs of a time frame in processFull (1: serial clusterization)"};
   Configurable<bool> applySoftwareTriggerSelection{"applySoftwareTriggerSelection", false, "Apply software trigger selection"};
   Configurable<std::string> softwareTriggerSelection{"softwareTriggerSelection", "fGammaHighPtEMCAL,fGammaHighPtDCAL", "Default: fGammaHighPtEMCAL,fGammaHighPtDCAL"};
   // cross talk emulation configs
@@ -170,6 +175,31 @@ struct EmcalCorrectionTask {
   // Cluster Eta and Phi used for track matching later
   std::vector<float> mClusterPhi;
   std::vector<float> mClusterEta;
+  // Clusterizers and cluster factory of a worker thread of the multi-threaded clusterization
+  struct ClusterizationWorker {
+    std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>> clusterizers;
+    o2::emcal::ClusterFactory<o2::emcal::Cell> clusterFactory;
+  };
+  // Clusters of a BC found by one clusterizer in the multi-threaded clusterization
+  struct BCClusters {
+    std::vector<o2::emcal::AnalysisCluster> analysisClusters;
+    std::vector<o2::emcal::ClusterLabel> clusterLabels;
+    std::vector<float> clusterPhi;
+    std::vector<float> clusterEta;
+  };
+  std::vector<ClusterizationWorker> mClusterizationWorkers; // workers besides the main thread
+  std::vector<BCClusters> mBCClusters;                      // clusters per (BC, clusterizer) of the time frame
+  // Converted cells of the BCs, reused for all the BCs and time frames
+  std::vector<o2::emcal::Cell> mCells;
+  std::vector<int64_t> mCellIndices;
+  std::vector<std::size_t> mCellsStartBC; // first converted cell of each clusterized BC of the time frame
+  std::vector<int64_t> mClusterizedBCs;   // global index of each clusterized BC of the time frame
+  // Track matching, with the grid and the buffers reused for all the collisions
+  TrackClusterMatcher mTrackMatcher;
+  std::vector<float> mTrackPhi;
+  std::vector<float> mTrackEta;
+  MatchResult mTrackMatchResult;
+  MatchResult mSecondaryMatchResult;
 
   std::vector<o2::aod::EMCALClusterDefinition> mClusterDefinitions;
   // QA
@@ -245,15 +275,9 @@ struct EmcalCorrectionTask {
         mClusterDefinitions.push_back(clusDef);
       }
     }
-    mClusterFactories.setGeometry(geometry);
-    mClusterFactories.SetECALogWeight(logWeight);
-    mClusterFactories.setExoticCellFraction(exoticCellFraction);
-    mClusterFactories.setExoticCellDiffTime(exoticCellDiffTime);
-    mClusterFactories.setExoticCellMinAmplitude(exoticCellMinAmplitude);
-    mClusterFactories.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
-    mClusterFactories.setUseWeightExotic(useWeightExotic);
+    setupClusterFactory(mClusterFactories);
     for (const auto& clusterDefinition : mClusterDefinitions) {
-      mClusterizers.emplace_back(std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy));
+      mClusterizers.emplace_back(makeClusterizer(clusterDefinition));
       LOG(info) << "Cluster definition initialized: " << clusterDefinition.toString();
       LOG(info) << "timeMin: " << clusterDefinition.timeMin;
       LOG(info) << "timeMax: " << clusterDefinition.timeMax;
@@ -263,14 +287,22 @@ struct EmcalCorrectionTask {
       LOG(info) << "minCellEnergy: " << clusterDefinition.minCellEnergy;
       LOG(info) << "storageID: " << clusterDefinition.storageID;
     }
-    for (const auto& clusterizer : mClusterizers) {
-      clusterizer->setGeometry(geometry);
-    }
-
     if (mClusterizers.size() == 0) {
       LOG(error) << "No cluster definitions specified!";
     }
 
+    // the worker threads of the multi-threaded clusterization have their own clusterizers and cluster factory
+    mClusterizationWorkers.resize(std::max(nThreadsClusterization.value, 1) - 1);
+    for (auto& worker : mClusterizationWorkers) {
+      setupClusterFactory(worker.clusterFactory);
+      for (const auto& clusterDefinition : mClusterDefinitions) {
+        worker.clusterizers.emplace_back(makeClusterizer(clusterDefinition));
+      }
+    }
+    if (!mClusterizationWorkers.empty()) {
+      LOG(info) << "Clusterizing the BCs with " << mClusterizationWorkers.size() + 1 << " threads";
+    }
+
     // 500 clusters per event is a good upper limit
     mClusterPhi.reserve(500 * mClusterizers.size());
     mClusterEta.reserve(500 * mClusterizers.size());
@@ -404,6 +436,59 @@ struct EmcalCorrectionTask {
     int nCellsProcessed = 0;
     std::unordered_map<uint64_t, int> numberCollsInBC; // Number of collisions mapped to the global BC index of all BCs
     std::unordered_map<uint64_t, int> numberCellsInBC; // Number of cells mapped to the global BC index of all BCs to check whether EMCal was readout
+
+    // Fill the cluster tables of a BC with the clusters found by a clusterizer
+    auto fillClusterTablesBC = [&](const auto& bc, const auto& collisionsInFoundBC, const gsl::span<int64_t> cellIndicesBC, size_t iClusterizer) {
+      if (collisionsInFoundBC.size() == 1) {
+        // dummy loop to get the first collision
+        for (const auto& col : collisionsInFoundBC) {
+          if (previousCollisionId > col.globalIndex()) {
+            mHistManager.fill(HIST("hBCMatchErrors"), 1);
+            continue;
+          }
+          previousCollisionId = col.globalIndex();
+          if (col.foundBCId() == bc.globalIndex()) {
+            mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
+            mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
+            mHistManager.fill(HIST("hCollPerBC"), 1);
+            mHistManager.fill(HIST("hCollisionType"), 1);
+            math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
+
+            MatchResult& indexMapPair = mTrackMatchResult;
+            std::vector<int64_t> trackGlobalIndex;
+            doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
+
+            // Store the clusters in the table where a matching collision could
+            // be identified.
+            fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
+          } else {
+            mHistManager.fill(HIST("hBCMatchErrors"), 2);
+          }
+        }
+      } else { // ambiguous
+        // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
+        bool hasCollision = false;
+        mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
+        if (collisionsInFoundBC.size() == 0) {
+          mHistManager.fill(HIST("hCollisionType"), 0);
+        } else {
+          hasCollision = true;
+          mHistManager.fill(HIST("hCollisionType"), 2);
+        }
+        fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
+      }
+
+      mClusterPhi.clear();
+      mClusterEta.clear();
+      LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
+    };
+
+    // With several threads, the cells of all the BCs are converted first, the BCs are clusterized in parallel and the tables are filled in BC order at the end
+    const bool isMultiThreaded = !mClusterizationWorkers.empty();
+    mCells.clear();
+    mCellIndices.clear();
+    mCellsStartBC.clear();
+    mClusterizedBCs.clear();
     for (const auto& bc : bcs) {
       LOG(debug) << "Next BC";
 
@@ -442,8 +527,11 @@ struct EmcalCorrectionTask {
         }
       }
 
-      std::vector<o2::emcal::Cell> cellsBC;
-      std::vector<int64_t> cellIndicesBC;
+      if (!isMultiThreaded) {
+        mCells.clear();
+        mCellIndices.clear();
+      }
+      const std::size_t firstCellBC = mCells.size();
       for (const auto& cell : cellsInBC) {
         auto amplitude = cell.amplitude();
         if (static_cast<bool>(hasShaperCorrection) && emcal::intToChannelType(cell.cellType()) == emcal::ChannelType_t::LOW_GAIN) { // Apply shaper correction to LG cells
@@ -460,71 +548,56 @@ struct EmcalCorrectionTask {
           amplitude /= tempCalibFactor;
           mHistManager.fill(HIST("hTempCalibCorrection"), tempCalibFactor);
         }
-        cellsBC.emplace_back(cell.cellNumber(),
-                             amplitude,
-                             cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
-                             o2::emcal::intToChannelType(cell.cellType()));
-        cellIndicesBC.emplace_back(cell.globalIndex());
+        mCells.emplace_back(cell.cellNumber(),
+                            amplitude,
+                            cell.time() + getCellTimeShift(cell.cellNumber(), amplitude, o2::emcal::intToChannelType(cell.cellType()), runNumber),
+                            o2::emcal::intToChannelType(cell.cellType()));
+        mCellIndices.emplace_back(cell.globalIndex());
       }
+      gsl::span<o2::emcal::Cell> cellsBC(mCells.data() + firstCellBC, mCells.size() - firstCellBC);
+      gsl::span<int64_t> cellIndicesBC(mCellIndices.data() + firstCellBC, mCellIndices.size() - firstCellBC);
       LOG(detail) << "Number of cells for BC (CF): " << cellsBC.size();
       nCellsProcessed += cellsBC.size();
 
       fillQAHistogram(cellsBC);
 
       LOG(debug) << "Converted cells. Contains: " << cellsBC.size() << ". Originally " << cellsInBC.size() << ". About to run clusterizer.";
+      if (isMultiThreaded) {
+        mCellsStartBC.push_back(firstCellBC);
+        mClusterizedBCs.push_back(bc.globalIndex());
+        nBCsProcessed++;
+        continue;
+      }
       //  this is a test
       //  Run the clusterizers
       LOG(debug) << "Running clusterizers";
       for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
         cellsToCluster(iClusterizer, cellsBC);
-
-        if (collisionsInFoundBC.size() == 1) {
-          // dummy loop to get the first collision
-          for (const auto& col : collisionsInFoundBC) {
-            if (previousCollisionId > col.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 1);
-              continue;
-            }
-            previousCollisionId = col.globalIndex();
-            if (col.foundBCId() == bc.globalIndex()) {
-              mHistManager.fill(HIST("hBCMatchErrors"), 0); // CollisionID ordered and foundBC matches -> Fill as healthy
-              mHistManager.fill(HIST("hCollisionTimeReso"), col.collisionTimeRes());
-              mHistManager.fill(HIST("hCollPerBC"), 1);
-              mHistManager.fill(HIST("hCollisionType"), 1);
-              math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
-
-              MatchResult indexMapPair;
-              std::vector<int64_t> trackGlobalIndex;
-              doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
-
-              // Store the clusters in the table where a matching collision could
-              // be identified.
-              fillClusterTable<CollEventSels::filtered_iterator>(col, vertexPos, iClusterizer, cellIndicesBC, &indexMapPair, &trackGlobalIndex);
-            } else {
-              mHistManager.fill(HIST("hBCMatchErrors"), 2);
-            }
-          }
-        } else { // ambiguous
-          // LOG(warning) << "No vertex found for event. Assuming (0,0,0).";
-          bool hasCollision = false;
-          mHistManager.fill(HIST("hCollPerBC"), collisionsInFoundBC.size());
-          if (collisionsInFoundBC.size() == 0) {
-            mHistManager.fill(HIST("hCollisionType"), 0);
-          } else {
-            hasCollision = true;
-            mHistManager.fill(HIST("hCollisionType"), 2);
-          }
-          fillAmbigousClusterTable<BcEvSels::iterator>(bc, iClusterizer, cellIndicesBC, hasCollision);
-        }
-
-        mClusterPhi.clear();
-        mClusterEta.clear();
-        LOG(debug) << "Cluster loop done for clusterizer " << iClusterizer;
+        fillClusterTablesBC(bc, collisionsInFoundBC, cellIndicesBC, iClusterizer);
       } // end of clusterizer loop
       LOG(debug) << "Done with process BC.";
       nBCsProcessed++;
     } // end of bc loop
 
+    if (isMultiThreaded) {
+      clusterizeBCsMultiThreaded();
+      for (size_t iBC = 0; iBC < mClusterizedBCs.size(); iBC++) {
+        auto bc = bcs.iteratorAt(mClusterizedBCs[iBC]);
+        auto collisionsInFoundBC = collisions.sliceBy(collisionsPerFoundBC, bc.globalIndex());
+        const std::size_t endCellBC = iBC + 1 < mCellsStartBC.size() ? mCellsStartBC[iBC + 1] : mCells.size();
+        gsl::span<int64_t> cellIndicesBC(mCellIndices.data() + mCellsStartBC[iBC], endCellBC - mCellsStartBC[iBC]);
+        for (size_t iClusterizer = 0; iClusterizer < mClusterizers.size(); iClusterizer++) {
+          auto& bcClusters = mBCClusters[iBC * mClusterizers.size() + iClusterizer];
+          mAnalysisClusters.swap(bcClusters.analysisClusters);
+          mClusterLabels.swap(bcClusters.clusterLabels);
+          mClusterPhi.swap(bcClusters.clusterPhi);
+          mClusterEta.swap(bcClusters.clusterEta);
+          mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
+          fillClusterTablesBC(bc, collisionsInFoundBC, cellIndicesBC, iClusterizer);
+        }
+      }
+    }
+
     // Loop through all collisions and fill emcalcollisionmatch with a boolean stating, whether the collision was ambiguous (not the only collision in its BC)
     // NOTE: we can not do zorro selection here since emcalcollisionmatch needs to alway be filled to be joinable with collision table
     for (const auto& collision : collisions) {
@@ -640,11 +713,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              MatchResult indexMapPair;
+              MatchResult& indexMapPair = mTrackMatchResult;
               std::vector<int64_t> trackGlobalIndex;
               doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
 
-              MatchResult indexMapPairSecondary;
+              MatchResult& indexMapPairSecondary = mSecondaryMatchResult;
               std::vector<int64_t> secondaryGlobalIndex;
               doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
 
@@ -824,7 +897,7 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              MatchResult indexMapPair;
+              MatchResult& indexMapPair = mTrackMatchResult;
               std::vector<int64_t> trackGlobalIndex;
               doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
 
@@ -1001,11 +1074,11 @@ struct EmcalCorrectionTask {
               mHistManager.fill(HIST("hCollisionType"), 1);
               math_utils::Point3D<float> vertexPos = {col.posX(), col.posY(), col.posZ()};
 
-              MatchResult indexMapPair;
+              MatchResult& indexMapPair = mTrackMatchResult;
               std::vector<int64_t> trackGlobalIndex;
               doTrackMatching<CollEventSels::filtered_iterator>(col, tracks, indexMapPair, trackGlobalIndex);
 
-              MatchResult indexMapPairSecondary;
+              MatchResult& indexMapPairSecondary = mSecondaryMatchResult;
               std::vector<int64_t> secondaryGlobalIndex;
               doSecondaryTrackMatching<CollEventSels::filtered_iterator>(col, v0legs, indexMapPairSecondary, secondaryGlobalIndex, tracks);
 
@@ -1170,40 +1243,96 @@ struct EmcalCorrectionTask {
 
   void cellsToCluster(size_t iClusterizer, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels = {})
   {
-    mClusterizers.at(iClusterizer)->findClusters(cellsBC);
+    buildAnalysisClusters(*mClusterizers.at(iClusterizer), mClusterFactories, cellsBC, cellLabels, mAnalysisClusters, mClusterLabels, mClusterPhi, mClusterEta);
+    mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
+    LOG(debug) << "Converted to analysis clusters.";
+  }
+
+  void buildAnalysisClusters(o2::emcal::Clusterizer<o2::emcal::Cell>& clusterizer, o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory, const gsl::span<o2::emcal::Cell> cellsBC, gsl::span<const o2::emcal::CellLabel> cellLabels, std::vector<o2::emcal::AnalysisCluster>& analysisClusters, std::vector<o2::emcal::ClusterLabel>& clusterLabels, std::vector<float>& clusterPhi, std::vector<float>& clusterEta)
+  {
+    clusterizer.findClusters(cellsBC);
 
-    auto emcalClusters = mClusterizers.at(iClusterizer)->getFoundClusters();
-    auto emcalClustersInputIndices = mClusterizers.at(iClusterizer)->getFoundClustersInputIndices();
+    auto emcalClusters = clusterizer.getFoundClusters();
+    auto emcalClustersInputIndices = clusterizer.getFoundClustersInputIndices();
     LOG(debug) << "Retrieved results. About to setup cluster factory.";
 
     // Convert to analysis clusters.
     // First, the cluster factory requires cluster and cell information in order
     // to build the clusters.
-    mAnalysisClusters.clear();
-    mClusterLabels.clear();
-    mClusterFactories.reset();
+    analysisClusters.clear();
+    clusterLabels.clear();
+    clusterFactory.reset();
     // in preparation for future O2 changes
     // mClusterFactories.setClusterizerSettings(mClusterDefinitions.at(iClusterizer).minCellEnergy, mClusterDefinitions.at(iClusterizer).timeMin, mClusterDefinitions.at(iClusterizer).timeMax, mClusterDefinitions.at(iClusterizer).recalcShowerShape5x5);
     if (cellLabels.empty()) {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices);
     } else {
-      mClusterFactories.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
+      clusterFactory.setContainer(*emcalClusters, cellsBC, *emcalClustersInputIndices, cellLabels);
     }
 
     LOG(debug) << "Cluster factory set up.";
     // Convert to analysis clusters.
-    for (int icl = 0; icl < mClusterFactories.getNumberOfClusters(); icl++) {
+    for (int icl = 0; icl < clusterFactory.getNumberOfClusters(); icl++) {
       o2::emcal::ClusterLabel clusterLabel;
-      auto analysisCluster = mClusterFactories.buildCluster(icl, &clusterLabel);
-      mAnalysisClusters.emplace_back(analysisCluster);
-      mClusterLabels.push_back(clusterLabel);
+      auto analysisCluster = clusterFactory.buildCluster(icl, &clusterLabel);
+      analysisClusters.emplace_back(analysisCluster);
+      clusterLabels.push_back(clusterLabel);
       auto pos = analysisCluster.getGlobalPosition();
-      mClusterPhi.emplace_back(RecoDecay::constrainAngle(pos.Phi()));
-      mClusterEta.emplace_back(pos.Eta());
+      clusterPhi.emplace_back(RecoDecay::constrainAngle(pos.Phi()));
+      clusterEta.emplace_back(pos.Eta());
       LOG(debug) << "Cluster " << icl << ": E: " << analysisCluster.E() << ", NCells " << analysisCluster.getNCells();
     }
-    mHistManager.fill(HIST("hNCluster"), mAnalysisClusters.size());
-    LOG(debug) << "Converted to analysis clusters.";
+  }
+
+  /// Clusterize the converted cells of the BCs of the time frame with a pool of threads, one set of clusterizers per thread
+  void clusterizeBCsMultiThreaded()
+  {
+    const std::size_t nClusterizers = mClusterizers.size();
+    const std::size_t nJobs = mClusterizedBCs.size() * nClusterizers;
+    if (mBCClusters.size() < nJobs) {
+      mBCClusters.resize(nJobs);
+    }
+    std::atomic<std::size_t> nextJob{0};
+    auto worker = [&](std::vector<std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>>>& clusterizers, o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory) {
+      for (std::size_t iJob = nextJob++; iJob < nJobs; iJob = nextJob++) {
+        const std::size_t iBC = iJob / nClusterizers;
+        const std::size_t endCellBC = iBC + 1 < mCellsStartBC.size() ? mCellsStartBC[iBC + 1] : mCells.size();
+        gsl::span<o2::emcal::Cell> cellsBC(mCells.data() + mCellsStartBC[iBC], endCellBC - mCellsStartBC[iBC]);
+        auto& bcClusters = mBCClusters[iJob];
+        bcClusters.clusterPhi.clear();
+        bcClusters.clusterEta.clear();
+        buildAnalysisClusters(*clusterizers[iJob % nClusterizers], clusterFactory, cellsBC, {}, bcClusters.analysisClusters, bcClusters.clusterLabels, bcClusters.clusterPhi, bcClusters.clusterEta);
+      }
+    };
+    const std::size_t nWorkers = std::min(mClusterizationWorkers.size(), nJobs);
+    std::vector<std::future<void>> workers;
+    for (std::size_t iWorker = 0; iWorker < nWorkers; iWorker++) {
+      workers.push_back(std::async(std::launch::async, worker, std::ref(mClusterizationWorkers[iWorker].clusterizers), std::ref(mClusterizationWorkers[iWorker].clusterFactory)));
+    }
+    worker(mClusterizers, mClusterFactories);
+    for (auto& result : workers) {
+      result.get();
+    }
+  }
+
+  /// Set up a cluster factory with the configured settings
+  void setupClusterFactory(o2::emcal::ClusterFactory<o2::emcal::Cell>& clusterFactory)
+  {
+    clusterFactory.setGeometry(geometry);
+    clusterFactory.SetECALogWeight(logWeight);
+    clusterFactory.setExoticCellFraction(exoticCellFraction);
+    clusterFactory.setExoticCellDiffTime(exoticCellDiffTime);
+    clusterFactory.setExoticCellMinAmplitude(exoticCellMinAmplitude);
+    clusterFactory.setExoticCellInCrossMinAmplitude(exoticCellInCrossMinAmplitude);
+    clusterFactory.setUseWeightExotic(useWeightExotic);
+  }
+
+  /// Create a clusterizer for a cluster definition
+  std::unique_ptr<o2::emcal::Clusterizer<o2::emcal::Cell>> makeClusterizer(o2::aod::EMCALClusterDefinition const& clusterDefinition)
+  {
+    auto clusterizer = std::make_unique<o2::emcal::Clusterizer<o2::emcal::Cell>>(clusterDefinition.timeDiff, clusterDefinition.timeMin, clusterDefinition.timeMax, clusterDefinition.gradientCut, clusterDefinition.doGradientCut, clusterDefinition.seedEnergy, clusterDefinition.minCellEnergy);
+    clusterizer->setGeometry(geometry);
+    return clusterizer;
   }
 
   template <typename Collision>
@@ -1360,15 +1489,15 @@ struct EmcalCorrectionTask {
   {
     auto groupedTracks = tracks.sliceBy(perCollision, col.globalIndex());
     int nTracksInCol = groupedTracks.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
+    mTrackPhi.clear();
+    mTrackEta.clear();
     // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nTracksInCol);
-    trackEta.reserve(nTracksInCol);
+    mTrackPhi.reserve(nTracksInCol);
+    mTrackEta.reserve(nTracksInCol);
     trackGlobalIndex.reserve(nTracksInCol);
-    fillTrackInfo<decltype(groupedTracks)>(groupedTracks, trackPhi, trackEta, trackGlobalIndex);
+    fillTrackInfo<decltype(groupedTracks)>(groupedTracks, mTrackPhi, mTrackEta, trackGlobalIndex);
 
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    mTrackMatcher.match(mClusterPhi, mClusterEta, mTrackPhi, mTrackEta, maxMatchingDistance, kMaxMatchesPerCluster, indexMapPair);
   }
 
   template <typename Collision>
@@ -1376,11 +1505,11 @@ struct EmcalCorrectionTask {
   {
     auto groupedV0Legs = v0legs.sliceBy(perCollisionEMV0Legs, col.globalIndex());
     int nLegsInCol = groupedV0Legs.size();
-    std::vector<float> trackPhi;
-    std::vector<float> trackEta;
+    mTrackPhi.clear();
+    mTrackEta.clear();
     // reserve memory to reduce on the fly memory allocation
-    trackPhi.reserve(nLegsInCol);
-    trackEta.reserve(nLegsInCol);
+    mTrackPhi.reserve(nLegsInCol);
+    mTrackEta.reserve(nLegsInCol);
     trackGlobalIndex.reserve(nLegsInCol);
 
     float trackEtaEmcal = 0.f;
@@ -1400,11 +1529,11 @@ struct EmcalCorrectionTask {
       if (trackMinPt > 0 && track.pt() < trackMinPt) {
         continue;
       }
-      trackPhi.emplace_back(RecoDecay::constrainAngle(trackPhiEmcal));
-      trackEta.emplace_back(trackEtaEmcal);
+      mTrackPhi.emplace_back(RecoDecay::constrainAngle(trackPhiEmcal));
+      mTrackEta.emplace_back(trackEtaEmcal);
       trackGlobalIndex.emplace_back(track.globalIndex());
     }
-    indexMapPair = matchTracksToCluster(mClusterPhi, mClusterEta, trackPhi, trackEta, maxMatchingDistance, kMaxMatchesPerCluster);
+    mTrackMatcher.match(mClusterPhi, mClusterEta, mTrackPhi, mTrackEta, maxMatchingDistance, kMaxMatchesPerCluster, indexMapPair);
   }
 
   template <typename Tracks>
@@ -26,12 +26,16 @@
 #include <Framework/Configurable.h>
 #include <Framework/DataTypes.h>
 #include <Framework/InitContext.h>
+#include <Framework/Logger.h>
 #include <Framework/O2DatabasePDGPlugin.h>
 #include <Framework/runDataProcessing.h>
 
 #include <fastjet/GhostedAreaSpec.hh>
 #include <fastjet/PseudoJet.hh>
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -89,6 +93,8 @@ struct eventWiseConstituentSubtractorTask {
   Configurable<double> ghostGridScatter{"ghostGridScatter", 1.0, "Grid scatter"};
   Configurable<double> ghostKtScatter{"ghostKtScatter", 0.1, "kT scatter"};
   Configurable<double> ghostMeanPt{"ghostMeanPt", 1e-100, "Mean ghost pT"};
+  Configurable<bool> useNativeConstSub{"useNativeConstSub", false, "use the native constituent subtractor instead of the fastjet one"};
+  Configurable<bool> doConstSubCrossCheck{"doConstSubCrossCheck", false, "compare the native constituent subtraction with the fastjet one and report the differences"};
 
   JetBkgSubUtils eventWiseConstituentSubtractor;
   std::vector<fastjet::PseudoJet> inputParticles;
@@ -101,6 +107,8 @@ struct eventWiseConstituentSubtractorTask {
 
   std::vector<int> eventSelectionBits;
 
+  static constexpr double constSubCrossCheckTolerance = 1.e-6; // relative pT tolerance of the cross-check of the native constituent subtraction
+
   void init(o2::framework::InitContext&)
   {
     eventSelectionBits = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(eventSelections));
@@ -113,6 +121,28 @@ struct eventWiseConstituentSubtractorTask {
     fastjet::GhostedAreaSpec ghostAreaSpec(ghostRapMax, ghostRepeat, ghostArea,
                                            ghostGridScatter, ghostKtScatter, ghostMeanPt);
     eventWiseConstituentSubtractor.setGhostAreaSpec(ghostAreaSpec);
+    eventWiseConstituentSubtractor.setUseNativeConstSub(useNativeConstSub);
+  }
+
+  void subtractEvent(double rho, double rhoM)
+  {
+    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, rho, rhoM);
+    if (!useNativeConstSub || !doConstSubCrossCheck) {
+      return;
+    }
+    // the subtracted particles of both implementations are compared one to one, ordered by user index
+    auto tracksSubtractedFastJet = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSubFastJet(inputParticles, rho, rhoM);
+    auto tracksSubtractedNative = tracksSubtracted;
+    auto byUserIndex = [](const fastjet::PseudoJet& a, const fastjet::PseudoJet& b) { return a.user_index() < b.user_index(); };
+    std::sort(tracksSubtractedFastJet.begin(), tracksSubtractedFastJet.end(), byUserIndex);
+    std::sort(tracksSubtractedNative.begin(), tracksSubtractedNative.end(), byUserIndex);
+    bool isDifferent = tracksSubtractedFastJet.size() != tracksSubtractedNative.size();
+    for (std::size_t iTrack = 0; !isDifferent && iTrack < tracksSubtractedNative.size(); iTrack++) {
+      isDifferent = tracksSubtractedNative[iTrack].user_index() != tracksSubtractedFastJet[iTrack].user_index() || std::abs(tracksSubtractedNative[iTrack].pt() - tracksSubtractedFastJet[iTrack].pt()) > constSubCrossCheckTolerance * (1. + tracksSubtractedFastJet[iTrack].pt());
+    }
+    if (isDifferent) {
+      LOGP(warning, "Native and fastjet constituent subtractions differ: {} and {} subtracted particles for {} input particles", tracksSubtracted.size(), tracksSubtractedFastJet.size(), inputParticles.size());
+    }
   }
 
   Filter trackCuts = (aod::jtrack::pt >= trackPtMin && aod::jtrack::pt < trackPtMax && aod::jtrack::eta > trackEtaMin && aod::jtrack::eta < trackEtaMax && aod::jtrack::phi >= trackPhiMin && aod::jtrack::phi <= trackPhiMax);
@@ -132,7 +162,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseTracks(inputParticles, tracks, trackSelection, &candidate);
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         trackSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
       }
@@ -153,7 +183,7 @@ struct eventWiseConstituentSubtractorTask {
       tracksSubtracted.clear();
       jetfindingutilities::analyseParticles<true>(inputParticles, particleSelection, 1, particles, pdgDatabase, &candidate); // currently only works for charged analyses
 
-      tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, candidate.rho(), candidate.rhoM());
+      subtractEvent(candidate.rho(), candidate.rhoM());
       for (auto const& trackSubtracted : tracksSubtracted) {
         particleSubTable(candidate.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 0, static_cast<uint8_t>(o2::aod::mcparticle::enums::PhysicalPrimary)); // everything after phi is artificial and should not be used for analyses
       }
@@ -169,7 +199,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseTracks<soa::Filtered<aod::JetTracks>, soa::Filtered<aod::JetTracks>::iterator>(inputParticles, tracks, trackSelection);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, collision.rho(), collision.rhoM());
+    subtractEvent(collision.rho(), collision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       trackSubtractedTable(collision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), jetderiveddatautilities::setSingleTrackSelectionBit(trackSelection));
@@ -186,7 +216,7 @@ struct eventWiseConstituentSubtractorTask {
     tracksSubtracted.clear();
     jetfindingutilities::analyseParticles<false, soa::Filtered<aod::JetParticles>, soa::Filtered<aod::JetParticles>::iterator>(inputParticles, particleSelection, 1, particles, pdgDatabase);
 
-    tracksSubtracted = eventWiseConstituentSubtractor.JetBkgSubUtils::doEventConstSub(inputParticles, mcCollision.rho(), mcCollision.rhoM());
+    subtractEvent(mcCollision.rho(), mcCollision.rhoM());
 
     for (auto const& trackSubtracted : tracksSubtracted) {
       particleSubtractedTable(mcCollision.globalIndex(), trackSubtracted.pt(), trackSubtracted.eta(), trackSubtracted.phi(), trackSubtracted.rap(), trackSubtracted.e(), 211, 0, static_cast<uint8_t>(o2::aod::mcparticle::enums::PhysicalPrimary)); // everything after phi is artificial and should not be used for analyses
@@ -112,6 +112,7 @@ struct JetTaggerHFTask {
   Configurable<int> nClassesMl{"nClassesMl", 2, "Number of classes in ML model"};
   Configurable<std::vector<std::string>> namesInputFeatures{"namesInputFeatures", std::vector<std::string>{"feature1", "feature2"}, "Names of ML model input features"};
   Configurable<bool> useDb{"useDb", false, "Flag to use DB for ML model instead of the score"};
+  Configurable<bool> evalMlInBatch{"evalMlInBatch", true, "Evaluate the ML model on all the jets of a dataframe in a single batch (models with one input node)"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::vector<std::string>> modelPathsCCDB{"modelPathsCCDB", std::vector<std::string>{"Users/h/hahassan"}, "Paths of models on CCDB"};
@@ -545,13 +546,50 @@ struct JetTaggerHFTask {
     }
   }
 
+  /// ML score of a jet from the model output
+  /// \param output is the model output, one value for each class
+  template <typename T>
+  float getScoreMl(T const& output)
+  {
+    if (bMlResponse.getOutputNodes() > 1) {
+      const float fCharm = fC;
+      return useDb ? std::log(output[2] / (fCharm * output[1] + (1 - fCharm) * output[0])) : output[2]; // 2 is the b-jet index
+    }
+    return output[0];
+  }
+
+  /// Evaluate the jets collected in the batch and fill their ML scores
+  /// \param alljets are the jets added to the batch, in the order in which they were added
+  /// \param isUsingSVs is whether the model uses the secondary vertices
+  template <typename AnyJets>
+  void fillScoresMlBatch(AnyJets const& alljets, bool isUsingSVs)
+  {
+    bMlResponse.evalBatch();
+    std::size_t iJet = 0;
+    for (const auto& analysisJet : alljets) {
+      if (!bMlResponse.isInBatchBinning(iJet)) {
+        LOG(fatal) << "Jet pT " << analysisJet.pt() << " is outside of the ML model binning! Please check your configurables.";
+      }
+      const auto output = bMlResponse.getBatchOutput(iJet++);
+      scoreML[analysisJet.globalIndex()] = isUsingSVs ? getScoreMl(output) : output[0];
+    }
+  }
+
   template <typename AnyJets, typename AnyTracks, typename SecondaryVertices>
   void analyzeJetAlgorithmML(AnyJets const& alljets, AnyTracks const& allTracks, SecondaryVertices const& allSVs)
   {
-    for (const auto& analysisJet : alljets) {
+    // models with one input node are evaluated on all the jets of the dataframe at once
+    const bool isBatched = evalMlInBatch && bMlResponse.getInputShape().size() <= 1;
+    if (isBatched) {
+      bMlResponse.clearBatch();
+    }
+    std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
+    std::vector<jettaggingutilities::BJetSVParams> svsParams;
+    std::vector<float> output;
 
-      std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
-      std::vector<jettaggingutilities::BJetSVParams> svsParams;
+    for (const auto& analysisJet : alljets) {
+      tracksParams.clear();
+      svsParams.clear();
 
       jettaggingutilities::analyzeJetSVInfo4ML(analysisJet, allTracks, allSVs, svsParams, svPtMin, svReductionFactor);
       jettaggingutilities::analyzeJetTrackInfo4ML(analysisJet, allTracks, allSVs, tracksParams, trackPtMin, trackDcaXYMax, trackDcaZMax);
@@ -562,7 +600,10 @@ struct JetTaggerHFTask {
       tracksParams.resize(nJetConst); // resize to the number of inputs of the ML
       svsParams.resize(nJetConst);    // resize to the number of inputs of the ML
 
-      std::vector<float> output;
+      if (isBatched) {
+        bMlResponse.addToBatch(bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams), analysisJet.pt());
+        continue;
+      }
 
       if (bMlResponse.getInputShape().size() > 1) {
         auto inputML = bMlResponse.getInputFeatures2D(jetparam, tracksParams, svsParams);
@@ -572,32 +613,37 @@ struct JetTaggerHFTask {
         bMlResponse.isSelectedMl(inputML, analysisJet.pt(), output);
       }
 
-      if (bMlResponse.getOutputNodes() > 1) {
-        auto mDb = [](const std::vector<float>& scores, float fC) {
-          return std::log(scores[2] / (fC * scores[1] + (1 - fC) * scores[0]));
-        };
-
-        scoreML[analysisJet.globalIndex()] = useDb ? mDb(output, fC) : output[2]; // 2 is the b-jet index
-      } else {
-        scoreML[analysisJet.globalIndex()] = output[0];
-      }
+      scoreML[analysisJet.globalIndex()] = getScoreMl(output);
+    }
+    if (isBatched) {
+      fillScoresMlBatch(alljets, true);
     }
   }
 
   template <typename AnyJets, typename AnyTracks>
   void analyzeJetAlgorithmMLnoSV(AnyJets const& alljets, AnyTracks const& allTracks)
   {
-    for (const auto& analysisJet : alljets) {
+    // models with one input node are evaluated on all the jets of the dataframe at once
+    const bool isBatched = evalMlInBatch && bMlResponse.getInputShape().size() <= 1;
+    if (isBatched) {
+      bMlResponse.clearBatch();
+    }
+    std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
+    std::vector<jettaggingutilities::BJetSVParams> svsParams;
+    std::vector<float> output;
 
-      std::vector<jettaggingutilities::BJetTrackParams> tracksParams;
-      std::vector<jettaggingutilities::BJetSVParams> svsParams;
+    for (const auto& analysisJet : alljets) {
+      tracksParams.clear();
 
       jettaggingutilities::analyzeJetTrackInfo4MLnoSV(analysisJet, allTracks, tracksParams, trackPtMin, trackDcaXYMax, trackDcaZMax);
 
       jettaggingutilities::BJetParams jetparam = {analysisJet.pt(), analysisJet.eta(), analysisJet.phi(), static_cast<int>(tracksParams.size()), 0, analysisJet.mass()};
       tracksParams.resize(nJetConst); // resize to the number of inputs of the ML
 
-      std::vector<float> output;
+      if (isBatched) {
+        bMlResponse.addToBatch(bMlResponse.getInputFeatures1D(jetparam, tracksParams, svsParams), analysisJet.pt());
+        continue;
+      }
 
       if (bMlResponse.getInputShape().size() > 1) {
         auto inputML = bMlResponse.getInputFeatures2D(jetparam, tracksParams, svsParams);
@@ -609,6 +655,9 @@ struct JetTaggerHFTask {
 
       scoreML[analysisJet.globalIndex()] = output[0];
     }
+    if (isBatched) {
+      fillScoresMlBatch(alljets, false);
+    }
   }
 
   template <typename AnyJets, typename AnyTracks, typename AnyOriginalTracks>
@@ -76,23 +76,23 @@ struct McOutlierRejectorTask {
             if (!jetderiveddatautilities::selectTrack(selectionObject, trackSelection)) {
               continue;
             }
-            auto& mcCollisions = mcCollisionsOpt.value().get();
             auto mcParticle = selectionObject.template mcParticle_as<soa::Join<aod::JetParticles, aod::JMcParticlePIs>>();
-            auto mcCollision = mcCollisions.sliceBy(perColParticle, mcParticle.mcCollisionId());
-            int subGenID = mcCollision.begin().getSubGeneratorId();
             int diffCollisionID = mcParticle.mcCollisionId() - mcCollisionId;
             if (diffCollisionID != 0 &&
                 selectionObjectPt > ptHatMax * ptHard) {
-              if (subGenID != jetderiveddatautilities::JCollisionSubGeneratorId::mbGap && selectionObjectPt > ptHatMax * ptHard) {
-                flagArray[collisionIndex] = true;
-              }
-              if (subGenID == jetderiveddatautilities::JCollisionSubGeneratorId::mbGap && selectionObjectPt > ptTrackMaxMinBias) {
+              // the MC collision of the particle is only looked up for the candidate outliers
+              auto& mcCollisions = mcCollisionsOpt.value().get();
+              auto mcCollision = mcCollisions.sliceBy(perColParticle, mcParticle.mcCollisionId());
+              int subGenID = mcCollision.begin().getSubGeneratorId();
+              if (subGenID != jetderiveddatautilities::JCollisionSubGeneratorId::mbGap || selectionObjectPt > ptTrackMaxMinBias) {
                 flagArray[collisionIndex] = true;
+                return; // the collision is rejected, the remaining tracks cannot change the decision
               }
             }
           } else { // particles
             if (selectionObjectPt > ptHatMax * ptHard) {
               flagArray[collisionIndex] = true;
+              return; // the collision is rejected, the remaining particles cannot change the decision
             }
           }
         }
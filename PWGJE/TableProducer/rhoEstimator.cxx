@@ -86,6 +86,8 @@ struct RhoEstimatorTask {
     Configurable<double> ghostGridScatter{"ghostGridScatter", 1.0, "Grid scatter"};
     Configurable<double> ghostKtScatter{"ghostKtScatter", 0.1, "kT scatter"};
     Configurable<double> ghostMeanPt{"ghostMeanPt", 1e-100, "Mean ghost pT"};
+    Configurable<bool> useGhostGridCache{"useGhostGridCache", true, "Take the ghosts from a grid built once and reused by all the events"};
+    Configurable<bool> ghostScatterPerEvent{"ghostScatterPerEvent", true, "Redraw the scatter of the cached ghosts for each event"};
 
     Configurable<float> thresholdTriggerTrackPtMin{"thresholdTriggerTrackPtMin", 0.0, "Minimum trigger track pt to accept event"};
     Configurable<float> thresholdClusterEnergyMin{"thresholdClusterEnergyMin", 0.0, "Minimum cluster energy to accept event"};
@@ -137,6 +139,7 @@ struct RhoEstimatorTask {
     fastjet::GhostedAreaSpec ghostAreaSpec(config.ghostRapMax, config.ghostRepeat, config.ghostArea,
                                            config.ghostGridScatter, config.ghostKtScatter, config.ghostMeanPt);
     bkgSub.setGhostAreaSpec(ghostAreaSpec);
+    bkgSub.setUseGhostGridCache(config.useGhostGridCache, config.ghostScatterPerEvent);
 
     eventSelectionBits = jetderiveddatautilities::initialiseEventSelectionBits(static_cast<std::string>(config.eventSelections));
     triggerMaskBits = jetderiveddatautilities::initialiseTriggerMaskBits(config.triggerMasks);
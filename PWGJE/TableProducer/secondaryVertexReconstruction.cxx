@@ -43,8 +43,11 @@
 
 #include <GPUROOTCartesianFwd.h>
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <map>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -92,6 +95,7 @@ struct SecondaryVertexReconstruction {
   Configurable<float> maxIPxy{"maxIPxy", 10, "maximum track DCA in xy plane"};
   Configurable<float> maxIPz{"maxIPz", 10, "maximum track DCA in z direction"};
   Configurable<bool> fillHistograms{"fillHistograms", true, "do validation plots"};
+  Configurable<bool> cacheSecondaryVertices{"cacheSecondaryVertices", true, "fit each track combination once per collision and reuse the SV for all the jets sharing it"};
 
   Configurable<std::string> ccdbUrl{"ccdbUrl", "http://alice-ccdb.cern.ch", "url of the ccdb repository"};
   Configurable<std::string> ccdbPathLut{"ccdbPathLut", "GLO/Param/MatLUT", "Path for LUT parametrization"};
@@ -110,6 +114,33 @@ struct SecondaryVertexReconstruction {
   static constexpr int TwoProngCount = 2;
   static constexpr int ThreeProngCount = 3;
 
+  /// Secondary vertex fitted from a track combination, independent of the jet
+  template <unsigned int numProngs>
+  struct SecondaryVertexFit {
+    bool isValid{false};                       // whether the fit succeeded and the SV passed the selections
+    std::array<double, 3> secondaryVertex{};   // position of the SV
+    std::array<double, 3> momentum{};          // momentum of the SV
+    double energySV{0.};                       // energy of the SV, with the pion mass hypothesis
+    double massSV{0.};                         // invariant mass of the SV, with the pion mass hypothesis
+    float chi2PCA{0.f};                        // chi2 of the SV fit
+    float dispersion{0.f};                     // dispersion of the prongs around the SV
+    double errorDecayLength{0.};               // uncertainty of the decay length
+    double errorDecayLengthXY{0.};             // uncertainty of the decay length in XY
+    std::array<float, numProngs> prongPt{};    // pT of the prongs
+    std::array<float, numProngs> prongDcaXY{}; // DCAxy of the prongs to the primary vertex
+    std::array<float, numProngs> prongDcaZ{};  // DCAz of the prongs to the primary vertex
+  };
+
+  /// Secondary vertices fitted in a collision, by sorted track indices
+  template <unsigned int numProngs>
+  struct SecondaryVertexCache {
+    int64_t collisionId{-1};                                                      // collision of the cached SVs
+    std::map<std::array<int64_t, numProngs>, SecondaryVertexFit<numProngs>> fits; // SVs by sorted track indices
+  };
+
+  SecondaryVertexCache<TwoProngCount> svCache2Prongs;   // 2-prong SVs of the current collision
+  SecondaryVertexCache<ThreeProngCount> svCache3Prongs; // 3-prong SVs of the current collision
+
   void init(InitContext const&)
   {
     if (fillHistograms) {
@@ -153,6 +184,121 @@ struct SecondaryVertexReconstruction {
   using JetTracksMCDwPIs = soa::Filtered<soa::Join<aod::JetTracksMCD, aod::JTrackPIs>>;
   using OriginalTracks = soa::Join<aod::Tracks, aod::TracksCov, aod::TrackSelection, aod::TracksDCA, aod::TracksDCACov>;
 
+  template <unsigned int numProngs>
+  auto& getSvCache()
+  {
+    static_assert(numProngs == TwoProngCount || numProngs == ThreeProngCount, "SVs are cached for 2 and 3 prongs only");
+    if constexpr (numProngs == TwoProngCount) {
+      return svCache2Prongs;
+    } else {
+      return svCache3Prongs;
+    }
+  }
+
+  /// Fit the secondary vertex of a combination of jet constituents
+  /// \param collision is the collision of the jet
+  /// \param particles are the constituents of the jet
+  /// \param currentCombination are the positions of the prongs among the constituents
+  /// \param df is the vertex fitter
+  /// \param fit is the fitted secondary vertex, invalid if the fit failed or the SV was rejected
+  template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyConstituents>
+  void fitSecondaryVertex(AnyCollision const& collision,
+                          AnyConstituents const& particles,
+                          std::vector<size_t> const& currentCombination,
+                          o2::vertexing::DCAFitterN<numProngs>& df,
+                          SecondaryVertexFit<numProngs>& fit)
+  {
+    // Create an array of track parameters and covariance matrices for the current combination
+    std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
+      fit.energySV += prong.energy(o2::constants::physics::MassPiPlus);
+      trackParVars[inum] = getTrackParCov(prong);
+    }
+
+    if constexpr (externalMagneticField) {
+      bz = magneticField;
+    } else {
+      auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
+      if (runNumber != bc.runNumber()) {
+        initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
+        bz = o2::base::Propagator::Instance()->getNominalBz();
+      }
+    }
+
+    // Use a different fitter depending on the number of prongs
+    df.setBz(bz);
+
+    // Reconstruct the secondary vertex
+    int processResult = 0;
+    try {
+      std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
+    } catch (const std::runtime_error& error) {
+      LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
+      return;
+    }
+    if (processResult == 0) {
+      return;
+    }
+
+    const auto& secondaryVertex = df.getPCACandidatePos();
+    if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
+      return;
+    }
+
+    float dispersion = 0.;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
+      o2::dataformats::DCA dcaSV;
+      auto& prong = df.getTrack(inum);
+      prong.propagateToDCA(sv, bz, &dcaSV);
+      dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
+    }
+    fit.dispersion = std::sqrt(dispersion / numProngs);
+
+    fit.chi2PCA = df.getChi2AtPCACandidate();
+    auto covMatrixPCA = df.calcPCACovMatrixFlat();
+
+    // get track impact parameters
+    // This modifies track momenta!
+    auto primaryVertex = getPrimaryVertex(collision);
+    auto covMatrixPV = primaryVertex.getCov();
+
+    // Get track momenta and impact parameters
+    std::array<std::array<float, 3>, numProngs> arrayMomenta{};
+    std::array<o2::dataformats::DCA, numProngs> impactParameters;
+    for (unsigned int inum = 0; inum < numProngs; ++inum) {
+      trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
+      trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
+
+      fit.prongPt[inum] = particles[currentCombination[inum]].template track_as<OriginalTracks>().pt();
+      fit.prongDcaXY[inum] = impactParameters[inum].getY();
+      fit.prongDcaZ[inum] = impactParameters[inum].getZ();
+    }
+
+    // get uncertainty of the decay length
+    double phi, theta;
+    getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
+    fit.errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
+    fit.errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
+
+    // calculate invariant mass
+    std::array<double, numProngs> massArray{};
+    std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
+    fit.massSV = RecoDecay::m(arrayMomenta, massArray);
+
+    // calculate momentum
+    for (unsigned int i = 0; i < 3; ++i) {
+      float momentum = 0.f;
+      for (unsigned int inum = 0; inum < numProngs; ++inum) {
+        momentum += arrayMomenta[inum][i];
+      }
+      fit.momentum[i] = momentum;
+    }
+    fit.secondaryVertex = {secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]};
+    fit.isValid = true;
+  }
+
   template <unsigned int numProngs, bool externalMagneticField, typename AnyCollision, typename AnyJet, typename AnyParticles>
   void runCreatorNProng(AnyCollision const& collision,
                         AnyJet const& analysisJet,
@@ -164,105 +310,44 @@ struct SecondaryVertexReconstruction {
   {
 
     const auto& particles = analysisJet.template tracks_as<AnyParticles>();
+    if (prongIndex == 0 && currentCombination.empty() && collision.globalIndex() != getSvCache<numProngs>().collisionId) {
+      getSvCache<numProngs>().fits.clear();
+      getSvCache<numProngs>().collisionId = collision.globalIndex();
+    }
 
     if (currentCombination.size() == numProngs) {
-      // Create an array of track parameters and covariance matrices for the current combination
-      std::array<o2::track::TrackParametrizationWithError<float>, numProngs> trackParVars;
-      double energySV = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-        energySV += prong.energy(o2::constants::physics::MassPiPlus);
-        trackParVars[inum] = getTrackParCov(prong);
-      }
-
-      if constexpr (externalMagneticField) {
-        bz = magneticField;
-      } else {
-        auto bc = collision.template bc_as<aod::BCsWithTimestamps>();
-        if (runNumber != bc.runNumber()) {
-          initCCDB(bc, runNumber, ccdb, ccdbPathGrpMag, lut, false);
-          bz = o2::base::Propagator::Instance()->getNominalBz();
+      // the same track combination is shared by the jets of different radii of the collision: fit it only once
+      SecondaryVertexFit<numProngs> fitNotCached;
+      SecondaryVertexFit<numProngs>* fit = &fitNotCached;
+      bool isFitted = false;
+      if (cacheSecondaryVertices) {
+        std::array<int64_t, numProngs> trackIds{};
+        for (unsigned int inum = 0; inum < numProngs; ++inum) {
+          trackIds[inum] = particles[currentCombination[inum]].template track_as<OriginalTracks>().globalIndex();
         }
+        std::sort(trackIds.begin(), trackIds.end());
+        const auto [entry, isNew] = getSvCache<numProngs>().fits.try_emplace(trackIds);
+        fit = &entry->second;
+        isFitted = !isNew;
       }
-
-      // Use a different fitter depending on the number of prongs
-      df.setBz(bz);
-
-      // Reconstruct the secondary vertex
-      int processResult = 0;
-      try {
-        std::apply([&df, &processResult](const auto&... elems) { processResult = df.process(elems...); }, trackParVars);
-      } catch (const std::runtime_error& error) {
-        LOG(info) << "Run time error found: " << error.what() << ". DCAFitterN cannot work, skipping the candidate.";
-        return;
+      if (!isFitted) {
+        fitSecondaryVertex<numProngs, externalMagneticField>(collision, particles, currentCombination, df, *fit);
       }
-      if (processResult == 0) {
+      if (!fit->isValid) {
         return;
       }
 
-      const auto& secondaryVertex = df.getPCACandidatePos();
-      if (std::sqrt(secondaryVertex[0] * secondaryVertex[0] + secondaryVertex[1] * secondaryVertex[1]) > maxRsv || std::abs(secondaryVertex[2]) > maxZsv) {
-        return;
-      }
-
-      float dispersion = 0.;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        o2::dataformats::VertexBase sv(o2::math_utils::Point3D<float>{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}, std::array<float, 6>{0});
-        o2::dataformats::DCA dcaSV;
-        auto& prong = df.getTrack(inum);
-        prong.propagateToDCA(sv, bz, &dcaSV);
-        dispersion += (dcaSV.getY() * dcaSV.getY() + dcaSV.getZ() * dcaSV.getZ());
-      }
-      dispersion = std::sqrt(dispersion / numProngs);
-
-      auto chi2PCA = df.getChi2AtPCACandidate();
-      auto covMatrixPCA = df.calcPCACovMatrixFlat();
-
-      // get track impact parameters
-      // This modifies track momenta!
-      auto primaryVertex = getPrimaryVertex(collision);
-      auto covMatrixPV = primaryVertex.getCov();
-
-      // Get track momenta and impact parameters
-      std::array<std::array<float, 3>, numProngs> arrayMomenta{};
-      std::array<o2::dataformats::DCA, numProngs> impactParameters;
-      for (unsigned int inum = 0; inum < numProngs; ++inum) {
-        trackParVars[inum].getPxPyPzGlo(arrayMomenta[inum]);
-        trackParVars[inum].propagateToDCA(primaryVertex, bz, &impactParameters[inum]);
-
-        if (fillHistograms) {
-          const auto& prong = particles[currentCombination[inum]].template track_as<OriginalTracks>();
-          registry.fill(HIST("hDcaXYNProngs"), prong.pt(), impactParameters[inum].getY() * toMicrometers, numProngs);
-          registry.fill(HIST("hDcaZNProngs"), prong.pt(), impactParameters[inum].getZ() * toMicrometers, numProngs);
-        }
-      }
-
-      // get uncertainty of the decay length
-      double phi, theta;
-      getPointDirection(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, secondaryVertex, phi, theta);
-      auto errorDecayLength = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, theta) + getRotatedCovMatrixXX(covMatrixPCA, phi, theta));
-      auto errorDecayLengthXY = std::sqrt(getRotatedCovMatrixXX(covMatrixPV, phi, 0.) + getRotatedCovMatrixXX(covMatrixPCA, phi, 0.));
-
-      // calculate invariant mass
-      std::array<double, numProngs> massArray{};
-      std::fill(massArray.begin(), massArray.end(), o2::constants::physics::MassPiPlus);
-      double massSV = RecoDecay::m(arrayMomenta, massArray);
-
-      // calculate momentum
-      double xMomenta = -1;
-      double yMomenta = -1;
-      double zMomenta = -1;
-      if (numProngs == ThreeProngCount) {
-        xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0] + arrayMomenta[2][0];
-        yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1] + arrayMomenta[2][1];
-        zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2] + arrayMomenta[2][2];
-      } else if (numProngs == TwoProngCount) {
-        xMomenta = arrayMomenta[0][0] + arrayMomenta[1][0];
-        yMomenta = arrayMomenta[0][1] + arrayMomenta[1][1];
-        zMomenta = arrayMomenta[0][2] + arrayMomenta[1][2];
-      } else {
-        LOG(error) << "No process momenta\n";
-      }
+      const auto primaryVertex = getPrimaryVertex(collision);
+      const auto& secondaryVertex = fit->secondaryVertex;
+      const auto& energySV = fit->energySV;
+      const auto& massSV = fit->massSV;
+      const auto& chi2PCA = fit->chi2PCA;
+      const auto& dispersion = fit->dispersion;
+      const auto& errorDecayLength = fit->errorDecayLength;
+      const auto& errorDecayLengthXY = fit->errorDecayLengthXY;
+      const auto& xMomenta = fit->momentum[0];
+      const auto& yMomenta = fit->momentum[1];
+      const auto& zMomenta = fit->momentum[2];
 
       // fill candidate table rows
       if ((doprocessData3Prongs || doprocessData3ProngsExternalMagneticField) && numProngs == ThreeProngCount) {
@@ -328,6 +413,10 @@ struct SecondaryVertexReconstruction {
         double decayLengthNormalised = RecoDecay::distance(std::array{primaryVertex.getX(), primaryVertex.getY(), primaryVertex.getZ()}, std::array{secondaryVertex[0], secondaryVertex[1], secondaryVertex[2]}) / errorDecayLength;
         double decayLengthXYNormalised = RecoDecay::distanceXY(std::array{primaryVertex.getX(), primaryVertex.getY()}, std::array{secondaryVertex[0], secondaryVertex[1]}) / errorDecayLengthXY;
 
+        for (unsigned int inum = 0; inum < numProngs; ++inum) {
+          registry.fill(HIST("hDcaXYNProngs"), fit->prongPt[inum], fit->prongDcaXY[inum] * toMicrometers, numProngs);
+          registry.fill(HIST("hDcaZNProngs"), fit->prongPt[inum], fit->prongDcaZ[inum] * toMicrometers, numProngs);
+        }
         registry.fill(HIST("hDispersion"), dispersion, numProngs);
         registry.fill(HIST("hMassNProngs"), massSV, numProngs);
         registry.fill(HIST("hLxySNProngs"), decayLengthXYNormalised, numProngs);
@@ -18,7 +18,6 @@
 
 #include "PWGJE/Core/FastJetUtilities.h"
 #include "PWGJE/Core/JetDerivedDataUtilities.h"
-#include "PWGJE/Core/JetFinder.h"
 #include "PWGJE/Core/JetFindingUtilities.h"
 #include "PWGJE/Core/JetSubstructureUtilities.h"
 #include "PWGJE/Core/JetUtilities.h"
@@ -40,8 +39,6 @@
 
 #include <TMath.h>
 
-#include <fastjet/ClusterSequenceArea.hh>
-#include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 
 #include <cmath>
@@ -83,8 +80,7 @@ struct JetSubstructureTask {
 
   Service<o2::framework::O2DatabasePDG> pdg;
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
-  JetFinder jetReclusterer;
+  jetsubstructureutilities::JetReclusteringCache reclusteringCache;
 
   std::vector<float> energyMotherVec;
   std::vector<float> ptLeadingVec;
@@ -125,10 +121,6 @@ struct JetSubstructureTask {
     registry.add("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{R}_{g}", {HistType::kTH2F, {{200, 0., 200.}, {22, 0.0, 1.1}}});
     registry.add("h2_jet_pt_jet_nsd_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{n}_{SD}", {HistType::kTH2F, {{200, 0., 200.}, {15, -0.5, 14.5}}});
 
-    jetReclusterer.isReclustering = true;
-    jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
-    jetReclusterer.ghostRepeatN = 0;
-
     trackSelection = jetderiveddatautilities::initialiseTrackSelection(static_cast<std::string>(trackSelections));
   }
 
@@ -143,56 +135,42 @@ struct JetSubstructureTask {
     ptLeadingVec.clear();
     ptSubLeadingVec.clear();
     thetaVec.clear();
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
-    fastjet::PseudoJet parentSubJet1;
-    fastjet::PseudoJet parentSubJet2;
-    bool softDropped = false;
-    auto nsd = 0.0;
-
-    while (daughterSubJet.has_parents(parentSubJet1, parentSubJet2)) {
-      if (parentSubJet1.perp() < parentSubJet2.perp()) {
-        std::swap(parentSubJet1, parentSubJet2);
-      }
-      std::vector<int32_t> tracks;
-      std::vector<int32_t> candidates;
-      std::vector<int32_t> clusters;
-      for (const auto& constituent : sorted_by_pt(parentSubJet2.constituents())) {
+    // the jet is reclustered once, the splittings, the Soft Drop and the N-subjettiness are all taken from the same tree
+    reclusteringCache.build(jetConstituents, jet.r() / 100.f);
+    std::vector<int32_t> tracks;
+    std::vector<int32_t> candidates;
+    std::vector<int32_t> clusters;
+    for (const auto& splitting : reclusteringCache.getSplittings()) {
+      tracks.clear();
+      for (const auto& constituent : sorted_by_pt(splitting.subLeading.constituents())) {
         if (constituent.template user_info<fastjetutilities::fastjet_user_info>().getStatus() == JetConstituentStatus::track) {
           tracks.push_back(constituent.template user_info<fastjetutilities::fastjet_user_info>().getIndex());
         }
       }
-      splittingTable(jet.globalIndex(), tracks, clusters, candidates, parentSubJet2.perp(), parentSubJet2.eta(), parentSubJet2.phi(), 0);
-      auto z = parentSubJet2.perp() / (parentSubJet1.perp() + parentSubJet2.perp());
-      auto theta = parentSubJet1.delta_R(parentSubJet2);
-      energyMotherVec.push_back(daughterSubJet.e());
-      ptLeadingVec.push_back(parentSubJet1.pt());
-      ptSubLeadingVec.push_back(parentSubJet2.pt());
-      thetaVec.push_back(theta);
-
-      if (z >= zCut * TMath::Power(theta / (jet.r() / 100.f), beta)) {
-        if (!softDropped) {
-          auto zg = z;
-          auto rg = theta;
-          if constexpr (!isSubtracted && !isMCP) {
-            registry.fill(HIST("h2_jet_pt_jet_zg"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_jet_rg"), jet.pt(), rg);
-          }
-          if constexpr (!isSubtracted && isMCP) {
-            registry.fill(HIST("h2_jet_pt_part_jet_zg_part"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_part_jet_rg_part"), jet.pt(), rg);
-          }
-          if constexpr (isSubtracted && !isMCP) {
-            registry.fill(HIST("h2_jet_pt_jet_zg_eventwiseconstituentsubtracted"), jet.pt(), zg);
-            registry.fill(HIST("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted"), jet.pt(), rg);
-          }
-          softDropped = true;
-        }
-        nsd++;
+      splittingTable(jet.globalIndex(), tracks, clusters, candidates, splitting.subLeading.perp(), splitting.subLeading.eta(), splitting.subLeading.phi(), 0);
+      energyMotherVec.push_back(splitting.mother.e());
+      ptLeadingVec.push_back(splitting.leading.pt());
+      ptSubLeadingVec.push_back(splitting.subLeading.pt());
+      thetaVec.push_back(splitting.theta);
+    }
+
+    const auto softDrop = reclusteringCache.getSoftDrop(zCut, beta);
+    const auto nsd = softDrop.nsd;
+    if (softDrop.iSplitting >= 0) {
+      const auto zg = softDrop.zg;
+      const auto rg = softDrop.rg;
+      if constexpr (!isSubtracted && !isMCP) {
+        registry.fill(HIST("h2_jet_pt_jet_zg"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_jet_rg"), jet.pt(), rg);
+      }
+      if constexpr (!isSubtracted && isMCP) {
+        registry.fill(HIST("h2_jet_pt_part_jet_zg_part"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_part_jet_rg_part"), jet.pt(), rg);
+      }
+      if constexpr (isSubtracted && !isMCP) {
+        registry.fill(HIST("h2_jet_pt_jet_zg_eventwiseconstituentsubtracted"), jet.pt(), zg);
+        registry.fill(HIST("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted"), jet.pt(), rg);
       }
-      daughterSubJet = parentSubJet1;
     }
     if constexpr (!isSubtracted && !isMCP) {
       registry.fill(HIST("h2_jet_pt_jet_nsd"), jet.pt(), nsd);
@@ -343,8 +321,8 @@ struct JetSubstructureTask {
     for (auto& jetConstituent : jet.template tracks_as<U>()) {
       fastjetutilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex());
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, tracks, tracks, tracks, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<false, isSubtracted>(jet, splittingTable);
+    nSub = reclusteringCache.getNSubjettiness(2, true, zCut, beta);
     jetPairing<false>(jet, tracks, trackSlicer, pairTable);
     jetSubstructureSimple(jet, tracks);
     outputTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
@@ -383,8 +361,8 @@ struct JetSubstructureTask {
     for (auto& jetConstituent : jet.template tracks_as<aod::JetParticles>()) {
       fastjetutilities::fillTracks(jetConstituent, jetConstituents, jetConstituent.globalIndex(), JetConstituentStatus::track, pdg->Mass(jetConstituent.pdgCode()));
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, particles, particles, particles, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<true, false>(jet, jetSplittingsMCPTable);
+    nSub = reclusteringCache.getNSubjettiness(2, true, zCut, beta);
     jetPairing<true>(jet, particles, ParticlesPerMcCollision, jetPairsMCPTable);
     jetSubstructureSimple(jet, particles);
     jetSubstructureMCPTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
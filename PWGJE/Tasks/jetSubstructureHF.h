@@ -19,7 +19,6 @@
 
 #include "PWGJE/Core/FastJetUtilities.h"
 #include "PWGJE/Core/JetDQUtilities.h"
-#include "PWGJE/Core/JetFinder.h"
 #include "PWGJE/Core/JetFindingUtilities.h"
 #include "PWGJE/Core/JetHFUtilities.h"
 #include "PWGJE/Core/JetSubstructureUtilities.h"
@@ -40,8 +39,6 @@
 
 #include <TMath.h>
 
-#include <fastjet/ClusterSequenceArea.hh>
-#include <fastjet/JetDefinition.hh>
 #include <fastjet/PseudoJet.hh>
 
 #include <cstdint>
@@ -87,8 +84,7 @@ struct JetSubstructureHFTask {
   float candMass;
 
   std::vector<fastjet::PseudoJet> jetConstituents;
-  std::vector<fastjet::PseudoJet> jetReclustered;
-  JetFinder jetReclusterer;
+  jetsubstructureutilities::JetReclusteringCache reclusteringCache;
 
   std::vector<float> energyMotherVec;
   std::vector<float> ptLeadingVec;
@@ -129,9 +125,6 @@ struct JetSubstructureHFTask {
     registry.add("h2_jet_pt_jet_rg_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{R}_{g}", {o2::framework::HistType::kTH2F, {{200, 0., 200.}, {22, 0.0, 1.1}}});
     registry.add("h2_jet_pt_jet_nsd_eventwiseconstituentsubtracted", ";#it{p}_{T,jet} (GeV/#it{c});#it{n}_{SD}", {o2::framework::HistType::kTH2F, {{200, 0., 200.}, {15, -0.5, 14.5}}});
 
-    jetReclusterer.isReclustering = true;
-    jetReclusterer.algorithm = fastjet::JetAlgorithm::cambridge_algorithm;
-    jetReclusterer.ghostRepeatN = 0;
 
     candMass = jetcandidateutilities::getTablePDGMass<CandidateTable>();
 
@@ -183,10 +176,11 @@ struct JetSubstructureHFTask {
     ptLeadingVec.clear();
     ptSubLeadingVec.clear();
     thetaVec.clear();
-    jetReclustered.clear();
-    fastjet::ClusterSequenceArea clusterSeq(jetReclusterer.findJets(jetConstituents, jetReclustered));
-    jetReclustered = sorted_by_pt(jetReclustered);
-    fastjet::PseudoJet daughterSubJet = jetReclustered[0];
+    // the jet is reclustered once, the N-subjettiness is taken from the same tree
+    if (!reclusteringCache.build(jetConstituents, jet.r() / 100.f)) {
+      return;
+    }
+    fastjet::PseudoJet daughterSubJet = reclusteringCache.getJet();
     fastjet::PseudoJet parentSubJet1;
     fastjet::PseudoJet parentSubJet2;
     bool softDropped = false;
@@ -471,8 +465,8 @@ struct JetSubstructureHFTask {
       fastjetutilities::fillTracks(jetHFCandidate, jetConstituents, jetHFCandidate.globalIndex(), JetConstituentStatus::candidate, candMass);
       nHFCandidates++;
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, tracks, tracks, candidates, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<false, isSubtracted>(jet, splittingTable, nHFCandidates);
+    nSub = reclusteringCache.getNSubjettiness(2, true, zCut, beta);
     jetPairing<false, isSubtracted>(jet, tracks, candidates, trackSlicer, pairTable);
     jetSubstructureSimple(jet, tracks, candidates);
     outputTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
@@ -528,8 +522,8 @@ struct JetSubstructureHFTask {
       fastjetutilities::fillTracks(jetHFCandidate, jetConstituents, jetHFCandidate.globalIndex(), JetConstituentStatus::candidate, candMass);
       nHFCandidates++;
     }
-    nSub = jetsubstructureutilities::getNSubjettiness(jet, particles, particles, candidates, 2, fastjet::contrib::CA_Axes(), true, zCut, beta);
     jetReclustering<true, false>(jet, jetSplittingsMCPTable, nHFCandidates);
+    nSub = reclusteringCache.getNSubjettiness(2, true, zCut, beta);
     jetPairing<true, false>(jet, particles, candidates, ParticlesPerMcCollision, jetPairsMCPTable);
     jetSubstructureSimple(jet, particles, candidates);
     jetSubstructureMCPTable(energyMotherVec, ptLeadingVec, ptSubLeadingVec, thetaVec, nSub[0], nSub[1], nSub[2], pairJetPtVec, pairJetEnergyVec, pairJetThetaVec, pairJetPerpCone1PtVec, pairJetPerpCone1EnergyVec, pairJetPerpCone1ThetaVec, pairPerpCone1PerpCone1PtVec, pairPerpCone1PerpCone1EnergyVec, pairPerpCone1PerpCone1ThetaVec, pairPerpCone1PerpCone2PtVec, pairPerpCone1PerpCone2EnergyVec, pairPerpCone1PerpCone2ThetaVec, angularity, leadingConstituentPt, perpConeRho);
@@ -976,6 +976,9 @@ struct decay3bodyBuilder {
       return; // don't do if no request for decay3bodys in place
     }
 
+    // proton-pion sub-vertices of the SVertexer cuts are cached within the data frame
+    helper.clearSubVertexCache();
+
     // Strictly upper index policy for decay3body objects binned by radius, phi
     for (const auto& [decay3body0, decay3body1] : selfPairCombinations(binningType, mixingOpts.n3bodyMixing, -1, decay3bodys)) {
       auto trackPos0 = decay3body0.template track0_as<TRedTracks>();
@@ -39,6 +39,7 @@
 #include <Framework/runDataProcessing.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <map>
@@ -139,6 +140,9 @@ struct cascademlselection {
       timeStampML = bc.timestamp();
     }
 
+    // the pending candidates are scored with the models of the previous run
+    scoreCandidates();
+
     // machine learning initialization if requested
     if (mlConfigurations.calculateXiMinusScores ||
         mlConfigurations.calculateXiPlusScores ||
@@ -213,44 +217,82 @@ struct cascademlselection {
     ccdb->setURL(ccdbConfigurations.ccdburl);
   }
 
-  // Process candidate and store properties in object
+  // Candidates pending for the inference, with their features flattened (candidates x features)
+  std::vector<float> mlInputFeatures;
+  std::vector<int> mlCandidateSigns;
+  std::vector<float> mlModelFeatures;
+  std::vector<float> mlModelScores;
+  std::vector<float> xiScores;
+  std::vector<float> omegaScores;
+
+  // Add a candidate to the pending batch
   template <typename TCascObject>
-  void processCandidate(TCascObject const& cand)
+  void addCandidate(TCascObject const& cand)
   {
     // Select features
     // FIXME THIS NEEDS ADJUSTING
     std::vector<float> inputFeatures{0.0f, 0.0f,
                                      0.0f, 0.0f};
 
-    // calculate scores
-    if (cand.sign() < 0) {
-      if (mlConfigurations.calculateXiMinusScores) {
-        float* xiMinusProbability = mlModelXiMinus.evalModel(inputFeatures);
-        xiMLSelections(xiMinusProbability[1]);
-      } else {
-        xiMLSelections(-1);
-      }
-      if (mlConfigurations.calculateOmegaMinusScores) {
-        float* omegaMinusProbability = mlModelOmegaMinus.evalModel(inputFeatures);
-        omegaMLSelections(omegaMinusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
+    mlInputFeatures.insert(mlInputFeatures.end(), inputFeatures.begin(), inputFeatures.end());
+    mlCandidateSigns.push_back(cand.sign());
+  }
+
+  // Evaluate a model in one call on the pending candidates of a given sign
+  void evalModelBatch(o2::ml::OnnxModel& model, const int sign, std::vector<float>& scores, const char* name)
+  {
+    const std::size_t nFeatures = mlInputFeatures.size() / mlCandidateSigns.size();
+    mlModelFeatures.clear();
+    for (std::size_t iCand = 0; iCand < mlCandidateSigns.size(); iCand++) {
+      if (mlCandidateSigns[iCand] * sign > 0) {
+        mlModelFeatures.insert(mlModelFeatures.end(), mlInputFeatures.begin() + iCand * nFeatures, mlInputFeatures.begin() + (iCand + 1) * nFeatures);
       }
     }
-    if (cand.sign() > 0) {
-      if (mlConfigurations.calculateXiPlusScores) {
-        float* xiPlusProbability = mlModelXiPlus.evalModel(inputFeatures);
-        xiMLSelections(xiPlusProbability[1]);
-      } else {
-        xiMLSelections(-1);
+    const std::size_t nCandidatesModel = mlModelFeatures.size() / nFeatures;
+    if (nCandidatesModel == 0) {
+      return;
+    }
+    if (!model.evalModel(mlModelFeatures, mlModelScores)) {
+      LOG(fatal) << "Inference of the " << name << " model failed for a batch of " << nCandidatesModel << " candidates";
+    }
+    const std::size_t nOutputs = mlModelScores.size() / nCandidatesModel;
+    std::size_t iCandModel = 0;
+    for (std::size_t iCand = 0; iCand < mlCandidateSigns.size(); iCand++) {
+      if (mlCandidateSigns[iCand] * sign > 0) {
+        scores[iCand] = mlModelScores[iCandModel * nOutputs + 1];
+        iCandModel++;
       }
-      if (mlConfigurations.calculateOmegaPlusScores) {
-        float* omegaPlusProbability = mlModelOmegaPlus.evalModel(inputFeatures);
-        omegaMLSelections(omegaPlusProbability[1]);
-      } else {
-        omegaMLSelections(-1);
+    }
+  }
+
+  // Score the pending candidates, with one inference call per model, and store the scores in the order of the candidates
+  void scoreCandidates()
+  {
+    if (mlCandidateSigns.empty()) {
+      return;
+    }
+    xiScores.assign(mlCandidateSigns.size(), -1.f);
+    omegaScores.assign(mlCandidateSigns.size(), -1.f);
+    if (mlConfigurations.calculateXiMinusScores) {
+      evalModelBatch(mlModelXiMinus, -1, xiScores, "XiMinus");
+    }
+    if (mlConfigurations.calculateXiPlusScores) {
+      evalModelBatch(mlModelXiPlus, +1, xiScores, "XiPlus");
+    }
+    if (mlConfigurations.calculateOmegaMinusScores) {
+      evalModelBatch(mlModelOmegaMinus, -1, omegaScores, "OmegaMinus");
+    }
+    if (mlConfigurations.calculateOmegaPlusScores) {
+      evalModelBatch(mlModelOmegaPlus, +1, omegaScores, "OmegaPlus");
+    }
+    for (std::size_t iCand = 0; iCand < mlCandidateSigns.size(); iCand++) {
+      if (mlCandidateSigns[iCand] != 0) {
+        xiMLSelections(xiScores[iCand]);
+        omegaMLSelections(omegaScores[iCand]);
       }
     }
+    mlInputFeatures.clear();
+    mlCandidateSigns.clear();
   }
 
   void processDerivedData(soa::Join<aod::StraCollisions, aod::StraStamps> const& collisions, CascDerivedDatas const& cascades)
@@ -273,9 +315,10 @@ struct cascademlselection {
         if (nCandidates % 50000 == 0) {
           LOG(info) << "Candidates processed: " << nCandidates;
         }
-        processCandidate(casc);
+        addCandidate(casc);
       }
     }
+    scoreCandidates();
   }
   void processStandardData(aod::Collisions const& collisions, CascOriginalDatas const& cascades)
   {
@@ -297,9 +340,10 @@ struct cascademlselection {
         if (nCandidates % 50000 == 0) {
           LOG(info) << "Candidates processed: " << nCandidates;
         }
-        processCandidate(casc);
+        addCandidate(casc);
       }
     }
+    scoreCandidates();
   }
 
   PROCESS_SWITCH(cascademlselection, processStandardData, "Process standard data", false);
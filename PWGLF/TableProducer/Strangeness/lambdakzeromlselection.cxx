@@ -41,6 +41,7 @@
 #include <TMath.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <map>
@@ -192,9 +193,13 @@ struct lambdakzeromlselection {
     return selected_elements;
   }
 
-  // Process candidate and store properties in object
+  // Features of the candidates of the data frame, flattened (candidates x features), and scores of one model
+  std::vector<float> mlInputFeatures;
+  std::vector<float> mlScores;
+
+  // Add the features of a candidate to the batch of the data frame
   template <typename TV0Object, typename T>
-  void processCandidate(TV0Object const& cand, const std::vector<T>& Feature_SelMask)
+  void addCandidate(TV0Object const& cand, const std::vector<T>& Feature_SelMask)
   {
     // Select features
     std::vector<float> base_features{cand.mLambda(), cand.mAntiLambda(),
@@ -207,47 +212,67 @@ struct lambdakzeromlselection {
 
     // Apply mask to select features
     std::vector<float> inputFeatures = extractSelectedElements(base_features, Feature_SelMask);
+    mlInputFeatures.insert(mlInputFeatures.end(), inputFeatures.begin(), inputFeatures.end());
+  }
+
+  // Evaluate a model on all the candidates of the batch in one call, and fill its score table in the order of the candidates
+  template <typename TTable>
+  void scoreCandidates(o2::ml::OnnxModel& model, TTable& mlSelections, const std::size_t nCandidatesBatch, const char* name)
+  {
+    if (!model.evalModel(mlInputFeatures, mlScores)) {
+      LOG(fatal) << "Inference of the " << name << " model failed for a batch of " << nCandidatesBatch << " candidates";
+    }
+    const std::size_t nOutputs = mlScores.size() / nCandidatesBatch;
+    for (std::size_t iCand = 0; iCand < nCandidatesBatch; iCand++) {
+      mlSelections(mlScores[iCand * nOutputs + 1]);
+    }
+  }
+
+  // Process the candidates of the data frame, with one inference call per model
+  template <typename TV0s>
+  void processCandidates(TV0s const& v0s)
+  {
+    const std::size_t nCandidatesBatch = v0s.size();
+    if (nCandidatesBatch == 0) {
+      return;
+    }
+    mlInputFeatures.clear();
+    for (const auto& v0 : v0s) {
+      nCandidates++;
+      if (nCandidates % 50000 == 0) {
+        LOG(info) << "Candidates processed: " << nCandidates;
+      }
+      addCandidate(v0, Feature_SelMask);
+    }
 
     // calculate classifier output
     if (PredictLambda) {
-      float* LambdaProbability = lambda_bdt.evalModel(inputFeatures);
-      lambdaMLSelections(LambdaProbability[1]);
+      scoreCandidates(lambda_bdt, lambdaMLSelections, nCandidatesBatch, "Lambda");
     }
     if (PredictGamma) {
-      float* GammaProbability = gamma_bdt.evalModel(inputFeatures);
-      gammaMLSelections(GammaProbability[1]);
+      scoreCandidates(gamma_bdt, gammaMLSelections, nCandidatesBatch, "Gamma");
     }
     if (PredictAntiLambda) {
-      float* AntiLambdaProbability = antilambda_bdt.evalModel(inputFeatures);
-      antiLambdaMLSelections(AntiLambdaProbability[1]);
+      scoreCandidates(antilambda_bdt, antiLambdaMLSelections, nCandidatesBatch, "AntiLambda");
     }
     if (PredictKZeroShort) {
-      float* KZeroShortProbability = kzeroshort_bdt.evalModel(inputFeatures);
-      kzeroShortMLSelections(KZeroShortProbability[1]);
+      scoreCandidates(kzeroshort_bdt, kzeroShortMLSelections, nCandidatesBatch, "KZeroShort");
     }
   }
 
-  void processDerivedData(aod::StraCollision const& coll, V0DerivedDatas const& v0s)
+  void processDerivedData(aod::StraCollisions const& collisions, V0DerivedDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
+    for (const auto& coll : collisions) {
+      histos.fill(HIST("hEventVertexZ"), coll.posZ());
     }
+    processCandidates(v0s);
   }
-  void processStandardData(aod::Collision const& coll, V0OriginalDatas const& v0s)
+  void processStandardData(aod::Collisions const& collisions, V0OriginalDatas const& v0s)
   {
-    histos.fill(HIST("hEventVertexZ"), coll.posZ());
-    for (auto& v0 : v0s) {
-      nCandidates++;
-      if (nCandidates % 50000 == 0) {
-        LOG(info) << "Candidates processed: " << nCandidates;
-      }
-      processCandidate(v0, Feature_SelMask);
+    for (const auto& coll : collisions) {
+      histos.fill(HIST("hEventVertexZ"), coll.posZ());
     }
+    processCandidates(v0s);
   }
 
   PROCESS_SWITCH(lambdakzeromlselection, processStandardData, "Process standard data", false);
@@ -56,6 +56,7 @@
 #include <cmath>
 #include <cstdint>
 #include <cstdlib>
+#include <limits>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -2627,6 +2628,42 @@ struct sigma0builder {
     return true;
   }
 
+  // Kinematics of a V0 candidate, for the photon-V0 pairing
+  struct V0PairingInfo {
+    int globalIndex;
+    int posTrackExtraId;
+    int negTrackExtraId;
+    float minPhotonEnergy; // photon energy range where a pair can fall in the mass window
+    float maxPhotonEnergy;
+  };
+
+  // Fills the pairing information of a V0, with the range of the energy of the (massless) photons for which the
+  // photon-V0 pair can fall in the mass window [mass - window, mass + window]. As
+  // m^2 = mV0^2 + 2 Egamma (EV0 - pV0 cos(theta)) and EV0 - pV0 <= EV0 - pV0 cos(theta) <= EV0 + pV0, the pairs with a
+  // photon outside of the range can not pass the mass selection. The range is enlarged by a small margin, the exact
+  // mass selection is done when building the candidate.
+  template <typename TV0Object>
+  V0PairingInfo getV0PairingInfo(TV0Object const& v0, double mV0, double mass, double window)
+  {
+    constexpr double Margin = 1e-3; // relative margin on the squared masses
+    const double pV0 = std::sqrt(v0.px() * v0.px() + v0.py() * v0.py() + v0.pz() * v0.pz());
+    const double eV0 = std::sqrt(pV0 * pV0 + mV0 * mV0);
+    const double mV02 = mV0 * mV0;
+    const double maxMass2 = (mass + window) * (mass + window) * (1. + Margin);
+    const double minMass2 = mass > window ? (mass - window) * (mass - window) * (1. - Margin) : 0.;
+
+    V0PairingInfo info{static_cast<int>(v0.globalIndex()), static_cast<int>(v0.posTrackExtraId()), static_cast<int>(v0.negTrackExtraId()), 0.f, std::numeric_limits<float>::max()};
+    if (maxMass2 > mV02) {
+      info.maxPhotonEnergy = (maxMass2 - mV02) * (eV0 + pV0) / (2. * mV02);
+    } else {
+      info.maxPhotonEnergy = -1.f; // no pair can reach the mass window
+    }
+    if (minMass2 > mV02) {
+      info.minPhotonEnergy = (minMass2 - mV02) / (2. * (eV0 + pV0));
+    }
+    return info;
+  }
+
   // Process photon and lambda candidates to build sigma0 candidates
   template <typename TCollision, typename TV0s, typename TEMCal, typename TEMCalTracks, typename TMCParticles>
   void dataProcess(TCollision const& collisions, TV0s const& fullV0s, TEMCal const& fullEMCalClusters, TEMCalTracks const& emcaltracks, TMCParticles const& mcparticles)
@@ -2640,6 +2677,11 @@ struct sigma0builder {
     std::vector<int> bestLambdasArray;
     std::vector<int> bestKShortsArray;
 
+    // Pairing information of the best PCM candidates, filled once per collision
+    std::vector<float> bestGammasEnergy;
+    std::vector<V0PairingInfo> bestLambdasInfo;
+    std::vector<V0PairingInfo> bestKShortsInfo;
+
     // Custom grouping
     std::vector<std::vector<int>> v0grouped(collisions.size());
     std::vector<std::vector<int>> emclustersgrouped(collisions.size());
@@ -2736,6 +2778,29 @@ struct sigma0builder {
         }
       }
 
+      //_______________________________________________
+      // Pairing information of the PCM candidates
+      if constexpr (!soa::is_table<TEMCal>) {
+        const double sigmaMass = doLambdaStar ? o2::constants::physics::MassLambda1520 : o2::constants::physics::MassSigma0;
+        bestGammasEnergy.clear();
+        bestLambdasInfo.clear();
+        bestKShortsInfo.clear();
+        for (const auto& gammaIdx : bestGammasArray) {
+          auto gamma = fullV0s.rawIteratorAt(gammaIdx);
+          bestGammasEnergy.push_back(std::sqrt(gamma.px() * gamma.px() + gamma.py() * gamma.py() + gamma.pz() * gamma.pz()));
+        }
+        if (fillSigma0Tables) {
+          for (const auto& lambdaIdx : bestLambdasArray) {
+            bestLambdasInfo.push_back(getV0PairingInfo(fullV0s.rawIteratorAt(lambdaIdx), o2::constants::physics::MassLambda0, sigmaMass, Sigma0Window));
+          }
+        }
+        if (fillKStarTables) {
+          for (const auto& kshortIdx : bestKShortsArray) {
+            bestKShortsInfo.push_back(getV0PairingInfo(fullV0s.rawIteratorAt(kshortIdx), o2::constants::physics::MassK0Short, o2::constants::physics::MassK0Star892, KStarWindow));
+          }
+        }
+      }
+
       //_______________________________________________
       // Photon-V0 nested loop
       for (size_t i = 0; i < bestGammasArray.size(); ++i) {
@@ -2744,15 +2809,28 @@ struct sigma0builder {
         // Sigma0 loop
         if (fillSigma0Tables) {
           for (size_t j = 0; j < bestLambdasArray.size(); ++j) {
-            auto lambda = fullV0s.rawIteratorAt(bestLambdasArray[j]);
-
             // Building sigma0 candidate & filling tables
             if constexpr (soa::is_table<TEMCal>) { // using EMCal photons
+              auto lambda = fullV0s.rawIteratorAt(bestLambdasArray[j]);
               auto gamma1 = fullEMCalClusters.rawIteratorAt(bestGammasArray[i]);
               if (!buildEMCalSigma0(lambda, gamma1, coll, mcparticles, emcaltracksgrouped))
                 continue;
             } else { // using PCM photons
+              // pairs out of the mass window are only counted, as in buildPCMSigma0
+              const auto& lambdaInfo = bestLambdasInfo[j];
+              if (bestGammasArray[i] == lambdaInfo.globalIndex)
+                continue;
               auto gamma1 = fullV0s.rawIteratorAt(bestGammasArray[i]);
+              if (gamma1.posTrackExtraId() == lambdaInfo.posTrackExtraId ||
+                  gamma1.negTrackExtraId() == lambdaInfo.negTrackExtraId ||
+                  gamma1.posTrackExtraId() == lambdaInfo.negTrackExtraId ||
+                  gamma1.negTrackExtraId() == lambdaInfo.posTrackExtraId)
+                continue;
+              if (bestGammasEnergy[i] < lambdaInfo.minPhotonEnergy || bestGammasEnergy[i] > lambdaInfo.maxPhotonEnergy) {
+                histos.fill(HIST("SigmaSel/hSelectionStatistics"), 1.);
+                continue;
+              }
+              auto lambda = fullV0s.rawIteratorAt(bestLambdasArray[j]);
               if (!buildPCMSigma0(lambda, gamma1, coll, mcparticles))
                 continue;
             }
@@ -2765,6 +2843,15 @@ struct sigma0builder {
           if (fillKStarTables) {
             auto gamma1 = fullV0s.rawIteratorAt(bestGammasArray[i]);
             for (size_t j = 0; j < bestKShortsArray.size(); ++j) {
+              // pairs out of the mass window are only counted, as in buildKStar
+              const auto& kshortInfo = bestKShortsInfo[j];
+              if (gamma1.posTrackExtraId() == kshortInfo.posTrackExtraId ||
+                  gamma1.negTrackExtraId() == kshortInfo.negTrackExtraId)
+                continue;
+              if (bestGammasEnergy[i] < kshortInfo.minPhotonEnergy || bestGammasEnergy[i] > kshortInfo.maxPhotonEnergy) {
+                histos.fill(HIST("KStarSel/hSelectionStatistics"), 1.);
+                continue;
+              }
               auto kshort = fullV0s.rawIteratorAt(bestKShortsArray[j]);
 
               // Building kstar candidate & filling tables
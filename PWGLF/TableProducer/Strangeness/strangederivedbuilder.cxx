@@ -42,6 +42,7 @@
 #include <Framework/OutputObjHeader.h>
 #include <Framework/StaticFor.h>
 #include <Framework/runDataProcessing.h>
+#include <MathUtils/detail/TypeTruncation.h>
 
 #include <TH1.h>
 #include <TH2.h>
@@ -186,6 +187,12 @@ struct strangederivedbuilder {
   Configurable<bool> roundNSigmaVariables{"roundNSigmaVariables", false, "round NSigma variables"};
   Configurable<float> precisionNSigmas{"precisionNSigmas", 0.1f, "precision to keep NSigmas"};
 
+  // reduce the precision of the floating point variables if requested
+  // only the lowest bits of the mantissa are zeroed, the tables keep their format (no change needed in the analyses)
+  // but the derived data compress much better; CosPA-like variables are not written here and not affected
+  Configurable<bool> reduceFloatPrecision{"reduceFloatPrecision", false, "reduce the precision of the collision positions, mother MC momenta and daughter track variables"};
+  Configurable<int> floatPrecisionBits{"floatPrecisionBits", 16, "number of mantissa bits kept (out of 23) if reducing the precision"};
+
   struct : ConfigurableGroup {
     Configurable<bool> fillRawFT0A{"fillRawFT0A", false, "Fill raw FT0A information for debug"};
     Configurable<bool> fillRawFT0C{"fillRawFT0C", true, "Fill raw FT0C information for debug"};
@@ -242,9 +249,23 @@ struct strangederivedbuilder {
     return step * static_cast<float>(static_cast<int>((number) / step)) + TMath::Sign(1.0f, number) * (0.5f) * step;
   }
 
+  uint32_t floatPrecisionMask = 0xFFFFFFFF; // mask of the kept bits of the floating point variables
+
+  float reducePrecision(float number)
+  {
+    // keeps the sign, the exponent and the requested number of mantissa bits
+    return reduceFloatPrecision ? o2::math_utils::detail::truncateFloatFraction(number, floatPrecisionMask) : number;
+  }
+
   void init(InitContext&)
   {
     LOGF(info, "Initializing now: cross-checking correctness...");
+    if (reduceFloatPrecision) {
+      constexpr int NMantissaBits = 23;
+      const int keptBits = std::clamp(static_cast<int>(floatPrecisionBits), 0, NMantissaBits);
+      floatPrecisionMask = 0xFFFFFFFF << (NMantissaBits - keptBits);
+      LOGF(info, "Floating point variables stored with %d mantissa bits (mask 0x%08x)", keptBits, floatPrecisionMask);
+    }
     if (doprocessCollisionsRun3 +
           doprocessCollisionsRun3WithUD +
           doprocessCollisionsRun3WithMC +
@@ -522,7 +543,7 @@ struct strangederivedbuilder {
       // fill collision tables
       if (strange || fillEmptyCollisions) {
         products.strangeStamps(bc.runNumber(), bc.timestamp(), bc.globalBC());
-        products.strangeColl(collision.posX(), collision.posY(), collision.posZ());
+        products.strangeColl(reducePrecision(collision.posX()), reducePrecision(collision.posY()), reducePrecision(collision.posZ()));
         if constexpr (requires { collision.mcCollisionId(); }) { // check if MC information is available and if so fill labels
           products.strangeCollLabels(collision.mcCollisionId());
         }
@@ -700,7 +721,7 @@ struct strangederivedbuilder {
         totalMult++;
       }
 
-      products.strangeMCColl(mccollision.posX(), mccollision.posY(), mccollision.posZ(),
+      products.strangeMCColl(reducePrecision(mccollision.posX()), reducePrecision(mccollision.posY()), reducePrecision(mccollision.posZ()),
                              mccollision.impactParameter(), mccollision.eventPlaneAngle(), mccollision.generatorsID());
       products.strangeMCMults(mccollision.multMCFT0A(), mccollision.multMCFT0C(),
                               mccollision.multMCNParticlesEta05(),
@@ -776,8 +797,8 @@ struct strangederivedbuilder {
     // circle back and populate actual DauTrackExtra table
     for (auto const& tr : tracksExtra) {
       if (trackMap[tr.globalIndex()] >= 0) {
-        products.dauTrackExtras(tr.itsChi2NCl(),
-                                tr.tpcChi2NCl(),
+        products.dauTrackExtras(reducePrecision(tr.itsChi2NCl()),
+                                reducePrecision(tr.tpcChi2NCl()),
                                 tr.detectorMap(),
                                 tr.itsClusterSizes(),
                                 tr.tpcNClsFindable(),
@@ -872,8 +893,8 @@ struct strangederivedbuilder {
     // circle back and populate actual DauTrackExtra table
     for (auto const& tr : tracksExtra) {
       if (trackMap[tr.globalIndex()] >= 0) {
-        products.dauTrackExtras(tr.itsChi2NCl(),
-                                tr.tpcChi2NCl(),
+        products.dauTrackExtras(reducePrecision(tr.itsChi2NCl()),
+                                reducePrecision(tr.tpcChi2NCl()),
                                 tr.detectorMap(),
                                 tr.itsClusterSizes(),
                                 tr.tpcNClsFindable(),
@@ -889,14 +910,14 @@ struct strangederivedbuilder {
         }
 
         if constexpr (requires { tr.tpcNSigmaEl(); }) {
-          products.dauTrackTPCPIDs(tr.tpcSignal(),
+          products.dauTrackTPCPIDs(reducePrecision(tr.tpcSignal()),
                                    aod::dautrack::packing::packInInt8(tr.tpcNSigmaEl()),
                                    aod::dautrack::packing::packInInt8(tr.tpcNSigmaPi()),
                                    aod::dautrack::packing::packInInt8(tr.tpcNSigmaKa()),
                                    aod::dautrack::packing::packInInt8(tr.tpcNSigmaPr()));
           // populate daughter-level TOF information
           if (tr.hasTOF()) {
-            products.dauTrackTOFPIDs(tr.collisionId(), products.dauTrackExtras.lastIndex(), tr.tofSignal(), tr.tofEvTime(), tr.length(), tr.tofExpMom());
+            products.dauTrackTOFPIDs(tr.collisionId(), products.dauTrackExtras.lastIndex(), reducePrecision(tr.tofSignal()), reducePrecision(tr.tofEvTime()), reducePrecision(tr.length()), reducePrecision(tr.tofExpMom()));
           }
         } else {
           // populate with empty fully-compatible Nsigmas if no corresponding table available
@@ -976,7 +997,7 @@ struct strangederivedbuilder {
     // populate motherMCParticles
     for (auto const& tr : mcParticles) {
       if (motherReference[tr.globalIndex()] >= 0) {
-        products.motherMCParts(tr.px(), tr.py(), tr.pz(), tr.pdgCode(), tr.isPhysicalPrimary());
+        products.motherMCParts(reducePrecision(tr.px()), reducePrecision(tr.py()), reducePrecision(tr.pz()), tr.pdgCode(), tr.isPhysicalPrimary());
       }
     }
   }
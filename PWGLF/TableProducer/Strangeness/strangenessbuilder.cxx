@@ -601,6 +601,10 @@ struct StrangenessBuilder {
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // for the findable modes, reused across the data frames
+  std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
+  std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
+
   void init(InitContext& context)
   {
     // setup bookkeeping histogram
@@ -1159,14 +1163,13 @@ struct StrangenessBuilder {
     sorted_v0.clear();
     sorted_cascade.clear();
     ao2dV0toV0List.clear();
+    bestCollisionArray.clear();
+    bestCollisionNContribsArray.clear();
 
     trackEntry currentTrackEntry;
     v0Entry currentV0Entry;
     cascadeEntry currentCascadeEntry;
 
-    std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
-    std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
-
     int collisionLessV0s = 0;
     int collisionLessCascades = 0;
 
@@ -213,6 +213,10 @@ struct strangenesstofpid {
   float maxSnp;  // max sine phi for propagation
   float maxStep; // max step size (cm) for propagation
 
+  // end points (x1, y1, x2, y2) of the 18 TOF sectors in the transverse plane, set at init
+  static constexpr int NTofSectors = 18;
+  std::array<std::array<float, 4>, NTofSectors> tofSectors;
+
   // enum to keep track of the TOF-related properties for V0s
   enum tofEnum { kLength = 0,
                  kHasTOF,
@@ -228,34 +232,24 @@ struct strangenesstofpid {
 
   /// function to calculate track length of this track up to a certain segment of a detector
   /// to be used internally in another function that calculates length until it finds the proper one
-  /// warning: this could be optimised further for speed
-  /// \param track the input track
+  /// the track-dependent quantities (circle, start point, momentum) are computed once by the caller for all the segments
+  /// \param trcCircle circle of the track in the transverse plane
+  /// \param startPoint start point of the track
+  /// \param mom momentum of the track at the start point
+  /// \param lengthFactor ratio of the track length to its transverse length, sqrt(1 + tgl^2)
   /// \param x1 x of the first point of the detector segment
   /// \param y1 y of the first point of the detector segment
   /// \param x2 x of the first point of the detector segment
   /// \param y2 y of the first point of the detector segment
-  /// \param magneticField the magnetic field to use when propagating
-  float trackLengthToSegment(o2::track::TrackPar track, float x1, float y1, float x2, float y2, float magneticField)
+  float trackLengthToSegment(o2::math_utils::CircleXYf_t const& trcCircle, std::array<float, 3> const& startPoint, std::array<float, 3> const& mom, double lengthFactor, float x1, float y1, float x2, float y2)
   {
     // don't make use of the track parametrization
     float length = -104;
 
-    // causality protection
-    std::array<float, 3> mom;
-    track.getPxPyPzGlo(mom);
-    // get start point
-    std::array<float, 3> startPoint;
-    track.getXYZGlo(startPoint);
-
     // better replaced with scalar momentum check later
     // if (((x1 + x2) * mom[0] + (y1 + y2) * mom[1]) < 0.0f)
     //   return -101;
 
-    // get circle X, Y please
-    o2::math_utils::CircleXYf_t trcCircle;
-    float sna, csa;
-    track.getCircleParams(magneticField, trcCircle, sna, csa);
-
     // Calculate necessary inner product
     float segmentModulus = std::hypot(x2 - x1, y2 - y1);
     float alongSegment = ((trcCircle.xC - x1) * (x2 - x1) + (trcCircle.yC - y1) * (y2 - y1)) / segmentModulus;
@@ -290,7 +284,7 @@ struct strangenesstofpid {
     cosAngle1 /= modulus1;
     sinAngle1 /= modulus1;
     length1 = trcCircle.rC * TMath::ACos(cosAngle1);
-    length1 *= sqrt(1.0f + track.getTgl() * track.getTgl());
+    length1 *= lengthFactor;
 
     modulus2 = std::hypot(interceptX2 - trcCircle.xC, interceptY2 - trcCircle.yC) * std::hypot(startPoint[0] - trcCircle.xC, startPoint[1] - trcCircle.yC);
     cosAngle2 = (interceptX2 - trcCircle.xC) * (startPoint[0] - trcCircle.xC) + (interceptY2 - trcCircle.yC) * (startPoint[1] - trcCircle.yC);
@@ -298,7 +292,7 @@ struct strangenesstofpid {
     cosAngle2 /= modulus2;
     sinAngle2 /= modulus2;
     length2 = trcCircle.rC * TMath::ACos(cosAngle2);
-    length2 *= sqrt(1.0f + track.getTgl() * track.getTgl());
+    length2 *= lengthFactor;
 
     // rotate transverse momentum vector such that it is at intercepts
     float angle1 = TMath::ACos(cosAngle1);
@@ -335,17 +329,23 @@ struct strangenesstofpid {
   /// \param magneticField the magnetic field to use when propagating
   float findInterceptLength(o2::track::TrackPar track, float magneticField)
   {
+    // causality protection
+    std::array<float, 3> mom;
+    track.getPxPyPzGlo(mom);
+    // get start point
+    std::array<float, 3> startPoint;
+    track.getXYZGlo(startPoint);
+
+    // get circle X, Y please
+    o2::math_utils::CircleXYf_t trcCircle;
+    float sna, csa;
+    track.getCircleParams(magneticField, trcCircle, sna, csa);
+    const double lengthFactor = sqrt(1.0f + track.getTgl() * track.getTgl());
+
     float length = 1e+6;
-    for (int iSeg = 0; iSeg < 18; iSeg++) {
+    for (const auto& sector : tofSectors) {
       // Detector segmentation loop
-      float segmentAngle = 20.0f / 180.0f * TMath::Pi();
-      float theta = static_cast<float>(iSeg) * 20.0f / 180.0f * TMath::Pi();
-      float halfWidth = propagationConfiguration.tofPosition * TMath::Tan(0.5f * segmentAngle);
-      float x1 = TMath::Cos(theta) * (-halfWidth) + TMath::Sin(theta) * propagationConfiguration.tofPosition;
-      float y1 = -TMath::Sin(theta) * (-halfWidth) + TMath::Cos(theta) * propagationConfiguration.tofPosition;
-      float x2 = TMath::Cos(theta) * (+halfWidth) + TMath::Sin(theta) * propagationConfiguration.tofPosition;
-      float y2 = -TMath::Sin(theta) * (+halfWidth) + TMath::Cos(theta) * propagationConfiguration.tofPosition;
-      float thisLength = trackLengthToSegment(track, x1, y1, x2, y2, magneticField);
+      float thisLength = trackLengthToSegment(trcCircle, startPoint, mom, lengthFactor, sector[0], sector[1], sector[2], sector[3]);
       if (thisLength < length && thisLength > 0) {
         length = thisLength;
       }
@@ -357,6 +357,17 @@ struct strangenesstofpid {
 
   void init(InitContext& initContext)
   {
+    // TOF sectors, they only depend on the configured radius
+    for (int iSeg = 0; iSeg < NTofSectors; iSeg++) {
+      float segmentAngle = 20.0f / 180.0f * TMath::Pi();
+      float theta = static_cast<float>(iSeg) * 20.0f / 180.0f * TMath::Pi();
+      float halfWidth = propagationConfiguration.tofPosition * TMath::Tan(0.5f * segmentAngle);
+      tofSectors[iSeg][0] = TMath::Cos(theta) * (-halfWidth) + TMath::Sin(theta) * propagationConfiguration.tofPosition;
+      tofSectors[iSeg][1] = -TMath::Sin(theta) * (-halfWidth) + TMath::Cos(theta) * propagationConfiguration.tofPosition;
+      tofSectors[iSeg][2] = TMath::Cos(theta) * (+halfWidth) + TMath::Sin(theta) * propagationConfiguration.tofPosition;
+      tofSectors[iSeg][3] = -TMath::Sin(theta) * (+halfWidth) + TMath::Cos(theta) * propagationConfiguration.tofPosition;
+    }
+
     if (calculateV0s.value < 0) {
       // check if TOF information is required, enable if so
       calculateV0s.value = isTableRequiredInWorkflow(initContext, "V0TOFNSigmas");
@@ -47,14 +47,16 @@
 #include <Framework/runDataProcessing.h>
 #include <ReconstructionDataFormats/PID.h>
 
-#include <TF1.h>
 #include <TH2.h>
 #include <TH3.h>
 #include <TMCProcess.h>
 #include <TPDGCode.h>
 
+#include <algorithm>
+#include <array>
 #include <bitset>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <gsl/span>
 #include <memory>
@@ -221,11 +223,30 @@ struct LFNucleiBATask {
   Configurable<int> unableAntiDPtShift{"unableAntiDPtShift", 0, "Select (0) to apply antideuteron pT shift or (1) to use default pT."};
 
   // Additional function used for pT-shift calibration
-  TF1* fShiftPtHe = 0;
-  TF1* fShiftPtantiHe = 0;
-  TF1* fShiftAntiD = 0;
-  TF1* fShiftD = 0;
-  TF1* fShiftPtPID = 0;
+  // [0] * exp([1] + [2] * x) + [3] + [4] * x + [5] * x * x + [6] * x * x * x, evaluated directly instead of with a TF1 in the track loop
+  struct PtShiftFunction {
+    static constexpr std::size_t NPar = 7;
+    std::array<double, NPar> par{}; // parameters, the missing ones are zero
+    bool isSet = false;
+
+    void setParameters(const std::vector<float>& parameters, const std::size_t nPar)
+    {
+      par.fill(0.);
+      for (std::size_t i = 0; i < std::min(nPar, NPar); i++) {
+        par[i] = parameters[i];
+      }
+      isSet = true;
+    }
+    double eval(const double x) const
+    {
+      return par[0] * std::exp(par[1] + par[2] * x) + par[3] + par[4] * x + par[5] * x * x + par[6] * x * x * x;
+    }
+  };
+  PtShiftFunction fShiftPtHe;
+  PtShiftFunction fShiftPtantiHe;
+  PtShiftFunction fShiftAntiD;
+  PtShiftFunction fShiftD;
+  PtShiftFunction fShiftPtPID;
 
   Configurable<bool> enablePtShiftD{"enablePtShiftD", true, "Flag to enable Pt shift (for Deuteron only)"};
   Configurable<bool> enablePtShiftAntiD{"enablePtShiftAntiD", true, "Flag to enable Pt shift (for antiDeuteron only)"};
@@ -2487,34 +2508,26 @@ struct LFNucleiBATask {
       float shiftPtNeg = 0.f;
       float shiftPtPID = 0.f;
 
-      if (enablePtShiftHe && !fShiftPtHe) {
-        fShiftPtHe = new TF1("fShiftPtHe", "[0] * exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto parHe = (std::vector<float>)parShiftPtHe; // NOLINT
-        fShiftPtHe->SetParameters(parHe[0], parHe[1], parHe[2], parHe[3], parHe[4]);
+      if (enablePtShiftHe && !fShiftPtHe.isSet) {
+        fShiftPtHe.setParameters(parShiftPtHe.value, 5);
       }
 
-      if (enablePtShiftHe && !fShiftPtantiHe) {
-        fShiftPtantiHe = new TF1("fShiftPtantiHe", "[0] * exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto parAntiHe = (std::vector<float>)parShiftPtAntiHe; // NOLINT
-        fShiftPtantiHe->SetParameters(parAntiHe[0], parAntiHe[1], parAntiHe[2], parAntiHe[3], parAntiHe[4]);
+      if (enablePtShiftHe && !fShiftPtantiHe.isSet) {
+        fShiftPtantiHe.setParameters(parShiftPtAntiHe.value, 5);
       }
 
-      if (enablePtShiftAntiD && !fShiftAntiD) {
-        fShiftAntiD = new TF1("fShiftAntiD", "[0] * exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto parAntiD = (std::vector<float>)parShiftPtAntiD; // NOLINT
-        fShiftAntiD->SetParameters(parAntiD[0], parAntiD[1], parAntiD[2], parAntiD[3], parAntiD[4]);
+      if (enablePtShiftAntiD && !fShiftAntiD.isSet) {
+        fShiftAntiD.setParameters(parShiftPtAntiD.value, 5);
       }
 
-      if (enablePtShiftPID && !fShiftPtPID) {
-        fShiftPtPID = new TF1("fShiftPtPID", "[0] * exp([1] + [2] * x) + [3] + [4] * x + [5] * x * x + [6] * x * x * x", 0.f, 8.f);
-        auto parPID = (std::vector<float>)parShiftPtPID; // NOLINT
-        fShiftPtPID->SetParameters(parPID[0], parPID[1], parPID[2], parPID[3], parPID[4], parPID[5], parPID[6]);
+      if (enablePtShiftPID && !fShiftPtPID.isSet) {
+        fShiftPtPID.setParameters(parShiftPtPID.value, 7);
       }
 
       switch (unableAntiDPtShift) {
         case 0:
-          if (enablePtShiftAntiD && fShiftAntiD) {
-            auto shiftAntiD = fShiftAntiD->Eval(track.pt());
+          if (enablePtShiftAntiD && fShiftAntiD.isSet) {
+            auto shiftAntiD = fShiftAntiD.eval(track.pt());
             antiDPt = track.pt() - shiftAntiD;
           }
           break;
@@ -2523,16 +2536,14 @@ struct LFNucleiBATask {
           break;
       }
 
-      if (enablePtShiftD && !fShiftD) {
-        fShiftD = new TF1("fShiftD", "[0] * exp([1] + [2] * x) + [3] + [4] * x", 0.f, 8.f);
-        auto parD = (std::vector<float>)parShiftPtD; // NOLINT
-        fShiftD->SetParameters(parD[0], parD[1], parD[2], parD[3], parD[4]);
+      if (enablePtShiftD && !fShiftD.isSet) {
+        fShiftD.setParameters(parShiftPtD.value, 5);
       }
 
       switch (unableDPtShift) {
         case 0:
-          if (enablePtShiftD && fShiftD) {
-            auto shiftD = fShiftD->Eval(track.pt());
+          if (enablePtShiftD && fShiftD.isSet) {
+            auto shiftD = fShiftD.eval(track.pt());
             DPt = track.pt() - shiftD;
           }
           break;
@@ -2544,17 +2555,17 @@ struct LFNucleiBATask {
       switch (helium3Pt) {
         case 0:
           hePt = track.pt();
-          if (enablePtShiftHe && fShiftPtHe) {
-            shiftPtPos = fShiftPtHe->Eval(2 * track.pt());
+          if (enablePtShiftHe && fShiftPtHe.isSet) {
+            shiftPtPos = fShiftPtHe.eval(2 * track.pt());
             hePt = track.pt() - shiftPtPos / 2.f;
           }
           antihePt = track.pt();
-          if (enablePtShiftHe && fShiftPtantiHe) {
-            shiftPtNeg = fShiftPtantiHe->Eval(2 * track.pt());
+          if (enablePtShiftHe && fShiftPtantiHe.isSet) {
+            shiftPtNeg = fShiftPtantiHe.eval(2 * track.pt());
             antihePt = track.pt() - shiftPtNeg / 2.f;
           }
-          if (enablePtShiftPID && fShiftPtPID) {
-            shiftPtPID = fShiftPtPID->Eval(2 * track.pt());
+          if (enablePtShiftPID && fShiftPtPID.isSet) {
+            shiftPtPID = fShiftPtPID.eval(2 * track.pt());
             if (tritonPID && (track.pt() <= 1.25f)) {
               hePt = track.pt() - shiftPtPID / 2.f;
               antihePt = track.pt() - shiftPtPID / 2.f;
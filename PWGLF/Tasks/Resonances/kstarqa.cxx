@@ -1054,6 +1054,35 @@ struct Kstarqa {
   ROOT::Math::XYZVector randomVec, beamVec, normalVec;
   bool isMix = false;
 
+  std::vector<bool> isSelectedTrack; // track selection of each track of the collision, indexed from the first track
+  int64_t firstTrackIndex{0};        // global index of the first track of the collision
+
+  /// Evaluates the track selection once for each track of the collision, before the same-event pair loop
+  template <typename T>
+  void cacheTrackSelection(const T& tracks)
+  {
+    isSelectedTrack.clear();
+    if (tracks.size() == 0) {
+      return;
+    }
+    int64_t lastTrackIndex = firstTrackIndex = tracks.begin().globalIndex();
+    for (const auto& track : tracks) {
+      firstTrackIndex = std::min(firstTrackIndex, static_cast<int64_t>(track.globalIndex()));
+      lastTrackIndex = std::max(lastTrackIndex, static_cast<int64_t>(track.globalIndex()));
+    }
+    isSelectedTrack.assign(lastTrackIndex - firstTrackIndex + 1, false);
+    for (const auto& track : tracks) {
+      isSelectedTrack[track.globalIndex() - firstTrackIndex] = selectionTrack(track);
+    }
+  }
+
+  /// \return the cached track selection of a track of the collision
+  template <typename T>
+  bool isSelectedTrackCached(const T& track) const
+  {
+    return isSelectedTrack[track.globalIndex() - firstTrackIndex];
+  }
+
   template <typename T1, typename T2>
   void fillInvMass(const T1& daughter1, const T1& daughter2, const T1& mother, float multiplicity, bool isMix, const T2& track1, const T2& track2)
   {
@@ -1134,12 +1163,13 @@ struct Kstarqa {
       rEventSelection.fill(HIST("hMultiplicity"), multiplicity);
     }
 
+    cacheTrackSelection(tracks);
     for (const auto& [track1, track2] : combinations(CombinationsFullIndexPolicy(tracks, tracks))) {
       rEventSelection.fill(HIST("tracksCheckData"), 0.5);
-      if (!selectionTrack(track1)) {
+      if (!isSelectedTrackCached(track1)) {
         continue;
       }
-      if (!selectionTrack(track2)) {
+      if (!isSelectedTrackCached(track2)) {
         continue;
       }
       rEventSelection.fill(HIST("tracksCheckData"), 1.5);
@@ -1549,9 +1579,10 @@ struct Kstarqa {
       rEventSelection.fill(HIST("hMultiplicity"), multiplicity);
     }
 
+    cacheTrackSelection(tracks);
     for (const auto& [track1, track2] : combinations(CombinationsFullIndexPolicy(tracks, tracks))) {
       rEventSelection.fill(HIST("tracksCheckData"), 0.5);
-      if (!selectionTrack(track1) || !selectionTrack(track2)) {
+      if (!isSelectedTrackCached(track1) || !isSelectedTrackCached(track2)) {
         continue;
       }
 
@@ -2572,12 +2603,13 @@ struct Kstarqa {
       // rEventSelection.fill(HIST("multdist_FT0M"), collision.multFT0M());
     }
 
+    cacheTrackSelection(tracks);
     for (const auto& [track1, track2] : combinations(CombinationsStrictlyUpperIndexPolicy(tracks, tracks))) {
       rEventSelection.fill(HIST("tracksCheckData"), 0.5);
-      if (!selectionTrack(track1)) {
+      if (!isSelectedTrackCached(track1)) {
         continue;
       }
-      if (!selectionTrack(track2)) {
+      if (!isSelectedTrackCached(track2)) {
         continue;
       }
       rEventSelection.fill(HIST("tracksCheckData"), 1.5);
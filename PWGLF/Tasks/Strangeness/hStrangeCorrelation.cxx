@@ -66,12 +66,14 @@
 
 #include <Rtypes.h>
 
+#include <array>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <variant>
 #include <vector>
 
@@ -707,7 +709,7 @@ struct HStrangeCorrelation {
 
     return dPhiStarMean;
   }
-  void fillTriggerHistogram(std::shared_ptr<TH2> hist, double pt, double mult, float eff, float effUncert, float purity, float purityErr)
+  void fillTriggerHistogram(std::shared_ptr<TH2> const& hist, double pt, double mult, float eff, float effUncert, float purity, float purityErr)
   {
     int binx = hist->GetXaxis()->FindBin(pt);
     int biny = hist->GetYaxis()->FindBin(mult);
@@ -718,7 +720,7 @@ struct HStrangeCorrelation {
     hist->SetBinContent(binx, biny, newContent);
     hist->SetBinError(binx, biny, newUncert);
   }
-  void fillCorrelationHistogram(std::shared_ptr<THn> hist, double binFillThn[], float etaWeight, float efficiency, float totalEffUncert, float purity, float totalPurityUncert)
+  void fillCorrelationHistogram(std::shared_ptr<THn> const& hist, double binFillThn[], float etaWeight, float efficiency, float totalEffUncert, float purity, float totalPurityUncert)
   {
     float previousContent, previousError2, currentContent, currentError2;
     int bin = hist->GetBin(binFillThn);
@@ -1003,6 +1005,16 @@ struct HStrangeCorrelation {
         (hastirgorassoc == 3 && currentCollision.trigParticles.empty() && currentCollision.assocParticles.empty()) ||
         (hastirgorassoc == 4 && (currentCollision.trigParticles.empty() || currentCollision.assocParticles.empty())))
       return;
+    // histograms of the mixed pairs by region and type, looked up once and not for each pair
+    std::array<std::array<std::shared_ptr<THn>, 3>, 3> mixedEventHists;
+    static_for<0, 2>([&](auto i) {
+      constexpr int Index = i.value;
+      if (TESTBIT(doCorrelation, Index) && masterConfigurations.doFullCorrelationStudy) {
+        mixedEventHists[0][Index] = histos.get<THn>(HIST("mixedEvent/LeftBg/") + HIST(V0names[Index]));
+        mixedEventHists[1][Index] = histos.get<THn>(HIST("mixedEvent/Signal/") + HIST(V0names[Index]));
+        mixedEventHists[2][Index] = histos.get<THn>(HIST("mixedEvent/RightBg/") + HIST(V0names[Index]));
+      }
+    });
     for (const auto& collision : validCollisions[binnumb]) {
       BinningTypePP colBinning{{axesConfigurations.axisVtxZ, axesConfigurations.axisMult}, true};
       // When 'collisionHasTriggOrAssoc' = 0:
@@ -1026,25 +1038,17 @@ struct HStrangeCorrelation {
             totalEffUncert = std::sqrt(std::pow(efficiencyTrigg * efficiencyAssocError, 2) + std::pow(efficiencyTriggError * efficiencyAssoc, 2));
           }
           double binFillThn[6] = {deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult};
-          static_for<0, 2>([&](auto i) {
-            constexpr int Index = i.value;
-            if (Index == assoc.type && assoc.region == 0) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/LeftBg/") + HIST(V0names[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-            if (Index == assoc.type && assoc.region == 1) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/Signal/") + HIST(V0names[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-            if (Index == assoc.type && assoc.region == 2) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/RightBg/") + HIST(V0names[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-          });
+          const auto& hist = mixedEventHists[assoc.region][assoc.type];
+          if (hist) {
+            fillCorrelationHistogram(hist, binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
+          }
         }
       }
     }
     if (validCollisions[binnumb].size() >= static_cast<size_t>(masterConfigurations.mixingParameter)) {
       validCollisions[binnumb].erase(validCollisions[binnumb].begin());
     }
-    validCollisions[binnumb].push_back(currentCollision);
+    validCollisions[binnumb].push_back(std::move(currentCollision));
   }
 
   void fillCorrelationsCascade(aod::TriggerTracks const& triggers, aod::AssocCascades const& assocs, bool mixing, bool mixingInBf, float pvx, float pvy, float pvz, float mult, double bField)
@@ -1309,6 +1313,16 @@ struct HStrangeCorrelation {
         (hastirgorassoc == 3 && currentCollision.trigParticles.empty() && currentCollision.assocParticles.empty()) ||
         (hastirgorassoc == 4 && (currentCollision.trigParticles.empty() || currentCollision.assocParticles.empty())))
       return;
+    // histograms of the mixed pairs by region and type, looked up once and not for each pair
+    std::array<std::array<std::shared_ptr<THn>, 4>, 3> mixedEventHists;
+    static_for<0, 3>([&](auto i) {
+      constexpr int Index = i.value;
+      if (TESTBIT(doCorrelation, Index + 3) && masterConfigurations.doFullCorrelationStudy) {
+        mixedEventHists[0][Index] = histos.get<THn>(HIST("mixedEvent/LeftBg/") + HIST(Cascadenames[Index]));
+        mixedEventHists[1][Index] = histos.get<THn>(HIST("mixedEvent/Signal/") + HIST(Cascadenames[Index]));
+        mixedEventHists[2][Index] = histos.get<THn>(HIST("mixedEvent/RightBg/") + HIST(Cascadenames[Index]));
+      }
+    });
     for (const auto& collision : validCollisions[binnumb]) {
       BinningTypePP colBinning{{axesConfigurations.axisVtxZ, axesConfigurations.axisMult}, true};
       histos.fill(HIST("MixingQA/hMECollisionBins"), colBinning.getBin({collision.pvz, collision.mult}));
@@ -1327,25 +1341,17 @@ struct HStrangeCorrelation {
             totalEffUncert = std::sqrt(std::pow(efficiencyTrigg * efficiencyAssocError, 2) + std::pow(efficiencyTriggError * efficiencyAssoc, 2));
           }
           double binFillThn[6] = {deltaphi, deltaeta, ptassoc, pttrigger, pvz, mult};
-          static_for<0, 3>([&](auto i) {
-            constexpr int Index = i.value;
-            if (Index == assoc.type && assoc.region == 0) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/LeftBg/") + HIST(Cascadenames[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-            if (Index == assoc.type && assoc.region == 1) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/Signal/") + HIST(Cascadenames[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-            if (Index == assoc.type && assoc.region == 2) {
-              fillCorrelationHistogram(histos.get<THn>(HIST("mixedEvent/RightBg/") + HIST(Cascadenames[Index])), binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
-            }
-          });
+          const auto& hist = mixedEventHists[assoc.region][assoc.type];
+          if (hist) {
+            fillCorrelationHistogram(hist, binFillThn, 1, efficiencyTrigg * efficiencyAssoc, totalEffUncert, 1., 0.);
+          }
         }
       }
     }
     if (validCollisions[binnumb].size() >= static_cast<size_t>(masterConfigurations.mixingParameter)) {
       validCollisions[binnumb].erase(validCollisions[binnumb].begin());
     }
-    validCollisions[binnumb].push_back(currentCollision);
+    validCollisions[binnumb].push_back(std::move(currentCollision));
   }
   template <typename TTriggers, typename THadrons>
   void fillCorrelationsHadron(TTriggers const& triggers, THadrons const& assocs, bool mixing, float pvz, float mult, double bField)
@@ -35,8 +35,11 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <cstdlib>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace o2
 {
@@ -286,6 +289,17 @@ class decay3bodyBuilderHelper
       }
     } // end of selections
 
+    //_______________________________________________________________________
+    // SVertexer selections of the proton-pion sub-vertex in case of event mixing, before the 3body fit
+    // (the sub-vertex only depends on the proton-pion pair, so it is fitted once per pair)
+    float radiusV0 = 0.f;
+    if (isEventMixing && doApplySVertexerCuts) {
+      if (!applySVertexerV0Cuts(collision, trackProton, trackPion, /*applyV0Cut = */ true, radiusV0)) {
+        decay3body = {};
+        return false;
+      }
+    }
+
     //_______________________________________________________________________
     // daughter track DCA to PV associated with decay3body --> computed with KFParticle
     float pvXY[2] = {pvX, pvY};
@@ -481,7 +495,10 @@ class decay3bodyBuilderHelper
     //_______________________________________________________________________
     // SVertexer selections in case of event mixing
     if (isEventMixing && doApplySVertexerCuts) {
-      applySVertexerCuts(collision, trackProton, trackPion, trackDeuteron, /*applyV0Cut = */ true);
+      if (!applySVertexer3bodyCuts(collision, trackProton, trackPion, trackDeuteron, radiusV0)) {
+        decay3body = {};
+        return false;
+      }
     }
 
     //_______________________________________________________________________
@@ -751,19 +768,127 @@ class decay3bodyBuilderHelper
   }
 
   //_______________________________________________________________________
-  // functionality to apply SVertexer cuts in case of event mixing
+  // functionality to apply the SVertexer cuts of the proton-pion sub-vertex in case of event mixing
+  // the sub-vertex is fitted once per proton-pion pair and collision, and cached for the following candidates
+  // \return true if the sub-vertex passes the cuts, radiusV0 is set to its radius
+  template <typename TCollision, typename TTrack>
+  bool applySVertexerV0Cuts(TCollision const& collision,
+                            TTrack const& trackProton,
+                            TTrack const& trackPion,
+                            bool applyV0Cut,
+                            float& radiusV0)
+  {
+    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(trackProton.globalIndex())) << 32) | static_cast<uint32_t>(trackPion.globalIndex());
+    auto [it, isNew] = subVertexCache.try_emplace(key);
+    subVertex& v0 = it->second;
+    if (isNew || v0.collisionID != collision.globalIndex() || v0.bz != fitterV0.getBz()) {
+      v0 = {};
+      v0.collisionID = collision.globalIndex();
+      v0.bz = fitterV0.getBz();
+      fitSVertexerV0(collision, trackProton, trackPion, v0);
+    }
+    radiusV0 = v0.radius;
+    const bool isSelected = v0.isFitted && (!applyV0Cut || v0.passesCuts);
+    if (subVertexCache.size() > MaxSubVertices) {
+      subVertexCache.clear();
+    }
+    return isSelected;
+  }
+
+  // clears the cached proton-pion sub-vertices, to be called at each new data frame
+  void clearSubVertexCache() { subVertexCache.clear(); }
+
+  //_______________________________________________________________________
+  // functionality to apply the SVertexer cuts of the 3body vertex in case of event mixing
+  // \return true if the candidate passes the cuts
   template <typename TCollision, typename TTrack>
-  void applySVertexerCuts(TCollision const& collision,
-                          TTrack const& trackProton,
-                          TTrack const& trackPion,
-                          TTrack const& trackDeuteron,
-                          bool applyV0Cut = true)
+  bool applySVertexer3bodyCuts(TCollision const& collision,
+                               TTrack const& trackProton,
+                               TTrack const& trackPion,
+                               TTrack const& trackDeuteron,
+                               float radiusV0)
   {
     // get TrackParCov daughters
     auto trackParCovProton = getTrackParCov(trackProton);
     auto trackParCovPion = getTrackParCov(trackPion);
     auto trackParCovDeuteron = getTrackParCov(trackDeuteron);
 
+    // 3body vertex
+    int n3bodyVtx = fitter3body.process(trackParCovProton, trackParCovPion, trackParCovDeuteron);
+    if (n3bodyVtx == 0) { // discard this pair
+      return false;
+    }
+    const auto& vertexXYZ = fitter3body.getPCACandidatePos();
+    std::array<float, 3> pos = {0.};
+    for (int i = 0; i < 3; i++) {
+      pos[i] = vertexXYZ[i];
+    }
+
+    std::array<float, 3> pProton = {0.}, pPion = {0.}, pDeuteron{0.};
+    const auto& propagatedTrackProton = fitter3body.getTrack(0);
+    const auto& propagatedTrackPion = fitter3body.getTrack(1);
+    const auto& propagatedTrackDeuteron = fitter3body.getTrack(2);
+    propagatedTrackProton.getPxPyPzGlo(pProton);
+    propagatedTrackPion.getPxPyPzGlo(pPion);
+    propagatedTrackDeuteron.getPxPyPzGlo(pDeuteron);
+    std::array<float, 3> p3B = {pProton[0] + pPion[0] + pDeuteron[0], pProton[1] + pPion[1] + pDeuteron[1], pProton[2] + pPion[2] + pDeuteron[2]};
+
+    float r3body = std::hypot(pos[0], pos[1]);
+    if (r3body < 0.5) {
+      return false;
+    }
+
+    // Cut for the compatibility of V0 and 3body vertex
+    float deltaR = std::abs(radiusV0 - r3body);
+    if (deltaR > svertexerselections.maxRDiffV03body) {
+      return false;
+    }
+
+    float pt3B = std::hypot(p3B[0], p3B[1]);
+    if (pt3B < svertexerselections.minPt3Body) { // pt cut
+      return false;
+    }
+    if (p3B[2] / pt3B > svertexerselections.maxTgl3Body) { // tgLambda cut
+      return false;
+    }
+
+    // H3L DCA Check
+    auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, trackDeuteron.sign());
+    o2::dataformats::DCA dca;
+    if (!track3B.propagateToDCA({{collision.posX(), collision.posY(), collision.posZ()}, {collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()}}, fitter3body.getBz(), &dca, 5.) ||
+        std::abs(dca.getY()) > svertexerselections.maxDCAXY3Body || std::abs(dca.getZ()) > svertexerselections.maxDCAZ3Body) {
+      return false;
+    }
+
+    return true;
+  }
+
+ private:
+  // proton-pion sub-vertex of the SVertexer cuts
+  struct subVertex {
+    int collisionID = -1;    // collision of the sub-vertex
+    float bz = 0.f;          // magnetic field of the fit
+    bool isFitted = false;   // the sub-vertex could be fitted
+    bool passesCuts = false; // the sub-vertex passes the V0 cuts
+    float radius = 0.f;      // radius of the sub-vertex w.r.t. the mean vertex
+  };
+
+  static constexpr std::size_t MaxSubVertices = 1 << 16; // maximum number of cached sub-vertices
+
+  std::unordered_map<uint64_t, subVertex> subVertexCache; // sub-vertices by proton and pion index
+
+  //_______________________________________________________________________
+  // fits the proton-pion sub-vertex and evaluates its SVertexer cuts
+  template <typename TCollision, typename TTrack>
+  void fitSVertexerV0(TCollision const& collision,
+                      TTrack const& trackProton,
+                      TTrack const& trackPion,
+                      subVertex& v0)
+  {
+    // get TrackParCov daughters
+    auto trackParCovProton = getTrackParCov(trackProton);
+    auto trackParCovPion = getTrackParCov(trackPion);
+
     const float pidCutsLambda[o2::vertexing::SVertexHypothesis::NPIDParams] = {0., 20, 0., 5.0, 0.0, 1.09004e-03, 2.62291e-04, 8.93179e-03, 2.83121}; // Lambda
     mV0Hyps.set(o2::track::PID::Lambda, o2::track::PID::Proton, o2::track::PID::Pion, pidCutsLambda, fitter3body.getBz());
 
@@ -791,11 +916,13 @@ class decay3bodyBuilderHelper
     // Cut for Virtual V0
     float dxv0 = v0pos[0] - mMeanVertex.getX(), dyv0 = v0pos[1] - mMeanVertex.getY(), r2v0 = dxv0 * dxv0 + dyv0 * dyv0;
     float rv0 = std::sqrt(r2v0);
+    v0.isFitted = true;
+    v0.radius = rv0;
     float pt2V0 = pV0[0] * pV0[0] + pV0[1] * pV0[1], prodXYv0 = dxv0 * pV0[0] + dyv0 * pV0[1], tDCAXY = prodXYv0 / pt2V0;
-    if (applyV0Cut && pt2V0 <= svertexerselections.minPt2V0) {
+    if (pt2V0 <= svertexerselections.minPt2V0) {
       return;
     }
-    if (applyV0Cut && pV0[2] * pV0[2] / pt2V0 > svertexerselections.maxTgl2V0) { // tgLambda cut
+    if (pV0[2] * pV0[2] / pt2V0 > svertexerselections.maxTgl2V0) { // tgLambda cut
       return;
     }
 
@@ -807,17 +934,17 @@ class decay3bodyBuilderHelper
     if (massForLambdaHyp - mV0Hyps.getMassV0Hyp() < mV0Hyps.getMargin(ptV0)) {
       good3bodyV0Hyp = true;
     }
-    if (applyV0Cut && !good3bodyV0Hyp) {
+    if (!good3bodyV0Hyp) {
       return;
     }
 
     float dcaX = dxv0 - pV0[0] * tDCAXY, dcaY = dyv0 - pV0[1] * tDCAXY, dca2 = dcaX * dcaX + dcaY * dcaY;
     float cosPAXY = prodXYv0 / rv0 * ptV0;
-    if (applyV0Cut && dca2 > svertexerselections.maxDCAXY2ToMeanVertex3bodyV0) {
+    if (dca2 > svertexerselections.maxDCAXY2ToMeanVertex3bodyV0) {
       return;
     }
     // FIXME: V0 cosPA cut to be investigated
-    if (applyV0Cut && cosPAXY < svertexerselections.minCosPAXYMeanVertex3bodyV0) {
+    if (cosPAXY < svertexerselections.minCosPAXYMeanVertex3bodyV0) {
       return;
     }
     // Check: CosPA Cut of Virtual V0 may not be used since the V0 may be based on another PV
@@ -826,61 +953,12 @@ class decay3bodyBuilderHelper
     float dz = v0pos[2] - collision.posZ();
     float prodXYZv0 = dx * pV0[0] + dy * pV0[1] + dz * pV0[2];
     float v0CosPA = prodXYZv0 / std::sqrt((dx * dx + dy * dy + dz * dz) * p2V0);
-    if (applyV0Cut && v0CosPA < svertexerselections.minCosPA3bodyV0) {
-      return;
-    }
-
-    // 3body vertex
-    int n3bodyVtx = fitter3body.process(trackParCovProton, trackParCovPion, trackParCovDeuteron);
-    if (n3bodyVtx == 0) { // discard this pair
-      return;
-    }
-    const auto& vertexXYZ = fitter3body.getPCACandidatePos();
-    std::array<float, 3> pos = {0.};
-    for (int i = 0; i < 3; i++) {
-      pos[i] = vertexXYZ[i];
-    }
-
-    std::array<float, 3> pProton = {0.}, pPion = {0.}, pDeuteron{0.};
-    const auto& propagatedTrackProton = fitter3body.getTrack(0);
-    const auto& propagatedTrackPion = fitter3body.getTrack(1);
-    const auto& propagatedTrackDeuteron = fitter3body.getTrack(2);
-    propagatedTrackProton.getPxPyPzGlo(pProton);
-    propagatedTrackPion.getPxPyPzGlo(pPion);
-    propagatedTrackDeuteron.getPxPyPzGlo(pDeuteron);
-    std::array<float, 3> p3B = {pProton[0] + pPion[0] + pDeuteron[0], pProton[1] + pPion[1] + pDeuteron[1], pProton[2] + pPion[2] + pDeuteron[2]};
-
-    float r3body = std::hypot(pos[0], pos[1]);
-    if (r3body < 0.5) {
-      return;
-    }
-
-    // Cut for the compatibility of V0 and 3body vertex
-    float deltaR = std::abs(rv0 - r3body);
-    if (deltaR > svertexerselections.maxRDiffV03body) {
-      return;
-    }
-
-    float pt3B = std::hypot(p3B[0], p3B[1]);
-    if (pt3B < svertexerselections.minPt3Body) { // pt cut
-      return;
-    }
-    if (p3B[2] / pt3B > svertexerselections.maxTgl3Body) { // tgLambda cut
+    if (v0CosPA < svertexerselections.minCosPA3bodyV0) {
       return;
     }
-
-    // H3L DCA Check
-    auto track3B = o2::track::TrackParCov(vertexXYZ, p3B, trackDeuteron.sign());
-    o2::dataformats::DCA dca;
-    if (!track3B.propagateToDCA({{collision.posX(), collision.posY(), collision.posZ()}, {collision.covXX(), collision.covXY(), collision.covYY(), collision.covXZ(), collision.covYZ(), collision.covZZ()}}, fitter3body.getBz(), &dca, 5.) ||
-        std::abs(dca.getY()) > svertexerselections.maxDCAXY3Body || std::abs(dca.getZ()) > svertexerselections.maxDCAZ3Body) {
-      return;
-    }
-
-    return;
+    v0.passesCuts = true;
   }
 
- private:
   // internal helper to calculate DCA (3D) of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
@@ -23,6 +23,7 @@
 #include <DCAFitter/DCAFitterN.h>
 #include <DetectorsBase/MatLayerCylSet.h>
 #include <Framework/Logger.h>
+#include <MathUtils/Primitive2D.h>
 #include <ReconstructionDataFormats/PID.h>
 #include <ReconstructionDataFormats/Track.h>
 
@@ -34,6 +35,7 @@
 #include <KFParticleBase.h>
 #include <KFVertex.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
 #include <cstdint>
@@ -262,6 +264,9 @@ class strangenessBuilderHelper
     v0selections.v0radius = 0.0f;
     v0selections.maxDaughterEta = 2.0;
 
+    prefilterselections.enabled = false;
+    prefilterselections.dcaMargin = 0.1f;
+
     // LUT has to be loaded later
     lut = nullptr;
     fitter.setMatCorrType(o2::base::Propagator::MatCorrType::USEMatCorrLUT);
@@ -316,6 +321,12 @@ class strangenessBuilderHelper
         v0 = {};
         return false;
       }
+
+      // analytic prefilter: DCA between daughters from the circles of the tracks, before any propagation
+      if (prefilterselections.enabled && !useCollinearFit && getMinimalDCAEstimate(positiveTrackParam, negativeTrackParam) > v0selections.dcav0dau + prefilterselections.dcaMargin) {
+        v0 = {};
+        return false;
+      }
     }
 
     if constexpr (calculateProngDCAtoPV) {
@@ -669,6 +680,12 @@ class strangenessBuilderHelper
                              bool useCascadeMomentumAtPV = false,
                              bool processCovariances = false)
   {
+    // track selections of the cascade, checked before the V0 fit
+    if (!isSelectedCascadeTracks(positiveTrack, negativeTrack, bachelorTrack)) {
+      cascade = {};
+      return false;
+    }
+
     // no special treatment of positive and negative tracks when building V0s for cascades
     auto posTrackPar = getTrackParCov(positiveTrack);
     auto negTrackPar = getTrackParCov(negativeTrack);
@@ -702,30 +719,8 @@ class strangenessBuilderHelper
   {
     cascade = {}; // initialize / empty (extra safety)
 
-    // verify track quality
-    if (positiveTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows) {
-      cascade = {};
-      return false;
-    }
-    if (negativeTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows) {
-      cascade = {};
-      return false;
-    }
-    if (bachelorTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows) {
-      cascade = {};
-      return false;
-    }
-
-    // verify eta
-    if (std::fabs(positiveTrack.eta()) > cascadeselections.maxDaughterEta) {
-      cascade = {};
-      return false;
-    }
-    if (std::fabs(negativeTrack.eta()) > cascadeselections.maxDaughterEta) {
-      cascade = {};
-      return false;
-    }
-    if (std::fabs(bachelorTrack.eta()) > cascadeselections.maxDaughterEta) {
+    // verify track quality and eta
+    if (!isSelectedCascadeTracks(positiveTrack, negativeTrack, bachelorTrack)) {
       cascade = {};
       return false;
     }
@@ -750,6 +745,13 @@ class strangenessBuilderHelper
       }
     }
 
+    // analytic prefilter: DCA between the V0 (straight line) and the bachelor circle, before any propagation
+    auto bachTrackPar = getTrackPar(bachelorTrack);
+    if (prefilterselections.enabled && getMinimalDCAEstimate(v0input, bachTrackPar) > cascadeselections.dcacascdau + prefilterselections.dcaMargin) {
+      cascade = {};
+      return false;
+    }
+
     // Overall cascade charge
     cascade.charge = bachelorTrack.signed1Pt() > 0 ? +1 : -1;
 
@@ -758,7 +760,6 @@ class strangenessBuilderHelper
     std::array<float, 2> dcaInfo;
     dcaInfo[0] = dcaInfo[1] = 999.0f; // by default, take large value to make sure candidate accepted
 
-    auto bachTrackPar = getTrackPar(bachelorTrack);
     o2::base::Propagator::Instance()->propagateToDCABxByBz({pvX, pvY, pvZ}, bachTrackPar, 2.f, fitter.getMatCorrType(), &dcaInfo);
     cascade.bachelorDCAxy = dcaInfo[0];
 
@@ -1278,7 +1279,74 @@ class strangenessBuilderHelper
     float maxDaughterEta;
   } cascadeselections;
 
+  // analytic prefilter before the DCA fits (DCA fitter path only)
+  // the distance of the circles of the tracks in the transverse plane is a lower bound of the distance of closest
+  // approach of the helices; the candidate is rejected if half of it exceeds the maximum DCA between daughters plus
+  // a margin, which is conservative for the absolute (unweighted) DCA minimised by the fitter by default
+  struct {
+    bool enabled;    // apply the prefilter
+    float dcaMargin; // margin on the maximum DCA between daughters (cm), covers the energy loss in the material
+  } prefilterselections;
+
  private:
+  template <typename TTrack>
+  bool isSelectedCascadeTracks(TTrack const& positiveTrack, TTrack const& negativeTrack, TTrack const& bachelorTrack)
+  {
+    // verify track quality
+    if (positiveTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows ||
+        negativeTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows ||
+        bachelorTrack.tpcNClsCrossedRows() < cascadeselections.minCrossedRows) {
+      return false;
+    }
+    // verify eta
+    if (std::fabs(positiveTrack.eta()) > cascadeselections.maxDaughterEta ||
+        std::fabs(negativeTrack.eta()) > cascadeselections.maxDaughterEta ||
+        std::fabs(bachelorTrack.eta()) > cascadeselections.maxDaughterEta) {
+      return false;
+    }
+    return true;
+  }
+
+  // lower bound of the DCA between daughters for two charged tracks, from their circles in the transverse plane
+  template <typename TTrackParametrization>
+  float getMinimalDCAEstimate(TTrackParametrization const& track0, TTrackParametrization const& track1)
+  {
+    if (std::fabs(fitter.getBz()) < MinBzForPrefilter) {
+      return 0.f; // straight tracks, no estimate
+    }
+    o2::math_utils::CircleXYf_t circle0, circle1;
+    float sna, csa;
+    track0.getCircleParams(fitter.getBz(), circle0, sna, csa);
+    track1.getCircleParams(fitter.getBz(), circle1, sna, csa);
+    const float distance = std::hypot(circle0.xC - circle1.xC, circle0.yC - circle1.yC);
+    float minDistance = 0.f;
+    if (distance > circle0.rC + circle1.rC) {
+      minDistance = distance - circle0.rC - circle1.rC; // separated circles
+    } else if (distance < std::fabs(circle0.rC - circle1.rC)) {
+      minDistance = std::fabs(circle0.rC - circle1.rC) - distance; // nested circles
+    }
+    return 0.5f * minDistance;
+  }
+
+  // lower bound of the DCA between a V0 (straight line) and a charged track, from the circle of the track in the transverse plane
+  template <typename TTrackParametrization>
+  float getMinimalDCAEstimate(v0candidate const& v0input, TTrackParametrization const& track)
+  {
+    const float px = v0input.positiveMomentum[0] + v0input.negativeMomentum[0];
+    const float py = v0input.positiveMomentum[1] + v0input.negativeMomentum[1];
+    const float pt = std::hypot(px, py);
+    if (std::fabs(fitter.getBz()) < MinBzForPrefilter || pt <= 0.f) {
+      return 0.f;
+    }
+    o2::math_utils::CircleXYf_t circle;
+    float sna, csa;
+    track.getCircleParams(fitter.getBz(), circle, sna, csa);
+    const float distance = std::fabs((circle.xC - v0input.position[0]) * py - (circle.yC - v0input.position[1]) * px) / pt; // center to line
+    return 0.5f * std::max(distance - circle.rC, 0.f);
+  }
+
+  static constexpr float MinBzForPrefilter = 0.1f; // minimum magnetic field (kG) for the circle estimates
+
   // internal helper to calculate DCA (3D) of a straight line to a given PV analytically
   float CalculateDCAStraightToPV(float X, float Y, float Z, float Px, float Py, float Pz, float pvX, float pvY, float pvZ)
   {
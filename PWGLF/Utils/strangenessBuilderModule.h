@@ -38,10 +38,15 @@
 #include <TPDGCode.h>
 #include <TString.h>
 
+#include <algorithm>
 #include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <functional>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -288,6 +293,13 @@ struct coreConfigurables : o2::framework::ConfigurableGroup {
 
   // test the possibility of refitting with material corrections (DCA Fitter option)
   o2::framework::Configurable<bool> refitWithMaterialCorrection{"refitWithMaterialCorrection", false, "do refit after material corrections were applied"};
+
+  // analytic prefilter of the V0s and cascades from the circles of the tracks, before the DCA fits
+  o2::framework::Configurable<bool> prefilterBeforeFit{"prefilterBeforeFit", false, "reject V0s and cascades whose daughters can not be close enough, from their circles in the transverse plane, before the DCA fits"};
+  o2::framework::Configurable<float> prefilterDCAMargin{"prefilterDCAMargin", 0.1f, "margin on the DCA between daughters for the prefilter (cm)"};
+
+  // V0s and cascades (DCA fitter path) fitted by a pool of threads before the tables are filled
+  o2::framework::Configurable<int> nThreads{"nThreads", 1, "number of threads fitting the V0s and cascades (1: fits done in the building loops)"};
 };
 
 // strangenessBuilder: V0 building options
@@ -515,6 +527,25 @@ class BuilderModule
   std::vector<int> ao2dV0toV0List;                     // index to relate v0s -> v0List
   std::vector<int> v0Map;                              // index to relate v0List -> v0sFromCascades
 
+  // for the findable modes, reused across the data frames
+  std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
+  std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
+
+  // for the multi-threaded fits: candidates of sorted_v0 / sorted_cascade fitted by the worker threads
+  struct v0FitInput {
+    std::size_t iv0;                    // index in sorted_v0
+    float pvX, pvY, pvZ;                // primary vertex of the V0
+    o2::track::TrackParCov posTrackPar; // positive track, moved if TPC-only
+    o2::track::TrackParCov negTrackPar; // negative track, moved if TPC-only
+  };
+  static constexpr std::size_t MinFitsPerThread = 16;                 // minimum number of fits per thread
+  std::vector<o2::pwglf::strangenessBuilderHelper> straHelperWorkers; // helpers of the worker threads, copies of straHelper
+  std::vector<v0FitInput> v0FitInputs;                                // inputs of the V0 fits
+  std::vector<o2::pwglf::v0candidate> v0Fits;                         // fitted V0s, by index in sorted_v0
+  std::vector<uint8_t> v0FitIsValid;                                  // V0 fitted successfully, by index in sorted_v0
+  std::vector<o2::pwglf::cascadeCandidate> cascadeFits;               // fitted cascades, by index in sorted_cascade
+  std::vector<uint8_t> cascadeFitIsValid;                             // cascade fitted successfully, by index in sorted_cascade
+
   // declaration of structs here
   // (N.B.: will be invisible to the outside, create your own copies)
   o2::pwglf::strangenessbuilder::coreConfigurables baseOpts;
@@ -712,6 +743,8 @@ class BuilderModule
 
     // Set option to refit with material corrections
     straHelper.fitter.setRefitWithMatCorr(baseOpts.refitWithMaterialCorrection.value);
+    straHelper.prefilterselections.enabled = baseOpts.prefilterBeforeFit.value;
+    straHelper.prefilterselections.dcaMargin = baseOpts.prefilterDCAMargin.value;
   }
 
   // for sorting
@@ -828,14 +861,13 @@ class BuilderModule
     sorted_v0.clear();
     sorted_cascade.clear();
     ao2dV0toV0List.clear();
+    bestCollisionArray.clear();
+    bestCollisionNContribsArray.clear();
 
     trackEntry currentTrackEntry;
     v0Entry currentV0Entry;
     cascadeEntry currentCascadeEntry;
 
-    std::vector<int> bestCollisionArray;          // stores McCollision -> Collision map
-    std::vector<int> bestCollisionNContribsArray; // stores Ncontribs for biggest coll assoc to mccoll
-
     int collisionLessV0s = 0;
     int collisionLessCascades = 0;
 
@@ -1338,6 +1370,157 @@ class BuilderModule
     LOGF(debug, "V0 total %i, Cascade total %i, Tracked cascade total %i, V0s flagged used in cascades: %i", v0s.size(), cascades.size(), trackedCascadeCount, v0sUsedInCascades);
   }
 
+  //__________________________________________________
+  // primary vertex of a V0, origin if not associated to a collision
+  template <typename TCollisions>
+  void getV0PrimaryVertex(v0Entry const& v0, TCollisions const& collisions, float& pvX, float& pvY, float& pvZ)
+  {
+    if (v0.collisionId >= 0) {
+      auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+      pvX = collision.posX();
+      pvY = collision.posY();
+      pvZ = collision.posZ();
+    }
+  }
+
+  //__________________________________________________
+  // track parametrizations of the V0 daughters, with the TPC-only tracks moved according to the TPC drift
+  // returns false if a TPC-only track cannot be moved
+  template <class TBCs, typename TCollisions, typename TTrack>
+  bool getV0TrackPars(v0Entry const& v0, TCollisions const& collisions, TTrack const& posTrack, TTrack const& negTrack, o2::track::TrackParCov& posTrackPar, o2::track::TrackParCov& negTrackPar)
+  {
+    if (v0.collisionId >= 0 && v0BuilderOpts.generatePhotonCandidates && v0BuilderOpts.moveTPCOnlyTracks) {
+      auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+      if (collision.has_bc()) {
+        mVDriftMgr.update(collision.template bc_as<aod::BCsWithTimestamps>().timestamp());
+      }
+    }
+
+    posTrackPar = getTrackParCov(posTrack);
+    negTrackPar = getTrackParCov(negTrack);
+
+    // handle TPC-only tracks properly (photon conversions)
+    if (v0BuilderOpts.moveTPCOnlyTracks) {
+      bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
+      if (isPosTPCOnly) {
+        // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
+        posTrackPar.setPID(o2::track::PID::Electron);
+        negTrackPar.setPID(o2::track::PID::Electron);
+
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        // if track cannot be uniquely identified with a collision or cannot be assigned to a collision at all (collisionId = -1), do not attempt to move the TPC track and move on
+        if (!posTrack.has_collision() || !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
+          return false;
+        }
+      }
+
+      bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
+      if (isNegTPCOnly) {
+        // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
+        posTrackPar.setPID(o2::track::PID::Electron);
+        negTrackPar.setPID(o2::track::PID::Electron);
+
+        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
+        // if track cannot be uniquely identified with a collision or cannot be assigned to a collision at all (collisionId = -1), do not attempt to move the TPC track and move on
+        if (!negTrack.has_collision() || !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  //__________________________________________________
+  // runs fit(helper, i) for i in [0, nFits) with the worker threads and the calling thread
+  // each thread uses its own copy of the helper (fitter and candidate storage)
+  template <typename TFit>
+  void runFitsInParallel(std::size_t nFits, TFit&& fit)
+  {
+    std::atomic<std::size_t> nextFit{0};
+    auto worker = [&](o2::pwglf::strangenessBuilderHelper& helper) {
+      for (std::size_t iFit = nextFit++; iFit < nFits; iFit = nextFit++) {
+        fit(helper, iFit);
+      }
+    };
+    straHelperWorkers.assign(std::min<std::size_t>(baseOpts.nThreads.value - 1, nFits / MinFitsPerThread), straHelper);
+    std::vector<std::future<void>> workers;
+    for (auto& helper : straHelperWorkers) {
+      workers.push_back(std::async(std::launch::async, worker, std::ref(helper)));
+    }
+    worker(straHelper);
+    for (auto& result : workers) {
+      result.get();
+    }
+  }
+
+  //__________________________________________________
+  // fits the V0s of sorted_v0 with several threads, in the same conditions as buildV0s
+  // the daughters are prepared here (TPC-only tracks moved), only the fits run in parallel
+  template <class TBCs, typename TCollisions, typename TTracks>
+  void fitV0sInParallel(TCollisions const& collisions, TTracks const& tracks)
+  {
+    v0FitInputs.clear();
+    v0Fits.assign(v0List.size(), {});
+    v0FitIsValid.assign(v0List.size(), 0);
+    for (size_t iv0 = 0; iv0 < v0List.size(); iv0++) {
+      const auto& v0 = v0List[sorted_v0[iv0]];
+      if (!v0BuilderOpts.generatePhotonCandidates.value && v0.v0Type > 1) {
+        continue;
+      }
+      if (!baseOpts.mEnabledTables[kV0CoresBase] && v0Map[iv0] == -2) {
+        continue;
+      }
+      v0FitInput input{iv0, 0.0f, 0.0f, 0.0f, {}, {}};
+      getV0PrimaryVertex(v0, collisions, input.pvX, input.pvY, input.pvZ);
+      if (!getV0TrackPars<TBCs>(v0, collisions, tracks.rawIteratorAt(v0.posTrackId), tracks.rawIteratorAt(v0.negTrackId), input.posTrackPar, input.negTrackPar)) {
+        continue;
+      }
+      v0FitInputs.push_back(input);
+    }
+
+    runFitsInParallel(v0FitInputs.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t iFit) {
+      auto& input = v0FitInputs[iFit];
+      const auto& v0 = v0List[sorted_v0[input.iv0]];
+      if (helper.buildV0Candidate(v0.collisionId, input.pvX, input.pvY, input.pvZ, tracks.rawIteratorAt(v0.posTrackId), tracks.rawIteratorAt(v0.negTrackId), input.posTrackPar, input.negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+        v0Fits[input.iv0] = helper.v0;
+        v0FitIsValid[input.iv0] = 1;
+      }
+    });
+  }
+
+  //__________________________________________________
+  // fits the cascades of sorted_cascade with several threads, in the same conditions as buildCascades
+  template <typename TCollisions, typename TCascades, typename TTracks>
+  void fitCascadesInParallel(TCollisions const& collisions, TCascades const& cascades, TTracks const& tracks)
+  {
+    cascadeFits.assign(cascades.size(), {});
+    cascadeFitIsValid.assign(cascades.size(), 0);
+    runFitsInParallel(cascades.size(), [&](o2::pwglf::strangenessBuilderHelper& helper, std::size_t icascade) {
+      auto const& cascade = cascades[sorted_cascade[icascade]];
+      float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
+      if (cascade.collisionId >= 0) {
+        auto const& collision = collisions.rawIteratorAt(cascade.collisionId);
+        pvX = collision.posX();
+        pvY = collision.posY();
+        pvZ = collision.posZ();
+      }
+      auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
+      auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
+      auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
+      bool isBuilt = false;
+      if (baseOpts.useV0BufferForCascades) {
+        isBuilt = cascade.v0Id >= 0 && v0Map[cascade.v0Id] >= 0 &&
+                  helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ, v0sFromCascades[v0Map[cascade.v0Id]], posTrack, negTrack, bachTrack, baseOpts.mEnabledTables[kCascBBs], cascadeBuilderOpts.useCascadeMomentumAtPrimVtx, baseOpts.mEnabledTables[kCascCovs]);
+      } else {
+        isBuilt = helper.buildCascadeCandidate(cascade.collisionId, pvX, pvY, pvZ, posTrack, negTrack, bachTrack, baseOpts.mEnabledTables[kCascBBs], cascadeBuilderOpts.useCascadeMomentumAtPrimVtx, baseOpts.mEnabledTables[kCascCovs]);
+      }
+      if (isBuilt) {
+        cascadeFits[icascade] = helper.cascade;
+        cascadeFitIsValid[icascade] = 1;
+      }
+    });
+  }
+
   //__________________________________________________
   template <class TBCs, typename THistoRegistry, typename TCollisions, typename TTracks, typename TV0s, typename TMCParticles, typename TProducts>
   void buildV0s(THistoRegistry& histos, TCollisions const& collisions, TV0s const& v0s, TTracks const& tracks, TMCParticles const& mcParticles, TProducts& products)
@@ -1351,6 +1534,11 @@ class BuilderModule
       mcParticleIsReco.resize(mcParticles.size(), false);
     }
 
+    const bool isMultiThreaded = baseOpts.nThreads.value > 1;
+    if (isMultiThreaded) {
+      fitV0sInParallel<TBCs>(collisions, tracks);
+    }
+
     int nV0s = 0;
     // Loops over all V0s in the time frame
     histos.fill(HIST("hInputStatistics"), kV0CoresBase, v0s.size());
@@ -1373,55 +1561,27 @@ class BuilderModule
       // if collisionId positive: get vertex, negative: origin
       // could be replaced by mean vertex (but without much benefit...)
       float pvX = 0.0f, pvY = 0.0f, pvZ = 0.0f;
-      if (v0.collisionId >= 0) {
-        auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-        pvX = collision.posX();
-        pvY = collision.posY();
-        pvZ = collision.posZ();
-        if (v0BuilderOpts.generatePhotonCandidates && v0BuilderOpts.moveTPCOnlyTracks && collision.has_bc()) {
-          mVDriftMgr.update(collision.template bc_as<aod::BCsWithTimestamps>().timestamp());
-        }
-      }
+      getV0PrimaryVertex(v0, collisions, pvX, pvY, pvZ);
       auto const& posTrack = tracks.rawIteratorAt(v0.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(v0.negTrackId);
 
-      auto posTrackPar = getTrackParCov(posTrack);
-      auto negTrackPar = getTrackParCov(negTrack);
-
-      // handle TPC-only tracks properly (photon conversions)
-      if (v0BuilderOpts.moveTPCOnlyTracks) {
-        bool isPosTPCOnly = (posTrack.hasTPC() && !posTrack.hasITS() && !posTrack.hasTRD() && !posTrack.hasTOF());
-        if (isPosTPCOnly) {
-          // Nota bene: positive is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
-
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          // if track cannot be uniquely identified with a collision or cannot be assigned to a collision at all (collisionId = -1), do not attempt to move the TPC track and move on
-          if (!posTrack.has_collision() || !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, posTrack, posTrackPar)) {
-            products.v0dataLink(-1, -1);
-            continue;
-          }
+      if (isMultiThreaded) {
+        // fitted beforehand
+        if (!v0FitIsValid[iv0]) {
+          products.v0dataLink(-1, -1);
+          continue;
         }
-
-        bool isNegTPCOnly = (negTrack.hasTPC() && !negTrack.hasITS() && !negTrack.hasTRD() && !negTrack.hasTOF());
-        if (isNegTPCOnly) {
-          // Nota bene: negative is TPC-only -> this entire V0 merits treatment as photon candidate
-          posTrackPar.setPID(o2::track::PID::Electron);
-          negTrackPar.setPID(o2::track::PID::Electron);
-
-          auto const& collision = collisions.rawIteratorAt(v0.collisionId);
-          // if track cannot be uniquely identified with a collision or cannot be assigned to a collision at all (collisionId = -1), do not attempt to move the TPC track and move on
-          if (!negTrack.has_collision() || !mVDriftMgr.moveTPCTrack<TBCs, TCollisions>(collision, negTrack, negTrackPar)) {
-            products.v0dataLink(-1, -1);
-            continue;
-          }
+        straHelper.v0 = v0Fits[iv0];
+      } else {
+        o2::track::TrackParCov posTrackPar, negTrackPar;
+        if (!getV0TrackPars<TBCs>(v0, collisions, posTrack, negTrack, posTrackPar, negTrackPar)) {
+          products.v0dataLink(-1, -1);
+          continue;
+        }
+        if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
+          products.v0dataLink(-1, -1);
+          continue;
         }
-      }
-
-      if (!straHelper.buildV0Candidate(v0.collisionId, pvX, pvY, pvZ, posTrack, negTrack, posTrackPar, negTrackPar, v0.isCollinearV0, baseOpts.mEnabledTables[kV0Covs], v0BuilderOpts.generatePhotonCandidates)) {
-        products.v0dataLink(-1, -1);
-        continue;
       }
       if constexpr (requires { posTrack.tpcNSigmaEl(); }) {
         if (preSelectOpts.preselectOnlyDesiredV0s) {
@@ -1901,6 +2061,11 @@ class BuilderModule
     if (!baseOpts.mEnabledTables[kStoredCascCores]) {
       return; // don't do if no request for cascades in place
     }
+    const bool isMultiThreaded = baseOpts.nThreads.value > 1;
+    if (isMultiThreaded) {
+      fitCascadesInParallel(collisions, cascades, tracks);
+    }
+
     int nCascades = 0;
     // Loops over all cascades in the time frame
     histos.fill(HIST("hInputStatistics"), kStoredCascCores, cascades.size());
@@ -1919,7 +2084,15 @@ class BuilderModule
       auto const& posTrack = tracks.rawIteratorAt(cascade.posTrackId);
       auto const& negTrack = tracks.rawIteratorAt(cascade.negTrackId);
       auto const& bachTrack = tracks.rawIteratorAt(cascade.bachTrackId);
-      if (baseOpts.useV0BufferForCascades) {
+      if (isMultiThreaded) {
+        // fitted beforehand
+        if (!cascadeFitIsValid[icascade]) {
+          products.cascdataLink(-1);
+          interlinks.cascadeToCascCores.push_back(-1);
+          continue; // didn't work out, skip
+        }
+        straHelper.cascade = cascadeFits[icascade];
+      } else if (baseOpts.useV0BufferForCascades) {
         // this processing path uses a buffer of V0s so that no
         // additional minimization step is redone. It consumes less
         // CPU at the cost of more memory. Since memory is a more
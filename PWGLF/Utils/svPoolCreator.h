@@ -21,10 +21,13 @@
 
 #include <Rtypes.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -73,7 +76,7 @@ class svPoolCreator
   void setFitter(const o2::vertexing::DCAFitterN<2>& fitter) { this->fitter = fitter; }
   void setSkipAmbiTracks() { skipAmbiTracks = true; }
   o2::vertexing::DCAFitterN<2>* getFitter() { return &fitter; }
-  std::array<std::vector<TrackCand>, 4> getTrackCandPool() { return trackCandPool; }
+  const std::array<std::vector<TrackCand>, 4>& getTrackCandPool() const { return trackCandPool; }
 
   template <typename C, typename BC>
   void fillBC2Coll(const C& collisions, BC const&)
@@ -197,60 +200,41 @@ class svPoolCreator
 
     // is Sorting Needed ? TBD
   }
+  // The pairs with overlapping collision brackets are found with a sweep over the brackets sorted by their start:
+  // when a bracket starts, the brackets of the other daughter already started and not yet ended are exactly those
+  // which overlap with it. The pools themselves are not reordered, since tmap points into them.
   template <typename C>
-  std::vector<SVCand>& getSVCandPool(const C& collisions, bool combineLikeSign = false)
+  std::vector<SVCand>& getSVCandPool(const C&, bool combineLikeSign = false)
   {
-    gsl::span<std::vector<TrackCand>> track0Pool{trackCandPool.data(), 2};
-    gsl::span<std::vector<TrackCand>> track1Pool{trackCandPool.data() + 2, 2};
-    std::array<std::vector<int>, 2> mVtxTrack0{}; // 1st pos. and neg. track of the kink pool for each vertex
-
-    for (int i = 0; i < 2; i++) {
-      mVtxTrack0[i].clear();
-      mVtxTrack0[i].resize(collisions.size(), -1);
-    }
-
     for (int pn = 0; pn < 2; pn++) {
-      auto& vtxFirstT = mVtxTrack0[pn];
-      const auto& signTrack0Pool = track0Pool[pn];
-      for (unsigned i = 0; i < signTrack0Pool.size(); i++) {
-        const auto& track0Seed = signTrack0Pool[i];
-        LOG(debug) << "Processsing track0 with index: " << track0Seed.Idxtr << " min bracket: " << track0Seed.collBracket.getMin() << " max bracket: " << track0Seed.collBracket.getMax();
-        for (int j{track0Seed.collBracket.getMin()}; j <= track0Seed.collBracket.getMax(); ++j) {
-          if (vtxFirstT[j] == -1) {
-            vtxFirstT[j] = i;
-          }
-        }
-      }
-      int track1sign = combineLikeSign ? pn : 1 - pn;
-      auto& signTrack1 = track1Pool[track1sign];
-      for (unsigned itp = 0; itp < signTrack1.size(); itp++) {
-        auto& track1Seed = signTrack1[itp];
-        LOG(debug) << "Processing track1 with index: " << track1Seed.Idxtr << " min bracket: " << track1Seed.collBracket.getMin() << " max bracket: " << track1Seed.collBracket.getMax();
-        int firsOverlapIdx = -1;
-        for (int j{track1Seed.collBracket.getMin()}; j <= track1Seed.collBracket.getMax(); ++j) {
-          LOG(debug) << "Checking vtxFirstT at position " << j << " with value " << vtxFirstT[j];
-          if (vtxFirstT[j] != -1) {
-            firsOverlapIdx = vtxFirstT[j];
-            break;
-          }
-        }
-        if (firsOverlapIdx < 0) {
-          continue;
-        }
-        for (unsigned itn = firsOverlapIdx; itn < signTrack0Pool.size(); itn++) {
-          auto& track0Seed = signTrack0Pool[itn];
-
-          if (track0Seed.collBracket.getMin() > track1Seed.collBracket.getMax()) {
-            break;
+      const auto& signTrack0Pool = trackCandPool[pn];
+      const auto& signTrack1Pool = trackCandPool[2 + (combineLikeSign ? pn : 1 - pn)];
+      sortByBracketStart(signTrack0Pool, sortedTrack0);
+      sortByBracketStart(signTrack1Pool, sortedTrack1);
+      activeTrack0.clear();
+      activeTrack1.clear();
+
+      std::size_t i0 = 0, i1 = 0;
+      while (i0 < sortedTrack0.size() || i1 < sortedTrack1.size()) {
+        bool isTrack0 = i1 == sortedTrack1.size() || (i0 < sortedTrack0.size() && signTrack0Pool[sortedTrack0[i0]].collBracket.getMin() <= signTrack1Pool[sortedTrack1[i1]].collBracket.getMin());
+        if (isTrack0) {
+          const auto& track0Seed = signTrack0Pool[sortedTrack0[i0++]];
+          LOG(debug) << "Processsing track0 with index: " << track0Seed.Idxtr << " min bracket: " << track0Seed.collBracket.getMin() << " max bracket: " << track0Seed.collBracket.getMax();
+          removeEnded(signTrack1Pool, activeTrack1, track0Seed.collBracket.getMin());
+          for (const auto& itp : activeTrack1) {
+            const auto& track1Seed = signTrack1Pool[itp];
+            svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, track0Seed.collBracket.getOverlap(track1Seed.collBracket)});
           }
-
-          if (track0Seed.collBracket.isOutside(track1Seed.collBracket)) {
-            LOG(debug) << "Brackets do not match";
-            continue;
+          activeTrack0.push_back(sortedTrack0[i0 - 1]);
+        } else {
+          const auto& track1Seed = signTrack1Pool[sortedTrack1[i1++]];
+          LOG(debug) << "Processing track1 with index: " << track1Seed.Idxtr << " min bracket: " << track1Seed.collBracket.getMin() << " max bracket: " << track1Seed.collBracket.getMax();
+          removeEnded(signTrack0Pool, activeTrack0, track1Seed.collBracket.getMin());
+          for (const auto& itn : activeTrack0) {
+            const auto& track0Seed = signTrack0Pool[itn];
+            svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, track0Seed.collBracket.getOverlap(track1Seed.collBracket)});
           }
-          auto overlapBracket = track0Seed.collBracket.getOverlap(track1Seed.collBracket);
-
-          svCandPool.emplace_back(SVCand{track0Seed.Idxtr, track1Seed.Idxtr, overlapBracket});
+          activeTrack1.push_back(sortedTrack1[i1 - 1]);
         }
       }
     }
@@ -272,6 +256,24 @@ class svPoolCreator
   std::array<std::vector<TrackCand>, 4> trackCandPool; // Sorting: dau0 pos, dau0 neg, dau1 pos, dau1 neg
   std::vector<SVCand> svCandPool;                      // index of the two tracks in the track table
   TrackCand trForpool;
+
+  std::vector<int> sortedTrack0; // pool indices of the track0 candidates, by bracket start
+  std::vector<int> sortedTrack1; // pool indices of the track1 candidates, by bracket start
+  std::vector<int> activeTrack0; // track0 candidates whose bracket is open in the sweep
+  std::vector<int> activeTrack1; // track1 candidates whose bracket is open in the sweep
+
+  static void sortByBracketStart(const std::vector<TrackCand>& pool, std::vector<int>& sorted)
+  {
+    sorted.resize(pool.size());
+    std::iota(sorted.begin(), sorted.end(), 0);
+    std::stable_sort(sorted.begin(), sorted.end(), [&pool](int a, int b) { return pool[a].collBracket.getMin() < pool[b].collBracket.getMin(); });
+  }
+
+  // drops the candidates whose bracket ended before the current position of the sweep, they can not overlap any more
+  static void removeEnded(const std::vector<TrackCand>& pool, std::vector<int>& active, int sweepPosition)
+  {
+    active.erase(std::remove_if(active.begin(), active.end(), [&](int i) { return pool[i].collBracket.getMax() < sweepPosition; }), active.end());
+  }
 };
 
 #endif // PWGLF_UTILS_SVPOOLCREATOR_H_
@@ -0,0 +1,97 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+#ifndef PWGMM_MULT_CORE_INCLUDE_EVENTETABUFFER_H_
+#define PWGMM_MULT_CORE_INCLUDE_EVENTETABUFFER_H_
+
+#include <Framework/Logger.h>
+
+#include <TAxis.h>
+#include <THnSparse.h>
+
+#include <RtypesCore.h>
+
+#include <vector>
+
+namespace pwgmm::mult
+{
+// Counts of the tracks of one event on the bins of the first axis (eta) of a THnSparse, whose other axes (e.g. z of
+// the vertex, centrality, occupancy) have the same value for all the tracks of the event. flush() adds the counts to
+// the histogram once per non-empty eta bin instead of once per track. The bin contents, the squared weights and the
+// number of entries are the same as if the tracks were filled one by one; the sums of the weights times the
+// coordinates kept by THnBase::Fill are not updated, as in THnBase::Add.
+class EventEtaBuffer
+{
+ public:
+  /// Binds the buffer to a histogram, the counts of the previous one must have been flushed
+  void bind(THnSparse* hist)
+  {
+    if (hist == mHist) {
+      return;
+    }
+    mHist = hist;
+    mAxis = hist->GetAxis(0);
+    mCounts.assign(mAxis->GetNbins() + 2, 0); // including under/overflow
+    mCoordinates.resize(hist->GetNdimensions());
+    mNentries = 0;
+  }
+
+  /// Counts a track
+  void fill(double eta)
+  {
+    mCounts[mAxis->FindBin(eta)]++;
+    mNentries++;
+  }
+
+  /// Adds the counts of the event to the histogram
+  /// \param values values of the other axes of the histogram, in their order
+  template <typename... Ts>
+  void flush(const Ts&... values)
+  {
+    if (!mNentries) {
+      return;
+    }
+    constexpr int NValues = sizeof...(Ts);
+    if (NValues + 1 != static_cast<int>(mCoordinates.size())) {
+      LOGF(fatal, "Number of values (%d) does not match the number of axes (%d) of %s", NValues + 1, mCoordinates.size(), mHist->GetName());
+    }
+    const double others[] = {static_cast<double>(values)...};
+    for (int i = 0; i < NValues; i++) {
+      mCoordinates[i + 1] = mHist->GetAxis(i + 1)->FindBin(others[i]);
+    }
+    const bool hasErrors = mHist->GetCalculateErrors();
+    for (int bin = 0; bin < static_cast<int>(mCounts.size()); bin++) {
+      if (!mCounts[bin]) {
+        continue;
+      }
+      mCoordinates[0] = bin;
+      const Long64_t globalBin = mHist->GetBin(mCoordinates.data(), kTRUE);
+      if (hasErrors) {
+        mHist->AddBinError2(globalBin, mCounts[bin]);
+      }
+      // only after the errors, as in THnBase::Add
+      mHist->AddBinContent(globalBin, mCounts[bin]);
+      mCounts[bin] = 0;
+    }
+    mHist->SetEntries(mHist->GetEntries() + mNentries);
+    mNentries = 0;
+  }
+
+ private:
+  THnSparse* mHist = nullptr;      // histogram the buffer is bound to
+  TAxis* mAxis = nullptr;          // eta axis of the histogram
+  std::vector<Int_t> mCounts;      // counts of the event per eta bin
+  std::vector<Int_t> mCoordinates; // bin of each axis, for the flush
+  Long64_t mNentries = 0;          // number of pending tracks
+};
+} // namespace pwgmm::mult
+
+#endif // PWGMM_MULT_CORE_INCLUDE_EVENTETABUFFER_H_
@@ -15,6 +15,7 @@
 /// \author Gyula Bencedi, gyula.bencedi@cern.ch
 /// \since  Nov 2024
 
+#include "PWGMM/Mult/Core/include/EventEtaBuffer.h"
 #include "PWGMM/Mult/Core/include/Functions.h"
 #include "PWGMM/Mult/DataModel/Index.h"
 #include "PWGMM/Mult/DataModel/bestCollisionTable.h"
@@ -465,6 +466,10 @@ struct DndetaMFTPbPb {
   std::vector<int> ambiguousTrkIdsMC;
   std::vector<int> reassignedTrkIdsMC;
 
+  // tracks of an event in eta, added to the EtaZvtx histograms once per event
+  pwgmm::mult::EventEtaBuffer etaZvtxBuffer;
+  pwgmm::mult::EventEtaBuffer etaZvtxBestBuffer;
+
   /// @brief init function, definition of histograms
   void init(InitContext&)
   {
@@ -1864,6 +1869,7 @@ struct DndetaMFTPbPb {
   int countTracks(T const& tracks, float z, float c, float occ)
   {
     auto nTrk = 0;
+    bool isBound = false;
     for (auto const& track : tracks) {
       if (fillHis) {
         if constexpr (has_reco_cent<C>) {
@@ -1885,15 +1891,22 @@ struct DndetaMFTPbPb {
         if (phi < Czero || TwoPI < phi) {
           continue;
         }
+        if (!isBound) {
+          if constexpr (has_reco_cent<C>) {
+            etaZvtxBuffer.bind(registry.get<THnSparse>(HIST("Tracks/Centrality/EtaZvtx")).get());
+          } else {
+            etaZvtxBuffer.bind(registry.get<THnSparse>(HIST("Tracks/EtaZvtx")).get());
+          }
+          isBound = true;
+        }
+        etaZvtxBuffer.fill(track.eta());
         if constexpr (has_reco_cent<C>) {
-          registry.fill(HIST("Tracks/Centrality/EtaZvtx"), track.eta(), z, c, occ);
           registry.fill(HIST("Tracks/Centrality/PhiEta"), phi, track.eta(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/TanLambda"), track.tgl(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/InvQPt"), track.signed1Pt(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/Eta"), track.eta(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/Phi"), phi, c, occ);
         } else {
-          registry.fill(HIST("Tracks/EtaZvtx"), track.eta(), z, occ);
           registry.fill(HIST("Tracks/PhiEta"), phi, track.eta(), occ);
           qaregistry.fill(HIST("Tracks/TanLambda"), track.tgl(), c, occ);
           qaregistry.fill(HIST("Tracks/InvQPt"), track.signed1Pt(), c, occ);
@@ -1905,8 +1918,10 @@ struct DndetaMFTPbPb {
     }
     if (fillHis) {
       if constexpr (has_reco_cent<C>) {
+        etaZvtxBuffer.flush(z, c, occ);
         qaregistry.fill(HIST("Tracks/Centrality/NchSel"), nTrk, c, occ);
       } else {
+        etaZvtxBuffer.flush(z, occ);
         qaregistry.fill(HIST("Tracks/NchSel"), nTrk, occ);
       }
     }
@@ -1947,6 +1962,7 @@ struct DndetaMFTPbPb {
                       float c, float occ)
   {
     auto nATrk = 0;
+    bool isBound = false;
     ambiguousTrkIds.reserve(besttracks.size());
     reassignedTrkIds.reserve(besttracks.size());
     for (auto const& atrack : besttracks) {
@@ -1966,14 +1982,21 @@ struct DndetaMFTPbPb {
         if (phi < Czero || TwoPI < phi) {
           continue;
         }
+        if (!isBound) {
+          if constexpr (has_reco_cent<C>) {
+            etaZvtxBestBuffer.bind(registry.get<THnSparse>(HIST("Tracks/Centrality/EtaZvtxBest")).get());
+          } else {
+            etaZvtxBestBuffer.bind(registry.get<THnSparse>(HIST("Tracks/EtaZvtxBest")).get());
+          }
+          isBound = true;
+        }
+        etaZvtxBestBuffer.fill(itrack.eta());
         if constexpr (has_reco_cent<C>) {
-          registry.fill(HIST("Tracks/Centrality/EtaZvtxBest"), itrack.eta(), z, c, occ);
           registry.fill(HIST("Tracks/Centrality/PhiEtaBest"), phi, itrack.eta(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/DCA3d"), itrack.pt(), itrack.eta(), atrack.bestDCAXY(), bestDcaZ, c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/NclustersEtaBest"), itrack.nClusters(), itrack.eta(), c, occ);
           qaregistry.fill(HIST("Tracks/Centrality/TrackAmbDegree"), atrack.ambDegree(), c, occ);
         } else {
-          registry.fill(HIST("Tracks/EtaZvtxBest"), itrack.eta(), z, occ);
           registry.fill(HIST("Tracks/PhiEtaBest"), phi, itrack.eta(), occ);
           qaregistry.fill(HIST("Tracks/DCA3d"), itrack.pt(), itrack.eta(), atrack.bestDCAXY(), bestDcaZ, occ);
           qaregistry.fill(HIST("Tracks/NclustersEtaBest"), itrack.nClusters(), itrack.eta(), occ);
@@ -2001,6 +2024,9 @@ struct DndetaMFTPbPb {
       }
     }
 
+    // sorted, so that each track is looked up with a binary search
+    std::sort(ambiguousTrkIds.begin(), ambiguousTrkIds.end());
+    std::sort(reassignedTrkIds.begin(), reassignedTrkIds.end());
     for (auto const& track : tracks) {
       if (!isTrackSelected(track)) {
         continue;
@@ -2019,10 +2045,10 @@ struct DndetaMFTPbPb {
           qaregistry.fill(HIST("Tracks/OrigTracksPhiEta"), phi, track.eta(), occ);
         }
       }
-      if (std::find(ambiguousTrkIds.begin(), ambiguousTrkIds.end(), track.globalIndex()) != ambiguousTrkIds.end()) {
+      if (std::binary_search(ambiguousTrkIds.begin(), ambiguousTrkIds.end(), track.globalIndex())) {
         continue;
       }
-      if (std::find(reassignedTrkIds.begin(), reassignedTrkIds.end(), track.globalIndex()) != reassignedTrkIds.end()) {
+      if (std::binary_search(reassignedTrkIds.begin(), reassignedTrkIds.end(), track.globalIndex())) {
         continue;
       }
       // ++nATrk; // use for testing purposes only!
@@ -2044,15 +2070,15 @@ struct DndetaMFTPbPb {
     }
     if (fillHis) {
       if constexpr (has_reco_cent<C>) {
+        etaZvtxBestBuffer.flush(z, c, occ);
         qaregistry.fill(HIST("Tracks/Centrality/NchBestSel"), nATrk, c, occ);
       } else {
+        etaZvtxBestBuffer.flush(z, occ);
         qaregistry.fill(HIST("Tracks/NchBestSel"), nATrk, occ);
       }
     }
     ambiguousTrkIds.clear();
-    ambiguousTrkIds.shrink_to_fit();
     reassignedTrkIds.clear();
-    reassignedTrkIds.shrink_to_fit();
     return nATrk;
   }
 
@@ -3351,11 +3377,14 @@ struct DndetaMFTPbPb {
       }
     }
 
+    // sorted, so that each track is looked up with a binary search
+    std::sort(ambiguousTrkIdsMC.begin(), ambiguousTrkIdsMC.end());
+    std::sort(reassignedTrkIdsMC.begin(), reassignedTrkIdsMC.end());
     for (auto const& track : tracks) {
-      if (std::find(ambiguousTrkIdsMC.begin(), ambiguousTrkIdsMC.end(), track.globalIndex()) != ambiguousTrkIdsMC.end()) {
+      if (std::binary_search(ambiguousTrkIdsMC.begin(), ambiguousTrkIdsMC.end(), track.globalIndex())) {
         continue;
       }
-      if (std::find(reassignedTrkIdsMC.begin(), reassignedTrkIdsMC.end(), track.globalIndex()) != reassignedTrkIdsMC.end()) {
+      if (std::binary_search(reassignedTrkIdsMC.begin(), reassignedTrkIdsMC.end(), track.globalIndex())) {
         continue;
       }
       if (!isTrackSelected<false>(track)) {
@@ -3383,9 +3412,7 @@ struct DndetaMFTPbPb {
       }
     }
     ambiguousTrkIdsMC.clear();
-    ambiguousTrkIdsMC.shrink_to_fit();
     reassignedTrkIdsMC.clear();
-    reassignedTrkIdsMC.shrink_to_fit();
   }
 
   void processTrkEffBestInclusive(
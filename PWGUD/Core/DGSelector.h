@@ -44,8 +44,9 @@ class DGSelector
   }
 
   // Function to check if collision passes DG filter
+  // The FIT veto of the BCs can be taken from a FITVetoIndex of the BCs table instead of looping over bcRange
   template <typename CC, typename BCs, typename TCs, typename FWs>
-  int IsSelected(DGCutparHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
+  int IsSelected(DGCutparHolder diffCuts, CC& collision, BCs& bcRange, TCs& tracks, FWs& fwdtracks, udhelpers::FITVetoIndex const* fitVetoIndex = nullptr)
   {
     LOGF(debug, "Collision %f", collision.collisionTime());
     LOGF(debug, "Number of close BCs: %i", bcRange.size());
@@ -57,18 +58,24 @@ class DGSelector
     //  1 TSC
     //  2 TCE
     //  3 TOR
-    for (auto const& bc : bcRange) {
-      /* for debuging
-      auto isVetoed = udhelpers::FITveto(bc, diffCuts);
-      auto isClean = udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
-      LOGF(info, "<IsSelected> isVetoed: %d isClean: %d", isVetoed, isClean);
-      if (isVetoed) {
+    if (fitVetoIndex) {
+      if (fitVetoIndex->isVetoed(bcRange)) {
         return 1;
       }
-      */
+    } else {
+      for (auto const& bc : bcRange) {
+        /* for debuging
+        auto isVetoed = udhelpers::FITveto(bc, diffCuts);
+        auto isClean = udhelpers::cleanFIT(bc, diffCuts.maxFITtime(), diffCuts.FITAmpLimits());
+        LOGF(info, "<IsSelected> isVetoed: %d isClean: %d", isVetoed, isClean);
+        if (isVetoed) {
+          return 1;
+        }
+        */
 
-      if (udhelpers::FITveto(bc, diffCuts)) {
-        return 1;
+        if (udhelpers::FITveto(bc, diffCuts)) {
+          return 1;
+        }
       }
     }
 
@@ -203,7 +210,7 @@ class DGSelector
 
   // Function to check if BC passes DG filter (without associated collision)
   template <typename BCs, typename TCs, typename FWs>
-  int IsSelected(DGCutparHolder diffCuts, BCs& bcRange, TCs& tracks, FWs& fwdtracks)
+  int IsSelected(DGCutparHolder diffCuts, BCs& bcRange, TCs& tracks, FWs& fwdtracks, udhelpers::FITVetoIndex const* fitVetoIndex = nullptr)
   {
     // return if FIT veto is found in any of the compatible BCs
     // Double Gap (DG) condition
@@ -212,10 +219,16 @@ class DGSelector
     //  1 TSC
     //  2 TCE
     //  3 TOR
-    for (auto const& bc : bcRange) {
-      if (udhelpers::FITveto(bc, diffCuts)) {
+    if (fitVetoIndex) {
+      if (fitVetoIndex->isVetoed(bcRange)) {
         return 1;
       }
+    } else {
+      for (auto const& bc : bcRange) {
+        if (udhelpers::FITveto(bc, diffCuts)) {
+          return 1;
+        }
+      }
     }
 
     // no activity in muon arm
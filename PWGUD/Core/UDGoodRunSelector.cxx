@@ -17,8 +17,11 @@
 #include <rapidjson/filereadstream.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <cstdio>
+#include <iterator>
 #include <string>
+#include <utility>
 #include <vector>
 
 class TFile;
@@ -39,9 +42,12 @@ void UDGoodRunSelector::clear()
 {
   mgoodRuns.clear();
   mrunMap.clear();
+  mgoodBCRanges.clear();
   mrnMin = -1;
   mrnMax = -1;
   misActive = false;
+  mlastRun = -1;
+  mlastBCRanges = nullptr;
 }
 
 void UDGoodRunSelector::Print()
@@ -57,16 +63,47 @@ void UDGoodRunSelector::Print()
   for (const auto& runNumber : mgoodRuns) {
     LOGF(info, "    %i", runNumber);
   }
+  for (const auto& [runNumber, bcRanges] : mgoodBCRanges) {
+    LOGF(info, "  good BC ranges of run %i", runNumber);
+    for (const auto& [bcMin, bcMax] : bcRanges) {
+      LOGF(info, "    %llu - %llu", bcMin, bcMax);
+    }
+  }
+}
+
+void UDGoodRunSelector::updateRun(int runNumber)
+{
+  if (runNumber == mlastRun) {
+    return;
+  }
+  mlastRun = runNumber;
+
+  // search for runNumber in mgoodRuns, which is sorted
+  mlastIsGood = !misActive || std::binary_search(mgoodRuns.begin(), mgoodRuns.end(), runNumber);
+  auto it = mgoodBCRanges.find(runNumber);
+  mlastBCRanges = it != mgoodBCRanges.end() ? &it->second : nullptr;
 }
 
 bool UDGoodRunSelector::isGoodRun(int runNumber)
 {
-  // search for runNumber in mgoodRuns
-  if (!misActive) {
+  updateRun(runNumber);
+  return mlastIsGood;
+}
+
+bool UDGoodRunSelector::isGoodBC(int runNumber, uint64_t globalBC)
+{
+  updateRun(runNumber);
+  if (!mlastIsGood) {
+    return false;
+  }
+  if (!mlastBCRanges) {
     return true;
-  } else {
-    return std::find(mgoodRuns.begin(), mgoodRuns.end(), runNumber) != mgoodRuns.end();
   }
+
+  // last range starting at or before globalBC
+  auto it = std::upper_bound(mlastBCRanges->begin(), mlastBCRanges->end(), globalBC,
+                             [](uint64_t bc, const std::pair<uint64_t, uint64_t>& range) { return bc < range.first; });
+  return it != mlastBCRanges->begin() && globalBC <= std::prev(it)->second;
 }
 
 std::vector<int> UDGoodRunSelector::goodRuns(std::string runPeriod)
@@ -91,11 +128,20 @@ bool UDGoodRunSelector::init(std::string const& goodRunsFile)
   //      },
   //      {
   //        "period": "LHC22f",
-  //        "runlist":  [ 520143 ]
+  //        "runlist":  [ 520143 ],
+  //        "bcranges": [
+  //          {
+  //            "run": 520143,
+  //            "ranges": [ [ 1000000, 2000000 ], [ 3000000, 4000000 ] ]
+  //          }
+  //        ]
   //      }
   //    ]
   //  }
+  // the optional bcranges give the good ranges of global BCs of a run, the limits are included
   misActive = false;
+  mlastRun = -1;
+  mlastBCRanges = nullptr;
   if (goodRunsFile.empty()) {
     LOGF(info, "goodRuns was not specified!");
     return true;
@@ -174,6 +220,42 @@ bool UDGoodRunSelector::init(std::string const& goodRunsFile)
         misActive = true;
       }
     }
+    // good BC ranges
+    itemName = "bcranges";
+    if (item1.HasMember(itemName)) {
+      if (!item1[itemName].IsArray()) {
+        LOGF(error, "Check the goodRuns file! Item %s must be an array!", itemName);
+        return false;
+      }
+      for (auto& item2 : item1[itemName].GetArray()) {
+        if (!item2.IsObject() || !item2.HasMember("run") || !item2.HasMember("ranges") || !item2["ranges"].IsArray()) {
+          LOGF(error, "Check the goodRuns file! Elements of %s must be objects with a run and an array of ranges!", itemName);
+          return false;
+        }
+        auto& bcRanges = mgoodBCRanges[item2["run"].GetInt()];
+        for (auto& item3 : item2["ranges"].GetArray()) {
+          if (!item3.IsArray() || item3.Size() != 2) {
+            LOGF(error, "Check the goodRuns file! The ranges of %s must be arrays of two BCs!", itemName);
+            return false;
+          }
+          bcRanges.emplace_back(item3[0].GetUint64(), item3[1].GetUint64());
+        }
+      }
+    }
+  }
+
+  // sort and merge the BC ranges
+  for (auto& [run, bcRanges] : mgoodBCRanges) {
+    std::sort(bcRanges.begin(), bcRanges.end());
+    std::vector<std::pair<uint64_t, uint64_t>> merged;
+    for (const auto& range : bcRanges) {
+      if (!merged.empty() && range.first <= merged.back().second + 1) {
+        merged.back().second = std::max(merged.back().second, range.second);
+      } else {
+        merged.push_back(range);
+      }
+    }
+    bcRanges = merged;
   }
   // make mgoodRuns unique
   std::sort(mgoodRuns.begin(), mgoodRuns.end());
@@ -12,11 +12,14 @@
 #ifndef PWGUD_CORE_UDGOODRUNSELECTOR_H_
 #define PWGUD_CORE_UDGOODRUNSELECTOR_H_
 
+#include <cstdint>
 #include <map>
 #include <string>
+#include <utility>
 #include <vector>
 
-// A class to select good runs
+// A class to select good runs and good BC ranges of runs
+// The result of the last run is kept, so that the queries of the collisions of a run are O(1)
 struct UDGoodRunSelector {
 
  public:
@@ -32,17 +35,26 @@ struct UDGoodRunSelector {
   // getters
   void Print();
   bool isGoodRun(int runNumber);
+  // good run and BC within one of the good BC ranges of the run, all BCs of a run without BC ranges are good
+  bool isGoodBC(int runNumber, uint64_t globalBC);
   std::vector<int> goodRuns() { return mgoodRuns; }
   std::vector<int> goodRuns(std::string runPeriod);
   int rnumMin() { return mrnMin; }
   int rnumMax() { return mrnMax; }
 
  private:
-  bool misActive;
+  bool misActive = false;
   std::string mgoodRunsFile;
   int mrnMin = -1, mrnMax = -1;
   std::vector<int> mgoodRuns;
   std::map<std::string, std::vector<int>> mrunMap;
+  std::map<int, std::vector<std::pair<uint64_t, uint64_t>>> mgoodBCRanges; // sorted and merged good BC ranges of runs
+
+  // result of the last run
+  void updateRun(int runNumber);
+  int mlastRun = -1;
+  bool mlastIsGood = true;
+  const std::vector<std::pair<uint64_t, uint64_t>>* mlastBCRanges = nullptr; //! good BC ranges of the last run
 };
 
 #endif // PWGUD_CORE_UDGOODRUNSELECTOR_H_
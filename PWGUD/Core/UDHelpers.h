@@ -541,6 +541,38 @@ bool FITveto(T const& bc, DGCutparHolder const& diffCuts)
   return false;
 }
 
+// -----------------------------------------------------------------------------
+// FIT veto of all the BCs of a data frame, evaluated once per BC and accumulated in
+// prefix sums, so that the presence of a veto in a slice of the BCs table (e.g. the
+// compatible BCs of a collision or of a BC) is known without looping over the slice
+class FITVetoIndex
+{
+ public:
+  // bcs: full BCs table of the data frame
+  template <typename T>
+  void build(T const& bcs, DGCutparHolder const& diffCuts)
+  {
+    mNVetoed.assign(bcs.size() + 1, 0);
+    for (auto const& bc : bcs) {
+      mNVetoed[bc.globalIndex() + 1] = mNVetoed[bc.globalIndex()] + (FITveto(bc, diffCuts) ? 1 : 0);
+    }
+  }
+
+  // returns true if the veto is active in any BC of bcRange, a slice of the BCs table used in build
+  template <typename T>
+  bool isVetoed(T const& bcRange) const
+  {
+    if (bcRange.size() == 0) {
+      return false;
+    }
+    int64_t first = bcRange.begin().globalIndex();
+    return mNVetoed[first + bcRange.size()] > mNVetoed[first];
+  }
+
+ private:
+  std::vector<int32_t> mNVetoed; // number of vetoed BCs before each BC
+};
+
 inline void setBit(uint64_t w[4], int bit, bool val)
 {
   if (!val) {
@@ -896,6 +896,9 @@ bool decayTree::init(std::string const& parFile, o2::framework::HistogramRegistr
   // clean up
   fclose(fjson);
 
+  // compile the decay tree
+  compile();
+
   // create the histograms
   createHistograms(registry);
 
@@ -940,8 +943,10 @@ void decayTree::updateStatus()
     if (res->status() < 3) {
       return;
     }
+  }
 
-    // check the charge state
+  // check the charge state
+  if (!fResonances.empty()) {
     updateChargeState();
     if (std::find(fULSstates.begin(), fULSstates.end(), fChargeState) == fULSstates.end()) {
       isULS = false;
@@ -1027,21 +1032,15 @@ std::vector<resonance*> decayTree::getFinals(resonance* res)
 void decayTree::checkAngles()
 {
   // loop over resonances
-  for (const auto& res : fResonances) {
-    auto anglecuts = res->getAngleCuts();
+  for (std::size_t ind = 0; ind < fResonances.size(); ind++) {
     // loop over angle cuts
-    for (const auto& anglecut : anglecuts) {
-      auto rnames = anglecut->rNames();
-      auto anglerange = anglecut->angleRange();
-
+    for (const auto& anglecut : fAngleCuts[ind]) {
       // compute angle between two resonances
-      auto lv1 = getResonance(rnames.first)->IVM();
-      auto lv2 = getResonance(rnames.second)->IVM();
-      auto ang = lv1.Angle(lv2.Vect());
+      auto ang = anglecut.res1->IVM().Angle(anglecut.res2->IVM().Vect());
 
       // apply cut
-      if (ang < anglerange.first || ang > anglerange.second) {
-        res->setStatus(2);
+      if (ang < anglecut.angleMin || ang > anglecut.angleMax) {
+        fResonances[ind]->setStatus(2);
         break;
       }
     }
@@ -1067,33 +1066,10 @@ void decayTree::updateChargeState()
 
   // loop over all finals
   for (auto ind = 0; ind < fnFinals; ind++) {
-    fChargeState += (getFinal(ind)->charge() > 0) * std::pow(2, ind);
+    fChargeState += (fFinals[ind]->charge() > 0) * std::pow(2, ind);
   }
 }
 
-std::size_t decayTree::combHash(std::vector<int>& comb)
-{
-  // comb contains indices to tracks
-  // the combination hash is created from a string which is comprised of a sorted list of track indices
-
-  // sort comb
-  std::map<int, int> m_unsorted;
-  for (size_t cnt = 0; cnt < comb.size(); cnt++) {
-    m_unsorted.insert(std::pair<int, int>(comb[cnt], cnt));
-  }
-  std::vector<int> v_sorted(comb.size());
-  partial_sort_copy(begin(comb), end(comb), begin(v_sorted), end(v_sorted));
-
-  // create the hash
-  std::hash<std::string> hasher;
-  std::string hashstr{""};
-  for (size_t cnt = 0; cnt < comb.size(); cnt++) {
-    hashstr += std::to_string(v_sorted[cnt]);
-  }
-
-  return hasher(hashstr);
-}
-
 // find all permutations of n0 elements
 void decayTree::permutations(std::vector<int>& ref, int n0, int np, std::vector<std::vector<int>>& perms)
 {
@@ -1153,79 +1129,93 @@ int decayTree::permutations(int n0, std::vector<std::vector<int>>& perms)
   return perms.size();
 }
 
-void decayTree::combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                             std::vector<std::vector<int>>& combs)
+// compile the decay tree into a flat evaluation plan
+void decayTree::compile()
 {
-  // loop over pool
-  for (auto ii = 0; ii < n0 - n; ii++) {
-
-    inds[n] = pool[ii];
-
-    // if all inds are defined then print them out
-    // else get next inds
-    if (np == 1) {
-
-      std::vector<int> comb(n + 1, 0);
-      for (uint ii = 0; ii < inds.size(); ii++) {
-        comb[ii] = inds[ii];
+  // finals, their nominal masses and the charges they can have in the ULS and LS states
+  fFinals.clear();
+  fFinalMasses.clear();
+  fFinalChargeMasks.clear();
+  for (auto ind = 0; ind < fnFinals; ind++) {
+    auto res = getFinal(ind);
+    fFinals.push_back(res);
+    fFinalMasses.push_back(fPDG->GetParticle(res->pid())->Mass());
+    int mask = 0;
+    for (const auto& states : {fULSstates, fLSstates}) {
+      for (const auto& state : states) {
+        mask |= 1 << ((state >> ind) & 1);
       }
-      combs.push_back(comb);
-
-    } else {
+    }
+    fFinalChargeMasks.push_back(mask);
+  }
 
-      auto n0new = n0 - ii;
-      std::vector<int> newpool(n0new, 0);
-      for (auto kk = 0; kk < n0new; kk++) {
-        newpool[kk] = pool[kk + ii + 1];
-      }
+  // resonances, daughters before their parents
+  fEvalOrder.clear();
+  fEvalDaughters.clear();
+  for (const auto& res : fResonances) {
+    addToEvalOrder(res);
+  }
 
-      auto npnew = np - 1;
-      auto nnew = n + 1;
-      combinations(n0new, newpool, npnew, inds, nnew, combs);
+  // angle cuts
+  fAngleCuts.clear();
+  for (const auto& res : fResonances) {
+    std::vector<compiledAngleCut> anglecuts;
+    for (const auto& anglecut : res->getAngleCuts()) {
+      auto rnames = anglecut->rNames();
+      auto anglerange = anglecut->angleRange();
+      anglecuts.push_back({getResonance(rnames.first), getResonance(rnames.second), anglerange.first, anglerange.second});
     }
+    fAngleCuts.push_back(anglecuts);
   }
 }
 
-// find all possible selections of np out of n0
-int decayTree::combinations(int n0, int np, std::vector<std::vector<int>>& combs)
+void decayTree::addToEvalOrder(resonance* res)
 {
-  // initialisations
-  combs.clear();
-  if (n0 < np) {
-    return 0;
+  if (res->isFinal() || std::find(fEvalOrder.begin(), fEvalOrder.end(), res) != fEvalOrder.end()) {
+    return;
   }
 
-  std::vector<int> pool(n0, 0);
-  for (auto ii = 0; ii < n0; ii++) {
-    pool[ii] = ii;
+  std::vector<resonance*> daughs;
+  for (const auto& daughName : res->getDaughters()) {
+    auto daugh = getResonance(daughName);
+    addToEvalOrder(daugh);
+    daughs.push_back(daugh);
   }
-  std::vector<int> inds(np, 0);
-
-  // iterate recursively
-  combinations(n0, pool, np, inds, 0, combs);
-
-  return combs.size();
+  fEvalOrder.push_back(res);
+  fEvalDaughters.push_back(daughs);
 }
 
-std::vector<std::vector<int>> decayTree::combinations(int nPool)
+// compute all resonances of a combination of tracks
+// the tracks of the combination pass the selections of their finals
+void decayTree::computeResonances(std::vector<int> const& comb, int nTracks)
 {
-  // all selections of fnFinals items from nPool elements
-  std::vector<std::vector<int>> combs;
-  combinations(nPool, fnFinals, combs);
-
-  // permute the combinations
-  std::vector<std::vector<int>> copes;
-  for (const auto& comb : combs) {
-    for (const auto& perm : fPermutations) {
-      std::vector<int> cope(fnFinals, 0);
-      for (auto jj = 0; jj < fnFinals; jj++) {
-        cope[perm[jj]] = comb[jj];
-      }
-      copes.push_back(cope);
-    }
+  reset();
+
+  // finals
+  for (auto ind = 0; ind < fnFinals; ind++) {
+    auto res = fFinals[ind];
+    const auto& prong = fProngs[ind * nTracks + comb[ind]];
+    res->setIVM(prong.ivm);
+    res->setCharge(prong.charge);
+    res->setStatus(3);
   }
 
-  return copes;
+  // resonances
+  for (std::size_t ind = 0; ind < fEvalOrder.size(); ind++) {
+    auto res = fEvalOrder[ind];
+    TLorentzVector ivm{0., 0., 0., 0.};
+    int charge = 0;
+    for (const auto& daugh : fEvalDaughters[ind]) {
+      ivm += daugh->IVM();
+      charge += daugh->charge();
+    }
+    res->setIVM(ivm);
+    res->setCharge(charge);
+    res->setStatus(1);
+
+    // apply cuts
+    res->updateStatus();
+  }
 }
 
 // -----------------------------------------------------------------------------
@@ -495,51 +495,85 @@ class decayTree
       return decayTreeResType{{"ULS", ULSresults}, {"LS", LSresults}};
     }
 
-    // create all possible track combinations including permutations
-    auto combs = combinations(tracks.size());
-
-    // a vector to keep track of successful combinations
-    std::vector<std::size_t> goodCombs;
-
-    // loop over possible combinations
-    LOGF(debug, "New event");
-    for (auto& comb : combs) {
-      std::string scomb("");
-      for (const auto& i : comb) {
-        scomb.append(" ").append(std::to_string(i));
-      }
-      LOGF(debug, "  combination:%s", scomb);
-
-      // has an equivalent combination been accepted already?
-      auto newHash = combHash(comb);
-      if (std::find(goodCombs.begin(), goodCombs.end(), newHash) != goodCombs.end()) {
-        LOGF(debug, "    Equivalent combination is already accepted!");
-        continue;
+    // kinematics and selections of each final with each track, computed once per event
+    // a combination with a track which does not pass the selections of its final is never accepted
+    const int nTracks = tracks.size();
+    fProngs.resize(fnFinals * nTracks);
+    int itrack = 0;
+    for (const auto& track : tracks) {
+      for (auto ind = 0; ind < fnFinals; ind++) {
+        auto& prong = fProngs[ind * nTracks + itrack];
+        prong.isGood = false;
+        if (!(fFinalChargeMasks[ind] & (1 << (track.sign() > 0)))) {
+          continue;
+        }
+        auto res = fFinals[ind];
+        prong.ivm.SetXYZM(track.px(), track.py(), track.pz(), fFinalMasses[ind]);
+        prong.charge = track.sign();
+        res->setIVM(prong.ivm);
+        res->setCharge(prong.charge);
+        res->updateStatus(track);
+        prong.isGood = res->status() >= 3;
       }
+      itrack++;
+    }
 
-      // loop over resonances and compute
-      reset();
-      for (auto res : fResonances) {
-        computeResonance(res, tracks, comb);
-      }
+    // loop over all selections of nFinals tracks, in increasing order, and over their permutations
+    LOGF(debug, "New event");
+    std::vector<int> sel(fnFinals, 0);
+    for (auto ind = 0; ind < fnFinals; ind++) {
+      sel[ind] = ind;
+    }
+    std::vector<int> comb(fnFinals, 0);
+    while (fnFinals > 0) {
+      // only the first accepted permutation of a selection is kept
+      bool isAccepted = false;
+      for (const auto& perm : fPermutations) {
+        bool isGood = true;
+        for (auto ind = 0; ind < fnFinals; ind++) {
+          comb[perm[ind]] = sel[ind];
+        }
+        for (auto ind = 0; ind < fnFinals && isGood; ind++) {
+          isGood = fProngs[ind * nTracks + comb[ind]].isGood;
+        }
+        if (!isGood) {
+          continue;
+        }
 
-      // check angles between daughters of all resonances
-      checkAngles();
+        // compute the resonances and check their angles and status
+        computeResonances(comb, nTracks);
+        checkAngles();
+        updateStatus();
+        if (fStatus >= 2) {
+          std::map<std::string, reconstructedParticle> recResonances;
+          for (const auto& res : fResonances) {
+            recResonances.insert({res->name(), reconstructedParticle(res->name(), res->IVM(), comb)});
+          }
 
-      // check status of all resonances
-      updateStatus();
-      if (fStatus >= 2) {
-        goodCombs.push_back(newHash);
-        std::map<std::string, reconstructedParticle> recResonances;
-        for (const auto& res : fResonances) {
-          recResonances.insert({res->name(), reconstructedParticle(res->name(), res->IVM(), comb)});
+          if (fStatus == 2) {
+            ULSresults.push_back(recResonances);
+          } else {
+            LSresults.push_back(recResonances);
+          }
+          isAccepted = true;
+          break;
         }
+      }
+      if (isAccepted) {
+        LOGF(debug, "  accepted combination of tracks %d to %d", sel.front(), sel.back());
+      }
 
-        if (fStatus == 2) {
-          ULSresults.push_back(recResonances);
-        } else {
-          LSresults.push_back(recResonances);
-        }
+      // next selection
+      auto ind = fnFinals - 1;
+      while (ind >= 0 && sel[ind] == nTracks - fnFinals + ind) {
+        ind--;
+      }
+      if (ind < 0) {
+        break;
+      }
+      sel[ind]++;
+      for (auto jj = ind + 1; jj < fnFinals; jj++) {
+        sel[jj] = sel[jj - 1] + 1;
       }
     }
     auto results = decayTreeResType{{"ULS", ULSresults}, {"LS", LSresults}};
@@ -771,17 +805,37 @@ class decayTree
   // generate parent information for all resonances
   void updateParents();
 
-  // helper functions to compute combinations and permutations
-  //  combination:  selection of n out of N
+  // helper functions to compute permutations
   //  permutation:  order of n selected items
-  // create all permutations of all combinations
-  std::size_t combHash(std::vector<int>& comb);
   void permutations(std::vector<int>& ref, int n0, int np, std::vector<std::vector<int>>& perms);
   int permutations(int n0, std::vector<std::vector<int>>& perms);
-  void combinations(int n0, std::vector<int>& pool, int np, std::vector<int>& inds, int n,
-                    std::vector<std::vector<int>>& combs);
-  int combinations(int n0, int np, std::vector<std::vector<int>>& combs);
-  std::vector<std::vector<int>> combinations(int nPool);
+
+  // decay tree compiled at init into a flat evaluation plan
+  //  the resonances are evaluated in an order where the daughters come before their parents
+  //  the names of the daughters, finals and angle cuts are resolved once
+  struct compiledAngleCut {
+    resonance* res1;
+    resonance* res2;
+    double angleMin;
+    double angleMax;
+  };
+  struct prong {
+    TLorentzVector ivm;
+    int charge = 0;
+    bool isGood = false;
+  };
+  std::vector<resonance*> fFinals;                       // finals, by counter
+  std::vector<double> fFinalMasses;                      // nominal masses of the finals
+  std::vector<int> fFinalChargeMasks;                    // bit 0 (1): a final can be negative (positive) in a charge state
+  std::vector<resonance*> fEvalOrder;                    // resonances which are not finals, daughters first
+  std::vector<std::vector<resonance*>> fEvalDaughters;   // daughters of the resonances of fEvalOrder
+  std::vector<std::vector<compiledAngleCut>> fAngleCuts; // angle cuts of the resonances of fResonances
+  std::vector<prong> fProngs;                            // finals computed with each track of the event
+  void compile();
+  void addToEvalOrder(resonance* res);
+
+  // compute all resonances of a combination of tracks
+  void computeResonances(std::vector<int> const& comb, int nTracks);
 
   // check all angle requirements
   void checkAngles();
@@ -790,50 +844,6 @@ class decayTree
   int chargeState(std::vector<int> chs);
   void updateChargeState();
 
-  // templated functions
-  template <typename TTs>
-  void computeResonance(resonance* res, TTs const& tracks, std::vector<int>& comb)
-  {
-    // if status > 0 then return
-    if (res->status() > 0) {
-      return;
-    }
-
-    // initialisations
-    TLorentzVector ivm{0., 0., 0., 0.};
-    int charge = 0;
-
-    // is this a final state or a resonance
-    if (res->isFinal()) {
-      // is a final
-      auto pdgparticle = fPDG->GetParticle(res->pid());
-      auto track = (tracks.begin() + comb[res->counter()]);
-      ivm.SetXYZM(track.px(), track.py(), track.pz(), pdgparticle->Mass());
-      res->setIVM(ivm);
-      res->setCharge(track.sign());
-      res->setStatus(1);
-
-      // apply cuts
-      res->updateStatus(track);
-
-    } else {
-      // is a resonance
-      // loop over daughters
-      for (const auto& daughName : res->getDaughters()) {
-        auto daugh = getResonance(daughName);
-        computeResonance(daugh, tracks, comb);
-        ivm += daugh->IVM();
-        charge += daugh->charge();
-      }
-      res->setIVM(ivm);
-      res->setCharge(charge);
-      res->setStatus(1);
-
-      // apply cuts
-      res->updateStatus();
-    }
-  }
-
   // create histograms
   void createHistograms(o2::framework::HistogramRegistry& registry)
   {
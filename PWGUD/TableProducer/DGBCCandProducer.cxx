@@ -288,6 +288,9 @@ struct DGBCCandProducer {
   // DG selector
   DGSelector dgSelector;
 
+  // FIT veto of the BCs of the data frame, for processFull
+  udhelpers::FITVetoIndex fitVetoIndex;
+
   HistogramRegistry registry{
     "registry",
     {}};
@@ -569,6 +572,9 @@ struct DGBCCandProducer {
       return;
     }
 
+    // FIT veto of all BCs, the compatible BC ranges of neighbouring BCs overlap
+    fitVetoIndex.build(bcs, diffCuts);
+
     // run over all BC in bcs and tibcs
     // int64_t lastCollision = 0;
     float vpos[3];
@@ -636,7 +642,7 @@ struct DGBCCandProducer {
           auto bcRange = udhelpers::compatibleBCs(bc, bcnum, diffCuts.minNBCs(), bcs);
           auto colTracks = tracks.sliceByCached(aod::track::collisionId, col.globalIndex(), cache);
           auto colFwdTracks = fwdtracks.sliceByCached(aod::fwdtrack::collisionId, col.globalIndex(), cache);
-          isDG1 = dgSelector.IsSelected(diffCuts, col, bcRange, colTracks, colFwdTracks);
+          isDG1 = dgSelector.IsSelected(diffCuts, col, bcRange, colTracks, colFwdTracks, &fitVetoIndex);
           LOGF(debug, "  isDG1 %d with %d tracks", isDG1, ntr1);
           if (isDG1 == 0) {
             // this is a DG candidate with proper collision vertex
@@ -681,14 +687,14 @@ struct DGBCCandProducer {
             }
             if (ftibc.bcnum() == bcnum) {
               auto fwdTracksArray = ftibc.fwdtrack_as<FTCs>();
-              isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray);
+              isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray, &fitVetoIndex);
             } else {
               auto fwdTracksArray = FTCs{{fwdtracks.asArrowTable()->Slice(0, 0)}, (uint64_t)0};
-              isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray);
+              isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray, &fitVetoIndex);
             }
           } else {
             auto fwdTracksArray = FTCs{{fwdtracks.asArrowTable()->Slice(0, 0)}, (uint64_t)0};
-            isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray);
+            isDG2 = dgSelector.IsSelected(diffCuts, bcRange, tracksArray, fwdTracksArray, &fitVetoIndex);
           }
 
           LOGF(debug, "  isDG2 %d with %d tracks", isDG2, ntr2);
@@ -43,11 +43,13 @@
 #include <TH1.h>
 #include <TMath.h>
 
+#include <algorithm>
 #include <cstdint>
 #include <cstdlib>
 #include <map>
 #include <numeric>
 #include <string>
+#include <utility>
 #include <vector>
 
 using namespace o2::framework;
@@ -58,6 +60,12 @@ struct UpcCandProducerMuon {
 
   std::map<int32_t, int32_t> fNewPartIDs;
 
+  // forward tracks as (global BC, track ID), sorted by BC, reused across data frames
+  std::vector<std::pair<uint64_t, int64_t>> fMchMidTracksBC;
+  std::vector<std::pair<uint64_t, int64_t>> fMchTracksBC;
+  // MCH-only tracks around a candidate as (track ID, global BC), sorted by ID
+  std::vector<std::pair<int64_t, uint64_t>> fMchTrkIdsBC;
+
   Produces<o2::aod::UDMcCollisions> udMCCollisions;
   Produces<o2::aod::UDMcParticles> udMCParticles;
   Produces<o2::aod::UDMcFwdTrackLabels> udFwdTrackLabels;
@@ -280,15 +288,16 @@ struct UpcCandProducerMuon {
     }
   }
 
-  void getMchTrackIds(uint64_t inGbc, std::map<uint64_t, std::vector<int64_t>>& mchTracksPerBC,
-                      uint64_t maxDbc, std::map<int64_t, uint64_t>& outMchTrkIds)
+  // tracks within inGbc +- maxDbc, the tracks are sorted by BC and the output by track ID
+  void getMchTrackIds(uint64_t inGbc, std::vector<std::pair<uint64_t, int64_t>> const& mchTracksBC,
+                      uint64_t maxDbc, std::vector<std::pair<int64_t, uint64_t>>& outMchTrkIds)
   {
-    auto fillMchIds = [&outMchTrkIds](std::map<uint64_t, std::vector<int64_t>>::iterator& inIt, uint64_t gbc) {
-      std::vector<int64_t>& ids = inIt->second;
-      for (const auto& id : ids)
-        outMchTrkIds[id] = gbc;
-    };
-    scrollBackForth(inGbc, maxDbc, mchTracksPerBC, fillMchIds);
+    outMchTrkIds.clear();
+    uint64_t minGbc = inGbc > maxDbc ? inGbc - maxDbc : 0;
+    auto it = std::lower_bound(mchTracksBC.begin(), mchTracksBC.end(), minGbc, [](const auto& trackBC, uint64_t gbc) { return trackBC.first < gbc; });
+    for (; it != mchTracksBC.end() && it->first <= inGbc + maxDbc; ++it)
+      outMchTrkIds.emplace_back(it->second, it->first);
+    std::sort(outMchTrkIds.begin(), outMchTrkIds.end());
   }
 
   void getFV0Amplitudes(uint64_t inGbc, o2::aod::FV0As const& fv0s, uint64_t maxDbc,
@@ -434,8 +443,8 @@ struct UpcCandProducerMuon {
       vAmbFwdTrackIndexBCs[ambTr.globalIndex()] = ambTr.bcIds()[0];
     }
 
-    std::map<uint64_t, std::vector<int64_t>> mapGlobalBcsWithMCHMIDTrackIds;
-    std::map<uint64_t, std::vector<int64_t>> mapGlobalBcsWithMCHTrackIds;
+    fMchMidTracksBC.clear();
+    fMchTracksBC.clear();
     for (const auto& fwdTrack : fwdTracks) {
       if (fwdTrack.trackType() != MCHStandaloneTrack && fwdTrack.trackType() != MuonStandaloneTrack)
         continue;
@@ -443,14 +452,22 @@ struct UpcCandProducerMuon {
       int64_t indexBC = vAmbFwdTrackIndex[trackId] < 0 ? vColIndexBCs[fwdTrack.collisionId()] : vAmbFwdTrackIndexBCs[vAmbFwdTrackIndex[trackId]];
       auto globalBC = vGlobalBCs[indexBC] + TMath::FloorNint(fwdTrack.trackTime() / o2::constants::lhc::LHCBunchSpacingNS + 1.);
       if (fwdTrack.trackType() == MuonStandaloneTrack) // MCH-MID
-        mapGlobalBcsWithMCHMIDTrackIds[globalBC].push_back(trackId);
+        fMchMidTracksBC.emplace_back(globalBC, trackId);
       if (fwdTrack.trackType() == MCHStandaloneTrack) // MCH-only
-        mapGlobalBcsWithMCHTrackIds[globalBC].push_back(trackId);
+        fMchTracksBC.emplace_back(globalBC, trackId);
     }
+    // stable: the tracks of a BC stay in the order of the table
+    auto byBC = [](const auto& a, const auto& b) { return a.first < b.first; };
+    std::stable_sort(fMchMidTracksBC.begin(), fMchMidTracksBC.end(), byBC);
+    std::stable_sort(fMchTracksBC.begin(), fMchTracksBC.end(), byBC);
 
     int32_t candId = 0;
-    for (const auto& gbc_muids : mapGlobalBcsWithMCHMIDTrackIds) {
-      uint64_t globalBcMid = gbc_muids.first;
+    for (auto itMid = fMchMidTracksBC.begin(); itMid != fMchMidTracksBC.end();) {
+      uint64_t globalBcMid = itMid->first;
+      // MCH-MID tracks of this BC
+      auto itMidBegin = itMid;
+      while (itMid != fMchMidTracksBC.end() && itMid->first == globalBcMid)
+        ++itMid;
       auto itFv0Id = mapGlobalBcWithV0A.find(globalBcMid);
       if (itFv0Id != mapGlobalBcWithV0A.end()) {
         auto fv0Id = itFv0Id->second;
@@ -462,19 +479,17 @@ struct UpcCandProducerMuon {
           continue;
       }
       uint16_t numContrib = 0;
-      auto& vMuonIds = gbc_muids.second;
       // writing MCH-MID tracks
-      for (const auto& imuon : vMuonIds) {
-        if (!addToFwdTable(candId, imuon, globalBcMid, 0., fwdTracks, mcFwdTrackLabels))
+      for (auto itMuon = itMidBegin; itMuon != itMid; ++itMuon) {
+        if (!addToFwdTable(candId, itMuon->second, globalBcMid, 0., fwdTracks, mcFwdTrackLabels))
           continue;
         numContrib++;
       }
       if (numContrib < 1) // didn't save any MCH-MID tracks
         continue;
-      std::map<int64_t, uint64_t> mapMchIdBc{};
-      getMchTrackIds(globalBcMid, mapGlobalBcsWithMCHTrackIds, fBcWindowMCH, mapMchIdBc);
+      getMchTrackIds(globalBcMid, fMchTracksBC, fBcWindowMCH, fMchTrkIdsBC);
       // writing MCH-only tracks
-      for (const auto& [imch, gbc] : mapMchIdBc) {
+      for (const auto& [imch, gbc] : fMchTrkIdsBC) {
         if (!addToFwdTable(candId, imch, gbc, (gbc - globalBcMid) * o2::constants::lhc::LHCBunchSpacingNS, fwdTracks, mcFwdTrackLabels))
           continue;
         numContrib++;
@@ -508,8 +523,8 @@ struct UpcCandProducerMuon {
     mapGlobalBcWithZdc.clear();
     vAmbFwdTrackIndex.clear();
     vAmbFwdTrackIndexBCs.clear();
-    mapGlobalBcsWithMCHMIDTrackIds.clear();
-    mapGlobalBcsWithMCHTrackIds.clear();
+    fMchMidTracksBC.clear();
+    fMchTracksBC.clear();
   }
 
   void processFwd(ForwardTracks const& fwdTracks,
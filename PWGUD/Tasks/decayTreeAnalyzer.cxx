@@ -47,7 +47,7 @@ struct decayTreeAnalyzer {
   std::bitset<o2::constants::lhc::LHCMaxBunches> bcPatternB; // bc pattern of colliding bunches
 
   // goodRun selector
-  Configurable<std::string> goodRunsFile{"goodRunsFile", {}, "json with list of good runs"};
+  Configurable<std::string> goodRunsFile{"goodRunsFile", {}, "json with list of good runs and BC ranges"};
   UDGoodRunSelector grsel = UDGoodRunSelector();
 
   // decay tree object
@@ -81,9 +81,9 @@ struct decayTreeAnalyzer {
   void process(UDCollisionFull const& dgcand, UDTracksFull const& dgtracks, PVTracks const& PVContributors)
   {
 
-    // accept only selected run numbers
+    // accept only selected run numbers and BC ranges
     int run = dgcand.runNumber();
-    if (!grsel.isGoodRun(run)) {
+    if (!grsel.isGoodBC(run, dgcand.globalBC())) {
       return;
     }
 
@@ -55,7 +55,7 @@ struct DGCandAnalyzer {
   // configurables
   Configurable<bool> verbose{"Verbose", {}, "Additional printouts"};
   Configurable<int> candCaseSel{"CandCase", {}, "0: all Cands, 1: only ColCands,2: only BCCands"};
-  Configurable<std::string> goodRunsFile{"goodRunsFile", {}, "json with list of good runs"};
+  Configurable<std::string> goodRunsFile{"goodRunsFile", {}, "json with list of good runs and BC ranges"};
 
   // ccdb
   Service<o2::ccdb::BasicCCDBManager> ccdb;
@@ -247,9 +247,9 @@ struct DGCandAnalyzer {
     registry.fill(HIST("stat/candCaseAll"), 0., 1.);
     registry.fill(HIST("stat/nPVtracks"), dgcand.numContrib(), 1.);
 
-    // accept only selected run numbers
+    // accept only selected run numbers and BC ranges
     int run = dgcand.runNumber();
-    if (!grsel.isGoodRun(run)) {
+    if (!grsel.isGoodBC(run, dgcand.globalBC())) {
       return;
     }
 
@@ -2413,11 +2413,12 @@ struct TauTau13topo {
           nPiHasTPC[trk.index()]++;
         // p1.SetXYZM(trk1.px(), trk1.py(), trk1.pz(), MassElectron);
         p1.SetXYZT(trk1.px(), trk1.py(), trk1.pz(), RecoDecay::e(trk1.px(), trk1.py(), trk1.pz(), MassElectron));
-        invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1).mag2();
-        gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = (p + p1);
-        registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill((p + p1).mag2());
+        const auto pairEl = p + p1;
+        invMass2El[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = pairEl.mag2();
+        gammaPair[(counterTmp < 3 ? counterTmp : 5 - counterTmp)][(counterTmp < 3 ? 0 : 1)] = pairEl;
+        registry.get<TH1>(HIST("control/cut0/hInvMass2ElAll"))->Fill(pairEl.mag2());
         counterTmp++;
-        if ((p + p1).M() < 0.015) {
+        if (pairEl.M() < 0.015) {
           flagIMGam2ePV[trk.index()] = false;
           flagIMGam2ePV[trk1.index()] = false;
         }
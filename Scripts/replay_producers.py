@@ -0,0 +1,257 @@
+#!/usr/bin/env python3
+
+# Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+# See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+# All rights not expressly granted are reserved.
+#
+# This software is distributed under the terms of the GNU General Public
+# License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+#
+# In applying this license CERN does not waive the privileges and immunities
+# granted to it by virtue of its status as an Intergovernmental Organization
+# or submit itself to any jurisdiction.
+
+"""!
+@brief  Replay a pinned AO2D sample through a set of Common producers and compare their resource usage with a baseline.
+
+The producers are chained in one DPL workflow, run on the given AO2D file with the given JSON configuration.
+While the workflow runs, the /proc entries of its processes are polled and, for each DPL device (named by its --id),
+the script records:
+- the CPU time (user + system),
+- the peak resident memory (VmHWM),
+- the peak size of the data segment (VmData), which grows with the memory allocated by the device.
+The wall time of the whole replay is recorded as well. With several repetitions, the minimum of each metric is kept.
+
+The results are written in a JSON file, together with the SHA-256 checksum of the AO2D file.
+With --baseline, each metric is compared with the baseline: a metric regresses if it exceeds the baseline by more than
+the relative tolerance and by more than a noise floor (0.1 s for the times, 10 MB for the memory).
+The script then exits with status 1 if any metric regresses. A baseline recorded on another sample is rejected.
+
+Example:
+replay_producers.py --aod-file AO2D.root --configuration dpl-config.json --producers event-selection multiplicity \
+  --output results.json --baseline baseline.json --tolerance 0.1
+
+Linux only: the metrics are read from /proc.
+"""
+
+import argparse
+import hashlib
+import json
+import os
+import shlex
+import subprocess as sp  # nosec B404
+import sys
+import time
+
+# Workflows of each group of producers, in the order in which they are chained
+PRODUCERS = {
+    "timestamp": ["o2-analysis-timestamp"],
+    "event-selection": ["o2-analysis-timestamp", "o2-analysis-event-selection-service"],
+    "multiplicity": ["o2-analysis-multiplicity-table"],
+    "centrality": ["o2-analysis-centrality-table"],
+    "propagation": ["o2-analysis-track-propagation"],
+    "track-selection": ["o2-analysis-trackselection"],
+    "pid-tpc": ["o2-analysis-pid-tpc-service"],
+    "pid-tof": ["o2-analysis-pid-tof-merge"],
+    "pid-its": ["o2-analysis-pid-its"],
+}
+
+METRICS = ["cpu_s", "peak_rss_kb", "peak_data_kb"]  # metrics of each device
+NOISE_FLOORS = {"s": 0.1, "kb": 10240.0}  # differences ignored in the comparison, per unit
+
+CLOCK_TICKS = os.sysconf("SC_CLK_TCK") if hasattr(os, "sysconf") else 100
+
+
+def msg_fatal(message: str):
+    """Print an error message and exit."""
+    print(f"Error: {message}", file=sys.stderr)
+    sys.exit(2)
+
+
+def sha256_file(path: str) -> str:
+    """Return the SHA-256 checksum of a file."""
+    digest = hashlib.sha256()
+    with open(path, "rb") as file:
+        for chunk in iter(lambda: file.read(1 << 20), b""):
+            digest.update(chunk)
+    return digest.hexdigest()
+
+
+def build_workflows(producers: "list[str]", extra_workflows: "list[str]") -> "list[str]":
+    """Return the list of workflows of the producers, without repetitions."""
+    workflows = []
+    for producer in producers:
+        if producer not in PRODUCERS:
+            msg_fatal(f"Unknown producer {producer}, available: {', '.join(PRODUCERS)}")
+        workflows += PRODUCERS[producer]
+    workflows += extra_workflows
+    return list(dict.fromkeys(workflows))
+
+
+def build_command(workflows: "list[str]", aod_file: str, configuration: str, extra_args: str) -> str:
+    """Return the shell command of the chained workflow."""
+    options = ["-b"]
+    if configuration:
+        options += ["--configuration", f"json://{os.path.abspath(configuration)}"]
+    commands = [shlex.join([workflow] + options) for workflow in workflows]
+    commands[-1] += " " + shlex.join(["--aod-file", aod_file]) + (f" {extra_args}" if extra_args else "")
+    return " | ".join(commands)
+
+
+def read_process(pid: int):
+    """Return (parent pid, device name, CPU ticks, VmHWM kB, VmData kB) of a process, None if it is gone."""
+    try:
+        with open(f"/proc/{pid}/stat", "r", encoding="utf-8") as file:
+            stat = file.read()
+        with open(f"/proc/{pid}/cmdline", "rb") as file:
+            args = file.read().decode(errors="replace").split("\0")
+        with open(f"/proc/{pid}/status", "r", encoding="utf-8") as file:
+            status = dict(line.split(":", 1) for line in file if ":" in line)
+    except OSError:
+        return None
+    # the command name in parentheses may contain spaces
+    fields = stat[stat.rfind(")") + 2 :].split()
+    parent = int(fields[1])
+    ticks = int(fields[11]) + int(fields[12])
+    # the processes which are not DPL devices (driver, shell) are merged by executable
+    name = args[args.index("--id") + 1] if "--id" in args[:-1] else os.path.basename(args[0])
+
+    def memory(key: str) -> float:
+        return float(status[key].split()[0]) if key in status else 0.0
+
+    return parent, name, ticks, memory("VmHWM"), memory("VmData")
+
+
+def run_replay(command: str, poll_interval: float, log_file) -> dict:
+    """Run the workflow and return its wall time and the metrics of its devices."""
+    start = time.monotonic()
+    with sp.Popen(command, shell=True, stdout=log_file, stderr=sp.STDOUT) as process:  # nosec B602
+        processes = {}  # pid -> (name, CPU ticks, peak RSS, peak data) of the processes of the workflow
+        while process.poll() is None:
+            infos = {}
+            for entry in os.listdir("/proc"):
+                if entry.isdigit():
+                    info = read_process(int(entry))
+                    if info is not None:
+                        infos[int(entry)] = info
+            # descendants of the shell running the workflow
+            workflow_pids = {process.pid}
+            n_pids = 0
+            while n_pids != len(workflow_pids):
+                n_pids = len(workflow_pids)
+                workflow_pids |= {pid for pid, info in infos.items() if info[0] in workflow_pids}
+            for pid in workflow_pids - {process.pid}:
+                _, name, ticks, rss, data = infos[pid]
+                previous = processes.get(pid, (name, 0, 0.0, 0.0))
+                processes[pid] = (name, max(previous[1], ticks), max(previous[2], rss), max(previous[3], data))
+            time.sleep(poll_interval)
+    wall = time.monotonic() - start
+    if process.returncode != 0:
+        msg_fatal(f"The workflow failed with status {process.returncode}")
+
+    devices = {}
+    for name, ticks, rss, data in processes.values():
+        device = devices.setdefault(name, {"cpu_s": 0.0, "peak_rss_kb": 0.0, "peak_data_kb": 0.0})
+        device["cpu_s"] += ticks / CLOCK_TICKS
+        device["peak_rss_kb"] = max(device["peak_rss_kb"], rss)
+        device["peak_data_kb"] = max(device["peak_data_kb"], data)
+    return {"wall_s": wall, "devices": devices}
+
+
+def merge_minimum(results: "list[dict]") -> dict:
+    """Return the minimum of each metric over the repetitions."""
+    merged = {"wall_s": min(result["wall_s"] for result in results), "devices": {}}
+    for result in results:
+        for name, metrics in result["devices"].items():
+            device = merged["devices"].setdefault(name, dict(metrics))
+            for metric in METRICS:
+                device[metric] = min(device[metric], metrics[metric])
+    return merged
+
+
+def is_regression(metric: str, value: float, reference: float, tolerance: float) -> bool:
+    """Return whether a metric exceeds its reference beyond the tolerance and the noise floor."""
+    floor = NOISE_FLOORS[metric.rsplit("_", 1)[-1]]
+    return value > reference * (1.0 + tolerance) and value - reference > floor
+
+
+def compare(results: dict, baseline: dict, tolerance: float) -> int:
+    """Print the comparison with the baseline and return the number of regressions."""
+    if baseline.get("sample", {}).get("sha256") != results["sample"]["sha256"]:
+        msg_fatal("The baseline was recorded on another AO2D sample.")
+    rows = [("replay", "wall_s", results["wall_s"], baseline["wall_s"])]
+    for name, metrics in sorted(results["devices"].items()):
+        if name not in baseline["devices"]:
+            print(f"New device without baseline: {name}")
+            continue
+        rows += [(name, metric, metrics[metric], baseline["devices"][name][metric]) for metric in METRICS]
+    n_regressions = 0
+    print(f"{'device':<50} {'metric':<14} {'value':>14} {'baseline':>14} {'change':>9}")
+    for name, metric, value, reference in rows:
+        change = (value / reference - 1.0) * 100.0 if reference > 0 else 0.0
+        regression = is_regression(metric, value, reference, tolerance)
+        n_regressions += regression
+        flag = "  REGRESSION" if regression else ""
+        print(f"{name:<50} {metric:<14} {value:>14.2f} {reference:>14.2f} {change:>8.1f}%{flag}")
+    return n_regressions
+
+
+def main():
+    """Main function"""
+    parser = argparse.ArgumentParser(
+        description="Replay a pinned AO2D sample through Common producers and compare their resource usage "
+        "with a baseline."
+    )
+    parser.add_argument("--aod-file", required=True, help="AO2D file of the pinned sample")
+    parser.add_argument("--configuration", default="", help="JSON configuration of the workflows")
+    parser.add_argument(
+        "--producers", nargs="+", default=["event-selection"], help=f"producers to run: {', '.join(PRODUCERS)}"
+    )
+    parser.add_argument("--workflows", nargs="*", default=[], help="additional workflows, chained after the producers")
+    parser.add_argument("--extra-args", default="", help="additional arguments of the workflow, e.g. DPL options")
+    parser.add_argument("--repeat", type=int, default=1, help="number of repetitions, the minimum is kept")
+    parser.add_argument("--poll-interval", type=float, default=0.1, help="interval between the /proc polls (s)")
+    parser.add_argument("--output", default="replay_producers.json", help="output JSON file of the results")
+    parser.add_argument("--log", default="replay_producers.log", help="log file of the workflow")
+    parser.add_argument("--baseline", help="JSON file of the baseline results to compare with")
+    parser.add_argument("--tolerance", type=float, default=0.1, help="relative tolerance of the comparison")
+    parser.add_argument("--print-command", action="store_true", help="print the workflow command and exit")
+    args = parser.parse_args()
+
+    workflows = build_workflows(args.producers, args.workflows)
+    command = build_command(workflows, args.aod_file, args.configuration, args.extra_args)
+    if args.print_command:
+        print(command)
+        return
+    if not os.path.isdir("/proc"):
+        msg_fatal("The metrics are read from /proc, which is not available.")
+    sample = args.aod_file
+    if not os.path.isfile(sample):
+        msg_fatal(f"AO2D sample {sample} not found.")
+
+    print(f"Replaying {sample} through: {' | '.join(workflows)}")
+    repetitions = []
+    with open(args.log, "w", encoding="utf-8") as log_file:
+        for i in range(args.repeat):
+            repetitions.append(run_replay(command, args.poll_interval, log_file))
+            print(f"Repetition {i + 1}/{args.repeat}: {repetitions[-1]['wall_s']:.2f} s")
+    results = merge_minimum(repetitions)
+    results["sample"] = {"path": sample, "sha256": sha256_file(sample)}
+    results["workflows"] = workflows
+    results["command"] = command
+    with open(args.output, "w", encoding="utf-8") as file:
+        json.dump(results, file, indent=2, sort_keys=True)
+    print(f"Results written in {args.output}")
+
+    if args.baseline:
+        with open(args.baseline, "r", encoding="utf-8") as file:
+            baseline = json.load(file)
+        n_regressions = compare(results, baseline, args.tolerance)
+        if n_regressions:
+            print(f"{n_regressions} metrics exceed the baseline by more than {args.tolerance * 100:.0f}%.")
+            sys.exit(1)
+        print("All the metrics are within the tolerance of the baseline.")
+
+
+if __name__ == "__main__":
+    main()
@@ -36,12 +36,18 @@
 #include <KFPVertex.h>
 #include <KFParticle.h>
 #include <KFParticleBase.h>
+#include <KFParticleDef.h>
+#include <KFParticleSIMD.h>
 
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 constexpr float ArbitrarySmallNumber{1e-8f};
 constexpr float ArbitraryHugeNumber{1e8f};
@@ -413,4 +419,144 @@ std::pair<float, float> kfCalculateImpactParameterZ(const KFParticle& candidate,
   return std::make_pair(distanceToVertexZ, errDistanceToVertexZ);
 }
 
+/// @brief Cache of the KF daughters converted from the tracks
+/// The KFPTrack of a track and its KFParticle in each mass hypothesis are created once, the first time the track is
+/// used, and shared by all the candidates built with the track. The cache is cleared for each new set of tracks.
+/// @tparam NHypotheses number of mass hypotheses
+template <std::size_t NHypotheses>
+class KFTrackCache
+{
+ public:
+  /// @brief KF daughters of a track
+  struct Entry {
+    KFPTrack kfpTrack;                             // track converted to KFPTrack
+    std::array<KFParticle, NHypotheses> particles; // KFParticle of the track in each mass hypothesis
+  };
+
+  /// @param pdgs PDG codes of the mass hypotheses
+  explicit KFTrackCache(const std::array<int, NHypotheses>& pdgs) : pdgs(pdgs) {}
+
+  /// @brief Remove all the tracks of the cache
+  void clear() { entries.clear(); }
+
+  /// @brief KF daughters of a track, created at the first call for the track
+  /// @param track Track from aod::Tracks, aod::TracksExtra, aod::TracksCov
+  /// @return KF daughters of the track, valid until the cache is cleared
+  template <typename T>
+  const Entry& get(const T& track)
+  {
+    auto [entry, isNew] = entries.try_emplace(track.globalIndex());
+    if (isNew) {
+      entry->second.kfpTrack = createKFPTrackFromTrack(track);
+      for (std::size_t i = 0; i < NHypotheses; ++i) {
+        entry->second.particles[i] = KFParticle(entry->second.kfpTrack, pdgs[i]);
+      }
+    }
+    return entry->second;
+  }
+
+ private:
+  std::array<int, NHypotheses> pdgs;          // PDG codes of the mass hypotheses
+  std::unordered_map<int64_t, Entry> entries; // KF daughters per global index of the track
+};
+
+/// @brief Batch of two-prong candidates reconstructed with KFParticleSIMD
+/// The candidates are packed in the SIMD lanes of KFParticleSIMD, so that float_v::Size candidates are processed per
+/// instruction in the construction, in the mass constraint and in the topological constraint to the production vertex.
+class KFCandidateBatch2Prong
+{
+ public:
+  /// @brief Remove all the candidates of the batch
+  void clear()
+  {
+    daughters0.clear();
+    daughters1.clear();
+    vertices.clear();
+    candidates.clear();
+    candidatesTopo.clear();
+  }
+
+  /// @brief Reserve the space for a number of candidates
+  /// @param size number of candidates
+  void reserve(const std::size_t size)
+  {
+    daughters0.reserve(size);
+    daughters1.reserve(size);
+    vertices.reserve(size);
+  }
+
+  /// @brief Add a candidate to the batch
+  /// @param daughter0 KFParticle first daughter
+  /// @param daughter1 KFParticle second daughter
+  /// @param vertex KFParticle production vertex
+  /// @return index of the candidate in the batch
+  std::size_t add(const KFParticle& daughter0, const KFParticle& daughter1, const KFParticle& vertex)
+  {
+    daughters0.push_back(daughter0);
+    daughters1.push_back(daughter1);
+    vertices.push_back(vertex);
+    return daughters0.size() - 1;
+  }
+
+  /// @brief Reconstruct all the candidates of the batch
+  /// @param bz magnetic field (kG)
+  /// @param constructMethod KFParticle construct method
+  /// @param mass mass of the nonlinear mass constraint, not applied if negative
+  /// @param constrainToVertex whether to compute the candidates with topological constraint to the production vertex
+  void construct(const float bz, const int constructMethod, const float mass, const bool constrainToVertex)
+  {
+    const std::size_t nCandidates = daughters0.size();
+    candidates.resize(nCandidates);
+    candidatesTopo.resize(constrainToVertex ? nCandidates : 0);
+    KFParticleSIMD::SetField(bz);
+    constexpr std::size_t NLanes = float_v::Size;
+    std::array<KFParticle*, NLanes> lanesDaughter0{};
+    std::array<KFParticle*, NLanes> lanesDaughter1{};
+    std::array<KFParticle*, NLanes> lanesVertex{};
+    for (std::size_t first = 0; first < nCandidates; first += NLanes) {
+      const std::size_t nFilled = std::min(NLanes, nCandidates - first);
+      // the unused lanes repeat the last candidate to keep them numerically sane
+      for (std::size_t iLane = 0; iLane < NLanes; ++iLane) {
+        const std::size_t iCandidate = first + std::min(iLane, nFilled - 1);
+        lanesDaughter0[iLane] = &daughters0[iCandidate];
+        lanesDaughter1[iLane] = &daughters1[iCandidate];
+        lanesVertex[iLane] = &vertices[iCandidate];
+      }
+      const KFParticleSIMD daughter0(lanesDaughter0.data(), static_cast<int>(NLanes));
+      const KFParticleSIMD daughter1(lanesDaughter1.data(), static_cast<int>(NLanes));
+      const KFParticleSIMD* daughters[2] = {&daughter0, &daughter1};
+      KFParticleSIMD candidate;
+      candidate.SetConstructMethod(constructMethod);
+      candidate.Construct(daughters, 2);
+      if (mass > 0.f) {
+        candidate.SetNonlinearMassConstraint(float_v(mass));
+      }
+      for (std::size_t iLane = 0; iLane < nFilled; ++iLane) {
+        candidate.GetKFParticle(candidates[first + iLane], static_cast<int>(iLane));
+      }
+      if (constrainToVertex) {
+        const KFParticleSIMD vertex(lanesVertex.data(), static_cast<int>(NLanes));
+        candidate.SetProductionVertex(vertex);
+        for (std::size_t iLane = 0; iLane < nFilled; ++iLane) {
+          candidate.GetKFParticle(candidatesTopo[first + iLane], static_cast<int>(iLane));
+        }
+      }
+    }
+  }
+
+  /// @brief number of candidates in the batch
+  std::size_t size() const { return daughters0.size(); }
+  /// @brief candidate reconstructed by construct()
+  const KFParticle& getCandidate(const std::size_t index) const { return candidates[index]; }
+  /// @brief candidate with topological constraint to the production vertex, reconstructed by construct()
+  const KFParticle& getCandidateTopo(const std::size_t index) const { return candidatesTopo[index]; }
+
+ private:
+  std::vector<KFParticle> daughters0;     // first daughters
+  std::vector<KFParticle> daughters1;     // second daughters
+  std::vector<KFParticle> vertices;       // production vertices
+  std::vector<KFParticle> candidates;     // reconstructed candidates
+  std::vector<KFParticle> candidatesTopo; // reconstructed candidates with topological constraint to the production vertex
+};
+
 #endif // TOOLS_KFPARTICLE_KFUTILITIES_H_
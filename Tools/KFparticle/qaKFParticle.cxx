@@ -53,6 +53,7 @@
 
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -76,6 +77,11 @@ struct qaKFParticle {
   int runNumber;
   double magneticField = 0.;
   int PVContributor = 0;
+  /// KF daughters of the tracks of the collision, in the pion and kaon hypotheses
+  static constexpr std::size_t IndexPion{0};
+  static constexpr std::size_t IndexKaon{1};
+  using KFDaughterCache = KFTrackCache<2>;
+  KFDaughterCache kfDaughters{{211, 321}};
 
   /// Histogram Configurables
   ConfigurableAxis binsPt{"binsPt", {VARIABLE_WIDTH, 0.0, 1., 2., 3., 4., 5., 6., 7., 8., 9., 10., 11., 12., 13., 14., 15., 16., 17., 24., 36., 50.0}, ""};
@@ -665,6 +671,7 @@ struct qaKFParticle {
     /// set KF primary vertex
     KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
     KFParticle KFPV(kfpVertex);
+    kfDaughters.clear();
     for (auto& [track1, track2] : combinations(soa::CombinationsStrictlyUpperIndexPolicy(tracks, tracks))) {
 
       histos.fill(HIST("DZeroCandTopo/Selections"), 3.f);
@@ -675,10 +682,10 @@ struct qaKFParticle {
         continue;
       }
 
-      KFPTrack kfpTrackPosPi;
-      KFPTrack kfpTrackNegPi;
-      KFPTrack kfpTrackPosKa;
-      KFPTrack kfpTrackNegKa;
+      const KFDaughterCache::Entry* posPi = nullptr;
+      const KFDaughterCache::Entry* negPi = nullptr;
+      const KFDaughterCache::Entry* posKa = nullptr;
+      const KFDaughterCache::Entry* negKa = nullptr;
 
       bool CandD0 = false;
       bool CandD0bar = false;
@@ -715,8 +722,8 @@ struct qaKFParticle {
         if (track1.sign() == 1 && track2.sign() == -1) {
           CandD0 = true;
           source = 1;
-          kfpTrackPosPi = createKFPTrackFromTrack(track1);
-          kfpTrackNegKa = createKFPTrackFromTrack(track2);
+          posPi = &kfDaughters.get(track1);
+          negKa = &kfDaughters.get(track2);
           TPCnSigmaPosPi = track1.tpcNSigmaPi();
           TPCnSigmaNegKa = track2.tpcNSigmaKa();
           TOFnSigmaPosPi = track1.tofNSigmaPi();
@@ -726,8 +733,8 @@ struct qaKFParticle {
         } else if (track1.sign() == -1 && track2.sign() == 1) {
           CandD0bar = true;
           source = 2;
-          kfpTrackNegPi = createKFPTrackFromTrack(track1);
-          kfpTrackPosKa = createKFPTrackFromTrack(track2);
+          negPi = &kfDaughters.get(track1);
+          posKa = &kfDaughters.get(track2);
           TPCnSigmaNegPi = track1.tpcNSigmaPi();
           TPCnSigmaPosKa = track2.tpcNSigmaKa();
           TOFnSigmaNegPi = track1.tofNSigmaPi();
@@ -745,8 +752,8 @@ struct qaKFParticle {
           if (CandD0 == true) {
             source = 3;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track2);
-          kfpTrackPosKa = createKFPTrackFromTrack(track1);
+          negPi = &kfDaughters.get(track2);
+          posKa = &kfDaughters.get(track1);
           TPCnSigmaNegPi = track2.tpcNSigmaPi();
           TPCnSigmaPosKa = track1.tpcNSigmaKa();
           TOFnSigmaNegPi = track2.tofNSigmaPi();
@@ -759,8 +766,8 @@ struct qaKFParticle {
           if (CandD0bar == true) {
             source = 3;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track2);
-          kfpTrackNegKa = createKFPTrackFromTrack(track1);
+          posPi = &kfDaughters.get(track2);
+          negKa = &kfDaughters.get(track1);
           TPCnSigmaPosPi = track2.tpcNSigmaPi();
           TPCnSigmaNegKa = track1.tpcNSigmaKa();
           TOFnSigmaPosPi = track2.tofNSigmaPi();
@@ -776,15 +783,14 @@ struct qaKFParticle {
         continue;
       }
 
-      KFParticle KFPosPion(kfpTrackPosPi, 211);
-      KFParticle KFNegPion(kfpTrackNegPi, 211);
-      KFParticle KFPosKaon(kfpTrackPosKa, 321);
-      KFParticle KFNegKaon(kfpTrackNegKa, 321);
-
       int NDaughters = 2;
       float cosThetaStar = 0;
 
       if (CandD0) {
+        const KFPTrack& kfpTrackPosPi = posPi->kfpTrack;
+        const KFPTrack& kfpTrackNegKa = negKa->kfpTrack;
+        const KFParticle& KFPosPion = posPi->particles[IndexPion];
+        const KFParticle& KFNegKaon = negKa->particles[IndexKaon];
         KFParticle KFDZero;
         const KFParticle* D0Daughters[2] = {&KFPosPion, &KFNegKaon};
         KFDZero.SetConstructMethod(2);
@@ -820,6 +826,10 @@ struct qaKFParticle {
         writeVarTree(kfpTrackPosPi, kfpTrackNegKa, KFPosPion, KFNegKaon, KFDZero_PV, KFDZero, KFPV, KFDZero_DecayVtx, TPCnSigmaPosPi, TOFnSigmaPosPi, TPCnSigmaNegKa, TOFnSigmaNegKa, TPCNclsPosPi, TPCNclsNegKa, cosThetaStar, track1, source);
       }
       if (CandD0bar) {
+        const KFPTrack& kfpTrackNegPi = negPi->kfpTrack;
+        const KFPTrack& kfpTrackPosKa = posKa->kfpTrack;
+        const KFParticle& KFNegPion = negPi->particles[IndexPion];
+        const KFParticle& KFPosKaon = posKa->particles[IndexKaon];
         KFParticle KFDZeroBar;
         const KFParticle* D0BarDaughters[2] = {&KFNegPion, &KFPosKaon};
         KFDZeroBar.SetConstructMethod(2);
@@ -882,6 +892,7 @@ struct qaKFParticle {
     /// set KF primary vertex
     KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
     KFParticle KFPV(kfpVertex);
+    kfDaughters.clear();
 
     KFPVertex kfpVertexDefault = createKFPVertexFromCollision(collision);
     KFParticle KFPVDefault(kfpVertexDefault);
@@ -979,10 +990,10 @@ struct qaKFParticle {
         continue;
       }
 
-      KFPTrack kfpTrackPosPi;
-      KFPTrack kfpTrackNegPi;
-      KFPTrack kfpTrackPosKa;
-      KFPTrack kfpTrackNegKa;
+      const KFDaughterCache::Entry* posPi = nullptr;
+      const KFDaughterCache::Entry* negPi = nullptr;
+      const KFDaughterCache::Entry* posKa = nullptr;
+      const KFDaughterCache::Entry* negKa = nullptr;
 
       bool CandD0 = false;
       bool CandD0bar = false;
@@ -1022,8 +1033,8 @@ struct qaKFParticle {
           if (pdgMother == -421) {
             sourceD0 |= kReflection;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track1);
-          kfpTrackNegKa = createKFPTrackFromTrack(track2);
+          posPi = &kfDaughters.get(track1);
+          negKa = &kfDaughters.get(track2);
           TPCnSigmaPosPi = track1.tpcNSigmaPi();
           TPCnSigmaNegKa = track2.tpcNSigmaKa();
           TOFnSigmaPosPi = track1.tofNSigmaPi();
@@ -1035,8 +1046,8 @@ struct qaKFParticle {
           if (pdgMother == 421) {
             sourceD0Bar |= kReflection;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track1);
-          kfpTrackPosKa = createKFPTrackFromTrack(track2);
+          negPi = &kfDaughters.get(track1);
+          posKa = &kfDaughters.get(track2);
           TPCnSigmaNegPi = track1.tpcNSigmaPi();
           TPCnSigmaPosKa = track2.tpcNSigmaKa();
           TOFnSigmaNegPi = track1.tofNSigmaPi();
@@ -1053,8 +1064,8 @@ struct qaKFParticle {
           if (pdgMother == 421) {
             sourceD0Bar |= kReflection;
           }
-          kfpTrackNegPi = createKFPTrackFromTrack(track2);
-          kfpTrackPosKa = createKFPTrackFromTrack(track1);
+          negPi = &kfDaughters.get(track2);
+          posKa = &kfDaughters.get(track1);
           TPCnSigmaNegPi = track2.tpcNSigmaPi();
           TPCnSigmaPosKa = track1.tpcNSigmaKa();
           TOFnSigmaNegPi = track2.tofNSigmaPi();
@@ -1066,8 +1077,8 @@ struct qaKFParticle {
           if (pdgMother == -421) {
             sourceD0 |= kReflection;
           }
-          kfpTrackPosPi = createKFPTrackFromTrack(track2);
-          kfpTrackNegKa = createKFPTrackFromTrack(track1);
+          posPi = &kfDaughters.get(track2);
+          negKa = &kfDaughters.get(track1);
           TPCnSigmaPosPi = track2.tpcNSigmaPi();
           TPCnSigmaNegKa = track1.tpcNSigmaKa();
           TOFnSigmaPosPi = track2.tofNSigmaPi();
@@ -1083,15 +1094,14 @@ struct qaKFParticle {
         continue;
       }
 
-      KFParticle KFPosPion(kfpTrackPosPi, 211);
-      KFParticle KFNegPion(kfpTrackNegPi, 211);
-      KFParticle KFPosKaon(kfpTrackPosKa, 321);
-      KFParticle KFNegKaon(kfpTrackNegKa, 321);
-
       int NDaughters = 2;
       float cosThetaStar = 0;
 
       if (CandD0) {
+        const KFPTrack& kfpTrackPosPi = posPi->kfpTrack;
+        const KFPTrack& kfpTrackNegKa = negKa->kfpTrack;
+        const KFParticle& KFPosPion = posPi->particles[IndexPion];
+        const KFParticle& KFNegKaon = negKa->particles[IndexKaon];
         KFParticle KFDZero;
         const KFParticle* D0Daughters[2] = {&KFPosPion, &KFNegKaon};
         KFDZero.SetConstructMethod(2);
@@ -1132,6 +1142,10 @@ struct qaKFParticle {
         writeVarTree(kfpTrackPosPi, kfpTrackNegKa, KFPosPion, KFNegKaon, KFDZero_PV, KFDZero, KFPV, KFDZero_DecayVtx, TPCnSigmaPosPi, TOFnSigmaPosPi, TPCnSigmaNegKa, TOFnSigmaNegKa, TPCNclsPosPi, TPCNclsNegKa, cosThetaStar, track1, sourceD0);
       }
       if (CandD0bar) {
+        const KFPTrack& kfpTrackNegPi = negPi->kfpTrack;
+        const KFPTrack& kfpTrackPosKa = posKa->kfpTrack;
+        const KFParticle& KFNegPion = negPi->particles[IndexPion];
+        const KFParticle& KFPosKaon = posKa->particles[IndexKaon];
         KFParticle KFDZeroBar;
         const KFParticle* D0BarDaughters[2] = {&KFNegPion, &KFPosKaon};
         KFDZeroBar.SetConstructMethod(2);
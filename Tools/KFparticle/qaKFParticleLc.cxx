@@ -47,6 +47,7 @@
 #include <KFParticle.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -69,6 +70,11 @@ struct qaKFParticleLc {
   int runNumber;
   double magneticField = 0.;
   KFParticle KFPion, KFKaon, KFProton, KFLc, KFLc_PV;
+  /// KF daughters of the tracks of the collision, in the pion, kaon and proton hypotheses
+  static constexpr std::size_t IndexPion{0};
+  static constexpr std::size_t IndexKaon{1};
+  static constexpr std::size_t IndexProton{2};
+  KFTrackCache<3> kfDaughters{{211, 321, 2212}};
 
   /// option to select good events
   Configurable<bool> eventSelection{"eventSelection", true, "select good events"}; // currently only sel8 is defined for run3
@@ -240,15 +246,9 @@ struct qaKFParticleLc {
   template <typename T, typename T2>
   bool ReconstructLc(const T& trackKaon, const T& trackPion, const T& trackProton, const T2& KFPV)
   {
-    KFPTrack kfpTrackKa = createKFPTrackFromTrack(trackKaon);
-    KFPTrack kfpTrackPi = createKFPTrackFromTrack(trackPion);
-    KFPTrack kfpTrackPr = createKFPTrackFromTrack(trackProton);
-    KFParticle KFKa(kfpTrackKa, 321);
-    KFKaon = KFKa;
-    KFParticle KFPi(kfpTrackPi, 211);
-    KFPion = KFPi;
-    KFParticle KFPr(kfpTrackPr, 2212);
-    KFProton = KFPr;
+    KFKaon = kfDaughters.get(trackKaon).particles[IndexKaon];
+    KFPion = kfDaughters.get(trackPion).particles[IndexPion];
+    KFProton = kfDaughters.get(trackProton).particles[IndexProton];
     const KFParticle* LcDaughters[3] = {&KFKaon, &KFPion, &KFProton};
     KFLc.SetConstructMethod(2);
     KFLc.Construct(LcDaughters, 3);
@@ -473,6 +473,7 @@ struct qaKFParticleLc {
     /// set KF primary vertex
     KFPVertex kfpVertex = createKFPVertexFromCollision(collision);
     KFParticle KFPV(kfpVertex);
+    kfDaughters.clear();
 
     for (auto& [track1, track2, track3] : combinations(soa::CombinationsStrictlyUpperIndexPolicy(tracks, tracks, tracks))) {
 
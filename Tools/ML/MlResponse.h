@@ -17,16 +17,25 @@
 #ifndef TOOLS_ML_MLRESPONSE_H_
 #define TOOLS_ML_MLRESPONSE_H_
 
+#include "Tools/ML/TreeEnsembleModel.h"
 #include "Tools/ML/model.h"
 
 #include <CCDB/CcdbApi.h>
 #include <Framework/Array2D.h>
 #include <Framework/Logger.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <future>
+#include <iterator>
+#include <limits>
 #include <map>
+#include <random>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace o2
@@ -50,8 +59,11 @@ class MlResponse
  public:
   /// Default constructor
   MlResponse() = default;
-  /// Default destructor
-  virtual ~MlResponse() = default;
+  /// Destructor, waits for the warm-up inference still running on the models
+  virtual ~MlResponse()
+  {
+    waitForWarmUp();
+  }
 
   /// Configure class instance (import configurables)
   /// \param binsLimits is a vector containing bins limits
@@ -64,6 +76,7 @@ class MlResponse
       LOG(fatal) << "Number of classes (" << static_cast<int>(nClasses) << ") different from the number of cuts on model scores (" << cutDir.size() << ")! Please check your configurables.";
     }
 
+    waitForWarmUp();
     mBinsLimits = binsLimits;
     mCuts = cuts;
     mCutDir = cutDir;
@@ -71,6 +84,7 @@ class MlResponse
     mNModels = binsLimits.size() - 1;
     mModels = std::vector<o2::ml::OnnxModel>(mNModels);
     mPaths = std::vector<std::string>(mNModels);
+    compileBinningAndCuts();
   }
 
   /// Configure class instance (import configurables)
@@ -85,6 +99,7 @@ class MlResponse
       LOG(fatal) << "Mismatch between nClasses and cutDir size";
     }
 
+    waitForWarmUp();
     mBinsLimits = binsLimitsVar1;
     mBinsLimitsVar2 = binsLimitsVar2;
     mCuts = cuts;
@@ -98,6 +113,7 @@ class MlResponse
     mPaths = std::vector<std::string>(mNModels);
 
     mUse2DBinning = true;
+    compileBinningAndCuts();
   }
 
   /// Set model paths to CCDB
@@ -105,8 +121,9 @@ class MlResponse
   /// \param ccdbApi is the CCDB API
   /// \param pathsCCDB is a vector of model paths in CCDB, one for each bin
   /// \param timestampCCDB is the CCDB timestamp
+  /// \param loadInMemory is a switch to retrieve all models in parallel directly into memory instead of writing them to disk
   /// \note On the CCDB, different models must be stored in different folders
-  void setModelPathsCCDB(const std::vector<std::string>& onnxFiles, const o2::ccdb::CcdbApi& ccdbApi, const std::vector<std::string>& pathsCCDB, int64_t timestampCCDB)
+  void setModelPathsCCDB(const std::vector<std::string>& onnxFiles, const o2::ccdb::CcdbApi& ccdbApi, const std::vector<std::string>& pathsCCDB, int64_t timestampCCDB, bool loadInMemory = false)
   {
     if (onnxFiles.size() != mNModels) {
       LOG(fatal) << "Number of expected models (" << mNModels << ") different from the one set (" << onnxFiles.size() << ")! Please check your configurables.";
@@ -124,6 +141,30 @@ class MlResponse
       }
     }
 
+    if (loadInMemory) {
+      // one CCDB API instance per request, so that all the models are retrieved in parallel
+      mModelBuffers = std::vector<std::vector<char>>(mNModels);
+      std::vector<std::future<void>> retrievals;
+      for (auto iFile{0}; iFile < mNModels; ++iFile) {
+        retrievals.emplace_back(std::async(std::launch::async, [&, iFile]() {
+          o2::ccdb::CcdbApi api;
+          api.init(ccdbApi.getURL());
+          std::map<std::string, std::string> metadata;
+          std::map<std::string, std::string> headers;
+          api.loadFileToMemory(mModelBuffers[iFile], pathsCCDB[iFile], metadata, timestampCCDB, &headers, "", "", "");
+        }));
+      }
+      for (auto iFile{0}; iFile < mNModels; ++iFile) {
+        retrievals[iFile].get();
+        if (!mModelBuffers[iFile].empty()) {
+          mPaths[iFile] = onnxFiles[iFile];
+        } else {
+          LOG(fatal) << "Error encountered while accessing the ML model from " << pathsCCDB[iFile] << "! Maybe the ML model doesn't exist yet for this run number or timestamp?";
+        }
+      }
+      return;
+    }
+
     for (auto iFile{0}; iFile < mNModels; ++iFile) {
       std::map<std::string, std::string> metadata;
       bool retrieveSuccess = ccdbApi.retrieveBlob(pathsCCDB[iFile], ".", metadata, timestampCCDB, false, onnxFiles[iFile]);
@@ -143,6 +184,70 @@ class MlResponse
       LOG(fatal) << "Number of expected models (" << mNModels << ") different from the one set (" << onnxFiles.size() << ")! Please check your configurables.";
     }
     mPaths = onnxFiles;
+    mModelBuffers.clear();
+  }
+
+  /// Set paths to reduced-precision (FP16 or INT8) variants of the models, to be used if they pass the accuracy check at init
+  /// \param onnxFiles is a vector of onnx file names, one for each bin (empty names keep the full-precision model)
+  /// \param maxDeviation is the maximum score deviation with respect to the full-precision model on the validation inputs
+  /// \note The reduced-precision variants must keep full-precision inputs and outputs (e.g. keep_io_types for FP16 conversion)
+  void setReducedPrecisionModelPathsLocal(const std::vector<std::string>& onnxFiles, double maxDeviation = 1.e-3)
+  {
+    if (onnxFiles.size() != mNModels) {
+      LOG(fatal) << "Number of expected reduced-precision models (" << mNModels << ") different from the one set (" << onnxFiles.size() << ")! Please check your configurables.";
+    }
+    mPathsReducedPrecision = onnxFiles;
+    mMaxDeviationReducedPrecision = maxDeviation;
+  }
+
+  /// Set paths to reduced-precision (FP16 or INT8) variants of the models stored in CCDB
+  /// \param onnxFiles is a vector of onnx file names, one for each bin
+  /// \param ccdbApi is the CCDB API
+  /// \param pathsCCDB is a vector of reduced-precision model paths in CCDB, one for each bin (empty paths keep the full-precision model)
+  /// \param timestampCCDB is the CCDB timestamp
+  /// \param maxDeviation is the maximum score deviation with respect to the full-precision model on the validation inputs
+  /// \note A missing reduced-precision model is not an error: the full-precision model is used for that bin
+  void setReducedPrecisionModelPathsCCDB(const std::vector<std::string>& onnxFiles, const o2::ccdb::CcdbApi& ccdbApi, const std::vector<std::string>& pathsCCDB, int64_t timestampCCDB, double maxDeviation = 1.e-3)
+  {
+    if (onnxFiles.size() != mNModels || pathsCCDB.size() != mNModels) {
+      LOG(fatal) << "Number of expected reduced-precision models (" << mNModels << ") different from the one set (" << onnxFiles.size() << " files, " << pathsCCDB.size() << " CCDB paths)! Please check your configurables.";
+    }
+    mPathsReducedPrecision = std::vector<std::string>(mNModels);
+    mMaxDeviationReducedPrecision = maxDeviation;
+    for (auto iFile{0}; iFile < mNModels; ++iFile) {
+      if (pathsCCDB[iFile].empty()) {
+        continue;
+      }
+      std::map<std::string, std::string> metadata;
+      if (ccdbApi.retrieveBlob(pathsCCDB[iFile], ".", metadata, timestampCCDB, false, onnxFiles[iFile])) {
+        mPathsReducedPrecision[iFile] = onnxFiles[iFile];
+      } else {
+        LOG(warning) << "Reduced-precision ML model not found in " << pathsCCDB[iFile] << ", using the full-precision model";
+      }
+    }
+  }
+
+  /// Set the validation inputs used to check the reduced-precision models at init
+  /// \param inputs are the flattened input features of the validation candidates, (number of candidates) x (number of features)
+  void setValidationInputs(const std::vector<TypeOutputScore>& inputs)
+  {
+    mValidationInputs = inputs;
+  }
+
+  /// Evaluate the candidates of all bins sharing the same model in a single batch, to be called before init
+  /// \param enable is a switch to enable the fused execution (enabled by default)
+  void setUseFusedExecution(bool enable)
+  {
+    mUseFusedExecution = enable;
+  }
+
+  /// Use the native tree-ensemble evaluator instead of ONNX Runtime for BDT models, to be called before init
+  /// \param enable is a switch to enable the native evaluator
+  /// \param tolerance is the maximum score difference with respect to ONNX Runtime accepted in the validation done at init
+  void setUseNativeTreeEvaluator(bool enable, double tolerance = 1.e-5)
+  {
+    mUseNativeTreeEvaluator = enable;
+    mTreeEvaluatorTolerance = tolerance;
   }
 
   /// Initialize class instance (initialize OnnxModels)
@@ -150,10 +255,83 @@ class MlResponse
   /// \param threads is the number of active threads
   void init(bool enableOptimizations = false, int threads = 0)
   {
-    uint8_t counterModel{0};
-    for (const auto& path : mPaths) {
-      mModels[counterModel].initModel(path, enableOptimizations, threads);
-      ++counterModel;
+    // the models must not be rebuilt while a previous warm-up is running on them
+    waitForWarmUp();
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      if (isModelInMemory(iModel)) {
+        mModels[iModel].initModelFromBuffer(getModelBuffer(iModel), mPaths[iModel], enableOptimizations, threads);
+      } else {
+        mModels[iModel].initModel(mPaths[iModel], enableOptimizations, threads);
+      }
+    }
+    if (!mPathsReducedPrecision.empty()) {
+      for (auto iModel{0}; iModel < mNModels; ++iModel) {
+        if (mPathsReducedPrecision[iModel].empty()) {
+          continue;
+        }
+        o2::ml::OnnxModel modelReducedPrecision;
+        modelReducedPrecision.initModel(mPathsReducedPrecision[iModel], enableOptimizations, threads);
+        if (validateReducedPrecisionModel(iModel, modelReducedPrecision)) {
+          mPaths[iModel] = mPathsReducedPrecision[iModel];
+          if (isModelInMemory(iModel)) {
+            mModelBuffers[iModel].clear();
+          }
+          mModels[iModel].initModel(mPaths[iModel], enableOptimizations, threads);
+        }
+      }
+    }
+    mTreeModels = std::vector<o2::ml::TreeEnsembleModel>(mNModels);
+    mUseTreeModel = std::vector<uint8_t>(mNModels, 0);
+    if (mUseNativeTreeEvaluator) {
+      for (auto iModel{0}; iModel < mNModels; ++iModel) {
+        const bool isLoaded = isModelInMemory(iModel) ? mTreeModels[iModel].loadModelFromBuffer(getModelBuffer(iModel), mPaths[iModel]) : mTreeModels[iModel].loadModel(mPaths[iModel]);
+        mUseTreeModel[iModel] = isLoaded && validateTreeModel(iModel);
+        if (!mUseTreeModel[iModel]) {
+          LOG(warning) << "Native tree-ensemble evaluator not available for model " << mPaths[iModel] << ", using ONNX Runtime";
+        }
+      }
+    }
+    // bins sharing the same model are evaluated together in batched mode
+    mFusedModels = std::vector<int>(mNModels);
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      mFusedModels[iModel] = iModel;
+      if (!mUseFusedExecution) {
+        continue;
+      }
+      for (auto iOtherModel{0}; iOtherModel < iModel; ++iOtherModel) {
+        if (isSameModel(iModel, iOtherModel)) {
+          mFusedModels[iModel] = mFusedModels[iOtherModel];
+          break;
+        }
+      }
+    }
+    // warm-up inference off the critical path, overlapping with the rest of the task initialisation
+    mWarmUp = std::async(std::launch::async, [this]() {
+      for (auto iModel{0}; iModel < mNModels; ++iModel) {
+        if (!isUsingTreeModel(iModel)) {
+          mModels[iModel].warmUp();
+        }
+      }
+    });
+  }
+
+  /// Enable the inference telemetry of all models
+  /// \param registry is an optional histogram registry where latency and batch-size histograms are added, one folder for each model
+  void enableTelemetry(o2::framework::HistogramRegistry* registry = nullptr)
+  {
+    waitForWarmUp();
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      mModels[iModel].enableTelemetry(registry, "MlResponse/model" + std::to_string(iModel) + "/");
+    }
+  }
+
+  /// Print the inference telemetry of all models
+  void printTelemetry() const
+  {
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      if (mModels[iModel].isTelemetryEnabled()) {
+        mModels[iModel].getTelemetry().print(mPaths[iModel]);
+      }
     }
   }
 
@@ -182,6 +360,13 @@ class MlResponse
       LOG(fatal) << "Model index " << nModel << " is out of range! The number of initialised models is " << mModels.size() << ". Please check your configurables.";
     }
 
+    waitForWarmUp();
+    if (isUsingTreeModel(nModel)) {
+      std::vector<TypeOutputScore> output(mTreeModels[nModel].getNumOutputs());
+      mTreeModels[nModel].evaluate(input.data(), 1, input.size(), output.data());
+      output.resize(mNClasses);
+      return output;
+    }
     TypeOutputScore* outputPtr = mModels[nModel].template evalModel<TypeOutputScore>(input);
     return std::vector<TypeOutputScore>{outputPtr, outputPtr + mNClasses};
   }
@@ -195,20 +380,7 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     auto output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return isPassingCuts(output, nModel);
   }
 
   /// ML selections
@@ -221,20 +393,7 @@ class MlResponse
   {
     int nModel = findBin(candVar);
     output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
-        }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
-        }
-      }
-      ++iClass;
-    }
-    return true;
+    return isPassingCuts(output, nModel);
   }
 
   /// ML selections
@@ -251,20 +410,187 @@ class MlResponse
     }
     int nModel = findBin2D(candVar1, candVar2);
     output = getModelOutput(input, nModel);
-    uint8_t iClass{0};
-    for (const auto& outputValue : output) {
-      uint8_t dir = mCutDir.at(iClass);
-      if (dir != o2::cuts_ml::CutDirection::CutNot) {
-        if (dir == o2::cuts_ml::CutDirection::CutGreater && outputValue > mCuts.get(nModel, iClass)) {
-          return false;
+    return isPassingCuts(output, nModel);
+  }
+
+  /// Set the maximum number of candidates sent to a model in a single call in batched mode
+  /// \param maxBatchSize is the maximum number of candidates per call (0 means no limit)
+  void setMaxBatchSize(std::size_t maxBatchSize)
+  {
+    mMaxBatchSize = maxBatchSize;
+  }
+
+  /// Remove all the candidates collected for batched inference
+  void clearBatch()
+  {
+    mBatchModels.clear();
+    mBatchOutputs.clear();
+    mBatchInputs.assign(mNModels, std::vector<TypeOutputScore>{});
+    mBatchCandidates.assign(mNModels, std::vector<std::size_t>{});
+  }
+
+  /// Add a candidate to the batch evaluated by evalBatch
+  /// \param input is the input features
+  /// \param candVar is the variable value (e.g. pT) used to select which model to use
+  /// \return index of the candidate in the batch
+  template <typename T1, typename T2>
+  std::size_t addToBatch(T1 const& input, const T2& candVar)
+  {
+    return addToBatchModel(input, findBin(candVar));
+  }
+
+  /// Add a candidate to the batch evaluated by evalBatch, with 2D binning
+  /// \param input is the input features
+  /// \param candVar1 is the first variable value (e.g. pT) used to select which model to use
+  /// \param candVar2 is the second variable value (e.g. multiplicity) used to select which model to use
+  /// \return index of the candidate in the batch
+  template <typename T1, typename T2, typename T3>
+  std::size_t addToBatch(T1 const& input, const T2& candVar1, const T3& candVar2)
+  {
+    return addToBatchModel(input, findBin2D(candVar1, candVar2));
+  }
+
+  /// Add a candidate to the batch evaluated by evalBatch, with the model chosen by the caller
+  /// \param input is the input features
+  /// \param nModel is the model index (-1 if outside of the binning)
+  /// \return index of the candidate in the batch
+  template <typename T>
+  std::size_t addToBatchModel(T const& input, const int nModel)
+  {
+    if (mBatchInputs.size() != mNModels) {
+      clearBatch();
+    }
+    if (nModel >= mNModels) {
+      LOG(fatal) << "Model index " << nModel << " is out of range! The number of initialised models is " << static_cast<int>(mNModels) << ". Please check your configurables.";
+    }
+    const std::size_t iCand = mBatchModels.size();
+    mBatchModels.push_back(nModel);
+    if (nModel >= 0) {
+      // candidates are stored in the bucket of the first bin sharing the same model
+      const int nModelFused = static_cast<std::size_t>(nModel) < mFusedModels.size() ? mFusedModels[nModel] : nModel;
+      mBatchInputs[nModelFused].insert(mBatchInputs[nModelFused].end(), std::begin(input), std::end(input));
+      mBatchCandidates[nModelFused].push_back(iCand);
+    }
+    return iCand;
+  }
+
+  /// Add several candidates to the batch evaluated by evalBatch, with the input features stored by column
+  /// \param featureColumns are the input features, one column of candVars.size() values for each feature
+  /// \param candVars are the variable values (e.g. pT) used to select which model to use, one for each candidate
+  /// \return index in the batch of the first candidate, the following ones having consecutive indices
+  template <typename T>
+  std::size_t addColumnsToBatch(std::span<const TypeOutputScore> featureColumns, std::vector<T> const& candVars)
+  {
+    if (mBatchInputs.size() != mNModels) {
+      clearBatch();
+    }
+    const std::size_t iFirstCand = mBatchModels.size();
+    const std::size_t nCand = candVars.size();
+    if (nCand == 0) {
+      return iFirstCand;
+    }
+    const std::size_t nFeatures = featureColumns.size() / nCand;
+    mBatchModels.reserve(iFirstCand + nCand);
+    for (std::size_t iCand{0}; iCand < nCand; ++iCand) {
+      const int nModel = findBin(candVars[iCand]);
+      mBatchModels.push_back(nModel);
+      if (nModel < 0) {
+        continue;
+      }
+      // the models take the input features by row, candidate after candidate
+      const int nModelFused = static_cast<std::size_t>(nModel) < mFusedModels.size() ? mFusedModels[nModel] : nModel;
+      auto& inputs = mBatchInputs[nModelFused];
+      for (std::size_t iFeature{0}; iFeature < nFeatures; ++iFeature) {
+        inputs.push_back(featureColumns[iFeature * nCand + iCand]);
+      }
+      mBatchCandidates[nModelFused].push_back(iFirstCand + iCand);
+    }
+    return iFirstCand;
+  }
+
+  /// Evaluate all the candidates collected in the batch with one model call per bin (or per chunk of setMaxBatchSize candidates)
+  /// \note Candidates outside of the binning are not evaluated: their scores are set to zero and they are rejected by isSelectedBatch
+  void evalBatch()
+  {
+    waitForWarmUp();
+    mBatchOutputs.assign(mBatchModels.size() * mNClasses, TypeOutputScore{0});
+    std::vector<TypeOutputScore> chunkInput;
+    std::vector<TypeOutputScore> chunkOutput;
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      const auto& candidates = mBatchCandidates[iModel];
+      if (candidates.empty()) {
+        continue;
+      }
+      auto& inputs = mBatchInputs[iModel];
+      const std::size_t nFeatures = inputs.size() / candidates.size();
+      const std::size_t chunkSize = mMaxBatchSize > 0 ? mMaxBatchSize : candidates.size();
+      for (std::size_t iFirst{0}; iFirst < candidates.size(); iFirst += chunkSize) {
+        const std::size_t nCandChunk = std::min(chunkSize, candidates.size() - iFirst);
+        bool success{false};
+        if (isUsingTreeModel(iModel)) {
+          chunkOutput.resize(nCandChunk * mTreeModels[iModel].getNumOutputs());
+          mTreeModels[iModel].evaluate(inputs.data() + iFirst * nFeatures, nCandChunk, nFeatures, chunkOutput.data());
+          success = true;
+        } else if (nCandChunk == candidates.size()) {
+          success = mModels[iModel].template evalModel<TypeOutputScore>(inputs, chunkOutput);
+        } else {
+          chunkInput.assign(inputs.begin() + iFirst * nFeatures, inputs.begin() + (iFirst + nCandChunk) * nFeatures);
+          success = mModels[iModel].template evalModel<TypeOutputScore>(chunkInput, chunkOutput);
+        }
+        if (!success || chunkOutput.size() < nCandChunk * mNClasses) {
+          LOG(fatal) << "Batched inference of model " << iModel << " failed for " << nCandChunk << " candidates!";
         }
-        if (dir == o2::cuts_ml::CutDirection::CutSmaller && outputValue < mCuts.get(nModel, iClass)) {
-          return false;
+        // the output of each candidate has the number of model output nodes, of which only the first mNClasses are kept
+        const std::size_t nOutputs = chunkOutput.size() / nCandChunk;
+        for (std::size_t iCandChunk{0}; iCandChunk < nCandChunk; ++iCandChunk) {
+          std::copy_n(chunkOutput.begin() + iCandChunk * nOutputs, mNClasses, mBatchOutputs.begin() + candidates[iFirst + iCandChunk] * mNClasses);
         }
       }
-      ++iClass;
     }
-    return true;
+  }
+
+  /// Get the number of candidates collected in the batch
+  std::size_t getBatchSize() const { return mBatchModels.size(); }
+
+  /// Get the model scores of all candidates of the batch, after evalBatch
+  /// \return span of (number of candidates) x (number of classes) scores, indexed by candidate
+  std::span<const TypeOutputScore> getBatchOutputs() const { return mBatchOutputs; }
+
+  /// Get the model scores of a candidate of the batch, after evalBatch
+  /// \param iCand is the index of the candidate returned by addToBatch
+  /// \return span of model predictions, one for each class
+  std::span<const TypeOutputScore> getBatchOutput(std::size_t iCand) const
+  {
+    return std::span<const TypeOutputScore>{mBatchOutputs}.subspan(iCand * mNClasses, mNClasses);
+  }
+
+  /// Whether a candidate of the batch is inside the binning of the models, i.e. evaluated by evalBatch
+  /// \param iCand is the index of the candidate returned by addToBatch
+  bool isInBatchBinning(std::size_t iCand) const
+  {
+    return mBatchModels[iCand] >= 0;
+  }
+
+  /// ML selections for a candidate of the batch, after evalBatch
+  /// \param iCand is the index of the candidate returned by addToBatch
+  /// \return boolean telling if model predictions pass the cuts
+  bool isSelectedBatch(std::size_t iCand) const
+  {
+    const int nModel = mBatchModels[iCand];
+    if (nModel < 0) {
+      return false;
+    }
+    return isPassingCuts(getBatchOutput(iCand), nModel);
+  }
+
+  /// ML selections for all candidates of the batch in one pass, after evalBatch
+  /// \param isSelected is filled with one flag for each candidate of the batch
+  void getSelectedBatch(std::vector<uint8_t>& isSelected) const
+  {
+    isSelected.resize(mBatchModels.size());
+    for (std::size_t iCand{0}; iCand < mBatchModels.size(); ++iCand) {
+      isSelected[iCand] = isSelectedBatch(iCand);
+    }
   }
 
  protected:
@@ -281,10 +607,216 @@ class MlResponse
   uint8_t mNVar1Bins = 1;                                 // number of bins of the first variable (e.g. pT) used to select which model to use
   uint8_t mNVar2Bins = 1;                                 // number of bins of the second variable (e.g. multiplicity) used to select which model to use
   bool mUse2DBinning = false;                             // switch to enable/disable 2D binning
+  std::size_t mMaxBatchSize = 0;                          // maximum number of candidates per model call in batched mode (0 means no limit)
+  std::vector<int> mBatchModels;                          // model index of each candidate of the batch (-1 if outside of the binning)
+  std::vector<std::vector<TypeOutputScore>> mBatchInputs; // flattened input features of the batch, one vector for each model
+  std::vector<std::vector<std::size_t>> mBatchCandidates; // indices of the candidates of the batch, one vector for each model
+  std::vector<TypeOutputScore> mBatchOutputs;             // flattened model predictions of the batch, indexed by candidate
+  std::vector<o2::ml::TreeEnsembleModel> mTreeModels;     // native tree-ensemble evaluators, one for each bin
+  std::vector<uint8_t> mUseTreeModel;                     // whether the native tree-ensemble evaluator is used, one for each bin
+  bool mUseNativeTreeEvaluator = false;                   // switch to enable the native tree-ensemble evaluator for BDT models
+  double mTreeEvaluatorTolerance = 1.e-5;                 // maximum score difference between native evaluator and ONNX Runtime
+  std::vector<std::string> mPathsReducedPrecision = {};  // paths to the reduced-precision variants of the models, one for each bin
+  double mMaxDeviationReducedPrecision = 1.e-3;           // maximum score deviation of the reduced-precision models on the validation inputs
+  std::vector<TypeOutputScore> mValidationInputs = {};    // flattened validation inputs used to check the reduced-precision models
+  std::vector<std::vector<char>> mModelBuffers = {};      // content of the models retrieved into memory, one for each bin
+  std::future<void> mWarmUp;                              // asynchronous warm-up inference of the models
+  std::vector<int> mFusedModels = {};                     // index of the first bin sharing the same model, one for each bin
+  bool mUseFusedExecution = true;                         // switch to evaluate together the bins sharing the same model in batched mode
+  std::vector<double> mCutsLow = {};                      // lower bound of the accepted scores, (number of models) x (number of classes)
+  std::vector<double> mCutsHigh = {};                     // upper bound of the accepted scores, (number of models) x (number of classes)
+  double mInvBinWidthVar1 = 0.;                           // inverse bin width of the first variable if its bins are uniform, zero otherwise
+  double mInvBinWidthVar2 = 0.;                           // inverse bin width of the second variable if its bins are uniform, zero otherwise
 
   virtual void setAvailableInputFeatures() { return; } // method to fill the map of available input features
 
  private:
+  /// Whether a model was retrieved into memory
+  bool isModelInMemory(const int nModel) const
+  {
+    return static_cast<std::size_t>(nModel) < mModelBuffers.size() && !mModelBuffers[nModel].empty();
+  }
+
+  /// Content of a model retrieved into memory
+  std::string_view getModelBuffer(const int nModel) const
+  {
+    return std::string_view{mModelBuffers[nModel].data(), mModelBuffers[nModel].size()};
+  }
+
+  /// Whether two bins use the same model with the same backend
+  bool isSameModel(const int nModel, const int nOtherModel) const
+  {
+    if (isUsingTreeModel(nModel) != isUsingTreeModel(nOtherModel) || isModelInMemory(nModel) != isModelInMemory(nOtherModel)) {
+      return false;
+    }
+    if (isModelInMemory(nModel)) {
+      return mModelBuffers[nModel] == mModelBuffers[nOtherModel];
+    }
+    return mPaths[nModel] == mPaths[nOtherModel];
+  }
+
+  /// Waits for the asynchronous warm-up of the models to complete
+  void waitForWarmUp()
+  {
+    if (mWarmUp.valid()) {
+      mWarmUp.get();
+    }
+  }
+
+  /// Whether the native tree-ensemble evaluator is used for a model
+  bool isUsingTreeModel(const int nModel) const
+  {
+    return static_cast<std::size_t>(nModel) < mUseTreeModel.size() && mUseTreeModel[nModel];
+  }
+
+  /// Compares a reduced-precision model with the full-precision one on the validation inputs
+  /// \param nModel is the model index
+  /// \param modelReducedPrecision is the initialised reduced-precision model
+  /// \return true if the maximum score deviation is within mMaxDeviationReducedPrecision
+  bool validateReducedPrecisionModel(const int nModel, o2::ml::OnnxModel& modelReducedPrecision)
+  {
+    const std::size_t nFeatures = mModels[nModel].getNumInputNodes();
+    if (mValidationInputs.empty() || mValidationInputs.size() % nFeatures != 0) {
+      LOG(warning) << "No valid validation inputs for the reduced-precision model " << mPathsReducedPrecision[nModel] << ", using the full-precision model";
+      return false;
+    }
+    if (modelReducedPrecision.getNumInputNodes() != mModels[nModel].getNumInputNodes()) {
+      LOG(warning) << "Reduced-precision model " << mPathsReducedPrecision[nModel] << " has a different number of inputs, using the full-precision model";
+      return false;
+    }
+    std::vector<TypeOutputScore> inputs = mValidationInputs;
+    std::vector<TypeOutputScore> outputFull;
+    std::vector<TypeOutputScore> outputReduced;
+    if (!mModels[nModel].template evalModel<TypeOutputScore>(inputs, outputFull) || !modelReducedPrecision.template evalModel<TypeOutputScore>(inputs, outputReduced) || outputFull.size() != outputReduced.size()) {
+      LOG(warning) << "Reduced-precision model " << mPathsReducedPrecision[nModel] << " cannot be evaluated on the validation inputs, using the full-precision model";
+      return false;
+    }
+    double maxDeviation{0.};
+    for (std::size_t iOutput{0}; iOutput < outputFull.size(); ++iOutput) {
+      maxDeviation = std::max(maxDeviation, static_cast<double>(std::abs(outputFull[iOutput] - outputReduced[iOutput])));
+    }
+    const bool isAccepted = maxDeviation <= mMaxDeviationReducedPrecision;
+    LOG(info) << "Reduced-precision model " << mPathsReducedPrecision[nModel] << ": maximum score deviation " << maxDeviation << (isAccepted ? ", model used" : ", above threshold, using the full-precision model");
+    return isAccepted;
+  }
+
+  /// Compares the native tree-ensemble evaluator with ONNX Runtime on inputs close to the split thresholds
+  /// \param nModel is the model index
+  /// \return true if the maximum score difference is within mTreeEvaluatorTolerance
+  bool validateTreeModel(const int nModel)
+  {
+    constexpr int NValidationInputs = 200;
+    const std::size_t nFeatures = mModels[nModel].getNumInputNodes();
+    if (mTreeModels[nModel].getNumOutputs() < mNClasses || static_cast<std::size_t>(mTreeModels[nModel].getNumFeatures()) > nFeatures) {
+      return false;
+    }
+    std::mt19937 generator(nModel);
+    std::vector<float> sample;
+    std::vector<TypeOutputScore> inputs;
+    for (int iInput{0}; iInput < NValidationInputs; ++iInput) {
+      mTreeModels[nModel].generateValidationInput(generator, sample, nFeatures);
+      inputs.insert(inputs.end(), sample.begin(), sample.end());
+    }
+    std::vector<TypeOutputScore> outputOnnx;
+    if (!mModels[nModel].template evalModel<TypeOutputScore>(inputs, outputOnnx) || outputOnnx.size() < NValidationInputs * static_cast<std::size_t>(mNClasses)) {
+      return false;
+    }
+    const std::size_t nOutputsOnnx = outputOnnx.size() / NValidationInputs;
+    const std::size_t nOutputsTree = mTreeModels[nModel].getNumOutputs();
+    std::vector<TypeOutputScore> outputTree(NValidationInputs * nOutputsTree);
+    mTreeModels[nModel].evaluate(inputs.data(), NValidationInputs, nFeatures, outputTree.data());
+    double maxDifference{0.};
+    for (int iInput{0}; iInput < NValidationInputs; ++iInput) {
+      for (auto iClass{0}; iClass < mNClasses; ++iClass) {
+        maxDifference = std::max(maxDifference, static_cast<double>(std::abs(outputOnnx[iInput * nOutputsOnnx + iClass] - outputTree[iInput * nOutputsTree + iClass])));
+      }
+    }
+    LOG(info) << "Native tree-ensemble evaluator for model " << mPaths[nModel] << ": maximum score difference with ONNX Runtime " << maxDifference;
+    return maxDifference <= mTreeEvaluatorTolerance;
+  }
+
+  /// Checks the model predictions of a candidate against the cuts
+  /// \param output is the container of model predictions, one for each class
+  /// \param nModel is the model index
+  /// \return boolean telling if model predictions pass the cuts
+  template <typename T>
+  bool isPassingCuts(T const& output, const int nModel) const
+  {
+    const double* cutsLow = mCutsLow.data() + nModel * mNClasses;
+    const double* cutsHigh = mCutsHigh.data() + nModel * mNClasses;
+    bool isPassing{true};
+    uint8_t iClass{0};
+    for (const auto& outputValue : output) {
+      isPassing &= !(outputValue < cutsLow[iClass]) & !(outputValue > cutsHigh[iClass]);
+      ++iClass;
+    }
+    return isPassing;
+  }
+
+  /// Compiles the cuts into per-model score intervals and checks whether the bins are uniform
+  void compileBinningAndCuts()
+  {
+    mCutsLow.assign(mNModels * mNClasses, -std::numeric_limits<double>::infinity());
+    mCutsHigh.assign(mNModels * mNClasses, std::numeric_limits<double>::infinity());
+    for (auto iModel{0}; iModel < mNModels; ++iModel) {
+      for (auto iClass{0}; iClass < mNClasses; ++iClass) {
+        const auto dir = mCutDir.at(iClass);
+        if (dir == o2::cuts_ml::CutDirection::CutGreater) {
+          mCutsHigh[iModel * mNClasses + iClass] = mCuts.get(iModel, iClass);
+        } else if (dir == o2::cuts_ml::CutDirection::CutSmaller) {
+          mCutsLow[iModel * mNClasses + iClass] = mCuts.get(iModel, iClass);
+        }
+      }
+    }
+    mInvBinWidthVar1 = getInverseUniformBinWidth(mBinsLimits);
+    mInvBinWidthVar2 = getInverseUniformBinWidth(mBinsLimitsVar2);
+  }
+
+  /// Checks whether bin limits are equally spaced
+  /// \param binsLimits is a vector containing bins limits
+  /// \return inverse of the bin width for uniform bins, zero otherwise
+  static double getInverseUniformBinWidth(const std::vector<double>& binsLimits)
+  {
+    if (binsLimits.size() < 2) {
+      return 0.;
+    }
+    const double width = (binsLimits.back() - binsLimits.front()) / (binsLimits.size() - 1);
+    if (!(width > 0.)) {
+      return 0.;
+    }
+    for (std::size_t iLimit{1}; iLimit < binsLimits.size(); ++iLimit) {
+      if (std::abs(binsLimits[iLimit] - binsLimits[iLimit - 1] - width) > 1.e-6 * width) {
+        return 0.;
+      }
+    }
+    return 1. / width;
+  }
+
+  /// Finds matching bin in a vector of bin limits
+  /// \param binsLimits is a vector containing bins limits
+  /// \param invBinWidth is the inverse of the bin width for uniform bins, zero otherwise
+  /// \param value e.g. pT
+  /// \return index of the matching bin, -1 if outside of the limits
+  template <typename T>
+  static int findBinInLimits(const std::vector<double>& binsLimits, const double invBinWidth, T const& value)
+  {
+    if (!(value >= binsLimits.front()) || value >= binsLimits.back()) {
+      return -1;
+    }
+    if (invBinWidth > 0.) {
+      // direct computation for uniform bins, corrected by one bin at most for rounding at the bin edges
+      const int nBins = binsLimits.size() - 1;
+      int bin = std::min(static_cast<int>((value - binsLimits.front()) * invBinWidth), nBins - 1);
+      if (value < binsLimits[bin]) {
+        --bin;
+      } else if (value >= binsLimits[bin + 1]) {
+        ++bin;
+      }
+      return bin;
+    }
+    return std::distance(binsLimits.begin(), std::upper_bound(binsLimits.begin(), binsLimits.end(), value)) - 1;
+  }
+
   /// Finds matching bin in mBinsLimits
   /// \param value e.g. pT
   /// \return index of the matching bin, used to access mModels
@@ -292,13 +824,7 @@ class MlResponse
   template <typename T>
   int findBin(T const& value)
   {
-    if (value < mBinsLimits.front()) {
-      return -1;
-    }
-    if (value >= mBinsLimits.back()) {
-      return -1;
-    }
-    return std::distance(mBinsLimits.begin(), std::upper_bound(mBinsLimits.begin(), mBinsLimits.end(), value)) - 1;
+    return findBinInLimits(mBinsLimits, mInvBinWidthVar1, value);
   }
 
   /// Finds matching bin in mBinsLimits
@@ -312,20 +838,11 @@ class MlResponse
     if (!mUse2DBinning) {
       LOG(fatal) << "2D ML selection called on a class not configured for 2D bins";
     }
-    if (value1 < mBinsLimits.front()) {
-      return -1;
-    }
-    if (value1 >= mBinsLimits.back()) {
-      return -1;
-    }
-    if (value2 < mBinsLimitsVar2.front()) {
-      return -1;
-    }
-    if (value2 >= mBinsLimitsVar2.back()) {
+    const int bin1 = findBinInLimits(mBinsLimits, mInvBinWidthVar1, value1);
+    const int bin2 = findBinInLimits(mBinsLimitsVar2, mInvBinWidthVar2, value2);
+    if (bin1 < 0 || bin2 < 0) {
       return -1;
     }
-    int bin1 = std::distance(mBinsLimits.begin(), std::upper_bound(mBinsLimits.begin(), mBinsLimits.end(), value1)) - 1;
-    int bin2 = std::distance(mBinsLimitsVar2.begin(), std::upper_bound(mBinsLimitsVar2.begin(), mBinsLimitsVar2.end(), value2)) - 1;
     return bin2 * mNVar1Bins + bin1;
   }
 };
@@ -0,0 +1,467 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     TreeEnsembleModel.cxx
+///
+/// \brief    Native evaluator of tree-ensemble (BDT) models stored in ONNX format
+///
+
+#include "Tools/ML/TreeEnsembleModel.h"
+
+#include <Framework/Logger.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace o2
+{
+
+namespace ml
+{
+
+namespace
+{
+
+/// Minimal reader of the protobuf wire format, sufficient to extract the attributes of the ONNX graph nodes
+class ProtoReader
+{
+ public:
+  ProtoReader(const char* begin, const char* end) : mPtr(begin), mEnd(end) {}
+
+  bool atEnd() const { return mPtr >= mEnd; }
+
+  uint64_t readVarint()
+  {
+    uint64_t result{0};
+    for (int shift = 0; shift < 64 && mPtr < mEnd; shift += 7) {
+      const auto byte = static_cast<uint8_t>(*mPtr++);
+      result |= static_cast<uint64_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) {
+        return result;
+      }
+    }
+    throw std::runtime_error("truncated varint");
+  }
+
+  float readFixed32Float()
+  {
+    if (mEnd - mPtr < 4) {
+      throw std::runtime_error("truncated fixed32");
+    }
+    float value;
+    std::memcpy(&value, mPtr, sizeof(value));
+    mPtr += 4;
+    return value;
+  }
+
+  ProtoReader readLengthDelimited()
+  {
+    const uint64_t length = readVarint();
+    if (length > static_cast<uint64_t>(mEnd - mPtr)) {
+      throw std::runtime_error("truncated length-delimited field");
+    }
+    ProtoReader sub(mPtr, mPtr + length);
+    mPtr += length;
+    return sub;
+  }
+
+  std::string readString()
+  {
+    auto sub = readLengthDelimited();
+    return std::string(sub.mPtr, sub.mEnd);
+  }
+
+  void skip(const int wireType)
+  {
+    switch (wireType) {
+      case 0:
+        readVarint();
+        break;
+      case 1:
+        advance(8);
+        break;
+      case 2:
+        readLengthDelimited();
+        break;
+      case 5:
+        advance(4);
+        break;
+      default:
+        throw std::runtime_error("unsupported wire type " + std::to_string(wireType));
+    }
+  }
+
+ private:
+  const char* mPtr;
+  const char* mEnd;
+
+  void advance(const std::ptrdiff_t n)
+  {
+    if (mEnd - mPtr < n) {
+      throw std::runtime_error("truncated field");
+    }
+    mPtr += n;
+  }
+};
+
+/// Attribute of an ONNX node (AttributeProto), restricted to the types used by tree ensembles
+struct Attribute {
+  float f = 0.f;
+  int64_t i = 0;
+  std::string s;
+  std::vector<float> floats;
+  std::vector<int64_t> ints;
+  std::vector<std::string> strings;
+};
+
+using AttributeMap = std::map<std::string, Attribute>;
+
+void readAttribute(ProtoReader reader, AttributeMap& attributes)
+{
+  std::string name;
+  Attribute attribute;
+  while (!reader.atEnd()) {
+    const uint64_t key = reader.readVarint();
+    const int field = key >> 3;
+    const int wireType = key & 0x7;
+    if (field == 1 && wireType == 2) {
+      name = reader.readString();
+    } else if (field == 2 && wireType == 5) {
+      attribute.f = reader.readFixed32Float();
+    } else if (field == 3 && wireType == 0) {
+      attribute.i = static_cast<int64_t>(reader.readVarint());
+    } else if (field == 4 && wireType == 2) {
+      attribute.s = reader.readString();
+    } else if (field == 7 && wireType == 5) {
+      attribute.floats.push_back(reader.readFixed32Float());
+    } else if (field == 7 && wireType == 2) {
+      auto packed = reader.readLengthDelimited();
+      while (!packed.atEnd()) {
+        attribute.floats.push_back(packed.readFixed32Float());
+      }
+    } else if (field == 8 && wireType == 0) {
+      attribute.ints.push_back(static_cast<int64_t>(reader.readVarint()));
+    } else if (field == 8 && wireType == 2) {
+      auto packed = reader.readLengthDelimited();
+      while (!packed.atEnd()) {
+        attribute.ints.push_back(static_cast<int64_t>(packed.readVarint()));
+      }
+    } else if (field == 9 && wireType == 2) {
+      attribute.strings.push_back(reader.readString());
+    } else {
+      reader.skip(wireType);
+    }
+  }
+  attributes[name] = std::move(attribute);
+}
+
+/// Looks for the first tree-ensemble node in the graph of an ONNX model (ModelProto.graph.node)
+/// \return true if a TreeEnsembleClassifier or TreeEnsembleRegressor node was found
+bool findTreeEnsembleNode(ProtoReader model, std::string& opType, AttributeMap& attributes)
+{
+  while (!model.atEnd()) {
+    const uint64_t key = model.readVarint();
+    if ((key >> 3) != 7 || (key & 0x7) != 2) { // ModelProto.graph
+      model.skip(key & 0x7);
+      continue;
+    }
+    auto graph = model.readLengthDelimited();
+    while (!graph.atEnd()) {
+      const uint64_t graphKey = graph.readVarint();
+      if ((graphKey >> 3) != 1 || (graphKey & 0x7) != 2) { // GraphProto.node
+        graph.skip(graphKey & 0x7);
+        continue;
+      }
+      auto node = graph.readLengthDelimited();
+      std::string thisOpType;
+      AttributeMap thisAttributes;
+      while (!node.atEnd()) {
+        const uint64_t nodeKey = node.readVarint();
+        const int field = nodeKey >> 3;
+        const int wireType = nodeKey & 0x7;
+        if (field == 4 && wireType == 2) { // NodeProto.op_type
+          thisOpType = node.readString();
+        } else if (field == 5 && wireType == 2) { // NodeProto.attribute
+          readAttribute(node.readLengthDelimited(), thisAttributes);
+        } else {
+          node.skip(wireType);
+        }
+      }
+      if (thisOpType == "TreeEnsembleClassifier" || thisOpType == "TreeEnsembleRegressor") {
+        opType = thisOpType;
+        attributes = std::move(thisAttributes);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+const Attribute& getAttribute(const AttributeMap& attributes, const std::string& name)
+{
+  static const Attribute empty{};
+  auto it = attributes.find(name);
+  return it != attributes.end() ? it->second : empty;
+}
+
+uint8_t getNodeMode(const std::string& mode)
+{
+  static const std::map<std::string, uint8_t> modes{
+    {"BRANCH_LEQ", TreeEnsembleModel::BranchLeq},
+    {"BRANCH_LT", TreeEnsembleModel::BranchLt},
+    {"BRANCH_GTE", TreeEnsembleModel::BranchGte},
+    {"BRANCH_GT", TreeEnsembleModel::BranchGt},
+    {"BRANCH_EQ", TreeEnsembleModel::BranchEq},
+    {"BRANCH_NEQ", TreeEnsembleModel::BranchNeq},
+    {"LEAF", TreeEnsembleModel::Leaf}};
+  auto it = modes.find(mode);
+  if (it == modes.end()) {
+    throw std::runtime_error("unsupported node mode " + mode);
+  }
+  return it->second;
+}
+
+uint8_t getCompareMask(const uint8_t mode, const bool missingTrue)
+{
+  uint8_t mask{0};
+  switch (mode) {
+    case TreeEnsembleModel::BranchLeq:
+      mask = TreeEnsembleModel::CompareLess | TreeEnsembleModel::CompareEqual;
+      break;
+    case TreeEnsembleModel::BranchLt:
+      mask = TreeEnsembleModel::CompareLess;
+      break;
+    case TreeEnsembleModel::BranchGte:
+      mask = TreeEnsembleModel::CompareGreater | TreeEnsembleModel::CompareEqual;
+      break;
+    case TreeEnsembleModel::BranchGt:
+      mask = TreeEnsembleModel::CompareGreater;
+      break;
+    case TreeEnsembleModel::BranchEq:
+      mask = TreeEnsembleModel::CompareEqual;
+      break;
+    case TreeEnsembleModel::BranchNeq: // NaN is different from any threshold
+      mask = TreeEnsembleModel::CompareLess | TreeEnsembleModel::CompareGreater | TreeEnsembleModel::CompareNaN;
+      break;
+    default:
+      break;
+  }
+  if (missingTrue && mode != TreeEnsembleModel::Leaf) {
+    mask |= TreeEnsembleModel::CompareNaN;
+  }
+  return mask;
+}
+
+/// Depth of the tree below a node, i.e. the maximum number of splits from the node to a leaf
+int32_t getDepth(const std::vector<TreeEnsembleModel::Node>& nodes, const int32_t root)
+{
+  int32_t depth{0};
+  std::vector<std::pair<int32_t, int32_t>> stack{{root, 0}};
+  while (!stack.empty()) {
+    const auto [iNode, level] = stack.back();
+    stack.pop_back();
+    const auto& node = nodes[iNode];
+    if (node.mode == TreeEnsembleModel::Leaf) {
+      depth = std::max(depth, level);
+      continue;
+    }
+    if (level >= static_cast<int32_t>(nodes.size())) {
+      throw std::runtime_error("cycle in the tree of node " + std::to_string(root));
+    }
+    stack.emplace_back(node.trueChild, level + 1);
+    stack.emplace_back(node.falseChild, level + 1);
+  }
+  return depth;
+}
+
+} // namespace
+
+bool TreeEnsembleModel::loadModel(const std::string& path)
+{
+  std::ifstream file(path, std::ios::binary);
+  if (!file.good()) {
+    LOG(error) << "Cannot open model file " << path;
+    return false;
+  }
+  const std::string content{std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+  return loadModelFromBuffer(content, path);
+}
+
+bool TreeEnsembleModel::loadModelFromBuffer(std::string_view content, const std::string& path)
+{
+  mNodes.clear();
+  mRoots.clear();
+  mDepths.clear();
+  mLeafWeights.clear();
+  mBaseValues.clear();
+
+  try {
+    std::string opType;
+    AttributeMap attributes;
+    if (!findTreeEnsembleNode(ProtoReader(content.data(), content.data() + content.size()), opType, attributes)) {
+      LOG(info) << "No tree-ensemble node found in " << path;
+      return false;
+    }
+    mIsClassifier = (opType == "TreeEnsembleClassifier");
+    const std::string prefix = mIsClassifier ? "class_" : "target_";
+
+    const auto& treeIds = getAttribute(attributes, "nodes_treeids").ints;
+    const auto& nodeIds = getAttribute(attributes, "nodes_nodeids").ints;
+    const auto& featureIds = getAttribute(attributes, "nodes_featureids").ints;
+    const auto& values = getAttribute(attributes, "nodes_values").floats;
+    const auto& modes = getAttribute(attributes, "nodes_modes").strings;
+    const auto& trueIds = getAttribute(attributes, "nodes_truenodeids").ints;
+    const auto& falseIds = getAttribute(attributes, "nodes_falsenodeids").ints;
+    const auto& missingTrue = getAttribute(attributes, "nodes_missing_value_tracks_true").ints;
+    const std::size_t nNodes = nodeIds.size();
+    if (nNodes == 0 || treeIds.size() != nNodes || featureIds.size() != nNodes || values.size() != nNodes || modes.size() != nNodes || trueIds.size() != nNodes || falseIds.size() != nNodes) {
+      LOG(error) << "Inconsistent node attributes in the tree ensemble of " << path << " (e.g. nodes_values stored as tensors are not supported)";
+      return false;
+    }
+
+    // flat index of each (tree, node) pair
+    std::map<std::pair<int64_t, int64_t>, int32_t> flatIndices;
+    for (std::size_t iNode = 0; iNode < nNodes; ++iNode) {
+      flatIndices[{treeIds[iNode], nodeIds[iNode]}] = iNode;
+    }
+    auto getFlatIndex = [&](const int64_t treeId, const int64_t nodeId) {
+      auto it = flatIndices.find({treeId, nodeId});
+      if (it == flatIndices.end()) {
+        throw std::runtime_error("reference to unknown node " + std::to_string(nodeId) + " of tree " + std::to_string(treeId));
+      }
+      return it->second;
+    };
+
+    mNodes.resize(nNodes);
+    std::vector<bool> isChild(nNodes, false);
+    mNFeatures = 0;
+    for (std::size_t iNode = 0; iNode < nNodes; ++iNode) {
+      Node& node = mNodes[iNode];
+      node.mode = getNodeMode(modes[iNode]);
+      node.value = values[iNode];
+      node.feature = featureIds[iNode];
+      node.compareMask = getCompareMask(node.mode, iNode < missingTrue.size() && missingTrue[iNode]);
+      if (node.mode != Leaf) {
+        node.trueChild = getFlatIndex(treeIds[iNode], trueIds[iNode]);
+        node.falseChild = getFlatIndex(treeIds[iNode], falseIds[iNode]);
+        isChild[node.trueChild] = true;
+        isChild[node.falseChild] = true;
+        mNFeatures = std::max(mNFeatures, node.feature + 1);
+      } else {
+        // leaves point to themselves, so that the traversal can run for a fixed number of steps
+        node.feature = 0;
+        node.trueChild = iNode;
+        node.falseChild = iNode;
+      }
+    }
+    for (std::size_t iNode = 0; iNode < nNodes; ++iNode) {
+      if (!isChild[iNode]) {
+        mRoots.push_back(iNode);
+        mDepths.push_back(getDepth(mNodes, iNode));
+      }
+    }
+
+    // leaf weights, grouped by leaf
+    const auto& weightTreeIds = getAttribute(attributes, prefix + "treeids").ints;
+    const auto& weightNodeIds = getAttribute(attributes, prefix + "nodeids").ints;
+    const auto& weightTargets = getAttribute(attributes, prefix + "ids").ints;
+    const auto& weights = getAttribute(attributes, prefix + "weights").floats;
+    const std::size_t nWeights = weights.size();
+    if (weightTreeIds.size() != nWeights || weightNodeIds.size() != nWeights || weightTargets.size() != nWeights) {
+      LOG(error) << "Inconsistent leaf attributes in the tree ensemble of " << path;
+      return false;
+    }
+    std::vector<std::vector<LeafWeight>> weightsPerNode(nNodes);
+    mNScores = 0;
+    mWeightsArePositive = true;
+    for (std::size_t iWeight = 0; iWeight < nWeights; ++iWeight) {
+      const int32_t iNode = getFlatIndex(weightTreeIds[iWeight], weightNodeIds[iWeight]);
+      weightsPerNode[iNode].push_back({static_cast<int32_t>(weightTargets[iWeight]), weights[iWeight]});
+      mNScores = std::max(mNScores, static_cast<int>(weightTargets[iWeight]) + 1);
+      mWeightsArePositive = mWeightsArePositive && weights[iWeight] >= 0.f;
+    }
+    for (std::size_t iNode = 0; iNode < nNodes; ++iNode) {
+      mNodes[iNode].leafOffset = mLeafWeights.size();
+      mNodes[iNode].leafCount = weightsPerNode[iNode].size();
+      mLeafWeights.insert(mLeafWeights.end(), weightsPerNode[iNode].begin(), weightsPerNode[iNode].end());
+    }
+
+    if (mIsClassifier) {
+      const auto nLabelsInt = getAttribute(attributes, "classlabels_int64s").ints.size();
+      const auto nLabelsString = getAttribute(attributes, "classlabels_strings").strings.size();
+      mNOutputs = std::max(nLabelsInt, nLabelsString);
+      mAverage = false;
+    } else {
+      mNOutputs = getAttribute(attributes, "n_targets").i;
+      const auto& aggregate = getAttribute(attributes, "aggregate_function").s;
+      if (!aggregate.empty() && aggregate != "SUM" && aggregate != "AVERAGE") {
+        LOG(error) << "Unsupported aggregate function " << aggregate << " in " << path;
+        return false;
+      }
+      mAverage = (aggregate == "AVERAGE");
+    }
+    mNScores = std::max(mNScores, mIsClassifier && mNOutputs == 2 ? 1 : mNOutputs);
+    mBaseValues = getAttribute(attributes, "base_values").floats;
+
+    const auto& postTransform = getAttribute(attributes, "post_transform").s;
+    if (postTransform.empty() || postTransform == "NONE") {
+      mPostTransform = None;
+    } else if (postTransform == "LOGISTIC") {
+      mPostTransform = Logistic;
+    } else if (postTransform == "SOFTMAX") {
+      mPostTransform = Softmax;
+    } else if (postTransform == "SOFTMAX_ZERO") {
+      mPostTransform = SoftmaxZero;
+    } else {
+      LOG(error) << "Unsupported post transform " << postTransform << " in " << path;
+      return false;
+    }
+  } catch (const std::exception& exception) {
+    LOG(error) << "Error parsing the tree ensemble of " << path << ": " << exception.what();
+    mRoots.clear();
+    mDepths.clear();
+    return false;
+  }
+
+  LOG(info) << "Loaded tree ensemble from " << path << ": " << mRoots.size() << " trees, " << mNodes.size() << " nodes, " << mNOutputs << " outputs";
+  return true;
+}
+
+void TreeEnsembleModel::generateValidationInput(std::mt19937& generator, std::vector<float>& input, const std::size_t nFeatures) const
+{
+  std::uniform_int_distribution<std::size_t> nodeDistribution(0, mNodes.size() - 1);
+  std::uniform_real_distribution<float> smearDistribution(-0.01f, 0.01f);
+  input.assign(nFeatures, 0.f);
+  // each feature is set close to the threshold of a random split on it, so that both branches get tested
+  for (std::size_t iTry = 0; iTry < 16 * nFeatures; ++iTry) {
+    const Node& node = mNodes[nodeDistribution(generator)];
+    if (node.mode == Leaf || static_cast<std::size_t>(node.feature) >= nFeatures) {
+      continue;
+    }
+    input[node.feature] = node.value * (1.f + smearDistribution(generator)) + smearDistribution(generator);
+  }
+}
+
+} // namespace ml
+
+} // namespace o2
@@ -0,0 +1,266 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     TreeEnsembleModel.h
+///
+/// \brief    Native evaluator of tree-ensemble (BDT) models stored in ONNX format
+///
+/// The TreeEnsembleClassifier / TreeEnsembleRegressor node of the ONNX graph is read
+/// directly from the model file and flattened into a contiguous node array, which is then
+/// traversed tree by tree for a whole batch of candidates. This avoids the per-call dispatch
+/// overhead of ONNX Runtime for the small inputs typical of analysis BDTs.
+///
+/// The traversal is predicated: leaves point to themselves, so that every tree is walked for
+/// a fixed number of steps (its depth) by blocks of candidates in lockstep, and the split test
+/// is a bit mask of comparisons with the child chosen arithmetically, without data-dependent
+/// branches. The inner loop over the candidates of a block is left to the compiler to vectorise.
+///
+
+#ifndef TOOLS_ML_TREEENSEMBLEMODEL_H_
+#define TOOLS_ML_TREEENSEMBLEMODEL_H_
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace o2
+{
+
+namespace ml
+{
+
+class TreeEnsembleModel
+{
+ public:
+  enum NodeMode : uint8_t {
+    BranchLeq = 0,
+    BranchLt,
+    BranchGte,
+    BranchGt,
+    BranchEq,
+    BranchNeq,
+    Leaf
+  };
+
+  enum PostTransform : uint8_t {
+    None = 0,
+    Logistic,
+    Softmax,
+    SoftmaxZero
+  };
+
+  // comparisons of the input with the threshold for which the condition of a split is true
+  enum CompareBits : uint8_t {
+    CompareLess = 1 << 0,
+    CompareEqual = 1 << 1,
+    CompareGreater = 1 << 2,
+    CompareNaN = 1 << 3
+  };
+
+  struct Node {
+    float value = 0.f;          // threshold of the split
+    int32_t feature = 0;        // index of the input feature tested by the split
+    int32_t trueChild = -1;     // flat index of the child followed if the condition is true (the node itself for leaves)
+    int32_t falseChild = -1;    // flat index of the child followed if the condition is false (the node itself for leaves)
+    int32_t leafOffset = 0;     // first leaf weight of the node in mLeafWeights (leaves only)
+    int32_t leafCount = 0;      // number of leaf weights of the node (leaves only)
+    uint8_t mode = Leaf;        // NodeMode of the split
+    uint8_t compareMask = 0;    // CompareBits of the split
+  };
+
+  struct LeafWeight {
+    int32_t target = 0;  // index of the class (or regression target) the weight is added to
+    float weight = 0.f;  // weight of the leaf
+  };
+
+  TreeEnsembleModel() = default;
+  ~TreeEnsembleModel() = default;
+
+  /// Load the tree ensemble from an ONNX model file
+  /// \param path is the path to the .onnx file
+  /// \return false if the file does not contain a supported tree-ensemble node
+  bool loadModel(const std::string& path);
+
+  /// Load the tree ensemble from the content of an ONNX model file
+  /// \param content is the content of the .onnx file
+  /// \param path is the name of the model, used for logging
+  /// \return false if the content does not contain a supported tree-ensemble node
+  bool loadModelFromBuffer(std::string_view content, const std::string& path);
+
+  bool isLoaded() const { return !mRoots.empty(); }
+  int getNumOutputs() const { return mNOutputs; }
+  int getNumFeatures() const { return mNFeatures; }
+  std::size_t getNumTrees() const { return mRoots.size(); }
+  std::size_t getNumNodes() const { return mNodes.size(); }
+
+  /// Evaluate the model on a batch of candidates
+  /// \param input flattened input features, nRows x nFeatures
+  /// \param nRows is the number of candidates
+  /// \param nFeatures is the number of features of each candidate
+  /// \param output filled with the flattened model output, nRows x getNumOutputs()
+  /// \note The method is reentrant, a model can be shared by several threads
+  template <typename TIn, typename TOut>
+  void evaluate(const TIn* input, const std::size_t nRows, const std::size_t nFeatures, TOut* output) const
+  {
+    std::vector<float> scores(BlockSize * mNScores);
+    std::array<int32_t, BlockSize> nodes{};
+    for (std::size_t iFirst = 0; iFirst < nRows; iFirst += BlockSize) {
+      const std::size_t nBlockRows = std::min(BlockSize, nRows - iFirst);
+      const TIn* blockInput = input + iFirst * nFeatures;
+      std::fill(scores.begin(), scores.end(), 0.f);
+      // trees in the outer loop to keep the node array of each tree in cache for the whole block
+      for (std::size_t iTree = 0; iTree < mRoots.size(); ++iTree) {
+        nodes.fill(mRoots[iTree]);
+        for (int32_t iLevel = 0; iLevel < mDepths[iTree]; ++iLevel) {
+          for (std::size_t iRow = 0; iRow < nBlockRows; ++iRow) {
+            const Node& node = mNodes[nodes[iRow]];
+            const int32_t isTrueChild = isTrue(node, static_cast<float>(blockInput[iRow * nFeatures + node.feature]));
+            nodes[iRow] = node.falseChild + isTrueChild * (node.trueChild - node.falseChild);
+          }
+        }
+        for (std::size_t iRow = 0; iRow < nBlockRows; ++iRow) {
+          const Node& leaf = mNodes[nodes[iRow]];
+          float* rowScores = scores.data() + iRow * mNScores;
+          for (int32_t iWeight = leaf.leafOffset; iWeight < leaf.leafOffset + leaf.leafCount; ++iWeight) {
+            rowScores[mLeafWeights[iWeight].target] += mLeafWeights[iWeight].weight;
+          }
+        }
+      }
+      for (std::size_t iRow = 0; iRow < nBlockRows; ++iRow) {
+        finalize(scores.data() + iRow * mNScores, output + (iFirst + iRow) * mNOutputs);
+      }
+    }
+  }
+
+  /// Generate a random input close to the split thresholds, used to validate the evaluator against ONNX Runtime
+  /// \param generator is the random-number generator
+  /// \param input is filled with nFeatures values
+  /// \param nFeatures is the number of features of the model input
+  void generateValidationInput(std::mt19937& generator, std::vector<float>& input, const std::size_t nFeatures) const;
+
+ private:
+  std::vector<Node> mNodes;              // flattened nodes of all trees
+  std::vector<int32_t> mRoots;           // flat index of the root node of each tree
+  std::vector<int32_t> mDepths;          // depth of each tree, number of steps of its traversal
+  std::vector<LeafWeight> mLeafWeights;  // flattened leaf weights of all leaves
+  std::vector<float> mBaseValues;        // base values added to the aggregated scores
+  int mNScores = 0;                      // number of aggregated scores
+  int mNOutputs = 0;                     // number of outputs (classes or regression targets)
+  int mNFeatures = 0;                    // number of input features used by the splits
+  bool mIsClassifier = true;             // classifier or regressor
+  bool mAverage = false;                 // average instead of sum of the tree outputs (regressor only)
+  bool mWeightsArePositive = true;       // all leaf weights positive, used for the binary-classification output
+  uint8_t mPostTransform = None;         // transformation applied to the aggregated scores
+
+  static constexpr std::size_t BlockSize = 16; // number of candidates traversed in lockstep
+
+  /// Condition of a split, evaluated without branches
+  static int32_t isTrue(const Node& node, const float value)
+  {
+    const uint32_t mask = node.compareMask;
+    const uint32_t result = (static_cast<uint32_t>(value < node.value) & mask) |
+                            ((static_cast<uint32_t>(value == node.value) << 1) & mask) |
+                            ((static_cast<uint32_t>(value > node.value) << 2) & mask) |
+                            ((static_cast<uint32_t>(std::isnan(value)) << 3) & mask);
+    return result != 0;
+  }
+
+  template <typename TOut>
+  void finalize(float* scores, TOut* output) const;
+
+  static float computeLogistic(const float value)
+  {
+    const float v = 1.f / (1.f + std::exp(-std::abs(value)));
+    return value < 0 ? 1.f - v : v;
+  }
+};
+
+template <typename TOut>
+void TreeEnsembleModel::finalize(float* scores, TOut* output) const
+{
+  if (mAverage && !mRoots.empty()) {
+    for (int iScore = 0; iScore < mNScores; ++iScore) {
+      scores[iScore] /= static_cast<float>(mRoots.size());
+    }
+  }
+
+  // binary classification with a single score: expand to two classes as done by ONNX Runtime
+  if (mIsClassifier && mNScores == 1 && mNOutputs == 2) {
+    float score = scores[0];
+    if (mBaseValues.size() == 2) {
+      score += mBaseValues[1];
+    } else if (mBaseValues.size() == 1) {
+      score += mBaseValues[0];
+    }
+    if (mWeightsArePositive) {
+      output[0] = static_cast<TOut>(1.f - score);
+      output[1] = static_cast<TOut>(score);
+    } else if (mPostTransform == Logistic) {
+      output[0] = static_cast<TOut>(computeLogistic(-score));
+      output[1] = static_cast<TOut>(computeLogistic(score));
+    } else {
+      output[0] = static_cast<TOut>(-score);
+      output[1] = static_cast<TOut>(score);
+    }
+    return;
+  }
+
+  if (mBaseValues.size() == static_cast<std::size_t>(mNScores)) {
+    for (int iScore = 0; iScore < mNScores; ++iScore) {
+      scores[iScore] += mBaseValues[iScore];
+    }
+  }
+
+  switch (mPostTransform) {
+    case Logistic:
+      for (int iScore = 0; iScore < mNScores; ++iScore) {
+        scores[iScore] = computeLogistic(scores[iScore]);
+      }
+      break;
+    case Softmax:
+    case SoftmaxZero: {
+      float maxScore = scores[0];
+      for (int iScore = 1; iScore < mNScores; ++iScore) {
+        maxScore = std::max(maxScore, scores[iScore]);
+      }
+      float sum{0.f};
+      for (int iScore = 0; iScore < mNScores; ++iScore) {
+        if (mPostTransform == SoftmaxZero && scores[iScore] == 0.f) {
+          continue;
+        }
+        scores[iScore] = std::exp(scores[iScore] - maxScore);
+        sum += scores[iScore];
+      }
+      for (int iScore = 0; iScore < mNScores; ++iScore) {
+        scores[iScore] = sum > 0.f ? scores[iScore] / sum : 0.f;
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  for (int iOutput = 0; iOutput < mNOutputs; ++iOutput) {
+    output[iOutput] = static_cast<TOut>(iOutput < mNScores ? scores[iOutput] : 0.f);
+  }
+}
+
+} // namespace ml
+
+} // namespace o2
+
+#endif // TOOLS_ML_TREEENSEMBLEMODEL_H_
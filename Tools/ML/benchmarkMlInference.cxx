@@ -0,0 +1,199 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+
+///
+/// \file     benchmarkMlInference.cxx
+///
+/// \brief    Standalone benchmark of the ML inference stack (OnnxModel, native tree-ensemble evaluator)
+///
+/// Each model is evaluated on random inputs for all combinations of batch size, number of
+/// threads, optimization level and backend. One JSON object per configuration is written to
+/// the report file, e.g.
+///
+///   o2-bench-ml-inference --models bdtD0.onnx,pidTPC.onnx --batch-sizes 1,64,1024 --threads 1,4 --output report.json
+///
+
+#include "Tools/ML/TreeEnsembleModel.h"
+#include "Tools/ML/model.h"
+
+#include <Framework/Logger.h>
+
+#include <boost/program_options.hpp> // IWYU pragma: keep
+#include <boost/program_options/options_description.hpp>
+#include <boost/program_options/value_semantic.hpp>
+#include <boost/program_options/variables_map.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bpo = boost::program_options;
+
+namespace
+{
+
+struct BenchmarkResult {
+  std::string model;
+  std::string backend;
+  std::size_t batchSize = 0;
+  int threads = 0;
+  bool optimizations = false;
+  std::size_t iterations = 0;
+  double meanLatency = 0.; // microseconds per call
+  double p50Latency = 0.;  // microseconds per call
+  double p99Latency = 0.;  // microseconds per call
+  double throughput = 0.;  // rows per second
+};
+
+template <typename T>
+std::vector<T> parseList(const std::string& list)
+{
+  std::vector<T> values;
+  std::stringstream ss(list);
+  std::string token;
+  while (std::getline(ss, token, ',')) {
+    if (token.empty()) {
+      continue;
+    }
+    std::stringstream tokenStream(token);
+    T value;
+    tokenStream >> value;
+    values.push_back(value);
+  }
+  return values;
+}
+
+/// Times the evaluation function and fills latency percentiles and throughput
+template <typename F>
+void measure(F&& evaluate, const std::size_t iterations, const std::size_t warmUpIterations, BenchmarkResult& result)
+{
+  for (std::size_t i = 0; i < warmUpIterations; ++i) {
+    evaluate();
+  }
+  std::vector<double> latencies(iterations);
+  for (std::size_t i = 0; i < iterations; ++i) {
+    const auto start = std::chrono::steady_clock::now();
+    evaluate();
+    latencies[i] = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+  }
+  double total = 0.;
+  for (const auto& latency : latencies) {
+    total += latency;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  result.iterations = iterations;
+  result.meanLatency = total / iterations;
+  result.p50Latency = latencies[iterations / 2];
+  result.p99Latency = latencies[std::min(iterations - 1, static_cast<std::size_t>(0.99 * iterations))];
+  result.throughput = total > 0. ? 1.e6 * iterations * result.batchSize / total : 0.;
+}
+
+std::string toJson(const BenchmarkResult& result)
+{
+  std::stringstream ss;
+  ss << "{\"model\": \"" << result.model << "\", \"backend\": \"" << result.backend << "\", \"batchSize\": " << result.batchSize
+     << ", \"threads\": " << result.threads << ", \"optimizations\": " << (result.optimizations ? "true" : "false")
+     << ", \"iterations\": " << result.iterations << ", \"meanLatencyUs\": " << result.meanLatency << ", \"p50LatencyUs\": " << result.p50Latency
+     << ", \"p99LatencyUs\": " << result.p99Latency << ", \"rowsPerSecond\": " << result.throughput << "}";
+  return ss.str();
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+  bpo::options_description options("Allowed options");
+  options.add_options()(
+    "help,h", "Print this help")(
+    "models,m", bpo::value<std::string>()->default_value(""), "Comma-separated list of ONNX model files")(
+    "batch-sizes,b", bpo::value<std::string>()->default_value("1,16,256,4096"), "Comma-separated list of batch sizes")(
+    "threads,t", bpo::value<std::string>()->default_value("1"), "Comma-separated list of intra-op thread numbers")(
+    "optimizations,O", bpo::value<std::string>()->default_value("0,1"), "Comma-separated list of optimization switches")(
+    "backends", bpo::value<std::string>()->default_value("onnx,tree"), "Comma-separated list of backends (onnx, tree)")(
+    "rows,n", bpo::value<std::size_t>()->default_value(100000), "Approximate number of rows evaluated per configuration")(
+    "seed", bpo::value<unsigned int>()->default_value(42), "Seed of the random inputs")(
+    "output,o", bpo::value<std::string>()->default_value("mlInferenceBenchmark.json"), "Output report (one JSON object per line)");
+
+  bpo::variables_map arguments;
+  try {
+    bpo::store(parse_command_line(argc, argv, options), arguments);
+    bpo::notify(arguments);
+  } catch (const bpo::error& e) {
+    LOG(error) << e.what();
+    std::cout << options << std::endl;
+    return 1;
+  }
+  if (arguments.count("help") || arguments["models"].as<std::string>().empty()) {
+    std::cout << options << std::endl;
+    return arguments.count("help") ? 0 : 1;
+  }
+
+  const auto models = parseList<std::string>(arguments["models"].as<std::string>());
+  const auto batchSizes = parseList<std::size_t>(arguments["batch-sizes"].as<std::string>());
+  const auto threads = parseList<int>(arguments["threads"].as<std::string>());
+  const auto optimizations = parseList<int>(arguments["optimizations"].as<std::string>());
+  const auto backends = parseList<std::string>(arguments["backends"].as<std::string>());
+  const auto nRows = arguments["rows"].as<std::size_t>();
+  std::mt19937 generator(arguments["seed"].as<unsigned int>());
+  std::uniform_real_distribution<float> distribution(0.f, 1.f);
+
+  std::ofstream report(arguments["output"].as<std::string>());
+  std::vector<BenchmarkResult> results;
+  for (const auto& modelPath : models) {
+    for (const auto& backend : backends) {
+      for (const auto& optimization : optimizations) {
+        for (const auto& nThreads : threads) {
+          // the tree evaluator does not depend on the ONNX Runtime settings
+          if (backend == "tree" && (optimization != optimizations.front() || nThreads != threads.front())) {
+            continue;
+          }
+          o2::ml::OnnxModel model;
+          model.initModel(modelPath, optimization, nThreads);
+          o2::ml::TreeEnsembleModel treeModel;
+          if (backend == "tree" && !treeModel.loadModel(modelPath)) {
+            LOG(warning) << "Model " << modelPath << " is not a supported tree ensemble, skipping the tree backend";
+            continue;
+          }
+          const std::size_t nFeatures = model.getNumInputNodes();
+          for (const auto& batchSize : batchSizes) {
+            std::vector<float> input(batchSize * nFeatures);
+            for (auto& value : input) {
+              value = distribution(generator);
+            }
+            std::vector<float> output(batchSize * std::max(treeModel.getNumOutputs(), 1));
+            BenchmarkResult result{modelPath, backend, batchSize, nThreads, optimization != 0};
+            const std::size_t iterations = std::max<std::size_t>(10, nRows / batchSize);
+            if (backend == "tree") {
+              measure([&]() { treeModel.evaluate(input.data(), batchSize, nFeatures, output.data()); }, iterations, 2, result);
+            } else if (backend == "onnx") {
+              measure([&]() { model.evalModel(input, output); }, iterations, 2, result);
+            } else {
+              LOG(fatal) << "Unknown backend " << backend;
+            }
+            LOGP(info, "{} [{}] batch {} threads {} optimizations {}: {:.1f} us/call (p99 {:.1f} us), {:.3g} rows/s",
+                 modelPath, backend, batchSize, nThreads, optimization, result.meanLatency, result.p99Latency, result.throughput);
+            report << toJson(result) << std::endl;
+            results.push_back(result);
+          }
+        }
+      }
+    }
+  }
+  LOG(info) << "Wrote " << results.size() << " benchmark results to " << arguments["output"].as<std::string>();
+  return 0;
+} // main
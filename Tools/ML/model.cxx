@@ -19,19 +19,30 @@
 
 #include "Tools/ML/model.h"
 
+#include <Framework/HistogramRegistry.h>
 #include <Framework/Logger.h>
 
+#include <TH1.h>
 #include <TSystem.h>
 
 #include <onnxruntime_c_api.h>
 #include <onnxruntime_cxx_api.h>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
 #include <cstddef>
 #include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iterator>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <string_view>
+#include <utility>
 #include <vector>
 
 namespace o2
@@ -40,6 +51,100 @@ namespace o2
 namespace ml
 {
 
+void OnnxModelTelemetry::record(const double latency, const uint64_t rows, const bool isAllocating)
+{
+  ++nCalls;
+  nRows += rows;
+  nAllocatingCalls += isAllocating;
+  totalLatency += latency;
+  const int latencyBin = latency > MinLatency ? static_cast<int>(8. * std::log10(latency / MinLatency)) : 0;
+  ++latencyCounts[std::min(latencyBin, NLatencyBins - 1)];
+  const int batchSizeBin = rows > 0 ? static_cast<int>(std::log2(static_cast<double>(rows))) : 0;
+  ++batchSizeCounts[std::min(batchSizeBin, NBatchSizeBins - 1)];
+}
+
+double OnnxModelTelemetry::getLatencyQuantile(const double quantile) const
+{
+  const double threshold = quantile * nCalls;
+  uint64_t cumulative = 0;
+  for (int iBin = 0; iBin < NLatencyBins; ++iBin) {
+    cumulative += latencyCounts[iBin];
+    if (cumulative > 0 && cumulative >= threshold) {
+      return MinLatency * std::pow(10., (iBin + 1) / 8.);
+    }
+  }
+  return 0.;
+}
+
+void OnnxModelTelemetry::print(const std::string& name) const
+{
+  LOGP(info, "ONNX model {}: {} calls, {} rows, {} allocating calls, mean latency {:.1f} us, p50 < {:.1f} us, p99 < {:.1f} us",
+       name, nCalls, nRows, nAllocatingCalls, nCalls > 0 ? totalLatency / nCalls : 0., getLatencyQuantile(0.5), getLatencyQuantile(0.99));
+}
+
+OnnxSessionRegistry& OnnxSessionRegistry::instance()
+{
+  static OnnxSessionRegistry registry;
+  return registry;
+}
+
+void OnnxSessionRegistry::setGlobalIntraOpThreads(const int threads)
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (mEnv) {
+    LOG(warning) << "ONNX environment already created, the global thread pool setting is ignored";
+    return;
+  }
+  mGlobalIntraOpThreads = threads;
+}
+
+std::shared_ptr<Ort::Env> OnnxSessionRegistry::getEnv()
+{
+  std::lock_guard<std::mutex> lock(mMutex);
+  if (!mEnv) {
+    if (mGlobalIntraOpThreads > 0) {
+      Ort::ThreadingOptions threadingOptions;
+      threadingOptions.SetGlobalIntraOpNumThreads(mGlobalIntraOpThreads);
+      threadingOptions.SetGlobalInterOpNumThreads(1);
+      mEnv = std::make_shared<Ort::Env>(threadingOptions, ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+      LOG(info) << "Created ONNX environment with a global pool of " << mGlobalIntraOpThreads << " intra-op threads";
+    } else {
+      mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
+    }
+  }
+  return mEnv;
+}
+
+std::shared_ptr<Ort::Session> OnnxSessionRegistry::getSession(std::shared_ptr<const std::string>& content, const std::string& name, Ort::SessionOptions& options, const std::string& optionsKey)
+{
+  const std::string key = std::to_string(std::hash<std::string>{}(*content)) + "_" + std::to_string(content->size()) + "_" + optionsKey;
+
+  auto env = getEnv();
+  std::lock_guard<std::mutex> lock(mMutex);
+  auto [first, last] = mSessions.equal_range(key);
+  for (auto entry = first; entry != last;) {
+    auto session = entry->second.session.lock();
+    if (!session) {
+      entry = mSessions.erase(entry);
+      continue;
+    }
+    if (*entry->second.content == *content) {
+      content = entry->second.content;
+      ++mNSessionsReused;
+      LOG(info) << "Reusing ONNX session for model " << name;
+      return session;
+    }
+    ++entry;
+  }
+  if (mGlobalIntraOpThreads > 0) {
+    options.DisablePerSessionThreads();
+  }
+  auto session = std::make_shared<Ort::Session>(*env, content->data(), content->size(), options);
+  mSessions.emplace(key, SessionEntry{content, session});
+  ++mNSessionsCreated;
+  return session;
+}
+
 std::string OnnxModel::printShape(const std::vector<int64_t>& v)
 {
   std::stringstream ss("");
@@ -49,6 +154,31 @@ std::string OnnxModel::printShape(const std::vector<int64_t>& v)
   return ss.str();
 }
 
+std::vector<Ort::Value> OnnxModel::runSession(std::vector<Ort::Value>& input)
+{
+  LOG(debug) << "Input tensor shape: " << printShape(input[0].GetTensorTypeAndShapeInfo().GetShape());
+  // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
+
+  const Ort::RunOptions runOptions;
+  const auto start = std::chrono::steady_clock::now();
+  auto outputTensors = mSession->Run(runOptions, mInputNamesChar.data(), input.data(), input.size(), mOutputNamesChar.data(), mOutputNamesChar.size());
+  if (mTelemetryEnabled) {
+    const auto inputShape = input[0].GetTensorTypeAndShapeInfo().GetShape();
+    recordTelemetry(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(), inputShape.empty() ? 1 : inputShape[0], true);
+  }
+  LOG(debug) << "Number of output tensors: " << outputTensors.size();
+  if (outputTensors.size() != mOutputNames.size()) {
+    LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
+  }
+  for (std::size_t i = 0; i < outputTensors.size(); i++) {
+    LOG(debug) << "Output tensor shape: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape());
+    if ((outputTensors[i].GetTensorTypeAndShapeInfo().GetShape() != mOutputShapes[i]) && (mOutputShapes[i][0] != -1)) {
+      LOG(fatal) << "Shape of tensor " << i << " does not agree with model specification! Output: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape()) << " model: " << printShape(mOutputShapes[i]);
+    }
+  }
+  return outputTensors;
+}
+
 bool OnnxModel::checkHyperloop(const bool verbose)
 {
   /// Testing hyperloop core settings
@@ -70,12 +200,29 @@ bool OnnxModel::checkHyperloop(const bool verbose)
 }
 
 void OnnxModel::initModel(const std::string& localPath, const bool enableOptimizations, const int threads, const uint64_t from, const uint64_t until)
+{
+  std::ifstream file(localPath, std::ios::binary);
+  if (!file.good()) {
+    LOG(fatal) << "Cannot open ONNX model file " << localPath;
+  }
+  auto content = std::make_shared<const std::string>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  initModelFromContent(std::move(content), localPath, enableOptimizations, threads, from, until);
+}
+
+void OnnxModel::initModelFromBuffer(std::string_view content, const std::string& name, const bool enableOptimizations, const int threads, const uint64_t from, const uint64_t until)
+{
+  initModelFromContent(std::make_shared<const std::string>(content), name, enableOptimizations, threads, from, until);
+}
+
+void OnnxModel::initModelFromContent(std::shared_ptr<const std::string> content, const std::string& name, const bool enableOptimizations, const int threads, const uint64_t from, const uint64_t until)
 {
 
   assert(from <= until);
 
   LOG(info) << "--- ONNX-ML model ---";
-  modelPath = localPath;
+  modelPath = name;
+  mModelContent = std::move(content);
+  mEnableOptimizations = enableOptimizations;
   activeThreads = threads;
 
   /// Running on Hyperloop
@@ -88,8 +235,15 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
     sessionOptions.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_EXTENDED);
   }
 
-  mEnv = std::make_shared<Ort::Env>(ORT_LOGGING_LEVEL_WARNING, "onnx-model");
-  mSession = std::make_shared<Ort::Session>(*mEnv, modelPath.c_str(), sessionOptions);
+  auto& registry = OnnxSessionRegistry::instance();
+  mEnv = registry.getEnv();
+  mSession = registry.getSession(mModelContent, modelPath, sessionOptions, getOptionsKey());
+
+  mInputNames.clear();
+  mInputShapes.clear();
+  mOutputNames.clear();
+  mOutputShapes.clear();
+  mIoBinding.reset();
 
   Ort::AllocatorWithDefaultOptions const tmpAllocator;
   for (std::size_t i = 0; i < mSession->GetInputCount(); ++i) {
@@ -104,6 +258,13 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
   for (std::size_t i = 0; i < mSession->GetOutputCount(); ++i) {
     mOutputShapes.emplace_back(mSession->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
   }
+  mInputNamesChar.resize(mInputNames.size());
+  std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(mInputNamesChar),
+                 [&](const std::string& str) { return str.c_str(); });
+  mOutputNamesChar.resize(mOutputNames.size());
+  std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(mOutputNamesChar),
+                 [&](const std::string& str) { return str.c_str(); });
+
   LOG(info) << "Input Nodes:";
   for (std::size_t i = 0; i < mInputNames.size(); i++) {
     LOG(info) << "\t" << mInputNames[i] << " : " << printShape(mInputShapes[i]);
@@ -122,6 +283,119 @@ void OnnxModel::initModel(const std::string& localPath, const bool enableOptimiz
   LOG(info) << "--- Model initialized! ---";
 }
 
+void OnnxModel::resetSession()
+{
+  // the model file may not exist on disk (model loaded from memory), the session is rebuilt from the held content
+  mSession = OnnxSessionRegistry::instance().getSession(mModelContent, modelPath, sessionOptions, getOptionsKey());
+  mIoBinding.reset();
+}
+
+void OnnxModel::warmUp()
+{
+  std::vector<float> dummyInput(getNumInputNodes(), 1.);
+  std::vector<float> dummyOutput;
+  evalModel(dummyInput, dummyOutput);
+}
+
+void OnnxModel::enableIoBinding(const std::size_t maxBatchSize)
+{
+  if (mInputNames.size() != 1) {
+    LOG(fatal) << "IO binding is only supported for models with one input, this model has " << mInputNames.size();
+  }
+  if (mInputShapes[0].size() < 2 || mOutputShapes.back().size() < 2) {
+    LOG(fatal) << "IO binding requires inputs and outputs with a batch dimension and at least one feature dimension, the model has input " << printShape(mInputShapes[0]) << " and output " << printShape(mOutputShapes.back());
+  }
+  mMaxBatchSize = maxBatchSize;
+  mBoundRows = 0;
+  // number of output values per row, product of the dimensions after the batch dimension
+  mBoundOutputShape.assign(mOutputShapes.back().begin() + 1, mOutputShapes.back().end());
+  mBoundOutputRowSize = 1;
+  for (const auto dim : mBoundOutputShape) {
+    if (dim <= 0) {
+      LOG(fatal) << "IO binding requires a fixed output shape after the batch dimension, the model has " << printShape(mOutputShapes.back());
+    }
+    mBoundOutputRowSize *= dim;
+  }
+  mBoundInput.assign(mMaxBatchSize * getNumInputNodes(), 0.f);
+  mBoundOutput.assign(mMaxBatchSize * mBoundOutputRowSize, 0.f);
+  mIoBinding = std::make_unique<Ort::IoBinding>(*mSession);
+  LOG(info) << "IO binding enabled for batches of up to " << mMaxBatchSize << " rows";
+}
+
+const float* OnnxModel::evalModelBound(const std::size_t nRows)
+{
+  if (!mIoBinding) {
+    LOG(fatal) << "IO binding not enabled! Call enableIoBinding after initModel.";
+  }
+  if (nRows > mMaxBatchSize) {
+    LOG(fatal) << "Number of rows (" << nRows << ") larger than the maximum batch size of the IO binding (" << mMaxBatchSize << ")";
+  }
+
+  // tensors are only rebound when the number of rows changes
+  const bool isRebinding = (nRows != mBoundRows);
+  if (isRebinding) {
+    Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    const int64_t nInputNodes = getNumInputNodes();
+    std::vector<int64_t> inputShape{static_cast<int64_t>(nRows), nInputNodes};
+    std::vector<int64_t> outputShape{static_cast<int64_t>(nRows)};
+    outputShape.insert(outputShape.end(), mBoundOutputShape.begin(), mBoundOutputShape.end());
+    mBoundInputTensor = Ort::Value::CreateTensor<float>(memInfo, mBoundInput.data(), nRows * nInputNodes, inputShape.data(), inputShape.size());
+    mBoundOutputTensor = Ort::Value::CreateTensor<float>(memInfo, mBoundOutput.data(), nRows * mBoundOutputRowSize, outputShape.data(), outputShape.size());
+    mIoBinding->ClearBoundInputs();
+    mIoBinding->ClearBoundOutputs();
+    mIoBinding->BindInput(mInputNamesChar[0], mBoundInputTensor);
+    // only the last output is read back, the other ones are allocated by the runtime
+    for (std::size_t i = 0; i + 1 < mOutputNamesChar.size(); i++) {
+      mIoBinding->BindOutput(mOutputNamesChar[i], memInfo);
+    }
+    mIoBinding->BindOutput(mOutputNamesChar.back(), mBoundOutputTensor);
+    mBoundRows = nRows;
+  }
+
+  try {
+    const auto start = std::chrono::steady_clock::now();
+    mSession->Run(Ort::RunOptions{nullptr}, *mIoBinding);
+    if (mTelemetryEnabled) {
+      recordTelemetry(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count(), nRows, isRebinding);
+    }
+  } catch (const Ort::Exception& exception) {
+    LOG(error) << "Error running model inference with IO binding: " << exception.what();
+    return nullptr;
+  }
+  return mBoundOutput.data();
+}
+
+void OnnxModel::enableTelemetry(o2::framework::HistogramRegistry* registry, const std::string& prefix)
+{
+  mTelemetryEnabled = true;
+  mTelemetry = OnnxModelTelemetry{};
+  if (registry == nullptr) {
+    return;
+  }
+  std::vector<double> latencyBins(OnnxModelTelemetry::NLatencyBins + 1);
+  for (int iBin = 0; iBin <= OnnxModelTelemetry::NLatencyBins; ++iBin) {
+    latencyBins[iBin] = OnnxModelTelemetry::MinLatency * std::pow(10., iBin / 8.);
+  }
+  std::vector<double> batchSizeBins(OnnxModelTelemetry::NBatchSizeBins + 1);
+  for (int iBin = 0; iBin <= OnnxModelTelemetry::NBatchSizeBins; ++iBin) {
+    batchSizeBins[iBin] = std::pow(2., iBin);
+  }
+  mHistLatency = registry->add<TH1>((prefix + "hOnnxLatency").c_str(), "ONNX inference latency;latency (#mus);calls", o2::framework::HistType::kTH1D, {{latencyBins, "latency (#mus)"}});
+  mHistBatchSize = registry->add<TH1>((prefix + "hOnnxBatchSize").c_str(), "ONNX inference batch size;number of rows;calls", o2::framework::HistType::kTH1D, {{batchSizeBins, "number of rows"}});
+  LOG(info) << "ONNX telemetry enabled for model " << modelPath << " (" << activeThreads << " intra-op threads)";
+}
+
+void OnnxModel::recordTelemetry(const double latency, const uint64_t rows, const bool isAllocating)
+{
+  mTelemetry.record(latency, rows, isAllocating);
+  if (mHistLatency) {
+    mHistLatency->Fill(latency);
+  }
+  if (mHistBatchSize) {
+    mHistBatchSize->Fill(static_cast<double>(rows));
+  }
+}
+
 void OnnxModel::setActiveThreads(const int threads)
 {
   activeThreads = threads;
@@ -26,20 +26,84 @@
 #include <onnxruntime_cxx_api.h>
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
 #include <iterator>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
+class TH1;
+
 namespace o2
 {
 
+namespace framework
+{
+class HistogramRegistry;
+} // namespace framework
+
 namespace ml
 {
 
+/// Inference statistics of an OnnxModel
+struct OnnxModelTelemetry {
+  static constexpr int NLatencyBins = 64;     // logarithmic latency bins, 8 per decade from 100 ns
+  static constexpr double MinLatency = 1.e-1; // lower edge of the latency bins in microseconds
+  static constexpr int NBatchSizeBins = 32;   // base-2 logarithmic batch-size bins
+
+  uint64_t nCalls = 0;            // number of inference calls
+  uint64_t nRows = 0;             // total number of evaluated rows (candidates, tracks, ...)
+  uint64_t nAllocatingCalls = 0;  // number of calls creating new input/output tensors
+  double totalLatency = 0.;       // total inference time in microseconds
+  std::array<uint64_t, NLatencyBins> latencyCounts{};
+  std::array<uint64_t, NBatchSizeBins> batchSizeCounts{};
+
+  void record(const double latency, const uint64_t rows, const bool isAllocating);
+  double getLatencyQuantile(const double quantile) const; // in microseconds, upper edge of the bin containing the quantile
+  void print(const std::string& name) const;
+};
+
+/// Process-wide registry of the ONNX environment and sessions
+/// Sessions are deduplicated by model file content and session settings, so that all OnnxModel instances of a device loading the same model share weights and thread pool
+/// The model content is kept with each session and compared byte by byte on a hit, so that a hash collision cannot hand out the session of another model
+class OnnxSessionRegistry
+{
+ public:
+  static OnnxSessionRegistry& instance();
+
+  /// Use one global intra-op thread pool for all sessions, must be called before the first model is initialised
+  /// \param threads is the number of threads of the global pool (0 means per-session thread pools)
+  void setGlobalIntraOpThreads(const int threads);
+  bool useGlobalThreadPool() const { return mGlobalIntraOpThreads > 0; }
+
+  std::shared_ptr<Ort::Env> getEnv();
+  /// \param content is the model file content, replaced by the content shared with the registered session on a hit
+  std::shared_ptr<Ort::Session> getSession(std::shared_ptr<const std::string>& content, const std::string& name, Ort::SessionOptions& options, const std::string& optionsKey);
+
+  std::size_t getNSessionsCreated() const { return mNSessionsCreated; }
+  std::size_t getNSessionsReused() const { return mNSessionsReused; }
+
+ private:
+  OnnxSessionRegistry() = default;
+
+  std::mutex mMutex;
+  std::shared_ptr<Ort::Env> mEnv = nullptr;
+  int mGlobalIntraOpThreads = 0;
+  struct SessionEntry {
+    std::shared_ptr<const std::string> content; // model file content
+    std::weak_ptr<Ort::Session> session;        // session built from the content
+  };
+  std::unordered_multimap<std::string, SessionEntry> mSessions; // sessions keyed by model content hash and session settings
+  std::size_t mNSessionsCreated = 0;
+  std::size_t mNSessionsReused = 0;
+};
+
 class OnnxModel
 {
 
@@ -49,34 +113,15 @@ class OnnxModel
 
   // Inferencing
   void initModel(const std::string&, const bool = false, const int = 0, const uint64_t = 0, const uint64_t = 0);
+  void initModelFromBuffer(std::string_view, const std::string&, const bool = false, const int = 0, const uint64_t = 0, const uint64_t = 0);
+  void warmUp(); // evaluate a dummy input, reduces the overhead of the first inference
 
   // template methods -- best to define them in header
   template <typename T>
   T* evalModel(std::vector<Ort::Value>& input)
   {
-    LOG(debug) << "Input tensor shape: " << printShape(input[0].GetTensorTypeAndShapeInfo().GetShape());
-    // assert(input[0].GetTensorTypeAndShapeInfo().GetShape() == getNumInputNodes()); --> Fails build in debug mode, TODO: assertion should be checked somehow
-
     try {
-      const Ort::RunOptions runOptions;
-      std::vector<const char*> inputNamesChar(mInputNames.size(), nullptr);
-      std::transform(std::begin(mInputNames), std::end(mInputNames), std::begin(inputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-
-      std::vector<const char*> outputNamesChar(mOutputNames.size(), nullptr);
-      std::transform(std::begin(mOutputNames), std::end(mOutputNames), std::begin(outputNamesChar),
-                     [&](const std::string& str) { return str.c_str(); });
-      auto outputTensors = mSession->Run(runOptions, inputNamesChar.data(), input.data(), input.size(), outputNamesChar.data(), outputNamesChar.size());
-      LOG(debug) << "Number of output tensors: " << outputTensors.size();
-      if (outputTensors.size() != mOutputNames.size()) {
-        LOG(fatal) << "Number of output tensors: " << outputTensors.size() << " does not agree with the model specified size: " << mOutputNames.size();
-      }
-      for (std::size_t i = 0; i < outputTensors.size(); i++) {
-        LOG(debug) << "Output tensor shape: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape());
-        if ((outputTensors[i].GetTensorTypeAndShapeInfo().GetShape() != mOutputShapes[i]) && (mOutputShapes[i][0] != -1)) {
-          LOG(fatal) << "Shape of tensor " << i << " does not agree with model specification! Output: " << printShape(outputTensors[i].GetTensorTypeAndShapeInfo().GetShape()) << " model: " << printShape(mOutputShapes[i]);
-        }
-      }
+      auto outputTensors = runSession(input);
       T* outputValues = outputTensors.back().GetTensorMutableData<T>();
       return outputValues;
     } catch (const Ort::Exception& exception) {
@@ -99,6 +144,34 @@ class OnnxModel
     return evalModel<T>(inputTensors);
   }
 
+  /// Evaluate the model on a batch of flattened inputs and copy the last output tensor into a caller-owned container
+  /// \param input flattened input features, (number of rows) x (number of input nodes)
+  /// \param output container filled with the flattened output, (number of rows) x (number of output nodes)
+  /// \return false if the inference failed
+  /// \note Unlike the overloads returning a raw pointer, the output does not depend on the lifetime of the ONNX output tensors
+  template <typename T>
+  bool evalModel(std::vector<T>& input, std::vector<T>& output)
+  {
+    const int64_t size = input.size();
+    assert(size % mInputShapes[0][1] == 0);
+    std::vector<int64_t> inputShape{size / mInputShapes[0][1], mInputShapes[0][1]};
+    std::vector<Ort::Value> inputTensors;
+    Ort::MemoryInfo memInfo =
+      Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
+    inputTensors.emplace_back(Ort::Value::CreateTensor<T>(memInfo, input.data(), size, inputShape.data(), inputShape.size()));
+    try {
+      auto outputTensors = runSession(inputTensors);
+      const T* outputValues = outputTensors.back().GetTensorData<T>();
+      const std::size_t outputSize = outputTensors.back().GetTensorTypeAndShapeInfo().GetElementCount();
+      output.assign(outputValues, outputValues + outputSize);
+      return true;
+    } catch (const Ort::Exception& exception) {
+      LOG(error) << "Error running model inference: " << exception.what();
+    }
+    output.clear();
+    return false;
+  }
+
   // For 2D inputs
   template <typename T>
   T* evalModel(std::vector<std::vector<T>>& input)
@@ -126,11 +199,15 @@ class OnnxModel
     return evalModel<T>(inputTensors);
   }
 
-  // Reset session
-  void resetSession()
-  {
-    mSession.reset(new Ort::Session{*mEnv, modelPath.c_str(), sessionOptions});
-  }
+  // Persistent IO binding with preallocated input & output buffers (single-input float models)
+  void enableIoBinding(const std::size_t);
+  bool isIoBindingEnabled() const { return mIoBinding != nullptr; }
+  std::size_t getMaxBatchSize() const { return mMaxBatchSize; }
+  float* getBoundInput() { return mBoundInput.data(); } // to be filled in place with (number of rows) x (number of input nodes) values
+  const float* evalModelBound(const std::size_t);       // output valid until the next call
+
+  // Reset session, rebuilt from the held model content with the current session options
+  void resetSession();
 
   // Getters & Setters
   Ort::SessionOptions* getSessionOptions() { return &sessionOptions; } // For optimizations in post
@@ -144,6 +221,12 @@ class OnnxModel
   uint64_t getValidityFrom() const { return validFrom; }
   uint64_t getValidityUntil() const { return validUntil; }
   void setActiveThreads(const int);
+  int getActiveThreads() const { return activeThreads; }
+
+  // Telemetry
+  void enableTelemetry(o2::framework::HistogramRegistry* = nullptr, const std::string& = "");
+  bool isTelemetryEnabled() const { return mTelemetryEnabled; }
+  const OnnxModelTelemetry& getTelemetry() const { return mTelemetry; }
 
  private:
   // Environment variables for the ONNX runtime
@@ -156,16 +239,43 @@ class OnnxModel
   std::vector<std::vector<int64_t>> mInputShapes;
   std::vector<std::string> mOutputNames;
   std::vector<std::vector<int64_t>> mOutputShapes;
+  std::vector<const char*> mInputNamesChar;
+  std::vector<const char*> mOutputNamesChar;
+
+  // Persistent IO binding
+  std::unique_ptr<Ort::IoBinding> mIoBinding = nullptr;
+  std::vector<float> mBoundInput;
+  std::vector<float> mBoundOutput;
+  Ort::Value mBoundInputTensor{nullptr};
+  Ort::Value mBoundOutputTensor{nullptr};
+  std::vector<int64_t> mBoundOutputShape; // output dimensions after the batch dimension
+  std::size_t mBoundOutputRowSize = 0;    // number of output values per row
+  std::size_t mMaxBatchSize = 0;
+  std::size_t mBoundRows = 0;
+
+  // Telemetry
+  bool mTelemetryEnabled = false;
+  OnnxModelTelemetry mTelemetry;
+  std::shared_ptr<TH1> mHistLatency = nullptr;
+  std::shared_ptr<TH1> mHistBatchSize = nullptr;
+  void recordTelemetry(const double, const uint64_t, const bool);
 
   // Environment settings
   std::string modelPath;
+  std::shared_ptr<const std::string> mModelContent = nullptr; // model file content, shared with the session registry
+  bool mEnableOptimizations = false;
   int activeThreads = 0;
   uint64_t validFrom = 0;
   uint64_t validUntil = 0;
 
   // Internal function for printing the shape of tensors
   std::string printShape(const std::vector<int64_t>&);
+  // Internal function running the session and checking the output tensors
+  std::vector<Ort::Value> runSession(std::vector<Ort::Value>&);
   bool checkHyperloop(const bool = true);
+  // Internal function initialising the model from its content
+  void initModelFromContent(std::shared_ptr<const std::string>, const std::string&, const bool, const int, const uint64_t, const uint64_t);
+  std::string getOptionsKey() const { return std::to_string(mEnableOptimizations) + "_" + std::to_string(activeThreads); }
 };
 
 } // namespace ml
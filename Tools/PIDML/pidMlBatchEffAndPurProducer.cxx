@@ -104,6 +104,8 @@ struct PidMlBatchEffAndPurProducer {
                                             aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr, aod::pidTPCFullEl, aod::pidTPCFullMu,
                                             aod::pidTOFFullPi, aod::pidTOFFullKa, aod::pidTOFFullPr, aod::pidTOFFullEl, aod::pidTOFFullMu>>;
   std::vector<PidONNXModel<BigTracks>> models;
+  std::vector<BigTracks::iterator> primaryTracks; // tracks of physical primaries in the data frame
+  std::vector<std::vector<float>> mlCertainties;  // certainties of the primary tracks for each pid
 
   void initHistos()
   {
@@ -222,15 +224,18 @@ struct PidMlBatchEffAndPurProducer {
     effAndPurPIDResult.reserve(mcParticles.size());
 
     auto bc = collisions.iteratorAt(0).bc_as<aod::BCsWithTimestamps>();
-    if (useCcdb && bc.runNumber() != CurrentRunNumber) {
-      uint64_t timestamp = useFixedTimestamp ? fixedTimestamp.value : bc.timestamp();
-      for (const int32_t& pid : pdgPids.value)
-        models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
-                                                    ccdbApi, timestamp, pid, 1.1, &detectorMomentumLimits.value[0]));
-    } else {
-      for (const int32_t& pid : pdgPids.value)
-        models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
-                                                    ccdbApi, -1, pid, 1.1, &detectorMomentumLimits.value[0]));
+    // the models are loaded for the first data frame and kept for the whole job
+    if (models.empty()) {
+      if (useCcdb && bc.runNumber() != CurrentRunNumber) {
+        uint64_t timestamp = useFixedTimestamp ? fixedTimestamp.value : bc.timestamp();
+        for (const int32_t& pid : pdgPids.value)
+          models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
+                                                      ccdbApi, timestamp, pid, 1.1, &detectorMomentumLimits.value[0]));
+      } else {
+        for (const int32_t& pid : pdgPids.value)
+          models.emplace_back(PidONNXModel<BigTracks>(localPath.value, ccdbPath.value, useCcdb.value,
+                                                      ccdbApi, -1, pid, 1.1, &detectorMomentumLimits.value[0]));
+      }
     }
 
     for (const auto& mcPart : mcParticles) {
@@ -240,20 +245,30 @@ struct PidMlBatchEffAndPurProducer {
       }
     }
 
+    primaryTracks.clear();
     for (const auto& track : tracks) {
-      if (track.has_mcParticle()) {
-        auto mcPart = track.mcParticle();
-        if (mcPart.isPhysicalPrimary()) {
-          fillTrackedHist(mcPart.pdgCode(), track.pt());
-
-          for (size_t i = 0; i < pdgPids.value.size(); ++i) {
-            float mlCertainty = models[i].applyModel(track);
-            nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
-            bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
-
-            effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainty, nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
-          }
-        }
+      if (track.has_mcParticle() && track.mcParticle().isPhysicalPrimary()) {
+        primaryTracks.push_back(track);
+      }
+    }
+
+    // one batched inference per model for all the tracks of the data frame
+    mlCertainties.resize(pdgPids.value.size());
+    for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+      mlCertainties[i] = models[i].applyModel(primaryTracks);
+    }
+
+    for (size_t iTrack = 0; iTrack < primaryTracks.size(); ++iTrack) {
+      const auto& track = primaryTracks[iTrack];
+      auto mcPart = track.mcParticle();
+      fillTrackedHist(mcPart.pdgCode(), track.pt());
+
+      for (size_t i = 0; i < pdgPids.value.size(); ++i) {
+        float mlCertainty = mlCertainties[i][iTrack];
+        nSigma_t nSigma = getNSigma(track, pdgPids.value[i]);
+        bool isMCPid = mcPart.pdgCode() == pdgPids.value[i];
+
+        effAndPurPIDResult(track.index(), pdgPids.value[i], track.pt(), mlCertainty, nSigma.composed, isMCPid, track.hasTOF(), track.hasTRD());
       }
     }
   }
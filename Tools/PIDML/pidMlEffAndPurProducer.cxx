@@ -33,9 +33,11 @@
 #include <Framework/runDataProcessing.h>
 
 #include <cmath>
+#include <cstddef>
 #include <cstdint>
 #include <cstdlib>
 #include <string>
+#include <vector>
 
 using namespace o2;
 using namespace o2::framework;
@@ -67,6 +69,7 @@ struct PidMlEffAndPurProducer {
                                             aod::pidTPCFullPi, aod::pidTPCFullKa, aod::pidTPCFullPr, aod::pidTPCFullEl, aod::pidTPCFullMu,
                                             aod::pidTOFFullPi, aod::pidTOFFullKa, aod::pidTOFFullPr, aod::pidTOFFullEl, aod::pidTOFFullMu>>;
   PidONNXModel<BigTracks> pidModel;
+  std::vector<BigTracks::iterator> primaryTracks; // tracks of physical primaries in the data frame
 
   typedef struct nSigma_t {
     double tpc, tof;
@@ -174,43 +177,50 @@ struct PidMlEffAndPurProducer {
       }
     }
 
+    primaryTracks.clear();
     for (const auto& track : tracks) {
-      if (track.has_mcParticle()) {
-        auto mcPart = track.mcParticle();
-        if (mcPart.isPhysicalPrimary()) {
-          bool mlAccepted = pidModel.applyModelBoolean(track);
-          nSigma_t nSigma = getNSigma(track);
-          bool nSigmaAccepted = isNSigmaAccept(track, nSigma);
-
-          LOGF(debug, "collision id: %d track id: %d mlAccepted: %d nSigmaAccepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
-               track.collisionId(), track.index(), mlAccepted, nSigmaAccepted, track.p(), track.x(), track.y(), track.z());
-
-          if (mcPart.pdgCode() == pidModel.mPid) {
-            histos.fill(HIST("full/hPtTOFNSigma"), track.p(), nSigma.tof);
-            histos.fill(HIST("full/hPtTPCNSigma"), track.p(), nSigma.tpc);
-            histos.fill(HIST("hPtMCTracked"), track.pt());
-          }
-
-          histos.fill(HIST("full/hPtTOFBeta"), track.pt(), track.beta());
-          histos.fill(HIST("full/hPtTPCSignal"), track.pt(), track.tpcSignal());
-
-          if (mlAccepted) {
-            if (mcPart.pdgCode() == pidModel.mPid) {
-              histos.fill(HIST("hPtMLTruePositive"), track.pt());
-            }
-            histos.fill(HIST("hPtMLPositive"), track.pt());
-          }
-
-          if (nSigmaAccepted) {
-            histos.fill(HIST("hPtTOFNSigma"), track.p(), nSigma.tof);
-            histos.fill(HIST("hPtTPCNSigma"), track.p(), nSigma.tpc);
-
-            if (mcPart.pdgCode() == pidModel.mPid) {
-              histos.fill(HIST("hPtNSigmaTruePositive"), track.pt());
-            }
-            histos.fill(HIST("hPtNSigmaPositive"), track.pt());
-          }
+      if (track.has_mcParticle() && track.mcParticle().isPhysicalPrimary()) {
+        primaryTracks.push_back(track);
+      }
+    }
+
+    // one batched inference for all the tracks of the data frame
+    const std::vector<float> mlCertainties = pidModel.applyModel(primaryTracks);
+
+    for (size_t iTrack = 0; iTrack < primaryTracks.size(); ++iTrack) {
+      const auto& track = primaryTracks[iTrack];
+      auto mcPart = track.mcParticle();
+      bool mlAccepted = mlCertainties[iTrack] >= pidModel.mMinCertainty;
+      nSigma_t nSigma = getNSigma(track);
+      bool nSigmaAccepted = isNSigmaAccept(track, nSigma);
+
+      LOGF(debug, "collision id: %d track id: %d mlAccepted: %d nSigmaAccepted: %d p: %.3f; x: %.3f, y: %.3f, z: %.3f",
+           track.collisionId(), track.index(), mlAccepted, nSigmaAccepted, track.p(), track.x(), track.y(), track.z());
+
+      if (mcPart.pdgCode() == pidModel.mPid) {
+        histos.fill(HIST("full/hPtTOFNSigma"), track.p(), nSigma.tof);
+        histos.fill(HIST("full/hPtTPCNSigma"), track.p(), nSigma.tpc);
+        histos.fill(HIST("hPtMCTracked"), track.pt());
+      }
+
+      histos.fill(HIST("full/hPtTOFBeta"), track.pt(), track.beta());
+      histos.fill(HIST("full/hPtTPCSignal"), track.pt(), track.tpcSignal());
+
+      if (mlAccepted) {
+        if (mcPart.pdgCode() == pidModel.mPid) {
+          histos.fill(HIST("hPtMLTruePositive"), track.pt());
+        }
+        histos.fill(HIST("hPtMLPositive"), track.pt());
+      }
+
+      if (nSigmaAccepted) {
+        histos.fill(HIST("hPtTOFNSigma"), track.p(), nSigma.tof);
+        histos.fill(HIST("hPtTPCNSigma"), track.p(), nSigma.tpc);
+
+        if (mcPart.pdgCode() == pidModel.mPid) {
+          histos.fill(HIST("hPtNSigmaTruePositive"), track.pt());
         }
+        histos.fill(HIST("hPtNSigmaPositive"), track.pt());
       }
     }
   }
@@ -105,6 +105,17 @@ struct PidONNXInterface {
     return false;
   }
 
+  /// \return certainties of a batch of tracks for each output pid, in the order of the output pids, with one batched inference per model
+  std::vector<std::vector<float>> applyModels(const std::vector<typename T::iterator>& tracks)
+  {
+    std::vector<std::vector<float>> certainties;
+    certainties.reserve(mNPids);
+    for (std::size_t i = 0; i < mNPids; i++) {
+      certainties.push_back(mModels[i].applyModel(tracks));
+    }
+    return certainties;
+  }
+
  private:
   void fillDefaultConfiguration(std::vector<double>& minCertainties)
   {
@@ -141,6 +141,37 @@ struct PidONNXModel {
     return getModelOutput(track) >= mMinCertainty;
   }
 
+  /// Applies the model to a batch of tracks, with one inference per configuration of the detectors used
+  /// \return certainties of the tracks, in the order of the tracks, as returned by applyModel for each track
+  std::vector<float> applyModel(const std::vector<typename T::iterator>& tracks)
+  {
+    // The missing detector signals are NaN inputs: the rows of a batch must have the same NaN columns
+    std::array<std::vector<size_t>, NDetectorConfigurations> batches;
+    for (size_t i = 0; i < tracks.size(); ++i) {
+      batches[getDetectorConfiguration(tracks[i])].push_back(i);
+    }
+
+    std::vector<float> certainties(tracks.size(), 0.f);
+    std::vector<float> inputTensorValues;
+    std::vector<float> batchCertainties;
+    for (const auto& batch : batches) {
+      if (batch.empty()) {
+        continue;
+      }
+      inputTensorValues.clear();
+      inputTensorValues.reserve(batch.size() * mTrainColumns.size());
+      for (const size_t i : batch) {
+        appendValues(tracks[i], inputTensorValues);
+      }
+      batchCertainties.assign(batch.size(), 0.f);
+      runModel(inputTensorValues, batchCertainties);
+      for (size_t j = 0; j < batch.size(); ++j) {
+        certainties[batch[j]] = batchCertainties[j];
+      }
+    }
+    return certainties;
+  }
+
   int mPid{0};
   double mMinCertainty{0};
 
@@ -214,13 +245,36 @@ struct PidONNXModel {
     return (value - scalingParams.first) / scalingParams.second;
   }
 
+  static constexpr size_t NDetectorConfigurations = 4; // TOF used or not, TRD used or not
+
+  bool useTOF(const typename T::iterator& track) const
+  {
+    return !pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF]);
+  }
+
+  bool useTRD(const typename T::iterator& track) const
+  {
+    return !pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD]);
+  }
+
+  size_t getDetectorConfiguration(const typename T::iterator& track) const
+  {
+    return static_cast<size_t>(useTOF(track)) + 2 * static_cast<size_t>(useTRD(track));
+  }
+
   std::vector<float> getValues(const typename T::iterator& track)
   {
     std::vector<float> output;
     output.reserve(mTrainColumns.size());
+    appendValues(track, output);
+    return output;
+  }
 
-    bool useTOF = !pidml::pidutils::tofMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOF]);
-    bool useTRD = !pidml::pidutils::trdMissing(track) && pidml::pidutils::inPLimit(track, mPLimits[kTPCTOFTRD]);
+  // Appends the scaled input values of a track, i.e. one row of the input tensor
+  void appendValues(const typename T::iterator& track, std::vector<float>& output)
+  {
+    bool useTOF = this->useTOF(track);
+    bool useTRD = this->useTRD(track);
 
     for (uint32_t i = 0; i < mTrainColumns.size(); ++i) {
       auto& columnLabel = mTrainColumns[i];
@@ -247,21 +301,25 @@ struct PidONNXModel {
 
       output.push_back(value);
     }
-
-    return output;
   }
 
   float getModelOutput(const typename T::iterator& track)
   {
-    // First rank of the expected model input is -1 which means that it is dynamic axis.
-    // Axis is exported as dynamic to make it possible to run model inference with the batch of
-    // tracks at once in the future (batch would need to have the same amount of quiet_NaNs in each row).
-    // For now we hardcode 1.
-    static constexpr int64_t BatchSize = 1;
+    std::vector<float> inputTensorValues = getValues(track);
+    std::vector<float> certainty(1, 0.f); // stays 0 if the inference fails
+    runModel(inputTensorValues, certainty);
+    return certainty[0];
+  }
+
+  // Runs the inference on a batch of rows, with the same quiet_NaNs in each row
+  // \return whether the inference succeeded, the certainties of the rows are then in certainties
+  bool runModel(std::vector<float>& inputTensorValues, std::vector<float>& certainties)
+  {
+    // First rank of the expected model input is -1 which means that it is dynamic axis,
+    // its size is the number of rows of the batch.
     auto inputShape = mInputShapes[0];
-    inputShape[0] = BatchSize;
+    inputShape[0] = static_cast<int64_t>(certainties.size());
 
-    std::vector<float> inputTensorValues = getValues(track);
     std::vector<Ort::Value> inputTensors;
 
     Ort::MemoryInfo memInfo = Ort::MemoryInfo::CreateCpu(OrtAllocatorType::OrtArenaAllocator, OrtMemType::OrtMemTypeDefault);
@@ -289,12 +347,12 @@ struct PidONNXModel {
       LOG(debug) << "output tensor shape: " << printShape(outputTensors[0].GetTensorTypeAndShapeInfo().GetShape());
 
       const float* outputValue = outputTensors[0].GetTensorData<float>();
-      float certainty = *outputValue;
-      return certainty;
+      std::copy(outputValue, outputValue + certainties.size(), certainties.begin());
+      return true;
     } catch (const Ort::Exception& exception) {
       LOG(error) << "Error running model inference: " << exception.what();
     }
-    return false; // unreachable code
+    return false;
   }
 
   // Pretty prints a shape dimension vector
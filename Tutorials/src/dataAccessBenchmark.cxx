@@ -0,0 +1,227 @@
+// Copyright 2019-2020 CERN and copyright holders of ALICE O2.
+// See https://alice-o2.web.cern.ch/copyright for details of the copyright holders.
+// All rights not expressly granted are reserved.
+//
+// This software is distributed under the terms of the GNU General Public
+// License v3 (GPL Version 3), copied verbatim in the file "COPYING".
+//
+// In applying this license CERN does not waive the privileges and immunities
+// granted to it by virtue of its status as an Intergovernmental Organization
+// or submit itself to any jurisdiction.
+///
+/// \brief Throughput of the data-access patterns shown in the tutorials.
+///        Each process function reads the tracks of the data frame with one pattern (partition or filter, slicing
+///        with a SliceCache, a Preslice or by grouping, iterator or rawIteratorAt, event mixing with SameKindPair or
+///        with manual pools) and sums their pT. Enable one process function per run, on a fixed AO2D sample: the time,
+///        the calls and the rows of each pattern are stored in the Profiling histograms and printed at the end of the
+///        stream, with the rows per second and the peak resident memory of the device.
+/// \author
+/// \since
+
+// the profiling scopes of this benchmark are always compiled in
+#define O2PHYSICS_PROFILING_SCOPES 1
+
+#include "Common/Core/ProfilingScopes.h"
+#include "Common/Core/TableResources.h"
+
+#include <Framework/ASoA.h>
+#include <Framework/ASoAHelpers.h>
+#include <Framework/AnalysisDataModel.h>
+#include <Framework/AnalysisHelpers.h>
+#include <Framework/AnalysisTask.h>
+#include <Framework/BinningPolicy.h>
+#include <Framework/Configurable.h>
+#include <Framework/EndOfStreamContext.h>
+#include <Framework/Expressions.h>
+#include <Framework/GroupedCombinations.h>
+#include <Framework/HistogramRegistry.h>
+#include <Framework/HistogramSpec.h>
+#include <Framework/InitContext.h>
+#include <Framework/runDataProcessing.h>
+
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace o2;
+using namespace o2::framework;
+using namespace o2::framework::expressions;
+using namespace o2::soa;
+
+struct DataAccessBenchmark {
+  enum Pattern { kPartition = 0,
+                 kFilter,
+                 kSliceByCached,
+                 kPreslice,
+                 kGrouping,
+                 kIterator,
+                 kRawIterator,
+                 kMixingSameKindPair,
+                 kMixingManualPools };
+
+  Configurable<float> ptMin{"ptMin", 0.5f, "Lowest pT of the partition and of the filter"};
+  Configurable<int> mixingDepth{"mixingDepth", 5, "Number of collisions mixed with each collision"};
+
+  Filter ptFilter = aod::track::pt > ptMin;
+  Partition<aod::Tracks> highPtTracks = aod::track::pt > ptMin;
+
+  SliceCache cache;
+  Preslice<aod::Tracks> perCollision = aod::track::collisionId;
+
+  std::vector<double> zBins{VARIABLE_WIDTH, -10., -6., -2., 2., 6., 10.};
+  using BinningType = ColumnBinningPolicy<aod::collision::PosZ>;
+  BinningType binningOnVertex{{zBins}, true};
+  std::vector<std::deque<int64_t>> pools; // last collisions of each vertex bin, for the manual mixing
+
+  HistogramRegistry registry{"registry", {}, OutputObjHandlingPolicy::AnalysisObject};
+  o2::common::core::ProfilingScopes profiling;
+
+  void init(InitContext&)
+  {
+    profiling.init(registry, {"partition", "filter", "sliceByCached", "preslice", "grouping", "iterator", "rawIteratorAt", "mixingSameKindPair", "mixingManualPools"});
+    pools.resize(zBins.size() - 2);
+  }
+
+  void endOfStream(EndOfStreamContext&)
+  {
+    profiling.print();
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+      if (line.rfind("VmHWM:", 0) == 0) {
+        LOGF(info, "Peak resident memory of the device: %s", line.substr(6).c_str());
+      }
+    }
+  }
+
+  template <typename TTracks>
+  static double sumPt(TTracks const& tracks)
+  {
+    double sum = 0.;
+    for (const auto& track : tracks) {
+      sum += track.pt();
+    }
+    return sum;
+  }
+
+  void processPartition(aod::Tracks const&)
+  {
+    auto scope = profiling.scope(kPartition);
+    scope.count(highPtTracks.size());
+    o2::common::core::doNotOptimize(sumPt(highPtTracks));
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processPartition, "Select the tracks with a partition", false);
+
+  void processFilter(soa::Filtered<aod::Tracks> const& tracks)
+  {
+    auto scope = profiling.scope(kFilter);
+    scope.count(tracks.size());
+    o2::common::core::doNotOptimize(sumPt(tracks));
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processFilter, "Select the tracks with a filter", false);
+
+  void processSliceByCached(aod::Collisions const& collisions, aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kSliceByCached);
+    scope.count(tracks.size());
+    for (const auto& collision : collisions) {
+      auto tracksThisCollision = tracks.sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+      o2::common::core::doNotOptimize(sumPt(tracksThisCollision));
+    }
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processSliceByCached, "Slice the tracks per collision with the SliceCache", false);
+
+  void processPreslice(aod::Collisions const& collisions, aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kPreslice);
+    scope.count(tracks.size());
+    for (const auto& collision : collisions) {
+      auto tracksThisCollision = tracks.sliceBy(perCollision, collision.globalIndex());
+      o2::common::core::doNotOptimize(sumPt(tracksThisCollision));
+    }
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processPreslice, "Slice the tracks per collision with a Preslice", false);
+
+  void processGrouping(aod::Collision const&, aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kGrouping);
+    scope.count(tracks.size());
+    o2::common::core::doNotOptimize(sumPt(tracks));
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processGrouping, "Group the tracks per collision", false);
+
+  void processIterator(aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kIterator);
+    scope.count(tracks.size());
+    o2::common::core::doNotOptimize(sumPt(tracks));
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processIterator, "Loop over the tracks with the table iterator", false);
+
+  void processRawIterator(aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kRawIterator);
+    scope.count(tracks.size());
+    double sum = 0.;
+    for (int64_t i = 0; i < tracks.size(); i++) {
+      sum += tracks.rawIteratorAt(i).pt();
+    }
+    o2::common::core::doNotOptimize(sum);
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processRawIterator, "Access the tracks with rawIteratorAt", false);
+
+  void processMixingSameKindPair(aod::Collisions const& collisions, aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kMixingSameKindPair);
+    auto tracksTuple = std::make_tuple(tracks);
+    SameKindPair<aod::Collisions, aod::Tracks, BinningType> pair{binningOnVertex, mixingDepth, -1, collisions, tracksTuple, &cache};
+    double sum = 0.;
+    for (const auto& [c1, tracks1, c2, tracks2] : pair) {
+      for (const auto& [t1, t2] : combinations(CombinationsFullIndexPolicy(tracks1, tracks2))) {
+        sum += t1.pt() + t2.pt();
+        scope.count(1);
+      }
+    }
+    o2::common::core::doNotOptimize(sum);
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processMixingSameKindPair, "Mix the collisions with SameKindPair, rows are track pairs", false);
+
+  void processMixingManualPools(aod::Collisions const& collisions, aod::Tracks const& tracks)
+  {
+    auto scope = profiling.scope(kMixingManualPools);
+    for (auto& pool : pools) {
+      pool.clear();
+    }
+    double sum = 0.;
+    for (const auto& collision : collisions) {
+      const int bin = binningOnVertex.getBin({collision.posZ()});
+      if (bin < 0) {
+        continue;
+      }
+      auto tracks1 = tracks.sliceByCached(aod::track::collisionId, collision.globalIndex(), cache);
+      auto& pool = pools[bin];
+      for (const auto& collisionId : pool) {
+        auto tracks2 = tracks.sliceByCached(aod::track::collisionId, collisionId, cache);
+        for (const auto& [t1, t2] : combinations(CombinationsFullIndexPolicy(tracks1, tracks2))) {
+          sum += t1.pt() + t2.pt();
+          scope.count(1);
+        }
+      }
+      pool.push_back(collision.globalIndex());
+      if (static_cast<int>(pool.size()) > mixingDepth) {
+        pool.pop_front();
+      }
+    }
+    o2::common::core::doNotOptimize(sum);
+  }
+  PROCESS_SWITCH(DataAccessBenchmark, processMixingManualPools, "Mix the collisions with manual pools per vertex bin, rows are track pairs", false);
+};
+
+WorkflowSpec defineDataProcessing(ConfigContext const& cfgc)
+{
+  return WorkflowSpec{
+    adaptAnalysisTask<DataAccessBenchmark>(cfgc),
+  };
+}